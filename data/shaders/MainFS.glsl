@@ -1,51 +1,574 @@
 #version 460 core
+#extension GL_GOOGLE_include_directive : require
 
-in vec2 v_TexCoord;
-in vec3 v_Normal;
-in vec3 v_FragPos;
+#ifdef GLITTER_BINDLESS_TEXTURES
+#extension GL_ARB_bindless_texture : require
+#endif
+#ifdef GLITTER_DEBUG_TRIANGLE_DENSITY
+#extension GL_NV_fragment_shader_barycentric : require
+#endif
 
-layout (std140, binding = 0) uniform CommonData
+#ifdef GLITTER_VISIBILITY_RESOLVE
+// The visibility buffer resolve, compiled as a compute shader: each invocation rebuilds the inputs of the opaque fragment
+// covering its pixel from the triangle the visibility buffer holds, and shades it with the same Shade().
+layout (local_size_x = 8, local_size_y = 8) in;
+
+// In place of the vertex shader outputs, filled in by LoadFragment().
+vec2 v_TexCoord;
+vec3 v_Normal;
+vec3 v_FragPos;
+uint v_TextureLayer;
+uvec2 v_TextureHandle;
+uint v_MaterialID;
+// The screen-space derivatives of v_TexCoord, which compute shaders can't take.
+vec2 v_TexCoordDx;
+vec2 v_TexCoordDy;
+
+#define PixelCoord (vec2(gl_GlobalInvocationID.xy) + 0.5)
+#elif defined(GLITTER_IMPOSTOR)
+// The impostor of a far Node, drawn by impostor/ImpostorVS.glsl: in place of the vertex shader outputs, filled in from the
+// frame's texel by LoadImpostor().
+vec2 v_TexCoord;
+vec3 v_Normal;
+vec3 v_FragPos;
+
+// Explicit locations, since SPIR-V modules only match their interfaces by location.
+layout (location = 2) in vec3 v_QuadPos;
+layout (location = 5) flat in uint v_TextureLayer;
+layout (location = 6) flat in uvec2 v_TextureHandle;
+layout (location = 7) flat in uint v_MaterialID;
+layout (location = 8) in vec3 v_AtlasCoord;
+layout (location = 9) flat in vec3 v_DepthOffset;
+layout (location = 10) flat in mat3 v_NormalMatrix;
+
+#define PixelCoord gl_FragCoord.xy
+#else
+// Explicit locations, since SPIR-V modules only match their interfaces by location.
+layout (location = 0) in vec2 v_TexCoord;
+layout (location = 1) in vec3 v_Normal;
+layout (location = 2) in vec3 v_FragPos;
+#ifdef GLITTER_TRANSPARENT
+layout (location = 4) flat in float v_Opacity;
+#endif
+layout (location = 5) flat in uint v_TextureLayer;
+layout (location = 6) flat in uvec2 v_TextureHandle;
+layout (location = 7) flat in uint v_MaterialID;
+#ifdef GLITTER_NODE_ID
+layout (location = 8) flat in uint v_NodeId;
+#endif
+#if defined(GLITTER_DEBUG_LOD) || defined(GLITTER_DEBUG_CULL_STATE)
+layout (location = 9) flat in uint v_DrawInfo;
+#endif
+
+#define PixelCoord gl_FragCoord.xy
+#endif
+
+// CommonData and DrawData, see Glitter::Render::GenerateShaderDataGlsl().
+#include "ShaderData.glsl"
+
+// The main light's shadow map, see Glitter::Render::ShadowCache.
+layout (binding = 1) uniform sampler2DShadow u_ShadowMap;
+
+// The point lights, binned into clusters over the view frustum by Glitter::Render::LightClusters.
+struct PointLight
 {
-    mat4 u_View;
-    mat4 u_Projection;
-    vec4 u_EyePos;
-    vec4 u_LightPos;
-    vec4 u_LightColor;
+    vec4 m_PositionRadius;
+    vec4 m_Color;
 };
 
-layout (std140, binding = 1) uniform PerDrawData
+layout (std430, binding = 3) readonly buffer PointLights
 {
-    mat4 u_Model;
-    float u_Opacity;
+    PointLight b_PointLights[];
 };
 
-uniform sampler2D u_Texture;
+layout (std430, binding = 4) readonly buffer LightGrid
+{
+    // x, y: clusters per pixel; z, w: scale and bias from the log of the view depth to the slice.
+    vec4 b_ClusterScale;
+    uvec4 b_ClusterCount;
+    // The offset and count of each cluster's list in b_LightIndices.
+    uvec2 b_Clusters[];
+};
+
+layout (std430, binding = 5) readonly buffer LightIndices
+{
+    uint b_LightIndices[];
+};
 
-out vec4 FragColor;
+// Every Node's shading parameters, indexed by its material ID.
+struct Material
+{
+    // Multiplies the texture.
+    vec4 m_BaseColor;
+    float m_SpecularStrength;
+    float m_SpecularExponent;
+};
 
-void main()
-{ 
+layout (std430, binding = 9) readonly buffer Materials
+{
+    Material b_Materials[];
+};
+
+#ifdef GLITTER_UNTEXTURED
+#define SampleTexture(TexCoord) vec4(1.0)
+#else
+#if defined(GLITTER_BINDLESS_TEXTURES)
+#define NodeSampler sampler2D(v_TextureHandle)
+#define NodeTexCoord(TexCoord) (TexCoord)
+#elif defined(GLITTER_TEXTURE_ARRAY)
+layout (binding = 0) uniform sampler2DArray u_TextureArray;
+#define NodeSampler u_TextureArray
+#define NodeTexCoord(TexCoord) vec3(TexCoord, v_TextureLayer)
+#else
+layout (binding = 0) uniform sampler2D u_Texture;
+#define NodeSampler u_Texture
+#define NodeTexCoord(TexCoord) (TexCoord)
+#endif
+
+#ifdef GLITTER_VISIBILITY_RESOLVE
+// The level sampled along the analytic derivatives.
+float QueryLod()
+{
+    vec2 Size = vec2(textureSize(NodeSampler, 0).xy);
+    vec2 Dx = v_TexCoordDx * Size;
+    vec2 Dy = v_TexCoordDy * Size;
+    return 0.5 * log2(max(dot(Dx, Dx), dot(Dy, Dy)));
+}
+#define NodeLod(TexCoord) QueryLod()
+#else
+#define NodeLod(TexCoord) textureQueryLod(NodeSampler, TexCoord).y
+#endif
+
+#ifdef GLITTER_TEXTURE_STREAMING
+// The finest resident level of each Node texture, see Glitter::Render::TextureStreamer.
+layout (std430, binding = 2) readonly buffer TextureMinLods
+{
+    float b_TextureMinLods[];
+};
+
+// Never sample the levels that aren't streamed in yet.
+#define SampleTexture(TexCoord) textureLod(NodeSampler, NodeTexCoord(TexCoord), \
+    max(NodeLod(TexCoord) + u_TextureParams.x, b_TextureMinLods[v_TextureLayer]))
+#elif defined(GLITTER_VISIBILITY_RESOLVE)
+// Scaling the derivatives by 2^bias biases the level of detail by bias.
+#define SampleTexture(TexCoord) textureGrad(NodeSampler, NodeTexCoord(TexCoord), \
+    v_TexCoordDx * exp2(u_TextureParams.x), v_TexCoordDy * exp2(u_TextureParams.x))
+#else
+#define SampleTexture(TexCoord) texture(NodeSampler, NodeTexCoord(TexCoord), u_TextureParams.x)
+#endif
+#endif
+
+#if defined(GLITTER_VISIBILITY_RESOLVE)
+// Where the resolve writes the shaded opaque Nodes, the visibility buffer it reads, and the viewport it covers. The color
+// is write-only, so it can leave its format out, whichever HDR format the target has.
+layout (binding = 0) uniform writeonly image2D u_Color;
+layout (binding = 2) uniform usampler2D u_Visibility;
+layout (location = 0) uniform ivec2 u_Size;
+// The Node data page and geometry pool page bound, as the visibility buffer packs them in w: the resolve is dispatched
+// once per pair of pages, and each pixel is shaded by the dispatch of its draw's.
+layout (location = 1) uniform uint u_Pages;
+#elif defined(GLITTER_WEIGHTED_OIT)
+// Weighted blended order-independent transparency, composited over the opaque Nodes by the post-processing: the sum of
+// the weighted premultiplied colors, and the product of the (1 - alpha) of every fragment.
+layout (location = 0) out vec4 Accumulation;
+layout (location = 1) out float Revealage;
+#else
+layout (location = 0) out vec4 FragColor;
+#if defined(GLITTER_NODE_ID) && !defined(GLITTER_IMPOSTOR)
+// The Node drawn over each pixel, cleared to 0 where none is, see Glitter::Render::NodePicker.
+layout (location = 1) out uint NodeId;
+#endif
+#endif
+
+// See Glitter::Config::LIGHT_AMBIENT_STRENGTH. Specialized in SPIR-V modules, and defined in GLSL sources.
+#ifdef GL_SPIRV
+layout (constant_id = 0) const float AMBIENT_STRENGTH = 0.1;
+#else
+const float AMBIENT_STRENGTH = float(GLITTER_AMBIENT_STRENGTH);
+#endif
+
+// Opaque Nodes are always fully opaque, so their permutation doesn't fetch or multiply by the opacity.
+#ifdef GLITTER_TRANSPARENT
+#define Opacity v_Opacity
+#else
+#define Opacity 1.0
+#endif
+
+#ifdef GLITTER_WEIGHTED_OIT
+// McGuire and Bavoil's depth weight (equation 10), so that nearer and more opaque fragments dominate the average.
+float OitWeight(float Alpha)
+{
+    float Depth = 1.0 - gl_FragCoord.z * 0.9;
+    return clamp(pow(min(1.0, Alpha * 10.0) + 0.01, 3.0) * 1e8 * Depth * Depth * Depth, 1e-2, 3e3);
+}
+#endif
+
+// 1 where the main light reaches the fragment, 0 in the shadow of a Node, filtered over 2x2 bilinear PCF taps.
+float SampleShadow(vec3 Normal)
+{
+    if (u_ShadowParams.x == 0.0) {
+        return 1.0;
+    }
+
+    vec4 ShadowPos = u_ShadowViewProjection * vec4(v_FragPos + Normal * u_ShadowParams.y, 1.0);
+    vec3 ShadowCoord = ShadowPos.xyz / ShadowPos.w * 0.5 + 0.5;
+    if (ShadowCoord.z > 1.0) {
+        return 1.0;
+    }
+
+    vec2 TexelSize = 1.0 / vec2(textureSize(u_ShadowMap, 0));
+    float Lit = 0.0;
+    for (int y = 0; y < 2; y++) {
+        for (int x = 0; x < 2; x++) {
+            Lit += texture(u_ShadowMap, vec3(ShadowCoord.xy + (vec2(x, y) - 0.5) * TexelSize, ShadowCoord.z));
+        }
+    }
+    return Lit * 0.25;
+}
+
+// The diffuse and specular light of a point light, windowed to reach 0 at its radius.
+vec3 ShadePointLight(PointLight Light, Material Surface, vec3 Normal, vec3 ViewDir)
+{
+    vec3 ToLight = Light.m_PositionRadius.xyz - v_FragPos;
+    float Distance = length(ToLight);
+    vec3 LightDir = ToLight / max(Distance, 1e-4);
+    float Window = clamp(1.0 - pow(Distance / Light.m_PositionRadius.w, 4.0), 0.0, 1.0);
+    float Attenuation = Window * Window / (Distance * Distance + 1.0);
+
+    float NDotL = max(dot(Normal, LightDir), 0.0);
+    float Spec = pow(max(0.0, dot(normalize(ViewDir + LightDir), Normal)), Surface.m_SpecularExponent);
+    return (NDotL + Surface.m_SpecularStrength * Spec) * Attenuation * Light.m_Color.rgb;
+}
+
+// The lights of this fragment's cluster.
+vec3 ShadePointLights(Material Surface, vec3 Normal, vec3 ViewDir)
+{
+    float ViewDepth = -(u_View * vec4(v_FragPos, 1.0)).z;
+    uvec3 Cluster = uvec3(uvec2(PixelCoord * b_ClusterScale.xy),
+        uint(max(log(ViewDepth) * b_ClusterScale.z + b_ClusterScale.w, 0.0)));
+    Cluster = min(Cluster, b_ClusterCount.xyz - 1u);
+    uvec2 Lights = b_Clusters[(Cluster.z * b_ClusterCount.y + Cluster.y) * b_ClusterCount.x + Cluster.x];
+
+    vec3 Light = vec3(0.0);
+    for (uint Idx = Lights.x; Idx < Lights.x + Lights.y; Idx++) {
+        Light += ShadePointLight(b_PointLights[b_LightIndices[Idx]], Surface, Normal, ViewDir);
+    }
+    return Light;
+}
+
+// The debug views' visualizations, see DebugView in main.cpp. They're only compiled into the Main program.
+#if defined(GLITTER_DEBUG_OVERDRAW) || defined(GLITTER_DEBUG_QUAD_OVERDRAW)
+// Added up over every fragment of a pixel, so that 10 layers reach about 1.
+const vec3 OVERDRAW_COLOR = vec3(0.1, 0.05, 0.02);
+#endif
+
+#ifdef GLITTER_DEBUG_QUAD_OVERDRAW
+// The lanes of this fragment's 2x2 quad covering a pixel of the triangle, from their neighbors' coverage through the fine
+// derivatives, so it has to be called from uniform control flow. The other lanes are helper invocations.
+float CountQuadLanes()
+{
+    float Covered = gl_HelperInvocation ? 0.0 : 1.0;
+    bvec2 Odd = bvec2((ivec2(gl_FragCoord.xy) & 1) != ivec2(0));
+    float Row = Covered + (Odd.x ? Covered - dFdxFine(Covered) : Covered + dFdxFine(Covered));
+    return Row + (Odd.y ? Row - dFdyFine(Row) : Row + dFdyFine(Row));
+}
+#endif
+
+#if defined(GLITTER_DEBUG_TRIANGLE_DENSITY) || defined(GLITTER_DEBUG_LOD) || defined(GLITTER_DEBUG_CULL_STATE)
+// Blue through green to red, over [0, 1].
+vec3 Heatmap(float Value)
+{
+    float T = clamp(Value, 0.0, 1.0) * 4.0;
+    return clamp(vec3(T - 2.0, T < 2.0 ? T : 4.0 - T, 2.0 - T), 0.0, 1.0);
+}
+
+// `Color` lit by the main light alone, so that the shapes stay readable under the flat colors.
+vec4 ShadeFlat(vec3 Color)
+{
+    vec3 LightDir = normalize(u_LightPos.xyz - v_FragPos * u_LightPos.w);
+    return vec4(Color * (0.4 + 0.6 * max(dot(normalize(v_Normal), LightDir), 0.0)), Opacity);
+}
+#endif
+
+#ifdef GLITTER_DEBUG_CULL_STATE
+// Indexed by DrawCullState: untested, inside, intersecting, nearly culled and batched.
+const vec3 CULL_STATE_COLORS[5] = vec3[](
+    vec3(0.5), vec3(0.1, 0.8, 0.1), vec3(0.9, 0.8, 0.1), vec3(0.9, 0.1, 0.1), vec3(0.2, 0.4, 1.0));
+#endif
+
+vec4 Shade()
+{
+#if defined(GLITTER_STUB_SHADING)
+    // See Glitter::Core::BenchmarkIsolation::StubShaders.
+    return vec4(0.5, 0.5, 0.5, Opacity);
+#elif defined(GLITTER_DEBUG_NORMALS)
+    return vec4(normalize(v_Normal) * 0.5 + 0.5, Opacity);
+#elif defined(GLITTER_DEBUG_OVERDRAW)
+    return vec4(OVERDRAW_COLOR, 1.0);
+#elif defined(GLITTER_DEBUG_QUAD_OVERDRAW)
+    // Each covered lane takes its share of the whole quad's cost.
+    return vec4(OVERDRAW_COLOR * 4.0 / max(CountQuadLanes(), 1.0), 1.0);
+#elif defined(GLITTER_DEBUG_TRIANGLE_DENSITY)
+    // The screen-space barycentrics change by the inverse of twice the triangle's area in pixels.
+    vec2 Dx = dFdx(gl_BaryCoordNoPerspNV.xy);
+    vec2 Dy = dFdy(gl_BaryCoordNoPerspNV.xy);
+    float TrianglesPerPixel = 2.0 * abs(Dx.x * Dy.y - Dx.y * Dy.x);
+    // From 1 triangle per 256 pixels to 1 per pixel.
+    return ShadeFlat(Heatmap(log2(max(TrianglesPerPixel, 1e-6)) / 8.0 + 1.0));
+#elif defined(GLITTER_DEBUG_LOD)
+    // From the full detail to the coarsest of Glitter::Config::MESH_LOD_COUNT levels.
+    return ShadeFlat(Heatmap(float(v_DrawInfo & 0xFFu) / 3.0));
+#elif defined(GLITTER_DEBUG_CULL_STATE)
+    return ShadeFlat(CULL_STATE_COLORS[min((v_DrawInfo >> 8) & 0xFFu, 4u)]);
+#else
     vec3 EyePos = u_EyePos.xyz;
     vec3 LightPos = u_LightPos.xyz;
     vec3 LightColor = u_LightColor.rgb;
+    Material Surface = b_Materials[v_MaterialID];
 
     // Ambient
-    vec3 Ambient = vec3(0.1 * LightColor);
+    vec3 Ambient = vec3(AMBIENT_STRENGTH * LightColor);
 
     // Diffuse
     vec3 Normal = normalize(v_Normal);
-    vec3 LightDir = normalize(LightPos - v_FragPos);
+    vec3 LightDir = normalize(LightPos - v_FragPos * u_LightPos.w);
     float NDotL = max(dot(Normal, LightDir), 0.0);
     vec3 Diffuse = NDotL * LightColor;
 
     // Specular
-    float SpecularStrength = 0.5;
     vec3 ViewDir = normalize(EyePos - v_FragPos);
     vec3 HalfDir = normalize(ViewDir + LightDir);
-    float Spec = pow(max(0.0, dot(HalfDir, Normal)), 32);
-    vec3 Specular = vec3(SpecularStrength * Spec * LightColor);
+    float Spec = pow(max(0.0, dot(HalfDir, Normal)), Surface.m_SpecularExponent);
+    vec3 Specular = vec3(Surface.m_SpecularStrength * Spec * LightColor);
+
+    // Shadow
+    float Shadow = SampleShadow(Normal);
+
+    // Point Lights
+    vec3 PointLights = ShadePointLights(Surface, Normal, ViewDir);
 
     // Result
-    vec3 CombinedLight = Ambient + Diffuse + Specular;
-    FragColor = texture(u_Texture, v_TexCoord) * vec4(CombinedLight, u_Opacity);
+    vec3 CombinedLight = Ambient + Shadow * (Diffuse + Specular) + PointLights;
+    return SampleTexture(v_TexCoord) * Surface.m_BaseColor * vec4(CombinedLight, Opacity);
+#endif
+}
+
+#ifdef GLITTER_VISIBILITY_RESOLVE
+mat4 NodeModel(DrawData Draw)
+{
+    return transpose(mat4(Draw.m_ModelRows[0], Draw.m_ModelRows[1], Draw.m_ModelRows[2], vec4(0.0, 0.0, 0.0, 1.0)));
+}
+
+uint NodeTextureLayer(DrawData Draw) { return Draw.m_Packed & 0xFFFFu; }
+uint NodeMaterialID(DrawData Draw) { return (Draw.m_Packed >> 16) & 0x7FFFu; }
+
+// A page of the persistent per-Node data, indexed by Node slot modulo NODE_PAGE_SIZE.
+layout (std430, binding = 0) readonly buffer NodeData
+{
+    DrawData b_Nodes[];
+};
+
+// The Node slot of each draw.
+layout (std430, binding = 1) readonly buffer DrawNodes
+{
+    uint b_DrawNodes[];
+};
+
+struct DrawElementsIndirectCommand
+{
+    uint m_Count;
+    uint m_InstanceCount;
+    uint m_FirstIndex;
+    int m_BaseVertex;
+    uint m_BaseInstance;
+};
+
+// The commands the visibility buffer was drawn with, and the geometry pool's buffers, see Glitter::Render::GeometryPool.
+layout (std430, binding = 6) readonly buffer Commands
+{
+    DrawElementsIndirectCommand b_Commands[];
+};
+
+layout (std430, binding = 7) readonly buffer Indices
+{
+    uint b_Indices[];
+};
+
+layout (std430, binding = 8) readonly buffer Vertices
+{
+    uint b_Vertices[];
+};
+
+uint FetchIndex(uint Idx)
+{
+#ifdef GLITTER_SHORT_INDICES
+    uint Word = b_Indices[Idx >> 1];
+    return (Idx & 1u) == 0u ? Word & 0xFFFFu : Word >> 16;
+#else
+    return b_Indices[Idx];
+#endif
+}
+
+#ifdef GLITTER_QUANTIZED_VERTICES
+// Matches MainVS.glsl's.
+vec3 DecodeOctahedral(vec2 Encoded)
+{
+    vec3 Normal = vec3(Encoded, 1.0 - abs(Encoded.x) - abs(Encoded.y));
+    if (Normal.z < 0.0) {
+        Normal.xy = (1.0 - abs(Normal.yx)) * vec2(Normal.x >= 0.0 ? 1.0 : -1.0, Normal.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(Normal);
+}
+
+// A Glitter::Scene::QuantizedVertex, decoded like the Main VAO's attributes.
+void FetchVertex(uint Vertex, out vec3 Position, out vec2 TexCoord, out vec3 Normal)
+{
+    uint Base = Vertex * 4u;
+    Position = vec3(unpackUnorm2x16(b_Vertices[Base]), unpackUnorm2x16(b_Vertices[Base + 1u]).x);
+    TexCoord = unpackHalf2x16(b_Vertices[Base + 2u]);
+    int Packed = int(b_Vertices[Base + 3u]);
+    vec2 Encoded = vec2(bitfieldExtract(Packed, 0, 10), bitfieldExtract(Packed, 10, 10));
+    Normal = DecodeOctahedral(max(Encoded / 511.0, -1.0));
+}
+#else
+// A Glitter::Scene::MeshVertex.
+void FetchVertex(uint Vertex, out vec3 Position, out vec2 TexCoord, out vec3 Normal)
+{
+    uint Base = Vertex * 8u;
+    Position = uintBitsToFloat(uvec3(b_Vertices[Base], b_Vertices[Base + 1u], b_Vertices[Base + 2u]));
+    TexCoord = uintBitsToFloat(uvec2(b_Vertices[Base + 3u], b_Vertices[Base + 4u]));
+    Normal = uintBitsToFloat(uvec3(b_Vertices[Base + 5u], b_Vertices[Base + 6u], b_Vertices[Base + 7u]));
+}
+#endif
+
+// The perspective-correct barycentrics of `Ndc` in the triangle of clip-space vertices `Clip`, and their derivatives
+// along a pixel in x and y, as derived in Schied and Dachsbacher's "Deferred Attribute Interpolation for Memory-Efficient
+// Deferred Shading".
+void ComputeBarycentrics(vec4 Clip[3], vec2 Ndc, out vec3 Lambda, out vec3 LambdaDx, out vec3 LambdaDy)
+{
+    vec3 InvW = 1.0 / vec3(Clip[0].w, Clip[1].w, Clip[2].w);
+    vec2 Ndc0 = Clip[0].xy * InvW.x;
+    vec2 Ndc1 = Clip[1].xy * InvW.y;
+    vec2 Ndc2 = Clip[2].xy * InvW.z;
+
+    float InvDet = 1.0 / determinant(mat2(Ndc2 - Ndc1, Ndc0 - Ndc1));
+    vec3 Dx = vec3(Ndc1.y - Ndc2.y, Ndc2.y - Ndc0.y, Ndc0.y - Ndc1.y) * InvDet * InvW;
+    vec3 Dy = vec3(Ndc2.x - Ndc1.x, Ndc0.x - Ndc2.x, Ndc1.x - Ndc0.x) * InvDet * InvW;
+    float DxSum = Dx.x + Dx.y + Dx.z;
+    float DySum = Dy.x + Dy.y + Dy.z;
+
+    vec2 Delta = Ndc - Ndc0;
+    float InterpInvW = InvW.x + Delta.x * DxSum + Delta.y * DySum;
+    Lambda = (vec3(InvW.x, 0.0, 0.0) + Delta.x * Dx + Delta.y * Dy) / InterpInvW;
+
+    // From NDC units to pixels.
+    vec2 PixelScale = 2.0 / vec2(u_Size);
+    Dx *= PixelScale.x;
+    Dy *= PixelScale.y;
+    LambdaDx = (Lambda * InterpInvW + Dx) / (InterpInvW + DxSum * PixelScale.x) - Lambda;
+    LambdaDy = (Lambda * InterpInvW + Dy) / (InterpInvW + DySum * PixelScale.y) - Lambda;
+}
+
+// Fills in the fragment inputs of triangle `Primitive` of instance `Instance` of command `CommandIdx`, at this pixel.
+void LoadFragment(uint CommandIdx, uint Instance, uint Primitive)
+{
+    DrawElementsIndirectCommand Command = b_Commands[CommandIdx];
+    DrawData Draw = b_Nodes[b_DrawNodes[Command.m_BaseInstance + Instance] % NODE_PAGE_SIZE];
+
+    vec3 World[3];
+    vec4 Clip[3];
+    vec2 TexCoords[3];
+    vec3 Normals[3];
+    for (uint Corner = 0u; Corner < 3u; Corner++) {
+        uint Vertex = uint(int(FetchIndex(Command.m_FirstIndex + Primitive * 3u + Corner)) + Command.m_BaseVertex);
+        vec3 Position;
+        FetchVertex(Vertex, Position, TexCoords[Corner], Normals[Corner]);
+        World[Corner] = vec3(NodeModel(Draw) * vec4(Position, 1.0));
+        Clip[Corner] = u_ViewProjection * vec4(World[Corner], 1.0);
+    }
+
+    vec3 Lambda;
+    vec3 LambdaDx;
+    vec3 LambdaDy;
+    ComputeBarycentrics(Clip, PixelCoord / vec2(u_Size) * 2.0 - 1.0, Lambda, LambdaDx, LambdaDy);
+
+    v_FragPos = Lambda.x * World[0] + Lambda.y * World[1] + Lambda.z * World[2];
+    v_Normal = Lambda.x * Normals[0] + Lambda.y * Normals[1] + Lambda.z * Normals[2];
+    v_TexCoord = Lambda.x * TexCoords[0] + Lambda.y * TexCoords[1] + Lambda.z * TexCoords[2];
+    v_TexCoordDx = LambdaDx.x * TexCoords[0] + LambdaDx.y * TexCoords[1] + LambdaDx.z * TexCoords[2];
+    v_TexCoordDy = LambdaDy.x * TexCoords[0] + LambdaDy.y * TexCoords[1] + LambdaDy.z * TexCoords[2];
+    v_TextureLayer = NodeTextureLayer(Draw);
+    v_TextureHandle = Draw.m_TextureHandle;
+    v_MaterialID = NodeMaterialID(Draw);
+}
+
+void main()
+{
+    ivec2 Texel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(Texel, u_Size))) {
+        return;
+    }
+
+    // Pixels without an opaque Node keep the main pass' clear color. See depth/VisibilityFS.glsl.
+    uvec4 Visibility = texelFetch(u_Visibility, Texel, 0);
+    if (Visibility.x == 0u || Visibility.w != u_Pages) {
+        return;
+    }
+    LoadFragment(Visibility.x - 1u, Visibility.y, Visibility.z);
+    imageStore(u_Color, Texel, Shade());
+}
+#elif defined(GLITTER_IMPOSTOR)
+// The frames of every impostor and their depth, see Glitter::Render::ImpostorAtlas.
+layout (binding = 3) uniform sampler2DArray u_ImpostorAtlas;
+layout (binding = 4) uniform sampler2DArray u_ImpostorDepth;
+
+// Matches MainVS.glsl's.
+vec3 DecodeOctahedral(vec2 Encoded)
+{
+    vec3 Normal = vec3(Encoded, 1.0 - abs(Encoded.x) - abs(Encoded.y));
+    if (Normal.z < 0.0) {
+        Normal.xy = (1.0 - abs(Normal.yx)) * vec2(Normal.x >= 0.0 ? 1.0 : -1.0, Normal.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(Normal);
+}
+
+// Fills in the fragment inputs from the surface the frame's texel holds, moved from the quad to the depth it was baked
+// at, and writes that depth. Returns false where the Mesh doesn't cover the texel.
+bool LoadImpostor()
+{
+    vec4 Texel = texture(u_ImpostorAtlas, v_AtlasCoord);
+    float Depth = textureLod(u_ImpostorDepth, v_AtlasCoord, 0.0).x;
+    v_TexCoord = Texel.xy;
+    v_Normal = v_NormalMatrix * DecodeOctahedral(Texel.zw);
+    v_FragPos = v_QuadPos + v_DepthOffset * (1.0 - 2.0 * Depth);
+
+    vec4 Clip = u_ViewProjection * vec4(v_FragPos, 1.0);
+    gl_FragDepth = Clip.z / Clip.w * 0.5 + 0.5;
+    return Texel.z <= 1.5;
+}
+
+void main()
+{
+    // Only discarded once shaded, so that the texture coordinates' derivatives stay defined.
+    bool Covered = LoadImpostor();
+    vec4 Color = Shade();
+    if (!Covered) {
+        discard;
+    }
+    FragColor = Color;
+}
+#else
+void main()
+{
+    vec4 Color = Shade();
+#ifdef GLITTER_WEIGHTED_OIT
+    Accumulation = vec4(Color.rgb * Color.a, Color.a) * OitWeight(Color.a);
+    Revealage = Color.a;
+#else
+    FragColor = Color;
+#ifdef GLITTER_NODE_ID
+    NodeId = v_NodeId;
+#endif
+#endif
 }
+#endif
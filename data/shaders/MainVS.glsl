@@ -1,35 +1,184 @@
 #version 460 core
+#extension GL_GOOGLE_include_directive : require
 
+#ifdef GLITTER_MULTIVIEW
+// Both eyes at once, into the layers of Glitter::Render::StereoTargets.
+#extension GL_OVR_multiview : require
+layout (num_views = 2) in;
+#endif
+
+#ifdef GLITTER_VERTEX_PULLING
+// The geometry pool's VBO, see Glitter::Config::ENABLE_VERTEX_PULLING.
+layout (std430, binding = 8) readonly buffer Vertices
+{
+    uint b_Vertices[];
+};
+#else
 layout (location = 0) in vec3 a_Position;
 layout (location = 1) in vec2 a_TexCoord;
+#ifdef GLITTER_QUANTIZED_VERTICES
+// Octahedral-encoded in xy, see Glitter::Scene::QuantizeAsset().
+layout (location = 2) in vec4 a_Normal;
+#else
 layout (location = 2) in vec3 a_Normal;
+#endif
+#endif
+
+// CommonData and DrawData, see Glitter::Render::GenerateShaderDataGlsl().
+#include "ShaderData.glsl"
+
+mat4 NodeModel(DrawData Draw)
+{
+    return transpose(mat4(Draw.m_ModelRows[0], Draw.m_ModelRows[1], Draw.m_ModelRows[2], vec4(0.0, 0.0, 0.0, 1.0)));
+}
+
+uint NodeTextureLayer(DrawData Draw) { return Draw.m_Packed & 0xFFFFu; }
+uint NodeMaterialID(DrawData Draw) { return (Draw.m_Packed >> 16) & 0x7FFFu; }
 
-layout (std140, binding = 0) uniform CommonData
+const uint NODE_ANIMATE = 1u << 31;
+
+// Matches Glitter::Scene::AnimatedOpacity().
+float EvaluateOpacity(DrawData Draw)
+{
+    if ((Draw.m_Packed & NODE_ANIMATE) != 0u) {
+        return clamp(abs(1.25 * cos(u_Time.x + Draw.m_OpacityOrPhase)), 0.0, 1.0);
+    }
+    return Draw.m_OpacityOrPhase;
+}
+
+// A page of the persistent per-Node data, indexed by Node slot modulo NODE_PAGE_SIZE.
+layout (std430, binding = 0) readonly buffer NodeData
 {
-    mat4 u_View;
-    mat4 u_Projection;
-    vec4 u_EyePos;
-    vec4 u_LightPos;
-    vec4 u_LightColor;
+    DrawData b_Nodes[];
 };
 
-layout (std140, binding = 1) uniform PerDrawData
+// The Node slot of each draw.
+layout (std430, binding = 1) readonly buffer DrawNodes
 {
-    mat4 u_Model;
-    float u_Opacity;
+    uint b_DrawNodes[];
 };
 
-out vec2 v_TexCoord;
-out vec3 v_Normal;
-out vec3 v_FragPos;
-out vec4 v_EyePos;
+#if defined(GLITTER_DEBUG_LOD) || defined(GLITTER_DEBUG_CULL_STATE)
+// The LOD level of each draw in bits 0-7 and its cull state in 8-15, in the same order, see PackDrawInfo().
+layout (std430, binding = 12) readonly buffer DrawInfo
+{
+    uint b_DrawInfo[];
+};
+#endif
+
+#ifdef GLITTER_QUANTIZED_VERTICES
+vec3 DecodeOctahedral(vec2 Encoded)
+{
+    vec3 Normal = vec3(Encoded, 1.0 - abs(Encoded.x) - abs(Encoded.y));
+    if (Normal.z < 0.0) {
+        Normal.xy = (1.0 - abs(Normal.yx)) * vec2(Normal.x >= 0.0 ? 1.0 : -1.0, Normal.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(Normal);
+}
+#endif
+
+#ifdef GLITTER_VERTEX_PULLING
+// Decoded like the Main VAO's attributes, and like MainFS.glsl's visibility resolve. Matches depth/DepthVS.glsl's.
+#ifdef GLITTER_QUANTIZED_VERTICES
+vec3 FetchPosition(uint Vertex)
+{
+    uint Base = Vertex * 4u;
+    return vec3(unpackUnorm2x16(b_Vertices[Base]), unpackUnorm2x16(b_Vertices[Base + 1u]).x);
+}
+
+// A Glitter::Scene::QuantizedVertex.
+void FetchVertex(uint Vertex, out vec3 Position, out vec2 TexCoord, out vec3 Normal)
+{
+    uint Base = Vertex * 4u;
+    Position = FetchPosition(Vertex);
+    TexCoord = unpackHalf2x16(b_Vertices[Base + 2u]);
+    int Packed = int(b_Vertices[Base + 3u]);
+    vec2 Encoded = vec2(bitfieldExtract(Packed, 0, 10), bitfieldExtract(Packed, 10, 10));
+    Normal = DecodeOctahedral(max(Encoded / 511.0, -1.0));
+}
+#else
+vec3 FetchPosition(uint Vertex)
+{
+    uint Base = Vertex * 8u;
+    return uintBitsToFloat(uvec3(b_Vertices[Base], b_Vertices[Base + 1u], b_Vertices[Base + 2u]));
+}
+
+// A Glitter::Scene::MeshVertex.
+void FetchVertex(uint Vertex, out vec3 Position, out vec2 TexCoord, out vec3 Normal)
+{
+    uint Base = Vertex * 8u;
+    Position = FetchPosition(Vertex);
+    TexCoord = uintBitsToFloat(uvec2(b_Vertices[Base + 3u], b_Vertices[Base + 4u]));
+    Normal = uintBitsToFloat(uvec3(b_Vertices[Base + 5u], b_Vertices[Base + 6u], b_Vertices[Base + 7u]));
+}
+#endif
+#endif
+
+// Explicit locations, since SPIR-V modules only match their interfaces by location.
+layout (location = 0) out vec2 v_TexCoord;
+layout (location = 1) out vec3 v_Normal;
+layout (location = 2) out vec3 v_FragPos;
+layout (location = 3) out vec4 v_EyePos;
+#ifdef GLITTER_TRANSPARENT
+layout (location = 4) flat out float v_Opacity;
+#endif
+layout (location = 5) flat out uint v_TextureLayer;
+layout (location = 6) flat out uvec2 v_TextureHandle;
+layout (location = 7) flat out uint v_MaterialID;
+#ifdef GLITTER_NODE_ID
+// The Node's slot plus 1, written into the Node ID target, see Glitter::Render::NodePicker.
+layout (location = 8) flat out uint v_NodeId;
+#endif
+#if defined(GLITTER_DEBUG_LOD) || defined(GLITTER_DEBUG_CULL_STATE)
+layout (location = 9) flat out uint v_DrawInfo;
+#endif
+
+// Matches depth/DepthVS.glsl's, for the GL_EQUAL depth test after the depth pre-pass.
+invariant gl_Position;
 
 void main()
 {
-    gl_Position = u_Projection * u_View * u_Model * vec4(a_Position, 1.0);
+    uint NodeSlot = b_DrawNodes[gl_BaseInstance + gl_InstanceID];
+    DrawData Draw = b_Nodes[NodeSlot % NODE_PAGE_SIZE];
+    mat4 Model = NodeModel(Draw);
 
+#ifdef GLITTER_VERTEX_PULLING
+    // gl_VertexID already includes the draw's base vertex.
+    vec3 Position;
+    vec3 Normal;
+    FetchVertex(uint(gl_VertexID), Position, v_TexCoord, Normal);
+#else
+    vec3 Position = a_Position;
     v_TexCoord = a_TexCoord;
-    v_Normal = a_Normal;
-    v_FragPos = vec3(u_Model * vec4(a_Position, 1.0));
+#ifdef GLITTER_QUANTIZED_VERTICES
+    vec3 Normal = DecodeOctahedral(a_Normal.xy);
+#else
+    vec3 Normal = a_Normal;
+#endif
+#endif
+    vec4 World = Model * vec4(Position, 1.0);
+#ifdef GLITTER_MULTIVIEW
+    gl_Position = u_EyeViewProjections[gl_ViewID_OVR] * World;
+#else
+    gl_Position = u_ViewProjection * World;
+#endif
+
+    // The cofactor matrix is the inverse-transpose up to a scale, which the fragment shader normalizes away. It keeps the
+    // normals perpendicular through non-uniform scales, the dequantization's included.
+    mat3 Cofactor = mat3(cross(Model[1].xyz, Model[2].xyz), cross(Model[2].xyz, Model[0].xyz), cross(Model[0].xyz, Model[1].xyz));
+    v_Normal = Cofactor * Normal;
+    v_FragPos = World.xyz;
     v_EyePos = u_EyePos;
+#ifdef GLITTER_TRANSPARENT
+    v_Opacity = EvaluateOpacity(Draw);
+#endif
+    v_TextureLayer = NodeTextureLayer(Draw);
+    v_TextureHandle = Draw.m_TextureHandle;
+    v_MaterialID = NodeMaterialID(Draw);
+#ifdef GLITTER_NODE_ID
+    v_NodeId = NodeSlot + 1u;
+#endif
+#if defined(GLITTER_DEBUG_LOD) || defined(GLITTER_DEBUG_CULL_STATE)
+    v_DrawInfo = b_DrawInfo[gl_BaseInstance + gl_InstanceID];
+#endif
 }
@@ -0,0 +1,163 @@
+#version 460 core
+
+// Copies the Primitives of the static Nodes into their batches, see Glitter::Render::StaticBatches: each work group
+// transforms the vertices of one part into its batch's vertex space, with the same vertex format, and offsets its indices
+// by where its vertices landed in the batch. The batches and the Primitives they're copied from are disjoint ranges of the
+// same buffers.
+layout (local_size_x = 64) in;
+
+struct Part
+{
+    // From the Primitive's vertices into the batch's.
+    mat4 m_Transform;
+    int m_SourceBaseVertex;
+    uint m_SourceFirstIndex;
+    // 0 for the parts of the HLOD proxies, whose indices are over the vertices their batch's parts copied.
+    uint m_VertexCount;
+    uint m_SourceIndexCount;
+    uint m_BaseVertex;
+    uint m_FirstIndex;
+    // Past m_SourceIndexCount, the last index is repeated into a degenerate triangle.
+    uint m_IndexCount;
+    // Of m_BaseVertex from the batch's base vertex, which its indices are relative to.
+    uint m_VertexOffset;
+};
+
+// The geometry pool's VBO, position-only stream and EBO.
+layout (std430, binding = 0) buffer Vertices
+{
+    uint b_Vertices[];
+};
+
+layout (std430, binding = 1) writeonly buffer Positions
+{
+    uint b_Positions[];
+};
+
+layout (std430, binding = 2) buffer Indices
+{
+    uint b_Indices[];
+};
+
+layout (std430, binding = 3) readonly buffer Parts
+{
+    Part b_Parts[];
+};
+
+// The part of the first work group, the parts are dispatched in chunks of the work group count limit.
+layout (location = 0) uniform uint u_FirstPart;
+
+#ifdef GLITTER_QUANTIZED_VERTICES
+// Matches MainVS.glsl's.
+vec3 DecodeOctahedral(vec2 Encoded)
+{
+    vec3 Normal = vec3(Encoded, 1.0 - abs(Encoded.x) - abs(Encoded.y));
+    if (Normal.z < 0.0) {
+        Normal.xy = (1.0 - abs(Normal.yx)) * vec2(Normal.x >= 0.0 ? 1.0 : -1.0, Normal.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(Normal);
+}
+
+// Matches EncodeOctahedral() in Glitter::Scene::QuantizeAsset().
+vec2 EncodeOctahedral(vec3 Normal)
+{
+    float Length = abs(Normal.x) + abs(Normal.y) + abs(Normal.z);
+    if (Length == 0.0) {
+        return vec2(0.0);
+    }
+
+    vec2 Encoded = Normal.xy / Length;
+    if (Normal.z < 0.0) {
+        Encoded = (1.0 - abs(Encoded.yx)) * vec2(Encoded.x >= 0.0 ? 1.0 : -1.0, Encoded.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return Encoded;
+}
+
+uint QuantizeSnorm10(float Value)
+{
+    return uint(int(round(clamp(Value, -1.0, 1.0) * 511.0))) & 0x3FFu;
+}
+
+// A Glitter::Scene::QuantizedVertex, whose position stream holds its first two words.
+void CopyVertex(Part Batch, uint Vertex, mat3 Cofactor)
+{
+    uint Source = (uint(Batch.m_SourceBaseVertex) + Vertex) * 4u;
+    uint Destination = (Batch.m_BaseVertex + Vertex) * 4u;
+
+    vec3 Position = vec3(unpackUnorm2x16(b_Vertices[Source]), unpackUnorm2x16(b_Vertices[Source + 1u]).x);
+    Position = clamp((Batch.m_Transform * vec4(Position, 1.0)).xyz, 0.0, 1.0);
+    uvec2 Packed = uvec2(packUnorm2x16(Position.xy), packUnorm2x16(vec2(Position.z, 0.0)));
+
+    int Normal = int(b_Vertices[Source + 3u]);
+    vec2 Encoded = vec2(bitfieldExtract(Normal, 0, 10), bitfieldExtract(Normal, 10, 10));
+    Encoded = EncodeOctahedral(normalize(Cofactor * DecodeOctahedral(max(Encoded / 511.0, -1.0))));
+
+    b_Vertices[Destination] = Packed.x;
+    b_Vertices[Destination + 1u] = Packed.y;
+    b_Vertices[Destination + 2u] = b_Vertices[Source + 2u];
+    b_Vertices[Destination + 3u] = QuantizeSnorm10(Encoded.x) | (QuantizeSnorm10(Encoded.y) << 10);
+    b_Positions[(Batch.m_BaseVertex + Vertex) * 2u] = Packed.x;
+    b_Positions[(Batch.m_BaseVertex + Vertex) * 2u + 1u] = Packed.y;
+}
+#else
+// A Glitter::Scene::MeshVertex, whose position stream holds its first three words.
+void CopyVertex(Part Batch, uint Vertex, mat3 Cofactor)
+{
+    uint Source = (uint(Batch.m_SourceBaseVertex) + Vertex) * 8u;
+    uint Destination = (Batch.m_BaseVertex + Vertex) * 8u;
+
+    vec3 Position = uintBitsToFloat(uvec3(b_Vertices[Source], b_Vertices[Source + 1u], b_Vertices[Source + 2u]));
+    uvec3 Packed = floatBitsToUint((Batch.m_Transform * vec4(Position, 1.0)).xyz);
+    vec3 Normal = uintBitsToFloat(uvec3(b_Vertices[Source + 5u], b_Vertices[Source + 6u], b_Vertices[Source + 7u]));
+    uvec3 PackedNormal = floatBitsToUint(normalize(Cofactor * Normal));
+
+    b_Vertices[Destination] = Packed.x;
+    b_Vertices[Destination + 1u] = Packed.y;
+    b_Vertices[Destination + 2u] = Packed.z;
+    b_Vertices[Destination + 3u] = b_Vertices[Source + 3u];
+    b_Vertices[Destination + 4u] = b_Vertices[Source + 4u];
+    b_Vertices[Destination + 5u] = PackedNormal.x;
+    b_Vertices[Destination + 6u] = PackedNormal.y;
+    b_Vertices[Destination + 7u] = PackedNormal.z;
+    b_Positions[(Batch.m_BaseVertex + Vertex) * 3u] = Packed.x;
+    b_Positions[(Batch.m_BaseVertex + Vertex) * 3u + 1u] = Packed.y;
+    b_Positions[(Batch.m_BaseVertex + Vertex) * 3u + 2u] = Packed.z;
+}
+#endif
+
+// The `Index`th index of the part, relative to the batch's base vertex.
+uint FetchIndex(Part Batch, uint Index)
+{
+    uint Source = Batch.m_SourceFirstIndex + min(Index, Batch.m_SourceIndexCount - 1u);
+#ifdef GLITTER_SHORT_INDICES
+    uint Value = (b_Indices[Source >> 1u] >> ((Source & 1u) * 16u)) & 0xFFFFu;
+#else
+    uint Value = b_Indices[Source];
+#endif
+    return Value + Batch.m_VertexOffset;
+}
+
+void main()
+{
+    Part Batch = b_Parts[u_FirstPart + gl_WorkGroupID.x];
+
+    // Matches MainVS.glsl's cofactor, so that the normals come out perpendicular once the batch's own model matrix
+    // transforms them in turn.
+    mat3 Model = mat3(Batch.m_Transform);
+    mat3 Cofactor = mat3(cross(Model[1], Model[2]), cross(Model[2], Model[0]), cross(Model[0], Model[1]));
+    for (uint Vertex = gl_LocalInvocationID.x; Vertex < Batch.m_VertexCount; Vertex += gl_WorkGroupSize.x) {
+        CopyVertex(Batch, Vertex, Cofactor);
+    }
+
+    // 16-bit indices are written two at a time, each part starts at an even index.
+#ifdef GLITTER_SHORT_INDICES
+    for (uint Word = gl_LocalInvocationID.x; Word < Batch.m_IndexCount / 2u; Word += gl_WorkGroupSize.x) {
+        uint Index = Word * 2u;
+        b_Indices[(Batch.m_FirstIndex >> 1u) + Word] = FetchIndex(Batch, Index) | (FetchIndex(Batch, Index + 1u) << 16u);
+    }
+#else
+    for (uint Index = gl_LocalInvocationID.x; Index < Batch.m_IndexCount; Index += gl_WorkGroupSize.x) {
+        b_Indices[Batch.m_FirstIndex + Index] = FetchIndex(Batch, Index);
+    }
+#endif
+}
@@ -0,0 +1,329 @@
+#version 460 core
+#extension GL_GOOGLE_include_directive : require
+
+layout (local_size_x = 64) in;
+
+// CommonData and DrawData, see Glitter::Render::GenerateShaderDataGlsl().
+#include "ShaderData.glsl"
+
+const uint NODE_ANIMATE = 1u << 31;
+
+// Matches Glitter::Scene::AnimatedOpacity().
+float EvaluateOpacity(DrawData Draw)
+{
+    if ((Draw.m_Packed & NODE_ANIMATE) != 0u) {
+        return clamp(abs(1.25 * cos(u_Time.x + Draw.m_OpacityOrPhase)), 0.0, 1.0);
+    }
+    return Draw.m_OpacityOrPhase;
+}
+
+struct NodeBounds
+{
+    vec3 m_Center;
+    uint m_MeshID;
+    vec3 m_Extent;
+    uint m_Padding;
+};
+
+struct MeshInfo
+{
+    uint m_FirstPrimitive;
+    uint m_PrimitiveCount;
+    uvec2 m_Padding;
+    // Inverse of the Mesh's dequantization, only used by the meshlet pass.
+    mat4 m_Quantize;
+};
+
+struct PrimitiveInfo
+{
+    uint m_Count;
+    uint m_FirstIndex;
+    int m_BaseVertex;
+    uint m_FirstMeshlet;
+    uint m_MeshletCount;
+    // The geometry pool page of its indices and vertices.
+    uint m_Page;
+    uint m_Padding[2];
+};
+
+struct DrawCommand
+{
+    uint m_Count;
+    uint m_InstanceCount;
+    uint m_FirstIndex;
+    int m_BaseVertex;
+    uint m_BaseInstance;
+};
+
+// A page of the persistent per-Node data and bounds, see NODE_PAGE_SIZE.
+layout (std430, binding = 0) readonly buffer NodeData
+{
+    DrawData b_Nodes[];
+};
+
+layout (std430, binding = 1) readonly buffer Bounds
+{
+    NodeBounds b_Bounds[];
+};
+
+layout (std430, binding = 2) readonly buffer Meshes
+{
+    MeshInfo b_Meshes[];
+};
+
+layout (std430, binding = 3) readonly buffer Primitives
+{
+    PrimitiveInfo b_Primitives[];
+};
+
+// Opaque commands are appended from u_CommandBase, transparent ones from halfway through the region by
+// TransparentCommandsCS.glsl.
+layout (std430, binding = 4) writeonly buffer Commands
+{
+    DrawCommand b_Commands[];
+};
+
+// Followed by the indirect dispatch of MeshletCullCS, which loops over the b_MeshletWorkCount items with its work groups.
+layout (std430, binding = 5) buffer DrawCounts
+{
+    uint b_OpaqueCount;
+    uint b_TransparentCount;
+    uint b_TransparentNodeCount;
+    uint b_Padding;
+    uint b_MeshletGroupsX;
+    uint b_MeshletGroupsY;
+    uint b_MeshletGroupsZ;
+    uint b_MeshletWorkCount;
+};
+
+// The Node slot of each command, laid out like the commands.
+layout (std430, binding = 6) writeonly buffer DrawNodes
+{
+    uint b_DrawNodes[];
+};
+
+// The opaque Primitives split into meshlets, as (Node, Primitive, Mesh) items, culled further by MeshletCullCS.
+layout (std430, binding = 7) writeonly buffer MeshletWork
+{
+    uvec4 b_MeshletWork[];
+};
+
+// The visible transparent Nodes, as (sort key, Node), sorted back to front by TransparentSortCS.glsl.
+layout (std430, binding = 10) writeonly buffer SortItems
+{
+    uvec2 b_SortItems[];
+};
+
+// Matches Glitter::Config::MESH_LOD_COUNT.
+const uint LOD_COUNT = 4u;
+
+// The Nodes kept and culled by each test, see Glitter::Render::GpuCullCounts. Each workgroup counts its Nodes in shared
+// memory first, so that there's a single atomic per counter and workgroup.
+const uint STATISTIC_VISIBLE = 0u;
+const uint STATISTIC_FRUSTUM_CULLED = 1u;
+const uint STATISTIC_CONTRIBUTION_CULLED = 2u;
+const uint STATISTIC_OCCLUSION_CULLED = 3u;
+const uint STATISTIC_FIRST_LOD = 4u;
+const uint STATISTIC_COUNT = STATISTIC_FIRST_LOD + LOD_COUNT;
+// A Node of none of them, past the Node count or fully transparent.
+const uint STATISTIC_NONE = STATISTIC_COUNT;
+
+layout (std430, binding = 13) buffer CullStatistics
+{
+    uint b_Statistics[STATISTIC_COUNT];
+};
+
+shared uint s_Statistics[STATISTIC_COUNT];
+
+// The minimum GL_MAX_COMPUTE_WORK_GROUP_COUNT.
+const uint MAX_MESHLET_GROUPS = 65535u;
+
+// The Nodes of the bound page of Node data, from u_FirstNode to u_NodeCount.
+layout (location = 0) uniform uint u_NodeCount;
+layout (location = 1) uniform uint u_FirstNode;
+layout (location = 2) uniform bool u_FrustumCulling;
+layout (location = 3) uniform bool u_OcclusionCulling;
+layout (location = 4) uniform vec2 u_HiZSize;
+layout (location = 5) uniform bool u_MeshletCulling;
+// x: the max draw distance; y: the min projected size in pixels; z: the pixels of one world unit at unit distance.
+layout (location = 6) uniform vec3 u_ContributionCulling;
+// Whether to count the Nodes into b_Statistics.
+layout (location = 7) uniform bool u_Statistics;
+// x: the LOD bias' scale of the projected size over Glitter::Config::MESH_LOD_CELL_PIXELS; y: MESH_LOD_RESOLUTION.
+layout (location = 8) uniform vec2 u_LodSelection;
+// The geometry pool page whose Primitives are drawn, and the first command of the region of the buffers its draws of the
+// page's Nodes are appended to, see GlitterApplication::DispatchGpuCulling().
+layout (location = 9) uniform uint u_Page;
+layout (location = 10) uniform uint u_CommandBase;
+
+// Last frame's Hi-Z pyramid, built with u_HiZViewProjection over its u_HiZSize viewport.
+layout (binding = 1) uniform sampler2D u_HiZ;
+
+// The texel of the pyramid's viewport at `Level` covering `Uv`, in [0, 1] across the viewport.
+float FetchHiZ(vec2 Uv, int Level)
+{
+    ivec2 LevelSize = max(ivec2(u_HiZSize) >> Level, ivec2(1));
+    ivec2 Texel = min(ivec2(Uv * u_HiZSize) >> Level, LevelSize - 1);
+    return texelFetch(u_HiZ, Texel, Level).r;
+}
+
+// Matches GlitterApplication::ProjectedPixels(): the height in pixels of the bounds' bounding sphere.
+float GetProjectedPixels(NodeBounds Bounds)
+{
+    float Distance = max(distance(u_EyePos.xyz, Bounds.m_Center), 1e-4);
+    return 2.0 * length(Bounds.m_Extent) * u_ContributionCulling.z / Distance;
+}
+
+// Matches the contribution culling of GlitterApplication::UpdateFrame(): whether the bounds are close and large enough to
+// be drawn.
+bool IsContributing(NodeBounds Bounds)
+{
+    vec3 Outside = max(abs(u_EyePos.xyz - Bounds.m_Center) - Bounds.m_Extent, 0.0);
+    if (dot(Outside, Outside) > u_ContributionCulling.x * u_ContributionCulling.x) {
+        return false;
+    }
+    return GetProjectedPixels(Bounds) >= u_ContributionCulling.y;
+}
+
+// Matches GlitterApplication::SelectLod().
+uint SelectLod(NodeBounds Bounds)
+{
+    float RequiredResolution = GetProjectedPixels(Bounds) * u_LodSelection.x;
+    uint Level = 0u;
+    float Resolution = u_LodSelection.y;
+    while (Level + 1u < LOD_COUNT && Resolution >= RequiredResolution) {
+        Level++;
+        Resolution *= 0.5;
+    }
+    return Level;
+}
+
+bool IsVisible(NodeBounds Bounds)
+{
+    for (int i = 0; i < 6; i++) {
+        vec4 Plane = u_FrustumPlanes[i];
+        float Distance = dot(Plane.xyz, Bounds.m_Center) + Plane.w;
+        float Radius = dot(abs(Plane.xyz), Bounds.m_Extent);
+        if (Distance + Radius <= 0.0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Projects the AABB with the Hi-Z pyramid's View-Projection and tests its nearest depth against the furthest depth of
+// the pyramid texels covering its screen-space rectangle.
+bool IsOccluded(NodeBounds Bounds)
+{
+    vec3 RectMin = vec3(1.0);
+    vec3 RectMax = vec3(0.0);
+    for (int i = 0; i < 8; i++) {
+        vec3 Corner = Bounds.m_Center + Bounds.m_Extent * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0,
+            (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 Clip = u_HiZViewProjection * vec4(Corner, 1.0);
+
+        // A corner behind the camera means the AABB crosses the near plane, so it can't be occluded.
+        if (Clip.w <= 0.0) {
+            return false;
+        }
+
+        vec3 Window = (Clip.xyz / Clip.w) * 0.5 + 0.5;
+        RectMin = min(RectMin, Window);
+        RectMax = max(RectMax, Window);
+    }
+    RectMin.xy = clamp(RectMin.xy, 0.0, 1.0);
+    RectMax.xy = clamp(RectMax.xy, 0.0, 1.0);
+
+    // Pick the level where the rectangle spans at most 2x2 texels, so that 4 samples cover it.
+    vec2 RectSize = (RectMax.xy - RectMin.xy) * u_HiZSize;
+    int Level = min(int(ceil(log2(max(max(RectSize.x, RectSize.y), 1.0)))), textureQueryLevels(u_HiZ) - 1);
+
+    float HiZDepth = max(max(FetchHiZ(RectMin.xy, Level), FetchHiZ(vec2(RectMax.x, RectMin.y), Level)),
+        max(FetchHiZ(vec2(RectMin.x, RectMax.y), Level), FetchHiZ(RectMax.xy, Level)));
+
+    return RectMin.z > HiZDepth;
+}
+
+// Culls `Node`, appending its commands if it's visible, and returns the statistic it counts towards.
+uint CullNode(uint Node)
+{
+    // Don't bother drawing a totally transparent Node.
+    float Opacity = EvaluateOpacity(b_Nodes[Node % NODE_PAGE_SIZE]);
+    if (Opacity == 0.0) {
+        return STATISTIC_NONE;
+    }
+
+    NodeBounds Bounds = b_Bounds[Node % NODE_PAGE_SIZE];
+    if (u_FrustumCulling && !IsVisible(Bounds)) {
+        return STATISTIC_FRUSTUM_CULLED;
+    }
+    if (!IsContributing(Bounds)) {
+        return STATISTIC_CONTRIBUTION_CULLED;
+    }
+    if (u_OcclusionCulling && IsOccluded(Bounds)) {
+        return STATISTIC_OCCLUSION_CULLED;
+    }
+
+    // Compact the transparent Nodes into the list to sort, keyed by the bit-inverted distance from the eye: floats of the
+    // same sign order like their bits, so the furthest Node has the lowest key.
+    if (Opacity < 1.0) {
+        uint Item = atomicAdd(b_TransparentNodeCount, 1);
+        b_SortItems[Item] = uvec2(~floatBitsToUint(distance(u_EyePos.xyz, Bounds.m_Center)), Node);
+        return STATISTIC_VISIBLE;
+    }
+
+    // Append one command per Primitive of the Node's Mesh on u_Page, fetching the Node's slot through gl_BaseInstance. The
+    // Primitives split into meshlets are handed to the meshlet pass instead, which appends their visible meshlets.
+    MeshInfo Mesh = b_Meshes[Bounds.m_MeshID];
+    bool SplitMeshlets = u_MeshletCulling;
+    uint CommandCount = 0;
+    for (uint i = 0; i < Mesh.m_PrimitiveCount; i++) {
+        PrimitiveInfo Primitive = b_Primitives[Mesh.m_FirstPrimitive + i];
+        if (Primitive.m_Page == u_Page && (!SplitMeshlets || Primitive.m_MeshletCount == 0)) {
+            CommandCount++;
+        }
+    }
+
+    uint Command = u_CommandBase + atomicAdd(b_OpaqueCount, CommandCount);
+
+    for (uint i = 0; i < Mesh.m_PrimitiveCount; i++) {
+        PrimitiveInfo Primitive = b_Primitives[Mesh.m_FirstPrimitive + i];
+        if (Primitive.m_Page != u_Page) {
+            continue;
+        }
+        if (SplitMeshlets && Primitive.m_MeshletCount != 0) {
+            uint Item = atomicAdd(b_MeshletWorkCount, 1);
+            b_MeshletWork[Item] = uvec4(Node, Mesh.m_FirstPrimitive + i, Bounds.m_MeshID, 0);
+            atomicMax(b_MeshletGroupsX, min(Item + 1, MAX_MESHLET_GROUPS));
+            continue;
+        }
+
+        b_Commands[Command] = DrawCommand(Primitive.m_Count, 1, Primitive.m_FirstIndex, Primitive.m_BaseVertex, Command);
+        b_DrawNodes[Command] = Node;
+        Command++;
+    }
+    return STATISTIC_VISIBLE;
+}
+
+void main()
+{
+    uint Node = u_FirstNode + gl_GlobalInvocationID.x;
+    uint Statistic = Node < u_NodeCount ? CullNode(Node) : STATISTIC_NONE;
+
+    if (u_Statistics) {
+        if (gl_LocalInvocationIndex < STATISTIC_COUNT) {
+            s_Statistics[gl_LocalInvocationIndex] = 0u;
+        }
+        barrier();
+        if (Statistic != STATISTIC_NONE) {
+            atomicAdd(s_Statistics[Statistic], 1u);
+        }
+        if (Statistic == STATISTIC_VISIBLE) {
+            atomicAdd(s_Statistics[STATISTIC_FIRST_LOD + SelectLod(b_Bounds[Node % NODE_PAGE_SIZE])], 1u);
+        }
+        barrier();
+        if (gl_LocalInvocationIndex < STATISTIC_COUNT && s_Statistics[gl_LocalInvocationIndex] != 0u) {
+            atomicAdd(b_Statistics[gl_LocalInvocationIndex], s_Statistics[gl_LocalInvocationIndex]);
+        }
+    }
+}
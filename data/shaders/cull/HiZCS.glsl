@@ -0,0 +1,46 @@
+#version 460 core
+
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (binding = 0) uniform sampler2D u_Depth;
+layout (binding = 0, r32f) uniform readonly image2D u_Source;
+layout (binding = 1, r32f) uniform writeonly image2D u_Destination;
+
+layout (location = 0) uniform bool u_FromDepth;
+layout (location = 1) uniform ivec2 u_SourceSize;
+// The viewport's part of the destination level, the rest of it is left alone.
+layout (location = 2) uniform ivec2 u_DestinationSize;
+
+void main()
+{
+    ivec2 Texel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 Size = u_DestinationSize;
+    if (any(greaterThanEqual(Texel, Size))) {
+        return;
+    }
+
+    // Level 0 is a straight copy of the depth buffer.
+    if (u_FromDepth) {
+        imageStore(u_Destination, Texel, vec4(texelFetch(u_Depth, Texel, 0).r));
+        return;
+    }
+
+    // Keep the furthest depth of the texels below. When the source size is odd, the last texel of each row and column
+    // would be skipped, so the destination's last texels also cover it. Out-of-bounds loads return 0, the nearest depth.
+    ivec2 Source = Texel * 2;
+    ivec2 Footprint = ivec2(2);
+    if ((u_SourceSize.x & 1) != 0 && Texel.x == Size.x - 1) {
+        Footprint.x = 3;
+    }
+    if ((u_SourceSize.y & 1) != 0 && Texel.y == Size.y - 1) {
+        Footprint.y = 3;
+    }
+
+    float Depth = 0.0;
+    for (int y = 0; y < Footprint.y; y++) {
+        for (int x = 0; x < Footprint.x; x++) {
+            Depth = max(Depth, imageLoad(u_Source, Source + ivec2(x, y)).r);
+        }
+    }
+    imageStore(u_Destination, Texel, vec4(Depth));
+}
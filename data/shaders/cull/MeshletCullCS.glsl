@@ -0,0 +1,205 @@
+#version 460 core
+#extension GL_GOOGLE_include_directive : require
+
+// Each work group culls the meshlets of one (Node, Primitive) pair handed over by CullCS at a time.
+layout (local_size_x = 64) in;
+
+// CommonData and DrawData, see Glitter::Render::GenerateShaderDataGlsl().
+#include "ShaderData.glsl"
+
+mat4 NodeModel(DrawData Draw)
+{
+    return transpose(mat4(Draw.m_ModelRows[0], Draw.m_ModelRows[1], Draw.m_ModelRows[2], vec4(0.0, 0.0, 0.0, 1.0)));
+}
+
+struct MeshInfo
+{
+    uint m_FirstPrimitive;
+    uint m_PrimitiveCount;
+    uvec2 m_Padding;
+    // Inverse of the Mesh's dequantization, maps Mesh space into the space NodeModel() expects.
+    mat4 m_Quantize;
+};
+
+struct PrimitiveInfo
+{
+    uint m_Count;
+    uint m_FirstIndex;
+    int m_BaseVertex;
+    uint m_FirstMeshlet;
+    uint m_MeshletCount;
+    // The geometry pool page of its indices and vertices.
+    uint m_Page;
+    uint m_Padding[2];
+};
+
+// Bounds in Mesh space, see Glitter::Scene::GltfMeshlet.
+struct MeshletInfo
+{
+    vec3 m_Center;
+    float m_Radius;
+    vec3 m_ConeAxis;
+    float m_ConeCutoff;
+    uint m_Count;
+    uint m_FirstIndex;
+    uvec2 m_Padding;
+};
+
+struct DrawCommand
+{
+    uint m_Count;
+    uint m_InstanceCount;
+    uint m_FirstIndex;
+    int m_BaseVertex;
+    uint m_BaseInstance;
+};
+
+layout (std430, binding = 0) readonly buffer NodeData
+{
+    DrawData b_Nodes[];
+};
+
+layout (std430, binding = 2) readonly buffer Meshes
+{
+    MeshInfo b_Meshes[];
+};
+
+layout (std430, binding = 3) readonly buffer Primitives
+{
+    PrimitiveInfo b_Primitives[];
+};
+
+// Visible meshlets are appended to the opaque commands, after the ones written by CullCS.
+layout (std430, binding = 4) writeonly buffer Commands
+{
+    DrawCommand b_Commands[];
+};
+
+layout (std430, binding = 5) buffer DrawCounts
+{
+    uint b_OpaqueCount;
+    uint b_TransparentCount;
+    uint b_TransparentNodeCount;
+    uint b_Padding;
+    uint b_MeshletGroupsX;
+    uint b_MeshletGroupsY;
+    uint b_MeshletGroupsZ;
+    uint b_MeshletWorkCount;
+};
+
+layout (std430, binding = 6) writeonly buffer DrawNodes
+{
+    uint b_DrawNodes[];
+};
+
+// (Node, Primitive, Mesh) items.
+layout (std430, binding = 7) readonly buffer MeshletWork
+{
+    uvec4 b_MeshletWork[];
+};
+
+layout (std430, binding = 8) readonly buffer Meshlets
+{
+    MeshletInfo b_Meshlets[];
+};
+
+layout (location = 2) uniform bool u_FrustumCulling;
+layout (location = 3) uniform bool u_OcclusionCulling;
+layout (location = 4) uniform vec2 u_HiZSize;
+// The first command of the region the meshlets are appended to, see CullCS.glsl.
+layout (location = 10) uniform uint u_CommandBase;
+
+// Last frame's Hi-Z pyramid, built with u_HiZViewProjection over its u_HiZSize viewport.
+layout (binding = 1) uniform sampler2D u_HiZ;
+
+// The texel of the pyramid's viewport at `Level` covering `Uv`, in [0, 1] across the viewport.
+float FetchHiZ(vec2 Uv, int Level)
+{
+    ivec2 LevelSize = max(ivec2(u_HiZSize) >> Level, ivec2(1));
+    ivec2 Texel = min(ivec2(Uv * u_HiZSize) >> Level, LevelSize - 1);
+    return texelFetch(u_HiZ, Texel, Level).r;
+}
+
+bool IsVisible(vec3 Center, float Radius)
+{
+    for (int i = 0; i < 6; i++) {
+        vec4 Plane = u_FrustumPlanes[i];
+        if (dot(Plane.xyz, Center) + Plane.w <= -Radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Every triangle faces away from the eye when the eye lies outside the cone of normals, widened by the radius.
+bool IsBackfacing(vec3 Center, float Radius, vec3 ConeAxis, float ConeCutoff)
+{
+    vec3 EyeToCenter = Center - u_EyePos.xyz;
+    return dot(EyeToCenter, ConeAxis) >= ConeCutoff * length(EyeToCenter) + Radius;
+}
+
+// Same test as CullCS's IsOccluded(), on the AABB around the bounding sphere.
+bool IsOccluded(vec3 Center, float Radius)
+{
+    vec3 RectMin = vec3(1.0);
+    vec3 RectMax = vec3(0.0);
+    for (int i = 0; i < 8; i++) {
+        vec3 Corner = Center + Radius * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 Clip = u_HiZViewProjection * vec4(Corner, 1.0);
+        if (Clip.w <= 0.0) {
+            return false;
+        }
+
+        vec3 Window = (Clip.xyz / Clip.w) * 0.5 + 0.5;
+        RectMin = min(RectMin, Window);
+        RectMax = max(RectMax, Window);
+    }
+    RectMin.xy = clamp(RectMin.xy, 0.0, 1.0);
+    RectMax.xy = clamp(RectMax.xy, 0.0, 1.0);
+
+    vec2 RectSize = (RectMax.xy - RectMin.xy) * u_HiZSize;
+    int Level = min(int(ceil(log2(max(max(RectSize.x, RectSize.y), 1.0)))), textureQueryLevels(u_HiZ) - 1);
+
+    float HiZDepth = max(max(FetchHiZ(RectMin.xy, Level), FetchHiZ(vec2(RectMax.x, RectMin.y), Level)),
+        max(FetchHiZ(vec2(RectMin.x, RectMax.y), Level), FetchHiZ(RectMax.xy, Level)));
+
+    return RectMin.z > HiZDepth;
+}
+
+void main()
+{
+    for (uint Item = gl_WorkGroupID.x; Item < b_MeshletWorkCount; Item += gl_NumWorkGroups.x) {
+        uvec4 Work = b_MeshletWork[Item];
+        uint Node = Work.x;
+        PrimitiveInfo Primitive = b_Primitives[Work.y];
+
+        // The Node's Model applies to quantized positions, map the Mesh space bounds through its quantization first.
+        mat4 MeshToWorld = NodeModel(b_Nodes[Node % NODE_PAGE_SIZE]) * b_Meshes[Work.z].m_Quantize;
+        vec3 AxisScale = vec3(length(MeshToWorld[0].xyz), length(MeshToWorld[1].xyz), length(MeshToWorld[2].xyz));
+        float RadiusScale = max(AxisScale.x, max(AxisScale.y, AxisScale.z));
+
+        // Normals only keep their cone under a uniform scale.
+        bool ConeCulling = RadiusScale - min(AxisScale.x, min(AxisScale.y, AxisScale.z)) <= 0.01 * RadiusScale;
+
+        for (uint i = gl_LocalInvocationID.x; i < Primitive.m_MeshletCount; i += gl_WorkGroupSize.x) {
+            MeshletInfo Meshlet = b_Meshlets[Primitive.m_FirstMeshlet + i];
+            vec3 Center = (MeshToWorld * vec4(Meshlet.m_Center, 1.0)).xyz;
+            float Radius = Meshlet.m_Radius * RadiusScale;
+
+            if (u_FrustumCulling && !IsVisible(Center, Radius)) {
+                continue;
+            }
+            if (ConeCulling && Meshlet.m_ConeCutoff < 1.0
+                && IsBackfacing(Center, Radius, normalize(mat3(MeshToWorld) * Meshlet.m_ConeAxis), Meshlet.m_ConeCutoff)) {
+                continue;
+            }
+            if (u_OcclusionCulling && IsOccluded(Center, Radius)) {
+                continue;
+            }
+
+            uint Command = u_CommandBase + atomicAdd(b_OpaqueCount, 1);
+            b_Commands[Command] = DrawCommand(Meshlet.m_Count, 1, Meshlet.m_FirstIndex, Primitive.m_BaseVertex, Command);
+            b_DrawNodes[Command] = Node;
+        }
+    }
+}
@@ -0,0 +1,204 @@
+#version 460 core
+#extension GL_GOOGLE_include_directive : require
+
+// Appends the commands of the transparent Nodes appended by CullCS.glsl, sorted by TransparentSortCS.glsl, in their
+// order: an exclusive prefix sum of their Primitive counts gives each Node its first command. Each block of SCAN_BLOCK
+// Nodes is summed in shared memory, the sums of the blocks by a single work group, then each Node writes its commands.
+layout (local_size_x = 256) in;
+
+// NODE_PAGE_SIZE, see Glitter::Render::GenerateShaderDataGlsl().
+#include "ShaderData.glsl"
+
+struct NodeBounds
+{
+    vec3 m_Center;
+    uint m_MeshID;
+    vec3 m_Extent;
+    uint m_Padding;
+};
+
+struct MeshInfo
+{
+    uint m_FirstPrimitive;
+    uint m_PrimitiveCount;
+    uvec2 m_Padding;
+    // Inverse of the Mesh's dequantization, only used by the meshlet pass.
+    mat4 m_Quantize;
+};
+
+struct PrimitiveInfo
+{
+    uint m_Count;
+    uint m_FirstIndex;
+    int m_BaseVertex;
+    uint m_FirstMeshlet;
+    uint m_MeshletCount;
+    // The geometry pool page of its indices and vertices.
+    uint m_Page;
+    uint m_Padding[2];
+};
+
+struct DrawCommand
+{
+    uint m_Count;
+    uint m_InstanceCount;
+    uint m_FirstIndex;
+    int m_BaseVertex;
+    uint m_BaseInstance;
+};
+
+layout (std430, binding = 1) readonly buffer Bounds
+{
+    NodeBounds b_Bounds[];
+};
+
+layout (std430, binding = 2) readonly buffer Meshes
+{
+    MeshInfo b_Meshes[];
+};
+
+layout (std430, binding = 3) readonly buffer Primitives
+{
+    PrimitiveInfo b_Primitives[];
+};
+
+// Transparent commands are appended from u_CommandBase + u_CommandCapacity.
+layout (std430, binding = 4) writeonly buffer Commands
+{
+    DrawCommand b_Commands[];
+};
+
+layout (std430, binding = 5) buffer DrawCounts
+{
+    uint b_OpaqueCount;
+    uint b_TransparentCount;
+    uint b_TransparentNodeCount;
+};
+
+// The Node slot of each command, laid out like the commands.
+layout (std430, binding = 6) writeonly buffer DrawNodes
+{
+    uint b_DrawNodes[];
+};
+
+// (sort key, Node), the key replaced by the Node's first command within its block once sorted.
+layout (std430, binding = 10) buffer SortItems
+{
+    uvec2 b_Items[];
+};
+
+// The first command of each block.
+layout (std430, binding = 11) buffer BlockOffsets
+{
+    uint b_BlockOffsets[];
+};
+
+const uint PASS_SCAN_BLOCKS = 0u;
+const uint PASS_SCAN_OFFSETS = 1u;
+const uint PASS_WRITE_COMMANDS = 2u;
+const uint SCAN_BLOCK = 512u;
+
+layout (location = 0) uniform uint u_Pass;
+layout (location = 1) uniform uint u_CommandCapacity;
+// The geometry pool page whose Primitives are drawn, and the first command of the region, see CullCS.glsl.
+layout (location = 9) uniform uint u_Page;
+layout (location = 10) uniform uint u_CommandBase;
+
+shared uint s_Sums[256];
+
+// The exclusive prefix sum of the work group's `Value`s, and of all of them in `Total`.
+uint ScanWorkGroup(uint Value, out uint Total)
+{
+    uint Invocation = gl_LocalInvocationID.x;
+    s_Sums[Invocation] = Value;
+    barrier();
+    for (uint Stride = 1u; Stride < gl_WorkGroupSize.x; Stride *= 2u) {
+        uint Sum = s_Sums[Invocation] + (Invocation >= Stride ? s_Sums[Invocation - Stride] : 0u);
+        barrier();
+        s_Sums[Invocation] = Sum;
+        barrier();
+    }
+    Total = s_Sums[gl_WorkGroupSize.x - 1u];
+    uint Exclusive = s_Sums[Invocation] - Value;
+    barrier();
+    return Exclusive;
+}
+
+// The Primitives of the Item's Mesh on u_Page.
+uint GetPrimitiveCount(uint Item)
+{
+    MeshInfo Mesh = b_Meshes[b_Bounds[b_Items[Item].y % NODE_PAGE_SIZE].m_MeshID];
+    uint Count = 0u;
+    for (uint i = 0; i < Mesh.m_PrimitiveCount; i++) {
+        if (b_Primitives[Mesh.m_FirstPrimitive + i].m_Page == u_Page) {
+            Count++;
+        }
+    }
+    return Count;
+}
+
+void main()
+{
+    uint Count = b_TransparentNodeCount;
+    uint BlockCount = (Count + SCAN_BLOCK - 1u) / SCAN_BLOCK;
+
+    if (u_Pass == PASS_SCAN_BLOCKS) {
+        uint Base = gl_WorkGroupID.x * SCAN_BLOCK;
+        if (Base >= Count) {
+            return;
+        }
+
+        // Each invocation sums two consecutive Nodes.
+        uint First = Base + gl_LocalInvocationID.x * 2u;
+        uint FirstCount = First < Count ? GetPrimitiveCount(First) : 0u;
+        uint SecondCount = First + 1u < Count ? GetPrimitiveCount(First + 1u) : 0u;
+        uint Total = 0u;
+        uint Offset = ScanWorkGroup(FirstCount + SecondCount, Total);
+        if (First < Count) {
+            b_Items[First].x = Offset;
+        }
+        if (First + 1u < Count) {
+            b_Items[First + 1u].x = Offset + FirstCount;
+        }
+        if (gl_LocalInvocationID.x == 0u) {
+            b_BlockOffsets[gl_WorkGroupID.x] = Total;
+        }
+        return;
+    }
+
+    // A single work group, carrying the sum over as many rounds as there are blocks.
+    if (u_Pass == PASS_SCAN_OFFSETS) {
+        uint Carry = 0u;
+        for (uint Round = 0u; Round < BlockCount; Round += gl_WorkGroupSize.x) {
+            uint Block = Round + gl_LocalInvocationID.x;
+            uint Sum = Block < BlockCount ? b_BlockOffsets[Block] : 0u;
+            uint Total = 0u;
+            uint Offset = ScanWorkGroup(Sum, Total);
+            if (Block < BlockCount) {
+                b_BlockOffsets[Block] = Carry + Offset;
+            }
+            Carry += Total;
+        }
+        if (gl_LocalInvocationID.x == 0u) {
+            b_TransparentCount = Carry;
+        }
+        return;
+    }
+
+    uint Item = gl_GlobalInvocationID.x;
+    if (Item >= Count) {
+        return;
+    }
+    uint Node = b_Items[Item].y;
+    MeshInfo Mesh = b_Meshes[b_Bounds[Node % NODE_PAGE_SIZE].m_MeshID];
+    uint Command = u_CommandBase + u_CommandCapacity + b_BlockOffsets[Item / SCAN_BLOCK] + b_Items[Item].x;
+    for (uint i = 0; i < Mesh.m_PrimitiveCount; i++) {
+        PrimitiveInfo Primitive = b_Primitives[Mesh.m_FirstPrimitive + i];
+        if (Primitive.m_Page != u_Page) {
+            continue;
+        }
+        b_Commands[Command] = DrawCommand(Primitive.m_Count, 1, Primitive.m_FirstIndex, Primitive.m_BaseVertex, Command);
+        b_DrawNodes[Command] = Node;
+        Command++;
+    }
+}
@@ -0,0 +1,114 @@
+#version 460 core
+
+// Sorts the transparent Nodes appended by CullCS.glsl back to front, as a bitonic sort over the next power of two of
+// their count: each block of SORT_BLOCK items is sorted in shared memory first, then every merge step spanning more than
+// a block runs as its own dispatch over the whole list, and the steps within a block in shared memory again. The CPU
+// dispatches the steps for every Node, the steps past the count's power of two return right away.
+layout (local_size_x = 256) in;
+
+layout (std430, binding = 5) readonly buffer DrawCounts
+{
+    uint b_OpaqueCount;
+    uint b_TransparentCount;
+    uint b_TransparentNodeCount;
+};
+
+// (sort key, Node), the key being the bit-inverted distance from the eye so that the furthest Nodes come first.
+layout (std430, binding = 10) buffer SortItems
+{
+    uvec2 b_Items[];
+};
+
+const uint PASS_SORT_BLOCKS = 0u;
+const uint PASS_MERGE = 1u;
+const uint PASS_MERGE_BLOCKS = 2u;
+const uint SORT_BLOCK = 512u;
+
+layout (location = 0) uniform uint u_Pass;
+// The size of the bitonic sequences being merged, and with PASS_MERGE the distance between the items compared.
+layout (location = 1) uniform uint u_MergeSize;
+layout (location = 2) uniform uint u_Stride;
+
+shared uvec2 s_Items[SORT_BLOCK];
+
+// Ties are broken by the Node, so that the order doesn't depend on the order CullCS.glsl appended them in.
+bool IsGreater(uvec2 A, uvec2 B)
+{
+    return A.x != B.x ? A.x > B.x : A.y > B.y;
+}
+
+uint GetSortSize()
+{
+    uint Count = b_TransparentNodeCount;
+    return Count <= SORT_BLOCK ? SORT_BLOCK : 1u << (findMSB(Count - 1u) + 1);
+}
+
+// The first of the two items the invocation compares, `Stride` apart.
+uint GetPairIndex(uint Invocation, uint Stride)
+{
+    return 2u * Stride * (Invocation / Stride) + Invocation % Stride;
+}
+
+void CompareShared(uint Base, uint MergeSize, uint Stride)
+{
+    uint First = GetPairIndex(gl_LocalInvocationID.x, Stride);
+    uint Second = First + Stride;
+    bool Ascending = ((Base + First) & MergeSize) == 0u;
+    if (IsGreater(s_Items[First], s_Items[Second]) == Ascending) {
+        uvec2 Item = s_Items[First];
+        s_Items[First] = s_Items[Second];
+        s_Items[Second] = Item;
+    }
+    barrier();
+}
+
+void main()
+{
+    uint SortSize = GetSortSize();
+    if (u_MergeSize > SortSize) {
+        return;
+    }
+
+    if (u_Pass == PASS_MERGE) {
+        uint First = GetPairIndex(gl_GlobalInvocationID.x, u_Stride);
+        uint Second = First + u_Stride;
+        if (Second >= SortSize) {
+            return;
+        }
+        uvec2 A = b_Items[First];
+        uvec2 B = b_Items[Second];
+        if (IsGreater(A, B) == ((First & u_MergeSize) == 0u)) {
+            b_Items[First] = B;
+            b_Items[Second] = A;
+        }
+        return;
+    }
+
+    uint Base = gl_WorkGroupID.x * SORT_BLOCK;
+    if (Base >= SortSize) {
+        return;
+    }
+
+    // The items past the count sort last, they are only written once the blocks are first sorted.
+    uint Count = b_TransparentNodeCount;
+    for (uint i = gl_LocalInvocationID.x; i < SORT_BLOCK; i += gl_WorkGroupSize.x) {
+        s_Items[i] = u_Pass == PASS_SORT_BLOCKS && Base + i >= Count ? uvec2(0xFFFFFFFFu) : b_Items[Base + i];
+    }
+    barrier();
+
+    if (u_Pass == PASS_SORT_BLOCKS) {
+        for (uint MergeSize = 2u; MergeSize <= SORT_BLOCK; MergeSize *= 2u) {
+            for (uint Stride = MergeSize / 2u; Stride > 0u; Stride /= 2u) {
+                CompareShared(Base, MergeSize, Stride);
+            }
+        }
+    } else {
+        for (uint Stride = SORT_BLOCK / 2u; Stride > 0u; Stride /= 2u) {
+            CompareShared(Base, u_MergeSize, Stride);
+        }
+    }
+
+    for (uint i = gl_LocalInvocationID.x; i < SORT_BLOCK; i += gl_WorkGroupSize.x) {
+        b_Items[Base + i] = s_Items[i];
+    }
+}
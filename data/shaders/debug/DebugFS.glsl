@@ -1,8 +1,10 @@
 #version 460 core
 
-out vec4 FragColor;
+layout (location = 0) in vec4 v_Color;
+
+layout (location = 0) out vec4 FragColor;
 
 void main()
-{ 
-    FragColor = vec4(1.0, 0.0, 0.0, 1.0);
+{
+    FragColor = v_Color;
 }
@@ -1,17 +1,80 @@
 #version 460 core
+#extension GL_GOOGLE_include_directive : require
 
+// The debug lines of Glitter::Render::DebugDraw, or with GLITTER_DEBUG_AABBS the wireframe of each Node's AABB, one
+// instance per Node slot expanded from the bounds the GPU culling reads, without any vertex attribute.
+#ifndef GLITTER_DEBUG_AABBS
 layout (location = 0) in vec3 a_Position;
+layout (location = 1) in vec4 a_Color;
+#endif
 
-layout (std140, binding = 0) uniform CommonData
+// CommonData and DrawData, see Glitter::Render::GenerateShaderDataGlsl().
+#include "ShaderData.glsl"
+
+#ifdef GLITTER_DEBUG_AABBS
+const uint NODE_ANIMATE = 1u << 31;
+
+// Matches Glitter::Scene::AnimatedOpacity().
+float EvaluateOpacity(DrawData Draw)
+{
+    if ((Draw.m_Packed & NODE_ANIMATE) != 0u) {
+        return clamp(abs(1.25 * cos(u_Time.x + Draw.m_OpacityOrPhase)), 0.0, 1.0);
+    }
+    return Draw.m_OpacityOrPhase;
+}
+
+struct NodeBounds
+{
+    vec3 m_Center;
+    uint m_MeshID;
+    vec3 m_Extent;
+    uint m_Padding;
+};
+
+// A page of the Node data and bounds, drawn an instance per Node of the page.
+layout (std430, binding = 0) readonly buffer NodeData
+{
+    DrawData b_Nodes[];
+};
+
+layout (std430, binding = 1) readonly buffer Bounds
 {
-    mat4 u_View;
-    mat4 u_Projection;
-    vec4 u_EyePos;
-    vec4 u_LightPos;
-    vec4 u_LightColor;
+    NodeBounds b_Bounds[];
 };
 
+// The 12 edges of the unit cube, as a line list.
+const vec3 CUBE_LINES[24] = vec3[](
+    vec3(-1.0, -1.0, -1.0), vec3(1.0, -1.0, -1.0),
+    vec3(-1.0, -1.0, -1.0), vec3(-1.0, 1.0, -1.0),
+    vec3(-1.0, -1.0, -1.0), vec3(-1.0, -1.0, 1.0),
+    vec3(1.0, -1.0, -1.0), vec3(1.0, -1.0, 1.0),
+    vec3(1.0, -1.0, -1.0), vec3(1.0, 1.0, -1.0),
+    vec3(-1.0, 1.0, -1.0), vec3(1.0, 1.0, -1.0),
+    vec3(-1.0, 1.0, -1.0), vec3(-1.0, 1.0, 1.0),
+    vec3(-1.0, -1.0, 1.0), vec3(1.0, -1.0, 1.0),
+    vec3(-1.0, -1.0, 1.0), vec3(-1.0, 1.0, 1.0),
+    vec3(1.0, -1.0, 1.0), vec3(1.0, 1.0, 1.0),
+    vec3(1.0, 1.0, -1.0), vec3(1.0, 1.0, 1.0),
+    vec3(1.0, 1.0, 1.0), vec3(-1.0, 1.0, 1.0));
+#endif
+
+layout (location = 0) out vec4 v_Color;
+
 void main()
 {
-    gl_Position = u_Projection * u_View * vec4(a_Position, 1.0);
+#ifdef GLITTER_DEBUG_AABBS
+    // Invisible Nodes are skipped, their lines clipped away.
+    if (EvaluateOpacity(b_Nodes[gl_InstanceID]) == 0.0) {
+        gl_Position = vec4(0.0, 0.0, 0.0, -1.0);
+        return;
+    }
+
+    NodeBounds Bounds = b_Bounds[gl_InstanceID];
+    vec3 Position = Bounds.m_Center + Bounds.m_Extent * CUBE_LINES[gl_VertexID];
+    v_Color = vec4(1.0, 0.0, 0.0, 1.0);
+#else
+    vec3 Position = a_Position;
+    v_Color = a_Color;
+#endif
+    gl_Position = u_ViewProjection * vec4(Position, 1.0);
 }
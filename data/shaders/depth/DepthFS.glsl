@@ -0,0 +1,6 @@
+#version 460 core
+
+// Only the depth is written, the color pass shades the fragments left.
+void main()
+{
+}
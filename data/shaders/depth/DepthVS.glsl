@@ -0,0 +1,90 @@
+#version 460 core
+#extension GL_GOOGLE_include_directive : require
+
+// The depth pre-pass, from the position-only stream of the geometry pool. Its positions must match MainVS.glsl's
+// exactly for the color pass' GL_EQUAL depth test, hence the same expression and the invariant gl_Position. With
+// GLITTER_SHADOW, the main light's shadow map instead. With GLITTER_VISIBILITY, the visibility buffer, see
+// VisibilityFS.glsl.
+#ifdef GLITTER_MULTIVIEW
+// Both eyes at once, into the layers of Glitter::Render::StereoTargets.
+#extension GL_OVR_multiview : require
+layout (num_views = 2) in;
+#endif
+
+#ifdef GLITTER_VERTEX_PULLING
+// From the geometry pool's VBO instead, see Glitter::Config::ENABLE_VERTEX_PULLING.
+layout (std430, binding = 8) readonly buffer Vertices
+{
+    uint b_Vertices[];
+};
+
+// Matches MainVS.glsl's.
+#ifdef GLITTER_QUANTIZED_VERTICES
+vec3 FetchPosition(uint Vertex)
+{
+    uint Base = Vertex * 4u;
+    return vec3(unpackUnorm2x16(b_Vertices[Base]), unpackUnorm2x16(b_Vertices[Base + 1u]).x);
+}
+#else
+vec3 FetchPosition(uint Vertex)
+{
+    uint Base = Vertex * 8u;
+    return uintBitsToFloat(uvec3(b_Vertices[Base], b_Vertices[Base + 1u], b_Vertices[Base + 2u]));
+}
+#endif
+#else
+layout (location = 0) in vec3 a_Position;
+#endif
+
+// CommonData and DrawData, see Glitter::Render::GenerateShaderDataGlsl().
+#include "ShaderData.glsl"
+
+mat4 NodeModel(DrawData Draw)
+{
+    return transpose(mat4(Draw.m_ModelRows[0], Draw.m_ModelRows[1], Draw.m_ModelRows[2], vec4(0.0, 0.0, 0.0, 1.0)));
+}
+
+// A page of the persistent per-Node data, indexed by Node slot modulo NODE_PAGE_SIZE.
+layout (std430, binding = 0) readonly buffer NodeData
+{
+    DrawData b_Nodes[];
+};
+
+// The Node slot of each draw.
+layout (std430, binding = 1) readonly buffer DrawNodes
+{
+    uint b_DrawNodes[];
+};
+
+#ifdef GLITTER_VISIBILITY
+// The index of the first command of the draw, in the buffer the resolve reads them from.
+layout (location = 0) uniform uint u_FirstCommand;
+
+// The command and instance of the draw.
+layout (location = 0) flat out uvec2 v_Draw;
+#endif
+
+invariant gl_Position;
+
+void main()
+{
+    DrawData Draw = b_Nodes[b_DrawNodes[gl_BaseInstance + gl_InstanceID] % NODE_PAGE_SIZE];
+    mat4 Model = NodeModel(Draw);
+
+#ifdef GLITTER_VERTEX_PULLING
+    vec3 Position = FetchPosition(uint(gl_VertexID));
+#else
+    vec3 Position = a_Position;
+#endif
+    vec4 World = Model * vec4(Position, 1.0);
+#ifdef GLITTER_SHADOW
+    gl_Position = u_ShadowViewProjection * World;
+#elif defined(GLITTER_MULTIVIEW)
+    gl_Position = u_EyeViewProjections[gl_ViewID_OVR] * World;
+#else
+    gl_Position = u_ViewProjection * World;
+#endif
+#ifdef GLITTER_VISIBILITY
+    v_Draw = uvec2(u_FirstCommand + uint(gl_DrawID), uint(gl_InstanceID));
+#endif
+}
@@ -0,0 +1,55 @@
+#version 460 core
+#extension GL_GOOGLE_include_directive : require
+
+// The AABB of the Node slot gl_BaseInstance, one occlusion query each, drawn with DepthFS.glsl against the opaque depth
+// without writing it, see Glitter::Render::OcclusionQueries. Without any vertex attribute, and drawn from both sides.
+// CommonData and DrawData, see Glitter::Render::GenerateShaderDataGlsl().
+#include "ShaderData.glsl"
+
+struct NodeBounds
+{
+    vec3 m_Center;
+    uint m_MeshID;
+    vec3 m_Extent;
+    uint m_Padding;
+};
+
+// The page of the bounds holding the Node's, see NODE_PAGE_SIZE.
+layout (std430, binding = 1) readonly buffer Bounds
+{
+    NodeBounds b_Bounds[];
+};
+
+// The distance from the eye to the corners of the near plane, how close the eye may come to an AABB before the near
+// plane may clip it.
+layout (location = 0) uniform float u_ClipMargin;
+
+// The 12 triangles of the unit cube.
+const vec3 CUBE_TRIANGLES[36] = vec3[](
+    vec3(-1.0, -1.0, -1.0), vec3(1.0, -1.0, -1.0), vec3(1.0, 1.0, -1.0),
+    vec3(-1.0, -1.0, -1.0), vec3(1.0, 1.0, -1.0), vec3(-1.0, 1.0, -1.0),
+    vec3(-1.0, -1.0, 1.0), vec3(1.0, 1.0, 1.0), vec3(1.0, -1.0, 1.0),
+    vec3(-1.0, -1.0, 1.0), vec3(-1.0, 1.0, 1.0), vec3(1.0, 1.0, 1.0),
+    vec3(-1.0, -1.0, -1.0), vec3(-1.0, 1.0, 1.0), vec3(-1.0, -1.0, 1.0),
+    vec3(-1.0, -1.0, -1.0), vec3(-1.0, 1.0, -1.0), vec3(-1.0, 1.0, 1.0),
+    vec3(1.0, -1.0, -1.0), vec3(1.0, -1.0, 1.0), vec3(1.0, 1.0, 1.0),
+    vec3(1.0, -1.0, -1.0), vec3(1.0, 1.0, 1.0), vec3(1.0, 1.0, -1.0),
+    vec3(-1.0, -1.0, -1.0), vec3(-1.0, -1.0, 1.0), vec3(1.0, -1.0, 1.0),
+    vec3(-1.0, -1.0, -1.0), vec3(1.0, -1.0, 1.0), vec3(1.0, -1.0, -1.0),
+    vec3(-1.0, 1.0, -1.0), vec3(1.0, 1.0, 1.0), vec3(-1.0, 1.0, 1.0),
+    vec3(-1.0, 1.0, -1.0), vec3(1.0, 1.0, -1.0), vec3(1.0, 1.0, 1.0));
+
+void main()
+{
+    NodeBounds Bounds = b_Bounds[gl_BaseInstance % NODE_PAGE_SIZE];
+
+    // With the eye inside the AABB, or close enough for the near plane to clip its front faces away, the Node is visible:
+    // its first two triangles cover the whole screen at the near plane instead, always passing the depth test.
+    if (all(lessThanEqual(abs(u_EyePos.xyz - Bounds.m_Center), Bounds.m_Extent + u_ClipMargin))) {
+        vec2 Corner = gl_VertexID < 6 ? CUBE_TRIANGLES[gl_VertexID].xy : vec2(0.0);
+        gl_Position = vec4(Corner, -1.0, 1.0);
+        return;
+    }
+
+    gl_Position = u_ViewProjection * vec4(Bounds.m_Center + Bounds.m_Extent * CUBE_TRIANGLES[gl_VertexID], 1.0);
+}
@@ -0,0 +1,16 @@
+#version 460 core
+
+// The visibility buffer: which triangle of which draw covers each pixel, from which the resolve pass of MainFS.glsl
+// rebuilds and shades the fragment. 0 in x is left for the pixels no opaque Node covers.
+layout (location = 0) flat in uvec2 v_Draw;
+
+// The Node data page of the draw's Node, in the high 16 bits, and the geometry pool page of its Primitive.
+layout (location = 1) uniform uint u_Pages;
+
+// x: the command of the draw, from 1; y: its instance; z: the triangle; w: u_Pages.
+layout (location = 0) out uvec4 Visibility;
+
+void main()
+{
+    Visibility = uvec4(v_Draw.x + 1u, v_Draw.y, uint(gl_PrimitiveID), u_Pages);
+}
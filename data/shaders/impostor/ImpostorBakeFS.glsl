@@ -0,0 +1,22 @@
+#version 460 core
+
+layout (location = 0) in vec2 v_TexCoord;
+layout (location = 1) in vec3 v_Normal;
+
+// The texture coordinates in xy and the octahedral-encoded normal in zw, see Glitter::Render::ImpostorAtlas.
+layout (location = 0) out vec4 Texel;
+
+// Decoded by DecodeOctahedral() in MainFS.glsl. Matches Glitter::Scene::QuantizeAsset()'s.
+vec2 EncodeOctahedral(vec3 Normal)
+{
+    vec2 Encoded = Normal.xy / (abs(Normal.x) + abs(Normal.y) + abs(Normal.z));
+    if (Normal.z < 0.0) {
+        Encoded = (1.0 - abs(Encoded.yx)) * vec2(Encoded.x >= 0.0 ? 1.0 : -1.0, Encoded.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return Encoded;
+}
+
+void main()
+{
+    Texel = vec4(v_TexCoord, EncodeOctahedral(normalize(v_Normal)));
+}
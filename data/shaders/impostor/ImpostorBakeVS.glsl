@@ -0,0 +1,87 @@
+#version 460 core
+
+// Renders a Mesh into one frame of its impostor, see Glitter::Render::ImpostorAtlas. Drawn once per primitive, outside of
+// the Node data: the positions are only dequantized into Mesh space.
+#ifdef GLITTER_VERTEX_PULLING
+// The geometry pool's VBO, see Glitter::Config::ENABLE_VERTEX_PULLING.
+layout (std430, binding = 8) readonly buffer Vertices
+{
+    uint b_Vertices[];
+};
+#else
+layout (location = 0) in vec3 a_Position;
+layout (location = 1) in vec2 a_TexCoord;
+#ifdef GLITTER_QUANTIZED_VERTICES
+// Octahedral-encoded in xy, see Glitter::Scene::QuantizeAsset().
+layout (location = 2) in vec4 a_Normal;
+#else
+layout (location = 2) in vec3 a_Normal;
+#endif
+#endif
+
+// The frame's orthographic View-Projection, and the Mesh's m_dequantize.
+layout (location = 0) uniform mat4 u_ViewProjection;
+layout (location = 1) uniform mat4 u_Dequantize;
+
+#ifdef GLITTER_QUANTIZED_VERTICES
+// Matches MainVS.glsl's.
+vec3 DecodeOctahedral(vec2 Encoded)
+{
+    vec3 Normal = vec3(Encoded, 1.0 - abs(Encoded.x) - abs(Encoded.y));
+    if (Normal.z < 0.0) {
+        Normal.xy = (1.0 - abs(Normal.yx)) * vec2(Normal.x >= 0.0 ? 1.0 : -1.0, Normal.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(Normal);
+}
+#endif
+
+#ifdef GLITTER_VERTEX_PULLING
+// Matches MainVS.glsl's.
+#ifdef GLITTER_QUANTIZED_VERTICES
+// A Glitter::Scene::QuantizedVertex.
+void FetchVertex(uint Vertex, out vec3 Position, out vec2 TexCoord, out vec3 Normal)
+{
+    uint Base = Vertex * 4u;
+    Position = vec3(unpackUnorm2x16(b_Vertices[Base]), unpackUnorm2x16(b_Vertices[Base + 1u]).x);
+    TexCoord = unpackHalf2x16(b_Vertices[Base + 2u]);
+    int Packed = int(b_Vertices[Base + 3u]);
+    vec2 Encoded = vec2(bitfieldExtract(Packed, 0, 10), bitfieldExtract(Packed, 10, 10));
+    Normal = DecodeOctahedral(max(Encoded / 511.0, -1.0));
+}
+#else
+// A Glitter::Scene::MeshVertex.
+void FetchVertex(uint Vertex, out vec3 Position, out vec2 TexCoord, out vec3 Normal)
+{
+    uint Base = Vertex * 8u;
+    Position = uintBitsToFloat(uvec3(b_Vertices[Base], b_Vertices[Base + 1u], b_Vertices[Base + 2u]));
+    TexCoord = uintBitsToFloat(uvec2(b_Vertices[Base + 3u], b_Vertices[Base + 4u]));
+    Normal = uintBitsToFloat(uvec3(b_Vertices[Base + 5u], b_Vertices[Base + 6u], b_Vertices[Base + 7u]));
+}
+#endif
+#endif
+
+layout (location = 0) out vec2 v_TexCoord;
+layout (location = 1) out vec3 v_Normal;
+
+void main()
+{
+#ifdef GLITTER_VERTEX_PULLING
+    vec3 Position;
+    vec3 Normal;
+    FetchVertex(uint(gl_VertexID), Position, v_TexCoord, Normal);
+#else
+    vec3 Position = a_Position;
+    v_TexCoord = a_TexCoord;
+#ifdef GLITTER_QUANTIZED_VERTICES
+    vec3 Normal = DecodeOctahedral(a_Normal.xy);
+#else
+    vec3 Normal = a_Normal;
+#endif
+#endif
+    gl_Position = u_ViewProjection * u_Dequantize * vec4(Position, 1.0);
+
+    // The cofactor of the dequantization, as in MainVS.glsl, for Mesh space normals.
+    mat3 Dequantize = mat3(u_Dequantize);
+    v_Normal = mat3(cross(Dequantize[1], Dequantize[2]), cross(Dequantize[2], Dequantize[0]), cross(Dequantize[0], Dequantize[1]))
+        * Normal;
+}
@@ -0,0 +1,106 @@
+#version 460 core
+#extension GL_GOOGLE_include_directive : require
+
+// Draws the impostor of a far Node, see Glitter::Render::ImpostorAtlas: a quad across the Mesh's bounding sphere, facing
+// the frame nearest to the direction towards the eye, shaded by MainFS.glsl with GLITTER_IMPOSTOR. Without any attribute,
+// 6 vertices per instance.
+// CommonData and DrawData, see Glitter::Render::GenerateShaderDataGlsl().
+#include "ShaderData.glsl"
+
+mat4 NodeModel(DrawData Draw)
+{
+    return transpose(mat4(Draw.m_ModelRows[0], Draw.m_ModelRows[1], Draw.m_ModelRows[2], vec4(0.0, 0.0, 0.0, 1.0)));
+}
+
+uint NodeTextureLayer(DrawData Draw) { return Draw.m_Packed & 0xFFFFu; }
+uint NodeMaterialID(DrawData Draw) { return (Draw.m_Packed >> 16) & 0x7FFFu; }
+
+// A page of the persistent per-Node data, indexed by Node slot modulo NODE_PAGE_SIZE.
+layout (std430, binding = 0) readonly buffer NodeData
+{
+    DrawData b_Nodes[];
+};
+
+// The Node slot of each draw.
+layout (std430, binding = 1) readonly buffer DrawNodes
+{
+    uint b_DrawNodes[];
+};
+
+// The inverse of the Mesh's m_dequantize, its bounding sphere in Mesh space, and its layer of the atlas.
+layout (location = 0) uniform mat4 u_Quantize;
+layout (location = 1) uniform vec4 u_Sphere;
+layout (location = 2) uniform uint u_Layer;
+
+// See Glitter::Config::IMPOSTOR_GRID. Specialized in SPIR-V modules, and defined in GLSL sources.
+#ifdef GL_SPIRV
+layout (constant_id = 0) const float IMPOSTOR_GRID = 8.0;
+#else
+const float IMPOSTOR_GRID = float(GLITTER_IMPOSTOR_GRID);
+#endif
+
+// Matches MainVS.glsl's.
+vec3 DecodeOctahedral(vec2 Encoded)
+{
+    vec3 Normal = vec3(Encoded, 1.0 - abs(Encoded.x) - abs(Encoded.y));
+    if (Normal.z < 0.0) {
+        Normal.xy = (1.0 - abs(Normal.yx)) * vec2(Normal.x >= 0.0 ? 1.0 : -1.0, Normal.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(Normal);
+}
+
+// Matches ImpostorBakeFS.glsl's.
+vec2 EncodeOctahedral(vec3 Normal)
+{
+    vec2 Encoded = Normal.xy / (abs(Normal.x) + abs(Normal.y) + abs(Normal.z));
+    if (Normal.z < 0.0) {
+        Encoded = (1.0 - abs(Encoded.yx)) * vec2(Encoded.x >= 0.0 ? 1.0 : -1.0, Encoded.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return Encoded;
+}
+
+// Two counter-clockwise triangles, from the bottom left corner of the frame.
+const vec2 QUAD_CORNERS[6] = vec2[](
+    vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0));
+
+// Explicit locations, since SPIR-V modules only match their interfaces by location. Matches MainVS.glsl's, but for the
+// texture coordinates and normals fetched from the atlas instead.
+layout (location = 2) out vec3 v_QuadPos;
+layout (location = 5) flat out uint v_TextureLayer;
+layout (location = 6) flat out uvec2 v_TextureHandle;
+layout (location = 7) flat out uint v_MaterialID;
+layout (location = 8) out vec3 v_AtlasCoord;
+// The world offset of the frame's nearest depth from the quad, and the normal matrix of the Mesh space normals.
+layout (location = 9) flat out vec3 v_DepthOffset;
+layout (location = 10) flat out mat3 v_NormalMatrix;
+
+void main()
+{
+    DrawData Draw = b_Nodes[b_DrawNodes[gl_BaseInstance + gl_InstanceID] % NODE_PAGE_SIZE];
+    // From Mesh space, where the impostor was baked, to world space.
+    mat4 Model = NodeModel(Draw) * u_Quantize;
+
+    // The frame whose cell the direction towards the eye maps into, in Mesh space.
+    vec3 Center = u_Sphere.xyz;
+    vec3 ToEye = inverse(mat3(Model)) * (u_EyePos.xyz - vec3(Model * vec4(Center, 1.0)));
+    vec2 Frame = min(floor((EncodeOctahedral(normalize(ToEye)) * 0.5 + 0.5) * IMPOSTOR_GRID), IMPOSTOR_GRID - 1.0);
+    vec3 Direction = DecodeOctahedral((Frame + 0.5) / IMPOSTOR_GRID * 2.0 - 1.0);
+
+    // The frame's basis, as glm::lookAt() builds it in Glitter::Render::ImpostorAtlas::Bake().
+    vec3 Up = abs(Direction.y) > 0.999 ? vec3(0.0, 0.0, 1.0) : vec3(0.0, 1.0, 0.0);
+    vec3 Right = normalize(cross(Up, Direction));
+    Up = cross(Direction, Right);
+
+    vec2 Corner = QUAD_CORNERS[gl_VertexID];
+    vec4 World = Model * vec4(Center + (Corner.x * Right + Corner.y * Up) * u_Sphere.w, 1.0);
+    gl_Position = u_ViewProjection * World;
+
+    v_QuadPos = World.xyz;
+    v_TextureLayer = NodeTextureLayer(Draw);
+    v_TextureHandle = Draw.m_TextureHandle;
+    v_MaterialID = NodeMaterialID(Draw);
+    v_AtlasCoord = vec3((Frame + Corner * 0.5 + 0.5) / IMPOSTOR_GRID, float(u_Layer));
+    v_DepthOffset = mat3(Model) * Direction * u_Sphere.w;
+    // The cofactor matrix, as in MainVS.glsl.
+    v_NormalMatrix = mat3(cross(Model[1].xyz, Model[2].xyz), cross(Model[2].xyz, Model[0].xyz), cross(Model[0].xyz, Model[1].xyz));
+}
@@ -0,0 +1,37 @@
+// Generated from src/glitter/render/ShaderData.h by the GlitterShaderLayouts target, do not edit.
+
+layout (std140, binding = 0) uniform CommonData
+{
+    mat4 u_View;
+    // The projection times u_View, premultiplied on the CPU.
+    mat4 u_ViewProjection;
+    vec4 u_EyePos;
+    // A direction towards the light when w is 0.
+    vec4 u_LightPos;
+    vec4 u_LightColor;
+    vec4 u_FrustumPlanes[6];
+    mat4 u_HiZViewProjection;
+    // x: seconds since startup.
+    vec4 u_Time;
+    mat4 u_ShadowViewProjection;
+    // x: 1 when shadows are enabled; y: offset along the normal before sampling the shadow map, in world units.
+    vec4 u_ShadowParams;
+    // x: the bias added to the level of detail of the Node textures.
+    vec4 u_TextureParams;
+    // The left and right eye's u_ViewProjection in stereo, picked by gl_ViewID_OVR.
+    mat4 u_EyeViewProjections[2];
+};
+
+struct DrawData
+{
+    // The first three rows of the affine model matrix, see NodeModel().
+    vec4 m_ModelRows[3];
+    uvec2 m_TextureHandle;
+    // The animation phase of the animating Nodes.
+    float m_OpacityOrPhase;
+    // Bits 0-15: the texture layer; 16-30: the material; 31: NODE_ANIMATE.
+    uint m_Packed;
+};
+
+// Nodes per page of b_Nodes and b_Bounds, see Glitter::Config::NODE_PAGE_SIZE: the bound page holds Slot at Slot % NODE_PAGE_SIZE.
+const uint NODE_PAGE_SIZE = 1048576u;
@@ -0,0 +1,150 @@
+#version 460 core
+
+// Generates up to MIP_LEVELS levels of every layer of a texture from the level above them, in a single dispatch,
+// see Render::MipGenerator. Each workgroup reduces a 64x64 tile of the source level into the 6 levels below it through
+// shared memory, and the last workgroup of a layer to finish carries on with the next 6 levels, from the texel each of
+// the layer's workgroups left in the last of the first 6.
+//
+// Each texel is the average of the 2x2 texels above it. Like glGenerateTextureMipmap() and the CPU mips, the last row or
+// column of odd-sized levels is left out, and a level 1 texel wide or high repeats its texels.
+
+#define TILE_LEVELS 6
+#define TILE_SIZE 64
+
+#ifdef GLITTER_MIP_RGBA16F
+#define MIP_FORMAT rgba16f
+#else
+#define MIP_FORMAT rgba8
+#endif
+// Only the drivers with the 13 image units it takes let the last workgroup carry on.
+#ifdef GLITTER_MIP_HANDOVER
+#define MIP_LEVELS (TILE_LEVELS * 2)
+#else
+#define MIP_LEVELS TILE_LEVELS
+#endif
+
+layout (local_size_x = 16, local_size_y = 16) in;
+
+// The source level, then the levels generated from it. Coherent, since the last workgroup reads what the others wrote.
+layout (binding = 0, MIP_FORMAT) uniform coherent image2DArray u_Levels[MIP_LEVELS + 1];
+
+// The workgroups of each layer done with their tile, reset by the last of them.
+layout (binding = 0, std430) restrict coherent buffer CounterBuffer {
+    uint b_Counters[];
+};
+
+layout (location = 0) uniform ivec2 u_SourceSize;
+// The levels generated by this dispatch, from 1 to MIP_LEVELS.
+layout (location = 1) uniform int u_LevelCount;
+layout (location = 2) uniform int u_FirstLayer;
+// Whether the color is sRGB-encoded, and averaged in linear space. Alpha always is linear.
+layout (location = 3) uniform bool u_Srgb;
+
+// The texels of the last level written, in linear space, so that the sRGB ones aren't quantized at every level.
+shared vec4 s_Texels[TILE_SIZE / 2][TILE_SIZE / 2];
+shared bool s_LastWorkgroup;
+
+vec4 Decode(vec4 Texel)
+{
+    if (!u_Srgb) {
+        return Texel;
+    }
+    bvec3 Curve = greaterThan(Texel.rgb, vec3(0.04045));
+    return vec4(mix(Texel.rgb / 12.92, pow((Texel.rgb + 0.055) / 1.055, vec3(2.4)), Curve), Texel.a);
+}
+
+vec4 Encode(vec4 Color)
+{
+    if (!u_Srgb) {
+        return Color;
+    }
+    Color.rgb = max(Color.rgb, vec3(0.0));
+    bvec3 Curve = greaterThan(Color.rgb, vec3(0.0031308));
+    return vec4(mix(Color.rgb * 12.92, 1.055 * pow(Color.rgb, vec3(1.0 / 2.4)) - 0.055, Curve), Color.a);
+}
+
+ivec2 GetLevelSize(int Level)
+{
+    return max(u_SourceSize >> Level, ivec2(1));
+}
+
+// The texels of `Level` covering the texel at `Texel` of the level below, clamped to the level.
+ivec2 GetFootprint(int Level, ivec2 Texel, int Corner)
+{
+    return min(Texel * 2 + ivec2(Corner & 1, Corner >> 1), GetLevelSize(Level) - 1);
+}
+
+void Store(int Level, ivec2 Texel, int Layer, vec4 Color)
+{
+    if (all(lessThan(Texel, GetLevelSize(Level)))) {
+        imageStore(u_Levels[Level], ivec3(Texel, Layer), Encode(Color));
+    }
+}
+
+// Reduces the tile `Tile` of `Level` into the levels below it, up to TILE_LEVELS of them, then waits for the workgroup.
+void ReduceTile(int Level, ivec2 Tile, int Layer)
+{
+    int LastLevel = min(Level + TILE_LEVELS, u_LevelCount);
+    ivec2 Local = ivec2(gl_LocalInvocationID.xy);
+
+    // The first level below is read from the image, 2x2 of its 32x32 texels per invocation.
+    for (int Quad = 0; Quad < 4; Quad++) {
+        ivec2 Texel = Local + ivec2(Quad & 1, Quad >> 1) * (TILE_SIZE / 4);
+        ivec2 Destination = Tile * (TILE_SIZE / 2) + Texel;
+        vec4 Color = vec4(0.0);
+        for (int Corner = 0; Corner < 4; Corner++) {
+            Color += Decode(imageLoad(u_Levels[Level], ivec3(GetFootprint(Level, Destination, Corner), Layer)));
+        }
+        Color *= 0.25;
+        s_Texels[Texel.y][Texel.x] = Color;
+        Store(Level + 1, Destination, Layer, Color);
+    }
+    barrier();
+
+    // The next ones from the shared texels, halving the invocations at work every level. Their source texels past the end
+    // of the level are clamped like they'd be in the image, since the tile is at its start whenever it's smaller.
+    for (int Below = Level + 2; Below <= LastLevel; Below++) {
+        int Size = TILE_SIZE >> (Below - Level);
+        bool Active = all(lessThan(Local, ivec2(Size)));
+        vec4 Color = vec4(0.0);
+        if (Active) {
+            ivec2 Destination = Tile * Size + Local;
+            for (int Corner = 0; Corner < 4; Corner++) {
+                ivec2 Source = clamp(GetFootprint(Below - 1, Destination, Corner) - Tile * Size * 2, ivec2(0), ivec2(Size * 2 - 1));
+                Color += s_Texels[Source.y][Source.x];
+            }
+            Color *= 0.25;
+            Store(Below, Destination, Layer, Color);
+        }
+        barrier();
+        if (Active) {
+            s_Texels[Local.y][Local.x] = Color;
+        }
+        barrier();
+    }
+}
+
+void main()
+{
+    int Layer = u_FirstLayer + int(gl_WorkGroupID.z);
+    ReduceTile(0, ivec2(gl_WorkGroupID.xy), Layer);
+
+    // Hand the rest of the layer over to its last workgroup, once every workgroup's texel of TILE_LEVELS is visible.
+#ifdef GLITTER_MIP_HANDOVER
+    if (u_LevelCount > TILE_LEVELS) {
+        memoryBarrierImage();
+        barrier();
+        if (gl_LocalInvocationIndex == 0) {
+            uint Workgroups = gl_NumWorkGroups.x * gl_NumWorkGroups.y;
+            s_LastWorkgroup = atomicAdd(b_Counters[gl_WorkGroupID.z], 1u) == Workgroups - 1u;
+            if (s_LastWorkgroup) {
+                b_Counters[gl_WorkGroupID.z] = 0u;
+            }
+        }
+        barrier();
+        if (s_LastWorkgroup) {
+            ReduceTile(TILE_LEVELS, ivec2(0), Layer);
+        }
+    }
+#endif
+}
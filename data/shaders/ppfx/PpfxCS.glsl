@@ -0,0 +1,168 @@
+#version 460 core
+
+// A pass of fused effects, generated by Glitter::Render::BuildPostProcessPasses(). Each workgroup loads its tile of the
+// input once into shared memory, with an apron of APRON texels around it, applying the PPFX_LOAD_ effects to every texel
+// on the way. The PPFX_BLOOM or PPFX_FXAA effect then samples the tile, and the PPFX_STORE_ effects are applied to its
+// result.
+#define TILE_SIZE 16
+#define APRON 2
+#define TILE_SIZE_WITH_APRON (TILE_SIZE + 2 * APRON)
+
+layout (local_size_x = TILE_SIZE, local_size_y = TILE_SIZE) in;
+
+layout (binding = 0) uniform sampler2D u_ColorTexture;
+#ifdef PPFX_LOAD_OIT
+// The weighted blended transparent Nodes, written by MainFS.glsl, composited over the opaque ones in u_ColorTexture.
+layout (binding = 1) uniform sampler2D u_OitAccumulation;
+layout (binding = 2) uniform sampler2D u_OitRevealage;
+#endif
+#ifdef PPFX_INTERMEDIATE
+layout (binding = 0, rgba16f) uniform writeonly image2D u_Output;
+#else
+layout (binding = 0, rgba8) uniform writeonly image2D u_Output;
+#endif
+
+layout (location = 0) uniform float u_Gamma;
+// The viewport at the origin of the input, and of the output, which can both be larger.
+layout (location = 1) uniform ivec2 u_Size;
+
+const float BLOOM_THRESHOLD = 1.0;
+const float BLOOM_INTENSITY = 0.5;
+
+// Below this local contrast, scaled by the brightest neighbour, a texel isn't on an edge.
+const float FXAA_EDGE_THRESHOLD = 0.125;
+const float FXAA_EDGE_THRESHOLD_MIN = 0.0312;
+
+shared vec3 s_Tile[TILE_SIZE_WITH_APRON][TILE_SIZE_WITH_APRON];
+
+// The loaded input at `Offset` from this invocation's texel, no further than APRON.
+vec3 LoadTile(ivec2 Offset)
+{
+    ivec2 Local = ivec2(gl_LocalInvocationID.xy) + APRON + Offset;
+    return s_Tile[Local.y][Local.x];
+}
+
+float Luma(vec3 Color)
+{
+    return dot(Color, vec3(0.299, 0.587, 0.114));
+}
+
+// The subpixel blend of FXAA over the 3x3 neighbourhood, across the edge. There's no search along the edge, which would
+// reach past the apron.
+vec3 Fxaa(vec3 Center)
+{
+    float LumaC = Luma(Center);
+    float LumaN = Luma(LoadTile(ivec2(0, 1)));
+    float LumaS = Luma(LoadTile(ivec2(0, -1)));
+    float LumaE = Luma(LoadTile(ivec2(1, 0)));
+    float LumaW = Luma(LoadTile(ivec2(-1, 0)));
+
+    float LumaMin = min(LumaC, min(min(LumaN, LumaS), min(LumaE, LumaW)));
+    float LumaMax = max(LumaC, max(max(LumaN, LumaS), max(LumaE, LumaW)));
+    float Range = LumaMax - LumaMin;
+    if (Range < max(FXAA_EDGE_THRESHOLD_MIN, LumaMax * FXAA_EDGE_THRESHOLD)) {
+        return Center;
+    }
+
+    float LumaNE = Luma(LoadTile(ivec2(1, 1)));
+    float LumaNW = Luma(LoadTile(ivec2(-1, 1)));
+    float LumaSE = Luma(LoadTile(ivec2(1, -1)));
+    float LumaSW = Luma(LoadTile(ivec2(-1, -1)));
+
+    // Blend across the edge, towards the side with the steepest gradient.
+    float Horizontal = 2.0 * abs(LumaN + LumaS - 2.0 * LumaC) + abs(LumaNE + LumaSE - 2.0 * LumaE)
+        + abs(LumaNW + LumaSW - 2.0 * LumaW);
+    float Vertical = 2.0 * abs(LumaE + LumaW - 2.0 * LumaC) + abs(LumaNE + LumaNW - 2.0 * LumaN)
+        + abs(LumaSE + LumaSW - 2.0 * LumaS);
+    bool IsHorizontal = Horizontal >= Vertical;
+    float Luma1 = IsHorizontal ? LumaS : LumaW;
+    float Luma2 = IsHorizontal ? LumaN : LumaE;
+    int Side = abs(Luma1 - LumaC) >= abs(Luma2 - LumaC) ? -1 : 1;
+    ivec2 Step = IsHorizontal ? ivec2(0, Side) : ivec2(Side, 0);
+
+    // The more the texel stands out of its neighbourhood, the more it's blended.
+    float Average = (2.0 * (LumaN + LumaS + LumaE + LumaW) + LumaNE + LumaNW + LumaSE + LumaSW) / 12.0;
+    float Subpixel = smoothstep(0.0, 1.0, clamp(abs(Average - LumaC) / Range, 0.0, 1.0));
+    return mix(Center, LoadTile(Step), 0.5 * Subpixel * Subpixel);
+}
+
+// A 5x5 binomial blur of the colors above BLOOM_THRESHOLD. A wider bloom needs a larger apron, or a blur chain.
+vec3 Bloom()
+{
+    const float Weights[5] = float[](1.0, 4.0, 6.0, 4.0, 1.0);
+
+    vec3 Sum = vec3(0.0);
+    for (int y = -APRON; y <= APRON; y++) {
+        for (int x = -APRON; x <= APRON; x++) {
+            Sum += Weights[x + APRON] * Weights[y + APRON] * max(LoadTile(ivec2(x, y)) - BLOOM_THRESHOLD, 0.0);
+        }
+    }
+    return BLOOM_INTENSITY * Sum / 256.0;
+}
+
+// The ACES filmic curve, as fitted by Krzysztof Narkowicz.
+vec3 Tonemap(vec3 Color)
+{
+    return clamp((Color * (2.51 * Color + 0.03)) / (Color * (2.43 * Color + 0.59) + 0.14), 0.0, 1.0);
+}
+
+// The weighted average of the transparent fragments at `Texel`, let through by what the opaque color is covered by.
+vec3 CompositeOit(vec3 Color, ivec2 Texel)
+{
+    vec4 Accumulation = texelFetch(u_OitAccumulation, Texel, 0);
+    float Revealage = texelFetch(u_OitRevealage, Texel, 0).r;
+    return mix(Accumulation.rgb / max(Accumulation.a, 1e-5), Color, Revealage);
+}
+
+vec3 ApplyLoadEffects(vec3 Color, ivec2 Texel)
+{
+#ifdef PPFX_LOAD_OIT
+    Color = CompositeOit(Color, Texel);
+#endif
+#ifdef PPFX_LOAD_GAMMA
+    Color *= u_Gamma;
+#endif
+#ifdef PPFX_LOAD_TONEMAP
+    Color = Tonemap(Color);
+#endif
+    return Color;
+}
+
+vec3 ApplyStoreEffects(vec3 Color)
+{
+#ifdef PPFX_STORE_GAMMA
+    Color *= u_Gamma;
+#endif
+#ifdef PPFX_STORE_TONEMAP
+    Color = Tonemap(Color);
+#endif
+    return Color;
+}
+
+void main()
+{
+    // Load the tile and its apron, clamped to the edges of the viewport. Without an effect sampling neighbours, the apron is
+    // wasted, but the workgroups keep the same shape.
+    ivec2 Size = u_Size;
+    ivec2 TileOrigin = ivec2(gl_WorkGroupID.xy) * TILE_SIZE - APRON;
+    for (uint Idx = gl_LocalInvocationIndex; Idx < TILE_SIZE_WITH_APRON * TILE_SIZE_WITH_APRON; Idx += TILE_SIZE * TILE_SIZE) {
+        ivec2 Local = ivec2(Idx % TILE_SIZE_WITH_APRON, Idx / TILE_SIZE_WITH_APRON);
+        ivec2 LoadTexel = clamp(TileOrigin + Local, ivec2(0), Size - 1);
+        vec3 Color = texelFetch(u_ColorTexture, LoadTexel, 0).rgb;
+        s_Tile[Local.y][Local.x] = ApplyLoadEffects(Color, LoadTexel);
+    }
+    barrier();
+
+    ivec2 Texel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(Texel, Size))) {
+        return;
+    }
+
+    vec3 Color = LoadTile(ivec2(0));
+#if defined(PPFX_BLOOM)
+    Color += Bloom();
+#elif defined(PPFX_FXAA)
+    Color = Fxaa(Color);
+#endif
+    imageStore(u_Output, Texel, vec4(ApplyStoreEffects(Color), 1.0));
+}
@@ -0,0 +1,116 @@
+#version 460 core
+
+// Upsamples the jittered scene color into the history at the output resolution, see Glitter::Render::TemporalUpsampler.
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (binding = 0) uniform sampler2D u_ColorTexture;
+layout (binding = 1) uniform sampler2D u_DepthTexture;
+layout (binding = 2) uniform sampler2D u_History;
+// The weighted blended transparent Nodes, written by MainFS.glsl, composited over each sample when u_CompositeOit is set.
+layout (binding = 3) uniform sampler2D u_OitAccumulation;
+layout (binding = 4) uniform sampler2D u_OitRevealage;
+layout (binding = 0, rgba16f) uniform writeonly image2D u_Output;
+
+// The viewports at the origin of the scene color and depth, and of the output, which can all be larger.
+layout (location = 0) uniform ivec2 u_InputSize;
+layout (location = 1) uniform ivec2 u_OutputSize;
+// The offset the scene was rendered at, in its pixels.
+layout (location = 2) uniform vec2 u_Jitter;
+// Takes this frame's unjittered clip space to the previous frame's.
+layout (location = 3) uniform mat4 u_Reprojection;
+// The output viewport's part of the history texture.
+layout (location = 4) uniform vec2 u_HistoryScale;
+layout (location = 5) uniform bool u_HistoryValid;
+layout (location = 6) uniform bool u_CompositeOit;
+// The part of the history a sample at the center of a pixel replaces.
+layout (location = 7) uniform float u_Blend;
+
+// How many standard deviations of the new samples' colors the history is let away from their mean.
+const float HISTORY_CLIP_SIGMA = 1.25;
+
+float Luma(vec3 Color)
+{
+    return dot(Color, vec3(0.299, 0.587, 0.114));
+}
+
+// The colors are accumulated with their brightness compressed, so that a few very bright samples don't flicker through
+// the history.
+vec3 Compress(vec3 Color)
+{
+    return Color / (1.0 + Luma(Color));
+}
+
+vec3 Decompress(vec3 Color)
+{
+    return Color / max(1.0 - Luma(Color), 1e-4);
+}
+
+vec3 LoadSample(ivec2 Texel)
+{
+    vec3 Color = texelFetch(u_ColorTexture, Texel, 0).rgb;
+    if (u_CompositeOit) {
+        vec4 Accumulation = texelFetch(u_OitAccumulation, Texel, 0);
+        float Revealage = texelFetch(u_OitRevealage, Texel, 0).r;
+        Color = mix(Accumulation.rgb / max(Accumulation.a, 1e-5), Color, Revealage);
+    }
+    return Compress(Color);
+}
+
+void main()
+{
+    ivec2 Texel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(Texel, u_OutputSize))) {
+        return;
+    }
+
+    // This pixel's center in the scene's pixels. Each of their samples was taken at its center minus the jitter.
+    vec2 Uv = (vec2(Texel) + 0.5) / vec2(u_OutputSize);
+    vec2 InputPos = Uv * vec2(u_InputSize);
+    vec2 OutputPerInput = vec2(u_OutputSize) / vec2(u_InputSize);
+    ivec2 Nearest = ivec2(floor(InputPos + u_Jitter));
+
+    // Resolve the 3x3 samples around this pixel, weighted by their distance to it in output pixels with a Gaussian fit of
+    // Blackman-Harris. Their mean and variance bound the history, and the closest depth reprojects it, so that edges
+    // follow the foreground.
+    vec3 Sum = vec3(0.0);
+    float WeightSum = 0.0;
+    float MaxWeight = 0.0;
+    vec3 Moment1 = vec3(0.0);
+    vec3 Moment2 = vec3(0.0);
+    float ClosestDepth = 1.0;
+    for (int y = -1; y <= 1; y++) {
+        for (int x = -1; x <= 1; x++) {
+            ivec2 SampleTexel = clamp(Nearest + ivec2(x, y), ivec2(0), u_InputSize - 1);
+            vec3 Color = LoadSample(SampleTexel);
+            vec2 Offset = (vec2(SampleTexel) + 0.5 - u_Jitter - InputPos) * OutputPerInput;
+            float Weight = exp(-2.29 * dot(Offset, Offset));
+            Sum += Weight * Color;
+            WeightSum += Weight;
+            MaxWeight = max(MaxWeight, Weight);
+            Moment1 += Color;
+            Moment2 += Color * Color;
+            ClosestDepth = min(ClosestDepth, texelFetch(u_DepthTexture, SampleTexel, 0).r);
+        }
+    }
+    vec3 Current = Sum / max(WeightSum, 1e-5);
+
+    vec4 PreviousClip = u_Reprojection * vec4(Uv * 2.0 - 1.0, ClosestDepth * 2.0 - 1.0, 1.0);
+    vec2 PreviousUv = PreviousClip.xy / PreviousClip.w * 0.5 + 0.5;
+    if (!u_HistoryValid || PreviousClip.w <= 0.0 || any(lessThan(PreviousUv, vec2(0.0)))
+        || any(greaterThan(PreviousUv, vec2(1.0)))) {
+        imageStore(u_Output, Texel, vec4(Decompress(Current), 1.0));
+        return;
+    }
+
+    // Kept half a pixel inside the viewport, so that the bilinear filter doesn't reach past it.
+    vec2 HalfPixel = 0.5 / vec2(u_OutputSize);
+    vec3 History = Compress(texture(u_History, clamp(PreviousUv, HalfPixel, 1.0 - HalfPixel) * u_HistoryScale).rgb);
+
+    vec3 Mean = Moment1 / 9.0;
+    vec3 Sigma = sqrt(max(Moment2 / 9.0 - Mean * Mean, 0.0));
+    History = clamp(History, Mean - HISTORY_CLIP_SIGMA * Sigma, Mean + HISTORY_CLIP_SIGMA * Sigma);
+
+    // Samples landing far from the pixel's center replace less of its history.
+    vec3 Color = mix(History, Current, u_Blend * MaxWeight);
+    imageStore(u_Output, Texel, vec4(Decompress(Color), 1.0));
+}
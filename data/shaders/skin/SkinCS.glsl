@@ -0,0 +1,165 @@
+#version 460 core
+
+// Skins the Primitives of the skinned Nodes into their own vertices, see Glitter::Render::SkinnedMeshes: each row of work
+// groups blends the skinning matrices of one part's vertices by their influences, and writes them in the same vertex
+// format, position stream included, so that every pass draws them as they are. The skinned vertices and the Primitives
+// they're skinned from are disjoint ranges of the same buffers.
+layout (local_size_x = 64) in;
+
+struct Part
+{
+    // From the Primitive's vertices into Mesh space, and from the skinned Mesh space into the skinned vertices'.
+    mat4 m_Dequantize;
+    mat4 m_Quantize;
+    int m_SourceBaseVertex;
+    uint m_BaseVertex;
+    uint m_VertexCount;
+    uint m_FirstInfluence;
+    // The range of b_Matrices the joint indices of the influences refer to.
+    uint m_FirstMatrix;
+    uint m_MatrixCount;
+};
+
+// The geometry pool's VBO and position-only stream.
+layout (std430, binding = 0) buffer Vertices
+{
+    uint b_Vertices[];
+};
+
+layout (std430, binding = 1) writeonly buffer Positions
+{
+    uint b_Positions[];
+};
+
+// Matches Glitter::Scene::SkinnedVertex: 4 16-bit joint indices, then 4 unorm16 weights.
+layout (std430, binding = 2) readonly buffer Influences
+{
+    uvec4 b_Influences[];
+};
+
+layout (std430, binding = 3) readonly buffer Parts
+{
+    Part b_Parts[];
+};
+
+layout (std430, binding = 4) readonly buffer Matrices
+{
+    mat4 b_Matrices[];
+};
+
+// The part of the first row of work groups, the parts are dispatched in chunks of the work group count limit.
+layout (location = 0) uniform uint u_FirstPart;
+layout (location = 1) uniform uint u_MatrixCount;
+
+// The weighted sum of the skinning matrices of the vertex's influences, with out of range joints clamped to the last one.
+mat4 BlendSkinning(Part Skinned, uint Vertex)
+{
+    uvec4 Influence = b_Influences[Skinned.m_FirstInfluence + Vertex];
+    uvec4 Joints = min(uvec4(Influence.x & 0xFFFFu, Influence.x >> 16u, Influence.y & 0xFFFFu, Influence.y >> 16u),
+        uvec4(Skinned.m_MatrixCount - 1u));
+    vec4 Weights = vec4(unpackUnorm2x16(Influence.z), unpackUnorm2x16(Influence.w));
+
+    uint First = Skinned.m_FirstMatrix;
+    return b_Matrices[First + Joints.x] * Weights.x + b_Matrices[First + Joints.y] * Weights.y
+        + b_Matrices[First + Joints.z] * Weights.z + b_Matrices[First + Joints.w] * Weights.w;
+}
+
+// Matches StaticBatchCS.glsl's cofactor, so that the normals come out perpendicular once the skinned Mesh's dequantization
+// transforms them in turn.
+mat3 Cofactor(mat4 Transform)
+{
+    mat3 Model = mat3(Transform);
+    return mat3(cross(Model[1], Model[2]), cross(Model[2], Model[0]), cross(Model[0], Model[1]));
+}
+
+#ifdef GLITTER_QUANTIZED_VERTICES
+// Matches MainVS.glsl's.
+vec3 DecodeOctahedral(vec2 Encoded)
+{
+    vec3 Normal = vec3(Encoded, 1.0 - abs(Encoded.x) - abs(Encoded.y));
+    if (Normal.z < 0.0) {
+        Normal.xy = (1.0 - abs(Normal.yx)) * vec2(Normal.x >= 0.0 ? 1.0 : -1.0, Normal.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(Normal);
+}
+
+// Matches EncodeOctahedral() in Glitter::Scene::QuantizeAsset().
+vec2 EncodeOctahedral(vec3 Normal)
+{
+    float Length = abs(Normal.x) + abs(Normal.y) + abs(Normal.z);
+    if (Length == 0.0) {
+        return vec2(0.0);
+    }
+
+    vec2 Encoded = Normal.xy / Length;
+    if (Normal.z < 0.0) {
+        Encoded = (1.0 - abs(Encoded.yx)) * vec2(Encoded.x >= 0.0 ? 1.0 : -1.0, Encoded.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return Encoded;
+}
+
+uint QuantizeSnorm10(float Value)
+{
+    return uint(int(round(clamp(Value, -1.0, 1.0) * 511.0))) & 0x3FFu;
+}
+
+// A Glitter::Scene::QuantizedVertex, whose position stream holds its first two words.
+void SkinVertex(Part Skinned, uint Vertex, mat4 Transform)
+{
+    uint Source = (uint(Skinned.m_SourceBaseVertex) + Vertex) * 4u;
+    uint Destination = (Skinned.m_BaseVertex + Vertex) * 4u;
+
+    vec3 Position = vec3(unpackUnorm2x16(b_Vertices[Source]), unpackUnorm2x16(b_Vertices[Source + 1u]).x);
+    Position = clamp((Transform * vec4(Position, 1.0)).xyz, 0.0, 1.0);
+    uvec2 Packed = uvec2(packUnorm2x16(Position.xy), packUnorm2x16(vec2(Position.z, 0.0)));
+
+    int Normal = int(b_Vertices[Source + 3u]);
+    vec2 Encoded = vec2(bitfieldExtract(Normal, 0, 10), bitfieldExtract(Normal, 10, 10));
+    Encoded = EncodeOctahedral(normalize(Cofactor(Transform) * DecodeOctahedral(max(Encoded / 511.0, -1.0))));
+
+    b_Vertices[Destination] = Packed.x;
+    b_Vertices[Destination + 1u] = Packed.y;
+    b_Vertices[Destination + 2u] = b_Vertices[Source + 2u];
+    b_Vertices[Destination + 3u] = QuantizeSnorm10(Encoded.x) | (QuantizeSnorm10(Encoded.y) << 10);
+    b_Positions[(Skinned.m_BaseVertex + Vertex) * 2u] = Packed.x;
+    b_Positions[(Skinned.m_BaseVertex + Vertex) * 2u + 1u] = Packed.y;
+}
+#else
+// A Glitter::Scene::MeshVertex, whose position stream holds its first three words.
+void SkinVertex(Part Skinned, uint Vertex, mat4 Transform)
+{
+    uint Source = (uint(Skinned.m_SourceBaseVertex) + Vertex) * 8u;
+    uint Destination = (Skinned.m_BaseVertex + Vertex) * 8u;
+
+    vec3 Position = uintBitsToFloat(uvec3(b_Vertices[Source], b_Vertices[Source + 1u], b_Vertices[Source + 2u]));
+    uvec3 Packed = floatBitsToUint((Transform * vec4(Position, 1.0)).xyz);
+    vec3 Normal = uintBitsToFloat(uvec3(b_Vertices[Source + 5u], b_Vertices[Source + 6u], b_Vertices[Source + 7u]));
+    uvec3 PackedNormal = floatBitsToUint(normalize(Cofactor(Transform) * Normal));
+
+    b_Vertices[Destination] = Packed.x;
+    b_Vertices[Destination + 1u] = Packed.y;
+    b_Vertices[Destination + 2u] = Packed.z;
+    b_Vertices[Destination + 3u] = b_Vertices[Source + 3u];
+    b_Vertices[Destination + 4u] = b_Vertices[Source + 4u];
+    b_Vertices[Destination + 5u] = PackedNormal.x;
+    b_Vertices[Destination + 6u] = PackedNormal.y;
+    b_Vertices[Destination + 7u] = PackedNormal.z;
+    b_Positions[(Skinned.m_BaseVertex + Vertex) * 3u] = Packed.x;
+    b_Positions[(Skinned.m_BaseVertex + Vertex) * 3u + 1u] = Packed.y;
+    b_Positions[(Skinned.m_BaseVertex + Vertex) * 3u + 2u] = Packed.z;
+}
+#endif
+
+void main()
+{
+    Part Skinned = b_Parts[u_FirstPart + gl_WorkGroupID.y];
+    uint Vertex = gl_GlobalInvocationID.x;
+    // A Node added since the matrices were computed isn't skinned until they include it.
+    if (Vertex >= Skinned.m_VertexCount || Skinned.m_MatrixCount == 0u
+        || Skinned.m_FirstMatrix + Skinned.m_MatrixCount > u_MatrixCount) {
+        return;
+    }
+
+    mat4 Transform = Skinned.m_Quantize * BlendSkinning(Skinned, Vertex) * Skinned.m_Dequantize;
+    SkinVertex(Skinned, Vertex, Transform);
+}
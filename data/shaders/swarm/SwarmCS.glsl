@@ -0,0 +1,104 @@
+#version 460 core
+#extension GL_GOOGLE_include_directive : require
+
+// Advances the agents of the swarm, see Glitter::Render::NodeSwarm, and writes each one's translation, opacity and bounds
+// into its Node's data, where the GPU culling pass and the draws read them from.
+layout (local_size_x = 64) in;
+
+// CommonData and DrawData, see Glitter::Render::GenerateShaderDataGlsl().
+#include "ShaderData.glsl"
+
+struct NodeBounds
+{
+    vec3 m_Center;
+    uint m_MeshID;
+    vec3 m_Extent;
+    uint m_Padding;
+};
+
+struct Agent
+{
+    // The Node's translation, and the agent's phase into its opacity fade.
+    vec4 m_PositionPhase;
+    // The velocity, and the pace of the fade.
+    vec4 m_VelocityFadeSpeed;
+    // From the Node's translation to the drawn model matrix's, and to the center of its bounds.
+    vec4 m_ModelOffset;
+    vec4 m_BoundsOffset;
+};
+
+// The page u_NodePage of the Node data and bounds, see NODE_PAGE_SIZE.
+layout (std430, binding = 0) buffer NodeData
+{
+    DrawData b_Nodes[];
+};
+
+layout (std430, binding = 1) buffer Bounds
+{
+    NodeBounds b_Bounds[];
+};
+
+layout (std430, binding = 2) buffer Agents
+{
+    Agent b_Agents[];
+};
+
+// The Node of each agent, NO_NODE for the free ones.
+layout (std430, binding = 3) readonly buffer AgentNodes
+{
+    uint b_AgentNodes[];
+};
+
+const uint NO_NODE = 0xFFFFFFFFu;
+const uint NODE_ANIMATE = 1u << 31;
+
+// How hard the agents are pulled back towards u_Radius from the swarm's center, how fast they're pushed around its
+// vertical axis, and how much of their velocity they lose per second.
+const float SPRING = 0.5;
+const float SWIRL = 0.35;
+const float DRAG = 0.25;
+
+layout (location = 0) uniform uint u_AgentCount;
+layout (location = 1) uniform uint u_StepCount;
+layout (location = 2) uniform float u_StepTime;
+layout (location = 3) uniform float u_Radius;
+// The swarm is dispatched once per page, each agent only advanced by the dispatch of its Node's.
+layout (location = 4) uniform uint u_NodePage;
+
+void main()
+{
+    uint AgentIdx = gl_GlobalInvocationID.x;
+    if (AgentIdx >= u_AgentCount || b_AgentNodes[AgentIdx] == NO_NODE
+        || b_AgentNodes[AgentIdx] / NODE_PAGE_SIZE != u_NodePage) {
+        return;
+    }
+
+    Agent State = b_Agents[AgentIdx];
+    vec3 Position = State.m_PositionPhase.xyz;
+    vec3 Velocity = State.m_VelocityFadeSpeed.xyz;
+    float Phase = State.m_PositionPhase.w;
+
+    // The same fixed steps as the CPU's simulation, integrated semi-implicitly.
+    for (uint Step = 0u; Step < u_StepCount; Step++) {
+        float Distance = length(Position);
+        vec3 Outward = Distance > 1e-4 ? Position / Distance : vec3(0.0, 1.0, 0.0);
+        vec3 Acceleration = -Outward * (Distance - u_Radius) * SPRING
+            + cross(vec3(0.0, 1.0, 0.0), Position) * SWIRL - Velocity * DRAG;
+        Velocity += Acceleration * u_StepTime;
+        Position += Velocity * u_StepTime;
+        Phase = mod(Phase + State.m_VelocityFadeSpeed.w * u_StepTime, 6.28318530718);
+    }
+    b_Agents[AgentIdx].m_PositionPhase = vec4(Position, Phase);
+    b_Agents[AgentIdx].m_VelocityFadeSpeed.xyz = Velocity;
+
+    // Only the translation of the model matrix moves, the last column of its rows. Matches
+    // Glitter::Scene::AnimatedOpacity(), evaluated here instead of in every pass.
+    uint Node = b_AgentNodes[AgentIdx] % NODE_PAGE_SIZE;
+    vec3 Translation = Position + State.m_ModelOffset.xyz;
+    b_Nodes[Node].m_ModelRows[0].w = Translation.x;
+    b_Nodes[Node].m_ModelRows[1].w = Translation.y;
+    b_Nodes[Node].m_ModelRows[2].w = Translation.z;
+    b_Nodes[Node].m_OpacityOrPhase = clamp(abs(1.25 * cos(Phase)), 0.0, 1.0);
+    b_Nodes[Node].m_Packed &= ~NODE_ANIMATE;
+    b_Bounds[Node].m_Center = Position + State.m_BoundsOffset.xyz;
+}
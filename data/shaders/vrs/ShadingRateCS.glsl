@@ -0,0 +1,80 @@
+#version 460 core
+
+// Builds the shading rate image, see Glitter::Render::ShadingRateImage. Each workgroup picks the palette index of one
+// texel, from 0 (every pixel shaded) to 3 (one invocation per 4x4 pixels).
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (binding = 0) uniform sampler2D u_ColorTexture;
+layout (binding = 0, r8ui) uniform writeonly uimage2D u_ShadingRates;
+
+// The viewport at the origin of the scene color, and the pixels each texel covers.
+layout (location = 0) uniform ivec2 u_Size;
+layout (location = 1) uniform ivec2 u_TexelSize;
+layout (location = 2) uniform bool u_ContentAdaptive;
+layout (location = 3) uniform float u_FoveaRadius;
+layout (location = 4) uniform float u_ContrastThreshold;
+
+// The largest contrast of the texel's pixels, as the bits of a positive float, which order like it.
+shared uint s_MaxContrast;
+
+// The luma with the HDR range compressed into [0, 1), so that the contrast is relative to the brightness.
+float CompressedLuma(ivec2 Pixel)
+{
+    float Luma = dot(texelFetch(u_ColorTexture, min(Pixel, u_Size - 1), 0).rgb, vec3(0.299, 0.587, 0.114));
+    return Luma / (1.0 + Luma);
+}
+
+uint FoveatedRate(ivec2 Texel)
+{
+    // From 0 at the center to 1 in the corners.
+    vec2 Center = (vec2(Texel) + 0.5) * vec2(u_TexelSize);
+    vec2 HalfSize = 0.5 * vec2(u_Size);
+    float Radius = length((Center - HalfSize) / HalfSize) / sqrt(2.0);
+    if (Radius < u_FoveaRadius) {
+        return 0u;
+    }
+    return min(1u + uint((Radius - u_FoveaRadius) / (1.0 - u_FoveaRadius) * 3.0), 3u);
+}
+
+void main()
+{
+    ivec2 Texel = ivec2(gl_WorkGroupID.xy);
+    if (!u_ContentAdaptive) {
+        if (gl_LocalInvocationIndex == 0u) {
+            imageStore(u_ShadingRates, Texel, uvec4(FoveatedRate(Texel)));
+        }
+        return;
+    }
+
+    if (gl_LocalInvocationIndex == 0u) {
+        s_MaxContrast = 0u;
+    }
+    barrier();
+
+    // Each invocation strides over the texel's pixels, comparing each to its right and top neighbours.
+    ivec2 Origin = Texel * u_TexelSize;
+    float Contrast = 0.0;
+    for (int y = int(gl_LocalInvocationID.y); y < u_TexelSize.y; y += 8) {
+        for (int x = int(gl_LocalInvocationID.x); x < u_TexelSize.x; x += 8) {
+            ivec2 Pixel = Origin + ivec2(x, y);
+            if (any(greaterThanEqual(Pixel, u_Size))) {
+                continue;
+            }
+            float Luma = CompressedLuma(Pixel);
+            Contrast = max(Contrast, abs(Luma - CompressedLuma(Pixel + ivec2(1, 0))));
+            Contrast = max(Contrast, abs(Luma - CompressedLuma(Pixel + ivec2(0, 1))));
+        }
+    }
+    atomicMax(s_MaxContrast, floatBitsToUint(Contrast));
+    barrier();
+
+    if (gl_LocalInvocationIndex == 0u) {
+        float MaxContrast = uintBitsToFloat(s_MaxContrast);
+        // Halving the rate for every halving of the contrast under the threshold.
+        uint Rate = 0u;
+        for (float Threshold = u_ContrastThreshold; Rate < 3u && MaxContrast < Threshold; Threshold *= 0.5) {
+            Rate++;
+        }
+        imageStore(u_ShadingRates, Texel, uvec4(Rate));
+    }
+}
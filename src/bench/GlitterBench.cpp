@@ -0,0 +1,562 @@
+// Microbenchmarks of the hot CPU routines, run without a GL context. Each routine is timed at several element counts and
+// reported in nanoseconds per element.
+
+#include "Config.h"
+#include "core/CpuFeatures.h"
+#include "core/JobSystem.h"
+#include "render/DrawKey.h"
+#include "render/FrustumCulling.h"
+#include "render/GpuBufferAllocator.h"
+#include "scene/Animation.h"
+#include "scene/BVH.h"
+#include "scene/GltfImporter.h"
+#include "scene/NodeStore.h"
+#include "scene/SceneGenerator.h"
+#include "scene/SpatialHashGrid.h"
+#include "util/GeometryCodec.h"
+#include "util/LinearAllocator.h"
+#include "util/RadixSort.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <print>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::array ELEMENT_COUNTS = std::to_array<size_t>({1'000, 10'000, 100'000, 1'000'000});
+
+// Each measurement repeats its routine until at least this much time has passed, and keeps the fastest run.
+constexpr auto MIN_MEASURE_TIME = std::chrono::milliseconds(200);
+
+// Written by the routines so that the compiler can't discard their results.
+volatile size_t g_sink = 0;
+
+void Measure(const char* name, size_t count, const std::function<void()>& setup, const std::function<void()>& routine)
+{
+    using Clock = std::chrono::steady_clock;
+
+    double bestSeconds = std::numeric_limits<double>::max();
+    size_t runs = 0;
+    Clock::duration total {};
+    while (total < MIN_MEASURE_TIME || runs < 3) {
+        setup();
+
+        Clock::time_point begin = Clock::now();
+        routine();
+        Clock::duration elapsed = Clock::now() - begin;
+
+        total += elapsed;
+        bestSeconds = std::min(bestSeconds, std::chrono::duration<double>(elapsed).count());
+        runs++;
+    }
+
+    std::println("{:<32} {:>9} {:>10.2f} ns/elem {:>10.2f} Melem/s", name, count, bestSeconds * 1e9 / static_cast<double>(count),
+        static_cast<double>(count) / bestSeconds / 1e6);
+}
+
+Glitter::Render::FrustumPlanes MakePlanes(float time)
+{
+    glm::vec3 eyePos = glm::vec3(std::sin(time), 2.5f, -3.5f);
+    glm::mat4 view = glm::lookAt(eyePos, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 1.0f, 20.0f);
+    return Glitter::Render::ExtractFrustumPlanes(projection * view);
+}
+
+// Scatters `count` small boxes the same way the space key spawns Nodes.
+Glitter::Render::CullBounds MakeBounds(size_t count, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> position(-45.0f, 45.0f);
+    std::uniform_real_distribution<float> extent(0.05f, 0.5f);
+
+    Glitter::Render::CullBounds bounds;
+    bounds.Resize(count);
+    for (size_t idx = 0; idx < count; idx++) {
+        bounds.Set(idx, glm::vec3(position(rng), position(rng), position(rng)) * 0.25f, glm::vec3(extent(rng)) * 0.25f);
+    }
+    return bounds;
+}
+
+void BenchCulling(size_t count, std::mt19937& rng)
+{
+    Glitter::Render::CullBounds bounds = MakeBounds(count, rng);
+    Glitter::Render::FrustumPlanes planes = MakePlanes(0.0f);
+
+    Measure("ExtractFrustumPlanes", count, [] {}, [&] {
+        float sum = 0.0f;
+        for (size_t idx = 0; idx < count; idx++) {
+            sum += MakePlanes(static_cast<float>(idx))[0].w;
+        }
+        g_sink = static_cast<size_t>(sum);
+    });
+
+    Measure("TestAABB", count, [] {}, [&] {
+        size_t visible = 0;
+        for (size_t idx = 0; idx < count; idx++) {
+            std::uint8_t planeMask = Glitter::Render::ALL_PLANES;
+            visible += Glitter::Render::TestAABB(planes, bounds.GetCenter(idx), bounds.GetExtent(idx), planeMask)
+                != Glitter::Render::CullResult::Outside;
+        }
+        g_sink = visible;
+    });
+
+    Glitter::Render::VisibilityMask visibility;
+    Glitter::Render::CullCoherency coherency;
+    Measure("CullAABBs", count, [&] { coherency = {}; },
+        [&] { g_sink = Glitter::Render::CullAABBs(planes, bounds, visibility, coherency); });
+    Measure("CullAABBs (coherent)", count, [] {},
+        [&] { g_sink = Glitter::Render::CullAABBs(planes, bounds, visibility, coherency); });
+    float time = 0.0f;
+    Measure("CullAABBs (moving camera)", count, [] {}, [&] {
+        time += 0.001f;
+        g_sink = Glitter::Render::CullAABBs(MakePlanes(time), bounds, visibility, coherency);
+    });
+
+    Glitter::Scene::BVH bvh;
+    Measure("BVH::Build", count, [] {}, [&] { bvh.Build(bounds); });
+    Measure("BVH::Cull", count, [&] { Glitter::Render::BeginCull(planes, count, visibility, coherency); },
+        [&] { g_sink = bvh.Cull(planes, bounds, visibility); });
+}
+
+struct SortEntry {
+    std::uint64_t m_sortKey;
+    std::uint32_t m_node;
+};
+
+void BenchSorting(size_t count, std::mt19937& rng, Glitter::Core::JobSystem& jobSystem)
+{
+    std::uniform_int_distribution<std::uint32_t> mesh(0, 15);
+    std::uniform_int_distribution<std::uint32_t> texture(0, 63);
+    std::uniform_int_distribution<std::uint32_t> depth(0, (1u << Glitter::Render::DrawKey::DEPTH_BITS) - 1);
+
+    std::vector<SortEntry> source(count);
+    for (size_t idx = 0; idx < count; idx++) {
+        source[idx] = SortEntry {.m_sortKey = Glitter::Render::DrawKey::Opaque(0, mesh(rng), texture(rng), depth(rng)),
+            .m_node = static_cast<std::uint32_t>(idx)};
+    }
+
+    std::vector<SortEntry> items(count);
+    std::vector<SortEntry> scratch(count);
+    auto reset = [&] { std::ranges::copy(source, items.begin()); };
+    Measure("RadixSort (draw keys)", count, reset, [&] {
+        Glitter::Util::RadixSort(std::span(items), std::span(scratch), [](const SortEntry& entry) { return entry.m_sortKey; });
+        g_sink = items[0].m_node;
+    });
+    Measure("ParallelRadixSort (draw keys)", count, reset, [&] {
+        Glitter::Util::ParallelRadixSort(jobSystem, std::span(items), std::span(scratch),
+            [](const SortEntry& entry) { return entry.m_sortKey; }, Glitter::Config::PARALLEL_SORT_GRAIN_SIZE);
+        g_sink = items[0].m_node;
+    });
+    Measure("std::sort (draw keys)", count, reset, [&] {
+        std::ranges::sort(items, {}, &SortEntry::m_sortKey);
+        g_sink = items[0].m_node;
+    });
+}
+
+// Shaped like the application's PerDrawData.
+struct alignas(16) PushRecord {
+    glm::mat4 m_model;
+    float m_opacity;
+    std::uint32_t m_textureLayer;
+    std::uint64_t m_textureHandle;
+};
+
+void BenchAllocator(size_t count)
+{
+    // Each single push is padded up to the alignment, as on most GPUs' UBO offset alignment.
+    constexpr size_t ALIGNMENT = 256;
+    std::vector<std::byte> target((sizeof(PushRecord) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT * count);
+    Glitter::Util::LinearAllocator allocator;
+    allocator.SetAlignment(ALIGNMENT);
+
+    PushRecord record {.m_model = glm::mat4(1.0f), .m_opacity = 1.0f, .m_textureLayer = 0, .m_textureHandle = 0};
+    std::vector<PushRecord> records(count, record);
+
+    Measure("LinearAllocator::Push", count, [&] { allocator.SetTarget(target); }, [&] {
+        for (size_t idx = 0; idx < count; idx++) {
+            allocator.Push(record);
+        }
+        g_sink = allocator.Overflowed() ? 0 : allocator.Size();
+    });
+    Measure("LinearAllocator::Push (span)", count, [&] { allocator.SetTarget(target); }, [&] {
+        g_sink = allocator.Push(std::span<const PushRecord>(records));
+    });
+    Measure("LinearAllocator::PushN", count, [&] { allocator.SetTarget(target); }, [&] {
+        g_sink = allocator.PushN(std::span<const PushRecord>(records)) + allocator.Size();
+    });
+
+    // Into the allocator's own buffer, reserved upfront.
+    Glitter::Util::LinearAllocator owned;
+    owned.SetAlignment(ALIGNMENT);
+    owned.Reserve(count, sizeof(PushRecord));
+    Measure("LinearAllocator::PushN (owned)", count, [&] { owned.Clear(); }, [&] {
+        g_sink = owned.PushN(std::span<const PushRecord>(records)) + owned.Size();
+    });
+}
+
+// Frees every other range of a full buffer and allocates ranges of other sizes into the holes, as streamed geometry does.
+void BenchGpuBufferAllocator(size_t count, std::mt19937& rng)
+{
+    std::uniform_int_distribution<std::uint32_t> size(64, 4096);
+    std::vector<std::uint32_t> sizes(count);
+    std::ranges::generate(sizes, [&] { return size(rng); });
+
+    Glitter::Render::GpuBufferAllocator allocator(sizeof(float), "Benchmark Buffer");
+    std::vector<Glitter::Render::GpuRange> ranges(count);
+    auto fill = [&] {
+        allocator.Clear();
+        for (size_t idx = 0; idx < count; idx++) {
+            ranges[idx] = allocator.Allocate(sizes[idx]);
+        }
+    };
+
+    Measure("GpuBufferAllocator::Allocate", count, [&] { allocator.Clear(); }, fill);
+    Measure("GpuBufferAllocator (churn)", count, fill, [&] {
+        for (size_t idx = 0; idx < count; idx += 2) {
+            allocator.Free(ranges[idx]);
+        }
+        for (size_t idx = 0; idx < count; idx += 2) {
+            ranges[idx] = allocator.Allocate(sizes[count - 1 - idx], 4);
+        }
+        g_sink = allocator.GetEnd() + allocator.GetFreeRangeCount();
+    });
+}
+
+// Files every box into the grid, then moves a tenth of them, the way the Nodes are kept in sync with it. Then queries the
+// neighbourhood of a few of them, and casts rays through the scene, against testing every box. The queries are reported
+// per box in the scene too, so that they compare with the brute force directly.
+void BenchSpatialHashGrid(size_t count, std::mt19937& rng)
+{
+    constexpr size_t QUERY_COUNT = 64;
+    constexpr float QUERY_RADIUS = 1.5f;
+
+    Glitter::Render::CullBounds bounds = MakeBounds(count, rng);
+    std::vector<std::uint32_t> items(count);
+    std::iota(items.begin(), items.end(), 0u);
+    std::vector<std::uint32_t> moved {};
+    for (size_t idx = 0; idx < count; idx += 10) {
+        moved.push_back(static_cast<std::uint32_t>(idx));
+    }
+
+    Glitter::Scene::SpatialHashGrid grid(1.0f);
+    Measure("SpatialHashGrid::Update", count, [&] { grid.Clear(); }, [&] { grid.Update(bounds, items); });
+    Measure("SpatialHashGrid::Update (moves)", moved.size(), [&] {
+        for (std::uint32_t item : moved) {
+            bounds.Set(item, -bounds.GetCenter(item), bounds.GetExtent(item));
+        }
+    }, [&] { grid.Update(bounds, moved); });
+
+    std::vector<std::uint32_t> found {};
+    Measure("SpatialHashGrid::QuerySphere", count, [] {}, [&] {
+        found.clear();
+        for (size_t query = 0; query < QUERY_COUNT; query++) {
+            grid.QuerySphere(bounds, bounds.GetCenter(query * count / QUERY_COUNT), QUERY_RADIUS, found);
+        }
+        g_sink = found.size();
+    });
+    Measure("QuerySphere (brute force)", count, [] {}, [&] {
+        found.clear();
+        for (size_t query = 0; query < QUERY_COUNT; query++) {
+            glm::vec3 center = bounds.GetCenter(query * count / QUERY_COUNT);
+            for (size_t idx = 0; idx < count; idx++) {
+                glm::vec3 distance = glm::max(glm::abs(center - bounds.GetCenter(idx)) - bounds.GetExtent(idx), 0.0f);
+                if (glm::dot(distance, distance) <= QUERY_RADIUS * QUERY_RADIUS) {
+                    found.push_back(static_cast<std::uint32_t>(idx));
+                }
+            }
+        }
+        g_sink = found.size();
+    });
+
+    // From the spawn sphere's surface through its center, as a pick from outside the scene would.
+    std::vector<glm::vec3> origins(QUERY_COUNT);
+    std::ranges::generate(origins, [&] {
+        std::uniform_real_distribution<float> angle(0.0f, glm::two_pi<float>());
+        return glm::vec3(std::cos(angle(rng)), 0.5f, std::sin(angle(rng))) * 15.0f;
+    });
+    Measure("SpatialHashGrid::Raycast", count, [] {}, [&] {
+        size_t hits = 0;
+        for (const glm::vec3& origin : origins) {
+            hits += grid.Raycast(bounds, origin, -origin, 2.0f).has_value();
+        }
+        g_sink = hits;
+    });
+}
+
+// Removes random Nodes from a full store and adds as many back, reusing their slots.
+void BenchNodeStore(size_t count, std::mt19937& rng)
+{
+    Glitter::Scene::NodeStore nodes;
+    Glitter::Scene::NodeDesc desc {.m_position = glm::vec3(0.0f),
+        .m_scale = glm::vec3(1.0f),
+        .m_meshID = 0,
+        .m_textureID = 0,
+        .m_materialID = 0,
+        .m_opacity = 1.0f,
+        .m_shouldAnimate = false,
+        .m_animationPhase = 0.0f};
+    std::vector<Glitter::Scene::NodeHandle> handles;
+    auto fill = [&] {
+        nodes.Clear();
+        handles.clear();
+        for (size_t idx = 0; idx < count; idx++) {
+            handles.push_back(nodes.Add(desc));
+        }
+        nodes.ClearDirty();
+        std::ranges::shuffle(handles, rng);
+    };
+
+    Measure("NodeStore::Add", count, [&] { nodes.Clear(); }, [&] {
+        for (size_t idx = 0; idx < count; idx++) {
+            nodes.Add(desc);
+        }
+        g_sink = nodes.Size();
+    });
+    // The arrays a scene snapshot is read into, appended at once.
+    std::vector<glm::vec3> positions(count, desc.m_position);
+    std::vector<glm::quat> rotations(count, desc.m_rotation);
+    std::vector<glm::vec3> scales(count, desc.m_scale);
+    std::vector<float> floats(count, 1.0f);
+    std::vector<std::uint8_t> flags(count, 0);
+    std::vector<std::uint32_t> parents(count, Glitter::Scene::NodeArrays::NO_PARENT);
+    std::vector<std::uint32_t> ids(count, 0);
+    Measure("NodeStore::Append", count, [&] { nodes.Clear(); }, [&] {
+        nodes.Append(Glitter::Scene::NodeArrays {.m_positions = positions,
+            .m_rotations = rotations,
+            .m_scales = scales,
+            .m_opacities = floats,
+            .m_flags = flags,
+            .m_animationPhases = floats,
+            .m_parents = parents,
+            .m_meshIDs = ids,
+            .m_textureIDs = ids,
+            .m_materialIDs = ids});
+        g_sink = nodes.Size();
+    });
+    Measure("NodeStore::Remove + Add", count, fill, [&] {
+        for (Glitter::Scene::NodeHandle handle : handles) {
+            nodes.Remove(handle);
+            nodes.Add(desc);
+        }
+        g_sink = nodes.Size() + nodes.DirtyNodes().size();
+    });
+}
+
+// Spawns `count` random Nodes the way the space key does, initialized on the job system and appended at once.
+void BenchSpawn(size_t count, Glitter::Core::JobSystem& jobSystem)
+{
+    Glitter::Scene::NodeStore nodes;
+    auto generator = [](size_t /*nodeIdx*/, Glitter::Util::Pcg32& rng) {
+        return Glitter::Scene::NodeDesc {.m_position = rng.NextDirection() * 11.25f,
+            .m_rotation = glm::angleAxis(rng.NextFloat() * glm::two_pi<float>(), rng.NextDirection()),
+            .m_scale = glm::vec3(0.25f),
+            .m_meshID = rng.NextBelow(4),
+            .m_textureID = rng.NextBelow(2),
+            .m_materialID = 0,
+            .m_opacity = 1.0f,
+            .m_shouldAnimate = false,
+            .m_animationPhase = 0.0f};
+    };
+    Measure("GenerateNodes + Append", count, [&] { nodes.Clear(); }, [&] {
+        Glitter::Scene::GeneratedScene spawned
+            = Glitter::Scene::GenerateNodes(count, Glitter::Config::SPAWN_GRAIN_SIZE, 1337, jobSystem, generator);
+        nodes.Append(spawned.GetArrays());
+        g_sink = nodes.Size();
+    });
+}
+
+// `count` Nodes, each with a translation and a rotation channel of 30 keyframes a second, sampled a frame further each run.
+void BenchAnimation(size_t count, std::mt19937& rng, Glitter::Core::JobSystem& jobSystem)
+{
+    constexpr std::uint32_t KEYFRAME_COUNT = 30;
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+    Glitter::Scene::GltfAnimations animations {};
+    animations.m_clips.push_back(Glitter::Scene::GltfAnimation {
+        .m_firstChannel = 0, .m_channelCount = static_cast<std::uint32_t>(count * 2), .m_duration = 1.0f});
+    for (size_t nodeIdx = 0; nodeIdx < count; nodeIdx++) {
+        animations.m_nodes.push_back(Glitter::Scene::GltfAnimatedNode {.m_node = static_cast<std::uint32_t>(nodeIdx),
+            .m_joint = 0,
+            .m_prefixTranslation = glm::vec3(0.0f),
+            .m_prefixRotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+            .m_prefixScale = glm::vec3(1.0f),
+            .m_translation = glm::vec3(0.0f),
+            .m_rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+            .m_scale = glm::vec3(1.0f)});
+        for (Glitter::Scene::GltfAnimationPath path : {Glitter::Scene::GltfAnimationPath::Translation,
+                 Glitter::Scene::GltfAnimationPath::Rotation}) {
+            animations.m_channels.push_back(Glitter::Scene::GltfAnimationChannel {.m_node = static_cast<std::uint32_t>(nodeIdx),
+                .m_path = path,
+                .m_step = 0,
+                .m_firstKeyframe = static_cast<std::uint32_t>(animations.m_keyframeTimes.size()),
+                .m_keyframeCount = KEYFRAME_COUNT});
+            for (std::uint32_t keyframeIdx = 0; keyframeIdx < KEYFRAME_COUNT; keyframeIdx++) {
+                glm::vec4 keyframe {value(rng), value(rng), value(rng), value(rng)};
+                animations.m_keyframeTimes.push_back(static_cast<float>(keyframeIdx) / static_cast<float>(KEYFRAME_COUNT - 1));
+                animations.m_keyframeValues.push_back(
+                    path == Glitter::Scene::GltfAnimationPath::Rotation ? glm::normalize(keyframe) : keyframe);
+            }
+        }
+    }
+
+    Glitter::Scene::NodeStore nodes;
+    std::vector<Glitter::Scene::NodeHandle> handles;
+    for (size_t idx = 0; idx < count; idx++) {
+        handles.push_back(nodes.Add(Glitter::Scene::NodeDesc {.m_position = glm::vec3(0.0f),
+            .m_scale = glm::vec3(1.0f),
+            .m_meshID = 0,
+            .m_textureID = 0,
+            .m_materialID = 0,
+            .m_opacity = 1.0f,
+            .m_shouldAnimate = false,
+            .m_animationPhase = 0.0f}));
+    }
+    Glitter::Scene::AnimationPlayer player;
+    player.Add(animations, 0, handles, std::nullopt);
+    Glitter::Scene::Skeletons skeletons;
+
+    float time = 0.0f;
+    Measure("AnimationPlayer::Evaluate", count, [&] { nodes.ClearDirty(); }, [&] {
+        time += 1.0f / 60.0f;
+        player.Evaluate(time, nodes, skeletons, jobSystem);
+        g_sink = nodes.DirtyNodes().size();
+    });
+}
+
+// Builds an in-memory glTF Mesh with one primitive of `vertexCount` interleaved position, normal and texture coordinate
+// vertices, the layout most exporters write.
+struct SyntheticGltf {
+    std::vector<float> m_vertices;
+    std::vector<std::uint32_t> m_indices;
+
+    // The vertex then the index buffer, registered with m_data so that the importer counts their uses down. Their data
+    // isn't cgltf's to free, so none is released and every run extracts the same data.
+    std::array<cgltf_buffer, 2> m_buffers {};
+    cgltf_buffer_view m_vertexView {};
+    cgltf_buffer_view m_indexView {};
+    std::array<cgltf_accessor, 4> m_accessors {};
+    std::array<cgltf_attribute, 3> m_attributes {};
+    cgltf_primitive m_primitive {};
+    cgltf_mesh m_mesh {};
+    cgltf_data m_data {};
+
+    explicit SyntheticGltf(size_t vertexCount, std::mt19937& rng)
+    {
+        constexpr size_t FLOATS_PER_VERTEX = 8;
+        std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+        m_vertices.resize(vertexCount * FLOATS_PER_VERTEX);
+        std::ranges::generate(m_vertices, [&] { return value(rng); });
+        m_indices.resize(vertexCount);
+        for (size_t idx = 0; idx < vertexCount; idx++) {
+            m_indices[idx] = static_cast<std::uint32_t>((idx * 7) % vertexCount);
+        }
+
+        cgltf_buffer& vertexBuffer = m_buffers[0];
+        vertexBuffer.size = m_vertices.size() * sizeof(float);
+        vertexBuffer.data = m_vertices.data();
+        cgltf_buffer& indexBuffer = m_buffers[1];
+        indexBuffer.size = m_indices.size() * sizeof(std::uint32_t);
+        indexBuffer.data = m_indices.data();
+
+        m_vertexView.buffer = &vertexBuffer;
+        m_vertexView.size = vertexBuffer.size;
+        m_vertexView.stride = FLOATS_PER_VERTEX * sizeof(float);
+        m_indexView.buffer = &indexBuffer;
+        m_indexView.size = indexBuffer.size;
+
+        constexpr std::array ATTRIBUTES = std::to_array<std::pair<cgltf_attribute_type, cgltf_type>>({
+            {cgltf_attribute_type_position, cgltf_type_vec3},
+            {cgltf_attribute_type_normal, cgltf_type_vec3},
+            {cgltf_attribute_type_texcoord, cgltf_type_vec2},
+        });
+        size_t offset = 0;
+        for (size_t attribIdx = 0; attribIdx < ATTRIBUTES.size(); attribIdx++) {
+            cgltf_accessor& accessor = m_accessors[attribIdx];
+            accessor.component_type = cgltf_component_type_r_32f;
+            accessor.type = ATTRIBUTES[attribIdx].second;
+            accessor.offset = offset;
+            accessor.count = vertexCount;
+            accessor.stride = m_vertexView.stride;
+            accessor.buffer_view = &m_vertexView;
+            offset += cgltf_calc_size(accessor.type, accessor.component_type);
+
+            m_attributes[attribIdx].type = ATTRIBUTES[attribIdx].first;
+            m_attributes[attribIdx].data = &accessor;
+        }
+
+        cgltf_accessor& indexAccessor = m_accessors.back();
+        indexAccessor.component_type = cgltf_component_type_r_32u;
+        indexAccessor.type = cgltf_type_scalar;
+        indexAccessor.count = vertexCount;
+        indexAccessor.stride = sizeof(std::uint32_t);
+        indexAccessor.buffer_view = &m_indexView;
+
+        m_primitive.type = cgltf_primitive_type_triangles;
+        m_primitive.indices = &indexAccessor;
+        m_primitive.attributes = m_attributes.data();
+        m_primitive.attributes_count = m_attributes.size();
+        m_mesh.primitives = &m_primitive;
+        m_mesh.primitives_count = 1;
+        m_data.meshes = &m_mesh;
+        m_data.meshes_count = 1;
+        m_data.buffers = m_buffers.data();
+        m_data.buffers_count = m_buffers.size();
+    }
+
+    SyntheticGltf(const SyntheticGltf&) = delete;
+    SyntheticGltf& operator=(const SyntheticGltf&) = delete;
+};
+
+void BenchGltf(size_t count, std::mt19937& rng)
+{
+    SyntheticGltf gltf(count, rng);
+    Measure("ExtractGltfAsset (vertices)", count, [] {}, [&] {
+        Glitter::Scene::GltfAsset asset = Glitter::Scene::ExtractGltfAsset(gltf.m_data);
+        g_sink = asset.m_primitives[0].m_vertexData.size();
+    });
+
+    Glitter::Scene::GltfPrimitive primitive = std::move(Glitter::Scene::ExtractGltfAsset(gltf.m_data).m_primitives[0]);
+    std::span<std::byte> vertices = std::as_writable_bytes(std::span(primitive.m_vertexData));
+    std::vector<std::byte> encodedVertices = Glitter::Util::EncodeVertexBuffer(vertices, sizeof(Glitter::Scene::MeshVertex));
+    Measure("DecodeVertexBuffer", count, [] {}, [&] {
+        g_sink = Glitter::Util::DecodeVertexBuffer(encodedVertices, vertices, sizeof(Glitter::Scene::MeshVertex));
+    });
+    std::vector<std::byte> encodedIndices = Glitter::Util::EncodeIndexBuffer(primitive.m_vertexIndices);
+    Measure("DecodeIndexBuffer", count, [] {},
+        [&] { g_sink = Glitter::Util::DecodeIndexBuffer(encodedIndices, primitive.m_vertexIndices); });
+}
+
+} // namespace
+
+int main()
+{
+    // Every run benchmarks the same data.
+    std::mt19937 rng(1337);
+    Glitter::Core::JobSystem jobSystem(Glitter::Config::JOB_WORKER_COUNT);
+
+    std::println("CPU: {}, culling with {}", Glitter::Core::GetSimdLevelName(Glitter::Core::GetSimdLevel()),
+        Glitter::Core::GetSimdLevelName(Glitter::Render::GetCullSimdLevel()));
+    std::println("{:<32} {:>9} {:>18} {:>18}", "routine", "elements", "time", "throughput");
+    for (size_t count : ELEMENT_COUNTS) {
+        BenchCulling(count, rng);
+        BenchSorting(count, rng, jobSystem);
+        BenchAllocator(count);
+        BenchGpuBufferAllocator(count, rng);
+        BenchNodeStore(count, rng);
+        BenchSpawn(count, jobSystem);
+        BenchAnimation(count, rng, jobSystem);
+        BenchSpatialHashGrid(count, rng);
+        BenchGltf(count, rng);
+    }
+
+    return 0;
+}
@@ -1,7 +1,550 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 namespace Glitter::Config {
 
-constexpr size_t MAX_NODES = 10'000;
+// Nodes the UBO is initially sized for, it grows past this on demand.
+constexpr size_t INITIAL_NODE_CAPACITY = 10'000;
+// Nodes per page of the persistent Node data and GPU bounds, each page a buffer of its own bound as an SSBO block by
+// itself, so that the Nodes outgrow neither a single buffer nor the block size limit. 64 MiB of PerDrawData, within the
+// 128 MiB block every GL 4.6 driver allows. The shaders index the bound page by Node slot modulo the page size, see
+// Glitter::Render::GenerateShaderDataGlsl().
+constexpr std::uint32_t NODE_PAGE_SIZE = 1u << 20;
+
+// Bytes of a chunk of the entities of an archetype, see Glitter::Scene::EntityWorld. 16 KiB keeps a chunk's arrays within
+// L1 while a system walks them.
+constexpr size_t ENTITY_CHUNK_SIZE = 16 * 1024;
+
+// Nodes spawned per SPACE press.
+constexpr size_t NODES_PER_SPAWN = 500;
+// Radius the Nodes of the GPU-simulated swarm swirl around the origin at.
+constexpr float SWARM_RADIUS = 6.0f;
+
+// Defaults of the scene generator, see Glitter::Scene::GenerateScene(): the Node count, the radius of the ball they're
+// spread through, and for the clustered distribution the number of clusters and their radius.
+constexpr size_t GENERATOR_NODE_COUNT = 100'000;
+constexpr float GENERATOR_RADIUS = 30.0f;
+constexpr size_t GENERATOR_CLUSTER_COUNT = 32;
+constexpr float GENERATOR_CLUSTER_RADIUS = 1.5f;
+
+// Frames the CPU can run ahead of the GPU, and so the number of regions in each per-frame stream buffer.
+constexpr size_t FRAMES_IN_FLIGHT = 3;
+
+// Frame rate of the frame limiter, when it's selected. It sleeps until FRAME_LIMITER_SPIN_TIME seconds before each frame
+// is due, and spins from there. The measured input latency is averaged over LATENCY_HISTORY_SIZE frames.
+constexpr double FRAME_LIMIT_RATE = 120.0;
+constexpr double FRAME_LIMITER_SPIN_TIME = 0.002;
+constexpr size_t LATENCY_HISTORY_SIZE = 32;
+
+// The just-in-time frames' pacing, see Glitter::Render::FramePacer: the seconds left to spare before each refresh, the
+// seconds the delay grows by per frame on time, and the most frames it's held for after a frame missed its refresh.
+constexpr double FRAME_DELAY_MARGIN = 0.002;
+constexpr double FRAME_DELAY_STEP = 0.0002;
+constexpr size_t FRAME_DELAY_MAX_HOLD = 1024;
+
+// Whether the frames are only drawn on demand, the simulation clock being held so that an untouched scene stays static.
+// Once ON_DEMAND_SETTLE_FRAMES frames went by without input or changes to the scene, the loop waits for the next event
+// instead, for up to ON_DEMAND_IDLE_TIMEOUT seconds in case a background load completes. The settle frames let the
+// temporal upsampling converge through all of its jitter phases first. An iconified, hidden or 0x0 window draws nothing
+// whether or not this is enabled.
+constexpr bool ENABLE_ON_DEMAND_RENDERING = false;
+constexpr size_t ON_DEMAND_SETTLE_FRAMES = 20;
+constexpr double ON_DEMAND_IDLE_TIMEOUT = 0.5;
+
+// Rate the simulation advances at, independently of the frame rate, and the steps a frame can catch up on before the
+// simulation slows down instead. Frames are interpolated between the last two steps.
+constexpr double SIMULATION_TIME_STEP = 1.0 / 60.0;
+constexpr size_t MAX_SIMULATION_STEPS = 5;
+
+// Update each frame's packet (Node transforms, culling and draw lists) on the update thread while the main thread submits
+// the previous one, at the cost of a frame of latency.
+constexpr bool ENABLE_FRAME_PIPELINING = true;
+
+// Flush the frame's commands before the CPU builds its draw batches, after the opaque pass, before Dear ImGui builds its
+// draw lists, and every SUBMIT_FLUSH_COMMANDS draw commands. The GPU then starts on them while the CPU is still busy,
+// instead of only at the swap.
+constexpr bool ENABLE_EARLY_FLUSH = true;
+constexpr size_t SUBMIT_FLUSH_COMMANDS = 4096;
+
+// Latch the main view's camera again as its frame is submitted, at the simulation time of then, instead of drawing from the
+// camera its packet was updated with, a frame earlier when pipelined. The packets are culled against their frustum grown
+// by LATE_LATCH_CULL_MARGIN world units, about as far as the camera moves in a frame, so that the latched camera doesn't
+// turn towards culled Nodes. The benchmark, and the camera recordings and their playback, keep the packets' camera.
+constexpr bool ENABLE_LATE_LATCHING = true;
+constexpr float LATE_LATCH_CULL_MARGIN = 0.1f;
+
+// Reuse the main pass' culled and sorted draw lists of an earlier packet while no Node moved, was added or removed, none
+// of the settings they were built with changed, and the camera's frustum drifted by at most DRAW_LIST_CACHE_MAX_DRIFT
+// world units, out to the far plane, from the one they were built for. The frusta are culled grown by as much, so that
+// the Nodes the drifted camera turns towards are listed already.
+constexpr bool ENABLE_DRAW_LIST_CACHING = true;
+constexpr float DRAW_LIST_CACHE_MAX_DRIFT = 0.05f;
+
+// Sample Node textures through GL_ARB_bindless_texture handles when the driver supports it.
+constexpr bool ENABLE_BINDLESS_TEXTURES = true;
+
+// Otherwise, sample Node textures from the layers of a single GL_TEXTURE_2D_ARRAY so they don't split batches either.
+constexpr bool ENABLE_TEXTURE_ARRAY = true;
+
+// Load the pre-compressed .ktx2 next to each Node texture when there's one in a format the driver supports, instead of
+// decoding the image and generating its mips at startup. See the GlitterTextureTool target.
+constexpr bool ENABLE_COMPRESSED_TEXTURES = true;
+
+// Compress the Node textures without a .ktx2 as they're decoded, into BC7, or BC1 for the opaque ones where the driver
+// lacks BC7, and keep the result in TEXTURE_TRANSCODE_CACHE_DIRECTORY, keyed by the hash of the image file, so that later
+// launches load it instead. Only along with ENABLE_COMPRESSED_TEXTURES. Relative to the data directory.
+constexpr bool ENABLE_TEXTURE_TRANSCODING = true;
+constexpr const char* TEXTURE_TRANSCODE_CACHE_DIRECTORY = "texturecache";
+
+// Box-filter the mips of decoded Node textures on the job system along with the decoding, instead of generating them on
+// the GPU once they're uploaded.
+constexpr bool ENABLE_CPU_TEXTURE_MIPS = true;
+
+// Generate the mips of the textures created without them, the Node textures and the impostor atlas, with the MipCS compute
+// program, a single dispatch per texture, filtering the sRGB ones in linear space, instead of glGenerateTextureMipmap(). See
+// Render::MipGenerator.
+constexpr bool ENABLE_COMPUTE_MIPS = true;
+
+// Anisotropic filtering of the Node textures' sampler, capped by the driver's maximum, and the bias added to the level of
+// detail they're sampled at. A positive bias samples coarser levels, for less bandwidth at the cost of sharpness.
+constexpr float TEXTURE_ANISOTROPY = 8.0f;
+constexpr float TEXTURE_MIP_BIAS = 0.0f;
+
+// Bytes of the persistently-mapped pixel unpack buffer texture uploads are staged through.
+constexpr size_t TEXTURE_UPLOAD_RING_SIZE = 16 * 1024 * 1024;
+
+// Stream the mips of Node textures in as Nodes using them are drawn larger, within TEXTURE_STREAMING_BUDGET bytes. Only
+// textures with a full mip chain are streamed, so either pre-compressed ones or ENABLE_CPU_TEXTURE_MIPS are needed.
+constexpr bool ENABLE_TEXTURE_STREAMING = true;
+constexpr size_t TEXTURE_STREAMING_BUDGET = 256 * 1024 * 1024;
+// Levels up to this many texels wide and high are uploaded at startup, and never evicted.
+constexpr size_t TEXTURE_STREAMING_MIN_SIZE = 32;
+// Bytes of streamed levels staged per frame at most.
+constexpr size_t TEXTURE_STREAMING_UPLOAD_BUDGET = 4 * 1024 * 1024;
+
+// Cull Nodes and build their indirect commands in a compute pass by default, sorting the transparent ones back-to-front
+// on the GPU too. Only available with bindless or array textures.
+constexpr bool ENABLE_GPU_CULLING = false;
+
+// Count the Nodes the GPU culling pass keeps and culls, by the test culling them, and the LOD sizes of those it keeps, read
+// back FRAMES_IN_FLIGHT frames later for the Performance header instead of stalling on the pass. See
+// Render::GpuCullStatistics.
+constexpr bool ENABLE_GPU_CULL_STATISTICS = true;
+
+// Draw the transparent Nodes with weighted blended order-independent transparency by default, batched by state like the
+// opaque ones instead of sorted back-to-front, at the cost of an approximate result where they overlap.
+constexpr bool ENABLE_WEIGHTED_OIT = true;
+
+// Blit the scene color straight to the backbuffer when no post-processing effect is enabled, rather than copying it
+// through a PpfxCS dispatch first.
+constexpr bool ENABLE_POST_PROCESS_ELISION = true;
+
+// Render the main pass into GL_R11F_G11F_B10F rather than GL_RGBA16F, HDR at the bandwidth of RGBA8. It has no alpha,
+// which nothing reads back, and less precision, which the tonemapping hides.
+constexpr bool ENABLE_PACKED_HDR_COLOR = true;
+
+// Render both eyes of a stereo pair in a single main pass through GL_OVR_multiview, when it's supported, with the Nodes
+// culled once against a frustum holding both eyes'. The eyes are STEREO_EYE_SEPARATION world units apart. The passes
+// without a multiview program, the visibility buffer, impostors, occlusion queries and culling, weighted blended OIT,
+// temporal upsampling and the post-processing, are left out.
+constexpr bool ENABLE_STEREO = false;
+constexpr float STEREO_EYE_SEPARATION = 0.065f;
+
+// Inset views drawn over the main view by default, each from its own camera, as pictures-in-picture of INSET_VIEW_SIZE
+// of the target's height, up to MAX_INSET_VIEWS. See Glitter::Render::ViewLayout. The Nodes are culled for every view at
+// once, and each view draws its part of the main pass' sorted draw lists.
+constexpr size_t INSET_VIEW_COUNT = 0;
+constexpr size_t MAX_INSET_VIEWS = 3;
+constexpr float INSET_VIEW_SIZE = 0.3f;
+
+// Coarsen the main pass' shading through GL_NV_shading_rate_image by default, where it's supported, down to one fragment
+// shader invocation per 4x4 pixels. Foveated, the rate drops from SHADING_RATE_FOVEA_RADIUS of the half-diagonal out to
+// the corners. Content adaptive, it drops in the tiles where the previous frame's luma contrast between neighbouring
+// pixels stayed under SHADING_RATE_CONTRAST_THRESHOLD.
+constexpr bool ENABLE_VARIABLE_RATE_SHADING = false;
+constexpr float SHADING_RATE_FOVEA_RADIUS = 0.5f;
+constexpr float SHADING_RATE_CONTRAST_THRESHOLD = 0.04f;
+
+// Shade the opaque Nodes from a visibility buffer by default: a first pass only writes which triangle covers each pixel,
+// and a compute pass shades each pixel once from it, whatever the overdraw. Only available with bindless or array
+// textures.
+constexpr bool ENABLE_VISIBILITY_BUFFER = false;
+
+// Shadow the main light with a SHADOW_MAP_SIZE map, cached for the Nodes that haven't moved in SHADOW_DYNAMIC_FRAMES.
+// Shaded fragments are offset by SHADOW_NORMAL_OFFSET along their normal before sampling it, against shadow acne.
+constexpr bool ENABLE_SHADOWS = true;
+constexpr std::int32_t SHADOW_MAP_SIZE = 2048;
+constexpr std::uint64_t SHADOW_DYNAMIC_FRAMES = 60;
+constexpr float SHADOW_NORMAL_OFFSET = 0.02f;
+
+// In the automatic mode, the opaque Nodes' depth is drawn first, from positions only and without shading, once their
+// overdraw is above DEPTH_PREPASS_ENABLE_OVERDRAW fragments per pixel, so that the color pass only shades the visible
+// ones. It's dropped again below DEPTH_PREPASS_DISABLE_OVERDRAW.
+constexpr float DEPTH_PREPASS_ENABLE_OVERDRAW = 2.0f;
+constexpr float DEPTH_PREPASS_DISABLE_OVERDRAW = 1.5f;
+
+// Render the main pass at a fraction of the window's resolution, lowered while the GPU frame time is above
+// DYNAMIC_RESOLUTION_TARGET_MS and raised back once it's below DYNAMIC_RESOLUTION_HEADROOM times that, then upscaled
+// bilinearly to the window by the post-processing. Off in the benchmark, so that its runs stay comparable.
+constexpr bool ENABLE_DYNAMIC_RESOLUTION = true;
+constexpr double DYNAMIC_RESOLUTION_TARGET_MS = 14.0;
+constexpr double DYNAMIC_RESOLUTION_HEADROOM = 0.8;
+constexpr float DYNAMIC_RESOLUTION_MIN_SCALE = 0.5f;
+constexpr float DYNAMIC_RESOLUTION_STEP = 0.05f;
+// Frames between two changes, more than FRAMES_IN_FLIGHT so that the GPU timings read back are of the new resolution.
+constexpr size_t DYNAMIC_RESOLUTION_SETTLE_FRAMES = 30;
+
+// Step the rendering quality down through the levels of Glitter::Render::QualityGovernor, to coarser LODs, a shorter
+// draw distance, a smaller shadow map and fewer post effects, while the slower of the CPU and GPU frame times stays above
+// QUALITY_GOVERNOR_TARGET_MS for QUALITY_GOVERNOR_DEGRADE_FRAMES frames, and back up once it's stayed below
+// QUALITY_GOVERNOR_HEADROOM times that for QUALITY_GOVERNOR_RECOVER_FRAMES. The target is above the dynamic resolution's,
+// so that the quality only drops once the resolution can't hold the frame time, or when the CPU is holding it. Off in
+// the benchmark, so that its runs stay comparable.
+constexpr bool ENABLE_QUALITY_GOVERNOR = true;
+constexpr double QUALITY_GOVERNOR_TARGET_MS = 16.0;
+constexpr double QUALITY_GOVERNOR_HEADROOM = 0.75;
+constexpr size_t QUALITY_GOVERNOR_DEGRADE_FRAMES = 30;
+constexpr size_t QUALITY_GOVERNOR_RECOVER_FRAMES = 120;
+
+// Render the main pass at TEMPORAL_UPSAMPLING_SCALE of the window's resolution, on top of the dynamic resolution's
+// scale, with its projection jittered within a pixel along TEMPORAL_UPSAMPLING_JITTER_PHASES points of the Halton
+// sequence, and accumulate the jittered frames into a history at the window's resolution. The history keeps
+// TEMPORAL_UPSAMPLING_BLEND of the new samples landing on a pixel's center, less for the further ones.
+constexpr bool ENABLE_TEMPORAL_UPSAMPLING = false;
+constexpr float TEMPORAL_UPSAMPLING_SCALE = 0.67f;
+constexpr std::uint32_t TEMPORAL_UPSAMPLING_JITTER_PHASES = 16;
+constexpr float TEMPORAL_UPSAMPLING_BLEND = 0.1f;
+
+// Screen-sized render targets are allocated in multiples of RENDER_TARGET_BUCKET texels wide and high, and the passes
+// render a viewport of them. While the window is being resized, they're only reallocated once it hasn't changed size
+// for RENDER_TARGET_RESIZE_SETTLE seconds, rendering at a lower resolution meanwhile if it outgrew them. Released
+// targets are kept for RENDER_TARGET_POOL_FRAMES frames, in case the window goes back to their size.
+constexpr size_t RENDER_TARGET_BUCKET = 128;
+constexpr double RENDER_TARGET_RESIZE_SETTLE = 0.25;
+constexpr size_t RENDER_TARGET_POOL_FRAMES = 300;
+
+// Bytes of the main thread's frame arena, for the data only living until the end of the frame. It grows past this on
+// demand.
+constexpr size_t FRAME_ARENA_SIZE = 256 * 1024;
+
+// Job system worker threads, 0 uses one per hardware thread minus the main thread.
+constexpr size_t JOB_WORKER_COUNT = 0;
+// Pin each worker to a hardware thread of its own, past the first, so that the scheduler doesn't move the frame's jobs
+// between cores mid-frame. Off by default, since it also keeps the workers off cores another process is busy on.
+constexpr bool ENABLE_JOB_AFFINITY = false;
+// While the main thread's frame time is past JOB_THROTTLE_FRAME_MS, only JOB_THROTTLED_BACKGROUND_WORKERS workers at a time
+// run background jobs, loading and streaming, see Core::JobPriority. Below the quality governor's target, so that the
+// background work yields before the quality is lowered.
+constexpr double JOB_THROTTLE_FRAME_MS = 14.0;
+constexpr size_t JOB_THROTTLED_BACKGROUND_WORKERS = 1;
+
+// Nodes per culling job, a multiple of 64 so that jobs never share a word of the visibility mask.
+constexpr size_t CULL_GRAIN_SIZE = 1024;
+static_assert(CULL_GRAIN_SIZE % 64 == 0);
+
+// Nodes initialized per job when spawning or generating them, each range from a random stream of its own.
+constexpr size_t SPAWN_GRAIN_SIZE = 4096;
+
+// How far inside the frustum, in world units, a group of Nodes must be for the CPU frustum culling to skip it on the next
+// frames. The camera can move about as far before they're tested again, see Glitter::Render::BeginCull().
+constexpr float CULL_INSIDE_MARGIN = 0.5f;
+// The groups of Nodes further than CULL_TIME_SLICE_DISTANCE world units along the view are only tested by the CPU frustum
+// culling every CULL_TIME_SLICE_FRAMES frames, a staggered share of them each frame, against the frustum grown by
+// CULL_TIME_SLICE_MARGIN world units. They keep that result in between, unless the camera moved about as far over those
+// frames. 1 tests every Node each frame, the default, as the groups flagged inside and the plane tried first already make
+// the distant ones about as cheap to test as to skip.
+constexpr std::uint32_t CULL_TIME_SLICE_FRAMES = 1;
+constexpr float CULL_TIME_SLICE_DISTANCE = 10.0f;
+constexpr float CULL_TIME_SLICE_MARGIN = 0.5f;
+static_assert(CULL_TIME_SLICE_FRAMES > 0);
+
+// The SIMD kernels are picked at startup among the instruction sets the CPU has, see Glitter::Core::GetSimdLevel(). Some
+// CPUs lower their clock for a while after running AVX-512, which may cost the rest of the frame more than it saves.
+constexpr bool ENABLE_AVX512 = true;
+
+// The CPU occlusion culling rasterizes the OCCLUDER_MAX_NODES visible Nodes projecting to the largest spheres, at least
+// OCCLUDER_MIN_PIXELS across, among those whose Mesh has an occluder of at most OCCLUDER_MAX_TRIANGLES triangles, into an
+// OCCLUSION_BUFFER_WIDTH by OCCLUSION_BUFFER_HEIGHT depth buffer, then culls the Nodes hidden behind them the same frame.
+// The buffer is rasterized in bands of OCCLUSION_BAND_HEIGHT rows, one per job. See Glitter::Render::OcclusionBuffer.
+constexpr std::uint32_t OCCLUSION_BUFFER_WIDTH = 256;
+constexpr std::uint32_t OCCLUSION_BUFFER_HEIGHT = 128;
+constexpr std::uint32_t OCCLUSION_BAND_HEIGHT = 16;
+constexpr size_t OCCLUDER_MAX_NODES = 32;
+constexpr size_t OCCLUDER_MAX_TRIANGLES = 512;
+constexpr float OCCLUDER_MIN_PIXELS = 96.0f;
+static_assert(OCCLUSION_BUFFER_WIDTH % 8 == 0 && OCCLUSION_BUFFER_HEIGHT % OCCLUSION_BAND_HEIGHT == 0);
+static_assert(OCCLUSION_BAND_HEIGHT % 8 == 0);
+
+// The defaults of the contribution culling, which drops the Nodes whose bounds are further than MAX_DRAW_DISTANCE world
+// units from the eye, or project to a sphere of fewer than MIN_PROJECTED_PIXELS pixels across.
+constexpr float MAX_DRAW_DISTANCE = 20.0f;
+constexpr float MIN_PROJECTED_PIXELS = 1.0f;
+
+// Draw list entries recorded into draw batches per job, see BuildDrawBatches() in main.cpp.
+constexpr size_t DRAW_RECORD_GRAIN_SIZE = 2048;
+
+// Draw lists longer than this are radix sorted on the job system, in ranges of PARALLEL_SORT_GRAIN_SIZE entries. Shorter
+// ones sort faster on a single thread than the jobs take to hand out.
+constexpr size_t PARALLEL_SORT_THRESHOLD = 64 * 1024;
+constexpr size_t PARALLEL_SORT_GRAIN_SIZE = 16 * 1024;
+
+// Animation channels sampled, and animated Nodes composed, per job, see Glitter::Scene::AnimationPlayer.
+constexpr size_t ANIMATION_GRAIN_SIZE = 512;
+
+// Skinning matrices computed per job, see Glitter::Scene::Skeletons. The bounds of a skinned Mesh in the rest pose of its
+// joints are scaled by SKINNED_BOUNDS_SCALE around their center, so they keep holding it as it animates.
+constexpr size_t SKINNING_GRAIN_SIZE = 256;
+constexpr float SKINNED_BOUNDS_SCALE = 1.5f;
+
+// Cell size of the spatial hash grid over the Nodes, in world units. Nodes more than half a cell across are tested by every
+// query instead of being filed under a cell.
+constexpr float SPATIAL_GRID_CELL_SIZE = 1.0f;
+// The Nodes within this distance of the picked Node are highlighted along with it.
+constexpr float PICK_NEIGHBOR_RADIUS = 1.5f;
+// Whether clicked Nodes are picked from a Node ID target written along with the main pass' color and read back
+// asynchronously, rather than by a ray cast through the spatial grid. The Node IDs are only written by the Main program,
+// so the impostors, the static batches and the visibility buffer are turned off with it, and it's unavailable in stereo.
+constexpr bool ENABLE_GPU_PICKING = false;
+
+// Stream the Nodes of a world of WORLD_CHUNKS by WORLD_CHUNKS chunks, WORLD_CHUNK_SIZE world units square, around the
+// camera as it flies over them, WORLD_FLIGHT_SPEED world units per second along a WORLD_FLIGHT_RADIUS circle. Chunks are
+// loaded within WORLD_LOAD_RADIUS of the camera and unloaded past WORLD_UNLOAD_RADIUS, and the Nodes of up to
+// WORLD_CHUNKS_PER_FRAME of them added per frame. The world is generated into WORLD_PATH, relative to the data directory,
+// the first time it's streamed, WORLD_NODES_PER_CHUNK Nodes per chunk.
+constexpr const char* WORLD_PATH = "worlds/generated.world";
+constexpr float WORLD_CHUNK_SIZE = 8.0f;
+constexpr std::uint32_t WORLD_CHUNKS = 32;
+constexpr size_t WORLD_NODES_PER_CHUNK = 64;
+constexpr float WORLD_LOAD_RADIUS = 16.0f;
+constexpr float WORLD_UNLOAD_RADIUS = 24.0f;
+constexpr size_t WORLD_CHUNKS_PER_FRAME = 4;
+constexpr float WORLD_FLIGHT_RADIUS = 96.0f;
+constexpr float WORLD_FLIGHT_SPEED = 2.0f;
+// Whether the world's chunks are read through io_uring on Linux, or an I/O completion port on Windows, with up to
+// ASYNC_FILE_IO_QUEUE_DEPTH reads in flight from the streamer's thread, rather than copied out of the mapped world one
+// page fault after the other. See Glitter::Util::AsyncFileReader.
+constexpr bool ENABLE_ASYNC_FILE_IO = true;
+constexpr size_t ASYNC_FILE_IO_QUEUE_DEPTH = 64;
+// Chunks read by the streamer's thread and not yet polled by the main thread, it waits for room past that.
+constexpr size_t WORLD_RESULT_QUEUE_CAPACITY = 256;
+
+// Scene snapshot the Nodes are saved into and loaded from, relative to the data directory. See
+// Glitter::Scene::SceneSnapshot.
+constexpr const char* SCENE_SNAPSHOT_PATH = "scenes/snapshot.scene";
+
+// Camera recording written by "Record Camera" and played back by "Play Camera", relative to the data directory.
+constexpr const char* CAMERA_RECORDING_PATH = "recordings/camera.rec";
+
+// Directory "Capture Frame" writes its screenshots into, relative to the data directory.
+constexpr const char* SCREENSHOT_DIRECTORY = "screenshots";
+
+// Frames of the `--capture` image sequence being encoded at once, the main thread waits for the oldest past this.
+constexpr size_t FRAME_OUTPUT_QUEUE_SIZE = 16;
+
+// Unchanged Nodes allowed between two dirty ranges of Node data before they're uploaded separately.
+constexpr std::uint32_t NODE_UPLOAD_MERGE_GAP = 16;
+
+// Read glTF assets from a binary cache written next to them, rebuilt whenever the source changes.
+constexpr bool ENABLE_MESH_CACHE = true;
+// Store the vertices and indices of the Mesh cache through Util::GeometryCodec, several times smaller, and decoded on the
+// JobSystem as it's read.
+constexpr bool ENABLE_MESH_CACHE_COMPRESSION = true;
+
+// Upload Mesh vertices as Scene::QuantizedVertex instead of Scene::MeshVertex, halving their size.
+constexpr bool ENABLE_QUANTIZED_VERTICES = false;
+// Fetch the vertices in the vertex shaders from the geometry pool's VBO bound as an SSBO, by gl_VertexID, instead of
+// through the VAOs' attributes. Every pass then shares a single attribute-less VAO holding the EBO.
+constexpr bool ENABLE_VERTEX_PULLING = false;
+// Bytes of vertices, and of indices, new primitives fill a geometry pool page with before the next ones go into a new
+// page, each with a VBO and EBO of its own. Clamped to half the SSBO block size limit, so that the LODs and static
+// batches added over the vertices of a full page still fit in it.
+constexpr size_t GEOMETRY_PAGE_SIZE = 256 * 1024 * 1024;
+
+// Reorder the triangles and vertices of imported Meshes for the post-transform cache, overdraw and vertex fetch.
+constexpr bool ENABLE_MESH_OPTIMIZATION = true;
+// Store Mesh indices in 16 bits, splitting the primitives with more vertices than that.
+constexpr bool ENABLE_SHORT_INDICES = true;
+
+// LOD levels per primitive including the full-resolution one, and the clustering grid of the first simplified level.
+// A level is only kept if it has at most MESH_LOD_MIN_REDUCTION times the indices of the previous one.
+constexpr size_t MESH_LOD_COUNT = 4;
+constexpr std::uint32_t MESH_LOD_RESOLUTION = 32;
+constexpr float MESH_LOD_MIN_REDUCTION = 0.75f;
+// Nodes use the coarsest LOD whose clustering cells project to at most this many pixels.
+constexpr float MESH_LOD_CELL_PIXELS = 2.0f;
+
+// Only upload the coarsest LOD of each unskinned primitive with them as it loads, and stream the finer ones and the
+// primitive's own indices into the geometry pool as Nodes drawing it come close, within MESH_STREAMING_BUDGET bytes of
+// indices. Nodes are taken for MESH_STREAMING_PREFETCH_SCALE times their size, so that levels are requested before
+// they're drawn.
+constexpr bool ENABLE_MESH_STREAMING = true;
+constexpr size_t MESH_STREAMING_BUDGET = 64 * 1024 * 1024;
+constexpr float MESH_STREAMING_PREFETCH_SCALE = 1.5f;
+// Bytes of streamed levels added per frame at most.
+constexpr size_t MESH_STREAMING_UPLOAD_BUDGET = 1024 * 1024;
+
+// Bake an octahedral impostor of up to MAX_IMPOSTOR_MESHES Meshes as they're loaded, an IMPOSTOR_GRID by IMPOSTOR_GRID
+// grid of IMPOSTOR_FRAME_SIZE pixel views, and draw the opaque Nodes whose bounds project to fewer than IMPOSTOR_PIXELS
+// pixels as a single quad of the nearest view instead of their Mesh.
+constexpr bool ENABLE_IMPOSTORS = true;
+constexpr std::uint32_t MAX_IMPOSTOR_MESHES = 16;
+constexpr std::uint32_t IMPOSTOR_GRID = 8;
+constexpr std::int32_t IMPOSTOR_FRAME_SIZE = 64;
+constexpr float IMPOSTOR_PIXELS = 48.0f;
+
+// Pre-transform the Primitives of the static opaque Nodes into merged batches, one per texture and material of each
+// STATIC_BATCH_CELL_SIZE cell, split past STATIC_BATCH_MAX_VERTICES vertices for 16-bit indices. Up to
+// STATIC_BATCH_REBUILDS_PER_FRAME cells whose Nodes changed are rebuilt each frame, drawn one Node at a time until then.
+constexpr bool ENABLE_STATIC_BATCHING = true;
+constexpr float STATIC_BATCH_CELL_SIZE = 4.0f;
+constexpr std::uint32_t STATIC_BATCH_MAX_VERTICES = 65536;
+constexpr size_t STATIC_BATCH_REBUILDS_PER_FRAME = 8;
+
+// Build a hierarchical LOD proxy along with each static batch, from the coarsest LOD of its Primitives, and draw the
+// proxies of the cells whose bounds are further than HLOD_DISTANCE world units in place of their batches, so that the
+// far cells cost a command per texture and material at a fraction of the triangles.
+constexpr bool ENABLE_HLOD = true;
+constexpr float HLOD_DISTANCE = 10.0f;
+
+// Split the primitives with at least MESHLET_MIN_TRIANGLES triangles into meshlets of up to MESHLET_MAX_VERTICES unique
+// vertices and MESHLET_MAX_TRIANGLES triangles, culled one by one by GPU culling.
+constexpr bool ENABLE_MESHLETS = true;
+constexpr size_t MESHLET_MAX_VERTICES = 64;
+constexpr size_t MESHLET_MAX_TRIANGLES = 124;
+constexpr size_t MESHLET_MIN_TRIANGLES = 1024;
+
+// Bytes of loaded Mesh geometry uploaded per frame, so streaming a large glTF in doesn't stall rendering. A primitive
+// is never split, so at least one is uploaded per frame.
+constexpr size_t MESH_UPLOAD_BUDGET = 4 * 1024 * 1024;
+
+// Write streamed Mesh geometry from a second GL context, shared with the main one and current on its own thread, so the
+// uploads don't take main thread frame time. Falls back to the main context if it can't be created.
+constexpr bool ENABLE_UPLOAD_CONTEXT = true;
+
+// Save linked program binaries and load them on later launches with the same shader sources and driver, instead of
+// compiling the shaders again. Relative to the data directory.
+constexpr bool ENABLE_PROGRAM_CACHE = true;
+constexpr const char* PROGRAM_CACHE_DIRECTORY = "shadercache";
+
+// Draw once with every program and pass state after Prepare(), behind a loading screen, so that the driver builds the
+// variants it defers until the first draw before the first frame, instead of hitching the frames that first use them.
+constexpr bool ENABLE_PROGRAM_WARM_UP = true;
+
+// Load the shaders from the SPIR-V modules the GlitterSpirv target builds into SPIRV_DIRECTORY, where the driver supports
+// GL_ARB_gl_spirv. A shader without a module, or whose module fails to link, is compiled from its GLSL source instead.
+constexpr bool ENABLE_SPIRV_SHADERS = true;
+constexpr const char* SPIRV_DIRECTORY = "shaders/spirv";
+
+// The ambient light of the Main program. It's a specialization constant of its SPIR-V modules, which don't need to be
+// built again when it changes.
+constexpr float LIGHT_AMBIENT_STRENGTH = 0.1f;
+// The specular terms of the default material, of the Meshes without a material of their own.
+constexpr float LIGHT_SPECULAR_STRENGTH = 0.5f;
+constexpr float LIGHT_SPECULAR_EXPONENT = 32.0f;
+
+// Point lights orbiting the scene, on top of the main light, each reaching up to POINT_LIGHT_RADIUS. They're binned
+// into a LIGHT_CLUSTER_X by LIGHT_CLUSTER_Y by LIGHT_CLUSTER_Z grid of clusters over the view frustum every frame.
+constexpr std::uint32_t POINT_LIGHT_COUNT = 256;
+constexpr float POINT_LIGHT_RADIUS = 3.0f;
+constexpr float POINT_LIGHT_SPREAD = 20.0f;
+constexpr std::uint32_t LIGHT_CLUSTER_X = 16;
+constexpr std::uint32_t LIGHT_CLUSTER_Y = 9;
+constexpr std::uint32_t LIGHT_CLUSTER_Z = 24;
+
+// How much instrumentation is compiled in. Off leaves none of it in the frame. Counters keeps the draw, bind, state
+// change and upload counters of Glitter::Render::RenderStats. Full adds the CPU and GPU profiler scopes, the pipeline
+// statistics queries and the debug draw. Whatever a level leaves out compiles to nothing, see GLITTER_PROFILE_SCOPE()
+// and GLITTER_COUNT(), rather than being skipped at runtime.
+enum class InstrumentationLevel : std::uint8_t {
+    Off,
+    Counters,
+    Full,
+};
+constexpr InstrumentationLevel INSTRUMENTATION_LEVEL = InstrumentationLevel::Full;
+constexpr bool ENABLE_COUNTERS = INSTRUMENTATION_LEVEL >= InstrumentationLevel::Counters;
+constexpr bool ENABLE_PROFILING = INSTRUMENTATION_LEVEL >= InstrumentationLevel::Full;
+
+// Compile in the debug lines, the AABBs and the framebuffer view. Their ring, VAOs and programs are only created the
+// first frame debug lines are enabled, and never when this is off, as below InstrumentationLevel::Full.
+constexpr bool ENABLE_DEBUG_DRAW = ENABLE_PROFILING;
+// Debug line vertices the debug draw ring is initially sized for per frame, it grows past this on demand, and segments
+// of each circle of a debug sphere.
+constexpr size_t DEBUG_DRAW_CAPACITY = 64 * 1024;
+constexpr std::uint32_t DEBUG_SPHERE_SEGMENTS = 24;
+// Threads first drawing debug lines between two frames, their registration waits for the next frame past that.
+constexpr size_t DEBUG_DRAW_MAX_NEW_THREADS = 1024;
+
+// Rebuild the programs whose shaders were modified on disk, in the background, and swap them in once they're linked.
+// Checked every SHADER_HOT_RELOAD_INTERVAL seconds, and disabled while the shaders are read from the asset pack.
+constexpr bool ENABLE_SHADER_HOT_RELOAD = true;
+constexpr double SHADER_HOT_RELOAD_INTERVAL = 0.5;
+
+// Asset pack read instead of the loose files it holds when it exists, relative to the data directory. See the
+// GlitterAssetPack target.
+constexpr const char* ASSET_PACK_PATH = "glitter.pack";
+
+// Log messages queued for the logging thread, which writes them out, so that logging never waits on the console. Past
+// that, the new messages are dropped rather than waited for. See Glitter::Core::InitializeLogging().
+constexpr size_t LOG_QUEUE_SIZE = 8192;
+
+// Each GL debug message, by its source, type and ID, is logged the first GL_DEBUG_MESSAGE_BURST times it's raised, then at
+// most once every GL_DEBUG_MESSAGE_INTERVAL seconds, along with how many times it was raised since. GL_DEBUG_SYNCHRONOUS
+// has the driver raise them from the offending call, to break on them, at the cost of serializing the driver.
+constexpr std::uint64_t GL_DEBUG_MESSAGE_BURST = 4;
+constexpr double GL_DEBUG_MESSAGE_INTERVAL = 1.0;
+constexpr bool GL_DEBUG_SYNCHRONOUS = false;
+
+// Times per second the Dear ImGui windows are rebuilt while the mouse isn't over them, the ones built last being drawn
+// again in between, and the scale of the main pass' color shown by the "Glitter Framebuffers" window.
+constexpr double DEBUG_UI_UPDATE_RATE = 20.0;
+constexpr float FRAMEBUFFER_VIEW_SCALE = 0.25f;
+
+// Log messages forwarded from any thread to the "Glitter Log" window between two frames, the ones past that are dropped,
+// and the messages the window keeps.
+constexpr size_t LOG_FORWARD_QUEUE_CAPACITY = 1024;
+constexpr size_t LOG_WINDOW_HISTORY = 512;
+
+// Seconds between two exports of the telemetry to the StatsD server given by `--telemetry=<host>:<port>`, the frames the
+// exporter's thread can fall behind by, and the prefix of the gauges' names.
+constexpr double TELEMETRY_INTERVAL = 10.0;
+constexpr size_t TELEMETRY_QUEUE_CAPACITY = 1024;
+constexpr const char* TELEMETRY_PREFIX = "glitter";
+
+// Frames written into a CPU trace capture.
+constexpr size_t CPU_TRACE_FRAMES = 120;
+
+// Draw batches the batch cost sampler times per frame, when enabled in the "Performance" header, moving on to the next
+// ones every frame, and the rows of its tables of the costliest Meshes and materials.
+constexpr size_t BATCH_COST_SAMPLED_BATCHES = 8;
+constexpr size_t BATCH_COST_TABLE_ROWS = 10;
+
+// Counts the allocations made through the global operator new, per frame in the "Performance" header and per CPU
+// profiler scope in the "Glitter Profiler" window. The `--benchmark` mode then fails when a frame past the warmup
+// allocates. Costs two atomic increments per allocation.
+constexpr bool ENABLE_ALLOCATION_TRACKING = false;
+
+// Frames shown in the frame time graph and used for the stutter detector's median.
+constexpr size_t FRAME_HISTORY_SIZE = 240;
+// A frame taking this many times the median frame time is flagged as a stutter.
+constexpr float STUTTER_FACTOR = 2.0f;
+// Whether the frame after each stutter is captured with RenderDoc, when the application runs under it, and the stutters
+// captured at most per run, so that a burst of them doesn't fill the disk. F11 captures the next frame whatever these are.
+constexpr bool ENABLE_RENDERDOC_STUTTER_CAPTURE = true;
+constexpr std::uint32_t RENDERDOC_MAX_STUTTER_CAPTURES = 4;
+
+// A GL trace, see `--gl-trace=`, finds the objects alive when its frame starts by their names, looking this many names
+// past the last one found of each type. The names the drivers give are small and reused, so the gaps stay short.
+constexpr std::uint32_t GL_TRACE_NAME_GAP = 1024;
+
+// Defaults of the `--benchmark` mode, the frame and Node counts can be overriden on the command line.
+constexpr unsigned int BENCHMARK_SEED = 1337;
+constexpr size_t BENCHMARK_NODE_COUNT = 20'000;
+constexpr size_t BENCHMARK_FRAME_COUNT = 1'000;
+// Frames rendered before sampling starts, so that the GPU queries and caches have settled.
+constexpr size_t BENCHMARK_WARMUP_FRAMES = 60;
+// Animation time per benchmark frame, so that every run follows the same camera path whatever the frame rate.
+constexpr double BENCHMARK_TIME_STEP = 1.0 / 60.0;
 
 } // namespace Glitter::Config
@@ -0,0 +1,137 @@
+#include "core/AllocationTracker.h"
+
+#include "Config.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace Glitter::Core {
+
+namespace {
+    std::atomic<std::uint64_t> s_allocations {};
+    std::atomic<std::uint64_t> s_bytes {};
+    // Trivially constructible, so that it's safe to touch from the very first allocation of each thread.
+    thread_local AllocationCounts t_counts {};
+
+    void CountAllocation(std::size_t size)
+    {
+        if constexpr (Glitter::Config::ENABLE_ALLOCATION_TRACKING) {
+            t_counts.m_allocations++;
+            t_counts.m_bytes += size;
+            s_allocations.fetch_add(1, std::memory_order_relaxed);
+            s_bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+    }
+
+    void* Allocate(std::size_t size, std::align_val_t alignment, bool nothrow)
+    {
+        CountAllocation(size);
+        // malloc() doesn't accept 0, and aligned_alloc() needs a size multiple of the alignment.
+        size = size == 0 ? 1 : size;
+        auto align = static_cast<std::size_t>(alignment);
+        while (true) {
+            void* memory = nullptr;
+            if (align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                memory = std::malloc(size);
+            } else {
+#ifdef _WIN32
+                memory = _aligned_malloc(size, align);
+#else
+                memory = std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+            }
+            if (memory) {
+                return memory;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) {
+                if (nothrow) {
+                    return nullptr;
+                }
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    void Deallocate(void* memory, std::align_val_t alignment)
+    {
+#ifdef _WIN32
+        if (static_cast<std::size_t>(alignment) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            _aligned_free(memory);
+            return;
+        }
+#else
+        (void)alignment;
+#endif
+        std::free(memory);
+    }
+
+    constexpr auto DEFAULT_ALIGNMENT = static_cast<std::align_val_t>(__STDCPP_DEFAULT_NEW_ALIGNMENT__);
+} // namespace
+
+AllocationCounts GetThreadAllocations() { return t_counts; }
+
+AllocationCounts GetTotalAllocations()
+{
+    return {.m_allocations = s_allocations.load(std::memory_order_relaxed), .m_bytes = s_bytes.load(std::memory_order_relaxed)};
+}
+
+} // namespace Glitter::Core
+
+// The replaceable global allocation functions, every form of them, so that none bypasses the count.
+void* operator new(std::size_t size) { return Glitter::Core::Allocate(size, Glitter::Core::DEFAULT_ALIGNMENT, false); }
+void* operator new[](std::size_t size) { return Glitter::Core::Allocate(size, Glitter::Core::DEFAULT_ALIGNMENT, false); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return Glitter::Core::Allocate(size, Glitter::Core::DEFAULT_ALIGNMENT, true);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return Glitter::Core::Allocate(size, Glitter::Core::DEFAULT_ALIGNMENT, true);
+}
+void* operator new(std::size_t size, std::align_val_t alignment) { return Glitter::Core::Allocate(size, alignment, false); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return Glitter::Core::Allocate(size, alignment, false); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return Glitter::Core::Allocate(size, alignment, true);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return Glitter::Core::Allocate(size, alignment, true);
+}
+
+void operator delete(void* memory) noexcept { Glitter::Core::Deallocate(memory, Glitter::Core::DEFAULT_ALIGNMENT); }
+void operator delete[](void* memory) noexcept { Glitter::Core::Deallocate(memory, Glitter::Core::DEFAULT_ALIGNMENT); }
+void operator delete(void* memory, std::size_t) noexcept { Glitter::Core::Deallocate(memory, Glitter::Core::DEFAULT_ALIGNMENT); }
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    Glitter::Core::Deallocate(memory, Glitter::Core::DEFAULT_ALIGNMENT);
+}
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    Glitter::Core::Deallocate(memory, Glitter::Core::DEFAULT_ALIGNMENT);
+}
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    Glitter::Core::Deallocate(memory, Glitter::Core::DEFAULT_ALIGNMENT);
+}
+void operator delete(void* memory, std::align_val_t alignment) noexcept { Glitter::Core::Deallocate(memory, alignment); }
+void operator delete[](void* memory, std::align_val_t alignment) noexcept { Glitter::Core::Deallocate(memory, alignment); }
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept
+{
+    Glitter::Core::Deallocate(memory, alignment);
+}
+void operator delete[](void* memory, std::size_t, std::align_val_t alignment) noexcept
+{
+    Glitter::Core::Deallocate(memory, alignment);
+}
+void operator delete(void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    Glitter::Core::Deallocate(memory, alignment);
+}
+void operator delete[](void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    Glitter::Core::Deallocate(memory, alignment);
+}
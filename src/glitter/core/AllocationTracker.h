@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Glitter::Core {
+
+// Allocations made through the global operator new, and the bytes they requested.
+struct AllocationCounts {
+    std::uint64_t m_allocations;
+    std::uint64_t m_bytes;
+
+    AllocationCounts operator-(const AllocationCounts& other) const
+    {
+        return {.m_allocations = m_allocations - other.m_allocations, .m_bytes = m_bytes - other.m_bytes};
+    }
+};
+
+// The replacements of the global operator new count every allocation when Glitter::Config::ENABLE_ALLOCATION_TRACKING
+// is set, and both of these stay 0 otherwise. Deallocations aren't counted, a frame that frees what it allocates still
+// pays for both.
+
+// The allocations made by the calling thread so far, without any synchronization.
+AllocationCounts GetThreadAllocations();
+// The allocations made by every thread so far.
+AllocationCounts GetTotalAllocations();
+
+} // namespace Glitter::Core
@@ -0,0 +1,149 @@
+#include "core/Benchmark.h"
+
+#include "Config.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <fstream>
+#include <numeric>
+
+namespace Glitter::Core {
+
+namespace {
+    // Parses the value of `--<name>=<value>` into `value`, keeping it when the argument doesn't match or is malformed.
+    void ParseCount(std::string_view argument, std::string_view prefix, size_t& value)
+    {
+        if (!argument.starts_with(prefix)) {
+            return;
+        }
+
+        std::string_view text = argument.substr(prefix.size());
+        size_t parsed = 0;
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), parsed);
+        if (error != std::errc {} || end != text.data() + text.size()) {
+            spdlog::warn("Ignoring malformed argument {}.", argument);
+            return;
+        }
+        value = parsed;
+    }
+
+    // `samples` must be sorted.
+    double Percentile(std::span<const double> samples, double percentile)
+    {
+        auto rank = static_cast<size_t>(percentile / 100.0 * static_cast<double>(samples.size() - 1) + 0.5);
+        return samples[std::min(rank, samples.size() - 1)];
+    }
+    // Indexed by BenchmarkIsolation.
+    constexpr std::array<std::string_view, 5> ISOLATION_NAMES {"none", "no-submit", "null-draws", "tiny-viewport", "stub-shaders"};
+} // namespace
+
+std::string_view GetBenchmarkIsolationName(BenchmarkIsolation isolation)
+{
+    return ISOLATION_NAMES[static_cast<size_t>(isolation)];
+}
+
+BenchmarkOptions ParseBenchmarkOptions(std::span<const char* const> arguments)
+{
+    BenchmarkOptions options {.m_enabled = false,
+        .m_headless = false,
+        .m_nodeCount = Glitter::Config::BENCHMARK_NODE_COUNT,
+        .m_frameCount = Glitter::Config::BENCHMARK_FRAME_COUNT,
+        .m_outputPath = "glitter_benchmark.csv",
+        .m_scenePath = {},
+        .m_cameraPath = {},
+        .m_capturePath = {},
+        .m_captureFormat = FrameOutputFormat::Png,
+        .m_capturePipe = {},
+        .m_startupReportPath = {},
+        .m_telemetryAddress = {},
+        .m_isolation = BenchmarkIsolation::None,
+        .m_glTracePath = {},
+        .m_servePath = {}};
+
+    for (std::string_view argument : arguments) {
+        constexpr std::string_view OUTPUT_PREFIX = "--benchmark-output=";
+        constexpr std::string_view SCENE_PREFIX = "--benchmark-scene=";
+        constexpr std::string_view CAMERA_PREFIX = "--benchmark-camera=";
+        constexpr std::string_view CAPTURE_PREFIX = "--capture=";
+        constexpr std::string_view CAPTURE_PIPE_PREFIX = "--capture-pipe=";
+        constexpr std::string_view STARTUP_REPORT_PREFIX = "--startup-report=";
+        constexpr std::string_view TELEMETRY_PREFIX = "--telemetry=";
+        constexpr std::string_view ISOLATE_PREFIX = "--benchmark-isolate=";
+        constexpr std::string_view GL_TRACE_PREFIX = "--gl-trace=";
+        constexpr std::string_view SERVE_PREFIX = "--serve=";
+        if (argument == "--benchmark") {
+            options.m_enabled = true;
+        } else if (argument == "--headless") {
+            options.m_headless = true;
+        } else if (argument.starts_with(OUTPUT_PREFIX)) {
+            options.m_outputPath = argument.substr(OUTPUT_PREFIX.size());
+        } else if (argument.starts_with(SCENE_PREFIX)) {
+            options.m_scenePath = argument.substr(SCENE_PREFIX.size());
+        } else if (argument.starts_with(CAMERA_PREFIX)) {
+            options.m_cameraPath = argument.substr(CAMERA_PREFIX.size());
+        } else if (argument.starts_with(CAPTURE_PREFIX)) {
+            options.m_capturePath = argument.substr(CAPTURE_PREFIX.size());
+        } else if (argument.starts_with(CAPTURE_PIPE_PREFIX)) {
+            options.m_capturePipe = argument.substr(CAPTURE_PIPE_PREFIX.size());
+        } else if (argument == "--startup-report") {
+            options.m_startupReportPath = "glitter_startup.json";
+        } else if (argument.starts_with(STARTUP_REPORT_PREFIX)) {
+            options.m_startupReportPath = argument.substr(STARTUP_REPORT_PREFIX.size());
+        } else if (argument.starts_with(TELEMETRY_PREFIX)) {
+            options.m_telemetryAddress = argument.substr(TELEMETRY_PREFIX.size());
+        } else if (argument.starts_with(GL_TRACE_PREFIX)) {
+            options.m_glTracePath = argument.substr(GL_TRACE_PREFIX.size());
+        } else if (argument.starts_with(SERVE_PREFIX)) {
+            options.m_servePath = argument.substr(SERVE_PREFIX.size());
+            options.m_headless = true;
+        } else if (argument.starts_with(ISOLATE_PREFIX)) {
+            auto it = std::ranges::find(ISOLATION_NAMES, argument.substr(ISOLATE_PREFIX.size()));
+            if (it != ISOLATION_NAMES.end()) {
+                options.m_isolation = static_cast<BenchmarkIsolation>(it - ISOLATION_NAMES.begin());
+            } else {
+                spdlog::warn("Ignoring malformed argument {}.", argument);
+            }
+        } else if (argument == "--capture-format=ppm") {
+            options.m_captureFormat = FrameOutputFormat::Ppm;
+        } else if (argument == "--capture-format=png") {
+            options.m_captureFormat = FrameOutputFormat::Png;
+        } else {
+            ParseCount(argument, "--benchmark-nodes=", options.m_nodeCount);
+            ParseCount(argument, "--benchmark-frames=", options.m_frameCount);
+        }
+    }
+
+    return options;
+}
+
+void BenchmarkRecorder::AddSample(std::string_view metric, double value)
+{
+    auto it = std::ranges::find_if(m_metrics, [&](const auto& entry) { return entry.first == metric; });
+    if (it == m_metrics.end()) {
+        it = m_metrics.emplace(m_metrics.end(), std::string(metric), std::vector<double> {});
+    }
+    it->second.push_back(value);
+}
+
+bool BenchmarkRecorder::WriteCsv(const std::filesystem::path& path) const
+{
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    file << "metric,samples,mean,p50,p95,p99\n";
+    for (const auto& [metric, samples] : m_metrics) {
+        std::vector<double> sorted = samples;
+        std::ranges::sort(sorted);
+
+        double mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size());
+        file << metric << ',' << sorted.size() << ',' << mean << ',' << Percentile(sorted, 50.0) << ','
+             << Percentile(sorted, 95.0) << ',' << Percentile(sorted, 99.0) << '\n';
+    }
+
+    return static_cast<bool>(file);
+}
+
+} // namespace Glitter::Core
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "core/FrameOutput.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Glitter::Core {
+
+// Removes the cost of one stage of the frame, so that comparing a run's timings against a run without tells whether it's
+// the stage limiting the frame rate.
+enum class BenchmarkIsolation : std::uint8_t {
+    None,
+    // Builds and uploads every frame's draws, but runs none of its passes: the CPU's cost alone.
+    NoSubmit,
+    // Submits every draw of the Nodes with no elements, keeping the API and driver cost without the vertex work.
+    NullDraws,
+    // Renders the scene into a single pixel, leaving the fragment cost out.
+    TinyViewport,
+    // Shades every Node with a constant color, leaving the lighting and texturing out.
+    StubShaders,
+};
+
+// The name `--benchmark-isolate=` takes it by.
+std::string_view GetBenchmarkIsolationName(BenchmarkIsolation isolation);
+
+// Parsed from the command line, see ParseBenchmarkOptions().
+struct BenchmarkOptions {
+    bool m_enabled;
+    // Renders without a display or Dear ImGui, from a surfaceless EGL context, then quits after m_frameCount frames.
+    bool m_headless;
+    size_t m_nodeCount;
+    size_t m_frameCount;
+    std::filesystem::path m_outputPath;
+    // The scene snapshot loaded instead of spawning m_nodeCount Nodes, if any.
+    std::filesystem::path m_scenePath;
+    // The camera recording played back instead of following the camera path, if any. Its frames are the benchmark's.
+    std::filesystem::path m_cameraPath;
+    // The directory every rendered frame is read back and written into as m_captureFormat images, if any.
+    std::filesystem::path m_capturePath;
+    FrameOutputFormat m_captureFormat;
+    // The command every rendered frame is piped to instead, if any.
+    std::string m_capturePipe;
+    // The Chrome trace the startup phases are written into once the first frame is about to start, if any.
+    std::filesystem::path m_startupReportPath;
+    // The `<host>:<port>` of the StatsD server the telemetry is exported to, if any, see TelemetryExporter.
+    std::string m_telemetryAddress;
+    BenchmarkIsolation m_isolation;
+    // The GL trace F10 records a frame into, if any, see Render::GLTraceRecorder. The benchmark records the first frame
+    // past its warmup.
+    std::filesystem::path m_glTracePath;
+    // The manifest of the scenes rendered round-robin by a single headless process, each into its own target, sharing its
+    // programs, Meshes and textures, if any, see ReadServeManifest(). Implies m_headless.
+    std::filesystem::path m_servePath;
+};
+
+// Parses `--benchmark`, `--headless`, `--benchmark-nodes=<count>`, `--benchmark-frames=<count>`,
+// `--benchmark-output=<path>`, `--benchmark-scene=<path>`, `--benchmark-camera=<path>`, `--capture=<directory>`,
+// `--capture-format=<ppm|png>`, `--capture-pipe=<command>`, `--startup-report[=<path>]`, `--telemetry=<host>:<port>`,
+// `--benchmark-isolate=<no-submit|null-draws|tiny-viewport|stub-shaders>`, `--gl-trace=<path>` and `--serve=<manifest>`,
+// defaulting to the Glitter::Config benchmark settings. Unknown arguments are ignored.
+BenchmarkOptions ParseBenchmarkOptions(std::span<const char* const> arguments);
+
+// Collects one sample per metric and frame, in milliseconds for timings, and writes their percentiles as CSV.
+class BenchmarkRecorder {
+public:
+    void AddSample(std::string_view metric, double value);
+
+    // Writes a `metric,samples,mean,p50,p95,p99` row per metric, in the order they were first sampled.
+    bool WriteCsv(const std::filesystem::path& path) const;
+
+private:
+    std::vector<std::pair<std::string, std::vector<double>>> m_metrics;
+};
+
+} // namespace Glitter::Core
@@ -0,0 +1,100 @@
+#include "core/CameraRecording.h"
+
+#include "util/File.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Glitter::Core {
+
+namespace {
+
+    // Bump whenever the layout below, CameraFrame or CameraEvent change.
+    constexpr std::uint32_t RECORDING_VERSION = 1;
+    constexpr std::array<char, 4> RECORDING_MAGIC {'G', 'L', 'C', 'R'};
+
+    // Followed by every CameraFrame, then every CameraEvent.
+    struct RecordingHeader {
+        std::array<char, 4> m_magic;
+        std::uint32_t m_version;
+        double m_startTime;
+        std::uint32_t m_seed;
+        std::uint32_t m_frameCount;
+        std::uint32_t m_eventCount;
+        std::uint32_t m_padding;
+    };
+
+} // namespace
+
+std::span<const CameraEvent> CameraRecording::GetEvents(size_t frame) const
+{
+    auto [first, last] = std::ranges::equal_range(m_events, frame, {}, [](const CameraEvent& event) {
+        return static_cast<size_t>(event.m_frame);
+    });
+    return {first, last};
+}
+
+bool WriteCameraRecording(const char* recordingPath, const CameraRecording& recording)
+{
+    RecordingHeader header {.m_magic = RECORDING_MAGIC,
+        .m_version = RECORDING_VERSION,
+        .m_startTime = recording.m_startTime,
+        .m_seed = recording.m_seed,
+        .m_frameCount = static_cast<std::uint32_t>(recording.m_frames.size()),
+        .m_eventCount = static_cast<std::uint32_t>(recording.m_events.size()),
+        .m_padding = 0};
+
+    std::error_code error {};
+    std::filesystem::create_directories(std::filesystem::path(recordingPath).parent_path(), error);
+    std::ofstream outputStream(recordingPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    outputStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    outputStream.write(reinterpret_cast<const char*>(recording.m_frames.data()),
+        static_cast<std::streamsize>(sizeof(CameraFrame) * recording.m_frames.size()));
+    outputStream.write(reinterpret_cast<const char*>(recording.m_events.data()),
+        static_cast<std::streamsize>(sizeof(CameraEvent) * recording.m_events.size()));
+    return static_cast<bool>(outputStream);
+}
+
+std::optional<CameraRecording> ReadCameraRecording(const char* recordingPath)
+{
+    std::optional<std::vector<std::byte>> contents = Util::ReadBinaryFile(recordingPath);
+    if (!contents) {
+        spdlog::error("Failed to read the camera recording {}.", recordingPath);
+        return std::nullopt;
+    }
+
+    RecordingHeader header {};
+    if (contents->size() < sizeof(header)) {
+        spdlog::error("The camera recording {} is truncated.", recordingPath);
+        return std::nullopt;
+    }
+    std::memcpy(&header, contents->data(), sizeof(header));
+    if (header.m_magic != RECORDING_MAGIC || header.m_version != RECORDING_VERSION) {
+        spdlog::error("The camera recording {} is from another format version, or isn't a recording.", recordingPath);
+        return std::nullopt;
+    }
+
+    size_t framesSize = sizeof(CameraFrame) * header.m_frameCount;
+    size_t eventsSize = sizeof(CameraEvent) * header.m_eventCount;
+    if (contents->size() - sizeof(header) < framesSize + eventsSize) {
+        spdlog::error("The camera recording {} is truncated.", recordingPath);
+        return std::nullopt;
+    }
+
+    CameraRecording recording {.m_startTime = header.m_startTime,
+        .m_seed = header.m_seed,
+        .m_frames = std::vector<CameraFrame>(header.m_frameCount),
+        .m_events = std::vector<CameraEvent>(header.m_eventCount)};
+    if (framesSize > 0) {
+        std::memcpy(recording.m_frames.data(), contents->data() + sizeof(header), framesSize);
+    }
+    if (eventsSize > 0) {
+        std::memcpy(recording.m_events.data(), contents->data() + sizeof(header) + framesSize, eventsSize);
+    }
+    return recording;
+}
+
+} // namespace Glitter::Core
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Glitter::Core {
+
+// The view a frame is drawn from, and the time its simulation was advanced by.
+struct CameraFrame {
+    double m_frameTime;
+    glm::vec3 m_eyePos;
+    glm::vec3 m_eyeTarget;
+};
+
+// A key event sampled before the m_frame-th frame of a recording.
+struct CameraEvent {
+    std::uint32_t m_frame;
+    std::int32_t m_key;
+    std::int32_t m_action;
+};
+
+// A camera path recorded frame by frame along with the key events in between, played back with the same time steps so
+// that every run draws exactly the same views. The simulation starts from m_startTime and the RNG from m_seed, so that
+// the replayed events spawn the same Nodes too.
+struct CameraRecording {
+    double m_startTime;
+    std::uint32_t m_seed;
+    std::vector<CameraFrame> m_frames;
+    // Sorted by frame.
+    std::vector<CameraEvent> m_events;
+
+    // The events sampled before frame `frame`.
+    std::span<const CameraEvent> GetEvents(size_t frame) const;
+};
+
+// Returns false if the recording can't be written.
+bool WriteCameraRecording(const char* recordingPath, const CameraRecording& recording);
+// Returns std::nullopt, after logging why, if the file is missing, from another format version or truncated.
+std::optional<CameraRecording> ReadCameraRecording(const char* recordingPath);
+
+} // namespace Glitter::Core
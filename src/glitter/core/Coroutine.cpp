@@ -0,0 +1,43 @@
+#include "core/Coroutine.h"
+
+namespace Glitter::Core {
+
+void TaskPromiseBase::Finish()
+{
+    // Notified under the lock, the waiting thread may destroy the coroutine as soon as it's released.
+    CoroutineScheduler& scheduler = *m_scheduler;
+    std::scoped_lock lock(scheduler.m_mutex);
+    m_finished = true;
+    scheduler.m_mainCondition.notify_all();
+}
+
+CoroutineScheduler::~CoroutineScheduler() { m_jobSystem.Wait(m_jobs); }
+
+void CoroutineScheduler::Post(std::coroutine_handle<> handle)
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_mainQueue.push_back(handle);
+    }
+    m_mainCondition.notify_all();
+}
+
+void CoroutineScheduler::RunUntilFinished(TaskPromiseBase& promise)
+{
+    while (true) {
+        std::coroutine_handle<> next {};
+        {
+            std::unique_lock lock(m_mutex);
+            m_mainCondition.wait(lock, [&] { return promise.m_finished || !m_mainQueue.empty(); });
+            // The ones already waiting for the main thread run first, whether it's done or not.
+            if (m_mainQueue.empty()) {
+                return;
+            }
+            next = m_mainQueue.front();
+            m_mainQueue.pop_front();
+        }
+        next.resume();
+    }
+}
+
+} // namespace Glitter::Core
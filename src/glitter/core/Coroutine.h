@@ -0,0 +1,254 @@
+#pragma once
+
+#include "core/JobSystem.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Glitter::Core {
+
+class CoroutineScheduler;
+
+// What every Task's promise holds, whatever its result: who to resume once the coroutine is done.
+struct TaskPromiseBase {
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template <typename Promise> std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            TaskPromiseBase& promise = handle.promise();
+            if (promise.m_remaining && promise.m_remaining->fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return std::noop_coroutine();
+            }
+            if (promise.m_continuation) {
+                return promise.m_continuation;
+            }
+            if (promise.m_scheduler) {
+                promise.Finish();
+            }
+            return std::noop_coroutine();
+        }
+        void await_resume() noexcept { }
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    // Errors are results, like everywhere else.
+    void unhandled_exception() noexcept { std::terminate(); }
+
+    // Tells the scheduler waiting for it that it's done, see CoroutineScheduler::Wait().
+    void Finish();
+
+    // The coroutine awaiting this one.
+    std::coroutine_handle<> m_continuation;
+    // Set by WhenAll(): m_continuation is resumed by whichever of its tasks is done last.
+    std::atomic<size_t>* m_remaining {};
+    // Set by CoroutineScheduler::Start(), and m_finished guarded by its mutex.
+    CoroutineScheduler* m_scheduler {};
+    bool m_finished {};
+};
+
+template <typename T> struct TaskPromise : TaskPromiseBase {
+    template <typename U> void return_value(U&& value) { m_value.emplace(std::forward<U>(value)); }
+    T TakeResult() { return std::move(*m_value); }
+
+    std::optional<T> m_value;
+};
+
+template <> struct TaskPromise<void> : TaskPromiseBase {
+    void return_void() { }
+    void TakeResult() { }
+};
+
+// A coroutine returning a T, only started once awaited, or by CoroutineScheduler::Start() or Wait(). Awaiting it resumes
+// the awaiting coroutine with its result, on the thread it's done on. Which thread each part of it runs on is up to the
+// CoroutineScheduler awaitables it awaits in turn, e.g.
+//
+//     Task<DecodedTexture> LoadTexture(CoroutineScheduler& scheduler, const char* path)
+//     {
+//         co_await scheduler.ResumeOnWorker();
+//         DecodedTexture texture = Decode(path);
+//         co_await scheduler.ResumeOnMain();
+//         Upload(texture);
+//         co_return texture;
+//     }
+//
+// The coroutine only starts running once awaited, so its parameters are taken by value, not by reference.
+template <typename T = void> class [[nodiscard]] Task {
+public:
+    struct promise_type : TaskPromise<T> {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+    };
+
+    Task() = default;
+    Task(Task&& other) noexcept
+        : m_handle(std::exchange(other.m_handle, nullptr))
+    {
+    }
+    Task& operator=(Task&& other) noexcept
+    {
+        std::swap(m_handle, other.m_handle);
+        return *this;
+    }
+    ~Task()
+    {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    auto operator co_await() noexcept
+    {
+        struct Awaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                m_handle.promise().m_continuation = awaiting;
+                return m_handle;
+            }
+            T await_resume() { return m_handle.promise().TakeResult(); }
+
+            std::coroutine_handle<promise_type> m_handle;
+        };
+        return Awaiter {m_handle};
+    }
+
+private:
+    friend class CoroutineScheduler;
+    template <typename U> friend auto WhenAll(std::span<Task<U>> tasks);
+
+    explicit Task(std::coroutine_handle<promise_type> handle)
+        : m_handle(handle)
+    {
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+// Awaits every one of `tasks` at once, each started in turn on the awaiting thread until it first suspends, and resumes
+// the awaiting coroutine with their results, in order, once the last one is done. Tasks resuming on the workers first
+// thus run in parallel.
+template <typename T> auto WhenAll(std::span<Task<T>> tasks)
+{
+    struct Awaiter {
+        bool await_ready() noexcept { return m_tasks.empty(); }
+        bool await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            // One more than the tasks, so that none of them resumes the awaiting coroutine before they're all started.
+            m_remaining.store(m_tasks.size() + 1, std::memory_order_relaxed);
+            for (Task<T>& task : m_tasks) {
+                task.m_handle.promise().m_continuation = awaiting;
+                task.m_handle.promise().m_remaining = &m_remaining;
+                task.m_handle.resume();
+            }
+            return m_remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+        }
+        auto await_resume()
+        {
+            if constexpr (!std::is_void_v<T>) {
+                std::vector<T> results {};
+                results.reserve(m_tasks.size());
+                for (Task<T>& task : m_tasks) {
+                    results.push_back(task.m_handle.promise().TakeResult());
+                }
+                return results;
+            }
+        }
+
+        std::span<Task<T>> m_tasks;
+        std::atomic<size_t> m_remaining {};
+    };
+    return Awaiter {tasks};
+}
+
+// Moves coroutines between the threads: the workers of a JobSystem, and the main thread, the only one the GL context is
+// current on, which runs its share of them while it waits for a Task. Loading asset after asset is then written as a
+// coroutine awaiting its files read and decoded on the workers, then resuming on the main thread for its GL objects.
+// The file reads are made on the workers too, they're mostly page faults of mapped files.
+class CoroutineScheduler {
+public:
+    explicit CoroutineScheduler(JobSystem& jobSystem)
+        : m_jobSystem(jobSystem)
+    {
+    }
+    // Waits for the coroutines resumed on the workers.
+    ~CoroutineScheduler();
+
+    CoroutineScheduler(const CoroutineScheduler&) = delete;
+    CoroutineScheduler& operator=(const CoroutineScheduler&) = delete;
+
+    // Awaiting it continues the coroutine as a background job of the JobSystem.
+    auto ResumeOnWorker() noexcept
+    {
+        struct Awaiter {
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                m_scheduler.m_jobSystem.Submit([handle] { handle.resume(); }, m_scheduler.m_jobs, JobPriority::Background);
+            }
+            void await_resume() noexcept { }
+
+            CoroutineScheduler& m_scheduler;
+        };
+        return Awaiter {*this};
+    }
+
+    // Awaiting it continues the coroutine on the main thread, the next time it runs the coroutines in Wait().
+    auto ResumeOnMain() noexcept
+    {
+        struct Awaiter {
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { m_scheduler.Post(handle); }
+            void await_resume() noexcept { }
+
+            CoroutineScheduler& m_scheduler;
+        };
+        return Awaiter {*this};
+    }
+
+    // Runs `task` on the calling thread until it first suspends, so that it's under way before it's waited for.
+    template <typename T> void Start(Task<T>& task)
+    {
+        task.m_handle.promise().m_scheduler = this;
+        task.m_handle.resume();
+    }
+
+    // Starts `task` unless it was already, then runs the coroutines resumed on the main thread until it's done, and
+    // returns its result. Only called from the main thread.
+    template <typename T> T Wait(Task<T>& task)
+    {
+        if (!task.m_handle.promise().m_scheduler) {
+            Start(task);
+        }
+        RunUntilFinished(task.m_handle.promise());
+        return task.m_handle.promise().TakeResult();
+    }
+
+private:
+    friend struct TaskPromiseBase;
+
+    void Post(std::coroutine_handle<> handle);
+    void RunUntilFinished(TaskPromiseBase& promise);
+
+    JobSystem& m_jobSystem;
+    JobCounter m_jobs {};
+
+    std::mutex m_mutex;
+    std::condition_variable m_mainCondition;
+    // The coroutines to resume on the main thread.
+    std::deque<std::coroutine_handle<>> m_mainQueue;
+};
+
+} // namespace Glitter::Core
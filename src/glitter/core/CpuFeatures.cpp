@@ -0,0 +1,98 @@
+#include "core/CpuFeatures.h"
+
+#include "Config.h"
+
+#include <array>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace Glitter::Core {
+
+namespace {
+
+    CpuFeatures DetectCpuFeatures()
+    {
+        CpuFeatures features {};
+#if defined(_MSC_VER) && defined(_M_X64)
+        std::array<int, 4> registers {};
+        __cpuid(registers.data(), 0);
+        int maxLeaf = registers[0];
+        __cpuid(registers.data(), 1);
+        features.m_sse2 = (registers[3] & (1 << 26)) != 0;
+        features.m_sse42 = (registers[2] & (1 << 20)) != 0;
+        bool avx = (registers[2] & (1 << 28)) != 0;
+
+        // The OS must save the YMM registers, and the ZMM and mask registers, when switching threads.
+        unsigned long long enabledState = (registers[2] & (1 << 27)) != 0 ? _xgetbv(0) : 0;
+        bool ymmSaved = (enabledState & 0x06) == 0x06;
+        bool zmmSaved = (enabledState & 0xE6) == 0xE6;
+        if (maxLeaf >= 7) {
+            __cpuidex(registers.data(), 7, 0);
+            features.m_avx2 = avx && ymmSaved && (registers[1] & (1 << 5)) != 0;
+            features.m_avx512f = features.m_avx2 && zmmSaved && (registers[1] & (1 << 16)) != 0;
+        }
+#elif defined(GLITTER_SIMD_X86)
+        // Checks that the OS saves the registers too.
+        __builtin_cpu_init();
+        features.m_sse2 = __builtin_cpu_supports("sse2");
+        features.m_sse42 = __builtin_cpu_supports("sse4.2");
+        features.m_avx2 = __builtin_cpu_supports("avx2");
+        features.m_avx512f = features.m_avx2 && __builtin_cpu_supports("avx512f");
+#elif defined(__ARM_NEON)
+        features.m_neon = true;
+#endif
+        return features;
+    }
+
+} // namespace
+
+const CpuFeatures& GetCpuFeatures()
+{
+    static const CpuFeatures features = DetectCpuFeatures();
+    return features;
+}
+
+SimdLevel GetSimdLevel()
+{
+    const CpuFeatures& features = GetCpuFeatures();
+    if (features.m_avx512f && Config::ENABLE_AVX512) {
+        return SimdLevel::Avx512;
+    }
+    if (features.m_avx2) {
+        return SimdLevel::Avx2;
+    }
+    if (features.m_sse42) {
+        return SimdLevel::Sse42;
+    }
+    if (features.m_sse2) {
+        return SimdLevel::Sse2;
+    }
+    if (features.m_neon) {
+        return SimdLevel::Neon;
+    }
+    return SimdLevel::Scalar;
+}
+
+const char* GetSimdLevelName(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::Scalar:
+        return "Scalar";
+    case SimdLevel::Sse2:
+        return "SSE2";
+    case SimdLevel::Sse42:
+        return "SSE4.2";
+    case SimdLevel::Avx2:
+        return "AVX2";
+    case SimdLevel::Avx512:
+        return "AVX-512";
+    case SimdLevel::Neon:
+        return "NEON";
+    }
+    return "Unknown";
+}
+
+} // namespace Glitter::Core
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+// On x86, the kernels past SSE2 are compiled for their instruction set alone, whatever the target, and are only called
+// once GetSimdLevel() found the CPU has it. MSVC compiles any intrinsic without it.
+#if defined(__SSE2__) || defined(_M_X64)
+#define GLITTER_SIMD_X86 1
+#if defined(__GNUC__) || defined(__clang__)
+#define GLITTER_TARGET_AVX2 __attribute__((target("avx2")))
+#define GLITTER_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define GLITTER_TARGET_AVX2
+#define GLITTER_TARGET_AVX512
+#endif
+#endif
+
+namespace Glitter::Core {
+
+// The instruction sets the SIMD kernels are written for, from the narrowest.
+enum class SimdLevel : std::uint8_t {
+    Scalar,
+    Sse2,
+    Sse42,
+    Avx2,
+    Avx512,
+    Neon,
+};
+
+// What the CPU runs, and the OS saves the registers of.
+struct CpuFeatures {
+    bool m_sse2 {};
+    bool m_sse42 {};
+    bool m_avx2 {};
+    bool m_avx512f {};
+    bool m_neon {};
+};
+
+// Detected on the first call, thread-safe.
+const CpuFeatures& GetCpuFeatures();
+// The widest instruction set of the CPU, AVX-512 only with Config::ENABLE_AVX512. Each kernel binds the widest version
+// it has up to this one on its first call, see Glitter::Render::GetCullSimdLevel().
+SimdLevel GetSimdLevel();
+const char* GetSimdLevelName(SimdLevel level);
+
+} // namespace Glitter::Core
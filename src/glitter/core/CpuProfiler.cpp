@@ -0,0 +1,163 @@
+#include "core/CpuProfiler.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace Glitter::Core {
+
+namespace {
+    // Events a thread can record between two CollectFrame() calls before the oldest ones are dropped.
+    constexpr size_t THREAD_EVENT_CAPACITY = 1 << 14;
+
+    // Written by its thread only, and read by CollectFrame() up to m_written.
+    struct ThreadBuffer {
+        std::string m_name;
+        std::array<ProfileEvent, THREAD_EVENT_CAPACITY> m_events;
+        std::atomic<std::uint64_t> m_written {};
+        std::uint32_t m_depth {};
+
+        // Only touched by the collecting thread.
+        std::uint64_t m_read {};
+    };
+
+    // Threads only lock it once, when they record their first event.
+    std::mutex s_threadsMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> s_threads;
+
+    thread_local ThreadBuffer* t_buffer = nullptr;
+
+    ThreadBuffer& GetThreadBuffer()
+    {
+        if (!t_buffer) {
+            std::scoped_lock lock(s_threadsMutex);
+            auto& buffer = s_threads.emplace_back(std::make_unique<ThreadBuffer>());
+            buffer->m_name = "Thread " + std::to_string(s_threads.size() - 1);
+            t_buffer = buffer.get();
+        }
+        return *t_buffer;
+    }
+
+    std::uint64_t Now()
+    {
+        static const auto epoch = std::chrono::steady_clock::now();
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+    }
+} // namespace
+
+void ProfileScope::Begin(const char* name)
+{
+    m_name = name;
+    m_begin = Now();
+    m_allocationsBegin = GetThreadAllocations();
+    GetThreadBuffer().m_depth++;
+}
+
+void ProfileScope::End()
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+    buffer.m_depth--;
+
+    std::uint64_t written = buffer.m_written.load(std::memory_order_relaxed);
+    buffer.m_events[written % THREAD_EVENT_CAPACITY]
+        = ProfileEvent {.m_name = m_name,
+            .m_begin = m_begin,
+            .m_end = Now(),
+            .m_depth = buffer.m_depth,
+            .m_allocations = GetThreadAllocations() - m_allocationsBegin};
+    buffer.m_written.store(written + 1, std::memory_order_release);
+}
+
+void SetProfileThreadName(std::string name)
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+    std::scoped_lock lock(s_threadsMutex);
+    buffer.m_name = std::move(name);
+}
+
+void CpuProfiler::CollectFrame()
+{
+    std::scoped_lock lock(s_threadsMutex);
+
+    m_frame.resize(s_threads.size());
+    for (size_t threadIdx = 0; threadIdx < s_threads.size(); threadIdx++) {
+        ThreadBuffer& buffer = *s_threads[threadIdx];
+        ProfileThread& thread = m_frame[threadIdx];
+        thread.m_name = buffer.m_name;
+        thread.m_events.clear();
+
+        // Skip the events that were already overwritten.
+        std::uint64_t written = buffer.m_written.load(std::memory_order_acquire);
+        std::uint64_t begin = std::max(buffer.m_read, written > THREAD_EVENT_CAPACITY ? written - THREAD_EVENT_CAPACITY : 0);
+        for (std::uint64_t event = begin; event < written; event++) {
+            thread.m_events.push_back(buffer.m_events[event % THREAD_EVENT_CAPACITY]);
+        }
+
+        // The thread may have kept recording while we copied, drop the events it wrapped over.
+        std::uint64_t rewritten = buffer.m_written.load(std::memory_order_acquire);
+        if (rewritten > THREAD_EVENT_CAPACITY && rewritten - THREAD_EVENT_CAPACITY > begin) {
+            size_t dropped = std::min(rewritten - THREAD_EVENT_CAPACITY - begin, thread.m_events.size());
+            thread.m_events.erase(thread.m_events.begin(), thread.m_events.begin() + static_cast<std::ptrdiff_t>(dropped));
+        }
+        buffer.m_read = written;
+    }
+
+    if (m_captureFramesLeft != 0) {
+        m_capture.resize(m_frame.size());
+        for (size_t threadIdx = 0; threadIdx < m_frame.size(); threadIdx++) {
+            m_capture[threadIdx].m_name = m_frame[threadIdx].m_name;
+            m_capture[threadIdx].m_events.insert(
+                m_capture[threadIdx].m_events.end(), m_frame[threadIdx].m_events.begin(), m_frame[threadIdx].m_events.end());
+        }
+
+        if (--m_captureFramesLeft == 0) {
+            if (WriteChromeTrace(m_capturePath, m_capture)) {
+                spdlog::info("Wrote a CPU profile capture to {}.", m_capturePath.string());
+            } else {
+                spdlog::error("Failed to write a CPU profile capture to {}.", m_capturePath.string());
+            }
+            m_capture.clear();
+        }
+    }
+}
+
+void CpuProfiler::StartCapture(size_t frameCount, std::filesystem::path path)
+{
+    m_capture.clear();
+    m_captureFramesLeft = frameCount;
+    m_capturePath = std::move(path);
+}
+
+bool WriteChromeTrace(const std::filesystem::path& path, std::span<const ProfileThread> threads)
+{
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    // Complete ("X") events in microseconds, with one metadata event naming each thread.
+    file << "{\"traceEvents\":[";
+    bool first = true;
+    for (size_t threadIdx = 0; threadIdx < threads.size(); threadIdx++) {
+        const ProfileThread& thread = threads[threadIdx];
+        file << (first ? "" : ",") << R"({"name":"thread_name","ph":"M","pid":0,"tid":)" << threadIdx
+             << R"(,"args":{"name":")" << thread.m_name << "\"}}";
+        first = false;
+
+        for (const ProfileEvent& event : thread.m_events) {
+            file << R"(,{"name":")" << event.m_name << R"(","ph":"X","pid":0,"tid":)" << threadIdx
+                 << ",\"ts\":" << static_cast<double>(event.m_begin) / 1e3
+                 << ",\"dur\":" << static_cast<double>(event.m_end - event.m_begin) / 1e3 << "}";
+        }
+    }
+    file << "]}\n";
+
+    return static_cast<bool>(file);
+}
+
+} // namespace Glitter::Core
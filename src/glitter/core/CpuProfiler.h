@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Config.h"
+#include "core/AllocationTracker.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#define GLITTER_PROFILE_CONCAT_IMPL(a, b) a##b
+#define GLITTER_PROFILE_CONCAT(a, b) GLITTER_PROFILE_CONCAT_IMPL(a, b)
+
+// Times the rest of the enclosing block on the CPU as `name`, which must be a string literal.
+#define GLITTER_PROFILE_SCOPE(name) ::Glitter::Core::ProfileScope GLITTER_PROFILE_CONCAT(profileScope, __LINE__)(name)
+
+namespace Glitter::Core {
+
+struct ProfileEvent {
+    const char* m_name;
+    // Nanoseconds since the profiler's epoch.
+    std::uint64_t m_begin;
+    std::uint64_t m_end;
+    // Scopes open on the same thread when it began.
+    std::uint32_t m_depth;
+    // Made by the scope's thread while it was open, its nested scopes' included, see Config::ENABLE_ALLOCATION_TRACKING.
+    AllocationCounts m_allocations;
+};
+
+struct ProfileThread {
+    std::string m_name;
+    std::vector<ProfileEvent> m_events;
+};
+
+// Records one ProfileEvent into the calling thread's event buffer when it goes out of scope. Each thread writes into
+// its own ring of events, so recording takes no locks. Records nothing, and compiles to nothing, below
+// Config::InstrumentationLevel::Full.
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+    {
+        if constexpr (Config::ENABLE_PROFILING) {
+            Begin(name);
+        }
+    }
+    ~ProfileScope()
+    {
+        if constexpr (Config::ENABLE_PROFILING) {
+            End();
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    void Begin(const char* name);
+    void End();
+
+    const char* m_name {};
+    std::uint64_t m_begin {};
+    AllocationCounts m_allocationsBegin {};
+};
+
+// Names the calling thread in the timeline and in captures.
+void SetProfileThreadName(std::string name);
+
+// Writes `threads`' events as a Chrome trace JSON file at `path`, which chrome://tracing or https://ui.perfetto.dev open.
+bool WriteChromeTrace(const std::filesystem::path& path, std::span<const ProfileThread> threads);
+
+// Gathers the events recorded by every thread, one frame at a time, and optionally captures a run of frames as a Chrome
+// trace (chrome://tracing or https://ui.perfetto.dev). Must only be used from one thread.
+class CpuProfiler {
+public:
+    // Collects every scope closed since the last call as the latest frame.
+    void CollectFrame();
+
+    // The latest frame's events, by thread.
+    std::span<const ProfileThread> GetFrame() const { return m_frame; }
+
+    // Captures the next `frameCount` frames, then writes them as a Chrome trace JSON file at `path`.
+    void StartCapture(size_t frameCount, std::filesystem::path path);
+    bool IsCapturing() const { return m_captureFramesLeft != 0; }
+
+private:
+    std::vector<ProfileThread> m_frame;
+
+    std::vector<ProfileThread> m_capture;
+    size_t m_captureFramesLeft {};
+    std::filesystem::path m_capturePath;
+};
+
+} // namespace Glitter::Core
@@ -0,0 +1,138 @@
+#include "core/FrameOutput.h"
+
+#include "Config.h"
+
+#include <stb_image_write.h>
+
+#include <format>
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+namespace Glitter::Core {
+
+namespace {
+
+    // The RGB8 pixels of `frame`, top row first.
+    std::vector<std::uint8_t> GetTopDownRgb(const FramePixels& frame)
+    {
+        size_t width = frame.m_width;
+        size_t height = frame.m_height;
+        std::vector<std::uint8_t> rgb(width * height * 3);
+        for (size_t row = 0; row < height; row++) {
+            const std::byte* source = frame.m_pixels.data() + (height - 1 - row) * width * 4;
+            std::uint8_t* destination = rgb.data() + row * width * 3;
+            for (size_t column = 0; column < width; column++) {
+                destination[column * 3 + 0] = static_cast<std::uint8_t>(source[column * 4 + 0]);
+                destination[column * 3 + 1] = static_cast<std::uint8_t>(source[column * 4 + 1]);
+                destination[column * 3 + 2] = static_cast<std::uint8_t>(source[column * 4 + 2]);
+            }
+        }
+        return rgb;
+    }
+
+} // namespace
+
+bool WriteFrameImage(const std::filesystem::path& path, FrameOutputFormat format, const FramePixels& frame)
+{
+    std::vector<std::uint8_t> rgb = GetTopDownRgb(frame);
+    std::error_code error {};
+    std::filesystem::create_directories(path.parent_path(), error);
+
+    if (format == FrameOutputFormat::Png) {
+        auto width = static_cast<int>(frame.m_width);
+        return stbi_write_png(path.string().c_str(), width, static_cast<int>(frame.m_height), 3, rgb.data(), width * 3) != 0;
+    }
+
+    std::ofstream outputStream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    outputStream << std::format("P6\n{} {}\n255\n", frame.m_width, frame.m_height);
+    outputStream.write(reinterpret_cast<const char*>(rgb.data()), static_cast<std::streamsize>(rgb.size()));
+    return static_cast<bool>(outputStream);
+}
+
+bool FrameOutput::Open(FrameOutputFormat format, const std::string& target)
+{
+    Close();
+    m_format = format;
+    if (format == FrameOutputFormat::Pipe) {
+        m_pipe = popen(target.c_str(), "w");
+        if (!m_pipe) {
+            spdlog::error("Failed to start the frame encoder `{}`.", target);
+            return false;
+        }
+    } else {
+        m_directory = target;
+    }
+    m_pipeWidth = 0;
+    m_pipeHeight = 0;
+    m_open = true;
+    return true;
+}
+
+void FrameOutput::Close()
+{
+    for (const std::unique_ptr<JobCounter>& counter : m_encodes) {
+        m_jobSystem.Wait(*counter);
+    }
+    m_encodes.clear();
+
+    if (m_pipe) {
+        pclose(m_pipe);
+        m_pipe = nullptr;
+    }
+    m_open = false;
+}
+
+void FrameOutput::Write(std::uint64_t frameIdx, const FramePixels& frame)
+{
+    if (!m_open) {
+        return;
+    }
+
+    // The encoder reads a stream of frames of the size it was told, so the rows are written right away, in order.
+    if (m_format == FrameOutputFormat::Pipe) {
+        if (m_pipeWidth == 0) {
+            m_pipeWidth = frame.m_width;
+            m_pipeHeight = frame.m_height;
+            spdlog::info("Piping {}x{} RGBA frames to the frame encoder.", m_pipeWidth, m_pipeHeight);
+        }
+        if (frame.m_width != m_pipeWidth || frame.m_height != m_pipeHeight) {
+            spdlog::warn("Skipping the {}x{} frame {}, the frame encoder takes {}x{} frames.", frame.m_width,
+                frame.m_height, frameIdx, m_pipeWidth, m_pipeHeight);
+            return;
+        }
+        size_t rowSize = size_t {frame.m_width} * 4;
+        for (size_t row = frame.m_height; row-- > 0;) {
+            std::fwrite(frame.m_pixels.data() + row * rowSize, 1, rowSize, m_pipe);
+        }
+        return;
+    }
+
+    // Finished encodes are dropped from the front, the oldest unfinished one waited for when the queue is full.
+    while (!m_encodes.empty() && m_encodes.front()->load() == 0) {
+        m_encodes.pop_front();
+    }
+    if (m_encodes.size() >= Glitter::Config::FRAME_OUTPUT_QUEUE_SIZE) {
+        m_jobSystem.Wait(*m_encodes.front());
+        m_encodes.pop_front();
+    }
+
+    const char* extension = m_format == FrameOutputFormat::Png ? "png" : "ppm";
+    std::filesystem::path path = m_directory / std::format("frame_{:06}.{}", frameIdx, extension);
+    std::vector<std::byte> pixels(frame.m_pixels.begin(), frame.m_pixels.end());
+    auto& counter = *m_encodes.emplace_back(std::make_unique<JobCounter>(0));
+    m_jobSystem.Submit(
+        [path = std::move(path), pixels = std::move(pixels), format = m_format, width = frame.m_width,
+            height = frame.m_height] {
+            if (!WriteFrameImage(path, format, FramePixels {.m_width = width, .m_height = height, .m_pixels = pixels})) {
+                spdlog::error("Failed to write the frame {}.", path.string());
+            }
+        },
+        counter);
+}
+
+} // namespace Glitter::Core
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "core/JobSystem.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace Glitter::Core {
+
+enum class FrameOutputFormat : std::uint8_t {
+    // Binary PPM, fast to write but uncompressed.
+    Ppm,
+    Png,
+    // The raw RGBA8 frames, top row first, piped to the standard input of an encoder such as ffmpeg.
+    Pipe,
+};
+
+// The pixels of a frame as read back from GL: RGBA8, from the bottom row up.
+struct FramePixels {
+    std::uint32_t m_width;
+    std::uint32_t m_height;
+    std::span<const std::byte> m_pixels;
+};
+
+// Writes `frame` as an image of `format`, either Ppm or Png, top row first and without its alpha. Returns false if it
+// can't be written.
+bool WriteFrameImage(const std::filesystem::path& path, FrameOutputFormat format, const FramePixels& frame);
+
+// Writes rendered frames out as an image sequence, or pipes them to an encoder. The images are encoded on the job
+// system, so that the output keeps up with the frame rate rather than with the speed of a single encoding thread, with up
+// to Glitter::Config::FRAME_OUTPUT_QUEUE_SIZE frames in flight.
+class FrameOutput {
+public:
+    explicit FrameOutput(JobSystem& jobSystem)
+        : m_jobSystem(jobSystem)
+    {
+    }
+    ~FrameOutput() { Close(); }
+
+    FrameOutput(const FrameOutput&) = delete;
+    FrameOutput& operator=(const FrameOutput&) = delete;
+
+    // `target` is the directory of the image sequence, or the command the frames are piped to. Returns false, after
+    // logging why, if the command can't be started.
+    bool Open(FrameOutputFormat format, const std::string& target);
+    // Waits for the frames still being encoded, and for the encoder to exit.
+    void Close();
+    bool IsOpen() const { return m_open; }
+
+    // Copies `frame` to encode it as the `frameIdx`-th image of the sequence, first waiting for the oldest frame still being
+    // encoded when the queue is full. Piped frames are written right away instead.
+    void Write(std::uint64_t frameIdx, const FramePixels& frame);
+
+private:
+    JobSystem& m_jobSystem;
+    FrameOutputFormat m_format {};
+    std::filesystem::path m_directory;
+    std::FILE* m_pipe {};
+    bool m_open {};
+
+    // A counter per frame being encoded, oldest first.
+    std::deque<std::unique_ptr<JobCounter>> m_encodes;
+    // A pipe only takes frames of its first frame's size.
+    std::uint32_t m_pipeWidth {};
+    std::uint32_t m_pipeHeight {};
+};
+
+} // namespace Glitter::Core
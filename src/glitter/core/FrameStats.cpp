@@ -0,0 +1,79 @@
+#include "core/FrameStats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+namespace Glitter::Core {
+
+namespace {
+    // Activities of the frame in progress.
+    std::atomic<std::uint32_t> s_activities {};
+
+    // Frames needed before the median is trusted to detect stutters.
+    constexpr size_t MIN_STUTTER_HISTORY = 30;
+    // Stutters kept for the debug UI.
+    constexpr size_t MAX_STUTTERS = 16;
+} // namespace
+
+void MarkFrameActivity(std::uint32_t activity) { s_activities.fetch_or(activity, std::memory_order_relaxed); }
+
+std::uint32_t PeekFrameActivity() { return s_activities.load(std::memory_order_relaxed); }
+
+std::string DescribeFrameActivity(std::uint32_t activities)
+{
+    constexpr std::array NAMES = std::to_array<std::pair<std::uint32_t, const char*>>({
+        {FrameActivity::UPLOAD, "upload"},
+        {FrameActivity::BUFFER_GROWTH, "buffer growth"},
+        {FrameActivity::SHADER_COMPILE, "shader compile"},
+        {FrameActivity::TEXTURE_LOAD, "texture load"},
+        {FrameActivity::FBO_RESIZE, "FBO resize"},
+        {FrameActivity::SCENE_CHANGE, "scene change"},
+    });
+
+    std::string description;
+    for (const auto& [activity, name] : NAMES) {
+        if (activities & activity) {
+            description += description.empty() ? name : std::string(", ") + name;
+        }
+    }
+    return description.empty() ? "none" : description;
+}
+
+bool FrameStats::BeginFrame()
+{
+    auto now = std::chrono::steady_clock::now();
+    std::uint32_t activities = s_activities.exchange(0, std::memory_order_relaxed);
+
+    // The first call has no frame to end.
+    if (m_frameStart == std::chrono::steady_clock::time_point {}) {
+        m_frameStart = now;
+        return false;
+    }
+    auto milliseconds = std::chrono::duration<float, std::milli>(now - m_frameStart).count();
+    m_frameStart = now;
+
+    // Compare against the frames before this one, so that a stutter doesn't raise its own threshold.
+    size_t historyCount = GetHistoryCount();
+    bool stutter = historyCount >= MIN_STUTTER_HISTORY && milliseconds > m_median * Glitter::Config::STUTTER_FACTOR;
+    if (stutter) {
+        m_stutters.push_back(
+            Stutter {.m_frame = m_frameCount, .m_milliseconds = milliseconds, .m_median = m_median, .m_activities = activities});
+        if (m_stutters.size() > MAX_STUTTERS) {
+            m_stutters.pop_front();
+        }
+    }
+
+    m_history[GetHistoryOffset()] = milliseconds;
+    m_frameCount++;
+
+    std::array<float, Glitter::Config::FRAME_HISTORY_SIZE> sorted = m_history;
+    auto end = sorted.begin() + static_cast<std::ptrdiff_t>(GetHistoryCount());
+    auto middle = sorted.begin() + static_cast<std::ptrdiff_t>(GetHistoryCount() / 2);
+    std::nth_element(sorted.begin(), middle, end);
+    m_median = *middle;
+    m_max = *std::max_element(sorted.begin(), end);
+    return stutter;
+}
+
+} // namespace Glitter::Core
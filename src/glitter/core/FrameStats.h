@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Config.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+namespace Glitter::Core {
+
+// What a frame spent time on besides rendering, to explain stutters.
+namespace FrameActivity {
+    constexpr std::uint32_t UPLOAD = 1 << 0;
+    constexpr std::uint32_t BUFFER_GROWTH = 1 << 1;
+    constexpr std::uint32_t SHADER_COMPILE = 1 << 2;
+    constexpr std::uint32_t TEXTURE_LOAD = 1 << 3;
+    constexpr std::uint32_t FBO_RESIZE = 1 << 4;
+    constexpr std::uint32_t SCENE_CHANGE = 1 << 5;
+} // namespace FrameActivity
+
+// Tags the current frame with `activity`, from any thread.
+void MarkFrameActivity(std::uint32_t activity);
+// The activities of the current frame so far.
+std::uint32_t PeekFrameActivity();
+
+// Lists the names of every activity in `activities`, comma-separated.
+std::string DescribeFrameActivity(std::uint32_t activities);
+
+// Keeps the frame times of the last Glitter::Config::FRAME_HISTORY_SIZE frames, and flags the frames that took more
+// than Glitter::Config::STUTTER_FACTOR times the median as stutters, along with what they were busy with.
+class FrameStats {
+public:
+    struct Stutter {
+        size_t m_frame;
+        float m_milliseconds;
+        float m_median;
+        std::uint32_t m_activities;
+    };
+
+    // Ends the previous frame, timed from the last call, and starts a new one. Returns whether the ended frame was a stutter.
+    bool BeginFrame();
+    // Drops the current frame, so that the time until the next BeginFrame(), e.g. spent waiting for input, isn't counted.
+    void Pause() { m_frameStart = {}; }
+
+    // A ring of frame times in milliseconds, the oldest at GetHistoryOffset().
+    const std::array<float, Glitter::Config::FRAME_HISTORY_SIZE>& GetHistory() const { return m_history; }
+    size_t GetHistoryOffset() const { return m_frameCount % m_history.size(); }
+    size_t GetHistoryCount() const { return std::min(m_frameCount, m_history.size()); }
+
+    float GetMedian() const { return m_median; }
+    float GetMax() const { return m_max; }
+    // The latest stutters, oldest first.
+    const std::deque<Stutter>& GetStutters() const { return m_stutters; }
+
+private:
+    std::array<float, Glitter::Config::FRAME_HISTORY_SIZE> m_history {};
+    size_t m_frameCount {};
+    float m_median {};
+    float m_max {};
+
+    std::deque<Stutter> m_stutters;
+    std::chrono::steady_clock::time_point m_frameStart {};
+};
+
+} // namespace Glitter::Core
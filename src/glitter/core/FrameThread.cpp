@@ -0,0 +1,66 @@
+#include "core/FrameThread.h"
+
+#include "core/CpuProfiler.h"
+
+#include <utility>
+
+namespace Glitter::Core {
+
+FrameThread::FrameThread(std::string name)
+{
+    // Started once every other member is initialized.
+    m_thread = std::thread([this, name = std::move(name)] { ThreadMain(name); });
+}
+
+FrameThread::~FrameThread()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+}
+
+void FrameThread::Kick(Job job)
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_job = std::move(job);
+        m_busy = true;
+    }
+    m_condition.notify_all();
+}
+
+void FrameThread::Wait()
+{
+    std::unique_lock lock(m_mutex);
+    m_condition.wait(lock, [this] { return !m_busy; });
+}
+
+void FrameThread::ThreadMain(const std::string& name)
+{
+    SetProfileThreadName(name);
+
+    while (true) {
+        Job job {};
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this] { return !m_running || m_job; });
+            if (!m_running) {
+                return;
+            }
+            job = std::exchange(m_job, nullptr);
+        }
+
+        job();
+
+        {
+            std::scoped_lock lock(m_mutex);
+            m_busy = false;
+        }
+        m_condition.notify_all();
+    }
+}
+
+} // namespace Glitter::Core
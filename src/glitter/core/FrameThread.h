@@ -0,0 +1,40 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Glitter::Core {
+
+// A thread of its own running one job at a time, so that the calling thread can work alongside it until Wait(). Unlike
+// the JobSystem's workers, it never runs anything else, and the waiting thread doesn't help out.
+class FrameThread {
+public:
+    using Job = std::function<void()>;
+
+    // `name` is the thread's name in the CPU profiler.
+    explicit FrameThread(std::string name);
+    ~FrameThread();
+
+    FrameThread(const FrameThread&) = delete;
+    FrameThread& operator=(const FrameThread&) = delete;
+
+    // Starts running `job`, the previous one must have been waited for.
+    void Kick(Job job);
+    // Returns once the latest kicked job has run.
+    void Wait();
+
+private:
+    void ThreadMain(const std::string& name);
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    Job m_job;
+    bool m_busy {};
+    bool m_running {true};
+    std::thread m_thread;
+};
+
+} // namespace Glitter::Core
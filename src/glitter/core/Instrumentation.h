@@ -0,0 +1,12 @@
+#pragma once
+
+#include "Config.h"
+
+// Runs the statement, counting something, from InstrumentationLevel::Counters up. Below that, it's still compiled, so that
+// it doesn't rot, but discarded, leaving no code behind.
+#define GLITTER_COUNT(...) \
+    do { \
+        if constexpr (::Glitter::Config::ENABLE_COUNTERS) { \
+            __VA_ARGS__; \
+        } \
+    } while (false)
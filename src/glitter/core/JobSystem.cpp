@@ -0,0 +1,244 @@
+#include "core/JobSystem.h"
+
+#include "Config.h"
+#include "core/CpuProfiler.h"
+
+#include <algorithm>
+#include <string>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Glitter::Core {
+
+namespace {
+
+    // The lane of the job running on this thread, Frame outside of any.
+    thread_local JobPriority t_jobPriority = JobPriority::Frame;
+
+    // Pins `thread` to the hardware thread `cpu`, where the platform allows it.
+    void PinThread(std::thread& thread, size_t cpu)
+    {
+#if defined(_WIN32)
+        if (cpu < 8 * sizeof(DWORD_PTR)) {
+            SetThreadAffinityMask(thread.native_handle(), DWORD_PTR {1} << cpu);
+        }
+#elif defined(__linux__)
+        cpu_set_t set {};
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+        (void)thread;
+        (void)cpu;
+#endif
+    }
+
+} // namespace
+
+JobSystem::JobSystem(size_t workerCount)
+{
+    if (workerCount == 0) {
+        workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    for (size_t queueIdx = 0; queueIdx < workerCount + 1; queueIdx++) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t queueIdx = 1; queueIdx < m_queues.size(); queueIdx++) {
+        m_workers.emplace_back([this, queueIdx] { WorkerMain(queueIdx); });
+        // The workers take the hardware threads past the first, left to the main thread.
+        if (Config::ENABLE_JOB_AFFINITY) {
+            PinThread(m_workers.back(), queueIdx % std::max(std::thread::hardware_concurrency(), 1u));
+        }
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::scoped_lock lock(m_sleepMutex);
+        m_running = false;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::Submit(Job job, JobCounter& counter, JobPriority priority)
+{
+    counter.fetch_add(1, std::memory_order_relaxed);
+    auto wrappedJob = [job = std::move(job), &counter] {
+        job();
+        counter.fetch_sub(1, std::memory_order_release);
+    };
+
+    // Spread the jobs over the worker queues, the owning thread only gets work by stealing while it waits.
+    auto lane = static_cast<size_t>(priority);
+    size_t queueIdx = m_workers.empty() ? 0 : 1 + m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+    {
+        std::scoped_lock lock(m_queues[queueIdx]->m_mutex);
+        m_queues[queueIdx]->m_jobs[lane].emplace_back(std::move(wrappedJob));
+    }
+
+    {
+        std::scoped_lock lock(m_sleepMutex);
+        m_pendingJobs[lane].fetch_add(1, std::memory_order_relaxed);
+    }
+    m_wakeCondition.notify_one();
+}
+
+void JobSystem::Wait(const JobCounter& counter)
+{
+    while (counter.load(std::memory_order_acquire) != 0) {
+        if (!TryRun(0, false)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& function)
+{
+    if (count == 0) {
+        return;
+    }
+
+    // Don't bother going wide for a single range.
+    grainSize = std::max<size_t>(grainSize, 1);
+    if (count <= grainSize || m_workers.empty()) {
+        function(0, count);
+        return;
+    }
+
+    JobCounter counter {};
+    for (size_t begin = 0; begin < count; begin += grainSize) {
+        size_t end = std::min(begin + grainSize, count);
+        Submit([&function, begin, end] { function(begin, end); }, counter, t_jobPriority);
+    }
+    Wait(counter);
+}
+
+void JobSystem::SetBackgroundThrottled(bool throttled)
+{
+    // The workers held back from the background jobs may take them again.
+    if (m_backgroundThrottled.exchange(throttled, std::memory_order_relaxed) && !throttled) {
+        {
+            std::scoped_lock lock(m_sleepMutex);
+        }
+        m_wakeCondition.notify_all();
+    }
+}
+
+void JobSystem::WorkerMain(size_t queueIdx)
+{
+    SetProfileThreadName("Worker " + std::to_string(queueIdx));
+
+    while (true) {
+        if (TryRun(queueIdx, true)) {
+            continue;
+        }
+
+        std::unique_lock lock(m_sleepMutex);
+        m_wakeCondition.wait(lock, [this] { return !m_running || HasRunnableJobs(); });
+        if (!m_running) {
+            return;
+        }
+    }
+}
+
+bool JobSystem::TryRun(size_t queueIdx, bool worker)
+{
+    for (size_t lane = 0; lane < PRIORITY_COUNT; lane++) {
+        if (m_pendingJobs[lane].load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+
+        // A worker holds one of the throttled background slots for as long as it runs the job.
+        auto priority = static_cast<JobPriority>(lane);
+        bool throttled
+            = worker && priority == JobPriority::Background && m_backgroundThrottled.load(std::memory_order_relaxed);
+        auto releaseSlot = [this] {
+            {
+                std::scoped_lock lock(m_sleepMutex);
+                m_backgroundWorkers.fetch_sub(1, std::memory_order_relaxed);
+            }
+            m_wakeCondition.notify_one();
+        };
+        if (throttled
+            && m_backgroundWorkers.fetch_add(1, std::memory_order_relaxed) >= Config::JOB_THROTTLED_BACKGROUND_WORKERS) {
+            // The workers holding the slots wake the others once they're done.
+            m_backgroundWorkers.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        Job job = TryPop(queueIdx, priority);
+        if (!job) {
+            if (throttled) {
+                releaseSlot();
+            }
+            continue;
+        }
+
+        m_pendingJobs[lane].fetch_sub(1, std::memory_order_relaxed);
+        JobPriority outerPriority = t_jobPriority;
+        t_jobPriority = priority;
+        job();
+        t_jobPriority = outerPriority;
+        if (throttled) {
+            releaseSlot();
+        }
+        return true;
+    }
+    return false;
+}
+
+JobSystem::Job JobSystem::TryPop(size_t queueIdx, JobPriority priority)
+{
+    auto lane = static_cast<size_t>(priority);
+
+    // Pop from the back of our own queue first, it holds the most recently submitted (and so likely cache-hot) work.
+    {
+        WorkQueue& queue = *m_queues[queueIdx];
+        std::scoped_lock lock(queue.m_mutex);
+        if (!queue.m_jobs[lane].empty()) {
+            Job job = std::move(queue.m_jobs[lane].back());
+            queue.m_jobs[lane].pop_back();
+            return job;
+        }
+    }
+
+    // Otherwise, steal from the front of the other queues.
+    for (size_t offset = 1; offset < m_queues.size(); offset++) {
+        WorkQueue& queue = *m_queues[(queueIdx + offset) % m_queues.size()];
+        std::scoped_lock lock(queue.m_mutex);
+        if (!queue.m_jobs[lane].empty()) {
+            Job job = std::move(queue.m_jobs[lane].front());
+            queue.m_jobs[lane].pop_front();
+            return job;
+        }
+    }
+    return {};
+}
+
+bool JobSystem::HasRunnableJobs() const
+{
+    constexpr auto BACKGROUND = static_cast<size_t>(JobPriority::Background);
+    for (size_t lane = 0; lane < BACKGROUND; lane++) {
+        if (m_pendingJobs[lane].load(std::memory_order_relaxed) != 0) {
+            return true;
+        }
+    }
+    return m_pendingJobs[BACKGROUND].load(std::memory_order_relaxed) != 0
+        && (!m_backgroundThrottled.load(std::memory_order_relaxed)
+            || m_backgroundWorkers.load(std::memory_order_relaxed) < Config::JOB_THROTTLED_BACKGROUND_WORKERS);
+}
+
+} // namespace Glitter::Core
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Glitter::Core {
+
+// Counts the unfinished jobs of a group, JobSystem::Wait() returns once it reaches zero.
+using JobCounter = std::atomic<size_t>;
+
+// The lanes of the JobSystem, a job of a lane only running once none of the lanes before it have any queued.
+enum class JobPriority : std::uint8_t {
+    // The work the current frame waits for.
+    Frame,
+    Normal,
+    // Loading and streaming, throttled while the frame is behind, see JobSystem::SetBackgroundThrottled().
+    Background,
+    Count,
+};
+
+// A small work-stealing job system. Each worker pops jobs from the back of its own queue and steals from the front of
+// the others' once it runs dry, and the thread calling Wait() helps out instead of blocking. Each queue has a lane per
+// JobPriority, and the workers look through every queue's lane before the next one, picking the lane again between
+// each job, so that a frame's jobs pass the background ones queued before them as soon as a worker is done with its
+// current job: background jobs are kept short enough for that.
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    // `workerCount` of 0 uses one worker per hardware thread, minus the calling thread.
+    explicit JobSystem(size_t workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Queues `job`, incrementing `counter` until it has run.
+    void Submit(Job job, JobCounter& counter, JobPriority priority = JobPriority::Normal);
+    // Runs queued jobs on the calling thread until `counter` reaches zero, of any lane, since those it waits for may be
+    // throttled.
+    void Wait(const JobCounter& counter);
+
+    // Splits [0, count) into ranges of at most `grainSize` elements and calls `function(begin, end)` for each, returning
+    // once every range is done. Ranges start at multiples of `grainSize`. The ranges are in the lane of the job calling
+    // it, and JobPriority::Frame outside of a job, since the calling thread waits for them.
+    void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& function);
+
+    // While throttled, only Config::JOB_THROTTLED_BACKGROUND_WORKERS workers at a time run background jobs, leaving the
+    // others to the frame's.
+    void SetBackgroundThrottled(bool throttled);
+    bool IsBackgroundThrottled() const { return m_backgroundThrottled.load(std::memory_order_relaxed); }
+
+    // Workers plus the calling thread.
+    size_t GetThreadCount() const { return m_queues.size(); }
+
+private:
+    static constexpr size_t PRIORITY_COUNT = static_cast<size_t>(JobPriority::Count);
+
+    struct WorkQueue {
+        std::mutex m_mutex;
+        std::array<std::deque<Job>, PRIORITY_COUNT> m_jobs;
+    };
+
+    void WorkerMain(size_t queueIdx);
+    // Pops a job from `queueIdx`, or steals one from another queue, from the first lane having one. Workers pass `worker`
+    // to be held to the background throttling.
+    bool TryRun(size_t queueIdx, bool worker);
+    Job TryPop(size_t queueIdx, JobPriority priority);
+    // Whether a sleeping worker has a job it may run.
+    bool HasRunnableJobs() const;
+
+    // m_queues[0] belongs to the thread owning the JobSystem, the rest to the workers.
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeCondition;
+    std::array<std::atomic<size_t>, PRIORITY_COUNT> m_pendingJobs {};
+    std::atomic<size_t> m_nextQueue {};
+    std::atomic<bool> m_running {true};
+
+    std::atomic<bool> m_backgroundThrottled {};
+    // Workers running a background job.
+    std::atomic<size_t> m_backgroundWorkers {};
+};
+
+} // namespace Glitter::Core
@@ -0,0 +1,59 @@
+#include "core/LogForwarder.h"
+
+#include "Config.h"
+#include "core/Logging.h"
+#include "util/RingQueue.h"
+
+#include <spdlog/sinks/base_sink.h>
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+
+namespace Glitter::Core {
+
+// Only the payload is kept, the logger's formatter isn't thread-safe, and the level is shown by the window. The queue
+// takes care of the threads logging at once, hence no mutex.
+class LogForwarder::Sink final : public spdlog::sinks::base_sink<spdlog::details::null_mutex> {
+public:
+    Util::MpscQueue<LogMessage> m_queue {Config::LOG_FORWARD_QUEUE_CAPACITY};
+    std::atomic<size_t> m_droppedCount {};
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& message) override
+    {
+        LogMessage forwarded {.m_level = message.level, .m_text = std::string(message.payload.data(), message.payload.size())};
+        if (!m_queue.TryPush(std::move(forwarded))) {
+            m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    void flush_() override { }
+};
+
+LogForwarder::LogForwarder()
+    : m_sink(std::make_shared<Sink>())
+{
+    AddLogSink(m_sink);
+}
+
+LogForwarder::~LogForwarder()
+{
+    RemoveLogSink(m_sink);
+}
+
+void LogForwarder::Drain()
+{
+    while (std::optional<LogMessage> message = m_sink->m_queue.TryPop()) {
+        m_history.push_back(std::move(*message));
+    }
+    while (m_history.size() > Config::LOG_WINDOW_HISTORY) {
+        m_history.pop_front();
+    }
+}
+
+size_t LogForwarder::GetDroppedCount() const
+{
+    return m_sink->m_droppedCount.load(std::memory_order_relaxed);
+}
+
+} // namespace Glitter::Core
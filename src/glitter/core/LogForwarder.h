@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace Glitter::Core {
+
+struct LogMessage {
+    spdlog::level::level_enum m_level;
+    std::string m_text;
+};
+
+// Forwards the messages logged through the default logger, from any thread, to the main thread, to be shown in the
+// "Glitter Log" window. They're handed over through a lock-free queue rather than under a lock, so that a worker logging
+// never stalls the frame, and the ones past Config::LOG_FORWARD_QUEUE_CAPACITY between two Drain() are dropped instead.
+// Installed by its constructor, and removed by its destructor, see AddLogSink().
+class LogForwarder {
+public:
+    LogForwarder();
+    ~LogForwarder();
+
+    LogForwarder(const LogForwarder&) = delete;
+    LogForwarder& operator=(const LogForwarder&) = delete;
+
+    // Moves the messages logged since into the history, keeping the last Config::LOG_WINDOW_HISTORY. Main thread only.
+    void Drain();
+
+    // Oldest first.
+    const std::deque<LogMessage>& GetHistory() const { return m_history; }
+    // The messages dropped since the start, as the queue was full.
+    size_t GetDroppedCount() const;
+
+private:
+    class Sink;
+
+    std::shared_ptr<Sink> m_sink;
+    std::deque<LogMessage> m_history;
+};
+
+} // namespace Glitter::Core
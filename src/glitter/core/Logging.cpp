@@ -0,0 +1,66 @@
+#include "core/Logging.h"
+
+#include "Config.h"
+
+#include <spdlog/async.h>
+#include <spdlog/sinks/dist_sink.h>
+
+#include <utility>
+#include <vector>
+
+namespace Glitter::Core {
+
+namespace {
+
+    // Every sink of the default logger, which can be changed under its mutex while the logging thread writes into them.
+    std::shared_ptr<spdlog::sinks::dist_sink_mt> s_sinks;
+
+} // namespace
+
+void InitializeLogging()
+{
+    s_sinks = std::make_shared<spdlog::sinks::dist_sink_mt>(spdlog::default_logger()->sinks());
+    spdlog::init_thread_pool(Config::LOG_QUEUE_SIZE, 1);
+    auto logger = std::make_shared<spdlog::async_logger>(
+        "glitter", s_sinks, spdlog::thread_pool(), spdlog::async_overflow_policy::discard_new);
+    logger->set_level(spdlog::default_logger()->level());
+    // The errors are written out right away, in case they're the last ones.
+    logger->flush_on(spdlog::level::err);
+    spdlog::set_default_logger(std::move(logger));
+}
+
+void ShutdownLogging()
+{
+    // Whatever's logged past this point is written out right away, by the thread logging it.
+    auto logger = std::make_shared<spdlog::logger>("glitter", s_sinks);
+    logger->set_level(spdlog::default_logger()->level());
+    spdlog::set_default_logger(std::move(logger));
+    // Joins the logging thread once it wrote out the queued messages.
+    spdlog::details::registry::instance().set_tp(nullptr);
+}
+
+void AddLogSink(std::shared_ptr<spdlog::sinks::sink> sink)
+{
+    if (s_sinks) {
+        s_sinks->add_sink(std::move(sink));
+    } else {
+        spdlog::default_logger()->sinks().push_back(std::move(sink));
+    }
+}
+
+void RemoveLogSink(const std::shared_ptr<spdlog::sinks::sink>& sink)
+{
+    if (s_sinks) {
+        s_sinks->remove_sink(sink);
+    } else {
+        std::erase(spdlog::default_logger()->sinks(), sink);
+    }
+}
+
+size_t GetDroppedLogCount()
+{
+    std::shared_ptr<spdlog::details::thread_pool> threadPool = spdlog::thread_pool();
+    return threadPool ? threadPool->discard_counter() : 0;
+}
+
+} // namespace Glitter::Core
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace spdlog::sinks {
+class sink;
+} // namespace spdlog::sinks
+
+namespace Glitter::Core {
+
+// Replaces the default logger by one handing its messages to a thread of their own, which writes them into the same
+// sinks, so that the threads logging only ever format and queue them. Up to Config::LOG_QUEUE_SIZE messages are queued,
+// the ones past that are dropped and counted. Called before anything else logs, from the main thread.
+void InitializeLogging();
+// Writes out the queued messages and joins the logging thread, once every other thread is done logging.
+void ShutdownLogging();
+
+// Adds or removes a sink of the default logger, while the other threads log.
+void AddLogSink(std::shared_ptr<spdlog::sinks::sink> sink);
+void RemoveLogSink(const std::shared_ptr<spdlog::sinks::sink>& sink);
+
+// The messages dropped so far, as the queue was full.
+size_t GetDroppedLogCount();
+
+} // namespace Glitter::Core
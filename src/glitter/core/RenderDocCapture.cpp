@@ -0,0 +1,96 @@
+#include "core/RenderDocCapture.h"
+
+#include <array>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#define GLITTER_RENDERDOC_CC __cdecl
+#else
+#include <dlfcn.h>
+#define GLITTER_RENDERDOC_CC
+#endif
+
+namespace Glitter::Core {
+
+// Laid out like the start of RENDERDOC_API_1_1_2, whose every entry is a function pointer, so that renderdoc_app.h isn't
+// needed. Later versions only append to it.
+struct RenderDocCapture::Api {
+    using Unused = void(GLITTER_RENDERDOC_CC*)();
+
+    // GetAPIVersion to UnloadCrashHandler.
+    std::array<Unused, 11> m_unused;
+    void(GLITTER_RENDERDOC_CC* m_setCaptureFilePathTemplate)(const char* pathTemplate);
+    const char*(GLITTER_RENDERDOC_CC* m_getCaptureFilePathTemplate)();
+    std::uint32_t(GLITTER_RENDERDOC_CC* m_getNumCaptures)();
+    // Writes the path of capture `index` into `path` when given, and its size with the terminator into `pathLength`.
+    std::uint32_t(GLITTER_RENDERDOC_CC* m_getCapture)(
+        std::uint32_t index, char* path, std::uint32_t* pathLength, std::uint64_t* timestamp);
+    void(GLITTER_RENDERDOC_CC* m_triggerCapture)();
+};
+
+namespace {
+
+    // eRENDERDOC_API_Version_1_1_2.
+    constexpr int RENDERDOC_API_VERSION = 10102;
+
+    using GetApi = int(GLITTER_RENDERDOC_CC*)(int version, void** api);
+
+    // RENDERDOC_GetAPI of the RenderDoc library already loaded into the process, if any.
+    GetApi FindGetApi()
+    {
+#ifdef _WIN32
+        HMODULE module = GetModuleHandleA("renderdoc.dll");
+        return module ? reinterpret_cast<GetApi>(GetProcAddress(module, "RENDERDOC_GetAPI")) : nullptr;
+#else
+        void* module = dlopen("librenderdoc.so", RTLD_NOW | RTLD_NOLOAD);
+        return module ? reinterpret_cast<GetApi>(dlsym(module, "RENDERDOC_GetAPI")) : nullptr;
+#endif
+    }
+
+} // namespace
+
+bool RenderDocCapture::Connect()
+{
+    GetApi getApi = FindGetApi();
+    void* api = nullptr;
+    if (!getApi || getApi(RENDERDOC_API_VERSION, &api) != 1 || !api) {
+        return false;
+    }
+
+    m_api = static_cast<const Api*>(api);
+    m_loggedCount = m_api->m_getNumCaptures();
+    spdlog::info("Connected to RenderDoc, capturing into {}*.rdc.", m_api->m_getCaptureFilePathTemplate());
+    return true;
+}
+
+void RenderDocCapture::TriggerCapture(std::string_view reason)
+{
+    if (!m_api) {
+        return;
+    }
+    m_api->m_triggerCapture();
+    spdlog::info("Capturing the next frame with RenderDoc: {}.", reason);
+}
+
+void RenderDocCapture::LogCaptures()
+{
+    if (!m_api) {
+        return;
+    }
+    // A triggered capture is only written once its frame was presented.
+    for (std::uint32_t captureCount = m_api->m_getNumCaptures(); m_loggedCount < captureCount; m_loggedCount++) {
+        std::uint32_t pathLength = 0;
+        if (m_api->m_getCapture(m_loggedCount, nullptr, &pathLength, nullptr) != 1 || pathLength == 0) {
+            continue;
+        }
+        std::string path(pathLength, '\0');
+        m_api->m_getCapture(m_loggedCount, path.data(), &pathLength, nullptr);
+        path.resize(pathLength - 1);
+        spdlog::info("Wrote the RenderDoc capture {}.", path);
+    }
+}
+
+} // namespace Glitter::Core
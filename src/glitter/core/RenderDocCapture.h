@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace Glitter::Core {
+
+// Triggers RenderDoc frame captures from inside the application, through RenderDoc's in-application API, so that a
+// hotkey or a stutter can capture the next frame without the RenderDoc UI in the way. RenderDoc must have been injected
+// into the process, by launching it from RenderDoc or preloading its library: it's only ever connected to, never loaded,
+// so that it can't hook the GL context after it was created. Must only be used from the thread presenting the frames.
+class RenderDocCapture {
+public:
+    // Connects to RenderDoc when it's injected into the process. Returns false when it isn't.
+    bool Connect();
+
+    bool IsConnected() const { return m_api != nullptr; }
+
+    // Captures the next frame presented, logging `reason`. Does nothing when not connected.
+    void TriggerCapture(std::string_view reason);
+
+    // Logs the path of every capture written since the last call.
+    void LogCaptures();
+
+private:
+    // The prefix of RENDERDOC_API_1_1_2 that's used, see renderdoc_app.h.
+    struct Api;
+
+    const Api* m_api {};
+    std::uint32_t m_loggedCount {};
+};
+
+} // namespace Glitter::Core
@@ -0,0 +1,45 @@
+#include "core/RenderServer.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace Glitter::Core {
+
+std::optional<std::vector<ServedSceneDesc>> ReadServeManifest(const std::filesystem::path& path)
+{
+    std::ifstream file(path);
+    if (!file) {
+        spdlog::error("Failed to read the serve manifest {}.", path.string());
+        return std::nullopt;
+    }
+
+    std::vector<ServedSceneDesc> scenes {};
+    std::string line {};
+    for (size_t lineIdx = 1; std::getline(file, line); lineIdx++) {
+        std::istringstream fields(line);
+        std::string scenePath {};
+        if (!(fields >> scenePath) || scenePath.starts_with('#')) {
+            continue;
+        }
+
+        std::string cameraPath {};
+        std::string capturePath {};
+        std::string extra {};
+        fields >> cameraPath >> capturePath;
+        if (fields >> extra) {
+            spdlog::warn("Ignoring the extra fields of line {} of the serve manifest {}.", lineIdx, path.string());
+        }
+        scenes.push_back(ServedSceneDesc {.m_scenePath = scenePath,
+            .m_cameraPath = cameraPath == "-" ? std::filesystem::path {} : std::filesystem::path(cameraPath),
+            .m_capturePath = capturePath});
+    }
+
+    if (scenes.empty()) {
+        spdlog::error("The serve manifest {} lists no scene.", path.string());
+        return std::nullopt;
+    }
+    return scenes;
+}
+
+} // namespace Glitter::Core
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace Glitter::Core {
+
+// One of the scenes `--serve` renders, from its own camera into its own target.
+struct ServedSceneDesc {
+    // The scene snapshot its Nodes are loaded from.
+    std::filesystem::path m_scenePath;
+    // The camera recording its frames follow, if any. Without one, it renders the benchmark's frame count along the default
+    // camera path.
+    std::filesystem::path m_cameraPath;
+    // The directory its frames are written into as images, if any.
+    std::filesystem::path m_capturePath;
+};
+
+// Reads the `--serve` manifest at `path`: a scene per line, as `<scene snapshot> [<camera recording>] [<capture
+// directory>]` separated by spaces, `-` standing for an omitted camera recording. Blank lines and the ones starting with
+// `#` are skipped. Returns std::nullopt, after logging why, if the manifest can't be read or lists no scene.
+std::optional<std::vector<ServedSceneDesc>> ReadServeManifest(const std::filesystem::path& path);
+
+// Tags the frames of several served scenes read back through a single FrameReadback, which only carries a frame index.
+constexpr std::uint64_t MakeServedFrameTag(size_t scene, std::uint64_t frame)
+{
+    return (static_cast<std::uint64_t>(scene) << 32) | (frame & UINT32_MAX);
+}
+constexpr size_t GetServedFrameScene(std::uint64_t tag) { return static_cast<size_t>(tag >> 32); }
+constexpr std::uint64_t GetServedFrameIndex(std::uint64_t tag) { return tag & UINT32_MAX; }
+
+} // namespace Glitter::Core
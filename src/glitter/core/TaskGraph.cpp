@@ -0,0 +1,161 @@
+#include "core/TaskGraph.h"
+
+#include "core/CpuProfiler.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+
+namespace Glitter::Core {
+
+TaskGraph::TaskId TaskGraph::Add(const char* name, TaskThread thread, Task task, std::initializer_list<TaskId> dependencies)
+{
+    return AddNode(name, thread, std::move(task), dependencies);
+}
+
+TaskGraph::TaskId TaskGraph::Add(const char* name, TaskThread thread, Task task, const Access& access)
+{
+    // Read after write, then write after write or read.
+    std::vector<TaskId> dependencies;
+    for (const void* state : access.m_reads) {
+        if (std::optional<TaskId> writer = GetStateUse(state).m_writer) {
+            dependencies.push_back(*writer);
+        }
+    }
+    for (const void* state : access.m_writes) {
+        const StateUse& use = GetStateUse(state);
+        if (use.m_writer) {
+            dependencies.push_back(*use.m_writer);
+        }
+        dependencies.insert(dependencies.end(), use.m_readers.begin(), use.m_readers.end());
+    }
+    std::ranges::sort(dependencies);
+    auto [last, end] = std::ranges::unique(dependencies);
+    dependencies.erase(last, end);
+
+    TaskId id = AddNode(name, thread, std::move(task), dependencies);
+    for (const void* state : access.m_reads) {
+        GetStateUse(state).m_readers.push_back(id);
+    }
+    for (const void* state : access.m_writes) {
+        StateUse& use = GetStateUse(state);
+        use.m_writer = id;
+        use.m_readers.clear();
+    }
+    return id;
+}
+
+TaskGraph::TaskId TaskGraph::AddNode(const char* name, TaskThread thread, Task task, std::span<const TaskId> dependencies)
+{
+    TaskId id = m_nodes.size();
+    for (TaskId dependency : dependencies) {
+        m_nodes[dependency].m_dependents.push_back(id);
+    }
+    m_nodes.push_back(Node {.m_name = name,
+        .m_thread = thread,
+        .m_task = std::move(task),
+        .m_dependencyCount = dependencies.size(),
+        .m_dependents = {}});
+    return id;
+}
+
+TaskGraph::StateUse& TaskGraph::GetStateUse(const void* state)
+{
+    auto it = std::ranges::find(m_stateUses, state, &StateUse::m_state);
+    if (it == m_stateUses.end()) {
+        it = m_stateUses.insert(m_stateUses.end(), StateUse {.m_state = state, .m_writer = std::nullopt, .m_readers = {}});
+    }
+    return *it;
+}
+
+bool TaskGraph::Run(JobSystem& jobSystem)
+{
+    std::vector<size_t> dependenciesLeft(m_nodes.size());
+    for (TaskId id = 0; id < m_nodes.size(); id++) {
+        dependenciesLeft[id] = m_nodes[id].m_dependencyCount;
+    }
+
+    // The Worker tasks hand their completion back to this thread, which alone walks the graph.
+    std::mutex finishedMutex;
+    std::condition_variable finishedCondition;
+    std::vector<TaskId> finished {};
+    bool failed = false;
+    JobCounter workerTasks {};
+
+    std::vector<TaskId> readyMainTasks {};
+    auto launch = [&](TaskId id) {
+        Node& node = m_nodes[id];
+        if (node.m_thread == TaskThread::Main) {
+            readyMainTasks.push_back(id);
+            return;
+        }
+        jobSystem.Submit(
+            [&, id] {
+                bool succeeded = false;
+                {
+                    ProfileScope scope(m_nodes[id].m_name);
+                    succeeded = m_nodes[id].m_task();
+                }
+                {
+                    std::scoped_lock lock(finishedMutex);
+                    finished.push_back(id);
+                    failed |= !succeeded;
+                }
+                finishedCondition.notify_one();
+            },
+            workerTasks, JobPriority::Frame);
+    };
+
+    size_t doneCount = 0;
+    auto complete = [&](TaskId id) {
+        doneCount++;
+        for (TaskId dependent : m_nodes[id].m_dependents) {
+            if (--dependenciesLeft[dependent] == 0) {
+                launch(dependent);
+            }
+        }
+    };
+
+    for (TaskId id = 0; id < m_nodes.size(); id++) {
+        if (dependenciesLeft[id] == 0) {
+            launch(id);
+        }
+    }
+
+    bool succeeded = true;
+    std::vector<TaskId> finishedNow {};
+    while (succeeded && doneCount < m_nodes.size()) {
+        // Sleep until a Worker task finishes, unless a Main task can run already.
+        {
+            std::unique_lock lock(finishedMutex);
+            if (readyMainTasks.empty()) {
+                finishedCondition.wait(lock, [&] { return !finished.empty(); });
+            }
+            finishedNow.swap(finished);
+            succeeded = !failed;
+        }
+        for (TaskId id : finishedNow) {
+            complete(id);
+        }
+        finishedNow.clear();
+
+        if (succeeded && !readyMainTasks.empty()) {
+            auto next = std::ranges::min_element(readyMainTasks);
+            TaskId id = *next;
+            readyMainTasks.erase(next);
+            {
+                ProfileScope scope(m_nodes[id].m_name);
+                succeeded = m_nodes[id].m_task();
+            }
+            if (succeeded) {
+                complete(id);
+            }
+        }
+    }
+
+    // The Worker tasks still running reference the graph and the state above.
+    jobSystem.Wait(workerTasks);
+    return succeeded && !failed;
+}
+
+} // namespace Glitter::Core
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "core/JobSystem.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Glitter::Core {
+
+// A graph of tasks, each run as soon as the tasks it depends on are done: the Worker tasks in the job system's Frame lane, and the
+// Main tasks on the thread calling Run(), which is the only one the GL context is current on. Among the Main tasks that
+// are ready, the first added runs first. Each task is profiled as a scope named after it.
+//
+// The dependencies are either listed, or derived from the state each task declares it reads and writes, see Access, the
+// way the RenderGraph orders its passes by their resources.
+class TaskGraph {
+public:
+    using TaskId = size_t;
+    // Returns false when it failed, which stops the graph.
+    using Task = std::function<bool()>;
+
+    enum class TaskThread : std::uint8_t {
+        Worker,
+        Main,
+    };
+
+    // The state a task reads and writes, each identified by its address.
+    struct Access {
+        std::initializer_list<const void*> m_reads;
+        std::initializer_list<const void*> m_writes;
+    };
+
+    // `name` must be a string literal, and `dependencies` tasks added before.
+    TaskId Add(const char* name, TaskThread thread, Task task, std::initializer_list<TaskId> dependencies = {});
+    // Depends on the latest task added before with an Access that writes the state it reads or writes, and on the tasks
+    // added since that read the state it writes, so that the tasks touching disjoint state, or only reading the same,
+    // run concurrently.
+    TaskId Add(const char* name, TaskThread thread, Task task, const Access& access);
+
+    // Runs every task, and returns false as soon as one failed: the Worker tasks already running are waited for, and the
+    // tasks left are skipped.
+    bool Run(JobSystem& jobSystem);
+
+private:
+    struct Node {
+        const char* m_name;
+        TaskThread m_thread;
+        Task m_task;
+        size_t m_dependencyCount;
+        std::vector<TaskId> m_dependents;
+    };
+
+    // The tasks using a piece of state, as of the latest task added.
+    struct StateUse {
+        const void* m_state;
+        std::optional<TaskId> m_writer;
+        std::vector<TaskId> m_readers;
+    };
+
+    TaskId AddNode(const char* name, TaskThread thread, Task task, std::span<const TaskId> dependencies);
+    StateUse& GetStateUse(const void* state);
+
+    std::vector<Node> m_nodes;
+    std::vector<StateUse> m_stateUses;
+};
+
+} // namespace Glitter::Core
@@ -0,0 +1,217 @@
+#include "core/Telemetry.h"
+
+#include "core/CpuProfiler.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <format>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace Glitter::Core {
+
+namespace {
+
+    // How often the exporter's thread drains the queue between two exports, so that it only has to hold that long.
+    constexpr std::chrono::milliseconds DRAIN_PERIOD {250};
+
+#ifdef _WIN32
+    using SocketHandle = SOCKET;
+    constexpr SocketHandle INVALID_HANDLE = INVALID_SOCKET;
+
+    void CloseSocket(SocketHandle handle) { closesocket(handle); }
+#else
+    using SocketHandle = int;
+    constexpr SocketHandle INVALID_HANDLE = -1;
+
+    void CloseSocket(SocketHandle handle) { close(handle); }
+#endif
+
+    // A UDP socket connected to `address`, `<host>:<port>`.
+    std::optional<SocketHandle> ConnectSocket(const std::string& address)
+    {
+        size_t separator = address.rfind(':');
+        std::uint16_t port = 0;
+        if (separator == std::string::npos
+            || std::from_chars(address.data() + separator + 1, address.data() + address.size(), port).ec != std::errc {}) {
+            spdlog::error("Malformed telemetry address {}, expected <host>:<port>.", address);
+            return std::nullopt;
+        }
+        std::string host = address.substr(0, separator);
+
+#ifdef _WIN32
+        WSADATA data {};
+        if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+            spdlog::error("Failed to initialize Winsock for the telemetry.");
+            return std::nullopt;
+        }
+#endif
+        addrinfo hints {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_DGRAM;
+        addrinfo* results = nullptr;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &results) != 0 || !results) {
+            spdlog::error("Failed to resolve the telemetry address {}.", address);
+#ifdef _WIN32
+            WSACleanup();
+#endif
+            return std::nullopt;
+        }
+
+        std::optional<SocketHandle> connected;
+        for (addrinfo* result = results; result && !connected; result = result->ai_next) {
+            SocketHandle handle = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+            if (handle == INVALID_HANDLE) {
+                continue;
+            }
+            if (connect(handle, result->ai_addr, static_cast<int>(result->ai_addrlen)) == 0) {
+                connected = handle;
+            } else {
+                CloseSocket(handle);
+            }
+        }
+        freeaddrinfo(results);
+
+        if (!connected) {
+            spdlog::error("Failed to open a socket to the telemetry address {}.", address);
+#ifdef _WIN32
+            WSACleanup();
+#endif
+        }
+        return connected;
+    }
+
+    // `samples` must be sorted.
+    float Percentile(std::span<const float> samples, double percentile)
+    {
+        auto rank = static_cast<size_t>(percentile / 100.0 * static_cast<double>(samples.size() - 1) + 0.5);
+        return samples[std::min(rank, samples.size() - 1)];
+    }
+
+    // The StatsD gauges of `samples`, one per line.
+    std::string FormatGauges(std::span<const TelemetrySample> samples, std::uint64_t gpuMemoryBytes, size_t droppedCount)
+    {
+        std::vector<float> frameTimes;
+        frameTimes.reserve(samples.size());
+        double drawCalls = 0.0;
+        double triangles = 0.0;
+        double nodes = 0.0;
+        double culledNodes = 0.0;
+        for (const TelemetrySample& sample : samples) {
+            frameTimes.push_back(sample.m_frameMilliseconds);
+            drawCalls += sample.m_drawCalls;
+            triangles += static_cast<double>(sample.m_triangles);
+            nodes += sample.m_nodes;
+            culledNodes += sample.m_culledNodes;
+        }
+        std::ranges::sort(frameTimes);
+        auto count = static_cast<double>(samples.size());
+
+        constexpr std::string_view PREFIX = Config::TELEMETRY_PREFIX;
+        std::string gauges = std::format("{}.frames:{}|g\n", PREFIX, samples.size());
+        gauges += std::format("{}.frame_ms.p50:{:.3f}|g\n", PREFIX, Percentile(frameTimes, 50.0));
+        gauges += std::format("{}.frame_ms.p95:{:.3f}|g\n", PREFIX, Percentile(frameTimes, 95.0));
+        gauges += std::format("{}.frame_ms.p99:{:.3f}|g\n", PREFIX, Percentile(frameTimes, 99.0));
+        gauges += std::format("{}.frame_ms.max:{:.3f}|g\n", PREFIX, frameTimes.back());
+        gauges += std::format("{}.draw_calls:{:.1f}|g\n", PREFIX, drawCalls / count);
+        gauges += std::format("{}.triangles:{:.0f}|g\n", PREFIX, triangles / count);
+        gauges += std::format("{}.cull_ratio:{:.4f}|g\n", PREFIX, nodes > 0.0 ? culledNodes / nodes : 0.0);
+        gauges += std::format("{}.gpu_memory_bytes:{}|g\n", PREFIX, gpuMemoryBytes);
+        gauges += std::format("{}.dropped_samples:{}|g", PREFIX, droppedCount);
+        return gauges;
+    }
+
+} // namespace
+
+bool TelemetryExporter::Open(const std::string& address, GpuMemorySource gpuMemory)
+{
+    Close();
+
+    std::optional<SocketHandle> handle = ConnectSocket(address);
+    if (!handle) {
+        return false;
+    }
+    m_socket = static_cast<std::intptr_t>(*handle);
+    m_gpuMemory = std::move(gpuMemory);
+    m_running = true;
+    m_thread = std::thread([this] { ExporterMain(); });
+    spdlog::info("Exporting the telemetry to {} every {} s.", address, Config::TELEMETRY_INTERVAL);
+    return true;
+}
+
+void TelemetryExporter::Close()
+{
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::scoped_lock lock(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+    CloseSocket(static_cast<SocketHandle>(m_socket));
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    m_socket = -1;
+}
+
+void TelemetryExporter::Submit(const TelemetrySample& sample)
+{
+    if (!m_samples.TryPush(sample)) {
+        m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void TelemetryExporter::ExporterMain()
+{
+    SetProfileThreadName("Telemetry");
+
+    std::vector<TelemetrySample> samples;
+    auto exportTime = std::chrono::steady_clock::now() + std::chrono::duration<double>(Config::TELEMETRY_INTERVAL);
+    bool running = true;
+    while (running) {
+        {
+            std::unique_lock lock(m_mutex);
+            running = !m_condition.wait_for(lock, DRAIN_PERIOD, [this] { return !m_running; });
+        }
+        while (std::optional<TelemetrySample> sample = m_samples.TryPop()) {
+            samples.push_back(*sample);
+        }
+
+        // The samples left once closed are sent right away.
+        auto now = std::chrono::steady_clock::now();
+        if ((running && now < exportTime) || samples.empty()) {
+            continue;
+        }
+        exportTime = now + std::chrono::duration<double>(Config::TELEMETRY_INTERVAL);
+
+        std::uint64_t gpuMemoryBytes = m_gpuMemory ? m_gpuMemory() : 0;
+        std::string gauges = FormatGauges(samples, gpuMemoryBytes, m_droppedCount.load(std::memory_order_relaxed));
+        samples.clear();
+        auto sent = send(static_cast<SocketHandle>(m_socket), gauges.data(), static_cast<int>(gauges.size()), 0);
+        // UDP, the server may well be down for now.
+        if (sent < 0) {
+            spdlog::debug("Failed to send the telemetry.");
+        }
+    }
+}
+
+} // namespace Glitter::Core
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Config.h"
+#include "util/RingQueue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Glitter::Core {
+
+// The counters of a frame handed to the TelemetryExporter.
+struct TelemetrySample {
+    float m_frameMilliseconds;
+    std::uint32_t m_drawCalls;
+    std::uint64_t m_triangles;
+    std::uint32_t m_nodes;
+    std::uint32_t m_culledNodes;
+};
+
+// Exports the frames' counters to a StatsD server over UDP, from a thread of its own, so that the render thread only
+// pushes each frame's TelemetrySample into a lock-free queue. Every Config::TELEMETRY_INTERVAL seconds, the samples
+// queued since are sent as a single datagram of gauges: the frame time percentiles, the draw calls and triangles per
+// frame, the share of the Nodes culled and the GPU memory. The samples past Config::TELEMETRY_QUEUE_CAPACITY between two
+// drains of the thread are dropped, and counted.
+class TelemetryExporter {
+public:
+    // Returns the GPU memory allocated, in bytes, called from the exporter's thread.
+    using GpuMemorySource = std::function<std::uint64_t()>;
+
+    TelemetryExporter() = default;
+    ~TelemetryExporter() { Close(); }
+
+    TelemetryExporter(const TelemetryExporter&) = delete;
+    TelemetryExporter& operator=(const TelemetryExporter&) = delete;
+
+    // Starts exporting to `address`, `<host>:<port>`. Returns false, after logging why, if it can't be resolved.
+    bool Open(const std::string& address, GpuMemorySource gpuMemory);
+    // Sends the samples queued so far, and joins the exporter's thread.
+    void Close();
+    bool IsOpen() const { return m_thread.joinable(); }
+
+    // From the one thread rendering the frames, without locking.
+    void Submit(const TelemetrySample& sample);
+
+private:
+    void ExporterMain();
+
+    Util::SpscQueue<TelemetrySample> m_samples {Config::TELEMETRY_QUEUE_CAPACITY};
+    std::atomic<size_t> m_droppedCount {};
+    GpuMemorySource m_gpuMemory;
+    // A UDP socket connected to the StatsD server, an int on POSIX and a SOCKET on Windows.
+    std::intptr_t m_socket {-1};
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_running {};
+    std::thread m_thread;
+};
+
+} // namespace Glitter::Core
@@ -0,0 +1,125 @@
+#include "render/BatchCostSampler.h"
+
+#include <algorithm>
+
+namespace Glitter::Render {
+
+void BatchCostSampler::Release()
+{
+    for (Frame& frame : m_frames) {
+        glDeleteQueries(static_cast<GLsizei>(frame.m_queries.size()), frame.m_queries.data());
+        frame = Frame {};
+    }
+    Reset();
+}
+
+void BatchCostSampler::BeginFrame()
+{
+    m_currentFrame = (m_currentFrame + 1) % m_frames.size();
+    Frame& frame = m_frames[m_currentFrame];
+
+    ReadBack(frame);
+    frame.m_usedQueries = 0;
+    frame.m_samples.clear();
+
+    // Start past the batches sampled last frame, over again once they were all sampled.
+    m_previousBatchCount = m_batchCount;
+    m_batchCount = 0;
+    m_firstSampledBatch += Config::BATCH_COST_SAMPLED_BATCHES;
+    if (m_firstSampledBatch >= m_previousBatchCount) {
+        m_firstSampledBatch = 0;
+    }
+}
+
+bool BatchCostSampler::SampleBatch()
+{
+    if (!m_enabled) {
+        return false;
+    }
+    size_t batch = m_batchCount++;
+    return batch >= m_firstSampledBatch && batch < m_firstSampledBatch + Config::BATCH_COST_SAMPLED_BATCHES;
+}
+
+void BatchCostSampler::BeginSample()
+{
+    m_pendingBegin = IssueTimestamp(m_frames[m_currentFrame]);
+}
+
+void BatchCostSampler::EndSample(std::uint32_t meshID, std::uint64_t materialKey)
+{
+    Frame& frame = m_frames[m_currentFrame];
+    frame.m_samples.push_back(PendingSample {
+        .m_meshID = meshID, .m_materialKey = materialKey, .m_beginQuery = m_pendingBegin, .m_endQuery = IssueTimestamp(frame)});
+}
+
+std::vector<BatchCostSampler::Cost> BatchCostSampler::GetCostliest(BatchCostCategory category, size_t count) const
+{
+    const std::unordered_map<std::uint64_t, Cost>& costs = m_costs[static_cast<size_t>(category)];
+    std::vector<Cost> costliest {};
+    costliest.reserve(costs.size());
+    for (const auto& [key, cost] : costs) {
+        costliest.push_back(cost);
+    }
+
+    auto byAverage = [](const Cost& lhs, const Cost& rhs) { return lhs.m_averageMilliseconds > rhs.m_averageMilliseconds; };
+    count = std::min(count, costliest.size());
+    std::ranges::partial_sort(costliest, costliest.begin() + static_cast<std::ptrdiff_t>(count), byAverage);
+    costliest.resize(count);
+    return costliest;
+}
+
+void BatchCostSampler::Reset()
+{
+    for (std::unordered_map<std::uint64_t, Cost>& costs : m_costs) {
+        costs.clear();
+    }
+}
+
+size_t BatchCostSampler::IssueTimestamp(Frame& frame)
+{
+    if (frame.m_usedQueries == frame.m_queries.size()) {
+        GLuint query = 0;
+        glCreateQueries(GL_TIMESTAMP, 1, &query);
+        frame.m_queries.push_back(query);
+    }
+
+    size_t query = frame.m_usedQueries++;
+    glQueryCounter(frame.m_queries[query], GL_TIMESTAMP);
+    return query;
+}
+
+void BatchCostSampler::ReadBack(Frame& frame)
+{
+    if (frame.m_samples.empty()) {
+        return;
+    }
+
+    // As in the GpuProfiler, a frame whose last query isn't available yet is dropped rather than waited for.
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(frame.m_queries[frame.m_usedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE) {
+        return;
+    }
+
+    std::vector<GLuint64> timestamps(frame.m_usedQueries);
+    for (size_t query = 0; query < frame.m_usedQueries; query++) {
+        glGetQueryObjectui64v(frame.m_queries[query], GL_QUERY_RESULT, &timestamps[query]);
+    }
+
+    for (const PendingSample& sample : frame.m_samples) {
+        double milliseconds = static_cast<double>(timestamps[sample.m_endQuery] - timestamps[sample.m_beginQuery]) / 1e6;
+        Accumulate(m_costs[static_cast<size_t>(BatchCostCategory::Mesh)], sample.m_meshID, milliseconds);
+        Accumulate(m_costs[static_cast<size_t>(BatchCostCategory::Material)], sample.m_materialKey, milliseconds);
+    }
+}
+
+void BatchCostSampler::Accumulate(std::unordered_map<std::uint64_t, Cost>& costs, std::uint64_t key, double milliseconds)
+{
+    Cost& cost = costs[key];
+    cost.m_key = key;
+    cost.m_samples++;
+    cost.m_totalMilliseconds += milliseconds;
+    cost.m_averageMilliseconds = cost.m_totalMilliseconds / static_cast<double>(cost.m_samples);
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Config.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Glitter::Render {
+
+// What a batch's GPU cost is accumulated by.
+enum class BatchCostCategory : std::uint8_t {
+    // The Mesh ID of a run of draws.
+    Mesh,
+    // The program permutation and bound texture of a draw batch, see BatchCostSampler::GetMaterialKey().
+    Material,
+};
+
+// Samples the GPU cost of the draw batches, which the per-pass timings of the GpuProfiler don't break down. While
+// enabled, Config::BATCH_COST_SAMPLED_BATCHES batches per frame have each of their runs of draws of a single Mesh
+// submitted on their own between two GL_TIMESTAMP queries, the next batches every frame, so that every batch gets
+// sampled every few frames without timing them all in one. The costs accumulate per Mesh and per material until
+// Reset(). Like the GpuProfiler, the queries are read back Config::FRAMES_IN_FLIGHT frames later.
+//
+// Timestamps between draws of the same pass are approximate, as the GPU overlaps their work, so the costs rank the
+// batches rather than add up to the pass' time.
+class BatchCostSampler {
+public:
+    struct Cost {
+        std::uint64_t m_key;
+        std::uint64_t m_samples;
+        double m_totalMilliseconds;
+        double m_averageMilliseconds;
+    };
+
+    static constexpr std::uint64_t GetMaterialKey(std::uint32_t program, GLuint texture)
+    {
+        return (std::uint64_t {program} << 32) | texture;
+    }
+
+    void Release();
+
+    void SetEnabled(bool enabled) { m_enabled = enabled; }
+    bool IsEnabled() const { return m_enabled; }
+
+    // Reads back the samples of the oldest frame, if the GPU is done with it, and moves on to the next batches.
+    void BeginFrame();
+
+    // Counts a draw batch, and returns whether it's sampled this frame. Always false while disabled.
+    bool SampleBatch();
+    // Bracket a run of draws of the sampled batch.
+    void BeginSample();
+    void EndSample(std::uint32_t meshID, std::uint64_t materialKey);
+
+    // The `count` costliest keys of `category` on average per sample, costliest first.
+    std::vector<Cost> GetCostliest(BatchCostCategory category, size_t count) const;
+    void Reset();
+
+private:
+    struct PendingSample {
+        std::uint32_t m_meshID;
+        std::uint64_t m_materialKey;
+        size_t m_beginQuery;
+        size_t m_endQuery;
+    };
+
+    struct Frame {
+        std::vector<GLuint> m_queries;
+        size_t m_usedQueries {};
+        std::vector<PendingSample> m_samples;
+    };
+
+    size_t IssueTimestamp(Frame& frame);
+    void ReadBack(Frame& frame);
+    static void Accumulate(std::unordered_map<std::uint64_t, Cost>& costs, std::uint64_t key, double milliseconds);
+
+    bool m_enabled {};
+    std::array<Frame, Glitter::Config::FRAMES_IN_FLIGHT> m_frames {};
+    size_t m_currentFrame {};
+
+    // The index of the first batch sampled this frame, and the batches counted this frame and the previous one, which
+    // the index wraps around.
+    size_t m_firstSampledBatch {};
+    size_t m_batchCount {};
+    size_t m_previousBatchCount {};
+    size_t m_pendingBegin {};
+
+    std::array<std::unordered_map<std::uint64_t, Cost>, 2> m_costs;
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,189 @@
+#include "render/DebugDraw.h"
+
+#include "Config.h"
+#include "render/VertexLayout.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numbers>
+#include <optional>
+#include <thread>
+
+namespace Glitter::Render {
+
+namespace {
+
+    // Bumped by every Create(), so that the threads don't reuse the ThreadLines of a released DebugDraw.
+    std::atomic<std::uint64_t> s_generation {};
+
+    struct ThreadCache {
+        std::uint64_t m_generation;
+        void* m_lines;
+    };
+    thread_local ThreadCache t_cache {};
+
+} // namespace
+
+void DebugDraw::Create()
+{
+    m_generation = ++s_generation;
+    m_stream.Create(sizeof(DebugVertex) * Glitter::Config::DEBUG_DRAW_CAPACITY, alignof(DebugVertex), "Debug VBO Ring");
+
+    // The ring is attached before each draw, since it can be reallocated.
+    glCreateVertexArrays(1, &m_vao);
+    glObjectLabel(GL_VERTEX_ARRAY, m_vao, -1, "Debug VAO");
+    SetVertexFormat<DebugVertex>(m_vao, 0);
+}
+
+void DebugDraw::Release()
+{
+    m_stream.Release();
+    glDeleteVertexArrays(1, &m_vao);
+    m_vao = 0;
+
+    while (m_newThreads.TryPop()) {
+    }
+    m_threads.clear();
+}
+
+void DebugDraw::Line(const glm::vec3& a, const glm::vec3& b, const glm::vec4& color, DebugDepth depth)
+{
+    std::uint32_t packed = glm::packUnorm4x8(color);
+    std::vector<DebugVertex>& vertices = GetThreadLines().m_vertices[static_cast<size_t>(depth)];
+    vertices.push_back({.m_position = a, .m_color = packed});
+    vertices.push_back({.m_position = b, .m_color = packed});
+}
+
+void DebugDraw::Box(const glm::vec3& center, const glm::vec3& extent, const glm::vec4& color, DebugDepth depth)
+{
+    std::array<glm::vec3, 8> corners {};
+    for (size_t idx = 0; idx < corners.size(); idx++) {
+        glm::vec3 sign((idx & 1) != 0 ? 1.0f : -1.0f, (idx & 2) != 0 ? 1.0f : -1.0f, (idx & 4) != 0 ? 1.0f : -1.0f);
+        corners[idx] = center + extent * sign;
+    }
+
+    // Each corner links to the ones differing by a single axis.
+    for (size_t idx = 0; idx < corners.size(); idx++) {
+        for (size_t axis = 1; axis < corners.size(); axis <<= 1) {
+            if ((idx & axis) == 0) {
+                Line(corners[idx], corners[idx | axis], color, depth);
+            }
+        }
+    }
+}
+
+void DebugDraw::Sphere(const glm::vec3& center, float radius, const glm::vec4& color, DebugDepth depth)
+{
+    constexpr std::uint32_t SEGMENTS = Glitter::Config::DEBUG_SPHERE_SEGMENTS;
+    auto circle = [&](std::uint32_t segment, size_t axis) {
+        float angle = 2.0f * std::numbers::pi_v<float> * static_cast<float>(segment) / static_cast<float>(SEGMENTS);
+        glm::vec3 point(0.0f);
+        point[(axis + 1) % 3] = std::cos(angle) * radius;
+        point[(axis + 2) % 3] = std::sin(angle) * radius;
+        return center + point;
+    };
+
+    for (size_t axis = 0; axis < 3; axis++) {
+        for (std::uint32_t segment = 0; segment < SEGMENTS; segment++) {
+            Line(circle(segment, axis), circle(segment + 1, axis), color, depth);
+        }
+    }
+}
+
+void DebugDraw::Frustum(const glm::mat4& viewProjection, const glm::vec4& color, DebugDepth depth)
+{
+    glm::mat4 inverse = glm::inverse(viewProjection);
+    std::array<glm::vec3, 8> corners {};
+    for (size_t idx = 0; idx < corners.size(); idx++) {
+        glm::vec4 ndc((idx & 1) != 0 ? 1.0f : -1.0f, (idx & 2) != 0 ? 1.0f : -1.0f, (idx & 4) != 0 ? 1.0f : -1.0f, 1.0f);
+        glm::vec4 world = inverse * ndc;
+        corners[idx] = glm::vec3(world) / world.w;
+    }
+
+    for (size_t idx = 0; idx < corners.size(); idx++) {
+        for (size_t axis = 1; axis < corners.size(); axis <<= 1) {
+            if ((idx & axis) == 0) {
+                Line(corners[idx], corners[idx | axis], color, depth);
+            }
+        }
+    }
+}
+
+void DebugDraw::Submit(RenderStats& stats)
+{
+    while (std::optional<std::unique_ptr<ThreadLines>> lines = m_newThreads.TryPop()) {
+        m_threads.push_back(std::move(*lines));
+    }
+
+    m_vertexCount = 0;
+    for (const std::unique_ptr<ThreadLines>& lines : m_threads) {
+        for (const std::vector<DebugVertex>& vertices : lines->m_vertices) {
+            m_vertexCount += vertices.size();
+        }
+    }
+    m_counts = {};
+    if (m_vertexCount == 0) {
+        return;
+    }
+
+    std::span<std::byte> region = m_stream.BeginFrame();
+    if (sizeof(DebugVertex) * m_vertexCount > region.size()) {
+        region = m_stream.Grow(std::max(sizeof(DebugVertex) * m_vertexCount, m_stream.GetRegionSize() * 2));
+        spdlog::info("Grew the debug VBO ring regions to {} bytes.", m_stream.GetRegionSize());
+    }
+    m_submitted = true;
+
+    // Grouped by DebugDepth, so that each is drawn at once.
+    auto* regionVertices = reinterpret_cast<DebugVertex*>(region.data());
+    size_t written = 0;
+    for (size_t depth = 0; depth < DEPTH_COUNT; depth++) {
+        m_firsts[depth] = written;
+        for (const std::unique_ptr<ThreadLines>& lines : m_threads) {
+            std::vector<DebugVertex>& vertices = lines->m_vertices[depth];
+            std::ranges::copy(vertices, regionVertices + written);
+            written += vertices.size();
+            vertices.clear();
+        }
+        m_counts[depth] = written - m_firsts[depth];
+    }
+    stats.CountUpload(sizeof(DebugVertex) * m_vertexCount);
+}
+
+void DebugDraw::Draw(RenderStats& stats, DebugDepth depth) const
+{
+    auto depthIdx = static_cast<size_t>(depth);
+    if (m_counts[depthIdx] == 0) {
+        return;
+    }
+
+    stats.BindVertexArray(m_vao);
+    glVertexArrayVertexBuffer(m_vao, 0, m_stream.GetBuffer(), static_cast<GLintptr>(m_stream.GetRegionOffset()),
+        sizeof(DebugVertex));
+    glDrawArrays(GL_LINES, static_cast<GLint>(m_firsts[depthIdx]), static_cast<GLsizei>(m_counts[depthIdx]));
+    stats.CountDraw(1, 0);
+}
+
+void DebugDraw::EndFrame()
+{
+    // Only the frames that wrote a region fence it.
+    if (m_submitted) {
+        m_stream.EndFrame();
+        m_submitted = false;
+    }
+}
+
+DebugDraw::ThreadLines& DebugDraw::GetThreadLines()
+{
+    if (t_cache.m_generation != m_generation) {
+        auto lines = std::make_unique<ThreadLines>();
+        t_cache = {.m_generation = m_generation, .m_lines = lines.get()};
+        // Only full with more than Config::DEBUG_DRAW_MAX_NEW_THREADS threads drawing for the first time in a frame.
+        while (!m_newThreads.TryPush(std::move(lines))) {
+            std::this_thread::yield();
+        }
+    }
+    return *static_cast<ThreadLines*>(t_cache.m_lines);
+}
+
+} // namespace Glitter::Render
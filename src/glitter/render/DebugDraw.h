@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Config.h"
+#include "render/RenderStats.h"
+#include "render/StreamBuffer.h"
+#include "scene/VertexFormat.h"
+#include "util/RingQueue.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Glitter::Render {
+
+// Matches the attributes of DebugVS.glsl.
+struct DebugVertex {
+    glm::vec3 m_position;
+    // RGBA8, see glm::packUnorm4x8().
+    std::uint32_t m_color;
+};
+
+} // namespace Glitter::Render
+
+namespace Glitter::Scene {
+
+template <> struct VertexFormat<Render::DebugVertex> {
+    static constexpr std::array ATTRIBUTES {
+        VertexAttribute {.m_semantic = VertexSemantic::Position,
+            .m_type = VertexAttributeType::Float,
+            .m_componentCount = 3,
+            .m_offset = offsetof(Render::DebugVertex, m_position)},
+        VertexAttribute {.m_semantic = VertexSemantic::Color,
+            .m_type = VertexAttributeType::Unorm8,
+            .m_componentCount = 4,
+            .m_offset = offsetof(Render::DebugVertex, m_color)},
+    };
+};
+
+} // namespace Glitter::Scene
+
+namespace Glitter::Render {
+
+enum class DebugDepth : std::uint8_t {
+    // Hidden behind the scene's Nodes, and post-processed along with them.
+    Tested,
+    // Drawn over the presented frame.
+    Overlay,
+    Count,
+};
+
+// Immediate-mode debug lines, rebuilt every frame: lines, boxes, spheres and frustums of any color, either depth tested
+// against the scene or drawn over it. Any thread can add them, into a buffer of its own that Submit() merges, so the
+// culling jobs don't contend on a lock. Everything is drawn with a single draw per DebugDepth, from this frame's region
+// of a persistently-mapped ring grown on the frames that outgrow it.
+class DebugDraw {
+public:
+    void Create();
+    void Release();
+
+    void Line(const glm::vec3& a, const glm::vec3& b, const glm::vec4& color, DebugDepth depth = DebugDepth::Overlay);
+    // The 12 edges of the box of `center` and half-`extent`.
+    void Box(const glm::vec3& center, const glm::vec3& extent, const glm::vec4& color,
+        DebugDepth depth = DebugDepth::Overlay);
+    // Its 3 axis-aligned great circles, of Glitter::Config::DEBUG_SPHERE_SEGMENTS segments each.
+    void Sphere(const glm::vec3& center, float radius, const glm::vec4& color, DebugDepth depth = DebugDepth::Overlay);
+    // The 12 edges of the frustum of `viewProjection`, with GL's [-1, 1] clip depth.
+    void Frustum(const glm::mat4& viewProjection, const glm::vec4& color, DebugDepth depth = DebugDepth::Overlay);
+
+    // Merges the lines every thread added since the previous Submit() into this frame's region, and clears them. No
+    // thread may add lines while it runs.
+    void Submit(RenderStats& stats);
+    // Draws the `depth` lines of the latest Submit() with the bound debug program, into the bound framebuffer.
+    void Draw(RenderStats& stats, DebugDepth depth) const;
+    // Fences this frame's region, once every draw reading it has been issued.
+    void EndFrame();
+
+    // Lines may only be added once it's created.
+    bool IsCreated() const { return m_vao != 0; }
+    bool IsEmpty(DebugDepth depth) const { return m_counts[static_cast<size_t>(depth)] == 0; }
+    size_t GetVertexCount() const { return m_vertexCount; }
+
+private:
+    static constexpr size_t DEPTH_COUNT = static_cast<size_t>(DebugDepth::Count);
+
+    // Only written by its thread, until Submit().
+    struct ThreadLines {
+        std::array<std::vector<DebugVertex>, DEPTH_COUNT> m_vertices;
+    };
+
+    ThreadLines& GetThreadLines();
+
+    StreamBuffer m_stream;
+    GLuint m_vao {};
+    bool m_submitted {};
+
+    // Told apart from any previous DebugDraw by each thread's cached ThreadLines.
+    std::uint64_t m_generation {};
+    // Registered by their thread through m_newThreads, without a lock, and only ever read by Submit(), which moves them
+    // into m_threads.
+    Util::MpscQueue<std::unique_ptr<ThreadLines>> m_newThreads {Config::DEBUG_DRAW_MAX_NEW_THREADS};
+    std::vector<std::unique_ptr<ThreadLines>> m_threads;
+
+    // The first vertex and count of each DebugDepth's lines in the current region.
+    std::array<size_t, DEPTH_COUNT> m_firsts {};
+    std::array<size_t, DEPTH_COUNT> m_counts {};
+    size_t m_vertexCount {};
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,60 @@
+#include "render/DepthPrepass.h"
+
+#include <algorithm>
+
+namespace Glitter::Render {
+
+void DepthPrepass::Create()
+{
+    for (Frame& frame : m_frames) {
+        glCreateQueries(GL_SAMPLES_PASSED, 1, &frame.m_query);
+    }
+}
+
+void DepthPrepass::Release()
+{
+    for (Frame& frame : m_frames) {
+        glDeleteQueries(1, &frame.m_query);
+        frame = Frame {};
+    }
+}
+
+void DepthPrepass::BeginFrame()
+{
+    m_currentFrame = (m_currentFrame + 1) % m_frames.size();
+    Frame& frame = m_frames[m_currentFrame];
+    if (!frame.m_pending) {
+        return;
+    }
+    frame.m_pending = false;
+
+    // Keep the previous overdraw rather than waiting for the GPU.
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(frame.m_query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE) {
+        return;
+    }
+
+    GLuint64 samples = 0;
+    glGetQueryObjectui64v(frame.m_query, GL_QUERY_RESULT, &samples);
+    m_overdraw = static_cast<float>(static_cast<double>(samples) / static_cast<double>(std::max(frame.m_pixels, 1)));
+
+    // Only switch past either threshold, so that a scene around one doesn't toggle the pre-pass every frame.
+    if (m_overdraw > Glitter::Config::DEPTH_PREPASS_ENABLE_OVERDRAW) {
+        m_autoEnabled = true;
+    } else if (m_overdraw < Glitter::Config::DEPTH_PREPASS_DISABLE_OVERDRAW) {
+        m_autoEnabled = false;
+    }
+}
+
+void DepthPrepass::BeginQuery() { glBeginQuery(GL_SAMPLES_PASSED, m_frames[m_currentFrame].m_query); }
+
+void DepthPrepass::EndQuery(GLsizei width, GLsizei height)
+{
+    glEndQuery(GL_SAMPLES_PASSED);
+    Frame& frame = m_frames[m_currentFrame];
+    frame.m_pixels = width * height;
+    frame.m_pending = true;
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Config.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstdint>
+
+namespace Glitter::Render {
+
+enum class DepthPrepassMode : std::uint8_t {
+    Off,
+    On,
+    // Enabled while the measured overdraw makes it worth it.
+    Auto,
+};
+
+// Measures the overdraw of the opaque Nodes as the GL_SAMPLES_PASSED of the pass writing their depth per pixel, read
+// back Glitter::Config::FRAMES_IN_FLIGHT frames later so that it never stalls. Drawn front-to-back, the samples passing
+// the depth test of the opaque color pass without a pre-pass are the ones passing it in the pre-pass, so the measure
+// holds whichever of them writes the depth, and picks whether the pre-pass is worth it.
+class DepthPrepass {
+public:
+    void Create();
+    void Release();
+
+    // Reads back the oldest frame's samples, if the GPU is done with them, and updates whether DepthPrepassMode::Auto
+    // enables the pre-pass.
+    void BeginFrame();
+
+    // Around the draws writing the opaque depth into a `width` by `height` viewport.
+    void BeginQuery();
+    void EndQuery(GLsizei width, GLsizei height);
+
+    bool IsEnabled(DepthPrepassMode mode) const
+    {
+        return mode == DepthPrepassMode::On || (mode == DepthPrepassMode::Auto && m_autoEnabled);
+    }
+    // Opaque fragments passing the depth test per pixel, of the latest frame read back.
+    float GetOverdraw() const { return m_overdraw; }
+
+private:
+    struct Frame {
+        GLuint m_query;
+        GLsizei m_pixels;
+        bool m_pending;
+    };
+
+    std::array<Frame, Glitter::Config::FRAMES_IN_FLIGHT> m_frames {};
+    size_t m_currentFrame {};
+    float m_overdraw {};
+    bool m_autoEnabled {};
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Glitter::Render {
+
+// Draw pass, in submission order. Occupies the top bits of a draw key so that every pass sorts contiguously.
+enum class DrawPass : std::uint8_t {
+    Opaque,
+    Transparent,
+    WeightedTransparent,
+};
+
+// Packed 64-bit draw keys, sorted ascending:
+//   Opaque:              | pass:2 | program:6 | texture:16 | mesh:16 | depth:24 |
+//   Transparent:         | pass:2 | ~depth:24 | program:6 | texture:16 | mesh:16 |
+//   WeightedTransparent: | pass:2 | program:6 | texture:16 | mesh:16 | 0:24     |
+// Opaque draws are grouped by state, most expensive change first, and then coarsely ordered front-to-back. Transparent
+// draws are strictly ordered back-to-front and only use the state bits to break ties. Weighted blended transparency
+// doesn't depend on the order, so its draws are only grouped by state.
+namespace DrawKey {
+    constexpr unsigned DEPTH_BITS = 24;
+    constexpr std::uint32_t DEPTH_MAX = (1u << DEPTH_BITS) - 1;
+
+    // Quantizes a view depth in [0, farPlane] to DEPTH_BITS.
+    inline std::uint32_t QuantizeDepth(float depth, float farPlane)
+    {
+        float normalized = depth / farPlane;
+        normalized = normalized < 0.0f ? 0.0f : (normalized > 1.0f ? 1.0f : normalized);
+        return static_cast<std::uint32_t>(normalized * static_cast<float>(DEPTH_MAX));
+    }
+
+    constexpr std::uint64_t Opaque(std::uint32_t program, std::uint32_t mesh, std::uint32_t texture, std::uint32_t depth)
+    {
+        return (static_cast<std::uint64_t>(DrawPass::Opaque) << 62) | (static_cast<std::uint64_t>(program & 0x3F) << 56)
+            | (static_cast<std::uint64_t>(texture & 0xFFFF) << 40) | (static_cast<std::uint64_t>(mesh & 0xFFFF) << 24)
+            | (depth & DEPTH_MAX);
+    }
+
+    constexpr std::uint64_t Transparent(std::uint32_t program, std::uint32_t mesh, std::uint32_t texture, std::uint32_t depth)
+    {
+        return (static_cast<std::uint64_t>(DrawPass::Transparent) << 62)
+            | (static_cast<std::uint64_t>(~depth & DEPTH_MAX) << 38) | (static_cast<std::uint64_t>(program & 0x3F) << 32)
+            | (static_cast<std::uint64_t>(texture & 0xFFFF) << 16) | (mesh & 0xFFFF);
+    }
+
+    constexpr std::uint64_t WeightedTransparent(std::uint32_t program, std::uint32_t mesh, std::uint32_t texture)
+    {
+        return (static_cast<std::uint64_t>(DrawPass::WeightedTransparent) << 62)
+            | (static_cast<std::uint64_t>(program & 0x3F) << 56) | (static_cast<std::uint64_t>(texture & 0xFFFF) << 40)
+            | (static_cast<std::uint64_t>(mesh & 0xFFFF) << 24);
+    }
+
+    constexpr DrawPass GetPass(std::uint64_t key) { return static_cast<DrawPass>(key >> 62); }
+
+    constexpr std::uint32_t GetProgram(std::uint64_t key)
+    {
+        return static_cast<std::uint32_t>(key >> (GetPass(key) == DrawPass::Transparent ? 32 : 56)) & 0x3F;
+    }
+} // namespace DrawKey
+
+} // namespace Glitter::Render
@@ -0,0 +1,235 @@
+#include "render/FramePacer.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+
+namespace Glitter::Render {
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // Sleeps until Config::FRAME_LIMITER_SPIN_TIME before `deadline`, since sleeping overshoots by up to the scheduler's
+    // granularity, and spins the rest of the way.
+    void SleepUntil(Clock::time_point deadline)
+    {
+        auto spinTime = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(Glitter::Config::FRAME_LIMITER_SPIN_TIME));
+        Clock::time_point now = Clock::now();
+        if (deadline - now > spinTime) {
+            std::this_thread::sleep_for(deadline - now - spinTime);
+        }
+        while (Clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+    }
+
+} // namespace
+
+void FramePacer::Create()
+{
+    Release();
+
+    for (Frame& frame : m_frames) {
+        glCreateQueries(GL_TIMESTAMP, 1, &frame.m_query);
+    }
+    m_swapControlTear = glfwExtensionSupported("WGL_EXT_swap_control_tear") == GLFW_TRUE
+        || glfwExtensionSupported("GLX_EXT_swap_control_tear") == GLFW_TRUE;
+    m_frameStart = std::chrono::steady_clock::now();
+
+    // The windows are on the primary monitor, or on one with about the same refresh rate.
+    const GLFWvidmode* videoMode = glfwGetPrimaryMonitor() ? glfwGetVideoMode(glfwGetPrimaryMonitor()) : nullptr;
+    m_refreshPeriod = 1.0 / (videoMode && videoMode->refreshRate > 0 ? videoMode->refreshRate : 60);
+}
+
+void FramePacer::Release()
+{
+    for (Frame& frame : m_frames) {
+        glDeleteSync(frame.m_fence);
+        glDeleteQueries(1, &frame.m_query);
+        frame = Frame {};
+    }
+    m_frameCount = 0;
+    m_presentModeApplied = false;
+    m_frameDelay = 0.0;
+    m_lastFinishedFrame = SIZE_MAX;
+    m_delayHold = 0;
+    m_delayHoldLength = 1;
+}
+
+void FramePacer::BeginFrame(const FramePacingSettings& settings)
+{
+    if (!m_presentModeApplied || settings.m_presentMode != m_presentMode) {
+        ApplyPresentMode(settings.m_presentMode);
+    }
+
+    // Only the vsync modes have a refresh to make just in time.
+    bool justInTime = settings.m_sync == FrameSync::JustInTime
+        && (settings.m_presentMode == PresentMode::VSync || settings.m_presentMode == PresentMode::AdaptiveVSync);
+    if (justInTime != m_justInTime) {
+        m_justInTime = justInTime;
+        m_frameDelay = 0.0;
+        m_delayHold = 0;
+        m_delayHoldLength = 1;
+    }
+
+    // Wait for the frame ended `m_maxFramesInFlight` frames ago, so that at most that many are queued once this one is.
+    size_t maxFramesInFlight = std::clamp<size_t>(settings.m_maxFramesInFlight, 1, m_frames.size());
+    if (settings.m_sync == FrameSync::JustInTime) {
+        maxFramesInFlight = m_frameDelay > 0.0 ? 1 : 2;
+    }
+    if ((settings.m_sync == FrameSync::Fence || settings.m_sync == FrameSync::JustInTime) && m_frameCount >= maxFramesInFlight) {
+        Frame& frame = m_frames[(m_frameCount - maxFramesInFlight) % m_frames.size()];
+        if (frame.m_fence) {
+            // Flush on the first wait, in case the fence hasn't been submitted yet.
+            GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            while (glClientWaitSync(frame.m_fence, waitFlags, 1'000'000) == GL_TIMEOUT_EXPIRED) {
+                waitFlags = 0;
+            }
+        }
+    }
+
+    // The delay adapts to the frames read back by now, which hold the previous one once it's the only one queued.
+    ReadLatencies();
+
+    if (settings.m_presentMode == PresentMode::Limited) {
+        WaitForFrameLimit(settings.m_frameLimit);
+    } else if (m_justInTime && m_frameDelay > 0.0) {
+        SleepUntil(Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_frameDelay)));
+        m_frameStart = Clock::now();
+    } else {
+        m_frameStart = Clock::now();
+    }
+    m_frameBeginTime = glfwGetTime();
+}
+
+void FramePacer::EndFrame(const FramePacingSettings& settings, double inputTime)
+{
+    // A frame the GPU still hasn't finished by now is dropped from the latencies.
+    Frame& frame = m_frames[m_frameCount % m_frames.size()];
+    glDeleteSync(frame.m_fence);
+    glQueryCounter(frame.m_query, GL_TIMESTAMP);
+    frame.m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frame.m_inputTime = inputTime;
+    frame.m_pending = true;
+    m_frameCount++;
+
+    // Follows the frame time up at once, and down slowly, so that a single quick frame doesn't let the delay eat into
+    // the slower ones' time.
+    double cpuTime = glfwGetTime() - m_frameBeginTime;
+    m_cpuTime = std::max(cpuTime, std::lerp(m_cpuTime, cpuTime, 0.05));
+
+    if (settings.m_sync == FrameSync::Finish) {
+        glFinish();
+    }
+}
+
+double FramePacer::GetAverageLatency() const
+{
+    size_t count = std::min(m_latencyCount, m_latencyHistory.size());
+    if (count == 0) {
+        return 0.0;
+    }
+    return std::accumulate(m_latencyHistory.begin(), m_latencyHistory.begin() + static_cast<std::ptrdiff_t>(count), 0.0)
+        / static_cast<double>(count);
+}
+
+void FramePacer::ApplyPresentMode(PresentMode mode)
+{
+    m_presentMode = mode;
+    m_presentModeApplied = true;
+    switch (mode) {
+    case PresentMode::VSync:
+        glfwSwapInterval(1);
+        break;
+    case PresentMode::AdaptiveVSync:
+        if (!m_swapControlTear) {
+            spdlog::warn("Adaptive vsync isn't supported, using vsync instead.");
+        }
+        glfwSwapInterval(m_swapControlTear ? -1 : 1);
+        break;
+    case PresentMode::Uncapped:
+    case PresentMode::Limited:
+        glfwSwapInterval(0);
+        break;
+    }
+}
+
+void FramePacer::ReadLatencies()
+{
+    // Map the GPU's timestamps onto glfwGetTime(), from both clocks' current time.
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    double cpuNow = glfwGetTime();
+
+    // Oldest first, so that the latest frame read back is the one shown.
+    for (size_t age = m_frames.size(); age > 0; age--) {
+        if (m_frameCount < age) {
+            continue;
+        }
+        Frame& frame = m_frames[(m_frameCount - age) % m_frames.size()];
+        if (!frame.m_pending) {
+            continue;
+        }
+
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(frame.m_query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_FALSE) {
+            continue;
+        }
+        frame.m_pending = false;
+
+        GLuint64 finished = 0;
+        glGetQueryObjectui64v(frame.m_query, GL_QUERY_RESULT, &finished);
+        double finishedTime = cpuNow - static_cast<double>(gpuNow - static_cast<GLint64>(finished)) / 1e9;
+        m_latency = std::max(finishedTime - frame.m_inputTime, 0.0) * 1000.0;
+        m_latencyHistory[m_latencyCount % m_latencyHistory.size()] = m_latency;
+        m_latencyCount++;
+
+        if (m_justInTime) {
+            UpdateFrameDelay(m_frameCount - age, finishedTime);
+        }
+    }
+}
+
+void FramePacer::UpdateFrameDelay(size_t frameIdx, double finishedTime)
+{
+    // Only a frame finished right after the previous one tells whether it made its refresh.
+    bool consecutive = m_lastFinishedFrame != SIZE_MAX && frameIdx == m_lastFinishedFrame + 1;
+    double interval = finishedTime - m_lastFinishedTime;
+    m_lastFinishedFrame = frameIdx;
+    m_lastFinishedTime = finishedTime;
+    if (!consecutive) {
+        return;
+    }
+
+    if (interval > m_refreshPeriod * 1.5) {
+        m_frameDelay = m_frameDelay / 2.0 < Glitter::Config::FRAME_DELAY_STEP ? 0.0 : m_frameDelay / 2.0;
+        m_delayHold = m_delayHoldLength;
+        m_delayHoldLength = std::min(m_delayHoldLength * 2, Glitter::Config::FRAME_DELAY_MAX_HOLD);
+    } else if (m_delayHold > 0) {
+        m_delayHold--;
+    } else {
+        double maxDelay = std::max(m_refreshPeriod - m_cpuTime - Glitter::Config::FRAME_DELAY_MARGIN, 0.0);
+        m_frameDelay = std::min(m_frameDelay + Glitter::Config::FRAME_DELAY_STEP, maxDelay);
+    }
+}
+
+void FramePacer::WaitForFrameLimit(double frameLimit)
+{
+    auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / std::max(frameLimit, 1.0)));
+    Clock::time_point deadline = m_frameStart + period;
+
+    Clock::time_point now = Clock::now();
+    SleepUntil(deadline);
+
+    // Keep the cadence of the frames on time, a late one restarts it.
+    m_frameStart = std::max(deadline, now);
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Config.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Glitter::Render {
+
+enum class PresentMode : std::uint8_t {
+    // Swaps on the vertical blank, at the display's refresh rate.
+    VSync,
+    // Swaps on the vertical blank, unless the frame missed it and then tears instead of waiting for the next one. Falls
+    // back to VSync without EXT_swap_control_tear.
+    AdaptiveVSync,
+    Uncapped,
+    // Uncapped, with each frame held back until FramePacingSettings::m_frameLimit allows it.
+    Limited,
+};
+
+enum class FrameSync : std::uint8_t {
+    // Up to Config::FRAMES_IN_FLIGHT frames queued, as the stream buffers allow.
+    None,
+    // Up to FramePacingSettings::m_maxFramesInFlight frames queued, by waiting on the fence of the oldest one.
+    Fence,
+    // glFinish() after each swap, so that the CPU never runs ahead of the GPU.
+    Finish,
+    // A single frame queued, started as late as it can be while still making the display's next refresh, with vsync. See
+    // FramePacer.
+    JustInTime,
+};
+
+struct FramePacingSettings {
+    PresentMode m_presentMode {PresentMode::VSync};
+    // Frames per second, with PresentMode::Limited.
+    double m_frameLimit {Glitter::Config::FRAME_LIMIT_RATE};
+    FrameSync m_sync {FrameSync::None};
+    // In [1, Config::FRAMES_IN_FLIGHT], with FrameSync::Fence.
+    size_t m_maxFramesInFlight {Glitter::Config::FRAMES_IN_FLIGHT};
+
+    bool operator==(const FramePacingSettings&) const = default;
+};
+
+// Paces the frames by their presentation mode, frame limit and frames in flight, and measures the latency from when
+// each frame's input was sampled to when the GPU finished it. The display's scanout comes after that, so the actual
+// input-to-photon latency is that plus up to a refresh with vsync.
+//
+// The frame limiter sleeps until Config::FRAME_LIMITER_SPIN_TIME before each frame is due, and spins the rest of the way
+// since sleeping overshoots by up to the scheduler's granularity. A frame running late starts the next period, rather
+// than the following frames catching up on it.
+//
+// With FrameSync::JustInTime and vsync, each frame waits for the previous one to finish on the GPU, then is delayed by as
+// much as the frames before it had to spare. The delay grows by Config::FRAME_DELAY_STEP for every frame finishing a
+// refresh after the previous one, up to the refresh period minus the CPU's frame time and Config::FRAME_DELAY_MARGIN, and
+// is halved by every frame missing its refresh. After a miss it's held for a while, twice as long as after the previous
+// miss, up to Config::FRAME_DELAY_MAX_HOLD frames. While it's held at 0, two frames are queued so that the CPU and the GPU
+// still work side by side.
+class FramePacer {
+public:
+    void Create();
+    void Release();
+
+    // Before the frame's input is sampled, so that it's as recent as possible: applies `settings`' swap interval when it
+    // changed, waits for the frame limit or the frames in flight, and reads back the latency of the frames the GPU
+    // finished.
+    void BeginFrame(const FramePacingSettings& settings);
+    // After the frame's swap: timestamps it with `inputTime`, the glfwGetTime() its input was sampled at.
+    void EndFrame(const FramePacingSettings& settings, double inputTime);
+
+    // Milliseconds, of the latest frame read back and averaged over the last Config::LATENCY_HISTORY_SIZE.
+    double GetLatency() const { return m_latency; }
+    double GetAverageLatency() const;
+    // Milliseconds the latest frame's start was delayed by, with FrameSync::JustInTime.
+    double GetFrameDelay() const { return m_frameDelay * 1000.0; }
+
+private:
+    struct Frame {
+        GLsync m_fence;
+        // GL_TIMESTAMP once the GPU finished the frame.
+        GLuint m_query;
+        double m_inputTime;
+        bool m_pending;
+    };
+
+    void ApplyPresentMode(PresentMode mode);
+    void ReadLatencies();
+    void WaitForFrameLimit(double frameLimit);
+    // Grows or shrinks m_frameDelay by whether the frame that finished at `finishedTime` made the refresh after the
+    // previous one.
+    void UpdateFrameDelay(size_t frameIdx, double finishedTime);
+
+    std::array<Frame, Glitter::Config::FRAMES_IN_FLIGHT> m_frames {};
+    // Frames ended since Create().
+    size_t m_frameCount {};
+
+    bool m_presentModeApplied {};
+    PresentMode m_presentMode {};
+    bool m_swapControlTear {};
+    std::chrono::steady_clock::time_point m_frameStart {};
+
+    // Whether the latest frame was paced just in time. Seconds of the display's refresh, and of the just-in-time frames'
+    // delay, the CPU's time from a frame's start to its end, and when the latest frame finished in order, with its index.
+    bool m_justInTime {};
+    double m_refreshPeriod {};
+    double m_frameDelay {};
+    double m_cpuTime {};
+    double m_frameBeginTime {};
+    double m_lastFinishedTime {};
+    size_t m_lastFinishedFrame {SIZE_MAX};
+    // The frames the delay is held for since the latest miss, and for after the next one.
+    size_t m_delayHold {};
+    size_t m_delayHoldLength {1};
+
+    double m_latency {};
+    std::array<double, Glitter::Config::LATENCY_HISTORY_SIZE> m_latencyHistory {};
+    size_t m_latencyCount {};
+};
+
+} // namespace Glitter::Render
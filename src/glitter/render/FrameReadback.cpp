@@ -0,0 +1,94 @@
+#include "render/FrameReadback.h"
+
+#include "render/GpuMemory.h"
+
+namespace Glitter::Render {
+
+void FrameReadback::Release()
+{
+    for (Slot& slot : m_slots) {
+        if (slot.m_fence) {
+            glDeleteSync(slot.m_fence);
+        }
+        DeleteBuffers(1, &slot.m_buffer);
+        slot = {};
+    }
+    m_next = 0;
+    m_pendingCount = 0;
+}
+
+bool FrameReadback::Request(GLuint fbo, GLenum readBuffer, GLsizei width, GLsizei height, std::uint64_t frame)
+{
+    if (IsFull()) {
+        return false;
+    }
+
+    // Read into client-side storage when the driver can, since only the CPU reads these buffers.
+    Slot& slot = m_slots[m_next];
+    auto size = static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+    if (size > slot.m_capacity) {
+        DeleteBuffers(1, &slot.m_buffer);
+        glCreateBuffers(1, &slot.m_buffer);
+        NamedBufferStorage(GpuMemoryCategory::StreamBuffer, slot.m_buffer, static_cast<GLsizeiptr>(size), nullptr,
+            GL_MAP_READ_BIT | GL_CLIENT_STORAGE_BIT);
+        glObjectLabel(GL_BUFFER, slot.m_buffer, -1, "Frame Readback Buffer");
+        slot.m_capacity = size;
+    }
+
+    // With a pack buffer bound, glReadPixels() only queues the copy and returns.
+    glNamedFramebufferReadBuffer(fbo, readBuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.m_buffer);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    slot.m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.m_frame = frame;
+    slot.m_width = width;
+    slot.m_height = height;
+    m_next = (m_next + 1) % m_slots.size();
+    m_pendingCount++;
+    return true;
+}
+
+void FrameReadback::Poll(const Consume& consume, bool waitForOldest)
+{
+    while (m_pendingCount > 0) {
+        Slot& slot = m_slots[(m_next + m_slots.size() - m_pendingCount) % m_slots.size()];
+        if (waitForOldest) {
+            // Flush on the first wait, in case the fence hasn't been submitted yet.
+            GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            while (glClientWaitSync(slot.m_fence, waitFlags, 1'000'000) == GL_TIMEOUT_EXPIRED) {
+                waitFlags = 0;
+            }
+            waitForOldest = false;
+        } else {
+            GLenum status = glClientWaitSync(slot.m_fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+                return;
+            }
+        }
+        glDeleteSync(slot.m_fence);
+        slot.m_fence = nullptr;
+        m_pendingCount--;
+
+        auto size = static_cast<size_t>(slot.m_width) * static_cast<size_t>(slot.m_height) * 4;
+        const auto* pixels = static_cast<const std::byte*>(
+            glMapNamedBufferRange(slot.m_buffer, 0, static_cast<GLsizeiptr>(size), GL_MAP_READ_BIT));
+        if (pixels) {
+            consume(ReadbackImage {
+                .m_frame = slot.m_frame, .m_width = slot.m_width, .m_height = slot.m_height, .m_pixels = {pixels, size}});
+            glUnmapNamedBuffer(slot.m_buffer);
+        }
+    }
+}
+
+void FrameReadback::Flush(const Consume& consume)
+{
+    while (m_pendingCount > 0) {
+        Poll(consume, true);
+    }
+}
+
+} // namespace Glitter::Render
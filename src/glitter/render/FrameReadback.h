@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Config.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+namespace Glitter::Render {
+
+// A frame read back by FrameReadback, as RGBA8 rows from the bottom one up like GL returns them.
+struct ReadbackImage {
+    std::uint64_t m_frame;
+    GLsizei m_width;
+    GLsizei m_height;
+    std::span<const std::byte> m_pixels;
+};
+
+// Reads frames back from the GPU without stalling it: each request glReadPixels() into a pixel pack buffer of a ring of
+// Glitter::Config::FRAMES_IN_FLIGHT, fenced, and the buffer is only mapped once its fence has signaled, frames later.
+// Requests made while every buffer of the ring is still in flight are refused.
+class FrameReadback {
+public:
+    using Consume = std::function<void(const ReadbackImage& image)>;
+
+    void Release();
+
+    // The buffer the next Request() copies into, e.g. to declare the copy's pass to the RenderGraph. 0 until then.
+    GLuint GetNextBuffer() const { return m_slots[m_next].m_buffer; }
+    bool IsFull() const { return m_pendingCount == m_slots.size(); }
+    size_t GetPendingCount() const { return m_pendingCount; }
+
+    // Queues a copy of the `width` by `height` pixels at the origin of `readBuffer` of `fbo`, tagged with `frame`.
+    // Returns false if the ring is full.
+    bool Request(GLuint fbo, GLenum readBuffer, GLsizei width, GLsizei height, std::uint64_t frame);
+
+    // Hands every copy the GPU has finished to `consume`, oldest first, without waiting for the others. When `waitForOldest`
+    // is set, the oldest is waited for instead of skipped. The pixels are only valid during the call.
+    void Poll(const Consume& consume, bool waitForOldest = false);
+    // Waits for and hands back every pending copy, e.g. before quitting.
+    void Flush(const Consume& consume);
+
+private:
+    struct Slot {
+        GLuint m_buffer;
+        size_t m_capacity;
+        GLsync m_fence;
+        std::uint64_t m_frame;
+        GLsizei m_width;
+        GLsizei m_height;
+    };
+
+    std::array<Slot, Glitter::Config::FRAMES_IN_FLIGHT> m_slots {};
+    // The slot of the next request, and the count of slots before it still in flight.
+    size_t m_next {};
+    size_t m_pendingCount {};
+};
+
+} // namespace Glitter::Render
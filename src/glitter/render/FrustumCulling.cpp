@@ -0,0 +1,590 @@
+#include "render/FrustumCulling.h"
+
+#include "Config.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#if defined(GLITTER_SIMD_X86)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace Glitter::Render {
+
+FrustumPlanes ExtractFrustumPlanes(const glm::mat4& vp)
+{
+    // Each plane is the 4th row of the VP matrix plus or minus one of the other rows.
+    glm::vec4 row0 {vp[0][0], vp[1][0], vp[2][0], vp[3][0]};
+    glm::vec4 row1 {vp[0][1], vp[1][1], vp[2][1], vp[3][1]};
+    glm::vec4 row2 {vp[0][2], vp[1][2], vp[2][2], vp[3][2]};
+    glm::vec4 row3 {vp[0][3], vp[1][3], vp[2][3], vp[3][3]};
+
+    return {
+        row3 + row0, // Left.
+        row3 - row0, // Right.
+        row3 + row1, // Bottom.
+        row3 - row1, // Top.
+        row3 + row2, // Near.
+        row3 - row2, // Far.
+    };
+}
+
+FrustumPlanes CombineStereoFrustums(const FrustumPlanes& leftEye, const FrustumPlanes& rightEye)
+{
+    FrustumPlanes planes = leftEye;
+    planes[1] = rightEye[1];
+    return planes;
+}
+
+FrustumPlanes GrowFrustumPlanes(const FrustumPlanes& planes, float distance)
+{
+    // The planes aren't normalized, so the distance is scaled by the length of their normal.
+    FrustumPlanes grown = planes;
+    for (Plane& plane : grown) {
+        plane.w += distance * glm::length(glm::vec3(plane));
+    }
+    return grown;
+}
+
+glm::vec4 BoundFrustums(std::span<const glm::mat4> viewProjections)
+{
+    // The corners of each frustum are the corners of the NDC cube taken back into World Space.
+    std::vector<glm::vec3> corners;
+    corners.reserve(viewProjections.size() * 8);
+    for (const glm::mat4& vp : viewProjections) {
+        glm::mat4 inverseViewProjection = glm::inverse(vp);
+        for (int cornerIdx = 0; cornerIdx < 8; cornerIdx++) {
+            glm::vec4 ndc((cornerIdx & 1) ? 1.0f : -1.0f, (cornerIdx & 2) ? 1.0f : -1.0f, (cornerIdx & 4) ? 1.0f : -1.0f, 1.0f);
+            glm::vec4 corner = inverseViewProjection * ndc;
+            corners.push_back(glm::vec3(corner) / corner.w);
+        }
+    }
+    if (corners.empty()) {
+        return glm::vec4(0.0f);
+    }
+
+    // Centered on the corners' bounding box, which is close enough to the smallest sphere for a coarse pre-test.
+    glm::vec3 cornerMin = corners.front();
+    glm::vec3 cornerMax = corners.front();
+    for (const glm::vec3& corner : corners) {
+        cornerMin = glm::min(cornerMin, corner);
+        cornerMax = glm::max(cornerMax, corner);
+    }
+    glm::vec3 center = (cornerMin + cornerMax) * 0.5f;
+    float radius = 0.0f;
+    for (const glm::vec3& corner : corners) {
+        radius = std::max(radius, glm::distance(center, corner));
+    }
+    return glm::vec4(center, radius);
+}
+
+void CullBounds::Resize(size_t count)
+{
+    m_centerX.resize(count);
+    m_centerY.resize(count);
+    m_centerZ.resize(count);
+    m_extentX.resize(count);
+    m_extentY.resize(count);
+    m_extentZ.resize(count);
+}
+
+void CullBounds::Set(size_t index, const glm::vec3& center, const glm::vec3& extent)
+{
+    m_centerX[index] = center.x;
+    m_centerY[index] = center.y;
+    m_centerZ[index] = center.z;
+    m_extentX[index] = extent.x;
+    m_extentY[index] = extent.y;
+    m_extentZ[index] = extent.z;
+}
+
+namespace {
+
+    // A CullCoherency group packs the plane to test first into its low bits, next to the distant and inside flags.
+    constexpr std::uint8_t FIRST_PLANE_MASK = 0x07;
+    constexpr std::uint8_t DISTANT = 1 << 6;
+    constexpr std::uint8_t INSIDE_FRUSTUM = 1 << 7;
+
+    // Per plane, how far inside of it, scaled by its normal's length like the distances are, an AABB must be to be flagged.
+    using InsideThresholds = std::array<float, 6>;
+
+    // The point where three planes meet.
+    glm::vec3 IntersectPlanes(const Plane& a, const Plane& b, const Plane& c)
+    {
+        glm::vec3 bc = glm::cross(glm::vec3(b), glm::vec3(c));
+        glm::vec3 ca = glm::cross(glm::vec3(c), glm::vec3(a));
+        glm::vec3 ab = glm::cross(glm::vec3(a), glm::vec3(b));
+        return -(a.w * bc + b.w * ca + c.w * ab) / glm::dot(glm::vec3(a), bc);
+    }
+
+    // The index of the group holding the AABB at `i`: a group per LANES AABBs, then one per AABB of the scalar tail.
+    size_t GetGroup(size_t i, size_t count, size_t lanes)
+    {
+        size_t vectorEnd = count / lanes * lanes;
+        return i < vectorEnd ? i / lanes : vectorEnd / lanes + (i - vectorEnd);
+    }
+
+    // An AABB is outside of a plane when even its corner furthest along the plane's normal is behind it, that is when
+    // `dot(n, c) + d + dot(|n|, e) <= 0`.
+    //
+    // Testing starts from the plane that rejected this AABB last time, since a culled AABB is likely to be culled by the
+    // same plane again. It's updated whenever a plane rejects the AABB. An AABB flagged inside the frustum is visible
+    // without testing, and one that's inside every plane by more than `thresholds` is flagged.
+    bool IsAABBVisible(
+        const FrustumPlanes& planes, const InsideThresholds& thresholds, const CullBounds& bounds, size_t i, std::uint8_t& group)
+    {
+        if ((group & INSIDE_FRUSTUM) != 0) {
+            return true;
+        }
+
+        bool inside = true;
+        for (size_t planeOffset = 0; planeOffset < planes.size(); planeOffset++) {
+            size_t planeIdx = ((group & FIRST_PLANE_MASK) + planeOffset) % planes.size();
+            const Plane& plane = planes[planeIdx];
+            float distance
+                = plane.x * bounds.m_centerX[i] + plane.y * bounds.m_centerY[i] + plane.z * bounds.m_centerZ[i] + plane.w;
+            float radius = std::abs(plane.x) * bounds.m_extentX[i] + std::abs(plane.y) * bounds.m_extentY[i]
+                + std::abs(plane.z) * bounds.m_extentZ[i];
+            if (distance + radius <= 0.0f) {
+                group = static_cast<std::uint8_t>(planeIdx);
+                return false;
+            }
+            inside = inside && distance - radius > thresholds[planeIdx];
+        }
+        if (inside) {
+            group |= INSIDE_FRUSTUM;
+        }
+        return true;
+    }
+
+    // Returns one bit per AABB in [i, i + lanes), set when it's visible.
+    using CullLanesFunction = std::uint32_t (*)(
+        const FrustumPlanes& planes, const InsideThresholds& thresholds, const CullBounds& bounds, size_t i, std::uint8_t& group);
+
+    std::uint32_t CullLanesScalar(
+        const FrustumPlanes& planes, const InsideThresholds& thresholds, const CullBounds& bounds, size_t i, std::uint8_t& group)
+    {
+        return IsAABBVisible(planes, thresholds, bounds, i, group) ? 1 : 0;
+    }
+
+#if defined(GLITTER_SIMD_X86)
+    GLITTER_TARGET_AVX512 std::uint32_t CullLanesAvx512(
+        const FrustumPlanes& planes, const InsideThresholds& thresholds, const CullBounds& bounds, size_t i, std::uint8_t& group)
+    {
+        if ((group & INSIDE_FRUSTUM) != 0) {
+            return 0xFFFF;
+        }
+
+        __m512 cx = _mm512_loadu_ps(&bounds.m_centerX[i]);
+        __m512 cy = _mm512_loadu_ps(&bounds.m_centerY[i]);
+        __m512 cz = _mm512_loadu_ps(&bounds.m_centerZ[i]);
+        __m512 ex = _mm512_loadu_ps(&bounds.m_extentX[i]);
+        __m512 ey = _mm512_loadu_ps(&bounds.m_extentY[i]);
+        __m512 ez = _mm512_loadu_ps(&bounds.m_extentZ[i]);
+
+        __mmask16 visible = 0xFFFF;
+        __mmask16 inside = visible;
+        for (size_t planeOffset = 0; planeOffset < planes.size(); planeOffset++) {
+            size_t planeIdx = ((group & FIRST_PLANE_MASK) + planeOffset) % planes.size();
+            const Plane& plane = planes[planeIdx];
+            __m512 distance = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(_mm512_set1_ps(plane.x), cx),
+                                                _mm512_mul_ps(_mm512_set1_ps(plane.y), cy)),
+                _mm512_add_ps(_mm512_mul_ps(_mm512_set1_ps(plane.z), cz), _mm512_set1_ps(plane.w)));
+            __m512 radius = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(_mm512_set1_ps(std::abs(plane.x)), ex),
+                                              _mm512_mul_ps(_mm512_set1_ps(std::abs(plane.y)), ey)),
+                _mm512_mul_ps(_mm512_set1_ps(std::abs(plane.z)), ez));
+            visible = _mm512_mask_cmp_ps_mask(visible, _mm512_add_ps(distance, radius), _mm512_setzero_ps(), _CMP_GT_OQ);
+            if (visible == 0) {
+                group = static_cast<std::uint8_t>(planeIdx);
+                return 0;
+            }
+            inside = _mm512_mask_cmp_ps_mask(
+                inside, _mm512_sub_ps(distance, radius), _mm512_set1_ps(thresholds[planeIdx]), _CMP_GT_OQ);
+        }
+        if (inside == 0xFFFF) {
+            group |= INSIDE_FRUSTUM;
+        }
+        return visible;
+    }
+
+    GLITTER_TARGET_AVX2 std::uint32_t CullLanesAvx2(
+        const FrustumPlanes& planes, const InsideThresholds& thresholds, const CullBounds& bounds, size_t i, std::uint8_t& group)
+    {
+        if ((group & INSIDE_FRUSTUM) != 0) {
+            return 0xFF;
+        }
+
+        __m256 cx = _mm256_loadu_ps(&bounds.m_centerX[i]);
+        __m256 cy = _mm256_loadu_ps(&bounds.m_centerY[i]);
+        __m256 cz = _mm256_loadu_ps(&bounds.m_centerZ[i]);
+        __m256 ex = _mm256_loadu_ps(&bounds.m_extentX[i]);
+        __m256 ey = _mm256_loadu_ps(&bounds.m_extentY[i]);
+        __m256 ez = _mm256_loadu_ps(&bounds.m_extentZ[i]);
+
+        __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        __m256 inside = visible;
+        for (size_t planeOffset = 0; planeOffset < planes.size(); planeOffset++) {
+            size_t planeIdx = ((group & FIRST_PLANE_MASK) + planeOffset) % planes.size();
+            const Plane& plane = planes[planeIdx];
+            __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), cx),
+                                                _mm256_mul_ps(_mm256_set1_ps(plane.y), cy)),
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.z), cz), _mm256_set1_ps(plane.w)));
+            __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(std::abs(plane.x)), ex),
+                                              _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.y)), ey)),
+                _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.z)), ez));
+            visible = _mm256_and_ps(visible, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GT_OQ));
+            if (_mm256_movemask_ps(visible) == 0) {
+                group = static_cast<std::uint8_t>(planeIdx);
+                return 0;
+            }
+            inside = _mm256_and_ps(
+                inside, _mm256_cmp_ps(_mm256_sub_ps(distance, radius), _mm256_set1_ps(thresholds[planeIdx]), _CMP_GT_OQ));
+        }
+        if (_mm256_movemask_ps(inside) == 0xFF) {
+            group |= INSIDE_FRUSTUM;
+        }
+        return static_cast<std::uint32_t>(_mm256_movemask_ps(visible));
+    }
+
+    std::uint32_t CullLanesSse2(
+        const FrustumPlanes& planes, const InsideThresholds& thresholds, const CullBounds& bounds, size_t i, std::uint8_t& group)
+    {
+        if ((group & INSIDE_FRUSTUM) != 0) {
+            return 0xF;
+        }
+
+        __m128 cx = _mm_loadu_ps(&bounds.m_centerX[i]);
+        __m128 cy = _mm_loadu_ps(&bounds.m_centerY[i]);
+        __m128 cz = _mm_loadu_ps(&bounds.m_centerZ[i]);
+        __m128 ex = _mm_loadu_ps(&bounds.m_extentX[i]);
+        __m128 ey = _mm_loadu_ps(&bounds.m_extentY[i]);
+        __m128 ez = _mm_loadu_ps(&bounds.m_extentZ[i]);
+
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        __m128 inside = visible;
+        for (size_t planeOffset = 0; planeOffset < planes.size(); planeOffset++) {
+            size_t planeIdx = ((group & FIRST_PLANE_MASK) + planeOffset) % planes.size();
+            const Plane& plane = planes[planeIdx];
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), cx), _mm_mul_ps(_mm_set1_ps(plane.y), cy)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), cz), _mm_set1_ps(plane.w)));
+            __m128 radius = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::abs(plane.x)), ex), _mm_mul_ps(_mm_set1_ps(std::abs(plane.y)), ey)),
+                _mm_mul_ps(_mm_set1_ps(std::abs(plane.z)), ez));
+            visible = _mm_and_ps(visible, _mm_cmpgt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+            if (_mm_movemask_ps(visible) == 0) {
+                group = static_cast<std::uint8_t>(planeIdx);
+                return 0;
+            }
+            inside = _mm_and_ps(inside, _mm_cmpgt_ps(_mm_sub_ps(distance, radius), _mm_set1_ps(thresholds[planeIdx])));
+        }
+        if (_mm_movemask_ps(inside) == 0xF) {
+            group |= INSIDE_FRUSTUM;
+        }
+        return static_cast<std::uint32_t>(_mm_movemask_ps(visible));
+    }
+#elif defined(__ARM_NEON)
+    std::uint32_t CullLanesNeon(
+        const FrustumPlanes& planes, const InsideThresholds& thresholds, const CullBounds& bounds, size_t i, std::uint8_t& group)
+    {
+        if ((group & INSIDE_FRUSTUM) != 0) {
+            return 0xF;
+        }
+
+        float32x4_t cx = vld1q_f32(&bounds.m_centerX[i]);
+        float32x4_t cy = vld1q_f32(&bounds.m_centerY[i]);
+        float32x4_t cz = vld1q_f32(&bounds.m_centerZ[i]);
+        float32x4_t ex = vld1q_f32(&bounds.m_extentX[i]);
+        float32x4_t ey = vld1q_f32(&bounds.m_extentY[i]);
+        float32x4_t ez = vld1q_f32(&bounds.m_extentZ[i]);
+
+        uint32x4_t visible = vdupq_n_u32(0xFFFF'FFFF);
+        uint32x4_t inside = visible;
+        for (size_t planeOffset = 0; planeOffset < planes.size(); planeOffset++) {
+            size_t planeIdx = ((group & FIRST_PLANE_MASK) + planeOffset) % planes.size();
+            const Plane& plane = planes[planeIdx];
+            float32x4_t distance = vdupq_n_f32(plane.w);
+            distance = vmlaq_n_f32(distance, cx, plane.x);
+            distance = vmlaq_n_f32(distance, cy, plane.y);
+            distance = vmlaq_n_f32(distance, cz, plane.z);
+            float32x4_t radius = vmulq_n_f32(ex, std::abs(plane.x));
+            radius = vmlaq_n_f32(radius, ey, std::abs(plane.y));
+            radius = vmlaq_n_f32(radius, ez, std::abs(plane.z));
+            visible = vandq_u32(visible, vcgtq_f32(vaddq_f32(distance, radius), vdupq_n_f32(0.0f)));
+            if (vmaxvq_u32(visible) == 0) {
+                group = static_cast<std::uint8_t>(planeIdx);
+                return 0;
+            }
+            inside = vandq_u32(inside, vcgtq_f32(vsubq_f32(distance, radius), vdupq_n_f32(thresholds[planeIdx])));
+        }
+        if (vminvq_u32(inside) != 0) {
+            group |= INSIDE_FRUSTUM;
+        }
+
+        // Gather the sign bit of each lane into a 4-bit mask.
+        const int32x4_t shifts = {0, 1, 2, 3};
+        return vaddvq_u32(vshlq_u32(vshrq_n_u32(visible, 31), shifts));
+    }
+#endif
+
+    struct CullKernel {
+        Core::SimdLevel m_level;
+        size_t m_lanes;
+        CullLanesFunction m_cullLanes;
+    };
+
+    // Bound on the first call, and the same for the whole run, so that the coherency groups keep holding the same AABBs.
+    const CullKernel& GetCullKernel()
+    {
+        static const CullKernel kernel = []() -> CullKernel {
+            switch (Core::GetSimdLevel()) {
+#if defined(GLITTER_SIMD_X86)
+            case Core::SimdLevel::Avx512:
+                return {Core::SimdLevel::Avx512, 16, CullLanesAvx512};
+            case Core::SimdLevel::Avx2:
+                return {Core::SimdLevel::Avx2, 8, CullLanesAvx2};
+            case Core::SimdLevel::Sse42:
+            case Core::SimdLevel::Sse2:
+                return {Core::SimdLevel::Sse2, 4, CullLanesSse2};
+#elif defined(__ARM_NEON)
+            case Core::SimdLevel::Neon:
+                return {Core::SimdLevel::Neon, 4, CullLanesNeon};
+#endif
+            default:
+                return {Core::SimdLevel::Scalar, 1, CullLanesScalar};
+            }
+        }();
+        return kernel;
+    }
+
+} // namespace
+
+Core::SimdLevel GetCullSimdLevel()
+{
+    return GetCullKernel().m_level;
+}
+
+CullResult TestAABB(const FrustumPlanes& planes, const glm::vec3& center, const glm::vec3& extent, std::uint8_t& planeMask)
+{
+    CullResult result = CullResult::Inside;
+    for (size_t planeIdx = 0; planeIdx < planes.size(); planeIdx++) {
+        std::uint8_t planeBit = static_cast<std::uint8_t>(1 << planeIdx);
+        if ((planeMask & planeBit) == 0) {
+            continue;
+        }
+
+        const Plane& plane = planes[planeIdx];
+        float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+        float radius = glm::dot(glm::abs(glm::vec3(plane)), extent);
+        if (distance + radius <= 0.0f) {
+            return CullResult::Outside;
+        }
+        if (distance - radius > 0.0f) {
+            // Fully inside this plane, so are all of the bounds it contains.
+            planeMask &= static_cast<std::uint8_t>(~planeBit);
+        } else {
+            result = CullResult::Intersecting;
+        }
+    }
+    return result;
+}
+
+size_t CullViewsRange(std::span<const FrustumPlanes> views, const glm::vec4& unionSphere, const CullBounds& bounds,
+    size_t begin, size_t end, std::span<std::uint8_t> viewMasks)
+{
+    size_t culled = 0;
+    glm::vec3 sphereCenter(unionSphere);
+    float sphereRadiusSq = unionSphere.w * unionSphere.w;
+    for (size_t idx = begin; idx < end; idx++) {
+        glm::vec3 center = bounds.GetCenter(idx);
+        glm::vec3 extent = bounds.GetExtent(idx);
+
+        // The distance from the sphere's center to the nearest point of the AABB.
+        glm::vec3 outside = glm::max(glm::abs(sphereCenter - center) - extent, 0.0f);
+        std::uint8_t viewMask = 0;
+        if (glm::dot(outside, outside) <= sphereRadiusSq) {
+            for (size_t viewIdx = 0; viewIdx < std::min<size_t>(views.size(), 8); viewIdx++) {
+                std::uint8_t planeMask = ALL_PLANES;
+                if (TestAABB(views[viewIdx], center, extent, planeMask) != CullResult::Outside) {
+                    viewMask |= static_cast<std::uint8_t>(1 << viewIdx);
+                }
+            }
+        }
+        viewMasks[idx] = viewMask;
+        culled += viewMask == 0 ? 1 : 0;
+    }
+    return culled;
+}
+
+void BeginCull(const FrustumPlanes& planes, size_t count, VisibilityMask& visibility, CullCoherency& coherency)
+{
+    visibility.assign((count + 63) / 64, 0);
+
+    // The groups no longer hold the same AABBs once the count changes.
+    size_t lanes = GetCullKernel().m_lanes;
+    bool regrouped = coherency.m_count != count || coherency.m_groups.empty();
+    if (regrouped) {
+        coherency.m_groups.assign(count / lanes + count % lanes + 1, 0);
+        coherency.m_distantVisibility.assign(visibility.size(), 0);
+        coherency.m_count = count;
+    }
+
+    FrustumPlanes normalized {};
+    for (size_t planeIdx = 0; planeIdx < planes.size(); planeIdx++) {
+        normalized[planeIdx] = planes[planeIdx] / glm::length(glm::vec3(planes[planeIdx]));
+    }
+    std::array<glm::vec3, 8> corners {};
+    for (size_t cornerIdx = 0; cornerIdx < corners.size(); cornerIdx++) {
+        corners[cornerIdx]
+            = IntersectPlanes(planes[0 + (cornerIdx & 1)], planes[2 + ((cornerIdx >> 1) & 1)], planes[4 + ((cornerIdx >> 2) & 1)]);
+    }
+
+    // The distant groups keep their visibility while the planes moved less than the margin since the oldest of them was
+    // tested, a frame less than the motion kept ago.
+    float motion = coherency.m_hasPrevious ? 0.0f : std::numeric_limits<float>::infinity();
+    for (size_t planeIdx = 0; planeIdx < planes.size() && coherency.m_hasPrevious; planeIdx++) {
+        for (const glm::vec3& corner : coherency.m_previousCorners) {
+            float moved = glm::dot(glm::vec3(normalized[planeIdx]), corner) + normalized[planeIdx].w
+                - (glm::dot(glm::vec3(coherency.m_previousPlanes[planeIdx]), corner) + coherency.m_previousPlanes[planeIdx].w);
+            motion = std::max(motion, std::abs(moved));
+        }
+    }
+    coherency.m_frame++;
+    coherency.m_motion[coherency.m_frame % coherency.m_motion.size()] = motion;
+    float totalMotion = 0.0f;
+    for (float frameMotion : coherency.m_motion) {
+        totalMotion += frameMotion;
+    }
+    bool timeSlice = Config::CULL_TIME_SLICE_FRAMES > 1 && !regrouped && totalMotion < Config::CULL_TIME_SLICE_MARGIN;
+    // The groups are tested exactly while the planes move too much, and only flagged distant again on their next frame once
+    // they stop, for the visibility kept to date from then.
+    if (coherency.m_timeSlice && !timeSlice) {
+        for (std::uint8_t& group : coherency.m_groups) {
+            group &= static_cast<std::uint8_t>(~DISTANT);
+        }
+    }
+    coherency.m_timeSlice = timeSlice;
+    coherency.m_previousPlanes = normalized;
+    coherency.m_previousCorners = corners;
+    coherency.m_hasPrevious = true;
+
+    // The distance to each plane changes linearly across the old frustum, so it moves the most at one of its corners.
+    bool keepInside = coherency.m_hasReference;
+    for (size_t planeIdx = 0; planeIdx < planes.size() && keepInside; planeIdx++) {
+        for (const glm::vec3& corner : coherency.m_referenceCorners) {
+            float moved = glm::dot(glm::vec3(normalized[planeIdx]), corner) + normalized[planeIdx].w
+                - (glm::dot(glm::vec3(coherency.m_referencePlanes[planeIdx]), corner) + coherency.m_referencePlanes[planeIdx].w);
+            keepInside = keepInside && moved > -Config::CULL_INSIDE_MARGIN;
+        }
+    }
+
+    if (!keepInside) {
+        for (std::uint8_t& group : coherency.m_groups) {
+            group &= static_cast<std::uint8_t>(~INSIDE_FRUSTUM);
+        }
+        coherency.m_referencePlanes = normalized;
+        coherency.m_referenceCorners = corners;
+        coherency.m_hasReference = true;
+    }
+    // Only flag groups against the reference planes themselves, so that they lie within the reference frustum.
+    coherency.m_markInside = normalized == coherency.m_referencePlanes;
+}
+
+size_t CullAABBRange(const FrustumPlanes& planes, const CullBounds& bounds, size_t begin, size_t end, VisibilityMask& visibility,
+    CullCoherency& coherency)
+{
+    InsideThresholds thresholds {};
+    for (size_t planeIdx = 0; planeIdx < planes.size(); planeIdx++) {
+        thresholds[planeIdx] = coherency.m_markInside
+            ? Config::CULL_INSIDE_MARGIN * glm::length(glm::vec3(planes[planeIdx]))
+            : std::numeric_limits<float>::infinity();
+    }
+
+    // The distant groups are tested against the planes pushed out by the margin, along every axis at once since the AABB
+    // test only looks at the extents along the axes, and still flagged inside of the actual ones.
+    FrustumPlanes distantPlanes = planes;
+    InsideThresholds distantThresholds = thresholds;
+    for (size_t planeIdx = 0; planeIdx < planes.size(); planeIdx++) {
+        const Plane& plane = planes[planeIdx];
+        float push = Config::CULL_TIME_SLICE_MARGIN * (std::abs(plane.x) + std::abs(plane.y) + std::abs(plane.z));
+        distantPlanes[planeIdx].w += push;
+        distantThresholds[planeIdx] += push;
+    }
+    // A group is distant when every AABB of it is culled by the near plane flipped and moved out to the distance, which
+    // the kernels tell after that single plane. The others always pass.
+    const Plane& nearPlane = planes[4];
+    float nearOffset = nearPlane.w - Config::CULL_TIME_SLICE_DISTANCE * glm::length(glm::vec3(nearPlane));
+    FrustumPlanes distancePlanes {};
+    distancePlanes.fill(Plane(0.0f, 0.0f, 0.0f, std::numeric_limits<float>::infinity()));
+    distancePlanes[0] = -Plane(glm::vec3(nearPlane), nearOffset);
+    InsideThresholds noThresholds {};
+    noThresholds.fill(std::numeric_limits<float>::infinity());
+
+    // Culls the `laneCount` AABBs of group `groupIdx` from `i` with `cullLanes`, or keeps the visibility a distant group
+    // was last tested to, if it's not its frame.
+    auto cullGroup = [&](size_t groupIdx, size_t i, size_t laneCount, auto cullLanes) {
+        std::uint8_t& group = coherency.m_groups[groupIdx];
+        std::uint64_t laneMask = (laneCount == 64 ? ~std::uint64_t {0} : (std::uint64_t {1} << laneCount) - 1) << (i % 64);
+        if ((group & INSIDE_FRUSTUM) != 0) {
+            visibility[i / 64] |= laneMask;
+            return;
+        }
+        if (!coherency.m_timeSlice) {
+            visibility[i / 64] |= static_cast<std::uint64_t>(cullLanes(planes, thresholds, bounds, i, group)) << (i % 64);
+            return;
+        }
+        bool due = (groupIdx + coherency.m_frame) % Config::CULL_TIME_SLICE_FRAMES == 0;
+        if (!due && (group & DISTANT) != 0) {
+            visibility[i / 64] |= coherency.m_distantVisibility[i / 64] & laneMask;
+            return;
+        }
+
+        std::uint8_t distanceGroup = 0;
+        bool distant = due ? cullLanes(distancePlanes, noThresholds, bounds, i, distanceGroup) == 0 : (group & DISTANT) != 0;
+        const FrustumPlanes& groupPlanes = distant ? distantPlanes : planes;
+        const InsideThresholds& groupThresholds = distant ? distantThresholds : thresholds;
+        auto visible = static_cast<std::uint64_t>(cullLanes(groupPlanes, groupThresholds, bounds, i, group));
+        group = static_cast<std::uint8_t>((group & ~DISTANT) | (distant ? DISTANT : 0));
+        visibility[i / 64] |= visible << (i % 64);
+        if (distant) {
+            coherency.m_distantVisibility[i / 64] = (coherency.m_distantVisibility[i / 64] & ~laneMask) | (visible << (i % 64));
+        }
+    };
+
+    // 64 is a multiple of every lane count, so a group of lanes never straddles two words.
+    const CullKernel& kernel = GetCullKernel();
+    size_t count = bounds.Size();
+    size_t vectorEnd = std::min(end, count / kernel.m_lanes * kernel.m_lanes);
+    size_t i = begin;
+    for (; i + kernel.m_lanes <= vectorEnd; i += kernel.m_lanes) {
+        cullGroup(i / kernel.m_lanes, i, kernel.m_lanes, kernel.m_cullLanes);
+    }
+    for (; i < end; i++) {
+        cullGroup(GetGroup(i, count, kernel.m_lanes), i, 1, IsAABBVisible);
+    }
+
+    size_t visibleCount = 0;
+    for (size_t word = begin / 64; word < (end + 63) / 64; word++) {
+        visibleCount += static_cast<size_t>(std::popcount(visibility[word]));
+    }
+    return (end - begin) - visibleCount;
+}
+
+size_t CullAABBs(const FrustumPlanes& planes, const CullBounds& bounds, VisibilityMask& visibility, CullCoherency& coherency)
+{
+    BeginCull(planes, bounds.Size(), visibility, coherency);
+    return CullAABBRange(planes, bounds, 0, bounds.Size(), visibility, coherency);
+}
+
+void InvalidateCoherency(CullCoherency& coherency, std::span<const std::uint32_t> items)
+{
+    for (std::uint32_t item : items) {
+        if (item < coherency.m_count) {
+            coherency.m_groups[GetGroup(item, coherency.m_count, GetCullKernel().m_lanes)] &= FIRST_PLANE_MASK;
+        }
+    }
+}
+
+} // namespace Glitter::Render
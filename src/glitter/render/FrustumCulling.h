@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Config.h"
+#include "core/CpuFeatures.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Glitter::Render {
+
+// A plane as (normal, distance), the inside halfspace is where `dot(normal, p) + distance > 0`.
+using Plane = glm::vec4;
+using FrustumPlanes = std::array<Plane, 6>;
+
+// Extracts the left, right, bottom, top, near and far planes from a View-Projection matrix. The planes are in the space
+// the VP matrix transforms from, so World Space for `projection * view`.
+FrustumPlanes ExtractFrustumPlanes(const glm::mat4& vp);
+// The planes of a frustum holding both eyes' frusta, extracted from their View-Projections, with the same projection and
+// their Views only apart along their x axis. Their top, bottom, near and far planes are then the same, so only the left
+// eye's left plane and the right eye's right plane change.
+FrustumPlanes CombineStereoFrustums(const FrustumPlanes& leftEye, const FrustumPlanes& rightEye);
+// The planes each moved `distance` world units outwards, so that the frustum holds what's at most that far outside of it.
+FrustumPlanes GrowFrustumPlanes(const FrustumPlanes& planes, float distance);
+// A sphere holding the frusta of every View-Projection of `viewProjections`, as (center, radius), around their corners.
+glm::vec4 BoundFrustums(std::span<const glm::mat4> viewProjections);
+
+// World-space AABBs stored as structure-of-arrays, so that the culling kernel can load several of them per register.
+struct CullBounds {
+    std::vector<float> m_centerX;
+    std::vector<float> m_centerY;
+    std::vector<float> m_centerZ;
+    std::vector<float> m_extentX;
+    std::vector<float> m_extentY;
+    std::vector<float> m_extentZ;
+
+    void Resize(size_t count);
+    void Set(size_t index, const glm::vec3& center, const glm::vec3& extent);
+    glm::vec3 GetCenter(size_t index) const { return {m_centerX[index], m_centerY[index], m_centerZ[index]}; }
+    glm::vec3 GetExtent(size_t index) const { return {m_extentX[index], m_extentY[index], m_extentZ[index]}; }
+    size_t Size() const { return m_centerX.size(); }
+};
+
+// One bit per AABB, set when it's visible.
+using VisibilityMask = std::vector<std::uint64_t>;
+
+inline bool IsVisible(const VisibilityMask& mask, size_t index) { return (mask[index / 64] >> (index % 64)) & 1; }
+
+// What CullAABBRange() keeps between frames to skip plane tests, see BeginCull().
+struct CullCoherency {
+    // Per group of lanes, then per AABB of the scalar tail: the plane that last rejected it, tested first on the next
+    // call, and whether it was found fully inside the frustum.
+    std::vector<std::uint8_t> m_groups;
+    size_t m_count {};
+    // The normalized planes the inside flags were set against, and the corners of their frustum.
+    FrustumPlanes m_referencePlanes {};
+    std::array<glm::vec3, 8> m_referenceCorners {};
+    bool m_hasReference {};
+    // Set while the planes are the reference ones, so that groups found inside them can be flagged.
+    bool m_markInside {};
+
+    // The visibility the distant groups were last tested to, kept for the frames they aren't.
+    VisibilityMask m_distantVisibility;
+    // The normalized planes of the previous call and the corners of their frustum, and how far the planes moved at those
+    // corners on each of the last frames.
+    FrustumPlanes m_previousPlanes {};
+    std::array<glm::vec3, 8> m_previousCorners {};
+    bool m_hasPrevious {};
+    std::array<float, Config::CULL_TIME_SLICE_FRAMES> m_motion {};
+    std::uint64_t m_frame {};
+    // Set while the distant groups can keep their result from the last time they were tested.
+    bool m_timeSlice {};
+};
+
+// Tests every AABB in `bounds` against `planes` with a center/extent test, 16 (AVX-512), 8 (AVX2) or 4 (SSE2, NEON) AABBs
+// at a time, and writes the result into `visibility`. Returns the number of culled AABBs.
+size_t CullAABBs(const FrustumPlanes& planes, const CullBounds& bounds, VisibilityMask& visibility, CullCoherency& coherency);
+// The instruction set CullAABBs() runs on, the widest of the CPU's it has a version for.
+Core::SimdLevel GetCullSimdLevel();
+
+// CullAABBs() split in two so that the AABBs can be culled in ranges on several threads. BeginCull() sizes the outputs
+// for `count` AABBs, then CullAABBRange() culls [begin, end) and returns the number of culled AABBs. `begin` must be a
+// multiple of 64 and `end` either a multiple of 64 or the AABB count, so that no two ranges write the same mask word.
+//
+// A group of AABBs found inside every plane by more than Config::CULL_INSIDE_MARGIN is flagged, and no longer tested
+// until a plane moves inward by more than the margin at a corner of the frustum the group was flagged in. Since the group
+// lies within that frustum, it's still inside the planes until then. BeginCull() checks the corners, and clears every flag
+// once a plane moved too far. The flagged AABBs must be unchanged meanwhile, see InvalidateCoherency().
+//
+// The groups of AABBs entirely beyond Config::CULL_TIME_SLICE_DISTANCE from the near plane are only tested on one frame
+// out of Config::CULL_TIME_SLICE_FRAMES, staggered by group, against the planes pushed out by
+// Config::CULL_TIME_SLICE_MARGIN, and keep that visibility on the other frames. An AABB only enters the frustum through
+// its faces, where the planes move at most as much as at its corners, so that it's conservative as long as the planes
+// moved by less than the margin at the corners over those frames. Every group is tested exactly on the frames they moved
+// further, and only flagged distant again on its next frame once they stop.
+void BeginCull(const FrustumPlanes& planes, size_t count, VisibilityMask& visibility, CullCoherency& coherency);
+size_t CullAABBRange(const FrustumPlanes& planes, const CullBounds& bounds, size_t begin, size_t end, VisibilityMask& visibility,
+    CullCoherency& coherency);
+
+// Clears the inside flag of the groups holding the AABBs at `items`, whose bounds changed since the last cull.
+void InvalidateCoherency(CullCoherency& coherency, std::span<const std::uint32_t> items);
+
+enum class [[nodiscard]] CullResult : std::uint8_t {
+    Outside,
+    Intersecting,
+    Inside,
+};
+
+// Every plane bit set, the initial mask for TestAABB.
+constexpr std::uint8_t ALL_PLANES = 0x3F;
+
+// Tests a single AABB against the planes whose bit is set in `planeMask`. Planes the AABB is fully inside of are cleared
+// from the mask, so that a hierarchy only has to test the remaining ones against the AABB's children.
+CullResult TestAABB(const FrustumPlanes& planes, const glm::vec3& center, const glm::vec3& extent, std::uint8_t& planeMask);
+
+// Culls the AABBs in [begin, end) of `bounds` for up to 8 views at once, setting bit `i` of their entry of `viewMasks`
+// when they're visible from the `i`-th of `views`. `unionSphere` holds every view's frustum, see BoundFrustums(): the
+// AABBs outside of it are culled from every view by a single test, and only the others are tested against each view's
+// planes. Returns the number of AABBs visible from none of them.
+size_t CullViewsRange(std::span<const FrustumPlanes> views, const glm::vec4& unionSphere, const CullBounds& bounds,
+    size_t begin, size_t end, std::span<std::uint8_t> viewMasks);
+
+} // namespace Glitter::Render
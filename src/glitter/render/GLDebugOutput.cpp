@@ -0,0 +1,96 @@
+#include "render/GLDebugOutput.h"
+
+#include "Config.h"
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace Glitter::Render {
+
+namespace {
+
+    struct MessageCount {
+        // Raised since the start, and since it was last logged.
+        std::uint64_t m_count {};
+        std::uint64_t m_skipped {};
+        std::chrono::steady_clock::time_point m_lastLogged {};
+    };
+
+    std::mutex s_mutex;
+    std::unordered_map<std::uint64_t, MessageCount> s_messages;
+
+    // Whether to log the message, and how many times it was raised without being logged since the last time it was.
+    bool CountMessage(GLenum source, GLenum type, GLuint id, std::uint64_t& skipped)
+    {
+        std::uint64_t key = (static_cast<std::uint64_t>(source & 0xffff) << 48)
+            | (static_cast<std::uint64_t>(type & 0xffff) << 32) | id;
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard lock(s_mutex);
+        MessageCount& message = s_messages[key];
+        ++message.m_count;
+        if (message.m_count > Config::GL_DEBUG_MESSAGE_BURST
+            && now - message.m_lastLogged < std::chrono::duration<double>(Config::GL_DEBUG_MESSAGE_INTERVAL)) {
+            ++message.m_skipped;
+            return false;
+        }
+        skipped = std::exchange(message.m_skipped, 0);
+        message.m_lastLogged = now;
+        return true;
+    }
+
+    void APIENTRY OnDebugMessage(GLenum source, GLenum type, GLuint id, GLenum /*severity*/, GLsizei /*length*/,
+        const GLchar* msg, const void* /*userParam*/)
+    {
+        bool isError = false;
+        switch (type) {
+        case GL_DEBUG_TYPE_ERROR:
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
+            isError = true;
+            break;
+        case GL_DEBUG_TYPE_PUSH_GROUP:
+        case GL_DEBUG_TYPE_POP_GROUP:
+        case GL_DEBUG_TYPE_OTHER:
+            return;
+        default:
+            break;
+        }
+
+        std::uint64_t skipped = 0;
+        if (!CountMessage(source, type, id, skipped)) {
+            return;
+        }
+        if (isError) {
+            if (skipped > 0) {
+                spdlog::error("{} {} (and {} more times since)", source, msg, skipped);
+            } else {
+                spdlog::error("{} {}", source, msg);
+            }
+        } else {
+            if (skipped > 0) {
+                spdlog::warn("{} (and {} more times since)", msg, skipped);
+            } else {
+                spdlog::warn("{}", msg);
+            }
+        }
+    }
+
+} // namespace
+
+void EnableGLDebugOutput()
+{
+    glEnable(GL_DEBUG_OUTPUT);
+    if (Config::GL_DEBUG_SYNCHRONOUS) {
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    } else {
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    }
+    glDebugMessageCallback(OnDebugMessage, nullptr);
+}
+
+} // namespace Glitter::Render
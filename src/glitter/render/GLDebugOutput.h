@@ -0,0 +1,10 @@
+#pragma once
+
+namespace Glitter::Render {
+
+// Logs the GL debug messages, each of them by its source, type and ID the first Config::GL_DEBUG_MESSAGE_BURST times, then
+// at most once every Config::GL_DEBUG_MESSAGE_INTERVAL seconds, so that one raised by every draw doesn't flood the log.
+// The driver may raise them from any of its threads, unless Config::GL_DEBUG_SYNCHRONOUS.
+void EnableGLDebugOutput();
+
+} // namespace Glitter::Render
@@ -0,0 +1,142 @@
+#include "render/GLExtensions.h"
+
+#include "render/TextureFile.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace Glitter::Render {
+
+namespace {
+    GLExtensions s_extensions {};
+
+    template <typename Proc> bool LoadProc(GLADloadproc loader, const char* name, Proc& proc)
+    {
+        proc = reinterpret_cast<Proc>(loader(name));
+        return proc != nullptr;
+    }
+} // namespace
+
+void LoadGLExtensions(GLADloadproc loader)
+{
+    s_extensions = {};
+
+    if (HasGLExtension("GL_ARB_bindless_texture")) {
+        bool loaded = LoadProc(loader, "glGetTextureHandleARB", s_extensions.m_getTextureHandle);
+        loaded &= LoadProc(loader, "glGetTextureSamplerHandleARB", s_extensions.m_getTextureSamplerHandle);
+        loaded &= LoadProc(loader, "glMakeTextureHandleResidentARB", s_extensions.m_makeTextureHandleResident);
+        loaded &= LoadProc(loader, "glMakeTextureHandleNonResidentARB", s_extensions.m_makeTextureHandleNonResident);
+        s_extensions.m_bindlessTexture = loaded;
+    }
+
+    if (HasGLExtension("GL_ARB_sparse_texture")) {
+        s_extensions.m_sparseTexture = LoadProc(loader, "glTexturePageCommitmentEXT", s_extensions.m_texturePageCommitment);
+    }
+
+    if (HasGLExtension("GL_KHR_parallel_shader_compile")) {
+        s_extensions.m_parallelShaderCompile
+            = LoadProc(loader, "glMaxShaderCompilerThreadsKHR", s_extensions.m_maxShaderCompilerThreads);
+    } else if (HasGLExtension("GL_ARB_parallel_shader_compile")) {
+        s_extensions.m_parallelShaderCompile
+            = LoadProc(loader, "glMaxShaderCompilerThreadsARB", s_extensions.m_maxShaderCompilerThreads);
+    }
+    if (s_extensions.m_parallelShaderCompile) {
+        // Let the driver pick how many threads to compile on.
+        s_extensions.m_maxShaderCompilerThreads(0xFFFF'FFFF);
+    }
+
+    if (HasGLExtension("GL_OVR_multiview")) {
+        GLint maxViews = 0;
+        glGetIntegerv(GL_MAX_VIEWS_OVR, &maxViews);
+        s_extensions.m_multiview = maxViews >= 2
+            && LoadProc(loader, "glFramebufferTextureMultiviewOVR", s_extensions.m_framebufferTextureMultiview);
+    }
+
+    if (HasGLExtension("GL_NV_shading_rate_image")) {
+        bool loaded = LoadProc(loader, "glBindShadingRateImageNV", s_extensions.m_bindShadingRateImage);
+        loaded &= LoadProc(loader, "glShadingRateImagePaletteNV", s_extensions.m_shadingRateImagePalette);
+        s_extensions.m_shadingRateImage = loaded;
+    }
+
+    s_extensions.m_fragmentShaderBarycentric = HasGLExtension("GL_NV_fragment_shader_barycentric");
+    s_extensions.m_gpuMemoryInfo = HasGLExtension("GL_NVX_gpu_memory_info");
+    s_extensions.m_memInfo = HasGLExtension("GL_ATI_meminfo");
+
+    GLint binaryFormatCount = 0;
+    glGetIntegerv(GL_NUM_SHADER_BINARY_FORMATS, &binaryFormatCount);
+    if (binaryFormatCount > 0) {
+        std::vector<GLint> binaryFormats(static_cast<size_t>(binaryFormatCount));
+        glGetIntegerv(GL_SHADER_BINARY_FORMATS, binaryFormats.data());
+        s_extensions.m_glSpirv = std::ranges::find(binaryFormats, GL_SHADER_BINARY_FORMAT_SPIR_V) != binaryFormats.end();
+    }
+
+    s_extensions.m_textureCompressionS3TC = HasGLExtension("GL_EXT_texture_compression_s3tc");
+    s_extensions.m_textureCompressionS3TCSrgb = s_extensions.m_textureCompressionS3TC && HasGLExtension("GL_EXT_texture_sRGB");
+    s_extensions.m_textureCompressionASTC = HasGLExtension("GL_KHR_texture_compression_astc_ldr");
+
+    spdlog::info("GL_ARB_bindless_texture: {}", s_extensions.m_bindlessTexture ? "supported" : "unsupported");
+    spdlog::info("GL_ARB_sparse_texture: {}", s_extensions.m_sparseTexture ? "supported" : "unsupported");
+    spdlog::info("GL_KHR_parallel_shader_compile: {}", s_extensions.m_parallelShaderCompile ? "supported" : "unsupported");
+    spdlog::info("GL_OVR_multiview: {}", s_extensions.m_multiview ? "supported" : "unsupported");
+    spdlog::info("GL_NV_shading_rate_image: {}", s_extensions.m_shadingRateImage ? "supported" : "unsupported");
+    spdlog::info("GL_NV_fragment_shader_barycentric: {}",
+        s_extensions.m_fragmentShaderBarycentric ? "supported" : "unsupported");
+    spdlog::info("GL_NVX_gpu_memory_info: {}", s_extensions.m_gpuMemoryInfo ? "supported" : "unsupported");
+    spdlog::info("GL_ATI_meminfo: {}", s_extensions.m_memInfo ? "supported" : "unsupported");
+    spdlog::info("GL_ARB_gl_spirv: {}", s_extensions.m_glSpirv ? "supported" : "unsupported");
+    spdlog::info("GL_EXT_texture_compression_s3tc: {}", s_extensions.m_textureCompressionS3TC ? "supported" : "unsupported");
+    spdlog::info("GL_KHR_texture_compression_astc_ldr: {}", s_extensions.m_textureCompressionASTC ? "supported" : "unsupported");
+}
+
+void DisableUntraceableGLExtensions()
+{
+    s_extensions.m_bindlessTexture = false;
+    s_extensions.m_sparseTexture = false;
+    s_extensions.m_multiview = false;
+    s_extensions.m_shadingRateImage = false;
+    spdlog::info("GL traces are enabled, turning off GL_ARB_bindless_texture, GL_ARB_sparse_texture, GL_OVR_multiview and "
+                 "GL_NV_shading_rate_image.");
+}
+
+const GLExtensions& GetGLExtensions()
+{
+    return s_extensions;
+}
+
+bool HasGLExtension(std::string_view name)
+{
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint extensionIdx = 0; extensionIdx < extensionCount; extensionIdx++) {
+        const auto* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(extensionIdx)));
+        if (extension && name == extension) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool IsCompressedFormatSupported(GLenum format)
+{
+    switch (format) {
+    case GL_COMPRESSED_RGBA_BPTC_UNORM:
+    case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+        return true;
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        return s_extensions.m_textureCompressionS3TC;
+    case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+        return s_extensions.m_textureCompressionS3TCSrgb;
+    case GL_COMPRESSED_RGBA_ASTC_4x4_KHR:
+    case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR:
+        return s_extensions.m_textureCompressionASTC;
+    default:
+        return false;
+    }
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string_view>
+
+namespace Glitter::Render {
+
+// GL_ARB_bindless_texture
+using PFNGLGETTEXTUREHANDLEARBPROC = GLuint64(APIENTRYP)(GLuint texture);
+using PFNGLGETTEXTURESAMPLERHANDLEARBPROC = GLuint64(APIENTRYP)(GLuint texture, GLuint sampler);
+using PFNGLMAKETEXTUREHANDLERESIDENTARBPROC = void(APIENTRYP)(GLuint64 handle);
+using PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC = void(APIENTRYP)(GLuint64 handle);
+
+// GL_ARB_sparse_texture, with the entry point it adds alongside GL_EXT_direct_state_access.
+#ifndef GL_TEXTURE_SPARSE_ARB
+#define GL_TEXTURE_SPARSE_ARB 0x91A6
+#define GL_VIRTUAL_PAGE_SIZE_INDEX_ARB 0x91A7
+#define GL_NUM_SPARSE_LEVELS_ARB 0x91AA
+#define GL_NUM_VIRTUAL_PAGE_SIZES_ARB 0x91A8
+#define GL_VIRTUAL_PAGE_SIZE_X_ARB 0x9195
+#define GL_VIRTUAL_PAGE_SIZE_Y_ARB 0x9196
+#endif
+using PFNGLTEXTUREPAGECOMMITMENTEXTPROC = void(APIENTRYP)(GLuint texture, GLint level, GLint xoffset, GLint yoffset,
+    GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLboolean commit);
+
+// GL_KHR_parallel_shader_compile, or its equivalent GL_ARB_parallel_shader_compile.
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+using PFNGLMAXSHADERCOMPILERTHREADSKHRPROC = void(APIENTRYP)(GLuint count);
+
+// GL_OVR_multiview.
+#ifndef GL_MAX_VIEWS_OVR
+#define GL_MAX_VIEWS_OVR 0x9631
+#endif
+using PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVRPROC = void(APIENTRYP)(
+    GLenum target, GLenum attachment, GLuint texture, GLint level, GLint baseViewIndex, GLsizei numViews);
+
+// GL_NV_shading_rate_image.
+#ifndef GL_SHADING_RATE_IMAGE_NV
+#define GL_SHADING_RATE_IMAGE_NV 0x9563
+#define GL_SHADING_RATE_1_INVOCATION_PER_PIXEL_NV 0x9565
+#define GL_SHADING_RATE_1_INVOCATION_PER_2X1_PIXELS_NV 0x9567
+#define GL_SHADING_RATE_1_INVOCATION_PER_2X2_PIXELS_NV 0x9568
+#define GL_SHADING_RATE_1_INVOCATION_PER_4X4_PIXELS_NV 0x956B
+#define GL_SHADING_RATE_IMAGE_TEXEL_WIDTH_NV 0x955C
+#define GL_SHADING_RATE_IMAGE_TEXEL_HEIGHT_NV 0x955D
+#endif
+using PFNGLBINDSHADINGRATEIMAGENVPROC = void(APIENTRYP)(GLuint texture);
+using PFNGLSHADINGRATEIMAGEPALETTENVPROC = void(APIENTRYP)(GLuint viewport, GLuint first, GLsizei count, const GLenum* rates);
+
+// GL_NVX_gpu_memory_info, in KiB.
+#ifndef GL_GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX
+#define GL_GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX 0x9047
+#define GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX 0x9048
+#define GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX 0x9049
+#define GL_GPU_MEMORY_INFO_EVICTION_COUNT_NVX 0x904A
+#define GL_GPU_MEMORY_INFO_EVICTED_MEMORY_NVX 0x904B
+#endif
+
+// GL_ATI_meminfo: the free KiB of each pool, its largest free block, and the same for the auxiliary memory.
+#ifndef GL_VBO_FREE_MEMORY_ATI
+#define GL_VBO_FREE_MEMORY_ATI 0x87FB
+#define GL_TEXTURE_FREE_MEMORY_ATI 0x87FC
+#define GL_RENDERBUFFER_FREE_MEMORY_ATI 0x87FD
+#endif
+
+// Optional extensions used by Glitter. The vendored glad only loads the core profile, so their availability and entry
+// points are resolved here instead.
+struct GLExtensions {
+    bool m_bindlessTexture {false};
+    PFNGLGETTEXTUREHANDLEARBPROC m_getTextureHandle {};
+    PFNGLGETTEXTURESAMPLERHANDLEARBPROC m_getTextureSamplerHandle {};
+    PFNGLMAKETEXTUREHANDLERESIDENTARBPROC m_makeTextureHandleResident {};
+    PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC m_makeTextureHandleNonResident {};
+
+    bool m_sparseTexture {false};
+    PFNGLTEXTUREPAGECOMMITMENTEXTPROC m_texturePageCommitment {};
+
+    bool m_parallelShaderCompile {false};
+    PFNGLMAXSHADERCOMPILERTHREADSKHRPROC m_maxShaderCompilerThreads {};
+
+    // With at least 2 views, for stereo.
+    bool m_multiview {false};
+    PFNGLFRAMEBUFFERTEXTUREMULTIVIEWOVRPROC m_framebufferTextureMultiview {};
+
+    bool m_shadingRateImage {false};
+    PFNGLBINDSHADINGRATEIMAGENVPROC m_bindShadingRateImage {};
+    PFNGLSHADINGRATEIMAGEPALETTENVPROC m_shadingRateImagePalette {};
+
+    // GL_NV_fragment_shader_barycentric, only used in GLSL.
+    bool m_fragmentShaderBarycentric {false};
+
+    // GL_NVX_gpu_memory_info and GL_ATI_meminfo, only queries.
+    bool m_gpuMemoryInfo {false};
+    bool m_memInfo {false};
+
+    // GL_ARB_gl_spirv. Its entry points are core since 4.6, but the driver still has to list the binary format.
+    bool m_glSpirv {false};
+
+    // GL_EXT_texture_compression_s3tc and GL_EXT_texture_sRGB, for BC1 and BC3. BC7 is core.
+    bool m_textureCompressionS3TC {false};
+    bool m_textureCompressionS3TCSrgb {false};
+    // GL_KHR_texture_compression_astc_ldr.
+    bool m_textureCompressionASTC {false};
+};
+
+// Must be called once the context is current and gladLoadGLLoader() succeeded.
+void LoadGLExtensions(GLADloadproc loader);
+const GLExtensions& GetGLExtensions();
+// Turns off the extensions whose calls a GLTraceRecorder can't see, as they aren't loaded through glad. Must be called
+// right after LoadGLExtensions(), before anything checks them.
+void DisableUntraceableGLExtensions();
+
+bool HasGLExtension(std::string_view name);
+
+// Whether textures of a Render::CompressedTexture format can be created.
+bool IsCompressedFormatSupported(GLenum format);
+
+} // namespace Glitter::Render
@@ -0,0 +1,2059 @@
+#include "render/GLTrace.h"
+
+#include "Config.h"
+#include "util/File.h"
+#include "util/Lz4.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Glitter::Render {
+
+namespace {
+
+    // Bump whenever the layout below or CallTable change, which renumbers the calls.
+    constexpr std::uint32_t TRACE_VERSION = 2;
+    constexpr std::array<char, 4> TRACE_MAGIC {'G', 'L', 'T', 'R'};
+    constexpr size_t SECTION_COUNT = 3;
+
+    // Followed by the LZ4 block of each section, objects, state then frame, each a sequence of calls: their index in
+    // CallTable as a std::uint16_t, then their arguments, as their specs write them.
+    struct TraceHeader {
+        std::array<char, 4> m_magic;
+        std::uint32_t m_version;
+        std::uint32_t m_callCount;
+        std::int32_t m_width;
+        std::int32_t m_height;
+        std::uint32_t m_padding;
+        std::array<std::uint64_t, SECTION_COUNT> m_sizes;
+        std::array<std::uint64_t, SECTION_COUNT> m_compressedSizes;
+    };
+
+    // The names the snapshot gives the shaders it creates, past those of the application.
+    constexpr GLuint SNAPSHOT_SHADER_NAME = 0x8000'0000;
+    // The scratch memory a glReadPixels() into client memory gets at most when replayed.
+    constexpr size_t MAX_READ_SIZE = size_t {256} << 20;
+
+    // The trace the hooks record into, only from s_recordingThread.
+    std::atomic<std::vector<std::byte>*> s_recording {};
+    std::thread::id s_recordingThread {};
+
+    std::mutex s_programMutex;
+    bool s_keepPrograms {};
+    std::unordered_map<GLuint, std::vector<ShaderSource>> s_programSources;
+
+    std::vector<std::byte>* GetRecordingTrace()
+    {
+        std::vector<std::byte>* trace = s_recording.load(std::memory_order_acquire);
+        return trace && std::this_thread::get_id() == s_recordingThread ? trace : nullptr;
+    }
+
+    void WriteBytes(std::vector<std::byte>& trace, const void* data, size_t size)
+    {
+        const auto* bytes = static_cast<const std::byte*>(data);
+        trace.insert(trace.end(), bytes, bytes + size);
+    }
+
+    template <typename T> void WriteValue(std::vector<std::byte>& trace, const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        WriteBytes(trace, &value, sizeof(T));
+    }
+
+    // Whether there's an array, its element count, then its elements if there is.
+    template <typename T> void WriteArray(std::vector<std::byte>& trace, const T* data, size_t count)
+    {
+        WriteValue(trace, static_cast<std::uint8_t>(data != nullptr));
+        WriteValue(trace, static_cast<std::uint64_t>(count));
+        if (data) {
+            WriteBytes(trace, data, sizeof(T) * count);
+        }
+    }
+
+    // Reads the calls of a section, failing rather than reading past its end.
+    class TraceReader {
+    public:
+        explicit TraceReader(std::span<const std::byte> data)
+            : m_data(data)
+        {
+        }
+
+        template <typename T> T Read()
+        {
+            T value {};
+            ReadBytes(&value, sizeof(T));
+            return value;
+        }
+
+        void ReadBytes(void* out, size_t size)
+        {
+            if (size > m_data.size() - m_offset) {
+                m_failed = true;
+                m_offset = m_data.size();
+                return;
+            }
+            std::memcpy(out, m_data.data() + m_offset, size);
+            m_offset += size;
+        }
+
+        // Returns false if WriteArray() wrote no array, leaving `out` with its count of elements then.
+        template <typename T> bool ReadArray(std::vector<T>& out)
+        {
+            bool present = Read<std::uint8_t>() != 0;
+            auto count = Read<std::uint64_t>();
+            if (!present) {
+                out.resize(m_failed ? 0 : count);
+                return false;
+            }
+            if (count > (m_data.size() - m_offset) / std::max<size_t>(sizeof(T), 1)) {
+                m_failed = true;
+                m_offset = m_data.size();
+                return false;
+            }
+            out.resize(count);
+            ReadBytes(out.data(), sizeof(T) * count);
+            return true;
+        }
+
+        bool IsAtEnd() const { return m_offset == m_data.size(); }
+        bool HasFailed() const { return m_failed; }
+
+    private:
+        std::span<const std::byte> m_data;
+        size_t m_offset {};
+        bool m_failed {};
+    };
+
+    // How each argument of a call is recorded and replayed. Write<T>() records the argument `value` given the tuple of
+    // the call's arguments, and Read<T>() returns its Decoded<T>, whose Get() is the argument to replay the call with,
+    // given the tuple of every Decoded of the call. The call is skipped if any Skip(), and Finish() runs after it.
+    struct Argument {
+        bool Skip() const { return false; }
+        void Finish(GLTraceNames& /*names*/) {}
+    };
+
+    // Enums, counts, offsets and the other values replayed as they are.
+    struct Value {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& trace, const Tuple& /*args*/, T value)
+        {
+            WriteValue(trace, value);
+        }
+        template <typename T> struct Decoded : Argument {
+            T m_value;
+            T Get(const auto& /*decoded*/) const { return m_value; }
+        };
+        template <typename T> static Decoded<T> Read(TraceReader& reader, GLTraceNames& /*names*/)
+        {
+            return {{}, reader.Read<T>()};
+        }
+    };
+
+    // A pointer taken as an offset into the buffer bound for it, e.g. the indices of glDrawElements().
+    struct Offset {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& trace, const Tuple& /*args*/, T pointer)
+        {
+            WriteValue(trace, static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(pointer)));
+        }
+        template <typename T> struct Decoded : Argument {
+            std::uint64_t m_offset;
+            T Get(const auto& /*decoded*/) const { return reinterpret_cast<T>(static_cast<std::uintptr_t>(m_offset)); }
+        };
+        template <typename T> static Decoded<T> Read(TraceReader& reader, GLTraceNames& /*names*/)
+        {
+            return {{}, reader.Read<std::uint64_t>()};
+        }
+    };
+
+    // A pointer the call ignores, replayed as nullptr.
+    struct Null {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& /*trace*/, const Tuple& /*args*/, T) {}
+        template <typename T> struct Decoded : Argument {
+            T Get(const auto& /*decoded*/) const { return nullptr; }
+        };
+        template <typename T> static Decoded<T> Read(TraceReader& /*reader*/, GLTraceNames& /*names*/) { return {}; }
+    };
+
+    template <GLObjectType Type> struct Name {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& trace, const Tuple& /*args*/, T name)
+        {
+            WriteValue(trace, name);
+        }
+        template <typename T> using Decoded = Value::Decoded<GLuint>;
+        template <typename T> static Decoded<T> Read(TraceReader& reader, GLTraceNames& names)
+        {
+            return {{}, names.Find(Type, reader.Read<GLuint>())};
+        }
+    };
+
+    // The name of a texture, or of a renderbuffer if the argument at TargetIdx is GL_RENDERBUFFER.
+    template <size_t TargetIdx> struct ImageName {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& trace, const Tuple& args, T name)
+        {
+            WriteValue(trace, static_cast<std::uint8_t>(std::get<TargetIdx>(args) == GL_RENDERBUFFER));
+            WriteValue(trace, name);
+        }
+        template <typename T> using Decoded = Value::Decoded<GLuint>;
+        template <typename T> static Decoded<T> Read(TraceReader& reader, GLTraceNames& names)
+        {
+            GLObjectType type = reader.Read<std::uint8_t>() != 0 ? GLObjectType::Renderbuffer : GLObjectType::Texture;
+            return {{}, names.Find(type, reader.Read<GLuint>())};
+        }
+    };
+
+    // The count of the array argument at ArrayIdx, which records it.
+    template <size_t ArrayIdx> struct ArrayCount {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& /*trace*/, const Tuple& /*args*/, T) {}
+        template <typename T> struct Decoded : Argument {
+            T Get(const auto& decoded) const { return static_cast<T>(std::get<ArrayIdx>(decoded).GetCount()); }
+        };
+        template <typename T> static Decoded<T> Read(TraceReader& /*reader*/, GLTraceNames& /*names*/) { return {}; }
+    };
+
+    // An array of names, or nullptr, of the count at CountIdx.
+    template <GLObjectType Type, size_t CountIdx> struct Names {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& trace, const Tuple& args, T names)
+        {
+            WriteArray(trace, names, static_cast<size_t>(std::get<CountIdx>(args)));
+        }
+        template <typename T> struct Decoded : Argument {
+            std::vector<GLuint> m_names;
+            bool m_present;
+            size_t GetCount() const { return m_names.size(); }
+            T Get(const auto& /*decoded*/) const { return m_present ? m_names.data() : nullptr; }
+        };
+        template <typename T> static Decoded<T> Read(TraceReader& reader, GLTraceNames& names)
+        {
+            Decoded<T> decoded {};
+            decoded.m_present = reader.ReadArray(decoded.m_names);
+            if (decoded.m_present) {
+                for (GLuint& name : decoded.m_names) {
+                    name = names.Find(Type, name);
+                }
+            }
+            return decoded;
+        }
+    };
+
+    // The names a glCreate*() or glGen*() call returns, mapped to the ones it returns when replayed.
+    template <GLObjectType Type, size_t CountIdx> struct Created {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& trace, const Tuple& args, T names)
+        {
+            WriteArray(trace, names, static_cast<size_t>(std::get<CountIdx>(args)));
+        }
+        template <typename T> struct Decoded : Argument {
+            std::vector<GLuint> m_names;
+            std::vector<GLuint> m_created;
+            size_t GetCount() const { return m_names.size(); }
+            T Get(const auto& /*decoded*/) { return m_created.data(); }
+            void Finish(GLTraceNames& names)
+            {
+                for (size_t idx = 0; idx < m_names.size(); idx++) {
+                    names.Add(Type, m_names[idx], m_created[idx]);
+                }
+            }
+        };
+        template <typename T> static Decoded<T> Read(TraceReader& reader, GLTraceNames& /*names*/)
+        {
+            Decoded<T> decoded {};
+            reader.ReadArray(decoded.m_names);
+            decoded.m_created.resize(decoded.m_names.size());
+            return decoded;
+        }
+    };
+
+    // The names a glDelete*() call deletes, but for the objects the frame didn't create when replaying it, which the
+    // next loop still needs.
+    template <GLObjectType Type, size_t CountIdx> struct Deleted {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& trace, const Tuple& args, T names)
+        {
+            WriteArray(trace, names, static_cast<size_t>(std::get<CountIdx>(args)));
+        }
+        template <typename T> struct Decoded : Argument {
+            std::vector<GLuint> m_deleted;
+            size_t GetCount() const { return m_deleted.size(); }
+            bool Skip() const { return m_deleted.empty(); }
+            T Get(const auto& /*decoded*/) const { return m_deleted.data(); }
+        };
+        template <typename T> static Decoded<T> Read(TraceReader& reader, GLTraceNames& names)
+        {
+            std::vector<GLuint> recorded {};
+            reader.ReadArray(recorded);
+            Decoded<T> decoded {};
+            for (GLuint name : recorded) {
+                GLuint replayed = names.Find(Type, name);
+                if (replayed != 0 && names.Remove(Type, name, replayed)) {
+                    decoded.m_deleted.push_back(replayed);
+                }
+            }
+            return decoded;
+        }
+    };
+
+    // The single name of glDeleteProgram() or glDeleteShader(), see Deleted.
+    template <GLObjectType Type> struct DeletedName {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& trace, const Tuple& /*args*/, T name)
+        {
+            WriteValue(trace, name);
+        }
+        template <typename T> struct Decoded : Argument {
+            GLuint m_deleted;
+            bool Skip() const { return m_deleted == 0; }
+            T Get(const auto& /*decoded*/) const { return m_deleted; }
+        };
+        template <typename T> static Decoded<T> Read(TraceReader& reader, GLTraceNames& names)
+        {
+            auto name = reader.Read<GLuint>();
+            GLuint replayed = names.Find(Type, name);
+            return {{}, replayed != 0 && names.Remove(Type, name, replayed) ? replayed : 0};
+        }
+    };
+
+    // A sync of the frame. The calls on the syncs fenced before it are skipped.
+    template <bool Delete> struct SyncArgument {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& trace, const Tuple& /*args*/, T sync)
+        {
+            WriteValue(trace, static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(sync)));
+        }
+        template <typename T> struct Decoded : Argument {
+            GLsync m_sync;
+            bool Skip() const { return m_sync == nullptr; }
+            T Get(const auto& /*decoded*/) const { return m_sync; }
+        };
+        template <typename T> static Decoded<T> Read(TraceReader& reader, GLTraceNames& names)
+        {
+            auto it = names.m_syncs.find(reader.Read<std::uint64_t>());
+            if (it == names.m_syncs.end()) {
+                return {{}, nullptr};
+            }
+            GLsync sync = it->second;
+            if (Delete) {
+                names.m_syncs.erase(it);
+            }
+            return {{}, sync};
+        }
+    };
+    using Sync = SyncArgument<false>;
+    using DeletedSync = SyncArgument<true>;
+
+    // A pointer to the bytes `Size(args)` tells, or nullptr.
+    template <auto Size> struct Data {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& trace, const Tuple& args, T data)
+        {
+            WriteArray(trace, static_cast<const std::byte*>(static_cast<const void*>(data)), data ? Size(args) : 0);
+        }
+        template <typename T> struct Decoded : Argument {
+            std::vector<std::byte> m_bytes;
+            bool m_present;
+            T Get(const auto& /*decoded*/) const
+            {
+                return m_present ? static_cast<T>(static_cast<const void*>(m_bytes.data())) : nullptr;
+            }
+        };
+        template <typename T> static Decoded<T> Read(TraceReader& reader, GLTraceNames& /*names*/)
+        {
+            Decoded<T> decoded {};
+            decoded.m_present = reader.ReadArray(decoded.m_bytes);
+            return decoded;
+        }
+    };
+
+    // The pixels a call uploads, which are an offset into the pixel unpack buffer if one is bound, as when the texture
+    // uploaders fill their staging buffers, or `Size(args)` bytes of client memory otherwise.
+    template <auto Size> struct Image {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& trace, const Tuple& args, T pixels)
+        {
+            GLint unpackBuffer = 0;
+            glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpackBuffer);
+            WriteValue(trace, static_cast<std::uint8_t>(unpackBuffer != 0));
+            if (unpackBuffer != 0) {
+                Offset::Write(trace, args, pixels);
+            } else {
+                Data<Size>::Write(trace, args, pixels);
+            }
+        }
+        template <typename T> struct Decoded : Argument {
+            bool m_fromBuffer;
+            Offset::Decoded<T> m_offset;
+            typename Data<Size>::template Decoded<T> m_data;
+            T Get(const auto& decoded) const { return m_fromBuffer ? m_offset.Get(decoded) : m_data.Get(decoded); }
+        };
+        template <typename T> static Decoded<T> Read(TraceReader& reader, GLTraceNames& names)
+        {
+            Decoded<T> decoded {};
+            decoded.m_fromBuffer = reader.Read<std::uint8_t>() != 0;
+            if (decoded.m_fromBuffer) {
+                decoded.m_offset = Offset::Read<T>(reader, names);
+            } else {
+                decoded.m_data = Data<Size>::template Read<T>(reader, names);
+            }
+            return decoded;
+        }
+    };
+
+    // The pixels glReadPixels() writes, into the pixel pack buffer if one is bound, or into scratch memory of `Size(args)`
+    // bytes when replayed otherwise.
+    template <auto Size> struct PackedImage {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& trace, const Tuple& args, T pixels)
+        {
+            GLint packBuffer = 0;
+            glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &packBuffer);
+            WriteValue(trace, static_cast<std::uint8_t>(packBuffer != 0));
+            WriteValue(trace,
+                static_cast<std::uint64_t>(packBuffer != 0 ? reinterpret_cast<std::uintptr_t>(pixels) : Size(args)));
+        }
+        template <typename T> struct Decoded : Argument {
+            bool m_toBuffer;
+            std::uint64_t m_offset;
+            std::vector<std::byte> m_scratch;
+            bool Skip() const { return !m_toBuffer && m_offset > MAX_READ_SIZE; }
+            T Get(const auto& /*decoded*/)
+            {
+                if (m_toBuffer) {
+                    return reinterpret_cast<T>(static_cast<std::uintptr_t>(m_offset));
+                }
+                m_scratch.resize(m_offset);
+                return m_scratch.data();
+            }
+        };
+        template <typename T> static Decoded<T> Read(TraceReader& reader, GLTraceNames& /*names*/)
+        {
+            Decoded<T> decoded {};
+            decoded.m_toBuffer = reader.Read<std::uint8_t>() != 0;
+            decoded.m_offset = reader.Read<std::uint64_t>();
+            return decoded;
+        }
+    };
+
+    // A string of the length at LengthIdx, or null-terminated if it's negative or there's no length.
+    constexpr size_t NO_LENGTH = SIZE_MAX;
+    template <size_t LengthIdx = NO_LENGTH> struct String {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& trace, const Tuple& args, T text)
+        {
+            size_t length = std::strlen(text);
+            if constexpr (LengthIdx != NO_LENGTH) {
+                if (std::get<LengthIdx>(args) >= 0) {
+                    length = static_cast<size_t>(std::get<LengthIdx>(args));
+                }
+            }
+            WriteArray(trace, text, length);
+        }
+        template <typename T> struct Decoded : Argument {
+            std::string m_text;
+            T Get(const auto& /*decoded*/) const { return m_text.c_str(); }
+        };
+        template <typename T> static Decoded<T> Read(TraceReader& reader, GLTraceNames& /*names*/)
+        {
+            std::vector<char> text {};
+            reader.ReadArray(text);
+            return {{}, std::string(text.begin(), text.end())};
+        }
+    };
+
+    // The strings of glShaderSource(), with their lengths at LengthIdx, replayed null-terminated.
+    template <size_t CountIdx, size_t LengthIdx> struct Strings {
+        template <typename T, typename Tuple> static void Write(std::vector<std::byte>& trace, const Tuple& args, T strings)
+        {
+            auto count = static_cast<size_t>(std::get<CountIdx>(args));
+            const GLint* lengths = std::get<LengthIdx>(args);
+            WriteValue(trace, static_cast<std::uint64_t>(count));
+            for (size_t idx = 0; idx < count; idx++) {
+                bool terminated = !lengths || lengths[idx] < 0;
+                WriteArray(trace, strings[idx], terminated ? std::strlen(strings[idx]) : static_cast<size_t>(lengths[idx]));
+            }
+        }
+        template <typename T> struct Decoded : Argument {
+            std::vector<std::string> m_strings;
+            std::vector<const GLchar*> m_pointers;
+            size_t GetCount() const { return m_strings.size(); }
+            T Get(const auto& /*decoded*/)
+            {
+                m_pointers.clear();
+                for (const std::string& string : m_strings) {
+                    m_pointers.push_back(string.c_str());
+                }
+                return m_pointers.data();
+            }
+        };
+        template <typename T> static Decoded<T> Read(TraceReader& reader, GLTraceNames& /*names*/)
+        {
+            Decoded<T> decoded {};
+            auto count = reader.Read<std::uint64_t>();
+            for (std::uint64_t idx = 0; idx < count && !reader.HasFailed(); idx++) {
+                std::vector<char> text {};
+                reader.ReadArray(text);
+                decoded.m_strings.emplace_back(text.begin(), text.end());
+            }
+            return decoded;
+        }
+    };
+
+    // What the calls returning something record of it.
+    struct NoResult {};
+
+    struct IgnoredResult {
+        template <typename R> static void Write(std::vector<std::byte>& /*trace*/, R /*result*/) {}
+        struct Decoded {
+            template <typename R> void Finish(GLTraceNames& /*names*/, R /*result*/) {}
+        };
+        static Decoded Read(TraceReader& /*reader*/) { return {}; }
+    };
+
+    template <GLObjectType Type> struct NameResult {
+        static void Write(std::vector<std::byte>& trace, GLuint name) { WriteValue(trace, name); }
+        struct Decoded {
+            GLuint m_name;
+            void Finish(GLTraceNames& names, GLuint created) { names.Add(Type, m_name, created); }
+        };
+        static Decoded Read(TraceReader& reader) { return {reader.Read<GLuint>()}; }
+    };
+
+    struct SyncResult {
+        static void Write(std::vector<std::byte>& trace, GLsync sync)
+        {
+            WriteValue(trace, static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(sync)));
+        }
+        struct Decoded {
+            std::uint64_t m_sync;
+            void Finish(GLTraceNames& names, GLsync created)
+            {
+                GLsync& sync = names.m_syncs[m_sync];
+                if (sync) {
+                    glDeleteSync(sync);
+                }
+                sync = created;
+            }
+        };
+        static Decoded Read(TraceReader& reader) { return {reader.Read<std::uint64_t>()}; }
+    };
+
+    // A traced GL function, called through the glad pointer at Slot, with a spec per argument.
+    template <typename Proc, auto* Slot, typename Result, typename... Specs> struct TracedCall;
+
+    template <typename R, typename... Args, auto* Slot, typename Result, typename... Specs>
+    struct TracedCall<R(APIENTRYP)(Args...), Slot, Result, Specs...> {
+        static_assert(sizeof...(Args) == sizeof...(Specs), "Every argument needs a spec.");
+        static_assert(std::is_void_v<R> == std::is_same_v<Result, NoResult>, "Only the calls returning a value have a result.");
+
+        using Proc = R(APIENTRYP)(Args...);
+        using Arguments = std::tuple<Args...>;
+        using ResultSpec = Result;
+        static constexpr const void* SLOT = Slot;
+
+        static void Write(std::vector<std::byte>& trace, std::uint16_t opcode, const Arguments& args)
+        {
+            WriteValue(trace, opcode);
+            [&]<size_t... Is>(std::index_sequence<Is...>) {
+                (Specs::template Write<Args>(trace, args, std::get<Is>(args)), ...);
+            }(std::index_sequence_for<Args...> {});
+        }
+
+        static R APIENTRY Hook(Args... args)
+        {
+            if constexpr (std::is_void_v<R>) {
+                s_original(args...);
+                if (std::vector<std::byte>* trace = GetRecordingTrace()) {
+                    Write(*trace, s_opcode, Arguments(args...));
+                }
+            } else {
+                R result = s_original(args...);
+                if (std::vector<std::byte>* trace = GetRecordingTrace()) {
+                    Write(*trace, s_opcode, Arguments(args...));
+                    Result::Write(*trace, result);
+                }
+                return result;
+            }
+        }
+
+        static void Install(std::uint16_t opcode)
+        {
+            s_opcode = opcode;
+            s_original = *Slot;
+            *Slot = &Hook;
+        }
+        static void Uninstall()
+        {
+            if (s_original) {
+                *Slot = s_original;
+            }
+        }
+
+        static void Replay(TraceReader& reader, GLTraceNames& names)
+        {
+            std::tuple<typename Specs::template Decoded<Args>...> decoded {Specs::template Read<Args>(reader, names)...};
+            if constexpr (std::is_void_v<R>) {
+                if (reader.HasFailed() || std::apply([](const auto&... arguments) { return (arguments.Skip() || ...); }, decoded)) {
+                    return;
+                }
+                std::apply([&](auto&... arguments) { (*Slot)(arguments.Get(decoded)...); }, decoded);
+            } else {
+                typename Result::Decoded result = Result::Read(reader);
+                if (reader.HasFailed() || std::apply([](const auto&... arguments) { return (arguments.Skip() || ...); }, decoded)) {
+                    return;
+                }
+                result.Finish(names, std::apply([&](auto&... arguments) { return (*Slot)(arguments.Get(decoded)...); }, decoded));
+            }
+            std::apply([&](auto&... arguments) { (arguments.Finish(names), ...); }, decoded);
+        }
+
+        static inline Proc s_original {};
+        static inline std::uint16_t s_opcode {};
+    };
+
+    template <auto* Slot, typename... Specs>
+    using Call = TracedCall<std::remove_pointer_t<decltype(Slot)>, Slot, NoResult, Specs...>;
+    template <auto* Slot, typename Result, typename... Specs>
+    using ReturningCall = TracedCall<std::remove_pointer_t<decltype(Slot)>, Slot, Result, Specs...>;
+
+    // The bytes of the array argument of the count at CountIdx.
+    template <size_t CountIdx, size_t ElementSize = 1>
+    constexpr auto ARRAY_BYTES = [](const auto& args) { return static_cast<size_t>(std::get<CountIdx>(args)) * ElementSize; };
+    // The bytes of a glTextureParameterfv() or glSamplerParameterfv() value.
+    constexpr auto PARAMETER_BYTES = [](const auto& args) { return std::get<1>(args) == GL_TEXTURE_BORDER_COLOR ? 16 : 4; };
+    // The bytes of a glClearBuffer*() value, of `ElementSize` per component.
+    template <size_t BufferIdx, size_t ElementSize>
+    constexpr auto CLEAR_BYTES
+        = [](const auto& args) { return std::get<BufferIdx>(args) == GL_COLOR ? 4 * ElementSize : ElementSize; };
+
+    size_t GetPixelSize(GLenum format, GLenum type)
+    {
+        switch (type) {
+        case GL_UNSIGNED_BYTE_3_3_2:
+        case GL_UNSIGNED_BYTE_2_3_3_REV:
+            return 1;
+        case GL_UNSIGNED_SHORT_5_6_5:
+        case GL_UNSIGNED_SHORT_5_6_5_REV:
+        case GL_UNSIGNED_SHORT_4_4_4_4:
+        case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+        case GL_UNSIGNED_SHORT_5_5_5_1:
+        case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+            return 2;
+        case GL_UNSIGNED_INT_8_8_8_8:
+        case GL_UNSIGNED_INT_8_8_8_8_REV:
+        case GL_UNSIGNED_INT_10_10_10_2:
+        case GL_UNSIGNED_INT_2_10_10_10_REV:
+        case GL_UNSIGNED_INT_24_8:
+        case GL_UNSIGNED_INT_10F_11F_11F_REV:
+        case GL_UNSIGNED_INT_5_9_9_9_REV:
+            return 4;
+        case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+            return 8;
+        default:
+            break;
+        }
+
+        size_t componentSize = 0;
+        switch (type) {
+        case GL_UNSIGNED_BYTE:
+        case GL_BYTE:
+            componentSize = 1;
+            break;
+        case GL_UNSIGNED_SHORT:
+        case GL_SHORT:
+        case GL_HALF_FLOAT:
+            componentSize = 2;
+            break;
+        case GL_UNSIGNED_INT:
+        case GL_INT:
+        case GL_FLOAT:
+            componentSize = 4;
+            break;
+        default:
+            return 0;
+        }
+
+        switch (format) {
+        case GL_RED:
+        case GL_GREEN:
+        case GL_BLUE:
+        case GL_RED_INTEGER:
+        case GL_GREEN_INTEGER:
+        case GL_BLUE_INTEGER:
+        case GL_DEPTH_COMPONENT:
+        case GL_STENCIL_INDEX:
+            return componentSize;
+        case GL_RG:
+        case GL_RG_INTEGER:
+            return 2 * componentSize;
+        case GL_RGB:
+        case GL_BGR:
+        case GL_RGB_INTEGER:
+        case GL_BGR_INTEGER:
+            return 3 * componentSize;
+        case GL_RGBA:
+        case GL_BGRA:
+        case GL_RGBA_INTEGER:
+        case GL_BGRA_INTEGER:
+            return 4 * componentSize;
+        default:
+            return 0;
+        }
+    }
+
+    // The bytes of an image of `width` x `height` x `depth` pixels in client memory, with the rows aligned as the current
+    // `alignmentParameter` tells, GL_UNPACK_ALIGNMENT or GL_PACK_ALIGNMENT. Glitter leaves the other pixel storage modes to
+    // their defaults.
+    size_t GetImageSize(GLenum alignmentParameter, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type)
+    {
+        size_t pixelSize = GetPixelSize(format, type);
+        if (width <= 0 || height <= 0 || depth <= 0 || pixelSize == 0) {
+            return 0;
+        }
+        GLint alignment = 4;
+        glGetIntegerv(alignmentParameter, &alignment);
+        auto align = static_cast<size_t>(std::max(alignment, 1));
+        size_t rowSize = (static_cast<size_t>(width) * pixelSize + align - 1) / align * align;
+        return rowSize * (static_cast<size_t>(height) * static_cast<size_t>(depth) - 1) + static_cast<size_t>(width) * pixelSize;
+    }
+
+    constexpr size_t NO_DEPTH = SIZE_MAX;
+    template <size_t WidthIdx, size_t HeightIdx, size_t DepthIdx, size_t FormatIdx, size_t TypeIdx, GLenum Alignment>
+    constexpr auto IMAGE_BYTES = [](const auto& args) {
+        GLsizei depth = 1;
+        if constexpr (DepthIdx != NO_DEPTH) {
+            depth = std::get<DepthIdx>(args);
+        }
+        return GetImageSize(Alignment, std::get<WidthIdx>(args), std::get<HeightIdx>(args), depth, std::get<FormatIdx>(args),
+            std::get<TypeIdx>(args));
+    };
+    template <size_t FormatIdx, size_t TypeIdx>
+    constexpr auto PIXEL_BYTES = [](const auto& args) { return GetPixelSize(std::get<FormatIdx>(args), std::get<TypeIdx>(args)); };
+
+    using enum GLObjectType;
+
+    // Every GL function Glitter calls but for the queries, and those the snapshot of the context replays. The index of
+    // each is its opcode in the traces.
+    using CallTable = std::tuple<
+        // Buffers.
+        Call<&glad_glCreateBuffers, ArrayCount<1>, Created<Buffer, 0>>,
+        Call<&glad_glDeleteBuffers, ArrayCount<1>, Deleted<Buffer, 0>>,
+        Call<&glad_glNamedBufferStorage, Name<Buffer>, Value, Data<ARRAY_BYTES<1>>, Value>,
+        Call<&glad_glNamedBufferData, Name<Buffer>, Value, Data<ARRAY_BYTES<1>>, Value>,
+        Call<&glad_glNamedBufferSubData, Name<Buffer>, Value, Value, Data<ARRAY_BYTES<2>>>,
+        Call<&glad_glCopyNamedBufferSubData, Name<Buffer>, Name<Buffer>, Value, Value, Value>,
+        Call<&glad_glInvalidateBufferData, Name<Buffer>>,
+        Call<&glad_glBindBuffer, Value, Name<Buffer>>,
+        Call<&glad_glBindBufferBase, Value, Value, Name<Buffer>>,
+        Call<&glad_glBindBufferRange, Value, Value, Name<Buffer>, Value, Value>,
+        Call<&glad_glBindBuffersBase, Value, Value, Value, Names<Buffer, 2>>,
+
+        // Textures.
+        Call<&glad_glCreateTextures, Value, ArrayCount<2>, Created<Texture, 1>>,
+        Call<&glad_glDeleteTextures, ArrayCount<1>, Deleted<Texture, 0>>,
+        Call<&glad_glGenTextures, ArrayCount<1>, Created<Texture, 0>>,
+        Call<&glad_glTextureView, Name<Texture>, Value, Name<Texture>, Value, Value, Value, Value, Value>,
+        Call<&glad_glTextureStorage2D, Name<Texture>, Value, Value, Value, Value>,
+        Call<&glad_glTextureStorage3D, Name<Texture>, Value, Value, Value, Value, Value>,
+        Call<&glad_glTextureStorage2DMultisample, Name<Texture>, Value, Value, Value, Value, Value>,
+        Call<&glad_glTextureStorage3DMultisample, Name<Texture>, Value, Value, Value, Value, Value, Value>,
+        Call<&glad_glTextureSubImage2D, Name<Texture>, Value, Value, Value, Value, Value, Value, Value,
+            Image<IMAGE_BYTES<4, 5, NO_DEPTH, 6, 7, GL_UNPACK_ALIGNMENT>>>,
+        Call<&glad_glTextureSubImage3D, Name<Texture>, Value, Value, Value, Value, Value, Value, Value, Value, Value,
+            Image<IMAGE_BYTES<5, 6, 7, 8, 9, GL_UNPACK_ALIGNMENT>>>,
+        Call<&glad_glCompressedTextureSubImage2D, Name<Texture>, Value, Value, Value, Value, Value, Value, Value,
+            Image<ARRAY_BYTES<7>>>,
+        Call<&glad_glCompressedTextureSubImage3D, Name<Texture>, Value, Value, Value, Value, Value, Value, Value, Value, Value,
+            Image<ARRAY_BYTES<9>>>,
+        Call<&glad_glTextureParameteri, Name<Texture>, Value, Value>,
+        Call<&glad_glTextureParameterf, Name<Texture>, Value, Value>,
+        Call<&glad_glTextureParameterfv, Name<Texture>, Value, Data<PARAMETER_BYTES>>,
+        Call<&glad_glGenerateTextureMipmap, Name<Texture>>,
+        Call<&glad_glClearTexImage, Name<Texture>, Value, Value, Value, Data<PIXEL_BYTES<2, 3>>>,
+        Call<&glad_glInvalidateTexImage, Name<Texture>, Value>,
+        Call<&glad_glCopyImageSubData, ImageName<1>, Value, Value, Value, Value, Value, ImageName<7>, Value, Value, Value, Value,
+            Value, Value, Value, Value>,
+        Call<&glad_glBindTextureUnit, Value, Name<Texture>>,
+        Call<&glad_glBindTextures, Value, Value, Names<Texture, 1>>,
+        Call<&glad_glBindImageTexture, Value, Name<Texture>, Value, Value, Value, Value, Value>,
+        Call<&glad_glBindImageTextures, Value, Value, Names<Texture, 1>>,
+        Call<&glad_glActiveTexture, Value>,
+
+        // Samplers.
+        Call<&glad_glCreateSamplers, ArrayCount<1>, Created<Sampler, 0>>,
+        Call<&glad_glDeleteSamplers, ArrayCount<1>, Deleted<Sampler, 0>>,
+        Call<&glad_glSamplerParameteri, Name<Sampler>, Value, Value>,
+        Call<&glad_glSamplerParameterf, Name<Sampler>, Value, Value>,
+        Call<&glad_glSamplerParameterfv, Name<Sampler>, Value, Data<PARAMETER_BYTES>>,
+        Call<&glad_glBindSampler, Value, Name<Sampler>>,
+        Call<&glad_glBindSamplers, Value, Value, Names<Sampler, 1>>,
+
+        // Renderbuffers and framebuffers.
+        Call<&glad_glCreateRenderbuffers, ArrayCount<1>, Created<Renderbuffer, 0>>,
+        Call<&glad_glDeleteRenderbuffers, ArrayCount<1>, Deleted<Renderbuffer, 0>>,
+        Call<&glad_glNamedRenderbufferStorage, Name<Renderbuffer>, Value, Value, Value>,
+        Call<&glad_glNamedRenderbufferStorageMultisample, Name<Renderbuffer>, Value, Value, Value, Value>,
+        Call<&glad_glCreateFramebuffers, ArrayCount<1>, Created<Framebuffer, 0>>,
+        Call<&glad_glDeleteFramebuffers, ArrayCount<1>, Deleted<Framebuffer, 0>>,
+        Call<&glad_glBindFramebuffer, Value, Name<Framebuffer>>,
+        Call<&glad_glNamedFramebufferTexture, Name<Framebuffer>, Value, Name<Texture>, Value>,
+        Call<&glad_glNamedFramebufferTextureLayer, Name<Framebuffer>, Value, Name<Texture>, Value, Value>,
+        Call<&glad_glNamedFramebufferRenderbuffer, Name<Framebuffer>, Value, Value, Name<Renderbuffer>>,
+        Call<&glad_glNamedFramebufferDrawBuffer, Name<Framebuffer>, Value>,
+        Call<&glad_glNamedFramebufferDrawBuffers, Name<Framebuffer>, Value, Data<ARRAY_BYTES<1, sizeof(GLenum)>>>,
+        Call<&glad_glNamedFramebufferReadBuffer, Name<Framebuffer>, Value>,
+        Call<&glad_glInvalidateNamedFramebufferData, Name<Framebuffer>, Value, Data<ARRAY_BYTES<1, sizeof(GLenum)>>>,
+        Call<&glad_glBlitNamedFramebuffer, Name<Framebuffer>, Name<Framebuffer>, Value, Value, Value, Value, Value, Value, Value,
+            Value, Value, Value>,
+        Call<&glad_glClearNamedFramebufferfv, Name<Framebuffer>, Value, Value, Data<CLEAR_BYTES<1, sizeof(GLfloat)>>>,
+        Call<&glad_glClearNamedFramebufferuiv, Name<Framebuffer>, Value, Value, Data<CLEAR_BYTES<1, sizeof(GLuint)>>>,
+        Call<&glad_glClearBufferuiv, Value, Value, Data<CLEAR_BYTES<0, sizeof(GLuint)>>>,
+        Call<&glad_glClear, Value>,
+        Call<&glad_glClearColor, Value, Value, Value, Value>,
+        Call<&glad_glClearDepth, Value>,
+        Call<&glad_glClearStencil, Value>,
+        Call<&glad_glReadPixels, Value, Value, Value, Value, Value, Value,
+            PackedImage<IMAGE_BYTES<2, 3, NO_DEPTH, 4, 5, GL_PACK_ALIGNMENT>>>,
+
+        // Vertex arrays.
+        Call<&glad_glCreateVertexArrays, ArrayCount<1>, Created<VertexArray, 0>>,
+        Call<&glad_glDeleteVertexArrays, ArrayCount<1>, Deleted<VertexArray, 0>>,
+        Call<&glad_glBindVertexArray, Name<VertexArray>>,
+        Call<&glad_glEnableVertexArrayAttrib, Name<VertexArray>, Value>,
+        Call<&glad_glDisableVertexArrayAttrib, Name<VertexArray>, Value>,
+        Call<&glad_glVertexArrayAttribFormat, Name<VertexArray>, Value, Value, Value, Value, Value>,
+        Call<&glad_glVertexArrayAttribIFormat, Name<VertexArray>, Value, Value, Value, Value>,
+        Call<&glad_glVertexArrayAttribLFormat, Name<VertexArray>, Value, Value, Value, Value>,
+        Call<&glad_glVertexArrayAttribBinding, Name<VertexArray>, Value, Value>,
+        Call<&glad_glVertexArrayBindingDivisor, Name<VertexArray>, Value, Value>,
+        Call<&glad_glVertexArrayVertexBuffer, Name<VertexArray>, Value, Name<Buffer>, Value, Value>,
+        Call<&glad_glVertexArrayElementBuffer, Name<VertexArray>, Name<Buffer>>,
+
+        // Queries.
+        Call<&glad_glCreateQueries, Value, ArrayCount<2>, Created<Query, 1>>,
+        Call<&glad_glGenQueries, ArrayCount<1>, Created<Query, 0>>,
+        Call<&glad_glDeleteQueries, ArrayCount<1>, Deleted<Query, 0>>,
+        Call<&glad_glBeginQuery, Value, Name<Query>>,
+        Call<&glad_glEndQuery, Value>,
+        Call<&glad_glQueryCounter, Name<Query>, Value>,
+        Call<&glad_glBeginConditionalRender, Name<Query>, Value>,
+        Call<&glad_glEndConditionalRender>,
+
+        // Programs.
+        ReturningCall<&glad_glCreateProgram, NameResult<Program>>,
+        ReturningCall<&glad_glCreateShader, NameResult<Shader>, Value>,
+        Call<&glad_glDeleteProgram, DeletedName<Program>>,
+        Call<&glad_glDeleteShader, DeletedName<Shader>>,
+        Call<&glad_glShaderSource, Name<Shader>, ArrayCount<2>, Strings<1, 3>, Null>,
+        Call<&glad_glCompileShader, Name<Shader>>,
+        Call<&glad_glShaderBinary, Value, Names<Shader, 0>, Value, Data<ARRAY_BYTES<4>>, Value>,
+        Call<&glad_glSpecializeShader, Name<Shader>, String<>, Value, Data<ARRAY_BYTES<2, sizeof(GLuint)>>,
+            Data<ARRAY_BYTES<2, sizeof(GLuint)>>>,
+        Call<&glad_glAttachShader, Name<Program>, Name<Shader>>,
+        Call<&glad_glLinkProgram, Name<Program>>,
+        Call<&glad_glProgramBinary, Name<Program>, Value, Data<ARRAY_BYTES<3>>, Value>,
+        Call<&glad_glProgramParameteri, Name<Program>, Value, Value>,
+        Call<&glad_glUseProgram, Name<Program>>,
+        Call<&glad_glUniform1f, Value, Value>,
+        Call<&glad_glUniform2f, Value, Value, Value>,
+        Call<&glad_glUniform3f, Value, Value, Value, Value>,
+        Call<&glad_glUniform1i, Value, Value>,
+        Call<&glad_glUniform2i, Value, Value, Value>,
+        Call<&glad_glUniform1ui, Value, Value>,
+        Call<&glad_glUniform4fv, Value, Value, Data<ARRAY_BYTES<1, 4 * sizeof(GLfloat)>>>,
+        Call<&glad_glUniformMatrix4fv, Value, Value, Value, Data<ARRAY_BYTES<1, 16 * sizeof(GLfloat)>>>,
+        Call<&glad_glProgramUniform1fv, Name<Program>, Value, Value, Data<ARRAY_BYTES<2, sizeof(GLfloat)>>>,
+        Call<&glad_glProgramUniform2fv, Name<Program>, Value, Value, Data<ARRAY_BYTES<2, 2 * sizeof(GLfloat)>>>,
+        Call<&glad_glProgramUniform3fv, Name<Program>, Value, Value, Data<ARRAY_BYTES<2, 3 * sizeof(GLfloat)>>>,
+        Call<&glad_glProgramUniform4fv, Name<Program>, Value, Value, Data<ARRAY_BYTES<2, 4 * sizeof(GLfloat)>>>,
+        Call<&glad_glProgramUniform1iv, Name<Program>, Value, Value, Data<ARRAY_BYTES<2, sizeof(GLint)>>>,
+        Call<&glad_glProgramUniform2iv, Name<Program>, Value, Value, Data<ARRAY_BYTES<2, 2 * sizeof(GLint)>>>,
+        Call<&glad_glProgramUniform3iv, Name<Program>, Value, Value, Data<ARRAY_BYTES<2, 3 * sizeof(GLint)>>>,
+        Call<&glad_glProgramUniform4iv, Name<Program>, Value, Value, Data<ARRAY_BYTES<2, 4 * sizeof(GLint)>>>,
+        Call<&glad_glProgramUniform1uiv, Name<Program>, Value, Value, Data<ARRAY_BYTES<2, sizeof(GLuint)>>>,
+        Call<&glad_glProgramUniform2uiv, Name<Program>, Value, Value, Data<ARRAY_BYTES<2, 2 * sizeof(GLuint)>>>,
+        Call<&glad_glProgramUniform3uiv, Name<Program>, Value, Value, Data<ARRAY_BYTES<2, 3 * sizeof(GLuint)>>>,
+        Call<&glad_glProgramUniform4uiv, Name<Program>, Value, Value, Data<ARRAY_BYTES<2, 4 * sizeof(GLuint)>>>,
+        Call<&glad_glProgramUniformMatrix3fv, Name<Program>, Value, Value, Value, Data<ARRAY_BYTES<2, 9 * sizeof(GLfloat)>>>,
+        Call<&glad_glProgramUniformMatrix4fv, Name<Program>, Value, Value, Value, Data<ARRAY_BYTES<2, 16 * sizeof(GLfloat)>>>,
+
+        // Fixed-function state.
+        Call<&glad_glEnable, Value>,
+        Call<&glad_glDisable, Value>,
+        Call<&glad_glEnablei, Value, Value>,
+        Call<&glad_glDisablei, Value, Value>,
+        Call<&glad_glBlendFunc, Value, Value>,
+        Call<&glad_glBlendFunci, Value, Value, Value>,
+        Call<&glad_glBlendFuncSeparatei, Value, Value, Value, Value, Value>,
+        Call<&glad_glBlendEquationSeparatei, Value, Value, Value>,
+        Call<&glad_glBlendColor, Value, Value, Value, Value>,
+        Call<&glad_glColorMask, Value, Value, Value, Value>,
+        Call<&glad_glColorMaski, Value, Value, Value, Value, Value>,
+        Call<&glad_glDepthFunc, Value>,
+        Call<&glad_glDepthMask, Value>,
+        Call<&glad_glDepthRange, Value, Value>,
+        Call<&glad_glClipControl, Value, Value>,
+        Call<&glad_glStencilFuncSeparate, Value, Value, Value, Value>,
+        Call<&glad_glStencilOpSeparate, Value, Value, Value, Value>,
+        Call<&glad_glStencilMaskSeparate, Value, Value>,
+        Call<&glad_glCullFace, Value>,
+        Call<&glad_glFrontFace, Value>,
+        Call<&glad_glPolygonMode, Value, Value>,
+        Call<&glad_glPolygonOffset, Value, Value>,
+        Call<&glad_glLineWidth, Value>,
+        Call<&glad_glPointSize, Value>,
+        Call<&glad_glPrimitiveRestartIndex, Value>,
+        Call<&glad_glViewport, Value, Value, Value, Value>,
+        Call<&glad_glScissor, Value, Value, Value, Value>,
+        Call<&glad_glPixelStorei, Value, Value>,
+        Call<&glad_glHint, Value, Value>,
+
+        // Draws and dispatches.
+        Call<&glad_glDrawArrays, Value, Value, Value>,
+        Call<&glad_glDrawArraysInstanced, Value, Value, Value, Value>,
+        Call<&glad_glDrawArraysInstancedBaseInstance, Value, Value, Value, Value, Value>,
+        Call<&glad_glDrawElementsBaseVertex, Value, Value, Value, Offset, Value>,
+        Call<&glad_glDrawElementsInstancedBaseVertexBaseInstance, Value, Value, Value, Offset, Value, Value, Value>,
+        Call<&glad_glMultiDrawElementsIndirect, Value, Value, Offset, Value, Value>,
+        Call<&glad_glMultiDrawElementsIndirectCount, Value, Value, Offset, Value, Value, Value>,
+        Call<&glad_glDispatchCompute, Value, Value, Value>,
+        Call<&glad_glDispatchComputeIndirect, Value>,
+        Call<&glad_glMemoryBarrier, Value>,
+
+        // Synchronization and debug groups.
+        ReturningCall<&glad_glFenceSync, SyncResult, Value, Value>,
+        ReturningCall<&glad_glClientWaitSync, IgnoredResult, Sync, Value, Value>,
+        Call<&glad_glWaitSync, Sync, Value, Value>,
+        Call<&glad_glDeleteSync, DeletedSync>,
+        Call<&glad_glFlush>,
+        Call<&glad_glFinish>,
+        Call<&glad_glPushDebugGroup, Value, Value, Value, String<2>>,
+        Call<&glad_glPopDebugGroup>>;
+
+    constexpr size_t CALL_COUNT = std::tuple_size_v<CallTable>;
+
+    template <auto* Slot, size_t Idx = 0> consteval size_t FindCall()
+    {
+        if constexpr (Idx == CALL_COUNT) {
+            return Idx;
+        } else if constexpr (std::tuple_element_t<Idx, CallTable>::SLOT == static_cast<const void*>(Slot)) {
+            return Idx;
+        } else {
+            return FindCall<Slot, Idx + 1>();
+        }
+    }
+
+    // Records a call the snapshot replays, without making it.
+    template <auto* Slot, typename... Args> void Emit(std::vector<std::byte>& trace, Args... args)
+    {
+        constexpr size_t CALL_IDX = FindCall<Slot>();
+        static_assert(CALL_IDX < CALL_COUNT, "Not a traced call.");
+        using Traced = std::tuple_element_t<CALL_IDX, CallTable>;
+        Traced::Write(trace, static_cast<std::uint16_t>(CALL_IDX), typename Traced::Arguments(args...));
+    }
+    template <auto* Slot, typename R, typename... Args> void EmitReturning(std::vector<std::byte>& trace, R result, Args... args)
+    {
+        Emit<Slot>(trace, args...);
+        std::tuple_element_t<FindCall<Slot>(), CallTable>::ResultSpec::Write(trace, result);
+    }
+
+    void InstallHooks()
+    {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            (std::tuple_element_t<Is, CallTable>::Install(static_cast<std::uint16_t>(Is)), ...);
+        }(std::make_index_sequence<CALL_COUNT> {});
+    }
+    void UninstallHooks()
+    {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            (std::tuple_element_t<Is, CallTable>::Uninstall(), ...);
+        }(std::make_index_sequence<CALL_COUNT> {});
+    }
+
+    using ReplayFunction = void (*)(TraceReader&, GLTraceNames&);
+    constexpr auto REPLAY_FUNCTIONS = []<size_t... Is>(std::index_sequence<Is...>) {
+        return std::array<ReplayFunction, CALL_COUNT> {&std::tuple_element_t<Is, CallTable>::Replay...};
+    }(std::make_index_sequence<CALL_COUNT> {});
+
+    // Calls `visit` with every name `isName` accepts, up to Config::GL_TRACE_NAME_GAP names past the last one it did.
+    template <typename IsName, typename Visit> void ForEachName(IsName isName, Visit&& visit)
+    {
+        std::uint32_t gap = 0;
+        for (GLuint name = 1; gap < Config::GL_TRACE_NAME_GAP; name++) {
+            if (isName(name) == GL_TRUE) {
+                visit(name);
+                gap = 0;
+            } else {
+                gap++;
+            }
+        }
+    }
+
+    GLint GetInteger(GLenum parameter)
+    {
+        GLint value = 0;
+        glGetIntegerv(parameter, &value);
+        return value;
+    }
+    GLint GetIntegerIndexed(GLenum parameter, GLuint index)
+    {
+        GLint value = 0;
+        glGetIntegeri_v(parameter, index, &value);
+        return value;
+    }
+
+    // Records the creation of `buffer`, with `contents` if they could be read.
+    void EmitBuffer(std::vector<std::byte>& trace, GLuint buffer, const void* contents)
+    {
+        GLint64 size = 0;
+        GLint immutable = GL_FALSE;
+        GLint flags = 0;
+        GLint usage = 0;
+        glGetNamedBufferParameteri64v(buffer, GL_BUFFER_SIZE, &size);
+        glGetNamedBufferParameteriv(buffer, GL_BUFFER_IMMUTABLE_STORAGE, &immutable);
+        glGetNamedBufferParameteriv(buffer, GL_BUFFER_STORAGE_FLAGS, &flags);
+        glGetNamedBufferParameteriv(buffer, GL_BUFFER_USAGE, &usage);
+
+        Emit<&glad_glCreateBuffers>(trace, 1, &buffer);
+        if (immutable == GL_TRUE) {
+            Emit<&glad_glNamedBufferStorage>(trace, buffer, size, contents, flags);
+        } else if (size > 0) {
+            Emit<&glad_glNamedBufferData>(trace, buffer, size, contents, usage);
+        }
+    }
+
+    std::vector<std::byte> ReadBuffer(GLuint buffer)
+    {
+        GLint64 size = 0;
+        glGetNamedBufferParameteri64v(buffer, GL_BUFFER_SIZE, &size);
+        std::vector<std::byte> contents(static_cast<size_t>(size));
+        glGetNamedBufferSubData(buffer, 0, size, contents.data());
+        return contents;
+    }
+
+    // The persistently mapped buffers are left for the end of the frame.
+    void SnapshotBuffers(std::vector<std::byte>& trace, std::vector<GLuint>& mappedBuffers)
+    {
+        ForEachName(glIsBuffer, [&](GLuint buffer) {
+            GLint mapped = GL_FALSE;
+            GLint access = 0;
+            glGetNamedBufferParameteriv(buffer, GL_BUFFER_MAPPED, &mapped);
+            glGetNamedBufferParameteriv(buffer, GL_BUFFER_ACCESS_FLAGS, &access);
+            if (mapped == GL_TRUE && (access & GL_MAP_PERSISTENT_BIT) != 0) {
+                mappedBuffers.push_back(buffer);
+                return;
+            }
+            if (mapped == GL_TRUE) {
+                spdlog::warn("Buffer {} is mapped, it's traced without its contents.", buffer);
+                EmitBuffer(trace, buffer, nullptr);
+                return;
+            }
+            std::vector<std::byte> contents = ReadBuffer(buffer);
+            EmitBuffer(trace, buffer, contents.empty() ? nullptr : contents.data());
+        });
+    }
+
+    constexpr std::array<GLenum, 7> SAMPLER_INT_PARAMETERS {GL_TEXTURE_MIN_FILTER, GL_TEXTURE_MAG_FILTER, GL_TEXTURE_WRAP_S,
+        GL_TEXTURE_WRAP_T, GL_TEXTURE_WRAP_R, GL_TEXTURE_COMPARE_MODE, GL_TEXTURE_COMPARE_FUNC};
+    constexpr std::array<GLenum, 6> TEXTURE_INT_PARAMETERS {GL_TEXTURE_BASE_LEVEL, GL_TEXTURE_MAX_LEVEL, GL_TEXTURE_SWIZZLE_R,
+        GL_TEXTURE_SWIZZLE_G, GL_TEXTURE_SWIZZLE_B, GL_TEXTURE_SWIZZLE_A};
+    constexpr std::array<GLenum, 4> SAMPLER_FLOAT_PARAMETERS {
+        GL_TEXTURE_MIN_LOD, GL_TEXTURE_MAX_LOD, GL_TEXTURE_LOD_BIAS, GL_TEXTURE_MAX_ANISOTROPY};
+
+    void SnapshotTextureContents(std::vector<std::byte>& trace, GLuint texture, GLenum target, GLint levels, GLenum format)
+    {
+        bool layered = target == GL_TEXTURE_3D || target == GL_TEXTURE_2D_ARRAY;
+        for (GLint level = 0; level < levels; level++) {
+            GLint width = 0;
+            GLint height = 0;
+            GLint depth = 0;
+            GLint compressed = GL_FALSE;
+            glGetTextureLevelParameteriv(texture, level, GL_TEXTURE_WIDTH, &width);
+            glGetTextureLevelParameteriv(texture, level, GL_TEXTURE_HEIGHT, &height);
+            glGetTextureLevelParameteriv(texture, level, GL_TEXTURE_DEPTH, &depth);
+            glGetTextureLevelParameteriv(texture, level, GL_TEXTURE_COMPRESSED, &compressed);
+
+            if (compressed == GL_TRUE) {
+                GLint size = 0;
+                glGetTextureLevelParameteriv(texture, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+                std::vector<std::byte> pixels(static_cast<size_t>(size));
+                glGetCompressedTextureImage(texture, level, size, pixels.data());
+                if (layered) {
+                    Emit<&glad_glCompressedTextureSubImage3D>(
+                        trace, texture, level, 0, 0, 0, width, height, depth, format, size, pixels.data());
+                } else {
+                    Emit<&glad_glCompressedTextureSubImage2D>(
+                        trace, texture, level, 0, 0, width, height, format, size, pixels.data());
+                }
+                continue;
+            }
+
+            GLint pixelFormat = 0;
+            GLint pixelType = 0;
+            glGetInternalformativ(target, format, GL_TEXTURE_IMAGE_FORMAT, 1, &pixelFormat);
+            glGetInternalformativ(target, format, GL_TEXTURE_IMAGE_TYPE, 1, &pixelType);
+            size_t size = GetImageSize(GL_PACK_ALIGNMENT, width, height, depth, pixelFormat, pixelType);
+            if (size == 0) {
+                spdlog::warn("Texture {} has a format whose pixels can't be read, it's traced without its contents.", texture);
+                return;
+            }
+            std::vector<std::byte> pixels(size);
+            glGetTextureImage(texture, level, pixelFormat, pixelType, static_cast<GLsizei>(size), pixels.data());
+            if (layered) {
+                Emit<&glad_glTextureSubImage3D>(
+                    trace, texture, level, 0, 0, 0, width, height, depth, pixelFormat, pixelType, pixels.data());
+            } else {
+                Emit<&glad_glTextureSubImage2D>(trace, texture, level, 0, 0, width, height, pixelFormat, pixelType, pixels.data());
+            }
+        }
+    }
+
+    void SnapshotTextures(std::vector<std::byte>& trace)
+    {
+        ForEachName(glIsTexture, [&](GLuint texture) {
+            GLint target = 0;
+            glGetTextureParameteriv(texture, GL_TEXTURE_TARGET, &target);
+            if (target == 0) {
+                // Generated but never bound, which Glitter doesn't do.
+                return;
+            }
+            Emit<&glad_glCreateTextures>(trace, target, 1, &texture);
+
+            GLint immutable = GL_FALSE;
+            GLint levels = 0;
+            glGetTextureParameteriv(texture, GL_TEXTURE_IMMUTABLE_FORMAT, &immutable);
+            if (immutable == GL_TRUE) {
+                glGetTextureParameteriv(texture, GL_TEXTURE_IMMUTABLE_LEVELS, &levels);
+            } else {
+                GLint width = 1;
+                for (; levels < 32 && width > 0; levels++) {
+                    glGetTextureLevelParameteriv(texture, levels, GL_TEXTURE_WIDTH, &width);
+                }
+                levels -= width > 0 ? 0 : 1;
+            }
+            GLint format = 0;
+            GLint width = 0;
+            GLint height = 0;
+            GLint depth = 0;
+            GLint samples = 0;
+            GLint fixedLocations = GL_TRUE;
+            glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_INTERNAL_FORMAT, &format);
+            glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_WIDTH, &width);
+            glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_HEIGHT, &height);
+            glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_DEPTH, &depth);
+            glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_SAMPLES, &samples);
+            glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_FIXED_SAMPLE_LOCATIONS, &fixedLocations);
+            if (levels == 0 || width == 0) {
+                return;
+            }
+
+            switch (target) {
+            case GL_TEXTURE_2D:
+            case GL_TEXTURE_RECTANGLE:
+            case GL_TEXTURE_1D_ARRAY:
+                Emit<&glad_glTextureStorage2D>(trace, texture, levels, format, width, height);
+                break;
+            case GL_TEXTURE_3D:
+            case GL_TEXTURE_2D_ARRAY:
+                Emit<&glad_glTextureStorage3D>(trace, texture, levels, format, width, height, depth);
+                break;
+            case GL_TEXTURE_2D_MULTISAMPLE:
+                // Render targets, whose samples can't be read back.
+                Emit<&glad_glTextureStorage2DMultisample>(trace, texture, samples, format, width, height, fixedLocations);
+                return;
+            case GL_TEXTURE_2D_MULTISAMPLE_ARRAY:
+                Emit<&glad_glTextureStorage3DMultisample>(trace, texture, samples, format, width, height, depth, fixedLocations);
+                return;
+            default:
+                spdlog::warn("Texture {} has a target Glitter doesn't use, it's traced without storage.", texture);
+                return;
+            }
+
+            for (GLenum parameter : SAMPLER_INT_PARAMETERS) {
+                GLint value = 0;
+                glGetTextureParameteriv(texture, parameter, &value);
+                Emit<&glad_glTextureParameteri>(trace, texture, parameter, value);
+            }
+            for (GLenum parameter : TEXTURE_INT_PARAMETERS) {
+                GLint value = 0;
+                glGetTextureParameteriv(texture, parameter, &value);
+                Emit<&glad_glTextureParameteri>(trace, texture, parameter, value);
+            }
+            for (GLenum parameter : SAMPLER_FLOAT_PARAMETERS) {
+                GLfloat value = 0.0f;
+                glGetTextureParameterfv(texture, parameter, &value);
+                Emit<&glad_glTextureParameterf>(trace, texture, parameter, value);
+            }
+            std::array<GLfloat, 4> borderColor {};
+            glGetTextureParameterfv(texture, GL_TEXTURE_BORDER_COLOR, borderColor.data());
+            Emit<&glad_glTextureParameterfv>(trace, texture, GL_TEXTURE_BORDER_COLOR, borderColor.data());
+
+            SnapshotTextureContents(trace, texture, target, levels, format);
+        });
+    }
+
+    void SnapshotSamplers(std::vector<std::byte>& trace)
+    {
+        ForEachName(glIsSampler, [&](GLuint sampler) {
+            Emit<&glad_glCreateSamplers>(trace, 1, &sampler);
+            for (GLenum parameter : SAMPLER_INT_PARAMETERS) {
+                GLint value = 0;
+                glGetSamplerParameteriv(sampler, parameter, &value);
+                Emit<&glad_glSamplerParameteri>(trace, sampler, parameter, value);
+            }
+            for (GLenum parameter : SAMPLER_FLOAT_PARAMETERS) {
+                GLfloat value = 0.0f;
+                glGetSamplerParameterfv(sampler, parameter, &value);
+                Emit<&glad_glSamplerParameterf>(trace, sampler, parameter, value);
+            }
+            std::array<GLfloat, 4> borderColor {};
+            glGetSamplerParameterfv(sampler, GL_TEXTURE_BORDER_COLOR, borderColor.data());
+            Emit<&glad_glSamplerParameterfv>(trace, sampler, GL_TEXTURE_BORDER_COLOR, borderColor.data());
+        });
+    }
+
+    void SnapshotRenderbuffers(std::vector<std::byte>& trace)
+    {
+        ForEachName(glIsRenderbuffer, [&](GLuint renderbuffer) {
+            GLint format = 0;
+            GLint width = 0;
+            GLint height = 0;
+            GLint samples = 0;
+            glGetNamedRenderbufferParameteriv(renderbuffer, GL_RENDERBUFFER_INTERNAL_FORMAT, &format);
+            glGetNamedRenderbufferParameteriv(renderbuffer, GL_RENDERBUFFER_WIDTH, &width);
+            glGetNamedRenderbufferParameteriv(renderbuffer, GL_RENDERBUFFER_HEIGHT, &height);
+            glGetNamedRenderbufferParameteriv(renderbuffer, GL_RENDERBUFFER_SAMPLES, &samples);
+            Emit<&glad_glCreateRenderbuffers>(trace, 1, &renderbuffer);
+            if (width > 0 && height > 0) {
+                Emit<&glad_glNamedRenderbufferStorageMultisample>(trace, renderbuffer, samples, format, width, height);
+            }
+        });
+    }
+
+    // Queries are only generated, their target is set by their first use.
+    void SnapshotQueries(std::vector<std::byte>& trace)
+    {
+        ForEachName(glIsQuery, [&](GLuint query) { Emit<&glad_glGenQueries>(trace, 1, &query); });
+    }
+
+    // The vertex arrays' state is queried with them bound, as their bindings have no DSA queries.
+    void SnapshotVertexArrays(std::vector<std::byte>& trace)
+    {
+        GLint previous = GetInteger(GL_VERTEX_ARRAY_BINDING);
+        GLint attributeCount = GetInteger(GL_MAX_VERTEX_ATTRIBS);
+        GLint bindingCount = GetInteger(GL_MAX_VERTEX_ATTRIB_BINDINGS);
+        ForEachName(glIsVertexArray, [&](GLuint vertexArray) {
+            Emit<&glad_glCreateVertexArrays>(trace, 1, &vertexArray);
+            glBindVertexArray(vertexArray);
+
+            GLint elementBuffer = 0;
+            glGetVertexArrayiv(vertexArray, GL_ELEMENT_ARRAY_BUFFER_BINDING, &elementBuffer);
+            if (elementBuffer != 0) {
+                Emit<&glad_glVertexArrayElementBuffer>(trace, vertexArray, elementBuffer);
+            }
+
+            for (GLint attribute = 0; attribute < attributeCount; attribute++) {
+                auto attributeIdx = static_cast<GLuint>(attribute);
+                GLint enabled = GL_FALSE;
+                GLint size = 0;
+                GLint type = 0;
+                GLint normalized = GL_FALSE;
+                GLint integer = GL_FALSE;
+                GLint isLong = GL_FALSE;
+                GLint relativeOffset = 0;
+                GLint binding = 0;
+                glGetVertexAttribiv(attributeIdx, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &enabled);
+                glGetVertexAttribiv(attributeIdx, GL_VERTEX_ATTRIB_ARRAY_SIZE, &size);
+                glGetVertexAttribiv(attributeIdx, GL_VERTEX_ATTRIB_ARRAY_TYPE, &type);
+                glGetVertexAttribiv(attributeIdx, GL_VERTEX_ATTRIB_ARRAY_NORMALIZED, &normalized);
+                glGetVertexAttribiv(attributeIdx, GL_VERTEX_ATTRIB_ARRAY_INTEGER, &integer);
+                glGetVertexAttribiv(attributeIdx, GL_VERTEX_ATTRIB_ARRAY_LONG, &isLong);
+                glGetVertexAttribiv(attributeIdx, GL_VERTEX_ATTRIB_RELATIVE_OFFSET, &relativeOffset);
+                glGetVertexAttribiv(attributeIdx, GL_VERTEX_ATTRIB_BINDING, &binding);
+                if (enabled != GL_TRUE) {
+                    continue;
+                }
+                Emit<&glad_glEnableVertexArrayAttrib>(trace, vertexArray, attributeIdx);
+                if (isLong == GL_TRUE) {
+                    Emit<&glad_glVertexArrayAttribLFormat>(trace, vertexArray, attributeIdx, size, type, relativeOffset);
+                } else if (integer == GL_TRUE) {
+                    Emit<&glad_glVertexArrayAttribIFormat>(trace, vertexArray, attributeIdx, size, type, relativeOffset);
+                } else {
+                    Emit<&glad_glVertexArrayAttribFormat>(
+                        trace, vertexArray, attributeIdx, size, type, static_cast<GLboolean>(normalized), relativeOffset);
+                }
+                Emit<&glad_glVertexArrayAttribBinding>(trace, vertexArray, attributeIdx, binding);
+            }
+
+            for (GLint binding = 0; binding < bindingCount; binding++) {
+                auto bindingIdx = static_cast<GLuint>(binding);
+                GLint buffer = GetIntegerIndexed(GL_VERTEX_BINDING_BUFFER, bindingIdx);
+                GLint stride = GetIntegerIndexed(GL_VERTEX_BINDING_STRIDE, bindingIdx);
+                GLint divisor = GetIntegerIndexed(GL_VERTEX_BINDING_DIVISOR, bindingIdx);
+                GLint64 offset = 0;
+                glGetInteger64i_v(GL_VERTEX_BINDING_OFFSET, bindingIdx, &offset);
+                if (buffer != 0) {
+                    Emit<&glad_glVertexArrayVertexBuffer>(trace, vertexArray, bindingIdx, buffer, offset, stride);
+                }
+                if (divisor != 0) {
+                    Emit<&glad_glVertexArrayBindingDivisor>(trace, vertexArray, bindingIdx, divisor);
+                }
+            }
+        });
+        glBindVertexArray(static_cast<GLuint>(previous));
+    }
+
+    void SnapshotFramebuffers(std::vector<std::byte>& trace)
+    {
+        GLint colorCount = GetInteger(GL_MAX_COLOR_ATTACHMENTS);
+        GLint drawBufferCount = GetInteger(GL_MAX_DRAW_BUFFERS);
+        std::vector<GLenum> attachments {GL_DEPTH_ATTACHMENT, GL_STENCIL_ATTACHMENT};
+        for (GLint color = 0; color < colorCount; color++) {
+            attachments.push_back(GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(color));
+        }
+
+        ForEachName(glIsFramebuffer, [&](GLuint framebuffer) {
+            Emit<&glad_glCreateFramebuffers>(trace, 1, &framebuffer);
+            for (GLenum attachment : attachments) {
+                GLint type = GL_NONE;
+                GLint name = 0;
+                glGetNamedFramebufferAttachmentParameteriv(framebuffer, attachment, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &type);
+                if (type == GL_NONE) {
+                    continue;
+                }
+                glGetNamedFramebufferAttachmentParameteriv(framebuffer, attachment, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME, &name);
+                if (type == GL_RENDERBUFFER) {
+                    Emit<&glad_glNamedFramebufferRenderbuffer>(trace, framebuffer, attachment, GL_RENDERBUFFER, name);
+                    continue;
+                }
+
+                GLint level = 0;
+                GLint layered = GL_FALSE;
+                GLint layer = 0;
+                GLint target = 0;
+                glGetNamedFramebufferAttachmentParameteriv(
+                    framebuffer, attachment, GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_LEVEL, &level);
+                glGetNamedFramebufferAttachmentParameteriv(framebuffer, attachment, GL_FRAMEBUFFER_ATTACHMENT_LAYERED, &layered);
+                glGetNamedFramebufferAttachmentParameteriv(
+                    framebuffer, attachment, GL_FRAMEBUFFER_ATTACHMENT_TEXTURE_LAYER, &layer);
+                glGetTextureParameteriv(static_cast<GLuint>(name), GL_TEXTURE_TARGET, &target);
+                if (layered == GL_FALSE && (target == GL_TEXTURE_3D || target == GL_TEXTURE_2D_ARRAY)) {
+                    Emit<&glad_glNamedFramebufferTextureLayer>(trace, framebuffer, attachment, name, level, layer);
+                } else {
+                    Emit<&glad_glNamedFramebufferTexture>(trace, framebuffer, attachment, name, level);
+                }
+            }
+
+            std::vector<GLenum> drawBuffers(static_cast<size_t>(drawBufferCount));
+            for (GLint drawBuffer = 0; drawBuffer < drawBufferCount; drawBuffer++) {
+                GLint value = GL_NONE;
+                glGetNamedFramebufferParameteriv(framebuffer, GL_DRAW_BUFFER0 + static_cast<GLenum>(drawBuffer), &value);
+                drawBuffers[static_cast<size_t>(drawBuffer)] = static_cast<GLenum>(value);
+            }
+            while (drawBuffers.size() > 1 && drawBuffers.back() == GL_NONE) {
+                drawBuffers.pop_back();
+            }
+            Emit<&glad_glNamedFramebufferDrawBuffers>(
+                trace, framebuffer, static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+            GLint readBuffer = GL_NONE;
+            glGetNamedFramebufferParameteriv(framebuffer, GL_READ_BUFFER, &readBuffer);
+            Emit<&glad_glNamedFramebufferReadBuffer>(trace, framebuffer, readBuffer);
+        });
+    }
+
+    // Reads the value of a uniform of N components of T into a glProgramUniform*v() call.
+    template <auto* Slot, typename T, size_t N, bool Matrix = false>
+    void EmitUniform(std::vector<std::byte>& trace, GLuint program, GLint location)
+    {
+        std::array<T, N> values {};
+        auto size = static_cast<GLsizei>(sizeof(values));
+        if constexpr (std::is_same_v<T, GLfloat>) {
+            glGetnUniformfv(program, location, size, values.data());
+        } else if constexpr (std::is_same_v<T, GLint>) {
+            glGetnUniformiv(program, location, size, values.data());
+        } else {
+            glGetnUniformuiv(program, location, size, values.data());
+        }
+        if constexpr (Matrix) {
+            Emit<Slot>(trace, program, location, 1, GL_FALSE, values.data());
+        } else {
+            Emit<Slot>(trace, program, location, 1, values.data());
+        }
+    }
+
+    // The values of the uniforms outside blocks, but for the opaque types, which Glitter's shaders bind in GLSL.
+    void SnapshotUniforms(std::vector<std::byte>& trace, GLuint program)
+    {
+        GLint uniformCount = 0;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniformCount);
+        for (GLint uniform = 0; uniform < uniformCount; uniform++) {
+            auto uniformIdx = static_cast<GLuint>(uniform);
+            GLint blockIdx = -1;
+            GLint type = 0;
+            GLint arraySize = 0;
+            glGetActiveUniformsiv(program, 1, &uniformIdx, GL_UNIFORM_BLOCK_INDEX, &blockIdx);
+            glGetActiveUniformsiv(program, 1, &uniformIdx, GL_UNIFORM_TYPE, &type);
+            glGetActiveUniformsiv(program, 1, &uniformIdx, GL_UNIFORM_SIZE, &arraySize);
+            std::array<GLchar, 256> name {};
+            glGetActiveUniformName(program, uniformIdx, static_cast<GLsizei>(name.size()), nullptr, name.data());
+            GLint location = glGetUniformLocation(program, name.data());
+            if (blockIdx != -1 || location < 0) {
+                continue;
+            }
+
+            // The elements of an array are at consecutive locations.
+            for (GLint element = location; element < location + arraySize; element++) {
+                switch (type) {
+                case GL_FLOAT:
+                    EmitUniform<&glad_glProgramUniform1fv, GLfloat, 1>(trace, program, element);
+                    break;
+                case GL_FLOAT_VEC2:
+                    EmitUniform<&glad_glProgramUniform2fv, GLfloat, 2>(trace, program, element);
+                    break;
+                case GL_FLOAT_VEC3:
+                    EmitUniform<&glad_glProgramUniform3fv, GLfloat, 3>(trace, program, element);
+                    break;
+                case GL_FLOAT_VEC4:
+                    EmitUniform<&glad_glProgramUniform4fv, GLfloat, 4>(trace, program, element);
+                    break;
+                case GL_INT:
+                case GL_BOOL:
+                    EmitUniform<&glad_glProgramUniform1iv, GLint, 1>(trace, program, element);
+                    break;
+                case GL_INT_VEC2:
+                case GL_BOOL_VEC2:
+                    EmitUniform<&glad_glProgramUniform2iv, GLint, 2>(trace, program, element);
+                    break;
+                case GL_INT_VEC3:
+                case GL_BOOL_VEC3:
+                    EmitUniform<&glad_glProgramUniform3iv, GLint, 3>(trace, program, element);
+                    break;
+                case GL_INT_VEC4:
+                case GL_BOOL_VEC4:
+                    EmitUniform<&glad_glProgramUniform4iv, GLint, 4>(trace, program, element);
+                    break;
+                case GL_UNSIGNED_INT:
+                    EmitUniform<&glad_glProgramUniform1uiv, GLuint, 1>(trace, program, element);
+                    break;
+                case GL_UNSIGNED_INT_VEC2:
+                    EmitUniform<&glad_glProgramUniform2uiv, GLuint, 2>(trace, program, element);
+                    break;
+                case GL_UNSIGNED_INT_VEC3:
+                    EmitUniform<&glad_glProgramUniform3uiv, GLuint, 3>(trace, program, element);
+                    break;
+                case GL_UNSIGNED_INT_VEC4:
+                    EmitUniform<&glad_glProgramUniform4uiv, GLuint, 4>(trace, program, element);
+                    break;
+                case GL_FLOAT_MAT3:
+                    EmitUniform<&glad_glProgramUniformMatrix3fv, GLfloat, 9, true>(trace, program, element);
+                    break;
+                case GL_FLOAT_MAT4:
+                    EmitUniform<&glad_glProgramUniformMatrix4fv, GLfloat, 16, true>(trace, program, element);
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+    }
+
+    void SnapshotPrograms(std::vector<std::byte>& trace)
+    {
+        std::scoped_lock lock(s_programMutex);
+        GLuint shader = SNAPSHOT_SHADER_NAME;
+        ForEachName(glIsProgram, [&](GLuint program) {
+            GLint linked = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            if (linked != GL_TRUE) {
+                return;
+            }
+
+            EmitReturning<&glad_glCreateProgram>(trace, program);
+            auto sources = s_programSources.find(program);
+            if (sources != s_programSources.end()) {
+                GLuint firstShader = shader;
+                for (const ShaderSource& source : sources->second) {
+                    const char* text = source.m_source.c_str();
+                    EmitReturning<&glad_glCreateShader>(trace, shader, source.m_type);
+                    Emit<&glad_glShaderSource>(trace, shader, 1, &text, nullptr);
+                    Emit<&glad_glCompileShader>(trace, shader);
+                    Emit<&glad_glAttachShader>(trace, program, shader);
+                    shader++;
+                }
+                Emit<&glad_glLinkProgram>(trace, program);
+                for (GLuint linkedShader = firstShader; linkedShader < shader; linkedShader++) {
+                    Emit<&glad_glDeleteShader>(trace, linkedShader);
+                }
+            } else {
+                GLint length = 0;
+                glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+                if (length == 0) {
+                    spdlog::warn("Program {} has neither sources nor a binary, it's traced empty.", program);
+                    return;
+                }
+                std::vector<std::byte> binary(static_cast<size_t>(length));
+                GLenum format = 0;
+                glGetProgramBinary(program, length, nullptr, &format, binary.data());
+                Emit<&glad_glProgramBinary>(trace, program, format, binary.data(), length);
+            }
+            SnapshotUniforms(trace, program);
+        });
+    }
+
+    struct BufferTarget {
+        GLenum m_target;
+        GLenum m_binding;
+    };
+    constexpr std::array<BufferTarget, 11> BUFFER_TARGETS {{
+        {GL_ARRAY_BUFFER, GL_ARRAY_BUFFER_BINDING},
+        {GL_ATOMIC_COUNTER_BUFFER, GL_ATOMIC_COUNTER_BUFFER_BINDING},
+        {GL_COPY_READ_BUFFER, GL_COPY_READ_BUFFER_BINDING},
+        {GL_COPY_WRITE_BUFFER, GL_COPY_WRITE_BUFFER_BINDING},
+        {GL_DISPATCH_INDIRECT_BUFFER, GL_DISPATCH_INDIRECT_BUFFER_BINDING},
+        {GL_DRAW_INDIRECT_BUFFER, GL_DRAW_INDIRECT_BUFFER_BINDING},
+        {GL_PARAMETER_BUFFER, GL_PARAMETER_BUFFER_BINDING},
+        {GL_PIXEL_PACK_BUFFER, GL_PIXEL_PACK_BUFFER_BINDING},
+        {GL_PIXEL_UNPACK_BUFFER, GL_PIXEL_UNPACK_BUFFER_BINDING},
+        {GL_QUERY_BUFFER, GL_QUERY_BUFFER_BINDING},
+        {GL_SHADER_STORAGE_BUFFER, GL_SHADER_STORAGE_BUFFER_BINDING},
+    }};
+
+    // The indexed buffer bindings, unbound up to the minimum count every GL 4.6 driver has, so that the trace replays
+    // anywhere, and restored up to the recording driver's count.
+    struct IndexedTarget {
+        GLenum m_target;
+        GLenum m_binding;
+        GLenum m_start;
+        GLenum m_size;
+        GLenum m_count;
+        GLuint m_portableCount;
+    };
+    constexpr std::array<IndexedTarget, 3> INDEXED_TARGETS {{
+        {GL_UNIFORM_BUFFER, GL_UNIFORM_BUFFER_BINDING, GL_UNIFORM_BUFFER_START, GL_UNIFORM_BUFFER_SIZE,
+            GL_MAX_UNIFORM_BUFFER_BINDINGS, 84},
+        {GL_SHADER_STORAGE_BUFFER, GL_SHADER_STORAGE_BUFFER_BINDING, GL_SHADER_STORAGE_BUFFER_START,
+            GL_SHADER_STORAGE_BUFFER_SIZE, GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS, 8},
+        {GL_ATOMIC_COUNTER_BUFFER, GL_ATOMIC_COUNTER_BUFFER_BINDING, GL_ATOMIC_COUNTER_BUFFER_START,
+            GL_ATOMIC_COUNTER_BUFFER_SIZE, GL_MAX_ATOMIC_COUNTER_BUFFER_BINDINGS, 1},
+    }};
+    constexpr GLuint PORTABLE_TEXTURE_UNITS = 80;
+    constexpr GLuint PORTABLE_IMAGE_UNITS = 8;
+
+    struct TextureTarget {
+        GLenum m_target;
+        GLenum m_binding;
+    };
+    constexpr std::array<TextureTarget, 9> TEXTURE_TARGETS {{
+        {GL_TEXTURE_2D, GL_TEXTURE_BINDING_2D},
+        {GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BINDING_2D_ARRAY},
+        {GL_TEXTURE_3D, GL_TEXTURE_BINDING_3D},
+        {GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BINDING_CUBE_MAP},
+        {GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_BINDING_CUBE_MAP_ARRAY},
+        {GL_TEXTURE_RECTANGLE, GL_TEXTURE_BINDING_RECTANGLE},
+        {GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_BINDING_2D_MULTISAMPLE},
+        {GL_TEXTURE_2D_MULTISAMPLE_ARRAY, GL_TEXTURE_BINDING_2D_MULTISAMPLE_ARRAY},
+        {GL_TEXTURE_BUFFER, GL_TEXTURE_BINDING_BUFFER},
+    }};
+
+    constexpr std::array<GLenum, 19> CAPABILITIES {GL_CULL_FACE, GL_DEPTH_TEST, GL_STENCIL_TEST, GL_SCISSOR_TEST,
+        GL_POLYGON_OFFSET_FILL, GL_POLYGON_OFFSET_LINE, GL_FRAMEBUFFER_SRGB, GL_MULTISAMPLE, GL_PRIMITIVE_RESTART,
+        GL_PRIMITIVE_RESTART_FIXED_INDEX, GL_RASTERIZER_DISCARD, GL_DEPTH_CLAMP, GL_TEXTURE_CUBE_MAP_SEAMLESS,
+        GL_PROGRAM_POINT_SIZE, GL_SAMPLE_ALPHA_TO_COVERAGE, GL_SAMPLE_SHADING, GL_LINE_SMOOTH, GL_DITHER, GL_CLIP_DISTANCE0};
+
+    void SnapshotBlendState(std::vector<std::byte>& trace)
+    {
+        auto drawBufferCount = static_cast<GLuint>(GetInteger(GL_MAX_DRAW_BUFFERS));
+        for (GLuint drawBuffer = 0; drawBuffer < drawBufferCount; drawBuffer++) {
+            if (glIsEnabledi(GL_BLEND, drawBuffer) == GL_TRUE) {
+                Emit<&glad_glEnablei>(trace, GL_BLEND, drawBuffer);
+            } else {
+                Emit<&glad_glDisablei>(trace, GL_BLEND, drawBuffer);
+            }
+            Emit<&glad_glBlendFuncSeparatei>(trace, drawBuffer, GetIntegerIndexed(GL_BLEND_SRC_RGB, drawBuffer),
+                GetIntegerIndexed(GL_BLEND_DST_RGB, drawBuffer), GetIntegerIndexed(GL_BLEND_SRC_ALPHA, drawBuffer),
+                GetIntegerIndexed(GL_BLEND_DST_ALPHA, drawBuffer));
+            Emit<&glad_glBlendEquationSeparatei>(trace, drawBuffer, GetIntegerIndexed(GL_BLEND_EQUATION_RGB, drawBuffer),
+                GetIntegerIndexed(GL_BLEND_EQUATION_ALPHA, drawBuffer));
+            std::array<GLboolean, 4> mask {};
+            glGetBooleani_v(GL_COLOR_WRITEMASK, drawBuffer, mask.data());
+            Emit<&glad_glColorMaski>(trace, drawBuffer, mask[0], mask[1], mask[2], mask[3]);
+        }
+        std::array<GLfloat, 4> blendColor {};
+        glGetFloatv(GL_BLEND_COLOR, blendColor.data());
+        Emit<&glad_glBlendColor>(trace, blendColor[0], blendColor[1], blendColor[2], blendColor[3]);
+    }
+
+    void SnapshotFixedFunctionState(std::vector<std::byte>& trace)
+    {
+        for (GLenum capability : CAPABILITIES) {
+            if (glIsEnabled(capability) == GL_TRUE) {
+                Emit<&glad_glEnable>(trace, capability);
+            } else {
+                Emit<&glad_glDisable>(trace, capability);
+            }
+        }
+        SnapshotBlendState(trace);
+
+        GLboolean depthMask = GL_TRUE;
+        glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+        std::array<GLdouble, 2> depthRange {};
+        glGetDoublev(GL_DEPTH_RANGE, depthRange.data());
+        Emit<&glad_glDepthFunc>(trace, GetInteger(GL_DEPTH_FUNC));
+        Emit<&glad_glDepthMask>(trace, depthMask);
+        Emit<&glad_glDepthRange>(trace, depthRange[0], depthRange[1]);
+        Emit<&glad_glClipControl>(trace, GetInteger(GL_CLIP_ORIGIN), GetInteger(GL_CLIP_DEPTH_MODE));
+
+        Emit<&glad_glStencilFuncSeparate>(
+            trace, GL_FRONT, GetInteger(GL_STENCIL_FUNC), GetInteger(GL_STENCIL_REF), GetInteger(GL_STENCIL_VALUE_MASK));
+        Emit<&glad_glStencilFuncSeparate>(trace, GL_BACK, GetInteger(GL_STENCIL_BACK_FUNC), GetInteger(GL_STENCIL_BACK_REF),
+            GetInteger(GL_STENCIL_BACK_VALUE_MASK));
+        Emit<&glad_glStencilOpSeparate>(trace, GL_FRONT, GetInteger(GL_STENCIL_FAIL), GetInteger(GL_STENCIL_PASS_DEPTH_FAIL),
+            GetInteger(GL_STENCIL_PASS_DEPTH_PASS));
+        Emit<&glad_glStencilOpSeparate>(trace, GL_BACK, GetInteger(GL_STENCIL_BACK_FAIL),
+            GetInteger(GL_STENCIL_BACK_PASS_DEPTH_FAIL), GetInteger(GL_STENCIL_BACK_PASS_DEPTH_PASS));
+        Emit<&glad_glStencilMaskSeparate>(trace, GL_FRONT, GetInteger(GL_STENCIL_WRITEMASK));
+        Emit<&glad_glStencilMaskSeparate>(trace, GL_BACK, GetInteger(GL_STENCIL_BACK_WRITEMASK));
+
+        std::array<GLint, 2> polygonMode {GL_FILL, GL_FILL};
+        glGetIntegerv(GL_POLYGON_MODE, polygonMode.data());
+        GLfloat offsetFactor = 0.0f;
+        GLfloat offsetUnits = 0.0f;
+        GLfloat lineWidth = 1.0f;
+        GLfloat pointSize = 1.0f;
+        glGetFloatv(GL_POLYGON_OFFSET_FACTOR, &offsetFactor);
+        glGetFloatv(GL_POLYGON_OFFSET_UNITS, &offsetUnits);
+        glGetFloatv(GL_LINE_WIDTH, &lineWidth);
+        glGetFloatv(GL_POINT_SIZE, &pointSize);
+        Emit<&glad_glCullFace>(trace, GetInteger(GL_CULL_FACE_MODE));
+        Emit<&glad_glFrontFace>(trace, GetInteger(GL_FRONT_FACE));
+        Emit<&glad_glPolygonMode>(trace, GL_FRONT_AND_BACK, polygonMode[0]);
+        Emit<&glad_glPolygonOffset>(trace, offsetFactor, offsetUnits);
+        Emit<&glad_glLineWidth>(trace, lineWidth);
+        Emit<&glad_glPointSize>(trace, pointSize);
+        Emit<&glad_glPrimitiveRestartIndex>(trace, GetInteger(GL_PRIMITIVE_RESTART_INDEX));
+
+        std::array<GLint, 4> viewport {};
+        std::array<GLint, 4> scissor {};
+        glGetIntegerv(GL_VIEWPORT, viewport.data());
+        glGetIntegerv(GL_SCISSOR_BOX, scissor.data());
+        Emit<&glad_glViewport>(trace, viewport[0], viewport[1], viewport[2], viewport[3]);
+        Emit<&glad_glScissor>(trace, scissor[0], scissor[1], scissor[2], scissor[3]);
+
+        std::array<GLfloat, 4> clearColor {};
+        GLdouble clearDepth = 1.0;
+        glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor.data());
+        glGetDoublev(GL_DEPTH_CLEAR_VALUE, &clearDepth);
+        Emit<&glad_glClearColor>(trace, clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+        Emit<&glad_glClearDepth>(trace, clearDepth);
+        Emit<&glad_glClearStencil>(trace, GetInteger(GL_STENCIL_CLEAR_VALUE));
+
+        Emit<&glad_glPixelStorei>(trace, GL_PACK_ALIGNMENT, GetInteger(GL_PACK_ALIGNMENT));
+        Emit<&glad_glPixelStorei>(trace, GL_UNPACK_ALIGNMENT, GetInteger(GL_UNPACK_ALIGNMENT));
+    }
+
+    void SnapshotBindings(std::vector<std::byte>& trace)
+    {
+        Emit<&glad_glUseProgram>(trace, GetInteger(GL_CURRENT_PROGRAM));
+        Emit<&glad_glBindVertexArray>(trace, GetInteger(GL_VERTEX_ARRAY_BINDING));
+        Emit<&glad_glBindFramebuffer>(trace, GL_DRAW_FRAMEBUFFER, GetInteger(GL_DRAW_FRAMEBUFFER_BINDING));
+        Emit<&glad_glBindFramebuffer>(trace, GL_READ_FRAMEBUFFER, GetInteger(GL_READ_FRAMEBUFFER_BINDING));
+
+        // The indexed bindings also bind the generic binding of their target, so they go first.
+        for (const IndexedTarget& target : INDEXED_TARGETS) {
+            auto count = static_cast<GLuint>(GetInteger(target.m_count));
+            Emit<&glad_glBindBuffersBase>(trace, target.m_target, 0, std::min(count, target.m_portableCount), nullptr);
+            for (GLuint index = 0; index < count; index++) {
+                GLint buffer = GetIntegerIndexed(target.m_binding, index);
+                if (buffer == 0) {
+                    continue;
+                }
+                GLint64 start = 0;
+                GLint64 size = 0;
+                glGetInteger64i_v(target.m_start, index, &start);
+                glGetInteger64i_v(target.m_size, index, &size);
+                if (size == 0) {
+                    Emit<&glad_glBindBufferBase>(trace, target.m_target, index, buffer);
+                } else {
+                    Emit<&glad_glBindBufferRange>(trace, target.m_target, index, buffer, start, size);
+                }
+            }
+        }
+        for (const BufferTarget& target : BUFFER_TARGETS) {
+            Emit<&glad_glBindBuffer>(trace, target.m_target, GetInteger(target.m_binding));
+        }
+
+        auto unitCount = static_cast<GLuint>(GetInteger(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS));
+        GLint activeTexture = GetInteger(GL_ACTIVE_TEXTURE);
+        Emit<&glad_glBindTextures>(trace, 0, std::min(unitCount, PORTABLE_TEXTURE_UNITS), nullptr);
+        Emit<&glad_glBindSamplers>(trace, 0, std::min(unitCount, PORTABLE_TEXTURE_UNITS), nullptr);
+        for (GLuint unit = 0; unit < unitCount; unit++) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            for (const TextureTarget& target : TEXTURE_TARGETS) {
+                if (GLint texture = GetInteger(target.m_binding); texture != 0) {
+                    Emit<&glad_glBindTextureUnit>(trace, unit, texture);
+                }
+            }
+            if (GLint sampler = GetInteger(GL_SAMPLER_BINDING); sampler != 0) {
+                Emit<&glad_glBindSampler>(trace, unit, sampler);
+            }
+        }
+        glActiveTexture(static_cast<GLenum>(activeTexture));
+        Emit<&glad_glActiveTexture>(trace, activeTexture);
+
+        auto imageUnitCount = static_cast<GLuint>(GetInteger(GL_MAX_IMAGE_UNITS));
+        Emit<&glad_glBindImageTextures>(trace, 0, std::min(imageUnitCount, PORTABLE_IMAGE_UNITS), nullptr);
+        for (GLuint unit = 0; unit < imageUnitCount; unit++) {
+            GLint texture = GetIntegerIndexed(GL_IMAGE_BINDING_NAME, unit);
+            if (texture == 0) {
+                continue;
+            }
+            GLboolean layered = GL_FALSE;
+            glGetBooleani_v(GL_IMAGE_BINDING_LAYERED, unit, &layered);
+            Emit<&glad_glBindImageTexture>(trace, unit, texture, GetIntegerIndexed(GL_IMAGE_BINDING_LEVEL, unit), layered,
+                GetIntegerIndexed(GL_IMAGE_BINDING_LAYER, unit), GetIntegerIndexed(GL_IMAGE_BINDING_ACCESS, unit),
+                GetIntegerIndexed(GL_IMAGE_BINDING_FORMAT, unit));
+        }
+    }
+
+    void DeleteObjects(GLObjectType type, const std::vector<GLuint>& objects)
+    {
+        auto count = static_cast<GLsizei>(objects.size());
+        switch (type) {
+        case Buffer:
+            glDeleteBuffers(count, objects.data());
+            break;
+        case Texture:
+            glDeleteTextures(count, objects.data());
+            break;
+        case Framebuffer:
+            glDeleteFramebuffers(count, objects.data());
+            break;
+        case Renderbuffer:
+            glDeleteRenderbuffers(count, objects.data());
+            break;
+        case Sampler:
+            glDeleteSamplers(count, objects.data());
+            break;
+        case VertexArray:
+            glDeleteVertexArrays(count, objects.data());
+            break;
+        case Query:
+            glDeleteQueries(count, objects.data());
+            break;
+        case Program:
+            for (GLuint program : objects) {
+                glDeleteProgram(program);
+            }
+            break;
+        case Shader:
+            for (GLuint shader : objects) {
+                glDeleteShader(shader);
+            }
+            break;
+        }
+    }
+
+    bool WriteTrace(
+        const std::filesystem::path& path, int width, int height, std::array<std::vector<std::byte>*, SECTION_COUNT> sections)
+    {
+        TraceHeader header {.m_magic = TRACE_MAGIC,
+            .m_version = TRACE_VERSION,
+            .m_callCount = static_cast<std::uint32_t>(CALL_COUNT),
+            .m_width = width,
+            .m_height = height,
+            .m_padding = 0,
+            .m_sizes = {},
+            .m_compressedSizes = {}};
+        std::array<std::vector<std::byte>, SECTION_COUNT> blocks {};
+        for (size_t sectionIdx = 0; sectionIdx < SECTION_COUNT; sectionIdx++) {
+            blocks[sectionIdx] = Util::CompressLz4Block(*sections[sectionIdx]);
+            header.m_sizes[sectionIdx] = sections[sectionIdx]->size();
+            header.m_compressedSizes[sectionIdx] = blocks[sectionIdx].size();
+        }
+
+        std::error_code error {};
+        std::filesystem::create_directories(path.parent_path(), error);
+        std::ofstream outputStream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        outputStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const std::vector<std::byte>& block : blocks) {
+            outputStream.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size()));
+        }
+        return static_cast<bool>(outputStream);
+    }
+
+} // namespace
+
+GLTraceRecorder::~GLTraceRecorder()
+{
+    if (m_capturing) {
+        UninstallHooks();
+        s_recording.store(nullptr, std::memory_order_release);
+    }
+    if (IsEnabled()) {
+        std::scoped_lock lock(s_programMutex);
+        s_keepPrograms = false;
+        s_programSources.clear();
+    }
+}
+
+void GLTraceRecorder::Create(std::filesystem::path path)
+{
+    m_path = std::move(path);
+    std::scoped_lock lock(s_programMutex);
+    s_keepPrograms = true;
+    spdlog::info("F10 traces the GL calls of the next frame into {}.", m_path.string());
+}
+
+void GLTraceRecorder::TriggerCapture()
+{
+    m_captureRequested = IsEnabled();
+}
+
+void GLTraceRecorder::BeginFrame(int width, int height)
+{
+    if (!m_captureRequested || m_capturing) {
+        return;
+    }
+    m_captureRequested = false;
+    m_capturing = true;
+    m_width = width;
+    m_height = height;
+    m_objects.clear();
+    m_state.clear();
+    m_frame.clear();
+    m_mappedBuffers.clear();
+
+    // The state is read before the snapshot of the objects changes any of it.
+    SnapshotFixedFunctionState(m_state);
+    SnapshotBindings(m_state);
+
+    // The contents are read into, and uploaded from, tightly packed client memory.
+    GLint packBuffer = GetInteger(GL_PIXEL_PACK_BUFFER_BINDING);
+    GLint unpackBuffer = GetInteger(GL_PIXEL_UNPACK_BUFFER_BINDING);
+    GLint packAlignment = GetInteger(GL_PACK_ALIGNMENT);
+    GLint unpackAlignment = GetInteger(GL_UNPACK_ALIGNMENT);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    Emit<&glad_glBindBuffer>(m_objects, GL_PIXEL_UNPACK_BUFFER, 0);
+    Emit<&glad_glPixelStorei>(m_objects, GL_UNPACK_ALIGNMENT, 1);
+
+    SnapshotBuffers(m_objects, m_mappedBuffers);
+    SnapshotTextures(m_objects);
+    SnapshotSamplers(m_objects);
+    SnapshotRenderbuffers(m_objects);
+    SnapshotQueries(m_objects);
+    SnapshotVertexArrays(m_objects);
+    SnapshotFramebuffers(m_objects);
+    SnapshotPrograms(m_objects);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, static_cast<GLuint>(packBuffer));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, static_cast<GLuint>(unpackBuffer));
+    glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+
+    s_recordingThread = std::this_thread::get_id();
+    InstallHooks();
+    s_recording.store(&m_frame, std::memory_order_release);
+}
+
+bool GLTraceRecorder::EndFrame()
+{
+    if (!m_capturing) {
+        return true;
+    }
+    s_recording.store(nullptr, std::memory_order_release);
+    UninstallHooks();
+    m_capturing = false;
+
+    // The persistently mapped buffers hold what the frame wrote into them by now, and are created first, as the other
+    // objects may refer to them.
+    std::vector<std::byte> objects {};
+    for (GLuint buffer : m_mappedBuffers) {
+        if (glIsBuffer(buffer) == GL_TRUE) {
+            std::vector<std::byte> contents = ReadBuffer(buffer);
+            EmitBuffer(objects, buffer, contents.empty() ? nullptr : contents.data());
+        }
+    }
+    objects.insert(objects.end(), m_objects.begin(), m_objects.end());
+
+    std::filesystem::path path = m_path;
+    if (m_captureCount > 0) {
+        path.replace_filename(std::format("{}-{}{}", m_path.stem().string(), m_captureCount, m_path.extension().string()));
+    }
+    m_captureCount++;
+    bool written = WriteTrace(path, m_width, m_height, {&objects, &m_state, &m_frame});
+    if (written) {
+        spdlog::info("Wrote the GL trace of the frame to {}, {:.1f} MiB of objects and {:.1f} KiB of calls.", path.string(),
+            static_cast<double>(objects.size()) / (1024.0 * 1024.0), static_cast<double>(m_frame.size()) / 1024.0);
+    } else {
+        spdlog::error("Failed to write the GL trace {}.", path.string());
+    }
+    m_objects = {};
+    m_state = {};
+    m_frame = {};
+    return written;
+}
+
+void GLTraceRecorder::RegisterProgram(GLuint program, std::span<const ShaderSource> shaders)
+{
+    std::scoped_lock lock(s_programMutex);
+    if (!s_keepPrograms) {
+        return;
+    }
+
+    // Only the GLSL is kept, which any driver compiles.
+    std::vector<ShaderSource>& sources = s_programSources[program];
+    sources.clear();
+    for (const ShaderSource& shader : shaders) {
+        sources.push_back(ShaderSource {.m_type = shader.m_type, .m_source = shader.m_source});
+    }
+}
+
+GLuint GLTraceNames::Find(GLObjectType type, GLuint name)
+{
+    if (name == 0) {
+        return 0;
+    }
+    const std::unordered_map<GLuint, GLuint>& names = m_names[static_cast<size_t>(type)];
+    if (auto it = names.find(name); it != names.end()) {
+        return it->second;
+    }
+    if (type != Query) {
+        return 0;
+    }
+
+    // Queries the frame uses before creating are generated, and created with the target of their first use.
+    GLuint query = 0;
+    glGenQueries(1, &query);
+    Add(type, name, query);
+    return query;
+}
+
+void GLTraceNames::Add(GLObjectType type, GLuint name, GLuint replayed)
+{
+    std::unordered_map<GLuint, GLuint>& names = m_names[static_cast<size_t>(type)];
+    if (m_inFrame) {
+        auto it = names.find(name);
+        m_undo.push_back(Undo {.m_type = type, .m_name = name, .m_replayed = it != names.end() ? it->second : 0});
+        m_frameObjects[static_cast<size_t>(type)].insert(replayed);
+    }
+    names[name] = replayed;
+}
+
+bool GLTraceNames::Remove(GLObjectType type, GLuint name, GLuint replayed)
+{
+    if (m_inFrame && !m_frameObjects[static_cast<size_t>(type)].erase(replayed)) {
+        return false;
+    }
+
+    std::unordered_map<GLuint, GLuint>& names = m_names[static_cast<size_t>(type)];
+    if (m_inFrame) {
+        m_undo.push_back(Undo {.m_type = type, .m_name = name, .m_replayed = replayed});
+    }
+    names.erase(name);
+    return true;
+}
+
+void GLTraceNames::EndFrame()
+{
+    for (size_t typeIdx = 0; typeIdx < GL_OBJECT_TYPE_COUNT; typeIdx++) {
+        std::vector<GLuint> objects(m_frameObjects[typeIdx].begin(), m_frameObjects[typeIdx].end());
+        if (!objects.empty()) {
+            DeleteObjects(static_cast<GLObjectType>(typeIdx), objects);
+        }
+        m_frameObjects[typeIdx].clear();
+    }
+    for (const auto& [name, sync] : m_syncs) {
+        glDeleteSync(sync);
+    }
+    m_syncs.clear();
+
+    for (auto it = m_undo.rbegin(); it != m_undo.rend(); it++) {
+        std::unordered_map<GLuint, GLuint>& names = m_names[static_cast<size_t>(it->m_type)];
+        if (it->m_replayed != 0) {
+            names[it->m_name] = it->m_replayed;
+        } else {
+            names.erase(it->m_name);
+        }
+    }
+    m_undo.clear();
+}
+
+bool GLTraceReplayer::Load(const char* path)
+{
+    std::optional<std::vector<std::byte>> contents = Util::ReadBinaryFile(path);
+    if (!contents) {
+        spdlog::error("Failed to read the GL trace {}.", path);
+        return false;
+    }
+    std::span<const std::byte> file = *contents;
+
+    TraceHeader header {};
+    if (file.size() < sizeof(header)) {
+        spdlog::error("The GL trace {} is truncated.", path);
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.m_magic != TRACE_MAGIC || header.m_version != TRACE_VERSION || header.m_callCount != CALL_COUNT) {
+        spdlog::error("The GL trace {} is from another version of Glitter, or isn't a trace.", path);
+        return false;
+    }
+
+    size_t offset = sizeof(header);
+    std::array<std::vector<std::byte>*, SECTION_COUNT> sections {&m_objects, &m_state, &m_frame};
+    for (size_t sectionIdx = 0; sectionIdx < SECTION_COUNT; sectionIdx++) {
+        std::uint64_t compressedSize = header.m_compressedSizes[sectionIdx];
+        if (compressedSize > file.size() - offset) {
+            spdlog::error("The GL trace {} is truncated.", path);
+            return false;
+        }
+        sections[sectionIdx]->resize(header.m_sizes[sectionIdx]);
+        if (!Util::DecompressLz4Block(file.subspan(offset, compressedSize), *sections[sectionIdx])) {
+            spdlog::error("The GL trace {} is corrupt.", path);
+            return false;
+        }
+        offset += compressedSize;
+    }
+
+    m_width = header.m_width;
+    m_height = header.m_height;
+    return true;
+}
+
+bool GLTraceReplayer::Prepare()
+{
+    m_names.m_inFrame = false;
+    return Replay(m_objects, nullptr);
+}
+
+bool GLTraceReplayer::ReplayFrame()
+{
+    m_names.m_inFrame = true;
+    bool replayed = Replay(m_state, nullptr) && Replay(m_frame, &m_frameCallCount);
+    m_names.EndFrame();
+    return replayed;
+}
+
+bool GLTraceReplayer::Replay(std::span<const std::byte> section, size_t* callCount)
+{
+    TraceReader reader(section);
+    size_t count = 0;
+    while (!reader.IsAtEnd()) {
+        auto opcode = reader.Read<std::uint16_t>();
+        if (reader.HasFailed() || opcode >= REPLAY_FUNCTIONS.size()) {
+            spdlog::error("The GL trace is corrupt past {} calls.", count);
+            return false;
+        }
+        REPLAY_FUNCTIONS[opcode](reader, m_names);
+        if (reader.HasFailed()) {
+            spdlog::error("The GL trace is corrupt past {} calls.", count);
+            return false;
+        }
+        count++;
+    }
+    if (callCount) {
+        *callCount = count;
+    }
+    return true;
+}
+
+} // namespace Glitter::Render
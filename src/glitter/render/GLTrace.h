@@ -0,0 +1,134 @@
+#pragma once
+
+#include "render/ProgramCache.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Glitter::Render {
+
+// The GL objects a trace refers to by name, each type having names of its own.
+enum class GLObjectType : std::uint8_t {
+    Buffer,
+    Texture,
+    Framebuffer,
+    Renderbuffer,
+    Sampler,
+    VertexArray,
+    Query,
+    Program,
+    Shader,
+};
+constexpr size_t GL_OBJECT_TYPE_COUNT = 9;
+
+// Records the GL calls of a single frame, with what they read, into a trace GlitterTraceReplay plays back in a loop
+// without the application, so that the same frame can be timed on other GPUs and drivers. The trace starts with the
+// objects alive when the frame begins, with their contents, and the context's state, then holds every call the frame
+// made through glad from the thread rendering it, which the hooks only see while it's captured.
+//
+// The calls through the entry points GLExtensions loads aren't seen, so DisableUntraceableGLExtensions() must turn them
+// off first. Neither are Dear ImGui's, which has a loader of its own, nor the writes into buffers mapped during the
+// frame. The persistently mapped buffers are read once the frame ends, holding what it wrote into them. The programs
+// registered with RegisterProgram() are compiled again from their GLSL sources, the others loaded from their binary,
+// which only the same driver accepts.
+class GLTraceRecorder {
+public:
+    GLTraceRecorder() = default;
+    ~GLTraceRecorder();
+
+    GLTraceRecorder(const GLTraceRecorder&) = delete;
+    GLTraceRecorder& operator=(const GLTraceRecorder&) = delete;
+
+    // Starts keeping the sources of the programs registered from now on, so must be called before building any.
+    void Create(std::filesystem::path path);
+    bool IsEnabled() const { return !m_path.empty(); }
+
+    // Captures the frame between the next BeginFrame() and EndFrame(). Does nothing unless created.
+    void TriggerCapture();
+    bool IsCapturing() const { return m_capturing; }
+
+    // Snapshots the objects and the state of the context, then records the calls of the thread calling it, if a capture
+    // was triggered. `width` and `height` are the default framebuffer's, which the replay's window is created with.
+    void BeginFrame(int width, int height);
+    // Stops recording, and writes the trace. Returns false if it couldn't, after logging why.
+    bool EndFrame();
+
+    // Keeps the GLSL sources `program` was linked from, while a recorder is created, for the traces to build it again.
+    static void RegisterProgram(GLuint program, std::span<const ShaderSource> shaders);
+
+private:
+    std::filesystem::path m_path;
+    bool m_captureRequested {};
+    bool m_capturing {};
+    int m_width {};
+    int m_height {};
+    std::uint32_t m_captureCount {};
+    // The sections of the trace being captured, see GLTraceReplayer.
+    std::vector<std::byte> m_objects;
+    std::vector<std::byte> m_state;
+    std::vector<std::byte> m_frame;
+    // The persistently mapped buffers, only read once the frame ends.
+    std::vector<GLuint> m_mappedBuffers;
+};
+
+// The names of a trace's objects in the context replaying it. The objects the frame creates are deleted once it's
+// replayed, along with its syncs, and those it deletes that it didn't create are kept for the next loop.
+struct GLTraceNames {
+    // The replayed name of `name`, 0 if it's unknown, which queries are generated for.
+    GLuint Find(GLObjectType type, GLuint name);
+    void Add(GLObjectType type, GLuint name, GLuint replayed);
+    // Whether the object `replayed` may be deleted, and forgets it if so.
+    bool Remove(GLObjectType type, GLuint name, GLuint replayed);
+    // Deletes the objects and syncs the frame created, and maps their names back to what they were before it.
+    void EndFrame();
+
+    struct Undo {
+        GLObjectType m_type;
+        GLuint m_name;
+        // 0 if the name was unknown.
+        GLuint m_replayed;
+    };
+
+    std::array<std::unordered_map<GLuint, GLuint>, GL_OBJECT_TYPE_COUNT> m_names;
+    std::array<std::unordered_set<GLuint>, GL_OBJECT_TYPE_COUNT> m_frameObjects;
+    std::unordered_map<std::uint64_t, GLsync> m_syncs;
+    std::vector<Undo> m_undo;
+    bool m_inFrame {};
+};
+
+// Plays back a trace GLTraceRecorder wrote. Its three sections are the objects, created once by Prepare(), then the
+// state, restored before every loop of the frame, and the frame's calls.
+class GLTraceReplayer {
+public:
+    // Reads and decompresses the trace, without touching the context yet.
+    bool Load(const char* path);
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+
+    // Creates the objects of the trace in the current context. Returns false if the trace is corrupt.
+    bool Prepare();
+    // Restores the state the frame started from, and replays its calls. Returns false if the trace is corrupt.
+    bool ReplayFrame();
+    size_t GetFrameCallCount() const { return m_frameCallCount; }
+
+private:
+    bool Replay(std::span<const std::byte> section, size_t* callCount);
+
+    int m_width {};
+    int m_height {};
+    std::vector<std::byte> m_objects;
+    std::vector<std::byte> m_state;
+    std::vector<std::byte> m_frame;
+    size_t m_frameCallCount {};
+    GLTraceNames m_names;
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,235 @@
+#include "render/GeometryPool.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Glitter::Render {
+
+namespace {
+
+    // Returns the `size` bytes to stage at `offset`, appended to the last write when they follow it.
+    std::span<std::byte> StageWrite(std::vector<GeometryWrite>& writes, size_t offset, size_t size)
+    {
+        if (writes.empty() || writes.back().m_offset + writes.back().m_data.size() != offset) {
+            writes.push_back(GeometryWrite {.m_offset = offset, .m_data = {}});
+        }
+
+        std::vector<std::byte>& data = writes.back().m_data;
+        size_t writeOffset = data.size();
+        data.resize(writeOffset + size);
+        return std::span(data).subspan(writeOffset);
+    }
+
+    void WriteAll(GLuint buffer, const std::vector<GeometryWrite>& writes)
+    {
+        for (const GeometryWrite& write : writes) {
+            glNamedBufferSubData(buffer, static_cast<GLintptr>(write.m_offset), static_cast<GLsizeiptr>(write.m_data.size()),
+                write.m_data.data());
+        }
+    }
+
+} // namespace
+
+GeometryPool::GeometryPool(GLsizei vertexStride, GLenum indexType, GLsizei positionStride, size_t pageSize)
+    : m_vertexStride(vertexStride)
+    , m_indexType(indexType)
+    , m_indexSize(indexType == GL_UNSIGNED_SHORT ? sizeof(std::uint16_t) : sizeof(std::uint32_t))
+    , m_positionStride(positionStride)
+{
+    LimitPageSize(pageSize);
+}
+
+void GeometryPool::LimitPageSize(size_t bytes)
+{
+    auto limit = [](size_t elements) { return static_cast<std::uint32_t>(std::clamp<size_t>(elements, 1, UINT32_MAX / 2)); };
+    m_pageVertices = std::min(m_pageVertices > 0 ? m_pageVertices : UINT32_MAX, limit(bytes / static_cast<size_t>(m_vertexStride)));
+    m_pageIndices = std::min(m_pageIndices > 0 ? m_pageIndices : UINT32_MAX, limit(bytes / m_indexSize));
+
+    // Past twice the page size, a page only grows by what's allocated in it.
+    for (Page& page : m_pages) {
+        page.m_vertices.SetCapacityLimit(2 * m_pageVertices);
+        page.m_indices.SetCapacityLimit(2 * m_pageIndices);
+        page.m_positions.SetCapacityLimit(2 * m_pageVertices);
+    }
+}
+
+std::uint32_t GeometryPool::AddPage()
+{
+    m_pages.push_back(Page {.m_vertexWrites = {},
+        .m_indexWrites = {},
+        .m_positionWrites = {},
+        .m_vertices = GpuBufferAllocator(static_cast<size_t>(m_vertexStride), "Geometry Pool VBO"),
+        .m_indices = GpuBufferAllocator(m_indexSize, "Geometry Pool EBO"),
+        .m_positions = GpuBufferAllocator(static_cast<size_t>(m_positionStride), "Geometry Pool Position VBO")});
+
+    Page& page = m_pages.back();
+    page.m_vertices.SetCapacityLimit(2 * m_pageVertices);
+    page.m_indices.SetCapacityLimit(2 * m_pageIndices);
+    page.m_positions.SetCapacityLimit(2 * m_pageVertices);
+    return static_cast<std::uint32_t>(m_pages.size() - 1);
+}
+
+GeometryRange GeometryPool::Add(std::span<const std::byte> vertices, std::span<const std::uint32_t> indices)
+{
+    auto stride = static_cast<size_t>(m_vertexStride);
+    auto vertexCount = static_cast<std::uint32_t>(vertices.size() / stride);
+    auto indexCount = static_cast<std::uint32_t>(indices.size());
+
+    auto pageIdx = static_cast<std::uint32_t>(std::ranges::find_if(m_pages, [&](const Page& page) {
+        return page.m_vertices.Fits(vertexCount, 1, m_pageVertices) && page.m_indices.Fits(indexCount, 1, m_pageIndices);
+    }) - m_pages.begin());
+    // A new page takes the primitive whatever its size.
+    if (pageIdx == m_pages.size()) {
+        AddPage();
+    }
+    Page& page = m_pages[pageIdx];
+
+    GpuRange range = page.m_vertices.Allocate(vertexCount);
+    std::ranges::copy(
+        vertices, StageWrite(page.m_vertexWrites, page.m_vertices.GetByteOffset(range.m_first), vertices.size()).begin());
+
+    if (m_positionStride > 0) {
+        auto positionStride = static_cast<size_t>(m_positionStride);
+        std::span<std::byte> positions
+            = StageWrite(page.m_positionWrites, page.m_positions.GetByteOffset(range.m_first), positionStride * vertexCount);
+        for (size_t vertexIdx = 0; vertexIdx < vertexCount; vertexIdx++) {
+            std::memcpy(&positions[positionStride * vertexIdx], &vertices[stride * vertexIdx], positionStride);
+        }
+    }
+
+    return AddIndices(pageIdx, static_cast<GLint>(range.m_first), indices);
+}
+
+GeometryRange GeometryPool::AddIndices(std::uint32_t page, GLint baseVertex, std::span<const std::uint32_t> indices)
+{
+    Page& target = m_pages[page];
+    GpuRange range = target.m_indices.Allocate(static_cast<std::uint32_t>(indices.size()));
+    std::span<std::byte> indexData
+        = StageWrite(target.m_indexWrites, target.m_indices.GetByteOffset(range.m_first), m_indexSize * indices.size());
+
+    if (m_indexType == GL_UNSIGNED_SHORT) {
+        for (size_t indexIdx = 0; indexIdx < indices.size(); indexIdx++) {
+            auto index = static_cast<std::uint16_t>(indices[indexIdx]);
+            std::memcpy(&indexData[sizeof(std::uint16_t) * indexIdx], &index, sizeof(index));
+        }
+    } else {
+        std::ranges::copy(std::as_bytes(indices), indexData.begin());
+    }
+
+    return GeometryRange {.m_baseVertex = baseVertex,
+        .m_firstIndex = static_cast<GLuint>(range.m_first),
+        .m_indexCount = static_cast<GLsizei>(indices.size()),
+        .m_page = page};
+}
+
+GeometryRange GeometryPool::Allocate(
+    std::uint32_t page, std::uint32_t vertexCount, std::uint32_t indexCount, std::uint32_t indexAlignment)
+{
+    GpuRange vertices = m_pages[page].m_vertices.Allocate(vertexCount);
+    GpuRange indices = m_pages[page].m_indices.Allocate(indexCount, indexAlignment);
+    return GeometryRange {.m_baseVertex = static_cast<GLint>(vertices.m_first),
+        .m_firstIndex = static_cast<GLuint>(indices.m_first),
+        .m_indexCount = static_cast<GLsizei>(indexCount),
+        .m_page = page};
+}
+
+GeometryRange GeometryPool::AllocateIndices(
+    std::uint32_t page, GLint baseVertex, std::uint32_t indexCount, std::uint32_t indexAlignment)
+{
+    GpuRange indices = m_pages[page].m_indices.Allocate(indexCount, indexAlignment);
+    return GeometryRange {.m_baseVertex = baseVertex,
+        .m_firstIndex = static_cast<GLuint>(indices.m_first),
+        .m_indexCount = static_cast<GLsizei>(indexCount),
+        .m_page = page};
+}
+
+void GeometryPool::FreeVertices(std::uint32_t page, GLint baseVertex, GLsizei vertexCount)
+{
+    m_pages[page].m_vertices.Free(
+        GpuRange {.m_first = static_cast<std::uint32_t>(baseVertex), .m_count = static_cast<std::uint32_t>(vertexCount)});
+}
+
+void GeometryPool::FreeIndices(const GeometryRange& range)
+{
+    m_pages[range.m_page].m_indices.Free(
+        GpuRange {.m_first = range.m_firstIndex, .m_count = static_cast<std::uint32_t>(range.m_indexCount)});
+}
+
+bool GeometryPool::Upload()
+{
+    GeometryUpload upload {};
+    bool reallocated = Stage(upload);
+    Write(upload);
+    return reallocated;
+}
+
+bool GeometryPool::Stage(GeometryUpload& upload)
+{
+    bool staged = std::ranges::any_of(
+        m_pages, [](const Page& page) { return !page.m_vertexWrites.empty() || !page.m_indexWrites.empty(); });
+    if (!staged) {
+        return false;
+    }
+
+    bool reallocated = Reserve();
+    upload.m_pages.clear();
+    for (Page& page : m_pages) {
+        if (page.m_vertexWrites.empty() && page.m_indexWrites.empty()) {
+            continue;
+        }
+
+        upload.m_pages.push_back(GeometryPageUpload {.m_vbo = page.m_vertices.GetBuffer(),
+            .m_ebo = page.m_indices.GetBuffer(),
+            .m_positionVbo = page.m_positions.GetBuffer(),
+            .m_vertexWrites = std::move(page.m_vertexWrites),
+            .m_indexWrites = std::move(page.m_indexWrites),
+            .m_positionWrites = std::move(page.m_positionWrites)});
+
+        page.m_vertexWrites = {};
+        page.m_indexWrites = {};
+        page.m_positionWrites = {};
+    }
+
+    return reallocated;
+}
+
+void GeometryPool::Write(const GeometryUpload& upload)
+{
+    for (const GeometryPageUpload& page : upload.m_pages) {
+        WriteAll(page.m_vbo, page.m_vertexWrites);
+        WriteAll(page.m_ebo, page.m_indexWrites);
+        WriteAll(page.m_positionVbo, page.m_positionWrites);
+    }
+}
+
+bool GeometryPool::Reserve()
+{
+    bool reallocated = false;
+    for (Page& page : m_pages) {
+        reallocated |= page.m_vertices.Reserve();
+        reallocated |= page.m_indices.Reserve();
+        if (m_positionStride > 0) {
+            reallocated |= page.m_positions.Reserve(page.m_vertices.GetEnd());
+        }
+    }
+    return reallocated;
+}
+
+bool GeometryPool::NeedsReallocation() const
+{
+    return std::ranges::any_of(m_pages, [&](const Page& page) {
+        return page.m_vertices.NeedsReallocation() || page.m_indices.NeedsReallocation()
+            || (m_positionStride > 0 && page.m_positions.NeedsReallocation(page.m_vertices.GetEnd()));
+    });
+}
+
+void GeometryPool::Release()
+{
+    for (Page& page : m_pages) {
+        page.m_vertices.Release();
+        page.m_indices.Release();
+        page.m_positions.Release();
+    }
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Config.h"
+#include "render/GpuBufferAllocator.h"
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Glitter::Render {
+
+// Location of a sub-allocated primitive inside the pool, in the form expected by the indirect draw commands, within the
+// buffers of page `m_page`.
+struct GeometryRange {
+    GLint m_baseVertex;
+    GLuint m_firstIndex;
+    GLsizei m_indexCount;
+    std::uint32_t m_page;
+};
+
+// Bytes to write at `m_offset` of one of the pool's buffers.
+struct GeometryWrite {
+    size_t m_offset;
+    std::vector<std::byte> m_data;
+};
+
+// Data staged by GeometryPool::Stage() for the buffers of one of its pages. Primitives added back-to-back are merged into
+// a single write.
+struct GeometryPageUpload {
+    GLuint m_vbo;
+    GLuint m_ebo;
+    GLuint m_positionVbo;
+    std::vector<GeometryWrite> m_vertexWrites;
+    std::vector<GeometryWrite> m_indexWrites;
+    std::vector<GeometryWrite> m_positionWrites;
+};
+
+// Data staged by GeometryPool::Stage(), to be written into the pool's buffers.
+struct GeometryUpload {
+    std::vector<GeometryPageUpload> m_pages;
+};
+
+// Packs the vertices and indices of every primitive into one shared VBO and EBO, so the VAO only has to be bound once
+// and draws differ only by their `baseVertex`/`firstIndex` offsets. Primitives can be added at any time, they're staged
+// on the CPU until the next Upload(). Indices are stored as GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, relative to each
+// primitive's base vertex, so 16-bit indices only limit the vertices per primitive.
+//
+// The ranges are sub-allocated by a GpuBufferAllocator, so primitives can be freed as well, and the ones added next reuse
+// their space instead of growing the buffers.
+//
+// The buffers are split into pages, each with a VBO and EBO of its own, so that the geometry isn't bounded by the size of
+// a single buffer, nor of the SSBO blocks the VBO and EBO are bound as, and its indices not by 32-bit offsets. A
+// primitive goes into the first page with room for its vertices and indices within the page size, or into a new one.
+// What is added over the vertices of a page, e.g. the LODs of a primitive, goes into that page whatever room is left,
+// so the page size leaves room for them. The draws of different pages need the VAOs pointed at each page in turn.
+//
+// With a `positionStride`, the pool also keeps a position-only stream alongside the VBO, made of the first
+// `positionStride` bytes of every vertex, for the passes that only need positions to fetch a quarter of the bytes or so.
+// The positions must lead the vertices.
+class GeometryPool {
+public:
+    explicit GeometryPool(GLsizei vertexStride, GLenum indexType = GL_UNSIGNED_INT, GLsizei positionStride = 0,
+        size_t pageSize = Config::GEOMETRY_PAGE_SIZE);
+
+    // Lowers the page size to `bytes`, e.g. to the SSBO block size limit, for the pages added from then on.
+    void LimitPageSize(size_t bytes);
+
+    template <typename Vertex> GeometryRange Add(std::span<const Vertex> vertices, std::span<const std::uint32_t> indices)
+    {
+        return Add(std::as_bytes(vertices), indices);
+    }
+    // With GL_UNSIGNED_SHORT, every index must be below 65536.
+    GeometryRange Add(std::span<const std::byte> vertices, std::span<const std::uint32_t> indices);
+    // Adds another index list over vertices already added at `baseVertex` of `page`, e.g. a LOD of a primitive.
+    GeometryRange AddIndices(std::uint32_t page, GLint baseVertex, std::span<const std::uint32_t> indices);
+    // Allocates `vertexCount` vertices and `indexCount` indices in `page` without staging anything, for the GPU to write
+    // once the buffers are reserved, e.g. the static batches. The indices start at a multiple of `indexAlignment`.
+    GeometryRange Allocate(
+        std::uint32_t page, std::uint32_t vertexCount, std::uint32_t indexCount, std::uint32_t indexAlignment = 1);
+    // Likewise allocates `indexCount` indices over vertices already allocated at `baseVertex` of `page`.
+    GeometryRange AllocateIndices(
+        std::uint32_t page, GLint baseVertex, std::uint32_t indexCount, std::uint32_t indexAlignment = 1);
+
+    // Frees the `vertexCount` vertices at `baseVertex` of `page`, and the index lists over them separately. The frames in
+    // flight must no longer draw them.
+    void FreeVertices(std::uint32_t page, GLint baseVertex, GLsizei vertexCount);
+    void FreeIndices(const GeometryRange& range);
+
+    // Writes everything added since the last call into the GPU buffers and releases the CPU-side staging data. Returns
+    // true if the buffers had to be reallocated to fit it, in which case the VAOs must be pointed at the new ones.
+    bool Upload();
+    // Like Upload(), but hands the staged data over instead of writing it, e.g. to write it from another context with
+    // Write(). Reallocating copies what was staged before, so those writes must have completed if NeedsReallocation().
+    bool Stage(GeometryUpload& upload);
+    static void Write(const GeometryUpload& upload);
+    // Grows the buffers to hold every allocation, see Upload() for its result.
+    bool Reserve();
+    bool NeedsReallocation() const;
+    void Release();
+
+    size_t GetPageCount() const { return m_pages.size(); }
+    GLuint GetVBO(std::uint32_t page) const { return page < m_pages.size() ? m_pages[page].m_vertices.GetBuffer() : 0; }
+    GLuint GetEBO(std::uint32_t page) const { return page < m_pages.size() ? m_pages[page].m_indices.GetBuffer() : 0; }
+    GLsizei GetVertexStride() const { return m_vertexStride; }
+    // 0 without a position stream.
+    GLuint GetPositionVBO(std::uint32_t page) const
+    {
+        return page < m_pages.size() ? m_pages[page].m_positions.GetBuffer() : 0;
+    }
+    GLsizei GetPositionStride() const { return m_positionStride; }
+    GLenum GetIndexType() const { return m_indexType; }
+    const GpuBufferAllocator& GetVertexAllocator(std::uint32_t page) const { return m_pages[page].m_vertices; }
+    const GpuBufferAllocator& GetIndexAllocator(std::uint32_t page) const { return m_pages[page].m_indices; }
+
+private:
+    struct Page {
+        // Staged since the last Upload().
+        std::vector<GeometryWrite> m_vertexWrites;
+        std::vector<GeometryWrite> m_indexWrites;
+        std::vector<GeometryWrite> m_positionWrites;
+
+        // In vertices and indices. The position stream isn't allocated from, it mirrors the vertices at its own stride.
+        GpuBufferAllocator m_vertices;
+        GpuBufferAllocator m_indices;
+        GpuBufferAllocator m_positions;
+    };
+
+    std::uint32_t AddPage();
+
+    GLsizei m_vertexStride;
+    GLenum m_indexType;
+    size_t m_indexSize;
+    GLsizei m_positionStride;
+
+    // The vertices and indices new primitives fill a page up to.
+    std::uint32_t m_pageVertices {};
+    std::uint32_t m_pageIndices {};
+
+    std::vector<Page> m_pages;
+};
+
+} // namespace Glitter::Render
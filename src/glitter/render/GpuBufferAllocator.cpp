@@ -0,0 +1,156 @@
+#include "render/GpuBufferAllocator.h"
+
+#include "render/GpuMemory.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace Glitter::Render {
+
+namespace {
+
+    std::uint32_t AlignUp(std::uint32_t element, std::uint32_t alignment)
+    {
+        return (element + alignment - 1) / alignment * alignment;
+    }
+
+} // namespace
+
+GpuBufferAllocator::GpuBufferAllocator(size_t elementSize, const char* label)
+    : m_elementSize(elementSize)
+    , m_label(label)
+{
+}
+
+GpuRange GpuBufferAllocator::Allocate(std::uint32_t count, std::uint32_t alignment)
+{
+    if (count == 0) {
+        return GpuRange {.m_first = 0, .m_count = 0};
+    }
+    alignment = std::max(alignment, 1u);
+
+    // Any range this large fits, wherever it starts.
+    auto best = m_freeBySize.lower_bound({count + alignment - 1, 0u});
+    if (best != m_freeBySize.end()) {
+        GpuRange free {.m_first = best->second, .m_count = best->first};
+        EraseFree(m_freeByOffset.find(free.m_first));
+
+        // Whatever is left on either side of the allocation stays free.
+        std::uint32_t first = AlignUp(free.m_first, alignment);
+        InsertFree(GpuRange {.m_first = free.m_first, .m_count = first - free.m_first});
+        InsertFree(GpuRange {.m_first = first + count, .m_count = free.m_first + free.m_count - (first + count)});
+
+        m_freeCount -= count;
+        return GpuRange {.m_first = first, .m_count = count};
+    }
+
+    // Nothing fits, extend the end. The padding up to the alignment can be used by smaller allocations.
+    std::uint32_t first = AlignUp(m_end, alignment);
+    InsertFree(GpuRange {.m_first = m_end, .m_count = first - m_end});
+    m_freeCount += first - m_end;
+    m_end = first + count;
+    return GpuRange {.m_first = first, .m_count = count};
+}
+
+bool GpuBufferAllocator::Fits(std::uint32_t count, std::uint32_t alignment, std::uint32_t limit) const
+{
+    if (count == 0) {
+        return true;
+    }
+    alignment = std::max(alignment, 1u);
+
+    // The free ranges all end before m_end.
+    if (m_freeBySize.lower_bound({count + alignment - 1, 0u}) != m_freeBySize.end()) {
+        return true;
+    }
+    std::uint64_t end = std::uint64_t {AlignUp(m_end, alignment)} + count;
+    return end <= limit;
+}
+
+void GpuBufferAllocator::Free(GpuRange range)
+{
+    if (range.m_count == 0) {
+        return;
+    }
+    m_freeCount += range.m_count;
+
+    // Merge with the neighbouring free ranges.
+    auto next = m_freeByOffset.lower_bound(range.m_first);
+    if (next != m_freeByOffset.end() && range.m_first + range.m_count == next->first) {
+        range.m_count += next->second;
+        auto merged = next++;
+        EraseFree(merged);
+    }
+    if (next != m_freeByOffset.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == range.m_first) {
+            range = GpuRange {.m_first = previous->first, .m_count = previous->second + range.m_count};
+            EraseFree(previous);
+        }
+    }
+
+    // A free range at the end just moves the end back.
+    if (range.m_first + range.m_count == m_end) {
+        m_end = range.m_first;
+        m_freeCount -= range.m_count;
+        return;
+    }
+    InsertFree(range);
+}
+
+void GpuBufferAllocator::Clear()
+{
+    m_freeByOffset.clear();
+    m_freeBySize.clear();
+    m_end = 0;
+    m_freeCount = 0;
+}
+
+bool GpuBufferAllocator::Reserve(std::uint32_t count)
+{
+    if (!NeedsReallocation(count)) {
+        return false;
+    }
+
+    std::uint32_t capacity = std::max({m_end, count, std::min(m_capacity * 2, m_capacityLimit)});
+
+    GLuint buffer = 0;
+    glCreateBuffers(1, &buffer);
+    NamedBufferStorage(GpuMemoryCategory::Buffer, buffer, static_cast<GLsizeiptr>(m_elementSize * capacity), nullptr,
+        GL_DYNAMIC_STORAGE_BIT);
+    glObjectLabel(GL_BUFFER, buffer, -1, m_label);
+    if (m_capacity > 0) {
+        glCopyNamedBufferSubData(m_buffer, buffer, 0, 0, static_cast<GLsizeiptr>(m_elementSize * m_capacity));
+    }
+    DeleteBuffers(1, &m_buffer);
+
+    m_buffer = buffer;
+    m_capacity = capacity;
+    return true;
+}
+
+bool GpuBufferAllocator::NeedsReallocation(std::uint32_t count) const { return std::max(m_end, count) > m_capacity; }
+
+void GpuBufferAllocator::InsertFree(GpuRange range)
+{
+    if (range.m_count > 0) {
+        m_freeByOffset.emplace(range.m_first, range.m_count);
+        m_freeBySize.emplace(range.m_count, range.m_first);
+    }
+}
+
+void GpuBufferAllocator::EraseFree(std::map<std::uint32_t, std::uint32_t>::iterator free)
+{
+    m_freeBySize.erase({free->second, free->first});
+    m_freeByOffset.erase(free);
+}
+
+void GpuBufferAllocator::Release()
+{
+    DeleteBuffers(1, &m_buffer);
+    m_buffer = 0;
+    m_capacity = 0;
+    Clear();
+}
+
+} // namespace Glitter::Render
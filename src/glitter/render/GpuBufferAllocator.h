@@ -0,0 +1,195 @@
+#pragma once
+
+#include "render/RenderStats.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Glitter::Render {
+
+// A range of elements of a GpuBufferAllocator.
+struct GpuRange {
+    std::uint32_t m_first;
+    std::uint32_t m_count;
+};
+
+// Sub-allocates ranges of elements of one immutable buffer, so that content can be added and removed at runtime without
+// creating GL objects for it. The free ranges are merged with their neighbours as they're freed, and each allocation takes
+// the smallest one that fits, so that the large ones stay whole and sub-allocating stays logarithmic in the free ranges.
+//
+// Allocating is only bookkeeping: when no free range fits, the allocation extends the end of the buffer, past its capacity
+// if needed, and Reserve() grows the buffer to it later, copying what it held. The offsets of the allocations never change,
+// only the buffer does.
+class GpuBufferAllocator {
+public:
+    GpuBufferAllocator(size_t elementSize, const char* label);
+
+    // `count` elements starting at a multiple of `alignment` elements.
+    GpuRange Allocate(std::uint32_t count, std::uint32_t alignment = 1);
+    // Whether Allocate() would return a range ending at or before element `limit`.
+    bool Fits(std::uint32_t count, std::uint32_t alignment, std::uint32_t limit) const;
+    // The range can be handed out again by the next Allocate(), so the frames in flight must no longer read it.
+    void Free(GpuRange range);
+    // Frees every range, keeping the buffer.
+    void Clear();
+
+    // Grows the buffer to hold every allocation, and at least `count` elements, copying its contents over. Returns true if
+    // it was reallocated, in which case whatever it's bound to must be pointed at the new one.
+    bool Reserve(std::uint32_t count = 0);
+    // Keeps Reserve() from doubling the buffer past `count` elements, though it still grows to hold every allocation.
+    void SetCapacityLimit(std::uint32_t count) { m_capacityLimit = count; }
+    bool NeedsReallocation(std::uint32_t count = 0) const;
+    void Release();
+
+    GLuint GetBuffer() const { return m_buffer; }
+    size_t GetElementSize() const { return m_elementSize; }
+    GLintptr GetByteOffset(std::uint32_t element) const { return static_cast<GLintptr>(m_elementSize * element); }
+    // In elements.
+    std::uint32_t GetCapacity() const { return m_capacity; }
+    // One past the last allocated element.
+    std::uint32_t GetEnd() const { return m_end; }
+    // The elements freed below GetEnd(), and the ranges they're split into.
+    std::uint32_t GetFreeCount() const { return m_freeCount; }
+    size_t GetFreeRangeCount() const { return m_freeByOffset.size(); }
+
+private:
+    void InsertFree(GpuRange range);
+    void EraseFree(std::map<std::uint32_t, std::uint32_t>::iterator free);
+
+    size_t m_elementSize;
+    const char* m_label;
+
+    // The free ranges, never adjacent to each other or to m_end, by their first element and by their count.
+    std::map<std::uint32_t, std::uint32_t> m_freeByOffset;
+    std::set<std::pair<std::uint32_t, std::uint32_t>> m_freeBySize;
+    std::uint32_t m_end {};
+    std::uint32_t m_freeCount {};
+
+    GLuint m_buffer {};
+    std::uint32_t m_capacity {};
+    std::uint32_t m_capacityLimit {UINT32_MAX};
+};
+
+// A range of a GpuBuffer<T>, which can't be mixed up with the ranges of buffers of other types.
+template <typename T> struct GpuHandle {
+    GpuRange m_range;
+};
+
+// A GpuBufferAllocator of `T`s.
+template <typename T> class GpuBuffer {
+public:
+    explicit GpuBuffer(const char* label)
+        : m_allocator(sizeof(T), label)
+    {
+    }
+
+    GpuHandle<T> Allocate(std::uint32_t count) { return GpuHandle<T> {m_allocator.Allocate(count)}; }
+    void Free(GpuHandle<T> handle) { m_allocator.Free(handle.m_range); }
+    void Clear() { m_allocator.Clear(); }
+    bool Reserve(std::uint32_t count = 0) { return m_allocator.Reserve(count); }
+    void SetCapacityLimit(std::uint32_t count) { m_allocator.SetCapacityLimit(count); }
+    void Release() { m_allocator.Release(); }
+
+    // Writes `data` at element `first` of the buffer, which must have been reserved.
+    void Write(RenderStats& stats, std::uint32_t first, std::span<const T> data) const
+    {
+        stats.NamedBufferSubData(m_allocator.GetBuffer(), m_allocator.GetByteOffset(first),
+            static_cast<GLsizeiptr>(data.size_bytes()), data.data());
+    }
+    // Writes `data` at element `offset` of `handle`.
+    void Write(RenderStats& stats, GpuHandle<T> handle, std::span<const T> data, std::uint32_t offset = 0) const
+    {
+        Write(stats, handle.m_range.m_first + offset, data);
+    }
+
+    GLuint GetBuffer() const { return m_allocator.GetBuffer(); }
+    GLintptr GetByteOffset(GpuHandle<T> handle) const { return m_allocator.GetByteOffset(handle.m_range.m_first); }
+    const GpuBufferAllocator& GetAllocator() const { return m_allocator; }
+
+private:
+    GpuBufferAllocator m_allocator;
+};
+
+// `T`s in pages of `pageSize` elements, each a GpuBuffer of its own, for more elements than a single buffer or SSBO block
+// holds. Element `i` lies at `i % pageSize` of page `i / pageSize`, so that the pages are bound one at a time and indexed
+// the same way whichever is bound.
+template <typename T> class PagedGpuBuffer {
+public:
+    PagedGpuBuffer(const char* label, std::uint32_t pageSize)
+        : m_label(label)
+        , m_pageSize(pageSize)
+    {
+    }
+
+    // Grows the pages to hold `count` elements, adding pages as needed, and keeps what they held. Returns true if a
+    // buffer was reallocated, in which case whatever it's bound to must be pointed at the new one.
+    bool Reserve(std::uint32_t count)
+    {
+        auto pageCount = std::max<size_t>((static_cast<size_t>(count) + m_pageSize - 1) / m_pageSize, 1);
+        while (m_pages.size() < pageCount) {
+            m_pages.emplace_back(m_label).SetCapacityLimit(m_pageSize);
+        }
+
+        bool grew = false;
+        for (size_t page = 0; page < m_pages.size(); page++) {
+            std::uint32_t first = GetFirst(static_cast<std::uint32_t>(page));
+            grew |= m_pages[page].Reserve(count > first ? std::min(count - first, m_pageSize) : 0);
+        }
+        m_buffers.resize(m_pages.size());
+        for (size_t page = 0; page < m_pages.size(); page++) {
+            m_buffers[page] = m_pages[page].GetBuffer();
+        }
+        return grew;
+    }
+
+    void Release()
+    {
+        for (GpuBuffer<T>& page : m_pages) {
+            page.Release();
+        }
+        m_pages.clear();
+        m_buffers.clear();
+    }
+
+    // Writes `data` from element `first` on, split over the pages it spans, which must have been reserved.
+    void Write(RenderStats& stats, std::uint32_t first, std::span<const T> data) const
+    {
+        while (!data.empty()) {
+            std::uint32_t page = GetPage(first);
+            size_t count = std::min<size_t>(data.size(), GetFirst(page + 1) - first);
+            m_pages[page].Write(stats, first - GetFirst(page), data.first(count));
+            first += static_cast<std::uint32_t>(count);
+            data = data.subspan(count);
+        }
+    }
+
+    std::uint32_t GetPage(std::uint32_t element) const { return element / m_pageSize; }
+    // The first element of `page`.
+    std::uint32_t GetFirst(std::uint32_t page) const { return page * m_pageSize; }
+    std::uint32_t GetPageSize() const { return m_pageSize; }
+    std::uint32_t GetPageCount() const { return static_cast<std::uint32_t>(m_pages.size()); }
+    GLuint GetBuffer(std::uint32_t page) const { return m_buffers[page]; }
+    // Every page's buffer, in order.
+    std::span<const GLuint> GetBuffers() const { return m_buffers; }
+    // In elements, over every page.
+    std::uint32_t GetCapacity() const
+    {
+        return m_pages.empty() ? 0 : GetFirst(GetPageCount() - 1) + m_pages.back().GetAllocator().GetCapacity();
+    }
+
+private:
+    const char* m_label;
+    std::uint32_t m_pageSize;
+    std::vector<GpuBuffer<T>> m_pages;
+    std::vector<GLuint> m_buffers;
+};
+
+} // namespace Glitter::Render
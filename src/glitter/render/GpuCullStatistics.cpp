@@ -0,0 +1,103 @@
+#include "render/GpuCullStatistics.h"
+
+#include "render/GpuMemory.h"
+
+#include <type_traits>
+
+namespace Glitter::Render {
+
+static_assert(std::is_trivially_copyable_v<GpuCullCounts>
+        && sizeof(GpuCullCounts) == sizeof(std::uint32_t) * (4 + Config::MESH_LOD_COUNT),
+    "GpuCullCounts must match CullCS.glsl's CullStatistics SSBO");
+
+void GpuCullStatistics::Create()
+{
+    Release();
+    glCreateBuffers(1, &m_counterBuffer);
+    NamedBufferStorage(GpuMemoryCategory::Buffer, m_counterBuffer, sizeof(GpuCullCounts), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    glObjectLabel(GL_BUFFER, m_counterBuffer, -1, "Cull Statistics SSBO");
+
+    // Read into client-side storage when the driver can, since only the CPU reads these buffers.
+    for (Slot& slot : m_slots) {
+        glCreateBuffers(1, &slot.m_buffer);
+        NamedBufferStorage(GpuMemoryCategory::StreamBuffer, slot.m_buffer, sizeof(GpuCullCounts), nullptr,
+            GL_MAP_READ_BIT | GL_CLIENT_STORAGE_BIT);
+        glObjectLabel(GL_BUFFER, slot.m_buffer, -1, "Cull Statistics Readback Buffer");
+    }
+}
+
+void GpuCullStatistics::Release()
+{
+    for (Slot& slot : m_slots) {
+        if (slot.m_fence) {
+            glDeleteSync(slot.m_fence);
+        }
+        DeleteBuffers(1, &slot.m_buffer);
+        slot = {};
+    }
+    DeleteBuffers(1, &m_counterBuffer);
+    m_counterBuffer = 0;
+    m_next = 0;
+    m_pendingCount = 0;
+    m_passCount = 0;
+    m_latest.reset();
+}
+
+void GpuCullStatistics::BeginPass(RenderStats& stats, size_t nodeCount)
+{
+    constexpr GpuCullCounts zeroCounts {};
+    stats.NamedBufferSubData(m_counterBuffer, 0, sizeof(zeroCounts), &zeroCounts);
+    stats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 13, m_counterBuffer);
+    m_nodeCount = nodeCount;
+}
+
+void GpuCullStatistics::EndPass()
+{
+    m_passCount++;
+    if (m_pendingCount == m_slots.size()) {
+        return;
+    }
+
+    // The copy reads the counters the pass' atomics wrote, and the next pass' zeroing overwrites them.
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    Slot& slot = m_slots[m_next];
+    glCopyNamedBufferSubData(m_counterBuffer, slot.m_buffer, 0, 0, sizeof(GpuCullCounts));
+    slot.m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.m_pass = m_passCount;
+    slot.m_nodeCount = m_nodeCount;
+    m_next = (m_next + 1) % m_slots.size();
+    m_pendingCount++;
+}
+
+void GpuCullStatistics::Poll()
+{
+    while (m_pendingCount > 0) {
+        Slot& slot = m_slots[(m_next + m_slots.size() - m_pendingCount) % m_slots.size()];
+        GLenum status = glClientWaitSync(slot.m_fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            return;
+        }
+        glDeleteSync(slot.m_fence);
+        slot.m_fence = nullptr;
+        m_pendingCount--;
+
+        const auto* counts = static_cast<const GpuCullCounts*>(
+            glMapNamedBufferRange(slot.m_buffer, 0, sizeof(GpuCullCounts), GL_MAP_READ_BIT));
+        if (counts) {
+            m_latest = *counts;
+            m_latestPass = slot.m_pass;
+            m_latestNodeCount = slot.m_nodeCount;
+            glUnmapNamedBuffer(slot.m_buffer);
+        }
+    }
+}
+
+std::optional<GpuCullReadback> GpuCullStatistics::GetLatest() const
+{
+    if (!m_latest) {
+        return std::nullopt;
+    }
+    return GpuCullReadback {.m_counts = *m_latest, .m_nodeCount = m_latestNodeCount, .m_age = m_passCount - m_latestPass};
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Config.h"
+#include "render/RenderStats.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace Glitter::Render {
+
+// The Node counts of a GPU culling pass, laid out like CullCS.glsl's CullStatistics SSBO. Zero-opacity Nodes are in none
+// of them, and each Node culled is counted by the first test it fails.
+struct GpuCullCounts {
+    std::uint32_t m_visibleNodes;
+    std::uint32_t m_frustumCulledNodes;
+    // Too far or too small, see the contribution culling.
+    std::uint32_t m_contributionCulledNodes;
+    std::uint32_t m_occlusionCulledNodes;
+    // The visible Nodes by the LOD level their projected size selects, whether or not the pass draws LODs.
+    std::array<std::uint32_t, Config::MESH_LOD_COUNT> m_lodNodes;
+};
+
+// The statistics of a pass read back, and how many passes ago it ran.
+struct GpuCullReadback {
+    GpuCullCounts m_counts;
+    size_t m_nodeCount;
+    std::uint64_t m_age;
+};
+
+// Counts the Nodes the GPU culling pass keeps and culls without stalling on it: every pass accumulates into an SSBO,
+// copied at its end into a buffer of a ring of Config::FRAMES_IN_FLIGHT, fenced, and the buffer is only mapped once its
+// fence has signaled, frames later, like FrameReadback. Passes ending while every buffer of the ring is still in flight
+// aren't read back.
+class GpuCullStatistics {
+public:
+    void Create();
+    void Release();
+
+    // Zeroes the counters of the pass of `nodeCount` Nodes about to be dispatched, binding them through `stats` at
+    // binding 13.
+    void BeginPass(RenderStats& stats, size_t nodeCount);
+    // Queues the copy of the counters once the pass has been dispatched.
+    void EndPass();
+
+    // Reads back every copy the GPU has finished, without waiting for the others.
+    void Poll();
+    // The latest pass read back, if any.
+    std::optional<GpuCullReadback> GetLatest() const;
+
+private:
+    struct Slot {
+        GLuint m_buffer;
+        GLsync m_fence;
+        std::uint64_t m_pass;
+        size_t m_nodeCount;
+    };
+
+    GLuint m_counterBuffer {};
+    std::array<Slot, Config::FRAMES_IN_FLIGHT> m_slots {};
+    // The slot of the next copy, and the count of slots before it still in flight.
+    size_t m_next {};
+    size_t m_pendingCount {};
+
+    std::uint64_t m_passCount {};
+    size_t m_nodeCount {};
+    std::optional<GpuCullCounts> m_latest;
+    std::uint64_t m_latestPass {};
+    size_t m_latestNodeCount {};
+};
+
+} // namespace Glitter::Render
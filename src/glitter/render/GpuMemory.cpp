@@ -0,0 +1,191 @@
+#include "render/GpuMemory.h"
+
+#include "render/GLExtensions.h"
+#include "render/TextureFile.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+namespace Glitter::Render {
+
+namespace {
+
+    struct Allocation {
+        size_t m_bytes;
+        GpuMemoryCategory m_category;
+    };
+
+    // Buffers, textures and renderbuffers have names of their own, so each is tracked by its kind and name.
+    enum class ObjectKind : std::uint8_t {
+        Buffer,
+        Texture,
+        Renderbuffer,
+    };
+
+    std::mutex s_mutex;
+    std::unordered_map<std::uint64_t, Allocation> s_allocations;
+    std::array<GpuMemoryUsage, GPU_MEMORY_CATEGORY_COUNT> s_usage {};
+
+    std::uint64_t GetKey(ObjectKind kind, GLuint name) { return (static_cast<std::uint64_t>(kind) << 32) | name; }
+
+    void Untrack(std::unordered_map<std::uint64_t, Allocation>::iterator allocation)
+    {
+        GpuMemoryUsage& usage = s_usage[static_cast<size_t>(allocation->second.m_category)];
+        usage.m_bytes -= allocation->second.m_bytes;
+        usage.m_objects--;
+        s_allocations.erase(allocation);
+    }
+
+    void Track(ObjectKind kind, GLuint name, GpuMemoryCategory category, size_t bytes)
+    {
+        std::scoped_lock lock(s_mutex);
+        if (auto previous = s_allocations.find(GetKey(kind, name)); previous != s_allocations.end()) {
+            Untrack(previous);
+        }
+        s_allocations.emplace(GetKey(kind, name), Allocation {.m_bytes = bytes, .m_category = category});
+        GpuMemoryUsage& usage = s_usage[static_cast<size_t>(category)];
+        usage.m_bytes += bytes;
+        usage.m_objects++;
+    }
+
+    void Untrack(ObjectKind kind, GLsizei count, const GLuint* names)
+    {
+        std::scoped_lock lock(s_mutex);
+        for (GLsizei nameIdx = 0; nameIdx < count; nameIdx++) {
+            if (auto allocation = s_allocations.find(GetKey(kind, names[nameIdx])); allocation != s_allocations.end()) {
+                Untrack(allocation);
+            }
+        }
+    }
+
+    // Bytes per texel of the uncompressed formats, 4 for the ones not listed.
+    size_t GetTexelSize(GLenum format)
+    {
+        switch (format) {
+        case GL_R8:
+        case GL_R8UI:
+            return 1;
+        case GL_R16F:
+        case GL_RG8:
+        case GL_DEPTH_COMPONENT16:
+            return 2;
+        case GL_RGBA16F:
+        case GL_RG32F:
+        case GL_RG32UI:
+            return 8;
+        case GL_RGBA32F:
+        case GL_RGBA32UI:
+            return 16;
+        default:
+            return 4;
+        }
+    }
+
+    size_t GetTextureSize(GLsizei levels, GLenum format, GLsizei width, GLsizei height, GLsizei depth)
+    {
+        size_t blockSize = GetCompressedBlockSize(format);
+        size_t bytes = 0;
+        for (GLsizei level = 0; level < levels; level++) {
+            auto levelWidth = static_cast<size_t>(std::max(width >> level, 1));
+            auto levelHeight = static_cast<size_t>(std::max(height >> level, 1));
+            if (blockSize > 0) {
+                bytes += (levelWidth + 3) / 4 * ((levelHeight + 3) / 4) * blockSize;
+            } else {
+                bytes += levelWidth * levelHeight * GetTexelSize(format);
+            }
+        }
+        // The layers of an array texture aren't mipmapped along with the others.
+        return bytes * static_cast<size_t>(depth);
+    }
+
+} // namespace
+
+const char* GetGpuMemoryCategoryName(GpuMemoryCategory category)
+{
+    constexpr std::array<const char*, GPU_MEMORY_CATEGORY_COUNT> NAMES {
+        "Buffers", "Stream Buffers", "Textures", "Render Targets"};
+    return NAMES[static_cast<size_t>(category)];
+}
+
+void NamedBufferStorage(GpuMemoryCategory category, GLuint buffer, GLsizeiptr size, const void* data, GLbitfield flags)
+{
+    glNamedBufferStorage(buffer, size, data, flags);
+    Track(ObjectKind::Buffer, buffer, category, static_cast<size_t>(size));
+}
+
+void NamedBufferData(GpuMemoryCategory category, GLuint buffer, GLsizeiptr size, const void* data, GLenum usage)
+{
+    glNamedBufferData(buffer, size, data, usage);
+    Track(ObjectKind::Buffer, buffer, category, static_cast<size_t>(size));
+}
+
+void TextureStorage2D(GpuMemoryCategory category, GLuint texture, GLsizei levels, GLenum format, GLsizei width, GLsizei height)
+{
+    glTextureStorage2D(texture, levels, format, width, height);
+    Track(ObjectKind::Texture, texture, category, GetTextureSize(levels, format, width, height, 1));
+}
+
+void TextureStorage3D(GpuMemoryCategory category, GLuint texture, GLsizei levels, GLenum format, GLsizei width,
+    GLsizei height, GLsizei depth)
+{
+    glTextureStorage3D(texture, levels, format, width, height, depth);
+    Track(ObjectKind::Texture, texture, category, GetTextureSize(levels, format, width, height, depth));
+}
+
+void NamedRenderbufferStorage(GpuMemoryCategory category, GLuint renderbuffer, GLenum format, GLsizei width, GLsizei height)
+{
+    glNamedRenderbufferStorage(renderbuffer, format, width, height);
+    Track(ObjectKind::Renderbuffer, renderbuffer, category, GetTextureSize(1, format, width, height, 1));
+}
+
+void DeleteBuffers(GLsizei count, const GLuint* buffers)
+{
+    Untrack(ObjectKind::Buffer, count, buffers);
+    glDeleteBuffers(count, buffers);
+}
+
+void DeleteTextures(GLsizei count, const GLuint* textures)
+{
+    Untrack(ObjectKind::Texture, count, textures);
+    glDeleteTextures(count, textures);
+}
+
+void DeleteRenderbuffers(GLsizei count, const GLuint* renderbuffers)
+{
+    Untrack(ObjectKind::Renderbuffer, count, renderbuffers);
+    glDeleteRenderbuffers(count, renderbuffers);
+}
+
+std::array<GpuMemoryUsage, GPU_MEMORY_CATEGORY_COUNT> GetGpuMemoryUsage()
+{
+    std::scoped_lock lock(s_mutex);
+    return s_usage;
+}
+
+std::optional<GpuMemoryInfo> QueryGpuMemoryInfo()
+{
+    constexpr size_t KIB = 1024;
+    const GLExtensions& extensions = GetGLExtensions();
+    if (extensions.m_gpuMemoryInfo) {
+        GLint dedicated = 0;
+        GLint available = 0;
+        GLint evicted = 0;
+        glGetIntegerv(GL_GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX, &dedicated);
+        glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &available);
+        glGetIntegerv(GL_GPU_MEMORY_INFO_EVICTED_MEMORY_NVX, &evicted);
+        return GpuMemoryInfo {.m_dedicatedBytes = static_cast<size_t>(dedicated) * KIB,
+            .m_availableBytes = static_cast<size_t>(available) * KIB,
+            .m_evictedBytes = static_cast<size_t>(evicted) * KIB};
+    }
+    if (extensions.m_memInfo) {
+        // The pools share the same memory on current drivers, the textures' is the one most of it goes to.
+        std::array<GLint, 4> textureFree {};
+        glGetIntegerv(GL_TEXTURE_FREE_MEMORY_ATI, textureFree.data());
+        return GpuMemoryInfo {
+            .m_dedicatedBytes = 0, .m_availableBytes = static_cast<size_t>(textureFree[0]) * KIB, .m_evictedBytes = 0};
+    }
+    return std::nullopt;
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace Glitter::Render {
+
+// What GL storage is used for, to break the GPU memory down in the debug UI and the benchmark results.
+enum class GpuMemoryCategory : std::uint8_t {
+    // The scene's persistent buffers: geometry, Node data and their tables.
+    Buffer,
+    // The rings written or read back every frame, and the buffers the frames grow.
+    StreamBuffer,
+    // The textures sampled by the Nodes and their impostors.
+    Texture,
+    // The targets rendered into: the render target pool's, the shadow maps' and the FBOs'.
+    RenderTarget,
+};
+constexpr size_t GPU_MEMORY_CATEGORY_COUNT = 4;
+
+const char* GetGpuMemoryCategoryName(GpuMemoryCategory category);
+
+struct GpuMemoryUsage {
+    size_t m_bytes;
+    size_t m_objects;
+};
+
+// The storage of every GL buffer, texture and renderbuffer is allocated and deleted through these, which record its size
+// under the object's name, so that the memory Glitter allocated can be told apart by category. The sizes are what the
+// storage holds, not what the driver pads or compresses it to. Reallocating an object's storage, e.g. by
+// NamedBufferData(), replaces its previous size. They can be called from any thread with a current context.
+void NamedBufferStorage(GpuMemoryCategory category, GLuint buffer, GLsizeiptr size, const void* data, GLbitfield flags);
+void NamedBufferData(GpuMemoryCategory category, GLuint buffer, GLsizeiptr size, const void* data, GLenum usage);
+void TextureStorage2D(
+    GpuMemoryCategory category, GLuint texture, GLsizei levels, GLenum format, GLsizei width, GLsizei height);
+void TextureStorage3D(GpuMemoryCategory category, GLuint texture, GLsizei levels, GLenum format, GLsizei width,
+    GLsizei height, GLsizei depth);
+void NamedRenderbufferStorage(GpuMemoryCategory category, GLuint renderbuffer, GLenum format, GLsizei width, GLsizei height);
+void DeleteBuffers(GLsizei count, const GLuint* buffers);
+void DeleteTextures(GLsizei count, const GLuint* textures);
+void DeleteRenderbuffers(GLsizei count, const GLuint* renderbuffers);
+
+// The memory currently allocated through the functions above, by GpuMemoryCategory.
+std::array<GpuMemoryUsage, GPU_MEMORY_CATEGORY_COUNT> GetGpuMemoryUsage();
+
+// The video memory as the driver reports it, in bytes.
+struct GpuMemoryInfo {
+    // 0 when the driver doesn't report it.
+    size_t m_dedicatedBytes;
+    size_t m_availableBytes;
+    // Moved out of the video memory to make room, since the context was created. 0 when the driver doesn't report it.
+    size_t m_evictedBytes;
+};
+
+// Queries GL_NVX_gpu_memory_info, or GL_ATI_meminfo's free texture memory. Returns std::nullopt when neither is
+// supported.
+std::optional<GpuMemoryInfo> QueryGpuMemoryInfo();
+
+} // namespace Glitter::Render
@@ -0,0 +1,105 @@
+#include "render/GpuProfiler.h"
+
+namespace Glitter::Render {
+
+namespace {
+    // Weight of the latest sample in the rolling averages.
+    constexpr double AVERAGE_WEIGHT = 0.05;
+} // namespace
+
+void GpuProfiler::Release()
+{
+    for (Frame& frame : m_frames) {
+        glDeleteQueries(static_cast<GLsizei>(frame.m_queries.size()), frame.m_queries.data());
+        frame = Frame {};
+    }
+    m_scopes.clear();
+    m_averages.clear();
+}
+
+void GpuProfiler::BeginFrame()
+{
+    m_currentFrame = (m_currentFrame + 1) % m_frames.size();
+    Frame& frame = m_frames[m_currentFrame];
+
+    ReadBack(frame);
+    frame.m_usedQueries = 0;
+    frame.m_scopes.clear();
+    frame.m_openScopes.clear();
+}
+
+void GpuProfiler::PushGroup(GLuint id, const char* name)
+{
+    glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, id, -1, name);
+    if constexpr (!Config::ENABLE_PROFILING) {
+        return;
+    }
+
+    Frame& frame = m_frames[m_currentFrame];
+    frame.m_openScopes.push_back(frame.m_scopes.size());
+    frame.m_scopes.push_back(PendingScope {.m_name = name,
+        .m_depth = static_cast<std::uint32_t>(frame.m_openScopes.size() - 1),
+        .m_beginQuery = IssueTimestamp(frame),
+        .m_endQuery = 0});
+}
+
+void GpuProfiler::PopGroup()
+{
+    if constexpr (Config::ENABLE_PROFILING) {
+        Frame& frame = m_frames[m_currentFrame];
+        frame.m_scopes[frame.m_openScopes.back()].m_endQuery = IssueTimestamp(frame);
+        frame.m_openScopes.pop_back();
+    }
+
+    glPopDebugGroup();
+}
+
+size_t GpuProfiler::IssueTimestamp(Frame& frame)
+{
+    if (frame.m_usedQueries == frame.m_queries.size()) {
+        GLuint query = 0;
+        glCreateQueries(GL_TIMESTAMP, 1, &query);
+        frame.m_queries.push_back(query);
+    }
+
+    size_t query = frame.m_usedQueries++;
+    glQueryCounter(frame.m_queries[query], GL_TIMESTAMP);
+    return query;
+}
+
+void GpuProfiler::ReadBack(Frame& frame)
+{
+    if (frame.m_scopes.empty()) {
+        return;
+    }
+
+    // The last query is the last one to complete, if it isn't available yet the frame is dropped rather than waited
+    // for.
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(frame.m_queries[frame.m_usedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE) {
+        return;
+    }
+
+    std::vector<GLuint64> timestamps(frame.m_usedQueries);
+    for (size_t query = 0; query < frame.m_usedQueries; query++) {
+        glGetQueryObjectui64v(frame.m_queries[query], GL_QUERY_RESULT, &timestamps[query]);
+    }
+
+    m_scopes.clear();
+    for (const PendingScope& pending : frame.m_scopes) {
+        double milliseconds = static_cast<double>(timestamps[pending.m_endQuery] - timestamps[pending.m_beginQuery]) / 1e6;
+
+        auto [average, inserted] = m_averages.try_emplace(pending.m_name, milliseconds);
+        if (!inserted) {
+            average->second += (milliseconds - average->second) * AVERAGE_WEIGHT;
+        }
+
+        m_scopes.push_back(Scope {.m_name = pending.m_name,
+            .m_depth = pending.m_depth,
+            .m_milliseconds = milliseconds,
+            .m_averageMilliseconds = average->second});
+    }
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Config.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Glitter::Render {
+
+// Times debug groups on the GPU with GL_TIMESTAMP queries. Each frame records into its own set of queries, which are
+// only read back Glitter::Config::FRAMES_IN_FLIGHT frames later, so reading the results never stalls on the GPU.
+class GpuProfiler {
+public:
+    struct Scope {
+        std::string m_name;
+        std::uint32_t m_depth;
+        double m_milliseconds;
+        double m_averageMilliseconds;
+    };
+
+    void Release();
+
+    // Reads back the results of the oldest frame, if the GPU is done with it, and starts recording a new one.
+    void BeginFrame();
+
+    // Pushes a debug group named `name` and records the GPU time spent until the matching PopGroup(), the latter only from
+    // Config::InstrumentationLevel::Full up.
+    void PushGroup(GLuint id, const char* name);
+    void PopGroup();
+
+    // The scopes of the latest frame read back, in the order they were pushed.
+    std::span<const Scope> GetScopes() const { return m_scopes; }
+
+private:
+    struct PendingScope {
+        const char* m_name;
+        std::uint32_t m_depth;
+        size_t m_beginQuery;
+        size_t m_endQuery;
+    };
+
+    struct Frame {
+        std::vector<GLuint> m_queries;
+        size_t m_usedQueries {};
+        std::vector<PendingScope> m_scopes;
+        std::vector<size_t> m_openScopes;
+    };
+
+    size_t IssueTimestamp(Frame& frame);
+    void ReadBack(Frame& frame);
+
+    std::array<Frame, Glitter::Config::FRAMES_IN_FLIGHT> m_frames {};
+    size_t m_currentFrame {};
+
+    std::vector<Scope> m_scopes;
+    // Exponential moving average of every scope, by name.
+    std::unordered_map<std::string, double> m_averages;
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,68 @@
+#include "render/HiZPyramid.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace Glitter::Render {
+
+void HiZPyramid::Create(RenderTargetPool& pool, GLsizei width, GLsizei height)
+{
+    Release(pool);
+
+    auto levels = static_cast<GLsizei>(std::bit_width(static_cast<unsigned>(std::max(width, height))));
+    m_target = pool.Acquire(GL_R32F, width, height, levels, "Hi-Z Pyramid");
+    glTextureParameteri(m_target.m_texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTextureParameteri(m_target.m_texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTextureParameteri(m_target.m_texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_target.m_texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    m_width = 0;
+    m_height = 0;
+}
+
+void HiZPyramid::Release(RenderTargetPool& pool) { pool.Release(m_target); }
+
+void HiZPyramid::Build(
+    RenderStats& stats, GLuint program, GLuint depthTexture, GLsizei width, GLsizei height, GpuProfiler& profiler)
+{
+    m_width = width;
+    m_height = height;
+
+    profiler.PushGroup(0, "Hi-Z Build");
+    {
+        stats.UseProgram(program);
+        stats.BindTextureUnit(0, depthTexture);
+
+        // Every level is built, down to 1x1 texels, whatever the viewport, since the culling picks them by the size of the
+        // rectangles it tests.
+        GLsizei sourceWidth = width;
+        GLsizei sourceHeight = height;
+        GLsizei levelWidth = width;
+        GLsizei levelHeight = height;
+        for (GLsizei level = 0; level < m_target.m_levels; level++) {
+            // uniform layout(location = 0) bool u_FromDepth;
+            // uniform layout(location = 1) ivec2 u_SourceSize;
+            // uniform layout(location = 2) ivec2 u_DestinationSize;
+            glUniform1i(0, level == 0 ? GL_TRUE : GL_FALSE);
+            glUniform2i(1, sourceWidth, sourceHeight);
+            glUniform2i(2, levelWidth, levelHeight);
+
+            if (level > 0) {
+                glBindImageTexture(0, m_target.m_texture, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+            }
+            glBindImageTexture(1, m_target.m_texture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+            glDispatchCompute(static_cast<GLuint>((levelWidth + 7) / 8), static_cast<GLuint>((levelHeight + 7) / 8), 1);
+            if (level + 1 < m_target.m_levels) {
+                glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+            }
+
+            sourceWidth = levelWidth;
+            sourceHeight = levelHeight;
+            levelWidth = std::max(levelWidth / 2, 1);
+            levelHeight = std::max(levelHeight / 2, 1);
+        }
+    }
+    profiler.PopGroup();
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "render/GpuProfiler.h"
+#include "render/RenderStats.h"
+#include "render/RenderTargetPool.h"
+
+#include <glad/glad.h>
+
+namespace Glitter::Render {
+
+// A hierarchical-Z pyramid: a R32F texture whose level 0 is a copy of a depth buffer, and where every texel of the
+// following levels holds the furthest depth of the 2x2 (or 3x3, for odd sizes) texels below it. Like the depth buffer,
+// it's only built over the viewport at its origin, whose texel at level L is the texel of the viewport's pixel >> L.
+class HiZPyramid {
+public:
+    // Allocates the pyramid of a depth target of `width` by `height`, from `pool`.
+    void Create(RenderTargetPool& pool, GLsizei width, GLsizei height);
+    void Release(RenderTargetPool& pool);
+
+    // Rebuilds every level from the `width` by `height` viewport of `depthTexture` with `program`, the HiZCS compute
+    // program, binding through `stats` and timed by `profiler`. The viewport must fit in the pyramid, which is written
+    // through image stores, so it needs a GL_TEXTURE_FETCH_BARRIER_BIT before it's sampled.
+    void Build(RenderStats& stats, GLuint program, GLuint depthTexture, GLsizei width, GLsizei height, GpuProfiler& profiler);
+
+    GLuint GetTexture() const { return m_target.m_texture; }
+    // The viewport of the last Build().
+    GLsizei GetWidth() const { return m_width; }
+    GLsizei GetHeight() const { return m_height; }
+    GLsizei GetLevels() const { return m_target.m_levels; }
+
+private:
+    RenderTarget m_target {};
+    GLsizei m_width {};
+    GLsizei m_height {};
+};
+
+} // namespace Glitter::Render
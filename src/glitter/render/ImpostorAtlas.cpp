@@ -0,0 +1,142 @@
+#include "render/ImpostorAtlas.h"
+
+#include "render/GpuMemory.h"
+
+#include "Config.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+
+namespace Glitter::Render {
+
+namespace {
+
+    constexpr GLsizei ATLAS_SIZE = Config::IMPOSTOR_FRAME_SIZE * static_cast<GLsizei>(Config::IMPOSTOR_GRID);
+    // Frames stop shrinking at 4 by 4 texels.
+    constexpr GLsizei ATLAS_LEVELS = std::bit_width(static_cast<std::uint32_t>(Config::IMPOSTOR_FRAME_SIZE / 4));
+
+    // Matches DecodeOctahedral() in MainVS.glsl.
+    glm::vec3 DecodeOctahedral(glm::vec2 encoded)
+    {
+        glm::vec3 normal {encoded, 1.0f - std::abs(encoded.x) - std::abs(encoded.y)};
+        if (normal.z < 0.0f) {
+            glm::vec2 signs {normal.x >= 0.0f ? 1.0f : -1.0f, normal.y >= 0.0f ? 1.0f : -1.0f};
+            normal = glm::vec3((1.0f - glm::abs(glm::vec2(normal.y, normal.x))) * signs, normal.z);
+        }
+        return glm::normalize(normal);
+    }
+
+} // namespace
+
+void ImpostorAtlas::Create(std::uint32_t layerCount)
+{
+    Release();
+    m_layerCount = layerCount;
+    auto layers = static_cast<GLsizei>(std::max(layerCount, 1u));
+
+    // Nearest-filtered, since neither the texture coordinates nor the normals blend across the Mesh's seams.
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_texture);
+    TextureStorage3D(GpuMemoryCategory::Texture, m_texture, ATLAS_LEVELS, GL_RGBA16F, ATLAS_SIZE, ATLAS_SIZE, layers);
+    glTextureParameteri(m_texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTextureParameteri(m_texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTextureParameteri(m_texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glObjectLabel(GL_TEXTURE, m_texture, -1, "Impostor Atlas");
+
+    // The bake's depth, sampled back as each texel's offset along the view.
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_depthTexture);
+    TextureStorage3D(
+        GpuMemoryCategory::Texture, m_depthTexture, 1, GL_DEPTH_COMPONENT32F, ATLAS_SIZE, ATLAS_SIZE, layers);
+    glTextureParameteri(m_depthTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(m_depthTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTextureParameteri(m_depthTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_depthTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glObjectLabel(GL_TEXTURE, m_depthTexture, -1, "Impostor Atlas Depth");
+
+    glCreateFramebuffers(1, &m_fbo);
+    glObjectLabel(GL_FRAMEBUFFER, m_fbo, -1, "Impostor Bake FBO");
+}
+
+void ImpostorAtlas::Release()
+{
+    glDeleteFramebuffers(1, &m_fbo);
+    DeleteTextures(1, &m_depthTexture);
+    DeleteTextures(1, &m_texture);
+    m_fbo = 0;
+    m_depthTexture = 0;
+    m_texture = 0;
+    m_layerCount = 0;
+    m_bakedCount = 0;
+}
+
+glm::vec3 ImpostorAtlas::GetFrameDirection(std::uint32_t x, std::uint32_t y)
+{
+    glm::vec2 cell = (glm::vec2(static_cast<float>(x), static_cast<float>(y)) + 0.5f) / static_cast<float>(Config::IMPOSTOR_GRID);
+    return DecodeOctahedral(cell * 2.0f - 1.0f);
+}
+
+std::optional<std::uint32_t> ImpostorAtlas::Bake(RenderStats& stats, GLuint program, const glm::mat4& dequantize,
+    const glm::vec3& center, float radius, const std::function<void()>& drawMesh)
+{
+    if (m_bakedCount >= m_layerCount) {
+        return std::nullopt;
+    }
+    std::uint32_t layer = m_bakedCount++;
+
+    glNamedFramebufferTextureLayer(m_fbo, GL_COLOR_ATTACHMENT0, m_texture, 0, static_cast<GLint>(layer));
+    glNamedFramebufferTextureLayer(m_fbo, GL_DEPTH_ATTACHMENT, m_depthTexture, 0, static_cast<GLint>(layer));
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    stats.DepthMask(GL_TRUE);
+    stats.DepthFunc(GL_LEQUAL);
+    std::array<GLfloat, 4> colorClear {0.0f, 0.0f, IMPOSTOR_UNCOVERED, IMPOSTOR_UNCOVERED};
+    GLfloat depthClear = 1.0f;
+    glClearNamedFramebufferfv(m_fbo, GL_COLOR, 0, colorClear.data());
+    glClearNamedFramebufferfv(m_fbo, GL_DEPTH, 0, &depthClear);
+
+    // The texels are written as they are, not blended over the clear.
+    glDisable(GL_BLEND);
+    stats.UseProgram(program);
+    // uniform layout(location = 1) mat4 u_Dequantize;
+    glUniformMatrix4fv(1, 1, GL_FALSE, glm::value_ptr(dequantize));
+
+    // Each frame looks at the bounding sphere from twice its radius, so that the depth range spans it exactly: the depth
+    // of a texel maps linearly from the near side of the sphere to the far side. Matches the quads of ImpostorVS.glsl.
+    radius = std::max(radius, 1e-4f);
+    glm::mat4 projection = glm::ortho(-radius, radius, -radius, radius, radius, 3.0f * radius);
+    for (std::uint32_t y = 0; y < Config::IMPOSTOR_GRID; y++) {
+        for (std::uint32_t x = 0; x < Config::IMPOSTOR_GRID; x++) {
+            glm::vec3 direction = GetFrameDirection(x, y);
+            glm::vec3 up = std::abs(direction.y) > 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+            glm::mat4 viewProjection = projection * glm::lookAt(center + direction * 2.0f * radius, center, up);
+
+            // uniform layout(location = 0) mat4 u_ViewProjection;
+            glUniformMatrix4fv(0, 1, GL_FALSE, glm::value_ptr(viewProjection));
+            glViewport(static_cast<GLint>(x) * Config::IMPOSTOR_FRAME_SIZE, static_cast<GLint>(y) * Config::IMPOSTOR_FRAME_SIZE,
+                Config::IMPOSTOR_FRAME_SIZE, Config::IMPOSTOR_FRAME_SIZE);
+            drawMesh();
+        }
+    }
+
+    glEnable(GL_BLEND);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return layer;
+}
+
+MipChain ImpostorAtlas::GetMipChain(std::uint32_t firstLayer, std::uint32_t layerCount) const
+{
+    return MipChain {
+        .m_texture = m_texture,
+        .m_target = GL_TEXTURE_2D_ARRAY,
+        .m_format = MipFormat::Rgba16F,
+        .m_filter = MipFilter::Linear,
+        .m_width = ATLAS_SIZE,
+        .m_height = ATLAS_SIZE,
+        .m_levels = ATLAS_LEVELS,
+        .m_firstLayer = static_cast<GLint>(firstLayer),
+        .m_layerCount = static_cast<GLsizei>(layerCount),
+    };
+}
+
+} // namespace Glitter::Render
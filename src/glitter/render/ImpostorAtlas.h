@@ -0,0 +1,56 @@
+#pragma once
+
+#include "render/MipGenerator.h"
+#include "render/RenderStats.h"
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+namespace Glitter::Render {
+
+// Octahedral impostors of the Meshes, each baked into a layer of a texture array as a Config::IMPOSTOR_GRID by
+// Config::IMPOSTOR_GRID grid of orthographic views of its bounding sphere. The views look at it from the directions the
+// octahedral mapping puts at the center of each cell, so the frame nearest to any direction is the cell it maps into.
+//
+// Each texel holds the texture coordinates and the octahedral-encoded Mesh space normal of the surface it covers, and the
+// depth layer its offset along the view, so that the impostor is shaded and lit like the Mesh itself. The texels the Mesh
+// doesn't cover hold a normal outside of the octahedron instead, see IMPOSTOR_UNCOVERED.
+class ImpostorAtlas {
+public:
+    // The encoded normal of the texels the Mesh doesn't cover, anything above 1 in either component.
+    static constexpr float IMPOSTOR_UNCOVERED = 2.0f;
+
+    // Room for `layerCount` Meshes.
+    void Create(std::uint32_t layerCount);
+    void Release();
+
+    // Bakes the next layer with `program`, returning it, or std::nullopt once every layer is taken. `drawMesh` draws the
+    // Mesh once per frame, with the frame's View-Projection set at location 0 and `dequantize` at location 1. The Mesh's
+    // bounding sphere in Mesh space is `center` and `radius`. Only level 0 is baked, the mips of the layers baked in a row
+    // are left to a MipGenerator, see GetMipChain().
+    std::optional<std::uint32_t> Bake(RenderStats& stats, GLuint program, const glm::mat4& dequantize, const glm::vec3& center,
+        float radius, const std::function<void()>& drawMesh);
+    // The mips of the `layerCount` layers from `firstLayer`, averaged as they are.
+    MipChain GetMipChain(std::uint32_t firstLayer, std::uint32_t layerCount) const;
+
+    // The direction from the Mesh towards the eye of frame (`x`, `y`), in Mesh space.
+    static glm::vec3 GetFrameDirection(std::uint32_t x, std::uint32_t y);
+
+    GLuint GetTexture() const { return m_texture; }
+    GLuint GetDepthTexture() const { return m_depthTexture; }
+    std::uint32_t GetBakedCount() const { return m_bakedCount; }
+    std::uint32_t GetLayerCount() const { return m_layerCount; }
+
+private:
+    std::uint32_t m_layerCount {};
+    std::uint32_t m_bakedCount {};
+
+    GLuint m_texture {};
+    GLuint m_depthTexture {};
+    GLuint m_fbo {};
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,182 @@
+#include "render/LightClusters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Glitter::Render {
+
+namespace {
+
+    constexpr std::uint32_t CLUSTER_COUNT
+        = Glitter::Config::LIGHT_CLUSTER_X * Glitter::Config::LIGHT_CLUSTER_Y * Glitter::Config::LIGHT_CLUSTER_Z;
+
+    // Matches the `LightGrid` header in MainFS.glsl, followed by the offset and count of each cluster's light list.
+    struct LightGridHeader {
+        // x, y: clusters per pixel of the viewport; z, w: scale and bias from the log of the view depth to the slice.
+        glm::vec4 m_scale;
+        glm::uvec4 m_count;
+    };
+
+    // The cluster of `ndc` out of `count` along an axis, clamped to the grid.
+    std::uint32_t GetTile(float ndc, std::uint32_t count)
+    {
+        auto tile = static_cast<std::int64_t>(std::floor((ndc * 0.5f + 0.5f) * static_cast<float>(count)));
+        return static_cast<std::uint32_t>(std::clamp<std::int64_t>(tile, 0, count - 1));
+    }
+
+} // namespace
+
+void LightClusters::Create(size_t alignment)
+{
+    m_alignment = alignment;
+
+    // Sized for a light per cluster, grown on demand in Build().
+    size_t regionSize = AlignOffset(sizeof(PointLight) * Glitter::Config::POINT_LIGHT_COUNT)
+        + AlignOffset(sizeof(LightGridHeader) + sizeof(glm::uvec2) * CLUSTER_COUNT) + sizeof(std::uint32_t) * CLUSTER_COUNT;
+    m_stream.Create(regionSize, alignment, "Light Cluster SSBO Ring");
+}
+
+void LightClusters::Release() { m_stream.Release(); }
+
+void LightClusters::Build(std::span<const PointLight> lights, const glm::mat4& view, const glm::mat4& projection,
+    float nearPlane, float farPlane, GLsizei width, GLsizei height)
+{
+    using Glitter::Config::LIGHT_CLUSTER_X;
+    using Glitter::Config::LIGHT_CLUSTER_Y;
+    using Glitter::Config::LIGHT_CLUSTER_Z;
+
+    float sliceScale = static_cast<float>(LIGHT_CLUSTER_Z) / std::log(farPlane / nearPlane);
+    float sliceBias = -std::log(nearPlane) * sliceScale;
+    auto getSlice = [&](float depth) {
+        auto slice = static_cast<std::int64_t>(std::floor(std::log(depth) * sliceScale + sliceBias));
+        return static_cast<std::uint32_t>(std::clamp<std::int64_t>(slice, 0, LIGHT_CLUSTER_Z - 1));
+    };
+
+    // Find the clusters each light overlaps, from the view-space box around its sphere.
+    m_bounds.clear();
+    for (size_t lightIdx = 0; lightIdx < lights.size(); lightIdx++) {
+        glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(lights[lightIdx].m_positionRadius), 1.0f));
+        float radius = lights[lightIdx].m_positionRadius.w;
+        float minDepth = -center.z - radius;
+        float maxDepth = -center.z + radius;
+        if (maxDepth <= nearPlane || minDepth >= farPlane) {
+            continue;
+        }
+
+        LightBounds bounds {
+            .m_light = static_cast<std::uint32_t>(lightIdx),
+            .m_minX = 0,
+            .m_maxX = LIGHT_CLUSTER_X - 1,
+            .m_minY = 0,
+            .m_maxY = LIGHT_CLUSTER_Y - 1,
+            .m_minZ = getSlice(std::max(minDepth, nearPlane)),
+            .m_maxZ = getSlice(std::min(maxDepth, farPlane)),
+        };
+
+        // A box crossing the near plane projects over the whole viewport, as far as it's concerned.
+        if (minDepth > nearPlane) {
+            glm::vec2 ndcMin(std::numeric_limits<float>::max());
+            glm::vec2 ndcMax(std::numeric_limits<float>::lowest());
+            for (std::uint32_t corner = 0; corner < 8; corner++) {
+                glm::vec3 offset((corner & 1) != 0 ? radius : -radius, (corner & 2) != 0 ? radius : -radius,
+                    (corner & 4) != 0 ? radius : -radius);
+                glm::vec4 clip = projection * glm::vec4(center + offset, 1.0f);
+                glm::vec2 ndc = glm::vec2(clip) / clip.w;
+                ndcMin = glm::min(ndcMin, ndc);
+                ndcMax = glm::max(ndcMax, ndc);
+            }
+            if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f) {
+                continue;
+            }
+            bounds.m_minX = GetTile(ndcMin.x, LIGHT_CLUSTER_X);
+            bounds.m_maxX = GetTile(ndcMax.x, LIGHT_CLUSTER_X);
+            bounds.m_minY = GetTile(ndcMin.y, LIGHT_CLUSTER_Y);
+            bounds.m_maxY = GetTile(ndcMax.y, LIGHT_CLUSTER_Y);
+        }
+        m_bounds.push_back(bounds);
+    }
+
+    auto forEachCluster = [](const LightBounds& bounds, auto&& function) {
+        for (std::uint32_t z = bounds.m_minZ; z <= bounds.m_maxZ; z++) {
+            for (std::uint32_t y = bounds.m_minY; y <= bounds.m_maxY; y++) {
+                for (std::uint32_t x = bounds.m_minX; x <= bounds.m_maxX; x++) {
+                    function((z * LIGHT_CLUSTER_Y + y) * LIGHT_CLUSTER_X + x);
+                }
+            }
+        }
+    };
+
+    // Count the lights of each cluster, and turn the counts into the offsets of their lists.
+    m_clusterOffsets.assign(CLUSTER_COUNT + 1, 0);
+    for (const LightBounds& bounds : m_bounds) {
+        forEachCluster(bounds, [&](std::uint32_t cluster) { m_clusterOffsets[cluster + 1]++; });
+    }
+    for (size_t cluster = 0; cluster < CLUSTER_COUNT; cluster++) {
+        m_clusterOffsets[cluster + 1] += m_clusterOffsets[cluster];
+    }
+    size_t indexCount = m_clusterOffsets[CLUSTER_COUNT];
+
+    // Lay out the region, growing the ring if it can't hold this frame's lists. None of the ranges can be empty.
+    m_lightsOffset = 0;
+    m_lightsSize = sizeof(PointLight) * std::max<size_t>(m_bounds.size(), 1);
+    m_gridOffset = AlignOffset(m_lightsOffset + m_lightsSize);
+    m_gridSize = sizeof(LightGridHeader) + sizeof(glm::uvec2) * CLUSTER_COUNT;
+    m_indicesOffset = AlignOffset(m_gridOffset + m_gridSize);
+    m_indicesSize = sizeof(std::uint32_t) * std::max<size_t>(indexCount, 1);
+    size_t regionSize = m_indicesOffset + m_indicesSize;
+
+    std::span<std::byte> region = m_stream.BeginFrame();
+    if (regionSize > region.size()) {
+        region = m_stream.Grow(std::max(regionSize, m_stream.GetRegionSize() * 2));
+        spdlog::info("Grew the light cluster SSBO ring regions to {} bytes.", m_stream.GetRegionSize());
+    }
+
+    // Write the visible lights, which the lists index into, and each cluster's list before filling them in.
+    auto* regionLights = reinterpret_cast<PointLight*>(region.data() + m_lightsOffset);
+    for (size_t idx = 0; idx < m_bounds.size(); idx++) {
+        regionLights[idx] = lights[m_bounds[idx].m_light];
+    }
+
+    LightGridHeader header {
+        .m_scale = glm::vec4(static_cast<float>(LIGHT_CLUSTER_X) / static_cast<float>(width),
+            static_cast<float>(LIGHT_CLUSTER_Y) / static_cast<float>(height), sliceScale, sliceBias),
+        .m_count = glm::uvec4(LIGHT_CLUSTER_X, LIGHT_CLUSTER_Y, LIGHT_CLUSTER_Z, 0),
+    };
+    std::memcpy(region.data() + m_gridOffset, &header, sizeof(header));
+    auto* regionClusters = reinterpret_cast<glm::uvec2*>(region.data() + m_gridOffset + sizeof(header));
+
+    m_stats = {
+        .m_lights = lights.size(),
+        .m_visibleLights = m_bounds.size(),
+        .m_lightIndices = indexCount,
+        .m_maxClusterLights = 0,
+    };
+    for (size_t cluster = 0; cluster < CLUSTER_COUNT; cluster++) {
+        std::uint32_t count = m_clusterOffsets[cluster + 1] - m_clusterOffsets[cluster];
+        regionClusters[cluster] = glm::uvec2(m_clusterOffsets[cluster], count);
+        m_stats.m_maxClusterLights = std::max<size_t>(m_stats.m_maxClusterLights, count);
+    }
+
+    // Fill in the lists, each offset ending up at the next one's start.
+    m_lightIndices.resize(indexCount);
+    for (size_t idx = 0; idx < m_bounds.size(); idx++) {
+        forEachCluster(m_bounds[idx],
+            [&](std::uint32_t cluster) { m_lightIndices[m_clusterOffsets[cluster]++] = static_cast<std::uint32_t>(idx); });
+    }
+    std::memcpy(region.data() + m_indicesOffset, m_lightIndices.data(), sizeof(std::uint32_t) * indexCount);
+}
+
+void LightClusters::Bind(RenderStats& stats) const
+{
+    auto regionOffset = static_cast<GLintptr>(m_stream.GetRegionOffset());
+    stats.BindBufferRange(GL_SHADER_STORAGE_BUFFER, 3, m_stream.GetBuffer(), regionOffset + static_cast<GLintptr>(m_lightsOffset),
+        static_cast<GLsizeiptr>(m_lightsSize));
+    stats.BindBufferRange(GL_SHADER_STORAGE_BUFFER, 4, m_stream.GetBuffer(), regionOffset + static_cast<GLintptr>(m_gridOffset),
+        static_cast<GLsizeiptr>(m_gridSize));
+    stats.BindBufferRange(GL_SHADER_STORAGE_BUFFER, 5, m_stream.GetBuffer(),
+        regionOffset + static_cast<GLintptr>(m_indicesOffset), static_cast<GLsizeiptr>(m_indicesSize));
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "render/RenderStats.h"
+#include "render/StreamBuffer.h"
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Glitter::Render {
+
+// Matches `PointLight` in MainFS.glsl.
+struct PointLight {
+    // World-space position, and the distance at which the light fades out.
+    glm::vec4 m_positionRadius;
+    glm::vec4 m_color;
+};
+
+struct LightClusterStats {
+    // Lights overlapping the view frustum, out of every light binned.
+    size_t m_lights;
+    size_t m_visibleLights;
+    // Entries of every cluster's light list, and of the longest one.
+    size_t m_lightIndices;
+    size_t m_maxClusterLights;
+};
+
+// Bins point lights into a grid of clusters over the view frustum, Glitter::Config::LIGHT_CLUSTER_X by LIGHT_CLUSTER_Y
+// tiles of the viewport and LIGHT_CLUSTER_Z slices of depth, exponentially spaced from the near to the far plane so that
+// the clusters stay roughly cubic. Each cluster lists the lights whose sphere overlaps its bounds, so that a fragment only
+// iterates over the lights of its cluster and their cost scales with how many of them are around, not with their total.
+//
+// The grid is built on the CPU every frame, straight into this frame's region of a persistently-mapped SSBO ring. Each
+// light is binned into the clusters of its bounds' projection, which is conservative: a light can be listed in clusters
+// near the corners of its bounds that its sphere doesn't reach.
+class LightClusters {
+public:
+    // `alignment` is GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT.
+    void Create(size_t alignment);
+    void Release();
+
+    // Bins the world-space `lights` for the frustum of `view` and `projection`, rendered into a `width` by `height`
+    // viewport.
+    void Build(std::span<const PointLight> lights, const glm::mat4& view, const glm::mat4& projection, float nearPlane,
+        float farPlane, GLsizei width, GLsizei height);
+    // Fences this frame's region, once every draw reading it has been issued.
+    void EndFrame() { m_stream.EndFrame(); }
+
+    // Binds this frame's lights, grid and cluster light lists into the SSBO slots 3, 4 and 5.
+    void Bind(RenderStats& stats) const;
+
+    // Of the latest Build().
+    const LightClusterStats& GetStats() const { return m_stats; }
+
+private:
+    // The clusters a light overlaps, bounds included.
+    struct LightBounds {
+        std::uint32_t m_light;
+        std::uint32_t m_minX, m_maxX;
+        std::uint32_t m_minY, m_maxY;
+        std::uint32_t m_minZ, m_maxZ;
+    };
+
+    size_t AlignOffset(size_t offset) const { return (offset + m_alignment - 1) / m_alignment * m_alignment; }
+
+    StreamBuffer m_stream;
+    size_t m_alignment {1};
+
+    // The offsets and sizes of this frame's lights, grid and light lists in the current region.
+    size_t m_lightsOffset {};
+    size_t m_lightsSize {};
+    size_t m_gridOffset {};
+    size_t m_gridSize {};
+    size_t m_indicesOffset {};
+    size_t m_indicesSize {};
+
+    // Kept between frames, so that they only allocate when the lights outgrow them.
+    std::vector<LightBounds> m_bounds;
+    std::vector<std::uint32_t> m_clusterOffsets;
+    // Scattered into before being copied into the region at once, which is write-combined.
+    std::vector<std::uint32_t> m_lightIndices;
+
+    LightClusterStats m_stats {};
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,175 @@
+#include "render/MeshStreamer.h"
+
+#include "Config.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace Glitter::Render {
+
+void MeshStreamer::Create(size_t budget)
+{
+    Release();
+    m_budget = budget;
+}
+
+void MeshStreamer::Release()
+{
+    // The pool's ranges go along with the pool.
+    m_primitives.clear();
+    m_pendingFrees.clear();
+    m_residentSize = 0;
+    m_frame = 0;
+}
+
+std::uint32_t MeshStreamer::Add(GeometryPool& pool, std::uint32_t page, GLint baseVertex, std::vector<StreamedMeshLevel> levels)
+{
+    m_indexSize = pool.GetIndexType() == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+
+    auto slot = static_cast<std::uint32_t>(m_primitives.size());
+    StreamedPrimitive& primitive = m_primitives.emplace_back();
+    primitive.m_page = page;
+    primitive.m_baseVertex = baseVertex;
+    primitive.m_levels = std::move(levels);
+    primitive.m_ranges.resize(primitive.m_levels.size());
+    if (primitive.m_levels.empty()) {
+        return slot;
+    }
+
+    // The coarsest level is outside of the budget, it's never freed.
+    auto coarsest = static_cast<std::uint32_t>(primitive.m_levels.size() - 1);
+    AddLevel(primitive, coarsest, pool);
+    m_residentSize -= GetLevelSize(primitive, coarsest);
+    primitive.m_wantedLevel = coarsest;
+    return slot;
+}
+
+void MeshStreamer::Request(std::uint32_t slot, std::uint32_t resolution)
+{
+    StreamedPrimitive& primitive = m_primitives[slot];
+    std::uint32_t level = 0;
+    while (level + 1 < primitive.m_levels.size() && primitive.m_levels[level + 1].m_resolution >= resolution) {
+        level++;
+    }
+    primitive.m_requestedLevel = std::min(primitive.m_requestedLevel, level);
+}
+
+bool MeshStreamer::Update(GeometryPool& pool)
+{
+    m_frame++;
+
+    // The frames still in flight may draw the freed levels.
+    std::erase_if(m_pendingFrees, [&](const PendingFree& pending) {
+        if (pending.m_frame + Config::FRAMES_IN_FLIGHT > m_frame) {
+            return false;
+        }
+        pool.FreeIndices(pending.m_range);
+        return true;
+    });
+
+    for (StreamedPrimitive& primitive : m_primitives) {
+        if (primitive.m_requestedLevel == UINT32_MAX) {
+            continue;
+        }
+        primitive.m_wantedLevel = primitive.m_requestedLevel;
+        primitive.m_lastRequestFrame = m_frame;
+        primitive.m_requestedLevel = UINT32_MAX;
+    }
+
+    bool changed = false;
+    size_t addedSize = 0;
+    for (size_t slot = 0; slot < m_primitives.size() && addedSize < Config::MESH_STREAMING_UPLOAD_BUDGET; slot++) {
+        StreamedPrimitive& primitive = m_primitives[slot];
+        if (primitive.m_levels.empty() || primitive.m_residentLevel <= primitive.m_wantedLevel) {
+            continue;
+        }
+
+        std::uint32_t level = primitive.m_residentLevel - 1;
+        size_t levelSize = GetLevelSize(primitive, level);
+        bool fits = m_residentSize + levelSize <= m_budget;
+        while (!fits && EvictForRoom(slot)) {
+            fits = m_residentSize + levelSize <= m_budget;
+            changed = true;
+        }
+        if (!fits) {
+            continue;
+        }
+
+        AddLevel(primitive, level, pool);
+        addedSize += levelSize;
+        changed = true;
+    }
+    return changed;
+}
+
+std::span<const ResidentMeshLevel> MeshStreamer::GetResidentLevels(std::uint32_t slot) const
+{
+    const StreamedPrimitive& primitive = m_primitives[slot];
+    return std::span(primitive.m_ranges).subspan(std::min<size_t>(primitive.m_residentLevel, primitive.m_ranges.size()));
+}
+
+size_t MeshStreamer::GetLevelSize(const StreamedPrimitive& primitive, std::uint32_t level) const
+{
+    return m_indexSize * primitive.m_levels[level].m_indices.size();
+}
+
+void MeshStreamer::AddLevel(StreamedPrimitive& primitive, std::uint32_t level, GeometryPool& pool)
+{
+    GeometryRange range = pool.AddIndices(primitive.m_page, primitive.m_baseVertex, primitive.m_levels[level].m_indices);
+    primitive.m_ranges[level] = ResidentMeshLevel {
+        .m_firstIndex = range.m_firstIndex,
+        .m_indexCount = range.m_indexCount,
+        .m_resolution = primitive.m_levels[level].m_resolution,
+    };
+    primitive.m_residentLevel = level;
+    m_residentSize += GetLevelSize(primitive, level);
+}
+
+void MeshStreamer::EvictLevel(StreamedPrimitive& primitive)
+{
+    std::uint32_t level = primitive.m_residentLevel;
+    const ResidentMeshLevel& resident = primitive.m_ranges[level];
+    m_pendingFrees.push_back(PendingFree {
+        .m_range = {.m_baseVertex = primitive.m_baseVertex,
+            .m_firstIndex = resident.m_firstIndex,
+            .m_indexCount = resident.m_indexCount,
+            .m_page = primitive.m_page},
+        .m_frame = m_frame,
+    });
+    primitive.m_ranges[level] = {};
+    primitive.m_residentLevel++;
+    m_residentSize -= GetLevelSize(primitive, level);
+}
+
+bool MeshStreamer::EvictForRoom(size_t keep)
+{
+    size_t best = m_primitives.size();
+    auto bestKey = std::make_pair(true, std::numeric_limits<std::uint64_t>::max());
+    for (size_t slot = 0; slot < m_primitives.size(); slot++) {
+        const StreamedPrimitive& primitive = m_primitives[slot];
+        if (slot == keep || primitive.m_residentLevel + 1 >= primitive.m_levels.size()) {
+            continue;
+        }
+
+        bool surplus = primitive.m_residentLevel < primitive.m_wantedLevel;
+        if (!surplus && primitive.m_lastRequestFrame == m_frame) {
+            continue;
+        }
+
+        auto key = std::make_pair(!surplus, primitive.m_lastRequestFrame);
+        if (key < bestKey) {
+            best = slot;
+            bestKey = key;
+        }
+    }
+
+    if (best == m_primitives.size()) {
+        return false;
+    }
+
+    EvictLevel(m_primitives[best]);
+    return true;
+}
+
+} // namespace Glitter::Render
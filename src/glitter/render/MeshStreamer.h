@@ -0,0 +1,97 @@
+#pragma once
+
+#include "render/GeometryPool.h"
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Glitter::Render {
+
+// An index list of a streamed primitive, over the vertices the primitive was added with.
+struct StreamedMeshLevel {
+    // Cells along the longest axis of the grid the level was clustered on, MESH_FULL_RESOLUTION for the primitive's own
+    // index list.
+    std::uint32_t m_resolution;
+    std::vector<std::uint32_t> m_indices;
+};
+
+constexpr std::uint32_t MESH_FULL_RESOLUTION = UINT32_MAX;
+
+// Where a resident level of a streamed primitive lives in the geometry pool.
+struct ResidentMeshLevel {
+    GLuint m_firstIndex;
+    GLsizei m_indexCount;
+    std::uint32_t m_resolution;
+};
+
+// Keeps the index lists of the Mesh LODs resident according to how large the Nodes drawing them are. Every primitive
+// starts out with only its coarsest level in the geometry pool, finer ones are added from the CPU copy as Nodes drawing
+// it come close enough, and the least recently requested levels are freed to stay within the budget. The vertices are
+// shared by every level, and so stay resident.
+//
+// Levels are streamed in and out one at a time from the finest resident one, so the resident levels of a primitive are
+// always its coarsest ones. Freed index ranges are only returned to the pool once the frames that may still draw them are
+// done.
+class MeshStreamer {
+public:
+    void Create(size_t budget);
+    void Release();
+
+    // Streams the levels of a primitive whose vertices were added to `pool` at `baseVertex` of `page`, from the finest to
+    // the coarsest, and adds its coarsest level right away. Returns its slot.
+    std::uint32_t Add(GeometryPool& pool, std::uint32_t page, GLint baseVertex, std::vector<StreamedMeshLevel> levels);
+
+    // Requests the coarsest level of `slot` clustered on at least `resolution` cells, or its finest one if none is. The
+    // finest request of a frame wins, and primitives keep their last request until they're requested again.
+    void Request(std::uint32_t slot, std::uint32_t resolution);
+
+    // Adds the levels requested this frame into `pool`, up to Config::MESH_STREAMING_UPLOAD_BUDGET bytes and one level
+    // per primitive, freeing others to make room for them. Returns true if the resident levels of any primitive changed.
+    bool Update(GeometryPool& pool);
+
+    // The resident levels of `slot`, from the finest to the coarsest.
+    std::span<const ResidentMeshLevel> GetResidentLevels(std::uint32_t slot) const;
+
+    size_t GetResidentSize() const { return m_residentSize; }
+    size_t GetBudget() const { return m_budget; }
+
+private:
+    struct StreamedPrimitive {
+        std::uint32_t m_page {};
+        GLint m_baseVertex {};
+        std::vector<StreamedMeshLevel> m_levels;
+        std::vector<ResidentMeshLevel> m_ranges;
+
+        // Levels [m_residentLevel, m_levels.size()) are resident, and the last one stays so.
+        std::uint32_t m_residentLevel {};
+        std::uint32_t m_wantedLevel {};
+        std::uint32_t m_requestedLevel {UINT32_MAX};
+        std::uint64_t m_lastRequestFrame {};
+    };
+
+    struct PendingFree {
+        GeometryRange m_range;
+        std::uint64_t m_frame;
+    };
+
+    size_t GetLevelSize(const StreamedPrimitive& primitive, std::uint32_t level) const;
+    void AddLevel(StreamedPrimitive& primitive, std::uint32_t level, GeometryPool& pool);
+    void EvictLevel(StreamedPrimitive& primitive);
+    // Frees the finest level of another primitive than `keep`: one resident finer than it was last requested at if
+    // there's one, or else the least recently requested one not drawn this frame. Returns false if there's none.
+    bool EvictForRoom(size_t keep);
+
+    std::vector<StreamedPrimitive> m_primitives;
+    std::vector<PendingFree> m_pendingFrees;
+    size_t m_indexSize {sizeof(std::uint32_t)};
+
+    size_t m_budget {};
+    size_t m_residentSize {};
+    std::uint64_t m_frame {};
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,185 @@
+#include "render/MipGenerator.h"
+
+#include "render/GpuMemory.h"
+
+#include "Config.h"
+
+#include <algorithm>
+
+namespace Glitter::Render {
+
+namespace {
+
+    // Matches MipCS.glsl.
+    constexpr GLsizei TILE_LEVELS = 6;
+    constexpr GLsizei TILE_SIZE = 64;
+
+    GLenum GetInternalFormat(MipFormat format) { return format == MipFormat::Rgba16F ? GL_RGBA16F : GL_RGBA8; }
+
+    // Twice TILE_LEVELS where the driver has an image unit for the source and each of them, once otherwise.
+    GLsizei GetLevelsPerDispatch()
+    {
+        GLint imageUnits = 0;
+        GLint computeImages = 0;
+        glGetIntegerv(GL_MAX_IMAGE_UNITS, &imageUnits);
+        glGetIntegerv(GL_MAX_COMPUTE_IMAGE_UNIFORMS, &computeImages);
+        return std::min(imageUnits, computeImages) > TILE_LEVELS * 2 ? TILE_LEVELS * 2 : TILE_LEVELS;
+    }
+
+} // namespace
+
+std::optional<MipFormat> GetMipFormat(GLenum internalFormat)
+{
+    switch (internalFormat) {
+    case GL_RGBA8:
+        return MipFormat::Rgba8;
+    case GL_RGBA16F:
+        return MipFormat::Rgba16F;
+    default:
+        return std::nullopt;
+    }
+}
+
+std::string MipGenerator::GetProgramDefines(MipFormat format)
+{
+    std::string defines {};
+    if (format == MipFormat::Rgba16F) {
+        defines += "#define GLITTER_MIP_RGBA16F\n";
+    }
+    if (GetLevelsPerDispatch() > TILE_LEVELS) {
+        defines += "#define GLITTER_MIP_HANDOVER\n";
+    }
+    return defines;
+}
+
+void MipGenerator::Create()
+{
+    Release();
+    m_levelsPerDispatch = GetLevelsPerDispatch();
+    ReserveCounters(1);
+}
+
+void MipGenerator::Release()
+{
+    DeleteBuffers(1, &m_counterBuffer);
+    m_counterBuffer = 0;
+    m_counterCapacity = 0;
+    m_queue.clear();
+}
+
+void MipGenerator::Queue(const MipChain& chain)
+{
+    if (chain.m_levels <= 1) {
+        return;
+    }
+    if (!Config::ENABLE_COMPUTE_MIPS) {
+        glGenerateTextureMipmap(chain.m_texture);
+        return;
+    }
+    m_queue.push_back(chain);
+}
+
+void MipGenerator::Flush(RenderStats& stats, const std::array<GLuint, MIP_FORMAT_COUNT>& programs)
+{
+    if (m_queue.empty()) {
+        return;
+    }
+
+    size_t generated = std::erase_if(m_queue, [&](const MipChain& chain) {
+        GLuint program = programs[static_cast<size_t>(chain.m_format)];
+        if (program == 0) {
+            return false;
+        }
+        Generate(stats, program, chain);
+        return true;
+    });
+    if (generated > 0) {
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    }
+}
+
+void MipGenerator::Generate(RenderStats& stats, GLuint program, const MipChain& chain)
+{
+    if (chain.m_levels <= 1 || chain.m_layerCount <= 0) {
+        return;
+    }
+
+    // The program binds every level as an image2DArray, which a 2D texture can only be bound as through a view.
+    GLenum internalFormat = GetInternalFormat(chain.m_format);
+    GLuint texture = chain.m_texture;
+    GLuint view = 0;
+    if (chain.m_target == GL_TEXTURE_2D) {
+        glGenTextures(1, &view);
+        glTextureView(view, GL_TEXTURE_2D_ARRAY, chain.m_texture, internalFormat, 0, static_cast<GLuint>(chain.m_levels), 0, 1);
+        texture = view;
+    }
+
+    if (ReserveCounters(chain.m_layerCount)) {
+        // The previous buffer was unbound along with its deletion.
+        stats.InvalidateState();
+    }
+    stats.UseProgram(program);
+    stats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_counterBuffer);
+    // uniform layout(location = 2) int u_FirstLayer;
+    // uniform layout(location = 3) bool u_Srgb;
+    glUniform1i(2, chain.m_firstLayer);
+    glUniform1i(3, chain.m_filter == MipFilter::Srgb ? GL_TRUE : GL_FALSE);
+
+    GLsizei sourceLevel = 0;
+    while (sourceLevel + 1 < chain.m_levels) {
+        GLsizei width = std::max(chain.m_width >> sourceLevel, 1);
+        GLsizei height = std::max(chain.m_height >> sourceLevel, 1);
+        GLsizei levelCount = std::min(chain.m_levels - 1 - sourceLevel, TILE_LEVELS);
+        if (m_levelsPerDispatch > TILE_LEVELS && std::max(width, height) >> TILE_LEVELS <= TILE_SIZE) {
+            levelCount = std::min(chain.m_levels - 1 - sourceLevel, m_levelsPerDispatch);
+        }
+
+        for (GLsizei level = 0; level <= levelCount; level++) {
+            glBindImageTexture(
+                static_cast<GLuint>(level), texture, sourceLevel + level, GL_TRUE, 0, GL_READ_WRITE, internalFormat);
+        }
+        // uniform layout(location = 0) ivec2 u_SourceSize;
+        // uniform layout(location = 1) int u_LevelCount;
+        glUniform2i(0, width, height);
+        glUniform1i(1, levelCount);
+        glDispatchCompute(static_cast<GLuint>((width + TILE_SIZE - 1) / TILE_SIZE),
+            static_cast<GLuint>((height + TILE_SIZE - 1) / TILE_SIZE), static_cast<GLuint>(chain.m_layerCount));
+
+        sourceLevel += levelCount;
+        if (sourceLevel + 1 < chain.m_levels) {
+            glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        }
+    }
+
+    // The dispatches keep the view alive until they're done with it.
+    glDeleteTextures(1, &view);
+}
+
+void MipGenerator::AddPass(RenderGraph& graph, RenderStats& stats, GLuint program, RenderResource texture, const MipChain& chain)
+{
+    RenderPassBuilder pass = graph.AddPass("Generate Mips", [=, this, &stats](const RenderGraph& run) {
+        MipChain resolved = chain;
+        resolved.m_texture = run.Get(texture);
+        Generate(stats, program, resolved);
+    });
+    pass.Read(texture, RenderAccess::ImageLoadStore).Write(texture, RenderAccess::ImageLoadStore);
+}
+
+bool MipGenerator::ReserveCounters(GLsizei layerCount)
+{
+    if (layerCount <= m_counterCapacity) {
+        return false;
+    }
+
+    // Zeroed once, the last workgroup of each layer resets its counter for the next dispatch.
+    DeleteBuffers(1, &m_counterBuffer);
+    m_counterCapacity = std::max(layerCount, m_counterCapacity * 2);
+    std::vector<GLuint> counters(static_cast<size_t>(m_counterCapacity), 0);
+    glCreateBuffers(1, &m_counterBuffer);
+    NamedBufferStorage(GpuMemoryCategory::Buffer, m_counterBuffer, static_cast<GLsizeiptr>(sizeof(GLuint) * counters.size()),
+        counters.data(), 0);
+    glObjectLabel(GL_BUFFER, m_counterBuffer, -1, "Mip Counter SSBO");
+    return true;
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "render/RenderGraph.h"
+#include "render/RenderStats.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Glitter::Render {
+
+// The formats MipGenerator has a MipCS program for.
+enum class MipFormat : std::uint8_t {
+    Rgba8,
+    Rgba16F,
+};
+constexpr size_t MIP_FORMAT_COUNT = 2;
+
+enum class MipFilter : std::uint8_t {
+    // Averages the texels as they are.
+    Linear,
+    // Averages the color of sRGB-encoded texels in linear space, like sampling a GL_SRGB8_ALPHA8 texture would, for the
+    // Node textures stored as GL_RGBA8. Alpha is averaged as it is.
+    Srgb,
+};
+
+// The levels of a texture to generate from its level 0, in every layer from m_firstLayer to m_firstLayer + m_layerCount.
+struct MipChain {
+    // GL_TEXTURE_2D or GL_TEXTURE_2D_ARRAY, with immutable storage.
+    GLuint m_texture;
+    GLenum m_target;
+    MipFormat m_format;
+    MipFilter m_filter;
+    // Of level 0.
+    GLsizei m_width;
+    GLsizei m_height;
+    GLsizei m_levels;
+    GLint m_firstLayer;
+    GLsizei m_layerCount;
+};
+
+// The MipFormat of textures of `internalFormat`, if any.
+std::optional<MipFormat> GetMipFormat(GLenum internalFormat);
+
+// Generates the mips of textures with the MipCS compute program, instead of glGenerateTextureMipmap(), which some drivers
+// run on the CPU or stall the GL thread on. A single dispatch generates up to 12 levels of every layer: each workgroup
+// reduces a 64x64 tile through shared memory into the 6 levels below it, and the last workgroup of each layer carries on
+// with the next 6, counted through an SSBO. Drivers with fewer than the 13 image units this takes get 6 levels per
+// dispatch instead, as do levels over 4096 texels, whose 6th level doesn't fit a single tile.
+//
+// The texels are box-filtered, as glGenerateTextureMipmap() and the CPU mips of DownsampleRGBA8() are, but the sRGB
+// textures are averaged in linear space. With Config::ENABLE_COMPUTE_MIPS disabled, or a format without a program, the
+// mips are generated with glGenerateTextureMipmap() instead.
+class MipGenerator {
+public:
+    // The defines of the MipCS program of `format`, for the driver's image units.
+    static std::string GetProgramDefines(MipFormat format);
+
+    void Create();
+    void Release();
+
+    // Generates the mips of `chain` by the next Flush(), the first with the program of its format linked. Its levels
+    // other than level 0 are undefined until then.
+    void Queue(const MipChain& chain);
+    // Generates the mips queued so far with `programs`, the MipCS program of each MipFormat, binding through `stats`, and
+    // issues the GL_TEXTURE_FETCH_BARRIER_BIT needed before they're sampled. Those whose program isn't linked yet, still 0,
+    // stay queued.
+    void Flush(RenderStats& stats, const std::array<GLuint, MIP_FORMAT_COUNT>& programs);
+
+    // Generates the mips of `chain` right away with `program`, the MipCS program of its format. They're written through
+    // image stores, so they need a GL_TEXTURE_FETCH_BARRIER_BIT before they're sampled.
+    void Generate(RenderStats& stats, GLuint program, const MipChain& chain);
+
+    // Adds a pass generating the mips of the texture of `graph` `texture`, which `chain` describes but for its m_texture,
+    // with `program`, the MipCS program of its format, which must outlive the graph's run.
+    void AddPass(RenderGraph& graph, RenderStats& stats, GLuint program, RenderResource texture, const MipChain& chain);
+
+private:
+    // Grows the counter SSBO to `layerCount` layers, returning whether it was reallocated.
+    bool ReserveCounters(GLsizei layerCount);
+
+    GLsizei m_levelsPerDispatch {};
+    GLuint m_counterBuffer {};
+    GLsizei m_counterCapacity {};
+    std::vector<MipChain> m_queue;
+};
+
+} // namespace Glitter::Render
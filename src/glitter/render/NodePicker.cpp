@@ -0,0 +1,71 @@
+#include "render/NodePicker.h"
+
+#include "render/GpuMemory.h"
+
+namespace Glitter::Render {
+
+void NodePicker::Release()
+{
+    for (Slot& slot : m_slots) {
+        if (slot.m_fence) {
+            glDeleteSync(slot.m_fence);
+        }
+        DeleteBuffers(1, &slot.m_buffer);
+        slot = {};
+    }
+    m_next = 0;
+    m_pendingCount = 0;
+}
+
+bool NodePicker::Request(GLuint fbo, GLenum readBuffer, GLint x, GLint y, std::uint64_t revision)
+{
+    if (IsFull()) {
+        return false;
+    }
+
+    // Read into client-side storage when the driver can, since only the CPU reads these buffers.
+    Slot& slot = m_slots[m_next];
+    if (slot.m_buffer == 0) {
+        glCreateBuffers(1, &slot.m_buffer);
+        NamedBufferStorage(
+            GpuMemoryCategory::StreamBuffer, slot.m_buffer, sizeof(std::uint32_t), nullptr, GL_CLIENT_STORAGE_BIT);
+        glObjectLabel(GL_BUFFER, slot.m_buffer, -1, "Node Picking Buffer");
+    }
+
+    // With a pack buffer bound, glReadPixels() only queues the copy and returns.
+    glNamedFramebufferReadBuffer(fbo, readBuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.m_buffer);
+    glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    slot.m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.m_revision = revision;
+    m_next = (m_next + 1) % m_slots.size();
+    m_pendingCount++;
+    return true;
+}
+
+std::optional<NodePick> NodePicker::Poll()
+{
+    std::optional<NodePick> pick {};
+    while (m_pendingCount > 0) {
+        Slot& slot = m_slots[(m_next + m_slots.size() - m_pendingCount) % m_slots.size()];
+        GLenum status = glClientWaitSync(slot.m_fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+        glDeleteSync(slot.m_fence);
+        slot.m_fence = nullptr;
+        m_pendingCount--;
+
+        // The copy has landed, so reading it back doesn't wait on the GPU.
+        std::uint32_t nodeId = 0;
+        glGetNamedBufferSubData(slot.m_buffer, 0, sizeof(nodeId), &nodeId);
+        pick = NodePick {.m_nodeId = nodeId, .m_revision = slot.m_revision};
+    }
+    return pick;
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Config.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace Glitter::Render {
+
+// A pixel of the Node ID target read back by NodePicker: the slot of the Node drawn there plus 1, 0 where none was, and
+// the NodeStore revision of the frame, after which the slots may refer to other Nodes.
+struct NodePick {
+    std::uint32_t m_nodeId;
+    std::uint64_t m_revision;
+};
+
+// Picks the Node under a pixel from the R32UI Node ID target the main pass writes, without a CPU pass over the Nodes or a
+// GPU stall: each request glReadPixels() the single pixel into a pixel pack buffer of a ring of
+// Glitter::Config::FRAMES_IN_FLIGHT, fenced, and the buffer is only read once its fence has signaled, frames later.
+// Requests made while every buffer of the ring is still in flight are refused.
+class NodePicker {
+public:
+    void Release();
+
+    // The buffer the next Request() copies into, e.g. to declare the copy's pass to the RenderGraph. 0 until then.
+    GLuint GetNextBuffer() const { return m_slots[m_next].m_buffer; }
+    bool IsFull() const { return m_pendingCount == m_slots.size(); }
+
+    // Queues a copy of the Node ID at `x`, `y` of `readBuffer` of `fbo`, drawn at `revision`. Returns false if the ring is
+    // full.
+    bool Request(GLuint fbo, GLenum readBuffer, GLint x, GLint y, std::uint64_t revision);
+
+    // The latest pick the GPU has finished, dropping the older finished ones, without waiting for the others.
+    std::optional<NodePick> Poll();
+
+private:
+    struct Slot {
+        GLuint m_buffer;
+        GLsync m_fence;
+        std::uint64_t m_revision;
+    };
+
+    std::array<Slot, Glitter::Config::FRAMES_IN_FLIGHT> m_slots {};
+    // The slot of the next request, and the count of slots before it still in flight.
+    size_t m_next {};
+    size_t m_pendingCount {};
+};
+
+} // namespace Glitter::Render
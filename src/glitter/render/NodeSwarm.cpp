@@ -0,0 +1,124 @@
+#include "render/NodeSwarm.h"
+
+#include "Config.h"
+
+#include <algorithm>
+#include <span>
+
+namespace Glitter::Render {
+
+void NodeSwarm::Create()
+{
+    Release();
+    m_agentBuffer.Reserve(static_cast<std::uint32_t>(Config::NODES_PER_SPAWN));
+    m_agentNodeBuffer.Reserve(static_cast<std::uint32_t>(Config::NODES_PER_SPAWN));
+}
+
+void NodeSwarm::Release()
+{
+    m_agentBuffer.Release();
+    m_agentNodeBuffer.Release();
+    Clear();
+}
+
+std::uint32_t NodeSwarm::Add(const SwarmAgentDesc& desc, std::uint32_t node)
+{
+    auto agent = static_cast<std::uint32_t>(m_agentNodes.size());
+    if (!m_freeAgents.empty()) {
+        agent = m_freeAgents.back();
+        m_freeAgents.pop_back();
+    } else {
+        m_agents.emplace_back();
+        m_agentNodes.push_back(NO_NODE);
+    }
+
+    m_agents[agent] = GpuAgent {.m_positionPhase = glm::vec4(desc.m_position, desc.m_phase),
+        .m_velocityFadeSpeed = glm::vec4(desc.m_velocity, desc.m_fadeSpeed),
+        .m_modelOffset = glm::vec4(desc.m_modelOffset, 0.0f),
+        .m_boundsOffset = glm::vec4(desc.m_boundsOffset, 0.0f)};
+    m_agentNodes[agent] = node;
+    m_addedAgents.Add(agent);
+    m_changedNodes.Add(agent);
+    return agent;
+}
+
+void NodeSwarm::Remap(const std::function<std::optional<std::uint32_t>(std::uint32_t)>& getNode)
+{
+    for (std::uint32_t agent = 0; agent < m_agentNodes.size(); agent++) {
+        if (m_agentNodes[agent] == NO_NODE) {
+            continue;
+        }
+
+        std::uint32_t node = getNode(agent).value_or(NO_NODE);
+        if (node == m_agentNodes[agent]) {
+            continue;
+        }
+        m_agentNodes[agent] = node;
+        m_changedNodes.Add(agent);
+        if (node == NO_NODE) {
+            m_freeAgents.push_back(agent);
+        }
+    }
+}
+
+void NodeSwarm::Clear()
+{
+    m_agents.clear();
+    m_agentNodes.clear();
+    m_freeAgents.clear();
+    m_addedAgents.Clear();
+    m_changedNodes.Clear();
+}
+
+void NodeSwarm::Simulate(RenderStats& stats, GLuint program, std::span<const GLuint> nodeData,
+    std::span<const GLuint> nodeBounds, std::uint32_t stepCount, float stepTime)
+{
+    auto slotCount = static_cast<std::uint32_t>(m_agentNodes.size());
+    bool grew = m_agentBuffer.Reserve(slotCount);
+    grew |= m_agentNodeBuffer.Reserve(slotCount);
+    if (grew) {
+        // The old buffers' names may be handed out again, and they were unbound when deleted.
+        stats.InvalidateState();
+    }
+
+    // The added agents are written exactly, they'd overwrite the simulated state of their neighbors otherwise. The Node
+    // indices are the CPU's, so those ranges can merge.
+    for (const Util::DirtyRanges::Range& range : m_addedAgents.Coalesce(0)) {
+        m_agentBuffer.Write(stats, range.m_begin, std::span(m_agents).subspan(range.m_begin, range.m_end - range.m_begin));
+    }
+    for (const Util::DirtyRanges::Range& range : m_changedNodes.Coalesce(Config::NODE_UPLOAD_MERGE_GAP)) {
+        std::uint32_t end = std::min(range.m_end, slotCount);
+        m_agentNodeBuffer.Write(
+            stats, range.m_begin, std::span<const std::uint32_t>(m_agentNodes).subspan(range.m_begin, end - range.m_begin));
+    }
+    m_addedAgents.Clear();
+    m_changedNodes.Clear();
+
+    // Even without a step, the agents write their Nodes' data over the CPU's uploads of it.
+    if (GetAgentCount() == 0) {
+        return;
+    }
+
+    stats.UseProgram(program);
+    stats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_agentBuffer.GetBuffer());
+    stats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_agentNodeBuffer.GetBuffer());
+    // uniform layout(location = 0) uint u_AgentCount;
+    glUniform1ui(0, slotCount);
+    // uniform layout(location = 1) uint u_StepCount;
+    glUniform1ui(1, stepCount);
+    // uniform layout(location = 2) float u_StepTime;
+    glUniform1f(2, stepTime);
+    // uniform layout(location = 3) float u_Radius;
+    glUniform1f(3, Config::SWARM_RADIUS);
+
+    // Each page's dispatch only advances the agents of its Nodes.
+    for (size_t page = 0; page < nodeData.size(); page++) {
+        stats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, nodeData[page]);
+        stats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, nodeBounds[page]);
+        // uniform layout(location = 4) uint u_NodePage;
+        glUniform1ui(4, static_cast<GLuint>(page));
+        glDispatchCompute((slotCount + 63) / 64, 1, 1);
+    }
+}
+
+} // namespace Glitter::Render
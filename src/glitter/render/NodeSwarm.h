@@ -0,0 +1,81 @@
+#pragma once
+
+#include "render/GpuBufferAllocator.h"
+#include "render/RenderStats.h"
+#include "util/DirtyRanges.h"
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Glitter::Render {
+
+// The state an agent of the swarm starts from. Only the Node's translation moves, so the offsets from it to the drawn
+// model matrix's translation and to the center of its bounds stay the same.
+struct SwarmAgentDesc {
+    glm::vec3 m_position;
+    glm::vec3 m_velocity;
+    // Into its opacity fade, and the fade's pace, in radians and radians per second.
+    float m_phase;
+    float m_fadeSpeed;
+    glm::vec3 m_modelOffset;
+    glm::vec3 m_boundsOffset;
+};
+
+// Nodes whose translation and opacity are simulated on the GPU by SwarmCS.glsl, one agent per Node. The agents' state
+// only lives in an SSBO: each frame advances it by the frame's simulation steps and writes it straight into the Nodes'
+// PerDrawData and GPU bounds, so the CPU never updates nor uploads them. Only the GPU culling pass sees where they are,
+// the CPU keeps their spawn transform.
+//
+// The agents keep their index, the Node indices they drive are only uploaded again when Nodes are added or removed.
+// Removed Nodes free their agent for the next one added.
+class NodeSwarm {
+public:
+    void Create();
+    void Release();
+
+    // Adds an agent driving Node `node`, returning its index.
+    std::uint32_t Add(const SwarmAgentDesc& desc, std::uint32_t node);
+    // Points every agent at its Node's index again, by `getNode`, which returns std::nullopt once the Node was removed.
+    void Remap(const std::function<std::optional<std::uint32_t>(std::uint32_t)>& getNode);
+    void Clear();
+
+    // Uploads the agents added or remapped since the last call, then advances every agent by `stepCount` steps of
+    // `stepTime` seconds with `program`, writing their Nodes' data into the `nodeData` and `nodeBounds` SSBOs, one of each
+    // per page of Config::NODE_PAGE_SIZE Nodes. Leaves the barriers to the caller.
+    void Simulate(RenderStats& stats, GLuint program, std::span<const GLuint> nodeData, std::span<const GLuint> nodeBounds,
+        std::uint32_t stepCount, float stepTime);
+
+    // Including the free ones.
+    std::uint32_t GetSlotCount() const { return static_cast<std::uint32_t>(m_agentNodes.size()); }
+    size_t GetAgentCount() const { return m_agentNodes.size() - m_freeAgents.size(); }
+
+private:
+    // In m_agentNodes, for the free agents, which SwarmCS.glsl skips.
+    static constexpr std::uint32_t NO_NODE = UINT32_MAX;
+
+    // Matches the std430 layout of `b_Agents` in SwarmCS.glsl.
+    struct alignas(16) GpuAgent {
+        glm::vec4 m_positionPhase;
+        glm::vec4 m_velocityFadeSpeed;
+        glm::vec4 m_modelOffset;
+        glm::vec4 m_boundsOffset;
+    };
+
+    // The agents as they were added, only uploaded once: their state past then is the GPU's.
+    std::vector<GpuAgent> m_agents;
+    std::vector<std::uint32_t> m_agentNodes;
+    std::vector<std::uint32_t> m_freeAgents;
+    Util::DirtyRanges m_addedAgents;
+    Util::DirtyRanges m_changedNodes;
+
+    GpuBuffer<GpuAgent> m_agentBuffer {"Swarm Agents SSBO"};
+    GpuBuffer<std::uint32_t> m_agentNodeBuffer {"Swarm Agent Nodes SSBO"};
+};
+
+} // namespace Glitter::Render
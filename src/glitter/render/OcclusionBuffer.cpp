@@ -0,0 +1,362 @@
+#include "render/OcclusionBuffer.h"
+
+#include "core/CpuProfiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(GLITTER_SIMD_X86)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace Glitter::Render {
+
+namespace {
+
+    constexpr std::uint32_t TILES_X = OcclusionBuffer::WIDTH / OcclusionBuffer::TILE_SIZE;
+
+    // Pixel coordinates past the buffer by more than a pixel are clamped, so that they convert to an int whatever the
+    // triangle.
+    constexpr float PIXEL_GUARD = 1.0f;
+
+    glm::vec2 ToPixels(const glm::vec4& clip)
+    {
+        return (glm::vec2(clip) / clip.w * 0.5f + 0.5f)
+            * glm::vec2(static_cast<float>(OcclusionBuffer::WIDTH), static_cast<float>(OcclusionBuffer::HEIGHT));
+    }
+
+    // Writes the pixels of [firstX, lastX] of `row` whose center the triangle covers, where it's nearer. The edges and
+    // depth are at the row's first pixel.
+    void RasterizeRowScalar(float* row, std::int32_t firstX, std::int32_t lastX, const std::array<float, 3>& edgeX,
+        const std::array<float, 3>& edges, float depthX, float depth)
+    {
+        for (std::int32_t x = firstX; x <= lastX; x++) {
+            auto pixelX = static_cast<float>(x);
+            if (edgeX[0] * pixelX + edges[0] >= 0.0f && edgeX[1] * pixelX + edges[1] >= 0.0f
+                && edgeX[2] * pixelX + edges[2] >= 0.0f) {
+                row[x] = std::max(row[x], depthX * pixelX + depth);
+            }
+        }
+    }
+
+#if defined(GLITTER_SIMD_X86)
+    // Same as RasterizeRowSse2(), 8 at a time from the multiple of 8 at or before `firstX`.
+    GLITTER_TARGET_AVX2 void RasterizeRowAvx2(float* row, std::int32_t firstX, std::int32_t lastX,
+        const std::array<float, 3>& edgeX, const std::array<float, 3>& edges, float depthX, float depth)
+    {
+        __m256 lane = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+        __m256 zero = _mm256_setzero_ps();
+        for (std::int32_t x = firstX & ~7; x <= lastX; x += 8) {
+            __m256 pixelX = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), lane);
+            __m256 e0 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(edgeX[0]), pixelX), _mm256_set1_ps(edges[0]));
+            __m256 e1 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(edgeX[1]), pixelX), _mm256_set1_ps(edges[1]));
+            __m256 e2 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(edgeX[2]), pixelX), _mm256_set1_ps(edges[2]));
+            __m256 covered = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(e0, zero, _CMP_GE_OQ), _mm256_cmp_ps(e1, zero, _CMP_GE_OQ)),
+                _mm256_cmp_ps(e2, zero, _CMP_GE_OQ));
+            __m256 pixelDepth = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(depthX), pixelX), _mm256_set1_ps(depth));
+            _mm256_storeu_ps(row + x, _mm256_max_ps(_mm256_loadu_ps(row + x), _mm256_and_ps(covered, pixelDepth)));
+        }
+    }
+
+    // Writes the pixels of [firstX, lastX] of `row`, 4 at a time from the multiple of 4 at or before `firstX`, whose
+    // center the triangle covers, where it's nearer. The edges and depth are at the row's first pixel.
+    void RasterizeRowSse2(float* row, std::int32_t firstX, std::int32_t lastX, const std::array<float, 3>& edgeX,
+        const std::array<float, 3>& edges, float depthX, float depth)
+    {
+        __m128 lane = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        __m128 zero = _mm_setzero_ps();
+        for (std::int32_t x = firstX & ~3; x <= lastX; x += 4) {
+            __m128 pixelX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lane);
+            __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edgeX[0]), pixelX), _mm_set1_ps(edges[0]));
+            __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edgeX[1]), pixelX), _mm_set1_ps(edges[1]));
+            __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edgeX[2]), pixelX), _mm_set1_ps(edges[2]));
+            __m128 covered = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+            __m128 pixelDepth = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(depthX), pixelX), _mm_set1_ps(depth));
+            _mm_storeu_ps(row + x, _mm_max_ps(_mm_loadu_ps(row + x), _mm_and_ps(covered, pixelDepth)));
+        }
+    }
+#elif defined(__ARM_NEON)
+    // Writes the pixels of [firstX, lastX] of `row`, 4 at a time from the multiple of 4 at or before `firstX`, whose
+    // center the triangle covers, where it's nearer. The edges and depth are at the row's first pixel.
+    void RasterizeRowNeon(float* row, std::int32_t firstX, std::int32_t lastX, const std::array<float, 3>& edgeX,
+        const std::array<float, 3>& edges, float depthX, float depth)
+    {
+        constexpr float lanes[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+        float32x4_t lane = vld1q_f32(lanes);
+        float32x4_t zero = vdupq_n_f32(0.0f);
+        for (std::int32_t x = firstX & ~3; x <= lastX; x += 4) {
+            float32x4_t pixelX = vaddq_f32(vdupq_n_f32(static_cast<float>(x)), lane);
+            float32x4_t e0 = vmlaq_n_f32(vdupq_n_f32(edges[0]), pixelX, edgeX[0]);
+            float32x4_t e1 = vmlaq_n_f32(vdupq_n_f32(edges[1]), pixelX, edgeX[1]);
+            float32x4_t e2 = vmlaq_n_f32(vdupq_n_f32(edges[2]), pixelX, edgeX[2]);
+            uint32x4_t covered = vandq_u32(vandq_u32(vcgeq_f32(e0, zero), vcgeq_f32(e1, zero)), vcgeq_f32(e2, zero));
+            float32x4_t pixelDepth = vmlaq_n_f32(vdupq_n_f32(depth), pixelX, depthX);
+            float32x4_t written = vreinterpretq_f32_u32(vandq_u32(covered, vreinterpretq_u32_f32(pixelDepth)));
+            vst1q_f32(row + x, vmaxq_f32(vld1q_f32(row + x), written));
+        }
+    }
+#endif
+
+    using RasterizeRowFunction = void (*)(float* row, std::int32_t firstX, std::int32_t lastX,
+        const std::array<float, 3>& edgeX, const std::array<float, 3>& edges, float depthX, float depth);
+
+    struct RowKernel {
+        Core::SimdLevel m_level;
+        RasterizeRowFunction m_rasterizeRow;
+    };
+
+    // Bound on the first call, see Core::GetSimdLevel(). AVX-512 would only help the rows at least 16 pixels across.
+    const RowKernel& GetRowKernel()
+    {
+        static const RowKernel kernel = []() -> RowKernel {
+            switch (Core::GetSimdLevel()) {
+#if defined(GLITTER_SIMD_X86)
+            case Core::SimdLevel::Avx512:
+            case Core::SimdLevel::Avx2:
+                return {Core::SimdLevel::Avx2, RasterizeRowAvx2};
+            case Core::SimdLevel::Sse42:
+            case Core::SimdLevel::Sse2:
+                return {Core::SimdLevel::Sse2, RasterizeRowSse2};
+#elif defined(__ARM_NEON)
+            case Core::SimdLevel::Neon:
+                return {Core::SimdLevel::Neon, RasterizeRowNeon};
+#endif
+            default:
+                return {Core::SimdLevel::Scalar, RasterizeRowScalar};
+            }
+        }();
+        return kernel;
+    }
+
+} // namespace
+
+Core::SimdLevel GetOcclusionSimdLevel()
+{
+    return GetRowKernel().m_level;
+}
+
+void OcclusionBuffer::Begin(const glm::mat4& viewProjection)
+{
+    m_viewProjection = viewProjection;
+    m_triangles.clear();
+    m_occluderCount = 0;
+    // Cleared by the bands.
+    m_depth.resize(size_t {WIDTH} * HEIGHT);
+    m_tileDepth.resize(size_t {TILES_X} * (HEIGHT / TILE_SIZE));
+}
+
+void OcclusionBuffer::AddOccluder(const OccluderMesh& mesh, const glm::mat4& model)
+{
+    glm::mat4 modelViewProjection = m_viewProjection * model;
+    m_clipPositions.clear();
+    for (const glm::vec3& position : mesh.m_positions) {
+        m_clipPositions.push_back(modelViewProjection * glm::vec4(position, 1.0f));
+    }
+    for (size_t index = 0; index + 2 < mesh.m_indices.size(); index += 3) {
+        AddTriangle(m_clipPositions[mesh.m_indices[index]], m_clipPositions[mesh.m_indices[index + 1]],
+            m_clipPositions[mesh.m_indices[index + 2]]);
+    }
+    m_occluderCount++;
+}
+
+void OcclusionBuffer::AddTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+{
+    // In front of the near plane where `z + w > 0`.
+    std::array<glm::vec4, 3> vertices {a, b, c};
+    std::array<float, 3> distances {a.z + a.w, b.z + b.w, c.z + c.w};
+    if (distances[0] > 0.0f && distances[1] > 0.0f && distances[2] > 0.0f) {
+        SetupTriangle(a, b, c);
+        return;
+    }
+
+    // Otherwise, what's left of it is a triangle or a quad.
+    std::array<glm::vec4, 4> clipped {};
+    size_t clippedCount = 0;
+    for (size_t vertexIdx = 0; vertexIdx < 3; vertexIdx++) {
+        size_t nextIdx = (vertexIdx + 1) % 3;
+        if (distances[vertexIdx] > 0.0f) {
+            clipped[clippedCount++] = vertices[vertexIdx];
+        }
+        if ((distances[vertexIdx] > 0.0f) != (distances[nextIdx] > 0.0f)) {
+            float t = distances[vertexIdx] / (distances[vertexIdx] - distances[nextIdx]);
+            clipped[clippedCount++] = glm::mix(vertices[vertexIdx], vertices[nextIdx], t);
+        }
+    }
+    for (size_t vertexIdx = 1; vertexIdx + 1 < clippedCount; vertexIdx++) {
+        SetupTriangle(clipped[0], clipped[vertexIdx], clipped[vertexIdx + 1]);
+    }
+}
+
+void OcclusionBuffer::SetupTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+{
+    std::array<glm::vec2, 3> pixels {ToPixels(a), ToPixels(b), ToPixels(c)};
+    std::array<float, 3> depths {1.0f / a.w, 1.0f / b.w, 1.0f / c.w};
+
+    // Counter-clockwise, so that its inside is where every edge function is positive, whichever side of it is seen.
+    float area = (pixels[1].x - pixels[0].x) * (pixels[2].y - pixels[0].y)
+        - (pixels[1].y - pixels[0].y) * (pixels[2].x - pixels[0].x);
+    if (!(std::abs(area) > std::numeric_limits<float>::epsilon())) {
+        return;
+    }
+    if (area < 0.0f) {
+        std::swap(pixels[1], pixels[2]);
+        std::swap(depths[1], depths[2]);
+        area = -area;
+    }
+
+    // The pixels whose center it covers are inside its bounds.
+    glm::vec2 guardMin {-PIXEL_GUARD};
+    glm::vec2 guardMax = glm::vec2(static_cast<float>(WIDTH), static_cast<float>(HEIGHT)) + PIXEL_GUARD;
+    glm::vec2 pixelMin = glm::clamp(glm::min(pixels[0], glm::min(pixels[1], pixels[2])), guardMin, guardMax);
+    glm::vec2 pixelMax = glm::clamp(glm::max(pixels[0], glm::max(pixels[1], pixels[2])), guardMin, guardMax);
+    Triangle triangle {};
+    triangle.m_minX = std::max(static_cast<std::int32_t>(std::floor(pixelMin.x)), 0);
+    triangle.m_minY = std::max(static_cast<std::int32_t>(std::floor(pixelMin.y)), 0);
+    triangle.m_maxX = std::min(static_cast<std::int32_t>(std::floor(pixelMax.x)), static_cast<std::int32_t>(WIDTH) - 1);
+    triangle.m_maxY = std::min(static_cast<std::int32_t>(std::floor(pixelMax.y)), static_cast<std::int32_t>(HEIGHT) - 1);
+    if (triangle.m_minX > triangle.m_maxX || triangle.m_minY > triangle.m_maxY) {
+        return;
+    }
+
+    // The i-th edge runs between the other two vertices, and is the i-th vertex's barycentric weight once divided by the
+    // area. Each function is evaluated at the pixel's center from its corner. The depth is then lessened by how much it
+    // varies over half a pixel, to be the smallest over the pixel.
+    float depthX = 0.0f;
+    float depthY = 0.0f;
+    float depthOffset = 0.0f;
+    for (size_t edgeIdx = 0; edgeIdx < 3; edgeIdx++) {
+        const glm::vec2& from = pixels[(edgeIdx + 1) % 3];
+        const glm::vec2& to = pixels[(edgeIdx + 2) % 3];
+        float edgeX = from.y - to.y;
+        float edgeY = to.x - from.x;
+        float edgeOffset = from.x * to.y - from.y * to.x;
+        triangle.m_edgeX[edgeIdx] = edgeX;
+        triangle.m_edgeY[edgeIdx] = edgeY;
+        triangle.m_edgeOffset[edgeIdx] = edgeOffset + 0.5f * (edgeX + edgeY);
+
+        depthX += edgeX * depths[edgeIdx] / area;
+        depthY += edgeY * depths[edgeIdx] / area;
+        depthOffset += edgeOffset * depths[edgeIdx] / area;
+    }
+    triangle.m_depthX = depthX;
+    triangle.m_depthY = depthY;
+    triangle.m_depthOffset = depthOffset + 0.5f * (depthX + depthY) - 0.5f * (std::abs(depthX) + std::abs(depthY));
+    m_triangles.push_back(triangle);
+}
+
+void OcclusionBuffer::Rasterize(Core::JobSystem& jobSystem)
+{
+    constexpr std::uint32_t bandCount = HEIGHT / Config::OCCLUSION_BAND_HEIGHT;
+    jobSystem.ParallelFor(bandCount, 1, [&](size_t begin, size_t end) {
+        GLITTER_PROFILE_SCOPE("Rasterize Occluders");
+        for (size_t band = begin; band < end; band++) {
+            auto beginRow = static_cast<std::uint32_t>(band) * Config::OCCLUSION_BAND_HEIGHT;
+            RasterizeBand(beginRow, beginRow + Config::OCCLUSION_BAND_HEIGHT);
+        }
+    });
+}
+
+void OcclusionBuffer::RasterizeBand(std::uint32_t beginRow, std::uint32_t endRow)
+{
+    std::fill(m_depth.begin() + std::ptrdiff_t {WIDTH} * beginRow, m_depth.begin() + std::ptrdiff_t {WIDTH} * endRow, 0.0f);
+
+    RasterizeRowFunction rasterizeRow = GetRowKernel().m_rasterizeRow;
+
+    for (const Triangle& triangle : m_triangles) {
+        std::int32_t firstY = std::max(triangle.m_minY, static_cast<std::int32_t>(beginRow));
+        std::int32_t lastY = std::min(triangle.m_maxY, static_cast<std::int32_t>(endRow) - 1);
+        for (std::int32_t y = firstY; y <= lastY; y++) {
+            auto pixelY = static_cast<float>(y);
+            std::array<float, 3> edges {};
+            for (size_t edgeIdx = 0; edgeIdx < 3; edgeIdx++) {
+                edges[edgeIdx] = triangle.m_edgeY[edgeIdx] * pixelY + triangle.m_edgeOffset[edgeIdx];
+            }
+            rasterizeRow(&m_depth[size_t {WIDTH} * static_cast<size_t>(y)], triangle.m_minX, triangle.m_maxX, triangle.m_edgeX,
+                edges, triangle.m_depthX, triangle.m_depthY * pixelY + triangle.m_depthOffset);
+        }
+    }
+
+    // Then the farthest depth of each of the band's tiles.
+    for (std::uint32_t tileY = beginRow / TILE_SIZE; tileY < endRow / TILE_SIZE; tileY++) {
+        for (std::uint32_t tileX = 0; tileX < TILES_X; tileX++) {
+            float farthest = std::numeric_limits<float>::max();
+            for (std::uint32_t y = tileY * TILE_SIZE; y < (tileY + 1) * TILE_SIZE; y++) {
+                const float* row = &m_depth[size_t {WIDTH} * y + tileX * TILE_SIZE];
+                farthest = std::min(farthest, *std::min_element(row, row + TILE_SIZE));
+            }
+            m_tileDepth[size_t {TILES_X} * tileY + tileX] = farthest;
+        }
+    }
+}
+
+bool OcclusionBuffer::IsOccluded(const glm::vec3& center, const glm::vec3& extent) const
+{
+    // The screen rectangle of the AABB's corners, and the nearest of them, w being linear over the AABB. An AABB crossing
+    // the near plane is never occluded.
+    glm::vec4 clipCenter = m_viewProjection * glm::vec4(center, 1.0f);
+    glm::vec4 clipX = m_viewProjection[0] * extent.x;
+    glm::vec4 clipY = m_viewProjection[1] * extent.y;
+    glm::vec4 clipZ = m_viewProjection[2] * extent.z;
+    glm::vec2 pixelMin {std::numeric_limits<float>::max()};
+    glm::vec2 pixelMax {std::numeric_limits<float>::lowest()};
+    float nearestW = std::numeric_limits<float>::max();
+    for (int cornerIdx = 0; cornerIdx < 8; cornerIdx++) {
+        glm::vec4 corner = clipCenter + ((cornerIdx & 1) ? clipX : -clipX) + ((cornerIdx & 2) ? clipY : -clipY)
+            + ((cornerIdx & 4) ? clipZ : -clipZ);
+        if (corner.z + corner.w <= 0.0f) {
+            return false;
+        }
+        glm::vec2 pixel = ToPixels(corner);
+        pixelMin = glm::min(pixelMin, pixel);
+        pixelMax = glm::max(pixelMax, pixel);
+        nearestW = std::min(nearestW, corner.w);
+    }
+    if (pixelMax.x < 0.0f || pixelMax.y < 0.0f || pixelMin.x >= static_cast<float>(WIDTH)
+        || pixelMin.y >= static_cast<float>(HEIGHT)) {
+        return false;
+    }
+
+    // Every pixel the rectangle touches on screen, and their neighbours, since a pixel is covered by the triangles over its
+    // center even if the rest of it isn't.
+    auto firstX = static_cast<std::uint32_t>(std::max(pixelMin.x - 1.0f, 0.0f));
+    auto firstY = static_cast<std::uint32_t>(std::max(pixelMin.y - 1.0f, 0.0f));
+    auto lastX = static_cast<std::uint32_t>(std::min(pixelMax.x + 1.0f, static_cast<float>(WIDTH - 1)));
+    auto lastY = static_cast<std::uint32_t>(std::min(pixelMax.y + 1.0f, static_cast<float>(HEIGHT - 1)));
+    float depth = 1.0f / nearestW;
+
+    // Only the tiles whose farthest pixel isn't nearer than the AABB are tested pixel by pixel.
+    for (std::uint32_t tileY = firstY / TILE_SIZE; tileY <= lastY / TILE_SIZE; tileY++) {
+        for (std::uint32_t tileX = firstX / TILE_SIZE; tileX <= lastX / TILE_SIZE; tileX++) {
+            if (m_tileDepth[size_t {TILES_X} * tileY + tileX] > depth) {
+                continue;
+            }
+            std::uint32_t endY = std::min((tileY + 1) * TILE_SIZE - 1, lastY);
+            std::uint32_t endX = std::min((tileX + 1) * TILE_SIZE - 1, lastX);
+            for (std::uint32_t y = std::max(tileY * TILE_SIZE, firstY); y <= endY; y++) {
+                for (std::uint32_t x = std::max(tileX * TILE_SIZE, firstX); x <= endX; x++) {
+                    if (m_depth[size_t {WIDTH} * y + x] <= depth) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+size_t OcclusionBuffer::CullRange(const CullBounds& bounds, size_t begin, size_t end, VisibilityMask& visibility) const
+{
+    size_t culled = 0;
+    for (size_t i = begin; i < end; i++) {
+        if (IsVisible(visibility, i) && IsOccluded(bounds.GetCenter(i), bounds.GetExtent(i))) {
+            visibility[i / 64] &= ~(std::uint64_t {1} << (i % 64));
+            culled++;
+        }
+    }
+    return culled;
+}
+
+} // namespace Glitter::Render
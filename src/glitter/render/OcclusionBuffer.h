@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Config.h"
+#include "core/CpuFeatures.h"
+#include "core/JobSystem.h"
+#include "render/FrustumCulling.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Glitter::Render {
+
+// The triangles a Mesh occludes with, in Mesh space. Built from its coarsest LOD, it's only meant to be about as large as
+// the Mesh, the culling is made conservative at the buffer's resolution, not at the occluder's.
+struct OccluderMesh {
+    std::vector<glm::vec3> m_positions;
+    std::vector<std::uint32_t> m_indices;
+};
+
+// A low-resolution depth buffer the occluders are rasterized into on the CPU, so that the AABBs hidden behind them can be
+// culled in the frame they're hidden in, rather than against the previous frame's depth like the GPU Hi-Z.
+//
+// Each pixel holds the largest 1/w of the occluders covering its center, that is the nearest, and 0 where there's none.
+// The depth written is the smallest 1/w the triangle's plane has over the pixel. An AABB is occluded when its nearest
+// point is further than every pixel its screen rectangle touches, grown by a pixel for the coverage to be conservative
+// too, but for gaps narrower than a pixel between the occluders' triangles. The pixels are first tested by tiles of 8x8,
+// against the farthest depth of each.
+class OcclusionBuffer {
+public:
+    static constexpr std::uint32_t WIDTH = Config::OCCLUSION_BUFFER_WIDTH;
+    static constexpr std::uint32_t HEIGHT = Config::OCCLUSION_BUFFER_HEIGHT;
+    static constexpr std::uint32_t TILE_SIZE = 8;
+
+    // Clears the buffer and the occluders, for the frame seen through `viewProjection`.
+    void Begin(const glm::mat4& viewProjection);
+    // Sets up the triangles of `mesh`, drawn with `model`, to be rasterized by Rasterize(), clipped by the near plane.
+    void AddOccluder(const OccluderMesh& mesh, const glm::mat4& model);
+    // Rasterizes every occluder added since Begin(), a band of Config::OCCLUSION_BAND_HEIGHT rows per job of `jobSystem`.
+    void Rasterize(Core::JobSystem& jobSystem);
+
+    // Whether the AABB is hidden behind the occluders. Thread-safe once rasterized.
+    bool IsOccluded(const glm::vec3& center, const glm::vec3& extent) const;
+    // Clears the bit of `visibility` of each visible AABB in [begin, end) of `bounds` that's occluded, and returns their
+    // count. Bound by the same rules as CullAABBRange(), so that the ranges can be tested concurrently.
+    size_t CullRange(const CullBounds& bounds, size_t begin, size_t end, VisibilityMask& visibility) const;
+
+    size_t GetOccluderCount() const { return m_occluderCount; }
+    size_t GetTriangleCount() const { return m_triangles.size(); }
+
+private:
+    // A triangle ready to rasterize: its edge functions, positive inside, and its 1/w as a plane offset to the smallest
+    // over a pixel, all of the coordinates of the pixel's corner.
+    struct Triangle {
+        std::array<float, 3> m_edgeX;
+        std::array<float, 3> m_edgeY;
+        std::array<float, 3> m_edgeOffset;
+        float m_depthX;
+        float m_depthY;
+        float m_depthOffset;
+        // The pixels it may cover, inclusive.
+        std::int32_t m_minX;
+        std::int32_t m_minY;
+        std::int32_t m_maxX;
+        std::int32_t m_maxY;
+    };
+
+    // Clips the clip-space triangle by the near plane, and sets up what's left of it.
+    void AddTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+    void SetupTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+    void RasterizeBand(std::uint32_t beginRow, std::uint32_t endRow);
+
+    glm::mat4 m_viewProjection {1.0f};
+    std::vector<Triangle> m_triangles;
+    size_t m_occluderCount {};
+    // The clip-space positions of the occluder being added, kept between occluders not to allocate.
+    std::vector<glm::vec4> m_clipPositions;
+
+    // Row by row, and the smallest of each tile's pixels.
+    std::vector<float> m_depth;
+    std::vector<float> m_tileDepth;
+};
+
+// The instruction set the occluders' rows are rasterized with, the widest of the CPU's it has a version for.
+Core::SimdLevel GetOcclusionSimdLevel();
+
+} // namespace Glitter::Render
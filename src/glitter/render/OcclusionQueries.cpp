@@ -0,0 +1,54 @@
+#include "render/OcclusionQueries.h"
+
+namespace Glitter::Render {
+
+void OcclusionQueries::Release()
+{
+    for (Pool& pool : m_pools) {
+        glDeleteQueries(static_cast<GLsizei>(pool.m_queries.size()), pool.m_queries.data());
+        pool = Pool {};
+    }
+    m_sceneRevision = UINT64_MAX;
+}
+
+void OcclusionQueries::BeginFrame(std::uint64_t sceneRevision, size_t nodeCount)
+{
+    m_frame++;
+    m_queryCount = 0;
+    if (sceneRevision != m_sceneRevision) {
+        m_sceneRevision = sceneRevision;
+        m_validFrame = m_frame;
+    }
+
+    // Only grows, the queries of the Nodes removed since are reused by the ones added later.
+    Pool& pool = m_pools[m_frame % m_pools.size()];
+    size_t queryCount = pool.m_queries.size();
+    if (nodeCount > queryCount) {
+        pool.m_queries.resize(nodeCount);
+        pool.m_frames.resize(nodeCount, 0);
+        glCreateQueries(GL_ANY_SAMPLES_PASSED_CONSERVATIVE, static_cast<GLsizei>(nodeCount - queryCount),
+            pool.m_queries.data() + queryCount);
+    }
+}
+
+GLuint OcclusionQueries::GetCondition(size_t node) const
+{
+    std::uint64_t previousFrame = m_frame - 1;
+    const Pool& pool = m_pools[previousFrame % m_pools.size()];
+    if (previousFrame < m_validFrame || node >= pool.m_queries.size() || pool.m_frames[node] != previousFrame) {
+        return 0;
+    }
+    return pool.m_queries[node];
+}
+
+void OcclusionQueries::BeginQuery(size_t node)
+{
+    Pool& pool = m_pools[m_frame % m_pools.size()];
+    pool.m_frames[node] = m_frame;
+    glBeginQuery(GL_ANY_SAMPLES_PASSED_CONSERVATIVE, pool.m_queries[node]);
+    m_queryCount++;
+}
+
+void OcclusionQueries::EndQuery() { glEndQuery(GL_ANY_SAMPLES_PASSED_CONSERVATIVE); }
+
+} // namespace Glitter::Render
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Config.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Glitter::Render {
+
+// Hardware occlusion queries of the Nodes' bounds, the fallback to the Hi-Z pyramid of the GPU culling pass: each frame
+// queries whether any sample of the bounds of the drawn Nodes passes the depth test against the opaque depth, and the next
+// frame only draws each Node under glBeginConditionalRender() of its query. The results are never read back, and the
+// conditions don't wait for them either: a query the GPU hasn't finished draws its Node.
+//
+// Every Node has a query in each of Glitter::Config::FRAMES_IN_FLIGHT pools, one per frame, so that a frame's queries are
+// only issued again once the GPU is done with them. The conditions only read the previous frame's pool, and only for the
+// Nodes it queried.
+class OcclusionQueries {
+public:
+    void Release();
+
+    // Moves on to the next pool, with a query for each of `nodeCount` Nodes. A new `sceneRevision` forgets the previous
+    // frame's queries, since the Nodes may have moved to other indices since.
+    void BeginFrame(std::uint64_t sceneRevision, size_t nodeCount);
+
+    // The previous frame's query of `node`, to draw it under, or 0 to draw it unconditionally.
+    GLuint GetCondition(size_t node) const;
+
+    // Around the draw of `node`'s bounds.
+    void BeginQuery(size_t node);
+    void EndQuery();
+
+    size_t GetQueryCount() const { return m_queryCount; }
+
+private:
+    struct Pool {
+        std::vector<GLuint> m_queries;
+        // The frame each Node was last queried in.
+        std::vector<std::uint64_t> m_frames;
+    };
+
+    std::array<Pool, Glitter::Config::FRAMES_IN_FLIGHT> m_pools {};
+    std::uint64_t m_frame {};
+    // The first frame whose queries hold for the current Node indices.
+    std::uint64_t m_validFrame {};
+    std::uint64_t m_sceneRevision {UINT64_MAX};
+    size_t m_queryCount {};
+};
+
+} // namespace Glitter::Render
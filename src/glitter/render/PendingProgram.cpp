@@ -0,0 +1,156 @@
+#include "render/PendingProgram.h"
+
+#include "core/FrameStats.h"
+#include "render/GLExtensions.h"
+#include "render/GLTrace.h"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <utility>
+
+namespace Glitter::Render {
+
+namespace {
+
+    constexpr const char* GetShaderTypeName(GLenum type)
+    {
+        switch (type) {
+        case GL_VERTEX_SHADER:
+            return "vertex";
+        case GL_FRAGMENT_SHADER:
+            return "fragment";
+        case GL_COMPUTE_SHADER:
+            return "compute";
+        default:
+            return "unknown";
+        }
+    }
+
+} // namespace
+
+PendingProgram PendingProgram::Submit(std::vector<ShaderSource> shaders, const char* name, const ProgramCache& cache)
+{
+    Core::MarkFrameActivity(Core::FrameActivity::SHADER_COMPILE);
+
+    PendingProgram pending {};
+    pending.m_sources = std::move(shaders);
+    pending.m_name = name;
+    if (std::optional<GLuint> cached = cache.Load(pending.m_sources, name)) {
+        pending.m_program = *cached;
+    } else {
+        pending.Compile();
+    }
+    return pending;
+}
+
+bool PendingProgram::IsReady() const
+{
+    if (!GetGLExtensions().m_parallelShaderCompile) {
+        return true;
+    }
+
+    GLint ready = GL_FALSE;
+    glGetProgramiv(m_program, GL_COMPLETION_STATUS_KHR, &ready);
+    return ready == GL_TRUE;
+}
+
+std::expected<GLuint, ProgramError> PendingProgram::Finish(const ProgramCache& cache)
+{
+    GLint res = GL_FALSE;
+    glGetProgramiv(m_program, GL_LINK_STATUS, &res);
+    if (res == GL_FALSE && m_shaders.empty()) {
+        // Drivers reject binaries of other builds of theirs, even with the same version string.
+        glDeleteProgram(m_program);
+        Compile();
+        glGetProgramiv(m_program, GL_LINK_STATUS, &res);
+    }
+    if (res == GL_FALSE && std::ranges::any_of(m_sources, [](const ShaderSource& source) { return !source.m_spirv.empty(); })) {
+        // A module built from an older source, or for another version of the other stages, doesn't link with them.
+        spdlog::warn("Failed to build {} from SPIR-V, compiling its GLSL sources instead.", m_name);
+        for (GLuint shader : m_shaders) {
+            glDeleteShader(shader);
+        }
+        m_shaders.clear();
+        glDeleteProgram(m_program);
+
+        for (ShaderSource& source : m_sources) {
+            source.m_spirv.clear();
+            source.m_constants.clear();
+        }
+        Compile();
+        glGetProgramiv(m_program, GL_LINK_STATUS, &res);
+    }
+
+    // Only look at the shaders once the program is done with them, so that checking one doesn't wait for its compile
+    // while the others are still queued.
+    std::optional<ProgramError> error {};
+    for (size_t idx = 0; idx < m_shaders.size(); idx++) {
+        GLint compiled = GL_TRUE;
+        if (res == GL_FALSE) {
+            glGetShaderiv(m_shaders[idx], GL_COMPILE_STATUS, &compiled);
+        }
+        if (compiled != GL_TRUE) {
+            std::array<GLchar, 512> log {};
+            glGetShaderInfoLog(m_shaders[idx], 512, nullptr, log.data());
+            spdlog::error("[{}] {}", GetShaderTypeName(m_sources[idx].m_type), log.data());
+            error = ProgramError::Compile;
+        }
+
+        // The shaders can be safely deleted after being linked into a Program.
+        glDeleteShader(m_shaders[idx]);
+    }
+    bool compiledFromSource = !m_shaders.empty();
+    m_shaders.clear();
+
+    if (res == GL_FALSE) {
+        if (!error) {
+            std::array<GLchar, 512> log {};
+            glGetProgramInfoLog(m_program, 512, nullptr, log.data());
+            spdlog::error("[program] {}", log.data());
+            error = ProgramError::Link;
+        }
+
+        glDeleteProgram(std::exchange(m_program, 0));
+        return std::unexpected(*error);
+    }
+
+    if (compiledFromSource) {
+        cache.Store(m_program, m_sources);
+    }
+    GLTraceRecorder::RegisterProgram(m_program, m_sources);
+    return std::exchange(m_program, 0);
+}
+
+void PendingProgram::Compile()
+{
+    m_program = glCreateProgram();
+    glObjectLabel(GL_PROGRAM, m_program, -1, m_name.c_str());
+    glProgramParameteri(m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+    // Link right away without checking the compile status, which would wait for the compile.
+    for (const ShaderSource& source : m_sources) {
+        GLuint shader = glCreateShader(source.m_type);
+        glObjectLabel(GL_SHADER, shader, -1, GetShaderTypeName(source.m_type));
+        if (!source.m_spirv.empty()) {
+            std::vector<GLuint> constantIds {};
+            std::vector<GLuint> constantValues {};
+            for (const SpecializationConstant& constant : source.m_constants) {
+                constantIds.push_back(constant.m_id);
+                constantValues.push_back(constant.m_value);
+            }
+            glShaderBinary(1, &shader, GL_SHADER_BINARY_FORMAT_SPIR_V, source.m_spirv.data(),
+                static_cast<GLsizei>(source.m_spirv.size()));
+            glSpecializeShader(shader, "main", static_cast<GLuint>(constantIds.size()), constantIds.data(), constantValues.data());
+        } else {
+            const char* src = source.m_source.c_str();
+            glShaderSource(shader, 1, &src, nullptr);
+            glCompileShader(shader);
+        }
+        glAttachShader(m_program, shader);
+        m_shaders.push_back(shader);
+    }
+    glLinkProgram(m_program);
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "render/ProgramCache.h"
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <vector>
+
+namespace Glitter::Render {
+
+enum class ProgramError : std::uint8_t {
+    Compile,
+    Link,
+};
+
+// A program being built by the driver, from its cached binary, SPIR-V modules or source. None is waited for until
+// Finish(), so submitting every program before finishing any lets the driver compile them concurrently, on its own threads
+// with GL_KHR_parallel_shader_compile, while the application does something else.
+class PendingProgram {
+public:
+    // Loads the cached binary of `shaders` if there's one, and otherwise starts compiling and linking them.
+    static PendingProgram Submit(std::vector<ShaderSource> shaders, const char* name, const ProgramCache& cache);
+
+    // Whether Finish() won't block. Always true without GL_KHR_parallel_shader_compile.
+    bool IsReady() const;
+    // Waits for the program and logs its errors if it failed. A program compiled from source is stored into `cache`, and
+    // one whose cached binary was rejected is compiled from source first. So are the GLSL sources of a program whose SPIR-V
+    // modules fail to link.
+    std::expected<GLuint, ProgramError> Finish(const ProgramCache& cache);
+
+private:
+    void Compile();
+
+    std::vector<ShaderSource> m_sources;
+    std::string m_name;
+    GLuint m_program {};
+    // Empty when loaded from the cache.
+    std::vector<GLuint> m_shaders;
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,174 @@
+#include "render/PostProcessor.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <format>
+
+namespace Glitter::Render {
+
+namespace {
+
+    // Matches PpfxCS.glsl.
+    constexpr GLsizei PPFX_TILE_SIZE = 16;
+
+    // The profiler scope of each pass, whose names must outlive the frame. There are at most 2 passes, one per effect
+    // sampling neighbours.
+    constexpr std::array<const char*, 2> PPFX_PASS_NAMES {"Post-Processing", "Post-Processing 2"};
+
+    // A post-processing effect, enabled in PpfxCS.glsl by the defines named after it.
+    struct Effect {
+        const char* m_name;
+        // Reads its input around each texel, rather than only the texel itself.
+        bool m_samplesNeighbours;
+        bool m_enabled;
+    };
+
+} // namespace
+
+std::vector<std::string> BuildPostProcessPasses(const PostProcessSettings& settings)
+{
+    // In the order they're applied.
+    std::array effects = std::to_array<Effect>({
+        {.m_name = "OIT", .m_samplesNeighbours = false, .m_enabled = settings.m_weightedOit},
+        {.m_name = "BLOOM", .m_samplesNeighbours = true, .m_enabled = settings.m_bloom},
+        {.m_name = "GAMMA", .m_samplesNeighbours = false, .m_enabled = settings.m_gamma != 1.0f},
+        {.m_name = "TONEMAP", .m_samplesNeighbours = false, .m_enabled = settings.m_tonemap},
+        {.m_name = "FXAA", .m_samplesNeighbours = true, .m_enabled = settings.m_fxaa},
+    });
+
+    std::vector<std::string> passes(1);
+    bool sampledNeighbours = false;
+    for (const Effect& effect : effects) {
+        if (!effect.m_enabled) {
+            continue;
+        }
+
+        if (!effect.m_samplesNeighbours) {
+            // Applied to each texel while the tile is loaded, before the pass' effect sampling neighbours, or to its result.
+            passes.back() += std::format("#define PPFX_{}_{}\n", sampledNeighbours ? "STORE" : "LOAD", effect.m_name);
+            continue;
+        }
+
+        if (sampledNeighbours) {
+            // The tile would need the previous effect's output around it, part of which other workgroups compute.
+            passes.back() += "#define PPFX_INTERMEDIATE\n";
+            passes.emplace_back();
+        }
+        passes.back() += std::format("#define PPFX_{}\n", effect.m_name);
+        sampledNeighbours = true;
+    }
+    return passes;
+}
+
+std::vector<std::string> GetPostProcessVariants()
+{
+    std::vector<std::string> variants {};
+    for (std::uint32_t combination = 0; combination < 1 << 5; combination++) {
+        PostProcessSettings settings {
+            .m_gamma = (combination & 1 << 0) != 0 ? 2.0f : 1.0f,
+            .m_tonemap = (combination & 1 << 1) != 0,
+            .m_bloom = (combination & 1 << 2) != 0,
+            .m_fxaa = (combination & 1 << 3) != 0,
+            .m_weightedOit = (combination & 1 << 4) != 0,
+        };
+        for (std::string& pass : BuildPostProcessPasses(settings)) {
+            if (std::ranges::find(variants, pass) == variants.end()) {
+                variants.push_back(std::move(pass));
+            }
+        }
+    }
+    return variants;
+}
+
+void PostProcessor::Create(GLsizei width, GLsizei height)
+{
+    Release();
+
+    m_targetWidth = width;
+    m_targetHeight = height;
+
+    // The output is transient, attached once the present pass knows its texture.
+    glCreateFramebuffers(1, &m_fbo);
+    glObjectLabel(GL_FRAMEBUFFER, m_fbo, -1, "Post-Processing FBO");
+}
+
+void PostProcessor::Release()
+{
+    glDeleteFramebuffers(1, &m_fbo);
+    m_fbo = 0;
+}
+
+void PostProcessor::AddPasses(RenderGraph& graph, const std::map<std::string, GLuint>& programs, RenderResource color,
+    GLsizei width, GLsizei height, const PostProcessSettings& settings, std::optional<WeightedOitTargets> oit,
+    RenderResource backbuffer, GLsizei presentWidth, GLsizei presentHeight, RenderStats& stats, GpuProfiler& profiler)
+{
+    if (settings != m_passSettings) {
+        m_passSettings = settings;
+        m_passes = BuildPostProcessPasses(settings);
+    }
+
+    // A single pass without defines only copies the scene color.
+    bool elide = settings.m_elidePasses && m_passes.size() == 1 && m_passes.front().empty();
+    RenderResource input = color;
+    for (size_t idx = 0; idx < m_passes.size() && !elide; idx++) {
+        // Every pass but the last writes into an intermediate texture, read by the next one. The graph backs them with
+        // the same targets every frame.
+        bool last = idx + 1 == m_passes.size();
+        GLenum outputFormat = last ? GL_RGBA8 : GL_RGBA16F;
+        RenderResource output = graph.CreateTexture(last ? "Post-Processing Output" : "Post-Processing Intermediate",
+            outputFormat, m_targetWidth, m_targetHeight);
+
+        // Every pass is one of GetPostProcessVariants().
+        auto program = programs.find(m_passes[idx]);
+        GLuint passProgram = program != programs.end() ? program->second : 0;
+        const char* name = PPFX_PASS_NAMES[std::min(idx, PPFX_PASS_NAMES.size() - 1)];
+        // The composite is always a load effect of the first pass.
+        std::optional<WeightedOitTargets> passOit = idx == 0 && settings.m_weightedOit ? oit : std::nullopt;
+        RenderPassBuilder pass = graph.AddPass(name,
+            [=, &stats, &profiler](const RenderGraph& run) {
+                profiler.PushGroup(0, name);
+                {
+                    stats.UseProgram(passProgram);
+                    stats.BindTextureUnit(0, run.Get(input));
+                    if (passOit) {
+                        stats.BindTextureUnit(1, run.Get(passOit->m_accumulation));
+                        stats.BindTextureUnit(2, run.Get(passOit->m_revealage));
+                    }
+                    glBindImageTexture(0, run.Get(output), 0, GL_FALSE, 0, GL_WRITE_ONLY, outputFormat);
+
+                    // uniform layout(location = 0) float u_Gamma;
+                    // uniform layout(location = 1) ivec2 u_Size;
+                    glUniform1f(0, settings.m_gamma);
+                    glUniform2i(1, width, height);
+
+                    glDispatchCompute(static_cast<GLuint>((width + PPFX_TILE_SIZE - 1) / PPFX_TILE_SIZE),
+                        static_cast<GLuint>((height + PPFX_TILE_SIZE - 1) / PPFX_TILE_SIZE), 1);
+                }
+                profiler.PopGroup();
+            });
+        pass.Read(input, RenderAccess::TextureFetch).Overwrite(output, RenderAccess::ImageLoadStore);
+        if (passOit) {
+            pass.Read(passOit->m_accumulation, RenderAccess::TextureFetch)
+                .Read(passOit->m_revealage, RenderAccess::TextureFetch);
+        }
+        input = output;
+    }
+
+    graph
+        .AddPass("Present",
+            [=, this, &profiler](const RenderGraph& run) {
+                profiler.PushGroup(0, "Present");
+                {
+                    glNamedFramebufferTexture(m_fbo, GL_COLOR_ATTACHMENT0, run.Get(input), 0);
+                    bool upscale = presentWidth != width || presentHeight != height;
+                    glBlitNamedFramebuffer(m_fbo, run.Get(backbuffer), 0, 0, width, height, 0, 0, presentWidth, presentHeight,
+                        GL_COLOR_BUFFER_BIT, upscale ? GL_LINEAR : GL_NEAREST);
+                }
+                profiler.PopGroup();
+            })
+        .Read(input, RenderAccess::Framebuffer)
+        .Overwrite(backbuffer, RenderAccess::Framebuffer);
+}
+
+} // namespace Glitter::Render
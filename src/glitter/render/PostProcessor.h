@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Config.h"
+#include "render/GpuProfiler.h"
+#include "render/RenderGraph.h"
+#include "render/RenderStats.h"
+
+#include <glad/glad.h>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Glitter::Render {
+
+struct PostProcessSettings {
+    // Multiplies the scene color, before it's tonemapped.
+    float m_gamma {1.0f};
+    // Maps the HDR scene color into [0, 1], instead of clamping it.
+    bool m_tonemap {};
+    // Bleeds the colors above 1 into the nearby texels.
+    bool m_bloom {};
+    // Runs on the final, tonemapped colors.
+    bool m_fxaa {};
+    // Composites the WeightedOitTargets passed to PostProcessor::AddPasses() over the scene color, before anything else.
+    bool m_weightedOit {};
+    // Skips the PpfxCS dispatch when no effect is enabled, presenting the scene color directly. Defaults to
+    // Config::ENABLE_POST_PROCESS_ELISION.
+    bool m_elidePasses {Glitter::Config::ENABLE_POST_PROCESS_ELISION};
+
+    bool operator==(const PostProcessSettings&) const = default;
+};
+
+// The transparent Nodes drawn with weighted blended order-independent transparency: the sum of their weighted
+// premultiplied colors and alphas, and the product of their (1 - alpha), over the same viewport as the scene color.
+struct WeightedOitTargets {
+    RenderResource m_accumulation;
+    RenderResource m_revealage;
+};
+
+// The defines of each PpfxCS dispatch needed to apply the effects enabled in `settings`, in order. The effects are
+// fused into as few dispatches as possible: per-pixel effects are applied to each texel of a workgroup's tile as it's
+// loaded, or before it's stored, so that a new dispatch is only needed where an effect samples the neighbours of a
+// previous one sampling neighbours itself.
+std::vector<std::string> BuildPostProcessPasses(const PostProcessSettings& settings);
+// The defines of every dispatch BuildPostProcessPasses() can return, whatever the settings, so that their programs can
+// all be built upfront.
+std::vector<std::string> GetPostProcessVariants();
+
+// The post-processing stack, as dispatches of the PpfxCS compute program whose workgroups load their tile of the input
+// into shared memory once, so that adding an effect doesn't add a full-screen read and write. The result is written
+// into an RGBA8 image, and then blitted to the default framebuffer, which compute shaders can't write to. The blit also
+// upscales it bilinearly to the window, when the scene is rendered at a lower resolution. Without any effect, the scene
+// color is blitted as is, the blit clamping it like the RGBA8 image would.
+class PostProcessor {
+public:
+    // Sizes the targets for a `width` by `height` scene color target.
+    void Create(GLsizei width, GLsizei height);
+    void Release();
+
+    // Adds the passes running the effects enabled in `settings` over the `width` by `height` viewport of `color` to
+    // `graph`, and the pass presenting the output to `backbuffer` at `presentWidth` by `presentHeight`, binding through
+    // `stats` and timed by `profiler`. `programs` holds the PpfxCS program of each of GetPostProcessVariants(), and must
+    // outlive the graph's run. The viewport must fit in the targets. `oit` is required when `settings` enables
+    // m_weightedOit.
+    void AddPasses(RenderGraph& graph, const std::map<std::string, GLuint>& programs, RenderResource color, GLsizei width,
+        GLsizei height, const PostProcessSettings& settings, std::optional<WeightedOitTargets> oit,
+        RenderResource backbuffer, GLsizei presentWidth, GLsizei presentHeight, RenderStats& stats, GpuProfiler& profiler);
+
+private:
+    GLuint m_fbo {};
+    GLsizei m_targetWidth {};
+    GLsizei m_targetHeight {};
+
+    // The passes of m_passSettings, only built again when the settings change.
+    PostProcessSettings m_passSettings {};
+    std::vector<std::string> m_passes {BuildPostProcessPasses({})};
+};
+
+} // namespace Glitter::Render
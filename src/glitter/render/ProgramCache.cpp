@@ -0,0 +1,154 @@
+#include "render/ProgramCache.h"
+
+#include "util/File.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace Glitter::Render {
+
+namespace {
+
+    // Bump whenever the layout below changes.
+    constexpr std::uint32_t PROGRAM_CACHE_VERSION = 1;
+    constexpr std::array<char, 4> PROGRAM_CACHE_MAGIC {'G', 'L', 'P', 'B'};
+
+    // Followed by the binary.
+    struct CacheHeader {
+        std::array<char, 4> m_magic;
+        std::uint32_t m_version;
+        std::uint64_t m_key;
+        GLenum m_binaryFormat;
+        std::uint32_t m_binarySize;
+    };
+
+    // 64-bit FNV-1a, continued from `hash`.
+    std::uint64_t Hash(std::uint64_t hash, std::span<const std::byte> data)
+    {
+        for (std::byte value : data) {
+            hash = (hash ^ static_cast<std::uint64_t>(value)) * 0x0000'0100'0000'01B3;
+        }
+        return hash;
+    }
+
+    template <typename T> std::uint64_t Hash(std::uint64_t hash, const T& value)
+    {
+        return Hash(hash, std::as_bytes(std::span(&value, 1)));
+    }
+
+    std::uint64_t Hash(std::uint64_t hash, std::string_view string)
+    {
+        // Hash the size too, so that consecutive strings can't shift into each other.
+        return Hash(Hash(hash, string.size()), std::as_bytes(std::span(string)));
+    }
+
+    std::string GetString(GLenum name)
+    {
+        const auto* string = reinterpret_cast<const char*>(glGetString(name));
+        return string ? string : "";
+    }
+
+} // namespace
+
+void ProgramCache::Create(const char* directory)
+{
+    m_directory = directory;
+    m_driver = GetString(GL_VENDOR) + '\n' + GetString(GL_RENDERER) + '\n' + GetString(GL_VERSION);
+
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    m_enabled = formatCount > 0;
+}
+
+std::optional<GLuint> ProgramCache::Load(std::span<const ShaderSource> shaders, const char* name) const
+{
+    if (!m_enabled) {
+        return std::nullopt;
+    }
+
+    std::uint64_t key = GetKey(shaders);
+    std::optional<Util::MappedFile> mappedFile = Util::MappedFile::Open(GetPath(key).c_str());
+    if (!mappedFile) {
+        return std::nullopt;
+    }
+    std::span<const std::byte> file = mappedFile->GetData();
+
+    CacheHeader header {};
+    if (file.size() < sizeof(CacheHeader)) {
+        return std::nullopt;
+    }
+    std::memcpy(&header, file.data(), sizeof(CacheHeader));
+    if (header.m_magic != PROGRAM_CACHE_MAGIC || header.m_version != PROGRAM_CACHE_VERSION || header.m_key != key
+        || header.m_binarySize != file.size() - sizeof(CacheHeader)) {
+        return std::nullopt;
+    }
+
+    GLuint program = glCreateProgram();
+    glObjectLabel(GL_PROGRAM, program, -1, name);
+    glProgramBinary(program, header.m_binaryFormat, file.data() + sizeof(CacheHeader), static_cast<GLsizei>(header.m_binarySize));
+    return program;
+}
+
+void ProgramCache::Store(GLuint program, std::span<const ShaderSource> shaders) const
+{
+    if (!m_enabled) {
+        return;
+    }
+
+    GLint binarySize = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+    if (binarySize <= 0) {
+        return;
+    }
+
+    std::uint64_t key = GetKey(shaders);
+    std::vector<std::byte> file(sizeof(CacheHeader) + static_cast<size_t>(binarySize));
+    GLenum binaryFormat = 0;
+    GLsizei writtenSize = 0;
+    glGetProgramBinary(program, binarySize, &writtenSize, &binaryFormat, file.data() + sizeof(CacheHeader));
+    if (writtenSize != binarySize) {
+        return;
+    }
+
+    CacheHeader header {
+        .m_magic = PROGRAM_CACHE_MAGIC,
+        .m_version = PROGRAM_CACHE_VERSION,
+        .m_key = key,
+        .m_binaryFormat = binaryFormat,
+        .m_binarySize = static_cast<std::uint32_t>(binarySize),
+    };
+    std::memcpy(file.data(), &header, sizeof(CacheHeader));
+
+    std::error_code error {};
+    std::filesystem::create_directories(m_directory, error);
+    std::string path = GetPath(key);
+    std::ofstream outputStream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    outputStream.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    if (!outputStream) {
+        spdlog::warn("Failed to write the program binary <{}>.", path);
+    }
+}
+
+std::uint64_t ProgramCache::GetKey(std::span<const ShaderSource> shaders) const
+{
+    std::uint64_t key = Hash(0xCBF2'9CE4'8422'2325, std::string_view(m_driver));
+    for (const ShaderSource& shader : shaders) {
+        key = Hash(Hash(key, shader.m_type), std::string_view(shader.m_source));
+        key = Hash(Hash(key, shader.m_spirv.size()), std::span<const std::byte>(shader.m_spirv));
+        for (const SpecializationConstant& constant : shader.m_constants) {
+            key = Hash(Hash(key, constant.m_id), constant.m_value);
+        }
+    }
+    return key;
+}
+
+std::string ProgramCache::GetPath(std::uint64_t key) const { return std::format("{}/{:016x}.bin", m_directory, key); }
+
+} // namespace Glitter::Render
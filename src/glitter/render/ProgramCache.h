@@ -0,0 +1,56 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Glitter::Render {
+
+// `m_value` holds the bits of the constant, whatever its type.
+struct SpecializationConstant {
+    GLuint m_id;
+    GLuint m_value;
+};
+
+struct ShaderSource {
+    GLenum m_type;
+    // The full source, with its defines already injected.
+    std::string m_source;
+    // A SPIR-V module built from the same source and defines, used instead of it when not empty.
+    std::vector<std::byte> m_spirv {};
+    // Applied to m_spirv with glSpecializeShader(). m_source has their values as defines already.
+    std::vector<SpecializationConstant> m_constants {};
+};
+
+// Program binaries saved with glGetProgramBinary(), one file per program keyed by the hash of its shaders' sources and
+// of the driver's vendor, renderer and version strings. A driver update or an edited shader misses the cache, as does a
+// binary the driver rejects, and the program is then compiled from source and stored again.
+class ProgramCache {
+public:
+    // Reads the driver strings, so must be called with a current context. Stays disabled if the driver supports no
+    // binary formats.
+    void Create(const char* directory);
+
+    bool IsEnabled() const { return m_enabled; }
+
+    // std::nullopt on a miss, without logging. The driver can still reject the binary, which the program's GL_LINK_STATUS
+    // tells, but querying it waits for the program to be loaded.
+    std::optional<GLuint> Load(std::span<const ShaderSource> shaders, const char* name) const;
+    // `program` must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+    void Store(GLuint program, std::span<const ShaderSource> shaders) const;
+
+private:
+    std::uint64_t GetKey(std::span<const ShaderSource> shaders) const;
+    std::string GetPath(std::uint64_t key) const;
+
+    std::string m_directory;
+    std::string m_driver;
+    bool m_enabled {};
+};
+
+} // namespace Glitter::Render
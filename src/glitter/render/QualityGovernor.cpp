@@ -0,0 +1,91 @@
+#include "render/QualityGovernor.h"
+
+#include "Config.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace Glitter::Render {
+
+namespace {
+
+    // The LODs and the draw distance go first, which cost the least to the image, then the shadow map's resolution and
+    // the post effects.
+    constexpr std::array<QualityLevel, 5> QUALITY_LEVELS {{
+        {.m_lodBias = 0.0f,
+            .m_drawDistanceScale = 1.0f,
+            .m_shadowMapSize = Config::SHADOW_MAP_SIZE,
+            .m_bloom = true,
+            .m_fxaa = true},
+        {.m_lodBias = 1.0f,
+            .m_drawDistanceScale = 0.8f,
+            .m_shadowMapSize = Config::SHADOW_MAP_SIZE,
+            .m_bloom = true,
+            .m_fxaa = true},
+        {.m_lodBias = 1.0f,
+            .m_drawDistanceScale = 0.65f,
+            .m_shadowMapSize = Config::SHADOW_MAP_SIZE / 2,
+            .m_bloom = true,
+            .m_fxaa = true},
+        {.m_lodBias = 2.0f,
+            .m_drawDistanceScale = 0.5f,
+            .m_shadowMapSize = Config::SHADOW_MAP_SIZE / 2,
+            .m_bloom = false,
+            .m_fxaa = true},
+        {.m_lodBias = 2.0f,
+            .m_drawDistanceScale = 0.4f,
+            .m_shadowMapSize = Config::SHADOW_MAP_SIZE / 4,
+            .m_bloom = false,
+            .m_fxaa = false},
+    }};
+
+} // namespace
+
+bool QualityGovernor::Update(double cpuMilliseconds, double gpuMilliseconds)
+{
+    m_framesSinceChange++;
+    double milliseconds = std::max(cpuMilliseconds, gpuMilliseconds);
+    if (milliseconds <= 0.0) {
+        return false;
+    }
+
+    // Only frames on the same side of the target in a row count, a single spike doesn't lower the quality.
+    double target = Config::QUALITY_GOVERNOR_TARGET_MS;
+    m_framesOver = milliseconds > target ? m_framesOver + 1 : 0;
+    m_framesUnder = milliseconds < target * Config::QUALITY_GOVERNOR_HEADROOM ? m_framesUnder + 1 : 0;
+    if (m_framesSinceChange < Config::DYNAMIC_RESOLUTION_SETTLE_FRAMES) {
+        return false;
+    }
+
+    size_t level = m_level;
+    if (m_framesOver >= Config::QUALITY_GOVERNOR_DEGRADE_FRAMES) {
+        level = std::min(m_level + 1, QUALITY_LEVELS.size() - 1);
+    } else if (m_framesUnder >= Config::QUALITY_GOVERNOR_RECOVER_FRAMES && m_level > 0) {
+        level = m_level - 1;
+    }
+    if (level == m_level) {
+        return false;
+    }
+
+    m_level = level;
+    m_framesSinceChange = 0;
+    m_framesOver = 0;
+    m_framesUnder = 0;
+    return true;
+}
+
+bool QualityGovernor::Reset()
+{
+    m_framesSinceChange = 0;
+    m_framesOver = 0;
+    m_framesUnder = 0;
+    return std::exchange(m_level, size_t {0}) != 0;
+}
+
+std::span<const QualityLevel> QualityGovernor::GetLevels()
+{
+    return QUALITY_LEVELS;
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <span>
+
+namespace Glitter::Render {
+
+// A step of QualityGovernor, each cheaper than the one before.
+struct QualityLevel {
+    // Halves the pixels a Node's bounds are taken to project to per unit, when picking its LOD.
+    float m_lodBias;
+    // Of the draw distance, with contribution culling.
+    float m_drawDistanceScale;
+    GLsizei m_shadowMapSize;
+    // Turn the post effects off when false, whatever they're set to.
+    bool m_bloom;
+    bool m_fxaa;
+};
+
+// Steps the rendering quality down through its levels while the frame time is above Config::QUALITY_GOVERNOR_TARGET_MS,
+// and back up once it's well below. The frame time is the slower of the CPU's and the GPU's, since either can hold the
+// frame. Against flickering between two levels, a level is only left after the frame time stayed on the same side of
+// the target for a run of frames, a longer one to step back up, and never within Config::DYNAMIC_RESOLUTION_SETTLE_FRAMES
+// of the last change, so that the timings read back are of the new level.
+class QualityGovernor {
+public:
+    // Feeds the times of the latest frame read back, and tells whether the level changed.
+    bool Update(double cpuMilliseconds, double gpuMilliseconds);
+    // Back to the best level, tells whether the level changed.
+    bool Reset();
+
+    size_t GetLevelIndex() const { return m_level; }
+    const QualityLevel& GetLevel() const { return GetLevels()[m_level]; }
+    // Every level, the best first.
+    static std::span<const QualityLevel> GetLevels();
+
+private:
+    size_t m_level {};
+    size_t m_framesSinceChange {};
+    // The length of the current run of frames above the target, or below its headroom.
+    size_t m_framesOver {};
+    size_t m_framesUnder {};
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,286 @@
+#include "render/RenderGraph.h"
+
+#include <algorithm>
+#include <array>
+#include <ranges>
+
+namespace Glitter::Render {
+
+namespace {
+
+    GLbitfield GetBarrier(RenderAccess access)
+    {
+        switch (access) {
+        case RenderAccess::TextureFetch:
+            return GL_TEXTURE_FETCH_BARRIER_BIT;
+        case RenderAccess::ImageLoadStore:
+            return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+        case RenderAccess::ShaderStorage:
+            return GL_SHADER_STORAGE_BARRIER_BIT;
+        case RenderAccess::Command:
+            return GL_COMMAND_BARRIER_BIT;
+        case RenderAccess::Framebuffer:
+            return GL_FRAMEBUFFER_BARRIER_BIT;
+        }
+        return 0;
+    }
+
+    bool IsIncoherent(RenderAccess access)
+    {
+        return access == RenderAccess::ImageLoadStore || access == RenderAccess::ShaderStorage;
+    }
+
+} // namespace
+
+RenderPassBuilder& RenderPassBuilder::Read(RenderResource resource, RenderAccess access)
+{
+    m_graph.m_passes[m_pass].m_accesses.push_back(
+        {.m_resource = resource.m_index, .m_access = access, .m_write = false, .m_overwrite = false});
+    return *this;
+}
+
+RenderPassBuilder& RenderPassBuilder::Write(RenderResource resource, RenderAccess access)
+{
+    m_graph.m_passes[m_pass].m_accesses.push_back(
+        {.m_resource = resource.m_index, .m_access = access, .m_write = true, .m_overwrite = false});
+    return *this;
+}
+
+RenderPassBuilder& RenderPassBuilder::Overwrite(RenderResource resource, RenderAccess access)
+{
+    m_graph.m_passes[m_pass].m_accesses.push_back(
+        {.m_resource = resource.m_index, .m_access = access, .m_write = true, .m_overwrite = true});
+    return *this;
+}
+
+void RenderGraph::Reset(std::pmr::memory_resource* arena)
+{
+    m_resources.clear();
+    m_passes.clear();
+    m_arena = arena;
+}
+
+RenderResource RenderGraph::Import(RenderResourceType type, GLuint object)
+{
+    auto barriers = m_importedBarriers.find(GetImportKey(type, object));
+    m_resources.push_back(Resource {
+        .m_type = type,
+        .m_object = object,
+        .m_imported = true,
+        .m_kept = false,
+        .m_discarded = false,
+        .m_fbo = 0,
+        .m_attachment = GL_NONE,
+        .m_name = nullptr,
+        .m_target = {},
+        .m_pendingBarriers = barriers != m_importedBarriers.end() ? barriers->second : 0,
+        .m_firstPass = 0,
+        .m_lastPass = 0,
+    });
+    return RenderResource {.m_index = static_cast<std::uint32_t>(m_resources.size() - 1)};
+}
+
+RenderResource RenderGraph::CreateTexture(const char* name, GLenum format, GLsizei width, GLsizei height, GLsizei levels)
+{
+    m_resources.push_back(Resource {
+        .m_type = RenderResourceType::Texture,
+        .m_object = 0,
+        .m_imported = false,
+        .m_kept = false,
+        .m_discarded = true,
+        .m_fbo = 0,
+        .m_attachment = GL_NONE,
+        .m_name = name,
+        .m_target = {.m_texture = 0, .m_format = format, .m_width = width, .m_height = height, .m_levels = levels},
+        .m_pendingBarriers = 0,
+        .m_firstPass = 0,
+        .m_lastPass = 0,
+    });
+    return RenderResource {.m_index = static_cast<std::uint32_t>(m_resources.size() - 1)};
+}
+
+void RenderGraph::Keep(RenderResource resource) { m_resources[resource.m_index].m_kept = true; }
+
+void RenderGraph::Discard(RenderResource resource, GLuint fbo, GLenum attachment)
+{
+    Resource& discarded = m_resources[resource.m_index];
+    discarded.m_discarded = true;
+    discarded.m_fbo = fbo;
+    discarded.m_attachment = attachment;
+}
+
+RenderPassBuilder RenderGraph::AddPass(const char* name, Execute execute)
+{
+    m_passes.push_back(
+        Pass {.m_name = name, .m_execute = std::move(execute), .m_accesses = std::pmr::vector<Access>(m_arena), .m_live = false});
+    return RenderPassBuilder(*this, m_passes.size() - 1);
+}
+
+void RenderGraph::Cull()
+{
+    // From the last pass back, a pass is live if it writes a resource that's kept, or read by a later live pass. A write
+    // doesn't end the need for the earlier ones, since a pass can only write part of a resource.
+    std::pmr::vector<bool> needed(m_resources.size(), m_arena);
+    for (size_t idx = 0; idx < m_resources.size(); idx++) {
+        needed[idx] = m_resources[idx].m_kept;
+    }
+
+    for (Pass& pass : m_passes | std::views::reverse) {
+        pass.m_live = std::ranges::any_of(
+            pass.m_accesses, [&](const Access& access) { return access.m_write && needed[access.m_resource]; });
+        if (!pass.m_live) {
+            continue;
+        }
+        for (const Access& access : pass.m_accesses) {
+            if (!access.m_write) {
+                needed[access.m_resource] = true;
+            }
+        }
+    }
+}
+
+void RenderGraph::IssueBarriers(const Pass& pass)
+{
+    GLbitfield barriers = 0;
+    for (const Access& access : pass.m_accesses) {
+        barriers |= m_resources[access.m_resource].m_pendingBarriers & GetBarrier(access.m_access);
+    }
+    if (barriers == 0) {
+        return;
+    }
+
+    // A barrier covers every write issued before it, not only the resource's.
+    glMemoryBarrier(barriers);
+    for (Resource& resource : m_resources) {
+        resource.m_pendingBarriers &= ~barriers;
+    }
+    for (auto& [key, pendingBarriers] : m_importedBarriers) {
+        pendingBarriers &= ~barriers;
+    }
+}
+
+void RenderGraph::Invalidate(const Resource& resource)
+{
+    m_stats.m_invalidations++;
+    if (resource.m_attachment != GL_NONE) {
+        glInvalidateNamedFramebufferData(resource.m_fbo, 1, &resource.m_attachment);
+        return;
+    }
+
+    switch (resource.m_type) {
+    case RenderResourceType::Texture:
+        glInvalidateTexImage(resource.m_object, 0);
+        break;
+    case RenderResourceType::Buffer:
+        glInvalidateBufferData(resource.m_object);
+        break;
+    case RenderResourceType::Framebuffer:
+        if (resource.m_object == 0) {
+            std::array<GLenum, 3> attachments {GL_COLOR, GL_DEPTH, GL_STENCIL};
+            glInvalidateNamedFramebufferData(0, static_cast<GLsizei>(attachments.size()), attachments.data());
+        } else {
+            GLenum attachment = GL_COLOR_ATTACHMENT0;
+            glInvalidateNamedFramebufferData(resource.m_object, 1, &attachment);
+        }
+        break;
+    }
+}
+
+void RenderGraph::Run(RenderTargetPool& pool)
+{
+    Cull();
+
+    m_stats = {};
+    m_stats.m_passes = m_passes.size();
+    for (size_t passIdx = 0; passIdx < m_passes.size(); passIdx++) {
+        const Pass& pass = m_passes[passIdx];
+        if (!pass.m_live) {
+            m_stats.m_culledPasses.push_back(pass.m_name);
+            continue;
+        }
+        for (const Access& access : pass.m_accesses) {
+            Resource& resource = m_resources[access.m_resource];
+            if (resource.m_lastPass == 0) {
+                resource.m_firstPass = passIdx + 1;
+            }
+            resource.m_lastPass = passIdx + 1;
+        }
+    }
+
+    for (size_t passIdx = 0; passIdx < m_passes.size(); passIdx++) {
+        const Pass& pass = m_passes[passIdx];
+        if (!pass.m_live) {
+            continue;
+        }
+
+        // Back the transient textures first accessed by this pass, with a target released earlier this frame if there's
+        // one that matches. The lifetimes are 1-based, 0 meaning not accessed by a live pass.
+        for (const Access& access : pass.m_accesses) {
+            Resource& resource = m_resources[access.m_resource];
+            if (resource.m_imported || resource.m_object != 0 || resource.m_firstPass != passIdx + 1) {
+                continue;
+            }
+
+            m_stats.m_transientTextures++;
+            RenderTarget& target = resource.m_target;
+            auto free = std::ranges::find_if(m_freeTargets, [&](const RenderTarget& freeTarget) {
+                return freeTarget.m_format == target.m_format && freeTarget.m_width == target.m_width
+                    && freeTarget.m_height == target.m_height && freeTarget.m_levels == target.m_levels;
+            });
+            if (free != m_freeTargets.end()) {
+                target = *free;
+                m_freeTargets.erase(free);
+            } else {
+                target = pool.Acquire(target.m_format, target.m_width, target.m_height, target.m_levels, resource.m_name);
+                m_stats.m_transientTargets++;
+            }
+            resource.m_object = target.m_texture;
+        }
+
+        for (const Access& access : pass.m_accesses) {
+            if (access.m_overwrite) {
+                Invalidate(m_resources[access.m_resource]);
+            }
+        }
+
+        IssueBarriers(pass);
+        pass.m_execute(*this);
+
+        for (const Access& access : pass.m_accesses) {
+            Resource& resource = m_resources[access.m_resource];
+            if (access.m_write && IsIncoherent(access.m_access)) {
+                resource.m_pendingBarriers = ALL_BARRIERS;
+            }
+        }
+
+        // Invalidate the discarded resources last accessed by this pass, and free the targets of the transient textures
+        // among them for the following ones. A resource accessed twice by the pass is only handled once.
+        for (const Access& access : pass.m_accesses) {
+            Resource& resource = m_resources[access.m_resource];
+            if (resource.m_lastPass != passIdx + 1) {
+                continue;
+            }
+            if (resource.m_discarded && !resource.m_kept) {
+                Invalidate(resource);
+                resource.m_discarded = false;
+            }
+            if (!resource.m_imported && resource.m_object != 0) {
+                m_freeTargets.push_back(resource.m_target);
+                resource.m_object = 0;
+            }
+        }
+    }
+
+    for (RenderTarget& target : m_freeTargets) {
+        pool.Release(target);
+    }
+    m_freeTargets.clear();
+
+    for (const Resource& resource : m_resources) {
+        if (resource.m_imported) {
+            m_importedBarriers[GetImportKey(resource.m_type, resource.m_object)] = resource.m_pendingBarriers;
+        }
+    }
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "render/RenderTargetPool.h"
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+namespace Glitter::Render {
+
+// A texture or buffer of a RenderGraph, valid until its next Reset().
+struct RenderResource {
+    std::uint32_t m_index;
+};
+
+enum class RenderResourceType : std::uint8_t {
+    Texture,
+    Buffer,
+    // The default framebuffer 0, or the FBO standing in for it with its color as the only attachment.
+    Framebuffer,
+};
+
+// How a pass accesses a resource. Image and shader storage writes aren't coherent with the following commands, so they
+// need the barrier of each access reading them afterwards.
+enum class RenderAccess : std::uint8_t {
+    // Sampled through a texture unit.
+    TextureFetch,
+    ImageLoadStore,
+    ShaderStorage,
+    // Indirect draw or dispatch parameters.
+    Command,
+    // Attached to the drawn framebuffer, or blitted.
+    Framebuffer,
+};
+
+struct RenderGraphStats {
+    size_t m_passes;
+    std::vector<const char*> m_culledPasses;
+    size_t m_transientTextures;
+    // Textures backing the transient ones, fewer when some of them share one.
+    size_t m_transientTargets;
+    // Resources whose contents were invalidated, before being overwritten or after their last access.
+    size_t m_invalidations;
+};
+
+class RenderGraph;
+
+// Declares the resources accessed by a pass that was just added to a RenderGraph.
+class RenderPassBuilder {
+public:
+    RenderPassBuilder& Read(RenderResource resource, RenderAccess access);
+    RenderPassBuilder& Write(RenderResource resource, RenderAccess access);
+    // Like Write(), for a pass overwriting every texel of `resource`, or clearing it, without reading it first. Its
+    // previous contents are invalidated before the pass, sparing tile-based GPUs loading them.
+    RenderPassBuilder& Overwrite(RenderResource resource, RenderAccess access);
+
+private:
+    friend class RenderGraph;
+
+    RenderPassBuilder(RenderGraph& graph, size_t pass)
+        : m_graph(graph)
+        , m_pass(pass)
+    {
+    }
+
+    RenderGraph& m_graph;
+    size_t m_pass;
+};
+
+// The GPU passes of a frame, in submission order, along with the resources each of them reads and writes. Executing it
+// skips the passes whose writes are never read by a later pass nor kept, issues the glMemoryBarrier() needed before
+// each access to a resource written incoherently, and backs the transient textures with targets of a RenderTargetPool
+// for their lifetime only, so that transient textures of the same format, size and levels whose lifetimes don't overlap
+// share a texture. GL has no way to alias the memory of different textures, so this is as close as it gets.
+//
+// Barriers between the commands of a same pass are left to the pass. The pending barriers of imported resources carry
+// over to the next frames.
+//
+// The contents of transient textures are invalidated after their last access, and those of imported resources too when
+// they're discarded, so that the GPU doesn't write them back to memory.
+class RenderGraph {
+public:
+    using Execute = std::function<void(const RenderGraph& graph)>;
+
+    // Starts a new frame, forgetting the previous one's passes and resources. The frame's bookkeeping is allocated from
+    // `arena`, which must outlive the next Reset().
+    void Reset(std::pmr::memory_resource* arena = std::pmr::get_default_resource());
+
+    // A resource owned outside the graph.
+    RenderResource Import(RenderResourceType type, GLuint object);
+    // A `width` by `height` texture of `format` and `levels` levels, only valid during the passes accessing it. The levels
+    // past the first are left to the passes, see MipGenerator::AddPass().
+    RenderResource CreateTexture(const char* name, GLenum format, GLsizei width, GLsizei height, GLsizei levels = 1);
+    // Marks `resource` as read outside the graph, e.g. presented or read by the next frame, so that the passes writing
+    // it are never skipped.
+    void Keep(RenderResource resource);
+    // Marks the contents of the imported `resource` as no longer needed once the last pass accessing it has run. A texture
+    // attached to `fbo` at `attachment` is invalidated through it, which drivers act on more readily than
+    // glInvalidateTexImage().
+    void Discard(RenderResource resource, GLuint fbo = 0, GLenum attachment = GL_NONE);
+
+    RenderPassBuilder AddPass(const char* name, Execute execute);
+
+    // Runs the passes added since Reset(), backing the transient textures with targets of `pool`.
+    void Run(RenderTargetPool& pool);
+
+    // The object of `resource`, only valid for transient textures while the passes accessing it run.
+    GLuint Get(RenderResource resource) const { return m_resources[resource.m_index].m_object; }
+
+    // Of the latest Run().
+    const RenderGraphStats& GetStats() const { return m_stats; }
+
+private:
+    friend class RenderPassBuilder;
+
+    // Every barrier an access can need after an incoherent write.
+    static constexpr GLbitfield ALL_BARRIERS = GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT
+        | GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT;
+
+    struct Resource {
+        RenderResourceType m_type;
+        GLuint m_object;
+        bool m_imported;
+        bool m_kept;
+        bool m_discarded;
+        // The framebuffer attachment it's invalidated through, if any.
+        GLuint m_fbo;
+        GLenum m_attachment;
+        // For transient textures, whose m_object is their target's texture while it's alive.
+        const char* m_name;
+        RenderTarget m_target;
+        // The barriers still needed before reading it, after an incoherent write.
+        GLbitfield m_pendingBarriers;
+        // The first and last live passes accessing it during Run(), from 1, 0 if none does.
+        size_t m_firstPass;
+        size_t m_lastPass;
+    };
+
+    struct Access {
+        std::uint32_t m_resource;
+        RenderAccess m_access;
+        bool m_write;
+        bool m_overwrite;
+    };
+
+    struct Pass {
+        const char* m_name;
+        Execute m_execute;
+        std::pmr::vector<Access> m_accesses;
+        bool m_live;
+    };
+
+    static std::uint64_t GetImportKey(RenderResourceType type, GLuint object)
+    {
+        return static_cast<std::uint64_t>(type) << 32 | object;
+    }
+
+    void Cull();
+    // Issues the barriers needed before the accesses of `pass`.
+    void IssueBarriers(const Pass& pass);
+    void Invalidate(const Resource& resource);
+
+    std::pmr::memory_resource* m_arena {std::pmr::get_default_resource()};
+    std::vector<Resource> m_resources;
+    std::vector<Pass> m_passes;
+    // The pending barriers of the imported resources, by GetImportKey().
+    std::unordered_map<std::uint64_t, GLbitfield> m_importedBarriers;
+    // Released by a transient texture during Run(), for a later one of the same format and size.
+    std::vector<RenderTarget> m_freeTargets;
+    RenderGraphStats m_stats {};
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,158 @@
+#include "render/RenderStats.h"
+
+#include <algorithm>
+
+namespace Glitter::Render {
+
+namespace {
+
+    constexpr std::array TRACKED_BUFFER_TARGETS
+        = std::to_array<GLenum>({GL_DRAW_INDIRECT_BUFFER, GL_PARAMETER_BUFFER, GL_DISPATCH_INDIRECT_BUFFER});
+
+} // namespace
+
+void RenderStats::Create()
+{
+    InvalidateState();
+    for (size_t targetIdx = 0; targetIdx < QUERY_TARGETS.size(); targetIdx++) {
+        for (Frame& frame : m_frames) {
+            glCreateQueries(QUERY_TARGETS[targetIdx], 1, &frame.m_queries[targetIdx]);
+        }
+    }
+}
+
+void RenderStats::Release()
+{
+    for (Frame& frame : m_frames) {
+        glDeleteQueries(static_cast<GLsizei>(frame.m_queries.size()), frame.m_queries.data());
+        frame = Frame {};
+    }
+}
+
+void RenderStats::BeginFrame()
+{
+    m_lastCounters = m_counters;
+    m_counters = RenderCounters {};
+    InvalidateState();
+
+    m_currentFrame = (m_currentFrame + 1) % m_frames.size();
+    Frame& frame = m_frames[m_currentFrame];
+    if (!frame.m_pending) {
+        return;
+    }
+    frame.m_pending = false;
+
+    // Keep the previous results rather than waiting for the GPU.
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(frame.m_queries.back(), GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE) {
+        return;
+    }
+
+    std::array<GLuint64, QUERY_TARGETS.size()> results {};
+    for (size_t targetIdx = 0; targetIdx < QUERY_TARGETS.size(); targetIdx++) {
+        glGetQueryObjectui64v(frame.m_queries[targetIdx], GL_QUERY_RESULT, &results[targetIdx]);
+    }
+    m_pipelineStatistics = PipelineStatistics {.m_primitivesSubmitted = static_cast<size_t>(results[0]),
+        .m_vertexShaderInvocations = static_cast<size_t>(results[1]),
+        .m_clippingInputPrimitives = static_cast<size_t>(results[2]),
+        .m_clippingOutputPrimitives = static_cast<size_t>(results[3]),
+        .m_fragmentShaderInvocations = static_cast<size_t>(results[4])};
+}
+
+void RenderStats::InvalidateState()
+{
+    BufferRange unknownRange {.m_buffer = UNKNOWN, .m_offset = 0, .m_size = 0};
+    m_program = UNKNOWN;
+    m_vertexArray = UNKNOWN;
+    m_buffers.fill(UNKNOWN);
+    m_uniformBuffers.fill(unknownRange);
+    m_storageBuffers.fill(unknownRange);
+    m_textures.fill(UNKNOWN);
+    m_depthMask = UNKNOWN;
+    m_depthFunc = UNKNOWN;
+    m_blendFunc = BlendState {UNKNOWN, UNKNOWN};
+}
+
+void RenderStats::BindBuffer(GLenum target, GLuint buffer)
+{
+    static_assert(TRACKED_BUFFER_TARGETS.size() == TRACKED_TARGETS);
+    const auto* tracked = std::ranges::find(TRACKED_BUFFER_TARGETS, target);
+    if (tracked != TRACKED_BUFFER_TARGETS.end() && Skip(m_buffers[tracked - TRACKED_BUFFER_TARGETS.begin()], buffer)) {
+        return;
+    }
+    GLITTER_COUNT(m_counters.m_bufferBinds++);
+    glBindBuffer(target, buffer);
+}
+
+void RenderStats::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+    if (SkipIndexed(target, index, BufferRange {.m_buffer = buffer, .m_offset = 0, .m_size = -1})) {
+        return;
+    }
+    GLITTER_COUNT(m_counters.m_bufferBinds++);
+    glBindBufferBase(target, index, buffer);
+}
+
+void RenderStats::BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    if (SkipIndexed(target, index, BufferRange {.m_buffer = buffer, .m_offset = offset, .m_size = size})) {
+        return;
+    }
+    GLITTER_COUNT(m_counters.m_bufferBinds++);
+    glBindBufferRange(target, index, buffer, offset, size);
+}
+
+void RenderStats::BindTextureUnit(GLuint unit, GLuint texture)
+{
+    if (unit < m_textures.size() && Skip(m_textures[unit], texture)) {
+        return;
+    }
+    GLITTER_COUNT(m_counters.m_textureBinds++);
+    glBindTextureUnit(unit, texture);
+}
+
+bool RenderStats::SkipIndexed(GLenum target, GLuint index, const BufferRange& range)
+{
+    std::array<BufferRange, TRACKED_BINDINGS>* bindings = nullptr;
+    if (target == GL_UNIFORM_BUFFER) {
+        bindings = &m_uniformBuffers;
+    } else if (target == GL_SHADER_STORAGE_BUFFER) {
+        bindings = &m_storageBuffers;
+    }
+    if (!bindings || index >= bindings->size()) {
+        return false;
+    }
+
+    BufferRange& tracked = (*bindings)[index];
+    if (tracked == range) {
+        GLITTER_COUNT(m_counters.m_redundantCalls++);
+        return true;
+    }
+    tracked = range;
+    return false;
+}
+
+void RenderStats::BeginPipelineQueries()
+{
+    if constexpr (!Config::ENABLE_PROFILING) {
+        return;
+    }
+    Frame& frame = m_frames[m_currentFrame];
+    for (size_t targetIdx = 0; targetIdx < QUERY_TARGETS.size(); targetIdx++) {
+        glBeginQuery(QUERY_TARGETS[targetIdx], frame.m_queries[targetIdx]);
+    }
+}
+
+void RenderStats::EndPipelineQueries()
+{
+    if constexpr (!Config::ENABLE_PROFILING) {
+        return;
+    }
+    for (GLenum target : QUERY_TARGETS) {
+        glEndQuery(target);
+    }
+    m_frames[m_currentFrame].m_pending = true;
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "Config.h"
+#include "core/Instrumentation.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+
+namespace Glitter::Render {
+
+struct RenderCounters {
+    size_t m_drawCalls;
+    // Commands submitted through indirect draws, or 1 per direct draw.
+    size_t m_drawCommands;
+    // Only counts the commands built on the CPU, the GPU-culled ones show up in the pipeline statistics instead.
+    size_t m_triangles;
+    size_t m_programBinds;
+    size_t m_vertexArrayBinds;
+    size_t m_bufferBinds;
+    size_t m_textureBinds;
+    size_t m_stateChanges;
+    // The binds and state changes skipped for not changing what was already bound or set.
+    size_t m_redundantCalls;
+    size_t m_uploadedBytes;
+};
+
+// GL_ARB_pipeline_statistics_query results, core since GL 4.6.
+struct PipelineStatistics {
+    size_t m_primitivesSubmitted;
+    size_t m_vertexShaderInvocations;
+    size_t m_clippingInputPrimitives;
+    size_t m_clippingOutputPrimitives;
+    size_t m_fragmentShaderInvocations;
+};
+
+// Counts the draws, state changes and uploads of each frame as they're issued through it, from
+// Config::InstrumentationLevel::Counters up, and samples the pipeline statistics of the passes between BeginPipelineQueries()
+// and EndPipelineQueries() at Full. The queries of each frame in flight are only read back Glitter::Config::FRAMES_IN_FLIGHT
+// frames later, so this never stalls on the GPU.
+//
+// It also tracks the state set through it, and skips the calls that wouldn't change it. State changed behind its back,
+// by calling GL directly or deleting a bound object, isn't seen: InvalidateState() must follow it before the next call
+// through it. Every frame starts from an invalidated state.
+class RenderStats {
+public:
+    void Create();
+    void Release();
+
+    // Keeps the counters of the previous frame, reads back the oldest pipeline statistics and starts a new frame.
+    void BeginFrame();
+
+    void BeginPipelineQueries();
+    void EndPipelineQueries();
+
+    // Forgets the tracked state, so that the next call of each kind goes through.
+    void InvalidateState();
+
+    void UseProgram(GLuint program)
+    {
+        if (Skip(m_program, program)) {
+            return;
+        }
+        GLITTER_COUNT(m_counters.m_programBinds++);
+        glUseProgram(program);
+    }
+    void BindVertexArray(GLuint vertexArray)
+    {
+        if (Skip(m_vertexArray, vertexArray)) {
+            return;
+        }
+        GLITTER_COUNT(m_counters.m_vertexArrayBinds++);
+        glBindVertexArray(vertexArray);
+    }
+    void BindBuffer(GLenum target, GLuint buffer);
+    void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+    void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    void BindTextureUnit(GLuint unit, GLuint texture);
+
+    void DepthMask(GLboolean enabled)
+    {
+        if (Skip(m_depthMask, static_cast<GLuint>(enabled))) {
+            return;
+        }
+        GLITTER_COUNT(m_counters.m_stateChanges++);
+        glDepthMask(enabled);
+    }
+    void DepthFunc(GLenum func)
+    {
+        if (Skip(m_depthFunc, func)) {
+            return;
+        }
+        GLITTER_COUNT(m_counters.m_stateChanges++);
+        glDepthFunc(func);
+    }
+    // The blend function of every draw buffer. BlendFunci() sets a single one's, which isn't tracked.
+    void BlendFunc(GLenum source, GLenum destination)
+    {
+        if (m_blendFunc == BlendState {source, destination}) {
+            GLITTER_COUNT(m_counters.m_redundantCalls++);
+            return;
+        }
+        m_blendFunc = BlendState {source, destination};
+        GLITTER_COUNT(m_counters.m_stateChanges++);
+        glBlendFunc(source, destination);
+    }
+    void BlendFunci(GLuint drawBuffer, GLenum source, GLenum destination)
+    {
+        m_blendFunc = BlendState {UNKNOWN, UNKNOWN};
+        GLITTER_COUNT(m_counters.m_stateChanges++);
+        glBlendFunci(drawBuffer, source, destination);
+    }
+    void NamedBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data)
+    {
+        GLITTER_COUNT(m_counters.m_uploadedBytes += static_cast<size_t>(size));
+        glNamedBufferSubData(buffer, offset, size, data);
+    }
+
+    // Counts a draw call submitting `commands` commands and `triangles` triangles.
+    void CountDraw(size_t commands, size_t triangles)
+    {
+        GLITTER_COUNT(m_counters.m_drawCalls++);
+        GLITTER_COUNT(m_counters.m_drawCommands += commands);
+        GLITTER_COUNT(m_counters.m_triangles += triangles);
+    }
+    // Counts bytes written into persistently-mapped buffers, which don't go through NamedBufferSubData().
+    void CountUpload(size_t bytes) { GLITTER_COUNT(m_counters.m_uploadedBytes += bytes); }
+
+    const RenderCounters& GetCounters() const { return m_lastCounters; }
+    const PipelineStatistics& GetPipelineStatistics() const { return m_pipelineStatistics; }
+
+private:
+    static constexpr std::array QUERY_TARGETS = std::to_array<GLenum>({GL_PRIMITIVES_SUBMITTED, GL_VERTEX_SHADER_INVOCATIONS,
+        GL_CLIPPING_INPUT_PRIMITIVES, GL_CLIPPING_OUTPUT_PRIMITIVES, GL_FRAGMENT_SHADER_INVOCATIONS});
+
+    struct Frame {
+        std::array<GLuint, QUERY_TARGETS.size()> m_queries;
+        bool m_pending;
+    };
+
+    // Never a GL name or enum handed to the calls above.
+    static constexpr GLuint UNKNOWN = ~GLuint {0};
+    // The indexed binding points tracked for each of GL_UNIFORM_BUFFER and GL_SHADER_STORAGE_BUFFER, and the texture units.
+    // The ones past them always go through.
+    static constexpr size_t TRACKED_BINDINGS = 16;
+    // GL_DRAW_INDIRECT_BUFFER, GL_PARAMETER_BUFFER and GL_DISPATCH_INDIRECT_BUFFER.
+    static constexpr size_t TRACKED_TARGETS = 3;
+
+    // A whole buffer is bound as the range of offset 0 and size -1.
+    struct BufferRange {
+        GLuint m_buffer;
+        GLintptr m_offset;
+        GLsizeiptr m_size;
+        bool operator==(const BufferRange&) const = default;
+    };
+    struct BlendState {
+        GLenum m_source;
+        GLenum m_destination;
+        bool operator==(const BlendState&) const = default;
+    };
+
+    // Counts the call redundant if `tracked` already holds `value`, or stores it.
+    bool Skip(GLuint& tracked, GLuint value)
+    {
+        if (tracked == value) {
+            GLITTER_COUNT(m_counters.m_redundantCalls++);
+            return true;
+        }
+        tracked = value;
+        return false;
+    }
+    // Like Skip(), for `index` of the indexed `target`, never skipping the untracked ones.
+    bool SkipIndexed(GLenum target, GLuint index, const BufferRange& range);
+
+    GLuint m_program {UNKNOWN};
+    GLuint m_vertexArray {UNKNOWN};
+    std::array<GLuint, TRACKED_TARGETS> m_buffers {};
+    std::array<BufferRange, TRACKED_BINDINGS> m_uniformBuffers {};
+    std::array<BufferRange, TRACKED_BINDINGS> m_storageBuffers {};
+    std::array<GLuint, TRACKED_BINDINGS> m_textures {};
+    GLuint m_depthMask {UNKNOWN};
+    GLenum m_depthFunc {UNKNOWN};
+    BlendState m_blendFunc {UNKNOWN, UNKNOWN};
+
+    RenderCounters m_counters {};
+    RenderCounters m_lastCounters {};
+
+    std::array<Frame, Glitter::Config::FRAMES_IN_FLIGHT> m_frames {};
+    size_t m_currentFrame {};
+    PipelineStatistics m_pipelineStatistics {};
+};
+
+} // namespace Glitter::Render
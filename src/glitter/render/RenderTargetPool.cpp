@@ -0,0 +1,65 @@
+#include "render/RenderTargetPool.h"
+
+#include "render/GpuMemory.h"
+
+#include "Config.h"
+
+#include <algorithm>
+
+namespace Glitter::Render {
+
+GLsizei RenderTargetPool::GetBucketSize(GLsizei size)
+{
+    constexpr auto BUCKET = static_cast<GLsizei>(Config::RENDER_TARGET_BUCKET);
+    return std::max((size + BUCKET - 1) / BUCKET, 1) * BUCKET;
+}
+
+RenderTarget RenderTargetPool::Acquire(GLenum format, GLsizei width, GLsizei height, GLsizei levels, const char* label)
+{
+    auto free = std::ranges::find_if(m_freeTargets, [&](const FreeTarget& freeTarget) {
+        const RenderTarget& target = freeTarget.m_target;
+        return target.m_format == format && target.m_width == width && target.m_height == height && target.m_levels == levels;
+    });
+
+    RenderTarget target {};
+    if (free != m_freeTargets.end()) {
+        target = free->m_target;
+        m_freeTargets.erase(free);
+    } else {
+        target = RenderTarget {.m_format = format, .m_width = width, .m_height = height, .m_levels = levels};
+        glCreateTextures(GL_TEXTURE_2D, 1, &target.m_texture);
+        TextureStorage2D(GpuMemoryCategory::RenderTarget, target.m_texture, levels, format, width, height);
+    }
+    glObjectLabel(GL_TEXTURE, target.m_texture, -1, label);
+    return target;
+}
+
+void RenderTargetPool::Release(RenderTarget& target)
+{
+    if (target.m_texture != 0) {
+        m_freeTargets.push_back(FreeTarget {.m_target = target, .m_releaseFrame = m_frame});
+    }
+    target = {};
+}
+
+void RenderTargetPool::Trim()
+{
+    m_frame++;
+    std::erase_if(m_freeTargets, [&](const FreeTarget& freeTarget) {
+        if (m_frame - freeTarget.m_releaseFrame < Config::RENDER_TARGET_POOL_FRAMES) {
+            return false;
+        }
+        DeleteTextures(1, &freeTarget.m_target.m_texture);
+        return true;
+    });
+}
+
+void RenderTargetPool::Clear()
+{
+    for (const FreeTarget& freeTarget : m_freeTargets) {
+        DeleteTextures(1, &freeTarget.m_target.m_texture);
+    }
+    m_freeTargets.clear();
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace Glitter::Render {
+
+struct RenderTarget {
+    GLuint m_texture {};
+    GLenum m_format {};
+    GLsizei m_width {};
+    GLsizei m_height {};
+    GLsizei m_levels {};
+};
+
+// The textures of the screen-sized passes. They're sized in buckets of Config::RENDER_TARGET_BUCKET texels, which the
+// passes render a viewport of, so that most resizes fit in the targets they have. The targets released when one doesn't
+// are kept for Config::RENDER_TARGET_POOL_FRAMES frames, and reused if the window goes back to their size.
+class RenderTargetPool {
+public:
+    // Rounds `size` up to the next bucket.
+    static GLsizei GetBucketSize(GLsizei size);
+
+    // A GL_TEXTURE_2D of `format` and `levels`, of exactly `width` by `height`. Its sampling parameters are whatever
+    // they were when it was released, if it's reused.
+    RenderTarget Acquire(GLenum format, GLsizei width, GLsizei height, GLsizei levels, const char* label);
+    // Keeps `target` for reuse and resets it. Does nothing if it's empty.
+    void Release(RenderTarget& target);
+
+    // Ends a frame, deleting the released targets that weren't reused in time.
+    void Trim();
+    // Deletes every released target.
+    void Clear();
+
+private:
+    struct FreeTarget {
+        RenderTarget m_target;
+        size_t m_releaseFrame;
+    };
+
+    std::vector<FreeTarget> m_freeTargets;
+    size_t m_frame {};
+};
+
+} // namespace Glitter::Render
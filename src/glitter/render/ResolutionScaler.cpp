@@ -0,0 +1,42 @@
+#include "render/ResolutionScaler.h"
+
+#include "Config.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace Glitter::Render {
+
+bool ResolutionScaler::Update(double gpuMilliseconds)
+{
+    m_framesSinceChange++;
+    if (m_framesSinceChange < Config::DYNAMIC_RESOLUTION_SETTLE_FRAMES || gpuMilliseconds <= 0.0) {
+        return false;
+    }
+
+    // Only scale back up with some headroom, so that the scale doesn't bounce between two steps around the target.
+    double target = Config::DYNAMIC_RESOLUTION_TARGET_MS;
+    if (gpuMilliseconds <= target && gpuMilliseconds >= target * Config::DYNAMIC_RESOLUTION_HEADROOM) {
+        return false;
+    }
+
+    float ideal = m_scale * static_cast<float>(std::sqrt(target / gpuMilliseconds));
+    float steps = std::round((ideal - m_scale) / Config::DYNAMIC_RESOLUTION_STEP);
+    float scale = std::clamp(m_scale + steps * Config::DYNAMIC_RESOLUTION_STEP, Config::DYNAMIC_RESOLUTION_MIN_SCALE, 1.0f);
+    if (scale == m_scale) {
+        return false;
+    }
+
+    m_scale = scale;
+    m_framesSinceChange = 0;
+    return true;
+}
+
+bool ResolutionScaler::Reset()
+{
+    m_framesSinceChange = 0;
+    return std::exchange(m_scale, 1.0f) != 1.0f;
+}
+
+} // namespace Glitter::Render
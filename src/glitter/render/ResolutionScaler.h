@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Glitter::Render {
+
+// Picks the scale of the main pass' resolution that holds the GPU frame time to Config::DYNAMIC_RESOLUTION_TARGET_MS.
+// The time is assumed to grow with the pixel count, so with the square of the scale, and the scale only moves in steps
+// of Config::DYNAMIC_RESOLUTION_STEP, waiting long enough after each change for the timings read back to reflect it.
+class ResolutionScaler {
+public:
+    // Feeds the GPU time of the latest frame read back, and tells whether the scale changed.
+    bool Update(double gpuMilliseconds);
+    // Back to full resolution, tells whether the scale changed.
+    bool Reset();
+
+    float GetScale() const { return m_scale; }
+
+private:
+    float m_scale {1.0f};
+    size_t m_framesSinceChange {};
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,19 @@
+#include "render/ShaderData.h"
+
+#include <format>
+
+namespace Glitter::Render {
+
+std::string GenerateShaderDataGlsl()
+{
+    std::string glsl = "// Generated from src/glitter/render/ShaderData.h by the GlitterShaderLayouts target, do not edit.\n\n";
+    glsl += WriteGlslDeclaration<CommonData>();
+    glsl += "\n";
+    glsl += WriteGlslDeclaration<PerDrawData>();
+    glsl += "\n// Nodes per page of b_Nodes and b_Bounds, see Glitter::Config::NODE_PAGE_SIZE: the bound page holds Slot at Slot "
+            "% NODE_PAGE_SIZE.\n";
+    glsl += std::format("const uint NODE_PAGE_SIZE = {}u;\n", Config::NODE_PAGE_SIZE);
+    return glsl;
+}
+
+} // namespace Glitter::Render
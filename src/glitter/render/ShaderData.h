@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Config.h"
+#include "render/FrustumCulling.h"
+#include "render/ShaderLayout.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace Glitter::Render {
+
+// The std140 `CommonData` uniform block of the shaders, at binding 0.
+struct CommonData {
+    glm::mat4 m_view;
+    // Premultiplied, so that the vertex shaders transform each vertex by one matrix less.
+    glm::mat4 m_viewProjection;
+    glm::vec4 m_eyePos;
+    // A direction towards the light when w is 0.
+    glm::vec4 m_lightPos;
+    glm::vec4 m_lightColor;
+    FrustumPlanes m_frustumPlanes;
+    glm::mat4 m_hiZViewProjection;
+    // x: seconds since startup.
+    glm::vec4 m_time;
+    glm::mat4 m_shadowViewProjection;
+    // x: 1 when shadows are enabled; y: Config::SHADOW_NORMAL_OFFSET.
+    glm::vec4 m_shadowParams;
+    // x: the bias added to the level of detail of the Node textures.
+    glm::vec4 m_textureParams;
+    // The left and right eye's, picked by gl_ViewID_OVR in stereo. Both are m_viewProjection otherwise.
+    std::array<glm::mat4, 2> m_eyeViewProjections;
+};
+
+// The std430 `DrawData` of the shaders, 64 bytes per Node in `b_Nodes`. The model matrix is always affine, so only its
+// first three rows are stored, the shaders rebuild the last one.
+struct alignas(16) PerDrawData {
+    std::array<glm::vec4, 3> m_modelRows;
+    // A GLuint64, read as a uvec2.
+    std::uint64_t m_textureHandle;
+    // Animating Nodes evaluate their opacity in the shaders from CommonData's time, so they store their animation
+    // phase here instead.
+    float m_opacityOrPhase;
+    // The texture layer, the material and NODE_DATA_ANIMATE.
+    std::uint32_t m_packed;
+};
+
+template <> struct GlslStruct<CommonData> {
+    static constexpr const char* DECLARATION = "layout (std140, binding = 0) uniform CommonData";
+    static constexpr GlslLayout LAYOUT = GlslLayout::Std140;
+    static constexpr std::array MEMBERS {
+        GLITTER_GLSL_MEMBER(CommonData, m_view, "u_View", Mat4, 0, nullptr),
+        GLITTER_GLSL_MEMBER(CommonData, m_viewProjection, "u_ViewProjection", Mat4, 0,
+            "The projection times u_View, premultiplied on the CPU."),
+        GLITTER_GLSL_MEMBER(CommonData, m_eyePos, "u_EyePos", Vec4, 0, nullptr),
+        GLITTER_GLSL_MEMBER(CommonData, m_lightPos, "u_LightPos", Vec4, 0, "A direction towards the light when w is 0."),
+        GLITTER_GLSL_MEMBER(CommonData, m_lightColor, "u_LightColor", Vec4, 0, nullptr),
+        GLITTER_GLSL_MEMBER(CommonData, m_frustumPlanes, "u_FrustumPlanes", Vec4, 6, nullptr),
+        GLITTER_GLSL_MEMBER(CommonData, m_hiZViewProjection, "u_HiZViewProjection", Mat4, 0, nullptr),
+        GLITTER_GLSL_MEMBER(CommonData, m_time, "u_Time", Vec4, 0, "x: seconds since startup."),
+        GLITTER_GLSL_MEMBER(CommonData, m_shadowViewProjection, "u_ShadowViewProjection", Mat4, 0, nullptr),
+        GLITTER_GLSL_MEMBER(CommonData, m_shadowParams, "u_ShadowParams", Vec4, 0,
+            "x: 1 when shadows are enabled; y: offset along the normal before sampling the shadow map, in world units."),
+        GLITTER_GLSL_MEMBER(CommonData, m_textureParams, "u_TextureParams", Vec4, 0,
+            "x: the bias added to the level of detail of the Node textures."),
+        GLITTER_GLSL_MEMBER(CommonData, m_eyeViewProjections, "u_EyeViewProjections", Mat4, 2,
+            "The left and right eye's u_ViewProjection in stereo, picked by gl_ViewID_OVR."),
+    };
+};
+static_assert(MatchesGlslLayout<CommonData>());
+
+template <> struct GlslStruct<PerDrawData> {
+    static constexpr const char* DECLARATION = "struct DrawData";
+    static constexpr GlslLayout LAYOUT = GlslLayout::Std430;
+    static constexpr std::array MEMBERS {
+        GLITTER_GLSL_MEMBER(PerDrawData, m_modelRows, "m_ModelRows", Vec4, 3,
+            "The first three rows of the affine model matrix, see NodeModel()."),
+        GLITTER_GLSL_MEMBER(PerDrawData, m_textureHandle, "m_TextureHandle", Uvec2, 0, nullptr),
+        GLITTER_GLSL_MEMBER(
+            PerDrawData, m_opacityOrPhase, "m_OpacityOrPhase", Float, 0, "The animation phase of the animating Nodes."),
+        GLITTER_GLSL_MEMBER(PerDrawData, m_packed, "m_Packed", Uint, 0,
+            "Bits 0-15: the texture layer; 16-30: the material; 31: NODE_ANIMATE."),
+    };
+};
+static_assert(MatchesGlslLayout<PerDrawData>());
+static_assert(sizeof(PerDrawData) == 64);
+static_assert(sizeof(PerDrawData) * Config::NODE_PAGE_SIZE <= 128 * 1024 * 1024);
+
+// The contents of shaders/include/ShaderData.glsl: the declarations of the structs above, and Config::NODE_PAGE_SIZE.
+std::string GenerateShaderDataGlsl();
+
+} // namespace Glitter::Render
@@ -0,0 +1,52 @@
+#include "render/ShaderLayout.h"
+
+#include <format>
+
+namespace Glitter::Render {
+
+namespace {
+
+    const char* GetGlslName(GlslType type)
+    {
+        switch (type) {
+        case GlslType::Float:
+            return "float";
+        case GlslType::Int:
+            return "int";
+        case GlslType::Uint:
+            return "uint";
+        case GlslType::Vec2:
+            return "vec2";
+        case GlslType::Vec3:
+            return "vec3";
+        case GlslType::Vec4:
+            return "vec4";
+        case GlslType::Uvec2:
+            return "uvec2";
+        case GlslType::Uvec4:
+            return "uvec4";
+        case GlslType::Mat4:
+            return "mat4";
+        }
+        return "";
+    }
+
+} // namespace
+
+std::string WriteGlslDeclaration(const char* declaration, std::span<const GlslMember> members)
+{
+    std::string glsl = std::format("{}\n{{\n", declaration);
+    for (const GlslMember& member : members) {
+        if (member.m_comment) {
+            glsl += std::format("    // {}\n", member.m_comment);
+        }
+        glsl += std::format("    {} {}", GetGlslName(member.m_type), member.m_name);
+        if (member.m_arraySize != 0) {
+            glsl += std::format("[{}]", member.m_arraySize);
+        }
+        glsl += ";\n";
+    }
+    return glsl + "};\n";
+}
+
+} // namespace Glitter::Render
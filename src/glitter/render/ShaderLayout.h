@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace Glitter::Render {
+
+// The GLSL types of the members of the structs shared with the shaders.
+enum class GlslType : std::uint8_t {
+    Float,
+    Int,
+    Uint,
+    Vec2,
+    Vec3,
+    Vec4,
+    Uvec2,
+    Uvec4,
+    Mat4,
+};
+
+enum class GlslLayout : std::uint8_t {
+    Std140,
+    Std430,
+};
+
+// A member of a struct shared with the shaders: its GLSL declaration, and where the C++ one lies, see
+// GLITTER_GLSL_MEMBER().
+struct GlslMember {
+    const char* m_name;
+    GlslType m_type;
+    // 0 if it isn't an array.
+    std::uint32_t m_arraySize;
+    std::uint32_t m_offset;
+    std::uint32_t m_size;
+    // Written above the declaration, unless nullptr.
+    const char* m_comment;
+};
+
+// The GlslMember `glslName` of `member` of `Struct`, an array of `arraySize` if not 0.
+#define GLITTER_GLSL_MEMBER(Struct, member, glslName, glslType, arraySize, comment)                                      \
+    ::Glitter::Render::GlslMember                                                                                          \
+    {                                                                                                                      \
+        .m_name = glslName, .m_type = ::Glitter::Render::GlslType::glslType, .m_arraySize = arraySize,                     \
+        .m_offset = offsetof(Struct, member), .m_size = sizeof(Struct::member), .m_comment = comment                       \
+    }
+
+// The GLSL declaration of a struct shared with the shaders, specialized next to each: a constexpr DECLARATION, the
+// `struct` or interface block its members are written into, its LAYOUT, and a constexpr array of its MEMBERS in order.
+// Their C++ layout is checked against the GLSL one with MatchesGlslLayout(), and the shaders include the declarations
+// WriteGlslDeclaration() generates, so that the two can't drift apart when a struct is repacked.
+template <typename T> struct GlslStruct;
+
+constexpr std::uint32_t GetGlslSize(GlslType type)
+{
+    switch (type) {
+    case GlslType::Float:
+    case GlslType::Int:
+    case GlslType::Uint:
+        return 4;
+    case GlslType::Vec2:
+    case GlslType::Uvec2:
+        return 8;
+    case GlslType::Vec3:
+        return 12;
+    case GlslType::Vec4:
+    case GlslType::Uvec4:
+        return 16;
+    case GlslType::Mat4:
+        return 64;
+    }
+    return 0;
+}
+
+// The base alignment of a member of `type`. std140 rounds the arrays' up to a vec4's.
+constexpr std::uint32_t GetGlslAlignment(GlslType type, GlslLayout layout, bool array)
+{
+    std::uint32_t alignment = 0;
+    switch (type) {
+    case GlslType::Float:
+    case GlslType::Int:
+    case GlslType::Uint:
+        alignment = 4;
+        break;
+    case GlslType::Vec2:
+    case GlslType::Uvec2:
+        alignment = 8;
+        break;
+    case GlslType::Vec3:
+    case GlslType::Vec4:
+    case GlslType::Uvec4:
+    case GlslType::Mat4:
+        alignment = 16;
+        break;
+    }
+    return layout == GlslLayout::Std140 && array ? std::max<std::uint32_t>(alignment, 16) : alignment;
+}
+
+// Whether the offset and size of every member of `T`, and its size, are the ones its GLSL declaration has. The size is
+// that of an element of an array of T, rounded up to the largest alignment of its members, and a vec4's in std140.
+template <typename T> consteval bool MatchesGlslLayout()
+{
+    constexpr GlslLayout layout = GlslStruct<T>::LAYOUT;
+    std::uint32_t offset = 0;
+    std::uint32_t structAlignment = layout == GlslLayout::Std140 ? 16 : 4;
+    for (const GlslMember& member : GlslStruct<T>::MEMBERS) {
+        bool array = member.m_arraySize != 0;
+        std::uint32_t alignment = GetGlslAlignment(member.m_type, layout, array);
+        std::uint32_t size = GetGlslSize(member.m_type);
+        if (array) {
+            size = (size + alignment - 1) / alignment * alignment * member.m_arraySize;
+        }
+        offset = (offset + alignment - 1) / alignment * alignment;
+        if (member.m_offset != offset || member.m_size != size) {
+            return false;
+        }
+        offset += size;
+        structAlignment = std::max(structAlignment, alignment);
+    }
+    return (offset + structAlignment - 1) / structAlignment * structAlignment == sizeof(T);
+}
+
+// `declaration`, then `members` between braces.
+std::string WriteGlslDeclaration(const char* declaration, std::span<const GlslMember> members);
+
+template <typename T> std::string WriteGlslDeclaration()
+{
+    return WriteGlslDeclaration(GlslStruct<T>::DECLARATION, GlslStruct<T>::MEMBERS);
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,97 @@
+#include "render/ShadingRateImage.h"
+
+#include "Config.h"
+#include "render/GLExtensions.h"
+#include "render/GpuMemory.h"
+
+#include <array>
+
+namespace Glitter::Render {
+
+void ShadingRateImage::Create(GLsizei width, GLsizei height)
+{
+    Release();
+    if (!GetGLExtensions().m_shadingRateImage) {
+        return;
+    }
+
+    glGetIntegerv(GL_SHADING_RATE_IMAGE_TEXEL_WIDTH_NV, &m_texelWidth);
+    glGetIntegerv(GL_SHADING_RATE_IMAGE_TEXEL_HEIGHT_NV, &m_texelHeight);
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_texture);
+    TextureStorage2D(GpuMemoryCategory::RenderTarget, m_texture, 1, GL_R8UI, (width + m_texelWidth - 1) / m_texelWidth,
+        (height + m_texelHeight - 1) / m_texelHeight);
+    glObjectLabel(GL_TEXTURE, m_texture, -1, "Shading Rate Image");
+
+    // Full rate until the first update.
+    std::uint8_t fullRate = 0;
+    glClearTexImage(m_texture, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, &fullRate);
+}
+
+void ShadingRateImage::Release()
+{
+    DeleteTextures(1, &m_texture);
+    m_texture = 0;
+}
+
+void ShadingRateImage::AddUpdatePass(RenderGraph& graph, GLuint program, ShadingRateMode mode, RenderResource color,
+    GLsizei width, GLsizei height, RenderStats& stats, GpuProfiler& profiler)
+{
+    RenderResource image = graph.Import(RenderResourceType::Texture, m_texture);
+    RenderPassBuilder pass = graph.AddPass("Shading Rate Image", [=, this, &stats, &profiler](const RenderGraph& run) {
+        profiler.PushGroup(0, "Shading Rate Image");
+        {
+            stats.UseProgram(program);
+            if (mode == ShadingRateMode::ContentAdaptive) {
+                stats.BindTextureUnit(0, run.Get(color));
+            }
+            glBindImageTexture(0, run.Get(image), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R8UI);
+
+            // uniform layout(location = 0) ivec2 u_Size;
+            // uniform layout(location = 1) ivec2 u_TexelSize;
+            // uniform layout(location = 2) bool u_ContentAdaptive;
+            // uniform layout(location = 3) float u_FoveaRadius;
+            // uniform layout(location = 4) float u_ContrastThreshold;
+            glUniform2i(0, width, height);
+            glUniform2i(1, m_texelWidth, m_texelHeight);
+            glUniform1i(2, mode == ShadingRateMode::ContentAdaptive ? GL_TRUE : GL_FALSE);
+            glUniform1f(3, Config::SHADING_RATE_FOVEA_RADIUS);
+            glUniform1f(4, Config::SHADING_RATE_CONTRAST_THRESHOLD);
+
+            // A workgroup per texel.
+            glDispatchCompute(static_cast<GLuint>((width + m_texelWidth - 1) / m_texelWidth),
+                static_cast<GLuint>((height + m_texelHeight - 1) / m_texelHeight), 1);
+
+            // Read by the next frame's rasterization, past this graph's barriers.
+            glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+        }
+        profiler.PopGroup();
+    });
+    pass.Overwrite(image, RenderAccess::ImageLoadStore);
+    if (mode == ShadingRateMode::ContentAdaptive) {
+        pass.Read(color, RenderAccess::TextureFetch);
+    }
+    graph.Keep(image);
+}
+
+void ShadingRateImage::Begin() const
+{
+    // Matches the rates ShadingRateCS.glsl writes.
+    static constexpr std::array<GLenum, 4> PALETTE {
+        GL_SHADING_RATE_1_INVOCATION_PER_PIXEL_NV,
+        GL_SHADING_RATE_1_INVOCATION_PER_2X1_PIXELS_NV,
+        GL_SHADING_RATE_1_INVOCATION_PER_2X2_PIXELS_NV,
+        GL_SHADING_RATE_1_INVOCATION_PER_4X4_PIXELS_NV,
+    };
+    const GLExtensions& extensions = GetGLExtensions();
+    extensions.m_bindShadingRateImage(m_texture);
+    extensions.m_shadingRateImagePalette(0, 0, static_cast<GLsizei>(PALETTE.size()), PALETTE.data());
+    glEnable(GL_SHADING_RATE_IMAGE_NV);
+}
+
+void ShadingRateImage::End() const
+{
+    glDisable(GL_SHADING_RATE_IMAGE_NV);
+    GetGLExtensions().m_bindShadingRateImage(0);
+}
+
+} // namespace Glitter::Render
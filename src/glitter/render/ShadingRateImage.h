@@ -0,0 +1,47 @@
+#pragma once
+
+#include "render/GpuProfiler.h"
+#include "render/RenderGraph.h"
+#include "render/RenderStats.h"
+
+#include <glad/glad.h>
+
+#include <cstdint>
+
+namespace Glitter::Render {
+
+enum class ShadingRateMode : std::uint8_t {
+    Off,
+    // Coarser away from the center of the viewport.
+    Foveated,
+    // Coarser where the previous frame's scene color was flat.
+    ContentAdaptive,
+};
+
+// The GL_NV_shading_rate_image coarsening the main pass' shading: an R8UI texel of palette indices per tile of the
+// driver's texel size, from one fragment shader invocation per pixel at 0 down to one per 4x4 pixels at 3. It's rebuilt
+// by the ShadingRateCS compute program after every main pass, and so lags the scene color it adapts to by a frame.
+class ShadingRateImage {
+public:
+    // Allocates the image covering a `width` by `height` target. Does nothing without the extension.
+    void Create(GLsizei width, GLsizei height);
+    void Release();
+
+    bool IsSupported() const { return m_texture != 0; }
+
+    // Adds the pass rebuilding the image for the `width` by `height` viewport of `color` in `mode` to `graph`, with
+    // `program`, binding through `stats` and timed by `profiler`. `color` is only read by ShadingRateMode::ContentAdaptive.
+    void AddUpdatePass(RenderGraph& graph, GLuint program, ShadingRateMode mode, RenderResource color, GLsizei width,
+        GLsizei height, RenderStats& stats, GpuProfiler& profiler);
+
+    // Around the draws shaded at the image's rates.
+    void Begin() const;
+    void End() const;
+
+private:
+    GLuint m_texture {};
+    GLint m_texelWidth {};
+    GLint m_texelHeight {};
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,170 @@
+#include "render/ShadowCache.h"
+
+#include "render/GpuMemory.h"
+
+#include "Config.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace Glitter::Render {
+
+namespace {
+
+    GLuint CreateShadowTexture(GLsizei size, const char* label)
+    {
+        GLuint texture = 0;
+        glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+        TextureStorage2D(GpuMemoryCategory::RenderTarget, texture, 1, GL_DEPTH_COMPONENT32F, size, size);
+        glObjectLabel(GL_TEXTURE, texture, -1, label);
+
+        // Compared by the sampler, with bilinear PCF. Outside the light's frustum is always lit.
+        glTextureParameteri(texture, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+        glTextureParameteri(texture, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+        glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        std::array<GLfloat, 4> border {1.0f, 1.0f, 1.0f, 1.0f};
+        glTextureParameterfv(texture, GL_TEXTURE_BORDER_COLOR, border.data());
+
+        // Lit everywhere until it's first rendered, which a map created again mid-run may be sampled before.
+        GLfloat clearDepth = 1.0f;
+        glClearTexImage(texture, 0, GL_DEPTH_COMPONENT, GL_FLOAT, &clearDepth);
+        return texture;
+    }
+
+    GLuint CreateShadowFramebuffer(GLuint texture, const char* label)
+    {
+        GLuint fbo = 0;
+        glCreateFramebuffers(1, &fbo);
+        glNamedFramebufferTexture(fbo, GL_DEPTH_ATTACHMENT, texture, 0);
+        glNamedFramebufferDrawBuffer(fbo, GL_NONE);
+        glObjectLabel(GL_FRAMEBUFFER, fbo, -1, label);
+        return fbo;
+    }
+
+} // namespace
+
+void ShadowCache::Create(GLsizei size)
+{
+    Release();
+
+    m_size = size;
+    m_staticTexture = CreateShadowTexture(size, "Static Shadow Map");
+    m_staticFbo = CreateShadowFramebuffer(m_staticTexture, "Static Shadow Map FBO");
+    m_texture = CreateShadowTexture(size, "Shadow Map");
+    m_fbo = CreateShadowFramebuffer(m_texture, "Shadow Map FBO");
+    m_valid = false;
+}
+
+void ShadowCache::Release()
+{
+    glDeleteFramebuffers(1, &m_staticFbo);
+    DeleteTextures(1, &m_staticTexture);
+    glDeleteFramebuffers(1, &m_fbo);
+    DeleteTextures(1, &m_texture);
+    m_staticFbo = 0;
+    m_staticTexture = 0;
+    m_fbo = 0;
+    m_texture = 0;
+}
+
+void ShadowCache::Update(std::span<const std::uint32_t> dirtyNodes, std::uint64_t sceneRevision, const glm::vec3& lightDirection,
+    const CullBounds& bounds)
+{
+    m_frame++;
+
+    // Nodes were added or cleared: the ones left start static.
+    if (sceneRevision != m_sceneRevision) {
+        m_sceneRevision = sceneRevision;
+        m_dynamic.assign(bounds.Size(), 0);
+        m_lastMoved.assign(bounds.Size(), 0);
+        m_dynamicNodes.clear();
+        m_valid = false;
+    } else {
+        for (std::uint32_t node : dirtyNodes) {
+            m_lastMoved[node] = m_frame;
+            if (!m_dynamic[node]) {
+                m_dynamic[node] = 1;
+                m_dynamicNodes.push_back(node);
+                m_valid = false;
+            }
+        }
+    }
+
+    // Nodes that settled are baked into the cache again.
+    std::erase_if(m_dynamicNodes, [&](std::uint32_t node) {
+        if (m_frame - m_lastMoved[node] < Glitter::Config::SHADOW_DYNAMIC_FRAMES) {
+            return false;
+        }
+        m_dynamic[node] = 0;
+        m_valid = false;
+        return true;
+    });
+
+    if (lightDirection != m_lightDirection) {
+        m_lightDirection = lightDirection;
+        m_valid = false;
+    }
+}
+
+bool ShadowCache::NeedsStaticRender(const CullBounds& bounds)
+{
+    if (m_valid) {
+        return false;
+    }
+    m_valid = true;
+    m_staticRenders++;
+
+    // Fit the light's frustum around the sphere bounding every Node.
+    glm::vec3 sceneMin(std::numeric_limits<float>::max());
+    glm::vec3 sceneMax(std::numeric_limits<float>::lowest());
+    for (size_t node = 0; node < bounds.Size(); node++) {
+        sceneMin = glm::min(sceneMin, bounds.GetCenter(node) - bounds.GetExtent(node));
+        sceneMax = glm::max(sceneMax, bounds.GetCenter(node) + bounds.GetExtent(node));
+    }
+    glm::vec3 center = bounds.Size() > 0 ? (sceneMin + sceneMax) * 0.5f : glm::vec3(0.0f);
+    float radius = bounds.Size() > 0 ? std::max(glm::length(sceneMax - sceneMin) * 0.5f, 1.0f) : 1.0f;
+
+    glm::vec3 up = std::abs(m_lightDirection.y) > 0.99f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::mat4 view = glm::lookAt(center + m_lightDirection * radius, center, up);
+    glm::mat4 projection = glm::ortho(-radius, radius, -radius, radius, 0.0f, 2.0f * radius);
+    m_viewProjection = projection * view;
+    m_frustumPlanes = ExtractFrustumPlanes(m_viewProjection);
+    return true;
+}
+
+void ShadowCache::BeginStatic(RenderStats& stats, GLuint program) { Begin(stats, m_staticFbo, program, true); }
+
+void ShadowCache::BeginDynamic(RenderStats& stats, GLuint program)
+{
+    glCopyImageSubData(
+        m_staticTexture, GL_TEXTURE_2D, 0, 0, 0, 0, m_texture, GL_TEXTURE_2D, 0, 0, 0, 0, m_size, m_size, 1);
+    Begin(stats, m_fbo, program, false);
+}
+
+void ShadowCache::Begin(RenderStats& stats, GLuint fbo, GLuint program, bool clear)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, m_size, m_size);
+    stats.DepthMask(GL_TRUE);
+    if (clear) {
+        glClear(GL_DEPTH_BUFFER_BIT);
+    }
+    stats.UseProgram(program);
+
+    // Push the depth away from the surfaces, so that they don't shadow themselves.
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(2.0f, 4.0f);
+}
+
+void ShadowCache::End()
+{
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "render/FrustumCulling.h"
+#include "render/RenderStats.h"
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Glitter::Render {
+
+// The shadow map of the scene's directional light, split between the Nodes that haven't moved for a while, whose depth is
+// cached in a static map only rendered again when the cache is invalidated, and the dynamic ones, rendered every frame over
+// a copy of it. A Node becomes dynamic as soon as it moves, which invalidates the cache since its old shadow is baked into
+// it, and static again Glitter::Config::SHADOW_DYNAMIC_FRAMES after it last moved. Adding Nodes, clearing them or turning
+// the light invalidates it too.
+//
+// The light's orthographic frustum is fitted around every Node when the cache is rendered, dynamic Nodes moving out of it
+// don't cast shadows until the next time.
+class ShadowCache {
+public:
+    // A `size` by `size` map. Creating it again at another size invalidates the cache.
+    void Create(GLsizei size);
+    void Release();
+    GLsizei GetSize() const { return m_size; }
+
+    // Tracks the Nodes of `bounds` that moved, `dirtyNodes`, and whether the cache is still valid for the light shining
+    // towards -`lightDirection`. A new `sceneRevision` turns every Node static.
+    void Update(std::span<const std::uint32_t> dirtyNodes, std::uint64_t sceneRevision, const glm::vec3& lightDirection,
+        const CullBounds& bounds);
+
+    // When set, the static Nodes must be rendered between BeginStatic() and EndStatic() this frame. Refits the light's
+    // frustum around `bounds`, to cull them against.
+    bool NeedsStaticRender(const CullBounds& bounds);
+    void BeginStatic(RenderStats& stats, GLuint program);
+    void EndStatic() { End(); }
+
+    // Copies the static map, and renders the dynamic Nodes over it.
+    void BeginDynamic(RenderStats& stats, GLuint program);
+    void EndDynamic() { End(); }
+
+    bool IsDynamic(size_t node) const { return node < m_dynamic.size() && m_dynamic[node]; }
+    std::span<const std::uint32_t> GetDynamicNodes() const { return m_dynamicNodes; }
+
+    // The light's View-Projection, and its frustum planes.
+    const glm::mat4& GetViewProjection() const { return m_viewProjection; }
+    const FrustumPlanes& GetFrustumPlanes() const { return m_frustumPlanes; }
+
+    // The map of the static Nodes, and the one the dynamic Nodes are rendered into, to sample when there are some. Both
+    // compare their depth with GL_LEQUAL.
+    GLuint GetStaticTexture() const { return m_staticTexture; }
+    GLuint GetTexture() const { return m_texture; }
+    // Times the static map was rendered, since Create().
+    size_t GetStaticRenders() const { return m_staticRenders; }
+
+private:
+    void Begin(RenderStats& stats, GLuint fbo, GLuint program, bool clear);
+    void End();
+
+    GLsizei m_size {};
+    GLuint m_staticTexture {};
+    GLuint m_staticFbo {};
+    GLuint m_texture {};
+    GLuint m_fbo {};
+
+    bool m_valid {};
+    size_t m_staticRenders {};
+    std::uint64_t m_sceneRevision {UINT64_MAX};
+    glm::vec3 m_lightDirection {};
+    glm::mat4 m_viewProjection {1.0f};
+    FrustumPlanes m_frustumPlanes {};
+
+    // The Nodes that moved in the last Config::SHADOW_DYNAMIC_FRAMES, and when they last did.
+    std::vector<std::uint8_t> m_dynamic;
+    std::vector<std::uint32_t> m_dynamicNodes;
+    std::vector<std::uint64_t> m_lastMoved;
+    std::uint64_t m_frame {};
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,186 @@
+#include "render/SkinnedMeshes.h"
+
+#include "render/GpuMemory.h"
+
+#include "Config.h"
+
+#include <algorithm>
+#include <array>
+
+namespace Glitter::Render {
+
+namespace {
+
+    // The dispatches' limit of work groups along y, which every implementation supports.
+    constexpr size_t MAX_WORK_GROUPS = 65535;
+    constexpr GLuint WORK_GROUP_SIZE = 64;
+
+    // Grows `buffer` to at least `size` bytes, doubling it, and writes `data` at its start.
+    void WriteGrowing(RenderStats& stats, GLuint buffer, size_t& bufferSize, const void* data, size_t size)
+    {
+        if (size > bufferSize) {
+            bufferSize = std::max(size, bufferSize * 2);
+            NamedBufferData(
+                GpuMemoryCategory::StreamBuffer, buffer, static_cast<GLsizeiptr>(bufferSize), nullptr, GL_DYNAMIC_DRAW);
+        }
+        stats.NamedBufferSubData(buffer, 0, static_cast<GLsizeiptr>(size), data);
+    }
+
+} // namespace
+
+void SkinnedMeshes::Create()
+{
+    std::array<GLuint, 2> buffers {};
+    glCreateBuffers(buffers.size(), buffers.data());
+    m_partBuffer = buffers[0];
+    m_matrixBuffer = buffers[1];
+    glObjectLabel(GL_BUFFER, m_partBuffer, -1, "Skinned Parts SSBO");
+    glObjectLabel(GL_BUFFER, m_matrixBuffer, -1, "Skinning Matrices SSBO");
+}
+
+void SkinnedMeshes::Release()
+{
+    DeleteBuffers(1, &m_partBuffer);
+    DeleteBuffers(1, &m_matrixBuffer);
+    m_partBuffer = 0;
+    m_partBufferSize = 0;
+    m_matrixBuffer = 0;
+    m_matrixBufferSize = 0;
+    m_influences.Release();
+    m_stagedInfluences.clear();
+    m_stagedInfluence = 0;
+    m_parts.clear();
+    m_partInstances.clear();
+    m_retired.clear();
+    m_instanceCount = 0;
+    m_vertexCount = 0;
+}
+
+std::uint32_t SkinnedMeshes::AddInfluences(std::span<const std::byte> influences)
+{
+    // The influences are never freed, so the staged ones stay contiguous.
+    auto count = static_cast<std::uint32_t>(influences.size() / m_influences.GetElementSize());
+    GpuRange range = m_influences.Allocate(count);
+    if (m_stagedInfluences.empty()) {
+        m_stagedInfluence = range.m_first;
+    }
+    m_stagedInfluences.insert(m_stagedInfluences.end(), influences.begin(), influences.end());
+    return range.m_first;
+}
+
+std::uint32_t SkinnedMeshes::Add(GeometryPool& pool, std::span<const SkinnedPartDesc> parts, std::span<GLint> baseVertices)
+{
+    std::uint32_t instance = m_nextInstance++;
+    for (size_t partIdx = 0; partIdx < parts.size(); partIdx++) {
+        const SkinnedPartDesc& desc = parts[partIdx];
+        GeometryRange range = pool.Allocate(desc.m_page, desc.m_vertexCount, 0);
+        baseVertices[partIdx] = range.m_baseVertex;
+
+        auto position = std::ranges::upper_bound(m_partPages, desc.m_page) - m_partPages.begin();
+        m_parts.insert(m_parts.begin() + position, GpuPart {.m_dequantize = desc.m_dequantize,
+            .m_quantize = desc.m_quantize,
+            .m_sourceBaseVertex = desc.m_sourceBaseVertex,
+            .m_baseVertex = static_cast<GLuint>(range.m_baseVertex),
+            .m_vertexCount = desc.m_vertexCount,
+            .m_firstInfluence = desc.m_firstInfluence,
+            .m_firstMatrix = desc.m_firstMatrix,
+            .m_matrixCount = desc.m_matrixCount,
+            .m_padding = {}});
+        m_partInstances.insert(m_partInstances.begin() + position, instance);
+        m_partPages.insert(m_partPages.begin() + position, desc.m_page);
+        m_vertexCount += desc.m_vertexCount;
+    }
+    m_instanceCount++;
+    m_partsChanged = true;
+    return instance;
+}
+
+void SkinnedMeshes::Remove(std::uint32_t instance)
+{
+    size_t kept = 0;
+    for (size_t partIdx = 0; partIdx < m_parts.size(); partIdx++) {
+        const GpuPart& part = m_parts[partIdx];
+        if (m_partInstances[partIdx] == instance) {
+            m_retired.push_back(Retired {.m_frame = m_frame,
+                .m_page = m_partPages[partIdx],
+                .m_baseVertex = static_cast<GLint>(part.m_baseVertex),
+                .m_vertexCount = part.m_vertexCount});
+            m_vertexCount -= part.m_vertexCount;
+            continue;
+        }
+        m_parts[kept] = part;
+        m_partInstances[kept] = m_partInstances[partIdx];
+        m_partPages[kept] = m_partPages[partIdx];
+        kept++;
+    }
+    if (kept < m_parts.size()) {
+        m_parts.resize(kept);
+        m_partInstances.resize(kept);
+        m_partPages.resize(kept);
+        m_instanceCount--;
+        m_partsChanged = true;
+    }
+}
+
+void SkinnedMeshes::BeginFrame(GeometryPool& pool)
+{
+    m_frame++;
+    std::erase_if(m_retired, [&](const Retired& retired) {
+        if (m_frame - retired.m_frame < Glitter::Config::FRAMES_IN_FLIGHT) {
+            return false;
+        }
+        pool.FreeVertices(retired.m_page, retired.m_baseVertex, static_cast<GLsizei>(retired.m_vertexCount));
+        return true;
+    });
+}
+
+void SkinnedMeshes::Dispatch(RenderStats& stats, GLuint program, const GeometryPool& pool, std::span<const glm::mat4> matrices)
+{
+    if (!m_stagedInfluences.empty()) {
+        if (m_influences.Reserve()) {
+            stats.InvalidateState();
+        }
+        stats.NamedBufferSubData(m_influences.GetBuffer(), m_influences.GetByteOffset(m_stagedInfluence),
+            static_cast<GLsizeiptr>(m_stagedInfluences.size()), m_stagedInfluences.data());
+        m_stagedInfluences.clear();
+    }
+    if (m_parts.empty() || matrices.empty()) {
+        return;
+    }
+
+    if (m_partsChanged) {
+        WriteGrowing(stats, m_partBuffer, m_partBufferSize, m_parts.data(), sizeof(GpuPart) * m_parts.size());
+        m_partsChanged = false;
+    }
+    WriteGrowing(stats, m_matrixBuffer, m_matrixBufferSize, matrices.data(), matrices.size_bytes());
+
+    stats.UseProgram(program);
+    stats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_influences.GetBuffer());
+    stats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_partBuffer);
+    stats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_matrixBuffer);
+    // uniform layout(location = 1) uint u_MatrixCount;
+    glUniform1ui(1, static_cast<GLuint>(matrices.size()));
+
+    for (size_t pageBegin = 0; pageBegin < m_parts.size();) {
+        std::uint32_t page = m_partPages[pageBegin];
+        size_t pageEnd = pageBegin;
+        GLuint maxVertexCount = 0;
+        for (; pageEnd < m_parts.size() && m_partPages[pageEnd] == page; pageEnd++) {
+            maxVertexCount = std::max(maxVertexCount, m_parts[pageEnd].m_vertexCount);
+        }
+
+        stats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, pool.GetVBO(page));
+        stats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, pool.GetPositionVBO(page));
+
+        // One row of work groups per part, each work group skinning WORK_GROUP_SIZE of its vertices.
+        GLuint groupsPerPart = (maxVertexCount + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE;
+        for (size_t firstPart = pageBegin; firstPart < pageEnd; firstPart += MAX_WORK_GROUPS) {
+            // uniform layout(location = 0) uint u_FirstPart;
+            glUniform1ui(0, static_cast<GLuint>(firstPart));
+            glDispatchCompute(groupsPerPart, static_cast<GLuint>(std::min(MAX_WORK_GROUPS, pageEnd - firstPart)), 1);
+        }
+        pageBegin = pageEnd;
+    }
+}
+
+} // namespace Glitter::Render
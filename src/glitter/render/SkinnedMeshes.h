@@ -0,0 +1,106 @@
+#pragma once
+
+#include "render/GeometryPool.h"
+#include "render/GpuBufferAllocator.h"
+#include "render/RenderStats.h"
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Glitter::Render {
+
+// A Primitive of a skinned Node to skin into vertices of its own: its vertices and their influences, the transforms from
+// its vertices into Mesh space and from the skinned Mesh space into its skinned vertices', and the skinning matrices its
+// joint indices refer to. Its skinned vertices go into the geometry pool page of its vertices, which SkinCS.glsl reads
+// them from.
+struct SkinnedPartDesc {
+    glm::mat4 m_dequantize;
+    glm::mat4 m_quantize;
+    std::uint32_t m_page;
+    GLint m_sourceBaseVertex;
+    GLuint m_vertexCount;
+    std::uint32_t m_firstInfluence;
+    std::uint32_t m_firstMatrix;
+    std::uint32_t m_matrixCount;
+};
+
+// The skinned vertices of the skinned Nodes, allocated from the geometry pool along with the Meshes, in the same vertex
+// format, so that every pass draws them like any other Mesh, with the same VAOs and programs. SkinCS.glsl skins each Node's
+// Primitives into them once per frame, blending up to 4 of the frame's skinning matrices per vertex, before any pass
+// draws them.
+//
+// The influences of the Primitives are uploaded once, as Glitter::Scene::SkinnedVertex, and shared by every Node skinning
+// them. A removed instance's vertices are only handed out again after Config::FRAMES_IN_FLIGHT frames.
+class SkinnedMeshes {
+public:
+    void Create();
+    void Release();
+
+    // Adds the influences of a Primitive, uploaded by the next Dispatch(), returning the first one.
+    std::uint32_t AddInfluences(std::span<const std::byte> influences);
+    // Allocates the skinned vertices of the `parts` of a Node, writing the base vertex of each part into `baseVertices`.
+    // Returns the instance, see Remove().
+    std::uint32_t Add(GeometryPool& pool, std::span<const SkinnedPartDesc> parts, std::span<GLint> baseVertices);
+    // Stops skinning the instance, its vertices are freed once the frames in flight no longer draw them.
+    void Remove(std::uint32_t instance);
+
+    // Frees the vertices of the instances removed Config::FRAMES_IN_FLIGHT frames ago.
+    void BeginFrame(GeometryPool& pool);
+
+    // Skins every part with `program` by `matrices`, once the geometry pool holds every skinned vertex. Parts whose
+    // matrices are past `matrices` keep their previous vertices. Leaves the barriers to the caller.
+    void Dispatch(RenderStats& stats, GLuint program, const GeometryPool& pool, std::span<const glm::mat4> matrices);
+
+    size_t GetInstanceCount() const { return m_instanceCount; }
+    size_t GetVertexCount() const { return m_vertexCount; }
+    bool IsEmpty() const { return m_parts.empty(); }
+
+private:
+    // Matches the std430 layout of `b_Parts` in SkinCS.glsl.
+    struct alignas(16) GpuPart {
+        glm::mat4 m_dequantize;
+        glm::mat4 m_quantize;
+        GLint m_sourceBaseVertex;
+        GLuint m_baseVertex;
+        GLuint m_vertexCount;
+        GLuint m_firstInfluence;
+        GLuint m_firstMatrix;
+        GLuint m_matrixCount;
+        GLuint m_padding[2];
+    };
+
+    struct Retired {
+        std::uint64_t m_frame;
+        std::uint32_t m_page;
+        GLint m_baseVertex;
+        GLuint m_vertexCount;
+    };
+
+    // Ordered by page, so that the parts of each page are dispatched together.
+    std::vector<GpuPart> m_parts;
+    std::vector<std::uint32_t> m_partInstances;
+    std::vector<std::uint32_t> m_partPages;
+    bool m_partsChanged {};
+    std::uint32_t m_nextInstance {};
+    size_t m_instanceCount {};
+    size_t m_vertexCount {};
+
+    std::vector<Retired> m_retired;
+    std::uint64_t m_frame {};
+
+    // 16 bytes per influence, the ones added since the last Dispatch() staged at m_stagedInfluence.
+    GpuBufferAllocator m_influences {16, "Skin Influences SSBO"};
+    std::vector<std::byte> m_stagedInfluences;
+    std::uint32_t m_stagedInfluence {};
+
+    GLuint m_partBuffer {};
+    size_t m_partBufferSize {};
+    GLuint m_matrixBuffer {};
+    size_t m_matrixBufferSize {};
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,371 @@
+#include "render/StaticBatches.h"
+
+#include "render/GpuMemory.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace Glitter::Render {
+
+namespace {
+
+    // Cells are clamped this far from the origin, so that their coordinates pack into 21 bits each.
+    constexpr int CELL_LIMIT = (1 << 20) - 1;
+
+    // The dispatches' limit of work groups along x, which every implementation supports.
+    constexpr size_t MAX_WORK_GROUPS = 65535;
+
+    std::uint64_t PackCell(const glm::ivec3& cell)
+    {
+        glm::u64vec3 biased = glm::u64vec3(cell + CELL_LIMIT);
+        return biased.x | (biased.y << 21) | (biased.z << 42);
+    }
+
+    // 16-bit indices are written two at a time, so a part with an odd triangle count gets a degenerate one more.
+    GLuint GetPaddedIndexCount(GLuint indexCount, bool shortIndices)
+    {
+        return shortIndices && indexCount % 2 != 0 ? indexCount + 3 : indexCount;
+    }
+
+} // namespace
+
+StaticBatchCells::StaticBatchCells(float cellSize)
+    : m_invCellSize(1.0f / cellSize)
+{
+}
+
+void StaticBatchCells::Update(std::span<const std::uint32_t> dirtyNodes, std::uint64_t sceneRevision, const CullBounds& bounds,
+    const std::function<StaticState(size_t)>& getState)
+{
+    // Nodes were added or removed, and the others may have moved to other indices: refile them all, and rebuild the cells
+    // that lost Nodes, or hold added or moved ones, which are dirty.
+    if (sceneRevision != m_sceneRevision) {
+        m_sceneRevision = sceneRevision;
+        std::vector<size_t> previousCounts(m_cells.size());
+        for (size_t cell = 0; cell < m_cells.size(); cell++) {
+            previousCounts[cell] = m_cells[cell].m_nodes.size();
+            m_cells[cell].m_nodes.clear();
+        }
+        m_movingNodes.clear();
+        m_nodeCells.assign(bounds.Size(), NO_CELL);
+        m_nodePositions.resize(bounds.Size());
+
+        for (std::uint32_t node = 0; node < bounds.Size(); node++) {
+            StaticState state = getState(node);
+            if (state == StaticState::Static) {
+                File(bounds, node);
+            } else if (state == StaticState::Moving) {
+                m_nodeCells[node] = MOVING_NODE;
+                m_movingNodes.push_back(node);
+            }
+        }
+        for (std::uint32_t node : dirtyNodes) {
+            if (node < m_nodeCells.size() && m_nodeCells[node] < MOVING_NODE) {
+                Queue(m_nodeCells[node]);
+            }
+        }
+        for (size_t cell = 0; cell < previousCounts.size(); cell++) {
+            if (m_cells[cell].m_nodes.size() != previousCounts[cell]) {
+                Queue(static_cast<std::uint32_t>(cell));
+            }
+        }
+        return;
+    }
+
+    // A moved Node leaves its cell until it settles.
+    for (std::uint32_t node : dirtyNodes) {
+        std::uint32_t cell = m_nodeCells[node];
+        if (cell == MOVING_NODE || getState(node) == StaticState::Excluded) {
+            continue;
+        }
+        if (cell != NO_CELL) {
+            Unfile(node);
+            Queue(cell);
+        }
+        m_nodeCells[node] = MOVING_NODE;
+        m_movingNodes.push_back(node);
+    }
+
+    std::erase_if(m_movingNodes, [&](std::uint32_t node) {
+        StaticState state = getState(node);
+        if (state == StaticState::Moving) {
+            return false;
+        }
+        m_nodeCells[node] = NO_CELL;
+        if (state == StaticState::Static) {
+            File(bounds, node);
+            Queue(m_nodeCells[node]);
+        }
+        return true;
+    });
+}
+
+void StaticBatchCells::Clear()
+{
+    m_cells.clear();
+    m_cellIndices.clear();
+    m_queue.clear();
+    m_nodeCells.clear();
+    m_nodePositions.clear();
+    m_movingNodes.clear();
+    m_sceneRevision = UINT64_MAX;
+    m_revision++;
+}
+
+void StaticBatchCells::TakeRebuilds(const CullBounds& bounds, size_t maxCells, std::vector<std::uint32_t>& cells)
+{
+    size_t count = std::min(maxCells, m_queue.size());
+    if (count > 0) {
+        m_revision++;
+    }
+    for (size_t queueIdx = 0; queueIdx < count; queueIdx++) {
+        std::uint32_t cellIdx = m_queue[queueIdx];
+        Cell& cell = m_cells[cellIdx];
+        cell.m_queued = false;
+        cell.m_built = !cell.m_nodes.empty();
+
+        glm::vec3 min {std::numeric_limits<float>::max()};
+        glm::vec3 max {std::numeric_limits<float>::lowest()};
+        for (std::uint32_t node : cell.m_nodes) {
+            min = glm::min(min, bounds.GetCenter(node) - bounds.GetExtent(node));
+            max = glm::max(max, bounds.GetCenter(node) + bounds.GetExtent(node));
+        }
+        cell.m_center = cell.m_built ? (min + max) * 0.5f : glm::vec3(0.0f);
+        cell.m_extent = cell.m_built ? (max - min) * 0.5f : glm::vec3(0.0f);
+        cells.push_back(cellIdx);
+    }
+    m_queue.erase(m_queue.begin(), m_queue.begin() + static_cast<std::ptrdiff_t>(count));
+}
+
+void StaticBatchCells::Requeue(std::span<const StaticBatchRebuild> rebuilds)
+{
+    for (const StaticBatchRebuild& rebuild : rebuilds) {
+        if (rebuild.m_cell < m_cells.size()) {
+            Queue(rebuild.m_cell);
+        }
+    }
+}
+
+void StaticBatchCells::Cull(const FrustumPlanes* planes, std::vector<std::uint32_t>& cells) const
+{
+    for (size_t cellIdx = 0; cellIdx < m_cells.size(); cellIdx++) {
+        const Cell& cell = m_cells[cellIdx];
+        if (!cell.m_built) {
+            continue;
+        }
+        std::uint8_t planeMask = ALL_PLANES;
+        if (!planes || TestAABB(*planes, cell.m_center, cell.m_extent, planeMask) != CullResult::Outside) {
+            cells.push_back(static_cast<std::uint32_t>(cellIdx));
+        }
+    }
+}
+
+std::uint32_t StaticBatchCells::GetCell(const glm::vec3& position)
+{
+    glm::ivec3 coords = glm::ivec3(
+        glm::clamp(glm::floor(position * m_invCellSize), glm::vec3(-CELL_LIMIT), glm::vec3(CELL_LIMIT)));
+    auto [found, inserted] = m_cellIndices.try_emplace(PackCell(coords), static_cast<std::uint32_t>(m_cells.size()));
+    if (inserted) {
+        m_cells.push_back(Cell {.m_nodes = {}, .m_center = {}, .m_extent = {}, .m_built = false, .m_queued = false});
+    }
+    return found->second;
+}
+
+void StaticBatchCells::File(const CullBounds& bounds, std::uint32_t node)
+{
+    std::uint32_t cell = GetCell(bounds.GetCenter(node));
+    m_nodeCells[node] = cell;
+    m_nodePositions[node] = static_cast<std::uint32_t>(m_cells[cell].m_nodes.size());
+    m_cells[cell].m_nodes.push_back(node);
+}
+
+void StaticBatchCells::Unfile(std::uint32_t node)
+{
+    // Fill its place with the last Node of the cell.
+    std::vector<std::uint32_t>& nodes = m_cells[m_nodeCells[node]].m_nodes;
+    std::uint32_t last = nodes.back();
+    nodes[m_nodePositions[node]] = last;
+    m_nodePositions[last] = m_nodePositions[node];
+    nodes.pop_back();
+    m_nodeCells[node] = NO_CELL;
+}
+
+void StaticBatchCells::Queue(std::uint32_t cell)
+{
+    // Its Nodes are drawn one by one until it's rebuilt.
+    if (m_cells[cell].m_built) {
+        m_cells[cell].m_built = false;
+        m_revision++;
+    }
+    if (!m_cells[cell].m_queued) {
+        m_cells[cell].m_queued = true;
+        m_queue.push_back(cell);
+    }
+}
+
+void StaticBatches::Create()
+{
+    glCreateBuffers(1, &m_partBuffer);
+    glObjectLabel(GL_BUFFER, m_partBuffer, -1, "Static Batch Parts");
+}
+
+void StaticBatches::Release()
+{
+    DeleteBuffers(1, &m_partBuffer);
+    m_partBuffer = 0;
+    m_partBufferSize = 0;
+    m_cells.clear();
+    m_retired.clear();
+    m_freeSlots.clear();
+    m_parts.clear();
+    m_partPages.clear();
+    m_slotCount = 0;
+    m_batchCount = 0;
+}
+
+void StaticBatches::BeginFrame(GeometryPool& pool)
+{
+    m_frame++;
+    std::erase_if(m_retired, [&](const Retired& retired) {
+        if (m_frame - retired.m_frame < Glitter::Config::FRAMES_IN_FLIGHT) {
+            return false;
+        }
+        pool.FreeVertices(retired.m_batch.m_range.m_page, retired.m_batch.m_range.m_baseVertex, retired.m_batch.m_vertexCount);
+        pool.FreeIndices(retired.m_batch.m_range);
+        pool.FreeIndices(retired.m_batch.m_proxyRange);
+        m_freeSlots.push_back(retired.m_batch.m_slot);
+        return true;
+    });
+}
+
+std::span<const StaticBatch> StaticBatches::Build(GeometryPool& pool, std::uint32_t cell, std::span<const StaticBatchDesc> batches,
+    std::span<const StaticBatchSource> sources)
+{
+    if (cell >= m_cells.size()) {
+        m_cells.resize(cell + 1);
+    }
+    Retire(cell);
+
+    bool shortIndices = pool.GetIndexType() == GL_UNSIGNED_SHORT;
+    std::vector<StaticBatch>& built = m_cells[cell];
+    for (const StaticBatchDesc& desc : batches) {
+        std::span<const StaticBatchSource> batchSources = sources.subspan(desc.m_firstSource, desc.m_sourceCount);
+        GLuint vertexCount = 0;
+        GLuint indexCount = 0;
+        GLuint proxyIndexCount = 0;
+        for (const StaticBatchSource& source : batchSources) {
+            vertexCount += source.m_vertexCount;
+            indexCount += GetPaddedIndexCount(source.m_indexCount, shortIndices);
+            proxyIndexCount += source.m_proxyIndexCount == 0 ? 0 : GetPaddedIndexCount(source.m_proxyIndexCount, shortIndices);
+        }
+        GeometryRange range = pool.Allocate(desc.m_page, vertexCount, indexCount, shortIndices ? 2 : 1);
+        GeometryRange proxyRange = pool.AllocateIndices(desc.m_page, range.m_baseVertex, proxyIndexCount, shortIndices ? 2 : 1);
+
+        std::uint32_t slot = m_slotCount;
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            m_slotCount++;
+        }
+
+        GLuint vertexOffset = 0;
+        GLuint indexOffset = 0;
+        GLuint proxyIndexOffset = 0;
+        for (const StaticBatchSource& source : batchSources) {
+            GLuint partIndexCount = GetPaddedIndexCount(source.m_indexCount, shortIndices);
+            m_parts.push_back(GpuPart {.m_transform = source.m_transform,
+                .m_sourceBaseVertex = source.m_baseVertex,
+                .m_sourceFirstIndex = source.m_firstIndex,
+                .m_vertexCount = source.m_vertexCount,
+                .m_sourceIndexCount = source.m_indexCount,
+                .m_baseVertex = static_cast<GLuint>(range.m_baseVertex) + vertexOffset,
+                .m_firstIndex = range.m_firstIndex + indexOffset,
+                .m_indexCount = partIndexCount,
+                .m_vertexOffset = vertexOffset});
+            // The proxy's part only copies indices, over the vertices the part above copies.
+            if (source.m_proxyIndexCount > 0) {
+                GLuint proxyPartIndexCount = GetPaddedIndexCount(source.m_proxyIndexCount, shortIndices);
+                m_parts.push_back(GpuPart {.m_transform = source.m_transform,
+                    .m_sourceBaseVertex = source.m_baseVertex,
+                    .m_sourceFirstIndex = source.m_proxyFirstIndex,
+                    .m_vertexCount = 0,
+                    .m_sourceIndexCount = source.m_proxyIndexCount,
+                    .m_baseVertex = static_cast<GLuint>(range.m_baseVertex) + vertexOffset,
+                    .m_firstIndex = proxyRange.m_firstIndex + proxyIndexOffset,
+                    .m_indexCount = proxyPartIndexCount,
+                    .m_vertexOffset = vertexOffset});
+                proxyIndexOffset += proxyPartIndexCount;
+            }
+            vertexOffset += source.m_vertexCount;
+            indexOffset += partIndexCount;
+        }
+        m_partPages.resize(m_parts.size(), desc.m_page);
+
+        built.push_back(StaticBatch {.m_range = range,
+            .m_proxyRange = proxyRange,
+            .m_vertexCount = static_cast<GLsizei>(vertexCount),
+            .m_texture = desc.m_texture,
+            .m_slot = slot});
+    }
+    m_batchCount += built.size();
+    return built;
+}
+
+void StaticBatches::Reset()
+{
+    for (size_t cell = 0; cell < m_cells.size(); cell++) {
+        Retire(static_cast<std::uint32_t>(cell));
+    }
+}
+
+void StaticBatches::Dispatch(RenderStats& stats, GLuint program, const GeometryPool& pool)
+{
+    if (m_parts.empty()) {
+        return;
+    }
+
+    size_t size = sizeof(GpuPart) * m_parts.size();
+    if (size > m_partBufferSize) {
+        m_partBufferSize = std::max(size, m_partBufferSize * 2);
+        NamedBufferData(GpuMemoryCategory::Buffer, m_partBuffer, static_cast<GLsizeiptr>(m_partBufferSize), nullptr,
+            GL_DYNAMIC_DRAW);
+    }
+    stats.NamedBufferSubData(m_partBuffer, 0, static_cast<GLsizeiptr>(size), m_parts.data());
+
+    stats.UseProgram(program);
+    stats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_partBuffer);
+
+    for (size_t pageBegin = 0; pageBegin < m_parts.size();) {
+        std::uint32_t page = m_partPages[pageBegin];
+        size_t pageEnd = pageBegin;
+        while (pageEnd < m_parts.size() && m_partPages[pageEnd] == page) {
+            pageEnd++;
+        }
+
+        stats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, pool.GetVBO(page));
+        stats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, pool.GetPositionVBO(page));
+        stats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, pool.GetEBO(page));
+
+        // One work group per part.
+        for (size_t firstPart = pageBegin; firstPart < pageEnd; firstPart += MAX_WORK_GROUPS) {
+            // uniform layout(location = 0) uint u_FirstPart;
+            glUniform1ui(0, static_cast<GLuint>(firstPart));
+            glDispatchCompute(static_cast<GLuint>(std::min(MAX_WORK_GROUPS, pageEnd - firstPart)), 1, 1);
+        }
+        pageBegin = pageEnd;
+    }
+    m_parts.clear();
+    m_partPages.clear();
+}
+
+void StaticBatches::Retire(std::uint32_t cell)
+{
+    for (const StaticBatch& batch : m_cells[cell]) {
+        m_retired.push_back(Retired {.m_frame = m_frame, .m_batch = batch});
+    }
+    m_batchCount -= m_cells[cell].size();
+    m_cells[cell].clear();
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,215 @@
+#pragma once
+
+#include "Config.h"
+#include "render/FrustumCulling.h"
+#include "render/GeometryPool.h"
+#include "render/RenderStats.h"
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Glitter::Render {
+
+// Whether a Node can be drawn from a static batch, see StaticBatchCells::Update().
+enum class StaticState : std::uint8_t {
+    // Never, e.g. transparent or animating.
+    Excluded,
+    // Once it stops moving.
+    Moving,
+    Static,
+};
+
+// A Primitive of a Node to pre-transform into a batch: its vertices and indices in the geometry pool, and the transform
+// from its vertices into the batch's. Its proxy indices, over the same vertices, are the ones its batch's HLOD proxy is
+// built from, none without one.
+struct StaticBatchSource {
+    glm::mat4 m_transform;
+    GLint m_baseVertex;
+    GLuint m_firstIndex;
+    GLuint m_vertexCount;
+    GLuint m_indexCount;
+    GLuint m_proxyFirstIndex;
+    GLuint m_proxyIndexCount;
+};
+
+// A batch to build from `m_sourceCount` sources starting at `m_firstSource`, drawn with `m_dequantize` as its model matrix
+// and with the texture and material of its Nodes. Its sources are all in geometry pool page `m_page`, where
+// StaticBatchCS.glsl copies them into the batch.
+struct StaticBatchDesc {
+    glm::mat4 m_dequantize;
+    std::uint32_t m_texture;
+    std::uint32_t m_material;
+    std::uint32_t m_page;
+    std::uint32_t m_firstSource;
+    std::uint32_t m_sourceCount;
+};
+
+// The batches a cell is rebuilt with, `m_batchCount` descs starting at `m_firstBatch`, none once the cell is empty.
+struct StaticBatchRebuild {
+    std::uint32_t m_cell;
+    std::uint32_t m_firstBatch;
+    std::uint32_t m_batchCount;
+};
+
+// Files the static Nodes into the cells of a uniform grid by the center of their bounds, each cell drawn from the batches
+// merging its Nodes' Primitives, see StaticBatches. A cell is rebuilt whenever a Node joins or leaves it, be it added,
+// removed or moving: a Node that moves leaves its cell, and joins one again once it's static again.
+//
+// Only tracks the Nodes, and which cells are built: the cells taken for a rebuild are built from then on, the batches
+// themselves being built along with the frame that took them. Runs along with the update of the Nodes.
+class StaticBatchCells {
+public:
+    explicit StaticBatchCells(float cellSize);
+
+    // Refiles the `dirtyNodes` of `bounds`, and the Nodes that stopped moving by `getState`. A new `sceneRevision` refiles
+    // every Node instead, only rebuilding the cells whose Nodes were added, removed or moved.
+    void Update(std::span<const std::uint32_t> dirtyNodes, std::uint64_t sceneRevision, const CullBounds& bounds,
+        const std::function<StaticState(size_t)>& getState);
+    // Forgets every cell, the caller has to drop their batches.
+    void Clear();
+
+    // Takes up to `maxCells` of the cells waiting for a rebuild, appending them to `cells`, and builds them around
+    // `bounds`, see GetCenter() and GetExtent().
+    void TakeRebuilds(const CullBounds& bounds, size_t maxCells, std::vector<std::uint32_t>& cells);
+    // The rebuilds were dropped along with their frame, their cells wait for another one.
+    void Requeue(std::span<const StaticBatchRebuild> rebuilds);
+
+    // Appends the built cells intersecting the frustum, or every built cell without `planes`, to `cells`.
+    void Cull(const FrustumPlanes* planes, std::vector<std::uint32_t>& cells) const;
+
+    // Whether `node` is drawn from the batches of its cell this frame.
+    bool IsBatched(size_t node) const
+    {
+        return node < m_nodeCells.size() && m_nodeCells[node] < MOVING_NODE && m_cells[m_nodeCells[node]].m_built;
+    }
+
+    std::span<const std::uint32_t> GetNodes(std::uint32_t cell) const { return m_cells[cell].m_nodes; }
+    // The box around the cell's Nodes when it was last taken for a rebuild.
+    const glm::vec3& GetCenter(std::uint32_t cell) const { return m_cells[cell].m_center; }
+    const glm::vec3& GetExtent(std::uint32_t cell) const { return m_cells[cell].m_extent; }
+    size_t GetQueuedCount() const { return m_queue.size(); }
+    bool IsEmpty() const { return m_cells.empty(); }
+    // Incremented whenever a cell is built or waits for a rebuild, and so whenever IsBatched() may have changed.
+    std::uint64_t GetRevision() const { return m_revision; }
+
+private:
+    // In m_nodeCells, for the Nodes in no cell, and for the ones in m_movingNodes.
+    static constexpr std::uint32_t NO_CELL = UINT32_MAX;
+    static constexpr std::uint32_t MOVING_NODE = UINT32_MAX - 1;
+
+    struct Cell {
+        std::vector<std::uint32_t> m_nodes;
+        glm::vec3 m_center;
+        glm::vec3 m_extent;
+        bool m_built;
+        bool m_queued;
+    };
+
+    std::uint32_t GetCell(const glm::vec3& position);
+    void File(const CullBounds& bounds, std::uint32_t node);
+    void Unfile(std::uint32_t node);
+    void Queue(std::uint32_t cell);
+
+    float m_invCellSize;
+    std::uint64_t m_sceneRevision {UINT64_MAX};
+    std::uint64_t m_revision {};
+
+    // Cells are never removed, so their indices stay valid for the rebuilds in flight.
+    std::vector<Cell> m_cells;
+    std::unordered_map<std::uint64_t, std::uint32_t> m_cellIndices;
+    std::vector<std::uint32_t> m_queue;
+
+    // The cell of each Node, and its position in the cell's m_nodes.
+    std::vector<std::uint32_t> m_nodeCells;
+    std::vector<std::uint32_t> m_nodePositions;
+    std::vector<std::uint32_t> m_movingNodes;
+};
+
+// A built batch: its vertices and indices in the geometry pool, drawn as a single command, and its slot of the batch data
+// the caller writes its model matrix, texture and material into. Its HLOD proxy is another index list over the same
+// vertices, drawn with the same slot in its place from afar, empty if its sources had no proxy indices.
+struct StaticBatch {
+    GeometryRange m_range;
+    GeometryRange m_proxyRange;
+    GLsizei m_vertexCount;
+    std::uint32_t m_texture;
+    std::uint32_t m_slot;
+};
+
+// The batches of the cells of StaticBatchCells, allocated from the geometry pool along with the Meshes, in the same vertex
+// format, so that they're drawn by the same VAOs and programs as the Nodes. StaticBatchCS.glsl copies each source
+// Primitive into its batch on the GPU, transforming its positions and normals on the way, since the Meshes' vertices
+// aren't kept on the CPU once uploaded. The proxy indices of the sources are copied along into the batch's HLOD proxy,
+// rebased onto the vertices their Primitive was copied into, so that the proxies take no vertices of their own.
+//
+// Freed batches are only handed out again after Config::FRAMES_IN_FLIGHT frames, once the GPU no longer draws them.
+class StaticBatches {
+public:
+    void Create();
+    void Release();
+
+    // Frees the batches dropped Config::FRAMES_IN_FLIGHT frames ago.
+    void BeginFrame(GeometryPool& pool);
+
+    // Drops the batches of `cell` for the ones of `batches`, from `sources`, and queues their sources for Dispatch().
+    // Returns the new batches, in the order of `batches`.
+    std::span<const StaticBatch> Build(GeometryPool& pool, std::uint32_t cell, std::span<const StaticBatchDesc> batches,
+        std::span<const StaticBatchSource> sources);
+    // Drops the batches of every cell.
+    void Reset();
+
+    // Pre-transforms the sources queued since the last call with `program`, once the geometry pool holds every batch.
+    // Leaves the barriers to the caller.
+    void Dispatch(RenderStats& stats, GLuint program, const GeometryPool& pool);
+    bool HasQueuedSources() const { return !m_parts.empty(); }
+
+    std::span<const StaticBatch> GetBatches(std::uint32_t cell) const
+    {
+        return cell < m_cells.size() ? std::span<const StaticBatch>(m_cells[cell]) : std::span<const StaticBatch> {};
+    }
+    // Past every slot in use.
+    std::uint32_t GetSlotCapacity() const { return m_slotCount; }
+    size_t GetBatchCount() const { return m_batchCount; }
+
+private:
+    // Matches the std430 layout of `b_Parts` in StaticBatchCS.glsl.
+    struct alignas(16) GpuPart {
+        glm::mat4 m_transform;
+        GLint m_sourceBaseVertex;
+        GLuint m_sourceFirstIndex;
+        GLuint m_vertexCount;
+        GLuint m_sourceIndexCount;
+        GLuint m_baseVertex;
+        GLuint m_firstIndex;
+        GLuint m_indexCount;
+        GLuint m_vertexOffset;
+    };
+
+    struct Retired {
+        std::uint64_t m_frame;
+        StaticBatch m_batch;
+    };
+
+    void Retire(std::uint32_t cell);
+
+    std::vector<std::vector<StaticBatch>> m_cells;
+    std::vector<Retired> m_retired;
+    std::vector<std::uint32_t> m_freeSlots;
+    std::uint32_t m_slotCount {};
+    size_t m_batchCount {};
+    std::uint64_t m_frame {};
+
+    // The page of each part, those of a batch queued together.
+    std::vector<GpuPart> m_parts;
+    std::vector<std::uint32_t> m_partPages;
+    GLuint m_partBuffer {};
+    size_t m_partBufferSize {};
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,72 @@
+#include "render/StereoTargets.h"
+
+#include "render/GLExtensions.h"
+#include "render/GpuMemory.h"
+
+namespace Glitter::Render {
+
+std::array<glm::mat4, 2> GetStereoViews(const glm::mat4& view, float separation)
+{
+    // Moving an eye to the left moves the world to its right.
+    glm::vec3 offset(separation * 0.5f, 0.0f, 0.0f);
+    return {glm::translate(glm::mat4(1.0f), offset) * view, glm::translate(glm::mat4(1.0f), -offset) * view};
+}
+
+void StereoTargets::Create(GLuint fbo, GLenum colorFormat, GLsizei width, GLsizei height)
+{
+    Release();
+
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_color);
+    TextureStorage3D(GpuMemoryCategory::RenderTarget, m_color, 1, colorFormat, width, height, VIEW_COUNT);
+    glObjectLabel(GL_TEXTURE, m_color, -1, "Stereo Color Texture");
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_depth);
+    TextureStorage3D(GpuMemoryCategory::RenderTarget, m_depth, 1, GL_DEPTH_COMPONENT32F, width, height, VIEW_COUNT);
+    glObjectLabel(GL_TEXTURE, m_depth, -1, "Stereo Depth Texture");
+
+    // The extension has no direct state access entry point.
+    const GLExtensions& extensions = GetGLExtensions();
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+    extensions.m_framebufferTextureMultiview(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_color, 0, 0, VIEW_COUNT);
+    extensions.m_framebufferTextureMultiview(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_depth, 0, 0, VIEW_COUNT);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    if (glCheckNamedFramebufferStatus(fbo, GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        spdlog::error("The stereo FBO is incomplete.");
+    }
+
+    glCreateFramebuffers(1, &m_readFbo);
+    glObjectLabel(GL_FRAMEBUFFER, m_readFbo, -1, "Stereo Present FBO");
+}
+
+void StereoTargets::Release()
+{
+    DeleteTextures(1, &m_color);
+    DeleteTextures(1, &m_depth);
+    glDeleteFramebuffers(1, &m_readFbo);
+    m_color = 0;
+    m_depth = 0;
+    m_readFbo = 0;
+}
+
+void StereoTargets::AddPresentPass(RenderGraph& graph, RenderResource color, GLsizei width, GLsizei height,
+    RenderResource backbuffer, GLsizei presentWidth, GLsizei presentHeight, GpuProfiler& profiler)
+{
+    graph
+        .AddPass("Stereo Present",
+            [=, this, &profiler](const RenderGraph& run) {
+                profiler.PushGroup(0, "Stereo Present");
+                {
+                    GLsizei eyeWidth = presentWidth / VIEW_COUNT;
+                    bool upscale = eyeWidth != width || presentHeight != height;
+                    for (GLint view = 0; view < VIEW_COUNT; view++) {
+                        glNamedFramebufferTextureLayer(m_readFbo, GL_COLOR_ATTACHMENT0, run.Get(color), 0, view);
+                        glBlitNamedFramebuffer(m_readFbo, run.Get(backbuffer), 0, 0, width, height, view * eyeWidth, 0,
+                            (view + 1) * eyeWidth, presentHeight, GL_COLOR_BUFFER_BIT, upscale ? GL_LINEAR : GL_NEAREST);
+                    }
+                }
+                profiler.PopGroup();
+            })
+        .Read(color, RenderAccess::Framebuffer)
+        .Overwrite(backbuffer, RenderAccess::Framebuffer);
+}
+
+} // namespace Glitter::Render
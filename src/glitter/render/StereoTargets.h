@@ -0,0 +1,42 @@
+#pragma once
+
+#include "render/GpuProfiler.h"
+#include "render/RenderGraph.h"
+
+#include <glad/glad.h>
+
+#include <array>
+
+namespace Glitter::Render {
+
+// The left and right eye's Views, `separation` apart along the x axis of `view`, which is between them.
+std::array<glm::mat4, 2> GetStereoViews(const glm::mat4& view, float separation);
+
+// The main pass' targets when rendering in stereo: a color and a depth GL_TEXTURE_2D_ARRAY of a layer per eye, attached
+// to an FBO through GL_OVR_multiview, so that every draw is rasterized into both layers at once, each with the
+// View-Projection its vertex shader picks by gl_ViewID_OVR. The eyes are presented side by side.
+class StereoTargets {
+public:
+    static constexpr GLsizei VIEW_COUNT = 2;
+
+    // Allocates `width` by `height` layers, of `colorFormat` for the color, and attaches them to `fbo`, replacing its
+    // color and depth attachments.
+    void Create(GLuint fbo, GLenum colorFormat, GLsizei width, GLsizei height);
+    void Release();
+
+    GLuint GetColorTexture() const { return m_color; }
+    GLuint GetDepthTexture() const { return m_depth; }
+
+    // Adds the pass blitting the `width` by `height` viewport of each layer of `color` to its half of the `presentWidth`
+    // by `presentHeight` `backbuffer` to `graph`, timed by `profiler`.
+    void AddPresentPass(RenderGraph& graph, RenderResource color, GLsizei width, GLsizei height, RenderResource backbuffer,
+        GLsizei presentWidth, GLsizei presentHeight, GpuProfiler& profiler);
+
+private:
+    GLuint m_color {};
+    GLuint m_depth {};
+    // Reads a single layer of m_color at a time, multiview framebuffers can't be blitted from.
+    GLuint m_readFbo {};
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,83 @@
+#include "render/StreamBuffer.h"
+
+#include "render/GpuMemory.h"
+
+namespace Glitter::Render {
+
+void StreamBuffer::Create(size_t regionSize, size_t alignment, const char* label)
+{
+    m_alignment = alignment;
+    m_label = label;
+    Allocate(regionSize);
+}
+
+void StreamBuffer::Release()
+{
+    for (size_t region = 0; region < m_fences.size(); region++) {
+        WaitForRegion(region);
+    }
+
+    if (m_buffer) {
+        glUnmapNamedBuffer(m_buffer);
+        DeleteBuffers(1, &m_buffer);
+    }
+    m_buffer = 0;
+    m_mappedData = nullptr;
+}
+
+std::span<std::byte> StreamBuffer::BeginFrame()
+{
+    m_currentRegion = (m_currentRegion + 1) % m_fences.size();
+    WaitForRegion(m_currentRegion);
+    return GetCurrentRegion();
+}
+
+void StreamBuffer::EndFrame()
+{
+    m_fences[m_currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+std::span<std::byte> StreamBuffer::Grow(size_t regionSize)
+{
+    Release();
+    Allocate(regionSize);
+    return GetCurrentRegion();
+}
+
+void StreamBuffer::Allocate(size_t regionSize)
+{
+    // Keep each region's offset usable with glBindBufferRange.
+    m_regionSize = (regionSize + m_alignment - 1) / m_alignment * m_alignment;
+
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    auto bufferSize = static_cast<GLsizeiptr>(m_regionSize * m_fences.size());
+
+    glCreateBuffers(1, &m_buffer);
+    NamedBufferStorage(GpuMemoryCategory::StreamBuffer, m_buffer, bufferSize, nullptr, flags);
+    glObjectLabel(GL_BUFFER, m_buffer, -1, m_label.c_str());
+    m_mappedData = static_cast<std::byte*>(glMapNamedBufferRange(m_buffer, 0, bufferSize, flags));
+}
+
+void StreamBuffer::WaitForRegion(size_t region)
+{
+    GLsync& fence = m_fences[region];
+    if (!fence) {
+        return;
+    }
+
+    // Flush on the first wait, in case the fence hasn't been submitted yet.
+    GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (glClientWaitSync(fence, waitFlags, 1'000'000) == GL_TIMEOUT_EXPIRED) {
+        waitFlags = 0;
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+std::span<std::byte> StreamBuffer::GetCurrentRegion()
+{
+    return {m_mappedData + GetRegionOffset(), m_regionSize};
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Config.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string>
+
+namespace Glitter::Render {
+
+// A persistently-mapped buffer split into Glitter::Config::FRAMES_IN_FLIGHT regions. The CPU writes one region per frame
+// while the GPU reads the previous ones, and each region is fenced after its frame is submitted so that it's only
+// rewritten once the GPU is done with it.
+class StreamBuffer {
+public:
+    void Create(size_t regionSize, size_t alignment, const char* label);
+    void Release();
+
+    // Waits until the next region is no longer in use by the GPU and returns it as the current region.
+    std::span<std::byte> BeginFrame();
+    // Fences the current region, must be called after every command reading from it has been issued.
+    void EndFrame();
+
+    // Reallocates every region to hold at least `regionSize` bytes and returns the new current region. Waits for the GPU to
+    // release the old buffer, so it should only happen on the rare frames that outgrow it.
+    std::span<std::byte> Grow(size_t regionSize);
+
+    GLuint GetBuffer() const { return m_buffer; }
+    size_t GetRegionOffset() const { return m_regionSize * m_currentRegion; }
+    size_t GetRegionSize() const { return m_regionSize; }
+    size_t GetAlignment() const { return m_alignment; }
+
+private:
+    void Allocate(size_t regionSize);
+    void WaitForRegion(size_t region);
+    std::span<std::byte> GetCurrentRegion();
+
+    GLuint m_buffer {};
+    std::byte* m_mappedData {};
+
+    size_t m_regionSize {};
+    size_t m_alignment {1};
+    size_t m_currentRegion {};
+    std::array<GLsync, Glitter::Config::FRAMES_IN_FLIGHT> m_fences {};
+
+    std::string m_label;
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,35 @@
+#include "render/SubmitFlusher.h"
+
+#include "Config.h"
+
+#include <glad/glad.h>
+
+namespace Glitter::Render {
+
+void SubmitFlusher::BeginFrame(bool enabled)
+{
+    m_enabled = enabled;
+    m_pendingCommands = 0;
+    m_lastFlushCount = m_flushCount;
+    m_flushCount = 0;
+}
+
+void SubmitFlusher::CountCommands(size_t commands)
+{
+    m_pendingCommands += commands;
+    if (m_pendingCommands >= Glitter::Config::SUBMIT_FLUSH_COMMANDS) {
+        Flush();
+    }
+}
+
+void SubmitFlusher::Flush()
+{
+    if (!m_enabled) {
+        return;
+    }
+    glFlush();
+    m_pendingCommands = 0;
+    m_flushCount++;
+}
+
+} // namespace Glitter::Render
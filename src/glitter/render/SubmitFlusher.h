@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Glitter::Render {
+
+// Flushes the commands of a frame at the points where the CPU still has work of its own to do, such as building the
+// draw batches or Dear ImGui's draw lists. The GPU then starts on the commands issued so far, instead of idling until
+// the swap flushes the whole frame. Draws are counted as they're issued and flushed every
+// Glitter::Config::SUBMIT_FLUSH_COMMANDS commands, so the GPU also starts on a long pass before its last batch is issued.
+class SubmitFlusher {
+public:
+    // Keeps the previous frame's flush count. Nothing is flushed early while `enabled` is false.
+    void BeginFrame(bool enabled);
+
+    // Counts `commands` draw commands issued, and flushes once Config::SUBMIT_FLUSH_COMMANDS were since the last flush.
+    void CountCommands(size_t commands);
+    // Flushes whatever was issued since the last flush.
+    void Flush();
+
+    // Of the previous frame.
+    size_t GetFlushCount() const { return m_lastFlushCount; }
+
+private:
+    bool m_enabled {};
+    size_t m_pendingCommands {};
+    size_t m_flushCount {};
+    size_t m_lastFlushCount {};
+};
+
+} // namespace Glitter::Render
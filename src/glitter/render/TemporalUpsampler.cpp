@@ -0,0 +1,132 @@
+#include "render/TemporalUpsampler.h"
+
+#include "Config.h"
+
+namespace Glitter::Render {
+
+namespace {
+
+    // Matches TemporalUpsampleCS.glsl.
+    constexpr GLsizei TEMPORAL_UPSAMPLE_GROUP_SIZE = 8;
+
+    // The `index`-th point of the Halton sequence of `base`, in [0, 1).
+    float Halton(std::uint32_t index, std::uint32_t base)
+    {
+        float result = 0.0f;
+        float fraction = 1.0f;
+        while (index > 0) {
+            fraction /= static_cast<float>(base);
+            result += fraction * static_cast<float>(index % base);
+            index /= base;
+        }
+        return result;
+    }
+
+} // namespace
+
+void TemporalUpsampler::Create(RenderTargetPool& pool, GLsizei width, GLsizei height)
+{
+    Release(pool);
+
+    // Sampled bilinearly when reprojected, clamped so that the pixels reprojected off the edges read the closest ones.
+    for (RenderTarget& history : m_history) {
+        history = pool.Acquire(GL_RGBA16F, width, height, 1, "Temporal Upsampling History");
+        glTextureParameteri(history.m_texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTextureParameteri(history.m_texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTextureParameteri(history.m_texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(history.m_texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    m_historyValid = false;
+}
+
+void TemporalUpsampler::Release(RenderTargetPool& pool)
+{
+    for (RenderTarget& history : m_history) {
+        pool.Release(history);
+    }
+    m_historyValid = false;
+}
+
+glm::vec2 TemporalUpsampler::NextJitter()
+{
+    // The sequence starts from 1, its first point being the origin.
+    std::uint32_t index = m_jitterIdx % Config::TEMPORAL_UPSAMPLING_JITTER_PHASES + 1;
+    m_jitterIdx++;
+    return glm::vec2(Halton(index, 2), Halton(index, 3)) - 0.5f;
+}
+
+glm::mat4 TemporalUpsampler::ApplyJitter(const glm::mat4& viewProjection, glm::vec2 jitter, GLsizei width, GLsizei height)
+{
+    // A pixel spans 2 / size of the NDC, scaled back into clip space by w.
+    glm::vec2 offset = 2.0f * jitter / glm::vec2(width, height);
+    return glm::translate(glm::mat4(1.0f), glm::vec3(offset, 0.0f)) * viewProjection;
+}
+
+RenderResource TemporalUpsampler::AddPass(RenderGraph& graph, GLuint program, RenderResource color, RenderResource depth,
+    GLsizei width, GLsizei height, const glm::mat4& viewProjection, glm::vec2 jitter,
+    std::optional<WeightedOitTargets> oit, GLsizei outputWidth, GLsizei outputHeight, RenderStats& stats,
+    GpuProfiler& profiler)
+{
+    // The history of another output size doesn't line up with this one's pixels.
+    bool historyValid = m_historyValid && m_historyWidth == outputWidth && m_historyHeight == outputHeight;
+    // Takes the pixels of this frame's unjittered clip space to the previous frame's.
+    glm::mat4 reprojection = m_historyViewProjection * glm::inverse(viewProjection);
+    RenderResource history = graph.Import(RenderResourceType::Texture, m_history[m_current].m_texture);
+    m_current = (m_current + 1) % m_history.size();
+    RenderResource output = graph.Import(RenderResourceType::Texture, m_history[m_current].m_texture);
+    glm::vec2 historyScale = glm::vec2(outputWidth, outputHeight)
+        / glm::vec2(m_history[m_current].m_width, m_history[m_current].m_height);
+
+    m_historyValid = true;
+    m_historyWidth = outputWidth;
+    m_historyHeight = outputHeight;
+    m_historyViewProjection = viewProjection;
+
+    RenderPassBuilder pass = graph.AddPass("Temporal Upsampling", [=, &stats, &profiler](const RenderGraph& run) {
+        profiler.PushGroup(0, "Temporal Upsampling");
+        {
+            stats.UseProgram(program);
+            stats.BindTextureUnit(0, run.Get(color));
+            stats.BindTextureUnit(1, run.Get(depth));
+            stats.BindTextureUnit(2, run.Get(history));
+            if (oit) {
+                stats.BindTextureUnit(3, run.Get(oit->m_accumulation));
+                stats.BindTextureUnit(4, run.Get(oit->m_revealage));
+            }
+            glBindImageTexture(0, run.Get(output), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
+            // uniform layout(location = 0) ivec2 u_InputSize;
+            // uniform layout(location = 1) ivec2 u_OutputSize;
+            // uniform layout(location = 2) vec2 u_Jitter;
+            // uniform layout(location = 3) mat4 u_Reprojection;
+            // uniform layout(location = 4) vec2 u_HistoryScale;
+            // uniform layout(location = 5) bool u_HistoryValid;
+            // uniform layout(location = 6) bool u_CompositeOit;
+            // uniform layout(location = 7) float u_Blend;
+            glUniform2i(0, width, height);
+            glUniform2i(1, outputWidth, outputHeight);
+            glUniform2f(2, jitter.x, jitter.y);
+            glUniformMatrix4fv(3, 1, GL_FALSE, glm::value_ptr(reprojection));
+            glUniform2f(4, historyScale.x, historyScale.y);
+            glUniform1i(5, historyValid ? GL_TRUE : GL_FALSE);
+            glUniform1i(6, oit ? GL_TRUE : GL_FALSE);
+            glUniform1f(7, Config::TEMPORAL_UPSAMPLING_BLEND);
+
+            glDispatchCompute(static_cast<GLuint>((outputWidth + TEMPORAL_UPSAMPLE_GROUP_SIZE - 1) / TEMPORAL_UPSAMPLE_GROUP_SIZE),
+                static_cast<GLuint>((outputHeight + TEMPORAL_UPSAMPLE_GROUP_SIZE - 1) / TEMPORAL_UPSAMPLE_GROUP_SIZE), 1);
+        }
+        profiler.PopGroup();
+    });
+    pass.Read(color, RenderAccess::TextureFetch)
+        .Read(depth, RenderAccess::TextureFetch)
+        .Read(history, RenderAccess::TextureFetch)
+        .Overwrite(output, RenderAccess::ImageLoadStore);
+    if (oit) {
+        pass.Read(oit->m_accumulation, RenderAccess::TextureFetch).Read(oit->m_revealage, RenderAccess::TextureFetch);
+    }
+    // Read again by the next frame's pass.
+    graph.Keep(output);
+    return output;
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "render/GpuProfiler.h"
+#include "render/PostProcessor.h"
+#include "render/RenderGraph.h"
+#include "render/RenderStats.h"
+#include "render/RenderTargetPool.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace Glitter::Render {
+
+// Upsamples a scene color rendered below the output resolution by accumulating it over the frames: the main pass'
+// projection is offset by a different sub-pixel jitter every frame, and each output pixel blends the jittered samples
+// around it into its history, reprojected from where the camera saw it the previous frame. The reprojection is
+// reconstructed from the depth, so it only follows the camera; the history of moving Nodes is instead clipped to the
+// colors of the new samples around each pixel, which also rejects what was disoccluded. The history is a pair of RGBA16F
+// targets, read and written in turn.
+class TemporalUpsampler {
+public:
+    // Allocates the history for outputs of up to `width` by `height`, from `pool`. It starts out empty.
+    void Create(RenderTargetPool& pool, GLsizei width, GLsizei height);
+    void Release(RenderTargetPool& pool);
+
+    // Drops the history, so that the next output is only made of its frame's samples, e.g. after a camera cut.
+    void Reset() { m_historyValid = false; }
+
+    // The jitter of the next frame, in pixels within [-0.5, 0.5], cycling through Config::TEMPORAL_UPSAMPLING_JITTER_PHASES
+    // points of the Halton (2, 3) sequence.
+    glm::vec2 NextJitter();
+    // `viewProjection` with its clip space offset by `jitter` pixels of a `width` by `height` viewport.
+    static glm::mat4 ApplyJitter(const glm::mat4& viewProjection, glm::vec2 jitter, GLsizei width, GLsizei height);
+
+    // Adds the pass upsampling the `width` by `height` viewport of `color` and `depth`, rendered with the unjittered
+    // `viewProjection` offset by `jitter`, into the `outputWidth` by `outputHeight` viewport of the returned history, to
+    // `graph`. `oit` is composited over each sample first, when given. `program` is the TemporalUpsampleCS compute
+    // program, bound through `stats` and timed by `profiler`. The output viewport must fit in the history.
+    RenderResource AddPass(RenderGraph& graph, GLuint program, RenderResource color, RenderResource depth, GLsizei width,
+        GLsizei height, const glm::mat4& viewProjection, glm::vec2 jitter, std::optional<WeightedOitTargets> oit,
+        GLsizei outputWidth, GLsizei outputHeight, RenderStats& stats, GpuProfiler& profiler);
+
+private:
+    std::array<RenderTarget, 2> m_history {};
+    // The history written by the latest pass, read by the next one.
+    size_t m_current {};
+    bool m_historyValid {};
+    GLsizei m_historyWidth {};
+    GLsizei m_historyHeight {};
+    glm::mat4 m_historyViewProjection {1.0f};
+    std::uint32_t m_jitterIdx {};
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,121 @@
+#include "render/TextureCache.h"
+
+#include "render/GpuMemory.h"
+
+#include <filesystem>
+#include <span>
+
+namespace Glitter::Render {
+
+namespace {
+
+    // 64-bit FNV-1a, continued from `hash`.
+    std::uint64_t Hash(std::uint64_t hash, std::span<const std::byte> data)
+    {
+        for (std::byte value : data) {
+            hash = (hash ^ static_cast<std::uint64_t>(value)) * 0x0000'0100'0000'01B3;
+        }
+        return hash;
+    }
+
+    template <typename T> std::uint64_t Hash(std::uint64_t hash, const T& value)
+    {
+        return Hash(hash, std::as_bytes(std::span(&value, 1)));
+    }
+
+} // namespace
+
+std::string TextureCache::NormalizePath(std::string_view path)
+{
+    return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+std::uint64_t TextureCache::HashContents(const DecodedTexture& texture)
+{
+    size_t levelCount = GetLevelCount(texture);
+    std::uint64_t hash = Hash(Hash(0xCBF2'9CE4'8422'2325, GetInternalFormat(texture)), levelCount);
+    for (size_t level = 0; level < levelCount; level++) {
+        hash = Hash(Hash(hash, GetLevelSize(texture, level)), GetLevelData(texture, level));
+    }
+    return hash;
+}
+
+GLuint TextureCache::Acquire(std::string_view path)
+{
+    auto cached = m_byPath.find(NormalizePath(path));
+    if (cached == m_byPath.end()) {
+        return 0;
+    }
+    m_entries.at(cached->second).m_references++;
+    return cached->second;
+}
+
+GLuint TextureCache::Acquire(std::string_view path, std::uint64_t contentHash)
+{
+    auto cached = m_byContents.find(contentHash);
+    if (cached == m_byContents.end()) {
+        return 0;
+    }
+
+    Entry& entry = m_entries.at(cached->second);
+    entry.m_references++;
+    std::string normalized = NormalizePath(path);
+    if (m_byPath.try_emplace(normalized, cached->second).second) {
+        entry.m_paths.push_back(std::move(normalized));
+    }
+    return cached->second;
+}
+
+void TextureCache::Insert(std::string_view path, std::uint64_t contentHash, GLuint texture)
+{
+    std::string normalized = NormalizePath(path);
+    m_byPath.insert_or_assign(normalized, texture);
+    m_byContents.insert_or_assign(contentHash, texture);
+    m_entries.insert_or_assign(
+        texture, Entry {.m_references = 1, .m_contentHash = contentHash, .m_paths = {std::move(normalized)}});
+}
+
+void TextureCache::Release(GLuint texture)
+{
+    auto entry = m_entries.find(texture);
+    if (entry == m_entries.end() || --entry->second.m_references > 0) {
+        return;
+    }
+
+    // Forgotten right away, so that loading it again creates it anew rather than reviving a retired texture.
+    for (const std::string& path : entry->second.m_paths) {
+        if (auto cached = m_byPath.find(path); cached != m_byPath.end() && cached->second == texture) {
+            m_byPath.erase(cached);
+        }
+    }
+    if (auto cached = m_byContents.find(entry->second.m_contentHash); cached != m_byContents.end() && cached->second == texture) {
+        m_byContents.erase(cached);
+    }
+    m_entries.erase(entry);
+    m_retired.push_back(Retired {.m_texture = texture, .m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)});
+}
+
+void TextureCache::Collect(bool wait)
+{
+    while (!m_retired.empty()) {
+        Retired& retired = m_retired.front();
+        if (wait) {
+            // Flush on the first wait, in case the fence hasn't been submitted yet.
+            GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            while (glClientWaitSync(retired.m_fence, waitFlags, 1'000'000) == GL_TIMEOUT_EXPIRED) {
+                waitFlags = 0;
+            }
+        } else {
+            GLenum status = glClientWaitSync(retired.m_fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+                break;
+            }
+        }
+
+        glDeleteSync(retired.m_fence);
+        DeleteTextures(1, &retired.m_texture);
+        m_retired.pop_front();
+    }
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "render/TextureDecoder.h"
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Glitter::Render {
+
+// Shares the GL textures loaded from the same file, or decoded into the same contents, so that each is created once
+// however many times it's loaded. Each texture is reference-counted, and the last Release() retires it: it's only deleted
+// once a fence inserted then signals, after the GPU is done with every frame issued so far, by Collect().
+class TextureCache {
+public:
+    // Lexically normalized with forward slashes, so that the spellings of a path share their texture.
+    static std::string NormalizePath(std::string_view path);
+    // The hash of every level of `texture`, and of its format and size.
+    static std::uint64_t HashContents(const DecodedTexture& texture);
+
+    // The texture cached under the normalized `path`, with a reference more, or 0 if there's none.
+    GLuint Acquire(std::string_view path);
+    // The texture whose contents hash to `contentHash`, with a reference more, and cached under `path` too from then on.
+    // 0 if there's none.
+    GLuint Acquire(std::string_view path, std::uint64_t contentHash);
+    // Caches `texture`, created from `path` with `contentHash`, holding a single reference.
+    void Insert(std::string_view path, std::uint64_t contentHash, GLuint texture);
+    // Drops a reference to `texture`, retiring it with the last one.
+    void Release(GLuint texture);
+
+    // Deletes the retired textures whose fence signaled, or every one of them with `wait`, blocking on their fences.
+    void Collect(bool wait);
+
+    size_t GetTextureCount() const { return m_entries.size(); }
+    size_t GetRetiredCount() const { return m_retired.size(); }
+
+private:
+    struct Entry {
+        std::uint32_t m_references;
+        std::uint64_t m_contentHash;
+        std::vector<std::string> m_paths;
+    };
+
+    struct Retired {
+        GLuint m_texture;
+        GLsync m_fence;
+    };
+
+    std::unordered_map<std::string, GLuint> m_byPath;
+    std::unordered_map<std::uint64_t, GLuint> m_byContents;
+    std::unordered_map<GLuint, Entry> m_entries;
+    // Oldest first, their fences signal in order.
+    std::deque<Retired> m_retired;
+};
+
+} // namespace Glitter::Render
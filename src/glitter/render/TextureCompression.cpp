@@ -0,0 +1,386 @@
+#include "render/TextureCompression.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace Glitter::Render {
+
+namespace {
+
+    // Interpolation weights of BC7's 4-bit indices, out of 64.
+    constexpr std::array<int, 16> BC7_WEIGHTS4 {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    // Fits a line through `points` along their principal axis, returning its ends at the extreme projections.
+    template <int N> std::array<glm::vec<N, float>, 2> FitPrincipalAxis(const std::array<glm::vec<N, float>, 16>& points)
+    {
+        using Vec = glm::vec<N, float>;
+
+        Vec mean(0.0f);
+        Vec low(255.0f);
+        Vec high(0.0f);
+        for (const Vec& point : points) {
+            mean += point / 16.0f;
+            low = glm::min(low, point);
+            high = glm::max(high, point);
+        }
+
+        std::array<Vec, N> covariance {};
+        for (const Vec& point : points) {
+            Vec offset = point - mean;
+            for (int row = 0; row < N; row++) {
+                covariance[row] += offset * offset[row];
+            }
+        }
+
+        // Power iteration from the bounding box diagonal.
+        Vec axis = high - low;
+        for (int iteration = 0; iteration < 8; iteration++) {
+            Vec next(0.0f);
+            for (int row = 0; row < N; row++) {
+                next[row] = glm::dot(covariance[row], axis);
+            }
+            float length = glm::length(next);
+            if (!(length > 0.0f)) {
+                break;
+            }
+            axis = next / length;
+        }
+        if (!(glm::length(axis) > 0.0f)) {
+            return {mean, mean};
+        }
+        axis = glm::normalize(axis);
+
+        float minProjection = 0.0f;
+        float maxProjection = 0.0f;
+        for (const Vec& point : points) {
+            float projection = glm::dot(point - mean, axis);
+            minProjection = std::min(minProjection, projection);
+            maxProjection = std::max(maxProjection, projection);
+        }
+
+        return {glm::clamp(mean + axis * minProjection, Vec(0.0f), Vec(255.0f)),
+            glm::clamp(mean + axis * maxProjection, Vec(0.0f), Vec(255.0f))};
+    }
+
+    // Least squares endpoints for texels at fixed interpolation weights `t` between them. Returns false if every texel
+    // has the same weight.
+    template <int N>
+    bool RefineEndpoints(const std::array<glm::vec<N, float>, 16>& points, const std::array<float, 16>& t,
+        std::array<glm::vec<N, float>, 2>& endpoints)
+    {
+        using Vec = glm::vec<N, float>;
+
+        float a = 0.0f, b = 0.0f, c = 0.0f;
+        Vec x(0.0f), y(0.0f);
+        for (size_t i = 0; i < points.size(); i++) {
+            a += (1.0f - t[i]) * (1.0f - t[i]);
+            b += t[i] * (1.0f - t[i]);
+            c += t[i] * t[i];
+            x += (1.0f - t[i]) * points[i];
+            y += t[i] * points[i];
+        }
+
+        float determinant = a * c - b * b;
+        if (std::abs(determinant) < 1e-6f) {
+            return false;
+        }
+
+        endpoints[0] = glm::clamp((c * x - b * y) / determinant, Vec(0.0f), Vec(255.0f));
+        endpoints[1] = glm::clamp((a * y - b * x) / determinant, Vec(0.0f), Vec(255.0f));
+        return true;
+    }
+
+    // Little-endian bit stream of a 128-bit block.
+    class BlockWriter {
+    public:
+        void Write(std::uint64_t value, int bits)
+        {
+            for (int bit = 0; bit < bits; bit++, m_position++) {
+                m_words[m_position / 64] |= ((value >> bit) & 1) << (m_position % 64);
+            }
+        }
+
+        std::array<std::byte, 16> GetBytes() const
+        {
+            std::array<std::byte, 16> bytes {};
+            std::memcpy(bytes.data(), m_words.data(), bytes.size());
+            return bytes;
+        }
+
+    private:
+        std::array<std::uint64_t, 2> m_words {};
+        int m_position {0};
+    };
+
+    std::uint16_t PackRGB565(glm::vec3 color)
+    {
+        auto r = static_cast<std::uint16_t>(std::lround(color.r * 31.0f / 255.0f));
+        auto g = static_cast<std::uint16_t>(std::lround(color.g * 63.0f / 255.0f));
+        auto b = static_cast<std::uint16_t>(std::lround(color.b * 31.0f / 255.0f));
+        return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    glm::vec3 UnpackRGB565(std::uint16_t color)
+    {
+        int r = (color >> 11) & 31;
+        int g = (color >> 5) & 63;
+        int b = color & 31;
+        return {static_cast<float>((r << 3) | (r >> 2)), static_cast<float>((g << 2) | (g >> 4)),
+            static_cast<float>((b << 3) | (b >> 2))};
+    }
+
+    struct BC1Fit {
+        std::uint16_t m_color0;
+        std::uint16_t m_color1;
+        std::uint32_t m_indices;
+        float m_error;
+    };
+
+    BC1Fit FitBC1(const std::array<glm::vec3, 16>& texels, const std::array<glm::vec3, 2>& endpoints)
+    {
+        BC1Fit fit {.m_color0 = PackRGB565(endpoints[0]), .m_color1 = PackRGB565(endpoints[1]), .m_indices = 0, .m_error = 0.0f};
+
+        // The 4-color palette needs color0 > color1, swapping them swaps indices 0 with 1 and 2 with 3.
+        if (fit.m_color0 < fit.m_color1) {
+            std::swap(fit.m_color0, fit.m_color1);
+        }
+
+        glm::vec3 color0 = UnpackRGB565(fit.m_color0);
+        glm::vec3 color1 = UnpackRGB565(fit.m_color1);
+        std::array<glm::vec3, 4> palette {color0, color1, (2.0f * color0 + color1) / 3.0f, (color0 + 2.0f * color1) / 3.0f};
+        size_t paletteSize = fit.m_color0 == fit.m_color1 ? 1 : palette.size();
+
+        for (size_t texel = 0; texel < texels.size(); texel++) {
+            std::uint32_t bestIndex = 0;
+            float bestError = FLT_MAX;
+            for (size_t index = 0; index < paletteSize; index++) {
+                glm::vec3 difference = texels[texel] - palette[index];
+                float error = glm::dot(difference, difference);
+                if (error < bestError) {
+                    bestIndex = static_cast<std::uint32_t>(index);
+                    bestError = error;
+                }
+            }
+            fit.m_indices |= bestIndex << (2 * texel);
+            fit.m_error += bestError;
+        }
+
+        return fit;
+    }
+
+    struct BC7Fit {
+        std::array<glm::ivec4, 2> m_endpoints;
+        std::array<int, 2> m_pBits;
+        std::array<int, 16> m_indices;
+        float m_error;
+    };
+
+    // Quantizes an endpoint to 7 bits per channel plus a shared p-bit, keeping the p-bit closest to it.
+    void QuantizeBC7Endpoint(glm::vec4 endpoint, glm::ivec4& quantized, int& pBit)
+    {
+        float bestError = FLT_MAX;
+        for (int candidate = 0; candidate < 2; candidate++) {
+            glm::ivec4 value = glm::clamp(glm::ivec4(glm::round((endpoint - static_cast<float>(candidate)) / 2.0f)), 0, 127);
+            glm::vec4 difference = glm::vec4(value * 2 + candidate) - endpoint;
+            float error = glm::dot(difference, difference);
+            if (error < bestError) {
+                bestError = error;
+                quantized = value;
+                pBit = candidate;
+            }
+        }
+    }
+
+    BC7Fit FitBC7(const std::array<glm::vec4, 16>& texels, const std::array<glm::vec4, 2>& endpoints)
+    {
+        BC7Fit fit {};
+        for (size_t endpoint = 0; endpoint < 2; endpoint++) {
+            QuantizeBC7Endpoint(endpoints[endpoint], fit.m_endpoints[endpoint], fit.m_pBits[endpoint]);
+        }
+
+        glm::ivec4 color0 = fit.m_endpoints[0] * 2 + fit.m_pBits[0];
+        glm::ivec4 color1 = fit.m_endpoints[1] * 2 + fit.m_pBits[1];
+        std::array<glm::vec4, 16> palette {};
+        for (size_t index = 0; index < palette.size(); index++) {
+            palette[index] = glm::vec4((color0 * (64 - BC7_WEIGHTS4[index]) + color1 * BC7_WEIGHTS4[index] + 32) >> 6);
+        }
+
+        for (size_t texel = 0; texel < texels.size(); texel++) {
+            float bestError = FLT_MAX;
+            for (size_t index = 0; index < palette.size(); index++) {
+                glm::vec4 difference = texels[texel] - palette[index];
+                float error = glm::dot(difference, difference);
+                if (error < bestError) {
+                    fit.m_indices[texel] = static_cast<int>(index);
+                    bestError = error;
+                }
+            }
+            fit.m_error += bestError;
+        }
+
+        return fit;
+    }
+
+    TexelBlock FetchBlock(std::span<const std::uint8_t> rgba, GLsizei width, GLsizei height, GLsizei blockX, GLsizei blockY)
+    {
+        // Blocks past the edges repeat the last row and column.
+        TexelBlock block {};
+        for (GLsizei y = 0; y < 4; y++) {
+            for (GLsizei x = 0; x < 4; x++) {
+                GLsizei sourceX = std::min(blockX * 4 + x, width - 1);
+                GLsizei sourceY = std::min(blockY * 4 + y, height - 1);
+                const std::uint8_t* texel = &rgba[4 * (static_cast<size_t>(sourceY) * static_cast<size_t>(width) + sourceX)];
+                block[static_cast<size_t>(y * 4 + x)] = glm::u8vec4(texel[0], texel[1], texel[2], texel[3]);
+            }
+        }
+        return block;
+    }
+
+} // namespace
+
+std::vector<std::uint8_t> DownsampleRGBA8(std::span<const std::uint8_t> rgba, GLsizei width, GLsizei height)
+{
+    GLsizei halfWidth = std::max(width / 2, 1);
+    GLsizei halfHeight = std::max(height / 2, 1);
+    std::vector<std::uint8_t> half(4 * static_cast<size_t>(halfWidth) * static_cast<size_t>(halfHeight));
+    for (GLsizei y = 0; y < halfHeight; y++) {
+        for (GLsizei x = 0; x < halfWidth; x++) {
+            for (size_t channel = 0; channel < 4; channel++) {
+                int sum = 0;
+                for (GLsizei offset = 0; offset < 4; offset++) {
+                    GLsizei sourceX = std::min(x * 2 + (offset & 1), width - 1);
+                    GLsizei sourceY = std::min(y * 2 + (offset >> 1), height - 1);
+                    sum += rgba[4 * (static_cast<size_t>(sourceY) * static_cast<size_t>(width) + sourceX) + channel];
+                }
+                half[4 * (static_cast<size_t>(y) * static_cast<size_t>(halfWidth) + x) + channel]
+                    = static_cast<std::uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+    return half;
+}
+
+std::array<std::byte, 8> EncodeBC1Block(const TexelBlock& texels)
+{
+    std::array<glm::vec3, 16> points {};
+    for (size_t texel = 0; texel < texels.size(); texel++) {
+        points[texel] = glm::vec3(texels[texel]);
+    }
+
+    std::array<glm::vec3, 2> endpoints = FitPrincipalAxis(points);
+    BC1Fit fit = FitBC1(points, endpoints);
+
+    // Palette entries 0 to 3 sit at these fractions of the way from color0 to color1.
+    constexpr std::array<float, 4> weights {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+    std::array<float, 16> t {};
+    for (size_t texel = 0; texel < texels.size(); texel++) {
+        t[texel] = weights[(fit.m_indices >> (2 * texel)) & 3];
+    }
+    std::array<glm::vec3, 2> refined {UnpackRGB565(fit.m_color0), UnpackRGB565(fit.m_color1)};
+    if (RefineEndpoints(points, t, refined)) {
+        BC1Fit refinedFit = FitBC1(points, refined);
+        if (refinedFit.m_error < fit.m_error) {
+            fit = refinedFit;
+        }
+    }
+
+    std::array<std::byte, 8> block {};
+    std::memcpy(block.data(), &fit.m_color0, 2);
+    std::memcpy(block.data() + 2, &fit.m_color1, 2);
+    std::memcpy(block.data() + 4, &fit.m_indices, 4);
+    return block;
+}
+
+std::array<std::byte, 16> EncodeBC7Block(const TexelBlock& texels)
+{
+    std::array<glm::vec4, 16> points {};
+    for (size_t texel = 0; texel < texels.size(); texel++) {
+        points[texel] = glm::vec4(texels[texel]);
+    }
+
+    BC7Fit fit = FitBC7(points, FitPrincipalAxis(points));
+    for (int iteration = 0; iteration < 2; iteration++) {
+        std::array<float, 16> t {};
+        for (size_t texel = 0; texel < texels.size(); texel++) {
+            t[texel] = static_cast<float>(BC7_WEIGHTS4[static_cast<size_t>(fit.m_indices[texel])]) / 64.0f;
+        }
+        std::array<glm::vec4, 2> refined {glm::vec4(fit.m_endpoints[0] * 2 + fit.m_pBits[0]),
+            glm::vec4(fit.m_endpoints[1] * 2 + fit.m_pBits[1])};
+        if (!RefineEndpoints(points, t, refined)) {
+            break;
+        }
+        BC7Fit refinedFit = FitBC7(points, refined);
+        if (!(refinedFit.m_error < fit.m_error)) {
+            break;
+        }
+        fit = refinedFit;
+    }
+
+    // The first index is stored without its top bit, which has to be 0: swap the endpoints otherwise.
+    if (fit.m_indices[0] >= 8) {
+        std::swap(fit.m_endpoints[0], fit.m_endpoints[1]);
+        std::swap(fit.m_pBits[0], fit.m_pBits[1]);
+        for (int& index : fit.m_indices) {
+            index = 15 - index;
+        }
+    }
+
+    BlockWriter writer {};
+    writer.Write(1u << 6, 7);
+    for (int channel = 0; channel < 4; channel++) {
+        writer.Write(static_cast<std::uint64_t>(fit.m_endpoints[0][channel]), 7);
+        writer.Write(static_cast<std::uint64_t>(fit.m_endpoints[1][channel]), 7);
+    }
+    writer.Write(static_cast<std::uint64_t>(fit.m_pBits[0]), 1);
+    writer.Write(static_cast<std::uint64_t>(fit.m_pBits[1]), 1);
+    for (size_t texel = 0; texel < fit.m_indices.size(); texel++) {
+        writer.Write(static_cast<std::uint64_t>(fit.m_indices[texel]), texel == 0 ? 3 : 4);
+    }
+
+    return writer.GetBytes();
+}
+
+std::optional<CompressedTexture> CompressTexture(
+    std::span<const std::uint8_t> rgba, GLsizei width, GLsizei height, GLenum format)
+{
+    if (format != GL_COMPRESSED_RGB_S3TC_DXT1_EXT && format != GL_COMPRESSED_RGBA_BPTC_UNORM) {
+        return std::nullopt;
+    }
+    if (width <= 0 || height <= 0 || rgba.size() < 4 * static_cast<size_t>(width) * static_cast<size_t>(height)) {
+        return std::nullopt;
+    }
+
+    CompressedTexture texture {.m_format = format, .m_levels = {}, .m_data = {}};
+    std::vector<std::uint8_t> level(rgba.begin(), rgba.begin() + 4 * static_cast<std::ptrdiff_t>(width) * height);
+    while (true) {
+        size_t offset = texture.m_data.size();
+        for (GLsizei blockY = 0; blockY < (height + 3) / 4; blockY++) {
+            for (GLsizei blockX = 0; blockX < (width + 3) / 4; blockX++) {
+                TexelBlock block = FetchBlock(level, width, height, blockX, blockY);
+                if (format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) {
+                    std::array<std::byte, 8> encoded = EncodeBC1Block(block);
+                    texture.m_data.insert(texture.m_data.end(), encoded.begin(), encoded.end());
+                } else {
+                    std::array<std::byte, 16> encoded = EncodeBC7Block(block);
+                    texture.m_data.insert(texture.m_data.end(), encoded.begin(), encoded.end());
+                }
+            }
+        }
+        texture.m_levels.push_back(
+            CompressedLevel {.m_width = width, .m_height = height, .m_offset = offset, .m_size = texture.m_data.size() - offset});
+
+        if (width == 1 && height == 1) {
+            break;
+        }
+        level = DownsampleRGBA8(level, width, height);
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+
+    return texture;
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "render/TextureFile.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Glitter::Render {
+
+// The 4x4 texels of a block in row-major order, as RGBA8.
+using TexelBlock = std::array<glm::u8vec4, 16>;
+
+// Box-filters a RGBA8 image down to half its size, rounding odd sizes down, and clamping at 1.
+std::vector<std::uint8_t> DownsampleRGBA8(std::span<const std::uint8_t> rgba, GLsizei width, GLsizei height);
+
+// Opaque BC1 with the 4-color palette, ignoring alpha. Endpoints are fit along the principal axis of the texels, then
+// refined once by least squares.
+std::array<std::byte, 8> EncodeBC1Block(const TexelBlock& texels);
+
+// BC7 mode 6 only: a single RGBA subset with 7-bit endpoints, per-endpoint p-bits and 16 interpolation steps, fit like
+// EncodeBC1Block(). Good for smooth texels, though blocks with several distinct colors would do better in other modes.
+std::array<std::byte, 16> EncodeBC7Block(const TexelBlock& texels);
+
+// Compresses a RGBA8 image into GL_COMPRESSED_RGB_S3TC_DXT1_EXT or GL_COMPRESSED_RGBA_BPTC_UNORM, with a full mip chain
+// box-filtered from it. Returns std::nullopt for any other format.
+std::optional<CompressedTexture> CompressTexture(
+    std::span<const std::uint8_t> rgba, GLsizei width, GLsizei height, GLenum format);
+
+} // namespace Glitter::Render
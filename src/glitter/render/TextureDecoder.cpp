@@ -0,0 +1,198 @@
+#include "render/TextureDecoder.h"
+
+#include "Config.h"
+#include "core/CpuProfiler.h"
+#include "render/GLExtensions.h"
+#include "render/TextureCompression.h"
+#include "util/File.h"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+
+namespace Glitter::Render {
+
+namespace {
+
+    // Reads the .ktx2 file next to the image at `path`, if there's one the driver can sample.
+    std::optional<CompressedTexture> ReadSupportedCompressedTexture(const char* path)
+    {
+        std::string compressedPath = std::filesystem::path(path).replace_extension(".ktx2").string();
+        std::optional<CompressedTexture> texture = ReadCompressedTexture(compressedPath.c_str());
+        if (texture && !IsCompressedFormatSupported(texture->m_format)) {
+            spdlog::info("Texture <{}> is in an unsupported compressed format, using <{}> instead.", compressedPath, path);
+            return std::nullopt;
+        }
+
+        return texture;
+    }
+
+    // Bumped whenever the encoders' output changes, so that the cached textures are encoded again.
+    constexpr std::uint64_t TRANSCODE_CACHE_VERSION = 1;
+
+    // The transcoded texture of the image file `encoded`, in the formats the driver supports.
+    std::string GetTranscodeCachePath(std::span<const std::byte> encoded, bool bc7)
+    {
+        // 64-bit FNV-1a.
+        std::uint64_t hash = 0xCBF2'9CE4'8422'2325;
+        auto mix = [&](std::uint64_t value) { hash = (hash ^ value) * 0x0000'0100'0000'01B3; };
+        mix(TRANSCODE_CACHE_VERSION);
+        mix(bc7 ? 1 : 0);
+        for (std::byte value : encoded) {
+            mix(static_cast<std::uint64_t>(value));
+        }
+        return std::format("{}/{:016x}.ktx2", Config::TEXTURE_TRANSCODE_CACHE_DIRECTORY, hash);
+    }
+
+    // BC7 where the driver supports it, or BC1 if every texel is opaque, std::nullopt otherwise.
+    std::optional<GLenum> GetTranscodeFormat(std::span<const std::uint8_t> rgba, bool bc7)
+    {
+        if (bc7) {
+            return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        }
+        for (size_t texel = 3; texel < rgba.size(); texel += 4) {
+            if (rgba[texel] != 255) {
+                return std::nullopt;
+            }
+        }
+        if (!IsCompressedFormatSupported(GL_COMPRESSED_RGB_S3TC_DXT1_EXT)) {
+            return std::nullopt;
+        }
+        return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    }
+
+    // Written to a file of its own first, then moved into place, since the workers decoding two images of the same
+    // contents write the same path.
+    void WriteTranscodeCache(const std::string& cachePath, const CompressedTexture& texture)
+    {
+        static std::atomic<std::uint32_t> s_writeCount {};
+        std::error_code error {};
+        std::filesystem::create_directories(Config::TEXTURE_TRANSCODE_CACHE_DIRECTORY, error);
+        std::string writePath = std::format("{}.{}.tmp", cachePath, s_writeCount.fetch_add(1, std::memory_order_relaxed));
+        if (!WriteKtx2(writePath.c_str(), texture)) {
+            spdlog::warn("Failed to write the transcoded texture <{}>.", writePath);
+            std::filesystem::remove(writePath, error);
+            return;
+        }
+        std::filesystem::rename(writePath, cachePath, error);
+        if (error) {
+            spdlog::warn("Failed to write the transcoded texture <{}>: {}.", cachePath, error.message());
+            std::filesystem::remove(writePath, error);
+        }
+    }
+
+    DecodedTexture DecodeTexture(const char* path, const TextureDecodeOptions& options)
+    {
+        DecodedTexture texture {};
+        if (options.m_allowCompressed) {
+            texture.m_compressed = ReadSupportedCompressedTexture(path);
+            if (texture.m_compressed) {
+                return texture;
+            }
+        }
+
+        std::optional<Util::MappedFile> file = Util::MappedFile::Open(path);
+        std::span<const std::byte> encoded = file ? file->GetData() : std::span<const std::byte> {};
+
+        // The images transcoded by an earlier launch are loaded as is.
+        bool transcode = options.m_allowCompressed && options.m_transcode && !encoded.empty();
+        bool bc7 = transcode && IsCompressedFormatSupported(GL_COMPRESSED_RGBA_BPTC_UNORM);
+        std::string cachePath {};
+        if (transcode) {
+            cachePath = GetTranscodeCachePath(encoded, bc7);
+            std::optional<CompressedTexture> cached = ReadCompressedTexture(cachePath.c_str());
+            if (cached && IsCompressedFormatSupported(cached->m_format)) {
+                texture.m_compressed = std::move(cached);
+                return texture;
+            }
+        }
+
+        int width = 0, height = 0, nChannels = 0;
+        stbi_uc* data = encoded.empty() ? nullptr
+                                        : stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(encoded.data()),
+                                              static_cast<int>(encoded.size()), &width, &height, &nChannels, 4);
+        if (!data) {
+            spdlog::error("Failed to load texture <{}>.", path);
+            return texture;
+        }
+
+        std::vector<std::uint8_t> rgba(data, data + 4 * static_cast<size_t>(width) * static_cast<size_t>(height));
+        stbi_image_free(data);
+
+        // Encoded along with its mips on this worker, the one decoding it.
+        if (std::optional<GLenum> format = transcode ? GetTranscodeFormat(rgba, bc7) : std::nullopt) {
+            GLITTER_PROFILE_SCOPE("Transcode Texture");
+            texture.m_compressed = CompressTexture(rgba, width, height, *format);
+            if (texture.m_compressed) {
+                WriteTranscodeCache(cachePath, *texture.m_compressed);
+                return texture;
+            }
+        }
+        texture.m_levels.push_back(ImageLevel {.m_width = width, .m_height = height, .m_rgba = std::move(rgba)});
+
+        while (options.m_generateMips && (width > 1 || height > 1)) {
+            std::vector<std::uint8_t> level = DownsampleRGBA8(texture.m_levels.back().m_rgba, width, height);
+            width = std::max(width / 2, 1);
+            height = std::max(height / 2, 1);
+            texture.m_levels.push_back(ImageLevel {.m_width = width, .m_height = height, .m_rgba = std::move(level)});
+        }
+
+        return texture;
+    }
+
+} // namespace
+
+size_t GetLevelCount(const DecodedTexture& texture)
+{
+    return texture.m_compressed ? texture.m_compressed->m_levels.size() : texture.m_levels.size();
+}
+
+glm::ivec2 GetLevelSize(const DecodedTexture& texture, size_t level)
+{
+    if (texture.m_compressed) {
+        return {texture.m_compressed->m_levels[level].m_width, texture.m_compressed->m_levels[level].m_height};
+    }
+    return {texture.m_levels[level].m_width, texture.m_levels[level].m_height};
+}
+
+std::span<const std::byte> GetLevelData(const DecodedTexture& texture, size_t level)
+{
+    if (texture.m_compressed) {
+        const CompressedLevel& source = texture.m_compressed->m_levels[level];
+        return std::span(texture.m_compressed->m_data).subspan(source.m_offset, source.m_size);
+    }
+    return std::as_bytes(std::span(texture.m_levels[level].m_rgba));
+}
+
+GLenum GetInternalFormat(const DecodedTexture& texture)
+{
+    return texture.m_compressed ? texture.m_compressed->m_format : GLenum {GL_RGBA8};
+}
+
+std::vector<DecodedTexture> DecodeTextures(
+    std::span<const char* const> paths, Core::JobSystem& jobSystem, const TextureDecodeOptions& options)
+{
+    std::vector<DecodedTexture> textures(paths.size());
+    jobSystem.ParallelFor(paths.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t idx = begin; idx < end; idx++) {
+            GLITTER_PROFILE_SCOPE("Decode Texture");
+            textures[idx] = DecodeTexture(paths[idx], options);
+        }
+    });
+    return textures;
+}
+
+Core::Task<DecodedTexture> DecodeTextureAsync(
+    Core::CoroutineScheduler& scheduler, const char* path, TextureDecodeOptions options)
+{
+    co_await scheduler.ResumeOnWorker();
+    GLITTER_PROFILE_SCOPE("Decode Texture");
+    co_return DecodeTexture(path, options);
+}
+
+} // namespace Glitter::Render
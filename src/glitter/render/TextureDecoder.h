@@ -0,0 +1,52 @@
+#pragma once
+
+#include "core/Coroutine.h"
+#include "core/JobSystem.h"
+#include "render/TextureFile.h"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Glitter::Render {
+
+struct ImageLevel {
+    GLsizei m_width;
+    GLsizei m_height;
+    std::vector<std::uint8_t> m_rgba;
+};
+
+// A texture decoded on the CPU, only waiting for its GL upload. Either `m_compressed` is set, or `m_levels` holds the
+// RGBA8 image, from the largest level, with its mip chain if it was generated. Both are empty if the image failed to load.
+struct DecodedTexture {
+    std::optional<CompressedTexture> m_compressed;
+    std::vector<ImageLevel> m_levels;
+};
+
+size_t GetLevelCount(const DecodedTexture& texture);
+glm::ivec2 GetLevelSize(const DecodedTexture& texture, size_t level);
+std::span<const std::byte> GetLevelData(const DecodedTexture& texture, size_t level);
+// The GL_COMPRESSED_* format of a compressed texture, GL_RGBA8 otherwise.
+GLenum GetInternalFormat(const DecodedTexture& texture);
+
+struct TextureDecodeOptions {
+    // Use the .ktx2 file next to an image instead, if the driver can sample its format.
+    bool m_allowCompressed;
+    // Along with m_allowCompressed, compress the images without one, and cache them, see
+    // Config::ENABLE_TEXTURE_TRANSCODING.
+    bool m_transcode;
+    // Box-filter the full mip chain of decoded images.
+    bool m_generateMips;
+};
+
+// Decodes every path on `jobSystem`, one job per texture. No GL calls are made, so the results must be uploaded by the
+// caller on the GL thread.
+std::vector<DecodedTexture> DecodeTextures(
+    std::span<const char* const> paths, Core::JobSystem& jobSystem, const TextureDecodeOptions& options);
+
+// Decodes `path` on a worker of `scheduler`, and resumes the awaiting coroutine there. `path` must outlive the task.
+Core::Task<DecodedTexture> DecodeTextureAsync(
+    Core::CoroutineScheduler& scheduler, const char* path, TextureDecodeOptions options);
+
+} // namespace Glitter::Render
@@ -0,0 +1,344 @@
+#include "render/TextureFile.h"
+
+#include "util/File.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <span>
+
+namespace Glitter::Render {
+
+namespace {
+
+    struct FormatInfo {
+        GLenum m_format;
+        std::uint32_t m_vkFormat;
+        // 0 if DDS files can't hold the format.
+        std::uint32_t m_dxgiFormat;
+        size_t m_blockSize;
+        // KHR_DF_MODEL_* of the KTX2 data format descriptor.
+        std::uint8_t m_dfdModel;
+        bool m_srgb;
+        bool m_alpha;
+    };
+
+    constexpr std::array FORMATS = std::to_array<FormatInfo>({
+        {GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 131, 0, 8, 128, false, false},
+        {GL_COMPRESSED_SRGB_S3TC_DXT1_EXT, 132, 0, 8, 128, true, false},
+        {GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 133, 71, 8, 128, false, true},
+        {GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, 134, 72, 8, 128, true, true},
+        {GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 137, 77, 16, 130, false, true},
+        {GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, 138, 78, 16, 130, true, true},
+        {GL_COMPRESSED_RGBA_BPTC_UNORM, 145, 98, 16, 134, false, true},
+        {GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, 146, 99, 16, 134, true, true},
+        {GL_COMPRESSED_RGBA_ASTC_4x4_KHR, 157, 0, 16, 162, false, true},
+        {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR, 158, 0, 16, 162, true, true},
+    });
+
+    template <typename Predicate> const FormatInfo* FindFormat(Predicate predicate)
+    {
+        const auto* it = std::find_if(FORMATS.begin(), FORMATS.end(), predicate);
+        return it != FORMATS.end() ? it : nullptr;
+    }
+
+    constexpr std::array<std::uint8_t, 12> KTX2_IDENTIFIER {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    struct Ktx2Header {
+        std::array<std::uint8_t, 12> m_identifier;
+        std::uint32_t m_vkFormat;
+        std::uint32_t m_typeSize;
+        std::uint32_t m_pixelWidth;
+        std::uint32_t m_pixelHeight;
+        std::uint32_t m_pixelDepth;
+        std::uint32_t m_layerCount;
+        std::uint32_t m_faceCount;
+        std::uint32_t m_levelCount;
+        std::uint32_t m_supercompressionScheme;
+
+        std::uint32_t m_dfdByteOffset;
+        std::uint32_t m_dfdByteLength;
+        std::uint32_t m_kvdByteOffset;
+        std::uint32_t m_kvdByteLength;
+        std::uint64_t m_sgdByteOffset;
+        std::uint64_t m_sgdByteLength;
+    };
+    static_assert(sizeof(Ktx2Header) == 80);
+
+    struct Ktx2Level {
+        std::uint64_t m_byteOffset;
+        std::uint64_t m_byteLength;
+        std::uint64_t m_uncompressedByteLength;
+    };
+
+    constexpr std::array<char, 4> DDS_MAGIC {'D', 'D', 'S', ' '};
+    constexpr std::uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+    constexpr std::uint32_t DDPF_FOURCC = 0x4;
+    constexpr std::uint32_t DDSCAPS2_CUBEMAP = 0x200;
+    constexpr std::uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+
+    struct DdsHeader {
+        std::array<char, 4> m_magic;
+        std::uint32_t m_size;
+        std::uint32_t m_flags;
+        std::uint32_t m_height;
+        std::uint32_t m_width;
+        std::uint32_t m_pitchOrLinearSize;
+        std::uint32_t m_depth;
+        std::uint32_t m_mipMapCount;
+        std::array<std::uint32_t, 11> m_reserved;
+
+        std::uint32_t m_pixelFormatSize;
+        std::uint32_t m_pixelFormatFlags;
+        std::array<char, 4> m_fourCC;
+        std::uint32_t m_rgbBitCount;
+        std::array<std::uint32_t, 4> m_masks;
+
+        std::array<std::uint32_t, 4> m_caps;
+        std::uint32_t m_reserved2;
+    };
+    static_assert(sizeof(DdsHeader) == 128);
+
+    struct DdsHeaderDx10 {
+        std::uint32_t m_dxgiFormat;
+        std::uint32_t m_resourceDimension;
+        std::uint32_t m_miscFlag;
+        std::uint32_t m_arraySize;
+        std::uint32_t m_miscFlags2;
+    };
+
+    template <typename T> bool ReadStruct(std::span<const std::byte> file, size_t offset, T& out)
+    {
+        if (offset > file.size() || sizeof(T) > file.size() - offset) {
+            return false;
+        }
+        std::memcpy(&out, file.data() + offset, sizeof(T));
+        return true;
+    }
+
+    size_t GetLevelSize(const FormatInfo& format, GLsizei width, GLsizei height)
+    {
+        auto blocksX = static_cast<size_t>((width + 3) / 4);
+        auto blocksY = static_cast<size_t>((height + 3) / 4);
+        return blocksX * blocksY * format.m_blockSize;
+    }
+
+    // Copies the chain of `levelCount` mips of `file` into `texture`, with `getOffset(level, size)` locating each one.
+    template <typename GetOffset>
+    bool ReadLevels(std::span<const std::byte> file, const FormatInfo& format, std::uint32_t width, std::uint32_t height,
+        std::uint32_t levelCount, GetOffset getOffset, CompressedTexture& texture)
+    {
+        if (width == 0 || height == 0 || width > 16384 || height > 16384 || levelCount > 15) {
+            return false;
+        }
+
+        for (std::uint32_t level = 0; level < levelCount; level++) {
+            auto levelWidth = static_cast<GLsizei>(std::max(width >> level, 1u));
+            auto levelHeight = static_cast<GLsizei>(std::max(height >> level, 1u));
+            size_t size = GetLevelSize(format, levelWidth, levelHeight);
+            std::optional<size_t> offset = getOffset(level, size);
+            if (!offset || *offset > file.size() || size > file.size() - *offset) {
+                return false;
+            }
+
+            texture.m_levels.push_back(CompressedLevel {
+                .m_width = levelWidth, .m_height = levelHeight, .m_offset = texture.m_data.size(), .m_size = size});
+            texture.m_data.insert(texture.m_data.end(), file.begin() + static_cast<std::ptrdiff_t>(*offset),
+                file.begin() + static_cast<std::ptrdiff_t>(*offset + size));
+        }
+
+        return true;
+    }
+
+    std::optional<CompressedTexture> ReadKtx2(std::span<const std::byte> file)
+    {
+        Ktx2Header header {};
+        if (!ReadStruct(file, 0, header) || header.m_identifier != KTX2_IDENTIFIER) {
+            return std::nullopt;
+        }
+
+        const FormatInfo* format = FindFormat([&](const FormatInfo& info) { return info.m_vkFormat == header.m_vkFormat; });
+        if (!format || header.m_typeSize != 1 || header.m_pixelDepth != 0 || header.m_layerCount > 1 || header.m_faceCount != 1
+            || header.m_supercompressionScheme != 0) {
+            return std::nullopt;
+        }
+
+        CompressedTexture texture {.m_format = format->m_format, .m_levels = {}, .m_data = {}};
+        auto getOffset = [&](std::uint32_t level, size_t size) -> std::optional<size_t> {
+            Ktx2Level index {};
+            if (!ReadStruct(file, sizeof(Ktx2Header) + sizeof(Ktx2Level) * level, index) || index.m_byteLength != size) {
+                return std::nullopt;
+            }
+            return static_cast<size_t>(index.m_byteOffset);
+        };
+        if (!ReadLevels(file, *format, header.m_pixelWidth, header.m_pixelHeight, std::max(header.m_levelCount, 1u), getOffset,
+                texture)) {
+            return std::nullopt;
+        }
+
+        return texture;
+    }
+
+    std::optional<CompressedTexture> ReadDds(std::span<const std::byte> file)
+    {
+        DdsHeader header {};
+        if (!ReadStruct(file, 0, header) || header.m_magic != DDS_MAGIC || header.m_size != sizeof(DdsHeader) - 4
+            || (header.m_pixelFormatFlags & DDPF_FOURCC) == 0 || (header.m_caps[1] & DDSCAPS2_CUBEMAP) != 0) {
+            return std::nullopt;
+        }
+
+        const FormatInfo* format = nullptr;
+        size_t dataOffset = sizeof(DdsHeader);
+        if (header.m_fourCC == std::array<char, 4> {'D', 'X', 'T', '1'}) {
+            format = FindFormat([](const FormatInfo& info) { return info.m_format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; });
+        } else if (header.m_fourCC == std::array<char, 4> {'D', 'X', 'T', '5'}) {
+            format = FindFormat([](const FormatInfo& info) { return info.m_format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; });
+        } else if (header.m_fourCC == std::array<char, 4> {'D', 'X', '1', '0'}) {
+            DdsHeaderDx10 dx10 {};
+            if (!ReadStruct(file, dataOffset, dx10) || dx10.m_resourceDimension != DDS_DIMENSION_TEXTURE2D
+                || dx10.m_arraySize > 1) {
+                return std::nullopt;
+            }
+            format = FindFormat(
+                [&](const FormatInfo& info) { return info.m_dxgiFormat != 0 && info.m_dxgiFormat == dx10.m_dxgiFormat; });
+            dataOffset += sizeof(DdsHeaderDx10);
+        }
+        if (!format) {
+            return std::nullopt;
+        }
+
+        // Levels are stored one after the other, from the largest.
+        CompressedTexture texture {.m_format = format->m_format, .m_levels = {}, .m_data = {}};
+        auto getOffset = [&](std::uint32_t, size_t size) -> std::optional<size_t> {
+            size_t offset = dataOffset;
+            dataOffset += size;
+            return offset;
+        };
+        std::uint32_t levelCount = (header.m_flags & DDSD_MIPMAPCOUNT) != 0 ? std::max(header.m_mipMapCount, 1u) : 1;
+        if (!ReadLevels(file, *format, header.m_width, header.m_height, levelCount, getOffset, texture)) {
+            return std::nullopt;
+        }
+
+        return texture;
+    }
+
+    // A KHR_DF_VERSIONNUMBER_1_3 basic data format descriptor, with one sample per 64 bits of the block. BC3 blocks start
+    // with their alpha half.
+    std::vector<std::uint32_t> MakeDataFormatDescriptor(const FormatInfo& format)
+    {
+        constexpr std::uint32_t KHR_DF_CHANNEL_COLOR = 0;
+        constexpr std::uint32_t KHR_DF_CHANNEL_ALPHA = 15;
+
+        std::vector<std::array<std::uint32_t, 2>> samples {};
+        if (format.m_dfdModel == 130) {
+            samples = {{0, KHR_DF_CHANNEL_ALPHA}, {64, KHR_DF_CHANNEL_COLOR}};
+        } else {
+            samples = {{0, format.m_dfdModel == 128 && format.m_alpha ? KHR_DF_CHANNEL_ALPHA : KHR_DF_CHANNEL_COLOR}};
+        }
+        auto sampleBits = static_cast<std::uint32_t>(format.m_blockSize * 8 / samples.size());
+
+        auto blockSize = static_cast<std::uint32_t>(24 + 16 * samples.size());
+        std::vector<std::uint32_t> words {};
+        words.push_back(4 + blockSize);
+        // Vendor KHR, descriptor type basic, then version 2 and the block size.
+        words.push_back(0);
+        words.push_back(2 | (blockSize << 16));
+        // Model, BT.709 primaries, linear or sRGB transfer, straight alpha.
+        words.push_back(format.m_dfdModel | (1u << 8) | ((format.m_srgb ? 2u : 1u) << 16));
+        // 4x4 texels per block, then the block's bytes in plane 0.
+        words.push_back(3 | (3u << 8));
+        words.push_back(static_cast<std::uint32_t>(format.m_blockSize));
+        words.push_back(0);
+        for (const auto& [bitOffset, channel] : samples) {
+            words.push_back(bitOffset | ((sampleBits - 1) << 16) | (channel << 24));
+            words.push_back(0);
+            words.push_back(0);
+            words.push_back(UINT32_MAX);
+        }
+
+        return words;
+    }
+
+} // namespace
+
+size_t GetCompressedBlockSize(GLenum format)
+{
+    const FormatInfo* info = FindFormat([&](const FormatInfo& candidate) { return candidate.m_format == format; });
+    return info ? info->m_blockSize : 0;
+}
+
+std::optional<CompressedTexture> ReadCompressedTexture(const char* path)
+{
+    std::optional<Util::MappedFile> file = Util::MappedFile::Open(path);
+    if (!file) {
+        return std::nullopt;
+    }
+
+    std::optional<CompressedTexture> texture = ReadKtx2(file->GetData());
+    if (!texture) {
+        texture = ReadDds(file->GetData());
+    }
+    if (!texture) {
+        spdlog::warn("Unsupported or malformed compressed texture <{}>.", path);
+    }
+
+    return texture;
+}
+
+bool WriteKtx2(const char* path, const CompressedTexture& texture)
+{
+    const FormatInfo* format = FindFormat([&](const FormatInfo& info) { return info.m_format == texture.m_format; });
+    if (!format || texture.m_levels.empty()) {
+        return false;
+    }
+
+    std::vector<std::uint32_t> dfd = MakeDataFormatDescriptor(*format);
+    size_t dfdOffset = sizeof(Ktx2Header) + sizeof(Ktx2Level) * texture.m_levels.size();
+    size_t dataOffset = dfdOffset + sizeof(std::uint32_t) * dfd.size();
+
+    // Levels are stored from the smallest, each aligned to the block size.
+    std::vector<Ktx2Level> levels(texture.m_levels.size());
+    for (size_t level = texture.m_levels.size(); level-- > 0;) {
+        dataOffset = (dataOffset + format->m_blockSize - 1) / format->m_blockSize * format->m_blockSize;
+        levels[level] = Ktx2Level {.m_byteOffset = dataOffset,
+            .m_byteLength = texture.m_levels[level].m_size,
+            .m_uncompressedByteLength = texture.m_levels[level].m_size};
+        dataOffset += texture.m_levels[level].m_size;
+    }
+
+    Ktx2Header header {.m_identifier = KTX2_IDENTIFIER,
+        .m_vkFormat = format->m_vkFormat,
+        .m_typeSize = 1,
+        .m_pixelWidth = static_cast<std::uint32_t>(texture.m_levels[0].m_width),
+        .m_pixelHeight = static_cast<std::uint32_t>(texture.m_levels[0].m_height),
+        .m_pixelDepth = 0,
+        .m_layerCount = 0,
+        .m_faceCount = 1,
+        .m_levelCount = static_cast<std::uint32_t>(texture.m_levels.size()),
+        .m_supercompressionScheme = 0,
+        .m_dfdByteOffset = static_cast<std::uint32_t>(dfdOffset),
+        .m_dfdByteLength = static_cast<std::uint32_t>(sizeof(std::uint32_t) * dfd.size()),
+        .m_kvdByteOffset = 0,
+        .m_kvdByteLength = 0,
+        .m_sgdByteOffset = 0,
+        .m_sgdByteLength = 0};
+
+    std::vector<std::byte> file(dataOffset);
+    std::memcpy(file.data(), &header, sizeof(header));
+    std::memcpy(file.data() + sizeof(header), levels.data(), sizeof(Ktx2Level) * levels.size());
+    std::memcpy(file.data() + dfdOffset, dfd.data(), sizeof(std::uint32_t) * dfd.size());
+    for (size_t level = 0; level < levels.size(); level++) {
+        const CompressedLevel& source = texture.m_levels[level];
+        if (source.m_offset > texture.m_data.size() || source.m_size > texture.m_data.size() - source.m_offset) {
+            return false;
+        }
+        std::memcpy(file.data() + levels[level].m_byteOffset, texture.m_data.data() + source.m_offset, source.m_size);
+    }
+
+    std::ofstream outputStream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    outputStream.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    return static_cast<bool>(outputStream);
+}
+
+} // namespace Glitter::Render
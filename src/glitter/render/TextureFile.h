@@ -0,0 +1,55 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Block-compressed formats from extensions the vendored glad doesn't define.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#define GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR 0x93D0
+#endif
+
+namespace Glitter::Render {
+
+struct CompressedLevel {
+    GLsizei m_width;
+    GLsizei m_height;
+    // Range of CompressedTexture::m_data.
+    size_t m_offset;
+    size_t m_size;
+};
+
+// A texture of 4x4 blocks with its mip chain, ready for glCompressedTextureSubImage2D.
+struct CompressedTexture {
+    // One of the GL_COMPRESSED_* formats GetCompressedBlockSize() knows.
+    GLenum m_format;
+    // From the largest to the smallest.
+    std::vector<CompressedLevel> m_levels;
+    std::vector<std::byte> m_data;
+};
+
+// Bytes per 4x4 block of a supported format, 0 otherwise.
+size_t GetCompressedBlockSize(GLenum format);
+
+// Reads a KTX2 or DDS file, told apart by their magic. Only single 2D images without supercompression, in BC1, BC3, BC7
+// or ASTC 4x4, are supported. Returns std::nullopt, without logging, if the file is missing.
+std::optional<CompressedTexture> ReadCompressedTexture(const char* path);
+
+// Writes `texture` as a KTX2 file, with the basic data format descriptor its format requires.
+bool WriteKtx2(const char* path, const CompressedTexture& texture);
+
+} // namespace Glitter::Render
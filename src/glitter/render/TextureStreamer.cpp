@@ -0,0 +1,271 @@
+#include "render/TextureStreamer.h"
+
+#include "Config.h"
+#include "render/GLExtensions.h"
+#include "render/GpuMemory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Glitter::Render {
+
+std::optional<GLsizei> AllocateStreamedTexture2D(
+    GLuint texture, GLenum internalFormat, GLsizei levels, GLsizei width, GLsizei height)
+{
+    if (GetGLExtensions().m_sparseTexture) {
+        GLint pageSizeCount = 0;
+        glGetInternalformativ(GL_TEXTURE_2D, internalFormat, GL_NUM_VIRTUAL_PAGE_SIZES_ARB, 1, &pageSizeCount);
+
+        // The first page size is the one at GL_VIRTUAL_PAGE_SIZE_INDEX_ARB 0.
+        GLint pageWidth = 0, pageHeight = 0;
+        if (pageSizeCount > 0) {
+            glGetInternalformativ(GL_TEXTURE_2D, internalFormat, GL_VIRTUAL_PAGE_SIZE_X_ARB, 1, &pageWidth);
+            glGetInternalformativ(GL_TEXTURE_2D, internalFormat, GL_VIRTUAL_PAGE_SIZE_Y_ARB, 1, &pageHeight);
+        }
+
+        if (pageWidth > 0 && pageHeight > 0 && width % pageWidth == 0 && height % pageHeight == 0) {
+            glTextureParameteri(texture, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+            glTextureParameteri(texture, GL_VIRTUAL_PAGE_SIZE_INDEX_ARB, 0);
+            // Sparse storage only reserves address space, its pages are committed as the levels stream in, so it isn't
+            // tracked as GPU memory.
+            glTextureStorage2D(texture, levels, internalFormat, width, height);
+
+            GLint sparseLevels = 0;
+            glGetTextureParameteriv(texture, GL_NUM_SPARSE_LEVELS_ARB, &sparseLevels);
+            return std::min(sparseLevels, levels);
+        }
+    }
+
+    TextureStorage2D(GpuMemoryCategory::Texture, texture, levels, internalFormat, width, height);
+    return std::nullopt;
+}
+
+void TextureStreamer::Create(size_t textureCount, size_t budget)
+{
+    m_budget = budget;
+    m_textures.resize(textureCount);
+    m_minLods.assign(textureCount, 0.0f);
+
+    glCreateBuffers(1, &m_minLodBuffer);
+    NamedBufferStorage(GpuMemoryCategory::Buffer, m_minLodBuffer,
+        static_cast<GLsizeiptr>(sizeof(float) * std::max<size_t>(textureCount, 1)), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    glObjectLabel(GL_BUFFER, m_minLodBuffer, -1, "Texture Min LOD Buffer");
+}
+
+void TextureStreamer::Release()
+{
+    DeleteBuffers(1, &m_minLodBuffer);
+    m_minLodBuffer = 0;
+    m_textures.clear();
+    m_minLods.clear();
+    m_residentSize = 0;
+}
+
+void TextureStreamer::AddTexture(size_t slot, StreamedTextureTarget target, DecodedTexture texture,
+    std::optional<GLsizei> sparseLevels, TextureUploader& uploader)
+{
+    StreamedTexture& streamed = m_textures[slot];
+    streamed = StreamedTexture {};
+    streamed.m_target = target;
+    streamed.m_source = std::move(texture);
+    streamed.m_sparseLevels = sparseLevels;
+
+    auto levelCount = static_cast<std::uint32_t>(GetLevelCount(streamed.m_source));
+    for (std::uint32_t level = 0; level < levelCount; level++) {
+        streamed.m_levelSizes.push_back(GetLevelData(streamed.m_source, level).size());
+    }
+    if (levelCount == 0) {
+        return;
+    }
+
+    // Start from the first level small enough, and at least from the mip tail, which can only be committed as a whole.
+    std::uint32_t baseLevel = 0;
+    while (baseLevel + 1 < levelCount) {
+        glm::ivec2 size = GetLevelSize(streamed.m_source, baseLevel);
+        if (std::max(size.x, size.y) <= static_cast<int>(Config::TEXTURE_STREAMING_MIN_SIZE)) {
+            break;
+        }
+        baseLevel++;
+    }
+    if (sparseLevels) {
+        baseLevel = std::min(baseLevel, static_cast<std::uint32_t>(*sparseLevels));
+    }
+
+    streamed.m_residentLevel = levelCount;
+    streamed.m_baseLevel = baseLevel;
+    streamed.m_wantedLevel = baseLevel;
+    for (std::uint32_t level = levelCount; level-- > baseLevel;) {
+        UploadLevel(slot, level, uploader, true);
+    }
+}
+
+void TextureStreamer::AddResidentTexture(size_t slot)
+{
+    m_textures[slot] = StreamedTexture {};
+    m_minLods[slot] = 0.0f;
+    m_minLodsDirty = true;
+}
+
+void TextureStreamer::AddAliasTexture(size_t slot, size_t source)
+{
+    m_textures[slot] = StreamedTexture {};
+    m_textures[slot].m_aliasOf = source;
+    m_minLods[slot] = m_minLods[source];
+    m_minLodsDirty = true;
+}
+
+void TextureStreamer::Request(size_t slot, float pixels)
+{
+    slot = m_textures[slot].m_aliasOf.value_or(slot);
+    m_textures[slot].m_requestedPixels = std::max(m_textures[slot].m_requestedPixels, pixels);
+}
+
+void TextureStreamer::Update(TextureUploader& uploader)
+{
+    m_frame++;
+
+    // Turn this frame's requests into levels: the one whose texels are about the size of the pixels they cover.
+    for (StreamedTexture& texture : m_textures) {
+        if (texture.m_levelSizes.empty() || texture.m_requestedPixels <= 0.0f) {
+            continue;
+        }
+
+        glm::ivec2 size = GetLevelSize(texture.m_source, 0);
+        float level = std::floor(std::log2(static_cast<float>(std::max(size.x, size.y)) / texture.m_requestedPixels));
+        texture.m_wantedLevel = static_cast<std::uint32_t>(std::clamp(level, 0.0f, static_cast<float>(texture.m_baseLevel)));
+        texture.m_lastRequestFrame = m_frame;
+        texture.m_requestedPixels = 0.0f;
+    }
+
+    size_t uploadedSize = 0;
+    for (size_t slot = 0; slot < m_textures.size() && uploadedSize < Config::TEXTURE_STREAMING_UPLOAD_BUDGET; slot++) {
+        StreamedTexture& texture = m_textures[slot];
+        if (texture.m_levelSizes.empty() || texture.m_residentLevel <= texture.m_wantedLevel) {
+            continue;
+        }
+
+        std::uint32_t level = texture.m_residentLevel - 1;
+        size_t levelSize = texture.m_levelSizes[level];
+        bool fits = m_residentSize + levelSize <= m_budget;
+        while (!fits && EvictForRoom(slot)) {
+            fits = m_residentSize + levelSize <= m_budget;
+        }
+        if (!fits) {
+            continue;
+        }
+
+        // The ring is full, try again next frame.
+        if (!UploadLevel(slot, level, uploader, false)) {
+            break;
+        }
+        uploadedSize += levelSize;
+    }
+
+    for (size_t slot = 0; slot < m_textures.size(); slot++) {
+        if (std::optional<size_t> source = m_textures[slot].m_aliasOf; source && m_minLods[slot] != m_minLods[*source]) {
+            m_minLods[slot] = m_minLods[*source];
+            m_minLodsDirty = true;
+        }
+    }
+    if (m_minLodsDirty) {
+        glNamedBufferSubData(m_minLodBuffer, 0, static_cast<GLsizeiptr>(sizeof(float) * m_minLods.size()), m_minLods.data());
+        m_minLodsDirty = false;
+    }
+}
+
+bool TextureStreamer::UploadLevel(size_t slot, std::uint32_t level, TextureUploader& uploader, bool wait)
+{
+    StreamedTexture& texture = m_textures[slot];
+    glm::ivec2 size = GetLevelSize(texture.m_source, level);
+    TextureUploadTarget target {
+        .m_texture = texture.m_target.m_texture,
+        .m_target = texture.m_target.m_target,
+        .m_level = static_cast<GLint>(level),
+        .m_layer = texture.m_target.m_layer,
+        .m_width = size.x,
+        .m_height = size.y,
+        .m_format = texture.m_source.m_compressed ? texture.m_source.m_compressed->m_format : GLenum {GL_RGBA},
+    };
+
+    Commit(slot, level, true);
+    if (wait) {
+        uploader.Upload(target, GetLevelData(texture.m_source, level));
+    } else if (!uploader.TryUpload(target, GetLevelData(texture.m_source, level))) {
+        Commit(slot, level, false);
+        return false;
+    }
+
+    texture.m_residentLevel = level;
+    m_residentSize += texture.m_levelSizes[level];
+    m_minLods[slot] = static_cast<float>(level);
+    m_minLodsDirty = true;
+    return true;
+}
+
+void TextureStreamer::EvictLevel(size_t slot)
+{
+    StreamedTexture& texture = m_textures[slot];
+    std::uint32_t level = texture.m_residentLevel;
+
+    // The draws of previous frames were issued before the decommit, and this frame's are clamped past the level.
+    texture.m_residentLevel++;
+    m_residentSize -= texture.m_levelSizes[level];
+    m_minLods[slot] = static_cast<float>(texture.m_residentLevel);
+    m_minLodsDirty = true;
+    Commit(slot, level, false);
+}
+
+void TextureStreamer::Commit(size_t slot, std::uint32_t level, bool commit)
+{
+    StreamedTexture& texture = m_textures[slot];
+    if (!texture.m_sparseLevels) {
+        return;
+    }
+
+    // Committing any level of the mip tail commits all of it, and it's never decommitted.
+    auto sparseLevels = static_cast<std::uint32_t>(*texture.m_sparseLevels);
+    if (level >= sparseLevels) {
+        if (!commit || texture.m_tailCommitted) {
+            return;
+        }
+        level = sparseLevels;
+        texture.m_tailCommitted = true;
+    }
+
+    glm::ivec2 size = GetLevelSize(texture.m_source, level);
+    GetGLExtensions().m_texturePageCommitment(texture.m_target.m_texture, static_cast<GLint>(level), 0, 0, 0, size.x, size.y, 1,
+        commit ? GL_TRUE : GL_FALSE);
+}
+
+bool TextureStreamer::EvictForRoom(size_t keep)
+{
+    size_t best = m_textures.size();
+    auto bestKey = std::make_pair(true, std::numeric_limits<std::uint64_t>::max());
+    for (size_t slot = 0; slot < m_textures.size(); slot++) {
+        const StreamedTexture& texture = m_textures[slot];
+        if (slot == keep || texture.m_levelSizes.empty() || texture.m_residentLevel >= texture.m_baseLevel) {
+            continue;
+        }
+
+        bool surplus = texture.m_residentLevel < texture.m_wantedLevel;
+        if (!surplus && texture.m_lastRequestFrame == m_frame) {
+            continue;
+        }
+
+        auto key = std::make_pair(!surplus, texture.m_lastRequestFrame);
+        if (key < bestKey) {
+            best = slot;
+            bestKey = key;
+        }
+    }
+
+    if (best == m_textures.size()) {
+        return false;
+    }
+
+    EvictLevel(best);
+    return true;
+}
+
+} // namespace Glitter::Render
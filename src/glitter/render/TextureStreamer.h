@@ -0,0 +1,97 @@
+#pragma once
+
+#include "render/TextureDecoder.h"
+#include "render/TextureUploader.h"
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Glitter::Render {
+
+// Where the levels of a streamed texture live: a 2D texture, or a layer of a 2D array texture.
+struct StreamedTextureTarget {
+    GLuint m_texture;
+    GLenum m_target;
+    GLint m_layer;
+};
+
+// Allocates the storage of a 2D texture to be streamed, sparse if GL_ARB_sparse_texture supports its format and its size
+// is a multiple of the format's page size. Returns the number of levels committed one by one before the mip tail for
+// sparse storage, and std::nullopt otherwise.
+std::optional<GLsizei> AllocateStreamedTexture2D(
+    GLuint texture, GLenum internalFormat, GLsizei levels, GLsizei width, GLsizei height);
+
+// Keeps the mips of the Node textures resident according to how large they're drawn. Every texture starts out with its
+// levels of at most Config::TEXTURE_STREAMING_MIN_SIZE texels, finer ones are uploaded from the decoded CPU copy
+// once Nodes using it are drawn large enough, and the least recently requested levels are evicted to stay within the
+// budget. Sparse textures decommit evicted levels, others keep their storage and only stop sampling them.
+//
+// The finest resident level of each texture is written into GetMinLodBuffer(), which the main program clamps its
+// sampling to, so that levels are never sampled before they're uploaded.
+class TextureStreamer {
+public:
+    void Create(size_t textureCount, size_t budget);
+    void Release();
+
+    // Streams `texture` into `target`, whose storage must hold all of its levels. `sparseLevels` is as returned by
+    // AllocateStreamedTexture2D(), and the coarsest levels are uploaded right away.
+    void AddTexture(size_t slot, StreamedTextureTarget target, DecodedTexture texture, std::optional<GLsizei> sparseLevels,
+        TextureUploader& uploader);
+    // Marks `slot` as uploaded some other way, with every level resident and outside of the budget.
+    void AddResidentTexture(size_t slot);
+    // Makes `slot` sample the same texture as `source`, added before: its requests go to `source`, and its minimum LOD
+    // follows the one of `source`.
+    void AddAliasTexture(size_t slot, size_t source);
+
+    // Requests the level of `slot` matching `pixels`, the on-screen size of a Node sampling it. The largest request of
+    // a frame wins, and textures keep their last request until they're requested again.
+    void Request(size_t slot, float pixels);
+
+    // Stages the levels requested this frame into `uploader`, up to Config::TEXTURE_STREAMING_UPLOAD_BUDGET bytes and one
+    // level per texture, evicting others to make room for them. Never waits for the upload ring.
+    void Update(TextureUploader& uploader);
+
+    GLuint GetMinLodBuffer() const { return m_minLodBuffer; }
+    size_t GetResidentSize() const { return m_residentSize; }
+    size_t GetBudget() const { return m_budget; }
+
+private:
+    struct StreamedTexture {
+        StreamedTextureTarget m_target {};
+        DecodedTexture m_source;
+        std::vector<size_t> m_levelSizes;
+        std::optional<GLsizei> m_sparseLevels;
+        bool m_tailCommitted {false};
+
+        // Levels [m_residentLevel, m_levelSizes.size()) are resident, and levels from m_baseLevel on stay so.
+        std::uint32_t m_residentLevel {};
+        std::uint32_t m_baseLevel {};
+        std::uint32_t m_wantedLevel {};
+        float m_requestedPixels {};
+        std::uint64_t m_lastRequestFrame {};
+        // The slot streaming the texture, if it's another one.
+        std::optional<size_t> m_aliasOf;
+    };
+
+    bool UploadLevel(size_t slot, std::uint32_t level, TextureUploader& uploader, bool wait);
+    void EvictLevel(size_t slot);
+    void Commit(size_t slot, std::uint32_t level, bool commit);
+    // Evicts the finest level of another texture than `keep`: one resident finer than it was last requested at if there's
+    // one, or else the least recently requested one not drawn this frame. Returns false if there's none.
+    bool EvictForRoom(size_t keep);
+
+    std::vector<StreamedTexture> m_textures;
+    std::vector<float> m_minLods;
+    GLuint m_minLodBuffer {};
+    bool m_minLodsDirty {false};
+
+    size_t m_budget {};
+    size_t m_residentSize {};
+    std::uint64_t m_frame {};
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,154 @@
+#include "render/TextureUploader.h"
+
+#include "render/GpuMemory.h"
+
+#include <cstring>
+#include <limits>
+
+namespace Glitter::Render {
+
+namespace {
+
+    // Keeps every staged upload aligned for any texel or block size, and GL_UNPACK_ALIGNMENT.
+    constexpr size_t UPLOAD_ALIGNMENT = 16;
+
+} // namespace
+
+void TextureUploader::Create(size_t capacity)
+{
+    m_capacity = (capacity + UPLOAD_ALIGNMENT - 1) / UPLOAD_ALIGNMENT * UPLOAD_ALIGNMENT;
+
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &m_buffer);
+    NamedBufferStorage(GpuMemoryCategory::StreamBuffer, m_buffer, static_cast<GLsizeiptr>(m_capacity), nullptr, flags);
+    glObjectLabel(GL_BUFFER, m_buffer, -1, "Texture Upload Ring");
+    m_mappedData = static_cast<std::byte*>(glMapNamedBufferRange(m_buffer, 0, static_cast<GLsizeiptr>(m_capacity), flags));
+}
+
+void TextureUploader::Release()
+{
+    EndFrame();
+    while (!m_fences.empty()) {
+        Retire(true);
+    }
+
+    if (m_buffer) {
+        glUnmapNamedBuffer(m_buffer);
+        DeleteBuffers(1, &m_buffer);
+    }
+    m_buffer = 0;
+    m_mappedData = nullptr;
+}
+
+bool TextureUploader::TryUpload(const TextureUploadTarget& target, std::span<const std::byte> data)
+{
+    size_t offset = Allocate(data.size());
+    if (offset == std::numeric_limits<size_t>::max()) {
+        Retire(false);
+        offset = Allocate(data.size());
+        if (offset == std::numeric_limits<size_t>::max()) {
+            return false;
+        }
+    }
+
+    std::memcpy(m_mappedData + offset, data.data(), data.size());
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+    Submit(target, reinterpret_cast<const void*>(offset), data.size());
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return true;
+}
+
+void TextureUploader::Upload(const TextureUploadTarget& target, std::span<const std::byte> data)
+{
+    if (data.size() > m_capacity) {
+        Submit(target, data.data(), data.size());
+        return;
+    }
+
+    while (!TryUpload(target, data)) {
+        // Space staged into this frame can only be waited on once it's fenced.
+        if (m_fenced != m_allocated) {
+            EndFrame();
+        }
+        Retire(true);
+    }
+}
+
+void TextureUploader::EndFrame()
+{
+    if (m_fenced == m_allocated) {
+        return;
+    }
+
+    m_fences.push_back(Fence {.m_sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), .m_allocated = m_allocated});
+    m_fenced = m_allocated;
+}
+
+size_t TextureUploader::Allocate(size_t size)
+{
+    size = (size + UPLOAD_ALIGNMENT - 1) / UPLOAD_ALIGNMENT * UPLOAD_ALIGNMENT;
+
+    // Restart an idle ring from its beginning, so that anything up to its capacity fits.
+    if (m_allocated == m_released) {
+        m_allocated = (m_allocated + m_capacity - 1) / m_capacity * m_capacity;
+        m_released = m_allocated;
+        m_fenced = m_allocated;
+    }
+
+    // Uploads are never split, so skip the end of the ring if they don't fit before it.
+    auto offset = static_cast<size_t>(m_allocated % m_capacity);
+    size_t padding = offset + size > m_capacity ? m_capacity - offset : 0;
+    if (m_allocated + padding + size - m_released > m_capacity) {
+        return std::numeric_limits<size_t>::max();
+    }
+
+    m_allocated += padding + size;
+    return padding ? 0 : offset;
+}
+
+void TextureUploader::Retire(bool wait)
+{
+    if (wait && !m_fences.empty()) {
+        // Flush on the first wait, in case the fence hasn't been submitted yet.
+        GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        while (glClientWaitSync(m_fences.front().m_sync, waitFlags, 1'000'000) == GL_TIMEOUT_EXPIRED) {
+            waitFlags = 0;
+        }
+    }
+
+    while (!m_fences.empty()) {
+        Fence& fence = m_fences.front();
+        GLenum status = glClientWaitSync(fence.m_sync, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+
+        glDeleteSync(fence.m_sync);
+        m_released = fence.m_allocated;
+        m_fences.pop_front();
+    }
+}
+
+void TextureUploader::Submit(const TextureUploadTarget& target, const void* pixels, size_t size)
+{
+    bool compressed = target.m_format != GL_RGBA;
+    if (target.m_target == GL_TEXTURE_2D_ARRAY) {
+        if (compressed) {
+            glCompressedTextureSubImage3D(target.m_texture, target.m_level, 0, 0, target.m_layer, target.m_width,
+                target.m_height, 1, target.m_format, static_cast<GLsizei>(size), pixels);
+        } else {
+            glTextureSubImage3D(target.m_texture, target.m_level, 0, 0, target.m_layer, target.m_width, target.m_height, 1,
+                GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        }
+    } else {
+        if (compressed) {
+            glCompressedTextureSubImage2D(target.m_texture, target.m_level, 0, 0, target.m_width, target.m_height,
+                target.m_format, static_cast<GLsizei>(size), pixels);
+        } else {
+            glTextureSubImage2D(
+                target.m_texture, target.m_level, 0, 0, target.m_width, target.m_height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        }
+    }
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+
+namespace Glitter::Render {
+
+// A texture level, or one layer of it, written by TextureUploader.
+struct TextureUploadTarget {
+    GLuint m_texture;
+    // GL_TEXTURE_2D, or GL_TEXTURE_2D_ARRAY to write `m_layer`.
+    GLenum m_target;
+    GLint m_level;
+    GLint m_layer;
+    GLsizei m_width;
+    GLsizei m_height;
+    // GL_RGBA for GL_UNSIGNED_BYTE texels, otherwise one of the GL_COMPRESSED_* formats of the texture.
+    GLenum m_format;
+};
+
+// Stages texture uploads through a persistently-mapped pixel unpack buffer used as a ring. Each upload is copied into the
+// ring and the GL call sources it from there, so the driver can schedule the transfer instead of copying client memory
+// before returning. The ring space of a frame is fenced by EndFrame() and reused once the GPU is done with it.
+class TextureUploader {
+public:
+    void Create(size_t capacity);
+    void Release();
+
+    // Stages `data` into `target` if the ring has room for it right now, or returns false without waiting, so a streaming
+    // caller can retry on a later frame.
+    bool TryUpload(const TextureUploadTarget& target, std::span<const std::byte> data);
+    // Stages `data` into `target`, waiting for the GPU to release ring space if needed. Data larger than the whole ring is
+    // uploaded from client memory instead.
+    void Upload(const TextureUploadTarget& target, std::span<const std::byte> data);
+
+    // Fences the ring space staged into since the last call, must be called after each frame's uploads.
+    void EndFrame();
+
+    // Bytes staged and not yet released by the GPU.
+    size_t GetUsedSize() const { return static_cast<size_t>(m_allocated - m_released); }
+
+private:
+    struct Fence {
+        GLsync m_sync;
+        // m_allocated when the fence was inserted.
+        std::uint64_t m_allocated;
+    };
+
+    // Returns the offset of `size` free bytes, or SIZE_MAX if the released space can't fit them.
+    size_t Allocate(size_t size);
+    // Releases the space of signaled fences, blocking on the oldest one first if `wait` is set.
+    void Retire(bool wait);
+    void Submit(const TextureUploadTarget& target, const void* pixels, size_t size);
+
+    GLuint m_buffer {};
+    std::byte* m_mappedData {};
+    size_t m_capacity {};
+
+    // Running totals of ring bytes, including the padding skipped when wrapping around.
+    std::uint64_t m_allocated {};
+    std::uint64_t m_released {};
+    std::uint64_t m_fenced {};
+    std::deque<Fence> m_fences;
+};
+
+} // namespace Glitter::Render
@@ -0,0 +1,148 @@
+#include "render/UploadContext.h"
+
+#include "core/CpuProfiler.h"
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+namespace Glitter::Render {
+
+UploadContext::~UploadContext()
+{
+    Release();
+}
+
+bool UploadContext::Create(GLFWwindow* sharedWindow)
+{
+    // Inherits the context version hints of `sharedWindow`.
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    m_window = glfwCreateWindow(1, 1, "Glitter Upload Context", nullptr, sharedWindow);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if (!m_window) {
+        return false;
+    }
+
+    m_running = true;
+    m_thread = std::thread(&UploadContext::UploadMain, this);
+    return true;
+}
+
+void UploadContext::Release()
+{
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_running = false;
+    }
+    m_taskCondition.notify_one();
+    m_thread.join();
+
+    for (FencedTask& fenced : m_fencedTasks) {
+        glDeleteSync(fenced.m_fence);
+    }
+    m_fencedTasks.clear();
+    m_unfencedCount = 0;
+
+    glfwDestroyWindow(m_window);
+    m_window = nullptr;
+}
+
+void UploadContext::Submit(Task task, Completion completion)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_tasks.push_back(PendingTask {.m_task = std::move(task), .m_completion = std::move(completion)});
+        m_unfencedCount++;
+    }
+    m_taskCondition.notify_one();
+}
+
+void UploadContext::Poll()
+{
+    Completion completion {};
+    while (PopFenced(false, completion)) {
+        completion();
+    }
+}
+
+void UploadContext::Finish()
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_fencedCondition.wait(lock, [this] { return m_unfencedCount == 0; });
+    }
+
+    Completion completion {};
+    while (PopFenced(true, completion)) {
+        completion();
+    }
+}
+
+bool UploadContext::PopFenced(bool wait, Completion& completion)
+{
+    GLsync fence {};
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_fencedTasks.empty()) {
+            return false;
+        }
+        fence = m_fencedTasks.front().m_fence;
+    }
+
+    // The upload thread flushed the fence, so it's bound to signal.
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    while (wait && status == GL_TIMEOUT_EXPIRED) {
+        status = glClientWaitSync(fence, 0, 1'000'000);
+    }
+    if (status == GL_TIMEOUT_EXPIRED) {
+        return false;
+    }
+
+    std::lock_guard lock(m_mutex);
+    glDeleteSync(fence);
+    completion = std::move(m_fencedTasks.front().m_completion);
+    m_fencedTasks.pop_front();
+    return true;
+}
+
+void UploadContext::UploadMain()
+{
+    Core::SetProfileThreadName("Upload Context");
+    glfwMakeContextCurrent(m_window);
+
+    while (true) {
+        PendingTask pending {};
+        {
+            std::unique_lock lock(m_mutex);
+            m_taskCondition.wait(lock, [this] { return !m_tasks.empty() || !m_running; });
+            if (m_tasks.empty()) {
+                break;
+            }
+            pending = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        {
+            GLITTER_PROFILE_SCOPE("Upload Task");
+            pending.m_task();
+        }
+
+        // Flush so that the render thread can wait on the fence from its own context.
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_fencedTasks.push_back(FencedTask {.m_fence = fence, .m_completion = std::move(pending.m_completion)});
+            m_unfencedCount--;
+        }
+        m_fencedCondition.notify_all();
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+struct GLFWwindow;
+
+namespace Glitter::Render {
+
+// A hidden GLFW context sharing its objects with the main one, current on a thread of its own. Tasks submitted to it
+// create and fill buffers or textures there, each followed by a fence, and their completion runs back on the render
+// thread once the GPU has executed the task, when its objects are safe to use from the main context.
+//
+// Only shared objects may be touched from a task: container objects like VAOs and framebuffers are per context.
+class UploadContext {
+public:
+    // Runs on the upload thread, with its context current.
+    using Task = std::function<void()>;
+    // Runs on the thread calling Poll() or Finish().
+    using Completion = std::function<void()>;
+
+    UploadContext() = default;
+    ~UploadContext();
+
+    UploadContext(const UploadContext&) = delete;
+    UploadContext& operator=(const UploadContext&) = delete;
+
+    // Creates the context and starts its thread. Must be called from the thread owning `sharedWindow`, which GLFW requires
+    // for window creation, after the GL entry points were loaded. Returns false if the context couldn't be created.
+    bool Create(GLFWwindow* sharedWindow);
+    // Runs the remaining tasks, without their completions, and destroys the context.
+    void Release();
+
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    void Submit(Task task, Completion completion);
+    // Runs the completions of the finished tasks, in the order they were submitted, without waiting for the others.
+    void Poll();
+    // Waits for every submitted task to finish and runs their completions.
+    void Finish();
+
+private:
+    struct PendingTask {
+        Task m_task;
+        Completion m_completion;
+    };
+
+    struct FencedTask {
+        GLsync m_fence;
+        Completion m_completion;
+    };
+
+    void UploadMain();
+    // Pops the front of m_fencedTasks if its fence signaled, or waits for it if `wait` is set.
+    bool PopFenced(bool wait, Completion& completion);
+
+    GLFWwindow* m_window {};
+
+    std::mutex m_mutex;
+    std::condition_variable m_taskCondition;
+    std::condition_variable m_fencedCondition;
+    std::deque<PendingTask> m_tasks;
+    std::deque<FencedTask> m_fencedTasks;
+    // Submitted tasks that weren't fenced yet.
+    size_t m_unfencedCount {};
+    bool m_running {};
+
+    std::thread m_thread;
+};
+
+} // namespace Glitter::Render
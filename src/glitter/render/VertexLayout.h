@@ -0,0 +1,50 @@
+#pragma once
+
+#include "scene/VertexFormat.h"
+
+#include <glad/glad.h>
+
+namespace Glitter::Render {
+
+// Declares `attribute` at `location` of `vao`, `offset` bytes into the vertices fetched from `binding`.
+inline void SetVertexAttribute(GLuint vao, GLuint location, const Scene::VertexAttribute& attribute, GLuint offset, GLuint binding)
+{
+    GLint size = static_cast<GLint>(attribute.m_componentCount);
+    GLenum type = GL_FLOAT;
+    GLboolean normalized = GL_FALSE;
+    switch (attribute.m_type) {
+    case Scene::VertexAttributeType::Float:
+        break;
+    case Scene::VertexAttributeType::Half:
+        type = GL_HALF_FLOAT;
+        break;
+    case Scene::VertexAttributeType::Unorm8:
+        type = GL_UNSIGNED_BYTE;
+        normalized = GL_TRUE;
+        break;
+    case Scene::VertexAttributeType::Unorm16:
+        type = GL_UNSIGNED_SHORT;
+        normalized = GL_TRUE;
+        break;
+    case Scene::VertexAttributeType::PackedSnorm10:
+        size = 4;
+        type = GL_INT_2_10_10_10_REV;
+        normalized = GL_TRUE;
+        break;
+    }
+
+    glEnableVertexArrayAttrib(vao, location);
+    glVertexArrayAttribFormat(vao, location, size, type, normalized, offset);
+    glVertexArrayAttribBinding(vao, location, binding);
+}
+
+// Declares every attribute of `Vertex`, see Scene::VertexFormat, fetched from `binding` of `vao`.
+template <typename Vertex> void SetVertexFormat(GLuint vao, GLuint binding)
+{
+    constexpr const auto& ATTRIBUTES = Scene::VertexFormat<Vertex>::ATTRIBUTES;
+    for (GLuint location = 0; location < ATTRIBUTES.size(); location++) {
+        SetVertexAttribute(vao, location, ATTRIBUTES[location], ATTRIBUTES[location].m_offset, binding);
+    }
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,73 @@
+#include "render/ViewLayout.h"
+
+#include "Config.h"
+
+#include <algorithm>
+#include <numbers>
+
+namespace Glitter::Render {
+
+void LayoutViews(ViewLayout layout, float aspect, glm::vec4& mainViewport, std::span<glm::vec4> insetViewports)
+{
+    mainViewport = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    switch (layout) {
+    case ViewLayout::Single:
+        break;
+    case ViewLayout::PictureInPicture: {
+        // Top down along the right edge, with the target's aspect, a margin of a fraction of their height apart.
+        float height = Config::INSET_VIEW_SIZE;
+        float margin = height * 0.1f;
+        float width = height;
+        for (size_t viewIdx = 0; viewIdx < insetViewports.size(); viewIdx++) {
+            float y = 1.0f - static_cast<float>(viewIdx + 1) * (height + margin);
+            insetViewports[viewIdx] = glm::vec4(1.0f - width - margin / aspect, y, width, height);
+        }
+        break;
+    }
+    case ViewLayout::SplitScreen:
+        mainViewport = glm::vec4(0.0f, 0.0f, 0.5f, 1.0f);
+        for (glm::vec4& viewport : insetViewports) {
+            viewport = glm::vec4(0.5f, 0.0f, 0.5f, 1.0f);
+        }
+        break;
+    }
+}
+
+glm::ivec4 GetViewportRect(const glm::vec4& viewport, int width, int height)
+{
+    // Both edges are rounded, so that adjacent rectangles neither overlap nor leave a gap.
+    glm::vec2 size(width, height);
+    glm::ivec2 lower = glm::ivec2(glm::round(glm::vec2(viewport.x, viewport.y) * size));
+    glm::ivec2 upper = glm::ivec2(glm::round(glm::vec2(viewport.x + viewport.z, viewport.y + viewport.w) * size));
+    return glm::ivec4(lower, upper - lower);
+}
+
+size_t GetInsetViewCount(ViewLayout layout, size_t requested)
+{
+    switch (layout) {
+    case ViewLayout::Single:
+        return 0;
+    case ViewLayout::PictureInPicture:
+        return std::min(requested, Config::MAX_INSET_VIEWS);
+    case ViewLayout::SplitScreen:
+        return 1;
+    }
+    return 0;
+}
+
+glm::mat4 FitToViewport(const glm::mat4& projection, const glm::vec4& viewport)
+{
+    // NDC [-1, 1] goes to [2 * x - 1, 2 * (x + width) - 1], and likewise along y.
+    glm::vec3 scale(viewport.z, viewport.w, 1.0f);
+    glm::vec3 offset(2.0f * viewport.x + viewport.z - 1.0f, 2.0f * viewport.y + viewport.w - 1.0f, 0.0f);
+    return glm::translate(glm::mat4(1.0f), offset) * glm::scale(glm::mat4(1.0f), scale) * projection;
+}
+
+glm::vec3 GetInsetEyePos(const glm::vec3& eyePos, const glm::vec3& eyeTarget, size_t index, size_t count)
+{
+    float angle = 2.0f * std::numbers::pi_v<float> * static_cast<float>(index + 1) / static_cast<float>(count + 1);
+    glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 1.0f, 0.0f));
+    return eyeTarget + glm::vec3(rotation * glm::vec4(eyePos - eyeTarget, 0.0f));
+}
+
+} // namespace Glitter::Render
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Glitter::Render {
+
+// How the render target is shared between the main view and the inset views drawn over it, each from its own camera.
+enum class ViewLayout : std::uint8_t {
+    // The main view alone.
+    Single,
+    // The main view covers the target, with the inset views stacked along its right edge.
+    PictureInPicture,
+    // The main view covers the left half of the target, and a single inset view the right half.
+    SplitScreen,
+};
+
+// The rectangles the views of `layout` cover, as x and y of their lower left corner then width and height, in fractions
+// of the render target. Writes the main view's into `mainViewport`, and those of the inset views into `insetViewports`,
+// whose size is the number of inset views. `aspect` is the target's width over its height.
+void LayoutViews(ViewLayout layout, float aspect, glm::vec4& mainViewport, std::span<glm::vec4> insetViewports);
+
+// `viewport` in the pixels of a `width` by `height` target, as x and y of its lower left corner then width and height.
+glm::ivec4 GetViewportRect(const glm::vec4& viewport, int width, int height);
+
+// The number of inset views `layout` draws, out of the `requested` ones.
+size_t GetInsetViewCount(ViewLayout layout, size_t requested);
+
+// `projection` squeezed into `viewport` of the NDC, so that a view rendered with the target's viewport lands in that
+// rectangle. Draws with it must still be scissored to the rectangle, since what the original projection clips can be
+// inside the rest of the NDC.
+glm::mat4 FitToViewport(const glm::mat4& projection, const glm::vec4& viewport);
+
+// The camera of the `index`-th of `count` inset views, orbiting `eyeTarget` from `eyePos`, so that the views are spread
+// evenly around it. Returns the eye position, which looks at `eyeTarget`.
+glm::vec3 GetInsetEyePos(const glm::vec3& eyePos, const glm::vec3& eyeTarget, size_t index, size_t count);
+
+} // namespace Glitter::Render
@@ -0,0 +1,270 @@
+#include "scene/Animation.h"
+
+#include "Config.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace Glitter::Scene {
+
+namespace {
+
+    // Keyframes stepped over from a channel's cursor before falling back to a binary search, when the time jumped further
+    // ahead than a frame usually does.
+    constexpr std::uint32_t CURSOR_STEPS = 4;
+
+    // The last of `times` at or before `time`, or the first one if none is, searching forward from `cursor`.
+    std::uint32_t FindKeyframe(std::span<const float> times, std::uint32_t cursor, float time)
+    {
+        // The clip looped around since.
+        if (cursor >= times.size() || times[cursor] > time) {
+            cursor = 0;
+        }
+        for (std::uint32_t step = 0; step < CURSOR_STEPS; step++) {
+            if (cursor + 1 >= times.size() || times[cursor + 1] > time) {
+                return cursor;
+            }
+            cursor++;
+        }
+        auto next = std::upper_bound(times.begin() + cursor, times.end(), time);
+        return static_cast<std::uint32_t>(next - times.begin()) - 1;
+    }
+
+#if defined(__SSE2__) || defined(_M_X64)
+    // The dot product of `a` and `b` in every lane.
+    __m128 Dot4(__m128 a, __m128 b)
+    {
+        __m128 products = _mm_mul_ps(a, b);
+        __m128 sums = _mm_add_ps(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_add_ps(sums, _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 0, 3, 2)));
+    }
+#endif
+
+    // Linearly from `from` to `to`. Rotations take the shorter arc and are normalized back, which stays within a fraction
+    // of a degree of a slerp between keyframes a frame or so apart.
+    glm::vec4 Interpolate(const glm::vec4& from, const glm::vec4& to, float weight, bool rotation)
+    {
+        glm::vec4 result {};
+#if defined(__SSE2__) || defined(_M_X64)
+        __m128 a = _mm_loadu_ps(&from.x);
+        __m128 b = _mm_loadu_ps(&to.x);
+        if (rotation) {
+            // q and -q are the same rotation, flip `to` into the same hemisphere as `from`.
+            b = _mm_xor_ps(b, _mm_and_ps(Dot4(a, b), _mm_set1_ps(-0.0f)));
+        }
+        __m128 blended = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_set1_ps(weight)));
+        if (rotation) {
+            blended = _mm_div_ps(blended, _mm_sqrt_ps(_mm_max_ps(Dot4(blended, blended), _mm_set1_ps(1e-12f))));
+        }
+        _mm_storeu_ps(&result.x, blended);
+#elif defined(__ARM_NEON)
+        float32x4_t a = vld1q_f32(&from.x);
+        float32x4_t b = vld1q_f32(&to.x);
+        if (rotation && vaddvq_f32(vmulq_f32(a, b)) < 0.0f) {
+            b = vnegq_f32(b);
+        }
+        float32x4_t blended = vmlaq_n_f32(a, vsubq_f32(b, a), weight);
+        if (rotation) {
+            blended = vmulq_n_f32(blended, 1.0f / std::sqrt(std::max(vaddvq_f32(vmulq_f32(blended, blended)), 1e-12f)));
+        }
+        vst1q_f32(&result.x, blended);
+#else
+        glm::vec4 target = rotation && glm::dot(from, to) < 0.0f ? -to : to;
+        result = glm::mix(from, target, weight);
+        if (rotation) {
+            result /= std::sqrt(std::max(glm::dot(result, result), 1e-12f));
+        }
+#endif
+        return result;
+    }
+
+} // namespace
+
+void AnimationPlayer::Add(const GltfAnimations& animations, std::uint32_t clip, std::span<const NodeHandle> nodes,
+    const std::optional<AnimatedJoints>& joints)
+{
+    if (clip >= animations.m_clips.size()) {
+        return;
+    }
+
+    const GltfAnimation& source = animations.m_clips[clip];
+    Playback playback {.m_duration = source.m_duration,
+        .m_firstChannel = static_cast<std::uint32_t>(m_channelPlaybacks.size()),
+        .m_channelCount = 0,
+        .m_firstNode = static_cast<std::uint32_t>(m_handles.size()),
+        .m_nodeCount = 0,
+        .m_firstKeyframe = static_cast<std::uint32_t>(m_keyframeTimes.size()),
+        .m_keyframeCount = 0};
+
+    // Only the Nodes this clip animates are added, once each.
+    std::vector<std::uint32_t> playbackNodes(animations.m_nodes.size(), UINT32_MAX);
+    std::span<const GltfAnimationChannel> channels
+        = std::span(animations.m_channels).subspan(source.m_firstChannel, source.m_channelCount);
+    for (const GltfAnimationChannel& channel : channels) {
+        const GltfAnimatedNode& node = animations.m_nodes[channel.m_node];
+        if (node.m_joint != 0 && !joints) {
+            continue;
+        }
+        if (playbackNodes[channel.m_node] == UINT32_MAX) {
+            playbackNodes[channel.m_node] = playback.m_nodeCount++;
+            m_handles.push_back(node.m_joint != 0 ? joints->m_owner : nodes[node.m_node]);
+            m_joints.push_back(node.m_joint != 0 ? joints->m_firstJoint + node.m_node : NO_JOINT);
+            m_localParts.push_back(glm::vec4(node.m_translation, 0.0f));
+            m_localParts.push_back(glm::vec4(node.m_rotation.x, node.m_rotation.y, node.m_rotation.z, node.m_rotation.w));
+            m_localParts.push_back(glm::vec4(node.m_scale, 0.0f));
+            m_prefixes.push_back(NodeTransform {
+                .m_translation = node.m_prefixTranslation, .m_rotation = node.m_prefixRotation, .m_scale = node.m_prefixScale});
+            m_transforms.push_back(NodeTransform {});
+        }
+
+        m_channelPlaybacks.push_back(static_cast<std::uint32_t>(m_playbacks.size()));
+        m_channelTargets.push_back(playbackNodes[channel.m_node] * 3 + static_cast<std::uint32_t>(channel.m_path));
+        m_channelFirstKeyframes.push_back(playback.m_keyframeCount);
+        m_channelKeyframeCounts.push_back(channel.m_keyframeCount);
+        m_channelSteps.push_back(channel.m_step != 0 ? 1 : 0);
+        m_channelCursors.push_back(0);
+        m_keyframeTimes.insert(m_keyframeTimes.end(), animations.m_keyframeTimes.begin() + channel.m_firstKeyframe,
+            animations.m_keyframeTimes.begin() + channel.m_firstKeyframe + channel.m_keyframeCount);
+        m_keyframeValues.insert(m_keyframeValues.end(), animations.m_keyframeValues.begin() + channel.m_firstKeyframe,
+            animations.m_keyframeValues.begin() + channel.m_firstKeyframe + channel.m_keyframeCount);
+        playback.m_channelCount++;
+        playback.m_keyframeCount += channel.m_keyframeCount;
+    }
+
+    m_playbacks.push_back(playback);
+    m_playbackTimes.push_back(0.0f);
+}
+
+void AnimationPlayer::RemoveStale(const NodeStore& store)
+{
+    // Backwards, so only the Playbacks already kept have their ranges shifted.
+    for (size_t playbackIdx = m_playbacks.size(); playbackIdx-- > 0;) {
+        Playback playback = m_playbacks[playbackIdx];
+        std::span<const NodeHandle> handles = std::span(m_handles).subspan(playback.m_firstNode, playback.m_nodeCount);
+        if (std::ranges::any_of(handles, [&](NodeHandle handle) { return store.IsValid(handle); })) {
+            continue;
+        }
+
+        auto eraseRange = [](auto& values, std::uint32_t first, std::uint32_t count) {
+            values.erase(values.begin() + first, values.begin() + first + count);
+        };
+        eraseRange(m_channelPlaybacks, playback.m_firstChannel, playback.m_channelCount);
+        eraseRange(m_channelTargets, playback.m_firstChannel, playback.m_channelCount);
+        eraseRange(m_channelFirstKeyframes, playback.m_firstChannel, playback.m_channelCount);
+        eraseRange(m_channelKeyframeCounts, playback.m_firstChannel, playback.m_channelCount);
+        eraseRange(m_channelSteps, playback.m_firstChannel, playback.m_channelCount);
+        eraseRange(m_channelCursors, playback.m_firstChannel, playback.m_channelCount);
+        eraseRange(m_keyframeTimes, playback.m_firstKeyframe, playback.m_keyframeCount);
+        eraseRange(m_keyframeValues, playback.m_firstKeyframe, playback.m_keyframeCount);
+        eraseRange(m_handles, playback.m_firstNode, playback.m_nodeCount);
+        eraseRange(m_joints, playback.m_firstNode, playback.m_nodeCount);
+        eraseRange(m_localParts, playback.m_firstNode * 3, playback.m_nodeCount * 3);
+        eraseRange(m_prefixes, playback.m_firstNode, playback.m_nodeCount);
+        eraseRange(m_transforms, playback.m_firstNode, playback.m_nodeCount);
+
+        for (size_t channelIdx = playback.m_firstChannel; channelIdx < m_channelPlaybacks.size(); channelIdx++) {
+            m_channelPlaybacks[channelIdx]--;
+        }
+        for (size_t laterIdx = playbackIdx + 1; laterIdx < m_playbacks.size(); laterIdx++) {
+            m_playbacks[laterIdx].m_firstChannel -= playback.m_channelCount;
+            m_playbacks[laterIdx].m_firstNode -= playback.m_nodeCount;
+            m_playbacks[laterIdx].m_firstKeyframe -= playback.m_keyframeCount;
+        }
+        m_playbacks.erase(m_playbacks.begin() + static_cast<std::ptrdiff_t>(playbackIdx));
+        m_playbackTimes.erase(m_playbackTimes.begin() + static_cast<std::ptrdiff_t>(playbackIdx));
+    }
+}
+
+void AnimationPlayer::Clear()
+{
+    m_playbacks.clear();
+    m_playbackTimes.clear();
+    m_channelPlaybacks.clear();
+    m_channelTargets.clear();
+    m_channelFirstKeyframes.clear();
+    m_channelKeyframeCounts.clear();
+    m_channelSteps.clear();
+    m_channelCursors.clear();
+    m_keyframeTimes.clear();
+    m_keyframeValues.clear();
+    m_handles.clear();
+    m_joints.clear();
+    m_localParts.clear();
+    m_prefixes.clear();
+    m_transforms.clear();
+}
+
+void AnimationPlayer::Evaluate(float time, NodeStore& store, Skeletons& skeletons, Core::JobSystem& jobs)
+{
+    if (m_handles.empty()) {
+        return;
+    }
+
+    for (size_t playbackIdx = 0; playbackIdx < m_playbacks.size(); playbackIdx++) {
+        float duration = m_playbacks[playbackIdx].m_duration;
+        m_playbackTimes[playbackIdx] = duration > 0.0f ? time - std::floor(time / duration) * duration : 0.0f;
+    }
+
+    // Each channel writes a part of a single Node, and each Node's parts are only composed once written.
+    jobs.ParallelFor(m_channelPlaybacks.size(), Config::ANIMATION_GRAIN_SIZE,
+        [&](size_t begin, size_t end) { SampleChannels(begin, end); });
+    jobs.ParallelFor(m_handles.size(), Config::ANIMATION_GRAIN_SIZE, [&](size_t begin, size_t end) { ComposeNodes(begin, end); });
+
+    // Marking the Nodes dirty appends to the store's dirty list, which isn't safe to do concurrently.
+    for (size_t nodeIdx = 0; nodeIdx < m_handles.size(); nodeIdx++) {
+        const NodeTransform& transform = m_transforms[nodeIdx];
+        if (m_joints[nodeIdx] != NO_JOINT) {
+            skeletons.SetLocal(m_joints[nodeIdx], transform.m_translation, transform.m_rotation, transform.m_scale);
+        } else {
+            store.SetTransform(m_handles[nodeIdx], transform.m_translation, transform.m_rotation, transform.m_scale);
+        }
+    }
+}
+
+void AnimationPlayer::SampleChannels(size_t begin, size_t end)
+{
+    for (size_t channelIdx = begin; channelIdx < end; channelIdx++) {
+        const Playback& playback = m_playbacks[m_channelPlaybacks[channelIdx]];
+        float time = m_playbackTimes[m_channelPlaybacks[channelIdx]];
+        std::uint32_t firstKeyframe = playback.m_firstKeyframe + m_channelFirstKeyframes[channelIdx];
+        std::span<const float> times = std::span(m_keyframeTimes).subspan(firstKeyframe, m_channelKeyframeCounts[channelIdx]);
+
+        std::uint32_t keyframe = FindKeyframe(times, m_channelCursors[channelIdx], time);
+        m_channelCursors[channelIdx] = keyframe;
+        std::uint32_t nextKeyframe = std::min<std::uint32_t>(keyframe + 1, static_cast<std::uint32_t>(times.size()) - 1);
+        float span = times[nextKeyframe] - times[keyframe];
+        float weight = 0.0f;
+        if (m_channelSteps[channelIdx] == 0 && span > 0.0f) {
+            weight = std::clamp((time - times[keyframe]) / span, 0.0f, 1.0f);
+        }
+
+        std::uint32_t target = m_channelTargets[channelIdx];
+        bool rotation = target % 3 == static_cast<std::uint32_t>(GltfAnimationPath::Rotation);
+        m_localParts[playback.m_firstNode * 3 + target] = Interpolate(
+            m_keyframeValues[firstKeyframe + keyframe], m_keyframeValues[firstKeyframe + nextKeyframe], weight, rotation);
+    }
+}
+
+void AnimationPlayer::ComposeNodes(size_t begin, size_t end)
+{
+    for (size_t nodeIdx = begin; nodeIdx < end; nodeIdx++) {
+        glm::vec3 translation {m_localParts[nodeIdx * 3]};
+        const glm::vec4& rotation = m_localParts[nodeIdx * 3 + 1];
+        glm::vec3 scale {m_localParts[nodeIdx * 3 + 2]};
+
+        // Exact as long as the prefix scales uniformly, like the GltfNode transforms the Nodes were added with.
+        const NodeTransform& prefix = m_prefixes[nodeIdx];
+        m_transforms[nodeIdx] = NodeTransform {
+            .m_translation = prefix.m_translation + prefix.m_rotation * (prefix.m_scale * translation),
+            .m_rotation = prefix.m_rotation * glm::quat(rotation.w, rotation.x, rotation.y, rotation.z),
+            .m_scale = prefix.m_scale * scale};
+    }
+}
+
+} // namespace Glitter::Scene
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "core/JobSystem.h"
+#include "scene/GltfImporter.h"
+#include "scene/NodeStore.h"
+#include "scene/Skeletons.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Glitter::Scene {
+
+// Where the GltfAsset::m_joints of an asset were added to Skeletons, and one of its skinned Nodes, whose removal from the
+// NodeStore stops the clips animating them.
+struct AnimatedJoints {
+    std::uint32_t m_firstJoint;
+    NodeHandle m_owner;
+};
+
+// Loops glTF animations on the Nodes of the loaded scenes. The channels of every clip playing are flattened into one
+// structure-of-arrays and sampled in ranges on the job system. Each channel keeps the keyframe it was last sampled at, so
+// that finding the next one is a step or two forward, and a keyframe's translation, rotation or scale fits a SIMD register,
+// interpolated in a handful of instructions. The joints of skinned Meshes are animated the same way, their transforms set in
+// Skeletons instead.
+class AnimationPlayer {
+public:
+    // Loops clip `clip` of `animations` on `nodes`, the Nodes added for the GltfAsset::m_nodes of the same asset, and on
+    // its `joints`. The channels animating joints are dropped without them.
+    void Add(const GltfAnimations& animations, std::uint32_t clip, std::span<const NodeHandle> nodes,
+        const std::optional<AnimatedJoints>& joints);
+    // Stops the clips none of whose Nodes are still in `store`.
+    void RemoveStale(const NodeStore& store);
+    void Clear();
+
+    // Samples every clip `time` seconds in, then sets the transforms of their Nodes still in `store`, and of their joints in
+    // `skeletons`.
+    void Evaluate(float time, NodeStore& store, Skeletons& skeletons, Core::JobSystem& jobs);
+
+    size_t GetChannelCount() const { return m_channelPlaybacks.size(); }
+    size_t GetNodeCount() const { return m_handles.size(); }
+
+private:
+    // In m_joints, for the Nodes.
+    static constexpr std::uint32_t NO_JOINT = UINT32_MAX;
+
+    // A clip playing on the Nodes of one scene, the ranges of the arrays below it owns.
+    struct Playback {
+        float m_duration;
+        std::uint32_t m_firstChannel;
+        std::uint32_t m_channelCount;
+        std::uint32_t m_firstNode;
+        std::uint32_t m_nodeCount;
+        std::uint32_t m_firstKeyframe;
+        std::uint32_t m_keyframeCount;
+    };
+
+    struct NodeTransform {
+        glm::vec3 m_translation;
+        glm::quat m_rotation;
+        glm::vec3 m_scale;
+    };
+
+    void SampleChannels(size_t begin, size_t end);
+    void ComposeNodes(size_t begin, size_t end);
+
+    std::vector<Playback> m_playbacks;
+    // Where each clip is at, wrapped into its duration.
+    std::vector<float> m_playbackTimes;
+
+    // Per channel, with the keyframe and Node indices relative to their Playback's.
+    std::vector<std::uint32_t> m_channelPlaybacks;
+    // The Node times 3, plus its GltfAnimationPath, into m_localParts.
+    std::vector<std::uint32_t> m_channelTargets;
+    std::vector<std::uint32_t> m_channelFirstKeyframes;
+    std::vector<std::uint32_t> m_channelKeyframeCounts;
+    std::vector<std::uint8_t> m_channelSteps;
+    // The last keyframe at or before the time the channel was last sampled at.
+    std::vector<std::uint32_t> m_channelCursors;
+
+    std::vector<float> m_keyframeTimes;
+    std::vector<glm::vec4> m_keyframeValues;
+
+    // Per Node or joint. Its index into Skeletons or NO_JOINT, the Node, or the joints' AnimatedJoints::m_owner. The
+    // translation, rotation and scale of its local transform, starting from its rest pose and overwritten by the channels
+    // animating them, and the transform of the glTF nodes folded into it.
+    std::vector<NodeHandle> m_handles;
+    std::vector<std::uint32_t> m_joints;
+    std::vector<glm::vec4> m_localParts;
+    std::vector<NodeTransform> m_prefixes;
+    std::vector<NodeTransform> m_transforms;
+};
+
+} // namespace Glitter::Scene
@@ -0,0 +1,166 @@
+#include "scene/BVH.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <numeric>
+
+namespace Glitter::Scene {
+
+void BVH::Build(const Render::CullBounds& bounds)
+{
+    m_nodes.clear();
+    m_items.resize(bounds.Size());
+    std::iota(m_items.begin(), m_items.end(), 0);
+    m_itemLeaves.resize(bounds.Size());
+
+    if (bounds.Size() == 0) {
+        return;
+    }
+
+    // A binary tree with leaves of up to LEAF_SIZE items has fewer than 2 * (items / (LEAF_SIZE / 2)) nodes.
+    m_nodes.reserve(bounds.Size() / (LEAF_SIZE / 2) * 2 + 1);
+    m_nodes.push_back(Node {});
+    BuildNode(bounds, 0, 0, static_cast<std::uint32_t>(bounds.Size()), INVALID_NODE);
+}
+
+void BVH::BuildNode(
+    const Render::CullBounds& bounds, std::uint32_t nodeIdx, std::uint32_t first, std::uint32_t count, std::uint32_t parent)
+{
+    m_nodes[nodeIdx] = Node {.m_min = {}, .m_max = {}, .m_first = first, .m_count = count, .m_parent = parent};
+    FitNode(bounds, m_nodes[nodeIdx]);
+
+    if (count <= LEAF_SIZE) {
+        for (std::uint32_t itemIdx = first; itemIdx < first + count; itemIdx++) {
+            m_itemLeaves[m_items[itemIdx]] = nodeIdx;
+        }
+        return;
+    }
+
+    // Split at the median centroid along the longest axis.
+    glm::vec3 size = m_nodes[nodeIdx].m_max - m_nodes[nodeIdx].m_min;
+    const std::vector<float>& centers
+        = size.x >= size.y && size.x >= size.z ? bounds.m_centerX : (size.y >= size.z ? bounds.m_centerY : bounds.m_centerZ);
+
+    auto begin = m_items.begin() + first;
+    std::uint32_t half = count / 2;
+    std::nth_element(begin, begin + half, begin + count, [&](std::uint32_t a, std::uint32_t b) { return centers[a] < centers[b]; });
+
+    // Both children are allocated next to each other before descending into them.
+    auto leftIdx = static_cast<std::uint32_t>(m_nodes.size());
+    m_nodes.push_back(Node {});
+    m_nodes.push_back(Node {});
+    m_nodes[nodeIdx].m_first = leftIdx;
+    m_nodes[nodeIdx].m_count = 0;
+
+    BuildNode(bounds, leftIdx, first, half, nodeIdx);
+    BuildNode(bounds, leftIdx + 1, first + half, count - half, nodeIdx);
+}
+
+void BVH::FitNode(const Render::CullBounds& bounds, Node& node) const
+{
+    node.m_min = glm::vec3(std::numeric_limits<float>::max());
+    node.m_max = glm::vec3(std::numeric_limits<float>::lowest());
+
+    if (node.IsLeaf()) {
+        for (std::uint32_t itemIdx = node.m_first; itemIdx < node.m_first + node.m_count; itemIdx++) {
+            std::uint32_t item = m_items[itemIdx];
+            glm::vec3 center = bounds.GetCenter(item);
+            glm::vec3 extent = bounds.GetExtent(item);
+            node.m_min = glm::min(node.m_min, center - extent);
+            node.m_max = glm::max(node.m_max, center + extent);
+        }
+    } else {
+        for (std::uint32_t childIdx = node.m_first; childIdx < node.m_first + 2; childIdx++) {
+            node.m_min = glm::min(node.m_min, m_nodes[childIdx].m_min);
+            node.m_max = glm::max(node.m_max, m_nodes[childIdx].m_max);
+        }
+    }
+}
+
+void BVH::Refit(const Render::CullBounds& bounds, std::span<const std::uint32_t> items)
+{
+    for (std::uint32_t item : items) {
+        // Walk up from the item's leaf, stopping early once a node's bounds didn't change.
+        std::uint32_t nodeIdx = m_itemLeaves[item];
+        while (nodeIdx != INVALID_NODE) {
+            Node& node = m_nodes[nodeIdx];
+            glm::vec3 oldMin = node.m_min;
+            glm::vec3 oldMax = node.m_max;
+            FitNode(bounds, node);
+            if (node.m_min == oldMin && node.m_max == oldMax) {
+                break;
+            }
+            nodeIdx = node.m_parent;
+        }
+    }
+}
+
+void BVH::MarkSubtree(const Node& node, Render::VisibilityMask& visibility) const
+{
+    if (node.IsLeaf()) {
+        for (std::uint32_t itemIdx = node.m_first; itemIdx < node.m_first + node.m_count; itemIdx++) {
+            std::uint32_t item = m_items[itemIdx];
+            visibility[item / 64] |= std::uint64_t {1} << (item % 64);
+        }
+    } else {
+        MarkSubtree(m_nodes[node.m_first], visibility);
+        MarkSubtree(m_nodes[node.m_first + 1], visibility);
+    }
+}
+
+size_t BVH::Cull(const Render::FrustumPlanes& planes, const Render::CullBounds& bounds, Render::VisibilityMask& visibility) const
+{
+    visibility.assign((m_items.size() + 63) / 64, 0);
+    if (m_nodes.empty()) {
+        return 0;
+    }
+
+    struct StackEntry {
+        std::uint32_t m_node;
+        std::uint8_t m_planeMask;
+    };
+    std::vector<StackEntry> stack {};
+    stack.push_back(StackEntry {.m_node = 0, .m_planeMask = Render::ALL_PLANES});
+
+    size_t visibleCount = 0;
+    while (!stack.empty()) {
+        StackEntry entry = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_nodes[entry.m_node];
+        std::uint8_t planeMask = entry.m_planeMask;
+        Render::CullResult result
+            = Render::TestAABB(planes, (node.m_min + node.m_max) * 0.5f, (node.m_max - node.m_min) * 0.5f, planeMask);
+        if (result == Render::CullResult::Outside) {
+            continue;
+        }
+
+        // Once inside every plane, so is everything below.
+        if (result == Render::CullResult::Inside) {
+            MarkSubtree(node, visibility);
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            for (std::uint32_t itemIdx = node.m_first; itemIdx < node.m_first + node.m_count; itemIdx++) {
+                std::uint32_t item = m_items[itemIdx];
+                std::uint8_t itemMask = planeMask;
+                Render::CullResult itemResult = Render::TestAABB(planes, bounds.GetCenter(item), bounds.GetExtent(item), itemMask);
+                if (itemResult != Render::CullResult::Outside) {
+                    visibility[item / 64] |= std::uint64_t {1} << (item % 64);
+                }
+            }
+        } else {
+            stack.push_back(StackEntry {.m_node = node.m_first + 1, .m_planeMask = planeMask});
+            stack.push_back(StackEntry {.m_node = node.m_first, .m_planeMask = planeMask});
+        }
+    }
+
+    for (std::uint64_t word : visibility) {
+        visibleCount += static_cast<size_t>(std::popcount(word));
+    }
+    return m_items.size() - visibleCount;
+}
+
+} // namespace Glitter::Scene
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "render/FrustumCulling.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Glitter::Scene {
+
+// A bounding volume hierarchy over a set of AABBs, so that frustum queries only descend into the subtrees intersecting
+// the frustum. Items are referenced by their index in the Render::CullBounds the hierarchy was built from.
+class BVH {
+public:
+    // Rebuilds the hierarchy over every AABB in `bounds`, splitting each node at the median of its longest axis.
+    void Build(const Render::CullBounds& bounds);
+
+    // Refits the bounds of every node containing one of `items`, after their AABBs in `bounds` changed. The hierarchy's
+    // structure is kept, so it degrades when items move far, at which point it should be rebuilt instead.
+    void Refit(const Render::CullBounds& bounds, std::span<const std::uint32_t> items);
+
+    // Writes the visibility of every item into `visibility` and returns the number of culled items. Subtrees fully
+    // inside the frustum are accepted without testing their items.
+    size_t Cull(const Render::FrustumPlanes& planes, const Render::CullBounds& bounds, Render::VisibilityMask& visibility) const;
+
+    size_t GetItemCount() const { return m_items.size(); }
+    size_t GetNodeCount() const { return m_nodes.size(); }
+
+private:
+    static constexpr std::uint32_t LEAF_SIZE = 8;
+    static constexpr std::uint32_t INVALID_NODE = UINT32_MAX;
+
+    struct Node {
+        glm::vec3 m_min;
+        glm::vec3 m_max;
+
+        // Leaves reference m_items[m_first, m_first + m_count), inner nodes have their children at m_first and
+        // m_first + 1.
+        std::uint32_t m_first;
+        std::uint32_t m_count;
+        std::uint32_t m_parent;
+
+        bool IsLeaf() const { return m_count != 0; }
+    };
+
+    void BuildNode(
+        const Render::CullBounds& bounds, std::uint32_t nodeIdx, std::uint32_t first, std::uint32_t count, std::uint32_t parent);
+    void FitNode(const Render::CullBounds& bounds, Node& node) const;
+    void MarkSubtree(const Node& node, Render::VisibilityMask& visibility) const;
+
+    std::vector<Node> m_nodes;
+    std::vector<std::uint32_t> m_items;
+    // The leaf containing each item, used to refit from the bottom up.
+    std::vector<std::uint32_t> m_itemLeaves;
+};
+
+} // namespace Glitter::Scene
@@ -0,0 +1,221 @@
+#include "scene/EntityWorld.h"
+
+#include "util/RingQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+namespace Glitter::Scene {
+
+namespace {
+
+    struct ComponentType {
+        size_t m_size;
+        size_t m_alignment;
+    };
+
+    // Never reallocated, so that the types registered can be read while another one is.
+    std::array<ComponentType, MAX_COMPONENT_TYPES> s_componentTypes {};
+    std::atomic<std::uint32_t> s_componentTypeCount {};
+    std::mutex s_componentTypeMutex;
+
+    // The arrays of a chunk start on their own cache line.
+    constexpr size_t ARRAY_ALIGNMENT = Util::CACHE_LINE_SIZE;
+
+    size_t AlignUp(size_t offset, size_t alignment) { return (offset + alignment - 1) / alignment * alignment; }
+
+    // The bytes a chunk of `capacity` entities of `mask` takes, and the offset of each of their arrays.
+    size_t LayOutChunk(ComponentMask mask, std::uint32_t capacity, std::array<std::uint32_t, MAX_COMPONENT_TYPES>& offsets)
+    {
+        size_t size = sizeof(std::uint32_t) * capacity;
+        for (ComponentMask remaining = mask; remaining != 0; remaining &= remaining - 1) {
+            auto componentID = static_cast<std::uint32_t>(std::countr_zero(remaining));
+            const ComponentType& type = s_componentTypes[componentID];
+            size = AlignUp(size, std::max(type.m_alignment, ARRAY_ALIGNMENT));
+            offsets[componentID] = static_cast<std::uint32_t>(size);
+            size += type.m_size * capacity;
+        }
+        return size;
+    }
+
+} // namespace
+
+namespace Detail {
+    std::uint32_t RegisterComponent(size_t size, size_t alignment)
+    {
+        std::scoped_lock lock(s_componentTypeMutex);
+        std::uint32_t componentID = s_componentTypeCount.load(std::memory_order_relaxed);
+        if (componentID == MAX_COMPONENT_TYPES) {
+            spdlog::critical("More than {} component types.", MAX_COMPONENT_TYPES);
+            std::abort();
+        }
+        s_componentTypes[componentID] = ComponentType {.m_size = size, .m_alignment = alignment};
+        s_componentTypeCount.store(componentID + 1, std::memory_order_release);
+        return componentID;
+    }
+} // namespace Detail
+
+void EntityWorld::ChunkDeleter::operator()(std::byte* data) const
+{
+    ::operator delete(data, std::align_val_t {ARRAY_ALIGNMENT});
+}
+
+bool EntityWorld::Destroy(EntityHandle handle)
+{
+    if (!IsValid(handle)) {
+        return false;
+    }
+
+    Slot& slot = m_slots[handle.m_slot];
+    FreeRow(slot.m_location);
+    slot.m_location.m_archetype = INVALID_ARCHETYPE;
+    slot.m_generation++;
+    m_freeSlots.push_back(handle.m_slot);
+    m_entityCount--;
+    return true;
+}
+
+void EntityWorld::Clear()
+{
+    // The archetypes are kept, along with their place in the iteration order.
+    for (Archetype& archetype : m_archetypes) {
+        archetype.m_chunks.clear();
+    }
+    for (std::uint32_t slotIdx = 0; slotIdx < m_slots.size(); slotIdx++) {
+        Slot& slot = m_slots[slotIdx];
+        if (slot.m_location.m_archetype != INVALID_ARCHETYPE) {
+            slot.m_location.m_archetype = INVALID_ARCHETYPE;
+            slot.m_generation++;
+            m_freeSlots.push_back(slotIdx);
+        }
+    }
+    m_entityCount = 0;
+}
+
+std::pair<EntityHandle, EntityWorld::Location> EntityWorld::CreateEntity(ComponentMask mask)
+{
+    std::uint32_t slotIdx = 0;
+    if (!m_freeSlots.empty()) {
+        slotIdx = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slotIdx = static_cast<std::uint32_t>(m_slots.size());
+        m_slots.push_back(Slot {.m_location = {}, .m_generation = 0});
+    }
+
+    Location location = AllocateRow(FindArchetype(mask), slotIdx);
+    m_slots[slotIdx].m_location = location;
+    m_entityCount++;
+    return {EntityHandle {.m_slot = slotIdx, .m_generation = m_slots[slotIdx].m_generation}, location};
+}
+
+void* EntityWorld::FindComponent(EntityHandle handle, std::uint32_t componentID)
+{
+    if (!IsValid(handle)) {
+        return nullptr;
+    }
+
+    const Location& location = m_slots[handle.m_slot].m_location;
+    const Archetype& archetype = m_archetypes[location.m_archetype];
+    if ((archetype.m_mask & (ComponentMask {1} << componentID)) == 0) {
+        return nullptr;
+    }
+    return archetype.m_chunks[location.m_chunk].m_data.get() + archetype.m_offsets[componentID]
+        + location.m_row * s_componentTypes[componentID].m_size;
+}
+
+EntityWorld::Location EntityWorld::ChangeArchetype(EntityHandle handle, ComponentMask mask)
+{
+    Location from = m_slots[handle.m_slot].m_location;
+    if (m_archetypes[from.m_archetype].m_mask == mask) {
+        return from;
+    }
+
+    // Finding the archetype may add one, so the references into m_archetypes are only taken past it.
+    std::uint32_t toArchetype = FindArchetype(mask);
+    Location to = AllocateRow(toArchetype, handle.m_slot);
+    const Archetype& source = m_archetypes[from.m_archetype];
+    const Archetype& target = m_archetypes[to.m_archetype];
+    const std::byte* sourceData = source.m_chunks[from.m_chunk].m_data.get();
+    std::byte* targetData = target.m_chunks[to.m_chunk].m_data.get();
+    for (ComponentMask shared = source.m_mask & mask; shared != 0; shared &= shared - 1) {
+        auto componentID = static_cast<std::uint32_t>(std::countr_zero(shared));
+        size_t size = s_componentTypes[componentID].m_size;
+        std::memcpy(targetData + target.m_offsets[componentID] + to.m_row * size,
+            sourceData + source.m_offsets[componentID] + from.m_row * size, size);
+    }
+
+    FreeRow(from);
+    m_slots[handle.m_slot].m_location = to;
+    return to;
+}
+
+std::uint32_t EntityWorld::FindArchetype(ComponentMask mask)
+{
+    auto it = std::ranges::find(m_archetypes, mask, &Archetype::m_mask);
+    if (it != m_archetypes.end()) {
+        return static_cast<std::uint32_t>(it - m_archetypes.begin());
+    }
+
+    // As many entities as fit in a chunk, or a single one if it's larger.
+    Archetype archetype {.m_mask = mask, .m_chunkSize = 0, .m_capacity = 0, .m_offsets = {}, .m_chunks = {}};
+    size_t entitySize = sizeof(std::uint32_t);
+    for (ComponentMask remaining = mask; remaining != 0; remaining &= remaining - 1) {
+        entitySize += s_componentTypes[std::countr_zero(remaining)].m_size;
+    }
+    archetype.m_capacity = static_cast<std::uint32_t>(std::max<size_t>(Config::ENTITY_CHUNK_SIZE / entitySize, 1));
+    while (archetype.m_capacity > 1 && LayOutChunk(mask, archetype.m_capacity, archetype.m_offsets) > Config::ENTITY_CHUNK_SIZE) {
+        archetype.m_capacity--;
+    }
+    archetype.m_chunkSize = LayOutChunk(mask, archetype.m_capacity, archetype.m_offsets);
+    m_archetypes.push_back(std::move(archetype));
+    return static_cast<std::uint32_t>(m_archetypes.size() - 1);
+}
+
+EntityWorld::Location EntityWorld::AllocateRow(std::uint32_t archetypeIdx, std::uint32_t slot)
+{
+    Archetype& archetype = m_archetypes[archetypeIdx];
+    if (archetype.m_chunks.empty() || archetype.m_chunks.back().m_count == archetype.m_capacity) {
+        auto* data = static_cast<std::byte*>(::operator new(archetype.m_chunkSize, std::align_val_t {ARRAY_ALIGNMENT}));
+        archetype.m_chunks.push_back(Chunk {.m_data = std::unique_ptr<std::byte[], ChunkDeleter>(data), .m_count = 0});
+    }
+
+    Chunk& chunk = archetype.m_chunks.back();
+    std::uint32_t row = chunk.m_count++;
+    std::memcpy(chunk.m_data.get() + row * sizeof(std::uint32_t), &slot, sizeof(slot));
+    return Location {
+        .m_archetype = archetypeIdx, .m_chunk = static_cast<std::uint32_t>(archetype.m_chunks.size() - 1), .m_row = row};
+}
+
+void EntityWorld::FreeRow(const Location& location)
+{
+    Archetype& archetype = m_archetypes[location.m_archetype];
+    Chunk& last = archetype.m_chunks.back();
+    std::uint32_t lastRow = last.m_count - 1;
+    auto lastChunk = static_cast<std::uint32_t>(archetype.m_chunks.size() - 1);
+    if (location.m_chunk != lastChunk || location.m_row != lastRow) {
+        std::byte* data = archetype.m_chunks[location.m_chunk].m_data.get();
+        const std::byte* lastData = last.m_data.get();
+        std::uint32_t movedSlot = 0;
+        std::memcpy(&movedSlot, lastData + lastRow * sizeof(std::uint32_t), sizeof(movedSlot));
+        std::memcpy(data + location.m_row * sizeof(std::uint32_t), &movedSlot, sizeof(movedSlot));
+        for (ComponentMask remaining = archetype.m_mask; remaining != 0; remaining &= remaining - 1) {
+            auto componentID = static_cast<std::uint32_t>(std::countr_zero(remaining));
+            size_t size = s_componentTypes[componentID].m_size;
+            std::memcpy(data + archetype.m_offsets[componentID] + location.m_row * size,
+                lastData + archetype.m_offsets[componentID] + lastRow * size, size);
+        }
+        m_slots[movedSlot].m_location = location;
+    }
+
+    last.m_count--;
+    if (last.m_count == 0) {
+        archetype.m_chunks.pop_back();
+    }
+}
+
+} // namespace Glitter::Scene
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "Config.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Glitter::Scene {
+
+// Stable reference to an entity of an EntityWorld, like a NodeHandle is to a Node.
+struct EntityHandle {
+    std::uint32_t m_slot;
+    std::uint32_t m_generation;
+
+    bool operator==(const EntityHandle&) const = default;
+};
+
+// Components are plain data, so that an entity moves between chunks by copying its bytes, aligned to a cache line at most,
+// which their arrays start on.
+template <typename T>
+concept Component = std::is_trivially_copyable_v<T> && !std::is_const_v<T> && alignof(T) <= 64;
+
+// Bit `i` is set for the component type of ID `i`.
+using ComponentMask = std::uint64_t;
+constexpr size_t MAX_COMPONENT_TYPES = 64;
+
+namespace Detail {
+    // Assigns the next component ID to a type of `size` and `alignment`, from any thread.
+    std::uint32_t RegisterComponent(size_t size, size_t alignment);
+
+    template <Component T> std::uint32_t GetComponentID()
+    {
+        static const std::uint32_t id = RegisterComponent(sizeof(T), alignof(T));
+        return id;
+    }
+    template <Component... Ts> ComponentMask GetComponentMask()
+    {
+        return (ComponentMask {0} | ... | (ComponentMask {1} << GetComponentID<Ts>()));
+    }
+} // namespace Detail
+
+// Entities grouped by archetype, the set of components they have. Each archetype keeps its entities in chunks of
+// Config::ENTITY_CHUNK_SIZE bytes, and each chunk its components as one array per component type, so that a system
+// iterating a few components over every entity having them, see ForEachChunk(), streams through contiguous arrays of just
+// those, and skips the archetypes that lack any. The Nodes themselves stay in the NodeStore, the archetype they'd all
+// share.
+//
+// The chunks are kept packed: removing an entity, or moving it to another archetype by adding or removing a component,
+// moves the last entity of its archetype into its place. Pointers and spans into the chunks are invalidated by any
+// change to the entities, the handles aren't. Single-threaded, but for concurrent reads.
+class EntityWorld {
+public:
+    EntityWorld() = default;
+    EntityWorld(const EntityWorld&) = delete;
+    EntityWorld& operator=(const EntityWorld&) = delete;
+    EntityWorld(EntityWorld&&) = default;
+    EntityWorld& operator=(EntityWorld&&) = default;
+
+    template <Component... Ts> EntityHandle Create(const Ts&... components)
+    {
+        auto [handle, location] = CreateEntity(Detail::GetComponentMask<Ts...>());
+        (WriteComponent(location, components), ...);
+        return handle;
+    }
+    // Returns false if the entity was already destroyed.
+    bool Destroy(EntityHandle handle);
+    void Clear();
+
+    bool IsValid(EntityHandle handle) const
+    {
+        return handle.m_slot < m_slots.size() && m_slots[handle.m_slot].m_generation == handle.m_generation
+            && m_slots[handle.m_slot].m_location.m_archetype != INVALID_ARCHETYPE;
+    }
+    size_t Size() const { return m_entityCount; }
+
+    // The component of a valid entity, or nullptr if it doesn't have one.
+    template <Component T> T* Get(EntityHandle handle)
+    {
+        return static_cast<T*>(FindComponent(handle, Detail::GetComponentID<T>()));
+    }
+    template <Component T> const T* Get(EntityHandle handle) const
+    {
+        return static_cast<const T*>(const_cast<EntityWorld*>(this)->FindComponent(handle, Detail::GetComponentID<T>()));
+    }
+    // Sets the component of an entity, moving it to the archetype with it if it didn't have one. Returns false if the
+    // entity was destroyed.
+    template <Component T> bool Set(EntityHandle handle, const T& component)
+    {
+        if (!IsValid(handle)) {
+            return false;
+        }
+        Location location = ChangeArchetype(handle, GetMask(handle) | Detail::GetComponentMask<T>());
+        WriteComponent(location, component);
+        return true;
+    }
+    // Moves an entity to the archetype without the component. Returns false if the entity was destroyed.
+    template <Component T> bool Remove(EntityHandle handle)
+    {
+        if (!IsValid(handle)) {
+            return false;
+        }
+        ChangeArchetype(handle, GetMask(handle) & ~Detail::GetComponentMask<T>());
+        return true;
+    }
+
+    // Calls `function(std::span<Ts>...)` once per chunk of every archetype having all of `Ts`, with the chunk's arrays of
+    // them, the archetypes in the order they were first used, and the entities of each in the order they were added
+    // until some are removed.
+    template <Component... Ts, typename F> void ForEachChunk(F&& function)
+    {
+        ComponentMask mask = Detail::GetComponentMask<Ts...>();
+        const std::array<std::uint32_t, sizeof...(Ts)> ids {Detail::GetComponentID<Ts>()...};
+        for (Archetype& archetype : m_archetypes) {
+            if ((archetype.m_mask & mask) != mask) {
+                continue;
+            }
+            for (Chunk& chunk : archetype.m_chunks) {
+                [&]<size_t... Is>(std::index_sequence<Is...>) {
+                    function(std::span<Ts>(
+                        reinterpret_cast<Ts*>(chunk.m_data.get() + archetype.m_offsets[ids[Is]]), chunk.m_count)...);
+                }(std::index_sequence_for<Ts...> {});
+            }
+        }
+    }
+    template <Component... Ts, typename F> void ForEachChunk(F&& function) const
+    {
+        const_cast<EntityWorld*>(this)->ForEachChunk<Ts...>(
+            [&](std::span<Ts>... components) { function(std::span<const Ts>(components)...); });
+    }
+    // Calls `function(Ts&...)` for every entity having all of `Ts`, in the order of ForEachChunk().
+    template <Component... Ts, typename F> void ForEach(F&& function)
+    {
+        ForEachChunk<Ts...>([&](std::span<Ts>... components) {
+            size_t count = std::get<0>(std::tie(components...)).size();
+            for (size_t i = 0; i < count; i++) {
+                function(components[i]...);
+            }
+        });
+    }
+    template <Component... Ts, typename F> void ForEach(F&& function) const
+    {
+        ForEachChunk<Ts...>([&](std::span<const Ts>... components) {
+            size_t count = std::get<0>(std::tie(components...)).size();
+            for (size_t i = 0; i < count; i++) {
+                function(components[i]...);
+            }
+        });
+    }
+
+    size_t GetArchetypeCount() const { return m_archetypes.size(); }
+
+private:
+    static constexpr std::uint32_t INVALID_ARCHETYPE = UINT32_MAX;
+
+    struct ChunkDeleter {
+        void operator()(std::byte* data) const;
+    };
+    struct Chunk {
+        std::unique_ptr<std::byte[], ChunkDeleter> m_data;
+        std::uint32_t m_count;
+    };
+    // Every chunk of m_chunkSize bytes holds up to m_capacity entities: the slot of each, then the array of each
+    // component, at the offset of its ID.
+    struct Archetype {
+        ComponentMask m_mask;
+        size_t m_chunkSize;
+        std::uint32_t m_capacity;
+        std::array<std::uint32_t, MAX_COMPONENT_TYPES> m_offsets;
+        std::vector<Chunk> m_chunks;
+    };
+    struct Location {
+        std::uint32_t m_archetype;
+        std::uint32_t m_chunk;
+        std::uint32_t m_row;
+    };
+    struct Slot {
+        // The archetype is INVALID_ARCHETYPE if the slot is free.
+        Location m_location;
+        std::uint32_t m_generation;
+    };
+
+    std::pair<EntityHandle, Location> CreateEntity(ComponentMask mask);
+    ComponentMask GetMask(EntityHandle handle) const
+    {
+        return m_archetypes[m_slots[handle.m_slot].m_location.m_archetype].m_mask;
+    }
+    void* FindComponent(EntityHandle handle, std::uint32_t componentID);
+    // Moves a valid entity to the archetype of `mask`, keeping the components both have. Returns its new location.
+    Location ChangeArchetype(EntityHandle handle, ComponentMask mask);
+
+    std::uint32_t FindArchetype(ComponentMask mask);
+    // Appends a row for `slot` to the last chunk of `archetypeIdx`, adding a chunk if it's full.
+    Location AllocateRow(std::uint32_t archetypeIdx, std::uint32_t slot);
+    // Moves the last row of the archetype into the row at `location`, and drops the last row.
+    void FreeRow(const Location& location);
+
+    template <Component T> void WriteComponent(const Location& location, const T& component)
+    {
+        const Archetype& archetype = m_archetypes[location.m_archetype];
+        std::byte* data = archetype.m_chunks[location.m_chunk].m_data.get();
+        std::memcpy(data + archetype.m_offsets[Detail::GetComponentID<T>()] + location.m_row * sizeof(T), &component, sizeof(T));
+    }
+
+    std::vector<Archetype> m_archetypes;
+    std::vector<Slot> m_slots;
+    std::vector<std::uint32_t> m_freeSlots;
+    size_t m_entityCount {};
+};
+
+} // namespace Glitter::Scene
@@ -0,0 +1,725 @@
+#include "scene/GltfImporter.h"
+
+#include "util/File.h"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace Glitter::Scene {
+
+namespace {
+
+    const AABB EMPTY_AABB {.m_localMin = glm::vec3(FLT_MAX), .m_localMax = glm::vec3(-FLT_MAX)};
+
+    // Copies `copySize` bytes of each of `count` elements, `sourceStride` apart, into the attribute of the vertices at
+    // `destination`. The size is a constant for the accessors that have all of the attribute's components, so that the
+    // copy of each vertex compiles down to a few moves.
+    template <typename Vertex, size_t copySize>
+    void CopyAttribute(std::byte* destination, const std::uint8_t* source, size_t sourceStride, size_t count)
+    {
+        for (size_t vertexIdx = 0; vertexIdx < count; vertexIdx++) {
+            std::memcpy(destination + sizeof(Vertex) * vertexIdx, source + sourceStride * vertexIdx, copySize);
+        }
+    }
+
+    // Copies each element of `accessor` into the `semantic` attribute of the vertices, as laid out by their VertexFormat,
+    // dropping the components past the attribute's. Plain float data is copied straight from its buffer view, anything
+    // else (normalized integers, sparse accessors) is converted through cgltf_accessor_unpack_floats() into `scratch`
+    // first.
+    template <VertexSemantic semantic, typename Vertex>
+    void UnpackAttribute(const cgltf_accessor& accessor, std::span<Vertex> vertices, std::vector<float>& scratch)
+    {
+        constexpr VertexAttribute ATTRIBUTE = FindVertexAttribute<Vertex>(semantic);
+        static_assert(ATTRIBUTE.m_type == VertexAttributeType::Float, "The importer only unpacks float attributes.");
+        constexpr size_t ATTRIBUTE_SIZE = GetAttributeSize(ATTRIBUTE);
+
+        size_t count = std::min<size_t>(accessor.count, vertices.size());
+        size_t accessorComponents = cgltf_num_components(accessor.type);
+        auto* destination = reinterpret_cast<std::byte*>(vertices.data()) + ATTRIBUTE.m_offset;
+
+        const std::uint8_t* source = nullptr;
+        size_t sourceStride = 0;
+        if (accessor.buffer_view && !accessor.is_sparse && accessor.component_type == cgltf_component_type_r_32f) {
+            source = cgltf_buffer_view_data(accessor.buffer_view) + accessor.offset;
+            sourceStride = accessor.stride;
+        } else {
+            scratch.resize(count * accessorComponents);
+            cgltf_accessor_unpack_floats(&accessor, scratch.data(), scratch.size());
+            source = reinterpret_cast<const std::uint8_t*>(scratch.data());
+            sourceStride = sizeof(float) * accessorComponents;
+        }
+
+        if (accessorComponents >= ATTRIBUTE.m_componentCount) {
+            CopyAttribute<Vertex, ATTRIBUTE_SIZE>(destination, source, sourceStride, count);
+        } else {
+            // Malformed, the missing components are left as they were.
+            for (size_t vertexIdx = 0; vertexIdx < count; vertexIdx++) {
+                std::memcpy(destination + sizeof(Vertex) * vertexIdx, source + sourceStride * vertexIdx,
+                    sizeof(float) * accessorComponents);
+            }
+        }
+    }
+
+    // Non-indexed primitives get a sequential index list, so every primitive can go through the same indexed draws.
+    // Packs the 4 joints and weights influencing each vertex. The weights are renormalized to sum to 1 before being
+    // quantized, and a vertex without any weight follows its first joint.
+    void UnpackInfluences(const cgltf_accessor& joints, const cgltf_accessor& weights, size_t vertexCount,
+        std::vector<SkinnedVertex>& skinnedVertices)
+    {
+        skinnedVertices.resize(vertexCount);
+        for (size_t vertexIdx = 0; vertexIdx < vertexCount; vertexIdx++) {
+            std::array<cgltf_uint, 4> joint {};
+            glm::vec4 weight {0.0f};
+            if (vertexIdx < joints.count) {
+                cgltf_accessor_read_uint(&joints, vertexIdx, joint.data(), 4);
+            }
+            if (vertexIdx < weights.count) {
+                cgltf_accessor_read_float(&weights, vertexIdx, &weight.x, 4);
+            }
+            weight = glm::max(weight, glm::vec4(0.0f));
+            float sum = weight.x + weight.y + weight.z + weight.w;
+            weight = sum > 0.0f ? weight / sum : glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+
+            for (size_t influenceIdx = 0; influenceIdx < 4; influenceIdx++) {
+                joint[influenceIdx] = std::min<cgltf_uint>(joint[influenceIdx], UINT16_MAX);
+            }
+            SkinnedVertex& skinned = skinnedVertices[vertexIdx];
+            skinned.m_joints = {joint[0] | joint[1] << 16, joint[2] | joint[3] << 16};
+            skinned.m_weights = {glm::packUnorm2x16(glm::vec2(weight.x, weight.y)),
+                glm::packUnorm2x16(glm::vec2(weight.z, weight.w))};
+        }
+    }
+
+    void UnpackIndices(const cgltf_accessor* accessor, size_t vertexCount, std::vector<std::uint32_t>& indices)
+    {
+        if (!accessor) {
+            indices.resize(vertexCount);
+            std::iota(indices.begin(), indices.end(), 0u);
+            return;
+        }
+
+        indices.resize(accessor->count);
+        if (cgltf_accessor_unpack_indices(accessor, indices.data(), sizeof(std::uint32_t), indices.size()) == indices.size()) {
+            return;
+        }
+
+        // Sparse index accessors can't be unpacked in bulk.
+        for (size_t indexIdx = 0; indexIdx < indices.size(); indexIdx++) {
+            indices[indexIdx] = static_cast<std::uint32_t>(cgltf_accessor_read_index(accessor, indexIdx));
+        }
+    }
+
+    // Grows `aabb` to enclose the position of every vertex. The 4-wide loads cover x, y, z and u, the latter is dropped.
+    void ExpandAABB(AABB& aabb, std::span<const MeshVertex> vertices)
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+        __m128 localMin = _mm_setr_ps(aabb.m_localMin.x, aabb.m_localMin.y, aabb.m_localMin.z, 0.0f);
+        __m128 localMax = _mm_setr_ps(aabb.m_localMax.x, aabb.m_localMax.y, aabb.m_localMax.z, 0.0f);
+        for (const MeshVertex& vertex : vertices) {
+            __m128 position = _mm_loadu_ps(&vertex.x);
+            localMin = _mm_min_ps(localMin, position);
+            localMax = _mm_max_ps(localMax, position);
+        }
+
+        alignas(16) std::array<float, 4> lanes {};
+        _mm_store_ps(lanes.data(), localMin);
+        aabb.m_localMin = glm::vec3 {lanes[0], lanes[1], lanes[2]};
+        _mm_store_ps(lanes.data(), localMax);
+        aabb.m_localMax = glm::vec3 {lanes[0], lanes[1], lanes[2]};
+#elif defined(__ARM_NEON)
+        float32x4_t localMin = {aabb.m_localMin.x, aabb.m_localMin.y, aabb.m_localMin.z, 0.0f};
+        float32x4_t localMax = {aabb.m_localMax.x, aabb.m_localMax.y, aabb.m_localMax.z, 0.0f};
+        for (const MeshVertex& vertex : vertices) {
+            float32x4_t position = vld1q_f32(&vertex.x);
+            localMin = vminq_f32(localMin, position);
+            localMax = vmaxq_f32(localMax, position);
+        }
+
+        aabb.m_localMin = glm::vec3 {vgetq_lane_f32(localMin, 0), vgetq_lane_f32(localMin, 1), vgetq_lane_f32(localMin, 2)};
+        aabb.m_localMax = glm::vec3 {vgetq_lane_f32(localMax, 0), vgetq_lane_f32(localMax, 1), vgetq_lane_f32(localMax, 2)};
+#else
+        for (const MeshVertex& vertex : vertices) {
+            glm::vec3 position {vertex.x, vertex.y, vertex.z};
+            aabb.m_localMin = glm::min(aabb.m_localMin, position);
+            aabb.m_localMax = glm::max(aabb.m_localMax, position);
+        }
+#endif
+    }
+
+    // Splits `model` back into a GltfNode's translation, rotation and scale. Shears, which only come out of non-uniform
+    // scales under rotated children, are lost.
+    // Maps the metallic-roughness model onto Blinn-Phong terms: the roughness onto the exponent of a highlight of about the
+    // same width, and the metalness onto the reflectance, from a dielectric's 4% up. The highlight fades out as the surface
+    // gets rougher, since the unnormalized Blinn-Phong lobe doesn't.
+    GltfMaterial ExtractMaterial(const cgltf_material& material)
+    {
+        const cgltf_pbr_metallic_roughness& pbr = material.pbr_metallic_roughness;
+        float roughness = std::clamp(pbr.roughness_factor, 0.0f, 1.0f);
+        float alpha = std::max(roughness * roughness, 0.03f);
+        return GltfMaterial {.m_baseColor = glm::make_vec4(pbr.base_color_factor),
+            .m_specularStrength = glm::mix(0.04f, 1.0f, std::clamp(pbr.metallic_factor, 0.0f, 1.0f)) * (1.0f - roughness),
+            .m_specularExponent = std::max(2.0f / (alpha * alpha) - 2.0f, 1.0f)};
+    }
+
+    GltfNode DecomposeNode(const glm::mat4& model, std::uint32_t parent, std::uint32_t mesh)
+    {
+        glm::vec3 scale {glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))};
+        glm::quat rotation {1.0f, 0.0f, 0.0f, 0.0f};
+        if (scale.x > 0.0f && scale.y > 0.0f && scale.z > 0.0f) {
+            glm::mat3 basis {glm::vec3(model[0]) / scale.x, glm::vec3(model[1]) / scale.y, glm::vec3(model[2]) / scale.z};
+            // A mirroring Model keeps a proper rotation, and flips the scale instead.
+            if (glm::determinant(basis) < 0.0f) {
+                scale.x = -scale.x;
+                basis[0] = -basis[0];
+            }
+            rotation = glm::normalize(glm::quat_cast(basis));
+        }
+
+        return GltfNode {.m_translation = glm::vec3(model[3]),
+            .m_rotation = rotation,
+            .m_scale = scale,
+            .m_parent = parent,
+            .m_mesh = mesh,
+            .m_skin = GLTF_NO_SKIN};
+    }
+
+    // The transform of EXT_mesh_gpu_instancing instance `instanceIdx` of `node`, relative to it.
+    glm::mat4 GetInstanceModel(const cgltf_node& node, size_t instanceIdx)
+    {
+        glm::vec3 translation {0.0f};
+        glm::vec4 rotation {0.0f, 0.0f, 0.0f, 1.0f};
+        glm::vec3 scale {1.0f};
+        for (cgltf_size attribIdx = 0; attribIdx < node.mesh_gpu_instancing.attributes_count; attribIdx++) {
+            const cgltf_attribute& attrib = node.mesh_gpu_instancing.attributes[attribIdx];
+            if (std::strcmp(attrib.name, "TRANSLATION") == 0) {
+                cgltf_accessor_read_float(attrib.data, instanceIdx, &translation.x, 3);
+            } else if (std::strcmp(attrib.name, "ROTATION") == 0) {
+                cgltf_accessor_read_float(attrib.data, instanceIdx, &rotation.x, 4);
+            } else if (std::strcmp(attrib.name, "SCALE") == 0) {
+                cgltf_accessor_read_float(attrib.data, instanceIdx, &scale.x, 3);
+            }
+        }
+
+        // glTF stores quaternions as x, y, z, w.
+        return glm::translate(glm::mat4(1.0f), translation)
+            * glm::mat4_cast(glm::quat(rotation.w, rotation.x, rotation.y, rotation.z)) * glm::scale(glm::mat4(1.0f), scale);
+    }
+
+    size_t GetInstanceCount(const cgltf_node& node)
+    {
+        size_t count = SIZE_MAX;
+        for (cgltf_size attribIdx = 0; attribIdx < node.mesh_gpu_instancing.attributes_count; attribIdx++) {
+            count = std::min<size_t>(count, node.mesh_gpu_instancing.attributes[attribIdx].data->count);
+        }
+        return node.mesh_gpu_instancing.attributes_count > 0 ? count : 0;
+    }
+
+    // A glTF node that became a GltfNode or a GltfJoint of its own, with the transform of the glTF nodes folded into it.
+    struct ExtractedNode {
+        std::uint32_t m_node;
+        glm::mat4 m_prefix;
+    };
+
+    // The glTF nodes of the scene that became a GltfNode, drawing a Mesh without being skinned nor instanced by
+    // EXT_mesh_gpu_instancing, or a GltfJoint.
+    struct ExtractedNodes {
+        std::vector<std::optional<ExtractedNode>> m_nodes;
+        std::vector<std::optional<ExtractedNode>> m_joints;
+    };
+
+    // Walks the default scene depth-first, so that parents are added before their children, and joints before the joints
+    // below them. Then gathers the joints of each skin.
+    void ExtractNodes(const cgltf_data& data, GltfAsset& asset, ExtractedNodes& extracted)
+    {
+        extracted.m_nodes.assign(data.nodes_count, std::nullopt);
+        extracted.m_joints.assign(data.nodes_count, std::nullopt);
+
+        std::vector<const cgltf_node*> roots {};
+        const cgltf_scene* scene = data.scene ? data.scene : (data.scenes_count > 0 ? &data.scenes[0] : nullptr);
+        if (scene) {
+            roots.assign(scene->nodes, scene->nodes + scene->nodes_count);
+        } else {
+            for (cgltf_size nodeIdx = 0; nodeIdx < data.nodes_count; nodeIdx++) {
+                if (!data.nodes[nodeIdx].parent) {
+                    roots.push_back(&data.nodes[nodeIdx]);
+                }
+            }
+        }
+
+        // A skin with a joint outside of the scene can't be posed, its Nodes are drawn unskinned instead. The others are
+        // numbered in order.
+        std::vector<bool> inScene(data.nodes_count, false);
+        std::vector<const cgltf_node*> pending(roots);
+        while (!pending.empty()) {
+            const cgltf_node* node = pending.back();
+            pending.pop_back();
+            inScene[node - data.nodes] = true;
+            pending.insert(pending.end(), node->children, node->children + node->children_count);
+        }
+        std::vector<bool> isJoint(data.nodes_count, false);
+        std::vector<std::uint32_t> skins(data.skins_count, GLTF_NO_SKIN);
+        std::uint32_t skinCount = 0;
+        for (cgltf_size skinIdx = 0; skinIdx < data.skins_count; skinIdx++) {
+            const cgltf_skin& skin = data.skins[skinIdx];
+            if (skin.joints_count == 0
+                || !std::all_of(skin.joints, skin.joints + skin.joints_count,
+                    [&](const cgltf_node* joint) { return inScene[joint - data.nodes]; })) {
+                continue;
+            }
+            skins[skinIdx] = skinCount++;
+            for (cgltf_size jointIdx = 0; jointIdx < skin.joints_count; jointIdx++) {
+                isJoint[skin.joints[jointIdx] - data.nodes] = true;
+            }
+        }
+
+        // Each glTF node, with the GltfNode it ends up parented to and its transform relative to it, and the same for the
+        // GltfJoint.
+        struct Visit {
+            const cgltf_node* m_node;
+            std::uint32_t m_parent;
+            glm::mat4 m_parentModel;
+            std::uint32_t m_parentJoint;
+            glm::mat4 m_parentJointModel;
+        };
+        std::vector<Visit> stack {};
+        for (auto root = roots.rbegin(); root != roots.rend(); ++root) {
+            stack.push_back(Visit {.m_node = *root,
+                .m_parent = GLTF_NO_PARENT,
+                .m_parentModel = glm::mat4(1.0f),
+                .m_parentJoint = GLTF_NO_PARENT,
+                .m_parentJointModel = glm::mat4(1.0f)});
+        }
+
+        while (!stack.empty()) {
+            Visit visit = stack.back();
+            stack.pop_back();
+            const cgltf_node& node = *visit.m_node;
+
+            glm::mat4 local {1.0f};
+            cgltf_node_transform_local(&node, &local[0][0]);
+            glm::mat4 model = visit.m_parentModel * local;
+            glm::mat4 jointModel = visit.m_parentJointModel * local;
+            size_t nodeIdx = visit.m_node - data.nodes;
+
+            std::uint32_t parentJoint = visit.m_parentJoint;
+            if (isJoint[nodeIdx]) {
+                parentJoint = static_cast<std::uint32_t>(asset.m_joints.size());
+                extracted.m_joints[nodeIdx] = ExtractedNode {.m_node = parentJoint, .m_prefix = visit.m_parentJointModel};
+                GltfNode decomposed = DecomposeNode(jointModel, GLTF_NO_PARENT, 0);
+                asset.m_joints.push_back(GltfJoint {.m_parent = visit.m_parentJoint,
+                    .m_translation = decomposed.m_translation,
+                    .m_rotation = decomposed.m_rotation,
+                    .m_scale = decomposed.m_scale});
+                jointModel = glm::mat4(1.0f);
+            }
+
+            std::uint32_t parent = visit.m_parent;
+            if (node.mesh) {
+                auto mesh = static_cast<std::uint32_t>(node.mesh - data.meshes);
+                std::uint32_t skin = node.skin ? skins[node.skin - data.skins] : GLTF_NO_SKIN;
+                if (skin != GLTF_NO_SKIN && !node.has_mesh_gpu_instancing) {
+                    // Placed by its joints, its children still see through its transform.
+                    GltfNode skinned = DecomposeNode(glm::mat4(1.0f), GLTF_NO_PARENT, mesh);
+                    skinned.m_skin = skin;
+                    asset.m_nodes.push_back(skinned);
+                } else if (node.has_mesh_gpu_instancing) {
+                    // The instances are drawn instead of the Node, which its children see through.
+                    for (size_t instanceIdx = 0; instanceIdx < GetInstanceCount(node); instanceIdx++) {
+                        asset.m_nodes.push_back(DecomposeNode(model * GetInstanceModel(node, instanceIdx), parent, mesh));
+                    }
+                } else {
+                    parent = static_cast<std::uint32_t>(asset.m_nodes.size());
+                    extracted.m_nodes[nodeIdx] = ExtractedNode {.m_node = parent, .m_prefix = visit.m_parentModel};
+                    asset.m_nodes.push_back(DecomposeNode(model, visit.m_parent, mesh));
+                    model = glm::mat4(1.0f);
+                }
+            }
+
+            for (cgltf_size childIdx = node.children_count; childIdx > 0; childIdx--) {
+                stack.push_back(Visit {.m_node = node.children[childIdx - 1],
+                    .m_parent = parent,
+                    .m_parentModel = model,
+                    .m_parentJoint = parentJoint,
+                    .m_parentJointModel = jointModel});
+            }
+        }
+
+        for (cgltf_size skinIdx = 0; skinIdx < data.skins_count; skinIdx++) {
+            const cgltf_skin& skin = data.skins[skinIdx];
+            if (skins[skinIdx] == GLTF_NO_SKIN) {
+                continue;
+            }
+
+            asset.m_skins.push_back(GltfSkin {.m_firstJoint = static_cast<std::uint32_t>(asset.m_skinJoints.size()),
+                .m_jointCount = static_cast<std::uint32_t>(skin.joints_count)});
+            for (cgltf_size jointIdx = 0; jointIdx < skin.joints_count; jointIdx++) {
+                glm::mat4 inverseBind {1.0f};
+                if (skin.inverse_bind_matrices) {
+                    cgltf_accessor_read_float(skin.inverse_bind_matrices, jointIdx, &inverseBind[0][0], 16);
+                }
+                asset.m_skinJoints.push_back(GltfSkinJoint {
+                    .m_joint = extracted.m_joints[skin.joints[jointIdx] - data.nodes]->m_node, .m_inverseBind = inverseBind});
+            }
+        }
+    }
+
+    // Keeps the channels of every animation targeting an extracted Node or joint, whose prefix and rest transform are
+    // split out of its GltfNode's or GltfJoint's so the channels can replace parts of the latter. A glTF node that's both
+    // gets a channel for each, over the same keyframes.
+    void ExtractAnimations(const cgltf_data& data, GltfAnimations& animations, const ExtractedNodes& extracted)
+    {
+        // Per glTF node, the GltfAnimatedNode of its GltfNode then of its GltfJoint.
+        std::vector<std::array<std::uint32_t, 2>> animatedNodes(data.nodes_count, {UINT32_MAX, UINT32_MAX});
+        for (cgltf_size animationIdx = 0; animationIdx < data.animations_count; animationIdx++) {
+            const cgltf_animation& animation = data.animations[animationIdx];
+            GltfAnimation clip {.m_firstChannel = static_cast<std::uint32_t>(animations.m_channels.size()),
+                .m_channelCount = 0,
+                .m_duration = 0.0f};
+
+            for (cgltf_size channelIdx = 0; channelIdx < animation.channels_count; channelIdx++) {
+                const cgltf_animation_channel& channel = animation.channels[channelIdx];
+                if (!channel.target_node || !channel.sampler) {
+                    continue;
+                }
+                size_t nodeIdx = channel.target_node - data.nodes;
+                std::array targets {&extracted.m_nodes[nodeIdx], &extracted.m_joints[nodeIdx]};
+                if (!*targets[0] && !*targets[1]) {
+                    continue;
+                }
+
+                GltfAnimationPath path {};
+                size_t componentCount = 3;
+                if (channel.target_path == cgltf_animation_path_type_translation) {
+                    path = GltfAnimationPath::Translation;
+                } else if (channel.target_path == cgltf_animation_path_type_rotation) {
+                    path = GltfAnimationPath::Rotation;
+                    componentCount = 4;
+                } else if (channel.target_path == cgltf_animation_path_type_scale) {
+                    path = GltfAnimationPath::Scale;
+                } else {
+                    continue;
+                }
+
+                // Cubic splines store an in-tangent, the value and an out-tangent per keyframe.
+                const cgltf_animation_sampler& sampler = *channel.sampler;
+                bool cubic = sampler.interpolation == cgltf_interpolation_type_cubic_spline;
+                size_t valueStride = cubic ? 3 : 1;
+                size_t keyframeCount = std::min<size_t>(sampler.input->count, sampler.output->count / valueStride);
+                if (keyframeCount == 0) {
+                    continue;
+                }
+
+                auto firstKeyframe = static_cast<std::uint32_t>(animations.m_keyframeTimes.size());
+                for (size_t keyframeIdx = 0; keyframeIdx < keyframeCount; keyframeIdx++) {
+                    float time = 0.0f;
+                    cgltf_accessor_read_float(sampler.input, keyframeIdx, &time, 1);
+                    // Keeps the times ascending, even for a malformed file.
+                    if (keyframeIdx > 0) {
+                        time = std::max(time, animations.m_keyframeTimes.back());
+                    }
+                    glm::vec4 value {0.0f};
+                    size_t valueIdx = keyframeIdx * valueStride + (cubic ? 1 : 0);
+                    cgltf_accessor_read_float(sampler.output, valueIdx, &value.x, componentCount);
+                    animations.m_keyframeTimes.push_back(time);
+                    animations.m_keyframeValues.push_back(value);
+                }
+                clip.m_duration = std::max(clip.m_duration, animations.m_keyframeTimes.back());
+
+                for (std::uint32_t isJoint = 0; isJoint < 2; isJoint++) {
+                    if (!*targets[isJoint]) {
+                        continue;
+                    }
+
+                    std::uint32_t& animatedNode = animatedNodes[nodeIdx][isJoint];
+                    if (animatedNode == UINT32_MAX) {
+                        const ExtractedNode& node = **targets[isJoint];
+                        glm::mat4 local {1.0f};
+                        cgltf_node_transform_local(channel.target_node, &local[0][0]);
+                        GltfNode prefix = DecomposeNode(node.m_prefix, GLTF_NO_PARENT, 0);
+                        GltfNode rest = DecomposeNode(local, GLTF_NO_PARENT, 0);
+                        animatedNode = static_cast<std::uint32_t>(animations.m_nodes.size());
+                        animations.m_nodes.push_back(GltfAnimatedNode {.m_node = node.m_node,
+                            .m_joint = isJoint,
+                            .m_prefixTranslation = prefix.m_translation,
+                            .m_prefixRotation = prefix.m_rotation,
+                            .m_prefixScale = prefix.m_scale,
+                            .m_translation = rest.m_translation,
+                            .m_rotation = rest.m_rotation,
+                            .m_scale = rest.m_scale});
+                    }
+
+                    animations.m_channels.push_back(GltfAnimationChannel {.m_node = animatedNode,
+                        .m_path = path,
+                        .m_step = sampler.interpolation == cgltf_interpolation_type_step ? 1u : 0u,
+                        .m_firstKeyframe = firstKeyframe,
+                        .m_keyframeCount = static_cast<std::uint32_t>(keyframeCount)});
+                    clip.m_channelCount++;
+                }
+            }
+
+            if (clip.m_channelCount > 0) {
+                animations.m_clips.push_back(clip);
+            }
+        }
+    }
+
+    // Counts down the primitives left to read each buffer of a glTF file, so that its data can be freed as soon as the last
+    // of them is extracted, rather than with the whole file. Only the buffers cgltf allocated or read are, a .glb's binary
+    // chunk points into the file, and a buffer any other part of the file reads is expected to be done with already.
+    class BufferReleaser {
+    public:
+        explicit BufferReleaser(cgltf_data& data)
+            : m_data(data)
+            , m_uses(data.buffers_count, 0)
+        {
+            for (cgltf_size meshIdx = 0; meshIdx < data.meshes_count; meshIdx++) {
+                const cgltf_mesh& mesh = data.meshes[meshIdx];
+                for (cgltf_size primIdx = 0; primIdx < mesh.primitives_count; primIdx++) {
+                    ForEachBuffer(mesh.primitives[primIdx], [this](size_t bufferIdx) { m_uses[bufferIdx]++; });
+                }
+            }
+            for (size_t bufferIdx = 0; bufferIdx < m_uses.size(); bufferIdx++) {
+                if (m_uses[bufferIdx] == 0) {
+                    Release(bufferIdx);
+                }
+            }
+        }
+
+        // Called once `prim` is extracted, or skipped.
+        void Done(const cgltf_primitive& prim)
+        {
+            ForEachBuffer(prim, [this](size_t bufferIdx) {
+                if (--m_uses[bufferIdx] == 0) {
+                    Release(bufferIdx);
+                }
+            });
+        }
+
+    private:
+        // Calls `function` with the index of every buffer read by the accessors of `prim`, once per accessor view. Views of
+        // a buffer that isn't one of m_data.buffers are skipped, so that buffer is never released early.
+        template <typename Function> void ForEachBuffer(const cgltf_primitive& prim, Function function) const
+        {
+            auto visitView = [&](const cgltf_buffer_view* view) {
+                // std::less orders the pointers into other arrays too, where the built-in comparison doesn't.
+                std::less<const cgltf_buffer*> less;
+                const cgltf_buffer* buffers = m_data.buffers;
+                if (!view || !view->buffer || less(view->buffer, buffers)
+                    || !less(view->buffer, buffers + m_data.buffers_count)) {
+                    return;
+                }
+                function(static_cast<size_t>(view->buffer - buffers));
+            };
+            auto visitAccessor = [&](const cgltf_accessor* accessor) {
+                if (!accessor) {
+                    return;
+                }
+                visitView(accessor->buffer_view);
+                if (accessor->is_sparse) {
+                    visitView(accessor->sparse.indices_buffer_view);
+                    visitView(accessor->sparse.values_buffer_view);
+                }
+            };
+
+            for (cgltf_size attribIdx = 0; attribIdx < prim.attributes_count; attribIdx++) {
+                visitAccessor(prim.attributes[attribIdx].data);
+            }
+            visitAccessor(prim.indices);
+        }
+
+        void Release(size_t bufferIdx)
+        {
+            cgltf_buffer& buffer = m_data.buffers[bufferIdx];
+            if (buffer.data_free_method == cgltf_data_free_method_none || !buffer.data) {
+                return;
+            }
+
+            if (buffer.data_free_method == cgltf_data_free_method_file_release && m_data.file.release) {
+                m_data.file.release(&m_data.memory, &m_data.file, buffer.data);
+            } else if (m_data.memory.free_func) {
+                m_data.memory.free_func(m_data.memory.user_data, buffer.data);
+            } else {
+                std::free(buffer.data);
+            }
+            buffer.data = nullptr;
+            buffer.data_free_method = cgltf_data_free_method_none;
+        }
+
+        cgltf_data& m_data;
+        std::vector<size_t> m_uses;
+    };
+
+} // namespace
+
+GltfAsset ExtractGltfAsset(cgltf_data& data)
+{
+    GltfAsset asset {};
+    asset.m_meshes.reserve(data.meshes_count);
+    std::vector<float> scratch;
+
+    asset.m_materials.reserve(data.materials_count);
+    for (cgltf_size materialIdx = 0; materialIdx < data.materials_count; materialIdx++) {
+        asset.m_materials.push_back(ExtractMaterial(data.materials[materialIdx]));
+    }
+
+    // The Nodes, skins and animations read their accessors first, so that the buffers are only left to the primitives.
+    ExtractedNodes extracted {};
+    ExtractNodes(data, asset, extracted);
+    ExtractAnimations(data, asset.m_animations, extracted);
+    BufferReleaser releaser(data);
+
+    // Primitives are identified by the accessors they read, so the ones instanced by several Meshes are shared.
+    std::map<std::array<const cgltf_accessor*, 6>, std::uint32_t> primitiveIndices;
+
+    // Iterate through each meshes, then through its primitives and their attributes, filling each primitive with data
+    // pointed by the attribute buffer views. A mesh can have several primitives.
+    for (cgltf_size meshIdx = 0; meshIdx < data.meshes_count; meshIdx++) {
+        const cgltf_mesh& mesh = data.meshes[meshIdx];
+
+        GltfMesh gltfMesh {};
+        gltfMesh.m_primitives.reserve(mesh.primitives_count);
+        gltfMesh.m_aabb = EMPTY_AABB;
+        gltfMesh.m_material = GLTF_NO_MATERIAL;
+        for (cgltf_size primIdx = 0; primIdx < mesh.primitives_count; primIdx++) {
+            const cgltf_primitive& prim = mesh.primitives[primIdx];
+
+            cgltf_size vertexCount {0};
+            // Fill out the accessor pointers.
+            const cgltf_accessor* positionAccessor = nullptr;
+            const cgltf_accessor* texCoordAccessor = nullptr;
+            const cgltf_accessor* normalAccessor = nullptr;
+            const cgltf_accessor* jointsAccessor = nullptr;
+            const cgltf_accessor* weightsAccessor = nullptr;
+            for (cgltf_size attribIdx = 0; attribIdx < prim.attributes_count; attribIdx++) {
+                const cgltf_attribute& attrib = prim.attributes[attribIdx];
+
+                switch (attrib.type) {
+                case cgltf_attribute_type_position:
+                    vertexCount = attrib.data->count;
+                    if (attrib.data->component_type == cgltf_component_type_r_32f) {
+                        positionAccessor = attrib.data;
+                    }
+                    break;
+                case cgltf_attribute_type_texcoord:
+                    if (attrib.data->component_type == cgltf_component_type_r_32f) {
+                        texCoordAccessor = attrib.data;
+                    }
+                    break;
+                case cgltf_attribute_type_normal:
+                    if (attrib.data->component_type == cgltf_component_type_r_32f) {
+                        normalAccessor = attrib.data;
+                    }
+                    break;
+                case cgltf_attribute_type_joints:
+                    if (attrib.index == 0) {
+                        jointsAccessor = attrib.data;
+                    }
+                    break;
+                case cgltf_attribute_type_weights:
+                    if (attrib.index == 0) {
+                        weightsAccessor = attrib.data;
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            // Both influence attributes or neither.
+            if (!jointsAccessor || !weightsAccessor) {
+                jointsAccessor = nullptr;
+                weightsAccessor = nullptr;
+            }
+
+            auto [it, inserted] = primitiveIndices.try_emplace(std::array {positionAccessor,
+                                                                   texCoordAccessor,
+                                                                   normalAccessor,
+                                                                   jointsAccessor,
+                                                                   weightsAccessor,
+                                                                   static_cast<const cgltf_accessor*>(prim.indices)},
+                static_cast<std::uint32_t>(asset.m_primitives.size()));
+            if (inserted) {
+                // Unpack each attribute in bulk into the interleaved vertices.
+                GltfPrimitive gltfPrim {};
+                gltfPrim.m_vertexData.resize(vertexCount);
+                gltfPrim.m_aabb = EMPTY_AABB;
+                if (positionAccessor) {
+                    UnpackAttribute<VertexSemantic::Position>(*positionAccessor, std::span(gltfPrim.m_vertexData), scratch);
+                    ExpandAABB(gltfPrim.m_aabb, gltfPrim.m_vertexData);
+                }
+                if (texCoordAccessor) {
+                    UnpackAttribute<VertexSemantic::TexCoord>(*texCoordAccessor, std::span(gltfPrim.m_vertexData), scratch);
+                }
+                if (normalAccessor) {
+                    UnpackAttribute<VertexSemantic::Normal>(*normalAccessor, std::span(gltfPrim.m_vertexData), scratch);
+                }
+                if (jointsAccessor) {
+                    UnpackInfluences(*jointsAccessor, *weightsAccessor, vertexCount, gltfPrim.m_skinnedVertexData);
+                }
+
+                UnpackIndices(prim.indices, vertexCount, gltfPrim.m_vertexIndices);
+
+                asset.m_primitives.emplace_back(std::move(gltfPrim));
+            }
+
+            const AABB& primAABB = asset.m_primitives[it->second].m_aabb;
+            gltfMesh.m_aabb.m_localMin = glm::min(gltfMesh.m_aabb.m_localMin, primAABB.m_localMin);
+            gltfMesh.m_aabb.m_localMax = glm::max(gltfMesh.m_aabb.m_localMax, primAABB.m_localMax);
+            gltfMesh.m_primitives.push_back(it->second);
+            if (gltfMesh.m_material == GLTF_NO_MATERIAL && prim.material) {
+                gltfMesh.m_material = static_cast<std::uint32_t>(cgltf_material_index(&data, prim.material));
+            }
+            releaser.Done(prim);
+        } // Iterating through the primitives.
+
+        // A Mesh without any positions is a point at its origin.
+        if (gltfMesh.m_aabb.m_localMin.x > gltfMesh.m_aabb.m_localMax.x) {
+            gltfMesh.m_aabb = AABB {.m_localMin = glm::vec3(0.0f), .m_localMax = glm::vec3(0.0f)};
+        }
+
+        asset.m_meshes.emplace_back(std::move(gltfMesh));
+    } // Iterating through the meshes.
+
+    return asset;
+}
+
+std::optional<GltfAsset> ImportGltf(const char* path)
+{
+    // Parsed from the MappedFile, so that it's read from the mounted AssetPack. A .glb's binary chunk points into it, while
+    // the external buffers of a .gltf are still read from loose files next to it.
+    std::optional<Util::MappedFile> file = Util::MappedFile::Open(path);
+    if (!file) {
+        return std::nullopt;
+    }
+
+    cgltf_options options {};
+    cgltf_data* data = nullptr;
+    if (cgltf_parse(&options, file->GetData().data(), file->GetData().size(), &data) != cgltf_result_success) {
+        return std::nullopt;
+    }
+    if (cgltf_load_buffers(&options, data, path) != cgltf_result_success) {
+        cgltf_free(data);
+        return std::nullopt;
+    }
+
+    GltfAsset asset = ExtractGltfAsset(*data);
+    cgltf_free(data);
+    return asset;
+}
+
+} // namespace Glitter::Scene
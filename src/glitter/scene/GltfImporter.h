@@ -0,0 +1,279 @@
+#pragma once
+
+#include "scene/VertexFormat.h"
+
+#include <cgltf.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Glitter::Scene {
+
+// Vertex layout of every loaded Mesh, matching the Main VAO.
+struct MeshVertex {
+    float x, y, z;
+    float u, v;
+    float nx, ny, nz;
+};
+
+// Packed alternative to MeshVertex, see Scene::QuantizeAsset(). 16 bytes instead of 32.
+struct QuantizedVertex {
+    // Unorm16 position inside the asset's bounds, w is padding.
+    std::uint16_t x, y, z, w;
+    // Half-float texture coordinates.
+    std::uint16_t u, v;
+    // Octahedral-encoded normal in the x and y components of a GL_INT_2_10_10_10_REV.
+    std::uint32_t m_normal;
+};
+
+template <> struct VertexFormat<MeshVertex> {
+    static constexpr std::array ATTRIBUTES {
+        VertexAttribute {.m_semantic = VertexSemantic::Position,
+            .m_type = VertexAttributeType::Float,
+            .m_componentCount = 3,
+            .m_offset = offsetof(MeshVertex, x)},
+        VertexAttribute {.m_semantic = VertexSemantic::TexCoord,
+            .m_type = VertexAttributeType::Float,
+            .m_componentCount = 2,
+            .m_offset = offsetof(MeshVertex, u)},
+        VertexAttribute {.m_semantic = VertexSemantic::Normal,
+            .m_type = VertexAttributeType::Float,
+            .m_componentCount = 3,
+            .m_offset = offsetof(MeshVertex, nx)},
+    };
+};
+
+// Quantized positions are fetched as [0, 1] and mapped back by the Mesh's dequantization matrix, octahedral normals are
+// decoded in MainVS.glsl.
+template <> struct VertexFormat<QuantizedVertex> {
+    static constexpr std::array ATTRIBUTES {
+        VertexAttribute {.m_semantic = VertexSemantic::Position,
+            .m_type = VertexAttributeType::Unorm16,
+            .m_componentCount = 3,
+            .m_offset = offsetof(QuantizedVertex, x)},
+        VertexAttribute {.m_semantic = VertexSemantic::TexCoord,
+            .m_type = VertexAttributeType::Half,
+            .m_componentCount = 2,
+            .m_offset = offsetof(QuantizedVertex, u)},
+        VertexAttribute {.m_semantic = VertexSemantic::Normal,
+            .m_type = VertexAttributeType::PackedSnorm10,
+            .m_componentCount = 4,
+            .m_offset = offsetof(QuantizedVertex, m_normal)},
+    };
+};
+
+// The joints a vertex of a skinned primitive follows: four 16-bit indices into its skin's joints, and their unorm16
+// weights summing to one, two to a word.
+struct SkinnedVertex {
+    std::array<std::uint32_t, 2> m_joints;
+    std::array<std::uint32_t, 2> m_weights;
+};
+
+struct AABB {
+    glm::vec3 m_localMin;
+    glm::vec3 m_localMax;
+};
+
+// A simplified index list of a primitive, over the same vertices, see Scene::GenerateLods().
+struct GltfLod {
+    std::vector<std::uint32_t> m_indices;
+    // Cells along the longest axis of the primitive the vertices were clustered into.
+    std::uint32_t m_resolution;
+};
+
+// A run of consecutive triangles of a primitive, with the bounds it's culled by, see Scene::BuildMeshlets().
+struct GltfMeshlet {
+    // Range of the primitive's m_vertexIndices.
+    std::uint32_t m_firstIndex;
+    std::uint32_t m_indexCount;
+
+    // Bounding sphere, in the space of the primitive's vertices.
+    glm::vec3 m_center;
+    float m_radius;
+
+    // Every triangle normal lies within the cone around m_coneAxis whose half-angle has a sine of m_coneCutoff. A cutoff
+    // of 1 means the normals are too spread out for the cone to cull anything.
+    glm::vec3 m_coneAxis;
+    float m_coneCutoff;
+};
+
+// CPU-side geometry of a glTF primitive, ready to be uploaded.
+struct GltfPrimitive {
+    std::vector<MeshVertex> m_vertexData;
+    std::vector<std::uint32_t> m_vertexIndices;
+    AABB m_aabb;
+
+    // From finest to coarsest, not including the full-resolution m_vertexIndices.
+    std::vector<GltfLod> m_lods;
+
+    // Partition m_vertexIndices, empty if the primitive is drawn whole.
+    std::vector<GltfMeshlet> m_meshlets;
+
+    // Filled instead of m_vertexData by QuantizeAsset().
+    std::vector<QuantizedVertex> m_quantizedVertexData;
+
+    // One per vertex if the primitive is skinned, empty otherwise.
+    std::vector<SkinnedVertex> m_skinnedVertexData;
+};
+
+// Stands for the default material in GltfMesh::m_material.
+constexpr std::uint32_t GLTF_NO_MATERIAL = UINT32_MAX;
+
+// The shading parameters of a glTF material, approximated for the Blinn-Phong lighting of MainFS.glsl.
+struct GltfMaterial {
+    // Multiplies the texture.
+    glm::vec4 m_baseColor;
+    float m_specularStrength;
+    float m_specularExponent;
+};
+
+struct GltfMesh {
+    // Indices into GltfAsset::m_primitives.
+    std::vector<std::uint32_t> m_primitives;
+    AABB m_aabb;
+
+    // Index into GltfAsset::m_materials of the first material its primitives reference, or GLTF_NO_MATERIAL. The Nodes
+    // drawing the Mesh are shaded with it.
+    std::uint32_t m_material;
+};
+
+// Stands for no parent in GltfNode::m_parent and GltfJoint::m_parent.
+constexpr std::uint32_t GLTF_NO_PARENT = UINT32_MAX;
+// Stands for an unskinned Node in GltfNode::m_skin.
+constexpr std::uint32_t GLTF_NO_SKIN = UINT32_MAX;
+
+// A Node of the glTF scene drawing a Mesh, see GltfAsset::m_nodes.
+struct GltfNode {
+    // Relative to the parent.
+    glm::vec3 m_translation;
+    glm::quat m_rotation;
+    glm::vec3 m_scale;
+
+    // Index into GltfAsset::m_nodes of the parent, which comes first, or GLTF_NO_PARENT.
+    std::uint32_t m_parent;
+    // Index into GltfAsset::m_meshes.
+    std::uint32_t m_mesh;
+    // Index into GltfAsset::m_skins, or GLTF_NO_SKIN. A skinned Node is placed by its skin's joints instead, so it keeps
+    // an identity transform without a parent.
+    std::uint32_t m_skin;
+};
+
+// A glTF node the vertices of some skin follow.
+struct GltfJoint {
+    // Index into GltfAsset::m_joints of its nearest ancestor that's a joint too, which comes first, or GLTF_NO_PARENT.
+    std::uint32_t m_parent;
+
+    // Relative to the parent joint, or to the scene, with the glTF nodes in between folded in.
+    glm::vec3 m_translation;
+    glm::quat m_rotation;
+    glm::vec3 m_scale;
+};
+
+struct GltfSkinJoint {
+    // Index into GltfAsset::m_joints.
+    std::uint32_t m_joint;
+    // From the space of the skinned Mesh into the joint's, in its bind pose.
+    glm::mat4 m_inverseBind;
+};
+
+// The joints the SkinnedVertex joint indices of a skinned Mesh refer to.
+struct GltfSkin {
+    // Range of GltfAsset::m_skinJoints.
+    std::uint32_t m_firstJoint;
+    std::uint32_t m_jointCount;
+};
+
+// A Node of GltfAsset::m_nodes or a joint of GltfAsset::m_joints whose transform is animated, see GltfAnimationChannel.
+// Its GltfNode or GltfJoint transform is the prefix, the glTF nodes folded into it, composed with its own local transform
+// at rest.
+struct GltfAnimatedNode {
+    // Index into GltfAsset::m_nodes, or into GltfAsset::m_joints when m_joint is set.
+    std::uint32_t m_node;
+    std::uint32_t m_joint;
+
+    glm::vec3 m_prefixTranslation;
+    glm::quat m_prefixRotation;
+    glm::vec3 m_prefixScale;
+
+    // The rest pose of the parts of the local transform none of the channels animate.
+    glm::vec3 m_translation;
+    glm::quat m_rotation;
+    glm::vec3 m_scale;
+};
+
+enum class GltfAnimationPath : std::uint32_t {
+    Translation,
+    Rotation,
+    Scale,
+};
+
+// The keyframes of one part of the local transform of an animated Node.
+struct GltfAnimationChannel {
+    // Index into GltfAnimations::m_nodes.
+    std::uint32_t m_node;
+    GltfAnimationPath m_path;
+    // Holds each keyframe until the next one instead of interpolating them. Cubic splines are interpolated linearly.
+    std::uint32_t m_step;
+
+    // Range of GltfAnimations::m_keyframeTimes and m_keyframeValues.
+    std::uint32_t m_firstKeyframe;
+    std::uint32_t m_keyframeCount;
+};
+
+struct GltfAnimation {
+    // Range of GltfAnimations::m_channels.
+    std::uint32_t m_firstChannel;
+    std::uint32_t m_channelCount;
+    // Of its longest channel, in seconds.
+    float m_duration;
+};
+
+// The animations of a glTF file. Only the channels animating the translation, rotation or scale of a joint, or of a Node
+// drawing a Mesh without being skinned nor instanced by EXT_mesh_gpu_instancing, are kept.
+struct GltfAnimations {
+    std::vector<GltfAnimation> m_clips;
+    std::vector<GltfAnimationChannel> m_channels;
+    std::vector<GltfAnimatedNode> m_nodes;
+    // Ascending for each channel, in seconds.
+    std::vector<float> m_keyframeTimes;
+    // Translations and scales in x, y and z, rotations as x, y, z, w quaternions.
+    std::vector<glm::vec4> m_keyframeValues;
+};
+
+// Every Mesh of a glTF file. Primitives reading the same accessors are only extracted once and shared by the Meshes
+// referencing them.
+//
+// The Nodes of its default scene reference the Meshes in turn, so that a Mesh drawn by many Nodes is only stored once. The
+// glTF Nodes that don't draw a Mesh are folded into their descendants' transforms, and each instance of an
+// EXT_mesh_gpu_instancing Node becomes a Node of its own.
+struct GltfAsset {
+    std::vector<GltfPrimitive> m_primitives;
+    std::vector<GltfMesh> m_meshes;
+    std::vector<GltfMaterial> m_materials;
+    // Parents first.
+    std::vector<GltfNode> m_nodes;
+
+    // Parents first, each glTF node once however many skins it's a joint of.
+    std::vector<GltfJoint> m_joints;
+    std::vector<GltfSkinJoint> m_skinJoints;
+    std::vector<GltfSkin> m_skins;
+
+    GltfAnimations m_animations;
+
+    // Maps quantized positions back into the space of the Meshes, identity unless quantized.
+    glm::mat4 m_dequantize {1.0f};
+};
+
+// Extracts the vertices and indices of every primitive of every Mesh in `data`, whose buffers must be loaded, the Nodes
+// of its default scene, or of every root Node without one, and the animations of those Nodes. The buffers cgltf loaded
+// are freed as soon as the last primitive reading them is extracted, so that the file and the asset are never both
+// whole in memory, which leaves `data` only fit for cgltf_free().
+GltfAsset ExtractGltfAsset(cgltf_data& data);
+
+// Parses the glTF file at `path` and loads its buffers, then extracts its Meshes.
+std::optional<GltfAsset> ImportGltf(const char* path);
+
+} // namespace Glitter::Scene
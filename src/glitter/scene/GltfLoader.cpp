@@ -0,0 +1,149 @@
+#include "scene/GltfLoader.h"
+
+#include "Config.h"
+#include "core/CpuProfiler.h"
+#include "scene/MeshCache.h"
+#include "scene/MeshLod.h"
+#include "scene/MeshOptimization.h"
+#include "scene/Meshlets.h"
+#include "scene/VertexQuantization.h"
+
+#include <utility>
+
+namespace Glitter::Scene {
+
+GltfLoader::GltfLoader(Core::JobSystem* jobSystem)
+    : m_jobSystem(jobSystem)
+    , m_thread([this] { LoaderMain(); })
+{
+}
+
+GltfLoader::~GltfLoader()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_running = false;
+    }
+    m_requestCondition.notify_all();
+    m_thread.join();
+}
+
+void GltfLoader::Request(std::string path)
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_requests.push_back(std::move(path));
+    }
+    m_requestCondition.notify_one();
+}
+
+std::optional<GltfLoadResult> GltfLoader::Poll()
+{
+    std::scoped_lock lock(m_mutex);
+    if (m_results.empty()) {
+        return std::nullopt;
+    }
+
+    GltfLoadResult result = std::move(m_results.front());
+    m_results.pop_front();
+    return result;
+}
+
+void GltfLoader::Wait()
+{
+    std::unique_lock lock(m_mutex);
+    m_resultCondition.wait(lock, [this] { return m_requests.empty() && !m_importing; });
+}
+
+size_t GltfLoader::GetPendingCount() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_requests.size() + (m_importing ? 1 : 0) + m_results.size();
+}
+
+std::optional<GltfAsset> GltfLoader::Import(const std::string& path)
+{
+    std::optional<GltfAsset> asset {};
+    {
+        GLITTER_PROFILE_SCOPE("Import glTF");
+        asset = ImportGltf(path.c_str());
+    }
+
+    if (asset && Config::ENABLE_MESH_OPTIMIZATION) {
+        GLITTER_PROFILE_SCOPE("Optimize Meshes");
+        OptimizeAsset(*asset);
+    }
+    if (asset && Config::MESH_LOD_COUNT > 1) {
+        GLITTER_PROFILE_SCOPE("Generate LODs");
+        GenerateLods(*asset);
+    }
+    return asset;
+}
+
+std::optional<GltfAsset> GltfLoader::Load(const std::string& path) const
+{
+    if (!Config::ENABLE_MESH_CACHE) {
+        return Import(path);
+    }
+
+    std::optional<std::uint64_t> sourceHash = HashMeshSource(path.c_str());
+    if (!sourceHash) {
+        return std::nullopt;
+    }
+
+    std::string cachePath = GetMeshCachePath(path.c_str());
+    {
+        GLITTER_PROFILE_SCOPE("Read Mesh Cache");
+        if (std::optional<GltfAsset> asset = ReadMeshCache(cachePath.c_str(), *sourceHash, m_jobSystem)) {
+            return asset;
+        }
+    }
+
+    std::optional<GltfAsset> asset = Import(path);
+    if (asset && !WriteMeshCache(cachePath.c_str(), *sourceHash, *asset, m_jobSystem)) {
+        spdlog::warn("Failed to write the Mesh cache {}.", cachePath);
+    }
+    return asset;
+}
+
+void GltfLoader::LoaderMain()
+{
+    Core::SetProfileThreadName("glTF Loader");
+
+    while (true) {
+        std::string path;
+        {
+            std::unique_lock lock(m_mutex);
+            m_requestCondition.wait(lock, [this] { return !m_running || !m_requests.empty(); });
+            if (!m_running) {
+                return;
+            }
+
+            path = std::move(m_requests.front());
+            m_requests.pop_front();
+            m_importing = true;
+        }
+
+        GltfLoadResult result {.m_path = path, .m_asset = Load(path)};
+        if (result.m_asset && Config::ENABLE_SHORT_INDICES) {
+            SplitForShortIndices(*result.m_asset);
+        }
+        if (result.m_asset && Config::ENABLE_MESHLETS) {
+            GLITTER_PROFILE_SCOPE("Build Meshlets");
+            BuildMeshlets(*result.m_asset);
+        }
+        if (result.m_asset && Config::ENABLE_QUANTIZED_VERTICES) {
+            GLITTER_PROFILE_SCOPE("Quantize Vertices");
+            QuantizeAsset(*result.m_asset);
+        }
+
+        {
+            std::scoped_lock lock(m_mutex);
+            m_results.push_back(std::move(result));
+            m_importing = false;
+        }
+        m_resultCondition.notify_all();
+    }
+}
+
+} // namespace Glitter::Scene
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "core/JobSystem.h"
+#include "scene/GltfImporter.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace Glitter::Scene {
+
+struct GltfLoadResult {
+    std::string m_path;
+    // std::nullopt if the file couldn't be parsed or its buffers loaded.
+    std::optional<GltfAsset> m_asset;
+};
+
+// Imports glTF files on a background thread, in the order they were requested, so parsing and extraction never block
+// the render thread. Only the GL upload of the resulting assets is left to the caller. Assets are read from their Mesh
+// cache when it's up to date, and the cache is (re)written otherwise with the optimized Meshes. The cache's primitives are
+// encoded and decoded on `jobSystem`, if any, which must outlive it.
+class GltfLoader {
+public:
+    explicit GltfLoader(Core::JobSystem* jobSystem = nullptr);
+    ~GltfLoader();
+
+    GltfLoader(const GltfLoader&) = delete;
+    GltfLoader& operator=(const GltfLoader&) = delete;
+
+    void Request(std::string path);
+    // Pops the oldest finished import, if any.
+    std::optional<GltfLoadResult> Poll();
+    // Blocks until every requested import has finished, they can then all be popped by Poll().
+    void Wait();
+
+    // Imports requested but not popped yet.
+    size_t GetPendingCount() const;
+
+private:
+    // Imports the glTF at `path`, then optimizes it and generates its LODs.
+    static std::optional<GltfAsset> Import(const std::string& path);
+    std::optional<GltfAsset> Load(const std::string& path) const;
+    void LoaderMain();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_requestCondition;
+    std::condition_variable m_resultCondition;
+    std::deque<std::string> m_requests;
+    std::deque<GltfLoadResult> m_results;
+    // Whether the loader thread is running an import it already popped from m_requests.
+    bool m_importing {};
+    bool m_running {true};
+
+    Core::JobSystem* m_jobSystem;
+
+    std::thread m_thread;
+};
+
+} // namespace Glitter::Scene
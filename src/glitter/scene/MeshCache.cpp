@@ -0,0 +1,567 @@
+#include "scene/MeshCache.h"
+
+#include "Config.h"
+#include "util/File.h"
+#include "util/GeometryCodec.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace Glitter::Scene {
+
+namespace {
+
+    // Bump whenever the layout below, MeshVertex, SkinnedVertex, AABB, GltfNode, GltfMaterial, the skin or animation records,
+    // Util::GeometryCodec or the optimizations applied before caching change.
+    constexpr std::uint32_t MESH_CACHE_VERSION = 8;
+    constexpr std::array<char, 4> MESH_CACHE_MAGIC {'G', 'L', 'M', 'C'};
+    constexpr size_t SECTION_ALIGNMENT = 16;
+    // LZ4 can't expand its input by more than this, which bounds what an encoded stream may decode to.
+    constexpr std::uint64_t MAX_DECODED_RATIO = 256;
+
+    struct CacheHeader {
+        std::array<char, 4> m_magic;
+        std::uint32_t m_version;
+        std::uint64_t m_sourceHash;
+        std::uint32_t m_primitiveCount;
+        std::uint32_t m_meshCount;
+        // Total primitive references of every Mesh.
+        std::uint32_t m_meshPrimitiveCount;
+        std::uint32_t m_lodCount;
+        std::uint32_t m_nodeCount;
+        std::uint32_t m_materialCount;
+        std::uint32_t m_animationCount;
+        std::uint32_t m_animationChannelCount;
+        std::uint32_t m_animatedNodeCount;
+        std::uint32_t m_keyframeCount;
+        std::uint32_t m_jointCount;
+        std::uint32_t m_skinJointCount;
+        std::uint32_t m_skinCount;
+        // Whether the vertices and indices of the primitives and LODs are encoded by Util::GeometryCodec, rather than
+        // stored as-is.
+        std::uint32_t m_encoded;
+    };
+
+    // Offsets are in bytes from the start of the file, sizes are those stored, encoded or not.
+    struct CachePrimitive {
+        std::uint64_t m_vertexOffset;
+        std::uint64_t m_vertexSize;
+        std::uint64_t m_vertexCount;
+        std::uint64_t m_indexOffset;
+        std::uint64_t m_indexSize;
+        std::uint64_t m_indexCount;
+        // Either none or one per vertex.
+        std::uint64_t m_skinnedVertexOffset;
+        std::uint64_t m_skinnedVertexSize;
+        std::uint64_t m_skinnedVertexCount;
+        AABB m_aabb;
+        std::uint32_t m_firstLod;
+        std::uint32_t m_lodCount;
+    };
+
+    struct CacheLod {
+        std::uint64_t m_indexOffset;
+        std::uint64_t m_indexSize;
+        std::uint64_t m_indexCount;
+        std::uint32_t m_resolution;
+        std::uint32_t m_padding;
+    };
+
+    struct CacheMesh {
+        std::uint32_t m_firstPrimitive;
+        std::uint32_t m_primitiveCount;
+        AABB m_aabb;
+        std::uint32_t m_material;
+    };
+
+    size_t AlignSection(size_t offset) { return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1); }
+
+    // Copies `count` elements at `offset` of `file` into `out`, failing if they're out of bounds.
+    template <typename T> bool ReadSection(std::span<const std::byte> file, std::uint64_t offset, std::uint64_t count, T* out)
+    {
+        if (offset > file.size() || count > (file.size() - offset) / sizeof(T)) {
+            return false;
+        }
+
+        if (count > 0) {
+            std::memcpy(out, file.data() + offset, sizeof(T) * count);
+        }
+        return true;
+    }
+
+    // Whether `count` elements could possibly be stored in `size` bytes, checked before allocating for them.
+    template <typename T> bool IsPlausibleCount(std::uint64_t count, std::uint64_t size, bool encoded)
+    {
+        if (!encoded || count == 0) {
+            return size == sizeof(T) * count;
+        }
+        // An encoded index takes at least a byte before LZ4.
+        return count <= size * MAX_DECODED_RATIO / (std::is_same_v<T, std::uint32_t> ? 1 : sizeof(T));
+    }
+
+    // Reads the `size` bytes of stream at `offset` of `file` into `out`, decoding them if `encoded`. Fails if they're
+    // out of bounds or don't fill `out` exactly.
+    template <typename T>
+    bool ReadStream(std::span<const std::byte> file, std::uint64_t offset, std::uint64_t size, bool encoded, std::span<T> out)
+    {
+        if (offset > file.size() || size > file.size() - offset) {
+            return false;
+        }
+
+        // Empty streams are stored as-is either way.
+        std::span<const std::byte> stream = file.subspan(offset, size);
+        if (!encoded || out.empty()) {
+            if (size != out.size_bytes()) {
+                return false;
+            }
+            if (size > 0) {
+                std::memcpy(out.data(), stream.data(), size);
+            }
+            return true;
+        }
+
+        if constexpr (std::is_same_v<T, std::uint32_t>) {
+            return Util::DecodeIndexBuffer(stream, out);
+        } else {
+            return Util::DecodeVertexBuffer(stream, std::as_writable_bytes(out), sizeof(T));
+        }
+    }
+
+    // The bytes each stream of a primitive is written as, pointing either into the primitive or into the streams it was
+    // encoded into.
+    struct StoredPrimitive {
+        std::span<const std::byte> m_vertices;
+        std::span<const std::byte> m_indices;
+        std::span<const std::byte> m_skinnedVertices;
+        std::vector<std::span<const std::byte>> m_lods;
+        std::vector<std::vector<std::byte>> m_encoded;
+    };
+
+    StoredPrimitive StorePrimitive(const GltfPrimitive& primitive, bool encode)
+    {
+        StoredPrimitive stored {};
+        auto store = [&](auto data, auto encoder) -> std::span<const std::byte> {
+            if (!encode || data.empty()) {
+                return std::as_bytes(data);
+            }
+            return stored.m_encoded.emplace_back(encoder(data));
+        };
+        auto encodeVertices = [](auto vertices) {
+            return Util::EncodeVertexBuffer(std::as_bytes(vertices), sizeof(typename decltype(vertices)::value_type));
+        };
+        auto encodeIndices = [](std::span<const std::uint32_t> indices) { return Util::EncodeIndexBuffer(indices); };
+
+        stored.m_vertices = store(std::span(primitive.m_vertexData), encodeVertices);
+        stored.m_indices = store(std::span(primitive.m_vertexIndices), encodeIndices);
+        stored.m_skinnedVertices = store(std::span(primitive.m_skinnedVertexData), encodeVertices);
+        for (const GltfLod& lod : primitive.m_lods) {
+            stored.m_lods.push_back(store(std::span(lod.m_indices), encodeIndices));
+        }
+        return stored;
+    }
+
+} // namespace
+
+std::string GetMeshCachePath(const char* sourcePath) { return std::string(sourcePath) + ".meshcache"; }
+
+std::optional<std::uint64_t> HashMeshSource(const char* sourcePath)
+{
+    std::optional<Util::MappedFile> source = Util::MappedFile::Open(sourcePath);
+    if (!source) {
+        return std::nullopt;
+    }
+
+    // 64-bit FNV-1a.
+    std::uint64_t hash = 0xCBF2'9CE4'8422'2325;
+    for (std::byte value : source->GetData()) {
+        hash = (hash ^ static_cast<std::uint64_t>(value)) * 0x0000'0100'0000'01B3;
+    }
+    return hash;
+}
+
+std::optional<GltfAsset> ReadMeshCache(const char* cachePath, std::uint64_t sourceHash, Core::JobSystem* jobSystem)
+{
+    std::optional<Util::MappedFile> mappedFile = Util::MappedFile::Open(cachePath);
+    if (!mappedFile) {
+        return std::nullopt;
+    }
+    std::span<const std::byte> file = mappedFile->GetData();
+
+    CacheHeader header {};
+    if (!ReadSection(file, 0, 1, &header) || header.m_magic != MESH_CACHE_MAGIC || header.m_version != MESH_CACHE_VERSION
+        || header.m_sourceHash != sourceHash) {
+        return std::nullopt;
+    }
+    bool encoded = header.m_encoded != 0;
+
+    std::vector<CachePrimitive> primitives(header.m_primitiveCount);
+    std::vector<CacheMesh> meshes(header.m_meshCount);
+    std::vector<std::uint32_t> meshPrimitives(header.m_meshPrimitiveCount);
+    std::vector<CacheLod> lods(header.m_lodCount);
+    std::vector<GltfNode> nodes(header.m_nodeCount);
+    std::vector<GltfMaterial> materials(header.m_materialCount);
+    std::vector<GltfAnimation> clips(header.m_animationCount);
+    std::vector<GltfAnimationChannel> animationChannels(header.m_animationChannelCount);
+    std::vector<GltfAnimatedNode> animatedNodes(header.m_animatedNodeCount);
+    std::vector<float> keyframeTimes(header.m_keyframeCount);
+    std::vector<glm::vec4> keyframeValues(header.m_keyframeCount);
+    std::vector<GltfJoint> joints(header.m_jointCount);
+    std::vector<GltfSkinJoint> skinJoints(header.m_skinJointCount);
+    std::vector<GltfSkin> skins(header.m_skinCount);
+    size_t offset = AlignSection(sizeof(CacheHeader));
+    if (!ReadSection(file, offset, primitives.size(), primitives.data())) {
+        return std::nullopt;
+    }
+    offset = AlignSection(offset + sizeof(CachePrimitive) * primitives.size());
+    if (!ReadSection(file, offset, meshes.size(), meshes.data())) {
+        return std::nullopt;
+    }
+    offset = AlignSection(offset + sizeof(CacheMesh) * meshes.size());
+    if (!ReadSection(file, offset, meshPrimitives.size(), meshPrimitives.data())) {
+        return std::nullopt;
+    }
+    offset = AlignSection(offset + sizeof(std::uint32_t) * meshPrimitives.size());
+    if (!ReadSection(file, offset, lods.size(), lods.data())) {
+        return std::nullopt;
+    }
+    offset = AlignSection(offset + sizeof(CacheLod) * lods.size());
+    if (!ReadSection(file, offset, nodes.size(), nodes.data())) {
+        return std::nullopt;
+    }
+    offset = AlignSection(offset + sizeof(GltfNode) * nodes.size());
+    if (!ReadSection(file, offset, materials.size(), materials.data())) {
+        return std::nullopt;
+    }
+    offset = AlignSection(offset + sizeof(GltfMaterial) * materials.size());
+    if (!ReadSection(file, offset, clips.size(), clips.data())) {
+        return std::nullopt;
+    }
+    offset = AlignSection(offset + sizeof(GltfAnimation) * clips.size());
+    if (!ReadSection(file, offset, animationChannels.size(), animationChannels.data())) {
+        return std::nullopt;
+    }
+    offset = AlignSection(offset + sizeof(GltfAnimationChannel) * animationChannels.size());
+    if (!ReadSection(file, offset, animatedNodes.size(), animatedNodes.data())) {
+        return std::nullopt;
+    }
+    offset = AlignSection(offset + sizeof(GltfAnimatedNode) * animatedNodes.size());
+    if (!ReadSection(file, offset, keyframeTimes.size(), keyframeTimes.data())) {
+        return std::nullopt;
+    }
+    offset = AlignSection(offset + sizeof(float) * keyframeTimes.size());
+    if (!ReadSection(file, offset, keyframeValues.size(), keyframeValues.data())) {
+        return std::nullopt;
+    }
+    offset = AlignSection(offset + sizeof(glm::vec4) * keyframeValues.size());
+    if (!ReadSection(file, offset, joints.size(), joints.data())) {
+        return std::nullopt;
+    }
+    offset = AlignSection(offset + sizeof(GltfJoint) * joints.size());
+    if (!ReadSection(file, offset, skinJoints.size(), skinJoints.data())) {
+        return std::nullopt;
+    }
+    offset = AlignSection(offset + sizeof(GltfSkinJoint) * skinJoints.size());
+    if (!ReadSection(file, offset, skins.size(), skins.data())) {
+        return std::nullopt;
+    }
+
+    GltfAsset asset {};
+    asset.m_primitives.resize(primitives.size());
+    for (size_t primitiveIdx = 0; primitiveIdx < primitives.size(); primitiveIdx++) {
+        const CachePrimitive& cached = primitives[primitiveIdx];
+        GltfPrimitive& primitive = asset.m_primitives[primitiveIdx];
+        primitive.m_aabb = cached.m_aabb;
+
+        // Fail on counts that couldn't possibly fit before allocating for them.
+        if (cached.m_vertexSize > file.size() || cached.m_indexSize > file.size() || cached.m_skinnedVertexSize > file.size()
+            || !IsPlausibleCount<MeshVertex>(cached.m_vertexCount, cached.m_vertexSize, encoded)
+            || !IsPlausibleCount<std::uint32_t>(cached.m_indexCount, cached.m_indexSize, encoded)
+            || !IsPlausibleCount<SkinnedVertex>(cached.m_skinnedVertexCount, cached.m_skinnedVertexSize, encoded)
+            || (cached.m_skinnedVertexCount != 0 && cached.m_skinnedVertexCount != cached.m_vertexCount)) {
+            return std::nullopt;
+        }
+        primitive.m_vertexData.resize(cached.m_vertexCount);
+        primitive.m_vertexIndices.resize(cached.m_indexCount);
+        primitive.m_skinnedVertexData.resize(cached.m_skinnedVertexCount);
+
+        if (cached.m_firstLod > lods.size() || cached.m_lodCount > lods.size() - cached.m_firstLod) {
+            return std::nullopt;
+        }
+        primitive.m_lods.resize(cached.m_lodCount);
+        for (size_t lodIdx = 0; lodIdx < cached.m_lodCount; lodIdx++) {
+            const CacheLod& cachedLod = lods[cached.m_firstLod + lodIdx];
+            GltfLod& lod = primitive.m_lods[lodIdx];
+            if (cachedLod.m_indexSize > file.size()
+                || !IsPlausibleCount<std::uint32_t>(cachedLod.m_indexCount, cachedLod.m_indexSize, encoded)) {
+                return std::nullopt;
+            }
+            lod.m_resolution = cachedLod.m_resolution;
+            lod.m_indices.resize(cachedLod.m_indexCount);
+        }
+    }
+
+    // The streams are read, and decoded, straight into the primitives they're uploaded from, a primitive per job.
+    std::atomic<bool> streamsRead {true};
+    auto readStreams = [&](size_t begin, size_t end) {
+        for (size_t primitiveIdx = begin; primitiveIdx < end && streamsRead.load(std::memory_order_relaxed); primitiveIdx++) {
+            const CachePrimitive& cached = primitives[primitiveIdx];
+            GltfPrimitive& primitive = asset.m_primitives[primitiveIdx];
+            bool read = ReadStream(file, cached.m_vertexOffset, cached.m_vertexSize, encoded, std::span(primitive.m_vertexData))
+                && ReadStream(file, cached.m_indexOffset, cached.m_indexSize, encoded, std::span(primitive.m_vertexIndices))
+                && ReadStream(file, cached.m_skinnedVertexOffset, cached.m_skinnedVertexSize, encoded,
+                    std::span(primitive.m_skinnedVertexData));
+            for (size_t lodIdx = 0; read && lodIdx < primitive.m_lods.size(); lodIdx++) {
+                const CacheLod& cachedLod = lods[cached.m_firstLod + lodIdx];
+                read = ReadStream(
+                    file, cachedLod.m_indexOffset, cachedLod.m_indexSize, encoded, std::span(primitive.m_lods[lodIdx].m_indices));
+            }
+            if (!read) {
+                streamsRead.store(false, std::memory_order_relaxed);
+            }
+        }
+    };
+    if (jobSystem) {
+        jobSystem->ParallelFor(primitives.size(), 1, readStreams);
+    } else {
+        readStreams(0, primitives.size());
+    }
+    if (!streamsRead.load(std::memory_order_relaxed)) {
+        return std::nullopt;
+    }
+
+    asset.m_meshes.resize(meshes.size());
+    for (size_t meshIdx = 0; meshIdx < meshes.size(); meshIdx++) {
+        const CacheMesh& cached = meshes[meshIdx];
+        if (cached.m_firstPrimitive > meshPrimitives.size()
+            || cached.m_primitiveCount > meshPrimitives.size() - cached.m_firstPrimitive) {
+            return std::nullopt;
+        }
+
+        if (cached.m_material != GLTF_NO_MATERIAL && cached.m_material >= materials.size()) {
+            return std::nullopt;
+        }
+
+        GltfMesh& mesh = asset.m_meshes[meshIdx];
+        mesh.m_aabb = cached.m_aabb;
+        mesh.m_material = cached.m_material;
+        mesh.m_primitives.assign(meshPrimitives.begin() + cached.m_firstPrimitive,
+            meshPrimitives.begin() + cached.m_firstPrimitive + cached.m_primitiveCount);
+        for (std::uint32_t primitiveIdx : mesh.m_primitives) {
+            if (primitiveIdx >= asset.m_primitives.size()) {
+                return std::nullopt;
+            }
+        }
+    }
+
+    // Parents come first.
+    for (size_t nodeIdx = 0; nodeIdx < nodes.size(); nodeIdx++) {
+        const GltfNode& node = nodes[nodeIdx];
+        if (node.m_mesh >= meshes.size() || (node.m_parent != GLTF_NO_PARENT && node.m_parent >= nodeIdx)
+            || (node.m_skin != GLTF_NO_SKIN && node.m_skin >= skins.size())) {
+            return std::nullopt;
+        }
+    }
+    asset.m_nodes = std::move(nodes);
+
+    for (size_t jointIdx = 0; jointIdx < joints.size(); jointIdx++) {
+        if (joints[jointIdx].m_parent != GLTF_NO_PARENT && joints[jointIdx].m_parent >= jointIdx) {
+            return std::nullopt;
+        }
+    }
+    for (const GltfSkinJoint& skinJoint : skinJoints) {
+        if (skinJoint.m_joint >= joints.size()) {
+            return std::nullopt;
+        }
+    }
+    for (const GltfSkin& skin : skins) {
+        if (skin.m_firstJoint > skinJoints.size() || skin.m_jointCount > skinJoints.size() - skin.m_firstJoint) {
+            return std::nullopt;
+        }
+    }
+    asset.m_joints = std::move(joints);
+    asset.m_skinJoints = std::move(skinJoints);
+    asset.m_skins = std::move(skins);
+    asset.m_materials = std::move(materials);
+
+    for (const GltfAnimation& clip : clips) {
+        if (clip.m_firstChannel > animationChannels.size()
+            || clip.m_channelCount > animationChannels.size() - clip.m_firstChannel) {
+            return std::nullopt;
+        }
+    }
+    for (const GltfAnimationChannel& channel : animationChannels) {
+        if (channel.m_node >= animatedNodes.size() || channel.m_path > GltfAnimationPath::Scale || channel.m_keyframeCount == 0
+            || channel.m_firstKeyframe > keyframeTimes.size()
+            || channel.m_keyframeCount > keyframeTimes.size() - channel.m_firstKeyframe) {
+            return std::nullopt;
+        }
+    }
+    for (const GltfAnimatedNode& node : animatedNodes) {
+        if (node.m_joint > 1 || node.m_node >= (node.m_joint ? asset.m_joints.size() : asset.m_nodes.size())) {
+            return std::nullopt;
+        }
+    }
+    asset.m_animations.m_clips = std::move(clips);
+    asset.m_animations.m_channels = std::move(animationChannels);
+    asset.m_animations.m_nodes = std::move(animatedNodes);
+    asset.m_animations.m_keyframeTimes = std::move(keyframeTimes);
+    asset.m_animations.m_keyframeValues = std::move(keyframeValues);
+
+    return asset;
+}
+
+bool WriteMeshCache(const char* cachePath, std::uint64_t sourceHash, const GltfAsset& asset, Core::JobSystem* jobSystem)
+{
+    std::vector<StoredPrimitive> stored(asset.m_primitives.size());
+    auto storePrimitives = [&](size_t begin, size_t end) {
+        for (size_t primitiveIdx = begin; primitiveIdx < end; primitiveIdx++) {
+            stored[primitiveIdx] = StorePrimitive(asset.m_primitives[primitiveIdx], Config::ENABLE_MESH_CACHE_COMPRESSION);
+        }
+    };
+    if (jobSystem) {
+        jobSystem->ParallelFor(stored.size(), 1, storePrimitives);
+    } else {
+        storePrimitives(0, stored.size());
+    }
+
+    std::vector<CachePrimitive> primitives;
+    std::vector<CacheLod> lods;
+    std::vector<CacheMesh> meshes;
+    std::vector<std::uint32_t> meshPrimitives;
+    for (const GltfMesh& mesh : asset.m_meshes) {
+        meshes.push_back(CacheMesh {.m_firstPrimitive = static_cast<std::uint32_t>(meshPrimitives.size()),
+            .m_primitiveCount = static_cast<std::uint32_t>(mesh.m_primitives.size()),
+            .m_aabb = mesh.m_aabb,
+            .m_material = mesh.m_material});
+        meshPrimitives.insert(meshPrimitives.end(), mesh.m_primitives.begin(), mesh.m_primitives.end());
+    }
+
+    // Lay the sections out first, so the primitive records know where their data lands.
+    size_t offset = AlignSection(sizeof(CacheHeader));
+    size_t primitivesOffset = offset;
+    offset = AlignSection(offset + sizeof(CachePrimitive) * asset.m_primitives.size());
+    size_t meshesOffset = offset;
+    offset = AlignSection(offset + sizeof(CacheMesh) * meshes.size());
+    size_t meshPrimitivesOffset = offset;
+    offset = AlignSection(offset + sizeof(std::uint32_t) * meshPrimitives.size());
+    size_t totalLodCount = 0;
+    for (const GltfPrimitive& primitive : asset.m_primitives) {
+        totalLodCount += primitive.m_lods.size();
+    }
+    size_t lodsOffset = offset;
+    offset = AlignSection(offset + sizeof(CacheLod) * totalLodCount);
+    size_t nodesOffset = offset;
+    offset = AlignSection(offset + sizeof(GltfNode) * asset.m_nodes.size());
+    size_t materialsOffset = offset;
+    offset = AlignSection(offset + sizeof(GltfMaterial) * asset.m_materials.size());
+    size_t animationsOffset = offset;
+    offset = AlignSection(offset + sizeof(GltfAnimation) * asset.m_animations.m_clips.size());
+    size_t animationChannelsOffset = offset;
+    offset = AlignSection(offset + sizeof(GltfAnimationChannel) * asset.m_animations.m_channels.size());
+    size_t animatedNodesOffset = offset;
+    offset = AlignSection(offset + sizeof(GltfAnimatedNode) * asset.m_animations.m_nodes.size());
+    size_t keyframeTimesOffset = offset;
+    offset = AlignSection(offset + sizeof(float) * asset.m_animations.m_keyframeTimes.size());
+    size_t keyframeValuesOffset = offset;
+    offset = AlignSection(offset + sizeof(glm::vec4) * asset.m_animations.m_keyframeValues.size());
+    size_t jointsOffset = offset;
+    offset = AlignSection(offset + sizeof(GltfJoint) * asset.m_joints.size());
+    size_t skinJointsOffset = offset;
+    offset = AlignSection(offset + sizeof(GltfSkinJoint) * asset.m_skinJoints.size());
+    size_t skinsOffset = offset;
+    offset = AlignSection(offset + sizeof(GltfSkin) * asset.m_skins.size());
+    for (size_t primitiveIdx = 0; primitiveIdx < asset.m_primitives.size(); primitiveIdx++) {
+        const GltfPrimitive& primitive = asset.m_primitives[primitiveIdx];
+        const StoredPrimitive& streams = stored[primitiveIdx];
+        primitives.push_back(CachePrimitive {.m_vertexOffset = offset,
+            .m_vertexSize = streams.m_vertices.size(),
+            .m_vertexCount = primitive.m_vertexData.size(),
+            .m_indexOffset = 0,
+            .m_indexSize = streams.m_indices.size(),
+            .m_indexCount = primitive.m_vertexIndices.size(),
+            .m_skinnedVertexOffset = 0,
+            .m_skinnedVertexSize = streams.m_skinnedVertices.size(),
+            .m_skinnedVertexCount = primitive.m_skinnedVertexData.size(),
+            .m_aabb = primitive.m_aabb,
+            .m_firstLod = static_cast<std::uint32_t>(lods.size()),
+            .m_lodCount = static_cast<std::uint32_t>(primitive.m_lods.size())});
+        offset = AlignSection(offset + streams.m_vertices.size());
+        primitives.back().m_indexOffset = offset;
+        offset = AlignSection(offset + streams.m_indices.size());
+        primitives.back().m_skinnedVertexOffset = offset;
+        offset = AlignSection(offset + streams.m_skinnedVertices.size());
+        for (size_t lodIdx = 0; lodIdx < primitive.m_lods.size(); lodIdx++) {
+            lods.push_back(CacheLod {.m_indexOffset = offset,
+                .m_indexSize = streams.m_lods[lodIdx].size(),
+                .m_indexCount = primitive.m_lods[lodIdx].m_indices.size(),
+                .m_resolution = primitive.m_lods[lodIdx].m_resolution,
+                .m_padding = 0});
+            offset = AlignSection(offset + streams.m_lods[lodIdx].size());
+        }
+    }
+
+    CacheHeader header {.m_magic = MESH_CACHE_MAGIC,
+        .m_version = MESH_CACHE_VERSION,
+        .m_sourceHash = sourceHash,
+        .m_primitiveCount = static_cast<std::uint32_t>(primitives.size()),
+        .m_meshCount = static_cast<std::uint32_t>(meshes.size()),
+        .m_meshPrimitiveCount = static_cast<std::uint32_t>(meshPrimitives.size()),
+        .m_lodCount = static_cast<std::uint32_t>(lods.size()),
+        .m_nodeCount = static_cast<std::uint32_t>(asset.m_nodes.size()),
+        .m_materialCount = static_cast<std::uint32_t>(asset.m_materials.size()),
+        .m_animationCount = static_cast<std::uint32_t>(asset.m_animations.m_clips.size()),
+        .m_animationChannelCount = static_cast<std::uint32_t>(asset.m_animations.m_channels.size()),
+        .m_animatedNodeCount = static_cast<std::uint32_t>(asset.m_animations.m_nodes.size()),
+        .m_keyframeCount = static_cast<std::uint32_t>(asset.m_animations.m_keyframeTimes.size()),
+        .m_jointCount = static_cast<std::uint32_t>(asset.m_joints.size()),
+        .m_skinJointCount = static_cast<std::uint32_t>(asset.m_skinJoints.size()),
+        .m_skinCount = static_cast<std::uint32_t>(asset.m_skins.size()),
+        .m_encoded = Config::ENABLE_MESH_CACHE_COMPRESSION ? 1u : 0u};
+
+    std::vector<std::byte> file(offset);
+    auto writeSection = [&](size_t sectionOffset, const void* data, size_t size) {
+        if (size > 0) {
+            std::memcpy(file.data() + sectionOffset, data, size);
+        }
+    };
+    writeSection(0, &header, sizeof(header));
+    writeSection(primitivesOffset, primitives.data(), sizeof(CachePrimitive) * primitives.size());
+    writeSection(meshesOffset, meshes.data(), sizeof(CacheMesh) * meshes.size());
+    writeSection(meshPrimitivesOffset, meshPrimitives.data(), sizeof(std::uint32_t) * meshPrimitives.size());
+    writeSection(lodsOffset, lods.data(), sizeof(CacheLod) * lods.size());
+    writeSection(nodesOffset, asset.m_nodes.data(), sizeof(GltfNode) * asset.m_nodes.size());
+    writeSection(materialsOffset, asset.m_materials.data(), sizeof(GltfMaterial) * asset.m_materials.size());
+    const GltfAnimations& animations = asset.m_animations;
+    writeSection(animationsOffset, animations.m_clips.data(), sizeof(GltfAnimation) * animations.m_clips.size());
+    writeSection(
+        animationChannelsOffset, animations.m_channels.data(), sizeof(GltfAnimationChannel) * animations.m_channels.size());
+    writeSection(animatedNodesOffset, animations.m_nodes.data(), sizeof(GltfAnimatedNode) * animations.m_nodes.size());
+    writeSection(keyframeTimesOffset, animations.m_keyframeTimes.data(), sizeof(float) * animations.m_keyframeTimes.size());
+    writeSection(keyframeValuesOffset, animations.m_keyframeValues.data(), sizeof(glm::vec4) * animations.m_keyframeValues.size());
+    writeSection(jointsOffset, asset.m_joints.data(), sizeof(GltfJoint) * asset.m_joints.size());
+    writeSection(skinJointsOffset, asset.m_skinJoints.data(), sizeof(GltfSkinJoint) * asset.m_skinJoints.size());
+    writeSection(skinsOffset, asset.m_skins.data(), sizeof(GltfSkin) * asset.m_skins.size());
+    for (size_t primitiveIdx = 0; primitiveIdx < primitives.size(); primitiveIdx++) {
+        const StoredPrimitive& streams = stored[primitiveIdx];
+        writeSection(primitives[primitiveIdx].m_vertexOffset, streams.m_vertices.data(), streams.m_vertices.size());
+        writeSection(primitives[primitiveIdx].m_indexOffset, streams.m_indices.data(), streams.m_indices.size());
+        writeSection(
+            primitives[primitiveIdx].m_skinnedVertexOffset, streams.m_skinnedVertices.data(), streams.m_skinnedVertices.size());
+        for (size_t lodIdx = 0; lodIdx < streams.m_lods.size(); lodIdx++) {
+            const CacheLod& lod = lods[primitives[primitiveIdx].m_firstLod + lodIdx];
+            writeSection(lod.m_indexOffset, streams.m_lods[lodIdx].data(), streams.m_lods[lodIdx].size());
+        }
+    }
+
+    std::ofstream outputStream(cachePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    outputStream.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    return static_cast<bool>(outputStream);
+}
+
+} // namespace Glitter::Scene
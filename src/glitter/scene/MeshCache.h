@@ -0,0 +1,25 @@
+#pragma once
+
+#include "core/JobSystem.h"
+#include "scene/GltfImporter.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace Glitter::Scene {
+
+// The cache of an asset is a single file next to it, holding the final interleaved vertices, indices, LODs and AABBs of
+// its GltfAsset, its Nodes, skins and their animations. Every section is 16-byte aligned from the start of the file, so
+// it can be read or mapped as-is. With Config::ENABLE_MESH_CACHE_COMPRESSION, the vertices and indices are encoded by
+// Util::GeometryCodec instead, a primitive per job of the JobSystem both ways.
+std::string GetMeshCachePath(const char* sourcePath);
+
+// Hashes the content of the source asset, a cache built from any other content is stale.
+std::optional<std::uint64_t> HashMeshSource(const char* sourcePath);
+
+// Returns std::nullopt if the cache is missing, from another format version or built from another source.
+std::optional<GltfAsset> ReadMeshCache(const char* cachePath, std::uint64_t sourceHash, Core::JobSystem* jobSystem = nullptr);
+bool WriteMeshCache(const char* cachePath, std::uint64_t sourceHash, const GltfAsset& asset, Core::JobSystem* jobSystem = nullptr);
+
+} // namespace Glitter::Scene
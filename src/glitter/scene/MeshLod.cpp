@@ -0,0 +1,129 @@
+#include "scene/MeshLod.h"
+
+#include "Config.h"
+#include "scene/MeshOptimization.h"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <unordered_map>
+
+namespace Glitter::Scene {
+
+namespace {
+
+    struct Cluster {
+        glm::vec3 m_positionSum;
+        std::uint32_t m_vertexCount;
+        std::uint32_t m_representative;
+        float m_representativeDistance;
+    };
+
+    // Collapses every vertex of `primitive` onto its cluster's representative, returning the triangles left.
+    std::vector<std::uint32_t> ClusterTriangles(const GltfPrimitive& primitive, std::uint32_t resolution)
+    {
+        const AABB& aabb = primitive.m_aabb;
+        glm::vec3 extent = aabb.m_localMax - aabb.m_localMin;
+        float cellSize = std::max({extent.x, extent.y, extent.z}) / static_cast<float>(resolution);
+        if (!(cellSize > 0.0f)) {
+            return primitive.m_vertexIndices;
+        }
+
+        auto cellOf = [&](const MeshVertex& vertex) {
+            glm::vec3 position = (glm::vec3 {vertex.x, vertex.y, vertex.z} - aabb.m_localMin) / cellSize;
+            glm::uvec3 cell = glm::uvec3(glm::clamp(position, 0.0f, static_cast<float>(resolution)));
+            return (static_cast<std::uint64_t>(cell.x) << 42) | (static_cast<std::uint64_t>(cell.y) << 21) | cell.z;
+        };
+
+        std::unordered_map<std::uint64_t, std::uint32_t> clusterIndices;
+        std::vector<Cluster> clusters;
+        std::vector<std::uint32_t> vertexClusters(primitive.m_vertexData.size());
+        for (size_t vertexIdx = 0; vertexIdx < primitive.m_vertexData.size(); vertexIdx++) {
+            const MeshVertex& vertex = primitive.m_vertexData[vertexIdx];
+            auto [it, inserted] = clusterIndices.try_emplace(cellOf(vertex), static_cast<std::uint32_t>(clusters.size()));
+            if (inserted) {
+                clusters.push_back(Cluster {.m_positionSum = glm::vec3(0.0f),
+                    .m_vertexCount = 0,
+                    .m_representative = static_cast<std::uint32_t>(vertexIdx),
+                    .m_representativeDistance = FLT_MAX});
+            }
+
+            Cluster& cluster = clusters[it->second];
+            cluster.m_positionSum += glm::vec3 {vertex.x, vertex.y, vertex.z};
+            cluster.m_vertexCount++;
+            vertexClusters[vertexIdx] = it->second;
+        }
+
+        for (size_t vertexIdx = 0; vertexIdx < primitive.m_vertexData.size(); vertexIdx++) {
+            const MeshVertex& vertex = primitive.m_vertexData[vertexIdx];
+            Cluster& cluster = clusters[vertexClusters[vertexIdx]];
+            glm::vec3 mean = cluster.m_positionSum / static_cast<float>(cluster.m_vertexCount);
+            float distance = glm::distance(mean, glm::vec3 {vertex.x, vertex.y, vertex.z});
+            if (distance < cluster.m_representativeDistance) {
+                cluster.m_representative = static_cast<std::uint32_t>(vertexIdx);
+                cluster.m_representativeDistance = distance;
+            }
+        }
+
+        // Drop the triangles that collapsed, and the duplicates of the ones that didn't. Rotating each triangle so its
+        // smallest index comes first keeps its winding.
+        std::vector<std::array<std::uint32_t, 3>> triangles;
+        triangles.reserve(primitive.m_vertexIndices.size() / 3);
+        for (size_t indexIdx = 0; indexIdx + 2 < primitive.m_vertexIndices.size(); indexIdx += 3) {
+            std::array<std::uint32_t, 3> triangle {};
+            for (size_t corner = 0; corner < 3; corner++) {
+                triangle[corner] = clusters[vertexClusters[primitive.m_vertexIndices[indexIdx + corner]]].m_representative;
+            }
+            if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2]) {
+                continue;
+            }
+
+            std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+            triangles.push_back(triangle);
+        }
+        std::ranges::sort(triangles);
+        triangles.erase(std::unique(triangles.begin(), triangles.end()), triangles.end());
+
+        std::vector<std::uint32_t> indices;
+        indices.reserve(triangles.size() * 3);
+        for (const auto& triangle : triangles) {
+            indices.insert(indices.end(), triangle.begin(), triangle.end());
+        }
+        return indices;
+    }
+
+} // namespace
+
+void GeneratePrimitiveLods(GltfPrimitive& primitive)
+{
+    primitive.m_lods.clear();
+    if (primitive.m_vertexIndices.empty() || primitive.m_vertexIndices.size() % 3 != 0) {
+        return;
+    }
+
+    size_t previousIndexCount = primitive.m_vertexIndices.size();
+    std::uint32_t resolution = Config::MESH_LOD_RESOLUTION;
+    for (size_t level = 1; level < Config::MESH_LOD_COUNT && resolution > 0; level++, resolution /= 2) {
+        std::vector<std::uint32_t> indices = ClusterTriangles(primitive, resolution);
+        if (indices.empty()) {
+            break;
+        }
+        if (static_cast<float>(indices.size()) > Config::MESH_LOD_MIN_REDUCTION * static_cast<float>(previousIndexCount)) {
+            continue;
+        }
+
+        OptimizeVertexCache(indices, primitive.m_vertexData.size());
+        previousIndexCount = indices.size();
+        primitive.m_lods.push_back(GltfLod {.m_indices = std::move(indices), .m_resolution = resolution});
+    }
+}
+
+void GenerateLods(GltfAsset& asset)
+{
+    for (GltfPrimitive& primitive : asset.m_primitives) {
+        GeneratePrimitiveLods(primitive);
+    }
+}
+
+} // namespace Glitter::Scene
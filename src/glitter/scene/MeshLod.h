@@ -0,0 +1,14 @@
+#pragma once
+
+#include "scene/GltfImporter.h"
+
+namespace Glitter::Scene {
+
+// Builds the LOD chain of a triangle list primitive by clustering its vertices into grids of Config::MESH_LOD_RESOLUTION
+// cells along its longest axis, halved at every level. Each cluster collapses onto the vertex nearest to its mean, so
+// every LOD is only a new index list. Levels that don't drop enough triangles are skipped.
+void GeneratePrimitiveLods(GltfPrimitive& primitive);
+
+void GenerateLods(GltfAsset& asset);
+
+} // namespace Glitter::Scene
@@ -0,0 +1,399 @@
+#include "scene/MeshOptimization.h"
+
+#include "scene/MeshLod.h"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Glitter::Scene {
+
+namespace {
+
+    // Forsyth's tuning values.
+    constexpr size_t VERTEX_CACHE_SIZE = 32;
+    constexpr float CACHE_DECAY_POWER = 1.5f;
+    constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+    constexpr float VALENCE_BOOST_SCALE = 2.0f;
+    constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+    // FIFO cache simulated to find the overdraw clusters and to check each pass actually helps, about the size of the
+    // real post-transform caches.
+    constexpr size_t SIMULATED_CACHE_SIZE = 16;
+    // Cache misses the overdraw pass is allowed to add.
+    constexpr float OVERDRAW_ACMR_THRESHOLD = 1.05f;
+
+    constexpr std::uint32_t SHORT_INDEX_LIMIT = 65536;
+
+    float VertexScore(int cachePosition, std::uint32_t remainingTriangles)
+    {
+        if (remainingTriangles == 0) {
+            return -1.0f;
+        }
+
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            // The 3 vertices of the last triangle get a fixed score, so the next one doesn't just reuse the same edge.
+            if (cachePosition < 3) {
+                score = LAST_TRIANGLE_SCORE;
+            } else {
+                float scaler = 1.0f / static_cast<float>(VERTEX_CACHE_SIZE - 3);
+                score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+            }
+        }
+
+        // Favor vertices with few triangles left, so they don't end up as lone triangles later.
+        score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+        return score;
+    }
+
+    bool IsTriangleList(const GltfPrimitive& primitive)
+    {
+        return !primitive.m_vertexIndices.empty() && primitive.m_vertexIndices.size() % 3 == 0;
+    }
+
+} // namespace
+
+void OptimizeVertexCache(std::span<std::uint32_t> indices, size_t vertexCount)
+{
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // Triangles of each vertex, as offsets into `vertexTriangles`.
+    std::vector<std::uint32_t> remainingTriangles(vertexCount);
+    for (std::uint32_t index : indices) {
+        remainingTriangles[index]++;
+    }
+    std::vector<std::uint32_t> triangleOffsets(vertexCount + 1);
+    std::inclusive_scan(remainingTriangles.begin(), remainingTriangles.end(), triangleOffsets.begin() + 1);
+    std::vector<std::uint32_t> vertexTriangles(indices.size());
+    {
+        std::vector<std::uint32_t> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+        for (size_t triangleIdx = 0; triangleIdx < triangleCount; triangleIdx++) {
+            for (size_t corner = 0; corner < 3; corner++) {
+                vertexTriangles[fill[indices[triangleIdx * 3 + corner]]++] = static_cast<std::uint32_t>(triangleIdx);
+            }
+        }
+    }
+
+    std::vector<int> cachePositions(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t vertexIdx = 0; vertexIdx < vertexCount; vertexIdx++) {
+        vertexScores[vertexIdx] = VertexScore(-1, remainingTriangles[vertexIdx]);
+    }
+
+    auto triangleScore = [&](size_t triangleIdx) {
+        return vertexScores[indices[triangleIdx * 3]] + vertexScores[indices[triangleIdx * 3 + 1]]
+            + vertexScores[indices[triangleIdx * 3 + 2]];
+    };
+
+    // Start from the best triangle, then only look at the triangles around the cached vertices.
+    size_t bestTriangle = 0;
+    for (size_t triangleIdx = 1; triangleIdx < triangleCount; triangleIdx++) {
+        if (triangleScore(triangleIdx) > triangleScore(bestTriangle)) {
+            bestTriangle = triangleIdx;
+        }
+    }
+
+    std::vector<std::uint32_t> output;
+    output.reserve(indices.size());
+    std::vector<std::uint32_t> cache;
+    cache.reserve(VERTEX_CACHE_SIZE + 3);
+    std::vector<std::uint32_t> newCache;
+    newCache.reserve(VERTEX_CACHE_SIZE + 3);
+
+    // Once no triangle of a cached vertex is left, carry on from the first triangle not emitted yet.
+    std::vector<bool> emitted(triangleCount);
+    size_t nextUnemitted = 0;
+    while (output.size() < indices.size()) {
+        std::array<std::uint32_t, 3> corners {
+            indices[bestTriangle * 3], indices[bestTriangle * 3 + 1], indices[bestTriangle * 3 + 2]};
+        output.insert(output.end(), corners.begin(), corners.end());
+        emitted[bestTriangle] = true;
+
+        // Push the triangle's vertices to the front of the cache, and drop the triangle from their lists.
+        newCache.assign(corners.begin(), corners.end());
+        for (std::uint32_t vertex : cache) {
+            if (std::ranges::find(corners, vertex) == corners.end()) {
+                newCache.push_back(vertex);
+            }
+        }
+        for (std::uint32_t vertex : corners) {
+            std::uint32_t* first = &vertexTriangles[triangleOffsets[vertex]];
+            std::uint32_t* last = first + remainingTriangles[vertex];
+            std::uint32_t* it = std::find(first, last, static_cast<std::uint32_t>(bestTriangle));
+            std::iter_swap(it, last - 1);
+            remainingTriangles[vertex]--;
+        }
+
+        // Rescore the vertices whose cache position changed, and the triangles left around them.
+        for (size_t cacheIdx = 0; cacheIdx < newCache.size(); cacheIdx++) {
+            std::uint32_t vertex = newCache[cacheIdx];
+            cachePositions[vertex] = cacheIdx < VERTEX_CACHE_SIZE ? static_cast<int>(cacheIdx) : -1;
+            vertexScores[vertex] = VertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+        }
+        newCache.resize(std::min(newCache.size(), VERTEX_CACHE_SIZE));
+        std::swap(cache, newCache);
+
+        float bestScore = -1.0f;
+        for (std::uint32_t vertex : cache) {
+            for (std::uint32_t i = 0; i < remainingTriangles[vertex]; i++) {
+                std::uint32_t triangleIdx = vertexTriangles[triangleOffsets[vertex] + i];
+                float score = triangleScore(triangleIdx);
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = triangleIdx;
+                }
+            }
+        }
+
+        if (bestScore < 0.0f) {
+            while (nextUnemitted < triangleCount && emitted[nextUnemitted]) {
+                nextUnemitted++;
+            }
+            bestTriangle = nextUnemitted;
+        }
+    }
+
+    std::ranges::copy(output, indices.begin());
+}
+
+void OptimizeOverdraw(std::span<std::uint32_t> indices, std::span<const MeshVertex> vertices)
+{
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2) {
+        return;
+    }
+
+    // Start a new cluster wherever a triangle misses the cache on all three vertices, i.e. where the cache order
+    // already jumped somewhere else.
+    std::vector<size_t> clusterStarts {0};
+    {
+        std::vector<std::uint32_t> cacheTimestamps(vertices.size(), 0);
+        std::uint32_t timestamp = SIMULATED_CACHE_SIZE + 1;
+        for (size_t triangleIdx = 0; triangleIdx < triangleCount; triangleIdx++) {
+            size_t misses = 0;
+            for (size_t corner = 0; corner < 3; corner++) {
+                std::uint32_t vertex = indices[triangleIdx * 3 + corner];
+                if (timestamp - cacheTimestamps[vertex] > SIMULATED_CACHE_SIZE) {
+                    cacheTimestamps[vertex] = timestamp++;
+                    misses++;
+                }
+            }
+            if (misses == 3 && triangleIdx > clusterStarts.back()) {
+                clusterStarts.push_back(triangleIdx);
+            }
+        }
+    }
+    if (clusterStarts.size() < 2) {
+        return;
+    }
+    clusterStarts.push_back(triangleCount);
+
+    auto position = [&](std::uint32_t vertex) {
+        return glm::vec3 {vertices[vertex].x, vertices[vertex].y, vertices[vertex].z};
+    };
+
+    // Area-weighted centroid and normal of each cluster, and of the whole primitive.
+    size_t clusterCount = clusterStarts.size() - 1;
+    std::vector<glm::vec3> clusterCentroids(clusterCount);
+    std::vector<glm::vec3> clusterNormals(clusterCount);
+    glm::vec3 meshCentroid {0.0f};
+    float meshArea = 0.0f;
+    for (size_t clusterIdx = 0; clusterIdx < clusterCount; clusterIdx++) {
+        glm::vec3 centroid {0.0f};
+        glm::vec3 normal {0.0f};
+        float area = 0.0f;
+        for (size_t triangleIdx = clusterStarts[clusterIdx]; triangleIdx < clusterStarts[clusterIdx + 1]; triangleIdx++) {
+            glm::vec3 p0 = position(indices[triangleIdx * 3]);
+            glm::vec3 p1 = position(indices[triangleIdx * 3 + 1]);
+            glm::vec3 p2 = position(indices[triangleIdx * 3 + 2]);
+            glm::vec3 areaNormal = glm::cross(p1 - p0, p2 - p0);
+            float triangleArea = glm::length(areaNormal);
+            centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+            normal += areaNormal;
+            area += triangleArea;
+        }
+        meshCentroid += centroid;
+        meshArea += area;
+        clusterCentroids[clusterIdx] = area > 0.0f ? centroid / area : centroid;
+        clusterNormals[clusterIdx] = normal;
+    }
+    if (meshArea > 0.0f) {
+        meshCentroid /= meshArea;
+    }
+
+    std::vector<float> sortKeys(clusterCount);
+    for (size_t clusterIdx = 0; clusterIdx < clusterCount; clusterIdx++) {
+        float normalLength = glm::length(clusterNormals[clusterIdx]);
+        sortKeys[clusterIdx] = normalLength > 0.0f
+            ? glm::dot(clusterCentroids[clusterIdx] - meshCentroid, clusterNormals[clusterIdx] / normalLength)
+            : -FLT_MAX;
+    }
+
+    std::vector<size_t> clusterOrder(clusterCount);
+    std::iota(clusterOrder.begin(), clusterOrder.end(), 0);
+    std::ranges::stable_sort(clusterOrder, [&](size_t a, size_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<std::uint32_t> output;
+    output.reserve(indices.size());
+    for (size_t clusterIdx : clusterOrder) {
+        output.insert(output.end(), indices.begin() + static_cast<std::ptrdiff_t>(clusterStarts[clusterIdx] * 3),
+            indices.begin() + static_cast<std::ptrdiff_t>(clusterStarts[clusterIdx + 1] * 3));
+    }
+    std::ranges::copy(output, indices.begin());
+}
+
+void OptimizeVertexFetch(
+    std::vector<MeshVertex>& vertices, std::vector<SkinnedVertex>& skinnedVertices, std::span<std::uint32_t> indices)
+{
+    constexpr std::uint32_t UNMAPPED = std::numeric_limits<std::uint32_t>::max();
+
+    bool skinned = !skinnedVertices.empty();
+    std::vector<std::uint32_t> remap(vertices.size(), UNMAPPED);
+    std::vector<MeshVertex> reordered;
+    std::vector<SkinnedVertex> reorderedSkinned;
+    reordered.reserve(vertices.size());
+    reorderedSkinned.reserve(skinnedVertices.size());
+    for (std::uint32_t& index : indices) {
+        if (remap[index] == UNMAPPED) {
+            remap[index] = static_cast<std::uint32_t>(reordered.size());
+            reordered.push_back(vertices[index]);
+            if (skinned) {
+                reorderedSkinned.push_back(skinnedVertices[index]);
+            }
+        }
+        index = remap[index];
+    }
+
+    vertices = std::move(reordered);
+    skinnedVertices = std::move(reorderedSkinned);
+}
+
+float ComputeACMR(std::span<const std::uint32_t> indices, size_t vertexCount, size_t cacheSize)
+{
+    if (indices.size() < 3) {
+        return 0.0f;
+    }
+
+    std::vector<size_t> cacheTimestamps(vertexCount, 0);
+    size_t timestamp = cacheSize + 1;
+    size_t misses = 0;
+    for (std::uint32_t index : indices) {
+        if (timestamp - cacheTimestamps[index] > cacheSize) {
+            cacheTimestamps[index] = timestamp++;
+            misses++;
+        }
+    }
+    return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
+
+void OptimizeAsset(GltfAsset& asset)
+{
+    for (GltfPrimitive& primitive : asset.m_primitives) {
+        if (!IsTriangleList(primitive)) {
+            continue;
+        }
+
+        std::vector<std::uint32_t>& indices = primitive.m_vertexIndices;
+        size_t vertexCount = primitive.m_vertexData.size();
+
+        // Some exporters already write a cache-friendly order, keep it if Forsyth's isn't any better.
+        std::vector<std::uint32_t> previousIndices = indices;
+        float previousACMR = ComputeACMR(indices, vertexCount, SIMULATED_CACHE_SIZE);
+        OptimizeVertexCache(indices, vertexCount);
+        float cacheACMR = ComputeACMR(indices, vertexCount, SIMULATED_CACHE_SIZE);
+        if (cacheACMR > previousACMR) {
+            indices = previousIndices;
+            cacheACMR = previousACMR;
+        }
+
+        previousIndices = indices;
+        OptimizeOverdraw(indices, primitive.m_vertexData);
+        if (ComputeACMR(indices, vertexCount, SIMULATED_CACHE_SIZE) > cacheACMR * OVERDRAW_ACMR_THRESHOLD) {
+            indices = previousIndices;
+        }
+
+        OptimizeVertexFetch(primitive.m_vertexData, primitive.m_skinnedVertexData, indices);
+    }
+}
+
+void SplitForShortIndices(GltfAsset& asset)
+{
+    constexpr std::uint32_t UNMAPPED = std::numeric_limits<std::uint32_t>::max();
+
+    // The primitives each original one was split into.
+    std::vector<std::vector<std::uint32_t>> splits(asset.m_primitives.size());
+    std::vector<GltfPrimitive> primitives;
+    std::vector<std::uint32_t> remap;
+    for (size_t primitiveIdx = 0; primitiveIdx < asset.m_primitives.size(); primitiveIdx++) {
+        GltfPrimitive& source = asset.m_primitives[primitiveIdx];
+        if (source.m_vertexData.size() <= SHORT_INDEX_LIMIT || !IsTriangleList(source)) {
+            splits[primitiveIdx].push_back(static_cast<std::uint32_t>(primitives.size()));
+            primitives.push_back(std::move(source));
+            continue;
+        }
+
+        // Fill each split with whole triangles until one more could reference too many vertices.
+        remap.assign(source.m_vertexData.size(), UNMAPPED);
+        GltfPrimitive split {};
+        // The source vertices copied into `split`.
+        std::vector<std::uint32_t> splitSources;
+        auto flush = [&] {
+            split.m_aabb = AABB {.m_localMin = glm::vec3(FLT_MAX), .m_localMax = glm::vec3(-FLT_MAX)};
+            for (const MeshVertex& vertex : split.m_vertexData) {
+                split.m_aabb.m_localMin = glm::min(split.m_aabb.m_localMin, glm::vec3 {vertex.x, vertex.y, vertex.z});
+                split.m_aabb.m_localMax = glm::max(split.m_aabb.m_localMax, glm::vec3 {vertex.x, vertex.y, vertex.z});
+            }
+            for (std::uint32_t vertex : splitSources) {
+                remap[vertex] = UNMAPPED;
+            }
+            splitSources.clear();
+
+            // The source's LODs reference vertices of every split, rebuild them for each.
+            if (!source.m_lods.empty()) {
+                GeneratePrimitiveLods(split);
+            }
+
+            splits[primitiveIdx].push_back(static_cast<std::uint32_t>(primitives.size()));
+            primitives.push_back(std::move(split));
+            split = {};
+        };
+
+        for (size_t indexIdx = 0; indexIdx < source.m_vertexIndices.size(); indexIdx += 3) {
+            if (split.m_vertexData.size() + 3 > SHORT_INDEX_LIMIT) {
+                flush();
+            }
+
+            for (size_t corner = 0; corner < 3; corner++) {
+                std::uint32_t vertex = source.m_vertexIndices[indexIdx + corner];
+                if (remap[vertex] == UNMAPPED) {
+                    remap[vertex] = static_cast<std::uint32_t>(split.m_vertexData.size());
+                    split.m_vertexData.push_back(source.m_vertexData[vertex]);
+                    if (!source.m_skinnedVertexData.empty()) {
+                        split.m_skinnedVertexData.push_back(source.m_skinnedVertexData[vertex]);
+                    }
+                    splitSources.push_back(vertex);
+                }
+                split.m_vertexIndices.push_back(remap[vertex]);
+            }
+        }
+        flush();
+    }
+
+    for (GltfMesh& mesh : asset.m_meshes) {
+        std::vector<std::uint32_t> meshPrimitives;
+        for (std::uint32_t primitiveIdx : mesh.m_primitives) {
+            meshPrimitives.insert(meshPrimitives.end(), splits[primitiveIdx].begin(), splits[primitiveIdx].end());
+        }
+        mesh.m_primitives = std::move(meshPrimitives);
+    }
+    asset.m_primitives = std::move(primitives);
+}
+
+} // namespace Glitter::Scene
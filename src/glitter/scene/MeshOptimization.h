@@ -0,0 +1,35 @@
+#pragma once
+
+#include "scene/GltfImporter.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Glitter::Scene {
+
+// Reorders the triangles of `indices` to reuse the post-transform vertex cache, with Tom Forsyth's linear-speed
+// algorithm.
+void OptimizeVertexCache(std::span<std::uint32_t> indices, size_t vertexCount);
+
+// Splits cache-ordered triangles into clusters where the cache starts over, then draws the clusters facing away from
+// the center of the primitive first, so they're more likely to occlude the rest. Mostly keeps the cache efficiency.
+void OptimizeOverdraw(std::span<std::uint32_t> indices, std::span<const MeshVertex> vertices);
+
+// Reorders `vertices` in the order `indices` first reference them and remaps `indices`, so vertex fetches stream
+// through memory. Unreferenced vertices are dropped. `skinnedVertices`, if not empty, is reordered alongside.
+void OptimizeVertexFetch(
+    std::vector<MeshVertex>& vertices, std::vector<SkinnedVertex>& skinnedVertices, std::span<std::uint32_t> indices);
+
+// Average post-transform cache misses per triangle of `indices` through a FIFO cache of `cacheSize` vertices.
+float ComputeACMR(std::span<const std::uint32_t> indices, size_t vertexCount, size_t cacheSize);
+
+// Runs the three passes above on every triangle list primitive of `asset`, keeping the triangle order of the first two
+// only where they don't make the simulated cache misses worse.
+void OptimizeAsset(GltfAsset& asset);
+
+// Splits the primitives of `asset` referencing more than 65536 vertices, so every index fits in 16 bits.
+void SplitForShortIndices(GltfAsset& asset);
+
+} // namespace Glitter::Scene
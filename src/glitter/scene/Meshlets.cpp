@@ -0,0 +1,131 @@
+#include "scene/Meshlets.h"
+
+#include "Config.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <span>
+
+namespace Glitter::Scene {
+
+namespace {
+
+    glm::vec3 PositionOf(const MeshVertex& vertex) { return {vertex.x, vertex.y, vertex.z}; }
+
+    // Fits the bounding sphere and normal cone of the triangles in `indices`.
+    void ComputeMeshletBounds(GltfMeshlet& meshlet, std::span<const MeshVertex> vertices, std::span<const std::uint32_t> indices)
+    {
+        glm::vec3 boundsMin(FLT_MAX);
+        glm::vec3 boundsMax(-FLT_MAX);
+        for (std::uint32_t index : indices) {
+            boundsMin = glm::min(boundsMin, PositionOf(vertices[index]));
+            boundsMax = glm::max(boundsMax, PositionOf(vertices[index]));
+        }
+        meshlet.m_center = (boundsMin + boundsMax) * 0.5f;
+        meshlet.m_radius = 0.0f;
+        for (std::uint32_t index : indices) {
+            meshlet.m_radius = std::max(meshlet.m_radius, glm::distance(meshlet.m_center, PositionOf(vertices[index])));
+        }
+
+        // The cone axis is the average of the triangle normals, and its half-angle the widest normal around it. Normals
+        // more than ~84 degrees apart leave too few camera positions from which the whole meshlet faces away.
+        meshlet.m_coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+        meshlet.m_coneCutoff = 1.0f;
+
+        std::vector<glm::vec3> normals;
+        normals.reserve(indices.size() / 3);
+        glm::vec3 normalSum(0.0f);
+        for (size_t indexIdx = 0; indexIdx + 2 < indices.size(); indexIdx += 3) {
+            glm::vec3 a = PositionOf(vertices[indices[indexIdx]]);
+            glm::vec3 b = PositionOf(vertices[indices[indexIdx + 1]]);
+            glm::vec3 c = PositionOf(vertices[indices[indexIdx + 2]]);
+            glm::vec3 normal = glm::cross(b - a, c - a);
+            float length = glm::length(normal);
+            if (length > 0.0f) {
+                normals.push_back(normal / length);
+                normalSum += normals.back();
+            }
+        }
+
+        float sumLength = glm::length(normalSum);
+        if (normals.empty() || !(sumLength > 0.0f)) {
+            return;
+        }
+
+        glm::vec3 axis = normalSum / sumLength;
+        float minDot = 1.0f;
+        for (const glm::vec3& normal : normals) {
+            minDot = std::min(minDot, glm::dot(axis, normal));
+        }
+        if (minDot > 0.1f) {
+            meshlet.m_coneAxis = axis;
+            meshlet.m_coneCutoff = std::sqrt(1.0f - minDot * minDot);
+        }
+    }
+
+} // namespace
+
+void BuildMeshlets(GltfPrimitive& primitive)
+{
+    primitive.m_meshlets.clear();
+    std::span<const MeshVertex> vertices(primitive.m_vertexData);
+    std::span<const std::uint32_t> indices(primitive.m_vertexIndices);
+
+    // The meshlet each vertex was last added to, so its unique vertices are counted without a set.
+    std::vector<std::uint32_t> vertexMeshlet(vertices.size(), UINT32_MAX);
+    auto meshletIdx = static_cast<std::uint32_t>(0);
+    size_t meshletStart = 0;
+    size_t meshletVertices = 0;
+
+    auto flush = [&](size_t end) {
+        GltfMeshlet meshlet {.m_firstIndex = static_cast<std::uint32_t>(meshletStart),
+            .m_indexCount = static_cast<std::uint32_t>(end - meshletStart),
+            .m_center = {},
+            .m_radius = 0.0f,
+            .m_coneAxis = {},
+            .m_coneCutoff = 1.0f};
+        ComputeMeshletBounds(meshlet, vertices, indices.subspan(meshletStart, end - meshletStart));
+        primitive.m_meshlets.push_back(meshlet);
+
+        meshletIdx++;
+        meshletStart = end;
+        meshletVertices = 0;
+    };
+
+    for (size_t indexIdx = 0; indexIdx + 2 < indices.size(); indexIdx += 3) {
+        size_t newVertices = 0;
+        for (size_t corner = 0; corner < 3; corner++) {
+            newVertices += vertexMeshlet[indices[indexIdx + corner]] != meshletIdx ? 1 : 0;
+        }
+
+        size_t meshletTriangles = (indexIdx - meshletStart) / 3;
+        if (meshletVertices + newVertices > Config::MESHLET_MAX_VERTICES || meshletTriangles + 1 > Config::MESHLET_MAX_TRIANGLES) {
+            flush(indexIdx);
+        }
+
+        // Repeated corners of a degenerate triangle are still only counted once.
+        for (size_t corner = 0; corner < 3; corner++) {
+            std::uint32_t& stamp = vertexMeshlet[indices[indexIdx + corner]];
+            if (stamp != meshletIdx) {
+                stamp = meshletIdx;
+                meshletVertices++;
+            }
+        }
+    }
+
+    if (meshletStart < indices.size() - indices.size() % 3) {
+        flush(indices.size() - indices.size() % 3);
+    }
+}
+
+void BuildMeshlets(GltfAsset& asset)
+{
+    for (GltfPrimitive& primitive : asset.m_primitives) {
+        if (primitive.m_vertexIndices.size() / 3 >= Config::MESHLET_MIN_TRIANGLES) {
+            BuildMeshlets(primitive);
+        }
+    }
+}
+
+} // namespace Glitter::Scene
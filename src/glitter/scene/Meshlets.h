@@ -0,0 +1,15 @@
+#pragma once
+
+#include "scene/GltfImporter.h"
+
+namespace Glitter::Scene {
+
+// Splits the triangles of a primitive into meshlets, in their current order, so that a vertex cache optimized order keeps
+// each meshlet compact. A meshlet ends when its next triangle would bring it over Config::MESHLET_MAX_VERTICES unique
+// vertices or Config::MESHLET_MAX_TRIANGLES triangles. Reads m_vertexData, so it has to run before QuantizeAsset().
+void BuildMeshlets(GltfPrimitive& primitive);
+
+// Builds the meshlets of the primitives with at least Config::MESHLET_MIN_TRIANGLES triangles.
+void BuildMeshlets(GltfAsset& asset);
+
+} // namespace Glitter::Scene
@@ -0,0 +1,362 @@
+#include "scene/NodeStore.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+
+namespace Glitter::Scene {
+
+namespace {
+
+    // Only set within Remove(), on the Nodes about to be removed along with their ancestor.
+    constexpr std::uint8_t REMOVING = 1 << 7;
+
+    // Shared by every NodeStore, so that a structure built over one store's Nodes never mistakes another's for them.
+    std::atomic<std::uint64_t> g_nextRevision {1};
+
+} // namespace
+
+NodeHandle NodeStore::Add(const NodeDesc& desc)
+{
+    auto node = static_cast<std::uint32_t>(m_positions.size());
+
+    std::uint32_t slot = 0;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        m_slots[slot].m_node = node;
+    } else {
+        slot = static_cast<std::uint32_t>(m_slots.size());
+        m_slots.push_back(Slot {.m_node = node, .m_generation = 0});
+    }
+
+    // An invalid parent leaves the Node at the root.
+    std::uint32_t parentSlot = INVALID_SLOT;
+    std::uint32_t depth = 0;
+    if (desc.m_parent && IsValid(*desc.m_parent)) {
+        parentSlot = desc.m_parent->m_slot;
+        std::uint32_t parent = m_slots[parentSlot].m_node;
+        depth = m_depths[parent] + 1;
+        m_childCounts[parent]++;
+    }
+
+    m_positions.push_back(desc.m_position);
+    m_rotations.push_back(desc.m_rotation);
+    m_scales.push_back(desc.m_scale);
+    m_opacities.push_back(desc.m_opacity);
+    m_flags.push_back(desc.m_shouldAnimate ? NodeFlags::ANIMATE : 0);
+    m_animationPhases.push_back(desc.m_animationPhase);
+    m_models.emplace_back(1.0f);
+    m_parents.push_back(parentSlot);
+    m_depths.push_back(depth);
+    m_childCounts.push_back(0);
+    m_meshIDs.push_back(static_cast<std::uint32_t>(desc.m_meshID));
+    m_textureIDs.push_back(static_cast<std::uint32_t>(desc.m_textureID));
+    m_materialIDs.push_back(static_cast<std::uint32_t>(desc.m_materialID));
+    m_nodeSlots.push_back(slot);
+    m_dirtyPositions.push_back(0);
+    MarkDirty(node);
+    BumpRevision();
+
+    NodeHandle handle {.m_slot = slot, .m_generation = m_slots[slot].m_generation};
+    if (parentSlot != INVALID_SLOT) {
+        m_hierarchy.push_back(handle);
+        m_hierarchyChanged = true;
+    }
+    return handle;
+}
+
+void NodeStore::Append(const NodeArrays& nodes)
+{
+    auto first = static_cast<std::uint32_t>(m_positions.size());
+    auto count = static_cast<std::uint32_t>(nodes.m_positions.size());
+    if (count == 0) {
+        return;
+    }
+
+    // Copy each array whole first.
+    m_positions.insert(m_positions.end(), nodes.m_positions.begin(), nodes.m_positions.end());
+    m_rotations.insert(m_rotations.end(), nodes.m_rotations.begin(), nodes.m_rotations.end());
+    m_scales.insert(m_scales.end(), nodes.m_scales.begin(), nodes.m_scales.end());
+    m_opacities.insert(m_opacities.end(), nodes.m_opacities.begin(), nodes.m_opacities.end());
+    std::ranges::transform(nodes.m_flags, std::back_inserter(m_flags),
+        [](std::uint8_t flags) { return static_cast<std::uint8_t>(flags & NodeFlags::ANIMATE); });
+    m_animationPhases.insert(m_animationPhases.end(), nodes.m_animationPhases.begin(), nodes.m_animationPhases.end());
+    m_meshIDs.insert(m_meshIDs.end(), nodes.m_meshIDs.begin(), nodes.m_meshIDs.end());
+    m_textureIDs.insert(m_textureIDs.end(), nodes.m_textureIDs.begin(), nodes.m_textureIDs.end());
+    m_materialIDs.insert(m_materialIDs.end(), nodes.m_materialIDs.begin(), nodes.m_materialIDs.end());
+    m_models.resize(first + count, glm::mat4(1.0f));
+    m_parents.resize(first + count, INVALID_SLOT);
+    m_depths.resize(first + count, 0);
+    m_childCounts.resize(first + count, 0);
+    m_nodeSlots.resize(first + count);
+    m_dirtyPositions.resize(first + count);
+
+    // Then give each its slot, parents first, and link it to its parent.
+    for (std::uint32_t nodeIdx = 0; nodeIdx < count; nodeIdx++) {
+        std::uint32_t node = first + nodeIdx;
+        std::uint32_t slot = 0;
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+            m_slots[slot].m_node = node;
+        } else {
+            slot = static_cast<std::uint32_t>(m_slots.size());
+            m_slots.push_back(Slot {.m_node = node, .m_generation = 0});
+        }
+        m_nodeSlots[node] = slot;
+
+        // A parent that isn't an earlier Node leaves the Node at the root.
+        if (std::uint32_t parentIdx = nodes.m_parents[nodeIdx]; parentIdx < nodeIdx) {
+            std::uint32_t parent = first + parentIdx;
+            m_parents[node] = m_nodeSlots[parent];
+            m_depths[node] = m_depths[parent] + 1;
+            m_childCounts[parent]++;
+            m_hierarchy.push_back(NodeHandle {.m_slot = slot, .m_generation = m_slots[slot].m_generation});
+            m_hierarchyChanged = true;
+        }
+        MarkDirty(node);
+    }
+    BumpRevision();
+}
+
+bool NodeStore::Remove(NodeHandle handle)
+{
+    if (!IsValid(handle)) {
+        return false;
+    }
+
+    std::uint32_t node = m_slots[handle.m_slot].m_node;
+    if (m_childCounts[node] > 0) {
+        // Gather the descendants, parents first, then remove them deepest first so that each is a leaf by then.
+        SortHierarchy();
+        m_flags[node] |= REMOVING;
+        std::vector<NodeHandle> descendants {};
+        for (NodeHandle child : m_hierarchy) {
+            std::uint32_t childNode = m_slots[child.m_slot].m_node;
+            if ((m_flags[m_slots[m_parents[childNode]].m_node] & REMOVING) != 0) {
+                m_flags[childNode] |= REMOVING;
+                descendants.push_back(child);
+            }
+        }
+        for (auto descendant = descendants.rbegin(); descendant != descendants.rend(); ++descendant) {
+            RemoveLeaf(m_slots[descendant->m_slot].m_node);
+        }
+        node = m_slots[handle.m_slot].m_node;
+    }
+
+    RemoveLeaf(node);
+    return true;
+}
+
+void NodeStore::RemoveLeaf(std::uint32_t node)
+{
+    std::uint32_t slot = m_nodeSlots[node];
+    m_slots[slot].m_node = INVALID_NODE;
+    m_slots[slot].m_generation++;
+    m_freeSlots.push_back(slot);
+
+    if (m_parents[node] != INVALID_SLOT) {
+        m_childCounts[m_slots[m_parents[node]].m_node]--;
+        m_hierarchyChanged = true;
+    }
+
+    // Drop it from the dirty Nodes, then fill its place with the last Node.
+    if ((m_flags[node] & NodeFlags::TRANSFORM_DIRTY) != 0) {
+        std::uint32_t position = m_dirtyPositions[node];
+        std::uint32_t lastDirty = m_dirtyNodes.back();
+        m_dirtyNodes[position] = lastDirty;
+        m_dirtyPositions[lastDirty] = position;
+        m_dirtyNodes.pop_back();
+    }
+    auto last = static_cast<std::uint32_t>(m_positions.size() - 1);
+    if (node != last) {
+        MoveNode(last, node);
+    }
+
+    m_positions.pop_back();
+    m_rotations.pop_back();
+    m_scales.pop_back();
+    m_opacities.pop_back();
+    m_flags.pop_back();
+    m_animationPhases.pop_back();
+    m_models.pop_back();
+    m_parents.pop_back();
+    m_depths.pop_back();
+    m_childCounts.pop_back();
+    m_meshIDs.pop_back();
+    m_textureIDs.pop_back();
+    m_materialIDs.pop_back();
+    m_nodeSlots.pop_back();
+    m_dirtyPositions.pop_back();
+    BumpRevision();
+}
+
+void NodeStore::BumpRevision() { m_revision = g_nextRevision.fetch_add(1, std::memory_order_relaxed); }
+
+void NodeStore::MoveNode(std::uint32_t from, std::uint32_t to)
+{
+    m_positions[to] = m_positions[from];
+    m_rotations[to] = m_rotations[from];
+    m_scales[to] = m_scales[from];
+    m_opacities[to] = m_opacities[from];
+    m_flags[to] = m_flags[from];
+    m_animationPhases[to] = m_animationPhases[from];
+    m_models[to] = m_models[from];
+    m_parents[to] = m_parents[from];
+    m_depths[to] = m_depths[from];
+    m_childCounts[to] = m_childCounts[from];
+    m_meshIDs[to] = m_meshIDs[from];
+    m_textureIDs[to] = m_textureIDs[from];
+    m_materialIDs[to] = m_materialIDs[from];
+    m_nodeSlots[to] = m_nodeSlots[from];
+    m_slots[m_nodeSlots[to]].m_node = to;
+
+    // Anything cached for it has to be refreshed at its new index.
+    if ((m_flags[to] & NodeFlags::TRANSFORM_DIRTY) != 0) {
+        m_dirtyPositions[to] = m_dirtyPositions[from];
+        m_dirtyNodes[m_dirtyPositions[to]] = to;
+    } else {
+        MarkDirty(to);
+    }
+}
+
+bool NodeStore::SetTransform(NodeHandle handle, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+{
+    if (!IsValid(handle)) {
+        return false;
+    }
+
+    std::uint32_t node = m_slots[handle.m_slot].m_node;
+    m_positions[node] = position;
+    m_rotations[node] = rotation;
+    m_scales[node] = scale;
+    if ((m_flags[node] & NodeFlags::TRANSFORM_DIRTY) == 0) {
+        MarkDirty(node);
+    }
+    return true;
+}
+
+void NodeStore::MarkDirty(std::uint32_t node)
+{
+    m_flags[node] |= NodeFlags::TRANSFORM_DIRTY;
+    m_dirtyPositions[node] = static_cast<std::uint32_t>(m_dirtyNodes.size());
+    m_dirtyNodes.push_back(node);
+}
+
+void NodeStore::MarkAllDirty()
+{
+    ClearDirty();
+    for (std::uint32_t node = 0; node < static_cast<std::uint32_t>(m_positions.size()); node++) {
+        MarkDirty(node);
+    }
+    BumpRevision();
+}
+
+void NodeStore::ClearDirty()
+{
+    for (std::uint32_t node : m_dirtyNodes) {
+        m_flags[node] &= static_cast<std::uint8_t>(~NodeFlags::TRANSFORM_DIRTY);
+    }
+    m_dirtyNodes.clear();
+}
+
+glm::aligned_mat4 NodeStore::GetLocalModel(std::uint32_t node) const
+{
+    // Scale, then rotate, then translate.
+    glm::aligned_mat4 model = glm::mat4_cast(m_rotations[node]);
+    model[0] *= m_scales[node].x;
+    model[1] *= m_scales[node].y;
+    model[2] *= m_scales[node].z;
+    model[3] = glm::aligned_vec4(m_positions[node], 1.0f);
+    return model;
+}
+
+void NodeStore::UpdateModels(size_t begin, size_t end)
+{
+    for (size_t dirtyIdx = begin; dirtyIdx < end; dirtyIdx++) {
+        std::uint32_t node = m_dirtyNodes[dirtyIdx];
+        if (m_parents[node] == INVALID_SLOT) {
+            m_models[node] = GetLocalModel(node);
+        }
+    }
+}
+
+void NodeStore::UpdateHierarchy()
+{
+    SortHierarchy();
+    for (NodeHandle child : m_hierarchy) {
+        std::uint32_t node = m_slots[child.m_slot].m_node;
+        std::uint32_t parent = m_slots[m_parents[node]].m_node;
+        if ((m_flags[parent] & NodeFlags::TRANSFORM_DIRTY) != 0 && (m_flags[node] & NodeFlags::TRANSFORM_DIRTY) == 0) {
+            MarkDirty(node);
+        }
+        if ((m_flags[node] & NodeFlags::TRANSFORM_DIRTY) != 0) {
+            m_models[node] = m_models[parent] * GetLocalModel(node);
+        }
+    }
+}
+
+void NodeStore::SortHierarchy()
+{
+    if (!m_hierarchyChanged) {
+        return;
+    }
+
+    std::erase_if(m_hierarchy, [this](NodeHandle handle) { return !IsValid(handle); });
+    std::ranges::stable_sort(
+        m_hierarchy, {}, [this](NodeHandle handle) { return m_depths[m_slots[handle.m_slot].m_node]; });
+    m_hierarchyChanged = false;
+}
+
+void NodeStore::Reserve(size_t capacity)
+{
+    m_positions.reserve(capacity);
+    m_rotations.reserve(capacity);
+    m_scales.reserve(capacity);
+    m_opacities.reserve(capacity);
+    m_flags.reserve(capacity);
+    m_animationPhases.reserve(capacity);
+    m_models.reserve(capacity);
+    m_parents.reserve(capacity);
+    m_depths.reserve(capacity);
+    m_childCounts.reserve(capacity);
+    m_meshIDs.reserve(capacity);
+    m_textureIDs.reserve(capacity);
+    m_materialIDs.reserve(capacity);
+    m_nodeSlots.reserve(capacity);
+    m_slots.reserve(capacity);
+    m_dirtyPositions.reserve(capacity);
+}
+
+void NodeStore::Clear()
+{
+    // Every slot is freed, and its handles invalidated.
+    for (std::uint32_t slot : m_nodeSlots) {
+        m_slots[slot].m_node = INVALID_NODE;
+        m_slots[slot].m_generation++;
+        m_freeSlots.push_back(slot);
+    }
+
+    m_positions.clear();
+    m_rotations.clear();
+    m_scales.clear();
+    m_opacities.clear();
+    m_flags.clear();
+    m_animationPhases.clear();
+    m_models.clear();
+    m_parents.clear();
+    m_depths.clear();
+    m_childCounts.clear();
+    m_hierarchy.clear();
+    m_hierarchyChanged = false;
+    m_dirtyNodes.clear();
+    m_meshIDs.clear();
+    m_textureIDs.clear();
+    m_materialIDs.clear();
+    m_nodeSlots.clear();
+    m_dirtyPositions.clear();
+    BumpRevision();
+}
+
+} // namespace Glitter::Scene
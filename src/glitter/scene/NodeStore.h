@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Glitter::Scene {
+
+// Stable reference to a Node of a NodeStore: the slot the Node was added into, and the generation of that slot at the
+// time. Removing the Node bumps the generation, so its handles are invalid from then on, even once the slot is reused.
+struct NodeHandle {
+    std::uint32_t m_slot;
+    std::uint32_t m_generation;
+
+    bool operator==(const NodeHandle&) const = default;
+};
+
+namespace NodeFlags {
+    // The opacity is animated over time, see AnimatedOpacity().
+    constexpr std::uint8_t ANIMATE = 1 << 0;
+    // The transform, or a parent's, changed since the cached Model and bounds were last updated.
+    constexpr std::uint8_t TRANSFORM_DIRTY = 1 << 1;
+    // The translation and opacity are simulated on the GPU, see Glitter::Render::NodeSwarm. The Node keeps the transform
+    // and opacity it was added with on the CPU.
+    constexpr std::uint8_t SIMULATED = 1 << 2;
+} // namespace NodeFlags
+
+// Opacity of an animating Node `time` seconds (offset by its phase) into the animation. MainVS.glsl and CullCS.glsl
+// evaluate the same curve, so animating Nodes never have to be re-uploaded.
+inline float AnimatedOpacity(float time) { return std::clamp(std::abs(1.25f * std::cos(time)), 0.0f, 1.0f); }
+
+struct NodeDesc {
+    // Relative to the parent, if any.
+    glm::vec3 m_position;
+    glm::quat m_rotation {1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 m_scale;
+
+    size_t m_meshID;
+
+    // Index into the loaded textures, and so the layer of the texture array in TextureMode::Array.
+    size_t m_textureID;
+    // Index into the material table, whose first material is the default one.
+    size_t m_materialID;
+    float m_opacity;
+
+    bool m_shouldAnimate;
+    // Offset into the opacity animation, in seconds.
+    float m_animationPhase;
+
+    // A Node already in the store, whose Model this Node's transform is relative to.
+    std::optional<NodeHandle> m_parent {};
+};
+
+// Nodes added in bulk by NodeStore::Append(), as arrays of the same length. A Node's parent is the index of an earlier one
+// among them, or NO_PARENT.
+struct NodeArrays {
+    static constexpr std::uint32_t NO_PARENT = UINT32_MAX;
+
+    std::span<const glm::vec3> m_positions;
+    std::span<const glm::quat> m_rotations;
+    std::span<const glm::vec3> m_scales;
+    std::span<const float> m_opacities;
+    // Only NodeFlags::ANIMATE is kept.
+    std::span<const std::uint8_t> m_flags;
+    std::span<const float> m_animationPhases;
+    std::span<const std::uint32_t> m_parents;
+    std::span<const std::uint32_t> m_meshIDs;
+    std::span<const std::uint32_t> m_textureIDs;
+    std::span<const std::uint32_t> m_materialIDs;
+};
+
+// Structure-of-arrays storage for every Node in the scene. Each field lives in its own contiguous array so that the
+// culling, animation and sorting passes only stream the bytes they actually touch.
+//
+// The arrays are kept packed: removing a Node moves the last one into its place, so every pass keeps iterating over
+// [0, Size()). The Nodes are referred to by their index in the arrays everywhere per-frame, including the GPU-side data,
+// and by a NodeHandle from outside, which a slot map resolves to the index in O(1). A moved Node is flagged as dirty,
+// so the per-Node caches indexed by its old index are refreshed at its new one.
+//
+// Nodes can be parented to others, their Model is then their parent's Model times their own transform. The Nodes that have
+// a parent are kept sorted by depth in a separate array, so that the Models are updated in a single pass over it, parents
+// first, which also propagates the dirty flags down the hierarchy. The Nodes without parents, most of them, don't take part
+// in it. Removing a Node removes its descendants too, which is linear in the Nodes with a parent when it has any.
+//
+// The positions, scales and Models are kept in glm's aligned types, a 16-byte lane per column, so that the Models are
+// built, multiplied down the hierarchy and transform the bounds with glm's SIMD code rather than a component at a time.
+class NodeStore {
+public:
+    NodeHandle Add(const NodeDesc& desc);
+    // Adds every Node of `nodes` at once, each array copied in a single pass rather than a Node at a time.
+    void Append(const NodeArrays& nodes);
+    // Returns false if the Node was already removed.
+    bool Remove(NodeHandle handle);
+    // Returns false if the Node was removed.
+    bool SetTransform(NodeHandle handle, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+    void Reserve(size_t capacity);
+    void Clear();
+
+    bool IsValid(NodeHandle handle) const
+    {
+        return handle.m_slot < m_slots.size() && m_slots[handle.m_slot].m_generation == handle.m_generation
+            && m_slots[handle.m_slot].m_node != INVALID_NODE;
+    }
+    // The index of a valid Node in the arrays, until a Node is removed.
+    size_t GetNode(NodeHandle handle) const { return m_slots[handle.m_slot].m_node; }
+    NodeHandle GetHandle(size_t node) const
+    {
+        std::uint32_t slot = m_nodeSlots[node];
+        return NodeHandle {.m_slot = slot, .m_generation = m_slots[slot].m_generation};
+    }
+
+    size_t Size() const { return m_positions.size(); }
+    // Changed whenever Nodes are added, removed or cleared, so that structures built over the Nodes know to rebuild. Every
+    // NodeStore draws its revisions from the same counter, so that another store's Nodes are never taken for its own.
+    std::uint64_t GetRevision() const { return m_revision; }
+    bool Empty() const { return m_positions.empty(); }
+
+    std::span<glm::aligned_vec3> Positions() { return m_positions; }
+    std::span<const glm::aligned_vec3> Positions() const { return m_positions; }
+    std::span<const glm::quat> Rotations() const { return m_rotations; }
+    std::span<glm::aligned_vec3> Scales() { return m_scales; }
+    std::span<const glm::aligned_vec3> Scales() const { return m_scales; }
+    std::span<float> Opacities() { return m_opacities; }
+    std::span<const float> Opacities() const { return m_opacities; }
+    std::span<std::uint8_t> Flags() { return m_flags; }
+    std::span<const std::uint8_t> Flags() const { return m_flags; }
+    std::span<glm::aligned_mat4> Models() { return m_models; }
+    std::span<const glm::aligned_mat4> Models() const { return m_models; }
+    std::span<const std::uint32_t> MeshIDs() const { return m_meshIDs; }
+    std::span<const std::uint32_t> TextureIDs() const { return m_textureIDs; }
+    std::span<const std::uint32_t> MaterialIDs() const { return m_materialIDs; }
+    std::span<const float> AnimationPhases() const { return m_animationPhases; }
+    // The depth of each Node below its root.
+    std::span<const std::uint32_t> Depths() const { return m_depths; }
+    // The index of a Node's parent, until a Node is removed, or std::nullopt if it has none.
+    std::optional<size_t> GetParent(size_t node) const
+    {
+        if (m_parents[node] == INVALID_SLOT) {
+            return std::nullopt;
+        }
+        return m_slots[m_parents[node]].m_node;
+    }
+
+    // The opacity of a Node at `time` seconds, animated or not.
+    float EvaluateOpacity(size_t node, float time) const
+    {
+        return (m_flags[node] & NodeFlags::ANIMATE) ? AnimatedOpacity(time + m_animationPhases[node]) : m_opacities[node];
+    }
+
+    // Nodes added or moved since the last ClearDirty(), each flagged with NodeFlags::TRANSFORM_DIRTY. Static Nodes only
+    // show up here once, so the per-Node caches only have to be refreshed for them. Their children only show up once
+    // UpdateHierarchy() propagated the flag to them.
+    std::span<const std::uint32_t> DirtyNodes() const { return m_dirtyNodes; }
+    void ClearDirty();
+    // Flags every Node as dirty and moves to a new revision, so that every per-Node cache is refreshed, e.g. once the store
+    // is swapped in for another one.
+    void MarkAllDirty();
+
+    // Refreshes the Models of the dirty Nodes without a parent in DirtyNodes()[begin, end). Disjoint ranges can be
+    // refreshed concurrently.
+    void UpdateModels(size_t begin, size_t end);
+    // Then flags the children of the dirty Nodes as dirty, and refreshes their Models, parents first.
+    void UpdateHierarchy();
+
+private:
+    static constexpr std::uint32_t INVALID_NODE = UINT32_MAX;
+    static constexpr std::uint32_t INVALID_SLOT = UINT32_MAX;
+
+    struct Slot {
+        // The index of the Node in the arrays, or INVALID_NODE if the slot is free.
+        std::uint32_t m_node;
+        std::uint32_t m_generation;
+    };
+
+    void MarkDirty(std::uint32_t node);
+    void BumpRevision();
+    // Moves every field of Node `from` into `to`, leaving `from` for removal.
+    void MoveNode(std::uint32_t from, std::uint32_t to);
+    // Removes a Node without children.
+    void RemoveLeaf(std::uint32_t node);
+    // Drops the removed Nodes from m_hierarchy and sorts it again, if it changed.
+    void SortHierarchy();
+    glm::aligned_mat4 GetLocalModel(std::uint32_t node) const;
+
+    // Hot data, touched every frame.
+    std::vector<glm::aligned_vec3> m_positions;
+    std::vector<glm::quat> m_rotations;
+    std::vector<glm::aligned_vec3> m_scales;
+    std::vector<float> m_opacities;
+    std::vector<std::uint8_t> m_flags;
+    std::vector<float> m_animationPhases;
+
+    // Cached from the transform and the parent's Model, refreshed for DirtyNodes().
+    std::vector<glm::aligned_mat4> m_models;
+
+    // The slot of each Node's parent, or INVALID_SLOT, which unlike its index doesn't change as Nodes are removed. Then
+    // its depth below its root, and its child count.
+    std::vector<std::uint32_t> m_parents;
+    std::vector<std::uint32_t> m_depths;
+    std::vector<std::uint32_t> m_childCounts;
+    // The Nodes with a parent, sorted by depth, and so parents first, once SortHierarchy() ran.
+    std::vector<NodeHandle> m_hierarchy;
+    bool m_hierarchyChanged {};
+
+    // Material data, only read when sorting and building the draw batches.
+    std::vector<std::uint32_t> m_meshIDs;
+    std::vector<std::uint32_t> m_textureIDs;
+    std::vector<std::uint32_t> m_materialIDs;
+
+    // The slot of each Node, and the free slots to reuse before adding new ones.
+    std::vector<std::uint32_t> m_nodeSlots;
+    std::vector<Slot> m_slots;
+    std::vector<std::uint32_t> m_freeSlots;
+
+    std::vector<std::uint32_t> m_dirtyNodes;
+    // The position of each dirty Node in m_dirtyNodes, so that removing one doesn't search for it.
+    std::vector<std::uint32_t> m_dirtyPositions;
+    std::uint64_t m_revision {};
+};
+
+} // namespace Glitter::Scene
@@ -0,0 +1,121 @@
+#include "scene/SceneGenerator.h"
+
+#include "Config.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Glitter::Scene {
+
+namespace {
+
+    // Evenly spread through the ball of `radius`, the cube root compensating for the volume growing with the radius.
+    glm::vec3 RandomInBall(Util::Pcg32& rng, float radius) { return rng.NextDirection() * radius * std::cbrt(rng.NextFloat()); }
+
+} // namespace
+
+NodeArrays GeneratedScene::GetArrays() const
+{
+    return NodeArrays {.m_positions = m_positions,
+        .m_rotations = m_rotations,
+        .m_scales = m_scales,
+        .m_opacities = m_opacities,
+        .m_flags = m_flags,
+        .m_animationPhases = m_animationPhases,
+        .m_parents = m_parents,
+        .m_meshIDs = m_meshIDs,
+        .m_textureIDs = m_textureIDs,
+        .m_materialIDs = m_materialIDs};
+}
+
+GeneratedScene GenerateNodes(
+    size_t count, size_t grainSize, std::uint64_t seed, Core::JobSystem& jobSystem, const NodeGenerator& generator)
+{
+    // Sized once, each job writing its own range in place.
+    GeneratedScene nodes {};
+    nodes.m_positions.resize(count);
+    nodes.m_rotations.resize(count);
+    nodes.m_scales.resize(count);
+    nodes.m_opacities.resize(count);
+    nodes.m_flags.resize(count);
+    nodes.m_animationPhases.resize(count);
+    nodes.m_parents.assign(count, NodeArrays::NO_PARENT);
+    nodes.m_meshIDs.resize(count);
+    nodes.m_textureIDs.resize(count);
+    nodes.m_materialIDs.resize(count);
+
+    jobSystem.ParallelFor(count, grainSize, [&](size_t begin, size_t end) {
+        Util::Pcg32 rng(seed, begin / grainSize);
+        for (size_t nodeIdx = begin; nodeIdx < end; nodeIdx++) {
+            NodeDesc desc = generator(nodeIdx, rng);
+            nodes.m_positions[nodeIdx] = desc.m_position;
+            nodes.m_rotations[nodeIdx] = desc.m_rotation;
+            nodes.m_scales[nodeIdx] = desc.m_scale;
+            nodes.m_opacities[nodeIdx] = desc.m_opacity;
+            nodes.m_flags[nodeIdx] = desc.m_shouldAnimate ? NodeFlags::ANIMATE : 0;
+            nodes.m_animationPhases[nodeIdx] = desc.m_animationPhase;
+            nodes.m_meshIDs[nodeIdx] = static_cast<std::uint32_t>(desc.m_meshID);
+            nodes.m_textureIDs[nodeIdx] = static_cast<std::uint32_t>(desc.m_textureID);
+            nodes.m_materialIDs[nodeIdx] = static_cast<std::uint32_t>(desc.m_materialID);
+        }
+    });
+    return nodes;
+}
+
+GeneratedScene GenerateScene(const SceneGeneratorSettings& settings, std::span<const std::uint32_t> meshMaterialIDs,
+    size_t textureCount, size_t materialCount, Core::JobSystem& jobSystem)
+{
+    if (meshMaterialIDs.empty() || textureCount == 0) {
+        return {};
+    }
+
+    auto meshCount = static_cast<std::uint32_t>(std::clamp<size_t>(settings.m_meshCount, 1, meshMaterialIDs.size()));
+    auto textures = static_cast<std::uint32_t>(std::clamp<size_t>(settings.m_textureCount, 1, textureCount));
+    auto materials = static_cast<std::uint32_t>(std::clamp<size_t>(settings.m_materialCount, 1, std::max<size_t>(materialCount, 1)));
+
+    // The clusters are drawn from a stream of their own, past the Nodes' ones.
+    std::vector<glm::vec3> clusters {};
+    if (settings.m_distribution == SceneDistribution::Clustered) {
+        Util::Pcg32 rng(settings.m_seed, UINT32_MAX);
+        for (size_t clusterIdx = 0; clusterIdx < std::max<size_t>(settings.m_clusterCount, 1); clusterIdx++) {
+            clusters.push_back(RandomInBall(rng, settings.m_radius));
+        }
+    }
+
+    return GenerateNodes(settings.m_nodeCount, Config::SPAWN_GRAIN_SIZE, settings.m_seed, jobSystem,
+        [&](size_t /*nodeIdx*/, Util::Pcg32& rng) {
+            glm::vec3 position {};
+            switch (settings.m_distribution) {
+            case SceneDistribution::Uniform:
+                position = RandomInBall(rng, settings.m_radius);
+                break;
+            case SceneDistribution::Clustered:
+                position = clusters[rng.NextBelow(static_cast<std::uint32_t>(clusters.size()))]
+                    + RandomInBall(rng, settings.m_clusterRadius);
+                break;
+            case SceneDistribution::Shell:
+                position = rng.NextDirection() * settings.m_radius;
+                break;
+            }
+            glm::quat rotation = glm::angleAxis(rng.NextFloat() * glm::two_pi<float>(), rng.NextDirection());
+
+            // The translucent Nodes are sorted and blended, the animated ones re-evaluated every frame and left unbatched.
+            float opacity = rng.NextFloat() < settings.m_transparentRatio ? rng.NextFloat(0.25f, 0.75f) : 1.0f;
+            bool animate = rng.NextFloat() < settings.m_animatedRatio;
+
+            std::uint32_t meshID = rng.NextBelow(meshCount);
+            std::uint32_t textureID = rng.NextBelow(textures);
+            std::uint32_t materialID = settings.m_materialCount == 0 ? meshMaterialIDs[meshID] : rng.NextBelow(materials);
+            return NodeDesc {.m_position = position,
+                .m_rotation = rotation,
+                .m_scale = glm::vec3(0.25f),
+                .m_meshID = meshID,
+                .m_textureID = textureID,
+                .m_materialID = materialID,
+                .m_opacity = opacity,
+                .m_shouldAnimate = animate,
+                .m_animationPhase = 0.0f};
+        });
+}
+
+} // namespace Glitter::Scene
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "core/JobSystem.h"
+#include "scene/NodeStore.h"
+#include "util/Random.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace Glitter::Scene {
+
+enum class SceneDistribution : std::uint8_t {
+    // Spread evenly through a ball.
+    Uniform,
+    // Gathered in m_clusterCount dense clusters spread through the ball.
+    Clustered,
+    // On the ball's surface, leaving its inside empty.
+    Shell,
+};
+
+// What a generated stress scene looks like. Each cardinality is capped by how many of each there are, and at least 1.
+struct SceneGeneratorSettings {
+    size_t m_nodeCount;
+    size_t m_meshCount;
+    size_t m_textureCount;
+    // 0 keeps the material of each Node's Mesh.
+    size_t m_materialCount;
+    SceneDistribution m_distribution;
+    float m_radius;
+    size_t m_clusterCount;
+    // How far from its cluster's center a Node may lie.
+    float m_clusterRadius;
+    // The fractions of the Nodes drawn translucent, and animated.
+    float m_transparentRatio;
+    float m_animatedRatio;
+    std::uint32_t m_seed;
+};
+
+// The arrays of generated Nodes, every one a root, ready for NodeStore::Append().
+struct GeneratedScene {
+    std::vector<glm::vec3> m_positions;
+    std::vector<glm::quat> m_rotations;
+    std::vector<glm::vec3> m_scales;
+    std::vector<float> m_opacities;
+    std::vector<std::uint8_t> m_flags;
+    std::vector<float> m_animationPhases;
+    std::vector<std::uint32_t> m_parents;
+    std::vector<std::uint32_t> m_meshIDs;
+    std::vector<std::uint32_t> m_textureIDs;
+    std::vector<std::uint32_t> m_materialIDs;
+
+    NodeArrays GetArrays() const;
+};
+
+// Returns the `nodeIdx`-th of the generated Nodes, drawing from `rng`. Its parent is ignored.
+using NodeGenerator = std::function<NodeDesc(size_t nodeIdx, Util::Pcg32& rng)>;
+
+// Generates `count` Nodes on the job system, each range of `grainSize` Nodes from its own stream of `seed`, so that the
+// same seed generates the same Nodes whatever thread runs each range.
+GeneratedScene GenerateNodes(
+    size_t count, size_t grainSize, std::uint64_t seed, Core::JobSystem& jobSystem, const NodeGenerator& generator);
+
+// Generates the Nodes of `settings`, the same ones for the same settings. They draw the first m_meshCount of the Meshes
+// whose materials are `meshMaterialIDs`, and the first m_textureCount of `textureCount` textures and m_materialCount of
+// `materialCount` materials, each picked at random.
+GeneratedScene GenerateScene(const SceneGeneratorSettings& settings, std::span<const std::uint32_t> meshMaterialIDs,
+    size_t textureCount, size_t materialCount, Core::JobSystem& jobSystem);
+
+} // namespace Glitter::Scene
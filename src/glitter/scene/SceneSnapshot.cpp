@@ -0,0 +1,230 @@
+#include "scene/SceneSnapshot.h"
+
+#include "util/File.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Glitter::Scene {
+
+namespace {
+
+    // Bump whenever the layout below or the arrays of SceneSnapshot change.
+    constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+    constexpr std::array<char, 4> SNAPSHOT_MAGIC {'G', 'L', 'S', 'N'};
+    constexpr size_t SECTION_ALIGNMENT = 16;
+
+    // Followed by a SnapshotAssetEntry per asset, the asset paths, the SnapshotMeshes, then each per-Node array whole, in
+    // the order of SceneSnapshot.
+    struct SnapshotHeader {
+        std::array<char, 4> m_magic;
+        std::uint32_t m_version;
+        std::uint32_t m_assetCount;
+        std::uint32_t m_meshCount;
+        std::uint32_t m_nodeCount;
+    };
+
+    // Offsets are in bytes from the start of the file.
+    struct SnapshotAssetEntry {
+        std::uint64_t m_pathOffset;
+        std::uint32_t m_pathLength;
+        std::uint32_t m_padding;
+    };
+
+    size_t AlignSection(size_t offset) { return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1); }
+
+    // Copies `count` elements at `offset` of `file` into `out`, failing if they're out of bounds.
+    template <typename T> bool ReadSection(std::span<const std::byte> file, std::uint64_t offset, std::uint64_t count, T* out)
+    {
+        if (offset > file.size() || count > (file.size() - offset) / sizeof(T)) {
+            return false;
+        }
+
+        if (count > 0) {
+            std::memcpy(out, file.data() + offset, sizeof(T) * count);
+        }
+        return true;
+    }
+
+    // Calls `visit` with each per-Node array of `snapshot`, in file order.
+    template <typename Snapshot, typename Visit> void ForEachNodeArray(Snapshot& snapshot, Visit&& visit)
+    {
+        visit(snapshot.m_positions);
+        visit(snapshot.m_rotations);
+        visit(snapshot.m_scales);
+        visit(snapshot.m_opacities);
+        visit(snapshot.m_flags);
+        visit(snapshot.m_animationPhases);
+        visit(snapshot.m_parents);
+        visit(snapshot.m_meshIDs);
+        visit(snapshot.m_textureIDs);
+    }
+
+} // namespace
+
+SceneSnapshot CaptureSceneSnapshot(
+    const NodeStore& store, std::span<const std::string> assetPaths, std::span<const SnapshotMesh> meshes)
+{
+    SceneSnapshot snapshot {.m_assetPaths = {assetPaths.begin(), assetPaths.end()},
+        .m_meshes = {meshes.begin(), meshes.end()},
+        .m_positions = {},
+        .m_rotations = {},
+        .m_scales = {},
+        .m_opacities = {},
+        .m_flags = {},
+        .m_animationPhases = {},
+        .m_parents = {},
+        .m_meshIDs = {},
+        .m_textureIDs = {}};
+
+    // Parents first, by a counting sort of the Nodes by depth.
+    std::span<const std::uint32_t> depths = store.Depths();
+    std::vector<std::uint32_t> depthStarts {};
+    for (std::uint32_t depth : depths) {
+        if (depth + 2 > depthStarts.size()) {
+            depthStarts.resize(depth + 2);
+        }
+        depthStarts[depth + 1]++;
+    }
+    for (size_t depth = 1; depth < depthStarts.size(); depth++) {
+        depthStarts[depth] += depthStarts[depth - 1];
+    }
+    std::vector<std::uint32_t> order(store.Size());
+    for (size_t node = 0; node < store.Size(); node++) {
+        order[depthStarts[depths[node]]++] = static_cast<std::uint32_t>(node);
+    }
+
+    std::span<const std::uint8_t> flags = store.Flags();
+    std::span<const std::uint32_t> meshIDs = store.MeshIDs();
+    std::vector<std::uint32_t> snapshotIndices(store.Size(), NodeArrays::NO_PARENT);
+    for (std::uint32_t node : order) {
+        std::optional<size_t> parent = store.GetParent(node);
+        std::uint32_t snapshotParent = parent ? snapshotIndices[*parent] : NodeArrays::NO_PARENT;
+        if ((flags[node] & NodeFlags::SIMULATED) != 0 || meshIDs[node] >= meshes.size()
+            || meshes[meshIDs[node]].m_asset == NO_SNAPSHOT_ASSET || (parent && snapshotParent == NodeArrays::NO_PARENT)) {
+            continue;
+        }
+
+        snapshotIndices[node] = static_cast<std::uint32_t>(snapshot.m_positions.size());
+        snapshot.m_positions.push_back(store.Positions()[node]);
+        snapshot.m_rotations.push_back(store.Rotations()[node]);
+        snapshot.m_scales.push_back(store.Scales()[node]);
+        snapshot.m_opacities.push_back(store.Opacities()[node]);
+        snapshot.m_flags.push_back(static_cast<std::uint8_t>(flags[node] & NodeFlags::ANIMATE));
+        snapshot.m_animationPhases.push_back(store.AnimationPhases()[node]);
+        snapshot.m_parents.push_back(snapshotParent);
+        snapshot.m_meshIDs.push_back(meshIDs[node]);
+        snapshot.m_textureIDs.push_back(store.TextureIDs()[node]);
+    }
+    return snapshot;
+}
+
+bool WriteSceneSnapshot(const char* snapshotPath, const SceneSnapshot& snapshot)
+{
+    size_t assetsOffset = AlignSection(sizeof(SnapshotHeader));
+    size_t offset = assetsOffset + sizeof(SnapshotAssetEntry) * snapshot.m_assetPaths.size();
+    std::vector<SnapshotAssetEntry> assets {};
+    for (const std::string& path : snapshot.m_assetPaths) {
+        assets.push_back(SnapshotAssetEntry {
+            .m_pathOffset = offset, .m_pathLength = static_cast<std::uint32_t>(path.size()), .m_padding = 0});
+        offset += path.size();
+    }
+    size_t meshesOffset = AlignSection(offset);
+    offset = meshesOffset + sizeof(SnapshotMesh) * snapshot.m_meshes.size();
+    std::vector<size_t> arrayOffsets {};
+    ForEachNodeArray(snapshot, [&](const auto& array) {
+        arrayOffsets.push_back(AlignSection(offset));
+        offset = arrayOffsets.back() + sizeof(array[0]) * array.size();
+    });
+
+    SnapshotHeader header {.m_magic = SNAPSHOT_MAGIC,
+        .m_version = SNAPSHOT_VERSION,
+        .m_assetCount = static_cast<std::uint32_t>(snapshot.m_assetPaths.size()),
+        .m_meshCount = static_cast<std::uint32_t>(snapshot.m_meshes.size()),
+        .m_nodeCount = static_cast<std::uint32_t>(snapshot.m_positions.size())};
+
+    std::vector<std::byte> file(offset);
+    auto writeSection = [&](size_t sectionOffset, const void* data, size_t size) {
+        if (size > 0) {
+            std::memcpy(file.data() + sectionOffset, data, size);
+        }
+    };
+    writeSection(0, &header, sizeof(header));
+    writeSection(assetsOffset, assets.data(), sizeof(SnapshotAssetEntry) * assets.size());
+    for (size_t assetIdx = 0; assetIdx < assets.size(); assetIdx++) {
+        writeSection(assets[assetIdx].m_pathOffset, snapshot.m_assetPaths[assetIdx].data(), assets[assetIdx].m_pathLength);
+    }
+    writeSection(meshesOffset, snapshot.m_meshes.data(), sizeof(SnapshotMesh) * snapshot.m_meshes.size());
+    size_t arrayIdx = 0;
+    ForEachNodeArray(snapshot, [&](const auto& array) {
+        writeSection(arrayOffsets[arrayIdx++], array.data(), sizeof(array[0]) * array.size());
+    });
+
+    std::error_code error {};
+    std::filesystem::create_directories(std::filesystem::path(snapshotPath).parent_path(), error);
+    std::ofstream outputStream(snapshotPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    outputStream.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    return static_cast<bool>(outputStream);
+}
+
+std::optional<SceneSnapshot> ReadSceneSnapshot(const char* snapshotPath)
+{
+    std::optional<std::vector<std::byte>> contents = Util::ReadBinaryFile(snapshotPath);
+    if (!contents) {
+        spdlog::error("Failed to read the scene snapshot {}.", snapshotPath);
+        return std::nullopt;
+    }
+    std::span<const std::byte> file = *contents;
+
+    SnapshotHeader header {};
+    if (!ReadSection(file, 0, 1, &header) || header.m_magic != SNAPSHOT_MAGIC || header.m_version != SNAPSHOT_VERSION) {
+        spdlog::error("The scene snapshot {} is from another format version, or isn't a snapshot.", snapshotPath);
+        return std::nullopt;
+    }
+
+    SceneSnapshot snapshot {};
+    size_t assetsOffset = AlignSection(sizeof(SnapshotHeader));
+    std::vector<SnapshotAssetEntry> assets(header.m_assetCount);
+    bool valid = ReadSection(file, assetsOffset, assets.size(), assets.data());
+    size_t offset = assetsOffset + sizeof(SnapshotAssetEntry) * assets.size();
+    for (size_t assetIdx = 0; valid && assetIdx < assets.size(); assetIdx++) {
+        std::string& path = snapshot.m_assetPaths.emplace_back(assets[assetIdx].m_pathLength, '\0');
+        valid = ReadSection(file, assets[assetIdx].m_pathOffset, assets[assetIdx].m_pathLength, path.data());
+        offset += assets[assetIdx].m_pathLength;
+    }
+
+    size_t meshesOffset = AlignSection(offset);
+    snapshot.m_meshes.resize(header.m_meshCount);
+    valid = valid && ReadSection(file, meshesOffset, snapshot.m_meshes.size(), snapshot.m_meshes.data());
+    offset = meshesOffset + sizeof(SnapshotMesh) * snapshot.m_meshes.size();
+
+    // Each per-Node array is only sized once the file is known to hold it.
+    size_t nodeCount = header.m_nodeCount;
+    ForEachNodeArray(snapshot, [&](auto& array) {
+        offset = AlignSection(offset);
+        if (!valid || offset > file.size() || nodeCount > (file.size() - offset) / sizeof(array[0])) {
+            valid = false;
+            return;
+        }
+        array.resize(nodeCount);
+        ReadSection(file, offset, nodeCount, array.data());
+        offset += sizeof(array[0]) * nodeCount;
+    });
+    if (!valid) {
+        spdlog::error("The scene snapshot {} is truncated.", snapshotPath);
+        return std::nullopt;
+    }
+
+    for (std::uint32_t meshID : snapshot.m_meshIDs) {
+        if (meshID >= snapshot.m_meshes.size() || snapshot.m_meshes[meshID].m_asset >= snapshot.m_assetPaths.size()) {
+            spdlog::error("The scene snapshot {} refers to missing Meshes.", snapshotPath);
+            return std::nullopt;
+        }
+    }
+    return snapshot;
+}
+
+} // namespace Glitter::Scene
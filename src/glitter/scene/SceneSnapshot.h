@@ -0,0 +1,51 @@
+#pragma once
+
+#include "scene/NodeStore.h"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Glitter::Scene {
+
+// Stands for a Mesh that can't be saved, not registered from an asset, in SnapshotMesh::m_asset.
+constexpr std::uint32_t NO_SNAPSHOT_ASSET = UINT32_MAX;
+
+// A Mesh of a scene snapshot: the m_mesh-th Mesh of the asset at SceneSnapshot::m_assetPaths[m_asset].
+struct SnapshotMesh {
+    std::uint32_t m_asset;
+    std::uint32_t m_mesh;
+};
+
+// The Nodes of a scene as arrays matching the NodeStore's, parents first, so that they're saved and loaded in bulk. Their
+// Meshes are referred to by index into m_meshes, their textures by index into the loaded textures.
+struct SceneSnapshot {
+    std::vector<std::string> m_assetPaths;
+    std::vector<SnapshotMesh> m_meshes;
+
+    std::vector<glm::vec3> m_positions;
+    std::vector<glm::quat> m_rotations;
+    std::vector<glm::vec3> m_scales;
+    std::vector<float> m_opacities;
+    std::vector<std::uint8_t> m_flags;
+    std::vector<float> m_animationPhases;
+    // The index of an earlier Node, or NodeArrays::NO_PARENT.
+    std::vector<std::uint32_t> m_parents;
+    std::vector<std::uint32_t> m_meshIDs;
+    std::vector<std::uint32_t> m_textureIDs;
+};
+
+// Gathers the Nodes of `store` whose Mesh ID is in `meshes` into a snapshot referring to `assetPaths`. The simulated
+// Nodes, and the ones whose Mesh has no asset, are left out along with their descendants.
+SceneSnapshot CaptureSceneSnapshot(
+    const NodeStore& store, std::span<const std::string> assetPaths, std::span<const SnapshotMesh> meshes);
+
+// Returns false if the snapshot can't be written.
+bool WriteSceneSnapshot(const char* snapshotPath, const SceneSnapshot& snapshot);
+// Reads the snapshot in a single read, each array copied out of it whole. Returns std::nullopt, after logging why, if the
+// file is missing, from another format version or truncated.
+std::optional<SceneSnapshot> ReadSceneSnapshot(const char* snapshotPath);
+
+} // namespace Glitter::Scene
@@ -0,0 +1,93 @@
+#include "scene/Skeletons.h"
+
+#include "Config.h"
+
+namespace Glitter::Scene {
+
+namespace {
+
+    glm::mat4 ComposeTransform(const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale)
+    {
+        return glm::scale(glm::translate(glm::mat4(1.0f), translation) * glm::mat4_cast(rotation), scale);
+    }
+
+} // namespace
+
+std::uint32_t Skeletons::Add(std::span<const GltfJoint> joints, std::span<const GltfSkinJoint> skinJoints)
+{
+    Instance instance {.m_firstJoint = static_cast<std::uint32_t>(m_parents.size()),
+        .m_jointCount = static_cast<std::uint32_t>(joints.size()),
+        .m_firstPaletteEntry = static_cast<std::uint32_t>(m_paletteJoints.size()),
+        .m_paletteSize = static_cast<std::uint32_t>(skinJoints.size())};
+    for (const GltfJoint& joint : joints) {
+        m_parents.push_back(joint.m_parent == GLTF_NO_PARENT ? NO_PARENT : instance.m_firstJoint + joint.m_parent);
+        m_locals.push_back(ComposeTransform(joint.m_translation, joint.m_rotation, joint.m_scale));
+        m_worlds.emplace_back(1.0f);
+    }
+    for (const GltfSkinJoint& skinJoint : skinJoints) {
+        m_paletteJoints.push_back(instance.m_firstJoint + skinJoint.m_joint);
+        m_inverseBinds.push_back(skinJoint.m_inverseBind);
+    }
+    ComposeInstance(instance);
+
+    m_instances.push_back(instance);
+    m_live.push_back(1);
+    m_liveInstanceCount++;
+    return static_cast<std::uint32_t>(m_instances.size() - 1);
+}
+
+void Skeletons::Remove(std::uint32_t instance)
+{
+    if (instance < m_live.size() && m_live[instance] != 0) {
+        m_live[instance] = 0;
+        m_liveInstanceCount--;
+    }
+}
+
+void Skeletons::Clear()
+{
+    m_instances.clear();
+    m_live.clear();
+    m_liveInstanceCount = 0;
+    m_parents.clear();
+    m_locals.clear();
+    m_worlds.clear();
+    m_paletteJoints.clear();
+    m_inverseBinds.clear();
+}
+
+void Skeletons::SetLocal(std::uint32_t joint, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale)
+{
+    m_locals[joint] = ComposeTransform(translation, rotation, scale);
+}
+
+void Skeletons::ComputeSkinning(Core::JobSystem& jobs, std::vector<glm::mat4>& palette)
+{
+    palette.resize(m_paletteJoints.size());
+    if (m_liveInstanceCount == 0) {
+        return;
+    }
+
+    // The joints of an instance are composed parents first, the instances are independent of each other.
+    jobs.ParallelFor(m_instances.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t instanceIdx = begin; instanceIdx < end; instanceIdx++) {
+            if (m_live[instanceIdx] != 0) {
+                ComposeInstance(m_instances[instanceIdx]);
+            }
+        }
+    });
+    jobs.ParallelFor(m_paletteJoints.size(), Config::SKINNING_GRAIN_SIZE, [&](size_t begin, size_t end) {
+        for (size_t entryIdx = begin; entryIdx < end; entryIdx++) {
+            palette[entryIdx] = GetSkinning(static_cast<std::uint32_t>(entryIdx));
+        }
+    });
+}
+
+void Skeletons::ComposeInstance(const Instance& instance)
+{
+    for (std::uint32_t joint = instance.m_firstJoint; joint < instance.m_firstJoint + instance.m_jointCount; joint++) {
+        m_worlds[joint] = m_parents[joint] == NO_PARENT ? m_locals[joint] : m_worlds[m_parents[joint]] * m_locals[joint];
+    }
+}
+
+} // namespace Glitter::Scene
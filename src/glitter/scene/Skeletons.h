@@ -0,0 +1,72 @@
+#pragma once
+
+#include "core/JobSystem.h"
+#include "scene/GltfImporter.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Glitter::Scene {
+
+// The joints of the loaded glTF assets, and the skinning matrices the skinned Meshes are deformed by. Each asset adds an
+// instance of its GltfAsset::m_joints and m_skinJoints, whose joints are set by the AnimationPlayer in their parents'
+// space, and composed into the scene's on the job system. The matrices of every instance are computed into one palette,
+// indexed by the instance's first palette entry plus the index of its GltfSkinJoint.
+//
+// Instances are only ever appended, a removed one is skipped from then on, so that the indices stay valid for the frames
+// in flight.
+class Skeletons {
+public:
+    // Stands for no parent in the joints' parents.
+    static constexpr std::uint32_t NO_PARENT = UINT32_MAX;
+
+    struct Instance {
+        std::uint32_t m_firstJoint;
+        std::uint32_t m_jointCount;
+        std::uint32_t m_firstPaletteEntry;
+        std::uint32_t m_paletteSize;
+    };
+
+    // Adds the joints of an asset at their rest pose, returning the index of their instance.
+    std::uint32_t Add(std::span<const GltfJoint> joints, std::span<const GltfSkinJoint> skinJoints);
+    // The instance's palette entries are no longer drawn.
+    void Remove(std::uint32_t instance);
+    void Clear();
+
+    // Sets the transform of `joint`, an index past an Instance's m_firstJoint, relative to its parent.
+    void SetLocal(std::uint32_t joint, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale);
+
+    // Composes the joints of every instance still in use, then writes the skinning matrix of each palette entry into
+    // `palette`, from the space of the skinned Mesh into the scene's.
+    void ComputeSkinning(Core::JobSystem& jobs, std::vector<glm::mat4>& palette);
+    // The skinning matrix of a palette entry as of the last ComputeSkinning(), or as added.
+    glm::mat4 GetSkinning(std::uint32_t paletteEntry) const
+    {
+        return m_worlds[m_paletteJoints[paletteEntry]] * m_inverseBinds[paletteEntry];
+    }
+
+    const Instance& GetInstance(std::uint32_t instance) const { return m_instances[instance]; }
+    size_t GetInstanceCount() const { return m_instances.size(); }
+    size_t GetLiveInstanceCount() const { return m_liveInstanceCount; }
+    size_t GetPaletteSize() const { return m_paletteJoints.size(); }
+
+private:
+    void ComposeInstance(const Instance& instance);
+
+    std::vector<Instance> m_instances;
+    std::vector<std::uint8_t> m_live;
+    size_t m_liveInstanceCount {};
+
+    // Per joint, parents first within each instance, with the parents' indices as absolute as the joints'.
+    std::vector<std::uint32_t> m_parents;
+    std::vector<glm::mat4> m_locals;
+    std::vector<glm::mat4> m_worlds;
+
+    // Per palette entry.
+    std::vector<std::uint32_t> m_paletteJoints;
+    std::vector<glm::mat4> m_inverseBinds;
+};
+
+} // namespace Glitter::Scene
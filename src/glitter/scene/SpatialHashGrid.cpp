@@ -0,0 +1,258 @@
+#include "scene/SpatialHashGrid.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace Glitter::Scene {
+
+namespace {
+
+    // Cells are clamped this far from the origin, so that far-off positions still convert to integers.
+    constexpr float CELL_LIMIT = static_cast<float>(1 << 30);
+
+    bool Overlaps(const glm::vec3& centerA, const glm::vec3& extentA, const glm::vec3& centerB, const glm::vec3& extentB)
+    {
+        glm::vec3 distance = glm::abs(centerA - centerB);
+        glm::vec3 reach = extentA + extentB;
+        return distance.x <= reach.x && distance.y <= reach.y && distance.z <= reach.z;
+    }
+
+} // namespace
+
+SpatialHashGrid::SpatialHashGrid(float cellSize)
+    : m_cellSize(cellSize)
+    , m_invCellSize(1.0f / cellSize)
+    , m_buckets(MIN_BUCKET_COUNT)
+{
+}
+
+void SpatialHashGrid::Update(const Render::CullBounds& bounds, std::span<const std::uint32_t> items)
+{
+    for (size_t item = bounds.Size(); item < m_entries.size(); item++) {
+        Unfile(static_cast<std::uint32_t>(item));
+    }
+    m_entries.resize(bounds.Size(), Entry {.m_cell = {}, .m_bucket = NO_BUCKET, .m_position = 0});
+
+    for (std::uint32_t item : items) {
+        File(bounds, item);
+    }
+
+    // Keep about two items per bucket.
+    while (m_filedCount > m_buckets.size() * 2) {
+        Grow();
+    }
+}
+
+void SpatialHashGrid::Clear()
+{
+    for (std::vector<Filed>& bucket : m_buckets) {
+        bucket.clear();
+    }
+    m_largeItems.clear();
+    m_entries.clear();
+    m_filedCount = 0;
+}
+
+glm::ivec3 SpatialHashGrid::GetCell(const glm::vec3& position) const
+{
+    return glm::ivec3(glm::clamp(glm::floor(position * m_invCellSize), glm::vec3(-CELL_LIMIT), glm::vec3(CELL_LIMIT)));
+}
+
+std::uint32_t SpatialHashGrid::GetBucket(const glm::ivec3& cell) const
+{
+    // Teschner et al.'s "Optimized Spatial Hashing for Collision Detection of Deformable Objects".
+    auto hash = (static_cast<std::uint32_t>(cell.x) * 73'856'093u) ^ (static_cast<std::uint32_t>(cell.y) * 19'349'663u)
+        ^ (static_cast<std::uint32_t>(cell.z) * 83'492'791u);
+    return hash & static_cast<std::uint32_t>(m_buckets.size() - 1);
+}
+
+void SpatialHashGrid::File(const Render::CullBounds& bounds, std::uint32_t item)
+{
+    glm::vec3 extent = bounds.GetExtent(item);
+    bool large = std::max({extent.x, extent.y, extent.z}) > m_cellSize * 0.5f;
+    glm::ivec3 cell = GetCell(bounds.GetCenter(item));
+
+    // Most moves stay within the cell.
+    Entry& entry = m_entries[item];
+    if (large ? entry.m_bucket == LARGE_BUCKET : (entry.m_bucket < NO_BUCKET && entry.m_cell == cell)) {
+        return;
+    }
+
+    Unfile(item);
+    if (large) {
+        entry = Entry {.m_cell = cell, .m_bucket = LARGE_BUCKET, .m_position = static_cast<std::uint32_t>(m_largeItems.size())};
+        m_largeItems.push_back(item);
+        return;
+    }
+
+    std::uint32_t bucket = GetBucket(cell);
+    entry = Entry {.m_cell = cell, .m_bucket = bucket, .m_position = static_cast<std::uint32_t>(m_buckets[bucket].size())};
+    m_buckets[bucket].push_back(Filed {.m_cell = cell, .m_item = item});
+    m_filedCount++;
+}
+
+void SpatialHashGrid::Unfile(std::uint32_t item)
+{
+    Entry& entry = m_entries[item];
+    if (entry.m_bucket == NO_BUCKET) {
+        return;
+    }
+
+    // Fill its place with the last item of the same list.
+    if (entry.m_bucket == LARGE_BUCKET) {
+        std::uint32_t last = m_largeItems.back();
+        m_largeItems[entry.m_position] = last;
+        m_entries[last].m_position = entry.m_position;
+        m_largeItems.pop_back();
+    } else {
+        std::vector<Filed>& bucket = m_buckets[entry.m_bucket];
+        bucket[entry.m_position] = bucket.back();
+        m_entries[bucket[entry.m_position].m_item].m_position = entry.m_position;
+        bucket.pop_back();
+        m_filedCount--;
+    }
+    entry.m_bucket = NO_BUCKET;
+}
+
+void SpatialHashGrid::Grow()
+{
+    std::vector<std::vector<Filed>> buckets(m_buckets.size() * 2);
+    m_buckets.swap(buckets);
+    for (const std::vector<Filed>& bucket : buckets) {
+        for (const Filed& filed : bucket) {
+            std::uint32_t newBucket = GetBucket(filed.m_cell);
+            Entry& entry = m_entries[filed.m_item];
+            entry.m_bucket = newBucket;
+            entry.m_position = static_cast<std::uint32_t>(m_buckets[newBucket].size());
+            m_buckets[newBucket].push_back(filed);
+        }
+    }
+}
+
+void SpatialHashGrid::GatherCell(const glm::ivec3& cell, std::vector<std::uint32_t>& items) const
+{
+    for (const Filed& filed : m_buckets[GetBucket(cell)]) {
+        if (filed.m_cell == cell) {
+            items.push_back(filed.m_item);
+        }
+    }
+}
+
+void SpatialHashGrid::GatherCandidates(const glm::vec3& min, const glm::vec3& max, std::vector<std::uint32_t>& items) const
+{
+    items.insert(items.end(), m_largeItems.begin(), m_largeItems.end());
+
+    glm::ivec3 minCell = GetCell(min - m_cellSize * 0.5f);
+    glm::ivec3 maxCell = GetCell(max + m_cellSize * 0.5f);
+    glm::i64vec3 span = glm::i64vec3(maxCell) - glm::i64vec3(minCell) + glm::i64vec3(1);
+
+    // Covering more cells than there are buckets, every bucket is visited once instead.
+    if (span.x * span.y * span.z > static_cast<std::int64_t>(m_buckets.size())) {
+        for (const std::vector<Filed>& bucket : m_buckets) {
+            for (const Filed& filed : bucket) {
+                if (glm::all(glm::greaterThanEqual(filed.m_cell, minCell)) && glm::all(glm::lessThanEqual(filed.m_cell, maxCell))) {
+                    items.push_back(filed.m_item);
+                }
+            }
+        }
+        return;
+    }
+
+    for (int z = minCell.z; z <= maxCell.z; z++) {
+        for (int y = minCell.y; y <= maxCell.y; y++) {
+            for (int x = minCell.x; x <= maxCell.x; x++) {
+                GatherCell(glm::ivec3(x, y, z), items);
+            }
+        }
+    }
+}
+
+void SpatialHashGrid::QueryBox(
+    const Render::CullBounds& bounds, const glm::vec3& center, const glm::vec3& extent, std::vector<std::uint32_t>& items) const
+{
+    size_t first = items.size();
+    GatherCandidates(center - extent, center + extent, items);
+    auto outside = std::remove_if(items.begin() + static_cast<std::ptrdiff_t>(first), items.end(),
+        [&](std::uint32_t item) { return !Overlaps(bounds.GetCenter(item), bounds.GetExtent(item), center, extent); });
+    items.erase(outside, items.end());
+}
+
+void SpatialHashGrid::QuerySphere(
+    const Render::CullBounds& bounds, const glm::vec3& center, float radius, std::vector<std::uint32_t>& items) const
+{
+    size_t first = items.size();
+    GatherCandidates(center - radius, center + radius, items);
+    auto outside = std::remove_if(items.begin() + static_cast<std::ptrdiff_t>(first), items.end(), [&](std::uint32_t item) {
+        // The distance from the center to the closest point of the AABB.
+        glm::vec3 distance = glm::max(glm::abs(center - bounds.GetCenter(item)) - bounds.GetExtent(item), 0.0f);
+        return glm::dot(distance, distance) > radius * radius;
+    });
+    items.erase(outside, items.end());
+}
+
+std::optional<RayHit> SpatialHashGrid::Raycast(
+    const Render::CullBounds& bounds, const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const
+{
+    std::optional<RayHit> hit {};
+    glm::vec3 invDirection = 1.0f / direction;
+    auto test = [&](std::uint32_t item) {
+        glm::vec3 center = bounds.GetCenter(item);
+        glm::vec3 extent = bounds.GetExtent(item);
+        glm::vec3 t0 = (center - extent - origin) * invDirection;
+        glm::vec3 t1 = (center + extent - origin) * invDirection;
+        glm::vec3 tMin = glm::min(t0, t1);
+        glm::vec3 tMax = glm::max(t0, t1);
+        float tEnter = std::max({tMin.x, tMin.y, tMin.z, 0.0f});
+        float tExit = std::min({tMax.x, tMax.y, tMax.z, hit ? hit->m_distance : maxDistance});
+        if (tEnter <= tExit && (!hit || tEnter < hit->m_distance)) {
+            hit = RayHit {.m_item = item, .m_distance = tEnter};
+        }
+    };
+
+    for (std::uint32_t item : m_largeItems) {
+        test(item);
+    }
+
+    // Walk the cells along the ray, as in Amanatides and Woo's "A Fast Voxel Traversal Algorithm for Ray Tracing". An item
+    // the ray enters at `t` is filed under a neighbour of the cell the ray is in at `t`, so once a cell is entered past the
+    // nearest hit, no later cell can hold a nearer one.
+    glm::ivec3 cell = GetCell(origin);
+    glm::ivec3 step {};
+    glm::vec3 tNext {std::numeric_limits<float>::infinity()};
+    glm::vec3 tDelta {std::numeric_limits<float>::infinity()};
+    for (int axis = 0; axis < 3; axis++) {
+        if (direction[axis] > 0.0f) {
+            step[axis] = 1;
+            tNext[axis] = (static_cast<float>(cell[axis] + 1) * m_cellSize - origin[axis]) * invDirection[axis];
+            tDelta[axis] = m_cellSize * invDirection[axis];
+        } else if (direction[axis] < 0.0f) {
+            step[axis] = -1;
+            tNext[axis] = (static_cast<float>(cell[axis]) * m_cellSize - origin[axis]) * invDirection[axis];
+            tDelta[axis] = -m_cellSize * invDirection[axis];
+        }
+    }
+
+    std::vector<std::uint32_t> candidates {};
+    float tCell = 0.0f;
+    while (tCell <= (hit ? hit->m_distance : maxDistance)) {
+        candidates.clear();
+        for (int z = -1; z <= 1; z++) {
+            for (int y = -1; y <= 1; y++) {
+                for (int x = -1; x <= 1; x++) {
+                    GatherCell(cell + glm::ivec3(x, y, z), candidates);
+                }
+            }
+        }
+        for (std::uint32_t item : candidates) {
+            test(item);
+        }
+
+        int axis = tNext.x < tNext.y ? (tNext.x < tNext.z ? 0 : 2) : (tNext.y < tNext.z ? 1 : 2);
+        tCell = tNext[axis];
+        cell[axis] += step[axis];
+        tNext[axis] += tDelta[axis];
+    }
+    return hit;
+}
+
+} // namespace Glitter::Scene
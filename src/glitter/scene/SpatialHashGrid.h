@@ -0,0 +1,94 @@
+#pragma once
+
+#include "render/FrustumCulling.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Glitter::Scene {
+
+// The first item a ray enters, see SpatialHashGrid::Raycast().
+struct RayHit {
+    std::uint32_t m_item;
+    // In units of the ray direction's length.
+    float m_distance;
+};
+
+// A uniform grid over a set of AABBs, hashed into buckets so that it covers an unbounded world in memory proportional to
+// the items. Items are referenced by their index in the Render::CullBounds the grid is updated from, and filed under the
+// cell their center falls into. Since they overlap the neighbouring cells by up to half a cell, the queries look half a
+// cell further out. Items larger than that are kept aside, and tested by every query.
+//
+// Unlike the BVH, it's updated incrementally: an item that moved to another cell moves between two buckets in O(1), so
+// keeping it in sync costs in proportion to the items that changed. Queries cost in proportion to the cells they cover and
+// the items in those, rather than to the item count.
+class SpatialHashGrid {
+public:
+    explicit SpatialHashGrid(float cellSize);
+
+    // Refiles the `items` whose AABB in `bounds` changed or was added, and drops the items past the end of `bounds`. An item
+    // moved to another index must be part of `items` at its new index.
+    void Update(const Render::CullBounds& bounds, std::span<const std::uint32_t> items);
+    void Clear();
+
+    // Appends every item whose AABB intersects the box of `center` and half-`extent`, or the sphere, to `items`.
+    void QueryBox(const Render::CullBounds& bounds, const glm::vec3& center, const glm::vec3& extent,
+        std::vector<std::uint32_t>& items) const;
+    void QuerySphere(
+        const Render::CullBounds& bounds, const glm::vec3& center, float radius, std::vector<std::uint32_t>& items) const;
+
+    // The first item whose AABB the ray from `origin` along `direction` enters within `maxDistance`, walking the cells
+    // along the ray until one starts past the nearest hit.
+    std::optional<RayHit> Raycast(
+        const Render::CullBounds& bounds, const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const;
+
+    float GetCellSize() const { return m_cellSize; }
+    size_t GetItemCount() const { return m_filedCount + m_largeItems.size(); }
+    size_t GetLargeItemCount() const { return m_largeItems.size(); }
+    size_t GetBucketCount() const { return m_buckets.size(); }
+
+private:
+    static constexpr size_t MIN_BUCKET_COUNT = 1024;
+    // In Entry::m_bucket, for the items kept in m_largeItems, and for the items not filed anywhere.
+    static constexpr std::uint32_t LARGE_BUCKET = UINT32_MAX;
+    static constexpr std::uint32_t NO_BUCKET = UINT32_MAX - 1;
+
+    struct Entry {
+        glm::ivec3 m_cell;
+        std::uint32_t m_bucket;
+        // In the bucket, or in m_largeItems.
+        std::uint32_t m_position;
+    };
+
+    // The cell is stored along with the item, so that the items of the other cells hashing to the same bucket are skipped
+    // without looking them up.
+    struct Filed {
+        glm::ivec3 m_cell;
+        std::uint32_t m_item;
+    };
+
+    glm::ivec3 GetCell(const glm::vec3& position) const;
+    std::uint32_t GetBucket(const glm::ivec3& cell) const;
+    void File(const Render::CullBounds& bounds, std::uint32_t item);
+    void Unfile(std::uint32_t item);
+    // Doubles the buckets, refiling every item.
+    void Grow();
+    // Appends every item that may intersect the box of `min` and `max`, unfiltered.
+    void GatherCandidates(const glm::vec3& min, const glm::vec3& max, std::vector<std::uint32_t>& items) const;
+    // Appends the items filed under `cell`.
+    void GatherCell(const glm::ivec3& cell, std::vector<std::uint32_t>& items) const;
+
+    float m_cellSize;
+    float m_invCellSize;
+
+    // A power of two of them.
+    std::vector<std::vector<Filed>> m_buckets;
+    std::vector<std::uint32_t> m_largeItems;
+    std::vector<Entry> m_entries;
+    size_t m_filedCount {};
+};
+
+} // namespace Glitter::Scene
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace Glitter::Scene {
+
+enum class VertexSemantic : std::uint8_t {
+    Position,
+    TexCoord,
+    Normal,
+    Color,
+};
+
+enum class VertexAttributeType : std::uint8_t {
+    Float,
+    Half,
+    // Normalized to [0, 1].
+    Unorm8,
+    Unorm16,
+    // Three signed normalized 10-bit components and a 2-bit one, packed in a word, as GL_INT_2_10_10_10_REV.
+    PackedSnorm10,
+};
+
+struct VertexAttribute {
+    VertexSemantic m_semantic;
+    VertexAttributeType m_type;
+    std::uint32_t m_componentCount;
+    // In bytes, from the start of the vertex.
+    std::uint32_t m_offset;
+};
+
+// The layout of a vertex type, specialized next to each: a constexpr array ATTRIBUTES, in the order of the shader
+// locations they're bound to. The VAOs are set up from it, see Render::SetVertexFormat(), and the importer unpacks into it,
+// so that a vertex type is only ever described once.
+template <typename Vertex> struct VertexFormat;
+
+// The attribute of `Vertex` for `semantic`, which it must have.
+template <typename Vertex> consteval VertexAttribute FindVertexAttribute(VertexSemantic semantic)
+{
+    const auto& attributes = VertexFormat<Vertex>::ATTRIBUTES;
+    return *std::ranges::find(attributes, semantic, &VertexAttribute::m_semantic);
+}
+
+// The size in bytes of the attribute's components, packed ones included.
+constexpr std::uint32_t GetAttributeSize(const VertexAttribute& attribute)
+{
+    switch (attribute.m_type) {
+    case VertexAttributeType::Float:
+        return 4 * attribute.m_componentCount;
+    case VertexAttributeType::Half:
+    case VertexAttributeType::Unorm16:
+        return 2 * attribute.m_componentCount;
+    case VertexAttributeType::Unorm8:
+        return attribute.m_componentCount;
+    case VertexAttributeType::PackedSnorm10:
+        return 4;
+    }
+    return 0;
+}
+
+} // namespace Glitter::Scene
@@ -0,0 +1,78 @@
+#include "scene/VertexQuantization.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace Glitter::Scene {
+
+namespace {
+
+    std::uint16_t QuantizeUnorm16(float value)
+    {
+        return static_cast<std::uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+    }
+
+    std::uint32_t QuantizeSnorm10(float value)
+    {
+        return static_cast<std::uint32_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 511.0f)) & 0x3FFu;
+    }
+
+    // Projects the unit normal onto an octahedron, then unfolds its lower half over the corners of the upper one.
+    // Decoded by DecodeOctahedral() in MainVS.glsl.
+    glm::vec2 EncodeOctahedral(glm::vec3 normal)
+    {
+        float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        if (length == 0.0f) {
+            return glm::vec2(0.0f);
+        }
+
+        glm::vec2 encoded = glm::vec2(normal) / length;
+        if (normal.z < 0.0f) {
+            glm::vec2 signs {encoded.x >= 0.0f ? 1.0f : -1.0f, encoded.y >= 0.0f ? 1.0f : -1.0f};
+            encoded = (1.0f - glm::abs(glm::vec2(encoded.y, encoded.x))) * signs;
+        }
+        return encoded;
+    }
+
+} // namespace
+
+void QuantizeAsset(GltfAsset& asset)
+{
+    AABB bounds {.m_localMin = glm::vec3(FLT_MAX), .m_localMax = glm::vec3(-FLT_MAX)};
+    for (const GltfPrimitive& primitive : asset.m_primitives) {
+        bounds.m_localMin = glm::min(bounds.m_localMin, primitive.m_aabb.m_localMin);
+        bounds.m_localMax = glm::max(bounds.m_localMax, primitive.m_aabb.m_localMax);
+    }
+    if (bounds.m_localMin.x > bounds.m_localMax.x) {
+        bounds = AABB {.m_localMin = glm::vec3(0.0f), .m_localMax = glm::vec3(0.0f)};
+    }
+
+    // Flat axes quantize to 0 rather than dividing by zero.
+    glm::vec3 extent = bounds.m_localMax - bounds.m_localMin;
+    glm::vec3 inverseExtent {extent.x > 0.0f ? 1.0f / extent.x : 0.0f, extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+        extent.z > 0.0f ? 1.0f / extent.z : 0.0f};
+
+    for (GltfPrimitive& primitive : asset.m_primitives) {
+        primitive.m_quantizedVertexData.resize(primitive.m_vertexData.size());
+        for (size_t vertexIdx = 0; vertexIdx < primitive.m_vertexData.size(); vertexIdx++) {
+            const MeshVertex& vertex = primitive.m_vertexData[vertexIdx];
+
+            glm::vec3 position = (glm::vec3 {vertex.x, vertex.y, vertex.z} - bounds.m_localMin) * inverseExtent;
+            glm::vec2 normal = EncodeOctahedral(glm::vec3 {vertex.nx, vertex.ny, vertex.nz});
+            primitive.m_quantizedVertexData[vertexIdx] = QuantizedVertex {.x = QuantizeUnorm16(position.x),
+                .y = QuantizeUnorm16(position.y),
+                .z = QuantizeUnorm16(position.z),
+                .w = 0,
+                .u = glm::packHalf1x16(vertex.u),
+                .v = glm::packHalf1x16(vertex.v),
+                .m_normal = QuantizeSnorm10(normal.x) | (QuantizeSnorm10(normal.y) << 10)};
+        }
+        primitive.m_vertexData = {};
+    }
+
+    // Unorm16 positions come out of the vertex fetch in [0, 1].
+    asset.m_dequantize = glm::scale(glm::translate(glm::mat4(1.0f), bounds.m_localMin), extent);
+}
+
+} // namespace Glitter::Scene
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "scene/GltfImporter.h"
+
+namespace Glitter::Scene {
+
+// Packs the vertices of every primitive of `asset` into QuantizedVertex and releases their MeshVertex data. Positions
+// are quantized against the bounds of the whole asset, so that primitives shared between its Meshes dequantize with the
+// same m_dequantize matrix whichever Mesh draws them.
+void QuantizeAsset(GltfAsset& asset);
+
+} // namespace Glitter::Scene
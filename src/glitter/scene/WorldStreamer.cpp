@@ -0,0 +1,374 @@
+#include "scene/WorldStreamer.h"
+
+#include "Config.h"
+#include "core/CpuProfiler.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+namespace Glitter::Scene {
+
+namespace {
+
+    // Bump whenever the layout below or WorldNode change.
+    constexpr std::uint32_t WORLD_VERSION = 1;
+    constexpr std::array<char, 4> WORLD_MAGIC {'G', 'L', 'W', 'D'};
+    constexpr size_t SECTION_ALIGNMENT = 16;
+
+    // Followed by a WorldChunkEntry per chunk, a WorldAssetEntry per asset, the asset paths, then the Nodes of each chunk.
+    struct WorldHeader {
+        std::array<char, 4> m_magic;
+        std::uint32_t m_version;
+        float m_chunkSize;
+        // Corner of the first chunk on the xz plane.
+        float m_minX;
+        float m_minZ;
+        std::uint32_t m_chunksX;
+        std::uint32_t m_chunksZ;
+        std::uint32_t m_assetCount;
+    };
+
+    // Offsets are in bytes from the start of the file.
+    struct WorldChunkEntry {
+        std::uint64_t m_nodeOffset;
+        std::uint32_t m_nodeCount;
+        std::uint32_t m_padding;
+    };
+
+    struct WorldAssetEntry {
+        std::uint64_t m_pathOffset;
+        std::uint32_t m_pathLength;
+        std::uint32_t m_padding;
+    };
+
+    size_t AlignSection(size_t offset) { return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1); }
+
+    // Copies `count` elements at `offset` of `file` into `out`, failing if they're out of bounds.
+    template <typename T> bool ReadSection(std::span<const std::byte> file, std::uint64_t offset, std::uint64_t count, T* out)
+    {
+        if (offset > file.size() || count > (file.size() - offset) / sizeof(T)) {
+            return false;
+        }
+
+        if (count > 0) {
+            std::memcpy(out, file.data() + offset, sizeof(T) * count);
+        }
+        return true;
+    }
+
+} // namespace
+
+bool WriteWorld(const char* worldPath, float chunkSize, std::uint32_t chunksX, std::uint32_t chunksZ,
+    std::span<const std::string> assetPaths, std::span<const std::vector<WorldNode>> chunks)
+{
+    size_t chunkCount = static_cast<size_t>(chunksX) * chunksZ;
+    if (chunks.size() != chunkCount) {
+        return false;
+    }
+
+    size_t chunksOffset = AlignSection(sizeof(WorldHeader));
+    size_t assetsOffset = AlignSection(chunksOffset + sizeof(WorldChunkEntry) * chunkCount);
+    size_t offset = AlignSection(assetsOffset + sizeof(WorldAssetEntry) * assetPaths.size());
+    std::vector<WorldAssetEntry> assets {};
+    for (const std::string& path : assetPaths) {
+        assets.push_back(WorldAssetEntry {
+            .m_pathOffset = offset, .m_pathLength = static_cast<std::uint32_t>(path.size()), .m_padding = 0});
+        offset += path.size();
+    }
+    std::vector<WorldChunkEntry> entries {};
+    for (const std::vector<WorldNode>& nodes : chunks) {
+        offset = AlignSection(offset);
+        entries.push_back(WorldChunkEntry {
+            .m_nodeOffset = offset, .m_nodeCount = static_cast<std::uint32_t>(nodes.size()), .m_padding = 0});
+        offset += sizeof(WorldNode) * nodes.size();
+    }
+
+    WorldHeader header {.m_magic = WORLD_MAGIC,
+        .m_version = WORLD_VERSION,
+        .m_chunkSize = chunkSize,
+        .m_minX = -chunkSize * static_cast<float>(chunksX) * 0.5f,
+        .m_minZ = -chunkSize * static_cast<float>(chunksZ) * 0.5f,
+        .m_chunksX = chunksX,
+        .m_chunksZ = chunksZ,
+        .m_assetCount = static_cast<std::uint32_t>(assetPaths.size())};
+
+    std::vector<std::byte> file(offset);
+    auto writeSection = [&](size_t sectionOffset, const void* data, size_t size) {
+        if (size > 0) {
+            std::memcpy(file.data() + sectionOffset, data, size);
+        }
+    };
+    writeSection(0, &header, sizeof(header));
+    writeSection(chunksOffset, entries.data(), sizeof(WorldChunkEntry) * entries.size());
+    writeSection(assetsOffset, assets.data(), sizeof(WorldAssetEntry) * assets.size());
+    for (size_t assetIdx = 0; assetIdx < assetPaths.size(); assetIdx++) {
+        writeSection(assets[assetIdx].m_pathOffset, assetPaths[assetIdx].data(), assetPaths[assetIdx].size());
+    }
+    for (size_t chunkIdx = 0; chunkIdx < chunkCount; chunkIdx++) {
+        writeSection(entries[chunkIdx].m_nodeOffset, chunks[chunkIdx].data(), sizeof(WorldNode) * chunks[chunkIdx].size());
+    }
+
+    std::error_code error {};
+    std::filesystem::create_directories(std::filesystem::path(worldPath).parent_path(), error);
+    std::ofstream outputStream(worldPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    outputStream.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    return static_cast<bool>(outputStream);
+}
+
+WorldStreamer::WorldStreamer()
+    : m_thread([this] { LoaderMain(); })
+{
+}
+
+WorldStreamer::~WorldStreamer()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_running = false;
+    }
+    m_requestCondition.notify_all();
+    m_thread.join();
+}
+
+bool WorldStreamer::Open(const char* worldPath)
+{
+    Close();
+
+    std::optional<Util::MappedFile> mappedFile = Util::MappedFile::Open(worldPath);
+    if (!mappedFile) {
+        spdlog::error("Failed to open the world {}.", worldPath);
+        return false;
+    }
+    std::span<const std::byte> file = mappedFile->GetData();
+
+    WorldHeader header {};
+    if (!ReadSection(file, 0, 1, &header) || header.m_magic != WORLD_MAGIC || header.m_version != WORLD_VERSION
+        || !(header.m_chunkSize > 0.0f)) {
+        spdlog::error("The world {} is from another format version, or isn't a world.", worldPath);
+        return false;
+    }
+
+    size_t chunkCount = static_cast<size_t>(header.m_chunksX) * header.m_chunksZ;
+    size_t chunksOffset = AlignSection(sizeof(WorldHeader));
+    std::vector<WorldChunkEntry> entries(chunkCount);
+    std::vector<WorldAssetEntry> assets(header.m_assetCount);
+    if (!ReadSection(file, chunksOffset, chunkCount, entries.data())
+        || !ReadSection(file, AlignSection(chunksOffset + sizeof(WorldChunkEntry) * chunkCount), assets.size(), assets.data())) {
+        spdlog::error("The world {} is truncated.", worldPath);
+        return false;
+    }
+
+    std::vector<std::string> assetPaths {};
+    for (const WorldAssetEntry& asset : assets) {
+        std::string& path = assetPaths.emplace_back(asset.m_pathLength, '\0');
+        if (!ReadSection(file, asset.m_pathOffset, asset.m_pathLength, path.data())) {
+            spdlog::error("The world {} is truncated.", worldPath);
+            return false;
+        }
+    }
+
+    // The chunks are only read in the background, but checked here once and for all.
+    std::vector<ChunkRange> ranges {};
+    for (const WorldChunkEntry& entry : entries) {
+        if (entry.m_nodeOffset > file.size() || entry.m_nodeCount > (file.size() - entry.m_nodeOffset) / sizeof(WorldNode)) {
+            spdlog::error("The world {} is truncated.", worldPath);
+            return false;
+        }
+        ranges.push_back(ChunkRange {.m_offset = entry.m_nodeOffset, .m_nodeCount = entry.m_nodeCount});
+    }
+
+    m_file = std::make_shared<const Util::MappedFile>(std::move(*mappedFile));
+    if (Config::ENABLE_ASYNC_FILE_IO) {
+        if (std::optional<Util::AsyncFile> asyncFile = Util::AsyncFile::Open(worldPath)) {
+            m_asyncFile = std::make_shared<const Util::AsyncFile>(std::move(*asyncFile));
+        }
+    }
+    m_chunkSize = header.m_chunkSize;
+    m_min = glm::vec2(header.m_minX, header.m_minZ);
+    m_chunksX = header.m_chunksX;
+    m_chunksZ = header.m_chunksZ;
+    m_assetPaths = std::move(assetPaths);
+    m_ranges = std::move(ranges);
+    m_states.assign(chunkCount, ChunkState::Unloaded);
+    spdlog::info("Opened the world {}, {} by {} chunks.", worldPath, m_chunksX, m_chunksZ);
+    return true;
+}
+
+void WorldStreamer::Close()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_requests.clear();
+    }
+    // Incremented first, so that the loader stops waiting for room to push the results being dropped.
+    m_generation++;
+    while (m_results.TryPop()) {
+    }
+    m_file.reset();
+    m_asyncFile.reset();
+    m_chunkSize = 0.0f;
+    m_min = glm::vec2(0.0f);
+    m_chunksX = 0;
+    m_chunksZ = 0;
+    m_assetPaths.clear();
+    m_ranges.clear();
+    m_states.clear();
+    m_residentChunks.clear();
+    m_loadedCount = 0;
+    m_requestedCount = 0;
+}
+
+void WorldStreamer::Update(const glm::vec3& focus, float loadRadius, float unloadRadius, std::vector<std::uint32_t>& unloaded)
+{
+    if (!m_file) {
+        return;
+    }
+
+    // Drop the chunks that fell behind, only the loaded ones have Nodes to unload.
+    std::erase_if(m_residentChunks, [&](std::uint32_t chunk) {
+        if (GetDistance(chunk, focus) <= unloadRadius) {
+            return false;
+        }
+        if (m_states[chunk] == ChunkState::Loaded) {
+            unloaded.push_back(chunk);
+            m_loadedCount--;
+        } else {
+            m_requestedCount--;
+        }
+        m_states[chunk] = ChunkState::Unloaded;
+        return true;
+    });
+
+    // Then request the ones ahead, among the chunks overlapping the box around the load radius.
+    auto firstCell = [&](float coordinate, float min, std::uint32_t count) {
+        return static_cast<std::uint32_t>(
+            std::clamp(std::floor((coordinate - min) / m_chunkSize), 0.0f, static_cast<float>(count)));
+    };
+    auto endCell = [&](float coordinate, float min, std::uint32_t count) {
+        return static_cast<std::uint32_t>(
+            std::clamp(std::floor((coordinate - min) / m_chunkSize) + 1.0f, 0.0f, static_cast<float>(count)));
+    };
+    std::uint32_t beginX = firstCell(focus.x - loadRadius, m_min.x, m_chunksX);
+    std::uint32_t endX = endCell(focus.x + loadRadius, m_min.x, m_chunksX);
+    std::uint32_t beginZ = firstCell(focus.z - loadRadius, m_min.y, m_chunksZ);
+    std::uint32_t endZ = endCell(focus.z + loadRadius, m_min.y, m_chunksZ);
+    bool requested = false;
+    for (std::uint32_t z = beginZ; z < endZ; z++) {
+        for (std::uint32_t x = beginX; x < endX; x++) {
+            std::uint32_t chunk = z * m_chunksX + x;
+            if (m_states[chunk] != ChunkState::Unloaded || GetDistance(chunk, focus) > loadRadius) {
+                continue;
+            }
+
+            m_residentChunks.push_back(chunk);
+            m_states[chunk] = ChunkState::Requested;
+            m_requestedCount++;
+            std::scoped_lock lock(m_mutex);
+            m_requests.push_back(Request {.m_file = m_file,
+                .m_asyncFile = m_asyncFile,
+                .m_generation = m_generation,
+                .m_chunk = chunk,
+                .m_range = m_ranges[chunk]});
+            requested = true;
+        }
+    }
+    if (requested) {
+        m_requestCondition.notify_one();
+    }
+}
+
+std::optional<WorldChunk> WorldStreamer::Poll()
+{
+    while (true) {
+        std::optional<Result> popped = m_results.TryPop();
+        if (!popped) {
+            return std::nullopt;
+        }
+        Result& result = *popped;
+
+        // Dropped if it was unloaded since, or requested again and already landed.
+        std::uint32_t chunk = result.m_chunk.m_chunk;
+        if (result.m_generation != m_generation || m_states[chunk] != ChunkState::Requested) {
+            continue;
+        }
+        m_states[chunk] = ChunkState::Loaded;
+        m_requestedCount--;
+        m_loadedCount++;
+        return std::move(result.m_chunk);
+    }
+}
+
+float WorldStreamer::GetDistance(std::uint32_t chunk, const glm::vec3& focus) const
+{
+    glm::vec2 min = m_min + glm::vec2(static_cast<float>(chunk % m_chunksX), static_cast<float>(chunk / m_chunksX)) * m_chunkSize;
+    glm::vec2 halfExtent {m_chunkSize * 0.5f};
+    glm::vec2 outside = glm::max(glm::abs(glm::vec2(focus.x, focus.z) - (min + halfExtent)) - halfExtent, 0.0f);
+    return glm::length(outside);
+}
+
+void WorldStreamer::LoaderMain()
+{
+    Core::SetProfileThreadName("World Streamer");
+
+    Util::AsyncFileReader reader(Config::ASYNC_FILE_IO_QUEUE_DEPTH);
+    while (true) {
+        std::deque<Request> requests {};
+        {
+            // Only sleeps with no reads in flight, it waits for their completions instead.
+            std::unique_lock lock(m_mutex);
+            m_requestCondition.wait(lock, [&] { return !m_running || !m_requests.empty() || reader.GetPendingCount() > 0; });
+            if (!m_running) {
+                return;
+            }
+            requests.swap(m_requests);
+        }
+
+        for (Request& request : requests) {
+            // Shared with the read's callback, the Nodes are read in place.
+            auto result = std::make_shared<Result>(Result {
+                .m_generation = request.m_generation, .m_chunk = WorldChunk {.m_chunk = request.m_chunk, .m_nodes = {}}});
+            result->m_chunk.m_nodes.resize(request.m_range.m_nodeCount);
+            if (!request.m_asyncFile) {
+                GLITTER_PROFILE_SCOPE("Read World Chunk");
+                ReadSection(request.m_file->GetData(), request.m_range.m_offset, request.m_range.m_nodeCount,
+                    result->m_chunk.m_nodes.data());
+                PushResult(std::move(*result));
+                continue;
+            }
+
+            std::span<std::byte> nodes = std::as_writable_bytes(std::span(result->m_chunk.m_nodes));
+            auto onRead = [this, result, file = request.m_asyncFile](bool read) {
+                // The range was checked by Open(), so only an I/O error fails it. The chunk lands empty, not to be requested
+                // over and over.
+                if (!read) {
+                    spdlog::error("Failed to read the chunk {} of the world.", result->m_chunk.m_chunk);
+                    result->m_chunk.m_nodes.clear();
+                }
+                PushResult(std::move(*result));
+            };
+            reader.Read(*request.m_asyncFile, request.m_range.m_offset, nodes, onRead);
+        }
+
+        GLITTER_PROFILE_SCOPE("Read World Chunks");
+        reader.Complete(true);
+    }
+}
+
+void WorldStreamer::PushResult(Result&& result)
+{
+    // Only full when the main thread polls slower than the chunks are read, it's worth waiting for rather than reading
+    // the chunk again.
+    while (!m_results.TryPush(std::move(result))) {
+        if (!m_running.load(std::memory_order_relaxed) || result.m_generation != m_generation.load(std::memory_order_relaxed)) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+} // namespace Glitter::Scene
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Config.h"
+#include "util/AsyncFile.h"
+#include "util/File.h"
+#include "util/RingQueue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Glitter::Scene {
+
+// A Node of a world chunk. Its Mesh is the m_mesh-th of the asset at WorldStreamer::GetAssetPaths()[m_asset], its texture
+// an index into the loaded textures.
+struct WorldNode {
+    glm::vec3 m_position;
+    glm::quat m_rotation;
+    glm::vec3 m_scale;
+    std::uint32_t m_asset;
+    std::uint32_t m_mesh;
+    std::uint32_t m_texture;
+};
+
+// The Nodes of a chunk, the m_chunk-th of its world's grid, row by row along x.
+struct WorldChunk {
+    std::uint32_t m_chunk;
+    std::vector<WorldNode> m_nodes;
+};
+
+// Writes a world of `chunksX` by `chunksZ` chunks of `chunkSize` world units square, centered on the origin, whose Nodes
+// are `chunks`, one per chunk and row by row along x, referring to the assets at `assetPaths`. Returns false if it can't
+// be written.
+bool WriteWorld(const char* worldPath, float chunkSize, std::uint32_t chunksX, std::uint32_t chunksZ,
+    std::span<const std::string> assetPaths, std::span<const std::vector<WorldNode>> chunks);
+
+// Streams the chunks of a world file around a focus point, so that only the neighbourhood of the camera is resident.
+// The world is partitioned on the xz plane into a grid of chunks, each a serialized list of WorldNode. The chunks within
+// the load radius of the focus are read on a background thread and handed to the caller by Poll(), and the loaded ones
+// past the unload radius are handed back by Update() to be dropped. The unload radius being the larger one, a chunk on the
+// edge isn't loaded and unloaded over and over as the focus moves back and forth.
+//
+// The world file is mapped, and only the pages of the chunks read are ever touched. With Config::ENABLE_ASYNC_FILE_IO, the
+// chunks are read from the file instead, all the requested ones in flight at once, unless it's in the mounted AssetPack.
+class WorldStreamer {
+public:
+    WorldStreamer();
+    ~WorldStreamer();
+
+    WorldStreamer(const WorldStreamer&) = delete;
+    WorldStreamer& operator=(const WorldStreamer&) = delete;
+
+    // Opens the world at `worldPath` in place of the current one, see Close(). Returns false, after logging why, if it can't
+    // be opened or isn't a valid world.
+    bool Open(const char* worldPath);
+    // Forgets every chunk, the caller drops the Nodes of the ones it was handed.
+    void Close();
+    bool IsOpen() const { return m_file != nullptr; }
+
+    // Requests the chunks within `loadRadius` of `focus` on the xz plane, and appends to `unloaded` the loaded ones past
+    // `unloadRadius`. The requested ones past it are dropped as they land.
+    void Update(const glm::vec3& focus, float loadRadius, float unloadRadius, std::vector<std::uint32_t>& unloaded);
+    // Pops a chunk read by the background thread, which is loaded from then on.
+    std::optional<WorldChunk> Poll();
+
+    std::span<const std::string> GetAssetPaths() const { return m_assetPaths; }
+    size_t GetChunkCount() const { return m_states.size(); }
+    size_t GetLoadedCount() const { return m_loadedCount; }
+    size_t GetRequestedCount() const { return m_requestedCount; }
+
+private:
+    enum class ChunkState : std::uint8_t {
+        Unloaded,
+        Requested,
+        Loaded,
+    };
+
+    // Where a chunk's Nodes are in the world file.
+    struct ChunkRange {
+        std::uint64_t m_offset;
+        std::uint32_t m_nodeCount;
+    };
+
+    struct Request {
+        // Keeps the file mapped until the request is done, even if another world was opened since.
+        std::shared_ptr<const Util::MappedFile> m_file;
+        // Null when the chunks are copied out of m_file.
+        std::shared_ptr<const Util::AsyncFile> m_asyncFile;
+        std::uint64_t m_generation;
+        std::uint32_t m_chunk;
+        ChunkRange m_range;
+    };
+
+    struct Result {
+        std::uint64_t m_generation;
+        WorldChunk m_chunk;
+    };
+
+    float GetDistance(std::uint32_t chunk, const glm::vec3& focus) const;
+    void LoaderMain();
+    // Hands `result` to Poll(), waiting for room in m_results unless it's stale or the streamer is shutting down.
+    void PushResult(Result&& result);
+
+    std::shared_ptr<const Util::MappedFile> m_file;
+    std::shared_ptr<const Util::AsyncFile> m_asyncFile;
+    float m_chunkSize {};
+    glm::vec2 m_min {};
+    std::uint32_t m_chunksX {};
+    std::uint32_t m_chunksZ {};
+    std::vector<std::string> m_assetPaths;
+    std::vector<ChunkRange> m_ranges;
+
+    // Per chunk, and the chunks requested or loaded.
+    std::vector<ChunkState> m_states;
+    std::vector<std::uint32_t> m_residentChunks;
+    size_t m_loadedCount {};
+    size_t m_requestedCount {};
+
+    // Incremented by Open() and Close(), the results of the requests made before are dropped.
+    std::atomic<std::uint64_t> m_generation {};
+
+    std::mutex m_mutex;
+    std::condition_variable m_requestCondition;
+    std::deque<Request> m_requests;
+    std::atomic<bool> m_running {true};
+
+    // From the loader thread to Poll(), without the main thread ever waiting on the loader's lock.
+    Util::SpscQueue<Result> m_results {Config::WORLD_RESULT_QUEUE_CAPACITY};
+
+    std::thread m_thread;
+};
+
+} // namespace Glitter::Scene
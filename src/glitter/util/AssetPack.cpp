@@ -0,0 +1,321 @@
+#include "util/AssetPack.h"
+
+#include "util/Lz4.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+
+namespace Glitter::Util {
+
+namespace {
+
+    constexpr std::array<char, 4> PACK_MAGIC {'G', 'P', 'A', 'K'};
+    constexpr std::uint32_t PACK_VERSION = 2;
+
+    struct PackHeader {
+        std::array<char, 4> m_magic;
+        std::uint32_t m_version;
+        std::uint32_t m_entryCount;
+        std::uint32_t m_reserved;
+    };
+    static_assert(sizeof(PackHeader) == 16);
+
+    enum class PackCompression : std::uint32_t {
+        None,
+        Lz4Blocks,
+    };
+
+    struct PackEntry {
+        // From the start of the pack.
+        std::uint64_t m_pathOffset;
+        std::uint64_t m_dataOffset;
+        std::uint64_t m_dataSize;
+        // Decompressed.
+        std::uint64_t m_size;
+        std::uint32_t m_pathSize;
+        PackCompression m_compression;
+    };
+    static_assert(sizeof(PackEntry) == 40);
+
+    size_t GetBlockCount(size_t size) { return (size + AssetPack::ASSET_PACK_BLOCK_SIZE - 1) / AssetPack::ASSET_PACK_BLOCK_SIZE; }
+
+    // The table of the blocks' compressed sizes, then the blocks, or nothing if `data` doesn't compress by an eighth.
+    std::vector<std::byte> CompressBlocks(std::span<const std::byte> data)
+    {
+        size_t blockCount = GetBlockCount(data.size());
+        std::vector<std::byte> compressed(sizeof(std::uint32_t) * blockCount);
+        for (size_t blockIdx = 0; blockIdx < blockCount; blockIdx++) {
+            std::span<const std::byte> block = data.subspan(blockIdx * AssetPack::ASSET_PACK_BLOCK_SIZE);
+            block = block.first(std::min(block.size(), AssetPack::ASSET_PACK_BLOCK_SIZE));
+            std::vector<std::byte> compressedBlock = CompressLz4Block(block);
+            if (compressedBlock.size() >= block.size()) {
+                compressedBlock.assign(block.begin(), block.end());
+            }
+
+            auto blockSize = static_cast<std::uint32_t>(compressedBlock.size());
+            std::memcpy(compressed.data() + sizeof(std::uint32_t) * blockIdx, &blockSize, sizeof(blockSize));
+            compressed.insert(compressed.end(), compressedBlock.begin(), compressedBlock.end());
+        }
+
+        if (compressed.size() > data.size() - data.size() / 8) {
+            return {};
+        }
+        return compressed;
+    }
+
+    size_t AlignUp(size_t offset)
+    {
+        return (offset + AssetPack::ASSET_PACK_ALIGNMENT - 1) & ~(AssetPack::ASSET_PACK_ALIGNMENT - 1);
+    }
+
+    bool InBounds(std::span<const std::byte> file, std::uint64_t offset, std::uint64_t size)
+    {
+        return offset <= file.size() && size <= file.size() - offset;
+    }
+
+    std::optional<AssetPack> g_mountedPack;
+
+} // namespace
+
+std::optional<AssetPack> AssetPack::Open(const char* packPath)
+{
+    std::optional<MappedFile> file = MappedFile::Open(packPath);
+    if (!file) {
+        return std::nullopt;
+    }
+    return Open(std::move(*file));
+}
+
+std::optional<AssetPack> AssetPack::Open(MappedFile file)
+{
+    std::span<const std::byte> data = file.GetData();
+    PackHeader header {};
+    if (data.size() < sizeof(PackHeader)) {
+        return std::nullopt;
+    }
+    std::memcpy(&header, data.data(), sizeof(PackHeader));
+    if (header.m_magic != PACK_MAGIC || header.m_version != PACK_VERSION
+        || !InBounds(data, sizeof(PackHeader), std::uint64_t {header.m_entryCount} * sizeof(PackEntry))) {
+        return std::nullopt;
+    }
+
+    AssetPack pack(std::move(file));
+    pack.m_entries.reserve(header.m_entryCount);
+    for (std::uint32_t i = 0; i < header.m_entryCount; i++) {
+        PackEntry entry {};
+        std::memcpy(&entry, data.data() + sizeof(PackHeader) + sizeof(PackEntry) * i, sizeof(PackEntry));
+        if (!InBounds(data, entry.m_pathOffset, entry.m_pathSize) || !InBounds(data, entry.m_dataOffset, entry.m_dataSize)) {
+            return std::nullopt;
+        }
+
+        bool compressed = entry.m_compression == PackCompression::Lz4Blocks;
+        if (!compressed && (entry.m_compression != PackCompression::None || entry.m_size != entry.m_dataSize)) {
+            return std::nullopt;
+        }
+        pack.m_entries.push_back(Entry {
+            .m_path = std::string_view(reinterpret_cast<const char*>(data.data() + entry.m_pathOffset), entry.m_pathSize),
+            .m_data = data.subspan(static_cast<size_t>(entry.m_dataOffset), static_cast<size_t>(entry.m_dataSize)),
+            .m_size = static_cast<size_t>(entry.m_size),
+            .m_compressed = compressed,
+        });
+    }
+
+    // Find() relies on the order GlitterPackTool wrote.
+    if (!std::ranges::is_sorted(pack.m_entries, {}, &Entry::m_path)) {
+        return std::nullopt;
+    }
+
+    return pack;
+}
+
+std::optional<std::span<const std::byte>> AssetPack::Find(std::string_view assetPath, std::vector<std::byte>& buffer) const
+{
+    auto it = std::ranges::lower_bound(m_entries, assetPath, {}, &Entry::m_path);
+    if (it == m_entries.end() || it->m_path != assetPath) {
+        return std::nullopt;
+    }
+    if (!it->m_compressed) {
+        return it->m_data;
+    }
+
+    buffer.resize(it->m_size);
+    if (!Decompress(*it, buffer)) {
+        spdlog::error("Failed to decompress <{}>.", assetPath);
+        return std::nullopt;
+    }
+    return buffer;
+}
+
+bool AssetPack::Contains(std::string_view assetPath) const
+{
+    auto it = std::ranges::lower_bound(m_entries, assetPath, {}, &Entry::m_path);
+    return it != m_entries.end() && it->m_path == assetPath;
+}
+
+bool AssetPack::Decompress(const Entry& entry, std::span<std::byte> destination) const
+{
+    size_t blockCount = GetBlockCount(entry.m_size);
+    if (entry.m_data.size() < sizeof(std::uint32_t) * blockCount) {
+        return false;
+    }
+
+    // Each block's offset in the entry, past the table of their sizes.
+    std::vector<size_t> blockOffsets(blockCount + 1);
+    blockOffsets[0] = sizeof(std::uint32_t) * blockCount;
+    for (size_t blockIdx = 0; blockIdx < blockCount; blockIdx++) {
+        std::uint32_t blockSize = 0;
+        std::memcpy(&blockSize, entry.m_data.data() + sizeof(std::uint32_t) * blockIdx, sizeof(blockSize));
+        blockOffsets[blockIdx + 1] = blockOffsets[blockIdx] + blockSize;
+    }
+    if (blockOffsets.back() != entry.m_data.size()) {
+        return false;
+    }
+
+    std::atomic<bool> decompressed {true};
+    auto decompressBlocks = [&](size_t begin, size_t end) {
+        for (size_t blockIdx = begin; blockIdx < end; blockIdx++) {
+            std::span<const std::byte> block
+                = entry.m_data.subspan(blockOffsets[blockIdx], blockOffsets[blockIdx + 1] - blockOffsets[blockIdx]);
+            std::span<std::byte> target = destination.subspan(blockIdx * ASSET_PACK_BLOCK_SIZE);
+            target = target.first(std::min(target.size(), ASSET_PACK_BLOCK_SIZE));
+            if (block.size() == target.size()) {
+                std::ranges::copy(block, target.begin());
+            } else if (!DecompressLz4Block(block, target)) {
+                decompressed.store(false, std::memory_order_relaxed);
+            }
+        }
+    };
+    if (m_jobSystem) {
+        m_jobSystem->ParallelFor(blockCount, 1, decompressBlocks);
+    } else {
+        decompressBlocks(0, blockCount);
+    }
+    return decompressed.load(std::memory_order_relaxed);
+}
+
+bool WriteAssetPack(const char* packPath, std::span<const std::string> assetPaths, bool compress)
+{
+    std::vector<std::string> paths(assetPaths.begin(), assetPaths.end());
+    std::ranges::sort(paths);
+    paths.erase(std::ranges::unique(paths).begin(), paths.end());
+
+    std::vector<MappedFile> files {};
+    for (const std::string& path : paths) {
+        std::optional<MappedFile> file = MappedFile::Open(path.c_str());
+        if (!file) {
+            spdlog::error("Failed to read <{}>.", path);
+            return false;
+        }
+        files.push_back(std::move(*file));
+    }
+
+    // Empty where the asset is stored as is.
+    std::vector<std::vector<std::byte>> compressedData(files.size());
+    if (compress) {
+        for (size_t i = 0; i < files.size(); i++) {
+            compressedData[i] = CompressBlocks(files[i].GetData());
+        }
+    }
+    auto getStoredData = [&](size_t i) {
+        return compressedData[i].empty() ? files[i].GetData() : std::span<const std::byte>(compressedData[i]);
+    };
+
+    // Lay the index and path strings out first, so the index can be read without touching the data.
+    std::vector<PackEntry> entries(paths.size());
+    size_t offset = sizeof(PackHeader) + sizeof(PackEntry) * entries.size();
+    for (size_t i = 0; i < paths.size(); i++) {
+        entries[i].m_pathOffset = offset;
+        entries[i].m_pathSize = static_cast<std::uint32_t>(paths[i].size());
+        offset += paths[i].size();
+    }
+    for (size_t i = 0; i < paths.size(); i++) {
+        offset = AlignUp(offset);
+        entries[i].m_dataOffset = offset;
+        entries[i].m_dataSize = getStoredData(i).size();
+        entries[i].m_size = files[i].GetData().size();
+        entries[i].m_compression = compressedData[i].empty() ? PackCompression::None : PackCompression::Lz4Blocks;
+        offset += getStoredData(i).size();
+    }
+
+    std::ofstream outputStream(packPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    PackHeader header {
+        .m_magic = PACK_MAGIC,
+        .m_version = PACK_VERSION,
+        .m_entryCount = static_cast<std::uint32_t>(entries.size()),
+        .m_reserved = 0,
+    };
+    outputStream.write(reinterpret_cast<const char*>(&header), sizeof(PackHeader));
+    outputStream.write(
+        reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(sizeof(PackEntry) * entries.size()));
+    size_t written = sizeof(PackHeader) + sizeof(PackEntry) * entries.size();
+    for (const std::string& path : paths) {
+        outputStream.write(path.data(), static_cast<std::streamsize>(path.size()));
+        written += path.size();
+    }
+
+    constexpr std::array<char, AssetPack::ASSET_PACK_ALIGNMENT> PADDING {};
+    for (size_t i = 0; i < files.size(); i++) {
+        outputStream.write(PADDING.data(), static_cast<std::streamsize>(entries[i].m_dataOffset - written));
+
+        std::span<const std::byte> data = getStoredData(i);
+        outputStream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        written = entries[i].m_dataOffset + data.size();
+    }
+
+    if (!outputStream) {
+        spdlog::error("Failed to write <{}>.", packPath);
+        return false;
+    }
+    return true;
+}
+
+bool WriteAssetPackSource(const char* sourcePath, const char* packPath)
+{
+    std::optional<MappedFile> pack = MappedFile::Open(packPath);
+    if (!pack) {
+        spdlog::error("Failed to read <{}>.", packPath);
+        return false;
+    }
+
+    // A line of hexadecimal bytes per 32, so that the compilers and diffs don't choke on a single huge line.
+    constexpr size_t BYTES_PER_LINE = 32;
+    std::string source {};
+    std::span<const std::byte> data = pack->GetData();
+    source.reserve(data.size() * 5 + data.size() / BYTES_PER_LINE + 1);
+    for (size_t i = 0; i < data.size(); i++) {
+        std::format_to(std::back_inserter(source), "0x{:02x},", static_cast<unsigned int>(data[i]));
+        if (i % BYTES_PER_LINE == BYTES_PER_LINE - 1 || i + 1 == data.size()) {
+            source += '\n';
+        }
+    }
+
+    std::ofstream outputStream(sourcePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    outputStream.write(source.data(), static_cast<std::streamsize>(source.size()));
+    if (!outputStream) {
+        spdlog::error("Failed to write <{}>.", sourcePath);
+        return false;
+    }
+    return true;
+}
+
+bool MountAssetPack(const char* packPath, Core::JobSystem* jobSystem)
+{
+    g_mountedPack = AssetPack::Open(packPath);
+    if (g_mountedPack) {
+        g_mountedPack->SetJobSystem(jobSystem);
+    }
+    return g_mountedPack.has_value();
+}
+
+const AssetPack* GetMountedAssetPack()
+{
+    return g_mountedPack ? &*g_mountedPack : nullptr;
+}
+
+} // namespace Glitter::Util
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "core/JobSystem.h"
+#include "util/File.h"
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Glitter::Util {
+
+// A single file holding many assets, each under the relative path it's loaded by, written by GlitterPackTool. The whole
+// pack is mapped once, so loading its assets costs no further opens or seeks.
+//
+// Layout, little-endian: a header, the index of entries sorted by path, the path strings, then the assets' data, each
+// aligned to ASSET_PACK_ALIGNMENT. A compressed asset is split into blocks of ASSET_PACK_BLOCK_SIZE, each compressed by
+// itself with LZ4 so that they're decompressed in parallel, and its data is the table of the blocks' compressed sizes
+// followed by the blocks. A block that doesn't compress is stored as is, at its own size.
+class AssetPack {
+public:
+    static constexpr size_t ASSET_PACK_ALIGNMENT = 16;
+    static constexpr size_t ASSET_PACK_BLOCK_SIZE = 256 * 1024;
+
+    // std::nullopt if the file can't be opened, or isn't a valid pack.
+    static std::optional<AssetPack> Open(const char* packPath);
+    // std::nullopt if `file` isn't a valid pack.
+    static std::optional<AssetPack> Open(MappedFile file);
+
+    // The data of the asset at `assetPath`: a view of the pack, valid for as long as it, or the asset decompressed into
+    // `buffer`. std::nullopt if it isn't in the pack, or is corrupt.
+    std::optional<std::span<const std::byte>> Find(std::string_view assetPath, std::vector<std::byte>& buffer) const;
+    bool Contains(std::string_view assetPath) const;
+
+    // Decompresses the blocks of the compressed assets in parallel on `jobSystem`, which must outlive the pack, rather
+    // than on the thread finding them.
+    void SetJobSystem(Core::JobSystem* jobSystem) { m_jobSystem = jobSystem; }
+
+    size_t GetAssetCount() const { return m_entries.size(); }
+    size_t GetSize() const { return m_file.GetData().size(); }
+
+private:
+    struct Entry {
+        std::string_view m_path;
+        std::span<const std::byte> m_data;
+        // Decompressed, when m_compressed is set.
+        size_t m_size;
+        bool m_compressed;
+    };
+
+    explicit AssetPack(MappedFile file)
+        : m_file(std::move(file))
+    {
+    }
+
+    bool Decompress(const Entry& entry, std::span<std::byte> destination) const;
+
+    MappedFile m_file;
+    // Views of m_file, which doesn't move them when the pack is moved.
+    std::vector<Entry> m_entries;
+    Core::JobSystem* m_jobSystem {};
+};
+
+// Writes the files at `assetPaths` into a pack, each under its path as given. With `compress`, the assets that compress
+// by at least an eighth are stored compressed. Returns false, after logging why, if one can't be read or the pack can't
+// be written.
+bool WriteAssetPack(const char* packPath, std::span<const std::string> assetPaths, bool compress = false);
+
+// Writes the bytes of the pack at `packPath` as the C++ initializer list the executable embeds it from, see
+// GetEmbeddedShaders(). Returns false, after logging why, if the pack can't be read or the source can't be written.
+bool WriteAssetPackSource(const char* sourcePath, const char* packPath);
+
+// Makes MappedFile::Open() read from the pack at `packPath` before looking for loose files, decompressing its assets on
+// `jobSystem` when given. Must be called before any other thread opens files, and returns false if the pack can't be
+// opened.
+bool MountAssetPack(const char* packPath, Core::JobSystem* jobSystem = nullptr);
+
+// The mounted pack, or nullptr.
+const AssetPack* GetMountedAssetPack();
+
+} // namespace Glitter::Util
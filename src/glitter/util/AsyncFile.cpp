@@ -0,0 +1,454 @@
+#include "util/AsyncFile.h"
+
+#include "util/AssetPack.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <unordered_set>
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define GLITTER_IO_URING
+#include <atomic>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace Glitter::Util {
+
+namespace {
+
+    constexpr std::intptr_t INVALID_FILE = -1;
+
+    // Reads all of `destination`, or returns false.
+    bool ReadBlocking(std::intptr_t file, std::uint64_t offset, std::span<std::byte> destination)
+    {
+#ifdef _WIN32
+        // The file was opened for overlapped reads, which don't wait on their own.
+        while (!destination.empty()) {
+            OVERLAPPED overlapped {};
+            overlapped.Offset = static_cast<DWORD>(offset);
+            overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            auto size = static_cast<DWORD>(std::min<size_t>(destination.size(), MAXDWORD));
+            DWORD read = 0;
+            auto handle = reinterpret_cast<HANDLE>(file);
+            if (!ReadFile(handle, destination.data(), size, nullptr, &overlapped) && GetLastError() != ERROR_IO_PENDING) {
+                return false;
+            }
+            if (!GetOverlappedResult(handle, &overlapped, &read, TRUE) || read == 0) {
+                return false;
+            }
+            offset += read;
+            destination = destination.subspan(read);
+        }
+#else
+        while (!destination.empty()) {
+            ssize_t read = pread(static_cast<int>(file), destination.data(), destination.size(), static_cast<off_t>(offset));
+            if (read < 0 && errno == EINTR) {
+                continue;
+            }
+            if (read <= 0) {
+                return false;
+            }
+            offset += static_cast<std::uint64_t>(read);
+            destination = destination.subspan(static_cast<size_t>(read));
+        }
+#endif
+        return true;
+    }
+
+} // namespace
+
+std::optional<AsyncFile> AsyncFile::Open(const char* filePath)
+{
+    // Not the loose file MappedFile::Open() would pass over for the pack's.
+    if (const AssetPack* pack = GetMountedAssetPack(); pack && pack->Contains(filePath)) {
+        return std::nullopt;
+    }
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return std::nullopt;
+    }
+    return AsyncFile(reinterpret_cast<std::intptr_t>(file));
+#else
+    int file = open(filePath, O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+        return std::nullopt;
+    }
+    return AsyncFile(file);
+#endif
+}
+
+AsyncFile::AsyncFile(AsyncFile&& other) noexcept
+    : m_handle(std::exchange(other.m_handle, INVALID_FILE))
+{
+}
+
+AsyncFile& AsyncFile::operator=(AsyncFile&& other) noexcept
+{
+    std::swap(m_handle, other.m_handle);
+    return *this;
+}
+
+AsyncFile::~AsyncFile()
+{
+    if (m_handle == INVALID_FILE) {
+        return;
+    }
+#ifdef _WIN32
+    CloseHandle(reinterpret_cast<HANDLE>(m_handle));
+#else
+    close(static_cast<int>(m_handle));
+#endif
+}
+
+// A read completed by the backend, whose callback is still to run.
+using CompletedRead = std::pair<AsyncFileReader::Callback, bool>;
+
+#if defined(GLITTER_IO_URING)
+
+// An io_uring, whose submission queue entries each read into one of the slots. The rings are shared with the kernel,
+// the indices we don't own are accessed atomically.
+struct AsyncFileReader::Backend {
+    static std::unique_ptr<Backend> Create(size_t queueDepth)
+    {
+        io_uring_params params {};
+        auto entries = static_cast<unsigned>(std::clamp<size_t>(queueDepth, 1, 4096));
+        int ring = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ring < 0) {
+            // Kernels before 5.1 don't have it, and sandboxes often block it.
+            spdlog::warn("io_uring isn't available ({}), file reads will block", errno);
+            return nullptr;
+        }
+
+        auto backend = std::make_unique<Backend>();
+        backend->m_ring = ring;
+        backend->m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        backend->m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) {
+            backend->m_sqRingSize = backend->m_cqRingSize = std::max(backend->m_sqRingSize, backend->m_cqRingSize);
+        }
+
+        backend->m_sqRing = mmap(nullptr, backend->m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring,
+            IORING_OFF_SQ_RING);
+        backend->m_cqRing = singleMap ? backend->m_sqRing
+                                      : mmap(nullptr, backend->m_cqRingSize, PROT_READ | PROT_WRITE,
+                                            MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+        backend->m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, backend->m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring,
+            IORING_OFF_SQES);
+        backend->m_sqes = sqes == MAP_FAILED ? nullptr : static_cast<io_uring_sqe*>(sqes);
+        if (backend->m_sqRing == MAP_FAILED || backend->m_cqRing == MAP_FAILED || !backend->m_sqes) {
+            spdlog::warn("Failed to map the io_uring queues, file reads will block");
+            return nullptr;
+        }
+
+        auto* sq = static_cast<std::byte*>(backend->m_sqRing);
+        auto* cq = static_cast<std::byte*>(backend->m_cqRing);
+        backend->m_sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        backend->m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        backend->m_sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        backend->m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        backend->m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        backend->m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        backend->m_cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        backend->m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        // As many in flight as there are entries, so that the completion queue, twice as large, never overflows.
+        backend->m_slots.resize(params.sq_entries);
+        for (unsigned slot = params.sq_entries; slot-- > 0;) {
+            backend->m_freeSlots.push_back(slot);
+        }
+        return backend;
+    }
+
+    ~Backend()
+    {
+        if (m_sqes) {
+            munmap(m_sqes, m_sqesSize);
+        }
+        if (m_cqRing && m_cqRing != MAP_FAILED && m_cqRing != m_sqRing) {
+            munmap(m_cqRing, m_cqRingSize);
+        }
+        if (m_sqRing && m_sqRing != MAP_FAILED) {
+            munmap(m_sqRing, m_sqRingSize);
+        }
+        if (m_ring >= 0) {
+            close(m_ring);
+        }
+    }
+
+    bool HasFreeSlot() const { return !m_freeSlots.empty(); }
+
+    void Start(QueuedRead&& read)
+    {
+        unsigned slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+
+        // Only the kernel moves the head, and never past the tail.
+        unsigned tail = *m_sqTail;
+        unsigned index = tail & m_sqMask;
+        io_uring_sqe& sqe = m_sqes[index];
+        sqe = io_uring_sqe {};
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = static_cast<int>(read.m_file);
+        sqe.off = read.m_offset;
+        sqe.addr = reinterpret_cast<std::uint64_t>(read.m_destination.data());
+        sqe.len = static_cast<std::uint32_t>(read.m_destination.size());
+        sqe.user_data = slot;
+        m_sqArray[index] = index;
+        std::atomic_ref(*m_sqTail).store(tail + 1, std::memory_order_release);
+
+        m_slots[slot] = std::move(read);
+    }
+
+    void Flush() { Enter(false); }
+
+    void Reap(bool wait, std::vector<CompletedRead>& completed)
+    {
+        while (true) {
+            unsigned head = *m_cqHead;
+            unsigned tail = std::atomic_ref(*m_cqTail).load(std::memory_order_acquire);
+            for (; head != tail; head++) {
+                const io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+                auto slot = static_cast<unsigned>(cqe.user_data);
+                QueuedRead& read = m_slots[slot];
+                bool success = cqe.res >= 0 && static_cast<size_t>(cqe.res) == read.m_destination.size();
+                if (cqe.res == -EINVAL || (cqe.res >= 0 && !success)) {
+                    // IORING_OP_READ needs 5.6, and reads may come up short, the rest is read in place.
+                    auto done = static_cast<size_t>(std::max(cqe.res, 0));
+                    success = ReadBlocking(read.m_file, read.m_offset + done, read.m_destination.subspan(done));
+                }
+                completed.emplace_back(std::move(read.m_callback), success);
+                m_freeSlots.push_back(slot);
+            }
+            std::atomic_ref(*m_cqHead).store(head, std::memory_order_release);
+
+            if (!completed.empty() || !wait || m_freeSlots.size() == m_slots.size()) {
+                return;
+            }
+            Enter(true);
+        }
+    }
+
+    // Submits the entries the kernel hasn't consumed yet, and waits for a completion with `wait`.
+    void Enter(bool wait)
+    {
+        unsigned submit = *m_sqTail - std::atomic_ref(*m_sqHead).load(std::memory_order_acquire);
+        if (submit == 0 && !wait) {
+            return;
+        }
+        unsigned flags = wait ? IORING_ENTER_GETEVENTS : 0;
+        while (syscall(__NR_io_uring_enter, m_ring, submit, wait ? 1 : 0, flags, nullptr, 0) < 0 && errno == EINTR) {
+        }
+    }
+
+    int m_ring {-1};
+    void* m_sqRing {};
+    void* m_cqRing {};
+    io_uring_sqe* m_sqes {};
+    size_t m_sqRingSize {};
+    size_t m_cqRingSize {};
+    size_t m_sqesSize {};
+    unsigned* m_sqHead {};
+    unsigned* m_sqTail {};
+    unsigned* m_sqArray {};
+    unsigned m_sqMask {};
+    unsigned* m_cqHead {};
+    unsigned* m_cqTail {};
+    unsigned m_cqMask {};
+    io_uring_cqe* m_cqes {};
+
+    std::vector<QueuedRead> m_slots;
+    std::vector<unsigned> m_freeSlots;
+};
+
+#elif defined(_WIN32)
+
+// An I/O completion port, which the files are associated with on their first read. Each slot's OVERLAPPED comes back
+// with its completion.
+struct AsyncFileReader::Backend {
+    struct Slot {
+        OVERLAPPED m_overlapped;
+        QueuedRead m_read;
+    };
+
+    static std::unique_ptr<Backend> Create(size_t queueDepth)
+    {
+        HANDLE port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+        if (!port) {
+            spdlog::warn("Failed to create an I/O completion port ({}), file reads will block", GetLastError());
+            return nullptr;
+        }
+
+        auto backend = std::make_unique<Backend>();
+        backend->m_port = port;
+        backend->m_slots.resize(std::max<size_t>(queueDepth, 1));
+        for (size_t slot = backend->m_slots.size(); slot-- > 0;) {
+            backend->m_freeSlots.push_back(slot);
+        }
+        return backend;
+    }
+
+    ~Backend() { CloseHandle(m_port); }
+
+    bool HasFreeSlot() const { return !m_freeSlots.empty(); }
+
+    void Start(QueuedRead&& read)
+    {
+        auto handle = reinterpret_cast<HANDLE>(read.m_file);
+        if (!m_associated.contains(handle)) {
+            CreateIoCompletionPort(handle, m_port, 0, 0);
+            m_associated.insert(handle);
+        }
+
+        size_t slotIdx = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        Slot& slot = m_slots[slotIdx];
+        slot.m_overlapped = OVERLAPPED {};
+        slot.m_overlapped.Offset = static_cast<DWORD>(read.m_offset);
+        slot.m_overlapped.OffsetHigh = static_cast<DWORD>(read.m_offset >> 32);
+        slot.m_read = std::move(read);
+
+        // The completion is queued to the port even when ReadFile() finishes right away, only a failure isn't.
+        auto size = static_cast<DWORD>(std::min<size_t>(slot.m_read.m_destination.size(), MAXDWORD));
+        if (!ReadFile(handle, slot.m_read.m_destination.data(), size, nullptr, &slot.m_overlapped)
+            && GetLastError() != ERROR_IO_PENDING) {
+            m_failed.emplace_back(std::move(slot.m_read.m_callback), false);
+            m_freeSlots.push_back(slotIdx);
+        }
+    }
+
+    void Flush() { }
+
+    void Reap(bool wait, std::vector<CompletedRead>& completed)
+    {
+        completed.insert(completed.end(), std::make_move_iterator(m_failed.begin()), std::make_move_iterator(m_failed.end()));
+        m_failed.clear();
+        if (m_freeSlots.size() == m_slots.size()) {
+            return;
+        }
+
+        std::array<OVERLAPPED_ENTRY, 64> entries {};
+        ULONG count = 0;
+        DWORD timeout = wait && completed.empty() ? INFINITE : 0;
+        if (!GetQueuedCompletionStatusEx(m_port, entries.data(), static_cast<ULONG>(entries.size()), &count, timeout, FALSE)) {
+            return;
+        }
+        for (const OVERLAPPED_ENTRY& entry : std::span(entries.data(), count)) {
+            // The OVERLAPPED is the first member of its slot.
+            auto* slot = reinterpret_cast<Slot*>(entry.lpOverlapped);
+            QueuedRead& read = slot->m_read;
+            DWORD transferred = 0;
+            bool success = GetOverlappedResult(reinterpret_cast<HANDLE>(read.m_file), &slot->m_overlapped, &transferred, FALSE);
+            size_t done = success ? transferred : 0;
+            // Reads larger than a DWORD and short reads read the rest in place.
+            if (success && done != read.m_destination.size()) {
+                success = done > 0 && ReadBlocking(read.m_file, read.m_offset + done, read.m_destination.subspan(done));
+            }
+            completed.emplace_back(std::move(read.m_callback), success);
+            m_freeSlots.push_back(static_cast<size_t>(slot - m_slots.data()));
+        }
+    }
+
+    HANDLE m_port {};
+    std::vector<Slot> m_slots;
+    std::vector<size_t> m_freeSlots;
+    std::unordered_set<HANDLE> m_associated;
+    std::vector<CompletedRead> m_failed;
+};
+
+#else
+
+// Nothing asynchronous to read with, the reads are made by CompleteBlocking().
+struct AsyncFileReader::Backend {
+    static std::unique_ptr<Backend> Create(size_t) { return nullptr; }
+    bool HasFreeSlot() const { return false; }
+    void Start(QueuedRead&&) { }
+    void Flush() { }
+    void Reap(bool, std::vector<CompletedRead>&) { }
+};
+
+#endif
+
+AsyncFileReader::AsyncFileReader(size_t queueDepth)
+    : m_backend(Backend::Create(queueDepth))
+{
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+    // The kernel may still be writing into the destinations of the reads in flight.
+    m_queued.clear();
+    while (m_inFlightCount > 0) {
+        Complete(true);
+    }
+}
+
+void AsyncFileReader::Read(const AsyncFile& file, std::uint64_t offset, std::span<std::byte> destination, Callback callback)
+{
+    m_queued.push_back(QueuedRead {
+        .m_file = file.GetHandle(), .m_offset = offset, .m_destination = destination, .m_callback = std::move(callback)});
+}
+
+void AsyncFileReader::Submit()
+{
+    if (!m_backend) {
+        return;
+    }
+
+    while (!m_queued.empty() && m_backend->HasFreeSlot()) {
+        m_backend->Start(std::move(m_queued.front()));
+        m_queued.pop_front();
+        m_inFlightCount++;
+    }
+    m_backend->Flush();
+}
+
+size_t AsyncFileReader::Complete(bool wait)
+{
+    if (!m_backend) {
+        return CompleteBlocking();
+    }
+
+    Submit();
+    std::vector<CompletedRead> completed;
+    m_backend->Reap(wait && m_inFlightCount > 0, completed);
+    m_inFlightCount -= completed.size();
+
+    // The callbacks may queue more reads, the next Complete() submits them.
+    for (auto& [callback, success] : completed) {
+        callback(success);
+    }
+    return completed.size();
+}
+
+size_t AsyncFileReader::CompleteBlocking()
+{
+    size_t count = 0;
+    while (!m_queued.empty()) {
+        QueuedRead read = std::move(m_queued.front());
+        m_queued.pop_front();
+        read.m_callback(ReadBlocking(read.m_file, read.m_offset, read.m_destination));
+        count++;
+    }
+    return count;
+}
+
+} // namespace Glitter::Util
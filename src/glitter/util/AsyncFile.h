@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+
+namespace Glitter::Util {
+
+// A loose file opened for AsyncFileReader, read by offset without a file position.
+class AsyncFile {
+public:
+    // std::nullopt if the file can't be opened, or is in the mounted AssetPack, whose assets are read by MappedFile.
+    static std::optional<AsyncFile> Open(const char* filePath);
+
+    AsyncFile(AsyncFile&& other) noexcept;
+    AsyncFile& operator=(AsyncFile&& other) noexcept;
+    ~AsyncFile();
+
+    AsyncFile(const AsyncFile&) = delete;
+    AsyncFile& operator=(const AsyncFile&) = delete;
+
+    // The file descriptor, or the HANDLE on Windows.
+    std::intptr_t GetHandle() const { return m_handle; }
+
+private:
+    explicit AsyncFile(std::intptr_t handle)
+        : m_handle(handle)
+    {
+    }
+
+    std::intptr_t m_handle {-1};
+};
+
+// Keeps many reads of AsyncFiles in flight from a single thread, so that a loader thread isn't blocked on each read in
+// turn, and the storage sees them all at once. Reads are queued by Read(), handed to the OS in a batch by Submit(), and
+// their callbacks run by Complete() on the thread calling it. The OS queue is io_uring on Linux and an I/O completion
+// port on Windows. Where neither is available, Complete() reads the queued ranges itself, one blocking read after the
+// other.
+//
+// Not thread-safe: a single thread reads, submits and completes.
+class AsyncFileReader {
+public:
+    // Called with whether the whole range was read.
+    using Callback = std::function<void(bool read)>;
+
+    // `queueDepth` reads are in flight at most, the others wait in the queue.
+    explicit AsyncFileReader(size_t queueDepth);
+    ~AsyncFileReader();
+
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+    // Queues the read of `destination.size()` bytes at `offset` of `file`. Both must outlive the callback.
+    void Read(const AsyncFile& file, std::uint64_t offset, std::span<std::byte> destination, Callback callback);
+    // Hands the queued reads to the OS, as many as there's room for in flight.
+    void Submit();
+    // Submits the queued reads, then runs the callbacks of the reads that completed, waiting for at least one with `wait`
+    // if there are any left. Returns how many callbacks ran.
+    size_t Complete(bool wait);
+
+    // Queued or in flight.
+    size_t GetPendingCount() const { return m_queued.size() + m_inFlightCount; }
+    // Whether reads go through io_uring or a completion port, rather than blocking reads.
+    bool IsAsync() const { return m_backend != nullptr; }
+
+private:
+    struct QueuedRead {
+        std::intptr_t m_file;
+        std::uint64_t m_offset;
+        std::span<std::byte> m_destination;
+        Callback m_callback;
+    };
+    struct Backend;
+
+    size_t CompleteBlocking();
+
+    std::unique_ptr<Backend> m_backend;
+    std::deque<QueuedRead> m_queued;
+    size_t m_inFlightCount {};
+};
+
+} // namespace Glitter::Util
@@ -0,0 +1,41 @@
+#include "util/DirtyRanges.h"
+
+#include <algorithm>
+
+namespace Glitter::Util {
+
+void DirtyRanges::AddRange(std::uint32_t begin, std::uint32_t end)
+{
+    if (begin >= end) {
+        return;
+    }
+
+    if (!m_ranges.empty() && m_ranges.back().m_end == begin) {
+        m_ranges.back().m_end = end;
+        return;
+    }
+    m_ranges.push_back(Range {.m_begin = begin, .m_end = end});
+}
+
+std::span<const DirtyRanges::Range> DirtyRanges::Coalesce(std::uint32_t mergeGap)
+{
+    std::sort(m_ranges.begin(), m_ranges.end(), [](const Range& a, const Range& b) { return a.m_begin < b.m_begin; });
+
+    size_t merged = 0;
+    for (size_t rangeIdx = 1; rangeIdx < m_ranges.size(); rangeIdx++) {
+        Range& last = m_ranges[merged];
+        const Range& range = m_ranges[rangeIdx];
+        if (range.m_begin <= last.m_end + mergeGap) {
+            last.m_end = std::max(last.m_end, range.m_end);
+        } else {
+            m_ranges[++merged] = range;
+        }
+    }
+    if (!m_ranges.empty()) {
+        m_ranges.resize(merged + 1);
+    }
+
+    return m_ranges;
+}
+
+} // namespace Glitter::Util
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Glitter::Util {
+
+// Collects the indices of changed elements as half-open ranges, so that they can be uploaded with as few copies as
+// possible.
+class DirtyRanges {
+public:
+    struct Range {
+        std::uint32_t m_begin;
+        std::uint32_t m_end;
+    };
+
+    // Consecutive indices extend the last range instead of adding a new one.
+    void Add(std::uint32_t index) { AddRange(index, index + 1); }
+    void AddRange(std::uint32_t begin, std::uint32_t end);
+    void Clear() { m_ranges.clear(); }
+    bool Empty() const { return m_ranges.empty(); }
+
+    // Sorts the ranges and merges the ones overlapping or closer than `mergeGap` elements, trading a few redundant
+    // elements for fewer copies. The result is valid until the next change.
+    std::span<const Range> Coalesce(std::uint32_t mergeGap);
+
+private:
+    std::vector<Range> m_ranges;
+};
+
+} // namespace Glitter::Util
@@ -0,0 +1,30 @@
+#include "util/EmbeddedShaders.h"
+
+#include <optional>
+#include <span>
+
+namespace Glitter::Util {
+
+namespace {
+
+#ifdef GLITTER_EMBEDDED_SHADERS
+    // Written by `GlitterPackTool --embed`, see CMakeLists.txt.
+    alignas(AssetPack::ASSET_PACK_ALIGNMENT) constexpr unsigned char EMBEDDED_SHADERS[] = {
+#include "EmbeddedShaders.inc"
+    };
+#endif
+
+} // namespace
+
+const AssetPack* GetEmbeddedShaders()
+{
+#ifdef GLITTER_EMBEDDED_SHADERS
+    // Only its index is read, the shaders stay views of the executable's data.
+    static const std::optional<AssetPack> s_pack = AssetPack::Open(MappedFile::View(std::as_bytes(std::span(EMBEDDED_SHADERS))));
+    return s_pack ? &*s_pack : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+} // namespace Glitter::Util
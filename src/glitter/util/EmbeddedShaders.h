@@ -0,0 +1,11 @@
+#pragma once
+
+#include "util/AssetPack.h"
+
+namespace Glitter::Util {
+
+// The pack of data/shaders embedded in the executable at build time, under the same paths as the loose files, see the
+// GLITTER_EMBED_SHADERS CMake option. nullptr when it was built without.
+const AssetPack* GetEmbeddedShaders();
+
+} // namespace Glitter::Util
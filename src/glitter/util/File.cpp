@@ -1,29 +1,206 @@
 #include "util/File.h"
 
-#include <fstream>
+#include "util/AssetPack.h"
+
+#include <cstdio>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace Glitter::Util {
 
+namespace {
+
+    // Maps the whole file, returning nullptr if it can't be, e.g. because it's empty.
+    const std::byte* MapFile(const char* filePath, size_t& size)
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return nullptr;
+        }
+
+        LARGE_INTEGER fileSize {};
+        const void* view = nullptr;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+            // The view keeps the mapping alive, so neither handle is needed past this.
+            if (HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)) {
+                view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+
+        size = static_cast<size_t>(fileSize.QuadPart);
+        return static_cast<const std::byte*>(view);
+#else
+        int file = open(filePath, O_RDONLY);
+        if (file < 0) {
+            return nullptr;
+        }
+
+        struct stat fileStat {};
+        void* view = MAP_FAILED;
+        if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0) {
+            view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        }
+        close(file);
+
+        size = static_cast<size_t>(fileStat.st_size);
+        return view == MAP_FAILED ? nullptr : static_cast<const std::byte*>(view);
+#endif
+    }
+
+    void UnmapFile(const std::byte* data, size_t size)
+    {
+#ifdef _WIN32
+        (void)size;
+        UnmapViewOfFile(data);
+#else
+        munmap(const_cast<std::byte*>(data), size);
+#endif
+    }
+
+} // namespace
+
+std::optional<MappedFile> MappedFile::Open(const char* filePath)
+{
+    // The mounted pack stays mounted, so its views never dangle.
+    if (const AssetPack* pack = GetMountedAssetPack()) {
+        if (std::optional<MappedFile> asset = Open(*pack, filePath)) {
+            return asset;
+        }
+    }
+
+    MappedFile file {};
+    size_t size = 0;
+    if (const std::byte* data = MapFile(filePath, size)) {
+        file.m_data = data;
+        file.m_size = size;
+        file.m_mapped = true;
+        return file;
+    }
+
+    // Empty files can't be mapped, and some file systems don't support it.
+    std::optional<std::vector<std::byte>> contents = ReadBinaryFile(filePath);
+    if (!contents) {
+        return std::nullopt;
+    }
+
+    file.m_contents = std::move(*contents);
+    file.m_data = file.m_contents.data();
+    file.m_size = file.m_contents.size();
+    return file;
+}
+
+std::optional<MappedFile> MappedFile::Open(const AssetPack& pack, std::string_view assetPath)
+{
+    // Moving m_contents keeps its data where it is, so the view of a decompressed asset stays valid.
+    MappedFile file {};
+    std::optional<std::span<const std::byte>> asset = pack.Find(assetPath, file.m_contents);
+    if (!asset) {
+        return std::nullopt;
+    }
+    file.m_data = asset->data();
+    file.m_size = asset->size();
+    return file;
+}
+
+MappedFile MappedFile::View(std::span<const std::byte> data)
+{
+    MappedFile file {};
+    file.m_data = data.data();
+    file.m_size = data.size();
+    return file;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+    , m_mapped(std::exchange(other.m_mapped, false))
+    , m_contents(std::move(other.m_contents))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        Unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_mapped = std::exchange(other.m_mapped, false);
+        m_contents = std::move(other.m_contents);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    Unmap();
+}
+
+void MappedFile::Unmap()
+{
+    if (m_mapped) {
+        UnmapFile(m_data, m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_contents = {};
+}
+
 std::optional<std::string> ReadFile(const char* filePath)
 {
-    std::ifstream inputStream = std::ifstream(filePath, std::ios::in);
-    if (inputStream) {
-        std::string inputContents
-            = {std::istreambuf_iterator<char>(inputStream),
-                std::istreambuf_iterator<char>()};
+    std::optional<MappedFile> file = MappedFile::Open(filePath);
+    if (!file) {
+        return std::nullopt;
+    }
 
-        // If present, remove the last empty line
-        size_t lastCharacterIdx = inputContents.length() - 1;
-        if (inputContents[lastCharacterIdx] == '\n') {
-            inputContents = inputContents.substr(0, lastCharacterIdx);
-        }
+    // If present, leave out the last empty line.
+    std::span<const std::byte> data = file->GetData();
+    if (!data.empty() && data.back() == std::byte {'\n'}) {
+        data = data.first(data.size() - 1);
+    }
+
+    return std::string(reinterpret_cast<const char*>(data.data()), data.size());
+}
 
-        return inputContents;
+std::optional<std::vector<std::byte>> ReadBinaryFile(const char* filePath)
+{
+    std::FILE* file = std::fopen(filePath, "rb");
+    if (!file) {
+        return std::nullopt;
     }
 
-    return {};
+    // Read in a single call once the size is known, with no stream buffering in between.
+    std::vector<std::byte> contents {};
+    bool read = std::fseek(file, 0, SEEK_END) == 0;
+    long size = read ? std::ftell(file) : -1;
+    if (size >= 0 && std::fseek(file, 0, SEEK_SET) == 0) {
+        contents.resize(static_cast<size_t>(size));
+        read = std::fread(contents.data(), 1, contents.size(), file) == contents.size();
+    } else {
+        read = false;
+    }
+    std::fclose(file);
+
+    if (!read) {
+        return std::nullopt;
+    }
+    return contents;
 }
 
 } // namespace Glitter::Util
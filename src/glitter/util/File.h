@@ -1,10 +1,53 @@
 #pragma once
 
+#include <cstddef>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace Glitter::Util {
 
+class AssetPack;
+
+// A read-only view of a whole file. It's memory-mapped where the platform supports it, so pages are only read as
+// they're touched and never copied, and read into memory in a single call otherwise. Files in the mounted AssetPack are
+// read from it instead.
+class MappedFile {
+public:
+    // std::nullopt if the file can't be opened.
+    static std::optional<MappedFile> Open(const char* filePath);
+    // The asset at `assetPath` of `pack`, which must outlive it unless the asset is compressed. std::nullopt if it isn't
+    // in the pack.
+    static std::optional<MappedFile> Open(const AssetPack& pack, std::string_view assetPath);
+    // A view of `data`, e.g. embedded in the executable, which must outlive it.
+    static MappedFile View(std::span<const std::byte> data);
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::span<const std::byte> GetData() const { return {m_data, m_size}; }
+
+private:
+    MappedFile() = default;
+    void Unmap();
+
+    const std::byte* m_data {};
+    size_t m_size {};
+    // Whether m_data is a mapping of its own, rather than pointing into m_contents, an AssetPack or View()'s data.
+    bool m_mapped {};
+    std::vector<std::byte> m_contents;
+};
+
+// Reads a text file, without the trailing newline if it ends with one.
 std::optional<std::string> ReadFile(const char* filePath);
 
+// Reads the whole file as-is, without ReadFile()'s text handling.
+std::optional<std::vector<std::byte>> ReadBinaryFile(const char* filePath);
+
 } // namespace Glitter::Util
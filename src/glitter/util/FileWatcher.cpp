@@ -0,0 +1,38 @@
+#include "util/FileWatcher.h"
+
+#include <algorithm>
+#include <system_error>
+
+namespace Glitter::Util {
+
+void FileWatcher::Watch(const std::string& path)
+{
+    if (std::ranges::any_of(m_files, [&](const WatchedFile& file) { return file.m_path == path; })) {
+        return;
+    }
+
+    std::error_code error {};
+    m_files.push_back(WatchedFile {.m_path = path, .m_writeTime = std::filesystem::last_write_time(path, error)});
+}
+
+std::vector<std::string> FileWatcher::Poll()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - m_lastPoll < m_interval) {
+        return {};
+    }
+    m_lastPoll = now;
+
+    std::vector<std::string> modified {};
+    for (WatchedFile& file : m_files) {
+        std::error_code error {};
+        std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(file.m_path, error);
+        if (!error && writeTime != file.m_writeTime) {
+            file.m_writeTime = writeTime;
+            modified.push_back(file.m_path);
+        }
+    }
+    return modified;
+}
+
+} // namespace Glitter::Util
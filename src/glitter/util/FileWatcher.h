@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Glitter::Util {
+
+// Tells which of a set of files were modified, by comparing their last write times once per interval. A few stat calls
+// every half second cost nothing next to a frame, and need no platform notification API.
+class FileWatcher {
+public:
+    explicit FileWatcher(double intervalSeconds)
+        : m_interval(intervalSeconds)
+    {
+    }
+
+    // Does nothing if `path` is already watched.
+    void Watch(const std::string& path);
+
+    // The watched files modified since the previous call, or none if it was less than the interval ago. A file that's
+    // missing, e.g. while an editor replaces it, is reported once it's back.
+    std::vector<std::string> Poll();
+
+private:
+    struct WatchedFile {
+        std::string m_path;
+        std::filesystem::file_time_type m_writeTime;
+    };
+
+    std::chrono::duration<double> m_interval;
+    std::chrono::steady_clock::time_point m_lastPoll {};
+    std::vector<WatchedFile> m_files;
+};
+
+} // namespace Glitter::Util
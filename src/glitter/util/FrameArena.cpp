@@ -0,0 +1,61 @@
+#include "util/FrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Glitter::Util {
+
+FrameArena::FrameArena(size_t capacity, std::pmr::memory_resource* upstream)
+    : m_upstream(upstream)
+    , m_capacity(capacity)
+{
+    m_block = static_cast<std::byte*>(m_upstream->allocate(m_capacity, alignof(std::max_align_t)));
+}
+
+FrameArena::~FrameArena()
+{
+    ReleaseOverflows();
+    m_upstream->deallocate(m_block, m_capacity, alignof(std::max_align_t));
+}
+
+void FrameArena::Reset()
+{
+    // Grow the block to the previous frame's peak, with room to spare for the next frames.
+    if (!m_overflows.empty()) {
+        ReleaseOverflows();
+        m_upstream->deallocate(m_block, m_capacity, alignof(std::max_align_t));
+        m_capacity = std::max(m_capacity * 2, m_used);
+        m_block = static_cast<std::byte*>(m_upstream->allocate(m_capacity, alignof(std::max_align_t)));
+        spdlog::info("Grew the frame arena to {} KiB.", m_capacity / 1024);
+    }
+
+    m_offset = 0;
+    m_used = 0;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+    // Align the address itself, the block is only aligned to std::max_align_t.
+    auto address = reinterpret_cast<std::uintptr_t>(m_block) + m_offset;
+    size_t padding = ((address + alignment - 1) & ~(alignment - 1)) - address;
+    m_used += padding + bytes;
+    if (m_offset + padding + bytes <= m_capacity) {
+        std::byte* data = m_block + m_offset + padding;
+        m_offset += padding + bytes;
+        return data;
+    }
+
+    void* data = m_upstream->allocate(bytes, alignment);
+    m_overflows.push_back(Overflow {.m_data = data, .m_bytes = bytes, .m_alignment = alignment});
+    return data;
+}
+
+void FrameArena::ReleaseOverflows()
+{
+    for (const Overflow& overflow : m_overflows) {
+        m_upstream->deallocate(overflow.m_data, overflow.m_bytes, overflow.m_alignment);
+    }
+    m_overflows.clear();
+}
+
+} // namespace Glitter::Util
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace Glitter::Util {
+
+// A bump allocator for the data that only lives until the end of the frame, as a std::pmr::memory_resource backing the
+// frame's std::pmr containers. Deallocating does nothing, everything is freed at once by Reset(). Allocations that don't
+// fit in its block are served by the upstream resource until then, and the block grows to hold them on the next
+// Reset(), so that a steady-state frame never reaches the heap.
+//
+// Not thread-safe, each thread allocating needs its own.
+class FrameArena final : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(size_t capacity, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Starts a new frame, invalidating every allocation of the previous one.
+    void Reset();
+
+    // Bytes allocated since the last Reset(), padding and overflows included, and the size of the block.
+    size_t GetUsed() const { return m_used; }
+    size_t GetCapacity() const { return m_capacity; }
+
+private:
+    struct Overflow {
+        void* m_data;
+        size_t m_bytes;
+        size_t m_alignment;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* /*data*/, size_t /*bytes*/, size_t /*alignment*/) override { }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void ReleaseOverflows();
+
+    std::pmr::memory_resource* m_upstream;
+    std::byte* m_block {};
+    size_t m_capacity {};
+    size_t m_offset {};
+    size_t m_used {};
+    std::vector<Overflow> m_overflows;
+};
+
+} // namespace Glitter::Util
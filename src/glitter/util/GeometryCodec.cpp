@@ -0,0 +1,116 @@
+#include "util/GeometryCodec.h"
+
+#include "util/Lz4.h"
+
+#include <cstring>
+
+namespace Glitter::Util {
+
+namespace {
+
+    // The size of the varints of an index buffer precedes its LZ4 block.
+    using StreamSize = std::uint64_t;
+
+} // namespace
+
+std::vector<std::byte> EncodeVertexBuffer(std::span<const std::byte> vertices, size_t vertexSize)
+{
+    size_t vertexCount = vertexSize > 0 ? vertices.size() / vertexSize : 0;
+    std::vector<std::byte> deltas(vertexCount * vertexSize);
+    for (size_t byteIdx = 0; byteIdx < vertexSize; byteIdx++) {
+        std::byte* lane = deltas.data() + vertexCount * byteIdx;
+        auto previous = std::uint8_t {0};
+        for (size_t vertexIdx = 0; vertexIdx < vertexCount; vertexIdx++) {
+            auto value = static_cast<std::uint8_t>(vertices[vertexSize * vertexIdx + byteIdx]);
+            lane[vertexIdx] = static_cast<std::byte>(value - previous);
+            previous = value;
+        }
+    }
+    return CompressLz4Block(deltas);
+}
+
+bool DecodeVertexBuffer(std::span<const std::byte> source, std::span<std::byte> vertices, size_t vertexSize)
+{
+    if (vertexSize == 0 || vertices.size() % vertexSize != 0) {
+        return false;
+    }
+
+    std::vector<std::byte> deltas(vertices.size());
+    if (!DecompressLz4Block(source, deltas)) {
+        return false;
+    }
+
+    // Interleaved back a vertex at a time, so that `vertices` is written in order, whichever the vertex size.
+    size_t vertexCount = vertices.size() / vertexSize;
+    std::vector<std::uint8_t> previous(vertexSize, 0);
+    for (size_t vertexIdx = 0; vertexIdx < vertexCount; vertexIdx++) {
+        std::byte* vertex = vertices.data() + vertexSize * vertexIdx;
+        for (size_t byteIdx = 0; byteIdx < vertexSize; byteIdx++) {
+            previous[byteIdx] += static_cast<std::uint8_t>(deltas[vertexCount * byteIdx + vertexIdx]);
+            vertex[byteIdx] = static_cast<std::byte>(previous[byteIdx]);
+        }
+    }
+    return true;
+}
+
+std::vector<std::byte> EncodeIndexBuffer(std::span<const std::uint32_t> indices)
+{
+    std::vector<std::byte> varints;
+    varints.reserve(indices.size() * 2);
+    std::uint32_t previous = 0;
+    for (std::uint32_t index : indices) {
+        auto delta = static_cast<std::int32_t>(index - previous);
+        auto zigzag = (static_cast<std::uint32_t>(delta) << 1) ^ static_cast<std::uint32_t>(delta >> 31);
+        for (; zigzag >= 0x80; zigzag >>= 7) {
+            varints.push_back(static_cast<std::byte>(zigzag | 0x80));
+        }
+        varints.push_back(static_cast<std::byte>(zigzag));
+        previous = index;
+    }
+
+    std::vector<std::byte> block = CompressLz4Block(varints);
+    std::vector<std::byte> encoded(sizeof(StreamSize) + block.size());
+    auto varintSize = static_cast<StreamSize>(varints.size());
+    std::memcpy(encoded.data(), &varintSize, sizeof(varintSize));
+    std::memcpy(encoded.data() + sizeof(StreamSize), block.data(), block.size());
+    return encoded;
+}
+
+bool DecodeIndexBuffer(std::span<const std::byte> source, std::span<std::uint32_t> indices)
+{
+    StreamSize varintSize = 0;
+    if (source.size() < sizeof(StreamSize)) {
+        return false;
+    }
+    std::memcpy(&varintSize, source.data(), sizeof(varintSize));
+    // An index takes at least one byte, and at most five.
+    if (varintSize < indices.size() || varintSize > indices.size() * 5) {
+        return false;
+    }
+
+    std::vector<std::byte> varints(varintSize);
+    if (!DecompressLz4Block(source.subspan(sizeof(StreamSize)), varints)) {
+        return false;
+    }
+
+    size_t pos = 0;
+    std::uint32_t previous = 0;
+    for (std::uint32_t& index : indices) {
+        std::uint32_t zigzag = 0;
+        for (std::uint32_t shift = 0;; shift += 7) {
+            if (pos == varints.size() || shift > 28) {
+                return false;
+            }
+            auto value = static_cast<std::uint32_t>(varints[pos++]);
+            zigzag |= (value & 0x7F) << shift;
+            if ((value & 0x80) == 0) {
+                break;
+            }
+        }
+        previous += (zigzag >> 1) ^ (0u - (zigzag & 1));
+        index = previous;
+    }
+    return pos == varints.size();
+}
+
+} // namespace Glitter::Util
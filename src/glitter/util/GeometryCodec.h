@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Glitter::Util {
+
+// A lossless codec for vertex and index buffers, shrinking the Mesh cache. Both are first made to look like runs of
+// small, repeating bytes, then compressed as a single LZ4 block, so that they decode at close to memory speed.
+
+// Each byte of a vertex is stored as its difference with the same byte of the previous vertex, the bytes grouped by their
+// position in the vertex. Nearby vertices of an optimized Mesh mostly differ in the low bytes of their floats.
+std::vector<std::byte> EncodeVertexBuffer(std::span<const std::byte> vertices, size_t vertexSize);
+// Decodes `source` into `vertices`, which must be exactly as large as the buffer encoded. Returns false if `source` is
+// corrupt, without reading or writing out of bounds.
+bool DecodeVertexBuffer(std::span<const std::byte> source, std::span<std::byte> vertices, size_t vertexSize);
+
+// Each index is stored as its zigzagged difference with the previous one, in 7-bit varints, so that the mostly local
+// indices of an optimized Mesh take a byte or two.
+std::vector<std::byte> EncodeIndexBuffer(std::span<const std::uint32_t> indices);
+// Decodes `source` into `indices`, which must be exactly as many as encoded. Returns false if `source` is corrupt,
+// without reading or writing out of bounds.
+bool DecodeIndexBuffer(std::span<const std::byte> source, std::span<std::uint32_t> indices);
+
+} // namespace Glitter::Util
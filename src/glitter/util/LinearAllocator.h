@@ -0,0 +1,139 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+
+namespace Glitter::Util {
+
+// Packs objects back-to-back at the UBO offset alignment, either into its own buffer or into an external target. The
+// alignment must be set, by QueryAlignment() or SetAlignment(), before the first push.
+class LinearAllocator {
+public:
+    LinearAllocator() = default;
+
+    // Returns the offset after the object in the buffer.
+    template <typename T> size_t Push(T& t) { return Push(std::span<const T>(&t, 1)); }
+
+    // Pushes a contiguous array of objects, only padding after the last one. Returns the offset of the first object.
+    template <typename T> size_t Push(std::span<const T> ts)
+    {
+        size_t offsetBeforePush = m_size;
+        size_t paddedSize = AlignUp(ts.size_bytes());
+        if (!Advance(paddedSize)) {
+            return offsetBeforePush;
+        }
+
+        std::byte* data = Data() + offsetBeforePush;
+        std::memcpy(data, ts.data(), ts.size_bytes());
+        std::memset(data + ts.size_bytes(), 0, paddedSize - ts.size_bytes());
+        return offsetBeforePush;
+    }
+
+    // Pushes each object at its own aligned offset, as if pushed one by one, so that each can be bound on its own. Returns
+    // the offset of the first object, the next ones follow every AlignUp(sizeof(T)) bytes.
+    template <typename T> size_t PushN(std::span<const T> ts)
+    {
+        size_t offsetBeforePush = m_size;
+        size_t stride = AlignUp(sizeof(T));
+        if (!Advance(stride * ts.size())) {
+            return offsetBeforePush;
+        }
+
+        std::byte* data = Data() + offsetBeforePush;
+        for (const T& t : ts) {
+            std::memcpy(data, &t, sizeof(T));
+            std::memset(data + sizeof(T), 0, stride - sizeof(T));
+            data += stride;
+        }
+        return offsetBeforePush;
+    }
+
+    // Grows the internal buffer so that `count` more objects of `size` bytes, each pushed on its own, fit without
+    // reallocating. Does nothing with an external target.
+    void Reserve(size_t count, size_t size)
+    {
+        if (m_target.empty()) {
+            Grow(m_size + AlignUp(size) * count);
+        }
+    }
+
+    // Redirects every push into externally owned memory, such as a mapped GPU buffer, instead of the internal buffer.
+    void SetTarget(std::span<std::byte> target)
+    {
+        m_target = target;
+        Clear();
+    }
+
+    // Uses GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, which needs a GL context.
+    void QueryAlignment()
+    {
+        GLint alignment = 1;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        SetAlignment(alignment);
+    }
+    // Uses `alignment` instead, rounded up to a power of two, for pushing without a GL context.
+    void SetAlignment(GLint alignment) { m_alignment = std::bit_ceil(static_cast<size_t>(std::max(alignment, 1))); }
+
+    std::byte* Data() { return m_target.empty() ? m_buffer.get() : m_target.data(); }
+    size_t Size() const { return m_size; }
+    GLint GetAlignment() const { return static_cast<GLint>(m_alignment); }
+    // True if a push didn't fit into the target since the last Clear(), in which case the pushed data is incomplete.
+    bool Overflowed() const { return m_overflowed; }
+    // Keeps the internal buffer's capacity.
+    void Clear()
+    {
+        m_size = 0;
+        m_overflowed = false;
+    }
+
+private:
+    size_t AlignUp(size_t size) const { return (size + m_alignment - 1) & ~(m_alignment - 1); }
+
+    // Moves the end `size` bytes further, growing the internal buffer if needed. Returns false if they don't fit into the
+    // target, in which case the required size keeps being counted, so the owner can grow the target and push everything
+    // again.
+    bool Advance(size_t size)
+    {
+        m_size += size;
+        if (!m_target.empty()) {
+            m_overflowed = m_overflowed || m_size > m_target.size();
+            return !m_overflowed;
+        }
+
+        Grow(m_size);
+        return true;
+    }
+
+    // Reallocates the internal buffer, without initializing it, to at least `capacity` bytes.
+    void Grow(size_t capacity)
+    {
+        if (capacity <= m_capacity) {
+            return;
+        }
+
+        capacity = std::max(capacity, m_capacity * 2);
+        auto buffer = std::make_unique_for_overwrite<std::byte[]>(capacity);
+        if (m_buffer) {
+            std::memcpy(buffer.get(), m_buffer.get(), m_capacity);
+        }
+        m_buffer = std::move(buffer);
+        m_capacity = capacity;
+    }
+
+    std::unique_ptr<std::byte[]> m_buffer;
+    size_t m_capacity {};
+    std::span<std::byte> m_target;
+    size_t m_size {};
+    bool m_overflowed {false};
+
+    // A power of two.
+    size_t m_alignment {1};
+};
+
+} // namespace Glitter::Util
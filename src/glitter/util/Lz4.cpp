@@ -0,0 +1,152 @@
+#include "util/Lz4.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace Glitter::Util {
+
+namespace {
+
+    constexpr size_t MIN_MATCH = 4;
+    // The format requires the last 5 bytes to be literals, and the last match to start 12 bytes before the end.
+    constexpr size_t LAST_LITERALS = 5;
+    constexpr size_t MATCH_START_LIMIT = 12;
+    constexpr size_t MAX_OFFSET = 65535;
+    constexpr std::uint32_t HASH_BITS = 16;
+
+    std::uint32_t Read32(std::span<const std::byte> data, size_t pos)
+    {
+        std::uint32_t value = 0;
+        std::memcpy(&value, data.data() + pos, sizeof(value));
+        return value;
+    }
+
+    std::uint32_t Hash(std::uint32_t sequence) { return (sequence * 2654435761u) >> (32 - HASH_BITS); }
+
+    // Lengths past the 15 of their token's nibble continue in bytes of 255, ended by a smaller one.
+    void WriteLength(std::vector<std::byte>& output, size_t length)
+    {
+        for (length -= 15; length >= 255; length -= 255) {
+            output.push_back(std::byte {255});
+        }
+        output.push_back(static_cast<std::byte>(length));
+    }
+
+    bool ReadLength(std::span<const std::byte> source, size_t& pos, size_t& length)
+    {
+        std::uint8_t value = 255;
+        while (value == 255) {
+            if (pos == source.size()) {
+                return false;
+            }
+            value = static_cast<std::uint8_t>(source[pos++]);
+            length += value;
+        }
+        return true;
+    }
+
+    void WriteLiterals(std::vector<std::byte>& output, std::span<const std::byte> literals, size_t matchLength)
+    {
+        size_t matchNibble = matchLength == 0 ? 0 : std::min<size_t>(matchLength - MIN_MATCH, 15);
+        output.push_back(static_cast<std::byte>((std::min<size_t>(literals.size(), 15) << 4) | matchNibble));
+        if (literals.size() >= 15) {
+            WriteLength(output, literals.size());
+        }
+        output.insert(output.end(), literals.begin(), literals.end());
+    }
+
+} // namespace
+
+std::vector<std::byte> CompressLz4Block(std::span<const std::byte> source)
+{
+    std::vector<std::byte> output {};
+    output.reserve(source.size() + source.size() / 255 + 16);
+
+    // The last position each hashed 4 bytes were seen at, a candidate only checked against the actual bytes.
+    std::vector<std::uint32_t> table(size_t {1} << HASH_BITS, 0);
+    size_t anchor = 0;
+    if (source.size() > MATCH_START_LIMIT) {
+        size_t matchEnd = source.size() - LAST_LITERALS;
+        size_t pos = 0;
+        while (pos < source.size() - MATCH_START_LIMIT) {
+            std::uint32_t sequence = Read32(source, pos);
+            std::uint32_t& entry = table[Hash(sequence)];
+            size_t candidate = entry;
+            entry = static_cast<std::uint32_t>(pos);
+            if (candidate >= pos || pos - candidate > MAX_OFFSET || Read32(source, candidate) != sequence) {
+                pos++;
+                continue;
+            }
+
+            size_t matchLength = MIN_MATCH;
+            while (pos + matchLength < matchEnd && source[candidate + matchLength] == source[pos + matchLength]) {
+                matchLength++;
+            }
+
+            WriteLiterals(output, source.subspan(anchor, pos - anchor), matchLength);
+            size_t offset = pos - candidate;
+            output.push_back(static_cast<std::byte>(offset & 0xFF));
+            output.push_back(static_cast<std::byte>(offset >> 8));
+            if (matchLength - MIN_MATCH >= 15) {
+                WriteLength(output, matchLength - MIN_MATCH);
+            }
+            pos += matchLength;
+            anchor = pos;
+        }
+    }
+
+    // The last sequence is only literals.
+    WriteLiterals(output, source.subspan(anchor), 0);
+    return output;
+}
+
+bool DecompressLz4Block(std::span<const std::byte> source, std::span<std::byte> destination)
+{
+    size_t in = 0;
+    size_t out = 0;
+    while (in < source.size()) {
+        auto token = static_cast<std::uint8_t>(source[in++]);
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !ReadLength(source, in, literalLength)) {
+            return false;
+        }
+        if (literalLength > source.size() - in || literalLength > destination.size() - out) {
+            return false;
+        }
+        std::copy_n(source.data() + in, literalLength, destination.data() + out);
+        in += literalLength;
+        out += literalLength;
+        if (in == source.size()) {
+            break;
+        }
+
+        if (source.size() - in < 2) {
+            return false;
+        }
+        size_t offset = static_cast<size_t>(source[in]) | (static_cast<size_t>(source[in + 1]) << 8);
+        in += 2;
+        size_t matchLength = token & 0xF;
+        if (matchLength == 15 && !ReadLength(source, in, matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > out || matchLength > destination.size() - out) {
+            return false;
+        }
+
+        // A match closer than its length repeats the bytes it's still writing, so it's copied a byte at a time.
+        std::byte* match = destination.data() + out - offset;
+        if (offset >= matchLength) {
+            std::memcpy(destination.data() + out, match, matchLength);
+        } else {
+            for (size_t i = 0; i < matchLength; i++) {
+                destination[out + i] = match[i];
+            }
+        }
+        out += matchLength;
+    }
+    return out == destination.size();
+}
+
+} // namespace Glitter::Util
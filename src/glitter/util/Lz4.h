@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace Glitter::Util {
+
+// The LZ4 block format, without the frame around it: sequences of literals followed by a match of at least 4 bytes at
+// most 64 KiB back. It decodes at memory speed, which is what the compressed AssetPack entries are for, and the greedy
+// compressor is fast enough for GlitterPackTool to run over the whole data directory.
+
+// Compresses `source` into a single block, which may be larger than `source` if it doesn't compress.
+std::vector<std::byte> CompressLz4Block(std::span<const std::byte> source);
+
+// Decompresses the block `source` into `destination`, which must be exactly the size it decompresses to. Returns false
+// if the block is corrupt or doesn't fill `destination`, without reading or writing out of bounds.
+bool DecompressLz4Block(std::span<const std::byte> source, std::span<std::byte> destination);
+
+} // namespace Glitter::Util
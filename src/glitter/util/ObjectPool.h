@@ -0,0 +1,108 @@
+#pragma once
+
+#include "util/RingQueue.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Glitter::Util {
+
+// Keeps objects in blocks of `BlockSize`, each aligned to a cache line, so that adding objects never moves the others and
+// references to them stay valid, unlike with a growing std::vector. Objects are addressed by index, for tables indexed
+// alike to mirror them. A removed object leaves a default-constructed T behind, whose index the next Add() reuses from a
+// free list, so that objects added and removed over and over neither grow the pool nor fragment the heap. Adding and
+// removing an object takes constant time.
+//
+// Iterating visits every index below Size(), the removed ones included, which IsLive() tells apart.
+template <typename T, size_t BlockSize = 64> class ObjectPool {
+public:
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Adds `object` past every other, so that objects appended in a row have consecutive indices. Returns its index.
+    std::uint32_t Append(T object)
+    {
+        auto index = static_cast<std::uint32_t>(m_size);
+        if (m_size == m_blocks.size() * BlockSize) {
+            m_blocks.push_back(std::make_unique<Block>());
+        }
+        m_size++;
+        m_live.push_back(true);
+        (*this)[index] = std::move(object);
+        return index;
+    }
+
+    // Adds `object` at the index removed last, or past every other if there's none. Returns its index.
+    std::uint32_t Add(T object)
+    {
+        if (m_freeIndices.empty()) {
+            return Append(std::move(object));
+        }
+
+        std::uint32_t index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+        m_live[index] = true;
+        (*this)[index] = std::move(object);
+        return index;
+    }
+
+    // Resets the object at `index`, which must have been added and not removed since, and frees its index.
+    void Remove(std::uint32_t index)
+    {
+        (*this)[index] = T {};
+        m_live[index] = false;
+        m_freeIndices.push_back(index);
+    }
+
+    T& operator[](size_t index) { return m_blocks[index / BlockSize]->m_objects[index % BlockSize]; }
+    const T& operator[](size_t index) const { return m_blocks[index / BlockSize]->m_objects[index % BlockSize]; }
+
+    size_t Size() const { return m_size; }
+    bool IsEmpty() const { return m_size == 0; }
+    size_t GetFreeCount() const { return m_freeIndices.size(); }
+    // Whether the object at `index`, below Size(), was added and not removed since.
+    bool IsLive(size_t index) const { return m_live[index]; }
+
+    template <typename Pool, typename Object> class Iterator {
+    public:
+        Iterator(Pool* pool, size_t index)
+            : m_pool(pool)
+            , m_index(index)
+        {
+        }
+
+        Object& operator*() const { return (*m_pool)[m_index]; }
+        Iterator& operator++()
+        {
+            m_index++;
+            return *this;
+        }
+        bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+
+    private:
+        Pool* m_pool;
+        size_t m_index;
+    };
+
+    Iterator<ObjectPool, T> begin() { return {this, 0}; }
+    Iterator<ObjectPool, T> end() { return {this, m_size}; }
+    Iterator<const ObjectPool, const T> begin() const { return {this, 0}; }
+    Iterator<const ObjectPool, const T> end() const { return {this, m_size}; }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Block {
+        std::array<T, BlockSize> m_objects {};
+    };
+
+    std::vector<std::unique_ptr<Block>> m_blocks;
+    size_t m_size {};
+    std::vector<std::uint32_t> m_freeIndices;
+    std::vector<bool> m_live;
+};
+
+} // namespace Glitter::Util
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "core/JobSystem.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Glitter::Util {
+
+// Stable LSD radix sort of `items` by the 64-bit key returned by `getKey`, one byte per pass. `scratch` must be at least
+// as large as `items`. Passes where every key shares the same byte are skipped, so keys with mostly-constant high bits
+// only pay for the bytes that actually vary.
+template <typename T, typename GetKey> void RadixSort(std::span<T> items, std::span<T> scratch, GetKey getKey)
+{
+    constexpr size_t RADIX = 256;
+    constexpr size_t PASSES = sizeof(std::uint64_t);
+
+    if (items.size() < 2) {
+        return;
+    }
+
+    // Build every pass' histogram in a single read of the keys.
+    std::array<std::array<size_t, RADIX>, PASSES> histograms {};
+    for (const T& item : items) {
+        std::uint64_t key = getKey(item);
+        for (size_t pass = 0; pass < PASSES; pass++) {
+            histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    std::span<T> src = items;
+    std::span<T> dst = scratch.first(items.size());
+    for (size_t pass = 0; pass < PASSES; pass++) {
+        auto& histogram = histograms[pass];
+
+        // Skip the pass when every key falls into the same bucket.
+        if (histogram[(getKey(src[0]) >> (pass * 8)) & 0xFF] == items.size()) {
+            continue;
+        }
+
+        // Turn the counts into the starting offset of each bucket.
+        size_t offset = 0;
+        for (size_t& count : histogram) {
+            size_t bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+
+        for (const T& item : src) {
+            dst[histogram[(getKey(item) >> (pass * 8)) & 0xFF]++] = item;
+        }
+        std::swap(src, dst);
+    }
+
+    // An odd number of passes leaves the result in the scratch buffer.
+    if (src.data() != items.data()) {
+        std::copy(src.begin(), src.end(), items.begin());
+    }
+}
+
+// RadixSort() spread over `jobSystem`, for lists long enough to pay for it. Each pass counts the keys of every range of
+// `grainSize` items in parallel, turns the counts into where each range's items of each bucket start, and scatters the
+// ranges in parallel. Stable too: within a bucket, the ranges' items land in the order of the ranges.
+template <typename T, typename GetKey>
+void ParallelRadixSort(Core::JobSystem& jobSystem, std::span<T> items, std::span<T> scratch, GetKey getKey, size_t grainSize)
+{
+    constexpr size_t RADIX = 256;
+    constexpr size_t PASSES = sizeof(std::uint64_t);
+
+    grainSize = std::max<size_t>(grainSize, 1);
+    if (items.size() <= grainSize) {
+        RadixSort(items, scratch, getKey);
+        return;
+    }
+
+    // Every pass' histogram of each range, in a single read of the keys, summed to skip the passes RadixSort() would.
+    size_t rangeCount = (items.size() + grainSize - 1) / grainSize;
+    std::vector<std::array<std::array<size_t, RADIX>, PASSES>> rangeHistograms(rangeCount);
+    jobSystem.ParallelFor(items.size(), grainSize, [&](size_t begin, size_t end) {
+        auto& histograms = rangeHistograms[begin / grainSize];
+        for (const T& item : items.subspan(begin, end - begin)) {
+            std::uint64_t key = getKey(item);
+            for (size_t pass = 0; pass < PASSES; pass++) {
+                histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+            }
+        }
+    });
+
+    std::vector<std::array<size_t, RADIX>> rangeOffsets(rangeCount);
+    std::span<T> src = items;
+    std::span<T> dst = scratch.first(items.size());
+    bool firstPass = true;
+    for (size_t pass = 0; pass < PASSES; pass++) {
+        std::array<size_t, RADIX> totals {};
+        for (const auto& histograms : rangeHistograms) {
+            for (size_t bucket = 0; bucket < RADIX; bucket++) {
+                totals[bucket] += histograms[pass][bucket];
+            }
+        }
+        if (totals[(getKey(src[0]) >> (pass * 8)) & 0xFF] == items.size()) {
+            continue;
+        }
+
+        // The first read counted the ranges of the original order, the later passes recount them as the items moved.
+        if (!firstPass) {
+            jobSystem.ParallelFor(items.size(), grainSize, [&](size_t begin, size_t end) {
+                std::array<size_t, RADIX>& histogram = rangeHistograms[begin / grainSize][pass];
+                histogram.fill(0);
+                for (const T& item : src.subspan(begin, end - begin)) {
+                    histogram[(getKey(item) >> (pass * 8)) & 0xFF]++;
+                }
+            });
+        }
+        firstPass = false;
+
+        // Each bucket starts after the smaller buckets, and each range's part of it after the previous ranges'.
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < RADIX; bucket++) {
+            for (size_t rangeIdx = 0; rangeIdx < rangeCount; rangeIdx++) {
+                rangeOffsets[rangeIdx][bucket] = offset;
+                offset += rangeHistograms[rangeIdx][pass][bucket];
+            }
+        }
+
+        jobSystem.ParallelFor(items.size(), grainSize, [&](size_t begin, size_t end) {
+            std::array<size_t, RADIX>& offsets = rangeOffsets[begin / grainSize];
+            for (const T& item : src.subspan(begin, end - begin)) {
+                dst[offsets[(getKey(item) >> (pass * 8)) & 0xFF]++] = item;
+            }
+        });
+        std::swap(src, dst);
+    }
+
+    if (src.data() != items.data()) {
+        jobSystem.ParallelFor(items.size(), grainSize, [&](size_t begin, size_t end) {
+            std::copy(src.begin() + static_cast<std::ptrdiff_t>(begin), src.begin() + static_cast<std::ptrdiff_t>(end),
+                items.begin() + static_cast<std::ptrdiff_t>(begin));
+        });
+    }
+}
+
+} // namespace Glitter::Util
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace Glitter::Util {
+
+// PCG32 (XSH RR), a small and fast generator whose state fits in two words. Generators of the same seed but different
+// streams produce independent sequences, so that each job of a parallel loop can draw from a stream of its own and still
+// produce the same numbers whatever thread runs it.
+class Pcg32 {
+public:
+    explicit Pcg32(std::uint64_t seed, std::uint64_t stream = 0)
+        : m_increment((stream << 1u) | 1u)
+    {
+        Next();
+        m_state += seed;
+        Next();
+    }
+
+    std::uint32_t Next()
+    {
+        std::uint64_t state = m_state;
+        m_state = state * 6364136223846793005ULL + m_increment;
+        auto xorShifted = static_cast<std::uint32_t>(((state >> 18u) ^ state) >> 27u);
+        auto rotation = static_cast<std::uint32_t>(state >> 59u);
+        return (xorShifted >> rotation) | (xorShifted << ((32u - rotation) & 31u));
+    }
+
+    // In [0, `bound`), by the multiply-shift reduction. Its bias is negligible for the bounds this is used with.
+    std::uint32_t NextBelow(std::uint32_t bound)
+    {
+        return static_cast<std::uint32_t>((static_cast<std::uint64_t>(Next()) * bound) >> 32u);
+    }
+
+    // In [0, 1), from the top 24 bits.
+    float NextFloat() { return static_cast<float>(Next() >> 8u) * 0x1p-24f; }
+    float NextFloat(float min, float max) { return min + NextFloat() * (max - min); }
+
+    // A direction evenly spread over the unit sphere, from a point in the unit ball.
+    glm::vec3 NextDirection()
+    {
+        while (true) {
+            glm::vec3 point(NextFloat(-1.0f, 1.0f), NextFloat(-1.0f, 1.0f), NextFloat(-1.0f, 1.0f));
+            float lengthSquared = glm::dot(point, point);
+            if (lengthSquared > 1e-6f && lengthSquared <= 1.0f) {
+                return point / std::sqrt(lengthSquared);
+            }
+        }
+    }
+
+private:
+    std::uint64_t m_state {};
+    std::uint64_t m_increment;
+};
+
+} // namespace Glitter::Util
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace Glitter::Util {
+
+// The indices written by different threads are kept this far apart, so that they don't bounce a cache line between the
+// cores. std::hardware_destructive_interference_size isn't portable across compilers.
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Bounded ring queues handing values from one thread to another without locks, for the frame-critical handoffs where a
+// mutex would have the main thread wait on a loader. Their capacity is rounded up to a power of two, and pushing into a
+// full queue fails rather than blocking, it's up to the producer to retry or drop the value.
+
+// From a single producer thread to a single consumer thread. Each side only writes its own index, and reads the other's
+// only once the copy it cached says the ring is full, or empty.
+template <typename T> class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity)
+        : m_mask(std::bit_ceil(std::max<size_t>(capacity, 1)) - 1)
+        , m_slots(std::make_unique<Slot[]>(m_mask + 1))
+    {
+    }
+    ~SpscQueue()
+    {
+        while (TryPop()) {
+        }
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer only. Returns false, leaving `value` as it was, if the queue is full.
+    template <typename U> bool TryPush(U&& value)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask) {
+                return false;
+            }
+        }
+
+        std::construct_at(m_slots[tail & m_mask].Get(), std::forward<U>(value));
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only.
+    std::optional<T> TryPop()
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return std::nullopt;
+            }
+        }
+
+        T* slot = m_slots[head & m_mask].Get();
+        std::optional<T> value(std::move(*slot));
+        std::destroy_at(slot);
+        m_head.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    // Exact only while neither side is pushing or popping.
+    size_t GetSize() const
+    {
+        size_t head = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - head;
+    }
+    size_t GetCapacity() const { return m_mask + 1; }
+
+private:
+    struct Slot {
+        T* Get() { return std::launder(reinterpret_cast<T*>(m_storage)); }
+
+        alignas(T) std::byte m_storage[sizeof(T)];
+    };
+
+    size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+
+    // The consumer's.
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head {};
+    size_t m_cachedTail {};
+    // The producer's.
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail {};
+    size_t m_cachedHead {};
+};
+
+// From any number of producer threads to a single consumer thread. Producers claim a slot by advancing the shared tail,
+// and publish it through the slot's sequence number, which the consumer waits on (Dmitry Vyukov's bounded queue).
+template <typename T> class MpscQueue {
+public:
+    explicit MpscQueue(size_t capacity)
+        : m_mask(std::bit_ceil(std::max<size_t>(capacity, 1)) - 1)
+        , m_cells(std::make_unique<Cell[]>(m_mask + 1))
+    {
+        for (size_t cellIdx = 0; cellIdx <= m_mask; cellIdx++) {
+            m_cells[cellIdx].m_sequence.store(cellIdx, std::memory_order_relaxed);
+        }
+    }
+    ~MpscQueue()
+    {
+        while (TryPop()) {
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Any thread. Returns false, leaving `value` as it was, if the queue is full.
+    template <typename U> bool TryPush(U&& value)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true) {
+            cell = &m_cells[tail & m_mask];
+            // The sequence is the tail it's free at, or one past the tail it was filled at until it's popped.
+            auto lag = static_cast<std::intptr_t>(cell->m_sequence.load(std::memory_order_acquire) - tail);
+            if (lag == 0) {
+                if (m_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lag < 0) {
+                return false;
+            } else {
+                tail = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        std::construct_at(cell->Get(), std::forward<U>(value));
+        cell->m_sequence.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. A value pushed after another that's still being written waits for it.
+    std::optional<T> TryPop()
+    {
+        Cell& cell = m_cells[m_head & m_mask];
+        if (cell.m_sequence.load(std::memory_order_acquire) != m_head + 1) {
+            return std::nullopt;
+        }
+
+        std::optional<T> value(std::move(*cell.Get()));
+        std::destroy_at(cell.Get());
+        cell.m_sequence.store(m_head + m_mask + 1, std::memory_order_release);
+        m_head++;
+        return value;
+    }
+
+    size_t GetCapacity() const { return m_mask + 1; }
+
+private:
+    struct Cell {
+        T* Get() { return std::launder(reinterpret_cast<T*>(m_storage)); }
+
+        std::atomic<size_t> m_sequence;
+        alignas(T) std::byte m_storage[sizeof(T)];
+    };
+
+    size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail {};
+    // The consumer's.
+    alignas(CACHE_LINE_SIZE) size_t m_head {};
+};
+
+} // namespace Glitter::Util
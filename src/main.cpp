@@ -1,25 +1,125 @@
 #include "glitter/Config.h"
+#include "glitter/core/AllocationTracker.h"
+#include "glitter/core/Benchmark.h"
+#include "glitter/core/CameraRecording.h"
+#include "glitter/core/Coroutine.h"
+#include "glitter/core/CpuFeatures.h"
+#include "glitter/core/CpuProfiler.h"
+#include "glitter/core/FrameOutput.h"
+#include "glitter/core/FrameStats.h"
+#include "glitter/core/FrameThread.h"
 #include "glitter/ImGuiConfig.h"
+#include "glitter/core/JobSystem.h"
+#include "glitter/core/LogForwarder.h"
+#include "glitter/core/Logging.h"
+#include "glitter/core/RenderDocCapture.h"
+#include "glitter/core/RenderServer.h"
+#include "glitter/core/TaskGraph.h"
+#include "glitter/core/Telemetry.h"
+#include "glitter/render/BatchCostSampler.h"
+#include "glitter/render/DebugDraw.h"
+#include "glitter/render/DepthPrepass.h"
+#include "glitter/render/DrawKey.h"
+#include "glitter/render/FramePacer.h"
+#include "glitter/render/FrameReadback.h"
+#include "glitter/render/FrustumCulling.h"
+#include "glitter/render/GLDebugOutput.h"
+#include "glitter/render/GLExtensions.h"
+#include "glitter/render/GLTrace.h"
+#include "glitter/render/GeometryPool.h"
+#include "glitter/render/GpuBufferAllocator.h"
+#include "glitter/render/GpuCullStatistics.h"
+#include "glitter/render/GpuMemory.h"
+#include "glitter/render/GpuProfiler.h"
+#include "glitter/render/HiZPyramid.h"
+#include "glitter/render/ImpostorAtlas.h"
+#include "glitter/render/LightClusters.h"
+#include "glitter/render/MeshStreamer.h"
+#include "glitter/render/MipGenerator.h"
+#include "glitter/render/NodePicker.h"
+#include "glitter/render/NodeSwarm.h"
+#include "glitter/render/OcclusionBuffer.h"
+#include "glitter/render/OcclusionQueries.h"
+#include "glitter/render/PendingProgram.h"
+#include "glitter/render/PostProcessor.h"
+#include "glitter/render/ProgramCache.h"
+#include "glitter/render/QualityGovernor.h"
+#include "glitter/render/RenderGraph.h"
+#include "glitter/render/RenderStats.h"
+#include "glitter/render/RenderTargetPool.h"
+#include "glitter/render/ResolutionScaler.h"
+#include "glitter/render/ShaderData.h"
+#include "glitter/render/ShadingRateImage.h"
+#include "glitter/render/ShadowCache.h"
+#include "glitter/render/SkinnedMeshes.h"
+#include "glitter/render/StaticBatches.h"
+#include "glitter/render/StereoTargets.h"
+#include "glitter/render/StreamBuffer.h"
+#include "glitter/render/SubmitFlusher.h"
+#include "glitter/render/TemporalUpsampler.h"
+#include "glitter/render/TextureCache.h"
+#include "glitter/render/TextureDecoder.h"
+#include "glitter/render/TextureStreamer.h"
+#include "glitter/render/TextureUploader.h"
+#include "glitter/render/UploadContext.h"
+#include "glitter/render/VertexLayout.h"
+#include "glitter/render/ViewLayout.h"
+#include "glitter/scene/Animation.h"
+#include "glitter/scene/BVH.h"
+#include "glitter/scene/EntityWorld.h"
+#include "glitter/scene/GltfImporter.h"
+#include "glitter/scene/GltfLoader.h"
+#include "glitter/scene/NodeStore.h"
+#include "glitter/scene/SceneGenerator.h"
+#include "glitter/scene/SceneSnapshot.h"
+#include "glitter/scene/Skeletons.h"
+#include "glitter/scene/SpatialHashGrid.h"
+#include "glitter/scene/WorldStreamer.h"
+#include "glitter/util/AssetPack.h"
+#include "glitter/util/DirtyRanges.h"
+#include "glitter/util/EmbeddedShaders.h"
 #include "glitter/util/File.h"
+#include "glitter/util/FileWatcher.h"
+#include "glitter/util/FrameArena.h"
+#include "glitter/util/LinearAllocator.h"
+#include "glitter/util/ObjectPool.h"
+#include "glitter/util/RadixSort.h"
+#include "glitter/util/Random.h"
 
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
 #include <glad/glad.h>
 
-#include <cgltf.h>
-#include <stb_image.h>
-
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <chrono>
+#include <deque>
 #include <expected>
+#include <filesystem>
+#include <format>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <memory_resource>
 #include <optional>
 #include <print>
+#include <ranges>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include <cfloat>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -43,173 +143,403 @@ template <typename Into, typename From> constexpr Into narrow_into(From x)
     return static_cast<Into>(x);
 }
 
-class LinearAllocator {
-public:
-    LinearAllocator() = default;
+// In Primitive::m_firstInfluence.
+constexpr std::uint32_t NO_INFLUENCES = UINT32_MAX;
 
-    // Returns the offset after the object in the buffer.
-    template <typename T> size_t Push(T& t)
-    {
-        InitializeAlignment();
+// In Primitive::m_streamedSlot.
+constexpr std::uint32_t NO_STREAMED_LODS = UINT32_MAX;
 
-        // Calculate total amount of bytes that will be pushed.
-        size_t sizeAfterT = m_buffer.size() + sizeof(T);
-        size_t paddingRequired = sizeAfterT % m_alignment == 0 ? 0 : m_alignment - (sizeAfterT % m_alignment);
+// In place of the Mesh ID of the static batches' draws, which merge several Meshes.
+constexpr std::uint32_t STATIC_BATCH_MESH = UINT32_MAX;
 
-        size_t offsetBeforePush = m_buffer.size();
-        m_buffer.resize(sizeAfterT + paddingRequired);
+// In place of the Node data page of the static batches' draws, which fetch their data from m_staticBatchData instead.
+constexpr std::uint32_t STATIC_BATCH_NODE_PAGE = UINT32_MAX;
 
-        // Push the object.
-        std::memcpy(m_buffer.data() + offsetBeforePush, &t, sizeof(T));
+// A simplified index list of a Primitive, drawn with the Primitive's vertices.
+struct PrimitiveLod {
+    GLuint m_firstIndex;
+    GLsizei m_elementCount;
 
-        // Push the padding.
-        std::memset(m_buffer.data() + offsetBeforePush + sizeof(T), 0, paddingRequired);
+    // Cells along the longest axis of the grid the LOD was clustered on.
+    std::uint32_t m_resolution;
+};
 
-        return offsetBeforePush;
-    }
+struct Primitive {
+    // Offsets into the buffers of page m_page of the shared Glitter::Render::GeometryPool.
+    std::uint32_t m_page;
+    GLint m_baseVertex;
+    GLuint m_firstIndex;
+    GLuint m_baseTexture;
+    GLsizei m_elementCount;
+    GLuint m_vertexCount;
+    // Into Glitter::Render::SkinnedMeshes' influences, or NO_INFLUENCES if the Primitive isn't skinned.
+    std::uint32_t m_firstInfluence;
+    // Into Glitter::Render::MeshStreamer, or NO_STREAMED_LODS if all of the Primitive's levels stay resident. Streamed,
+    // m_firstIndex and m_elementCount are its finest resident level, and m_lods the coarser ones.
+    std::uint32_t m_streamedSlot;
+
+    // From the finest to the coarsest.
+    std::vector<PrimitiveLod> m_lods;
+
+    // Culled one by one by GPU culling, their index ranges are relative to m_firstIndex.
+    std::vector<Glitter::Scene::GltfMeshlet> m_meshlets;
+};
 
-    std::byte* Data() { return m_buffer.data(); }
-    size_t Size() { return m_buffer.size(); }
-    GLint GetAlignment()
-    {
-        InitializeAlignment();
-        return m_alignment;
-    }
-    void Clear() { m_buffer.clear(); }
+struct Mesh {
+    std::vector<Primitive> m_primitives;
 
-private:
-    void InitializeAlignment()
-    {
-        if (!m_initializedAlignment) {
-            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &m_alignment);
-            m_initializedAlignment = true;
-        }
-    }
+    // Axis-Aligned Bounding Box for frustum culling.
+    Glitter::Scene::AABB m_aabb;
+
+    // Maps the vertex positions of the primitives into Mesh space, part of the drawn model matrix.
+    glm::mat4 m_dequantize {1.0f};
 
-    std::vector<std::byte> m_buffer;
+    // Index into the material table, given to the Nodes added for the Mesh.
+    std::uint32_t m_materialID {};
 
-    bool m_initializedAlignment {false};
-    GLint m_alignment {};
+    // Its layer of the impostor atlas, if it got one, and the bounding sphere it was baked around in Mesh space.
+    std::optional<std::uint32_t> m_impostorLayer {};
+    glm::vec4 m_impostorSphere {};
+
+    // Rasterized by the CPU occlusion culling when its Nodes are among the largest on screen, none if it can't occlude.
+    std::shared_ptr<const Glitter::Render::OccluderMesh> m_occluder;
 };
 
-struct Primitive {
-    GLuint m_vbo;
-    GLuint m_ebo;
-    GLuint m_baseTexture;
-    GLsizei m_elementCount;
+// The Nodes of a loaded asset, added once its Meshes are registered.
+struct LoadedScene {
+    std::string m_path;
+    // Index of the asset's first Mesh among the Meshes registered along with it, and its Mesh count.
+    size_t m_firstMesh;
+    size_t m_meshCount;
+    std::vector<Glitter::Scene::GltfNode> m_nodes;
+    std::vector<Glitter::Scene::GltfJoint> m_joints;
+    std::vector<Glitter::Scene::GltfSkinJoint> m_skinJoints;
+    std::vector<Glitter::Scene::GltfSkin> m_skins;
+    Glitter::Scene::GltfAnimations m_animations;
 };
 
-struct AABB {
-    glm::vec3 m_localMin;
-    glm::vec3 m_localMax;
+// A Node drawing the skinned vertices of its own SkinnedMeshes instance, deformed by the joints of a Skeletons instance.
+struct SkinnedNode {
+    Glitter::Scene::NodeHandle m_handle;
+    std::uint32_t m_instance;
+    std::uint32_t m_skeleton;
+    // The copy of its Mesh drawing the instance, removed along with the Node.
+    std::uint32_t m_mesh;
 };
 
-struct Mesh {
-    std::vector<Primitive> m_primitives;
+// How fast a point light entity orbits the scene's vertical axis, in radians per second. Its Glitter::Render::PointLight
+// component is where it starts from.
+struct LightOrbit {
+    float m_speed;
+};
 
-    // Axis-Aligned Bounding Box for frustum culling.
-    AABB m_aabb;
+// The Meshes registered for an asset, none if it failed to load.
+struct AssetMeshes {
+    size_t m_firstMesh;
+    size_t m_meshCount;
 };
 
-// Vertex Attributes!
-struct MeshVertex {
-    float x, y, z;
-    float u, v;
-    float nx, ny, nz;
+// What the Main program draws the Nodes as, picked in the Debug View settings. The views from Overdraw on visualize where
+// the GPU spends its time in place of the shading, so they're drawn without textures, and only by the Main program.
+enum class DebugView : std::uint8_t {
+    Shaded,
+    Normals,
+    // The fragments drawn over each pixel, added up with the depth test off.
+    Overdraw,
+    // Like Overdraw, with the helper invocations of the 2x2 quads a triangle only partly covers added to its pixels.
+    QuadOverdraw,
+    // The triangles per pixel of each fragment's triangle, from its size on screen. Needs GL_NV_fragment_shader_barycentric.
+    TriangleDensity,
+    // The LOD level each Node is drawn at.
+    Lod,
+    // How each Node got past the culling, see DrawCullState.
+    CullState,
+};
+constexpr size_t DEBUG_VIEW_COUNT = 7;
+
+constexpr bool IsVisualization(DebugView view) { return view >= DebugView::Overdraw; }
+// The views blended additively, over the Nodes' own depth test and blending.
+constexpr bool IsAdditive(DebugView view) { return view == DebugView::Overdraw || view == DebugView::QuadOverdraw; }
+// The views reading each draw's LOD level and cull state from its draw info, written on the CPU.
+constexpr bool HasDrawInfo(DebugView view) { return view == DebugView::Lod || view == DebugView::CullState; }
+
+// How a drawn Node got past the culling, shown by DebugView::CullState.
+enum class DrawCullState : std::uint8_t {
+    // Not tested against the frustum.
+    Untested,
+    Inside,
+    // Crossing the frustum's planes.
+    Intersecting,
+    // Within half the draw distance or twice the minimum size of being dropped by the contribution culling.
+    NearlyCulled,
+    // Drawn along with the other static Nodes of its batch, culled by cell.
+    Batched,
 };
 
-[[nodiscard]] std::optional<GLuint> CreateShader(GLenum type, const char* src)
+// Packs the draw info of a Node, read by MainVS.glsl in the views with HasDrawInfo().
+constexpr GLuint PackDrawInfo(std::uint32_t lod, DrawCullState cullState)
 {
-    if (type != GL_VERTEX_SHADER && type != GL_FRAGMENT_SHADER) {
-        return std::nullopt;
-    }
-
-    GLint res = GL_FALSE;
+    return std::min(lod, 0xFFu) | (static_cast<GLuint>(cullState) << 8);
+}
 
-    GLuint shader = glCreateShader(type);
-    glObjectLabel(GL_SHADER, shader, -1, type == GL_VERTEX_SHADER ? "Vertex Shader" : "Fragment Shader");
-    glShaderSource(shader, 1, &src, nullptr);
-    glCompileShader(shader);
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &res);
+// Specializations of the Main program, each compiling in only what its Nodes need through a define of MainVS.glsl and
+// MainFS.glsl. Combined into the program index of a Node's Glitter::Render::DrawKey.
+constexpr std::uint32_t MAIN_PERMUTATION_TRANSPARENT = 1 << 0;
+constexpr std::uint32_t MAIN_PERMUTATION_UNTEXTURED = 1 << 1;
+// Only combined with MAIN_PERMUTATION_TRANSPARENT.
+constexpr std::uint32_t MAIN_PERMUTATION_WEIGHTED_OIT = 1 << 2;
+// The DebugView, in the bits from this one on.
+constexpr std::uint32_t MAIN_PERMUTATION_DEBUG_VIEW_SHIFT = 3;
+constexpr size_t MAIN_PERMUTATION_COUNT = DEBUG_VIEW_COUNT << MAIN_PERMUTATION_DEBUG_VIEW_SHIFT;
+
+constexpr DebugView GetDebugView(std::uint32_t permutation)
+{
+    return static_cast<DebugView>(permutation >> MAIN_PERMUTATION_DEBUG_VIEW_SHIFT);
+}
 
-    if (res != GL_TRUE) {
-        {
-            std::array<GLchar, 512> error {};
-            glGetShaderInfoLog(shader, 512, nullptr, error.data());
-            spdlog::error("[{}] {}", type == GL_VERTEX_SHADER ? "vertex" : "fragment", error.data());
-        }
-        glDeleteShader(shader);
-        return std::nullopt;
+std::string GetMainPermutationDefines(std::uint32_t permutation)
+{
+    constexpr std::array DEBUG_VIEW_DEFINES = std::to_array<const char*>({
+        "",
+        "#define GLITTER_DEBUG_NORMALS\n",
+        "#define GLITTER_DEBUG_OVERDRAW\n",
+        "#define GLITTER_DEBUG_QUAD_OVERDRAW\n",
+        "#define GLITTER_DEBUG_TRIANGLE_DENSITY\n",
+        "#define GLITTER_DEBUG_LOD\n",
+        "#define GLITTER_DEBUG_CULL_STATE\n",
+    });
+    static_assert(DEBUG_VIEW_DEFINES.size() == DEBUG_VIEW_COUNT);
+
+    std::string defines {};
+    if ((permutation & MAIN_PERMUTATION_TRANSPARENT) != 0) {
+        defines += "#define GLITTER_TRANSPARENT\n";
+    }
+    if ((permutation & MAIN_PERMUTATION_UNTEXTURED) != 0) {
+        defines += "#define GLITTER_UNTEXTURED\n";
     }
+    defines += DEBUG_VIEW_DEFINES[static_cast<size_t>(GetDebugView(permutation))];
+    if ((permutation & MAIN_PERMUTATION_WEIGHTED_OIT) != 0) {
+        defines += "#define GLITTER_WEIGHTED_OIT\n";
+    }
+    return defines;
+}
 
-    return shader;
+// Whether the Main program is compiled for `permutation`: the visualizations ignore the textures, draw without weighted
+// blended transparency, and the triangle density is only drawn where the driver has the barycentrics.
+bool IsMainPermutationUsed(std::uint32_t permutation)
+{
+    DebugView view = GetDebugView(permutation);
+    if ((permutation & MAIN_PERMUTATION_WEIGHTED_OIT) != 0
+        && ((permutation & MAIN_PERMUTATION_TRANSPARENT) == 0 || IsVisualization(view))) {
+        return false;
+    }
+    if (IsVisualization(view) && (permutation & MAIN_PERMUTATION_UNTEXTURED) != 0) {
+        return false;
+    }
+    return view != DebugView::TriangleDensity || Glitter::Render::GetGLExtensions().m_fragmentShaderBarycentric;
 }
 
-[[nodiscard]] std::optional<GLuint> CreateShaderFromPath(GLenum type, const char* path)
+// Layout expected by glMultiDrawElementsIndirect.
+struct DrawElementsIndirectCommand {
+    GLuint m_count;
+    GLuint m_instanceCount;
+    GLuint m_firstIndex;
+    GLint m_baseVertex;
+    GLuint m_baseInstance;
+};
+
+// Opens a shader, or a SPIR-V module, from the shaders embedded in the executable. From the loose files, or the mounted
+// AssetPack, when `loose` is set, to hot reload them, or when it wasn't built with them.
+std::optional<Glitter::Util::MappedFile> OpenShaderFile(const char* path, bool loose)
 {
-    if (type != GL_VERTEX_SHADER && type != GL_FRAGMENT_SHADER) {
-        return std::nullopt;
+    if (const Glitter::Util::AssetPack* embedded = Glitter::Util::GetEmbeddedShaders(); embedded && !loose) {
+        return Glitter::Util::MappedFile::Open(*embedded, path);
     }
+    return Glitter::Util::MappedFile::Open(path);
+}
 
-    std::optional<std::string> src = Glitter::Util::ReadFile(path);
-    if (!src) {
+// `defines` are injected right after the `#version` directive, which has to be the first line of the source. Each
+// `#include "<file>"` line is replaced by shaders/include/<file>, and the extension glslangValidator needs for them is
+// left out.
+[[nodiscard]] std::optional<std::string> LoadShaderSource(const char* path, bool loose, std::string_view defines = {})
+{
+    std::optional<Glitter::Util::MappedFile> file = OpenShaderFile(path, loose);
+    if (!file) {
+        spdlog::error("Failed to read <{}>.", path);
         return std::nullopt;
     }
 
-    return CreateShader(type, src.value().c_str());
+    // Assemble the source straight from the mapping, with room for the defines.
+    std::span<const std::byte> data = file->GetData();
+    std::string_view mapped(reinterpret_cast<const char*>(data.data()), data.size());
+    size_t versionEnd = mapped.find('\n');
+    versionEnd = versionEnd == std::string_view::npos ? mapped.size() : versionEnd + 1;
+
+    std::string src {};
+    src.reserve(mapped.size() + defines.size());
+    src.append(mapped.substr(0, versionEnd)).append(defines);
+
+    constexpr std::string_view INCLUDE = "#include \"";
+    constexpr std::string_view INCLUDE_EXTENSION = "#extension GL_GOOGLE_include_directive";
+    for (std::string_view body = mapped.substr(versionEnd); !body.empty();) {
+        size_t lineEnd = body.find('\n');
+        lineEnd = lineEnd == std::string_view::npos ? body.size() : lineEnd + 1;
+        std::string_view line = body.substr(0, lineEnd);
+        body.remove_prefix(lineEnd);
+
+        if (line.starts_with(INCLUDE_EXTENSION)) {
+            continue;
+        }
+        if (!line.starts_with(INCLUDE)) {
+            src.append(line);
+            continue;
+        }
+        std::string_view name = line.substr(INCLUDE.size(), line.find('"', INCLUDE.size()) - INCLUDE.size());
+        std::string includePath = std::format("shaders/include/{}", name);
+        std::optional<Glitter::Util::MappedFile> include = OpenShaderFile(includePath.c_str(), loose);
+        if (!include) {
+            spdlog::error("Failed to read <{}>, included by <{}>.", includePath, path);
+            return std::nullopt;
+        }
+        std::span<const std::byte> includeData = include->GetData();
+        src.append(reinterpret_cast<const char*>(includeData.data()), includeData.size());
+    }
+    return src;
 }
 
-[[nodiscard]] std::optional<GLuint> LinkProgram(GLuint vertexShader, GLuint fragmentShader, const char* name)
+// A specialization constant of a shader's SPIR-V module, which its GLSL source gets as the define `m_define` instead.
+struct ShaderConstant {
+    GLuint m_id;
+    const char* m_define;
+    float m_value;
+};
+
+constexpr std::array MAIN_FS_CONSTANTS = std::to_array<ShaderConstant>({
+    {0, "GLITTER_AMBIENT_STRENGTH", Glitter::Config::LIGHT_AMBIENT_STRENGTH},
+});
+
+constexpr std::array IMPOSTOR_VS_CONSTANTS = std::to_array<ShaderConstant>({
+    {0, "GLITTER_IMPOSTOR_GRID", static_cast<float>(Glitter::Config::IMPOSTOR_GRID)},
+});
+
+// The module the GlitterSpirv target builds from the GLSL source at `path` with `defines`, which must all be flags: e.g.
+// shaders/spirv/MainFS-GLITTER_TEXTURE_ARRAY.spv.
+std::string GetSpirvPath(std::string_view path, std::string_view defines)
 {
-    GLuint program = glCreateProgram();
-    glObjectLabel(GL_PROGRAM, program, -1, name);
-    glAttachShader(program, vertexShader);
-    glAttachShader(program, fragmentShader);
-    glLinkProgram(program);
-
-    // The shaders can be safely deleted after being linked into a Program.
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    // Check if the Program was linked successfully.
-    GLint res = GL_FALSE;
-    glGetProgramiv(program, GL_LINK_STATUS, &res);
-    if (res == GL_FALSE) {
-        std::array<GLchar, 512> error {};
-        glGetProgramInfoLog(program, 512, nullptr, error.data());
-        spdlog::error("[program] {}", error.data());
-
-        glDeleteProgram(program);
-        return std::nullopt;
+    constexpr std::string_view DEFINE = "#define ";
+    std::string spirvPath = std::format("{}/{}", Glitter::Config::SPIRV_DIRECTORY, std::filesystem::path(path).stem().string());
+    for (size_t pos = defines.find(DEFINE); pos != std::string_view::npos; pos = defines.find(DEFINE, pos)) {
+        pos += DEFINE.size();
+        size_t end = defines.find_first_of(" \n", pos);
+        spirvPath.append("-").append(defines.substr(pos, end - pos));
     }
+    return spirvPath + ".spv";
+}
 
-    return program;
+// The occluder of `mesh`, in Mesh space, from the coarsest LOD of each of its primitives and the vertices they still
+// reference. None if it's skinned, or past Config::OCCLUDER_MAX_TRIANGLES triangles.
+std::shared_ptr<const Glitter::Render::OccluderMesh> BuildOccluder(
+    const Glitter::Scene::GltfAsset& asset, const Glitter::Scene::GltfMesh& mesh)
+{
+    auto occluder = std::make_shared<Glitter::Render::OccluderMesh>();
+    for (std::uint32_t primitiveIdx : mesh.m_primitives) {
+        const Glitter::Scene::GltfPrimitive& primitive = asset.m_primitives[primitiveIdx];
+        const std::vector<std::uint32_t>& indices
+            = primitive.m_lods.empty() ? primitive.m_vertexIndices : primitive.m_lods.back().m_indices;
+        if (!primitive.m_skinnedVertexData.empty()
+            || occluder->m_indices.size() + indices.size() > 3 * Glitter::Config::OCCLUDER_MAX_TRIANGLES) {
+            return nullptr;
+        }
+
+        bool quantized = !primitive.m_quantizedVertexData.empty();
+        std::vector<std::uint32_t> remap(
+            quantized ? primitive.m_quantizedVertexData.size() : primitive.m_vertexData.size(), UINT32_MAX);
+        for (std::uint32_t index : indices) {
+            if (remap[index] == UINT32_MAX) {
+                remap[index] = static_cast<std::uint32_t>(occluder->m_positions.size());
+                if (quantized) {
+                    const Glitter::Scene::QuantizedVertex& vertex = primitive.m_quantizedVertexData[index];
+                    glm::vec3 unorm = glm::vec3(vertex.x, vertex.y, vertex.z) / 65535.0f;
+                    occluder->m_positions.emplace_back(asset.m_dequantize * glm::vec4(unorm, 1.0f));
+                } else {
+                    const Glitter::Scene::MeshVertex& vertex = primitive.m_vertexData[index];
+                    occluder->m_positions.emplace_back(vertex.x, vertex.y, vertex.z);
+                }
+            }
+            occluder->m_indices.push_back(remap[index]);
+        }
+    }
+    if (occluder->m_indices.empty()) {
+        return nullptr;
+    }
+    return occluder;
 }
 
 class GlitterApplication {
 public:
-    void Run()
+    explicit GlitterApplication(Glitter::Core::BenchmarkOptions benchmark)
+        : m_benchmark(std::move(benchmark))
+    {
+    }
+
+    // Returns the process' exit code: a failure when it couldn't start, or when the benchmark failed its checks.
+    int Run()
     {
         spdlog::info("Started Glitter.");
+        spdlog::info("CPU: {}, culling with {}, rasterizing the occluders with {}.",
+            Glitter::Core::GetSimdLevelName(Glitter::Core::GetSimdLevel()),
+            Glitter::Core::GetSimdLevelName(Glitter::Render::GetCullSimdLevel()),
+            Glitter::Core::GetSimdLevelName(Glitter::Render::GetOcclusionSimdLevel()));
 
-        if (Initialize() != InitializeResult::Ok) {
-            spdlog::error("Initialize() failed!");
-            Finish();
-            return;
+        // The startup phases are profiled like the frames' scopes, and collected once they're over, see ReportStartup().
+        Glitter::Core::SetProfileThreadName("Main");
+        {
+            GLITTER_PROFILE_SCOPE("Initialize");
+            if (Initialize() != InitializeResult::Ok) {
+                spdlog::error("Initialize() failed!");
+                Finish();
+                return EXIT_FAILURE;
+            }
         }
-
-        if (Prepare() != PrepareResult::Ok) {
-            spdlog::error("Prepare() failed!");
-            Finish();
-            return;
+        {
+            GLITTER_PROFILE_SCOPE("Prepare");
+            if (Prepare() != PrepareResult::Ok) {
+                spdlog::error("Prepare() failed!");
+                Finish();
+                return EXIT_FAILURE;
+            }
         }
+        if (Glitter::Config::ENABLE_PROGRAM_WARM_UP) {
+            GLITTER_PROFILE_SCOPE("Warm Up");
+            WarmUpPrograms();
+        }
+        ReportStartup();
 
         while (!glfwWindowShouldClose(m_window)) {
+            WaitForFrame();
+            if (glfwWindowShouldClose(m_window)) {
+                break;
+            }
+            // The render server quits once every scene rendered its frames.
+            if (!m_servedScenes.empty() && !BeginServedFrame()) {
+                glfwSetWindowShouldClose(m_window, true);
+                break;
+            }
+            Glitter::Core::AllocationCounts frameStart = Glitter::Core::GetTotalAllocations();
             Tick();
+            Simulate();
             Render();
+            m_frameAllocations = Glitter::Core::GetTotalAllocations() - frameStart;
+
+            if (m_benchmark.m_enabled) {
+                RecordBenchmarkFrame();
+            } else if (m_benchmark.m_headless && m_servedScenes.empty() && ++m_headlessFrame == m_benchmark.m_frameCount) {
+                glfwSetWindowShouldClose(m_window, true);
+            }
         }
 
         Finish();
+        return m_benchmarkFailed ? EXIT_FAILURE : EXIT_SUCCESS;
     }
 
 private:
@@ -222,16 +552,41 @@ private:
 
     InitializeResult Initialize()
     {
+        // Each phase is timed as a scope of its own, ended by the next.
+        std::optional<Glitter::Core::ProfileScope> phase;
+        phase.emplace("Mount Asset Pack");
+
+        // Mounted before anything is loaded, on this thread or the loaders'. Its compressed assets are decompressed on the
+        // job system.
+        if (Glitter::Util::MountAssetPack(Glitter::Config::ASSET_PACK_PATH, &m_jobSystem)) {
+            const Glitter::Util::AssetPack* pack = Glitter::Util::GetMountedAssetPack();
+            spdlog::info("Mounted <{}>: {} assets, {} KiB.", Glitter::Config::ASSET_PACK_PATH, pack->GetAssetCount(),
+                pack->GetSize() / 1024);
+        }
+
+        // The headless mode runs without a display, from a surfaceless EGL context.
+        phase.emplace("Initialize GLFW");
+        if (m_benchmark.m_headless) {
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        }
         if (!glfwInit()) {
             return InitializeResult::GlfwInitError;
         }
 
+        phase.emplace("Create Window");
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 #ifdef _DEBUG
         glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
 #endif
+        // The benchmark runs without showing its window.
+        if (m_benchmark.m_enabled) {
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        }
+        if (m_benchmark.m_headless) {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+        }
         m_window = glfwCreateWindow(m_windowWidth, m_windowHeight, "Glitter", nullptr, nullptr);
         if (!m_window) {
             return InitializeResult::GlfwWindowError;
@@ -251,84 +606,50 @@ private:
             app->m_windowHeight = height;
             glViewport(0, 0, width, height);
 
-            // Create new color and depth attachments for the FBO.
-            GLuint oldColor = app->m_fboColor;
-            GLuint oldDepth = app->m_fboDepth;
-
-            // Create the color texture used with the FBO.
-            GLuint fboColor = 0;
-            glCreateTextures(GL_TEXTURE_2D, 1, &fboColor);
-            glTextureStorage2D(fboColor, 1, GL_RGBA8, width, height);
-            glObjectLabel(GL_TEXTURE, fboColor, -1, "Post-Processing FBO Color Texture");
-
-            // Create the depth renderbuffer (note: can't be sampled) used with the FBO.
-            GLuint fboDepth = 0;
-            glCreateRenderbuffers(1, &fboDepth);
-            glNamedRenderbufferStorage(fboDepth, GL_DEPTH_COMPONENT24, width, height);
-            glObjectLabel(GL_RENDERBUFFER, fboDepth, -1, "Post-Processing FBO Depth Renderbuffer");
-
-            // Attach the textures to the FBO.
-            glNamedFramebufferTexture(app->m_fbo, GL_COLOR_ATTACHMENT0, fboColor, 0);
-            glNamedFramebufferRenderbuffer(app->m_fbo, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, fboDepth);
-
-            app->m_fboColor = fboColor;
-            app->m_fboDepth = fboDepth;
-
-            // Delete the old FBO attachments.
-            glDeleteTextures(1, &oldColor);
-            glDeleteRenderbuffers(1, &oldDepth);
+            // The FBO's attachments are only reallocated once the resize settles, see UpdateRenderTargets().
+            app->m_lastResizeTime = glfwGetTime();
         });
 
         glfwSetKeyCallback(m_window, [](GLFWwindow* window, int key, int /*scancode*/, int action, int /*mods*/) {
             auto* app = static_cast<GlitterApplication*>(glfwGetWindowUserPointer(window));
-            switch (key) {
-            case GLFW_KEY_SPACE:
-                if (action == GLFW_RELEASE) {
-                    size_t nodesPerPress = Glitter::Config::MAX_NODES / 20;
-
-                    // We only accept up to Glitter::Config::MAX_NODES nodes, because UBO reallocation hasn't been implemented yet.
-                    if (app->m_nodes.size() >= Glitter::Config::MAX_NODES) {
-                        break;
-                    }
-                    if (app->m_nodes.size() + nodesPerPress > Glitter::Config::MAX_NODES) {
-                        nodesPerPress = Glitter::Config::MAX_NODES - app->m_nodes.size();
-                    }
-
-                    for (size_t i = 0; i < nodesPerPress; i++) {
-                        app->m_nodes.push_back(Node {.m_position = glm::sphericalRand(45.0f),
-                            .m_scale = glm::vec3(0.25f),
-                            .m_meshID = std::rand() % app->m_meshes.size(),
-                            .m_uboOffset = 0,
-                            .m_texture = app->m_loadedTextures[std::rand() % app->m_loadedTextures.size()],
-                            .m_opacity = 1.0f,
-                            .m_shouldAnimate = true,
-                            .m_culled = false});
-                    }
-                }
-                break;
-            case GLFW_KEY_K:
-                if (action == GLFW_RELEASE) {
-                    app->m_frustumCulling = !app->m_frustumCulling;
-                }
-                break;
-            case GLFW_KEY_ESCAPE:
-                glfwSetWindowShouldClose(window, true);
-                break;
-            default:
-                break;
-            }
+            app->HandleKey(key, action);
         });
 
+        phase.emplace("Load GL");
         if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
             return InitializeResult::GladLoadError;
         }
+        Glitter::Render::LoadGLExtensions(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
+        m_renderDoc.Connect();
+        if (!m_benchmark.m_glTracePath.empty()) {
+            Glitter::Render::DisableUntraceableGLExtensions();
+            m_glTrace.Create(m_benchmark.m_glTracePath);
+        }
+
+        phase.emplace("Create Upload Context");
+        if (Glitter::Config::ENABLE_UPLOAD_CONTEXT && !m_uploadContext.Create(m_window)) {
+            spdlog::warn("Failed to create the upload context, uploading from the main context instead.");
+        }
+        phase.reset();
 
-        glfwSwapInterval(1);
+        // The benchmark measures uncapped frame times, from the same scene on every run. Nothing waits on a display in the
+        // headless mode either.
+        if (m_benchmark.m_enabled || m_benchmark.m_headless) {
+            m_framePacing = Glitter::Render::FramePacingSettings {.m_presentMode = Glitter::Render::PresentMode::Uncapped};
+        }
+        m_framePacer.Create();
 
         // Seed the RNG.
-        std::srand(static_cast<unsigned int>(std::time(nullptr)));
+        std::srand(m_benchmark.m_enabled ? Glitter::Config::BENCHMARK_SEED : static_cast<unsigned int>(std::time(nullptr)));
+
+        // The headless mode draws neither Dear ImGui nor the debug lines overlaid on top.
+        if (m_benchmark.m_headless) {
+            m_debugLines = false;
+            return InitializeResult::Ok;
+        }
 
         // Initialize Dear ImGui context.
+        phase.emplace("Initialize ImGui");
         IMGUI_CHECKVERSION();
         ImGui::CreateContext();
         ImGuiIO& io = ImGui::GetIO();
@@ -404,32 +725,13 @@ private:
         ShaderCompileError,
         ProgramLinkError,
         FramebufferIncomplete,
+        ServedSceneError,
     };
 
     PrepareResult Prepare()
     {
 #ifdef _DEBUG
-        glEnable(GL_DEBUG_OUTPUT);
-        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
-        glDebugMessageCallback(
-            [](GLenum source, GLenum type, GLuint /*id*/, GLenum /*severity*/, GLsizei /*length*/, const GLchar* msg,
-                const void* /*userParam*/) {
-                switch (type) {
-                case GL_DEBUG_TYPE_ERROR:
-                case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
-                case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
-                    spdlog::error("{} {}", source, msg);
-                    break;
-                case GL_DEBUG_TYPE_PUSH_GROUP:
-                case GL_DEBUG_TYPE_POP_GROUP:
-                case GL_DEBUG_TYPE_OTHER:
-                    break;
-                default:
-                    spdlog::warn("{}", msg);
-                    break;
-                }
-            },
-            nullptr);
+        Glitter::Render::EnableGLDebugOutput();
 #endif
 
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
@@ -442,647 +744,6456 @@ private:
         glEnable(GL_LINE_SMOOTH);
         glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
 
-        // Create the Debug shaders and program.
-        GLuint debugVS = CreateShaderFromPath(GL_VERTEX_SHADER, "shaders/debug/DebugVS.glsl").value_or(0);
-        GLuint debugFS = CreateShaderFromPath(GL_FRAGMENT_SHADER, "shaders/debug/DebugFS.glsl").value_or(0);
-        if (!debugVS || !debugFS) {
-            return PrepareResult::ShaderCompileError;
+        // glTF mesh! Imported in the background, and uploaded over the next frames by StreamLoadedMeshes().
+        std::array meshPaths(std::to_array<const char*>({"meshes/teapot.glb"}));
+        for (auto& path : meshPaths) {
+            RequestAsset(path);
         }
 
-        GLuint debugProgram = LinkProgram(debugVS, debugFS, "Debug Program").value_or(0);
-        if (!debugProgram) {
-            return PrepareResult::ProgramLinkError;
+        // Load some Node textures, decoded on the job system while the GL objects are created, only their upload needs
+        // the GL thread. Started right away, and created once the buffers are, by the stage waiting for it.
+        std::array texturePaths(std::to_array<const char*>({"textures/Tile.png", "textures/Cobble.png"}));
+        Glitter::Render::TextureDecodeOptions decodeOptions {
+            .m_allowCompressed = Glitter::Config::ENABLE_COMPRESSED_TEXTURES,
+            .m_transcode = Glitter::Config::ENABLE_TEXTURE_TRANSCODING,
+            .m_generateMips = Glitter::Config::ENABLE_CPU_TEXTURE_MIPS,
+        };
+        std::stop_source skipTextures {};
+        Glitter::Core::Task<> loadTextures = LoadTextures(texturePaths, decodeOptions, skipTextures.get_token());
+        m_coroutines.Start(loadTextures);
+
+        // The rest runs as a graph, each stage as soon as those it needs are done: the programs are submitted first, so
+        // that the driver compiles them while the buffers and framebuffers are created, and the textures are created once
+        // they're decoded. The benchmark scene waits for everything.
+        using TaskThread = Glitter::Core::TaskGraph::TaskThread;
+        PrepareResult result = PrepareResult::Ok;
+        auto check = [&result](PrepareResult stageResult) {
+            result = stageResult;
+            return stageResult == PrepareResult::Ok;
+        };
+        Glitter::Core::TaskGraph graph;
+        auto readCamera = graph.Add("Read Camera Recording", TaskThread::Worker, [this] {
+            ReadBenchmarkCamera();
+            return true;
+        });
+        auto readServedScenes
+            = graph.Add("Read Served Scenes", TaskThread::Worker, [&] { return check(ReadServedScenes()); });
+        auto submitPrograms = graph.Add("Submit Programs", TaskThread::Main, [&] { return check(SubmitPrograms()); });
+        auto createBuffers = graph.Add("Create Buffers", TaskThread::Main,
+            [this] {
+                CreateBuffers();
+                return true;
+            },
+            {submitPrograms});
+        auto createFramebuffers
+            = graph.Add("Create Framebuffers", TaskThread::Main, [&] { return check(CreateFramebuffers()); }, {submitPrograms});
+        auto createTextures = graph.Add("Create Textures", TaskThread::Main,
+            [&] {
+                m_coroutines.Wait(loadTextures);
+                return true;
+            },
+            {createBuffers});
+        auto finishPrograms = graph.Add("Finish Programs", TaskThread::Main, [&] { return check(FinishPrograms()); },
+            {createBuffers, createFramebuffers});
+        if (m_benchmark.m_enabled) {
+            graph.Add("Load Benchmark Scene", TaskThread::Main,
+                [this] {
+                    LoadBenchmarkScene();
+                    return true;
+                },
+                {readCamera, createTextures, finishPrograms});
+        }
+        if (!m_benchmark.m_servePath.empty()) {
+            graph.Add("Load Served Scenes", TaskThread::Main, [&] { return check(LoadServedScenes()); },
+                {readServedScenes, createTextures, finishPrograms});
+        }
+        if (!graph.Run(m_jobSystem)) {
+            // The decoding still under way references the task.
+            skipTextures.request_stop();
+            m_coroutines.Wait(loadTextures);
+            return result;
         }
 
-        m_debugProgram = debugProgram;
-
-        {
-            // Create Debug VAO.
-            GLuint vao = 0;
-            glCreateVertexArrays(1, &vao);
-            glObjectLabel(GL_VERTEX_ARRAY, vao, -1, "Debug VAO");
+        // Start the simulation from now, or from 0 so that every benchmark run follows the same path.
+        m_lastFrameTime = glfwGetTime();
+        RestartSimulation(m_benchmark.m_enabled ? 0.0 : m_lastFrameTime);
 
-            // Declare the Position Attribute.
-            glEnableVertexArrayAttrib(vao, 0);
-            glVertexArrayAttribFormat(vao, 0, 3, GL_FLOAT, GL_FALSE, offsetof(DebugVertex, x));
-            glVertexArrayAttribBinding(vao, 0, 0);
+        return PrepareResult::Ok;
+    }
 
-            m_debugVAO = vao;
+    // Creates the program cache and submits every program, finished by FinishPrograms(). Picks the texture mode and the
+    // features the programs are built for, which the other stages of Prepare() rely on.
+    PrepareResult SubmitPrograms()
+    {
+        if (Glitter::Config::ENABLE_PROGRAM_CACHE) {
+            m_programCache.Create(Glitter::Config::PROGRAM_CACHE_DIRECTORY);
         }
-
-        // Create the Main shaders and program.
-        GLuint mainVS = CreateShaderFromPath(GL_VERTEX_SHADER, "shaders/MainVS.glsl").value_or(0);
-        GLuint mainFS = CreateShaderFromPath(GL_FRAGMENT_SHADER, "shaders/MainFS.glsl").value_or(0);
-        if (!mainVS || !mainFS) {
-            return PrepareResult::ShaderCompileError;
+        // Hot reloading reads the loose shaders instead of the embedded ones, wherever they're found.
+        std::error_code shadersError {};
+        m_shaderHotReload = Glitter::Config::ENABLE_SHADER_HOT_RELOAD && !Glitter::Util::GetMountedAssetPack()
+            && std::filesystem::is_directory("shaders", shadersError);
+        m_spirvShaders = Glitter::Config::ENABLE_SPIRV_SHADERS && Glitter::Render::GetGLExtensions().m_glSpirv;
+
+        // Create the Main shaders and program. Like every other program, it's only submitted here and finished at the end
+        // of Prepare(), so that the driver compiles them all concurrently while the rest is prepared. It samples the Nodes'
+        // textures through bindless handles where supported, and otherwise through a texture array.
+        if (Glitter::Config::ENABLE_BINDLESS_TEXTURES && Glitter::Render::GetGLExtensions().m_bindlessTexture) {
+            m_textureMode = TextureMode::Bindless;
+        } else if (Glitter::Config::ENABLE_TEXTURE_ARRAY) {
+            m_textureMode = TextureMode::Array;
+        } else {
+            m_textureMode = TextureMode::Bound;
         }
 
-        GLuint mainProgram = LinkProgram(mainVS, mainFS, "Main Program").value_or(0);
-        if (!mainProgram) {
-            return PrepareResult::ProgramLinkError;
+        std::string mainDefines {};
+        if (m_textureMode == TextureMode::Bindless) {
+            mainDefines += "#define GLITTER_BINDLESS_TEXTURES\n";
+        } else if (m_textureMode == TextureMode::Array) {
+            mainDefines += "#define GLITTER_TEXTURE_ARRAY\n";
+        }
+        if (Glitter::Config::ENABLE_QUANTIZED_VERTICES) {
+            mainDefines += "#define GLITTER_QUANTIZED_VERTICES\n";
+        }
+        if (Glitter::Config::ENABLE_TEXTURE_STREAMING) {
+            mainDefines += "#define GLITTER_TEXTURE_STREAMING\n";
+        }
+        // In stereo, every program drawing into the main pass' FBO renders both eyes.
+        m_stereo = Glitter::Config::ENABLE_STEREO && Glitter::Render::GetGLExtensions().m_multiview;
+        if (m_stereo) {
+            mainDefines += "#define GLITTER_MULTIVIEW\n";
+            RestrictToStereo();
+        }
+        if (m_viewLayout != Glitter::Render::ViewLayout::Single) {
+            RestrictToInsetViews();
+        }
+        // The Main program writes the Node IDs into the main pass' own FBO, which stereo replaces.
+        m_gpuPicking = Glitter::Config::ENABLE_GPU_PICKING && !m_stereo;
+        if (m_gpuPicking) {
+            mainDefines += "#define GLITTER_NODE_ID\n";
+            RestrictToGpuPicking();
+        }
+        // The depth programs pull the same vertices as the Main program, so they decode them the same way.
+        std::string pullingDefines {};
+        if (Glitter::Config::ENABLE_VERTEX_PULLING) {
+            pullingDefines += "#define GLITTER_VERTEX_PULLING\n";
+            if (Glitter::Config::ENABLE_QUANTIZED_VERTICES) {
+                pullingDefines += "#define GLITTER_QUANTIZED_VERTICES\n";
+            }
+            mainDefines += "#define GLITTER_VERTEX_PULLING\n";
+        }
+        if (m_benchmark.m_isolation == Glitter::Core::BenchmarkIsolation::StubShaders) {
+            mainDefines += "#define GLITTER_STUB_SHADING\n";
+        }
+        std::array mainStages = std::to_array<ShaderStage>({
+            {GL_VERTEX_SHADER, "shaders/MainVS.glsl"},
+            {GL_FRAGMENT_SHADER, "shaders/MainFS.glsl", MAIN_FS_CONSTANTS},
+        });
+        for (std::uint32_t permutation = 0; permutation < MAIN_PERMUTATION_COUNT; permutation++) {
+            if (!IsMainPermutationUsed(permutation)) {
+                continue;
+            }
+            std::string name = std::format("Main Program {}", permutation);
+            if (!SubmitProgram(mainStages, mainDefines + GetMainPermutationDefines(permutation), name.c_str(),
+                    m_mainPrograms[permutation])) {
+                return PrepareResult::ShaderCompileError;
+            }
         }
 
-        m_mainProgram = mainProgram;
-
-        // Create the Post-Processing shaders and program.
-        GLuint ppfxVS = CreateShaderFromPath(GL_VERTEX_SHADER, "shaders/ppfx/PpfxVS.glsl").value_or(0);
-        GLuint ppfxFS = CreateShaderFromPath(GL_FRAGMENT_SHADER, "shaders/ppfx/PpfxFS.glsl").value_or(0);
-        if (!ppfxVS || !ppfxFS) {
+        // Create the depth pre-pass program, without a single shading instruction.
+        std::array depthStages = std::to_array<ShaderStage>({
+            {GL_VERTEX_SHADER, "shaders/depth/DepthVS.glsl"},
+            {GL_FRAGMENT_SHADER, "shaders/depth/DepthFS.glsl"},
+        });
+        std::string depthDefines = pullingDefines + (m_stereo ? "#define GLITTER_MULTIVIEW\n" : "");
+        if (!SubmitProgram(depthStages, depthDefines, "Depth Program", m_depthProgram)) {
             return PrepareResult::ShaderCompileError;
         }
-
-        GLuint ppfxProgram = LinkProgram(ppfxVS, ppfxFS, "Post-Processing Program").value_or(0);
-        if (!ppfxProgram) {
-            return PrepareResult::ProgramLinkError;
+        if (!SubmitProgram(depthStages, pullingDefines + "#define GLITTER_SHADOW\n", "Shadow Program", m_shadowProgram)) {
+            return PrepareResult::ShaderCompileError;
         }
-
-        m_ppfxProgram = ppfxProgram;
-
-        {
-            // Create Post-Processing VAO
-            GLuint vao = 0;
-            glCreateVertexArrays(1, &vao);
-            glObjectLabel(GL_VERTEX_ARRAY, vao, -1, "Post-Processing VAO");
-
-            // Declare the Position attribute
-            glEnableVertexArrayAttrib(vao, 0);
-            glVertexArrayAttribFormat(vao, 0, 3, GL_FLOAT, GL_FALSE, offsetof(DebugVertex, x));
-            glVertexArrayAttribBinding(vao, 0, 0);
-
-            // Declare the UV Attribute.
-            glEnableVertexArrayAttrib(vao, 1);
-            glVertexArrayAttribFormat(vao, 1, 2, GL_FLOAT, GL_FALSE, offsetof(MeshVertex, u));
-            glVertexArrayAttribBinding(vao, 1, 0);
-
-            m_ppfxVAO = vao;
-
-            // Create Post-Processing VBO
-            GLuint vbo = 0;
-            glCreateBuffers(1, &vbo);
-
-            std::array ppfxQuad = std::to_array<PpfxVertex>({{.x = -1.0f, .y = -1.0f, .z = 0.0f, .u = 0.0f, .v = 0.0f},
-                {.x = 1.0f, .y = -1.0f, .z = 0.0f, .u = 1.0f, .v = 0.0f}, {.x = -1.0f, .y = 1.0f, .z = 0.0f, .u = 0.0f, .v = 1.0f},
-                {.x = 1.0f, .y = 1.0f, .z = 0.0f, .u = 1.0f, .v = 1.0f}});
-
-            glNamedBufferStorage(vbo, static_cast<GLsizeiptr>(sizeof(PpfxVertex) * std::size(ppfxQuad)), ppfxQuad.data(), 0);
-            glObjectLabel(GL_BUFFER, vbo, -1, "Post-Processing VBO");
-
-            // Attach the VBO to the VAO.
-            glVertexArrayVertexBuffer(vao, 0, vbo, 0, sizeof(PpfxVertex));
+        std::array occlusionBoxStages = std::to_array<ShaderStage>({
+            {GL_VERTEX_SHADER, "shaders/depth/OcclusionBoxVS.glsl"},
+            {GL_FRAGMENT_SHADER, "shaders/depth/DepthFS.glsl"},
+        });
+        if (!SubmitProgram(occlusionBoxStages, "", "Occlusion Box Program", m_occlusionBoxProgram)) {
+            return PrepareResult::ShaderCompileError;
         }
 
-        // glTF mesh!
-        std::array meshPaths(std::to_array<const char*>({"meshes/teapot.glb"}));
-        for (auto& path : meshPaths) {
-            cgltf_options options {};
-            cgltf_data* data = nullptr;
-            cgltf_result result = cgltf_parse_file(&options, path, &data);
-            cgltf_load_buffers(&options, data, path);
-
-            // Build the VBO for the loaded mesh.
-            struct GltfPrimitive {
-                std::vector<MeshVertex> m_vertexData;
-                std::vector<uint32_t> m_vertexIndices;
-            };
-
-            struct GltfMesh {
-                std::vector<GltfPrimitive> m_primitives;
-                AABB m_aabb;
-            };
+        // Create the visibility buffer programs: the depth pre-pass writing which triangle covers each pixel, and the Main
+        // program resolving it in a compute pass, for each opaque permutation. The resolve fetches the triangles from the
+        // geometry pool itself, and samples the Nodes' textures without rebinding them between pixels.
+        if (m_textureMode != TextureMode::Bound) {
+            std::array visibilityStages = std::to_array<ShaderStage>({
+                {GL_VERTEX_SHADER, "shaders/depth/DepthVS.glsl"},
+                {GL_FRAGMENT_SHADER, "shaders/depth/VisibilityFS.glsl"},
+            });
+            if (!SubmitProgram(visibilityStages, pullingDefines + "#define GLITTER_VISIBILITY\n", "Visibility Program",
+                    m_visibilityProgram)) {
+                return PrepareResult::ShaderCompileError;
+            }
 
-            Mesh glitterMesh {};
-            std::vector<GltfMesh> parsedMeshes;
-            if (result == cgltf_result_success) {
-                // Iterate through each meshes, then through its primitives and their attributes, creating one VBO per primitive and
-                // filling it with data pointed by the attribute buffer views. A mesh can have several primitives.
-                for (cgltf_size meshIdx = 0; meshIdx < data->meshes_count; meshIdx++) {
-                    cgltf_mesh mesh = data->meshes[meshIdx];
-
-                    GltfMesh gltfMesh {};
-                    for (cgltf_size primIdx = 0; primIdx < mesh.primitives_count; primIdx++) {
-                        cgltf_primitive prim = mesh.primitives[primIdx];
-
-                        cgltf_size vertexCount {0};
-                        // Fill out the accessor pointers.
-                        cgltf_accessor* positionAccessor = nullptr;
-                        cgltf_accessor* texCoordAccessor = nullptr;
-                        cgltf_accessor* normalAccessor = nullptr;
-                        for (cgltf_size attribIdx = 0; attribIdx < prim.attributes_count; attribIdx++) {
-                            cgltf_attribute attrib = prim.attributes[attribIdx];
-
-                            switch (attrib.type) {
-                            case cgltf_attribute_type_position:
-                                vertexCount = attrib.data->count;
-                                if (attrib.data->component_type == cgltf_component_type_r_32f) {
-                                    positionAccessor = attrib.data;
-                                }
-                                break;
-                            case cgltf_attribute_type_texcoord:
-                                if (attrib.data->component_type == cgltf_component_type_r_32f) {
-                                    texCoordAccessor = attrib.data;
-                                }
-                                break;
-                            case cgltf_attribute_type_normal:
-                                if (attrib.data->component_type == cgltf_component_type_r_32f) {
-                                    normalAccessor = attrib.data;
-                                }
-                                break;
-                            default:
-                                break;
-                            }
-                        }
+            std::string resolveDefines {};
+            if (m_geometryPool.GetIndexType() == GL_UNSIGNED_SHORT) {
+                resolveDefines += "#define GLITTER_SHORT_INDICES\n";
+            }
+            resolveDefines += "#define GLITTER_VISIBILITY_RESOLVE\n";
+            std::array resolveStages = std::to_array<ShaderStage>({
+                {GL_COMPUTE_SHADER, "shaders/MainFS.glsl", MAIN_FS_CONSTANTS},
+            });
+            for (std::uint32_t permutation = 0; permutation < MAIN_PERMUTATION_COUNT; permutation++) {
+                if ((permutation & MAIN_PERMUTATION_TRANSPARENT) != 0 || IsVisualization(GetDebugView(permutation))
+                    || !IsMainPermutationUsed(permutation)) {
+                    continue;
+                }
+                std::string name = std::format("Visibility Resolve Program {}", permutation);
+                if (!SubmitProgram(resolveStages, mainDefines + GetMainPermutationDefines(permutation) + resolveDefines,
+                        name.c_str(), m_visibilityResolvePrograms[permutation])) {
+                    return PrepareResult::ShaderCompileError;
+                }
+            }
+        }
 
-                        GltfPrimitive gltfPrim {};
-                        for (cgltf_size vertexIdx = 0; vertexIdx < vertexCount; vertexIdx++) {
-                            MeshVertex vertex {};
+        // Create the impostor programs: the bake, decoding the vertices like the Main program, and the Main program shading
+        // the impostors of the far opaque Nodes, for each opaque permutation. Each Mesh's impostors are a single instanced
+        // draw, which can't switch bound textures between Nodes.
+        if (Glitter::Config::ENABLE_IMPOSTORS && m_textureMode != TextureMode::Bound) {
+            std::array bakeStages = std::to_array<ShaderStage>({
+                {GL_VERTEX_SHADER, "shaders/impostor/ImpostorBakeVS.glsl"},
+                {GL_FRAGMENT_SHADER, "shaders/impostor/ImpostorBakeFS.glsl"},
+            });
+            if (!SubmitProgram(bakeStages, mainDefines, "Impostor Bake Program", m_impostorBakeProgram)) {
+                return PrepareResult::ShaderCompileError;
+            }
 
-                            if (positionAccessor) {
-                                cgltf_accessor_read_float(positionAccessor, vertexIdx, &vertex.x, 3);
+            std::array impostorStages = std::to_array<ShaderStage>({
+                {GL_VERTEX_SHADER, "shaders/impostor/ImpostorVS.glsl", IMPOSTOR_VS_CONSTANTS},
+                {GL_FRAGMENT_SHADER, "shaders/MainFS.glsl", MAIN_FS_CONSTANTS},
+            });
+            for (std::uint32_t permutation = 0; permutation < MAIN_PERMUTATION_COUNT; permutation++) {
+                if ((permutation & MAIN_PERMUTATION_TRANSPARENT) != 0 || IsVisualization(GetDebugView(permutation))
+                    || !IsMainPermutationUsed(permutation)) {
+                    continue;
+                }
+                std::string name = std::format("Impostor Program {}", permutation);
+                std::string defines = mainDefines + GetMainPermutationDefines(permutation) + "#define GLITTER_IMPOSTOR\n";
+                if (!SubmitProgram(impostorStages, defines, name.c_str(), m_impostorPrograms[permutation])) {
+                    return PrepareResult::ShaderCompileError;
+                }
+            }
+        }
 
-                                // Calculate the AABB.
-                                auto& aabb = gltfMesh.m_aabb;
-                                aabb.m_localMin = glm::vec3 {std::min(aabb.m_localMin.x, vertex.x),
-                                    std::min(aabb.m_localMin.y, vertex.y), std::min(aabb.m_localMin.z, vertex.z)};
-                                aabb.m_localMax = glm::vec3 {std::max(aabb.m_localMax.x, vertex.x),
-                                    std::max(aabb.m_localMax.y, vertex.y), std::max(aabb.m_localMax.z, vertex.z)};
-                            }
-                            if (texCoordAccessor) {
-                                cgltf_accessor_read_float(texCoordAccessor, vertexIdx, &vertex.u, 2);
-                            }
-                            if (normalAccessor) {
-                                cgltf_accessor_read_float(normalAccessor, vertexIdx, &vertex.nx, 3);
-                            }
+        // Create the GPU culling program.
+        std::array cullStages = std::to_array<ShaderStage>({{GL_COMPUTE_SHADER, "shaders/cull/CullCS.glsl"}});
+        if (!SubmitProgram(cullStages, {}, "Cull Program", m_cullProgram)) {
+            return PrepareResult::ShaderCompileError;
+        }
 
-                            gltfPrim.m_vertexData.emplace_back(vertex);
-                        }
+        std::array meshletCullStages = std::to_array<ShaderStage>({{GL_COMPUTE_SHADER, "shaders/cull/MeshletCullCS.glsl"}});
+        if (!SubmitProgram(meshletCullStages, {}, "Meshlet Cull Program", m_meshletCullProgram)) {
+            return PrepareResult::ShaderCompileError;
+        }
 
-                        for (cgltf_size indexIdx = 0; indexIdx < prim.indices->count; indexIdx++) {
-                            gltfPrim.m_vertexIndices.emplace_back(
-                                static_cast<GLuint>(cgltf_accessor_read_index(prim.indices, indexIdx)));
-                        }
+        std::array transparentSortStages
+            = std::to_array<ShaderStage>({{GL_COMPUTE_SHADER, "shaders/cull/TransparentSortCS.glsl"}});
+        if (!SubmitProgram(transparentSortStages, {}, "Transparent Sort Program", m_transparentSortProgram)) {
+            return PrepareResult::ShaderCompileError;
+        }
+        std::array transparentCommandStages
+            = std::to_array<ShaderStage>({{GL_COMPUTE_SHADER, "shaders/cull/TransparentCommandsCS.glsl"}});
+        if (!SubmitProgram(transparentCommandStages, {}, "Transparent Commands Program", m_transparentCommandsProgram)) {
+            return PrepareResult::ShaderCompileError;
+        }
 
-                        gltfMesh.m_primitives.emplace_back(gltfPrim);
-                    } // Iterating through the primitives.
+        // Create the static batch program, copying the static Nodes' Primitives into their batches in the pool's formats.
+        std::string staticBatchDefines {};
+        if (Glitter::Config::ENABLE_QUANTIZED_VERTICES) {
+            staticBatchDefines += "#define GLITTER_QUANTIZED_VERTICES\n";
+        }
+        if (m_geometryPool.GetIndexType() == GL_UNSIGNED_SHORT) {
+            staticBatchDefines += "#define GLITTER_SHORT_INDICES\n";
+        }
+        std::array staticBatchStages = std::to_array<ShaderStage>({{GL_COMPUTE_SHADER, "shaders/batch/StaticBatchCS.glsl"}});
+        if (!SubmitProgram(staticBatchStages, staticBatchDefines, "Static Batch Program", m_staticBatchProgram)) {
+            return PrepareResult::ShaderCompileError;
+        }
 
-                    parsedMeshes.emplace_back(gltfMesh);
-                } // Iterating through the meshes.
+        // Create the skinning program, skinning the skinned Nodes' Primitives into their vertices in the pool's format.
+        std::string skinDefines {};
+        if (Glitter::Config::ENABLE_QUANTIZED_VERTICES) {
+            skinDefines += "#define GLITTER_QUANTIZED_VERTICES\n";
+        }
+        std::array skinStages = std::to_array<ShaderStage>({{GL_COMPUTE_SHADER, "shaders/skin/SkinCS.glsl"}});
+        if (!SubmitProgram(skinStages, skinDefines, "Skinning Program", m_skinProgram)) {
+            return PrepareResult::ShaderCompileError;
+        }
 
-                cgltf_free(data);
+        // Create the swarm program, simulating the swarm's Nodes into their data.
+        std::array swarmStages = std::to_array<ShaderStage>({{GL_COMPUTE_SHADER, "shaders/swarm/SwarmCS.glsl"}});
+        if (!SubmitProgram(swarmStages, {}, "Swarm Program", m_swarmProgram)) {
+            return PrepareResult::ShaderCompileError;
+        }
 
-                for (auto& primitives : parsedMeshes[0].m_primitives) {
-                    Primitive primitive {.m_vbo = 0,
-                        .m_ebo = 0,
-                        .m_baseTexture = 0,
-                        .m_elementCount = narrow_into<GLsizei>(primitives.m_vertexIndices.size())};
+        // Create the Hi-Z pyramid program, used for occlusion culling.
+        std::array hiZStages = std::to_array<ShaderStage>({{GL_COMPUTE_SHADER, "shaders/cull/HiZCS.glsl"}});
+        if (!SubmitProgram(hiZStages, {}, "Hi-Z Program", m_hiZProgram)) {
+            return PrepareResult::ShaderCompileError;
+        }
 
-                    // Create VBO.
-                    GLuint vbo = 0;
-                    glCreateBuffers(1, &vbo);
-                    glNamedBufferStorage(vbo,
-                        static_cast<GLsizeiptr>(sizeof(MeshVertex) * parsedMeshes[0].m_primitives[0].m_vertexData.size()),
-                        parsedMeshes[0].m_primitives[0].m_vertexData.data(), 0);
-                    glObjectLabel(GL_BUFFER, vbo, -1, "VBO");
-                    primitive.m_vbo = vbo;
+        // Create the mip programs, generating the mips of the textures created without them, one per format.
+        std::array mipStages = std::to_array<ShaderStage>({{GL_COMPUTE_SHADER, "shaders/mip/MipCS.glsl"}});
+        for (size_t format = 0; format < Glitter::Render::MIP_FORMAT_COUNT; format++) {
+            std::string defines = Glitter::Render::MipGenerator::GetProgramDefines(static_cast<Glitter::Render::MipFormat>(format));
+            std::string name = std::format("Mip Program {}", format);
+            if (!SubmitProgram(mipStages, defines, name.c_str(), m_mipPrograms[format])) {
+                return PrepareResult::ShaderCompileError;
+            }
+        }
 
-                    // Create EBO.
-                    GLuint ebo = 0;
-                    glCreateBuffers(1, &ebo);
-                    glNamedBufferStorage(ebo,
-                        static_cast<GLsizeiptr>(sizeof(uint32_t) * parsedMeshes[0].m_primitives[0].m_vertexIndices.size()),
-                        parsedMeshes[0].m_primitives[0].m_vertexIndices.data(), 0);
-                    glObjectLabel(GL_BUFFER, ebo, -1, "EBO");
-                    primitive.m_ebo = ebo;
+        // GPU culling writes a single command stream per pass, which can't switch bound textures between draws.
+        m_gpuCulling = Glitter::Config::ENABLE_GPU_CULLING && m_textureMode != TextureMode::Bound;
+        if (m_benchmark.m_isolation == Glitter::Core::BenchmarkIsolation::NullDraws) {
+            RestrictToNullDraws();
+        }
+        if (!m_benchmark.m_servePath.empty()) {
+            RestrictToServedScenes();
+        }
 
-                    // Add primitive to the Mesh.
-                    glitterMesh.m_primitives.emplace_back(primitive);
-                }
+        // Create the Post-Processing programs, one for each pass of fused effects the settings can need.
+        std::array ppfxStages = std::to_array<ShaderStage>({{GL_COMPUTE_SHADER, "shaders/ppfx/PpfxCS.glsl"}});
+        for (const std::string& defines : Glitter::Render::GetPostProcessVariants()) {
+            std::string name = std::format("Post-Processing Program {}", m_ppfxPrograms.size());
+            if (!SubmitProgram(ppfxStages, defines, name.c_str(), m_ppfxPrograms[defines])) {
+                return PrepareResult::ShaderCompileError;
+            }
+        }
 
-                glitterMesh.m_aabb = parsedMeshes[0].m_aabb;
+        // Create the temporal upsampling program, accumulating the jittered scene color into the history.
+        std::array temporalUpsampleStages
+            = std::to_array<ShaderStage>({{GL_COMPUTE_SHADER, "shaders/ppfx/TemporalUpsampleCS.glsl"}});
+        if (!SubmitProgram(temporalUpsampleStages, {}, "Temporal Upsampling Program", m_temporalUpsampleProgram)) {
+            return PrepareResult::ShaderCompileError;
+        }
 
-                m_meshes.emplace_back(glitterMesh);
+        // Create the shading rate image program, where the driver can shade at coarser rates.
+        if (Glitter::Render::GetGLExtensions().m_shadingRateImage) {
+            std::array shadingRateStages = std::to_array<ShaderStage>({{GL_COMPUTE_SHADER, "shaders/vrs/ShadingRateCS.glsl"}});
+            if (!SubmitProgram(shadingRateStages, {}, "Shading Rate Program", m_shadingRateProgram)) {
+                return PrepareResult::ShaderCompileError;
             }
         }
+        return PrepareResult::Ok;
+    }
 
+    // Creates the VAOs, the rings and the buffers of Prepare(), the Meshes' included, empty until they're loaded.
+    void CreateBuffers()
+    {
         // Create VAO.
         GLuint vao = 0;
         glCreateVertexArrays(1, &vao);
         glObjectLabel(GL_VERTEX_ARRAY, vao, -1, "Main VAO");
 
-        // Declare the Position Attribute.
-        glEnableVertexArrayAttrib(vao, 0);
-        glVertexArrayAttribFormat(vao, 0, 3, GL_FLOAT, GL_FALSE, offsetof(MeshVertex, x));
-        glVertexArrayAttribBinding(vao, 0, 0);
+        // Declare the Position, UV and Normal attributes of the vertex format, see Scene::VertexFormat. The quantized
+        // positions' dequantization matrix is folded into each Node's model matrix. Pulled vertices need none, the vertex
+        // shaders fetch them from the VBO themselves.
+        if (!Glitter::Config::ENABLE_VERTEX_PULLING) {
+            if (Glitter::Config::ENABLE_QUANTIZED_VERTICES) {
+                Glitter::Render::SetVertexFormat<Glitter::Scene::QuantizedVertex>(vao, 0);
+            } else {
+                Glitter::Render::SetVertexFormat<Glitter::Scene::MeshVertex>(vao, 0);
+            }
+        }
 
-        // Declare the UV Attribute.
-        glEnableVertexArrayAttrib(vao, 1);
-        glVertexArrayAttribFormat(vao, 1, 2, GL_FLOAT, GL_FALSE, offsetof(MeshVertex, u));
-        glVertexArrayAttribBinding(vao, 1, 0);
+        // The shared VBO and EBO are attached once the first Meshes are uploaded.
+        m_mainVAO = vao;
 
-        // Declare the Normal attribute
-        glEnableVertexArrayAttrib(vao, 2);
-        glVertexArrayAttribFormat(vao, 2, 3, GL_FLOAT, GL_FALSE, offsetof(MeshVertex, nx));
-        glVertexArrayAttribBinding(vao, 2, 0);
+        // Keep the pages of the geometry pool within the SSBO blocks their VBO and EBO are bound as, with as much room
+        // again for what's added over the vertices of a full page, see Config::GEOMETRY_PAGE_SIZE.
+        GLint64 maxStorageBlockSize = 0;
+        glGetInteger64v(GL_MAX_SHADER_STORAGE_BLOCK_SIZE, &maxStorageBlockSize);
+        if (maxStorageBlockSize > 0) {
+            m_geometryPool.LimitPageSize(static_cast<size_t>(maxStorageBlockSize) / 2);
+        }
 
-        m_mainVAO = vao;
+        // Create the depth pre-pass VAO, with the same Position attribute from the position-only stream. Pulled vertices are
+        // fetched from the VBO instead, so the depth passes share the Main VAO for its EBO.
+        if (Glitter::Config::ENABLE_VERTEX_PULLING) {
+            m_depthVAO = vao;
+        } else {
+            GLuint depthVao = 0;
+            glCreateVertexArrays(1, &depthVao);
+            glObjectLabel(GL_VERTEX_ARRAY, depthVao, -1, "Depth VAO");
+            constexpr Glitter::Scene::VertexAttribute position = Glitter::Config::ENABLE_QUANTIZED_VERTICES
+                ? Glitter::Scene::FindVertexAttribute<Glitter::Scene::QuantizedVertex>(Glitter::Scene::VertexSemantic::Position)
+                : Glitter::Scene::FindVertexAttribute<Glitter::Scene::MeshVertex>(Glitter::Scene::VertexSemantic::Position);
+            Glitter::Render::SetVertexAttribute(depthVao, 0, position, 0, 0);
+            m_depthVAO = depthVao;
+        }
 
-        // Create empty UBO buffer.
-        GLuint ubo {};
-        glCreateBuffers(1, &ubo);
-        glObjectLabel(GL_BUFFER, ubo, -1, "UBO");
+        // Create the persistently-mapped UBO ring, just enough for the Common stuff of the main view and of every inset
+        // view, each at its own aligned offset.
+        m_uboAllocator.QueryAlignment();
+        auto uboAlignment = static_cast<size_t>(m_uboAllocator.GetAlignment());
+        m_commonDataStride = (sizeof(CommonData) + uboAlignment - 1) / uboAlignment * uboAlignment;
+        m_uboStream.Create(m_commonDataStride * (1 + Glitter::Config::MAX_INSET_VIEWS), uboAlignment, "UBO Ring");
+
+        // Create the persistently-mapped per-draw SSBO ring holding each draw's Node slot, sized for the initial Nodes and
+        // grown on demand in Render().
+        GLint ssboAlignment = 0;
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &ssboAlignment);
+        m_perDrawStream.Create(sizeof(GLuint) * Glitter::Config::INITIAL_NODE_CAPACITY,
+            std::max(static_cast<size_t>(ssboAlignment), alignof(GLuint)), "Per-Draw SSBO Ring");
+
+        // Create the shadow maps, whose static Nodes are rendered on the first frame.
+        m_shadowCache.Create(Glitter::Config::SHADOW_MAP_SIZE);
+
+        // Create the impostor atlas, baked as the Meshes are loaded.
+        if (Glitter::Config::ENABLE_IMPOSTORS && m_textureMode != TextureMode::Bound) {
+            m_impostorAtlas.Create(Glitter::Config::MAX_IMPOSTOR_MESHES);
+        }
 
-        // Just enough for the Common stuff and the Nodes.
-        glNamedBufferData(ubo,
-            static_cast<GLsizeiptr>(
-                sizeof(CommonData) + ((sizeof(PerDrawData) + m_uboAllocator.GetAlignment())) * Glitter::Config::MAX_NODES),
-            nullptr, GL_DYNAMIC_DRAW);
-        m_mainUBO = ubo;
+        // Create the mip generator's counters, before the textures queue their mips.
+        m_mipGenerator.Create();
+
+        // Create the static batches' part buffer, grown on demand as cells are rebuilt.
+        m_staticBatches.Create();
+        m_nodeSwarm.Create();
+        m_skinnedMeshes.Create();
+
+        // Create the light cluster SSBO ring, and scatter the point lights around the scene.
+        m_lightClusters.Create(std::max(static_cast<size_t>(ssboAlignment), alignof(Glitter::Render::PointLight)));
+        for (std::uint32_t lightIdx = 0; lightIdx < Glitter::Config::POINT_LIGHT_COUNT; lightIdx++) {
+            glm::vec3 position = glm::ballRand(Glitter::Config::POINT_LIGHT_SPREAD);
+            m_entities.Create(
+                Glitter::Render::PointLight {
+                    .m_positionRadius = glm::vec4(position, Glitter::Config::POINT_LIGHT_RADIUS),
+                    .m_color = glm::vec4(glm::linearRand(glm::vec3(0.2f), glm::vec3(1.0f)) * 4.0f, 1.0f),
+                },
+                LightOrbit {.m_speed = 0.1f + 0.05f * static_cast<float>(lightIdx % 8)});
+        }
 
-        // Load some Node textures.
-        std::array texturePaths(std::to_array<const char*>({"textures/Tile.png", "textures/Cobble.png"}));
+        // Create the indirect command buffer, grown on demand in Render().
+        GLuint indirectBuffer {};
+        glCreateBuffers(1, &indirectBuffer);
+        glObjectLabel(GL_BUFFER, indirectBuffer, -1, "Indirect Command Buffer");
+        m_indirectBuffer = indirectBuffer;
+
+        // Create the GPU culling buffers: the Mesh, Primitive and meshlet tables, rebuilt whenever Meshes are loaded, the
+        // command, draw Node and draw count buffers written by the culling passes, and the meshlet work list handed from
+        // the Node pass to the meshlet pass. The draw counts are followed by the meshlet pass' indirect dispatch.
+        UploadMeshTables();
+
+        // The material table starts with the default material, of the Meshes without one.
+        m_materials.push_back(GpuMaterial {.m_baseColor = glm::vec4(1.0f),
+            .m_specularStrength = Glitter::Config::LIGHT_SPECULAR_STRENGTH,
+            .m_specularExponent = Glitter::Config::LIGHT_SPECULAR_EXPONENT,
+            .m_padding = {}});
+        UploadMaterialTable();
+
+        std::array<GLuint, 6> cullBuffers {};
+        glCreateBuffers(cullBuffers.size(), cullBuffers.data());
+        glObjectLabel(GL_BUFFER, cullBuffers[0], -1, "GPU Command Buffer");
+        glObjectLabel(GL_BUFFER, cullBuffers[1], -1, "Draw Count Buffer");
+        glObjectLabel(GL_BUFFER, cullBuffers[2], -1, "GPU Draw Node Buffer");
+        glObjectLabel(GL_BUFFER, cullBuffers[3], -1, "Meshlet Work Buffer");
+        glObjectLabel(GL_BUFFER, cullBuffers[4], -1, "Transparent Sort Buffer");
+        glObjectLabel(GL_BUFFER, cullBuffers[5], -1, "Transparent Block Offset Buffer");
+        m_gpuCommandBuffer = cullBuffers[0];
+        m_drawCountBuffer = cullBuffers[1];
+        // Each culling region's draw counts are bound as a range of their own, see DispatchGpuCulling().
+        GLint countAlignment = std::max(ssboAlignment, 1);
+        m_drawCountStride = (static_cast<GLint>(DRAW_COUNT_SIZE) + countAlignment - 1) / countAlignment * countAlignment;
+        m_gpuDrawNodeBuffer = cullBuffers[2];
+        m_meshletWorkBuffer = cullBuffers[3];
+        m_transparentSortBuffer = cullBuffers[4];
+        m_transparentBlockOffsetBuffer = cullBuffers[5];
+        m_gpuCullStatistics.Create();
+        m_meshStreamer.Create(Glitter::Config::MESH_STREAMING_BUDGET);
+
+        m_nodes.Reserve(Glitter::Config::INITIAL_NODE_CAPACITY);
+    }
+
+    // Creates the Node textures from `textures`, decoded from `texturePaths` with `decodeOptions`, and their sampler.
+    // Decodes the textures at `texturePaths` in parallel on the workers, then creates them on the main thread, see
+    // CreateTextures(), unless `skip` was requested meanwhile. `texturePaths` must outlive the task.
+    Glitter::Core::Task<> LoadTextures(std::span<const char* const> texturePaths,
+        Glitter::Render::TextureDecodeOptions decodeOptions, std::stop_token skip)
+    {
+        std::vector<Glitter::Core::Task<Glitter::Render::DecodedTexture>> decodes {};
+        for (const char* path : texturePaths) {
+            decodes.push_back(Glitter::Render::DecodeTextureAsync(m_coroutines, path, decodeOptions));
+        }
+        std::vector<Glitter::Render::DecodedTexture> textures = co_await Glitter::Core::WhenAll(std::span(decodes));
+
+        co_await m_coroutines.ResumeOnMain();
+        if (!skip.stop_requested()) {
+            CreateTextures(texturePaths, textures, decodeOptions);
+        }
+    }
+
+    void CreateTextures(std::span<const char* const> texturePaths, std::vector<Glitter::Render::DecodedTexture>& textures,
+        Glitter::Render::TextureDecodeOptions decodeOptions)
+    {
+        // Stage their upload through the upload ring.
+        m_textureUploader.Create(Glitter::Config::TEXTURE_UPLOAD_RING_SIZE);
+
+        // Sample every Node texture trilinearly and anisotropically, whatever their own parameters. The bindless handles
+        // are made from the sampler, the other texture modes bind it during the main pass.
+        GLfloat maxAnisotropy = 1.0f;
+        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxAnisotropy);
+        m_textureAnisotropy = std::clamp(Glitter::Config::TEXTURE_ANISOTROPY, 1.0f, maxAnisotropy);
+        glCreateSamplers(1, &m_nodeSampler);
+        glSamplerParameteri(m_nodeSampler, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glSamplerParameteri(m_nodeSampler, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glSamplerParameteri(m_nodeSampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glSamplerParameteri(m_nodeSampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glSamplerParameterf(m_nodeSampler, GL_TEXTURE_MAX_ANISOTROPY, m_textureAnisotropy);
+        glObjectLabel(GL_SAMPLER, m_nodeSampler, -1, "Node Texture Sampler");
+
+        m_textureCount = texturePaths.size();
+        m_textureStreamer.Create(m_textureCount, Glitter::Config::TEXTURE_STREAMING_BUDGET);
+        if (m_textureMode == TextureMode::Array) {
+            m_textureArray = CreateCompressedTextureArray(texturePaths, textures);
+            if (!m_textureArray) {
+                // The layers that were pre-compressed have to be decoded after all.
+                if (std::ranges::any_of(textures, [](const auto& texture) { return texture.m_compressed.has_value(); })) {
+                    decodeOptions.m_allowCompressed = false;
+                    textures = Glitter::Render::DecodeTextures(texturePaths, m_jobSystem, decodeOptions);
+                }
+                m_textureArray = CreateTextureArray(textures);
+            }
+        } else {
+            // The slots listing the same file, or one decoded into the same contents, share the texture of the first one.
+            std::unordered_map<GLuint, size_t> firstSlots {};
+            for (size_t idx = 0; idx < texturePaths.size(); idx++) {
+                GLuint texture = m_textureCache.Acquire(texturePaths[idx]);
+                std::uint64_t contentHash = 0;
+                if (!texture) {
+                    contentHash = Glitter::Render::TextureCache::HashContents(textures[idx]);
+                    texture = m_textureCache.Acquire(texturePaths[idx], contentHash);
+                }
+                if (texture) {
+                    size_t firstSlot = firstSlots.at(texture);
+                    m_textureStreamer.AddAliasTexture(idx, firstSlot);
+                    m_loadedTextures.push_back(texture);
+                    if (m_textureMode == TextureMode::Bindless) {
+                        m_loadedTextureHandles.push_back(m_loadedTextureHandles[firstSlot]);
+                    }
+                    continue;
+                }
 
-        for (auto& path : texturePaths) {
-            GLuint texture {};
-            glCreateTextures(GL_TEXTURE_2D, 1, &texture);
-            glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
-            glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glObjectLabel(GL_TEXTURE, texture, -1, std::format("Texture <{}>", path).c_str());
+                texture = CreateTexture2D(texturePaths[idx], std::move(textures[idx]), idx);
+                m_textureCache.Insert(texturePaths[idx], contentHash, texture);
+                firstSlots.emplace(texture, idx);
+                m_loadedTextures.push_back(texture);
 
-            int width = 0, height = 0, nChannels = 0;
-            unsigned char* textureData = stbi_load(path, &width, &height, &nChannels, 4);
-            if (textureData) {
-                glTextureStorage2D(texture, 1, GL_RGBA8, width, height);
-                glTextureSubImage2D(texture, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, textureData);
-                glGenerateTextureMipmap(texture);
+                // Make the texture resident, so Nodes can reference it from their PerDrawData without binding it.
+                if (m_textureMode == TextureMode::Bindless) {
+                    GLuint64 handle = Glitter::Render::GetGLExtensions().m_getTextureSamplerHandle(texture, m_nodeSampler);
+                    Glitter::Render::GetGLExtensions().m_makeTextureHandleResident(handle);
+                    m_loadedTextureHandles.push_back(handle);
+                }
             }
-            stbi_image_free(textureData);
-            m_loadedTextures.push_back(texture);
         }
+    }
 
+    // Creates the FBOs and their attachments, and the frame output.
+    PrepareResult CreateFramebuffers()
+    {
         // Create FBO to be used for post-processing effects.
         GLuint fbo = 0;
         glCreateFramebuffers(1, &fbo);
+        m_fbo = fbo;
 
-        // Create the color texture used with the FBO.
-        GLuint fboColor = 0;
-        glCreateTextures(GL_TEXTURE_2D, 1, &fboColor);
-        glTextureStorage2D(fboColor, 1, GL_RGBA8, m_windowWidth, m_windowHeight);
-        glObjectLabel(GL_TEXTURE, fboColor, -1, "Post-Processing FBO Color Texture");
+        // Create the FBO of the weighted blended transparent Nodes, whose color targets are transient and attached every
+        // frame. They're depth tested against the opaque Nodes.
+        glCreateFramebuffers(1, &m_oitFbo);
+        glObjectLabel(GL_FRAMEBUFFER, m_oitFbo, -1, "Weighted OIT FBO");
+        std::array oitDrawBuffers = std::to_array<GLenum>({GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1});
+        glNamedFramebufferDrawBuffers(m_oitFbo, oitDrawBuffers.size(), oitDrawBuffers.data());
+
+        // Create the FBO of the visibility buffer, whose color target is transient and attached every frame. It writes the
+        // opaque Nodes' depth, for the transparent ones and the Hi-Z pyramid.
+        glCreateFramebuffers(1, &m_visibilityFbo);
+        glObjectLabel(GL_FRAMEBUFFER, m_visibilityFbo, -1, "Visibility FBO");
+
+        // Without a default framebuffer, the headless mode presents into a window-sized FBO of its own, the render server
+        // into one per scene, see LoadServedScenes().
+        if (m_benchmark.m_headless && m_benchmark.m_servePath.empty()) {
+            glCreateRenderbuffers(1, &m_headlessColor);
+            Glitter::Render::NamedRenderbufferStorage(Glitter::Render::GpuMemoryCategory::RenderTarget, m_headlessColor, GL_RGBA8,
+                m_windowWidth, m_windowHeight);
+            glCreateFramebuffers(1, &m_headlessFbo);
+            glNamedFramebufferRenderbuffer(m_headlessFbo, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_headlessColor);
+            glObjectLabel(GL_FRAMEBUFFER, m_headlessFbo, -1, "Headless FBO");
+            if (glCheckNamedFramebufferStatus(m_headlessFbo, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                return PrepareResult::FramebufferIncomplete;
+            }
+        }
 
-        // Create the depth renderbuffer (note: can't be sampled) used with the FBO.
-        GLuint fboDepth = 0;
-        glCreateRenderbuffers(1, &fboDepth);
-        glNamedRenderbufferStorage(fboDepth, GL_DEPTH_COMPONENT24, m_windowWidth, m_windowHeight);
-        glObjectLabel(GL_RENDERBUFFER, fboDepth, -1, "Post-Processing FBO Depth Renderbuffer");
+        // Capture every frame into an image sequence, or pipe them to an encoder.
+        if (!m_benchmark.m_capturePipe.empty()) {
+            m_frameOutput.Open(Glitter::Core::FrameOutputFormat::Pipe, m_benchmark.m_capturePipe);
+        } else if (!m_benchmark.m_capturePath.empty()) {
+            m_frameOutput.Open(m_benchmark.m_captureFormat, m_benchmark.m_capturePath.string());
+        }
+        // Export the frames' counters, totalling the GPU memory on the exporter's thread rather than this one.
+        if (!m_benchmark.m_telemetryAddress.empty()) {
+            m_telemetry.Open(m_benchmark.m_telemetryAddress, [] {
+                std::uint64_t bytes = 0;
+                for (const Glitter::Render::GpuMemoryUsage& usage : Glitter::Render::GetGpuMemoryUsage()) {
+                    bytes += usage.m_bytes;
+                }
+                return bytes;
+            });
+        }
+
+        // The benchmark and the render server draw every frame as it comes, at the same resolution and quality.
+        bool fixedFrames = m_benchmark.m_enabled || !m_benchmark.m_servePath.empty();
+        m_dynamicResolution = Glitter::Config::ENABLE_DYNAMIC_RESOLUTION && !fixedFrames;
+        m_lateLatching = Glitter::Config::ENABLE_LATE_LATCHING && !fixedFrames;
+        m_adaptiveQuality = Glitter::Config::ENABLE_QUALITY_GOVERNOR && !fixedFrames;
+        CreateFramebufferAttachments(Glitter::Render::RenderTargetPool::GetBucketSize(m_windowWidth),
+            Glitter::Render::RenderTargetPool::GetBucketSize(m_windowHeight));
+        if (glCheckNamedFramebufferStatus(fbo, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            return PrepareResult::FramebufferIncomplete;
+        }
+
+        m_renderStats.Create();
+        m_depthPrepass.Create();
+        return PrepareResult::Ok;
+    }
+
+    // Reads the camera recording every benchmark frame follows past the warmup, if any, see RecordBenchmarkFrame().
+    void ReadBenchmarkCamera()
+    {
+        if (m_benchmark.m_enabled && !m_benchmark.m_cameraPath.empty()) {
+            m_benchmarkCamera = Glitter::Core::ReadCameraRecording(m_benchmark.m_cameraPath.string().c_str());
+            if (m_benchmarkCamera) {
+                m_benchmark.m_frameCount = m_benchmarkCamera->m_frames.size();
+            }
+        }
+
+    }
+
+    // Loads the benchmark's scene, or spawns its Nodes, once every Mesh it draws is uploaded.
+    void LoadBenchmarkScene()
+    {
+        // Every run must draw the same Meshes from its first frame on, the snapshot's assets requested along with them.
+        bool loadScene = !m_benchmark.m_scenePath.empty() && LoadSceneSnapshot(m_benchmark.m_scenePath.string().c_str());
+        if (loadScene) {
+            AddSnapshotNodes();
+        }
+        m_gltfLoader.Wait();
+        StreamLoadedMeshes(std::numeric_limits<size_t>::max());
+        if (m_uploadContext.IsRunning()) {
+            m_uploadContext.Finish();
+        }
+        if (loadScene) {
+            AddSnapshotNodes();
+        } else {
+            SpawnNodes(m_benchmark.m_nodeCount);
+        }
+        spdlog::info("Benchmarking {} frames with {} Nodes, isolating {}.", m_benchmark.m_frameCount, m_nodes.Size(),
+            Glitter::Core::GetBenchmarkIsolationName(m_benchmark.m_isolation));
+    }
+
+    // Reads the manifest of the scenes to serve, then the snapshot and the camera recording of each, see m_servedScenes.
+    PrepareResult ReadServedScenes()
+    {
+        if (m_benchmark.m_servePath.empty()) {
+            return PrepareResult::Ok;
+        }
+        std::optional<std::vector<Glitter::Core::ServedSceneDesc>> descs
+            = Glitter::Core::ReadServeManifest(m_benchmark.m_servePath);
+        if (!descs) {
+            return PrepareResult::ServedSceneError;
+        }
+
+        m_servedScenes.resize(descs->size());
+        for (size_t sceneIdx = 0; sceneIdx < descs->size(); sceneIdx++) {
+            ServedScene& scene = m_servedScenes[sceneIdx];
+            scene.m_desc = std::move((*descs)[sceneIdx]);
+            scene.m_snapshot = Glitter::Scene::ReadSceneSnapshot(scene.m_desc.m_scenePath.string().c_str());
+            if (!scene.m_snapshot) {
+                return PrepareResult::ServedSceneError;
+            }
+            if (!scene.m_desc.m_cameraPath.empty()) {
+                scene.m_camera = Glitter::Core::ReadCameraRecording(scene.m_desc.m_cameraPath.string().c_str());
+                if (!scene.m_camera) {
+                    return PrepareResult::ServedSceneError;
+                }
+            }
+            scene.m_frameCount = scene.m_camera ? scene.m_camera->m_frames.size() : m_benchmark.m_frameCount;
+        }
+        return PrepareResult::Ok;
+    }
+
+    // Adds the Nodes of every served scene into a NodeStore of its own, once the assets of all of them are uploaded, and
+    // creates its target and frame output. The Nodes of the assets' own scenes are dropped, as the benchmark's are.
+    PrepareResult LoadServedScenes()
+    {
+        // Returns false while an asset of the scene isn't registered yet.
+        auto addNodes = [this](ServedScene& scene) {
+            m_nodes.Clear();
+            m_pendingSnapshot = std::exchange(scene.m_snapshot, std::nullopt);
+            if (!AddSnapshotNodes()) {
+                scene.m_snapshot = std::exchange(m_pendingSnapshot, std::nullopt);
+                return false;
+            }
+            std::swap(m_nodes, scene.m_nodes);
+            return true;
+        };
+
+        // Every scene's assets are requested before any is waited for, so that they're loaded together.
+        std::vector<ServedScene*> pendingScenes {};
+        for (ServedScene& scene : m_servedScenes) {
+            if (!addNodes(scene)) {
+                pendingScenes.push_back(&scene);
+            }
+        }
+        m_gltfLoader.Wait();
+        StreamLoadedMeshes(std::numeric_limits<size_t>::max());
+        if (m_uploadContext.IsRunning()) {
+            m_uploadContext.Finish();
+        }
+        for (ServedScene* scene : pendingScenes) {
+            if (!addNodes(*scene)) {
+                spdlog::error("Failed to load the assets of the served scene {}.", scene->m_desc.m_scenePath.string());
+                return PrepareResult::ServedSceneError;
+            }
+        }
+
+        // The handles of the assets' animated and skinned Nodes would be valid in the scenes' stores too.
+        m_nodes.Clear();
+        m_animationPlayer.RemoveStale(m_nodes);
+        RemoveStaleSkinnedNodes();
+
+        size_t nodeCount = 0;
+        for (ServedScene& scene : m_servedScenes) {
+            glCreateRenderbuffers(1, &scene.m_color);
+            Glitter::Render::NamedRenderbufferStorage(Glitter::Render::GpuMemoryCategory::RenderTarget, scene.m_color, GL_RGBA8,
+                m_windowWidth, m_windowHeight);
+            glCreateFramebuffers(1, &scene.m_fbo);
+            glNamedFramebufferRenderbuffer(scene.m_fbo, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, scene.m_color);
+            glObjectLabel(GL_FRAMEBUFFER, scene.m_fbo, -1, "Served Scene FBO");
+            if (glCheckNamedFramebufferStatus(scene.m_fbo, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                return PrepareResult::FramebufferIncomplete;
+            }
+            if (!scene.m_desc.m_capturePath.empty()) {
+                scene.m_output = std::make_unique<Glitter::Core::FrameOutput>(m_jobSystem);
+                scene.m_output->Open(m_benchmark.m_captureFormat, scene.m_desc.m_capturePath.string());
+            }
+            nodeCount += scene.m_nodes.Size();
+        }
+        spdlog::info("Serving {} scenes round-robin, {} Nodes in all.", m_servedScenes.size(), nodeCount);
+        return PrepareResult::Ok;
+    }
+
+    // Swaps the next served scene with frames left into m_nodes and the backbuffer, in turn, after swapping the previous one
+    // out. Every cache over the Nodes is rebuilt for it, unless it's the only scene left. Returns false once every scene
+    // rendered its frames.
+    bool BeginServedFrame()
+    {
+        std::optional<size_t> previous = m_activeServedScene;
+        if (previous) {
+            m_servedScenes[*previous].m_frame++;
+        }
+
+        m_activeServedScene.reset();
+        size_t first = previous ? *previous + 1 : 0;
+        for (size_t offset = 0; offset < m_servedScenes.size(); offset++) {
+            size_t sceneIdx = (first + offset) % m_servedScenes.size();
+            if (m_servedScenes[sceneIdx].m_frame < m_servedScenes[sceneIdx].m_frameCount) {
+                m_activeServedScene = sceneIdx;
+                break;
+            }
+        }
+        if (m_activeServedScene == previous) {
+            return m_activeServedScene.has_value();
+        }
+
+        if (previous) {
+            std::swap(m_nodes, m_servedScenes[*previous].m_nodes);
+        }
+        if (!m_activeServedScene) {
+            return false;
+        }
+        ServedScene& scene = m_servedScenes[*m_activeServedScene];
+        std::swap(m_nodes, scene.m_nodes);
+        m_nodes.MarkAllDirty();
+        m_headlessFbo = scene.m_fbo;
+        // The pyramid is the previous scene's depth.
+        m_hiZValid = false;
+        return true;
+    }
+
+    // The camera of the served scene's current frame: its recording's, or the default path's at the benchmark's time step.
+    // The recording's key events aren't replayed, since the features they toggle are every scene's.
+    Glitter::Core::CameraFrame GetServedCamera() const
+    {
+        const ServedScene& scene = m_servedScenes[*m_activeServedScene];
+        if (scene.m_camera) {
+            return scene.m_camera->m_frames[scene.m_frame];
+        }
+        constexpr double STEP = Glitter::Config::BENCHMARK_TIME_STEP;
+        auto [eyePos, eyeTarget] = EvaluateCamera(static_cast<float>(static_cast<double>(scene.m_frame) * STEP));
+        return Glitter::Core::CameraFrame {.m_frameTime = STEP, .m_eyePos = eyePos, .m_eyeTarget = eyeTarget};
+    }
+
+    // Once their frames were read back. m_headlessFbo is one of their FBOs.
+    void ReleaseServedScenes()
+    {
+        for (ServedScene& scene : m_servedScenes) {
+            if (scene.m_output) {
+                scene.m_output->Close();
+            }
+            glDeleteFramebuffers(1, &scene.m_fbo);
+            Glitter::Render::DeleteRenderbuffers(1, &scene.m_color);
+        }
+        m_servedScenes.clear();
+        m_activeServedScene.reset();
+        if (!m_benchmark.m_servePath.empty()) {
+            m_headlessFbo = 0;
+        }
+    }
+
+    // Collects the startup's scopes as a frame of their own, and logs how long the Main thread took to start. With
+    // `--startup-report`, also logs its phases from the slowest on, and writes every thread's scopes as a Chrome trace.
+    void ReportStartup()
+    {
+        m_cpuProfiler.CollectFrame();
+        std::span<const Glitter::Core::ProfileThread> threads = m_cpuProfiler.GetFrame();
+        auto mainThread = std::ranges::find(threads, std::string_view("Main"), &Glitter::Core::ProfileThread::m_name);
+        if (mainThread == threads.end()) {
+            return;
+        }
+
+        // Initialize(), Prepare() and WarmUpPrograms() are the only scopes at depth 0, and their phases are at depth 1.
+        std::uint64_t startupNanoseconds = 0;
+        std::vector<Glitter::Core::ProfileEvent> phases {};
+        for (const Glitter::Core::ProfileEvent& event : mainThread->m_events) {
+            if (event.m_depth == 0) {
+                startupNanoseconds += event.m_end - event.m_begin;
+            } else if (event.m_depth == 1) {
+                phases.push_back(event);
+            }
+        }
+        spdlog::info("Started up in {:.1f} ms.", static_cast<double>(startupNanoseconds) / 1e6);
+        if (m_benchmark.m_startupReportPath.empty()) {
+            return;
+        }
+
+        std::ranges::sort(phases, std::ranges::greater {}, [](const auto& phase) { return phase.m_end - phase.m_begin; });
+        for (const Glitter::Core::ProfileEvent& phase : phases) {
+            spdlog::info("  {}: {:.1f} ms", phase.m_name, static_cast<double>(phase.m_end - phase.m_begin) / 1e6);
+        }
+        if (Glitter::Core::WriteChromeTrace(m_benchmark.m_startupReportPath, threads)) {
+            spdlog::info("Wrote the startup report to {}.", m_benchmark.m_startupReportPath.string());
+        } else {
+            spdlog::error("Failed to write the startup report to {}.", m_benchmark.m_startupReportPath.string());
+        }
+    }
+
+    // Draws a frame with only `message` in it, for the startup phases long enough to be noticed.
+    void ShowLoadingScreen(const char* message)
+    {
+        if (m_benchmark.m_headless) {
+            return;
+        }
+
+        ImGui_ImplOpenGL3_NewFrame();
+        ImGui_ImplGlfw_NewFrame();
+        ImGui::NewFrame();
+        ImGui::SetNextWindowPos(ImGui::GetMainViewport()->GetCenter(), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+        ImGui::Begin("Loading", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize);
+        ImGui::TextUnformatted(message);
+        ImGui::End();
+        ImGui::Render();
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, m_windowWidth, m_windowHeight);
+        glClear(GL_COLOR_BUFFER_BIT);
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        glfwSwapBuffers(m_window);
+    }
+
+    // Draws once with every graphics program, in the state and into the target formats of each pass it's drawn in, so that
+    // the driver builds the variants it defers until their first draw now, rather than in the first frames to enable
+    // them. Each draw is scissored out, so that nothing is rasterized into the targets. The compute programs have no state
+    // to be specialized for, and the debug programs are only built once the debug lines are enabled.
+    void WarmUpPrograms()
+    {
+        ShowLoadingScreen("Compiling shaders...");
+
+        // The passes' targets are only attached during their frames, 1x1 ones of the same formats stand in for them.
+        Glitter::Render::RenderTarget accumulation
+            = m_renderTargets.Acquire(GL_RGBA16F, 1, 1, 1, "Warm Up Weighted OIT Accumulation");
+        Glitter::Render::RenderTarget revealage = m_renderTargets.Acquire(GL_R16F, 1, 1, 1, "Warm Up Weighted OIT Revealage");
+        Glitter::Render::RenderTarget visibility = m_renderTargets.Acquire(GL_RGBA32UI, 1, 1, 1, "Warm Up Visibility Buffer");
+        glNamedFramebufferTexture(m_oitFbo, GL_COLOR_ATTACHMENT0, accumulation.m_texture, 0);
+        glNamedFramebufferTexture(m_oitFbo, GL_COLOR_ATTACHMENT1, revealage.m_texture, 0);
+        glNamedFramebufferTexture(m_visibilityFbo, GL_COLOR_ATTACHMENT0, visibility.m_texture, 0);
+
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(0, 0, 0, 0);
+        glViewport(0, 0, m_renderWidth, m_renderHeight);
+        m_renderStats.BindBufferRange(GL_UNIFORM_BUFFER, 0, m_uboStream.GetBuffer(), 0, sizeof(CommonData));
+        m_renderStats.BindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, m_perDrawStream.GetBuffer(), 0,
+            static_cast<GLsizeiptr>(m_perDrawStream.GetRegionSize()));
+        auto draw = [&](GLuint fbo, GLuint vao, GLuint program) {
+            if (program == 0) {
+                return;
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            m_renderStats.BindVertexArray(vao);
+            m_renderStats.UseProgram(program);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+        };
+
+        // The depth-only passes: the depth pre-pass, the shadow maps and the visibility buffer write the depth, the
+        // occlusion boxes only test it.
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        m_renderStats.DepthMask(GL_TRUE);
+        draw(m_fbo, m_depthVAO, m_depthProgram);
+        draw(m_fbo, m_depthVAO, m_shadowProgram);
+        glDisable(GL_CULL_FACE);
+        m_renderStats.DepthMask(GL_FALSE);
+        draw(m_fbo, m_depthVAO, m_occlusionBoxProgram);
+        glEnable(GL_CULL_FACE);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        m_renderStats.DepthMask(GL_TRUE);
+        draw(m_visibilityFbo, m_depthVAO, m_visibilityProgram);
+
+        // The opaque Nodes and their impostors, then the transparent ones blended over them, or into the weighted OIT
+        // targets.
+        for (std::uint32_t permutation = 0; permutation < MAIN_PERMUTATION_COUNT; permutation++) {
+            if ((permutation & MAIN_PERMUTATION_TRANSPARENT) == 0) {
+                draw(m_fbo, m_mainVAO, m_mainPrograms[permutation]);
+                draw(m_fbo, m_mainVAO, m_impostorPrograms[permutation]);
+            }
+        }
+        m_renderStats.DepthMask(GL_FALSE);
+        for (std::uint32_t permutation = 0; permutation < MAIN_PERMUTATION_COUNT; permutation++) {
+            if ((permutation & MAIN_PERMUTATION_TRANSPARENT) == 0) {
+                continue;
+            }
+            if ((permutation & MAIN_PERMUTATION_WEIGHTED_OIT) != 0) {
+                m_renderStats.BlendFunci(0, GL_ONE, GL_ONE);
+                m_renderStats.BlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+                draw(m_oitFbo, m_mainVAO, m_mainPrograms[permutation]);
+                m_renderStats.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            } else {
+                draw(m_fbo, m_mainVAO, m_mainPrograms[permutation]);
+            }
+        }
+        m_renderStats.DepthMask(GL_TRUE);
+        glDisable(GL_SCISSOR_TEST);
+
+        glNamedFramebufferTexture(m_oitFbo, GL_COLOR_ATTACHMENT0, 0, 0);
+        glNamedFramebufferTexture(m_oitFbo, GL_COLOR_ATTACHMENT1, 0, 0);
+        glNamedFramebufferTexture(m_visibilityFbo, GL_COLOR_ATTACHMENT0, 0, 0);
+        m_renderTargets.Release(accumulation);
+        m_renderTargets.Release(revealage);
+        m_renderTargets.Release(visibility);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, m_windowWidth, m_windowHeight);
+
+        // Drivers build the variants on their own thread, wait for it before the first frame.
+        glFinish();
+    }
+
+    struct ShaderStage {
+        GLenum m_type;
+        const char* m_path;
+        std::span<const ShaderConstant> m_constants {};
+    };
+
+    // Everything needed to build a program again, when its shaders are reloaded.
+    struct ProgramSource {
+        std::vector<ShaderStage> m_stages;
+        std::string m_defines;
+        std::string m_name;
+        GLuint* m_program;
+    };
+
+    struct PendingProgramTarget {
+        Glitter::Render::PendingProgram m_pending;
+        GLuint* m_program;
+    };
+
+    // Starts building the program of `stages` into `program`, which is only set by FinishPrograms().
+    bool SubmitProgram(std::span<const ShaderStage> stages, std::string_view defines, const char* name, GLuint& program)
+    {
+        ProgramSource source {
+            .m_stages = {stages.begin(), stages.end()},
+            .m_defines = std::string(defines),
+            .m_name = name,
+            .m_program = &program,
+        };
+        std::optional<PendingProgramTarget> pending = BeginProgram(source);
+        if (!pending) {
+            return false;
+        }
+
+        m_pendingPrograms.push_back(std::move(*pending));
+        if (m_shaderHotReload) {
+            for (const ShaderStage& stage : stages) {
+                m_shaderWatcher.Watch(stage.m_path);
+                if (m_spirvShaders) {
+                    m_shaderWatcher.Watch(GetSpirvPath(stage.m_path, defines));
+                }
+            }
+            m_programSources.push_back(std::move(source));
+        }
+        return true;
+    }
+
+    std::optional<PendingProgramTarget> BeginProgram(const ProgramSource& source)
+    {
+        std::vector<Glitter::Render::ShaderSource> sources {};
+        for (const ShaderStage& stage : source.m_stages) {
+            std::string defines = source.m_defines;
+            for (const ShaderConstant& constant : stage.m_constants) {
+                defines += std::format("#define {} {}\n", constant.m_define, constant.m_value);
+            }
+            std::optional<std::string> shaderSource = LoadShaderSource(stage.m_path, m_shaderHotReload, defines);
+            if (!shaderSource) {
+                return std::nullopt;
+            }
+            Glitter::Render::ShaderSource& shader = sources.emplace_back(Glitter::Render::ShaderSource {
+                .m_type = stage.m_type,
+                .m_source = std::move(*shaderSource),
+            });
+
+            // The GLSL source is kept, to fall back on if the modules don't link.
+            std::optional<Glitter::Util::MappedFile> spirv {};
+            if (m_spirvShaders) {
+                spirv = OpenShaderFile(GetSpirvPath(stage.m_path, source.m_defines).c_str(), m_shaderHotReload);
+            }
+            if (spirv) {
+                shader.m_spirv.assign(spirv->GetData().begin(), spirv->GetData().end());
+                for (const ShaderConstant& constant : stage.m_constants) {
+                    shader.m_constants.push_back({.m_id = constant.m_id, .m_value = std::bit_cast<GLuint>(constant.m_value)});
+                }
+            }
+        }
+
+        return PendingProgramTarget {
+            .m_pending = Glitter::Render::PendingProgram::Submit(std::move(sources), source.m_name.c_str(), m_programCache),
+            .m_program = source.m_program,
+        };
+    }
+
+    // Waits for every submitted program, in the order they were submitted.
+    PrepareResult FinishPrograms()
+    {
+        PrepareResult result = PrepareResult::Ok;
+        for (PendingProgramTarget& target : m_pendingPrograms) {
+            std::expected<GLuint, Glitter::Render::ProgramError> program = target.m_pending.Finish(m_programCache);
+            if (program) {
+                *target.m_program = *program;
+            } else if (result == PrepareResult::Ok) {
+                bool compileError = program.error() == Glitter::Render::ProgramError::Compile;
+                result = compileError ? PrepareResult::ShaderCompileError : PrepareResult::ProgramLinkError;
+            }
+        }
+        m_pendingPrograms.clear();
+        return result;
+    }
+
+    // Rebuilds the programs whose shaders were modified, without waiting for the driver, and swaps each one in once it's
+    // linked. A program that fails to build keeps the previous one.
+    void ReloadShaders()
+    {
+        GLITTER_PROFILE_SCOPE("Reload Shaders");
+        for (const std::string& path : m_shaderWatcher.Poll()) {
+            for (const ProgramSource& source : m_programSources) {
+                auto usesPath = [&](const ShaderStage& stage) {
+                    return path == stage.m_path || (m_spirvShaders && path == GetSpirvPath(stage.m_path, source.m_defines));
+                };
+                if (std::ranges::none_of(source.m_stages, usesPath)) {
+                    continue;
+                }
+
+                spdlog::info("Reloading {} after <{}> changed.", source.m_name, path);
+                if (std::optional<PendingProgramTarget> pending = BeginProgram(source)) {
+                    m_reloadingPrograms.push_back(std::move(*pending));
+                }
+            }
+        }
+
+        // In submission order, so that the last rebuild of a program edited twice in a row is the one that stays.
+        while (!m_reloadingPrograms.empty() && m_reloadingPrograms.front().m_pending.IsReady()) {
+            PendingProgramTarget& target = m_reloadingPrograms.front();
+            std::expected<GLuint, Glitter::Render::ProgramError> program = target.m_pending.Finish(m_programCache);
+            if (program) {
+                // The previous frames' draws keep the old program alive until they're done with it.
+                glDeleteProgram(*target.m_program);
+                *target.m_program = *program;
+            }
+            m_reloadingPrograms.pop_front();
+        }
+    }
+
+    // Creates the debug draw's ring and VAOs, and submits its programs, the first frame debug lines are enabled, so that
+    // the runs without them never pay for them. The lines aren't drawn until FinishLinkedPrograms() sets the programs.
+    void CreateDebugDraw()
+    {
+        if (!Glitter::Config::ENABLE_DEBUG_DRAW || !m_debugLines || m_debugDraw.IsCreated()) {
+            return;
+        }
+
+        GLITTER_PROFILE_SCOPE("Create Debug Draw");
+        std::array debugStages = std::to_array<ShaderStage>({
+            {GL_VERTEX_SHADER, "shaders/debug/DebugVS.glsl"},
+            {GL_FRAGMENT_SHADER, "shaders/debug/DebugFS.glsl"},
+        });
+        if (!SubmitProgram(debugStages, {}, "Debug Program", m_debugProgram)
+            || !SubmitProgram(debugStages, "#define GLITTER_DEBUG_AABBS\n", "Debug AABB Program", m_debugAABBProgram)) {
+            spdlog::error("Failed to load the debug shaders, disabling the debug lines.");
+            m_debugLines = false;
+            return;
+        }
+
+        // The AABBs are expanded from the Node bounds SSBO, without any attribute.
+        m_debugDraw.Create();
+        glCreateVertexArrays(1, &m_debugAABBVAO);
+        glObjectLabel(GL_VERTEX_ARRAY, m_debugAABBVAO, -1, "Debug AABB VAO");
+    }
+
+    // Sets the programs submitted after Prepare() once the driver linked them, without waiting for it. A program that
+    // fails to build stays 0, and isn't drawn with.
+    void FinishLinkedPrograms()
+    {
+        while (!m_pendingPrograms.empty() && m_pendingPrograms.front().m_pending.IsReady()) {
+            PendingProgramTarget& target = m_pendingPrograms.front();
+            if (std::expected<GLuint, Glitter::Render::ProgramError> program = target.m_pending.Finish(m_programCache)) {
+                *target.m_program = *program;
+            }
+            m_pendingPrograms.erase(m_pendingPrograms.begin());
+        }
+    }
+
+    // The GPU frame time, from the rolling averages of the passes' timings.
+    double GetGpuFrameMilliseconds() const
+    {
+        double gpuMilliseconds = 0.0;
+        for (const auto& scope : m_gpuProfiler.GetScopes()) {
+            if (scope.m_depth == 0) {
+                gpuMilliseconds += scope.m_averageMilliseconds;
+            }
+        }
+        return gpuMilliseconds;
+    }
+
+    // The main thread's time in the latest frame collected by m_cpuProfiler, without pacing the frame or swapping the
+    // buffers, which only wait for the display and the GPU.
+    double GetCpuFrameMilliseconds() const
+    {
+        for (const Glitter::Core::ProfileThread& thread : m_cpuProfiler.GetFrame()) {
+            if (thread.m_name != "Main") {
+                continue;
+            }
+            std::uint64_t nanoseconds = 0;
+            for (const Glitter::Core::ProfileEvent& event : thread.m_events) {
+                std::string_view name = event.m_name;
+                if (event.m_depth == 0 && name != "Tick") {
+                    nanoseconds += event.m_end - event.m_begin;
+                } else if (event.m_depth > 0 && name == "Swap") {
+                    nanoseconds -= event.m_end - event.m_begin;
+                }
+            }
+            return static_cast<double>(nanoseconds) * 1e-6;
+        }
+        return 0.0;
+    }
+
+    // Scales the main pass' resolution to hold the GPU frame time, back to full resolution when m_dynamicResolution is
+    // off, and steps the quality to hold the slower of the CPU and GPU frame times when m_adaptiveQuality is on. The render
+    // targets are reallocated once the window has settled into another bucket, and until then the main pass renders the
+    // largest viewport of the current ones that keeps the window's aspect ratio. The shadow map is reallocated at the size
+    // of a new quality level right away, which is safe here since the update thread is idle.
+    void UpdateRenderTargets()
+    {
+        double gpuMilliseconds = GetGpuFrameMilliseconds();
+        if (m_dynamicResolution) {
+            m_resolutionScaler.Update(gpuMilliseconds);
+        } else {
+            m_resolutionScaler.Reset();
+        }
+
+        if (m_adaptiveQuality) {
+            m_qualityGovernor.Update(GetCpuFrameMilliseconds(), gpuMilliseconds);
+        } else {
+            m_qualityGovernor.Reset();
+        }
+        GLsizei shadowMapSize = m_qualityGovernor.GetLevel().m_shadowMapSize;
+        if (shadowMapSize != m_shadowCache.GetSize()) {
+            m_shadowCache.Create(shadowMapSize);
+        }
+
+        GLsizei targetWidth = Glitter::Render::RenderTargetPool::GetBucketSize(m_windowWidth);
+        GLsizei targetHeight = Glitter::Render::RenderTargetPool::GetBucketSize(m_windowHeight);
+        bool resizeSettled = glfwGetTime() - m_lastResizeTime >= Glitter::Config::RENDER_TARGET_RESIZE_SETTLE;
+        bool resize = resizeSettled && (targetWidth != m_fboColor.m_width || targetHeight != m_fboColor.m_height);
+        if (resize || m_fboColor.m_format != GetColorFormat()) {
+            CreateFramebufferAttachments(resizeSettled ? targetWidth : m_fboColor.m_width,
+                resizeSettled ? targetHeight : m_fboColor.m_height);
+        }
+
+        float scale = m_resolutionScaler.GetScale() * (m_temporalUpsampling ? m_temporalUpsamplingScale : 1.0f);
+        // In stereo, each eye gets half of the window.
+        float width = static_cast<float>(m_windowWidth) * scale / (m_stereo ? 2.0f : 1.0f);
+        float height = static_cast<float>(m_windowHeight) * scale;
+        float fit = std::min(
+            {1.0f, static_cast<float>(m_fboColor.m_width) / width, static_cast<float>(m_fboColor.m_height) / height});
+        m_renderWidth = std::clamp(static_cast<int>(width * fit), 1, m_fboColor.m_width);
+        m_renderHeight = std::clamp(static_cast<int>(height * fit), 1, m_fboColor.m_height);
+        if (m_benchmark.m_isolation == Glitter::Core::BenchmarkIsolation::TinyViewport) {
+            m_renderWidth = 1;
+            m_renderHeight = 1;
+        }
+
+        m_renderTargets.Trim();
+    }
+
+    // Uploads the primitives of the assets finished by m_gltfLoader, one at a time, until `byteBudget` is spent. The
+    // Meshes of an asset become drawable once all of its primitives are uploaded.
+    void StreamLoadedMeshes(size_t byteBudget)
+    {
+        GLITTER_PROFILE_SCOPE("Stream Meshes");
+
+        // Register the Meshes whose previous uploads the GPU has finished.
+        if (m_uploadContext.IsRunning()) {
+            m_uploadContext.Poll();
+        }
+
+        while (std::optional<Glitter::Scene::GltfLoadResult> result = m_gltfLoader.Poll()) {
+            if (!result->m_asset) {
+                spdlog::error("Failed to load the glTF file {}.", result->m_path);
+                m_assetMeshes[result->m_path] = AssetMeshes {.m_firstMesh = 0, .m_meshCount = 0};
+                continue;
+            }
+
+            m_pendingAssets.push_back(
+                PendingAsset {.m_path = std::move(result->m_path), .m_source = std::move(*result->m_asset), .m_primitives = {}});
+        }
+
+        size_t uploadedBytes = 0;
+        std::vector<Mesh> loadedMeshes {};
+        std::vector<LoadedScene> loadedScenes {};
+        while (!m_pendingAssets.empty() && uploadedBytes < byteBudget) {
+            PendingAsset& pending = m_pendingAssets.front();
+            if (pending.m_primitives.size() < pending.m_source.m_primitives.size()) {
+                const Glitter::Scene::GltfPrimitive& primitive = pending.m_source.m_primitives[pending.m_primitives.size()];
+
+                // Sub-allocate the primitive's vertices and indices from the shared Geometry Pool, followed by the index
+                // lists of its LODs, which reuse the same vertices. Streamed, only its coarsest LOD is added for now, and
+                // m_meshStreamer adds the finer ones as Nodes drawing it come close. The skinned Meshes draw the indices
+                // of the Primitives they skin, so the skinned ones keep all of theirs.
+                bool streamed = Glitter::Config::ENABLE_MESH_STREAMING && primitive.m_skinnedVertexData.empty()
+                    && !primitive.m_lods.empty();
+                std::span<const std::byte> vertices = Glitter::Config::ENABLE_QUANTIZED_VERTICES
+                    ? std::as_bytes(std::span(primitive.m_quantizedVertexData))
+                    : std::as_bytes(std::span(primitive.m_vertexData));
+                std::span<const uint32_t> indices = streamed ? std::span<const uint32_t> {} : primitive.m_vertexIndices;
+                Glitter::Render::GeometryRange range = m_geometryPool.Add(vertices, indices);
+                uploadedBytes += vertices.size() + sizeof(uint32_t) * indices.size();
+
+                Primitive uploaded {.m_page = range.m_page,
+                    .m_baseVertex = range.m_baseVertex,
+                    .m_firstIndex = range.m_firstIndex,
+                    .m_baseTexture = 0,
+                    .m_elementCount = range.m_indexCount,
+                    .m_vertexCount = static_cast<GLuint>(vertices.size() / static_cast<size_t>(m_geometryPool.GetVertexStride())),
+                    .m_firstInfluence = NO_INFLUENCES,
+                    .m_streamedSlot = NO_STREAMED_LODS,
+                    .m_lods = {},
+                    .m_meshlets = primitive.m_meshlets};
+                if (!primitive.m_skinnedVertexData.empty()) {
+                    uploaded.m_firstInfluence
+                        = m_skinnedMeshes.AddInfluences(std::as_bytes(std::span(primitive.m_skinnedVertexData)));
+                    uploadedBytes += sizeof(Glitter::Scene::SkinnedVertex) * primitive.m_skinnedVertexData.size();
+                }
+                if (streamed) {
+                    std::vector<Glitter::Render::StreamedMeshLevel> levels {};
+                    levels.push_back(
+                        {.m_resolution = Glitter::Render::MESH_FULL_RESOLUTION, .m_indices = primitive.m_vertexIndices});
+                    for (const Glitter::Scene::GltfLod& lod : primitive.m_lods) {
+                        levels.push_back({.m_resolution = lod.m_resolution, .m_indices = lod.m_indices});
+                    }
+                    uploaded.m_streamedSlot
+                        = m_meshStreamer.Add(m_geometryPool, range.m_page, range.m_baseVertex, std::move(levels));
+                    ApplyStreamedLods(uploaded);
+                    uploadedBytes += sizeof(uint32_t) * primitive.m_lods.back().m_indices.size();
+                } else {
+                    for (const Glitter::Scene::GltfLod& lod : primitive.m_lods) {
+                        Glitter::Render::GeometryRange lodRange = m_geometryPool.AddIndices(
+                            range.m_page, range.m_baseVertex, std::span<const uint32_t>(lod.m_indices));
+                        uploaded.m_lods.push_back(PrimitiveLod {.m_firstIndex = lodRange.m_firstIndex,
+                            .m_elementCount = lodRange.m_indexCount,
+                            .m_resolution = lod.m_resolution});
+                        uploadedBytes += sizeof(uint32_t) * lod.m_indices.size();
+                    }
+                }
+                pending.m_primitives.push_back(std::move(uploaded));
+            }
+
+            if (pending.m_primitives.size() < pending.m_source.m_primitives.size()) {
+                continue;
+            }
+
+            // Register each Mesh of the asset, with primitives shared between them drawn from the same range, then add
+            // the Nodes of its scene. Its materials are appended to the material table right away, the table is only
+            // uploaded along with the Meshes. Past the material IDs PerDrawData can hold, the Meshes keep the default one.
+            auto firstMaterial = static_cast<std::uint32_t>(m_materials.size());
+            bool materialsFit = m_materials.size() + pending.m_source.m_materials.size() <= MAX_NODE_MATERIALS;
+            if (!materialsFit) {
+                spdlog::warn("Too many materials, drawing the {} of this asset with the default one instead.",
+                    pending.m_source.m_materials.size());
+                pending.m_source.m_materials.clear();
+            }
+            for (const Glitter::Scene::GltfMaterial& material : pending.m_source.m_materials) {
+                m_materials.push_back(GpuMaterial {.m_baseColor = material.m_baseColor,
+                    .m_specularStrength = material.m_specularStrength,
+                    .m_specularExponent = material.m_specularExponent,
+                    .m_padding = {}});
+            }
+            loadedScenes.push_back(LoadedScene {.m_path = std::move(pending.m_path),
+                .m_firstMesh = loadedMeshes.size(),
+                .m_meshCount = pending.m_source.m_meshes.size(),
+                .m_nodes = pending.m_source.m_nodes,
+                .m_joints = std::move(pending.m_source.m_joints),
+                .m_skinJoints = std::move(pending.m_source.m_skinJoints),
+                .m_skins = std::move(pending.m_source.m_skins),
+                .m_animations = std::move(pending.m_source.m_animations)});
+            for (const Glitter::Scene::GltfMesh& source : pending.m_source.m_meshes) {
+                Mesh glitterMesh {};
+                for (std::uint32_t primitiveIdx : source.m_primitives) {
+                    glitterMesh.m_primitives.push_back(pending.m_primitives[primitiveIdx]);
+                }
+                glitterMesh.m_aabb = source.m_aabb;
+                glitterMesh.m_dequantize = pending.m_source.m_dequantize;
+                glitterMesh.m_occluder = BuildOccluder(pending.m_source, source);
+                if (materialsFit && source.m_material != Glitter::Scene::GLTF_NO_MATERIAL) {
+                    glitterMesh.m_materialID = firstMaterial + source.m_material;
+                }
+
+                loadedMeshes.emplace_back(std::move(glitterMesh));
+            }
+            m_pendingAssets.pop_front();
+        }
+
+        if (uploadedBytes > 0) {
+            Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::UPLOAD);
+            m_renderStats.CountUpload(uploadedBytes);
+
+            // Write the geometry from the upload context, and only draw the Meshes once it has landed. Growing the pool
+            // copies the buffers, so the writes still in flight have to land first.
+            bool reallocated = false;
+            if (m_uploadContext.IsRunning()) {
+                if (m_geometryPool.NeedsReallocation()) {
+                    m_uploadContext.Finish();
+                }
+
+                Glitter::Render::GeometryUpload upload {};
+                reallocated = m_geometryPool.Stage(upload);
+                m_uploadContext.Submit([upload = std::move(upload)] { Glitter::Render::GeometryPool::Write(upload); },
+                    [this, meshes = std::move(loadedMeshes), scenes = std::move(loadedScenes)]() mutable {
+                        AddMeshes(std::move(meshes), scenes);
+                    });
+                loadedMeshes.clear();
+                loadedScenes.clear();
+            } else {
+                reallocated = m_geometryPool.Upload();
+            }
+
+            // Point the VAO at the shared VBO and EBO again if they had to grow.
+            if (reallocated) {
+                Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::BUFFER_GROWTH);
+                AttachGeometryPool();
+            }
+        }
+
+        if (!loadedMeshes.empty()) {
+            AddMeshes(std::move(loadedMeshes), loadedScenes);
+        }
+    }
+
+    // Points the VAOs at the current buffers of the geometry pool's attached page.
+    void AttachGeometryPool()
+    {
+        std::uint32_t page = m_attachedGeometryPage;
+        glVertexArrayVertexBuffer(m_mainVAO, 0, m_geometryPool.GetVBO(page), 0, m_geometryPool.GetVertexStride());
+        glVertexArrayElementBuffer(m_mainVAO, m_geometryPool.GetEBO(page));
+        if (m_depthVAO != m_mainVAO) {
+            glVertexArrayVertexBuffer(
+                m_depthVAO, 0, m_geometryPool.GetPositionVBO(page), 0, m_geometryPool.GetPositionStride());
+            glVertexArrayElementBuffer(m_depthVAO, m_geometryPool.GetEBO(page));
+        }
+    }
+
+    // Attaches page `page` of the geometry pool for the draws of its Primitives, and binds its VBO as the pulled vertices.
+    void AttachGeometryPage(std::uint32_t page)
+    {
+        if (page == m_attachedGeometryPage) {
+            return;
+        }
+        m_attachedGeometryPage = page;
+        AttachGeometryPool();
+        BindPulledVertices();
+    }
+
+    // Binds page `page` of the Node data as SSBO 0, or m_staticBatchData for STATIC_BATCH_NODE_PAGE, whose few slots all
+    // fit in a page.
+    void BindNodePage(std::uint32_t page)
+    {
+        m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0,
+            page == STATIC_BATCH_NODE_PAGE ? m_staticBatchData.GetBuffer() : m_nodeDataBuffer.GetBuffer(page));
+    }
+
+    // The pages the visibility buffer's draws were drawn from, as VisibilityFS.glsl writes them for the resolve to match.
+    static GLuint PackVisibilityPages(std::uint32_t nodePage, std::uint32_t geometryPage)
+    {
+        return static_cast<GLuint>(nodePage << 16 | geometryPage);
+    }
+
+    // Points a streamed Primitive at its resident levels in m_meshStreamer: the finest as its own index list, and the
+    // coarser ones as its LODs.
+    void ApplyStreamedLods(Primitive& primitive) const
+    {
+        std::span<const Glitter::Render::ResidentMeshLevel> levels = m_meshStreamer.GetResidentLevels(primitive.m_streamedSlot);
+        primitive.m_firstIndex = levels.front().m_firstIndex;
+        primitive.m_elementCount = levels.front().m_indexCount;
+        primitive.m_lods.clear();
+        for (const Glitter::Render::ResidentMeshLevel& level : levels.subspan(1)) {
+            primitive.m_lods.push_back(PrimitiveLod {
+                .m_firstIndex = level.m_firstIndex, .m_elementCount = level.m_indexCount, .m_resolution = level.m_resolution});
+        }
+    }
+
+    void AddMeshes(std::vector<Mesh> meshes, std::span<const LoadedScene> scenes)
+    {
+        // Appended rather than added, an asset's Meshes have consecutive IDs.
+        size_t firstMesh = m_meshes.Size();
+        for (Mesh& mesh : meshes) {
+            m_spawnableMeshes.push_back(m_meshes.Append(std::move(mesh)));
+        }
+        UploadMeshTables();
+        UploadMaterialTable();
+        BakeImpostors(firstMesh);
+
+        // Every Node of a scene drawing the same Mesh is an instance of the same draw, but the skinned ones, each drawing a
+        // Mesh of its own skinned vertices.
+        size_t skinnedNodeCount = m_skinnedNodes.size();
+        for (const LoadedScene& scene : scenes) {
+            m_assetMeshes[scene.m_path]
+                = AssetMeshes {.m_firstMesh = firstMesh + scene.m_firstMesh, .m_meshCount = scene.m_meshCount};
+
+            std::optional<std::uint32_t> skeleton {};
+            if (!scene.m_skins.empty()) {
+                skeleton = m_skeletons.Add(scene.m_joints, scene.m_skinJoints);
+            }
+
+            std::vector<Glitter::Scene::NodeHandle> handles {};
+            handles.reserve(scene.m_nodes.size());
+            std::optional<Glitter::Scene::NodeHandle> skinOwner {};
+            for (const Glitter::Scene::GltfNode& node : scene.m_nodes) {
+                std::optional<Glitter::Scene::NodeHandle> parent {};
+                if (node.m_parent != Glitter::Scene::GLTF_NO_PARENT) {
+                    parent = handles[node.m_parent];
+                }
+                size_t meshID = firstMesh + scene.m_firstMesh + node.m_mesh;
+                std::optional<std::uint32_t> instance {};
+                if (skeleton && node.m_skin != Glitter::Scene::GLTF_NO_SKIN) {
+                    instance = AddSkinnedMesh(meshID, *skeleton, scene.m_skins[node.m_skin]);
+                }
+                handles.push_back(m_nodes.Add(Glitter::Scene::NodeDesc {.m_position = node.m_translation,
+                    .m_rotation = node.m_rotation,
+                    .m_scale = node.m_scale,
+                    .m_meshID = meshID,
+                    .m_textureID = 0,
+                    .m_materialID = m_meshes[meshID].m_materialID,
+                    .m_opacity = 1.0f,
+                    .m_shouldAnimate = false,
+                    .m_animationPhase = 0.0f,
+                    .m_parent = parent}));
+                if (instance) {
+                    m_skinnedNodes.push_back(
+                        SkinnedNode {.m_handle = handles.back(),
+                            .m_instance = *instance,
+                            .m_skeleton = *skeleton,
+                            .m_mesh = static_cast<std::uint32_t>(meshID)});
+                    skinOwner = skinOwner.value_or(handles.back());
+                }
+            }
+            if (!scene.m_nodes.empty()) {
+                spdlog::info("Added the {} Nodes of a loaded scene.", scene.m_nodes.size());
+            }
+
+            // Its joints are animated while its first skinned Node is left, and dropped if it has none.
+            std::optional<Glitter::Scene::AnimatedJoints> joints {};
+            if (skinOwner) {
+                joints = Glitter::Scene::AnimatedJoints {.m_firstJoint = m_skeletons.GetInstance(*skeleton).m_firstJoint,
+                    .m_owner = *skinOwner};
+            } else if (skeleton) {
+                m_skeletons.Remove(*skeleton);
+            }
+
+            // Its first animation loops from then on, the others would overwrite the same Nodes.
+            if (!scene.m_animations.m_clips.empty()) {
+                m_animationPlayer.Add(scene.m_animations, 0, handles, joints);
+                spdlog::info("Playing the first of its {} animations.", scene.m_animations.m_clips.size());
+            }
+        }
+
+        // The skinned Meshes were added past the others.
+        if (m_skinnedNodes.size() > skinnedNodeCount) {
+            UploadMeshTables();
+            spdlog::info("Skinning {} of the Nodes on the GPU.", m_skinnedNodes.size() - skinnedNodeCount);
+        }
+    }
+
+    // Imports the asset at `path` in the background, unless it already was requested. Its Meshes are registered under its
+    // path in m_assetMeshes once they're uploaded.
+    void RequestAsset(const std::string& path)
+    {
+        if (m_assetMeshes.try_emplace(path).second) {
+            m_gltfLoader.Request(path);
+        }
+    }
+
+    // Adds a copy of Mesh `meshID` drawing a SkinnedMeshes instance of its Primitives, skinned by the joints of `skin` in
+    // Skeletons instance `skeleton`, at the ID of a removed one if there's any, and points `meshID` at it. Returns the
+    // instance, or nothing if any of its Primitives has no influences, then drawn unskinned.
+    std::optional<std::uint32_t> AddSkinnedMesh(size_t& meshID, std::uint32_t skeleton, const Glitter::Scene::GltfSkin& skin)
+    {
+        const Mesh& source = m_meshes[meshID];
+        if (source.m_primitives.empty()
+            || std::ranges::any_of(source.m_primitives, [](const Primitive& p) { return p.m_firstInfluence == NO_INFLUENCES; })) {
+            return std::nullopt;
+        }
+
+        // The skinned vertices can't be bounded once and for all, so the Mesh is bounded by its AABB moved by each of its
+        // joints at rest, inflated by Config::SKINNED_BOUNDS_SCALE.
+        const Glitter::Scene::Skeletons::Instance& instance = m_skeletons.GetInstance(skeleton);
+        std::uint32_t firstMatrix = instance.m_firstPaletteEntry + skin.m_firstJoint;
+        glm::vec3 boundsMin {FLT_MAX};
+        glm::vec3 boundsMax {-FLT_MAX};
+        for (std::uint32_t jointIdx = 0; jointIdx < skin.m_jointCount; jointIdx++) {
+            glm::mat4 skinning = m_skeletons.GetSkinning(firstMatrix + jointIdx);
+            for (std::uint32_t corner = 0; corner < 8; corner++) {
+                glm::vec3 local = glm::mix(source.m_aabb.m_localMin, source.m_aabb.m_localMax,
+                    glm::vec3((corner & 1) != 0, (corner & 2) != 0, (corner & 4) != 0));
+                glm::vec3 skinned = glm::vec3(skinning * glm::vec4(local, 1.0f));
+                boundsMin = glm::min(boundsMin, skinned);
+                boundsMax = glm::max(boundsMax, skinned);
+            }
+        }
+        if (skin.m_jointCount == 0) {
+            boundsMin = source.m_aabb.m_localMin;
+            boundsMax = source.m_aabb.m_localMax;
+        }
+        glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+        glm::vec3 extent = glm::max((boundsMax - boundsMin) * Glitter::Config::SKINNED_BOUNDS_SCALE, glm::vec3(1e-4f));
+
+        Mesh skinned = source;
+        skinned.m_aabb = Glitter::Scene::AABB {.m_localMin = center - extent * 0.5f, .m_localMax = center + extent * 0.5f};
+        skinned.m_impostorLayer.reset();
+        skinned.m_dequantize = Glitter::Config::ENABLE_QUANTIZED_VERTICES
+            ? glm::scale(glm::translate(glm::mat4(1.0f), skinned.m_aabb.m_localMin), extent)
+            : glm::mat4(1.0f);
+
+        glm::mat4 quantize = glm::inverse(skinned.m_dequantize);
+        std::vector<Glitter::Render::SkinnedPartDesc> parts {};
+        for (const Primitive& primitive : source.m_primitives) {
+            parts.push_back(Glitter::Render::SkinnedPartDesc {.m_dequantize = source.m_dequantize,
+                .m_quantize = quantize,
+                .m_page = primitive.m_page,
+                .m_sourceBaseVertex = primitive.m_baseVertex,
+                .m_vertexCount = primitive.m_vertexCount,
+                .m_firstInfluence = primitive.m_firstInfluence,
+                .m_firstMatrix = firstMatrix,
+                .m_matrixCount = skin.m_jointCount});
+        }
+        std::vector<GLint> baseVertices(parts.size());
+        std::uint32_t skinnedInstance = m_skinnedMeshes.Add(m_geometryPool, parts, baseVertices);
+
+        // The meshlets' bounds and cones would no longer hold once skinned, its Primitives are culled whole.
+        for (size_t primitiveIdx = 0; primitiveIdx < skinned.m_primitives.size(); primitiveIdx++) {
+            skinned.m_primitives[primitiveIdx].m_baseVertex = baseVertices[primitiveIdx];
+            skinned.m_primitives[primitiveIdx].m_meshlets.clear();
+        }
+        meshID = m_meshes.Add(std::move(skinned));
+        return skinnedInstance;
+    }
+
+    // (Re)creates the Mesh, Primitive and meshlet tables read by the GPU culling passes from m_meshes.
+    void UploadMeshTables()
+    {
+        std::vector<GpuMeshInfo> meshInfos {};
+        std::vector<GpuPrimitiveInfo> primitiveInfos {};
+        std::vector<GpuMeshletInfo> meshletInfos {};
+        for (size_t meshID = 0; meshID < m_meshes.Size(); meshID++) {
+            // A freed Mesh ID keeps its entry, without Primitives, for the others to stay indexed by theirs.
+            const Mesh& mesh = m_meshes[meshID];
+            if (!m_meshes.IsLive(meshID)) {
+                meshInfos.push_back(GpuMeshInfo {.m_firstPrimitive = static_cast<GLuint>(primitiveInfos.size()),
+                    .m_primitiveCount = 0,
+                    .m_padding = {},
+                    .m_quantize = glm::mat4(1.0f)});
+                continue;
+            }
+            meshInfos.push_back(GpuMeshInfo {.m_firstPrimitive = static_cast<GLuint>(primitiveInfos.size()),
+                .m_primitiveCount = static_cast<GLuint>(mesh.m_primitives.size()),
+                .m_padding = {},
+                .m_quantize = glm::inverse(mesh.m_dequantize)});
+
+            size_t commandCount = 0;
+            for (const Primitive& primitive : mesh.m_primitives) {
+                // The meshlets index the Primitive's own indices, a streamed Primitive is culled whole until they're
+                // resident.
+                std::span<const Glitter::Scene::GltfMeshlet> meshlets = primitive.m_meshlets;
+                if (primitive.m_streamedSlot != NO_STREAMED_LODS
+                    && m_meshStreamer.GetResidentLevels(primitive.m_streamedSlot).front().m_resolution
+                        != Glitter::Render::MESH_FULL_RESOLUTION) {
+                    meshlets = {};
+                }
+                primitiveInfos.push_back(GpuPrimitiveInfo {.m_count = static_cast<GLuint>(primitive.m_elementCount),
+                    .m_firstIndex = primitive.m_firstIndex,
+                    .m_baseVertex = primitive.m_baseVertex,
+                    .m_firstMeshlet = static_cast<GLuint>(meshletInfos.size()),
+                    .m_meshletCount = static_cast<GLuint>(meshlets.size()),
+                    .m_page = primitive.m_page,
+                    .m_padding = {}});
+                for (const Glitter::Scene::GltfMeshlet& meshlet : meshlets) {
+                    meshletInfos.push_back(GpuMeshletInfo {.m_center = meshlet.m_center,
+                        .m_radius = meshlet.m_radius,
+                        .m_coneAxis = meshlet.m_coneAxis,
+                        .m_coneCutoff = meshlet.m_coneCutoff,
+                        .m_count = meshlet.m_indexCount,
+                        .m_firstIndex = primitive.m_firstIndex + meshlet.m_firstIndex,
+                        .m_padding = {}});
+                }
+                commandCount += std::max<size_t>(meshlets.size(), 1);
+            }
+            m_maxPrimitivesPerMesh = std::max(m_maxPrimitivesPerMesh, mesh.m_primitives.size());
+            m_maxCommandsPerMesh = std::max(m_maxCommandsPerMesh, commandCount);
+        }
+
+        Glitter::Render::DeleteBuffers(1, &m_meshTableBuffer);
+        Glitter::Render::DeleteBuffers(1, &m_primitiveTableBuffer);
+        Glitter::Render::DeleteBuffers(1, &m_meshletTableBuffer);
+
+        std::array<GLuint, 3> tableBuffers {};
+        glCreateBuffers(tableBuffers.size(), tableBuffers.data());
+        Glitter::Render::NamedBufferStorage(Glitter::Render::GpuMemoryCategory::Buffer, tableBuffers[0],
+            static_cast<GLsizeiptr>(sizeof(GpuMeshInfo) * std::max<size_t>(meshInfos.size(), 1)),
+            meshInfos.empty() ? nullptr : meshInfos.data(), 0);
+        glObjectLabel(GL_BUFFER, tableBuffers[0], -1, "Mesh Table SSBO");
+        Glitter::Render::NamedBufferStorage(Glitter::Render::GpuMemoryCategory::Buffer, tableBuffers[1],
+            static_cast<GLsizeiptr>(sizeof(GpuPrimitiveInfo) * std::max<size_t>(primitiveInfos.size(), 1)),
+            primitiveInfos.empty() ? nullptr : primitiveInfos.data(), 0);
+        glObjectLabel(GL_BUFFER, tableBuffers[1], -1, "Primitive Table SSBO");
+        Glitter::Render::NamedBufferStorage(Glitter::Render::GpuMemoryCategory::Buffer, tableBuffers[2],
+            static_cast<GLsizeiptr>(sizeof(GpuMeshletInfo) * std::max<size_t>(meshletInfos.size(), 1)),
+            meshletInfos.empty() ? nullptr : meshletInfos.data(), 0);
+        glObjectLabel(GL_BUFFER, tableBuffers[2], -1, "Meshlet Table SSBO");
+        m_meshTableBuffer = tableBuffers[0];
+        m_primitiveTableBuffer = tableBuffers[1];
+        m_meshletTableBuffer = tableBuffers[2];
+    }
+
+    // (Re)creates the material table read by the Main program from m_materials, indexed by each Node's material ID.
+    void UploadMaterialTable()
+    {
+        GLuint materialTableBuffer = 0;
+        glCreateBuffers(1, &materialTableBuffer);
+        Glitter::Render::NamedBufferStorage(Glitter::Render::GpuMemoryCategory::Buffer, materialTableBuffer,
+            static_cast<GLsizeiptr>(sizeof(GpuMaterial) * m_materials.size()), m_materials.data(), 0);
+        glObjectLabel(GL_BUFFER, materialTableBuffer, -1, "Material Table SSBO");
+        Glitter::Render::DeleteBuffers(1, &m_materialTableBuffer);
+        m_materialTableBuffer = materialTableBuffer;
+    }
+
+    // Bakes the impostor of each Mesh from `firstMesh` on around its AABB's bounding sphere, while the atlas has room. The
+    // Meshes left without one are always drawn in full.
+    void BakeImpostors(size_t firstMesh)
+    {
+        if (m_impostorAtlas.GetLayerCount() == 0) {
+            return;
+        }
+
+        GLITTER_PROFILE_SCOPE("Bake Impostors");
+        m_renderStats.BindVertexArray(m_mainVAO);
+        BindPulledVertices();
+        size_t indexSize = m_geometryPool.GetIndexType() == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+        std::uint32_t firstLayer = m_impostorAtlas.GetBakedCount();
+        for (size_t meshID = firstMesh; meshID < m_meshes.Size(); meshID++) {
+            if (!m_meshes.IsLive(meshID)) {
+                continue;
+            }
+            Mesh& mesh = m_meshes[meshID];
+            glm::vec3 center = (mesh.m_aabb.m_localMin + mesh.m_aabb.m_localMax) * 0.5f;
+            float radius = glm::length(mesh.m_aabb.m_localMax - mesh.m_aabb.m_localMin) * 0.5f;
+            mesh.m_impostorLayer = m_impostorAtlas.Bake(
+                m_renderStats, m_impostorBakeProgram, mesh.m_dequantize, center, radius, [&] {
+                    for (const Primitive& primitive : mesh.m_primitives) {
+                        AttachGeometryPage(primitive.m_page);
+                        glDrawElementsBaseVertex(GL_TRIANGLES, primitive.m_elementCount, m_geometryPool.GetIndexType(),
+                            reinterpret_cast<const void*>(indexSize * primitive.m_firstIndex), primitive.m_baseVertex);
+                        m_renderStats.CountDraw(1, static_cast<size_t>(primitive.m_elementCount / 3));
+                    }
+                });
+            if (!mesh.m_impostorLayer) {
+                spdlog::warn("The impostor atlas is full, {} Meshes have no impostor.", m_meshes.Size() - meshID);
+                break;
+            }
+            mesh.m_impostorSphere = glm::vec4(center, radius);
+        }
+        glViewport(0, 0, m_windowWidth, m_windowHeight);
+
+        // The mips of the layers baked above, all at once by the frame loop's next Flush(), before any impostor is drawn.
+        std::uint32_t bakedLayers = m_impostorAtlas.GetBakedCount() - firstLayer;
+        if (bakedLayers > 0) {
+            m_mipGenerator.Queue(m_impostorAtlas.GetMipChain(firstLayer, bakedLayers));
+        }
+    }
+
+    // Turns off the features drawing the Nodes from commands the CPU doesn't build, which the null draws of
+    // BenchmarkIsolation::NullDraws couldn't empty.
+    void RestrictToNullDraws()
+    {
+        m_gpuCulling = false;
+        m_impostors = false;
+    }
+
+    // Turns off the features carrying state over from one frame to the next, which would mix up the scenes of the render
+    // server, whose every frame draws another one, see m_servedScenes. The Hi-Z pyramid is dropped along with the scene
+    // instead, and the caches over the Nodes are rebuilt from their revision.
+    void RestrictToServedScenes()
+    {
+        m_framePipelining = false;
+        m_temporalUpsampling = false;
+    }
+
+    // Turns off the features without a multiview program, which can't draw into the stereo FBO, see m_stereo.
+    void RestrictToStereo()
+    {
+        m_visibilityBuffer = false;
+        m_impostors = false;
+        m_occlusionQueries = false;
+        m_occlusionCulling = false;
+        m_weightedOit = false;
+        m_temporalUpsampling = false;
+        m_viewLayout = Glitter::Render::ViewLayout::Single;
+    }
+
+    // Turns off the features the inset views can't share the main pass' work with, which don't leave it sorted draw lists
+    // on the CPU or only draw a single view, see m_viewLayout.
+    void RestrictToInsetViews()
+    {
+        m_gpuCulling = false;
+        m_impostors = false;
+        m_staticBatching = false;
+        m_weightedOit = false;
+        m_temporalUpsampling = false;
+    }
+
+    // Turns off the features drawing the opaque Nodes without the Main program's vertex shader, whose pixels would hold no
+    // Node ID, or the ID of a whole static batch, see m_gpuPicking.
+    void RestrictToGpuPicking()
+    {
+        m_visibilityBuffer = false;
+        m_impostors = false;
+        m_staticBatching = false;
+    }
+
+    // Turns off the features drawing the Nodes without the Main program, or from draw lists the CPU doesn't write the draw
+    // info of, in the visualizations of m_debugView. The triangle density falls back to the shading without barycentrics.
+    void RestrictToDebugView()
+    {
+        if (m_debugView == DebugView::TriangleDensity && !Glitter::Render::GetGLExtensions().m_fragmentShaderBarycentric) {
+            m_debugView = DebugView::Shaded;
+            return;
+        }
+        m_visibilityBuffer = false;
+        m_impostors = false;
+        m_weightedOit = false;
+        if (HasDrawInfo(m_debugView)) {
+            m_gpuCulling = false;
+        }
+    }
+
+    // Clears the main pass' FBO within the scissor, its Node IDs to 0 when picking on the GPU. glClear() leaves integer
+    // attachments undefined, so they're left out of the draw buffers for it and cleared on their own.
+    void ClearMainFramebuffer()
+    {
+        if (!m_gpuPicking) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            return;
+        }
+        glNamedFramebufferDrawBuffer(m_fbo, GL_COLOR_ATTACHMENT0);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        std::array drawBuffers = std::to_array<GLenum>({GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1});
+        glNamedFramebufferDrawBuffers(m_fbo, drawBuffers.size(), drawBuffers.data());
+        std::array<GLuint, 4> noNode {};
+        glClearBufferuiv(GL_COLOR, 1, noNode.data());
+    }
+
+    // The format of the main pass' HDR color target, see m_packedHdrColor.
+    GLenum GetColorFormat() const { return m_packedHdrColor ? GL_R11F_G11F_B10F : GL_RGBA16F; }
+
+    // (Re)creates the FBO's color and depth attachments, the Hi-Z pyramid built from the depth and the post-processing
+    // targets at `width` by `height`, a bucket size that the main pass renders a viewport of. The old targets go back to
+    // m_renderTargets.
+    void CreateFramebufferAttachments(GLsizei width, GLsizei height)
+    {
+        Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::FBO_RESIZE);
+
+        Glitter::Render::RenderTarget oldColor = m_fboColor;
+        Glitter::Render::RenderTarget oldDepth = m_fboDepth;
+        Glitter::Render::RenderTarget oldNodeIds = m_fboNodeIds;
+
+        // The color target used with the FBO, in HDR until the post-processing tonemaps it.
+        m_fboColor = m_renderTargets.Acquire(GetColorFormat(), width, height, 1, "Post-Processing FBO Color Texture");
+
+        // The depth target used with the FBO, sampled when building the Hi-Z pyramid.
+        m_fboDepth = m_renderTargets.Acquire(GL_DEPTH_COMPONENT32F, width, height, 1, "Post-Processing FBO Depth Texture");
+        glTextureParameteri(m_fboDepth.m_texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTextureParameteri(m_fboDepth.m_texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        // The Node drawn over each pixel, only read back a pixel at a time, see m_gpuPicking.
+        if (m_gpuPicking) {
+            m_fboNodeIds = m_renderTargets.Acquire(GL_R32UI, width, height, 1, "Post-Processing FBO Node ID Texture");
+        }
+
+        // Attach the textures to the FBO, or a layer per eye of the stereo targets instead.
+        if (m_stereo) {
+            m_stereoTargets.Create(m_fbo, GetColorFormat(), width, height);
+        } else {
+            glNamedFramebufferTexture(m_fbo, GL_COLOR_ATTACHMENT0, m_fboColor.m_texture, 0);
+            glNamedFramebufferTexture(m_fbo, GL_DEPTH_ATTACHMENT, m_fboDepth.m_texture, 0);
+            if (m_gpuPicking) {
+                glNamedFramebufferTexture(m_fbo, GL_COLOR_ATTACHMENT1, m_fboNodeIds.m_texture, 0);
+            }
+        }
+        glNamedFramebufferTexture(m_oitFbo, GL_DEPTH_ATTACHMENT, m_fboDepth.m_texture, 0);
+        glNamedFramebufferTexture(m_visibilityFbo, GL_DEPTH_ATTACHMENT, m_fboDepth.m_texture, 0);
+
+        // Release the old FBO attachments, once they're detached.
+        m_renderTargets.Release(oldColor);
+        m_renderTargets.Release(oldDepth);
+        m_renderTargets.Release(oldNodeIds);
+
+        // The old pyramid doesn't match the new depth anymore.
+        m_hiZ.Create(m_renderTargets, width, height);
+        m_hiZValid = false;
+
+        m_postProcessor.Create(width, height);
+        m_temporalUpsampler.Create(m_renderTargets, width, height);
+        m_shadingRateImage.Create(width, height);
+    }
+
+    // Uploads the RGBA8 or pre-compressed levels of `decoded` into `target` of `texture`, and `layer` of it for arrays.
+    void UploadTextureLevels(GLuint texture, GLenum target, GLint layer, const Glitter::Render::DecodedTexture& decoded)
+    {
+        for (size_t level = 0; level < Glitter::Render::GetLevelCount(decoded); level++) {
+            glm::ivec2 size = Glitter::Render::GetLevelSize(decoded, level);
+            Glitter::Render::TextureUploadTarget upload {
+                .m_texture = texture,
+                .m_target = target,
+                .m_level = static_cast<GLint>(level),
+                .m_layer = layer,
+                .m_width = size.x,
+                .m_height = size.y,
+                .m_format = decoded.m_compressed ? decoded.m_compressed->m_format : GLenum {GL_RGBA},
+            };
+            m_textureUploader.Upload(upload, Glitter::Render::GetLevelData(decoded, level));
+        }
+    }
+
+    // Creates the texture of `slot` with a full mip chain. With Config::ENABLE_TEXTURE_STREAMING, textures decoded with
+    // their mips are handed to m_textureStreamer instead of being uploaded whole.
+    GLuint CreateTexture2D(const char* path, Glitter::Render::DecodedTexture&& decoded, size_t slot)
+    {
+        Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::TEXTURE_LOAD);
+
+        GLuint texture {};
+        glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+        glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glObjectLabel(GL_TEXTURE, texture, -1, std::format("Texture <{}>", path).c_str());
+
+        m_textureStreamer.AddResidentTexture(slot);
+        size_t levelCount = Glitter::Render::GetLevelCount(decoded);
+        if (levelCount == 0) {
+            return texture;
+        }
+
+        GLenum internalFormat = Glitter::Render::GetInternalFormat(decoded);
+        glm::ivec2 size = Glitter::Render::GetLevelSize(decoded, 0);
+        if (Glitter::Config::ENABLE_TEXTURE_STREAMING && levelCount > 1) {
+            std::optional<GLsizei> sparseLevels = Glitter::Render::AllocateStreamedTexture2D(
+                texture, internalFormat, static_cast<GLsizei>(levelCount), size.x, size.y);
+            m_textureStreamer.AddTexture(slot, {.m_texture = texture, .m_target = GL_TEXTURE_2D, .m_layer = 0},
+                std::move(decoded), sparseLevels, m_textureUploader);
+            return texture;
+        }
+
+        // Otherwise upload every level, and generate the mips of images decoded without them. Pre-compressed mips are
+        // uploaded as-is.
+        GLsizei storageLevels = static_cast<GLsizei>(std::floor(std::log2(std::max(size.x, size.y)))) + 1;
+        if (decoded.m_compressed) {
+            storageLevels = static_cast<GLsizei>(levelCount);
+        }
+        Glitter::Render::TextureStorage2D(
+            Glitter::Render::GpuMemoryCategory::Texture, texture, storageLevels, internalFormat, size.x, size.y);
+        UploadTextureLevels(texture, GL_TEXTURE_2D, 0, decoded);
+        if (static_cast<GLsizei>(levelCount) < storageLevels) {
+            m_mipGenerator.Queue({
+                .m_texture = texture,
+                .m_target = GL_TEXTURE_2D,
+                .m_format = Glitter::Render::MipFormat::Rgba8,
+                .m_filter = Glitter::Render::MipFilter::Srgb,
+                .m_width = size.x,
+                .m_height = size.y,
+                .m_levels = storageLevels,
+                .m_firstLayer = 0,
+                .m_layerCount = 1,
+            });
+        }
+
+        return texture;
+    }
+
+    // Uploads every texture into a layer of a single GL_TEXTURE_2D_ARRAY with a full mip chain. Layers share the resolution
+    // of the largest texture, and smaller ones are upscaled into their layer with a filtered blit. Their mips are then
+    // generated on the GPU, while layers of the right size use their decoded mips if they have them, and are streamed with
+    // Config::ENABLE_TEXTURE_STREAMING.
+    GLuint CreateTextureArray(std::span<Glitter::Render::DecodedTexture> textures)
+    {
+        Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::TEXTURE_LOAD);
+
+        GLsizei layerWidth = 1, layerHeight = 1;
+        for (const Glitter::Render::DecodedTexture& texture : textures) {
+            if (!texture.m_levels.empty()) {
+                layerWidth = std::max(layerWidth, texture.m_levels[0].m_width);
+                layerHeight = std::max(layerHeight, texture.m_levels[0].m_height);
+            }
+        }
+
+        auto levels = static_cast<GLsizei>(std::floor(std::log2(std::max(layerWidth, layerHeight)))) + 1;
+
+        GLuint textureArray {};
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &textureArray);
+        glTextureParameteri(textureArray, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTextureParameteri(textureArray, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTextureParameteri(textureArray, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTextureParameteri(textureArray, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        Glitter::Render::TextureStorage3D(Glitter::Render::GpuMemoryCategory::Texture, textureArray, levels, GL_RGBA8,
+            layerWidth, layerHeight, static_cast<GLsizei>(textures.size()));
+        glObjectLabel(GL_TEXTURE, textureArray, -1, "Node Texture Array");
+
+        // Framebuffers used to resize the textures that don't match the layer resolution.
+        std::array<GLuint, 2> blitFbos {};
+        glCreateFramebuffers(2, blitFbos.data());
+
+        // The layers whose mips are generated, left out of the streamed layers' chains, whose mips come in later.
+        std::vector<bool> generateMips(textures.size(), false);
+        std::vector<size_t> streamedLayers {};
+        for (size_t layer = 0; layer < textures.size(); layer++) {
+            m_textureStreamer.AddResidentTexture(layer);
+            const std::vector<Glitter::Render::ImageLevel>& images = textures[layer].m_levels;
+            if (images.empty()) {
+                continue;
+            }
+
+            const Glitter::Render::ImageLevel& image = images[0];
+            if (image.m_width == layerWidth && image.m_height == layerHeight) {
+                if (Glitter::Config::ENABLE_TEXTURE_STREAMING && images.size() == static_cast<size_t>(levels)) {
+                    streamedLayers.push_back(layer);
+                    continue;
+                }
+                UploadTextureLevels(textureArray, GL_TEXTURE_2D_ARRAY, static_cast<GLint>(layer), textures[layer]);
+                generateMips[layer] = images.size() < static_cast<size_t>(levels);
+            } else {
+                GLuint staging {};
+                glCreateTextures(GL_TEXTURE_2D, 1, &staging);
+                Glitter::Render::TextureStorage2D(
+                    Glitter::Render::GpuMemoryCategory::Texture, staging, 1, GL_RGBA8, image.m_width, image.m_height);
+                Glitter::Render::TextureUploadTarget upload {
+                    .m_texture = staging,
+                    .m_target = GL_TEXTURE_2D,
+                    .m_level = 0,
+                    .m_layer = 0,
+                    .m_width = image.m_width,
+                    .m_height = image.m_height,
+                    .m_format = GL_RGBA,
+                };
+                m_textureUploader.Upload(upload, std::as_bytes(std::span(image.m_rgba)));
+
+                glNamedFramebufferTexture(blitFbos[0], GL_COLOR_ATTACHMENT0, staging, 0);
+                glNamedFramebufferTextureLayer(blitFbos[1], GL_COLOR_ATTACHMENT0, textureArray, 0, static_cast<GLint>(layer));
+                glBlitNamedFramebuffer(blitFbos[0], blitFbos[1], 0, 0, image.m_width, image.m_height, 0, 0, layerWidth,
+                    layerHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+                Glitter::Render::DeleteTextures(1, &staging);
+                generateMips[layer] = true;
+            }
+        }
+
+        glDeleteFramebuffers(2, blitFbos.data());
+        for (size_t firstLayer = 0; firstLayer < textures.size();) {
+            if (!generateMips[firstLayer]) {
+                firstLayer++;
+                continue;
+            }
+            size_t lastLayer = firstLayer;
+            while (lastLayer + 1 < textures.size() && generateMips[lastLayer + 1]) {
+                lastLayer++;
+            }
+            m_mipGenerator.Queue({
+                .m_texture = textureArray,
+                .m_target = GL_TEXTURE_2D_ARRAY,
+                .m_format = Glitter::Render::MipFormat::Rgba8,
+                .m_filter = Glitter::Render::MipFilter::Srgb,
+                .m_width = layerWidth,
+                .m_height = layerHeight,
+                .m_levels = levels,
+                .m_firstLayer = static_cast<GLint>(firstLayer),
+                .m_layerCount = static_cast<GLsizei>(lastLayer - firstLayer + 1),
+            });
+            firstLayer = lastLayer + 1;
+        }
+
+        // Stream the rest, whose levels the generated mips leave alone.
+        for (size_t layer : streamedLayers) {
+            m_textureStreamer.AddTexture(layer,
+                {.m_texture = textureArray, .m_target = GL_TEXTURE_2D_ARRAY, .m_layer = static_cast<GLint>(layer)},
+                std::move(textures[layer]), std::nullopt, m_textureUploader);
+        }
+
+        return textureArray;
+    }
+
+    // Returns 0 unless every texture was pre-compressed, with the same format, size and mips, since they can't be blitted
+    // into a layer like CreateTextureArray() does.
+    GLuint CreateCompressedTextureArray(std::span<const char* const> paths, std::span<Glitter::Render::DecodedTexture> textures)
+    {
+        if (textures.empty() || !textures[0].m_compressed) {
+            return 0;
+        }
+
+        const Glitter::Render::CompressedTexture& first = *textures[0].m_compressed;
+        for (size_t layer = 0; layer < textures.size(); layer++) {
+            const std::optional<Glitter::Render::CompressedTexture>& texture = textures[layer].m_compressed;
+            if (!texture || texture->m_format != first.m_format || texture->m_levels.size() != first.m_levels.size()
+                || texture->m_levels[0].m_width != first.m_levels[0].m_width
+                || texture->m_levels[0].m_height != first.m_levels[0].m_height) {
+                spdlog::info(
+                    "Texture <{}> doesn't match the other compressed layers, decoding every texture instead.", paths[layer]);
+                return 0;
+            }
+        }
+
+        Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::TEXTURE_LOAD);
+
+        GLuint textureArray {};
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &textureArray);
+        glTextureParameteri(textureArray, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTextureParameteri(textureArray, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTextureParameteri(textureArray, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTextureParameteri(textureArray, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        Glitter::Render::TextureStorage3D(Glitter::Render::GpuMemoryCategory::Texture, textureArray,
+            static_cast<GLsizei>(first.m_levels.size()), first.m_format, first.m_levels[0].m_width,
+            first.m_levels[0].m_height, static_cast<GLsizei>(textures.size()));
+        glObjectLabel(GL_TEXTURE, textureArray, -1, "Node Texture Array");
+
+        for (size_t layer = 0; layer < textures.size(); layer++) {
+            if (Glitter::Config::ENABLE_TEXTURE_STREAMING && first.m_levels.size() > 1) {
+                m_textureStreamer.AddTexture(layer,
+                    {.m_texture = textureArray, .m_target = GL_TEXTURE_2D_ARRAY, .m_layer = static_cast<GLint>(layer)},
+                    std::move(textures[layer]), std::nullopt, m_textureUploader);
+            } else {
+                m_textureStreamer.AddResidentTexture(layer);
+                UploadTextureLevels(textureArray, GL_TEXTURE_2D_ARRAY, static_cast<GLint>(layer), textures[layer]);
+            }
+        }
+
+        return textureArray;
+    }
+
+    // Applies a key event, recorded along with the camera while it's recorded. Quitting, captures and hiding the overlays
+    // are never recorded.
+    void HandleKey(int key, int action)
+    {
+        if (m_cameraRecording && key != GLFW_KEY_ESCAPE && key != GLFW_KEY_F11 && key != GLFW_KEY_F10 && key != GLFW_KEY_F1) {
+            m_cameraRecording->m_events.push_back(Glitter::Core::CameraEvent {
+                .m_frame = static_cast<std::uint32_t>(m_cameraRecording->m_frames.size()), .m_key = key, .m_action = action});
+        }
+
+        switch (key) {
+        case GLFW_KEY_SPACE:
+            if (action == GLFW_RELEASE) {
+                SpawnNodes(Glitter::Config::NODES_PER_SPAWN);
+            }
+            break;
+        case GLFW_KEY_K:
+            if (action == GLFW_RELEASE) {
+                m_frustumCulling = !m_frustumCulling;
+            }
+            break;
+        case GLFW_KEY_F11:
+            if (action == GLFW_RELEASE) {
+                m_renderDoc.TriggerCapture("requested");
+            }
+            break;
+        case GLFW_KEY_F10:
+            if (action == GLFW_RELEASE) {
+                m_glTrace.TriggerCapture();
+            }
+            break;
+        case GLFW_KEY_F1:
+            if (action == GLFW_RELEASE) {
+                m_showOverlays = !m_showOverlays;
+            }
+            break;
+        case GLFW_KEY_ESCAPE:
+            glfwSetWindowShouldClose(m_window, true);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Blocks while the Window is iconified, hidden or 0x0, and in on-demand mode, once the scene was left untouched for
+    // Config::ON_DEMAND_SETTLE_FRAMES frames, until the next event or Config::ON_DEMAND_IDLE_TIMEOUT. The time spent
+    // waiting isn't counted as a frame.
+    void WaitForFrame()
+    {
+        if (m_benchmark.m_enabled || m_benchmark.m_headless) {
+            return;
+        }
+
+        bool suspended = false;
+        while (IsSuspended() && !glfwWindowShouldClose(m_window)) {
+            glfwWaitEvents();
+            suspended = true;
+        }
+        if (suspended) {
+            // The simulation picks up where it was suspended.
+            m_lastFrameTime = glfwGetTime();
+            m_frameStats.Pause();
+        }
+
+        if (!m_renderOnDemand || suspended || Glitter::Core::PeekFrameActivity() != 0) {
+            m_idleFrames = 0;
+        } else if (++m_idleFrames > Glitter::Config::ON_DEMAND_SETTLE_FRAMES) {
+            double start = glfwGetTime();
+            glfwWaitEventsTimeout(Glitter::Config::ON_DEMAND_IDLE_TIMEOUT);
+            // Returning before the timeout means an event woke the loop up, which may change the scene.
+            if (glfwGetTime() - start < Glitter::Config::ON_DEMAND_IDLE_TIMEOUT) {
+                m_idleFrames = 0;
+            }
+            m_frameStats.Pause();
+        }
+    }
+
+    // GLFW doesn't report whether the Window is occluded, only whether it's iconified or hidden, or 0x0.
+    bool IsSuspended() const
+    {
+        int width = 0;
+        int height = 0;
+        glfwGetFramebufferSize(m_window, &width, &height);
+        return width == 0 || height == 0 || glfwGetWindowAttrib(m_window, GLFW_ICONIFIED) == GLFW_TRUE
+            || glfwGetWindowAttrib(m_window, GLFW_VISIBLE) == GLFW_FALSE;
+    }
+
+    void Tick()
+    {
+        // Gather the CPU scopes and time of the previous frame before recording this one.
+        m_cpuProfiler.CollectFrame();
+        bool stutter = m_frameStats.BeginFrame();
+        GLITTER_PROFILE_SCOPE("Tick");
+
+        // Capture the frame after a stutter, which likely pays for the same work, e.g. what a stream or a shader compile
+        // left behind, and log the captures the previous frames wrote.
+        if (stutter && m_captureStutters && m_stutterCaptures < Glitter::Config::RENDERDOC_MAX_STUTTER_CAPTURES
+            && m_renderDoc.IsConnected()) {
+            const auto& latest = m_frameStats.GetStutters().back();
+            m_renderDoc.TriggerCapture(std::format("frame {} took {:.2f} ms ({:.1f}x median), {}", latest.m_frame,
+                latest.m_milliseconds, latest.m_milliseconds / latest.m_median,
+                Glitter::Core::DescribeFrameActivity(latest.m_activities)));
+            m_stutterCaptures++;
+        }
+        m_renderDoc.LogCaptures();
+
+        // The trace starts before the frame waits, with the objects and state the previous frame left.
+        m_glTrace.BeginFrame(m_windowWidth, m_windowHeight);
+
+        // Pace the frame before sampling its input, so that the input is as recent as possible once it's drawn.
+        m_framePacer.BeginFrame(m_framePacing);
+        m_inputTime = glfwGetTime();
+        glfwPollEvents();
+
+        // Start Dear ImGui frame, at Config::DEBUG_UI_UPDATE_RATE unless the mouse or the keyboard is on the windows, or the
+        // windows were just shown or resized. The ones built last are drawn again in between.
+        m_updateUi = false;
+        if (!m_benchmark.m_headless && m_showOverlays) {
+            const ImGuiIO& io = ImGui::GetIO();
+            const ImDrawData* drawData = ImGui::GetDrawData();
+            int width = 0;
+            int height = 0;
+            glfwGetWindowSize(m_window, &width, &height);
+            double time = glfwGetTime();
+            m_updateUi = drawData == nullptr || drawData->DisplaySize.x != static_cast<float>(width)
+                || drawData->DisplaySize.y != static_cast<float>(height) || io.WantCaptureMouse || io.WantCaptureKeyboard
+                || time - m_uiUpdateTime >= 1.0 / Glitter::Config::DEBUG_UI_UPDATE_RATE;
+            if (m_updateUi) {
+                m_uiUpdateTime = time;
+                ImGui_ImplOpenGL3_NewFrame();
+                ImGui_ImplGlfw_NewFrame();
+                ImGui::NewFrame();
+            }
+        } else if (!m_benchmark.m_headless) {
+            // The input meant for the windows while they're hidden isn't handed to them once they're shown.
+            ImGui::GetIO().ClearEventsQueue();
+        }
+    }
+
+    // The state advanced by Simulate().
+    struct SimulationState {
+        // Seconds since startup, or since the benchmark started.
+        double m_time;
+        glm::vec3 m_eyePos;
+        glm::vec3 m_eyeTarget;
+        std::vector<Glitter::Render::PointLight> m_pointLights;
+    };
+
+    // Advances the simulation by as many fixed steps as fit in the time since the previous frame, the benchmark's step
+    // being fixed too. There are at most Config::MAX_SIMULATION_STEPS per frame, after a stall the simulation drops the
+    // time it can't catch up on rather than spending the next frames on it. A played back frame advances by its recorded
+    // time instead, and is drawn from its recorded view, as is a served scene's frame.
+    void Simulate()
+    {
+        GLITTER_PROFILE_SCOPE("Simulate");
+        double now = glfwGetTime();
+        double frameTime = m_benchmark.m_enabled ? Glitter::Config::BENCHMARK_TIME_STEP : now - m_lastFrameTime;
+        m_lastFrameTime = now;
+        // The clock is held while rendering on demand, so that the camera and lights only move when asked to.
+        if (m_renderOnDemand && !m_benchmark.m_enabled) {
+            frameTime = 0.0;
+        }
+        std::optional<Glitter::Core::CameraFrame> playedFrame
+            = m_activeServedScene ? std::optional(GetServedCamera()) : AdvanceCameraPlayback();
+        if (playedFrame) {
+            frameTime = playedFrame->m_frameTime;
+        }
+
+        constexpr double STEP = Glitter::Config::SIMULATION_TIME_STEP;
+        m_simulationAccumulator = std::min(
+            m_simulationAccumulator + frameTime, STEP * static_cast<double>(Glitter::Config::MAX_SIMULATION_STEPS));
+        m_simulationSteps = 0;
+        while (m_simulationAccumulator >= STEP) {
+            // Keep the previous step to interpolate from, reusing its allocations for the next one.
+            std::swap(m_previousState, m_currentState);
+            m_currentState.m_time = m_previousState.m_time + STEP;
+            EvaluateSimulation(m_currentState);
+            m_simulationAccumulator -= STEP;
+            m_simulationSteps++;
+        }
+
+        // The view is interpolated between the last two steps, by how far this frame is past the latest.
+        auto alpha = static_cast<float>(m_simulationAccumulator / STEP);
+        m_frameCamera = playedFrame.value_or(Glitter::Core::CameraFrame {.m_frameTime = frameTime,
+            .m_eyePos = glm::mix(m_previousState.m_eyePos, m_currentState.m_eyePos, alpha),
+            .m_eyeTarget = glm::mix(m_previousState.m_eyeTarget, m_currentState.m_eyeTarget, alpha)});
+        if (m_cameraRecording) {
+            m_cameraRecording->m_frames.push_back(m_frameCamera);
+        }
+    }
+
+    // Starts the simulation over from `time`, without a step to interpolate from.
+    void RestartSimulation(double time)
+    {
+        m_simulationAccumulator = 0.0;
+        m_currentState.m_time = time;
+        EvaluateSimulation(m_currentState);
+        m_previousState = m_currentState;
+    }
+
+    // Records the camera and the key events of every frame from now on, see StopCameraRecording(). The simulation and the
+    // RNG are restarted so that the playback can start from the same state.
+    void StartCameraRecording()
+    {
+        auto seed = static_cast<std::uint32_t>(std::rand());
+        std::srand(seed);
+        RestartSimulation(m_currentState.m_time);
+        m_cameraRecording = Glitter::Core::CameraRecording {
+            .m_startTime = m_currentState.m_time, .m_seed = seed, .m_frames = {}, .m_events = {}};
+    }
+
+    void StopCameraRecording()
+    {
+        const char* path = Glitter::Config::CAMERA_RECORDING_PATH;
+        if (Glitter::Core::WriteCameraRecording(path, *m_cameraRecording)) {
+            spdlog::info("Recorded {} camera frames into {}.", m_cameraRecording->m_frames.size(), path);
+        } else {
+            spdlog::error("Failed to write the camera recording {}.", path);
+        }
+        m_cameraRecording.reset();
+    }
+
+    // Plays `recording` back from its first frame on, from the simulation time and RNG seed it was recorded from.
+    void StartCameraPlayback(Glitter::Core::CameraRecording recording)
+    {
+        RestartSimulation(recording.m_startTime);
+        std::srand(recording.m_seed);
+        spdlog::info("Playing back {} camera frames.", recording.m_frames.size());
+        m_cameraPlayback = std::move(recording);
+        m_playbackFrame = 0;
+    }
+
+    // Replays the key events sampled before the next frame of the playback, and returns that frame. Returns std::nullopt
+    // once every frame was played back, or if nothing is.
+    std::optional<Glitter::Core::CameraFrame> AdvanceCameraPlayback()
+    {
+        if (!m_cameraPlayback) {
+            return std::nullopt;
+        }
+        if (m_playbackFrame == m_cameraPlayback->m_frames.size()) {
+            spdlog::info("Finished playing back the camera recording.");
+            m_cameraPlayback.reset();
+            return std::nullopt;
+        }
+
+        for (const Glitter::Core::CameraEvent& event : m_cameraPlayback->GetEvents(m_playbackFrame)) {
+            HandleKey(event.m_key, event.m_action);
+        }
+        return m_cameraPlayback->m_frames[m_playbackFrame++];
+    }
+
+    // The camera's eye position and target at `time`.
+    std::pair<glm::vec3, glm::vec3> EvaluateCamera(float time) const
+    {
+        // The camera's path is carried along a circle around the streamed world while it's streamed.
+        glm::vec3 flight {0.0f};
+        if (m_worldStreaming) {
+            float angle = time * Glitter::Config::WORLD_FLIGHT_SPEED / Glitter::Config::WORLD_FLIGHT_RADIUS;
+            flight = Glitter::Config::WORLD_FLIGHT_RADIUS * glm::vec3(std::cos(angle), 0.0f, std::sin(angle));
+        }
+        return {glm::vec3(std::sin(time), 2.5f, -3.5f) + flight, flight};
+    }
+
+    // The camera's path and the point lights' orbits at `state.m_time`.
+    void EvaluateSimulation(SimulationState& state) const
+    {
+        auto time = static_cast<float>(state.m_time);
+        std::tie(state.m_eyePos, state.m_eyeTarget) = EvaluateCamera(time);
+
+        // Orbit the point lights around the scene's vertical axis, each at its own pace.
+        state.m_pointLights.clear();
+        m_entities.ForEach<Glitter::Render::PointLight, LightOrbit>(
+            [&](const Glitter::Render::PointLight& origin, const LightOrbit& orbit) {
+                if (state.m_pointLights.size() == static_cast<size_t>(m_pointLightCount)) {
+                    return;
+                }
+                glm::vec3 position = glm::angleAxis(time * orbit.m_speed, glm::vec3(0.0f, 1.0f, 0.0f))
+                    * glm::vec3(origin.m_positionRadius);
+                state.m_pointLights.push_back({
+                    .m_positionRadius = glm::vec4(position, origin.m_positionRadius.w),
+                    .m_color = origin.m_color,
+                });
+            });
+    }
+
+    // Submits the packet updated during the previous frame, while m_updateThread updates the next one from this frame's
+    // simulation steps. Without m_framePipelining, or when the Nodes were added or cleared since the packet's update, the
+    // packet is updated first, and submitted within the same frame.
+    void Render()
+    {
+        GLITTER_PROFILE_SCOPE("Render");
+        m_frameArena.Reset();
+        m_gpuProfiler.BeginFrame();
+        m_batchCostSampler.BeginFrame();
+        m_gpuCullStatistics.Poll();
+        m_renderStats.BeginFrame();
+        m_depthPrepass.BeginFrame();
+        m_submitFlusher.BeginFrame(m_earlyFlush);
+
+        StreamLoadedMeshes(Glitter::Config::MESH_UPLOAD_BUDGET);
+        StreamWorld();
+        AddSnapshotNodes();
+        if (m_shaderHotReload) {
+            ReloadShaders();
+        }
+        CreateDebugDraw();
+        FinishLinkedPrograms();
+        m_mipGenerator.Flush(m_renderStats, m_mipPrograms);
+        UpdateRenderTargets();
+        // Hold the loading and streaming jobs back while the frames are behind.
+        m_jobSystem.SetBackgroundThrottled(GetCpuFrameMilliseconds() > Glitter::Config::JOB_THROTTLE_FRAME_MS);
+        // The buffers, programs and targets recreated above may have reused the names of the deleted ones.
+        m_renderStats.InvalidateState();
+
+        // Pick the Node read back from under the latest click, while no update reads the picked Node.
+        if (m_gpuPicking) {
+            ApplyNodePick();
+        }
+
+        // Add Debug UI, showing the stats of the packet about to be submitted.
+        FramePacket& packet = m_framePackets[m_framePacketIdx];
+        if (m_updateUi) {
+            GLITTER_PROFILE_SCOPE("ImGui Build");
+            BuildDebugUi(packet);
+        }
+        // Drained even while the log isn't built, so that the queue has room for the next frame's messages.
+        m_logForwarder.Drain();
+
+        // The draw lists of a packet index the Nodes of its update.
+        if (!m_framePipelining || !packet.m_valid || packet.m_sceneRevision != m_nodes.GetRevision()) {
+            UpdateFrame(packet);
+        }
+        StreamMeshLods(packet);
+
+        // Upload the Node data that changed along with the packet into the persistent Node data buffers, and merge the
+        // debug lines added since the previous frame, before the next packet's update changes or adds any.
+        UploadNodeData();
+        SimulateSwarm();
+        SkinMeshes(packet);
+        BuildStaticBatches(packet);
+        m_debugDraw.Submit(m_renderStats);
+
+        FramePacket& nextPacket = m_framePackets[m_framePacketIdx ^ 1];
+        if (m_framePipelining) {
+            m_updateThread.Kick([this, &nextPacket] { UpdateFrame(nextPacket); });
+        }
+        // The GPU skins, batches and uploads while the draw batches are built.
+        m_submitFlusher.Flush();
+        SubmitFrame(packet);
+        packet.m_valid = false;
+        if (m_framePipelining) {
+            GLITTER_PROFILE_SCOPE("Wait for Update");
+            m_updateThread.Wait();
+            m_framePacketIdx ^= 1;
+        }
+    }
+
+    // Picks the Node of the latest Node ID m_nodePicker read back, or unpicks it where no Node was drawn. The IDs are Node
+    // slots, which only index the same Nodes until some are added or removed, so a pick from an older revision is dropped.
+    void ApplyNodePick()
+    {
+        std::optional<Glitter::Render::NodePick> pick = m_nodePicker.Poll();
+        if (!pick || pick->m_revision != m_nodes.GetRevision()) {
+            return;
+        }
+        if (pick->m_nodeId == 0 || pick->m_nodeId > m_nodes.Size()) {
+            m_pickedNode.reset();
+        } else {
+            m_pickedNode = m_nodes.GetHandle(pick->m_nodeId - 1);
+        }
+    }
+
+    // See Glitter::Render::GenerateShaderDataGlsl().
+    using CommonData = Glitter::Render::CommonData;
+    using PerDrawData = Glitter::Render::PerDrawData;
+    static constexpr GLuint NODE_DATA_TEXTURE_BITS = 16;
+    static constexpr GLuint NODE_DATA_MATERIAL_BITS = 15;
+    static constexpr GLuint NODE_DATA_ANIMATE = 1u << 31;
+    static constexpr size_t MAX_NODE_MATERIALS = size_t {1} << NODE_DATA_MATERIAL_BITS;
+    struct ShaderData {
+        CommonData m_commonData;
+        PerDrawData m_perDrawData;
+    };
+
+    // Match the std430 layouts of the buffers read by the culling compute shader.
+    struct alignas(16) GpuNodeBounds {
+        glm::vec3 m_center;
+        GLuint m_meshID;
+        glm::vec3 m_extent;
+        GLuint m_padding;
+    };
+    struct GpuMeshInfo {
+        GLuint m_firstPrimitive;
+        GLuint m_primitiveCount;
+        std::array<GLuint, 2> m_padding;
+        glm::mat4 m_quantize;
+    };
+    struct GpuPrimitiveInfo {
+        GLuint m_count;
+        GLuint m_firstIndex;
+        GLint m_baseVertex;
+        GLuint m_firstMeshlet;
+        GLuint m_meshletCount;
+        GLuint m_page;
+        std::array<GLuint, 2> m_padding;
+    };
+    struct GpuMeshletInfo {
+        glm::vec3 m_center;
+        float m_radius;
+        glm::vec3 m_coneAxis;
+        float m_coneCutoff;
+        GLuint m_count;
+        GLuint m_firstIndex;
+        std::array<GLuint, 2> m_padding;
+    };
+
+    // Matches the std430 layout of `b_Materials` in MainFS.glsl.
+    struct GpuMaterial {
+        glm::vec4 m_baseColor;
+        float m_specularStrength;
+        float m_specularExponent;
+        std::array<float, 2> m_padding;
+    };
+
+    // A visible Node in one of the per-pass draw lists, ordered by its Glitter::Render::DrawKey.
+    struct DrawListEntry {
+        std::uint64_t m_sortKey;
+        std::uint32_t m_node;
+
+        // 0 draws the full Primitives, level `l` their LODs of Config::MESH_LOD_RESOLUTION >> (l - 1) or finer.
+        std::uint32_t m_lod;
+    };
+
+    // A run of draws sharing the same program, texture binding, geometry pool page and Node data page, submitted with a
+    // single glMultiDrawElementsIndirect. Each draw fetches its PerDrawData from the per-draw SSBO through gl_BaseInstance.
+    struct DrawBatch {
+        // Index of m_mainPrograms.
+        std::uint32_t m_program;
+        GLuint m_texture;
+        std::uint32_t m_page;
+        // See BindNodePage().
+        std::uint32_t m_nodePage;
+
+        size_t m_firstCommand;
+        GLsizei m_drawCount;
+    };
+
+    // The impostors of one Mesh on one Node data page, drawn instanced from the per-draw slots starting at m_firstDraw.
+    struct ImpostorBatch {
+        std::uint32_t m_meshID;
+        std::uint32_t m_nodePage;
+        GLuint m_firstDraw;
+        GLsizei m_instanceCount;
+    };
+
+    // The draw batches and indirect commands recorded for a range of a draw list, their m_firstCommand relative to
+    // m_commands.
+    struct DrawRecording {
+        std::vector<DrawBatch> m_batches;
+        std::vector<DrawElementsIndirectCommand> m_commands;
+        // The Mesh ID of each command, only while the batch cost sampler is enabled.
+        std::vector<std::uint32_t> m_meshIDs;
+    };
+
+    // A texture level requested by a drawn Node, see Glitter::Render::TextureStreamer::Request().
+    struct TextureRequest {
+        std::uint32_t m_slot;
+        float m_pixels;
+    };
+
+    // A LOD level of a Mesh requested by a drawn Node, see Glitter::Render::MeshStreamer::Request().
+    struct MeshRequest {
+        std::uint32_t m_mesh;
+        std::uint32_t m_lod;
+    };
+
+    // A view drawn over its rectangle of the main view's image, see Glitter::Render::ViewLayout. Its draw lists are the
+    // entries of the main pass' it sees, in the same order, and its CommonData the main view's with its own camera.
+    struct InsetViewPacket {
+        glm::vec4 m_viewport;
+        glm::mat4 m_view;
+        glm::mat4 m_viewProjection;
+        glm::vec3 m_eyePos;
+        Glitter::Render::FrustumPlanes m_frustumPlanes;
+        std::vector<DrawListEntry> m_opaqueDrawList;
+        std::vector<DrawListEntry> m_transparentDrawList;
+    };
+
+    // Everything a frame's GL submission reads from its update: the CommonData, the sorted draw lists, the interpolated
+    // point lights and the requested textures, with the settings they were built for. The per-draw data is written from
+    // the draw lists when the packet is submitted, the Nodes' PerDrawData into their persistent buffer right before.
+    struct FramePacket {
+        bool m_valid;
+        // The Nodes' revision when the packet was updated, and the glfwGetTime() the input it's updated from was sampled at.
+        std::uint64_t m_sceneRevision;
+        double m_inputTime;
+
+        CommonData m_commonData;
+        glm::mat4 m_projection;
+        float m_nearPlane;
+        float m_farPlane;
+        // The main view's rectangle of the target, see Glitter::Render::LayoutViews(), and the inset views drawn over it.
+        glm::vec4 m_viewport;
+        std::array<InsetViewPacket, Glitter::Config::MAX_INSET_VIEWS> m_insetViews;
+        size_t m_insetViewCount;
+        // The point clicked to pick a Node, in NDC, read back from the Node ID target after the main pass, see m_gpuPicking.
+        std::optional<glm::vec2> m_pickRequest;
+
+        bool m_gpuCulling;
+        bool m_weightedOit;
+        bool m_shadows;
+        bool m_renderStaticShadows;
+        // Index of m_mainPrograms, for the opaque Nodes and the transparent bits added for the others.
+        std::uint32_t m_basePermutation;
+        std::uint32_t m_transparentPermutation;
+        DebugView m_debugView;
+        // The DrawCullState of each Node in the draw lists, indexed by Node, only in DebugView::CullState.
+        std::vector<std::uint8_t> m_cullStates;
+
+        // Kept between frames, so that they only allocate when the scene outgrows them.
+        std::vector<DrawListEntry> m_opaqueDrawList;
+        std::vector<DrawListEntry> m_transparentDrawList;
+        // The opaque Nodes drawn as impostors instead, sorted by Mesh.
+        std::vector<DrawListEntry> m_impostorDrawList;
+        std::vector<DrawListEntry> m_staticShadowDrawList;
+        std::vector<DrawListEntry> m_dynamicShadowDrawList;
+        std::vector<Glitter::Render::PointLight> m_pointLights;
+        std::vector<TextureRequest> m_textureRequests;
+        std::vector<MeshRequest> m_meshRequests;
+        // The skinning matrices of every Skeletons instance, which the skinned Nodes are skinned by before the packet's
+        // passes draw them.
+        std::vector<glm::mat4> m_skinMatrices;
+
+        // Whether the static Nodes are drawn from the batches of their cells instead, the cells whose batches are rebuilt
+        // along with the packet and the batches they're rebuilt with, and the built cells in the frustum, split between the
+        // ones drawn from their batches and the far ones drawn from their HLOD proxies. A reset drops every batch before
+        // the rebuilds.
+        bool m_staticBatching;
+        bool m_staticBatchReset;
+        std::vector<Glitter::Render::StaticBatchRebuild> m_staticBatchRebuilds;
+        std::vector<Glitter::Render::StaticBatchDesc> m_staticBatchDescs;
+        std::vector<Glitter::Render::StaticBatchSource> m_staticBatchSources;
+        std::vector<std::uint32_t> m_staticBatchCells;
+        std::vector<std::uint32_t> m_hlodCells;
+        size_t m_staticBatchedNodes;
+
+        size_t m_culledNodes;
+        // Among the Nodes in the frustum, the ones hidden behind the occluders rasterized by the CPU occlusion culling.
+        size_t m_occluders;
+        size_t m_occludedNodes;
+        // Among the Nodes in the frustum, the ones too far away or too small to be drawn, see m_contributionCulling.
+        size_t m_distanceCulledNodes;
+        size_t m_sizeCulledNodes;
+        // Whether the main pass' draw lists, and the counts above, were copied from m_drawListCache.
+        bool m_drawListsCached;
+    };
+
+    // What the main pass' draw lists were built from besides the camera and the time, see DrawListCache.
+    struct DrawListCacheKey {
+        std::uint64_t m_sceneRevision;
+        std::uint64_t m_staticBatchRevision;
+        size_t m_meshCount;
+        std::uint32_t m_bakedImpostors;
+        glm::mat4 m_projection;
+        glm::vec4 m_viewport;
+        Glitter::Render::ViewLayout m_viewLayout;
+        size_t m_insetViewCount;
+        std::uint32_t m_basePermutation;
+        std::uint32_t m_transparentPermutation;
+        float m_maxDrawDistance;
+        float m_minProjectedPixels;
+        bool m_stereo;
+        bool m_gpuCulling;
+        bool m_frustumCulling;
+        bool m_bvhCulling;
+        bool m_cpuOcclusionCulling;
+        bool m_contributionCulling;
+        bool m_meshLods;
+        bool m_impostors;
+        bool m_boundTextures;
+        bool m_staticBatching;
+        bool m_trackCullStates;
+
+        bool operator==(const DrawListCacheKey&) const = default;
+    };
+
+    // The main pass' culled and sorted draw lists as last built, with the Nodes' texture requests and the culling counts,
+    // copied into the packets updated while they still hold, see Config::ENABLE_DRAW_LIST_CACHING. No Node may have
+    // moved since, which UpdateFrame() checks, and none of the listed Nodes may animate their opacity.
+    struct DrawListCache {
+        bool m_valid;
+        DrawListCacheKey m_key;
+        glm::vec3 m_eyePos;
+        glm::vec3 m_viewDirection;
+        std::vector<DrawListEntry> m_opaqueDrawList;
+        std::vector<DrawListEntry> m_transparentDrawList;
+        std::vector<DrawListEntry> m_impostorDrawList;
+        std::array<std::vector<DrawListEntry>, Glitter::Config::MAX_INSET_VIEWS> m_insetOpaqueDrawLists;
+        std::array<std::vector<DrawListEntry>, Glitter::Config::MAX_INSET_VIEWS> m_insetTransparentDrawLists;
+        std::vector<std::uint8_t> m_cullStates;
+        std::vector<TextureRequest> m_textureRequests;
+        std::vector<MeshRequest> m_meshRequests;
+        size_t m_culledNodes;
+        size_t m_occluders;
+        size_t m_occludedNodes;
+        size_t m_distanceCulledNodes;
+        size_t m_sizeCulledNodes;
+    };
+
+    // Updates `packet` from the latest two simulation steps: refreshes the Nodes that moved, culls them, and builds and
+    // sorts the draw lists of both passes and of the shadow map. It only writes state that SubmitFrame() doesn't read, so
+    // that it can run on m_updateThread while the previous packet is submitted, and must not touch GL.
+    void UpdateFrame(FramePacket& packet)
+    {
+        GLITTER_PROFILE_SCOPE("Update");
+        packet.m_sceneRevision = m_nodes.GetRevision();
+        packet.m_inputTime = m_inputTime;
+        packet.m_pickRequest.reset();
+        packet.m_gpuCulling = m_gpuCulling;
+        packet.m_weightedOit = m_weightedOit;
+        packet.m_shadows = m_shadows;
+
+        // Interpolate between the last two simulation steps, by how far this frame is past the latest. Animating Nodes are
+        // evaluated at this time, both here and in the shaders.
+        auto alpha = static_cast<float>(m_simulationAccumulator / Glitter::Config::SIMULATION_TIME_STEP);
+        auto time = static_cast<float>(std::lerp(m_previousState.m_time, m_currentState.m_time, static_cast<double>(alpha)));
+
+        // Calculate View and Projection.
+        glm::vec3 eyePos = m_frameCamera.m_eyePos;
+        glm::vec3 eyeTarget = m_frameCamera.m_eyeTarget;
+        glm::mat4 view = glm::lookAt(eyePos, eyeTarget, glm::vec3(0.0f, 1.0f, 0.0f));
+        float nearPlane = 1.0f;
+        float farPlane = 20.0f;
+        packet.m_nearPlane = nearPlane;
+        packet.m_farPlane = farPlane;
+        float eyeWidth = static_cast<float>(m_windowWidth) / (m_stereo ? 2.0f : 1.0f);
+        float aspect = eyeWidth / static_cast<float>(m_windowHeight);
+
+        // Lay the views out over the target, each with the aspect of its rectangle.
+        size_t insetViewCount
+            = m_stereo ? 0 : Glitter::Render::GetInsetViewCount(m_viewLayout, static_cast<size_t>(m_insetViewCount));
+        std::array<glm::vec4, Glitter::Config::MAX_INSET_VIEWS> insetViewports {};
+        Glitter::Render::LayoutViews(insetViewCount > 0 ? m_viewLayout : Glitter::Render::ViewLayout::Single, aspect,
+            packet.m_viewport, std::span(insetViewports).first(insetViewCount));
+        packet.m_insetViewCount = insetViewCount;
+        glm::mat4 projection = glm::perspective(
+            glm::radians(45.0f), aspect * packet.m_viewport.z / packet.m_viewport.w, nearPlane, farPlane);
+
+        // Extract the frustum planes using the VP matrix.
+        // By using the combined View and Projection matrices, we should obtain the clipping planes in World Space.
+        // Proj: (View Space)  -> (Clip Space);
+        // View: (World Space) -> (View Space);
+        //   VP: (World Space) -> (Clip Space).
+        glm::mat4 vp = projection * view;
+        Glitter::Render::FrustumPlanes frustumPlanes = Glitter::Render::ExtractFrustumPlanes(vp);
+        glm::mat4 cullViewProjection = vp;
+
+        // The main view is culled with its own frustum, then squeezed into its rectangle of the target, so that the passes
+        // sized by the target's viewport, the light clusters and the Hi-Z pyramid, line up with it.
+        projection = Glitter::Render::FitToViewport(projection, packet.m_viewport);
+        vp = projection * view;
+        packet.m_projection = projection;
+
+        // Each inset view orbits the main camera's target. The Nodes are culled for every inset view at once, only those
+        // within a sphere around all of their frusta being tested against each of them.
+        std::array<Glitter::Render::FrustumPlanes, Glitter::Config::MAX_INSET_VIEWS> insetFrustumPlanes {};
+        std::array<glm::mat4, Glitter::Config::MAX_INSET_VIEWS> insetViewProjections {};
+        for (size_t viewIdx = 0; viewIdx < insetViewCount; viewIdx++) {
+            InsetViewPacket& inset = packet.m_insetViews[viewIdx];
+            const glm::vec4& viewport = insetViewports[viewIdx];
+            inset.m_viewport = viewport;
+            inset.m_eyePos = Glitter::Render::GetInsetEyePos(eyePos, eyeTarget, viewIdx, insetViewCount);
+            inset.m_view = glm::lookAt(inset.m_eyePos, eyeTarget, glm::vec3(0.0f, 1.0f, 0.0f));
+            inset.m_viewProjection
+                = glm::perspective(glm::radians(45.0f), aspect * viewport.z / viewport.w, nearPlane, farPlane) * inset.m_view;
+            inset.m_frustumPlanes = Glitter::Render::ExtractFrustumPlanes(inset.m_viewProjection);
+            insetFrustumPlanes[viewIdx] = inset.m_frustumPlanes;
+            insetViewProjections[viewIdx] = inset.m_viewProjection;
+        }
+        glm::vec4 insetSphere = Glitter::Render::BoundFrustums(std::span(insetViewProjections).first(insetViewCount));
+
+        // Both eyes are culled at once, against a frustum holding both of theirs, and drawn from the same draw lists.
+        std::array<glm::mat4, 2> eyeViewProjections {vp, vp};
+        if (m_stereo) {
+            std::array<glm::mat4, 2> eyeViews = Glitter::Render::GetStereoViews(view, Glitter::Config::STEREO_EYE_SEPARATION);
+            eyeViewProjections = {projection * eyeViews[0], projection * eyeViews[1]};
+            frustumPlanes = Glitter::Render::CombineStereoFrustums(Glitter::Render::ExtractFrustumPlanes(eyeViewProjections[0]),
+                Glitter::Render::ExtractFrustumPlanes(eyeViewProjections[1]));
+        }
+        // The camera drawn from is latched again once the packet is submitted, a little further along its path, and the
+        // cached draw lists are drawn from cameras that drifted a little from the one they were culled for.
+        float cullMargin = (m_lateLatching ? Glitter::Config::LATE_LATCH_CULL_MARGIN : 0.0f)
+            + (m_drawListCaching ? Glitter::Config::DRAW_LIST_CACHE_MAX_DRIFT : 0.0f);
+        if (cullMargin > 0.0f) {
+            frustumPlanes = Glitter::Render::GrowFrustumPlanes(frustumPlanes, cullMargin);
+        }
+        if (m_drawListCaching) {
+            for (size_t viewIdx = 0; viewIdx < insetViewCount; viewIdx++) {
+                insetFrustumPlanes[viewIdx] = Glitter::Render::GrowFrustumPlanes(
+                    insetFrustumPlanes[viewIdx], Glitter::Config::DRAW_LIST_CACHE_MAX_DRIFT);
+            }
+            insetSphere.w += Glitter::Config::DRAW_LIST_CACHE_MAX_DRIFT;
+        }
+
+        // The main light is directional, it casts the shadows.
+        glm::vec3 lightDirection = glm::normalize(glm::vec3(1.0f, 0.5f, -0.5f));
+
+        // Prepare the packet's CommonData, it's written into the UBO ring along with the draw batches. The Hi-Z pyramid's
+        // View-Projection is only known once the previous packet is submitted.
+        packet.m_commonData = {.m_view = view,
+            .m_viewProjection = vp,
+            .m_eyePos = glm::vec4(eyePos, 1.0),
+            .m_lightPos = glm::vec4(lightDirection, 0.0f),
+            .m_lightColor = glm::vec4(1.0, 1.0, 1.0, 1.0),
+            .m_frustumPlanes = frustumPlanes,
+            .m_hiZViewProjection = glm::mat4(1.0f),
+            .m_time = glm::vec4(time, 0.0f, 0.0f, 0.0f),
+            .m_shadowViewProjection = glm::mat4(1.0f),
+            .m_shadowParams = glm::vec4(packet.m_shadows ? 1.0f : 0.0f, Glitter::Config::SHADOW_NORMAL_OFFSET, 0.0f, 0.0f),
+            .m_textureParams = glm::vec4(m_textureMipBias, 0.0f, 0.0f, 0.0f),
+            .m_eyeViewProjections = eyeViewProjections};
+
+        // Move the animated Nodes of the loaded scenes, before their Models are refreshed.
+        // They're only evaluated again once the time moved, or Nodes were added or removed.
+        bool animationsStale = time != m_animationTime;
+        if (m_animationRevision != m_nodes.GetRevision()) {
+            m_animationPlayer.RemoveStale(m_nodes);
+            m_animationRevision = m_nodes.GetRevision();
+            animationsStale = true;
+        }
+        if (m_playAnimations && animationsStale) {
+            m_animationTime = time;
+            GLITTER_PROFILE_SCOPE("Animations");
+            m_animationPlayer.Evaluate(time, m_nodes, m_skeletons, m_jobSystem);
+
+            // The skinned Nodes stay in place, but are moved on the spot to keep them out of the static shadows and batches.
+            std::span<const glm::aligned_vec3> positions = m_nodes.Positions();
+            std::span<const glm::quat> rotations = m_nodes.Rotations();
+            std::span<const glm::aligned_vec3> scales = m_nodes.Scales();
+            for (const SkinnedNode& skinned : m_skinnedNodes) {
+                if (m_nodes.IsValid(skinned.m_handle)) {
+                    size_t nodeIdx = m_nodes.GetNode(skinned.m_handle);
+                    m_nodes.SetTransform(skinned.m_handle, positions[nodeIdx], rotations[nodeIdx], scales[nodeIdx]);
+                }
+            }
+        }
+        {
+            GLITTER_PROFILE_SCOPE("Skinning");
+            m_skeletons.ComputeSkinning(m_jobSystem, packet.m_skinMatrices);
+        }
+
+        // Refresh the cached Model and world-space AABB (as a center and half-extent) of every Node added or moved since
+        // the last frame, or whose parent moved. Static Nodes keep theirs. The Models of the Nodes without a parent are
+        // refreshed concurrently, then the hierarchy's, parents first.
+        m_jobSystem.ParallelFor(m_nodes.DirtyNodes().size(), Glitter::Config::CULL_GRAIN_SIZE, [&](size_t begin, size_t end) {
+            GLITTER_PROFILE_SCOPE("Update Models");
+            m_nodes.UpdateModels(begin, end);
+        });
+        m_nodes.UpdateHierarchy();
+
+        std::span<const std::uint32_t> nodeMeshIDs = m_nodes.MeshIDs();
+        std::span<const glm::aligned_mat4> nodeModels = m_nodes.Models();
+        std::span<const std::uint32_t> dirtyNodes = m_nodes.DirtyNodes();
+        MarkNodeDataStale(dirtyNodes);
+        if (!dirtyNodes.empty()) {
+            Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::SCENE_CHANGE);
+        }
+        m_cullBounds.Resize(m_nodes.Size());
+        m_jobSystem.ParallelFor(dirtyNodes.size(), Glitter::Config::CULL_GRAIN_SIZE, [&](size_t begin, size_t end) {
+            GLITTER_PROFILE_SCOPE("Update Nodes");
+            for (size_t dirtyIdx = begin; dirtyIdx < end; dirtyIdx++) {
+                std::uint32_t nodeIdx = dirtyNodes[dirtyIdx];
+
+                // The box around the Mesh's AABB once transformed, whose half-extent along each axis sums the absolute
+                // contributions of the Model's columns. Their w is 0, so the extent's is too.
+                const glm::aligned_mat4& model = nodeModels[nodeIdx];
+                const Glitter::Scene::AABB& aabb = m_meshes[nodeMeshIDs[nodeIdx]].m_aabb;
+                glm::vec3 localCenter = (aabb.m_localMin + aabb.m_localMax) * 0.5f;
+                glm::vec3 localExtent = (aabb.m_localMax - aabb.m_localMin) * 0.5f;
+                glm::aligned_vec4 center = model * glm::aligned_vec4(localCenter, 1.0f);
+                glm::aligned_vec4 extent = glm::abs(model[0]) * localExtent.x + glm::abs(model[1]) * localExtent.y
+                    + glm::abs(model[2]) * localExtent.z;
+                m_cullBounds.Set(nodeIdx, glm::vec3(center), glm::vec3(extent));
+            }
+        });
+
+        // Keep the static batches' cells in sync, by the shadow cache's notion of which Nodes are static, and take the
+        // next cells to rebuild. The rebuilds of a packet updated again before it was submitted are taken again instead.
+        if (packet.m_valid) {
+            m_staticBatchCells.Requeue(packet.m_staticBatchRebuilds);
+        } else {
+            packet.m_staticBatchReset = false;
+        }
+        packet.m_staticBatching
+            = m_staticBatching && !m_gpuCulling && !(m_visibilityBuffer && m_textureMode != TextureMode::Bound);
+        packet.m_staticBatchRebuilds.clear();
+        packet.m_staticBatchDescs.clear();
+        packet.m_staticBatchSources.clear();
+        packet.m_staticBatchCells.clear();
+        packet.m_hlodCells.clear();
+        packet.m_staticBatchedNodes = 0;
+
+        // The structures over the Nodes' bounds are kept in sync by systems run on the job system, each ordered by the
+        // state it reads and writes, so that only the static batches wait for the shadow cache.
+        using TaskThread = Glitter::Core::TaskGraph::TaskThread;
+        Glitter::Core::TaskGraph systems;
+        // Rebuild the BVH when Nodes were added or cleared, and refit it around the ones that moved.
+        systems.Add(
+            "BVH Update", TaskThread::Worker,
+            [&] {
+                if (!m_bvhCulling) {
+                    m_bvhRevision = UINT64_MAX;
+                } else if (m_bvhRevision != m_nodes.GetRevision()) {
+                    m_bvh.Build(m_cullBounds);
+                    m_bvhRevision = m_nodes.GetRevision();
+                } else if (!dirtyNodes.empty()) {
+                    m_bvh.Refit(m_cullBounds, dirtyNodes);
+                }
+                return true;
+            },
+            {.m_reads = {&m_nodes, &m_cullBounds}, .m_writes = {&m_bvh}});
+        systems.Add(
+            "Shadow Cache Update", TaskThread::Worker,
+            [&] {
+                m_shadowCache.Update(dirtyNodes, m_nodes.GetRevision(), lightDirection, m_cullBounds);
+                return true;
+            },
+            {.m_reads = {&m_nodes, &m_cullBounds}, .m_writes = {&m_shadowCache}});
+        systems.Add(
+            "Static Batch Update", TaskThread::Worker,
+            [&] {
+                if (packet.m_staticBatching) {
+                    std::span<const std::uint8_t> nodeFlags = m_nodes.Flags();
+                    std::span<const float> nodeOpacities = m_nodes.Opacities();
+                    m_staticBatchCells.Update(dirtyNodes, m_nodes.GetRevision(), m_cullBounds, [&](size_t nodeIdx) {
+                        constexpr std::uint8_t excludedFlags
+                            = Glitter::Scene::NodeFlags::ANIMATE | Glitter::Scene::NodeFlags::SIMULATED;
+                        if ((nodeFlags[nodeIdx] & excludedFlags) != 0 || nodeOpacities[nodeIdx] != 1.0f) {
+                            return Glitter::Render::StaticState::Excluded;
+                        }
+                        return m_shadowCache.IsDynamic(nodeIdx) ? Glitter::Render::StaticState::Moving
+                                                                : Glitter::Render::StaticState::Static;
+                    });
+                    TakeStaticBatchRebuilds(packet);
+                    m_staticBatchCells.Cull(m_frustumCulling ? &frustumPlanes : nullptr, packet.m_staticBatchCells);
+                    // The cells past Config::HLOD_DISTANCE of the eye, by the nearest point of their bounds, are drawn
+                    // from their proxies.
+                    if (Glitter::Config::ENABLE_HLOD && m_hlod) {
+                        std::erase_if(packet.m_staticBatchCells, [&](std::uint32_t cell) {
+                            glm::vec3 outside = glm::max(
+                                glm::abs(eyePos - m_staticBatchCells.GetCenter(cell)) - m_staticBatchCells.GetExtent(cell),
+                                0.0f);
+                            if (glm::dot(outside, outside) <= Glitter::Config::HLOD_DISTANCE * Glitter::Config::HLOD_DISTANCE) {
+                                return false;
+                            }
+                            packet.m_hlodCells.push_back(cell);
+                            return true;
+                        });
+                    }
+                } else if (!m_staticBatchCells.IsEmpty()) {
+                    m_staticBatchCells.Clear();
+                    packet.m_staticBatchReset = true;
+                }
+                return true;
+            },
+            {.m_reads = {&m_nodes, &m_cullBounds, &m_shadowCache, &m_meshes}, .m_writes = {&m_staticBatchCells, &packet}});
+        // The spatial grid is kept in sync incrementally, removals included, since a Node moved into the place of a removed
+        // one is dirty.
+        systems.Add(
+            "Spatial Grid Update", TaskThread::Worker,
+            [&] {
+                m_spatialGrid.Update(m_cullBounds, dirtyNodes);
+                return true;
+            },
+            {.m_reads = {&m_cullBounds}, .m_writes = {&m_spatialGrid}});
+        systems.Run(m_jobSystem);
+
+        // Then pick the Node under the cursor clicked in BuildDebugUi(), and find the Nodes around it.
+        Glitter::Render::InvalidateCoherency(m_cullCoherency, dirtyNodes);
+        m_nodes.ClearDirty();
+        if (m_pickRequest && m_gpuPicking) {
+            packet.m_pickRequest = m_pickRequest;
+            m_pickRequest.reset();
+        } else if (m_pickRequest) {
+            glm::mat4 inverseViewProjection = glm::inverse(projection * view);
+            glm::vec4 nearPoint = inverseViewProjection * glm::vec4(*m_pickRequest, -1.0f, 1.0f);
+            glm::vec4 farPoint = inverseViewProjection * glm::vec4(*m_pickRequest, 1.0f, 1.0f);
+            glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+            std::optional<Glitter::Scene::RayHit> hit
+                = m_spatialGrid.Raycast(m_cullBounds, origin, glm::vec3(farPoint) / farPoint.w - origin, 1.0f);
+            m_pickedNode = hit ? std::optional(m_nodes.GetHandle(hit->m_item)) : std::nullopt;
+            m_pickRequest.reset();
+        }
+        m_pickedNeighbors.clear();
+        if (m_pickedNode && m_nodes.IsValid(*m_pickedNode)) {
+            size_t pickedIdx = m_nodes.GetNode(*m_pickedNode);
+            glm::vec3 pickedCenter = m_cullBounds.GetCenter(pickedIdx);
+            m_spatialGrid.QuerySphere(m_cullBounds, pickedCenter, Glitter::Config::PICK_NEIGHBOR_RADIUS, m_pickedNeighbors);
+            std::erase(m_pickedNeighbors, static_cast<std::uint32_t>(pickedIdx));
+            if (Glitter::Config::ENABLE_DEBUG_DRAW && m_debugLines && m_debugDraw.IsCreated()) {
+                for (std::uint32_t neighborIdx : m_pickedNeighbors) {
+                    m_debugDraw.Box(m_cullBounds.GetCenter(neighborIdx), m_cullBounds.GetExtent(neighborIdx),
+                        glm::vec4(0.0f, 0.5f, 1.0f, 1.0f));
+                }
+                m_debugDraw.Box(pickedCenter, m_cullBounds.GetExtent(pickedIdx), glm::vec4(1.0f, 0.5f, 0.0f, 1.0f));
+                m_debugDraw.Sphere(pickedCenter, Glitter::Config::PICK_NEIGHBOR_RADIUS, glm::vec4(0.0f, 0.5f, 1.0f, 1.0f),
+                    Glitter::Render::DebugDepth::Tested);
+            }
+        }
+
+        // Each Node is drawn with the Main program permutation of its pass and of the Debug View settings.
+        std::uint32_t basePermutation = (m_drawTextures || IsVisualization(m_debugView) ? 0 : MAIN_PERMUTATION_UNTEXTURED)
+            | (static_cast<std::uint32_t>(m_debugView) << MAIN_PERMUTATION_DEBUG_VIEW_SHIFT);
+        std::uint32_t transparentPermutation = MAIN_PERMUTATION_TRANSPARENT | (m_weightedOit ? MAIN_PERMUTATION_WEIGHTED_OIT : 0);
+        packet.m_basePermutation = basePermutation;
+        packet.m_transparentPermutation = transparentPermutation;
+        packet.m_debugView = m_debugView;
+        bool trackCullStates = m_debugView == DebugView::CullState;
+        float maxDrawDistance = GetMaxDrawDistance();
+
+        // Copy the main pass' draw lists from the cache rather than building them again while they still hold: no Node
+        // moved, and the frustum drifted by less than it was culled grown by, measured out to the far plane.
+        DrawListCacheKey drawListKey {.m_sceneRevision = m_nodes.GetRevision(),
+            .m_staticBatchRevision = m_staticBatchCells.GetRevision(),
+            .m_meshCount = m_meshes.Size(),
+            .m_bakedImpostors = m_impostorAtlas.GetBakedCount(),
+            .m_projection = projection,
+            .m_viewport = packet.m_viewport,
+            .m_viewLayout = m_viewLayout,
+            .m_insetViewCount = insetViewCount,
+            .m_basePermutation = basePermutation,
+            .m_transparentPermutation = transparentPermutation,
+            .m_maxDrawDistance = maxDrawDistance,
+            .m_minProjectedPixels = m_minProjectedPixels,
+            .m_stereo = m_stereo,
+            .m_gpuCulling = m_gpuCulling,
+            .m_frustumCulling = m_frustumCulling,
+            .m_bvhCulling = m_bvhCulling,
+            .m_cpuOcclusionCulling = m_cpuOcclusionCulling,
+            .m_contributionCulling = m_contributionCulling,
+            .m_meshLods = m_meshLods,
+            .m_impostors = m_impostors,
+            .m_boundTextures = m_textureMode == TextureMode::Bound,
+            .m_staticBatching = packet.m_staticBatching,
+            .m_trackCullStates = trackCullStates};
+        glm::vec3 viewDirection = glm::normalize(eyeTarget - eyePos);
+        float drift = glm::distance(eyePos, m_drawListCache.m_eyePos)
+            + farPlane * std::acos(std::clamp(glm::dot(viewDirection, m_drawListCache.m_viewDirection), -1.0f, 1.0f));
+        packet.m_drawListsCached = m_drawListCaching && m_drawListCache.m_valid && m_drawListCache.m_key == drawListKey
+            && dirtyNodes.empty() && drift <= Glitter::Config::DRAW_LIST_CACHE_MAX_DRIFT;
+
+        // Cull each Node against the frustum. Each range of Nodes is handled by a job, writing only its own slice of the
+        // visibility mask.
+        std::atomic<size_t> numCulledNodes = 0;
+        if (!packet.m_drawListsCached) {
+            Glitter::Render::BeginCull(frustumPlanes, m_nodes.Size(), m_nodeVisibility, m_cullCoherency);
+            m_insetViewMasks.resize(m_nodes.Size());
+            m_jobSystem.ParallelFor(m_nodes.Size(), Glitter::Config::CULL_GRAIN_SIZE, [&](size_t begin, size_t end) {
+                GLITTER_PROFILE_SCOPE("Frustum Cull");
+                if (m_frustumCulling && !m_gpuCulling && !m_bvhCulling) {
+                    numCulledNodes += Glitter::Render::CullAABBRange(
+                        frustumPlanes, m_cullBounds, begin, end, m_nodeVisibility, m_cullCoherency);
+                }
+                if (m_frustumCulling && !m_gpuCulling && insetViewCount > 0) {
+                    Glitter::Render::CullViewsRange(std::span(insetFrustumPlanes).first(insetViewCount), insetSphere,
+                        m_cullBounds, begin, end, m_insetViewMasks);
+                }
+            });
+        }
+
+        // Otherwise, cull through the BVH.
+        if (!packet.m_drawListsCached && m_frustumCulling && !m_gpuCulling && m_bvhCulling) {
+            GLITTER_PROFILE_SCOPE("BVH Cull");
+            numCulledNodes = m_bvh.Cull(frustumPlanes, m_cullBounds, m_nodeVisibility);
+        }
+
+        // Then the Nodes hidden behind the nearest occluders, rasterized on the CPU, so that they're culled in the frame
+        // they're hidden in. Only from the main view, of a single eye.
+        packet.m_occluders = 0;
+        packet.m_occludedNodes = 0;
+        if (!packet.m_drawListsCached && m_cpuOcclusionCulling && m_frustumCulling && !m_gpuCulling && !m_stereo) {
+            CullOccludedNodes(packet, cullViewProjection, eyePos);
+            numCulledNodes += packet.m_occludedNodes;
+        }
+
+        // Split Node elements between the opaque and transparent draw lists. Each packet keeps its lists between frames, so
+        // they only allocate when the scene outgrows them.
+        if (trackCullStates) {
+            packet.m_cullStates.resize(m_nodes.Size());
+        }
+        packet.m_opaqueDrawList.clear();
+        packet.m_transparentDrawList.clear();
+        packet.m_impostorDrawList.clear();
+        packet.m_textureRequests.clear();
+        packet.m_meshRequests.clear();
+        packet.m_distanceCulledNodes = 0;
+        packet.m_sizeCulledNodes = 0;
+        std::span<const std::uint32_t> nodeTextureIDs = m_nodes.TextureIDs();
+        m_drawListViews.resize(m_nodes.Size());
+        auto allViews = static_cast<std::uint8_t>((1u << (insetViewCount + 1)) - 1);
+        bool animatedOpacity = false;
+        for (size_t nodeIdx = 0; !m_gpuCulling && !packet.m_drawListsCached && nodeIdx < m_nodes.Size(); nodeIdx++) {
+            // The views seeing the Node, the main view's bit first.
+            std::uint8_t views = allViews;
+            if (m_frustumCulling) {
+                views = Glitter::Render::IsVisible(m_nodeVisibility, nodeIdx) ? 1 : 0;
+                if (insetViewCount > 0) {
+                    views |= static_cast<std::uint8_t>(m_insetViewMasks[nodeIdx] << 1);
+                }
+                if (views == 0) {
+                    continue;
+                }
+            }
+            // The batches of their cells draw the static Nodes, culled by cell.
+            if (packet.m_staticBatching && m_staticBatchCells.IsBatched(nodeIdx)) {
+                continue;
+            }
+
+            // Drop the Nodes that would contribute too little to the image, by the distance to the nearest point of their
+            // bounds and by the size of their bounding sphere on screen.
+            glm::vec3 boundsCenter = m_cullBounds.GetCenter(nodeIdx);
+            glm::vec3 boundsExtent = m_cullBounds.GetExtent(nodeIdx);
+            // Only from the main view, the inset views draw whatever they see.
+            float pixels = ProjectedPixels(boundsCenter, boundsExtent, eyePos);
+            if (m_contributionCulling && (views & 1) != 0) {
+                glm::vec3 outside = glm::max(glm::abs(eyePos - boundsCenter) - boundsExtent, 0.0f);
+                if (glm::dot(outside, outside) > maxDrawDistance * maxDrawDistance) {
+                    packet.m_distanceCulledNodes++;
+                    views &= static_cast<std::uint8_t>(~1u);
+                } else if (pixels < m_minProjectedPixels) {
+                    packet.m_sizeCulledNodes++;
+                    views &= static_cast<std::uint8_t>(~1u);
+                }
+                if (views == 0) {
+                    continue;
+                }
+            }
+            m_drawListViews[nodeIdx] = views;
+
+            if (trackCullStates) {
+                auto cullState = DrawCullState::Untested;
+                if (m_frustumCulling) {
+                    std::uint8_t planeMask = Glitter::Render::ALL_PLANES;
+                    cullState = Glitter::Render::TestAABB(frustumPlanes, boundsCenter, boundsExtent, planeMask)
+                            == Glitter::Render::CullResult::Inside
+                        ? DrawCullState::Inside
+                        : DrawCullState::Intersecting;
+                }
+                if (m_contributionCulling) {
+                    glm::vec3 outside = glm::max(glm::abs(eyePos - boundsCenter) - boundsExtent, 0.0f);
+                    if (glm::dot(outside, outside) > 0.25f * maxDrawDistance * maxDrawDistance
+                        || pixels < 2.0f * m_minProjectedPixels) {
+                        cullState = DrawCullState::NearlyCulled;
+                    }
+                }
+                packet.m_cullStates[nodeIdx] = static_cast<std::uint8_t>(cullState);
+            }
+
+            glm::vec3 nodePosition = glm::vec3(nodeModels[nodeIdx][3]);
+            std::uint32_t depth = Glitter::Render::DrawKey::QuantizeDepth(glm::distance(eyePos, nodePosition), farPlane);
+            // A texture only changes state when it's bound.
+            std::uint32_t texture = m_textureMode == TextureMode::Bound ? nodeTextureIDs[nodeIdx] : 0;
+
+            std::uint32_t lod = 0;
+            if (m_meshLods) {
+                lod = SelectLod(pixels);
+            }
+            if (Glitter::Config::ENABLE_TEXTURE_STREAMING) {
+                packet.m_textureRequests.push_back({.m_slot = nodeTextureIDs[nodeIdx], .m_pixels = pixels});
+            }
+            if (Glitter::Config::ENABLE_MESH_STREAMING) {
+                packet.m_meshRequests.push_back({.m_mesh = nodeMeshIDs[nodeIdx], .m_lod = SelectStreamedLod(pixels)});
+            }
+
+            animatedOpacity |= (m_nodes.Flags()[nodeIdx] & Glitter::Scene::NodeFlags::ANIMATE) != 0;
+            float opacity = m_nodes.EvaluateOpacity(nodeIdx, time);
+            std::uint32_t program = basePermutation | (opacity == 1.0f ? 0 : transparentPermutation);
+            const Mesh& mesh = m_meshes[nodeMeshIDs[nodeIdx]];
+            if (opacity == 1.0f && m_impostors && mesh.m_impostorLayer && pixels < Glitter::Config::IMPOSTOR_PIXELS) {
+                // Far opaque Nodes are drawn as the impostor of their Mesh, instanced by Mesh.
+                packet.m_impostorDrawList.push_back(
+                    DrawListEntry {.m_sortKey = Glitter::Render::DrawKey::Opaque(0, nodeMeshIDs[nodeIdx], 0, depth),
+                        .m_node = static_cast<std::uint32_t>(nodeIdx),
+                        .m_lod = 0});
+            } else if (opacity == 1.0f) {
+                // Sort each opaque Node by its texture (if bound) and Mesh, so that consecutive Nodes can be drawn
+                // instanced within the same indirect batch, and then from front-to-back.
+                packet.m_opaqueDrawList.push_back(
+                    DrawListEntry {.m_sortKey = Glitter::Render::DrawKey::Opaque(program, nodeMeshIDs[nodeIdx], texture, depth),
+                        .m_node = static_cast<std::uint32_t>(nodeIdx),
+                        .m_lod = lod});
+            } else if (opacity != 0.0f && m_weightedOit) {
+                // Weighted blended transparency doesn't depend on the order, so the transparent Nodes are only sorted by
+                // state, to be instanced like the opaque ones.
+                packet.m_transparentDrawList.push_back(DrawListEntry {
+                    .m_sortKey = Glitter::Render::DrawKey::WeightedTransparent(program, nodeMeshIDs[nodeIdx], texture),
+                    .m_node = static_cast<std::uint32_t>(nodeIdx),
+                    .m_lod = lod});
+            } else if (opacity != 0.0f) {
+                // Sort each transparent Node from back-to-front.
+                packet.m_transparentDrawList.push_back(DrawListEntry {
+                    .m_sortKey = Glitter::Render::DrawKey::Transparent(program, nodeMeshIDs[nodeIdx], texture, depth),
+                    .m_node = static_cast<std::uint32_t>(nodeIdx),
+                    .m_lod = lod});
+            } else {
+                // A totally transparent Node (opacity = 0.0f).
+                continue;
+            }
+        }
+
+        // Radix sort the main pass' draw lists by their packed keys.
+        if (!packet.m_drawListsCached) {
+            GLITTER_PROFILE_SCOPE("Sort Draw Lists");
+            SortDrawList(packet.m_opaqueDrawList);
+            SortDrawList(packet.m_transparentDrawList, packet.m_weightedOit);
+            SortDrawList(packet.m_impostorDrawList);
+        }
+
+        // Split the inset views' draw lists off the sorted ones, in the same order, then drop the Nodes that only the inset
+        // views see from the main pass'.
+        if (!packet.m_drawListsCached && insetViewCount > 0) {
+            GLITTER_PROFILE_SCOPE("Inset View Draw Lists");
+            for (size_t viewIdx = 0; viewIdx < insetViewCount; viewIdx++) {
+                InsetViewPacket& inset = packet.m_insetViews[viewIdx];
+                auto viewBit = static_cast<std::uint8_t>(1u << (viewIdx + 1));
+                auto seen = [&](const DrawListEntry& entry) { return (m_drawListViews[entry.m_node] & viewBit) != 0; };
+                inset.m_opaqueDrawList.clear();
+                inset.m_transparentDrawList.clear();
+                std::ranges::copy_if(packet.m_opaqueDrawList, std::back_inserter(inset.m_opaqueDrawList), seen);
+                std::ranges::copy_if(packet.m_transparentDrawList, std::back_inserter(inset.m_transparentDrawList), seen);
+            }
+            auto insetOnly = [&](const DrawListEntry& entry) { return (m_drawListViews[entry.m_node] & 1) == 0; };
+            std::erase_if(packet.m_opaqueDrawList, insetOnly);
+            std::erase_if(packet.m_transparentDrawList, insetOnly);
+        }
+
+        // Then copy the lists from the cache, or keep them in it, unless a listed Node animates its opacity, which changes
+        // the list it's in from frame to frame.
+        if (packet.m_drawListsCached) {
+            CopyCachedDrawLists(packet);
+            numCulledNodes = m_drawListCache.m_culledNodes;
+        } else {
+            m_drawListCache.m_valid = m_drawListCaching && !animatedOpacity;
+            if (m_drawListCache.m_valid) {
+                CacheDrawLists(packet, drawListKey, eyePos, viewDirection, numCulledNodes.load());
+            }
+        }
+
+        // The batched Nodes request their textures and Mesh LODs at the size of their cell, the LODs for the batches
+        // rebuilt later on.
+        std::array batchedCells {std::span(packet.m_staticBatchCells), std::span(packet.m_hlodCells)};
+        for (std::uint32_t cell : batchedCells | std::views::join) {
+            std::span<const std::uint32_t> cellNodes = m_staticBatchCells.GetNodes(cell);
+            packet.m_staticBatchedNodes += cellNodes.size();
+            if (Glitter::Config::ENABLE_TEXTURE_STREAMING || Glitter::Config::ENABLE_MESH_STREAMING) {
+                float pixels
+                    = ProjectedPixels(m_staticBatchCells.GetCenter(cell), m_staticBatchCells.GetExtent(cell), eyePos);
+                for (std::uint32_t nodeIdx : cellNodes) {
+                    if (Glitter::Config::ENABLE_TEXTURE_STREAMING) {
+                        packet.m_textureRequests.push_back({.m_slot = nodeTextureIDs[nodeIdx], .m_pixels = pixels});
+                    }
+                    if (Glitter::Config::ENABLE_MESH_STREAMING) {
+                        packet.m_meshRequests.push_back({.m_mesh = nodeMeshIDs[nodeIdx], .m_lod = SelectStreamedLod(pixels)});
+                    }
+                }
+            }
+        }
+
+        // Interpolate the point lights along their orbits, they're binned into clusters when the packet is submitted. The
+        // lights added since the previous step have nothing to interpolate from.
+        {
+            GLITTER_PROFILE_SCOPE("Point Lights");
+            const std::vector<Glitter::Render::PointLight>& currentLights = m_currentState.m_pointLights;
+            const std::vector<Glitter::Render::PointLight>& previousLights = m_previousState.m_pointLights;
+            packet.m_pointLights.resize(currentLights.size());
+            for (size_t lightIdx = 0; lightIdx < packet.m_pointLights.size(); lightIdx++) {
+                packet.m_pointLights[lightIdx] = currentLights[lightIdx];
+                if (lightIdx < previousLights.size()) {
+                    packet.m_pointLights[lightIdx].m_positionRadius = glm::mix(
+                        previousLights[lightIdx].m_positionRadius, currentLights[lightIdx].m_positionRadius, alpha);
+                }
+            }
+        }
+
+        if (Glitter::Config::ENABLE_DEBUG_DRAW && m_debugLines && m_drawLights && m_debugDraw.IsCreated()) {
+            for (const Glitter::Render::PointLight& light : packet.m_pointLights) {
+                m_debugDraw.Sphere(glm::vec3(light.m_positionRadius), light.m_positionRadius.w,
+                    glm::vec4(glm::vec3(light.m_color), 1.0f), Glitter::Render::DebugDepth::Tested);
+            }
+            m_debugDraw.Frustum(m_shadowCache.GetViewProjection(), glm::vec4(1.0f, 1.0f, 0.0f, 1.0f));
+        }
+
+        // List the Nodes casting shadows inside the light's frustum: every static one when the cache has to be rendered
+        // again, and the dynamic ones every frame. Each is sorted by Mesh, to be instanced. Transparent Nodes cast
+        // shadows as if they were opaque, the swarm's don't cast any since the CPU doesn't know where they are.
+        packet.m_staticShadowDrawList.clear();
+        packet.m_dynamicShadowDrawList.clear();
+        packet.m_renderStaticShadows = packet.m_shadows && m_shadowCache.NeedsStaticRender(m_cullBounds);
+        if (packet.m_shadows) {
+            GLITTER_PROFILE_SCOPE("Shadow Draw Lists");
+            const Glitter::Render::FrustumPlanes& shadowPlanes = m_shadowCache.GetFrustumPlanes();
+            std::span<const std::uint8_t> nodeFlags = m_nodes.Flags();
+            auto addShadowCaster = [&](std::vector<DrawListEntry>& list, size_t nodeIdx) {
+                if ((nodeFlags[nodeIdx] & Glitter::Scene::NodeFlags::SIMULATED) != 0) {
+                    return;
+                }
+                std::uint8_t planeMask = Glitter::Render::ALL_PLANES;
+                if (Glitter::Render::TestAABB(shadowPlanes, m_cullBounds.GetCenter(nodeIdx), m_cullBounds.GetExtent(nodeIdx),
+                        planeMask)
+                    != Glitter::Render::CullResult::Outside) {
+                    list.push_back(DrawListEntry {.m_sortKey = Glitter::Render::DrawKey::Opaque(0, nodeMeshIDs[nodeIdx], 0, 0),
+                        .m_node = static_cast<std::uint32_t>(nodeIdx),
+                        .m_lod = 0});
+                }
+            };
+            for (size_t nodeIdx = 0; packet.m_renderStaticShadows && nodeIdx < m_nodes.Size(); nodeIdx++) {
+                if (!m_shadowCache.IsDynamic(nodeIdx)) {
+                    addShadowCaster(packet.m_staticShadowDrawList, nodeIdx);
+                }
+            }
+            for (std::uint32_t nodeIdx : m_shadowCache.GetDynamicNodes()) {
+                addShadowCaster(packet.m_dynamicShadowDrawList, nodeIdx);
+            }
+
+            SortDrawList(packet.m_staticShadowDrawList);
+            SortDrawList(packet.m_dynamicShadowDrawList);
+            packet.m_commonData.m_shadowViewProjection = m_shadowCache.GetViewProjection();
+        }
+        RequestNodeData(packet);
+        packet.m_culledNodes = numCulledNodes.load();
+        packet.m_valid = true;
+    }
+
+    // Keeps the main pass' draw lists of `packet`, just built with `key` from `eyePos` looking along `viewDirection`, and
+    // the Nodes' texture requests so far, in m_drawListCache.
+    void CacheDrawLists(
+        const FramePacket& packet, const DrawListCacheKey& key, glm::vec3 eyePos, glm::vec3 viewDirection, size_t culledNodes)
+    {
+        GLITTER_PROFILE_SCOPE("Cache Draw Lists");
+        DrawListCache& cache = m_drawListCache;
+        cache.m_key = key;
+        cache.m_eyePos = eyePos;
+        cache.m_viewDirection = viewDirection;
+        cache.m_opaqueDrawList.assign(packet.m_opaqueDrawList.begin(), packet.m_opaqueDrawList.end());
+        cache.m_transparentDrawList.assign(packet.m_transparentDrawList.begin(), packet.m_transparentDrawList.end());
+        cache.m_impostorDrawList.assign(packet.m_impostorDrawList.begin(), packet.m_impostorDrawList.end());
+        for (size_t viewIdx = 0; viewIdx < packet.m_insetViewCount; viewIdx++) {
+            const InsetViewPacket& inset = packet.m_insetViews[viewIdx];
+            cache.m_insetOpaqueDrawLists[viewIdx].assign(inset.m_opaqueDrawList.begin(), inset.m_opaqueDrawList.end());
+            cache.m_insetTransparentDrawLists[viewIdx].assign(
+                inset.m_transparentDrawList.begin(), inset.m_transparentDrawList.end());
+        }
+        cache.m_cullStates.assign(packet.m_cullStates.begin(), packet.m_cullStates.end());
+        cache.m_textureRequests.assign(packet.m_textureRequests.begin(), packet.m_textureRequests.end());
+        cache.m_meshRequests.assign(packet.m_meshRequests.begin(), packet.m_meshRequests.end());
+        cache.m_culledNodes = culledNodes;
+        cache.m_occluders = packet.m_occluders;
+        cache.m_occludedNodes = packet.m_occludedNodes;
+        cache.m_distanceCulledNodes = packet.m_distanceCulledNodes;
+        cache.m_sizeCulledNodes = packet.m_sizeCulledNodes;
+    }
+
+    // Copies m_drawListCache into `packet`, in place of the main pass' draw lists it would build.
+    void CopyCachedDrawLists(FramePacket& packet) const
+    {
+        GLITTER_PROFILE_SCOPE("Copy Cached Draw Lists");
+        const DrawListCache& cache = m_drawListCache;
+        packet.m_opaqueDrawList.assign(cache.m_opaqueDrawList.begin(), cache.m_opaqueDrawList.end());
+        packet.m_transparentDrawList.assign(cache.m_transparentDrawList.begin(), cache.m_transparentDrawList.end());
+        packet.m_impostorDrawList.assign(cache.m_impostorDrawList.begin(), cache.m_impostorDrawList.end());
+        for (size_t viewIdx = 0; viewIdx < packet.m_insetViewCount; viewIdx++) {
+            InsetViewPacket& inset = packet.m_insetViews[viewIdx];
+            inset.m_opaqueDrawList.assign(
+                cache.m_insetOpaqueDrawLists[viewIdx].begin(), cache.m_insetOpaqueDrawLists[viewIdx].end());
+            inset.m_transparentDrawList.assign(
+                cache.m_insetTransparentDrawLists[viewIdx].begin(), cache.m_insetTransparentDrawLists[viewIdx].end());
+        }
+        packet.m_cullStates.assign(cache.m_cullStates.begin(), cache.m_cullStates.end());
+        packet.m_textureRequests.assign(cache.m_textureRequests.begin(), cache.m_textureRequests.end());
+        packet.m_meshRequests.assign(cache.m_meshRequests.begin(), cache.m_meshRequests.end());
+        packet.m_occluders = cache.m_occluders;
+        packet.m_occludedNodes = cache.m_occludedNodes;
+        packet.m_distanceCulledNodes = cache.m_distanceCulledNodes;
+        packet.m_sizeCulledNodes = cache.m_sizeCulledNodes;
+    }
+
+    // Takes the next cells to rebuild into `packet`, listing the batches of each: its Nodes grouped by texture and material,
+    // every Primitive of their Meshes a source, split into another batch past Config::STATIC_BATCH_MAX_VERTICES vertices
+    // or on another page of the geometry pool.
+    // Quantized vertices are quantized again to the box around the cell's Nodes, which becomes the batches' model matrix.
+    void TakeStaticBatchRebuilds(FramePacket& packet)
+    {
+        m_staticBatchRebuildCells.clear();
+        m_staticBatchCells.TakeRebuilds(
+            m_cullBounds, Glitter::Config::STATIC_BATCH_REBUILDS_PER_FRAME, m_staticBatchRebuildCells);
+
+        std::span<const std::uint32_t> meshIDs = m_nodes.MeshIDs();
+        std::span<const std::uint32_t> textureIDs = m_nodes.TextureIDs();
+        std::span<const std::uint32_t> materialIDs = m_nodes.MaterialIDs();
+        std::span<const glm::aligned_mat4> models = m_nodes.Models();
+        for (std::uint32_t cell : m_staticBatchRebuildCells) {
+            packet.m_staticBatchRebuilds.push_back(Glitter::Render::StaticBatchRebuild {
+                .m_cell = cell, .m_firstBatch = static_cast<std::uint32_t>(packet.m_staticBatchDescs.size()), .m_batchCount = 0});
+            Glitter::Render::StaticBatchRebuild& rebuild = packet.m_staticBatchRebuilds.back();
+
+            glm::mat4 dequantize {1.0f};
+            if (Glitter::Config::ENABLE_QUANTIZED_VERTICES) {
+                glm::vec3 extent = glm::max(m_staticBatchCells.GetExtent(cell), glm::vec3(1e-4f));
+                dequantize = glm::translate(glm::mat4(1.0f), m_staticBatchCells.GetCenter(cell) - extent)
+                    * glm::scale(glm::mat4(1.0f), extent * 2.0f);
+            }
+            glm::mat4 quantize = glm::inverse(dequantize);
+
+            std::span<const std::uint32_t> cellNodes = m_staticBatchCells.GetNodes(cell);
+            m_staticBatchNodes.assign(cellNodes.begin(), cellNodes.end());
+            std::ranges::sort(m_staticBatchNodes, {}, [&](std::uint32_t nodeIdx) {
+                return std::pair(textureIDs[nodeIdx], materialIDs[nodeIdx]);
+            });
+            GLuint batchVertices = 0;
+            for (std::uint32_t nodeIdx : m_staticBatchNodes) {
+                const Mesh& mesh = m_meshes[meshIDs[nodeIdx]];
+                glm::mat4 transform = quantize * glm::mat4(models[nodeIdx]) * mesh.m_dequantize;
+                for (const Primitive& primitive : mesh.m_primitives) {
+                    Glitter::Render::StaticBatchDesc* batch
+                        = rebuild.m_batchCount == 0 ? nullptr : &packet.m_staticBatchDescs.back();
+                    if (!batch || batch->m_texture != textureIDs[nodeIdx] || batch->m_material != materialIDs[nodeIdx]
+                        || batch->m_page != primitive.m_page
+                        || batchVertices + primitive.m_vertexCount > Glitter::Config::STATIC_BATCH_MAX_VERTICES) {
+                        batch = &packet.m_staticBatchDescs.emplace_back(
+                            Glitter::Render::StaticBatchDesc {.m_dequantize = dequantize,
+                                .m_texture = textureIDs[nodeIdx],
+                                .m_material = materialIDs[nodeIdx],
+                                .m_page = primitive.m_page,
+                                .m_firstSource = static_cast<std::uint32_t>(packet.m_staticBatchSources.size()),
+                                .m_sourceCount = 0});
+                        rebuild.m_batchCount++;
+                        batchVertices = 0;
+                    }
+
+                    // The HLOD proxies are built from the coarsest LOD, or from the Primitive itself without any.
+                    GLuint proxyFirstIndex
+                        = primitive.m_lods.empty() ? primitive.m_firstIndex : primitive.m_lods.back().m_firstIndex;
+                    GLsizei proxyElementCount
+                        = primitive.m_lods.empty() ? primitive.m_elementCount : primitive.m_lods.back().m_elementCount;
+                    packet.m_staticBatchSources.push_back(Glitter::Render::StaticBatchSource {.m_transform = transform,
+                        .m_baseVertex = primitive.m_baseVertex,
+                        .m_firstIndex = primitive.m_firstIndex,
+                        .m_vertexCount = primitive.m_vertexCount,
+                        .m_indexCount = static_cast<GLuint>(primitive.m_elementCount),
+                        .m_proxyFirstIndex = proxyFirstIndex,
+                        .m_proxyIndexCount = Glitter::Config::ENABLE_HLOD ? static_cast<GLuint>(proxyElementCount) : 0});
+                    batch->m_sourceCount++;
+                    batchVertices += primitive.m_vertexCount;
+                }
+            }
+        }
+    }
+
+    // Queues the GPU bounds of `nodes` for upload, and flags their PerDrawData as stale until they're drawn, see
+    // RequestNodeData(). Forgets the Nodes past the end of the store.
+    void MarkNodeDataStale(std::span<const std::uint32_t> nodes)
+    {
+        for (size_t nodeIdx = m_nodes.Size(); nodeIdx < m_nodeDataStale.size(); nodeIdx++) {
+            m_staleNodeCount -= m_nodeDataStale[nodeIdx];
+        }
+        m_nodeDataStale.resize(m_nodes.Size(), 0);
+
+        for (std::uint32_t nodeIdx : nodes) {
+            m_nodeBoundsDirty.Add(nodeIdx);
+            m_staleNodeCount += 1 - m_nodeDataStale[nodeIdx];
+            m_nodeDataStale[nodeIdx] = 1;
+        }
+    }
+
+    // Radix sorts `list` by its packed keys, spread over the job system past Config::PARALLEL_SORT_THRESHOLD entries. Once
+    // the Nodes span several Node data pages, a list drawn in any order is sorted by page again, which keeps the order of
+    // the keys within each page, so that its batches aren't split at every change of page, see BindNodePage().
+    void SortDrawList(std::vector<DrawListEntry>& list, bool anyOrder = true)
+    {
+        if (m_drawListScratch.size() < list.size()) {
+            m_drawListScratch.resize(list.size());
+        }
+        auto sort = [&](auto getKey) {
+            if (list.size() > Glitter::Config::PARALLEL_SORT_THRESHOLD) {
+                Glitter::Util::ParallelRadixSort(m_jobSystem, std::span(list), std::span(m_drawListScratch), getKey,
+                    Glitter::Config::PARALLEL_SORT_GRAIN_SIZE);
+            } else {
+                Glitter::Util::RadixSort(std::span(list), std::span(m_drawListScratch), getKey);
+            }
+        };
+        sort([](const DrawListEntry& entry) { return entry.m_sortKey; });
+        if (anyOrder && m_nodes.Size() > Glitter::Config::NODE_PAGE_SIZE) {
+            sort([](const DrawListEntry& entry) {
+                return static_cast<std::uint64_t>(entry.m_node / Glitter::Config::NODE_PAGE_SIZE);
+            });
+        }
+    }
+
+    // Queues the stale PerDrawData of the Nodes `packet` draws for upload. The culled Nodes keep theirs stale until they're
+    // drawn, so that the Nodes changing off-screen cost no upload, and what's uploaded tracks what's on screen. The GPU
+    // culling and the AABB debug view read every Node's data, so they flush every stale Node instead.
+    void RequestNodeData(const FramePacket& packet)
+    {
+        GLITTER_PROFILE_SCOPE("Request Node Data");
+        auto request = [this](std::uint32_t nodeIdx) {
+            if (m_nodeDataStale[nodeIdx] != 0) {
+                m_nodeDataStale[nodeIdx] = 0;
+                m_staleNodeCount--;
+                m_nodeDataDirty.Add(nodeIdx);
+            }
+        };
+
+        if (packet.m_gpuCulling || (m_debugLines && m_drawAABBs)) {
+            for (std::uint32_t nodeIdx = 0; m_staleNodeCount > 0 && nodeIdx < m_nodeDataStale.size(); nodeIdx++) {
+                request(nodeIdx);
+            }
+            return;
+        }
+
+        for (const std::vector<DrawListEntry>* drawList : {&packet.m_opaqueDrawList, &packet.m_transparentDrawList,
+                 &packet.m_impostorDrawList, &packet.m_staticShadowDrawList, &packet.m_dynamicShadowDrawList}) {
+            for (const DrawListEntry& entry : *drawList) {
+                request(entry.m_node);
+            }
+        }
+        for (size_t viewIdx = 0; viewIdx < packet.m_insetViewCount; viewIdx++) {
+            for (const DrawListEntry& entry : packet.m_insetViews[viewIdx].m_opaqueDrawList) {
+                request(entry.m_node);
+            }
+            for (const DrawListEntry& entry : packet.m_insetViews[viewIdx].m_transparentDrawList) {
+                request(entry.m_node);
+            }
+        }
+    }
+
+    // Builds the Dear ImGui windows from the stats of `packet`, on the main thread before the next packet's update reads
+    // the settings they edit.
+    void BuildDebugUi(const FramePacket& packet)
+    {
+        GLITTER_PROFILE_SCOPE("ImGui Build");
+
+        ImGui::Begin("Glitter Debug");
+        if (ImGui::CollapsingHeader("Performance", ImGuiTreeNodeFlags_DefaultOpen)) {
+            ImGui::Checkbox("Frustum Culling", &m_frustumCulling);
+            ImGui::SameLine();
+            ImGui::Checkbox("BVH Culling", &m_bvhCulling);
+            ImGui::BeginDisabled(m_textureMode == TextureMode::Bound);
+            ImGui::Checkbox("GPU Culling", &m_gpuCulling);
+            ImGui::EndDisabled();
+            ImGui::SameLine();
+            ImGui::BeginDisabled(!m_gpuCulling);
+            ImGui::Checkbox("Occlusion Culling", &m_occlusionCulling);
+            ImGui::SameLine();
+            ImGui::Checkbox("Meshlet Culling", &m_meshletCulling);
+            ImGui::EndDisabled();
+            ImGui::BeginDisabled(m_gpuCulling || m_stereo);
+            ImGui::Checkbox("CPU Occlusion Culling", &m_cpuOcclusionCulling);
+            ImGui::EndDisabled();
+            ImGui::SameLine();
+            ImGui::Text("(%zu occluders, %zu Nodes hidden)", packet.m_occluders, packet.m_occludedNodes);
+            ImGui::BeginDisabled(m_gpuCulling || m_visibilityBuffer);
+            ImGui::Checkbox("Occlusion Queries", &m_occlusionQueries);
+            ImGui::EndDisabled();
+            ImGui::SameLine();
+            ImGui::Text("(%zu issued)", m_occlusionQueryPool.GetQueryCount());
+            ImGui::BeginDisabled(m_gpuCulling);
+            ImGui::Checkbox("Mesh LODs", &m_meshLods);
+            ImGui::EndDisabled();
+            ImGui::SameLine();
+            ImGui::Checkbox("Contribution Culling", &m_contributionCulling);
+            if (m_contributionCulling) {
+                ImGui::SliderFloat("Max Draw Distance", &m_maxDrawDistance, 1.0f, 50.0f);
+                ImGui::SliderFloat("Min Projected Pixels", &m_minProjectedPixels, 0.0f, 16.0f);
+            }
+            ImGui::BeginDisabled(m_gpuCulling || m_impostorAtlas.GetLayerCount() == 0);
+            ImGui::Checkbox("Impostors", &m_impostors);
+            ImGui::EndDisabled();
+            ImGui::SameLine();
+            ImGui::Text("(%zu drawn, %u/%u Meshes baked)", packet.m_impostorDrawList.size(), m_impostorAtlas.GetBakedCount(),
+                m_impostorAtlas.GetLayerCount());
+            ImGui::BeginDisabled(m_gpuCulling || (m_visibilityBuffer && m_textureMode != TextureMode::Bound));
+            ImGui::Checkbox("Static Batching", &m_staticBatching);
+            ImGui::EndDisabled();
+            ImGui::SameLine();
+            ImGui::Text("(%zu Nodes in %zu batches, %zu cells queued)", packet.m_staticBatchedNodes,
+                m_staticBatches.GetBatchCount(), m_staticBatchCells.GetQueuedCount());
+            if (Glitter::Config::ENABLE_HLOD) {
+                ImGui::BeginDisabled(!packet.m_staticBatching);
+                ImGui::Checkbox("HLOD", &m_hlod);
+                ImGui::EndDisabled();
+                ImGui::SameLine();
+                ImGui::Text("(%zu of %zu cells drawn from their proxies)", packet.m_hlodCells.size(),
+                    packet.m_staticBatchCells.size() + packet.m_hlodCells.size());
+            }
+            ImGui::Checkbox("Draw List Caching", &m_drawListCaching);
+            ImGui::SameLine();
+            ImGui::Text("(%s)", packet.m_drawListsCached ? "cached" : "rebuilt");
+            ImGui::Checkbox("Pipelined Update", &m_framePipelining);
+            ImGui::SameLine();
+            ImGui::Checkbox("Early Flush", &m_earlyFlush);
+            ImGui::SameLine();
+            ImGui::Checkbox("CPU Timeline", &m_showCpuTimeline);
+            ImGui::SameLine();
+            ImGui::Checkbox("Log", &m_showLog);
+            ImGui::SameLine();
+            ImGui::BeginDisabled(m_cpuProfiler.IsCapturing());
+            if (ImGui::Button("Capture CPU Trace")) {
+                m_cpuProfiler.StartCapture(Glitter::Config::CPU_TRACE_FRAMES, "glitter_trace.json");
+            }
+            ImGui::EndDisabled();
+            constexpr std::array textureModeNames = std::to_array<const char*>({"Bound", "Bindless", "Array"});
+            ImGui::Text("Texture Mode: %s", textureModeNames[static_cast<size_t>(m_textureMode)]);
+            if (Glitter::Config::ENABLE_TEXTURE_STREAMING) {
+                ImGui::Text("Streamed Textures: %zu/%zu KiB", m_textureStreamer.GetResidentSize() / 1024,
+                    m_textureStreamer.GetBudget() / 1024);
+            }
+            if (Glitter::Config::ENABLE_MESH_STREAMING) {
+                ImGui::Text("Streamed Mesh LODs: %zu/%zu KiB", m_meshStreamer.GetResidentSize() / 1024,
+                    m_meshStreamer.GetBudget() / 1024);
+            }
+            ImGui::Text("Geometry Pool Pages: %zu", m_geometryPool.GetPageCount());
+            ImGui::Text("Node Data Pages: %u", m_nodeDataBuffer.GetPageCount());
+            ImGui::Text("Node Uploads: %zu ranges, %zu bytes, %zu culled Nodes stale", m_nodeUploadRanges, m_nodeUploadBytes,
+                m_staleNodeCount);
+            ImGui::Text("Early Flushes: %zu", m_submitFlusher.GetFlushCount());
+            ImGui::Text("Frame Arena: %zu/%zu KiB", m_frameArena.GetUsed() / 1024, m_frameArena.GetCapacity() / 1024);
+            ImGui::Text("SIMD: %s (culling %s, occlusion %s)", Glitter::Core::GetSimdLevelName(Glitter::Core::GetSimdLevel()),
+                Glitter::Core::GetSimdLevelName(Glitter::Render::GetCullSimdLevel()),
+                Glitter::Core::GetSimdLevelName(Glitter::Render::GetOcclusionSimdLevel()));
+            if (packet.m_gpuCulling) {
+                // As of the latest pass the GPU is done with, frames ago.
+                if (std::optional<Glitter::Render::GpuCullReadback> readback = m_gpuCullStatistics.GetLatest()) {
+                    const Glitter::Render::GpuCullCounts& counts = readback->m_counts;
+                    size_t culledNodes = static_cast<size_t>(counts.m_frustumCulledNodes) + counts.m_contributionCulledNodes
+                        + counts.m_occlusionCulledNodes;
+                    ImGui::Text("Culled Nodes: %zu/%zu (%.2f%%), %llu frames ago", culledNodes, readback->m_nodeCount,
+                        readback->m_nodeCount != 0
+                            ? static_cast<float>(culledNodes) / static_cast<float>(readback->m_nodeCount) * 100.0f
+                            : 0.0f,
+                        static_cast<unsigned long long>(readback->m_age));
+                    ImGui::Text("(%u frustum, %u far or small, %u occluded)", counts.m_frustumCulledNodes,
+                        counts.m_contributionCulledNodes, counts.m_occlusionCulledNodes);
+                    ImGui::Text("Visible Nodes by LOD size: %u/%u/%u/%u", counts.m_lodNodes[0], counts.m_lodNodes[1],
+                        counts.m_lodNodes[2], counts.m_lodNodes[3]);
+                } else {
+                    ImGui::Text("Culled Nodes: (on the GPU)/%zu", m_nodes.Size());
+                }
+            } else {
+                size_t culledNodes = packet.m_culledNodes;
+                ImGui::Text("Culled Nodes: %zu/%zu (%.2f%%)", culledNodes, m_nodes.Size(),
+                    !m_nodes.Empty() ? static_cast<float>(culledNodes) / static_cast<float>(m_nodes.Size()) * 100.0f : 0.0f);
+                if (m_contributionCulling) {
+                    ImGui::SameLine();
+                    ImGui::Text("(+%zu far, +%zu small)", packet.m_distanceCulledNodes, packet.m_sizeCulledNodes);
+                }
+            }
+            if (ImGui::Button("Remove Nodes", ImVec2(ImGui::GetContentRegionAvail().x * 0.5f, 0.0f))) {
+                RemoveNodes(Glitter::Config::NODES_PER_SPAWN);
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Clear Nodes", ImVec2(-1.0f, 0.0f))) {
+                m_nodes.Clear();
+                m_worldStreaming = false;
+            }
+            if (ImGui::Button("Save Scene", ImVec2(ImGui::GetContentRegionAvail().x * 0.5f, 0.0f))) {
+                SaveSceneSnapshot(Glitter::Config::SCENE_SNAPSHOT_PATH);
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Load Scene", ImVec2(-1.0f, 0.0f))) {
+                LoadSceneSnapshot(Glitter::Config::SCENE_SNAPSHOT_PATH);
+            }
+            // Records the camera and the key events until stopped, or plays the latest recording back.
+            ImGui::BeginDisabled(m_cameraPlayback.has_value());
+            if (ImGui::Button(m_cameraRecording ? "Stop Recording" : "Record Camera",
+                    ImVec2(ImGui::GetContentRegionAvail().x * 0.5f, 0.0f))) {
+                if (m_cameraRecording) {
+                    StopCameraRecording();
+                } else {
+                    StartCameraRecording();
+                }
+            }
+            ImGui::EndDisabled();
+            ImGui::SameLine();
+            ImGui::BeginDisabled(m_cameraRecording.has_value());
+            if (ImGui::Button(m_cameraPlayback ? "Stop Playback" : "Play Camera", ImVec2(-1.0f, 0.0f))) {
+                if (m_cameraPlayback) {
+                    m_cameraPlayback.reset();
+                } else if (std::optional<Glitter::Core::CameraRecording> recording
+                           = Glitter::Core::ReadCameraRecording(Glitter::Config::CAMERA_RECORDING_PATH)) {
+                    StartCameraPlayback(std::move(*recording));
+                }
+            }
+            ImGui::EndDisabled();
+            // Read back without stalling, and written a few frames later.
+            if (ImGui::Button("Capture Frame", ImVec2(-1.0f, 0.0f))) {
+                m_captureRequested = true;
+            }
+            if (m_cameraRecording) {
+                ImGui::Text("Recording: %zu frames", m_cameraRecording->m_frames.size());
+            } else if (m_cameraPlayback) {
+                ImGui::Text("Playback: frame %zu/%zu", m_playbackFrame, m_cameraPlayback->m_frames.size());
+            }
+            // Despawns and respawns Nodes every frame, the way short-lived effects would.
+            ImGui::Checkbox("Churn Nodes", &m_nodeChurn);
+            if (m_nodeChurn) {
+                RemoveNodes(Glitter::Config::NODES_PER_SPAWN);
+                SpawnNodes(Glitter::Config::NODES_PER_SPAWN);
+            }
+            ImGui::Checkbox("Animate Spawned Nodes", &m_animateSpawnedNodes);
+            ImGui::Checkbox("Stream World", &m_worldStreaming);
+            ImGui::SameLine();
+            ImGui::Text("(%zu/%zu chunks, %zu loading)", m_worldStreamer.GetLoadedCount() - m_pendingWorldChunks.size(),
+                m_worldStreamer.GetChunkCount(), m_worldStreamer.GetRequestedCount() + m_pendingWorldChunks.size());
+            // The swarm is only drawn at its simulated positions by the GPU culling pass, it's removed without it.
+            ImGui::BeginDisabled(!m_gpuCulling);
+            if (ImGui::Button("Spawn Swarm", ImVec2(ImGui::GetContentRegionAvail().x * 0.5f, 0.0f))) {
+                SpawnSwarm(Glitter::Config::NODES_PER_SPAWN);
+            }
+            ImGui::EndDisabled();
+            ImGui::SameLine();
+            if (ImGui::Button("Clear Swarm", ImVec2(-1.0f, 0.0f)) || (!m_gpuCulling && m_nodeSwarm.GetAgentCount() > 0)) {
+                ClearSwarm();
+            }
+            ImGui::Text("Swarm: %zu Nodes simulated on the GPU", m_nodeSwarm.GetAgentCount());
+            ImGui::Checkbox("Play Animations", &m_playAnimations);
+            ImGui::SameLine();
+            ImGui::Text("(%zu Nodes, %zu channels)", m_animationPlayer.GetNodeCount(), m_animationPlayer.GetChannelCount());
+            ImGui::Text("Skinned: %zu Nodes, %zu vertices", m_skinnedMeshes.GetInstanceCount(), m_skinnedMeshes.GetVertexCount());
+
+            // Presentation and frame pacing, and the latency they result in.
+            auto presentMode = static_cast<int>(m_framePacing.m_presentMode);
+            ImGui::Combo("Present Mode", &presentMode, "VSync\0Adaptive VSync\0Uncapped\0Limited\0");
+            m_framePacing.m_presentMode = static_cast<Glitter::Render::PresentMode>(presentMode);
+            ImGui::BeginDisabled(m_framePacing.m_presentMode != Glitter::Render::PresentMode::Limited);
+            auto frameLimit = static_cast<float>(m_framePacing.m_frameLimit);
+            ImGui::SliderFloat("Frame Limit", &frameLimit, 30.0f, 360.0f, "%.0f FPS", ImGuiSliderFlags_AlwaysClamp);
+            m_framePacing.m_frameLimit = frameLimit;
+            ImGui::EndDisabled();
+            auto frameSync = static_cast<int>(m_framePacing.m_sync);
+            ImGui::Combo("Frame Sync", &frameSync, "Driver\0Fence\0glFinish\0Just in Time\0");
+            m_framePacing.m_sync = static_cast<Glitter::Render::FrameSync>(frameSync);
+            ImGui::BeginDisabled(m_framePacing.m_sync != Glitter::Render::FrameSync::Fence);
+            auto maxFramesInFlight = static_cast<int>(m_framePacing.m_maxFramesInFlight);
+            ImGui::SliderInt("Max Frames in Flight", &maxFramesInFlight, 1, static_cast<int>(Glitter::Config::FRAMES_IN_FLIGHT));
+            m_framePacing.m_maxFramesInFlight = static_cast<size_t>(maxFramesInFlight);
+            ImGui::EndDisabled();
+            ImGui::Text("Input Latency: %.2f ms (%.2f ms average)", m_framePacer.GetLatency(), m_framePacer.GetAverageLatency());
+            if (m_framePacing.m_sync == Glitter::Render::FrameSync::JustInTime) {
+                ImGui::Text("Frame Delay: %.2f ms", m_framePacer.GetFrameDelay());
+            }
+            ImGui::Checkbox("Render On Demand", &m_renderOnDemand);
+
+            // Frame times, and the latest frames that took much longer than the median.
+            const auto& history = m_frameStats.GetHistory();
+            std::pmr::string overlay(&m_frameArena);
+            std::format_to(std::back_inserter(overlay), "median {:.2f} ms, max {:.2f} ms", m_frameStats.GetMedian(),
+                m_frameStats.GetMax());
+            ImGui::PlotLines("##Frame Times", history.data(), static_cast<int>(history.size()),
+                static_cast<int>(m_frameStats.GetHistoryOffset()), overlay.c_str(), 0.0f, m_frameStats.GetMax() * 1.1f,
+                ImVec2(-1.0f, 60.0f));
+
+            // Bucket the frame times up to twice the stutter threshold, the last bucket holding everything above.
+            std::array<float, 32> histogram {};
+            float histogramMax = std::max(m_frameStats.GetMedian() * Glitter::Config::STUTTER_FACTOR * 2.0f, 1.0f);
+            for (size_t frameIdx = 0; frameIdx < m_frameStats.GetHistoryCount(); frameIdx++) {
+                auto bucket = static_cast<size_t>(history[frameIdx] / histogramMax * static_cast<float>(histogram.size()));
+                histogram[std::min(bucket, histogram.size() - 1)] += 1.0f;
+            }
+            std::pmr::string histogramOverlay(&m_frameArena);
+            std::format_to(std::back_inserter(histogramOverlay), "0 to {:.1f} ms", histogramMax);
+            ImGui::PlotHistogram("##Frame Time Histogram", histogram.data(), static_cast<int>(histogram.size()), 0,
+                histogramOverlay.c_str(), 0.0f, FLT_MAX, ImVec2(-1.0f, 60.0f));
+
+            if (Glitter::Config::ENABLE_ALLOCATION_TRACKING) {
+                ImGui::Text("Allocations: %llu (%.1f KiB) last frame",
+                    static_cast<unsigned long long>(m_frameAllocations.m_allocations),
+                    static_cast<double>(m_frameAllocations.m_bytes) / 1024.0);
+            }
+            if (m_renderDoc.IsConnected()) {
+                if (ImGui::Button("RenderDoc Capture (F11)")) {
+                    m_renderDoc.TriggerCapture("requested");
+                }
+                ImGui::SameLine();
+                ImGui::Checkbox("Capture Stutters", &m_captureStutters);
+                ImGui::SameLine();
+                ImGui::Text("%u/%u captured", m_stutterCaptures, Glitter::Config::RENDERDOC_MAX_STUTTER_CAPTURES);
+            }
+            if (m_glTrace.IsEnabled() && ImGui::Button("GL Trace (F10)")) {
+                m_glTrace.TriggerCapture();
+            }
+            if (ImGui::TreeNode("GPU Memory")) {
+                constexpr double MIB = 1024.0 * 1024.0;
+                std::array<Glitter::Render::GpuMemoryUsage, Glitter::Render::GPU_MEMORY_CATEGORY_COUNT> gpuMemory =
+                    Glitter::Render::GetGpuMemoryUsage();
+                size_t totalBytes = 0;
+                for (size_t categoryIdx = 0; categoryIdx < gpuMemory.size(); categoryIdx++) {
+                    ImGui::Text("%s: %.1f MiB (%zu objects)",
+                        Glitter::Render::GetGpuMemoryCategoryName(static_cast<Glitter::Render::GpuMemoryCategory>(categoryIdx)),
+                        static_cast<double>(gpuMemory[categoryIdx].m_bytes) / MIB, gpuMemory[categoryIdx].m_objects);
+                    totalBytes += gpuMemory[categoryIdx].m_bytes;
+                }
+                ImGui::Text("Total: %.1f MiB", static_cast<double>(totalBytes) / MIB);
+                if (std::optional<Glitter::Render::GpuMemoryInfo> memoryInfo = Glitter::Render::QueryGpuMemoryInfo()) {
+                    ImGui::Text("Driver: %.1f MiB available", static_cast<double>(memoryInfo->m_availableBytes) / MIB);
+                    if (memoryInfo->m_dedicatedBytes > 0) {
+                        ImGui::Text("Driver: %.1f MiB dedicated, %.1f MiB evicted",
+                            static_cast<double>(memoryInfo->m_dedicatedBytes) / MIB,
+                            static_cast<double>(memoryInfo->m_evictedBytes) / MIB);
+                    }
+                } else {
+                    ImGui::TextUnformatted("Driver: no memory info extension");
+                }
+                ImGui::TreePop();
+            }
+            if (ImGui::TreeNode("Stutters", "Stutters (%zu)", m_frameStats.GetStutters().size())) {
+                for (const auto& stutter : m_frameStats.GetStutters() | std::views::reverse) {
+                    ImGui::Text("Frame %zu: %.2f ms (%.1fx median), %s", stutter.m_frame, stutter.m_milliseconds,
+                        stutter.m_milliseconds / stutter.m_median,
+                        Glitter::Core::DescribeFrameActivity(stutter.m_activities).c_str());
+                }
+                ImGui::TreePop();
+            }
+
+            // Counters of the previous frame, and the pipeline statistics of a few frames ago.
+            const Glitter::Render::RenderCounters& counters = m_renderStats.GetCounters();
+            ImGui::Text("Draw Calls: %zu (%zu commands, %zu triangles)", counters.m_drawCalls, counters.m_drawCommands,
+                counters.m_triangles);
+            ImGui::Text("Binds: %zu programs, %zu VAOs, %zu buffers, %zu textures", counters.m_programBinds,
+                counters.m_vertexArrayBinds, counters.m_bufferBinds, counters.m_textureBinds);
+            ImGui::Text("State Changes: %zu, %zu redundant calls skipped", counters.m_stateChanges, counters.m_redundantCalls);
+            ImGui::Text("Uploaded: %zu bytes", counters.m_uploadedBytes);
+            const Glitter::Render::PipelineStatistics& statistics = m_renderStats.GetPipelineStatistics();
+            ImGui::Text("Primitives: %zu submitted, %zu clipping in, %zu clipping out", statistics.m_primitivesSubmitted,
+                statistics.m_clippingInputPrimitives, statistics.m_clippingOutputPrimitives);
+            ImGui::Text("Invocations: %zu VS, %zu FS", statistics.m_vertexShaderInvocations,
+                statistics.m_fragmentShaderInvocations);
+
+            // GPU times of the passes, read back a few frames late.
+            for (const auto& scope : m_gpuProfiler.GetScopes()) {
+                ImGui::Text("%*s%s: %.3f ms (avg. %.3f ms)", static_cast<int>(scope.m_depth * 2), "", scope.m_name.c_str(),
+                    scope.m_milliseconds, scope.m_averageMilliseconds);
+            }
+            BuildBatchCostUi();
+            const Glitter::Render::RenderGraphStats& graphStats = m_renderGraph.GetStats();
+            ImGui::Text("Render Graph: %zu passes, %zu culled, %zu transient textures in %zu targets, %zu invalidations",
+                graphStats.m_passes, graphStats.m_culledPasses.size(), graphStats.m_transientTextures,
+                graphStats.m_transientTargets, graphStats.m_invalidations);
+            for (const char* pass : graphStats.m_culledPasses) {
+                ImGui::Text("  Culled: %s", pass);
+            }
+        }
+        if (ImGui::CollapsingHeader("Scene Generator")) {
+            // Replaces the Nodes with a stress scene, saved with "Save Scene" to be benchmarked with `--benchmark-scene`.
+            Glitter::Scene::SceneGeneratorSettings& settings = m_generatorSettings;
+            auto nodeCount = static_cast<int>(settings.m_nodeCount);
+            auto meshCount = static_cast<int>(std::min(settings.m_meshCount, m_spawnableMeshes.size()));
+            auto textureCount = static_cast<int>(std::min(settings.m_textureCount, m_textureCount));
+            auto materialCount = static_cast<int>(settings.m_materialCount);
+            auto clusterCount = static_cast<int>(settings.m_clusterCount);
+            auto distribution = static_cast<int>(settings.m_distribution);
+            ImGui::DragInt("Nodes", &nodeCount, 100.0f, 0, 1'000'000, "%d", ImGuiSliderFlags_AlwaysClamp);
+            ImGui::SliderInt("Meshes", &meshCount, 1, std::max(static_cast<int>(m_spawnableMeshes.size()), 1));
+            ImGui::SliderInt("Textures", &textureCount, 1, std::max(static_cast<int>(m_textureCount), 1));
+            ImGui::SliderInt("Materials", &materialCount, 0, static_cast<int>(m_materials.size()), materialCount == 0 ? "Per Mesh" : "%d");
+            ImGui::Combo("Distribution", &distribution, "Uniform\0Clustered\0Shell\0");
+            ImGui::SliderFloat("Radius", &settings.m_radius, 1.0f, 100.0f);
+            ImGui::BeginDisabled(distribution != static_cast<int>(Glitter::Scene::SceneDistribution::Clustered));
+            ImGui::SliderInt("Clusters", &clusterCount, 1, 256);
+            ImGui::SliderFloat("Cluster Radius", &settings.m_clusterRadius, 0.1f, 10.0f);
+            ImGui::EndDisabled();
+            ImGui::SliderFloat("Transparent", &settings.m_transparentRatio, 0.0f, 1.0f);
+            ImGui::SliderFloat("Animated", &settings.m_animatedRatio, 0.0f, 1.0f);
+            settings.m_nodeCount = static_cast<size_t>(nodeCount);
+            settings.m_meshCount = static_cast<size_t>(meshCount);
+            settings.m_textureCount = static_cast<size_t>(textureCount);
+            settings.m_materialCount = static_cast<size_t>(materialCount);
+            settings.m_clusterCount = static_cast<size_t>(clusterCount);
+            settings.m_distribution = static_cast<Glitter::Scene::SceneDistribution>(distribution);
+            if (ImGui::Button("Generate Scene", ImVec2(-1.0f, 0.0f))) {
+                GenerateStressScene(settings);
+            }
+        }
+        if (ImGui::CollapsingHeader("Debug View", ImGuiTreeNodeFlags_DefaultOpen)) {
+            if (Glitter::Config::ENABLE_DEBUG_DRAW) {
+                ImGui::Checkbox("Debug Lines", &m_debugLines);
+                ImGui::SameLine();
+                ImGui::Checkbox("Draw AABBs", &m_drawAABBs);
+                ImGui::SameLine();
+                ImGui::Checkbox("Draw Lights", &m_drawLights);
+                ImGui::SameLine();
+                ImGui::Checkbox("Framebuffer View", &m_showFramebufferView);
+            }
+            ImGui::Checkbox("Textures", &m_drawTextures);
+            auto debugView = static_cast<int>(m_debugView);
+            ImGui::Combo("View", &debugView, "Shaded\0Normals\0Overdraw\0Quad Overdraw\0Triangle Density\0LOD\0Cull State\0");
+            m_debugView = static_cast<DebugView>(debugView);
+
+            // Clicking outside the UI picks the Node under the cursor in the next update, or unpicks it.
+            const ImGuiIO& io = ImGui::GetIO();
+            if (ImGui::IsMouseClicked(ImGuiMouseButton_Left) && !io.WantCaptureMouse) {
+                m_pickRequest = glm::vec2(io.MousePos.x / io.DisplaySize.x, 1.0f - io.MousePos.y / io.DisplaySize.y) * 2.0f - 1.0f;
+            }
+            if (m_pickedNode && m_nodes.IsValid(*m_pickedNode)) {
+                size_t pickedIdx = m_nodes.GetNode(*m_pickedNode);
+                ImGui::Text("Picked Node %zu (Mesh %u), %zu Nodes within %.1f", pickedIdx, m_nodes.MeshIDs()[pickedIdx],
+                    m_pickedNeighbors.size(), static_cast<double>(Glitter::Config::PICK_NEIGHBOR_RADIUS));
+            } else {
+                ImGui::TextUnformatted("Click a Node to pick it");
+            }
+            ImGui::Text("Spatial Grid: %zu Nodes (%zu large) in %zu buckets", m_spatialGrid.GetItemCount(),
+                m_spatialGrid.GetLargeItemCount(), m_spatialGrid.GetBucketCount());
+        }
+        ImGui::SeparatorText("Scene Properties");
+        ImGui::SliderFloat("Scene Gamma", &m_postProcessSettings.m_gamma, 0.0f, 5.0f, "%.2f", ImGuiSliderFlags_AlwaysClamp);
+        ImGui::Checkbox("Tonemap", &m_postProcessSettings.m_tonemap);
+        ImGui::SameLine();
+        ImGui::Checkbox("Bloom", &m_postProcessSettings.m_bloom);
+        ImGui::SameLine();
+        ImGui::Checkbox("FXAA", &m_postProcessSettings.m_fxaa);
+        ImGui::SameLine();
+        ImGui::Checkbox("Elide Empty Pass", &m_postProcessSettings.m_elidePasses);
+        ImGui::Checkbox("Packed HDR Color (R11G11B10F)", &m_packedHdrColor);
+        ImGui::Checkbox("Weighted Blended OIT", &m_weightedOit);
+        ImGui::SliderFloat("Texture Mip Bias", &m_textureMipBias, -2.0f, 2.0f, "%.2f");
+        ImGui::SameLine();
+        ImGui::Text("%.0fx anisotropic", static_cast<double>(m_textureAnisotropy));
+        ImGui::BeginDisabled(m_textureMode == TextureMode::Bound);
+        ImGui::Checkbox("Visibility Buffer", &m_visibilityBuffer);
+        ImGui::EndDisabled();
+        ImGui::Checkbox("Shadows", &m_shadows);
+        ImGui::SameLine();
+        ImGui::Text("%zu dynamic Nodes, cache rendered %zu times", m_shadowCache.GetDynamicNodes().size(),
+            m_shadowCache.GetStaticRenders());
+        ImGui::SliderInt("Point Lights", &m_pointLightCount, 0, static_cast<int>(Glitter::Config::POINT_LIGHT_COUNT));
+        const Glitter::Render::LightClusterStats& lightStats = m_lightClusters.GetStats();
+        ImGui::Text("%zu visible, %zu cluster entries, at most %zu per cluster", lightStats.m_visibleLights,
+            lightStats.m_lightIndices, lightStats.m_maxClusterLights);
+        auto depthPrepassMode = static_cast<int>(m_depthPrepassMode);
+        ImGui::Combo("Depth Pre-Pass", &depthPrepassMode, "Off\0On\0Auto\0");
+        m_depthPrepassMode = static_cast<Glitter::Render::DepthPrepassMode>(depthPrepassMode);
+        ImGui::SameLine();
+        ImGui::Text("%.2fx overdraw%s", m_depthPrepass.GetOverdraw(),
+            m_depthPrepass.IsEnabled(m_depthPrepassMode) ? ", enabled" : "");
+        ImGui::BeginDisabled(!m_shadingRateImage.IsSupported());
+        auto shadingRateMode = static_cast<int>(m_shadingRateMode);
+        ImGui::Combo("Shading Rate", &shadingRateMode, "Off\0Foveated\0Content Adaptive\0");
+        m_shadingRateMode = static_cast<Glitter::Render::ShadingRateMode>(shadingRateMode);
+        ImGui::EndDisabled();
+        ImGui::Checkbox("Dynamic Resolution", &m_dynamicResolution);
+        ImGui::SameLine();
+        ImGui::Text("%dx%d (%.0f%%)", m_renderWidth, m_renderHeight, m_resolutionScaler.GetScale() * 100.0f);
+        ImGui::Checkbox("Adaptive Quality", &m_adaptiveQuality);
+        {
+            const Glitter::Render::QualityLevel& level = m_qualityGovernor.GetLevel();
+            ImGui::SameLine();
+            ImGui::Text("level %zu of %zu", m_qualityGovernor.GetLevelIndex() + 1,
+                Glitter::Render::QualityGovernor::GetLevels().size());
+            ImGui::Text("LOD bias %.0f, %.0f%% draw distance, %dx%d shadow map%s%s", static_cast<double>(level.m_lodBias),
+                static_cast<double>(level.m_drawDistanceScale) * 100.0, level.m_shadowMapSize, level.m_shadowMapSize,
+                level.m_bloom ? "" : ", no bloom", level.m_fxaa ? "" : ", no FXAA");
+        }
+        if (m_stereo) {
+            ImGui::Text("Stereo, %dx%d per eye", m_renderWidth, m_renderHeight);
+        }
+        ImGui::Checkbox("Temporal Upsampling", &m_temporalUpsampling);
+        if (m_temporalUpsampling) {
+            ImGui::SliderFloat("Upsampling Scale", &m_temporalUpsamplingScale, 0.5f, 1.0f, "%.2f");
+        }
+        ImGui::BeginDisabled(m_stereo);
+        auto viewLayout = static_cast<int>(m_viewLayout);
+        ImGui::Combo("Views", &viewLayout, "Single\0Picture-in-Picture\0Split Screen\0");
+        m_viewLayout = static_cast<Glitter::Render::ViewLayout>(viewLayout);
+        ImGui::EndDisabled();
+        if (m_viewLayout == Glitter::Render::ViewLayout::PictureInPicture) {
+            ImGui::SliderInt("Inset Views", &m_insetViewCount, 1, static_cast<int>(Glitter::Config::MAX_INSET_VIEWS));
+        }
+        if (packet.m_insetViewCount > 0) {
+            size_t insetDraws = 0;
+            for (size_t viewIdx = 0; viewIdx < packet.m_insetViewCount; viewIdx++) {
+                insetDraws += packet.m_insetViews[viewIdx].m_opaqueDrawList.size()
+                    + packet.m_insetViews[viewIdx].m_transparentDrawList.size();
+            }
+            ImGui::Text("%zu Nodes drawn by the inset views", insetDraws);
+        }
+        ImGui::Text("%zu simulation steps this frame, at %.0f Hz", m_simulationSteps,
+            1.0 / Glitter::Config::SIMULATION_TIME_STEP);
+        ImGui::End();
+
+        if (Glitter::Config::ENABLE_DEBUG_DRAW && m_showFramebufferView) {
+            ImGui::Begin("Glitter Framebuffers", &m_showFramebufferView, ImGuiWindowFlags_AlwaysAutoResize);
+            if (ImGui::CollapsingHeader("Main FB", ImGuiTreeNodeFlags_DefaultOpen)) {
+                // Only the main pass' viewport of the target, scaled down not to sample as many texels as it has.
+                ImVec2 uv(static_cast<float>(m_renderWidth) / static_cast<float>(m_fboColor.m_width),
+                    static_cast<float>(m_renderHeight) / static_cast<float>(m_fboColor.m_height));
+                ImVec2 size(static_cast<float>(m_renderWidth) * Glitter::Config::FRAMEBUFFER_VIEW_SCALE,
+                    static_cast<float>(m_renderHeight) * Glitter::Config::FRAMEBUFFER_VIEW_SCALE);
+                ImGui::Image(m_fboColor.m_texture, size, ImVec2(0, uv.y), ImVec2(uv.x, 0));
+            }
+            ImGui::End();
+        }
+
+        if (m_showCpuTimeline) {
+            DrawCpuTimeline();
+        }
+        if (m_showLog) {
+            DrawLog();
+        }
+
+        // Undo the toggles stereo, the inset views, the GPU picking and the visualizations can't render with.
+        if (m_stereo) {
+            RestrictToStereo();
+        }
+        if (m_viewLayout != Glitter::Render::ViewLayout::Single) {
+            RestrictToInsetViews();
+        }
+        if (m_gpuPicking) {
+            RestrictToGpuPicking();
+        }
+        if (IsVisualization(m_debugView)) {
+            RestrictToDebugView();
+        }
+    }
+
+    // The costliest Meshes and materials the batch cost sampler timed, in the "Performance" header.
+    void BuildBatchCostUi()
+    {
+        bool sampleBatches = m_batchCostSampler.IsEnabled();
+        if (ImGui::Checkbox("Sample Batch Costs", &sampleBatches)) {
+            m_batchCostSampler.SetEnabled(sampleBatches);
+        }
+        if (!sampleBatches) {
+            return;
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Reset Batch Costs")) {
+            m_batchCostSampler.Reset();
+        }
+
+        ImGui::TextUnformatted("Costliest Meshes, per run of draws:");
+        for (const auto& cost :
+            m_batchCostSampler.GetCostliest(Glitter::Render::BatchCostCategory::Mesh, Glitter::Config::BATCH_COST_TABLE_ROWS)) {
+            auto meshID = static_cast<std::uint32_t>(cost.m_key);
+            if (meshID == STATIC_BATCH_MESH) {
+                ImGui::Text("  %.3f ms (%llu samples): static batches", cost.m_averageMilliseconds,
+                    static_cast<unsigned long long>(cost.m_samples));
+                continue;
+            }
+            // Named after the asset the Mesh was loaded from, if any.
+            const char* asset = "generated";
+            for (const auto& [path, meshes] : m_assetMeshes) {
+                if (meshes && meshID >= meshes->m_firstMesh && meshID < meshes->m_firstMesh + meshes->m_meshCount) {
+                    asset = path.c_str();
+                    break;
+                }
+            }
+            ImGui::Text("  %.3f ms (%llu samples): Mesh %u of %s", cost.m_averageMilliseconds,
+                static_cast<unsigned long long>(cost.m_samples), meshID, asset);
+        }
+
+        ImGui::TextUnformatted("Costliest materials, per run of draws:");
+        for (const auto& cost : m_batchCostSampler.GetCostliest(
+                 Glitter::Render::BatchCostCategory::Material, Glitter::Config::BATCH_COST_TABLE_ROWS)) {
+            ImGui::Text("  %.3f ms (%llu samples): permutation %#x, texture %u", cost.m_averageMilliseconds,
+                static_cast<unsigned long long>(cost.m_samples), static_cast<unsigned int>(cost.m_key >> 32),
+                static_cast<unsigned int>(cost.m_key & 0xFFFF'FFFF));
+        }
+    }
+
+    // Replaces the main view's camera in `data`, the CommonData of `packet`, with the camera at the simulation time of now,
+    // see Config::ENABLE_LATE_LATCHING. Returns false, leaving `data` be, when the packet's camera is kept: the inset
+    // views orbit it, and the camera recordings must draw what they record or play back.
+    bool LatchCamera(const FramePacket& packet, CommonData& data) const
+    {
+        if (!m_lateLatching || m_renderOnDemand || m_cameraRecording || m_cameraPlayback || packet.m_insetViewCount > 0) {
+            return false;
+        }
+
+        // The frame's simulation time, as Simulate() interpolated it, moved on by the time since.
+        double alpha = m_simulationAccumulator / Glitter::Config::SIMULATION_TIME_STEP;
+        double time = std::lerp(m_previousState.m_time, m_currentState.m_time, alpha) + (glfwGetTime() - m_lastFrameTime);
+        auto [eyePos, eyeTarget] = EvaluateCamera(static_cast<float>(time));
+        glm::mat4 view = glm::lookAt(eyePos, eyeTarget, glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 vp = packet.m_projection * view;
+        data.m_view = view;
+        data.m_viewProjection = vp;
+        data.m_eyePos = glm::vec4(eyePos, 1.0f);
+        data.m_frustumPlanes = Glitter::Render::ExtractFrustumPlanes(vp);
+        data.m_eyeViewProjections = {vp, vp};
+        if (m_stereo) {
+            std::array<glm::mat4, 2> eyeViews = Glitter::Render::GetStereoViews(view, Glitter::Config::STEREO_EYE_SEPARATION);
+            data.m_eyeViewProjections = {packet.m_projection * eyeViews[0], packet.m_projection * eyeViews[1]};
+            data.m_frustumPlanes
+                = Glitter::Render::CombineStereoFrustums(Glitter::Render::ExtractFrustumPlanes(data.m_eyeViewProjections[0]),
+                    Glitter::Render::ExtractFrustumPlanes(data.m_eyeViewProjections[1]));
+        }
+        return true;
+    }
+
+    // Uploads the CommonData and per-draw data of `packet` into this frame's regions of their rings, and schedules and
+    // runs the frame's passes drawing it.
+    void SubmitFrame(const FramePacket& packet)
+    {
+        GLITTER_PROFILE_SCOPE("Submit");
+        // Latch the main view's camera before anything is derived from it.
+        CommonData packetData = packet.m_commonData;
+        double inputTime = packet.m_inputTime;
+        if (LatchCamera(packet, packetData)) {
+            inputTime = glfwGetTime();
+        }
+        m_currentView = packetData.m_view;
+        m_currentProjection = packet.m_projection;
+        const glm::mat4& viewProjection = packetData.m_viewProjection;
+
+        // Bin the packet's point lights into clusters, straight into this frame's region of their SSBO ring.
+        {
+            GLITTER_PROFILE_SCOPE("Light Clusters");
+            m_lightClusters.Build(packet.m_pointLights, packetData.m_view, packet.m_projection, packet.m_nearPlane,
+                packet.m_farPlane, m_renderWidth, m_renderHeight);
+        }
+
+        // Write the CommonData straight into this frame's region of the persistently-mapped UBO ring.
+        {
+            GLITTER_PROFILE_SCOPE("UBO Upload");
+            CommonData commonData = packetData;
+            commonData.m_hiZViewProjection = m_hiZViewProjection;
+            // The culling and Hi-Z keep the unjittered View-Projection, a fraction of a pixel off.
+            if (m_temporalUpsampling) {
+                m_jitter = m_temporalUpsampler.NextJitter();
+                commonData.m_viewProjection = Glitter::Render::TemporalUpsampler::ApplyJitter(
+                    viewProjection, m_jitter, m_renderWidth, m_renderHeight);
+            } else {
+                m_jitter = glm::vec2(0.0f);
+                m_temporalUpsampler.Reset();
+            }
+            // The inset views' follow, the main view's with their own cameras.
+            std::array<CommonData, 1 + Glitter::Config::MAX_INSET_VIEWS> viewData {};
+            viewData[0] = commonData;
+            for (size_t viewIdx = 0; viewIdx < packet.m_insetViewCount; viewIdx++) {
+                const InsetViewPacket& inset = packet.m_insetViews[viewIdx];
+                CommonData& insetData = viewData[viewIdx + 1];
+                insetData = commonData;
+                insetData.m_view = inset.m_view;
+                insetData.m_viewProjection = inset.m_viewProjection;
+                insetData.m_eyePos = glm::vec4(inset.m_eyePos, 1.0f);
+                insetData.m_frustumPlanes = inset.m_frustumPlanes;
+                insetData.m_eyeViewProjections = {inset.m_viewProjection, inset.m_viewProjection};
+            }
+            m_uboAllocator.SetTarget(m_uboStream.BeginFrame());
+            m_uboAllocator.PushN(std::span<const CommonData>(viewData).first(1 + packet.m_insetViewCount));
+            m_renderStats.CountUpload(sizeof(CommonData) * (1 + packet.m_insetViewCount));
+        }
+
+        // Build the indirect draw batches for both passes and the shadow map, writing the Node slot of each draw straight
+        // into this frame's region of the per-draw SSBO ring, growing it first if it can't hold every visible Node. GPU
+        // culling writes its own, only the shadow map's are written here then.
+        size_t staticBatchCount = 0;
+        std::array batchedCells {std::span(packet.m_staticBatchCells), std::span(packet.m_hlodCells)};
+        for (std::uint32_t cell : batchedCells | std::views::join) {
+            staticBatchCount += m_staticBatches.GetBatches(cell).size();
+        }
+        size_t insetDrawCount = 0;
+        for (size_t viewIdx = 0; viewIdx < packet.m_insetViewCount; viewIdx++) {
+            insetDrawCount += packet.m_insetViews[viewIdx].m_opaqueDrawList.size()
+                + packet.m_insetViews[viewIdx].m_transparentDrawList.size();
+        }
+        size_t mainDrawCount = packet.m_gpuCulling ? 0
+                                                   : packet.m_opaqueDrawList.size() + packet.m_transparentDrawList.size()
+                                                       + packet.m_impostorDrawList.size() + staticBatchCount + insetDrawCount;
+        size_t staticShadowCount = packet.m_staticShadowDrawList.size();
+        size_t perDrawCount = mainDrawCount + staticShadowCount + packet.m_dynamicShadowDrawList.size();
+        // The views with draw info read it from after the Node slots, at an offset the SSBO can be bound at.
+        bool drawInfo = HasDrawInfo(packet.m_debugView) && !packet.m_gpuCulling;
+        size_t drawInfoOffset = 0;
+        size_t perDrawSize = sizeof(GLuint) * perDrawCount;
+        if (drawInfo) {
+            size_t alignment = m_perDrawStream.GetAlignment();
+            drawInfoOffset = (perDrawSize + alignment - 1) / alignment * alignment;
+            perDrawSize = drawInfoOffset + sizeof(GLuint) * std::max<size_t>(mainDrawCount, 1);
+        }
+        std::span<std::byte> perDrawRegion = m_perDrawStream.BeginFrame();
+        if (perDrawSize > perDrawRegion.size()) {
+            perDrawRegion = m_perDrawStream.Grow(std::max(perDrawSize, m_perDrawStream.GetRegionSize() * 2));
+            spdlog::info("Grew the per-draw SSBO ring regions to {} bytes.", m_perDrawStream.GetRegionSize());
+            // The old buffer's name may be handed out again, and it was unbound when deleted.
+            m_renderStats.InvalidateState();
+            Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::BUFFER_GROWTH);
+        }
+        std::span<GLuint> drawNodes(reinterpret_cast<GLuint*>(perDrawRegion.data()), perDrawCount);
+
+        m_indirectCommands.clear();
+        m_indirectCommandMeshes.clear();
+        size_t opaqueCount = packet.m_opaqueDrawList.size();
+        std::pmr::vector<DrawBatch> opaqueBatches
+            = BuildDrawBatches(packet.m_opaqueDrawList, drawNodes.first(opaqueCount), 0, false);
+        std::pmr::vector<DrawBatch> transparentBatches = BuildDrawBatches(
+            packet.m_transparentDrawList, drawNodes.subspan(opaqueCount), static_cast<GLuint>(opaqueCount), !packet.m_weightedOit);
+        size_t firstImpostor = opaqueCount + packet.m_transparentDrawList.size();
+        std::pmr::vector<ImpostorBatch> impostorBatches = BuildImpostorBatches(packet.m_impostorDrawList,
+            drawNodes.subspan(firstImpostor, packet.m_impostorDrawList.size()), static_cast<GLuint>(firstImpostor));
+        size_t firstStaticBatch = firstImpostor + packet.m_impostorDrawList.size();
+        std::pmr::vector<DrawBatch> staticBatches = BuildStaticBatchDraws(
+            packet, drawNodes.subspan(firstStaticBatch, staticBatchCount), static_cast<GLuint>(firstStaticBatch));
+        // Each inset view's draws only write the slots of the Nodes it sees, whose data is the main pass'.
+        std::pmr::vector<std::pmr::vector<DrawBatch>> insetOpaqueBatches(&m_frameArena);
+        std::pmr::vector<std::pmr::vector<DrawBatch>> insetTransparentBatches(&m_frameArena);
+        size_t firstInsetDraw = firstStaticBatch + staticBatchCount;
+        for (size_t viewIdx = 0; viewIdx < packet.m_insetViewCount; viewIdx++) {
+            const InsetViewPacket& inset = packet.m_insetViews[viewIdx];
+            insetOpaqueBatches.push_back(BuildDrawBatches(inset.m_opaqueDrawList,
+                drawNodes.subspan(firstInsetDraw, inset.m_opaqueDrawList.size()), static_cast<GLuint>(firstInsetDraw), false));
+            firstInsetDraw += inset.m_opaqueDrawList.size();
+            insetTransparentBatches.push_back(BuildDrawBatches(inset.m_transparentDrawList,
+                drawNodes.subspan(firstInsetDraw, inset.m_transparentDrawList.size()), static_cast<GLuint>(firstInsetDraw),
+                true));
+            firstInsetDraw += inset.m_transparentDrawList.size();
+        }
+        std::pmr::vector<DrawBatch> staticShadowBatches = BuildDrawBatches(packet.m_staticShadowDrawList,
+            drawNodes.subspan(mainDrawCount, staticShadowCount), static_cast<GLuint>(mainDrawCount), false);
+        std::pmr::vector<DrawBatch> dynamicShadowBatches = BuildDrawBatches(packet.m_dynamicShadowDrawList,
+            drawNodes.subspan(mainDrawCount + staticShadowCount), static_cast<GLuint>(mainDrawCount + staticShadowCount), false);
+        m_renderStats.CountUpload(drawNodes.size_bytes());
+
+        // Write the draw info of the main pass' draws, in the order of their slots.
+        if (drawInfo) {
+            std::span<GLuint> drawInfos(reinterpret_cast<GLuint*>(perDrawRegion.data() + drawInfoOffset), mainDrawCount);
+            size_t drawIdx = 0;
+            auto writeDrawInfos = [&](const std::vector<DrawListEntry>& list) {
+                for (const DrawListEntry& entry : list) {
+                    auto cullState = packet.m_debugView == DebugView::CullState
+                        ? static_cast<DrawCullState>(packet.m_cullStates[entry.m_node])
+                        : DrawCullState::Untested;
+                    drawInfos[drawIdx++] = PackDrawInfo(entry.m_lod, cullState);
+                }
+            };
+            writeDrawInfos(packet.m_opaqueDrawList);
+            writeDrawInfos(packet.m_transparentDrawList);
+            writeDrawInfos(packet.m_impostorDrawList);
+            for (size_t batchIdx = 0; batchIdx < staticBatchCount; batchIdx++) {
+                drawInfos[drawIdx++] = PackDrawInfo(0, DrawCullState::Batched);
+            }
+            for (size_t viewIdx = 0; viewIdx < packet.m_insetViewCount; viewIdx++) {
+                writeDrawInfos(packet.m_insetViews[viewIdx].m_opaqueDrawList);
+                writeDrawInfos(packet.m_insetViews[viewIdx].m_transparentDrawList);
+            }
+            m_renderStats.CountUpload(drawInfos.size_bytes());
+        }
+
+        // Bind the Common UBO data into the first slot of the UBO.
+        m_renderStats.BindBufferRange(GL_UNIFORM_BUFFER, 0, m_uboStream.GetBuffer(),
+            static_cast<GLintptr>(m_uboStream.GetRegionOffset()), sizeof(CommonData));
+
+        // Bind the first page of the persistent Node data into the first SSBO slot, the draws of the others bind theirs.
+        BindNodePage(0);
+        m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 9, m_materialTableBuffer);
+
+        // Stream in the texture levels requested by the drawn Nodes, as sharp as the mip bias samples them. The GPU culling
+        // pass doesn't read back which Nodes it draws, so it requests every texture at full resolution.
+        if (Glitter::Config::ENABLE_TEXTURE_STREAMING) {
+            GLITTER_PROFILE_SCOPE("Texture Streaming");
+            float biasScale = std::exp2(-packet.m_commonData.m_textureParams.x);
+            for (const TextureRequest& request : packet.m_textureRequests) {
+                m_textureStreamer.Request(request.m_slot, request.m_pixels * biasScale);
+            }
+            for (size_t slot = 0; packet.m_gpuCulling && slot < m_textureCount; slot++) {
+                m_textureStreamer.Request(slot, std::numeric_limits<float>::infinity());
+            }
+            m_textureStreamer.Update(m_textureUploader);
+        }
+        // Delete the textures released since, once the frames that sampled them are done.
+        m_textureCache.Collect(false);
+
+        // Null draws keep every command, and so every draw call, with nothing to draw.
+        if (m_benchmark.m_isolation == Glitter::Core::BenchmarkIsolation::NullDraws) {
+            for (DrawElementsIndirectCommand& command : m_indirectCommands) {
+                command.m_count = 0;
+            }
+        }
+
+        // Upload the indirect commands, growing the buffer if it can't hold this frame's commands.
+        size_t indirectSize = sizeof(DrawElementsIndirectCommand) * m_indirectCommands.size();
+        if (indirectSize > m_indirectBufferSize) {
+            m_indirectBufferSize = std::max(indirectSize, m_indirectBufferSize * 2);
+            Glitter::Render::NamedBufferData(Glitter::Render::GpuMemoryCategory::StreamBuffer, m_indirectBuffer,
+                static_cast<GLsizeiptr>(m_indirectBufferSize), nullptr, GL_DYNAMIC_DRAW);
+        }
+        m_renderStats.NamedBufferSubData(m_indirectBuffer, 0, static_cast<GLsizeiptr>(indirectSize), m_indirectCommands.data());
+
+        // Schedule the frame's passes. The GPU culling pass is only run when the main pass draws its commands, the Hi-Z
+        // pyramid only built when the next frame culls against it, and the post-processing textures are transient.
+        using Glitter::Render::RenderAccess;
+        using Glitter::Render::RenderResourceType;
+        m_renderGraph.Reset(&m_frameArena);
+        Glitter::Render::RenderResource hiZ = m_renderGraph.Import(RenderResourceType::Texture, m_hiZ.GetTexture());
+        Glitter::Render::RenderResource gpuCommands = m_renderGraph.Import(RenderResourceType::Buffer, m_gpuCommandBuffer);
+        Glitter::Render::RenderResource drawCounts = m_renderGraph.Import(RenderResourceType::Buffer, m_drawCountBuffer);
+        Glitter::Render::RenderResource gpuDrawNodes = m_renderGraph.Import(RenderResourceType::Buffer, m_gpuDrawNodeBuffer);
+        Glitter::Render::RenderResource color = m_renderGraph.Import(
+            RenderResourceType::Texture, m_stereo ? m_stereoTargets.GetColorTexture() : m_fboColor.m_texture);
+        Glitter::Render::RenderResource depth = m_renderGraph.Import(
+            RenderResourceType::Texture, m_stereo ? m_stereoTargets.GetDepthTexture() : m_fboDepth.m_texture);
+        // Nothing reads the main pass' targets past the frame, so they're invalidated after their last pass rather than
+        // stored, and before the main pass' clear rather than loaded.
+        m_renderGraph.Discard(color, m_fbo, GL_COLOR_ATTACHMENT0);
+        m_renderGraph.Discard(depth, m_fbo, GL_DEPTH_ATTACHMENT);
+        std::optional<Glitter::Render::RenderResource> nodeIds {};
+        if (m_gpuPicking) {
+            nodeIds = m_renderGraph.Import(RenderResourceType::Texture, m_fboNodeIds.m_texture);
+        }
+        Glitter::Render::RenderResource backbuffer = m_renderGraph.Import(RenderResourceType::Framebuffer, m_headlessFbo);
+        m_renderGraph.Keep(backbuffer);
+        bool buildHiZ = packet.m_gpuCulling && m_occlusionCulling;
+        if (buildHiZ) {
+            m_renderGraph.Keep(hiZ);
+        }
+        // The weighted blended transparent Nodes, composited by the post-processing.
+        std::optional<Glitter::Render::WeightedOitTargets> oit {};
+        if (packet.m_weightedOit) {
+            oit = Glitter::Render::WeightedOitTargets {
+                .m_accumulation = m_renderGraph.CreateTexture(
+                    "Weighted OIT Accumulation", GL_RGBA16F, m_fboColor.m_width, m_fboColor.m_height),
+                .m_revealage = m_renderGraph.CreateTexture(
+                    "Weighted OIT Revealage", GL_R16F, m_fboColor.m_width, m_fboColor.m_height),
+            };
+        }
+        // Which triangle of which opaque draw covers each pixel, 0 in x where none does.
+        std::optional<Glitter::Render::RenderResource> visibility {};
+        if (m_visibilityBuffer && m_textureMode != TextureMode::Bound && !packet.m_staticBatching) {
+            visibility = m_renderGraph.CreateTexture("Visibility Buffer", GL_RGBA32UI, m_fboColor.m_width, m_fboColor.m_height);
+        }
+
+        // Render the static shadow casters into the cache when it was invalidated, and the dynamic ones over a copy of it.
+        // The main pass samples the cache directly when there are none.
+        Glitter::Render::RenderResource staticShadowMap
+            = m_renderGraph.Import(RenderResourceType::Texture, m_shadowCache.GetStaticTexture());
+        Glitter::Render::RenderResource dynamicShadowMap
+            = m_renderGraph.Import(RenderResourceType::Texture, m_shadowCache.GetTexture());
+        bool renderDynamicShadows = !dynamicShadowBatches.empty();
+        Glitter::Render::RenderResource shadowMap = renderDynamicShadows ? dynamicShadowMap : staticShadowMap;
+        if (packet.m_renderStaticShadows || renderDynamicShadows) {
+            auto shadowPass = m_renderGraph.AddPass("Shadow Map", [&](const Glitter::Render::RenderGraph&) {
+                m_renderStats.BindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, m_perDrawStream.GetBuffer(),
+                    static_cast<GLintptr>(m_perDrawStream.GetRegionOffset()),
+                    static_cast<GLsizeiptr>(m_perDrawStream.GetRegionSize()));
+                m_renderStats.BindVertexArray(m_depthVAO);
+                BindPulledVertices();
+                m_renderStats.BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+
+                m_gpuProfiler.PushGroup(0, "Shadow Map");
+                {
+                    if (packet.m_renderStaticShadows) {
+                        m_shadowCache.BeginStatic(m_renderStats, m_shadowProgram);
+                        SubmitDepthPrepass(staticShadowBatches);
+                        m_shadowCache.EndStatic();
+                    }
+                    if (renderDynamicShadows) {
+                        m_shadowCache.BeginDynamic(m_renderStats, m_shadowProgram);
+                        SubmitDepthPrepass(dynamicShadowBatches);
+                        m_shadowCache.EndDynamic();
+                    }
+                    glViewport(0, 0, m_windowWidth, m_windowHeight);
+                }
+                m_gpuProfiler.PopGroup();
+            });
+            if (packet.m_renderStaticShadows) {
+                shadowPass.Write(staticShadowMap, RenderAccess::Framebuffer);
+            }
+            if (renderDynamicShadows) {
+                shadowPass.Read(staticShadowMap, RenderAccess::Framebuffer).Write(dynamicShadowMap, RenderAccess::Framebuffer);
+            }
+        }
+
+        m_renderGraph
+            .AddPass("GPU Culling", [&](const Glitter::Render::RenderGraph&) { DispatchGpuCulling(!packet.m_weightedOit); })
+            .Read(hiZ, RenderAccess::TextureFetch)
+            .Write(gpuCommands, RenderAccess::ShaderStorage)
+            .Write(drawCounts, RenderAccess::ShaderStorage)
+            .Write(gpuDrawNodes, RenderAccess::ShaderStorage);
+
+        // The visibility buffer already only shades each pixel once, and the additive views count every fragment.
+        bool additive = IsAdditive(packet.m_debugView);
+        bool depthPrepass = !visibility && !additive && m_depthPrepass.IsEnabled(m_depthPrepassMode);
+
+        // Draw each opaque Node under its occlusion query of the previous frame, and query them again against this frame's
+        // opaque depth. The GPU culling pass has its own, and the visibility buffer resolves the draws by command.
+        bool occlusionQueries = m_occlusionQueries && !packet.m_gpuCulling && !visibility;
+        size_t queryCount = occlusionQueries ? m_nodeDataBuffer.GetCapacity() : 0;
+        m_occlusionQueryPool.BeginFrame(packet.m_sceneRevision, queryCount);
+        std::span<const DrawListEntry> conditionalNodes {};
+        if (occlusionQueries) {
+            conditionalNodes = packet.m_opaqueDrawList;
+        }
+        // Shade at the rates the previous frame's update picked. Its stereo color is an array, which the content adaptive
+        // mode doesn't sample, so it falls back to foveation.
+        Glitter::Render::ShadingRateMode shadingRateMode
+            = m_shadingRateImage.IsSupported() ? m_shadingRateMode : Glitter::Render::ShadingRateMode::Off;
+        if (m_stereo && shadingRateMode == Glitter::Render::ShadingRateMode::ContentAdaptive) {
+            shadingRateMode = Glitter::Render::ShadingRateMode::Foveated;
+        }
+        bool variableRateShading = shadingRateMode != Glitter::Render::ShadingRateMode::Off;
+        auto mainPass = m_renderGraph.AddPass("Main FB Draw", [&](const Glitter::Render::RenderGraph& run) {
+            // The GPU culling pass binds its own buffers into the same SSBO slots.
+            if (Glitter::Config::ENABLE_TEXTURE_STREAMING) {
+                m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_textureStreamer.GetMinLodBuffer());
+            }
+
+            // Bind the point lights and their clusters into the SSBO slots 3 to 5.
+            m_lightClusters.Bind(m_renderStats);
+
+            // Bind the Node slot of each draw into the second SSBO slot.
+            if (packet.m_gpuCulling) {
+                m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_gpuDrawNodeBuffer);
+            } else {
+                m_renderStats.BindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, m_perDrawStream.GetBuffer(),
+                    static_cast<GLintptr>(m_perDrawStream.GetRegionOffset()),
+                    static_cast<GLsizeiptr>(m_perDrawStream.GetRegionSize()));
+            }
+            // And their draw info into slot 12, in the views reading it.
+            if (drawInfo) {
+                m_renderStats.BindBufferRange(GL_SHADER_STORAGE_BUFFER, 12, m_perDrawStream.GetBuffer(),
+                    static_cast<GLintptr>(m_perDrawStream.GetRegionOffset() + drawInfoOffset),
+                    static_cast<GLsizeiptr>(sizeof(GLuint) * std::max<size_t>(mainDrawCount, 1)));
+            }
+
+            // Bind the VAO, each batch binds its own Program.
+            m_renderStats.BindVertexArray(m_mainVAO);
+            BindPulledVertices();
+            m_renderStats.BindBuffer(GL_DRAW_INDIRECT_BUFFER, packet.m_gpuCulling ? m_gpuCommandBuffer : m_indirectBuffer);
+            m_renderStats.BindBuffer(GL_PARAMETER_BUFFER, m_drawCountBuffer);
+
+            // Bind the texture array once for every batch, and the Node textures' sampler to their unit.
+            if (m_textureMode == TextureMode::Array) {
+                m_renderStats.BindTextureUnit(0, m_textureArray);
+            }
+            glBindSampler(0, m_nodeSampler);
+
+            // Bind the shadow map, sampled unless shadows are disabled.
+            m_renderStats.BindTextureUnit(1, run.Get(shadowMap));
+
+            m_gpuProfiler.PushGroup(0, "Main FB Draw");
+            m_renderStats.BeginPipelineQueries();
+            {
+                glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+                glViewport(0, 0, m_renderWidth, m_renderHeight);
+                // The main view only draws into its rectangle, when it doesn't cover the whole target.
+                bool scissorMainView = packet.m_viewport != glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+                if (scissorMainView) {
+                    glm::ivec4 rect = Glitter::Render::GetViewportRect(packet.m_viewport, m_renderWidth, m_renderHeight);
+                    glEnable(GL_SCISSOR_TEST);
+                    glScissor(rect.x, rect.y, rect.z, rect.w);
+                }
+                // The FBO needs its own independent clear.
+                m_renderStats.DepthMask(GL_TRUE);
+                ClearMainFramebuffer();
+                if (variableRateShading) {
+                    m_shadingRateImage.Begin();
+                }
+                if (additive) {
+                    glDisable(GL_DEPTH_TEST);
+                    m_renderStats.BlendFunc(GL_ONE, GL_ONE);
+                }
+
+                // Render the depth of each opaque Node first, then only shade the fragments matching it. The overdraw is
+                // measured on whichever pass writes the depth.
+                bool drawOpaque = !packet.m_opaqueDrawList.empty() || !staticBatches.empty() || packet.m_gpuCulling;
+                if (drawOpaque && depthPrepass) {
+                    m_gpuProfiler.PushGroup(1, "Depth Pre-Pass");
+                    {
+                        m_renderStats.BindVertexArray(m_depthVAO);
+                        m_renderStats.UseProgram(m_depthProgram);
+                        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+                        m_renderStats.DepthMask(GL_TRUE);
+                        m_depthPrepass.BeginQuery();
+                        if (packet.m_gpuCulling) {
+                            SubmitGpuCulledDraws(0);
+                        } else {
+                            SubmitDepthPrepass(opaqueBatches, conditionalNodes);
+                            SubmitStaticBatches(staticBatches, true);
+                        }
+                        m_depthPrepass.EndQuery(m_renderWidth, m_renderHeight);
+                        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                        m_renderStats.BindVertexArray(m_mainVAO);
+                    }
+                    m_gpuProfiler.PopGroup();
+                }
+
+                // Render the triangle of each opaque Node covering each pixel, and shade them from it. The overdraw is
+                // measured on the visibility pass, which is as cheap as the depth pre-pass.
+                if (drawOpaque && visibility) {
+                    m_gpuProfiler.PushGroup(1, "Visibility Buffer");
+                    {
+                        glNamedFramebufferTexture(m_visibilityFbo, GL_COLOR_ATTACHMENT0, run.Get(*visibility), 0);
+                        std::array<GLuint, 4> visibilityClear {};
+                        glClearNamedFramebufferuiv(m_visibilityFbo, GL_COLOR, 0, visibilityClear.data());
+                        glBindFramebuffer(GL_FRAMEBUFFER, m_visibilityFbo);
+
+                        m_renderStats.BindVertexArray(m_depthVAO);
+                        m_renderStats.UseProgram(m_visibilityProgram);
+                        m_depthPrepass.BeginQuery();
+                        if (packet.m_gpuCulling) {
+                            SubmitGpuCulledDraws(0, true);
+                        } else {
+                            SubmitDepthPrepass(opaqueBatches, {}, true);
+                        }
+                        m_depthPrepass.EndQuery(m_renderWidth, m_renderHeight);
+                        m_renderStats.BindVertexArray(m_mainVAO);
+                    }
+                    m_gpuProfiler.PopGroup();
+
+                    m_gpuProfiler.PushGroup(1, "Visibility Resolve");
+                    {
+                        m_renderStats.UseProgram(m_visibilityResolvePrograms[packet.m_basePermutation]);
+                        m_renderStats.BindTextureUnit(2, run.Get(*visibility));
+                        m_renderStats.BindBufferBase(
+                            GL_SHADER_STORAGE_BUFFER, 6, packet.m_gpuCulling ? m_gpuCommandBuffer : m_indirectBuffer);
+                        glBindImageTexture(0, m_fboColor.m_texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, m_fboColor.m_format);
+
+                        // uniform layout(location = 0) ivec2 u_Size;
+                        glUniform2i(0, m_renderWidth, m_renderHeight);
+
+                        // One dispatch per pair of pages, with the Node data and the geometry pool page's EBO and VBO the
+                        // pixels drawn from them fetch, each shading only its own pixels.
+                        for (std::uint32_t nodePage = 0; nodePage < m_nodeDataBuffer.GetPageCount(); nodePage++) {
+                            BindNodePage(nodePage);
+                            for (std::uint32_t page = 0; page < m_geometryPool.GetPageCount(); page++) {
+                                m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, m_geometryPool.GetEBO(page));
+                                m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, m_geometryPool.GetVBO(page));
+                                // uniform layout(location = 1) uint u_Pages;
+                                glUniform1ui(1, PackVisibilityPages(nodePage, page));
+                                glDispatchCompute(static_cast<GLuint>((m_renderWidth + 7) / 8),
+                                    static_cast<GLuint>((m_renderHeight + 7) / 8), 1);
+                            }
+                        }
+                        // The pulled vertices share slot 8.
+                        BindPulledVertices();
+
+                        // The transparent Nodes blend over the resolved colors.
+                        glMemoryBarrier(GL_FRAMEBUFFER_BARRIER_BIT);
+                        glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+                    }
+                    m_gpuProfiler.PopGroup();
+                }
+
+                // Render each opaque Node.
+                if (drawOpaque && !visibility) {
+                    m_gpuProfiler.PushGroup(1, "Opaque Nodes");
+                    {
+                        m_renderStats.DepthMask(depthPrepass ? GL_FALSE : GL_TRUE);
+                        m_renderStats.DepthFunc(depthPrepass ? GL_EQUAL : GL_LEQUAL);
+                        if (!depthPrepass) {
+                            m_depthPrepass.BeginQuery();
+                        }
+                        if (packet.m_gpuCulling) {
+                            m_renderStats.UseProgram(m_mainPrograms[packet.m_basePermutation]);
+                            SubmitGpuCulledDraws(0);
+                        } else {
+                            SubmitDrawBatches(opaqueBatches, conditionalNodes);
+                            SubmitStaticBatches(staticBatches, false);
+                        }
+                        if (!depthPrepass) {
+                            m_depthPrepass.EndQuery(m_renderWidth, m_renderHeight);
+                        }
+                        m_renderStats.DepthFunc(GL_LEQUAL);
+                    }
+                    m_gpuProfiler.PopGroup();
+                    // The GPU shades the opaque Nodes while the rest of the frame is issued.
+                    m_submitFlusher.Flush();
+                }
+
+                // Render the impostors of the far opaque Nodes, depth tested and written at the depth they were baked at.
+                if (!impostorBatches.empty()) {
+                    m_gpuProfiler.PushGroup(1, "Impostors");
+                    {
+                        m_renderStats.DepthMask(GL_TRUE);
+                        m_renderStats.UseProgram(m_impostorPrograms[packet.m_basePermutation]);
+                        m_renderStats.BindTextureUnit(3, m_impostorAtlas.GetTexture());
+                        m_renderStats.BindTextureUnit(4, m_impostorAtlas.GetDepthTexture());
+                        SubmitImpostors(impostorBatches);
+                    }
+                    m_gpuProfiler.PopGroup();
+                }
+
+                // Query each opaque Node's AABB against the opaque depth, impostors included, for the next frame.
+                if (!conditionalNodes.empty()) {
+                    m_gpuProfiler.PushGroup(1, "Occlusion Queries");
+                    {
+                        m_renderStats.UseProgram(m_occlusionBoxProgram);
+                        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+                        m_renderStats.DepthMask(GL_FALSE);
+                        glDisable(GL_CULL_FACE);
+
+                        // uniform layout(location = 0) float u_ClipMargin;
+                        float clipMargin = packet.m_nearPlane
+                            * std::sqrt(1.0f + 1.0f / (packet.m_projection[0][0] * packet.m_projection[0][0])
+                                + 1.0f / (packet.m_projection[1][1] * packet.m_projection[1][1]));
+                        glUniform1f(0, clipMargin);
+                        for (const DrawListEntry& entry : conditionalNodes) {
+                            m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1,
+                                m_nodeBoundsBuffer.GetBuffer(m_nodeBoundsBuffer.GetPage(entry.m_node)));
+                            m_occlusionQueryPool.BeginQuery(entry.m_node);
+                            glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, 36, 1, entry.m_node);
+                            m_occlusionQueryPool.EndQuery();
+                        }
+                        m_renderStats.CountDraw(conditionalNodes.size(), 12 * conditionalNodes.size());
+
+                        glEnable(GL_CULL_FACE);
+                        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                        m_renderStats.BindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, m_perDrawStream.GetBuffer(),
+                            static_cast<GLintptr>(m_perDrawStream.GetRegionOffset()),
+                            static_cast<GLsizeiptr>(m_perDrawStream.GetRegionSize()));
+                    }
+                    m_gpuProfiler.PopGroup();
+                }
+
+                // Render each transparent Node. With weighted blended transparency, into the sum of their weighted
+                // premultiplied colors and the product of their (1 - alpha), cleared even without any for the composite.
+                if (oit) {
+                    glNamedFramebufferTexture(m_oitFbo, GL_COLOR_ATTACHMENT0, run.Get(oit->m_accumulation), 0);
+                    glNamedFramebufferTexture(m_oitFbo, GL_COLOR_ATTACHMENT1, run.Get(oit->m_revealage), 0);
+                    std::array<GLfloat, 4> accumulationClear {0.0f, 0.0f, 0.0f, 0.0f};
+                    std::array<GLfloat, 4> revealageClear {1.0f, 0.0f, 0.0f, 0.0f};
+                    glClearNamedFramebufferfv(m_oitFbo, GL_COLOR, 0, accumulationClear.data());
+                    glClearNamedFramebufferfv(m_oitFbo, GL_COLOR, 1, revealageClear.data());
+                }
+                if (!packet.m_transparentDrawList.empty() || packet.m_gpuCulling) {
+                    m_gpuProfiler.PushGroup(2, "Transparent Nodes");
+                    {
+                        m_renderStats.DepthMask(GL_FALSE);
+                        if (oit) {
+                            glBindFramebuffer(GL_FRAMEBUFFER, m_oitFbo);
+                            m_renderStats.BlendFunci(0, GL_ONE, GL_ONE);
+                            m_renderStats.BlendFunci(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+                        }
+                        if (packet.m_gpuCulling) {
+                            m_renderStats.UseProgram(m_mainPrograms[packet.m_basePermutation | packet.m_transparentPermutation]);
+                            SubmitGpuCulledDraws(1);
+                        } else {
+                            SubmitDrawBatches(transparentBatches);
+                        }
+                        if (oit) {
+                            m_renderStats.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                        }
+                    }
+                    m_gpuProfiler.PopGroup();
+                }
+                if (variableRateShading) {
+                    m_shadingRateImage.End();
+                }
+
+                // Render each inset view over its rectangle, at the full shading rate, from the batches of its part of the
+                // draw lists. Only its CommonData is its own.
+                if (packet.m_insetViewCount > 0) {
+                    m_gpuProfiler.PushGroup(1, "Inset Views");
+                    {
+                        glEnable(GL_SCISSOR_TEST);
+                        for (size_t viewIdx = 0; viewIdx < packet.m_insetViewCount; viewIdx++) {
+                            glm::ivec4 rect = Glitter::Render::GetViewportRect(
+                                packet.m_insetViews[viewIdx].m_viewport, m_renderWidth, m_renderHeight);
+                            glViewport(rect.x, rect.y, rect.z, rect.w);
+                            glScissor(rect.x, rect.y, rect.z, rect.w);
+                            m_renderStats.DepthMask(GL_TRUE);
+                            ClearMainFramebuffer();
+                            m_renderStats.BindBufferRange(GL_UNIFORM_BUFFER, 0, m_uboStream.GetBuffer(),
+                                static_cast<GLintptr>(m_uboStream.GetRegionOffset() + m_commonDataStride * (viewIdx + 1)),
+                                sizeof(CommonData));
+                            SubmitDrawBatches(insetOpaqueBatches[viewIdx]);
+                            m_renderStats.DepthMask(GL_FALSE);
+                            SubmitDrawBatches(insetTransparentBatches[viewIdx]);
+                        }
+                        m_renderStats.DepthMask(GL_TRUE);
+                        m_renderStats.BindBufferRange(GL_UNIFORM_BUFFER, 0, m_uboStream.GetBuffer(),
+                            static_cast<GLintptr>(m_uboStream.GetRegionOffset()), sizeof(CommonData));
+                    }
+                    m_gpuProfiler.PopGroup();
+                }
+                glDisable(GL_SCISSOR_TEST);
+                if (additive) {
+                    glEnable(GL_DEPTH_TEST);
+                    m_renderStats.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                }
+                // Only the Main program writes the Node IDs, the later passes drawing into the FBO leave them be.
+                if (m_gpuPicking) {
+                    glNamedFramebufferDrawBuffer(m_fbo, GL_COLOR_ATTACHMENT0);
+                }
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                glViewport(0, 0, m_windowWidth, m_windowHeight);
+            }
+            m_renderStats.EndPipelineQueries();
+            m_gpuProfiler.PopGroup();
+            glBindSampler(0, 0);
+        });
+        mainPass.Overwrite(color, RenderAccess::Framebuffer).Overwrite(depth, RenderAccess::Framebuffer);
+        if (packet.m_shadows) {
+            mainPass.Read(shadowMap, RenderAccess::TextureFetch);
+        }
+        if (oit) {
+            mainPass.Overwrite(oit->m_accumulation, RenderAccess::Framebuffer)
+                .Overwrite(oit->m_revealage, RenderAccess::Framebuffer);
+        }
+        if (visibility) {
+            mainPass.Overwrite(*visibility, RenderAccess::Framebuffer).Write(color, RenderAccess::ImageLoadStore);
+        }
+        if (nodeIds) {
+            mainPass.Overwrite(*nodeIds, RenderAccess::Framebuffer);
+        }
+
+        // Copy the Node ID under the click into a buffer, read back once the GPU is done with it, see ApplyNodePick().
+        if (nodeIds && packet.m_pickRequest) {
+            Glitter::Render::RenderResource pickBuffer
+                = m_renderGraph.Import(RenderResourceType::Buffer, m_nodePicker.GetNextBuffer());
+            m_renderGraph.Keep(pickBuffer);
+            m_renderGraph
+                .AddPass("Node Picking",
+                    [&](const Glitter::Render::RenderGraph&) {
+                        glm::ivec2 size(m_renderWidth, m_renderHeight);
+                        glm::ivec2 pixel = glm::clamp(
+                            glm::ivec2((*packet.m_pickRequest * 0.5f + 0.5f) * glm::vec2(size)), glm::ivec2(0), size - 1);
+                        if (!m_nodePicker.Request(m_fbo, GL_COLOR_ATTACHMENT1, pixel.x, pixel.y, packet.m_sceneRevision)) {
+                            spdlog::warn("Dropped a Node pick, {} are still in flight.", Glitter::Config::FRAMES_IN_FLIGHT);
+                        }
+                    })
+                .Read(*nodeIds, RenderAccess::Framebuffer)
+                .Write(pickBuffer, RenderAccess::Framebuffer);
+        }
+        if (packet.m_gpuCulling) {
+            mainPass.Read(gpuCommands, RenderAccess::Command)
+                .Read(drawCounts, RenderAccess::Command)
+                .Read(gpuDrawNodes, RenderAccess::ShaderStorage);
+        }
+
+        // Pick the next frame's shading rates, from this frame's scene color in the content adaptive mode.
+        if (variableRateShading) {
+            m_shadingRateImage.AddUpdatePass(m_renderGraph, m_shadingRateProgram, shadingRateMode, color, m_renderWidth,
+                m_renderHeight, m_renderStats, m_gpuProfiler);
+        }
+
+        // Build the Hi-Z pyramid from this frame's depth, only the opaque pass writes to it. The next frame culls against
+        // it with this frame's View-Projection.
+        m_renderGraph
+            .AddPass("Hi-Z Build",
+                [&](const Glitter::Render::RenderGraph&) {
+                    m_hiZ.Build(m_renderStats, m_hiZProgram, m_fboDepth.m_texture, m_renderWidth, m_renderHeight, m_gpuProfiler);
+                    m_hiZViewProjection = viewProjection;
+                })
+            .Read(depth, RenderAccess::TextureFetch)
+            .Write(hiZ, RenderAccess::ImageLoadStore);
+
+        // Render the depth tested debug lines into the scene color, before it's post-processed.
+        bool drawDebugLines = m_debugLines && m_debugProgram != 0 && !m_debugDraw.IsEmpty(Glitter::Render::DebugDepth::Overlay);
+        if (m_debugLines && m_debugProgram != 0 && !m_stereo && !m_debugDraw.IsEmpty(Glitter::Render::DebugDepth::Tested)) {
+            m_renderGraph
+                .AddPass("Debug (Depth Tested)",
+                    [&](const Glitter::Render::RenderGraph&) {
+                        m_gpuProfiler.PushGroup(2, "Debug (Depth Tested)");
+                        {
+                            glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+                            glViewport(0, 0, m_renderWidth, m_renderHeight);
+                            m_renderStats.DepthMask(GL_FALSE);
+                            m_renderStats.UseProgram(m_debugProgram);
+                            m_debugDraw.Draw(m_renderStats, Glitter::Render::DebugDepth::Tested);
+                            m_renderStats.DepthMask(GL_TRUE);
+                            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                            glViewport(0, 0, m_windowWidth, m_windowHeight);
+                        }
+                        m_gpuProfiler.PopGroup();
+                    })
+                .Read(depth, RenderAccess::Framebuffer)
+                .Write(color, RenderAccess::Framebuffer);
+        }
+
+        // Render Post-Processing effects into the default framebuffer, or present both eyes side by side in stereo.
+        // The weighted blended transparent Nodes are composited by the first pass.
+        Glitter::Render::PostProcessSettings postProcessSettings = m_postProcessSettings;
+        postProcessSettings.m_weightedOit = packet.m_weightedOit;
+        // The quality governor can only turn the post effects off.
+        const Glitter::Render::QualityLevel& qualityLevel = m_qualityGovernor.GetLevel();
+        postProcessSettings.m_bloom = postProcessSettings.m_bloom && qualityLevel.m_bloom;
+        postProcessSettings.m_fxaa = postProcessSettings.m_fxaa && qualityLevel.m_fxaa;
+        Glitter::Render::RenderResource postProcessInput = color;
+        GLsizei postProcessWidth = m_renderWidth;
+        GLsizei postProcessHeight = m_renderHeight;
+        if (m_temporalUpsampling) {
+            // Upsampled to the window, or as much of it as the targets hold while it's being resized, compositing the
+            // transparent Nodes over each sample on the way.
+            postProcessWidth = std::min(m_windowWidth, m_fboColor.m_width);
+            postProcessHeight = std::min(m_windowHeight, m_fboColor.m_height);
+            postProcessInput = m_temporalUpsampler.AddPass(m_renderGraph, m_temporalUpsampleProgram, color, depth,
+                m_renderWidth, m_renderHeight, viewProjection, m_jitter, oit, postProcessWidth, postProcessHeight,
+                m_renderStats, m_gpuProfiler);
+            postProcessSettings.m_weightedOit = false;
+        }
+        if (m_stereo) {
+            m_stereoTargets.AddPresentPass(m_renderGraph, color, m_renderWidth, m_renderHeight, backbuffer, m_windowWidth,
+                m_windowHeight, m_gpuProfiler);
+        } else {
+            m_postProcessor.AddPasses(m_renderGraph, m_ppfxPrograms, postProcessInput, postProcessWidth, postProcessHeight,
+                postProcessSettings, oit, backbuffer, m_windowWidth, m_windowHeight, m_renderStats, m_gpuProfiler);
+        }
+
+        // Render the overlaid debug lines, and each Node's AABB from its GPU bounds.
+        bool drawAABBs = m_debugLines && m_drawAABBs && m_debugAABBProgram != 0 && !m_nodes.Empty();
+        auto aabbCount = static_cast<GLsizei>(m_nodes.Size());
+        if (drawDebugLines || drawAABBs) {
+            m_renderGraph
+                .AddPass("Debug",
+                    [&](const Glitter::Render::RenderGraph&) {
+                        m_gpuProfiler.PushGroup(2, "Debug");
+                        {
+                            m_renderStats.DepthFunc(GL_ALWAYS);
+
+                            // Bind the Common UBO data into the first slot of the UBO.
+                            m_renderStats.BindBufferRange(GL_UNIFORM_BUFFER, 0, m_uboStream.GetBuffer(),
+                                static_cast<GLintptr>(m_uboStream.GetRegionOffset()), sizeof(CommonData));
+
+                            if (drawDebugLines) {
+                                m_renderStats.UseProgram(m_debugProgram);
+                                m_debugDraw.Draw(m_renderStats, Glitter::Render::DebugDepth::Overlay);
+                            }
+
+                            // Draw the 24 vertices of the unit cube's edges once per Node slot, scaled by its bounds, a
+                            // draw per page.
+                            if (drawAABBs) {
+                                m_renderStats.UseProgram(m_debugAABBProgram);
+                                m_renderStats.BindVertexArray(m_debugAABBVAO);
+                                for (std::uint32_t page = 0; page < m_nodeBoundsBuffer.GetPageCount(); page++) {
+                                    auto first = static_cast<GLsizei>(m_nodeBoundsBuffer.GetFirst(page));
+                                    if (first >= aabbCount) {
+                                        break;
+                                    }
+                                    BindNodePage(page);
+                                    m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_nodeBoundsBuffer.GetBuffer(page));
+                                    glDrawArraysInstanced(GL_LINES, 0, 24,
+                                        std::min(aabbCount - first, static_cast<GLsizei>(m_nodeBoundsBuffer.GetPageSize())));
+                                    m_renderStats.CountDraw(1, 0);
+                                }
+                            }
+
+                            m_renderStats.DepthFunc(GL_LEQUAL);
+                        }
+                        m_gpuProfiler.PopGroup();
+                    })
+                .Write(backbuffer, RenderAccess::Framebuffer);
+        }
+
+        // Read the presented frame back before Dear ImGui is drawn over it, on request or every frame when capturing. The
+        // capture waits for the oldest readback rather than drop a frame.
+        bool captureFrames = m_activeServedScene ? m_servedScenes[*m_activeServedScene].m_output != nullptr
+                                                 : m_frameOutput.IsOpen();
+        if (m_captureRequested || captureFrames) {
+            if (captureFrames && m_frameReadback.IsFull()) {
+                m_frameReadback.Poll([&](const Glitter::Render::ReadbackImage& image) { WriteCapture(image); }, true);
+            }
+            Glitter::Render::RenderResource readback
+                = m_renderGraph.Import(RenderResourceType::Buffer, m_frameReadback.GetNextBuffer());
+            m_renderGraph.Keep(readback);
+            m_renderGraph
+                .AddPass("Frame Readback",
+                    [&](const Glitter::Render::RenderGraph&) {
+                        GLenum readBuffer = m_headlessFbo ? GL_COLOR_ATTACHMENT0 : GL_BACK;
+                        std::uint64_t frame = m_capturedFrames;
+                        if (m_activeServedScene) {
+                            frame = Glitter::Core::MakeServedFrameTag(
+                                *m_activeServedScene, m_servedScenes[*m_activeServedScene].m_frame);
+                        }
+                        if (m_frameReadback.Request(m_headlessFbo, readBuffer, m_windowWidth, m_windowHeight, frame)) {
+                            m_capturedFrames++;
+                            m_captureRequested = false;
+                        }
+                    })
+                .Read(backbuffer, RenderAccess::Framebuffer)
+                .Write(readback, RenderAccess::Framebuffer);
+        }
+
+        // Render Dear ImGui, which shows the main pass' color, with the windows built last when they weren't this frame.
+        if (!m_benchmark.m_headless && m_showOverlays) {
+            m_renderGraph
+                .AddPass("Dear ImGui",
+                    [&](const Glitter::Render::RenderGraph&) {
+                        m_gpuProfiler.PushGroup(3, "Dear ImGui");
+                        {
+                            GLITTER_PROFILE_SCOPE("ImGui Render");
+                            // The GPU post-processes the frame while Dear ImGui builds its draw lists.
+                            m_submitFlusher.Flush();
+                            if (m_updateUi) {
+                                ImGui::Render();
+                            }
+                            if (ImDrawData* drawData = ImGui::GetDrawData()) {
+                                ImGui_ImplOpenGL3_RenderDrawData(drawData);
+                            }
+                        }
+                        m_gpuProfiler.PopGroup();
+                    })
+                .Read(color, RenderAccess::TextureFetch)
+                .Write(backbuffer, RenderAccess::Framebuffer);
+        }
+
+        // Without submitting, the frame is only built: none of its passes run, and nothing is drawn or dispatched.
+        bool submit = m_benchmark.m_isolation != Glitter::Core::BenchmarkIsolation::NoSubmit;
+        if (submit) {
+            GLITTER_PROFILE_SCOPE("Render Graph");
+            m_renderGraph.Run(m_renderTargets);
+        } else if (m_updateUi) {
+            // Ends the Dear ImGui frame its pass would have rendered.
+            ImGui::EndFrame();
+        }
+        m_hiZValid = buildHiZ && submit;
+        m_frameReadback.Poll([&](const Glitter::Render::ReadbackImage& image) { WriteCapture(image); });
+
+        // Fence this frame's regions of the stream buffers after every command reading from them.
+        m_uboStream.EndFrame();
+        m_perDrawStream.EndFrame();
+        m_lightClusters.EndFrame();
+        m_debugDraw.EndFrame();
+        m_textureUploader.EndFrame();
+
+        if (!m_benchmark.m_headless) {
+            GLITTER_PROFILE_SCOPE("Swap");
+            glfwSwapBuffers(m_window);
+        }
+        m_framePacer.EndFrame(m_framePacing, inputTime);
+        m_glTrace.EndFrame();
+
+        // The frame time is the previous frame's, the latest FrameStats ended.
+        if (m_telemetry.IsOpen() && m_frameStats.GetHistoryCount() > 0) {
+            const Glitter::Render::RenderCounters& counters = m_renderStats.GetCounters();
+            const auto& history = m_frameStats.GetHistory();
+            m_telemetry.Submit(Glitter::Core::TelemetrySample {
+                .m_frameMilliseconds = history[(m_frameStats.GetHistoryOffset() + history.size() - 1) % history.size()],
+                .m_drawCalls = static_cast<std::uint32_t>(counters.m_drawCalls),
+                .m_triangles = static_cast<std::uint64_t>(counters.m_triangles),
+                .m_nodes = static_cast<std::uint32_t>(m_nodes.Size()),
+                .m_culledNodes = static_cast<std::uint32_t>(packet.m_culledNodes)});
+        }
+    }
+
+    // Hands a frame read back by m_frameReadback to the frame output when capturing every frame, or to its served scene's,
+    // or writes it as a screenshot.
+    void WriteCapture(const Glitter::Render::ReadbackImage& image)
+    {
+        GLITTER_PROFILE_SCOPE("Write Capture");
+        Glitter::Core::FramePixels frame {.m_width = static_cast<std::uint32_t>(image.m_width),
+            .m_height = static_cast<std::uint32_t>(image.m_height),
+            .m_pixels = image.m_pixels};
+        if (!m_servedScenes.empty()) {
+            ServedScene& scene = m_servedScenes[Glitter::Core::GetServedFrameScene(image.m_frame)];
+            if (scene.m_output) {
+                scene.m_output->Write(Glitter::Core::GetServedFrameIndex(image.m_frame), frame);
+            }
+            return;
+        }
+        if (m_frameOutput.IsOpen()) {
+            m_frameOutput.Write(image.m_frame, frame);
+            return;
+        }
+
+        std::filesystem::path path = std::filesystem::path(Glitter::Config::SCREENSHOT_DIRECTORY)
+            / std::format("screenshot_{}_{}.png", std::time(nullptr), image.m_frame);
+        if (Glitter::Core::WriteFrameImage(path, Glitter::Core::FrameOutputFormat::Png, frame)) {
+            spdlog::info("Captured the frame into {}.", path.string());
+        } else {
+            spdlog::error("Failed to write the captured frame {}.", path.string());
+        }
+    }
+
+    // Adds `count` Nodes with random positions, m_spawnableMeshes and textures. Does nothing until a Mesh has been loaded.
+    void SpawnNodes(size_t count)
+    {
+        if (m_spawnableMeshes.empty()) {
+            return;
+        }
+
+        auto meshCount = static_cast<std::uint32_t>(m_spawnableMeshes.size());
+        auto textureCount = static_cast<std::uint32_t>(m_textureCount);
+        bool animate = m_animateSpawnedNodes;
+        SpawnNodes(count, [&](size_t /*nodeIdx*/, Glitter::Util::Pcg32& rng) {
+            std::uint32_t meshID = m_spawnableMeshes[rng.NextBelow(meshCount)];
+            return Glitter::Scene::NodeDesc {.m_position = rng.NextDirection() * 11.25f,
+                .m_rotation = glm::angleAxis(rng.NextFloat() * glm::two_pi<float>(), rng.NextDirection()),
+                .m_scale = glm::vec3(0.25f),
+                .m_meshID = meshID,
+                .m_textureID = rng.NextBelow(textureCount),
+                .m_materialID = m_meshes[meshID].m_materialID,
+                .m_opacity = 1.0f,
+                .m_shouldAnimate = animate,
+                .m_animationPhase = 0.0f};
+        });
+    }
 
-        // Attach the textures to the FBO.
-        glNamedFramebufferTexture(fbo, GL_COLOR_ATTACHMENT0, fboColor, 0);
-        glNamedFramebufferRenderbuffer(fbo, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, fboDepth);
+    // Adds `count` Nodes from `generator`, initialized in parallel and appended at once, see
+    // Glitter::Scene::GenerateNodes(). Their streams are seeded from the global RNG, so that a seeded run spawns the same
+    // Nodes.
+    void SpawnNodes(size_t count, const Glitter::Scene::NodeGenerator& generator)
+    {
+        GLITTER_PROFILE_SCOPE("Spawn Nodes");
+        auto seed = static_cast<std::uint64_t>(std::rand());
+        Glitter::Scene::GeneratedScene nodes
+            = Glitter::Scene::GenerateNodes(count, Glitter::Config::SPAWN_GRAIN_SIZE, seed, m_jobSystem, generator);
+        m_nodes.Append(nodes.GetArrays());
+    }
+
+    // Replaces the Nodes with a scene generated from `settings`, see Glitter::Scene::GenerateScene().
+    void GenerateStressScene(const Glitter::Scene::SceneGeneratorSettings& settings)
+    {
+        GLITTER_PROFILE_SCOPE("Generate Scene");
+        std::vector<std::uint32_t> meshMaterialIDs {};
+        for (std::uint32_t meshID : m_spawnableMeshes) {
+            meshMaterialIDs.push_back(m_meshes[meshID].m_materialID);
+        }
+        Glitter::Scene::GeneratedScene scene
+            = Glitter::Scene::GenerateScene(settings, meshMaterialIDs, m_textureCount, m_materials.size(), m_jobSystem);
+        // The generated Nodes index m_spawnableMeshes.
+        for (std::uint32_t& meshID : scene.m_meshIDs) {
+            meshID = m_spawnableMeshes[meshID];
+        }
+
+        m_nodes.Clear();
+        m_worldStreaming = false;
+        m_nodes.Append(scene.GetArrays());
+        spdlog::info("Generated a scene of {} Nodes.", m_nodes.Size());
+    }
+
+    // Spawns `count` Nodes swirling around the origin, simulated on the GPU from then on, see SimulateSwarm().
+    void SpawnSwarm(size_t count)
+    {
+        if (m_spawnableMeshes.empty()) {
+            return;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            size_t meshID = m_spawnableMeshes[std::rand() % m_spawnableMeshes.size()];
+            glm::vec3 position = glm::sphericalRand(Glitter::Config::SWARM_RADIUS);
+            glm::quat rotation = glm::angleAxis(glm::linearRand(0.0f, glm::two_pi<float>()), glm::sphericalRand(1.0f));
+            glm::vec3 scale {0.25f};
+            Glitter::Scene::NodeHandle handle = m_nodes.Add(Glitter::Scene::NodeDesc {.m_position = position,
+                .m_rotation = rotation,
+                .m_scale = scale,
+                .m_meshID = meshID,
+                .m_textureID = std::rand() % m_textureCount,
+                .m_materialID = m_meshes[meshID].m_materialID,
+                .m_opacity = 1.0f,
+                .m_shouldAnimate = false,
+                .m_animationPhase = 0.0f});
+            auto nodeIdx = static_cast<std::uint32_t>(m_nodes.GetNode(handle));
+            m_nodes.Flags()[nodeIdx] |= Glitter::Scene::NodeFlags::SIMULATED;
+
+            // The Node's drawn model matrix and bounds are offset from its translation by its rotated and scaled Mesh.
+            const Mesh& mesh = m_meshes[meshID];
+            glm::mat3 rotationScale = glm::mat3_cast(rotation) * glm::mat3(glm::scale(glm::mat4(1.0f), scale));
+            glm::vec3 localCenter = (mesh.m_aabb.m_localMin + mesh.m_aabb.m_localMax) * 0.5f;
+            std::uint32_t agent = m_nodeSwarm.Add(
+                Glitter::Render::SwarmAgentDesc {.m_position = position,
+                    .m_velocity = glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), position) * 0.2f + glm::ballRand(0.5f),
+                    .m_phase = glm::linearRand(0.0f, glm::two_pi<float>()),
+                    .m_fadeSpeed = glm::linearRand(0.25f, 1.0f),
+                    .m_modelOffset = rotationScale * glm::vec3(mesh.m_dequantize[3]),
+                    .m_boundsOffset = rotationScale * localCenter},
+                nodeIdx);
+            if (agent >= m_swarmHandles.size()) {
+                m_swarmHandles.resize(agent + 1);
+            }
+            m_swarmHandles[agent] = handle;
+        }
+    }
+
+    // Removes every Node of the swarm.
+    void ClearSwarm()
+    {
+        for (const std::optional<Glitter::Scene::NodeHandle>& handle : m_swarmHandles) {
+            if (handle) {
+                m_nodes.Remove(*handle);
+            }
+        }
+        m_swarmHandles.clear();
+        m_nodeSwarm.Clear();
+    }
+
+    // Advances the swarm by this frame's simulation steps on the GPU, over the data just uploaded for its Nodes, which
+    // holds their spawn transforms. Its agents are pointed at their Nodes again whenever Nodes were added or removed.
+    void SimulateSwarm()
+    {
+        GLITTER_PROFILE_SCOPE("Swarm");
+        if (m_swarmRevision != m_nodes.GetRevision()) {
+            m_nodeSwarm.Remap([&](std::uint32_t agent) -> std::optional<std::uint32_t> {
+                std::optional<Glitter::Scene::NodeHandle>& handle = m_swarmHandles[agent];
+                if (handle && m_nodes.IsValid(*handle)) {
+                    return static_cast<std::uint32_t>(m_nodes.GetNode(*handle));
+                }
+                handle.reset();
+                return std::nullopt;
+            });
+            m_swarmRevision = m_nodes.GetRevision();
+        }
+
+        // The culling pass and the draws read the simulated data.
+        if (m_nodeSwarm.GetAgentCount() > 0) {
+            m_nodeSwarm.Simulate(m_renderStats, m_swarmProgram, m_nodeDataBuffer.GetBuffers(), m_nodeBoundsBuffer.GetBuffers(),
+                static_cast<std::uint32_t>(m_simulationSteps), static_cast<float>(Glitter::Config::SIMULATION_TIME_STEP));
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        }
+    }
+
+    // Drops the skinned Nodes removed from m_nodes along with their Meshes, and the skeletons none of them are left on.
+    void RemoveStaleSkinnedNodes()
+    {
+        std::erase_if(m_skinnedNodes, [&](const SkinnedNode& skinned) {
+            if (m_nodes.IsValid(skinned.m_handle)) {
+                return false;
+            }
+            m_skinnedMeshes.Remove(skinned.m_instance);
+            m_meshes.Remove(skinned.m_mesh);
+            return true;
+        });
+        std::vector<bool> skinnedSkeletons(m_skeletons.GetInstanceCount());
+        for (const SkinnedNode& skinned : m_skinnedNodes) {
+            skinnedSkeletons[skinned.m_skeleton] = true;
+        }
+        for (size_t skeleton = 0; skeleton < skinnedSkeletons.size(); skeleton++) {
+            if (!skinnedSkeletons[skeleton]) {
+                m_skeletons.Remove(static_cast<std::uint32_t>(skeleton));
+            }
+        }
+    }
+
+    // Streams the Mesh LODs requested by the Nodes of `packet` in and out of the geometry pool, see
+    // Config::ENABLE_MESH_STREAMING, and points the streamed Primitives at the levels left resident. The GPU culling pass
+    // doesn't read back which Nodes it draws, and only draws the Primitives in full, so it requests every Primitive in
+    // full. Runs before the next packet's update, which reads the Primitives.
+    void StreamMeshLods(const FramePacket& packet)
+    {
+        if (!Glitter::Config::ENABLE_MESH_STREAMING) {
+            return;
+        }
+
+        GLITTER_PROFILE_SCOPE("Mesh Streaming");
+        for (const MeshRequest& request : packet.m_meshRequests) {
+            std::uint32_t resolution = request.m_lod == 0 ? Glitter::Render::MESH_FULL_RESOLUTION
+                                                          : Glitter::Config::MESH_LOD_RESOLUTION >> (request.m_lod - 1);
+            for (const Primitive& primitive : m_meshes[request.m_mesh].m_primitives) {
+                if (primitive.m_streamedSlot != NO_STREAMED_LODS) {
+                    m_meshStreamer.Request(primitive.m_streamedSlot, resolution);
+                }
+            }
+        }
+        for (size_t meshID = 0; packet.m_gpuCulling && meshID < m_meshes.Size(); meshID++) {
+            if (!m_meshes.IsLive(meshID)) {
+                continue;
+            }
+            for (const Primitive& primitive : m_meshes[meshID].m_primitives) {
+                if (primitive.m_streamedSlot != NO_STREAMED_LODS) {
+                    m_meshStreamer.Request(primitive.m_streamedSlot, Glitter::Render::MESH_FULL_RESOLUTION);
+                }
+            }
+        }
+        if (!m_meshStreamer.Update(m_geometryPool)) {
+            return;
+        }
+
+        // The Primitives draw the added levels right away. Growing the pool copies the buffers, so the Mesh writes still in
+        // flight on the upload context have to land first.
+        if (m_uploadContext.IsRunning() && m_geometryPool.NeedsReallocation()) {
+            m_uploadContext.Finish();
+        }
+        if (m_geometryPool.Upload()) {
+            Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::BUFFER_GROWTH);
+            AttachGeometryPool();
+            m_renderStats.InvalidateState();
+        }
+        for (Mesh& mesh : m_meshes) {
+            for (Primitive& primitive : mesh.m_primitives) {
+                if (primitive.m_streamedSlot != NO_STREAMED_LODS) {
+                    ApplyStreamedLods(primitive);
+                }
+            }
+        }
+        UploadMeshTables();
+    }
+
+    // Skins the skinned Nodes' vertices by the packet's skinning matrices, before any pass draws them or a static batch
+    // copies them. The skinned Nodes removed since are dropped first, and the skeletons none of them are left on.
+    void SkinMeshes(const FramePacket& packet)
+    {
+        GLITTER_PROFILE_SCOPE("Skinning");
+        m_skinnedMeshes.BeginFrame(m_geometryPool);
+        if (m_skinnedRevision != m_nodes.GetRevision()) {
+            RemoveStaleSkinnedNodes();
+            m_skinnedRevision = m_nodes.GetRevision();
+        }
+        if (m_skinnedMeshes.IsEmpty()) {
+            return;
+        }
+
+        // The skinned vertices were only allocated so far. Growing the pool copies the buffers, so the Mesh writes still in
+        // flight on the upload context have to land first.
+        if (m_uploadContext.IsRunning() && m_geometryPool.NeedsReallocation()) {
+            m_uploadContext.Finish();
+        }
+        if (m_geometryPool.Reserve()) {
+            Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::BUFFER_GROWTH);
+            AttachGeometryPool();
+            m_renderStats.InvalidateState();
+        }
+
+        // The passes fetch the skinned vertices as attributes, or pull them from the VBO.
+        m_skinnedMeshes.Dispatch(m_renderStats, m_skinProgram, m_geometryPool, packet.m_skinMatrices);
+        glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    // Adds the Nodes of the world chunks that landed around the camera, and removes the ones of the chunks it left behind,
+    // see Glitter::Scene::WorldStreamer. A chunk waits for the assets it draws to be registered, requested the first time
+    // a chunk needs them.
+    void StreamWorld()
+    {
+        GLITTER_PROFILE_SCOPE("Stream World");
+        if (!m_worldStreaming) {
+            if (m_worldStreamer.IsOpen()) {
+                CloseWorld();
+            }
+            return;
+        }
+        if (!m_worldStreamer.IsOpen() && !OpenWorld()) {
+            m_worldStreaming = false;
+            return;
+        }
+
+        std::vector<std::uint32_t> unloaded {};
+        m_worldStreamer.Update(
+            m_currentState.m_eyePos, Glitter::Config::WORLD_LOAD_RADIUS, Glitter::Config::WORLD_UNLOAD_RADIUS, unloaded);
+        for (std::uint32_t chunk : unloaded) {
+            if (auto nodes = m_worldChunkNodes.find(chunk); nodes != m_worldChunkNodes.end()) {
+                for (Glitter::Scene::NodeHandle handle : nodes->second) {
+                    m_nodes.Remove(handle);
+                }
+                m_worldChunkNodes.erase(nodes);
+            }
+            std::erase_if(
+                m_pendingWorldChunks, [&](const Glitter::Scene::WorldChunk& pending) { return pending.m_chunk == chunk; });
+        }
+
+        while (std::optional<Glitter::Scene::WorldChunk> chunk = m_worldStreamer.Poll()) {
+            m_pendingWorldChunks.push_back(std::move(*chunk));
+        }
+        size_t addedChunks = 0;
+        std::erase_if(m_pendingWorldChunks, [&](const Glitter::Scene::WorldChunk& chunk) {
+            if (addedChunks == Glitter::Config::WORLD_CHUNKS_PER_FRAME || !AddWorldChunk(chunk)) {
+                return false;
+            }
+            addedChunks++;
+            return true;
+        });
+    }
+
+    // Adds the Nodes of `chunk`, or returns false if an asset they draw isn't registered yet.
+    bool AddWorldChunk(const Glitter::Scene::WorldChunk& chunk)
+    {
+        std::span<const std::string> assetPaths = m_worldStreamer.GetAssetPaths();
+        std::vector<std::optional<AssetMeshes>> assets(assetPaths.size());
+        bool ready = true;
+        for (size_t assetIdx = 0; assetIdx < assetPaths.size(); assetIdx++) {
+            auto registered = m_assetMeshes.find(assetPaths[assetIdx]);
+            if (registered == m_assetMeshes.end()) {
+                RequestAsset(assetPaths[assetIdx]);
+                ready = false;
+            } else if (!registered->second) {
+                ready = false;
+            } else {
+                assets[assetIdx] = registered->second;
+            }
+        }
+        if (!ready) {
+            return false;
+        }
+
+        std::vector<Glitter::Scene::NodeHandle>& handles = m_worldChunkNodes[chunk.m_chunk];
+        for (const Glitter::Scene::WorldNode& node : chunk.m_nodes) {
+            if (node.m_asset >= assets.size() || assets[node.m_asset]->m_meshCount == 0) {
+                continue;
+            }
+            size_t meshID = assets[node.m_asset]->m_firstMesh + node.m_mesh % assets[node.m_asset]->m_meshCount;
+            handles.push_back(m_nodes.Add(Glitter::Scene::NodeDesc {.m_position = node.m_position,
+                .m_rotation = node.m_rotation,
+                .m_scale = node.m_scale,
+                .m_meshID = meshID,
+                .m_textureID = node.m_texture % m_textureCount,
+                .m_materialID = m_meshes[meshID].m_materialID,
+                .m_opacity = 1.0f,
+                .m_shouldAnimate = false,
+                .m_animationPhase = 0.0f}));
+        }
+        return true;
+    }
+
+    // Opens the streamed world, generating it first if it doesn't exist yet.
+    bool OpenWorld()
+    {
+        const char* path = Glitter::Config::WORLD_PATH;
+        if (!std::filesystem::exists(path)) {
+            spdlog::info("Generating the world {}.", path);
+            std::vector<std::vector<Glitter::Scene::WorldNode>> chunks(
+                static_cast<size_t>(Glitter::Config::WORLD_CHUNKS) * Glitter::Config::WORLD_CHUNKS);
+            float min = -Glitter::Config::WORLD_CHUNK_SIZE * static_cast<float>(Glitter::Config::WORLD_CHUNKS) * 0.5f;
+            for (size_t chunkIdx = 0; chunkIdx < chunks.size(); chunkIdx++) {
+                glm::vec2 chunkMin = glm::vec2(min)
+                    + glm::vec2(static_cast<float>(chunkIdx % Glitter::Config::WORLD_CHUNKS),
+                          static_cast<float>(chunkIdx / Glitter::Config::WORLD_CHUNKS))
+                        * Glitter::Config::WORLD_CHUNK_SIZE;
+                for (size_t nodeIdx = 0; nodeIdx < Glitter::Config::WORLD_NODES_PER_CHUNK; nodeIdx++) {
+                    glm::vec2 position = chunkMin + glm::linearRand(glm::vec2(0.0f), glm::vec2(Glitter::Config::WORLD_CHUNK_SIZE));
+                    chunks[chunkIdx].push_back(Glitter::Scene::WorldNode {
+                        .m_position = glm::vec3(position.x, glm::linearRand(-1.5f, 1.5f), position.y),
+                        .m_rotation = glm::angleAxis(glm::linearRand(0.0f, glm::two_pi<float>()), glm::vec3(0.0f, 1.0f, 0.0f)),
+                        .m_scale = glm::vec3(0.25f),
+                        .m_asset = 0,
+                        .m_mesh = static_cast<std::uint32_t>(std::rand()),
+                        .m_texture = static_cast<std::uint32_t>(std::rand())});
+                }
+            }
+            std::array assetPaths {std::string("meshes/teapot.glb")};
+            if (!Glitter::Scene::WriteWorld(path, Glitter::Config::WORLD_CHUNK_SIZE, Glitter::Config::WORLD_CHUNKS,
+                    Glitter::Config::WORLD_CHUNKS, assetPaths, chunks)) {
+                spdlog::error("Failed to write the world {}.", path);
+                return false;
+            }
+        }
+        return m_worldStreamer.Open(path);
+    }
+
+    // Removes the Nodes of every chunk, and forgets about the streamed world.
+    void CloseWorld()
+    {
+        for (const auto& [chunk, handles] : m_worldChunkNodes) {
+            for (Glitter::Scene::NodeHandle handle : handles) {
+                m_nodes.Remove(handle);
+            }
+        }
+        m_worldChunkNodes.clear();
+        m_pendingWorldChunks.clear();
+        m_worldStreamer.Close();
+    }
+
+    // Saves the Nodes into the scene snapshot at `path`, but the swarm's and the skinned ones, whose Meshes have no asset.
+    void SaveSceneSnapshot(const char* path)
+    {
+        GLITTER_PROFILE_SCOPE("Save Scene Snapshot");
+        std::vector<std::string> assetPaths {};
+        std::vector<Glitter::Scene::SnapshotMesh> meshes(
+            m_meshes.Size(), Glitter::Scene::SnapshotMesh {.m_asset = Glitter::Scene::NO_SNAPSHOT_ASSET, .m_mesh = 0});
+        for (const auto& [assetPath, assetMeshes] : m_assetMeshes) {
+            if (!assetMeshes || assetMeshes->m_meshCount == 0) {
+                continue;
+            }
+            auto asset = static_cast<std::uint32_t>(assetPaths.size());
+            assetPaths.push_back(assetPath);
+            for (size_t meshIdx = 0; meshIdx < assetMeshes->m_meshCount; meshIdx++) {
+                meshes[assetMeshes->m_firstMesh + meshIdx]
+                    = Glitter::Scene::SnapshotMesh {.m_asset = asset, .m_mesh = static_cast<std::uint32_t>(meshIdx)};
+            }
+        }
+
+        Glitter::Scene::SceneSnapshot snapshot = Glitter::Scene::CaptureSceneSnapshot(m_nodes, assetPaths, meshes);
+        if (!Glitter::Scene::WriteSceneSnapshot(path, snapshot)) {
+            spdlog::error("Failed to write the scene snapshot {}.", path);
+            return;
+        }
+        spdlog::info("Saved {} of the {} Nodes into the scene snapshot {}.", snapshot.m_positions.size(), m_nodes.Size(), path);
+    }
+
+    // Reads the scene snapshot at `path`, whose Nodes replace the current ones once the assets they draw are registered,
+    // see AddSnapshotNodes().
+    bool LoadSceneSnapshot(const char* path)
+    {
+        GLITTER_PROFILE_SCOPE("Load Scene Snapshot");
+        m_pendingSnapshot = Glitter::Scene::ReadSceneSnapshot(path);
+        return m_pendingSnapshot.has_value();
+    }
+
+    // Replaces the Nodes with the ones of the loaded scene snapshot, all appended at once, or returns false if an asset
+    // they draw isn't registered yet. The snapshot is dropped if one of its assets failed to load.
+    bool AddSnapshotNodes()
+    {
+        if (!m_pendingSnapshot) {
+            return true;
+        }
+
+        const Glitter::Scene::SceneSnapshot& snapshot = *m_pendingSnapshot;
+        std::vector<AssetMeshes> assets {};
+        bool ready = true;
+        for (const std::string& path : snapshot.m_assetPaths) {
+            auto registered = m_assetMeshes.find(path);
+            if (registered == m_assetMeshes.end()) {
+                RequestAsset(path);
+                ready = false;
+            } else if (!registered->second) {
+                ready = false;
+            } else {
+                assets.push_back(*registered->second);
+            }
+        }
+        if (!ready) {
+            return false;
+        }
+        if (std::ranges::any_of(assets, [](const AssetMeshes& asset) { return asset.m_meshCount == 0; })) {
+            spdlog::error("Dropping the scene snapshot, one of the assets it draws failed to load.");
+            m_pendingSnapshot.reset();
+            return true;
+        }
 
-        if (glCheckNamedFramebufferStatus(fbo, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-            return PrepareResult::FramebufferIncomplete;
+        // Only the Mesh, texture and material IDs depend on what was loaded, the other arrays are appended as read.
+        GLITTER_PROFILE_SCOPE("Add Snapshot Nodes");
+        size_t nodeCount = snapshot.m_positions.size();
+        std::vector<std::uint32_t> meshIDs(nodeCount);
+        std::vector<std::uint32_t> textureIDs(nodeCount);
+        std::vector<std::uint32_t> materialIDs(nodeCount);
+        for (size_t nodeIdx = 0; nodeIdx < nodeCount; nodeIdx++) {
+            const Glitter::Scene::SnapshotMesh& mesh = snapshot.m_meshes[snapshot.m_meshIDs[nodeIdx]];
+            const AssetMeshes& asset = assets[mesh.m_asset];
+            size_t meshID = asset.m_firstMesh + mesh.m_mesh % asset.m_meshCount;
+            meshIDs[nodeIdx] = static_cast<std::uint32_t>(meshID);
+            textureIDs[nodeIdx] = static_cast<std::uint32_t>(snapshot.m_textureIDs[nodeIdx] % m_textureCount);
+            materialIDs[nodeIdx] = m_meshes[meshID].m_materialID;
         }
 
-        m_fbo = fbo;
-        m_fboColor = fboColor;
-        m_fboDepth = fboDepth;
+        m_nodes.Clear();
+        m_worldStreaming = false;
+        m_nodes.Append(Glitter::Scene::NodeArrays {.m_positions = snapshot.m_positions,
+            .m_rotations = snapshot.m_rotations,
+            .m_scales = snapshot.m_scales,
+            .m_opacities = snapshot.m_opacities,
+            .m_flags = snapshot.m_flags,
+            .m_animationPhases = snapshot.m_animationPhases,
+            .m_parents = snapshot.m_parents,
+            .m_meshIDs = meshIDs,
+            .m_textureIDs = textureIDs,
+            .m_materialIDs = materialIDs});
+        spdlog::info("Loaded the {} Nodes of a scene snapshot.", nodeCount);
+        m_pendingSnapshot.reset();
+        return true;
+    }
 
-        return PrepareResult::Ok;
+    // Removes up to `count` random Nodes.
+    void RemoveNodes(size_t count)
+    {
+        for (size_t i = 0; i < count && !m_nodes.Empty(); i++) {
+            m_nodes.Remove(m_nodes.GetHandle(static_cast<size_t>(std::rand()) % m_nodes.Size()));
+        }
     }
 
-    void Tick()
+    // Samples the frame time, the latest CPU and GPU scope times and the render counters, then writes the results and closes the
+    // window once every benchmark frame has run. CPU scopes with the same name are summed over every thread.
+    void RecordBenchmarkFrame()
     {
-        glfwPollEvents();
+        auto now = std::chrono::steady_clock::now();
+        double frameMilliseconds = std::chrono::duration<double, std::milli>(now - m_benchmarkFrameStart).count();
+        m_benchmarkFrameStart = now;
+
+        m_benchmarkFrame++;
+        if (m_benchmarkFrame <= Glitter::Config::BENCHMARK_WARMUP_FRAMES) {
+            if (m_benchmarkFrame == Glitter::Config::BENCHMARK_WARMUP_FRAMES && m_benchmarkCamera) {
+                StartCameraPlayback(std::move(*m_benchmarkCamera));
+                m_benchmarkCamera.reset();
+            }
+            if (m_benchmarkFrame == Glitter::Config::BENCHMARK_WARMUP_FRAMES) {
+                m_glTrace.TriggerCapture();
+            }
+            return;
+        }
+
+        m_benchmarkRecorder.AddSample("frame", frameMilliseconds);
+        if (Glitter::Config::ENABLE_ALLOCATION_TRACKING) {
+            m_benchmarkRecorder.AddSample("allocations", static_cast<double>(m_frameAllocations.m_allocations));
+            m_benchmarkRecorder.AddSample("allocated_bytes", static_cast<double>(m_frameAllocations.m_bytes));
+            if (m_frameAllocations.m_allocations > 0) {
+                m_allocatingBenchmarkFrames++;
+            }
+        }
 
-        // Clear Debug data.
-        m_debugData.Clear();
+        std::pmr::vector<std::pair<std::string_view, double>> cpuScopes(&m_frameArena);
+        for (const auto& thread : m_cpuProfiler.GetFrame()) {
+            for (const auto& event : thread.m_events) {
+                auto name = std::string_view(event.m_name);
+                auto it = std::ranges::find(cpuScopes, name, [](const auto& scope) { return scope.first; });
+                if (it == cpuScopes.end()) {
+                    it = cpuScopes.emplace(cpuScopes.end(), name, 0.0);
+                }
+                it->second += static_cast<double>(event.m_end - event.m_begin) / 1e6;
+            }
+        }
+        for (const auto& [name, milliseconds] : cpuScopes) {
+            m_benchmarkRecorder.AddSample(std::format("cpu:{}", name), milliseconds);
+        }
+        for (const auto& scope : m_gpuProfiler.GetScopes()) {
+            m_benchmarkRecorder.AddSample(std::format("gpu:{}", scope.m_name), scope.m_milliseconds);
+        }
 
-        // Start Dear ImGui frame.
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-        ImGui::NewFrame();
+        const Glitter::Render::RenderCounters& counters = m_renderStats.GetCounters();
+        m_benchmarkRecorder.AddSample("draw_calls", static_cast<double>(counters.m_drawCalls));
+        m_benchmarkRecorder.AddSample("draw_commands", static_cast<double>(counters.m_drawCommands));
+        m_benchmarkRecorder.AddSample("triangles", static_cast<double>(counters.m_triangles));
+        m_benchmarkRecorder.AddSample("program_binds", static_cast<double>(counters.m_programBinds));
+        m_benchmarkRecorder.AddSample("vao_binds", static_cast<double>(counters.m_vertexArrayBinds));
+        m_benchmarkRecorder.AddSample("buffer_binds", static_cast<double>(counters.m_bufferBinds));
+        m_benchmarkRecorder.AddSample("texture_binds", static_cast<double>(counters.m_textureBinds));
+        m_benchmarkRecorder.AddSample("state_changes", static_cast<double>(counters.m_stateChanges));
+        m_benchmarkRecorder.AddSample("redundant_calls", static_cast<double>(counters.m_redundantCalls));
+        m_benchmarkRecorder.AddSample("uploaded_bytes", static_cast<double>(counters.m_uploadedBytes));
+        const Glitter::Render::PipelineStatistics& statistics = m_renderStats.GetPipelineStatistics();
+        m_benchmarkRecorder.AddSample("primitives_submitted", static_cast<double>(statistics.m_primitivesSubmitted));
+        m_benchmarkRecorder.AddSample("vs_invocations", static_cast<double>(statistics.m_vertexShaderInvocations));
+        m_benchmarkRecorder.AddSample("clipping_input_primitives", static_cast<double>(statistics.m_clippingInputPrimitives));
+        m_benchmarkRecorder.AddSample("clipping_output_primitives", static_cast<double>(statistics.m_clippingOutputPrimitives));
+        m_benchmarkRecorder.AddSample("fs_invocations", static_cast<double>(statistics.m_fragmentShaderInvocations));
+        constexpr double MIB = 1024.0 * 1024.0;
+        std::array<Glitter::Render::GpuMemoryUsage, Glitter::Render::GPU_MEMORY_CATEGORY_COUNT> gpuMemory =
+            Glitter::Render::GetGpuMemoryUsage();
+        for (size_t categoryIdx = 0; categoryIdx < gpuMemory.size(); categoryIdx++) {
+            auto category = static_cast<Glitter::Render::GpuMemoryCategory>(categoryIdx);
+            m_benchmarkRecorder.AddSample(std::format("gpu_memory_mib:{}", Glitter::Render::GetGpuMemoryCategoryName(category)),
+                static_cast<double>(gpuMemory[categoryIdx].m_bytes) / MIB);
+        }
+        if (std::optional<Glitter::Render::GpuMemoryInfo> memoryInfo = Glitter::Render::QueryGpuMemoryInfo()) {
+            m_benchmarkRecorder.AddSample("gpu_memory_available_mib", static_cast<double>(memoryInfo->m_availableBytes) / MIB);
+        }
 
-        for (Node& node : m_nodes) {
-            if (node.m_shouldAnimate) {
-                node.m_opacity = std::clamp(std::abs(1.25f * std::cosf(static_cast<float>(glfwGetTime()))), 0.0f, 1.0f);
+        if (m_benchmarkFrame == Glitter::Config::BENCHMARK_WARMUP_FRAMES + m_benchmark.m_frameCount) {
+            if (m_benchmarkRecorder.WriteCsv(m_benchmark.m_outputPath)) {
+                spdlog::info("Wrote the benchmark results to {}.", m_benchmark.m_outputPath.string());
+            } else {
+                spdlog::error("Failed to write the benchmark results to {}.", m_benchmark.m_outputPath.string());
+                m_benchmarkFailed = true;
             }
+            // The steady-state frames are expected to reuse what the warmup allocated.
+            if (m_allocatingBenchmarkFrames > 0) {
+                spdlog::error("{} of the {} benchmark frames allocated memory, see the allocations in the results.",
+                    m_allocatingBenchmarkFrames, m_benchmark.m_frameCount);
+                m_benchmarkFailed = true;
+            }
+            glfwSetWindowShouldClose(m_window, true);
         }
     }
 
-    void Render()
+    // Draws the CPU scopes of the previous frame in the "Glitter Profiler" window, as one row of nested bars per thread.
+    void DrawCpuTimeline()
     {
-        // Note: glClear() respects depth-write, therefore depth-write must be enabled to clear the depth buffer.
-        glDepthMask(GL_TRUE);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        ImGui::Begin("Glitter Profiler", &m_showCpuTimeline);
+
+        std::span<const Glitter::Core::ProfileThread> threads = m_cpuProfiler.GetFrame();
+        std::uint64_t frameBegin = UINT64_MAX;
+        std::uint64_t frameEnd = 0;
+        for (const auto& thread : threads) {
+            for (const auto& event : thread.m_events) {
+                frameBegin = std::min(frameBegin, event.m_begin);
+                frameEnd = std::max(frameEnd, event.m_end);
+            }
+        }
+        if (frameBegin >= frameEnd) {
+            ImGui::TextUnformatted("No CPU scopes were recorded.");
+            ImGui::End();
+            return;
+        }
+        ImGui::Text("Frame: %.3f ms", static_cast<double>(frameEnd - frameBegin) / 1e6);
+
+        constexpr float ROW_HEIGHT = 18.0f;
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        float width = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+        float scale = width / static_cast<float>(frameEnd - frameBegin);
+        const Glitter::Core::ProfileEvent* hovered = nullptr;
+        for (const auto& thread : threads) {
+            if (thread.m_events.empty()) {
+                continue;
+            }
+            ImGui::SeparatorText(thread.m_name.c_str());
+
+            ImVec2 origin = ImGui::GetCursorScreenPos();
+            std::uint32_t maxDepth = 0;
+            for (const auto& event : thread.m_events) {
+                maxDepth = std::max(maxDepth, event.m_depth);
+
+                auto barMin = ImVec2(origin.x + static_cast<float>(event.m_begin - frameBegin) * scale,
+                    origin.y + static_cast<float>(event.m_depth) * ROW_HEIGHT);
+                auto barMax = ImVec2(std::max(origin.x + static_cast<float>(event.m_end - frameBegin) * scale, barMin.x + 1.0f),
+                    barMin.y + ROW_HEIGHT - 1.0f);
+
+                // Color each scope by its name, so that it's recognizable between threads and frames.
+                auto hash = static_cast<std::uint32_t>(std::hash<std::string_view> {}(event.m_name));
+                ImU32 color = IM_COL32(64 + hash % 128, 64 + (hash >> 8) % 128, 64 + (hash >> 16) % 128, 255);
+                drawList->AddRectFilled(barMin, barMax, color);
+                drawList->PushClipRect(barMin, barMax, true);
+                drawList->AddText(ImVec2(barMin.x + 2.0f, barMin.y + 2.0f), IM_COL32_WHITE, event.m_name);
+                drawList->PopClipRect();
+
+                if (ImGui::IsMouseHoveringRect(barMin, barMax) && (!hovered || event.m_depth > hovered->m_depth)) {
+                    hovered = &event;
+                }
+            }
+            ImGui::Dummy(ImVec2(width, static_cast<float>(maxDepth + 1) * ROW_HEIGHT));
+        }
 
-        // Clear the UBO CPU-backing buffer.
-        m_uboAllocator.Clear();
+        if (hovered) {
+            if (Glitter::Config::ENABLE_ALLOCATION_TRACKING) {
+                ImGui::SetTooltip("%s: %.3f ms, %llu allocations (%llu bytes)", hovered->m_name,
+                    static_cast<double>(hovered->m_end - hovered->m_begin) / 1e6,
+                    static_cast<unsigned long long>(hovered->m_allocations.m_allocations),
+                    static_cast<unsigned long long>(hovered->m_allocations.m_bytes));
+            } else {
+                ImGui::SetTooltip("%s: %.3f ms", hovered->m_name, static_cast<double>(hovered->m_end - hovered->m_begin) / 1e6);
+            }
+        }
+        ImGui::End();
+    }
 
-        // Calculate View and Projection.
-        glm::vec3 eyePos = glm::vec3(std::sin(glfwGetTime()), 2.5f, -3.5f);
-        glm::mat4 view = glm::lookAt(eyePos, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        glm::mat4 projection = glm::perspective(
-            glm::radians(45.0f), static_cast<float>(m_windowWidth) / static_cast<float>(m_windowHeight), 1.0f, 20.0f);
-        m_currentView = view;
-        m_currentProjection = projection;
+    // Draws the messages logged by every thread in the "Glitter Log" window, colored by level, following the newest.
+    void DrawLog()
+    {
+        ImGui::Begin("Glitter Log", &m_showLog);
+        if (size_t dropped = m_logForwarder.GetDroppedCount(); dropped > 0) {
+            ImGui::Text("%zu messages dropped", dropped);
+        }
+        if (size_t dropped = Glitter::Core::GetDroppedLogCount(); dropped > 0) {
+            ImGui::Text("%zu messages dropped by the logging thread", dropped);
+        }
 
-        // Extract the frustum planes using the VP matrix.
-        // By using the combined View and Projection matrices, we should obtain the clipping planes in World Space.
-        // Proj: (View Space)  -> (Clip Space);
-        // View: (World Space) -> (View Space);
-        //   VP: (World Space) -> (Clip Space).
-        struct Plane {
-            float a, b, c, d;
-        };
-        std::array<Plane, 6> frustumPlanes {};
-        glm::mat4 vp = projection * view;
-        {
-            Plane left {.a = vp[0][3] + vp[0][0], .b = vp[1][3] + vp[1][0], .c = vp[2][3] + vp[2][0], .d = vp[3][3] + vp[3][0]};
-            Plane right {.a = vp[0][3] - vp[0][0], .b = vp[1][3] - vp[1][0], .c = vp[2][3] - vp[2][0], .d = vp[3][3] - vp[3][0]};
+        ImGui::BeginChild("Messages");
+        bool following = ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
+        for (const Glitter::Core::LogMessage& message : m_logForwarder.GetHistory()) {
+            ImVec4 color = ImGui::GetStyleColorVec4(ImGuiCol_Text);
+            if (message.m_level >= spdlog::level::err) {
+                color = ImVec4(1.0f, 0.4f, 0.4f, 1.0f);
+            } else if (message.m_level == spdlog::level::warn) {
+                color = ImVec4(1.0f, 0.8f, 0.3f, 1.0f);
+            } else if (message.m_level < spdlog::level::info) {
+                color = ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled);
+            }
+            spdlog::string_view_t level = spdlog::level::to_string_view(message.m_level);
+            ImGui::TextColored(color, "[%.*s] %s", static_cast<int>(level.size()), level.data(), message.m_text.c_str());
+        }
+        if (following) {
+            ImGui::SetScrollHereY(1.0f);
+        }
+        ImGui::EndChild();
+        ImGui::End();
+    }
 
-            Plane bottom {.a = vp[0][3] + vp[0][1], .b = vp[1][3] + vp[1][1], .c = vp[2][3] + vp[2][1], .d = vp[3][3] + vp[3][1]};
-            Plane top {.a = vp[0][3] - vp[0][1], .b = vp[1][3] - vp[1][1], .c = vp[2][3] - vp[2][1], .d = vp[3][3] - vp[3][1]};
+    PerDrawData MakePerDrawData(std::uint32_t node) const
+    {
+        std::uint32_t textureID = m_nodes.TextureIDs()[node];
+        bool animate = (m_nodes.Flags()[node] & Glitter::Scene::NodeFlags::ANIMATE) != 0;
+        glm::mat4 modelTranspose
+            = glm::transpose(m_nodes.Models()[node] * glm::aligned_mat4(m_meshes[m_nodes.MeshIDs()[node]].m_dequantize));
+        return PerDrawData {.m_modelRows = {modelTranspose[0], modelTranspose[1], modelTranspose[2]},
+            .m_textureHandle = m_textureMode == TextureMode::Bindless ? m_loadedTextureHandles[textureID] : 0,
+            .m_opacityOrPhase = animate ? m_nodes.AnimationPhases()[node] : m_nodes.Opacities()[node],
+            .m_packed = textureID | (m_nodes.MaterialIDs()[node] << NODE_DATA_TEXTURE_BITS) | (animate ? NODE_DATA_ANIMATE : 0)};
+    }
 
-            Plane near {.a = vp[0][3] + vp[0][2], .b = vp[1][3] + vp[1][2], .c = vp[2][3] + vp[2][2], .d = vp[3][3] + vp[3][2]};
-            Plane far {.a = vp[0][3] - vp[0][2], .b = vp[1][3] - vp[1][2], .c = vp[2][3] - vp[2][2], .d = vp[3][3] - vp[3][2]};
+    // Writes the Node slot of every entry of `nodes` into `drawNodes`, shared by every Primitive of its Mesh. The shaders
+    // fetch the Node's PerDrawData from the persistent Node data buffer through it. Runs of consecutive Nodes with the
+    // same Mesh and texture are drawn as one instanced command per Primitive, with baseInstance pointing at the run's
+    // first slot. `firstDraw` is the index of `drawNodes[0]` in the frame's SSBO region.
+    //
+    // Instancing a run draws each Primitive for every Node before the next Primitive, so when `preserveOrder` is set, runs
+    // are only formed for single-Primitive Meshes to keep the Nodes' draw order intact.
+    //
+    // The ranges of Config::DRAW_RECORD_GRAIN_SIZE entries are recorded concurrently on the job system, each into its own
+    // DrawRecording, then spliced in order into m_indirectCommands, merging the batches that meet at the seams. Only the
+    // runs crossing a seam are split, into one more command per Primitive.
+    std::pmr::vector<DrawBatch> BuildDrawBatches(
+        std::span<const DrawListEntry> nodes, std::span<GLuint> drawNodes, GLuint firstDraw, bool preserveOrder)
+    {
+        GLITTER_PROFILE_SCOPE("Build Draw Batches");
+        std::pmr::vector<DrawBatch> batches(&m_frameArena);
 
-            frustumPlanes[0] = left;
-            frustumPlanes[1] = right;
-            frustumPlanes[2] = bottom;
-            frustumPlanes[3] = top;
-            frustumPlanes[4] = near;
-            frustumPlanes[5] = far;
+        constexpr size_t grainSize = Glitter::Config::DRAW_RECORD_GRAIN_SIZE;
+        size_t rangeCount = (nodes.size() + grainSize - 1) / grainSize;
+        if (m_drawRecordings.size() < rangeCount) {
+            m_drawRecordings.resize(rangeCount);
         }
+        m_jobSystem.ParallelFor(nodes.size(), grainSize, [&](size_t begin, size_t end) {
+            GLITTER_PROFILE_SCOPE("Record Draw Batches");
+            RecordDrawBatches(nodes.subspan(begin, end - begin), drawNodes.subspan(begin, end - begin),
+                firstDraw + static_cast<GLuint>(begin), preserveOrder, m_drawRecordings[begin / grainSize]);
+        });
 
-        // Write the CommonData into the UBO-backing CPU buffer.
-        CommonData commonData = {.m_view = view,
-            .m_projection = projection,
-            .m_eyePos = glm::vec4(eyePos, 1.0),
-            .m_lightPos = glm::vec4(1.0, 0.5, -0.5, 1.0),
-            .m_lightColor = glm::vec4(1.0, 1.0, 1.0, 1.0)};
-        m_uboAllocator.Push(commonData);
-
-        // Write each Node's PerDrawData into the buffer.
-        int numCulledNodes = 0;
-        for (auto& node : m_nodes) {
-            // Don't bother writing data for a totally transparent Node.
-            if (node.m_opacity == 0.0f) {
-                continue;
+        for (size_t rangeIdx = 0; rangeIdx < rangeCount; rangeIdx++) {
+            const DrawRecording& recording = m_drawRecordings[rangeIdx];
+            size_t commandBase = m_indirectCommands.size();
+            for (const DrawBatch& batch : recording.m_batches) {
+                if (!batches.empty() && batches.back().m_program == batch.m_program
+                    && batches.back().m_texture == batch.m_texture && batches.back().m_page == batch.m_page
+                    && batches.back().m_nodePage == batch.m_nodePage) {
+                    batches.back().m_drawCount += batch.m_drawCount;
+                } else {
+                    batches.push_back(batch);
+                    batches.back().m_firstCommand += commandBase;
+                }
             }
+            m_indirectCommands.insert(m_indirectCommands.end(), recording.m_commands.begin(), recording.m_commands.end());
+            m_indirectCommandMeshes.insert(m_indirectCommandMeshes.end(), recording.m_meshIDs.begin(), recording.m_meshIDs.end());
+        }
 
-            if (m_frustumCulling) {
-                // Check if a `vec3` point is in the inside halfspace of a plane, for culling purposes.
-                auto isInsideHalfspace = [](glm::vec3& position, Plane& plane) {
-                    float d = (plane.a * position.x) + (plane.b * position.y) + (plane.c * position.z) + plane.d;
+        return batches;
+    }
 
-                    // Inside halfspace.
-                    return d > 0;
-                };
+    // Records the draw batches of `nodes` into `recording`, see BuildDrawBatches(). Only reads the Nodes and Meshes, so
+    // that ranges of a draw list can be recorded concurrently.
+    void RecordDrawBatches(std::span<const DrawListEntry> nodes, std::span<GLuint> drawNodes, GLuint firstDraw,
+        bool preserveOrder, DrawRecording& recording) const
+    {
+        recording.m_batches.clear();
+        recording.m_commands.clear();
+        recording.m_meshIDs.clear();
+        bool recordMeshes = m_batchCostSampler.IsEnabled();
 
-                // Obtain the AABB's scaled and translated transform.
-                auto aabbTransform = glm::mat4(1.0f);
-                aabbTransform = glm::scale(aabbTransform, node.m_scale);
-                aabbTransform = glm::translate(aabbTransform, node.m_position);
-
-                AABB aabb = m_meshes[node.m_meshID].m_aabb;
-                std::array aabbCorners = std::to_array({
-                    /* 0 */ glm::vec3 {aabb.m_localMin},
-                    /* 1 */ glm::vec3 {aabb.m_localMax.x, aabb.m_localMin.y, aabb.m_localMin.z},
-                    /* 2 */ glm::vec3 {aabb.m_localMin.x, aabb.m_localMax.y, aabb.m_localMin.z},
-                    /* 3 */ glm::vec3 {aabb.m_localMin.x, aabb.m_localMin.y, aabb.m_localMax.z},
-                    /* 4 */ glm::vec3 {aabb.m_localMax.x, aabb.m_localMin.y, aabb.m_localMax.z},
-                    /* 5 */ glm::vec3 {aabb.m_localMax.x, aabb.m_localMax.y, aabb.m_localMin.z},
-                    /* 6 */ glm::vec3 {aabb.m_localMin.x, aabb.m_localMax.y, aabb.m_localMax.z},
-                    /* 7 */ glm::vec3 {aabb.m_localMax},
-                });
+        std::span<const std::uint32_t> meshIDs = m_nodes.MeshIDs();
+        std::span<const std::uint32_t> textureIDs = m_nodes.TextureIDs();
+
+        for (size_t nodeIdx = 0; nodeIdx < nodes.size(); nodeIdx++) {
+            drawNodes[nodeIdx] = nodes[nodeIdx].m_node;
+        }
+
+        size_t runStart = 0;
+        while (runStart < nodes.size()) {
+            std::uint32_t runMeshID = meshIDs[nodes[runStart].m_node];
+            std::uint32_t runTextureID = textureIDs[nodes[runStart].m_node];
+            std::uint32_t runLod = nodes[runStart].m_lod;
+            std::uint32_t runProgram = Glitter::Render::DrawKey::GetProgram(nodes[runStart].m_sortKey);
+            std::uint32_t runNodePage = nodes[runStart].m_node / Glitter::Config::NODE_PAGE_SIZE;
+            const Mesh& mesh = m_meshes[runMeshID];
+
+            // Find the end of the run of Nodes that can share instanced draws.
+            size_t runEnd = runStart + 1;
+            if (!preserveOrder || mesh.m_primitives.size() == 1) {
+                while (runEnd < nodes.size() && meshIDs[nodes[runEnd].m_node] == runMeshID && nodes[runEnd].m_lod == runLod
+                    && Glitter::Render::DrawKey::GetProgram(nodes[runEnd].m_sortKey) == runProgram
+                    && nodes[runEnd].m_node / Glitter::Config::NODE_PAGE_SIZE == runNodePage
+                    && (m_textureMode != TextureMode::Bound || textureIDs[nodes[runEnd].m_node] == runTextureID)) {
+                    runEnd++;
+                }
+            }
+
+            // Start a new batch if the program, the bound texture, the geometry pool page or the Node data page changes.
+            // Bindless and array textures are selected from the PerDrawData instead, so every draw of a program on a page
+            // fits into a single batch.
+            GLuint batchTexture = m_textureMode == TextureMode::Bound ? m_loadedTextures[runTextureID] : 0;
+            std::vector<DrawBatch>& batches = recording.m_batches;
+            for (const auto& primitive : mesh.m_primitives) {
+                if (batches.empty() || batches.back().m_texture != batchTexture || batches.back().m_program != runProgram
+                    || batches.back().m_page != primitive.m_page || batches.back().m_nodePage != runNodePage) {
+                    batches.push_back(DrawBatch {.m_program = runProgram,
+                        .m_texture = batchTexture,
+                        .m_page = primitive.m_page,
+                        .m_nodePage = runNodePage,
+                        .m_firstCommand = recording.m_commands.size(),
+                        .m_drawCount = 0});
+                }
 
-                // Transform the corners in `aabbCorners` into world space.
-                for (auto& corner : aabbCorners) {
-                    corner = glm::vec3(aabbTransform * glm::vec4(corner, 1.0f));
-                }
-
-                // Draw each AABB's lines using PushDebugLine.
-                if (m_drawAABBs) {
-                    m_debugData.PushDebugLine(aabbCorners[0], aabbCorners[1]);
-                    m_debugData.PushDebugLine(aabbCorners[0], aabbCorners[2]);
-                    m_debugData.PushDebugLine(aabbCorners[0], aabbCorners[3]);
-                    m_debugData.PushDebugLine(aabbCorners[1], aabbCorners[4]);
-                    m_debugData.PushDebugLine(aabbCorners[1], aabbCorners[5]);
-                    m_debugData.PushDebugLine(aabbCorners[2], aabbCorners[5]);
-                    m_debugData.PushDebugLine(aabbCorners[2], aabbCorners[6]);
-                    m_debugData.PushDebugLine(aabbCorners[3], aabbCorners[4]);
-                    m_debugData.PushDebugLine(aabbCorners[3], aabbCorners[6]);
-                    m_debugData.PushDebugLine(aabbCorners[4], aabbCorners[7]);
-                    m_debugData.PushDebugLine(aabbCorners[5], aabbCorners[7]);
-                    m_debugData.PushDebugLine(aabbCorners[7], aabbCorners[6]);
-                }
-
-                // Check if any corners of the AABB are inside one of the viewing frustums. If so, don't cull that Node.
-                bool cullNode = true;
-                for (auto& corner : aabbCorners) {
-                    bool insideLeft = isInsideHalfspace(corner, frustumPlanes[0]);
-                    bool insideRight = isInsideHalfspace(corner, frustumPlanes[1]);
-                    bool insideBottom = isInsideHalfspace(corner, frustumPlanes[2]);
-                    bool insideTop = isInsideHalfspace(corner, frustumPlanes[3]);
-                    bool insideNear = isInsideHalfspace(corner, frustumPlanes[4]);
-                    bool insideFar = isInsideHalfspace(corner, frustumPlanes[5]);
-
-                    if (insideLeft && insideRight && insideBottom && insideTop && insideNear && insideFar) {
-                        cullNode = false;
+                // Use the coarsest LOD that still has the run's resolution, a Primitive may have skipped some levels.
+                GLuint firstIndex = primitive.m_firstIndex;
+                GLsizei elementCount = primitive.m_elementCount;
+                for (const PrimitiveLod& lod : primitive.m_lods) {
+                    if (runLod == 0 || lod.m_resolution < (Glitter::Config::MESH_LOD_RESOLUTION >> (runLod - 1))) {
                         break;
                     }
+                    firstIndex = lod.m_firstIndex;
+                    elementCount = lod.m_elementCount;
                 }
-                if (cullNode) {
-                    numCulledNodes += 1;
+
+                batches.back().m_drawCount += 1;
+                recording.m_commands.push_back(DrawElementsIndirectCommand {.m_count = static_cast<GLuint>(elementCount),
+                    .m_instanceCount = static_cast<GLuint>(runEnd - runStart),
+                    .m_firstIndex = firstIndex,
+                    .m_baseVertex = primitive.m_baseVertex,
+                    .m_baseInstance = firstDraw + static_cast<GLuint>(runStart)});
+                if (recordMeshes) {
+                    recording.m_meshIDs.push_back(runMeshID);
                 }
-                node.m_culled = cullNode;
             }
 
-            // The Model has to follow the Scale-Rotate-Translate
-            // order.
-            auto model = glm::mat4(1.0f);
-            model = glm::scale(model, node.m_scale);
-            model = glm::translate(model, node.m_position);
-
-            PerDrawData shaderData {.m_model = model, .m_opacity = node.m_opacity};
-            node.m_uboOffset = m_uboAllocator.Push(shaderData);
+            runStart = runEnd;
         }
+    }
 
-        // Add Debug UI.
-        ImGui::Begin("Glitter Debug");
-        if (ImGui::CollapsingHeader("Performance", ImGuiTreeNodeFlags_DefaultOpen)) {
-            ImGui::Checkbox("Frustum Culling", &m_frustumCulling);
-            ImGui::Text("Culled Nodes: %d/%zu (%.2f%%)", numCulledNodes, m_nodes.size(),
-                !m_nodes.empty() ? static_cast<float>(numCulledNodes) / static_cast<float>(m_nodes.size()) * 100.0f : 0.0f);
-            if (ImGui::Button("Clear Nodes", ImVec2(-1.0f, 0.0f))) {
-                m_nodes.clear();
+    // The height in pixels of the sphere around a Node's bounds, as seen from `eyePos`.
+    // Rasterizes the Nodes in the main frustum projecting to the largest spheres, among the opaque ones whose Mesh has an
+    // occluder, into m_occlusionBuffer, then clears the visibility of the Nodes hidden behind them.
+    void CullOccludedNodes(FramePacket& packet, const glm::mat4& viewProjection, glm::vec3 eyePos)
+    {
+        GLITTER_PROFILE_SCOPE("Occlusion Cull");
+        std::span<const std::uint32_t> nodeMeshIDs = m_nodes.MeshIDs();
+        std::span<const std::uint8_t> nodeFlags = m_nodes.Flags();
+        std::span<const float> nodeOpacities = m_nodes.Opacities();
+        constexpr std::uint8_t excludedFlags = Glitter::Scene::NodeFlags::ANIMATE | Glitter::Scene::NodeFlags::SIMULATED;
+        m_occluderCandidates.clear();
+        for (size_t nodeIdx = 0; nodeIdx < m_nodes.Size(); nodeIdx++) {
+            if (!m_meshes[nodeMeshIDs[nodeIdx]].m_occluder || !Glitter::Render::IsVisible(m_nodeVisibility, nodeIdx)
+                || (nodeFlags[nodeIdx] & excludedFlags) != 0 || nodeOpacities[nodeIdx] != 1.0f) {
+                continue;
+            }
+            float pixels = ProjectedPixels(m_cullBounds.GetCenter(nodeIdx), m_cullBounds.GetExtent(nodeIdx), eyePos);
+            if (pixels >= Glitter::Config::OCCLUDER_MIN_PIXELS) {
+                m_occluderCandidates.emplace_back(pixels, static_cast<std::uint32_t>(nodeIdx));
             }
         }
-        if (ImGui::CollapsingHeader("Debug View", ImGuiTreeNodeFlags_DefaultOpen)) {
-            ImGui::Checkbox("Debug Lines", &m_debugLines);
-            ImGui::SameLine();
-            ImGui::Checkbox("Draw AABBs", &m_drawAABBs);
+        size_t occluderCount = std::min(m_occluderCandidates.size(), Glitter::Config::OCCLUDER_MAX_NODES);
+        if (occluderCount == 0) {
+            return;
         }
-        ImGui::SeparatorText("Scene Properties");
-        ImGui::SliderFloat("Scene Gamma", &m_sceneGamma, 0.0f, 5.0f, "%.2f", ImGuiSliderFlags_AlwaysClamp);
-        ImGui::End();
+        std::ranges::partial_sort(m_occluderCandidates, m_occluderCandidates.begin() + static_cast<std::ptrdiff_t>(occluderCount),
+            std::greater {});
+
+        m_occlusionBuffer.Begin(viewProjection);
+        std::span<const glm::aligned_mat4> nodeModels = m_nodes.Models();
+        for (size_t occluderIdx = 0; occluderIdx < occluderCount; occluderIdx++) {
+            std::uint32_t nodeIdx = m_occluderCandidates[occluderIdx].second;
+            m_occlusionBuffer.AddOccluder(*m_meshes[nodeMeshIDs[nodeIdx]].m_occluder, nodeModels[nodeIdx]);
+        }
+        m_occlusionBuffer.Rasterize(m_jobSystem);
+
+        // The occluders themselves are never hidden, their nearest point being in front of their surface.
+        std::atomic<size_t> occludedNodes = 0;
+        m_jobSystem.ParallelFor(m_nodes.Size(), Glitter::Config::CULL_GRAIN_SIZE, [&](size_t begin, size_t end) {
+            GLITTER_PROFILE_SCOPE("Occlusion Test");
+            occludedNodes += m_occlusionBuffer.CullRange(m_cullBounds, begin, end, m_nodeVisibility);
+        });
+        packet.m_occluders = occluderCount;
+        packet.m_occludedNodes = occludedNodes.load();
+    }
+
+    float ProjectedPixels(glm::vec3 center, glm::vec3 extent, glm::vec3 eyePos) const
+    {
+        float distance = std::max(glm::distance(eyePos, center), 1e-4f);
+        return 2.0f * glm::length(extent) * GetPixelScale() / distance;
+    }
+
+    // The height in pixels of one world unit at unit distance from the eye.
+    float GetPixelScale() const
+    {
+        return static_cast<float>(m_renderHeight) / (2.0f * std::tan(glm::radians(45.0f) * 0.5f));
+    }
+
+    // The draw distance of the contribution culling, shortened by the quality governor.
+    float GetMaxDrawDistance() const { return m_maxDrawDistance * m_qualityGovernor.GetLevel().m_drawDistanceScale; }
 
-        ImGui::Begin("Glitter Framebuffers");
-        if (ImGui::CollapsingHeader("Main FB", ImGuiTreeNodeFlags_DefaultOpen)) {
-            ImGui::Image(m_fboColor, ImGui::GetWindowSize(), ImVec2(0, 1), ImVec2(1, 0));
+    // Picks the LOD level of a Node from the size its bounds project to on screen: the coarsest level whose clustering
+    // cells still cover at most Config::MESH_LOD_CELL_PIXELS pixels, or 0 when even the finest LOD is too coarse.
+    std::uint32_t SelectLod(float projectedPixels) const
+    {
+        // The quality governor's bias takes the Node for smaller than it is, a LOD bias of 1 halving its size.
+        float lodBias = m_qualityGovernor.GetLevel().m_lodBias;
+        float requiredResolution = projectedPixels * std::exp2(-lodBias) / Glitter::Config::MESH_LOD_CELL_PIXELS;
+
+        std::uint32_t level = 0;
+        std::uint32_t resolution = Glitter::Config::MESH_LOD_RESOLUTION;
+        while (level + 1 < Glitter::Config::MESH_LOD_COUNT && static_cast<float>(resolution) >= requiredResolution) {
+            level++;
+            resolution >>= 1;
         }
-        ImGui::End();
 
-        // Upload the CPU-backing buffer into the UBO.
-        glNamedBufferSubData(m_mainUBO, 0, static_cast<GLsizeiptr>(sizeof(uint8_t) * m_uboAllocator.Size()), m_uboAllocator.Data());
+        return level;
+    }
 
-        // Bind the Program and VAO.
-        glUseProgram(m_mainProgram);
-        glBindVertexArray(m_mainVAO);
+    // The LOD level to request from m_meshStreamer for a Node drawn over `projectedPixels`, taken for larger than it is so
+    // that finer levels stream in before it's drawn with them. Every Node is drawn in full without Mesh LODs.
+    std::uint32_t SelectStreamedLod(float projectedPixels) const
+    {
+        return m_meshLods ? SelectLod(projectedPixels * Glitter::Config::MESH_STREAMING_PREFETCH_SCALE) : 0;
+    }
 
-        // Split Node elements between opaque and transparent.
-        std::vector<Node> opaqueNodes {};
-        std::vector<Node> transparentNodes {};
-        for (Node& node : m_nodes) {
-            if (m_frustumCulling) {
-                if (node.m_culled) {
-                    continue;
-                }
+    // Binds the VBO of the geometry pool's attached page for the vertex shaders to pull the vertices from, see
+    // Config::ENABLE_VERTEX_PULLING.
+    void BindPulledVertices()
+    {
+        if (Glitter::Config::ENABLE_VERTEX_PULLING) {
+            m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, m_geometryPool.GetVBO(m_attachedGeometryPage));
+        }
+    }
+
+    // Uploads the PerDrawData of the Nodes in m_nodeDataDirty and the GPU bounds of the ones in m_nodeBoundsDirty into the
+    // persistent Node data buffers, one copy per coalesced range. The buffers grow on the GPU when the Nodes outgrow them,
+    // keeping what they held.
+    void UploadNodeData()
+    {
+        GLITTER_PROFILE_SCOPE("Node Upload");
+        size_t nodeCount = m_nodes.Size();
+        auto nodeCapacity = static_cast<std::uint32_t>(std::max(nodeCount, Glitter::Config::INITIAL_NODE_CAPACITY));
+        bool grew = m_nodeDataBuffer.Reserve(nodeCapacity);
+        grew |= m_nodeBoundsBuffer.Reserve(nodeCapacity);
+        if (grew) {
+            spdlog::info("Grew the Node data buffers to {} Nodes, over {} pages.", m_nodeDataBuffer.GetCapacity(),
+                m_nodeDataBuffer.GetPageCount());
+            Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::BUFFER_GROWTH);
+        }
+        m_nodeData.resize(nodeCount);
+        m_nodeBounds.resize(nodeCount);
+
+        std::span<const std::uint32_t> meshIDs = m_nodes.MeshIDs();
+        m_nodeUploadRanges = 0;
+        m_nodeUploadBytes = 0;
+        for (const auto& range : m_nodeDataDirty.Coalesce(Glitter::Config::NODE_UPLOAD_MERGE_GAP)) {
+            // Cleared Nodes can leave ranges past the end.
+            std::uint32_t end = std::min(range.m_end, static_cast<std::uint32_t>(nodeCount));
+            if (range.m_begin >= end) {
+                continue;
             }
 
-            if (node.m_opacity == 1.0f) {
-                opaqueNodes.emplace_back(node);
-            } else if (node.m_opacity != 0.0f) {
-                transparentNodes.emplace_back(node);
-            } else {
-                // A totally transparent Node (opacity = 0.0f).
+            for (std::uint32_t nodeIdx = range.m_begin; nodeIdx < end; nodeIdx++) {
+                m_nodeData[nodeIdx] = MakePerDrawData(nodeIdx);
+            }
+            size_t count = end - range.m_begin;
+            m_nodeDataBuffer.Write(m_renderStats, range.m_begin, std::span(m_nodeData).subspan(range.m_begin, count));
+            m_nodeUploadRanges += 1;
+            m_nodeUploadBytes += sizeof(PerDrawData) * count;
+        }
+        for (const auto& range : m_nodeBoundsDirty.Coalesce(Glitter::Config::NODE_UPLOAD_MERGE_GAP)) {
+            std::uint32_t end = std::min(range.m_end, static_cast<std::uint32_t>(nodeCount));
+            if (range.m_begin >= end) {
                 continue;
             }
+
+            for (std::uint32_t nodeIdx = range.m_begin; nodeIdx < end; nodeIdx++) {
+                m_nodeBounds[nodeIdx] = GpuNodeBounds {.m_center = m_cullBounds.GetCenter(nodeIdx),
+                    .m_meshID = meshIDs[nodeIdx],
+                    .m_extent = m_cullBounds.GetExtent(nodeIdx),
+                    .m_padding = 0};
+            }
+            size_t count = end - range.m_begin;
+            m_nodeBoundsBuffer.Write(m_renderStats, range.m_begin, std::span(m_nodeBounds).subspan(range.m_begin, count));
+            m_nodeUploadRanges += 1;
+            m_nodeUploadBytes += sizeof(GpuNodeBounds) * count;
         }
+        m_nodeDataDirty.Clear();
+        m_nodeBoundsDirty.Clear();
 
-        // Sort each opaque Node from front-to-back.
-        std::sort(opaqueNodes.begin(), opaqueNodes.end(), [&eyePos](const Node& a, const Node& b) {
-            return glm::distance(eyePos, a.m_position) < glm::distance(eyePos, b.m_position);
-        });
+        if (m_nodeUploadBytes != 0) {
+            Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::UPLOAD);
+        }
+    }
 
-        // Sort each transparent Node from back-to-front.
-        std::sort(transparentNodes.begin(), transparentNodes.end(), [&eyePos](const Node& a, const Node& b) {
-            return glm::distance(eyePos, a.m_position) > glm::distance(eyePos, b.m_position);
-        });
+    // Culls every Node on the GPU, from the persistent Node data and bounds. The culling pass appends the commands of the
+    // visible Nodes to m_gpuCommandBuffer and their Node slots to m_gpuDrawNodeBuffer, opaque ones from the start of their
+    // region and transparent ones from m_gpuCommandCapacity into it, and their counts to the region's m_drawCountBuffer
+    // range.
+    //
+    // A multi-draw reads a single Node data page and geometry pool page, so the passes run once per region, a pair of
+    // pages, each appending the commands of the Primitives on its geometry page of the Nodes on its Node data page into a
+    // region of the buffers of its own, see SubmitGpuCulledDraws(). Region `r` of `G` geometry pages covers Node data page
+    // `r / G` and geometry page `r % G`.
+    //
+    // The visible transparent Nodes are compacted into m_transparentSortBuffer instead, sorted back to front on the GPU
+    // unless `sortTransparent` is unset, and their commands appended in that order by a prefix sum of their Primitive
+    // counts, see SubmitTransparentSort(). They're only sorted within their region.
+    //
+    // With m_meshletCulling, the opaque Primitives that have meshlets are handed to a second pass instead, which culls
+    // each meshlet by frustum, normal cone and Hi-Z, and appends a command per visible meshlet.
+    //
+    // Expects the CommonData UBO to be bound. The barriers before the commands are drawn are left to the caller.
+    void DispatchGpuCulling(bool sortTransparent)
+    {
+        GLITTER_PROFILE_SCOPE("GPU Culling");
+        size_t nodeCount = m_nodes.Size();
+        size_t pageNodeCount = std::min<size_t>(nodeCount, Glitter::Config::NODE_PAGE_SIZE);
+        m_gpuCullNodePages = static_cast<std::uint32_t>(
+            std::max<size_t>((nodeCount + Glitter::Config::NODE_PAGE_SIZE - 1) / Glitter::Config::NODE_PAGE_SIZE, 1));
+        m_gpuCullGeometryPages = static_cast<std::uint32_t>(m_geometryPool.GetPageCount());
+        size_t regionCount = std::max<size_t>(static_cast<size_t>(m_gpuCullNodePages) * m_gpuCullGeometryPages, 1);
+
+        // Grow the command buffers so that every Primitive or meshlet of every Node of a page fits into either pass of each
+        // region. The meshlet work list holds at most a Primitive per command, and is reused by every region.
+        size_t commandCapacity = std::max<size_t>(pageNodeCount * m_maxCommandsPerMesh, 1);
+        if (commandCapacity > m_gpuCommandCapacity || regionCount > m_gpuCullRegionCapacity) {
+            Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::BUFFER_GROWTH);
+            if (commandCapacity > m_gpuCommandCapacity) {
+                m_gpuCommandCapacity = std::max(commandCapacity, m_gpuCommandCapacity * 2);
+            }
+            m_gpuCullRegionCapacity = std::max(regionCount, m_gpuCullRegionCapacity);
+            size_t regionCommands = m_gpuCommandCapacity * 2 * m_gpuCullRegionCapacity;
+            Glitter::Render::NamedBufferData(Glitter::Render::GpuMemoryCategory::StreamBuffer, m_gpuCommandBuffer,
+                static_cast<GLsizeiptr>(sizeof(DrawElementsIndirectCommand) * regionCommands), nullptr, GL_DYNAMIC_COPY);
+            Glitter::Render::NamedBufferData(Glitter::Render::GpuMemoryCategory::StreamBuffer, m_gpuDrawNodeBuffer,
+                static_cast<GLsizeiptr>(sizeof(GLuint) * regionCommands), nullptr, GL_DYNAMIC_COPY);
+            Glitter::Render::NamedBufferData(Glitter::Render::GpuMemoryCategory::StreamBuffer, m_meshletWorkBuffer,
+                static_cast<GLsizeiptr>(sizeof(glm::uvec4) * m_gpuCommandCapacity), nullptr, GL_DYNAMIC_COPY);
+            Glitter::Render::NamedBufferData(Glitter::Render::GpuMemoryCategory::StreamBuffer, m_drawCountBuffer,
+                static_cast<GLsizeiptr>(m_drawCountStride) * static_cast<GLsizeiptr>(m_gpuCullRegionCapacity), nullptr,
+                GL_DYNAMIC_DRAW);
+        }
+        // The sort runs over a power of two of whole blocks.
+        size_t sortCapacity = std::max(std::bit_ceil(pageNodeCount), TRANSPARENT_SORT_BLOCK);
+        if (sortCapacity > m_transparentSortCapacity) {
+            Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::BUFFER_GROWTH);
+            m_transparentSortCapacity = sortCapacity;
+            Glitter::Render::NamedBufferData(Glitter::Render::GpuMemoryCategory::StreamBuffer, m_transparentSortBuffer,
+                static_cast<GLsizeiptr>(sizeof(glm::uvec2) * m_transparentSortCapacity), nullptr, GL_DYNAMIC_COPY);
+            Glitter::Render::NamedBufferData(Glitter::Render::GpuMemoryCategory::StreamBuffer,
+                m_transparentBlockOffsetBuffer,
+                static_cast<GLsizeiptr>(sizeof(GLuint) * m_transparentSortCapacity / TRANSPARENT_SORT_BLOCK), nullptr,
+                GL_DYNAMIC_COPY);
+        }
+
+        m_gpuProfiler.PushGroup(0, "GPU Culling");
+        {
+            // Zero every region's draw counts, and the meshlet pass' work group count and work list size.
+            constexpr std::array<GLuint, 8> emptyDrawCounts {0, 0, 0, 0, 0, 1, 1, 0};
+            static_assert(static_cast<GLsizeiptr>(sizeof(emptyDrawCounts)) == DRAW_COUNT_SIZE);
+            size_t strideCounts = static_cast<size_t>(m_drawCountStride) / sizeof(GLuint);
+            std::pmr::vector<GLuint> drawCounts(regionCount * strideCounts, 0, &m_frameArena);
+            for (size_t region = 0; region < regionCount; region++) {
+                std::ranges::copy(emptyDrawCounts, drawCounts.begin() + static_cast<std::ptrdiff_t>(region * strideCounts));
+            }
+            m_renderStats.NamedBufferSubData(m_drawCountBuffer, 0,
+                static_cast<GLsizeiptr>(sizeof(GLuint) * drawCounts.size()), drawCounts.data());
+
+            m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_meshTableBuffer);
+            m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_primitiveTableBuffer);
+            m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_gpuCommandBuffer);
+            m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, m_gpuDrawNodeBuffer);
+            m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, m_meshletWorkBuffer);
+            m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, m_meshletTableBuffer);
+            m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 10, m_transparentSortBuffer);
+            m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 11, m_transparentBlockOffsetBuffer);
+            m_renderStats.BindTextureUnit(1, m_hiZ.GetTexture());
+
+            // The uniforms every region shares.
+            m_renderStats.UseProgram(m_cullProgram);
+            // uniform layout(location = 2) bool u_FrustumCulling;
+            glUniform1i(2, m_frustumCulling ? GL_TRUE : GL_FALSE);
+
+            // uniform layout(location = 3) bool u_OcclusionCulling;
+            // uniform layout(location = 4) vec2 u_HiZSize;
+            glUniform1i(3, m_occlusionCulling && m_hiZValid ? GL_TRUE : GL_FALSE);
+            glUniform2f(4, static_cast<float>(m_hiZ.GetWidth()), static_cast<float>(m_hiZ.GetHeight()));
+
+            // uniform layout(location = 5) bool u_MeshletCulling;
+            glUniform1i(5, m_meshletCulling ? GL_TRUE : GL_FALSE);
+
+            // uniform layout(location = 6) vec3 u_ContributionCulling;
+            glUniform3f(6, m_contributionCulling ? GetMaxDrawDistance() : std::numeric_limits<float>::infinity(),
+                m_contributionCulling ? m_minProjectedPixels : 0.0f, GetPixelScale());
+
+            // uniform layout(location = 8) vec2 u_LodSelection;
+            float lodBias = m_qualityGovernor.GetLevel().m_lodBias;
+            glUniform2f(8, std::exp2(-lodBias) / Glitter::Config::MESH_LOD_CELL_PIXELS,
+                static_cast<float>(Glitter::Config::MESH_LOD_RESOLUTION));
+
+            if (m_meshletCulling) {
+                m_renderStats.UseProgram(m_meshletCullProgram);
+                glUniform1i(2, m_frustumCulling ? GL_TRUE : GL_FALSE);
+                glUniform1i(3, m_occlusionCulling && m_hiZValid ? GL_TRUE : GL_FALSE);
+                glUniform2f(4, static_cast<float>(m_hiZ.GetWidth()), static_cast<float>(m_hiZ.GetHeight()));
+            }
 
-        auto renderNodes = [this](const std::vector<Node>& nodes) {
-            for (const Node& node : nodes) {
-                size_t meshIdx = node.m_meshID;
+            if (Glitter::Config::ENABLE_GPU_CULL_STATISTICS) {
+                m_gpuCullStatistics.BeginPass(m_renderStats, nodeCount);
+            }
 
-                for (const auto& primitive : m_meshes[meshIdx].m_primitives) {
-                    // Attach the VBO to the VAO.
-                    glVertexArrayVertexBuffer(m_mainVAO, 0, primitive.m_vbo, 0, sizeof(MeshVertex));
+            for (size_t region = 0; region < static_cast<size_t>(m_gpuCullNodePages) * m_gpuCullGeometryPages; region++) {
+                auto nodePage = static_cast<std::uint32_t>(region / m_gpuCullGeometryPages);
+                auto page = static_cast<std::uint32_t>(region % m_gpuCullGeometryPages);
+                auto commandBase = static_cast<GLuint>(m_gpuCommandCapacity * 2 * region);
+                std::uint32_t firstNode = m_nodeDataBuffer.GetFirst(nodePage);
+                auto nodeEnd = static_cast<std::uint32_t>(std::min<size_t>(nodeCount, firstNode + pageNodeCount));
 
-                    // Attach the EBO to the VAO.
-                    glVertexArrayElementBuffer(m_mainVAO, primitive.m_ebo);
+                // The previous region's passes are done with the meshlet work list and the sort buffers.
+                if (region > 0) {
+                    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+                }
 
-                    // Bind the Common UBO data into the first slot of the UBO.
-                    glBindBufferRange(GL_UNIFORM_BUFFER, 0, m_mainUBO, 0, sizeof(CommonData));
+                m_renderStats.UseProgram(m_cullProgram);
+                BindNodePage(nodePage);
+                m_renderStats.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_nodeBoundsBuffer.GetBuffer(nodePage));
+                m_renderStats.BindBufferRange(GL_SHADER_STORAGE_BUFFER, 5, m_drawCountBuffer,
+                    static_cast<GLintptr>(m_drawCountStride) * static_cast<GLintptr>(region), DRAW_COUNT_SIZE);
+
+                // uniform layout(location = 0) uint u_NodeCount;
+                // uniform layout(location = 1) uint u_FirstNode;
+                glUniform1ui(0, nodeEnd);
+                glUniform1ui(1, firstNode);
+
+                // uniform layout(location = 7) bool u_Statistics;
+                // Each Node is only counted by the regions of the first geometry page.
+                glUniform1i(7, Glitter::Config::ENABLE_GPU_CULL_STATISTICS && page == 0 ? GL_TRUE : GL_FALSE);
+
+                // uniform layout(location = 9) uint u_Page;
+                // uniform layout(location = 10) uint u_CommandBase;
+                glUniform1ui(9, page);
+                glUniform1ui(10, commandBase);
+
+                glDispatchCompute((nodeEnd - firstNode + 63) / 64, 1, 1);
+
+                if (m_meshletCulling) {
+                    // The meshlet pass reads the work list, and its dispatch size, written by the Node pass.
+                    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+
+                    m_renderStats.UseProgram(m_meshletCullProgram);
+                    glUniform1ui(10, commandBase);
+                    m_renderStats.BindBuffer(GL_DISPATCH_INDIRECT_BUFFER, m_drawCountBuffer);
+                    glDispatchComputeIndirect(static_cast<GLintptr>(m_drawCountStride) * static_cast<GLintptr>(region)
+                        + static_cast<GLintptr>(sizeof(GLuint) * 4));
+                }
 
-                    // Bind the Per-Draw UBO data into the second slot of the UBO.
-                    glBindBufferRange(
-                        GL_UNIFORM_BUFFER, 1, m_mainUBO, static_cast<GLintptr>(node.m_uboOffset), sizeof(PerDrawData));
+                SubmitTransparentSort(sortTransparent, page, commandBase);
+            }
 
-                    // Bind the texture.
-                    glBindTextureUnit(0, node.m_texture);
+            if (Glitter::Config::ENABLE_GPU_CULL_STATISTICS) {
+                m_gpuCullStatistics.EndPass();
+            }
+        }
+        m_gpuProfiler.PopGroup();
+    }
 
-                    // Draw the Primitive!
-                    glDrawElements(GL_TRIANGLES, primitive.m_elementCount, GL_UNSIGNED_INT, nullptr);
+    // Sorts the transparent Nodes compacted by the culling pass of a region with a bitonic sort, then appends their
+    // commands on geometry pool page `page` from `commandBase + m_gpuCommandCapacity` on. Neither their count nor the
+    // sort's size is read back: every step is dispatched for m_transparentSortCapacity, and the shaders return from the
+    // ones past the count. Matches TransparentSortCS.glsl's and TransparentCommandsCS.glsl's passes.
+    void SubmitTransparentSort(bool sortTransparent, std::uint32_t page, GLuint commandBase)
+    {
+        auto blockCount = static_cast<GLuint>(m_transparentSortCapacity / TRANSPARENT_SORT_BLOCK);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        if (sortTransparent) {
+            m_renderStats.UseProgram(m_transparentSortProgram);
+            // uniform layout(location = 0) uint u_Pass;
+            // uniform layout(location = 1) uint u_MergeSize;
+            // uniform layout(location = 2) uint u_Stride;
+            glUniform1ui(0, 0);
+            glUniform1ui(1, static_cast<GLuint>(TRANSPARENT_SORT_BLOCK));
+            glDispatchCompute(blockCount, 1, 1);
+            for (size_t mergeSize = TRANSPARENT_SORT_BLOCK * 2; mergeSize <= m_transparentSortCapacity; mergeSize *= 2) {
+                glUniform1ui(1, static_cast<GLuint>(mergeSize));
+                for (size_t stride = mergeSize / 2; stride >= TRANSPARENT_SORT_BLOCK; stride /= 2) {
+                    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+                    glUniform1ui(0, 1);
+                    glUniform1ui(2, static_cast<GLuint>(stride));
+                    glDispatchCompute(static_cast<GLuint>(m_transparentSortCapacity / 2 / 256), 1, 1);
                 }
+                glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+                glUniform1ui(0, 2);
+                glDispatchCompute(blockCount, 1, 1);
             }
-        };
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        }
 
-        glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, "Main FB Draw");
-        {
-            glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
-            // The FBO needs its own independent clear.
-            glDepthMask(GL_TRUE);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        m_renderStats.UseProgram(m_transparentCommandsProgram);
+        // uniform layout(location = 0) uint u_Pass;
+        // uniform layout(location = 1) uint u_CommandCapacity;
+        glUniform1ui(1, static_cast<GLuint>(m_gpuCommandCapacity));
+        // uniform layout(location = 9) uint u_Page;
+        // uniform layout(location = 10) uint u_CommandBase;
+        glUniform1ui(9, page);
+        glUniform1ui(10, commandBase);
+        glUniform1ui(0, 0);
+        glDispatchCompute(blockCount, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        glUniform1ui(0, 1);
+        glDispatchCompute(1, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        glUniform1ui(0, 2);
+        glDispatchCompute(static_cast<GLuint>(m_transparentSortCapacity / 256), 1, 1);
+    }
 
-            // Render each opaque Node.
-            if (!opaqueNodes.empty()) {
-                glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 1, -1, "Opaque Nodes");
-                {
-                    glDepthMask(GL_TRUE);
-                    renderNodes(opaqueNodes);
-                }
-                glPopDebugGroup();
+    // Draws the commands appended by DispatchGpuCulling() for `pass`, 0 being opaque and 1 transparent, a multi-draw per
+    // region with its Node data page bound and its geometry pool page attached. With `visibility`, the program is the
+    // visibility buffer's, told each region's first command and pages. Expects the GPU command and draw count buffers to
+    // be bound.
+    void SubmitGpuCulledDraws(size_t pass, bool visibility = false)
+    {
+        for (size_t region = 0; region < static_cast<size_t>(m_gpuCullNodePages) * m_gpuCullGeometryPages; region++) {
+            auto nodePage = static_cast<std::uint32_t>(region / m_gpuCullGeometryPages);
+            auto page = static_cast<std::uint32_t>(region % m_gpuCullGeometryPages);
+            size_t firstCommand = m_gpuCommandCapacity * (region * 2 + pass);
+            AttachGeometryPage(page);
+            BindNodePage(nodePage);
+            if (visibility) {
+                // uniform layout(location = 0) uint u_FirstCommand;
+                // uniform layout(location = 1) uint u_Pages;
+                glUniform1ui(0, static_cast<GLuint>(firstCommand));
+                glUniform1ui(1, PackVisibilityPages(nodePage, page));
             }
 
-            // Render each transparent Node.
-            if (!transparentNodes.empty()) {
-                glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 2, -1, "Transparent Nodes");
-                {
-                    glDepthMask(GL_FALSE);
-                    renderNodes(transparentNodes);
+            auto commandOffset = static_cast<std::uintptr_t>(sizeof(DrawElementsIndirectCommand) * firstCommand);
+            glMultiDrawElementsIndirectCount(GL_TRIANGLES, m_geometryPool.GetIndexType(),
+                reinterpret_cast<const void*>(commandOffset),
+                static_cast<GLintptr>(m_drawCountStride) * static_cast<GLintptr>(region)
+                    + static_cast<GLintptr>(sizeof(GLuint) * pass),
+                static_cast<GLsizei>(m_gpuCommandCapacity), 0);
+            // The command count is only known on the GPU.
+            m_renderStats.CountDraw(0, 0);
+        }
+    }
+
+    // Draws each instance of `drawCount` commands from `firstCommand` on by itself, under the occlusion query of its Node
+    // in `conditionalNodes`, the draw list the commands were built from. Returns the triangles drawn, when not culled.
+    std::uint64_t SubmitConditionalCommands(
+        size_t firstCommand, GLsizei drawCount, std::span<const DrawListEntry> conditionalNodes)
+    {
+        GLenum indexType = m_geometryPool.GetIndexType();
+        size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+        std::uint64_t triangles = 0;
+        for (GLsizei commandIdx = 0; commandIdx < drawCount; commandIdx++) {
+            const DrawElementsIndirectCommand& command = m_indirectCommands[firstCommand + commandIdx];
+            for (GLuint instance = 0; instance < command.m_instanceCount; instance++) {
+                GLuint draw = command.m_baseInstance + instance;
+                GLuint condition = m_occlusionQueryPool.GetCondition(conditionalNodes[draw].m_node);
+                if (condition != 0) {
+                    glBeginConditionalRender(condition, GL_QUERY_NO_WAIT);
+                }
+                glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, static_cast<GLsizei>(command.m_count), indexType,
+                    reinterpret_cast<const void*>(indexSize * command.m_firstIndex), 1, command.m_baseVertex, draw);
+                if (condition != 0) {
+                    glEndConditionalRender();
                 }
-                glPopDebugGroup();
             }
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            triangles += static_cast<std::uint64_t>(command.m_count / 3) * command.m_instanceCount;
         }
-        glPopDebugGroup();
+        return triangles;
+    }
 
-        // Render Post-Processing effects.
-        glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, "Post-Processing");
-        {
-            glUseProgram(m_ppfxProgram);
-            glBindVertexArray(m_ppfxVAO);
+    // Draws every command of `batches`, which must be contiguous, with the bound program in a single call per geometry
+    // pool page and Node data page, or each Node by itself under its occlusion query with `conditionalNodes`, see
+    // SubmitConditionalCommands(). With `visibility`, the program is the visibility buffer's, told each call's first
+    // command and pages.
+    void SubmitDepthPrepass(
+        std::span<const DrawBatch> batches, std::span<const DrawListEntry> conditionalNodes = {}, bool visibility = false)
+    {
+        size_t runStart = 0;
+        while (runStart < batches.size()) {
+            size_t runEnd = runStart + 1;
+            while (runEnd < batches.size() && batches[runEnd].m_page == batches[runStart].m_page
+                && batches[runEnd].m_nodePage == batches[runStart].m_nodePage) {
+                runEnd++;
+            }
+            AttachGeometryPage(batches[runStart].m_page);
+            BindNodePage(batches[runStart].m_nodePage);
+
+            size_t firstCommand = batches[runStart].m_firstCommand;
+            const DrawBatch& last = batches[runEnd - 1];
+            GLsizei drawCount = static_cast<GLsizei>(last.m_firstCommand - firstCommand) + last.m_drawCount;
+            if (visibility) {
+                // uniform layout(location = 0) uint u_FirstCommand;
+                // uniform layout(location = 1) uint u_Pages;
+                glUniform1ui(0, static_cast<GLuint>(firstCommand));
+                glUniform1ui(1, PackVisibilityPages(batches[runStart].m_nodePage, batches[runStart].m_page));
+            }
+            if (!conditionalNodes.empty()) {
+                SubmitConditionalCommands(firstCommand, drawCount, conditionalNodes);
+            } else {
+                glMultiDrawElementsIndirect(GL_TRIANGLES, m_geometryPool.GetIndexType(),
+                    reinterpret_cast<const void*>(sizeof(DrawElementsIndirectCommand) * firstCommand), drawCount, 0);
+            }
+            m_renderStats.CountDraw(static_cast<size_t>(drawCount), 0);
+            m_submitFlusher.CountCommands(static_cast<size_t>(drawCount));
+            runStart = runEnd;
+        }
+    }
+
+    void SubmitDrawBatches(std::span<const DrawBatch> batches, std::span<const DrawListEntry> conditionalNodes = {})
+    {
+        std::optional<std::uint32_t> boundProgram {};
+        for (const DrawBatch& batch : batches) {
+            // Bind the program and the texture.
+            if (boundProgram != batch.m_program) {
+                m_renderStats.UseProgram(m_mainPrograms[batch.m_program]);
+                boundProgram = batch.m_program;
+            }
+            if (m_textureMode == TextureMode::Bound) {
+                m_renderStats.BindTextureUnit(0, batch.m_texture);
+            }
+            AttachGeometryPage(batch.m_page);
+            BindNodePage(batch.m_nodePage);
+
+            if (!conditionalNodes.empty()) {
+                std::uint64_t triangles = SubmitConditionalCommands(batch.m_firstCommand, batch.m_drawCount, conditionalNodes);
+                m_renderStats.CountDraw(static_cast<std::uint64_t>(batch.m_drawCount), triangles);
+                m_submitFlusher.CountCommands(static_cast<size_t>(batch.m_drawCount));
+                continue;
+            }
 
-            // uniform layout(location = 0) sampler2D u_ColorTexture;
-            // uniform layout(location = 1) float u_Gamma;
-            glBindTextureUnit(0, m_fboColor);
-            glUniform1f(1, m_sceneGamma);
+            // Draw every Primitive in the batch!
+            if (m_batchCostSampler.SampleBatch() && m_indirectCommandMeshes.size() == m_indirectCommands.size()) {
+                SubmitSampledBatch(batch);
+            } else {
+                glMultiDrawElementsIndirect(GL_TRIANGLES, m_geometryPool.GetIndexType(),
+                    reinterpret_cast<const void*>(sizeof(DrawElementsIndirectCommand) * batch.m_firstCommand), batch.m_drawCount,
+                    0);
+            }
 
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            std::uint64_t triangles = 0;
+            for (GLsizei commandIdx = 0; commandIdx < batch.m_drawCount; commandIdx++) {
+                const DrawElementsIndirectCommand& command = m_indirectCommands[batch.m_firstCommand + commandIdx];
+                triangles += static_cast<std::uint64_t>(command.m_count / 3) * command.m_instanceCount;
+            }
+            m_renderStats.CountDraw(static_cast<std::uint64_t>(batch.m_drawCount), triangles);
+            m_submitFlusher.CountCommands(static_cast<size_t>(batch.m_drawCount));
         }
-        glPopDebugGroup();
+    }
 
-        // Render Debug.
-        if (m_debugLines && !m_debugData.m_debugLines.empty()) {
-            glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 2, -1, "Debug");
-            {
-                glDepthFunc(GL_ALWAYS);
+    // Draws a batch one run of commands of the same Mesh at a time, each timed by the batch cost sampler.
+    void SubmitSampledBatch(const DrawBatch& batch)
+    {
+        std::uint64_t materialKey = Glitter::Render::BatchCostSampler::GetMaterialKey(batch.m_program, batch.m_texture);
+        size_t batchEnd = batch.m_firstCommand + static_cast<size_t>(batch.m_drawCount);
+        size_t runStart = batch.m_firstCommand;
+        while (runStart < batchEnd) {
+            std::uint32_t meshID = m_indirectCommandMeshes[runStart];
+            size_t runEnd = runStart + 1;
+            while (runEnd < batchEnd && m_indirectCommandMeshes[runEnd] == meshID) {
+                runEnd++;
+            }
 
-                // Bind the Program and VAO.
-                glUseProgram(m_debugProgram);
-                glBindVertexArray(m_debugVAO);
+            m_batchCostSampler.BeginSample();
+            glMultiDrawElementsIndirect(GL_TRIANGLES, m_geometryPool.GetIndexType(),
+                reinterpret_cast<const void*>(sizeof(DrawElementsIndirectCommand) * runStart),
+                static_cast<GLsizei>(runEnd - runStart), 0);
+            m_batchCostSampler.EndSample(meshID, materialKey);
+            runStart = runEnd;
+        }
+    }
+
+    // Replaces the batches of the cells `packet` rebuilt, growing the geometry pool to hold them, and pre-transforms their
+    // sources into it. Each new batch's data is written into its slot of m_staticBatchData: its cell's model matrix, and
+    // the texture and material of its Nodes.
+    void BuildStaticBatches(const FramePacket& packet)
+    {
+        GLITTER_PROFILE_SCOPE("Static Batches");
+        m_staticBatches.BeginFrame(m_geometryPool);
+        if (packet.m_staticBatchReset) {
+            m_staticBatches.Reset();
+        }
 
-                // Create VBO.
-                GLuint vbo = 0;
-                glCreateBuffers(1, &vbo);
-                glNamedBufferStorage(vbo, static_cast<GLsizeiptr>(sizeof(DebugVertex) * m_debugData.m_debugLines.size()),
-                    m_debugData.m_debugLines.data(), 0);
-                glObjectLabel(GL_BUFFER, vbo, -1, "Debug VBO");
+        std::pmr::vector<PerDrawData> batchData(&m_frameArena);
+        std::pmr::vector<std::uint32_t> batchSlots(&m_frameArena);
+        for (const Glitter::Render::StaticBatchRebuild& rebuild : packet.m_staticBatchRebuilds) {
+            std::span<const Glitter::Render::StaticBatchDesc> descs
+                = std::span(packet.m_staticBatchDescs).subspan(rebuild.m_firstBatch, rebuild.m_batchCount);
+            std::span<const Glitter::Render::StaticBatch> built
+                = m_staticBatches.Build(m_geometryPool, rebuild.m_cell, descs, packet.m_staticBatchSources);
+            for (size_t batchIdx = 0; batchIdx < built.size(); batchIdx++) {
+                const Glitter::Render::StaticBatchDesc& desc = descs[batchIdx];
+                glm::mat4 modelTranspose = glm::transpose(desc.m_dequantize);
+                batchData.push_back(PerDrawData {.m_modelRows = {modelTranspose[0], modelTranspose[1], modelTranspose[2]},
+                    .m_textureHandle = m_textureMode == TextureMode::Bindless ? m_loadedTextureHandles[desc.m_texture] : 0,
+                    .m_opacityOrPhase = 1.0f,
+                    .m_packed = desc.m_texture | (desc.m_material << NODE_DATA_TEXTURE_BITS)});
+                batchSlots.push_back(built[batchIdx].m_slot);
+            }
+        }
+        if (!m_staticBatches.HasQueuedSources()) {
+            return;
+        }
 
-                // Attach the VBO to the VAO.
-                glVertexArrayVertexBuffer(m_debugVAO, 0, vbo, 0, sizeof(DebugVertex));
+        // The batches were only allocated so far. Growing the pool copies the buffers, so the Mesh writes still in flight
+        // on the upload context have to land first.
+        if (m_uploadContext.IsRunning() && m_geometryPool.NeedsReallocation()) {
+            m_uploadContext.Finish();
+        }
+        if (m_geometryPool.Reserve()) {
+            Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::BUFFER_GROWTH);
+            AttachGeometryPool();
+            m_renderStats.InvalidateState();
+        }
+        if (m_staticBatchData.Reserve(m_staticBatches.GetSlotCapacity())) {
+            Glitter::Core::MarkFrameActivity(Glitter::Core::FrameActivity::BUFFER_GROWTH);
+            m_renderStats.InvalidateState();
+        }
+        for (size_t batchIdx = 0; batchIdx < batchData.size(); batchIdx++) {
+            m_staticBatchData.Write(m_renderStats, batchSlots[batchIdx], std::span(batchData).subspan(batchIdx, 1));
+        }
 
-                // Bind the Common UBO data into the first slot of the UBO.
-                glBindBufferRange(GL_UNIFORM_BUFFER, 0, m_mainUBO, 0, sizeof(CommonData));
+        // The batches are drawn from the vertex and index buffers they were written into.
+        m_staticBatches.Dispatch(m_renderStats, m_staticBatchProgram, m_geometryPool);
+        glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    }
 
-                // Draw the Primitive!
-                glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(m_debugData.m_debugLines.size()));
+    // Writes the slot of each batch of the packet's cells into `drawNodes`, the per-draw slots from `firstDraw` on, and
+    // records one command per batch, grouped by geometry pool page and bound texture. The far cells' batches are drawn
+    // from their HLOD proxies.
+    std::pmr::vector<DrawBatch> BuildStaticBatchDraws(const FramePacket& packet, std::span<GLuint> drawNodes, GLuint firstDraw)
+    {
+        std::pmr::vector<DrawBatch> batches(&m_frameArena);
+        std::pmr::vector<std::pair<const Glitter::Render::StaticBatch*, Glitter::Render::GeometryRange>> drawn(&m_frameArena);
+        for (std::uint32_t cell : packet.m_staticBatchCells) {
+            for (const Glitter::Render::StaticBatch& batch : m_staticBatches.GetBatches(cell)) {
+                drawn.emplace_back(&batch, batch.m_range);
+            }
+        }
+        for (std::uint32_t cell : packet.m_hlodCells) {
+            for (const Glitter::Render::StaticBatch& batch : m_staticBatches.GetBatches(cell)) {
+                drawn.emplace_back(&batch, batch.m_proxyRange.m_indexCount > 0 ? batch.m_proxyRange : batch.m_range);
+            }
+        }
+        if (m_textureMode == TextureMode::Bound || m_geometryPool.GetPageCount() > 1) {
+            std::ranges::sort(drawn, {}, [&](const auto& draw) {
+                return std::pair(draw.second.m_page, m_textureMode == TextureMode::Bound ? draw.first->m_texture : 0);
+            });
+        }
 
-                glDepthFunc(GL_LEQUAL);
+        for (size_t drawIdx = 0; drawIdx < drawn.size(); drawIdx++) {
+            const auto& [batchPtr, range] = drawn[drawIdx];
+            const Glitter::Render::StaticBatch& batch = *batchPtr;
+            GLuint texture = m_textureMode == TextureMode::Bound ? m_loadedTextures[batch.m_texture] : 0;
+            if (batches.empty() || batches.back().m_texture != texture || batches.back().m_page != range.m_page) {
+                batches.push_back(DrawBatch {.m_program = packet.m_basePermutation,
+                    .m_texture = texture,
+                    .m_page = range.m_page,
+                    .m_nodePage = STATIC_BATCH_NODE_PAGE,
+                    .m_firstCommand = m_indirectCommands.size(),
+                    .m_drawCount = 0});
             }
-            glPopDebugGroup();
+            drawNodes[drawIdx] = batch.m_slot;
+            m_indirectCommands.push_back(DrawElementsIndirectCommand {.m_count = static_cast<GLuint>(range.m_indexCount),
+                .m_instanceCount = 1,
+                .m_firstIndex = range.m_firstIndex,
+                .m_baseVertex = range.m_baseVertex,
+                .m_baseInstance = firstDraw + static_cast<GLuint>(drawIdx)});
+            if (m_batchCostSampler.IsEnabled()) {
+                m_indirectCommandMeshes.push_back(STATIC_BATCH_MESH);
+            }
+            batches.back().m_drawCount++;
         }
+        return batches;
+    }
 
-        // Render Dear ImGui.
-        glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 3, -1, "Dear ImGui");
-        {
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    // Draws the static batches in the depth pre-pass or the opaque pass, fetching their data from m_staticBatchData in
+    // place of the Node data, see STATIC_BATCH_NODE_PAGE.
+    void SubmitStaticBatches(std::span<const DrawBatch> batches, bool depthOnly)
+    {
+        if (depthOnly) {
+            SubmitDepthPrepass(batches);
+        } else {
+            SubmitDrawBatches(batches);
         }
-        glPopDebugGroup();
+    }
 
-        glfwSwapBuffers(m_window);
+    // Writes the Node of each impostor into `drawNodes`, the per-draw slots from `firstDraw` on, and groups the impostors
+    // of each Mesh on each Node data page into a batch.
+    std::pmr::vector<ImpostorBatch> BuildImpostorBatches(
+        std::span<const DrawListEntry> nodes, std::span<GLuint> drawNodes, GLuint firstDraw)
+    {
+        std::pmr::vector<ImpostorBatch> batches(&m_frameArena);
+        std::span<const std::uint32_t> meshIDs = m_nodes.MeshIDs();
+        for (size_t nodeIdx = 0; nodeIdx < nodes.size(); nodeIdx++) {
+            drawNodes[nodeIdx] = nodes[nodeIdx].m_node;
+            std::uint32_t meshID = meshIDs[nodes[nodeIdx].m_node];
+            std::uint32_t nodePage = nodes[nodeIdx].m_node / Glitter::Config::NODE_PAGE_SIZE;
+            if (batches.empty() || batches.back().m_meshID != meshID || batches.back().m_nodePage != nodePage) {
+                batches.push_back(ImpostorBatch {.m_meshID = meshID,
+                    .m_nodePage = nodePage,
+                    .m_firstDraw = firstDraw + static_cast<GLuint>(nodeIdx),
+                    .m_instanceCount = 0});
+            }
+            batches.back().m_instanceCount++;
+        }
+        return batches;
+    }
+
+    // Draws each batch's impostors as one instanced quad per Node, with its Mesh's frames.
+    void SubmitImpostors(std::span<const ImpostorBatch> batches)
+    {
+        for (const ImpostorBatch& batch : batches) {
+            const Mesh& mesh = m_meshes[batch.m_meshID];
+            glm::mat4 quantize = glm::inverse(mesh.m_dequantize);
+
+            // uniform layout(location = 0) mat4 u_Quantize;
+            glUniformMatrix4fv(0, 1, GL_FALSE, glm::value_ptr(quantize));
+            // uniform layout(location = 1) vec4 u_Sphere;
+            glUniform4fv(1, 1, glm::value_ptr(mesh.m_impostorSphere));
+            // uniform layout(location = 2) uint u_Layer;
+            glUniform1ui(2, *mesh.m_impostorLayer);
+            BindNodePage(batch.m_nodePage);
+            glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, 6, batch.m_instanceCount, batch.m_firstDraw);
+            m_renderStats.CountDraw(1, 2 * static_cast<size_t>(batch.m_instanceCount));
+        }
     }
 
     void Finish()
@@ -1090,120 +7201,602 @@ private:
         spdlog::info("Stopping...");
 
         // Shutdown Dear ImGui.
-        ImGui_ImplOpenGL3_Shutdown();
-        ImGui_ImplGlfw_Shutdown();
-        ImGui::DestroyContext();
+        if (!m_benchmark.m_headless) {
+            ImGui_ImplOpenGL3_Shutdown();
+            ImGui_ImplGlfw_Shutdown();
+            ImGui::DestroyContext();
+        }
 
         // Shutdown OpenGL.
-        glDeleteProgram(m_mainProgram);
-        glDeleteBuffers(1, &m_mainVAO);
-        glDeleteBuffers(1, &m_mainUBO);
+        for (GLuint program : m_mainPrograms) {
+            glDeleteProgram(program);
+        }
+        if (m_depthVAO != m_mainVAO) {
+            glDeleteVertexArrays(1, &m_depthVAO);
+        }
+        glDeleteVertexArrays(1, &m_mainVAO);
+        glDeleteProgram(m_depthProgram);
+        glDeleteProgram(m_shadowProgram);
+        glDeleteProgram(m_occlusionBoxProgram);
+        glDeleteProgram(m_visibilityProgram);
+        for (GLuint program : m_visibilityResolvePrograms) {
+            glDeleteProgram(program);
+        }
+        glDeleteProgram(m_impostorBakeProgram);
+        for (GLuint program : m_impostorPrograms) {
+            glDeleteProgram(program);
+        }
+        m_impostorAtlas.Release();
+        glDeleteProgram(m_swarmProgram);
+        m_nodeSwarm.Release();
+        glDeleteProgram(m_skinProgram);
+        m_skinnedMeshes.Release();
+        glDeleteProgram(m_staticBatchProgram);
+        m_staticBatches.Release();
+        m_staticBatchData.Release();
+        m_shadowCache.Release();
+        m_uboStream.Release();
+        m_perDrawStream.Release();
+        m_lightClusters.Release();
+        m_debugDraw.Release();
+        m_framePacer.Release();
+        m_frameReadback.Flush([&](const Glitter::Render::ReadbackImage& image) { WriteCapture(image); });
+        m_frameReadback.Release();
+        m_nodePicker.Release();
+        m_frameOutput.Close();
+        ReleaseServedScenes();
+        m_telemetry.Close();
+        m_uploadContext.Release();
+        m_textureStreamer.Release();
+        m_meshStreamer.Release();
+        m_textureUploader.Release();
+        Glitter::Render::DeleteBuffers(1, &m_indirectBuffer);
+        m_geometryPool.Release();
+
+        glDeleteProgram(m_cullProgram);
+        glDeleteProgram(m_meshletCullProgram);
+        glDeleteProgram(m_transparentSortProgram);
+        glDeleteProgram(m_transparentCommandsProgram);
+        Glitter::Render::DeleteBuffers(1, &m_gpuDrawNodeBuffer);
+        m_nodeDataBuffer.Release();
+        m_nodeBoundsBuffer.Release();
+        Glitter::Render::DeleteBuffers(1, &m_meshTableBuffer);
+        Glitter::Render::DeleteBuffers(1, &m_primitiveTableBuffer);
+        Glitter::Render::DeleteBuffers(1, &m_meshletTableBuffer);
+        Glitter::Render::DeleteBuffers(1, &m_materialTableBuffer);
+        Glitter::Render::DeleteBuffers(1, &m_gpuCommandBuffer);
+        Glitter::Render::DeleteBuffers(1, &m_drawCountBuffer);
+        m_gpuCullStatistics.Release();
+        Glitter::Render::DeleteBuffers(1, &m_meshletWorkBuffer);
+        Glitter::Render::DeleteBuffers(1, &m_transparentSortBuffer);
+        Glitter::Render::DeleteBuffers(1, &m_transparentBlockOffsetBuffer);
 
         glDeleteProgram(m_debugProgram);
-        glDeleteBuffers(1, &m_debugVAO);
+        glDeleteProgram(m_debugAABBProgram);
+        glDeleteVertexArrays(1, &m_debugAABBVAO);
 
-        glDeleteProgram(m_ppfxProgram);
-        glDeleteBuffers(1, &m_ppfxVAO);
+        for (const auto& [defines, program] : m_ppfxPrograms) {
+            glDeleteProgram(program);
+        }
+        m_postProcessor.Release();
+        glDeleteProgram(m_temporalUpsampleProgram);
+        m_temporalUpsampler.Release(m_renderTargets);
+        m_stereoTargets.Release();
+        glDeleteProgram(m_shadingRateProgram);
+        m_shadingRateImage.Release();
 
         glDeleteFramebuffers(1, &m_fbo);
-        glDeleteTextures(1, &m_fboColor);
-        glDeleteRenderbuffers(1, &m_fboDepth);
-
-        glDeleteTextures(m_loadedTextures.size(), m_loadedTextures.data());
+        glDeleteFramebuffers(1, &m_oitFbo);
+        glDeleteFramebuffers(1, &m_visibilityFbo);
+        glDeleteFramebuffers(1, &m_headlessFbo);
+        Glitter::Render::DeleteRenderbuffers(1, &m_headlessColor);
+        m_renderTargets.Release(m_fboColor);
+        m_renderTargets.Release(m_fboDepth);
+        m_renderTargets.Release(m_fboNodeIds);
+
+        glDeleteProgram(m_hiZProgram);
+        m_hiZ.Release(m_renderTargets);
+        for (GLuint program : m_mipPrograms) {
+            glDeleteProgram(program);
+        }
+        m_mipGenerator.Release();
+        m_renderTargets.Clear();
+        m_gpuProfiler.Release();
+        m_batchCostSampler.Release();
+        m_renderStats.Release();
+        m_depthPrepass.Release();
+        m_occlusionQueryPool.Release();
+
+        // The slots sharing a texture share its handle, only made resident once.
+        std::ranges::sort(m_loadedTextureHandles);
+        auto [duplicateHandles, handlesEnd] = std::ranges::unique(m_loadedTextureHandles);
+        m_loadedTextureHandles.erase(duplicateHandles, handlesEnd);
+        for (GLuint64 handle : m_loadedTextureHandles) {
+            Glitter::Render::GetGLExtensions().m_makeTextureHandleNonResident(handle);
+        }
+        for (GLuint texture : m_loadedTextures) {
+            m_textureCache.Release(texture);
+        }
+        m_textureCache.Collect(true);
+        Glitter::Render::DeleteTextures(1, &m_textureArray);
+        glDeleteSamplers(1, &m_nodeSampler);
 
         // Shutdown GLFW.
         glfwTerminate();
     }
 
+    // First, so that it's installed before any other member starts a thread, and removed once they're all joined.
+    Glitter::Core::LogForwarder m_logForwarder;
+    bool m_showLog {false};
+
     GLFWwindow* m_window {};
 
-    GLuint m_mainProgram {};
+    // Indexed by the MAIN_PERMUTATION_* bits.
+    std::array<GLuint, MAIN_PERMUTATION_COUNT> m_mainPrograms {};
     GLuint m_mainVAO {};
-    GLuint m_mainUBO {};
+    GLuint m_depthProgram {};
+    // Over the geometry pool's position-only stream.
+    GLuint m_depthVAO {};
+    // DepthVS.glsl from the main light, with GLITTER_SHADOW.
+    GLuint m_shadowProgram {};
+    // DepthVS.glsl with GLITTER_VISIBILITY, and MainFS.glsl resolving it by opaque MAIN_PERMUTATION_* bits. Only created
+    // with bindless or array textures.
+    GLuint m_visibilityProgram {};
+    std::array<GLuint, MAIN_PERMUTATION_COUNT> m_visibilityResolvePrograms {};
+    // The impostor bake, and ImpostorVS.glsl with MainFS.glsl by opaque MAIN_PERMUTATION_* bits. Only created with bindless
+    // or array textures.
+    GLuint m_impostorBakeProgram {};
+    std::array<GLuint, MAIN_PERMUTATION_COUNT> m_impostorPrograms {};
+    Glitter::Render::ImpostorAtlas m_impostorAtlas;
+    // The static Nodes' batches, pre-transformed by StaticBatchCS.glsl and drawn with their cell's model matrix from
+    // m_staticBatchData instead of the Node data. Only drawn by the CPU-culled passes without the visibility buffer.
+    GLuint m_staticBatchProgram {};
+    Glitter::Render::StaticBatchCells m_staticBatchCells {Glitter::Config::STATIC_BATCH_CELL_SIZE};
+    Glitter::Render::StaticBatches m_staticBatches;
+    Glitter::Render::GpuBuffer<PerDrawData> m_staticBatchData {"Static Batch Data SSBO"};
+    // The update thread's scratch, see TakeStaticBatchRebuilds().
+    std::vector<std::uint32_t> m_staticBatchRebuildCells;
+    std::vector<std::uint32_t> m_staticBatchNodes;
+    // The GPU-simulated Nodes, and the Node of each of its agents until it's removed.
+    GLuint m_swarmProgram {};
+    Glitter::Render::NodeSwarm m_nodeSwarm;
+    std::vector<std::optional<Glitter::Scene::NodeHandle>> m_swarmHandles;
+    // The NodeStore revision the agents were pointed at their Nodes for.
+    std::uint64_t m_swarmRevision {UINT64_MAX};
+    // The animations of the loaded scenes, and the NodeStore revision their removed Nodes were last dropped at.
+    Glitter::Scene::AnimationPlayer m_animationPlayer;
+    std::uint64_t m_animationRevision {UINT64_MAX};
+    // The time the animations were last evaluated at.
+    float m_animationTime {std::numeric_limits<float>::quiet_NaN()};
+    // The joints of the loaded scenes, and the skinned Nodes whose vertices SkinMeshes() skins by them every frame, with the
+    // NodeStore revision their removed Nodes were last dropped at.
+    Glitter::Scene::Skeletons m_skeletons;
+    GLuint m_skinProgram {};
+    Glitter::Render::SkinnedMeshes m_skinnedMeshes;
+    std::vector<SkinnedNode> m_skinnedNodes;
+    std::uint64_t m_skinnedRevision {UINT64_MAX};
+    Glitter::Render::ShadowCache m_shadowCache;
+    bool m_shadows {Glitter::Config::ENABLE_SHADOWS};
+    Glitter::Render::DepthPrepass m_depthPrepass;
+    // Flushes the frame's commands as they're issued, see Config::ENABLE_EARLY_FLUSH.
+    Glitter::Render::SubmitFlusher m_submitFlusher;
+    bool m_earlyFlush {Glitter::Config::ENABLE_EARLY_FLUSH};
+    // The occlusion queries of the opaque Nodes' AABBs, drawn by DepthFS.glsl with OcclusionBoxVS.glsl.
+    Glitter::Render::OcclusionQueries m_occlusionQueryPool;
+    GLuint m_occlusionBoxProgram {};
+    Glitter::Render::DepthPrepassMode m_depthPrepassMode {Glitter::Render::DepthPrepassMode::Auto};
+    Glitter::Render::StreamBuffer m_uboStream;
+    Glitter::Render::StreamBuffer m_perDrawStream;
+    Glitter::Render::LightClusters m_lightClusters;
+    // Simulate()'s latest two steps.
+    SimulationState m_previousState {};
+    SimulationState m_currentState {};
+    // Time since the latest step, less than Config::SIMULATION_TIME_STEP between frames.
+    double m_simulationAccumulator {};
+    // glfwGetTime() of the previous frame.
+    double m_lastFrameTime {};
+    // Steps run by the latest Simulate().
+    size_t m_simulationSteps {};
+    // The view this frame is drawn from, see Simulate().
+    Glitter::Core::CameraFrame m_frameCamera {};
+    // Recorded while set, then written into Config::CAMERA_RECORDING_PATH.
+    std::optional<Glitter::Core::CameraRecording> m_cameraRecording;
+    // Played back while set, its m_playbackFrame-th frame next.
+    std::optional<Glitter::Core::CameraRecording> m_cameraPlayback;
+    size_t m_playbackFrame {};
+
+    // The entities besides the Nodes, so far the point lights, see LightOrbit. Only the first m_pointLightCount are lit.
+    Glitter::Scene::EntityWorld m_entities;
+    int m_pointLightCount {static_cast<int>(Glitter::Config::POINT_LIGHT_COUNT)};
+    Glitter::Render::TextureUploader m_textureUploader;
+    Glitter::Render::TextureStreamer m_textureStreamer;
+    Glitter::Render::MeshStreamer m_meshStreamer;
+    Glitter::Render::UploadContext m_uploadContext;
+
+    GLuint m_indirectBuffer {};
+    size_t m_indirectBufferSize {};
+    std::vector<DrawElementsIndirectCommand> m_indirectCommands;
+    // The Mesh ID of each of m_indirectCommands, STATIC_BATCH_MESH for the static batches', only while the batch cost
+    // sampler is enabled.
+    std::vector<std::uint32_t> m_indirectCommandMeshes;
+    // One per range of the draw list being batched, kept across frames for their storage, see BuildDrawBatches().
+    std::vector<DrawRecording> m_drawRecordings;
+    std::vector<DrawListEntry> m_drawListScratch;
+
+    // The packet submitted this frame, and the one updated meanwhile on m_updateThread.
+    std::array<FramePacket, 2> m_framePackets {};
+    size_t m_framePacketIdx {};
+    Glitter::Core::FrameThread m_updateThread {"Update"};
+    bool m_framePipelining {Glitter::Config::ENABLE_FRAME_PIPELINING};
+    // See Config::ENABLE_LATE_LATCHING and LatchCamera().
+    bool m_lateLatching {false};
+
+    // See Config::ENABLE_DRAW_LIST_CACHING and DrawListCache.
+    bool m_drawListCaching {Glitter::Config::ENABLE_DRAW_LIST_CACHING};
+    DrawListCache m_drawListCache {};
+
+    Glitter::Render::CullBounds m_cullBounds;
+    Glitter::Render::VisibilityMask m_nodeVisibility;
+    Glitter::Render::CullCoherency m_cullCoherency;
+    // The depth of the occluders the CPU occlusion culling rasterizes, and the Nodes it picks them among, by the pixels
+    // they cover.
+    Glitter::Render::OcclusionBuffer m_occlusionBuffer;
+    std::vector<std::pair<float, std::uint32_t>> m_occluderCandidates;
+
+    // Persistent per-Node GPU data, indexed by Node slot and mirrored on the CPU, in pages of Config::NODE_PAGE_SIZE Nodes
+    // bound one at a time. Only the ranges in m_nodeDataDirty and m_nodeBoundsDirty are uploaded each frame.
+    Glitter::Render::PagedGpuBuffer<PerDrawData> m_nodeDataBuffer {"Node Data SSBO", Glitter::Config::NODE_PAGE_SIZE};
+    Glitter::Render::PagedGpuBuffer<GpuNodeBounds> m_nodeBoundsBuffer {"Node Bounds SSBO", Glitter::Config::NODE_PAGE_SIZE};
+    std::vector<PerDrawData> m_nodeData;
+    std::vector<GpuNodeBounds> m_nodeBounds;
+    Glitter::Util::DirtyRanges m_nodeDataDirty;
+    Glitter::Util::DirtyRanges m_nodeBoundsDirty;
+    // 1 for the Nodes whose PerDrawData changed since it was last uploaded, see RequestNodeData().
+    std::vector<std::uint8_t> m_nodeDataStale;
+    size_t m_staleNodeCount {};
+    size_t m_nodeUploadRanges {};
+    size_t m_nodeUploadBytes {};
+    Glitter::Scene::BVH m_bvh;
+    // The NodeStore revision m_bvh was built for.
+    std::uint64_t m_bvhRevision {UINT64_MAX};
+
+    // Over the Nodes' world-space AABBs, for the queries around and ray picks of Nodes.
+    Glitter::Scene::SpatialHashGrid m_spatialGrid {Glitter::Config::SPATIAL_GRID_CELL_SIZE};
+    // Set by a click in BuildDebugUi(), in NDC, and consumed by the next UpdateFrame().
+    std::optional<glm::vec2> m_pickRequest;
+    std::optional<Glitter::Scene::NodeHandle> m_pickedNode;
+    // The other Nodes around the picked one, as of the latest UpdateFrame().
+    std::vector<std::uint32_t> m_pickedNeighbors;
+
+    // GPU culling, enabled through m_gpuCulling.
+    GLuint m_cullProgram {};
+    GLuint m_meshTableBuffer {};
+    GLuint m_primitiveTableBuffer {};
+    GLuint m_gpuCommandBuffer {};
+    // Per culling region and pass, see DispatchGpuCulling().
+    size_t m_gpuCommandCapacity {};
+    GLuint m_drawCountBuffer {};
+    // The draw counts and the meshlet pass' indirect dispatch of a culling region, and their stride in m_drawCountBuffer,
+    // rounded up to GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT.
+    static constexpr GLsizeiptr DRAW_COUNT_SIZE = sizeof(GLuint) * 8;
+    GLint m_drawCountStride {DRAW_COUNT_SIZE};
+    // The regions the buffers hold, and the pages the last DispatchGpuCulling() culled the regions of.
+    size_t m_gpuCullRegionCapacity {};
+    std::uint32_t m_gpuCullNodePages {};
+    std::uint32_t m_gpuCullGeometryPages {};
+    // The Nodes the culling pass keeps and culls, read back a few frames later.
+    Glitter::Render::GpuCullStatistics m_gpuCullStatistics;
+    GLuint m_gpuDrawNodeBuffer {};
+    size_t m_maxPrimitivesPerMesh {};
+
+    // Meshlet culling, the second GPU culling pass enabled through m_meshletCulling.
+    GLuint m_meshletCullProgram {};
+    GLuint m_meshletTableBuffer {};
+    GLuint m_meshletWorkBuffer {};
+    size_t m_maxCommandsPerMesh {};
+
+    // The back-to-front sort of the GPU culled transparent Nodes, see SubmitTransparentSort().
+    static constexpr size_t TRANSPARENT_SORT_BLOCK = 512;
+    GLuint m_transparentSortProgram {};
+    GLuint m_transparentCommandsProgram {};
+    GLuint m_transparentSortBuffer {};
+    GLuint m_transparentBlockOffsetBuffer {};
+    size_t m_transparentSortCapacity {};
+
+    // Hi-Z occlusion culling, built from the opaque depth and used by the next frame's GPU culling pass.
+    GLuint m_hiZProgram {};
+    Glitter::Render::HiZPyramid m_hiZ;
+    glm::mat4 m_hiZViewProjection {1.0f};
+    bool m_hiZValid {false};
+
+    // Generates the mips of the textures created without them, once the program of their format is linked.
+    std::array<GLuint, Glitter::Render::MIP_FORMAT_COUNT> m_mipPrograms {};
+    Glitter::Render::MipGenerator m_mipGenerator;
+
+    // Times the debug groups of Render() for the "Performance" header.
+    Glitter::Render::GpuProfiler m_gpuProfiler;
+    // Times a few draw batches per frame, per Mesh and material, while enabled in the "Performance" header.
+    Glitter::Render::BatchCostSampler m_batchCostSampler;
+    // Counts the draws, state changes and uploads of Render(), and the pipeline statistics of the main FB passes.
+    Glitter::Render::RenderStats m_renderStats;
+
+    // Collects the CPU scopes of every thread, shown in the "Glitter Profiler" window.
+    Glitter::Core::CpuProfiler m_cpuProfiler;
+    bool m_showCpuTimeline {false};
+
+    // Frame time history and stutters, shown in the "Performance" header.
+    Glitter::Core::FrameStats m_frameStats;
+    // Made by every thread from the previous frame's Tick() to the end of its Render().
+    Glitter::Core::AllocationCounts m_frameAllocations {};
+    // Captures frames through RenderDoc when it's injected, on F11 and after the stutters while m_captureStutters is set,
+    // at most Config::RENDERDOC_MAX_STUTTER_CAPTURES of them.
+    Glitter::Core::RenderDocCapture m_renderDoc;
+    bool m_captureStutters {Glitter::Config::ENABLE_RENDERDOC_STUTTER_CAPTURE};
+    std::uint32_t m_stutterCaptures {};
+    // Records the GL calls of a frame on F10, once created by `--gl-trace=`.
+    Glitter::Render::GLTraceRecorder m_glTrace;
+
+    // Paces the frames by m_framePacing, and measures their latency from m_inputTime, the glfwGetTime() of the latest
+    // Tick()'s input.
+    Glitter::Render::FramePacer m_framePacer;
+    Glitter::Render::FramePacingSettings m_framePacing {};
+    double m_inputTime {};
+    // Draws frames only on input or changes to the scene, see Config::ENABLE_ON_DEMAND_RENDERING, and the frames drawn
+    // since the latest ones.
+    bool m_renderOnDemand {Glitter::Config::ENABLE_ON_DEMAND_RENDERING};
+    size_t m_idleFrames {};
+
+    // Set by `--benchmark`, see RecordBenchmarkFrame().
+    Glitter::Core::BenchmarkOptions m_benchmark;
+    Glitter::Core::BenchmarkRecorder m_benchmarkRecorder;
+    // Set by `--benchmark-camera`, played back from the first sampled frame on.
+    std::optional<Glitter::Core::CameraRecording> m_benchmarkCamera;
+    size_t m_benchmarkFrame {};
+    // The sampled frames that allocated, see Config::ENABLE_ALLOCATION_TRACKING, and whether the benchmark failed.
+    size_t m_allocatingBenchmarkFrames {};
+    bool m_benchmarkFailed {false};
+    std::chrono::steady_clock::time_point m_benchmarkFrameStart {std::chrono::steady_clock::now()};
 
     GLuint m_debugProgram {};
-    GLuint m_debugVAO {};
-
-    struct PpfxVertex {
-        float x, y, z;
-        float u, v;
-    };
-
-    GLuint m_ppfxProgram {};
-    GLuint m_ppfxVAO {};
-
+    Glitter::Render::DebugDraw m_debugDraw;
+    // DebugVS.glsl with GLITTER_DEBUG_AABBS, drawn without attributes.
+    GLuint m_debugAABBProgram {};
+    GLuint m_debugAABBVAO {};
+
+    // The PpfxCS program of each Render::GetPostProcessVariants(), keyed by its defines.
+    std::map<std::string, GLuint> m_ppfxPrograms;
+    // Binaries of the programs built by SubmitProgram(), when Config::ENABLE_PROGRAM_CACHE is set.
+    Glitter::Render::ProgramCache m_programCache;
+    std::vector<PendingProgramTarget> m_pendingPrograms;
+    // Shader hot reload, enabled through Config::ENABLE_SHADER_HOT_RELOAD unless the shaders are read from an AssetPack, or
+    // there are no loose shaders to override the embedded ones with.
+    bool m_shaderHotReload {false};
+    // Shaders loaded from SPIR-V modules where there are some, through Config::ENABLE_SPIRV_SHADERS.
+    bool m_spirvShaders {false};
+    Glitter::Util::FileWatcher m_shaderWatcher {Glitter::Config::SHADER_HOT_RELOAD_INTERVAL};
+    std::vector<ProgramSource> m_programSources;
+    std::deque<PendingProgramTarget> m_reloadingPrograms;
+    Glitter::Render::PostProcessor m_postProcessor;
+    Glitter::Render::PostProcessSettings m_postProcessSettings {};
+
+    // The main thread's transient allocations, reset every Render(). Outlives the render graph holding some.
+    Glitter::Util::FrameArena m_frameArena {Glitter::Config::FRAME_ARENA_SIZE};
+    Glitter::Render::RenderTargetPool m_renderTargets;
+    Glitter::Render::RenderGraph m_renderGraph;
     GLuint m_fbo {};
-    GLuint m_fboColor {};
-    GLuint m_fboDepth {};
-
-    struct DebugVertex {
-        float x, y, z;
+    Glitter::Render::RenderTarget m_fboColor {};
+    Glitter::Render::RenderTarget m_fboDepth {};
+    // The Node drawn over each pixel of m_fbo, when clicked Nodes are picked from it rather than by a ray cast, and the
+    // readbacks of its clicked pixels. Set from Config::ENABLE_GPU_PICKING in Prepare().
+    Glitter::Render::RenderTarget m_fboNodeIds {};
+    bool m_gpuPicking {};
+    Glitter::Render::NodePicker m_nodePicker;
+    // The weighted blended transparent Nodes' FBO, sharing m_fboDepth. Defaults to Config::ENABLE_WEIGHTED_OIT.
+    GLuint m_oitFbo {};
+    bool m_weightedOit {Glitter::Config::ENABLE_WEIGHTED_OIT};
+    // The visibility buffer's FBO, sharing m_fboDepth. Defaults to Config::ENABLE_VISIBILITY_BUFFER.
+    GLuint m_visibilityFbo {};
+    bool m_visibilityBuffer {Glitter::Config::ENABLE_VISIBILITY_BUFFER};
+    // Whether m_fboColor is GL_R11F_G11F_B10F rather than GL_RGBA16F. Defaults to Config::ENABLE_PACKED_HDR_COLOR.
+    bool m_packedHdrColor {Glitter::Config::ENABLE_PACKED_HDR_COLOR};
+    // Presented into instead of the default framebuffer in the headless mode, 0 otherwise.
+    GLuint m_headlessFbo {};
+    GLuint m_headlessColor {};
+    // Frames rendered in the headless mode, which quits after the benchmark's frame count.
+    size_t m_headlessFrame {};
+
+    // A scene of the render server, see Core::BenchmarkOptions::m_servePath. Its Nodes are swapped into m_nodes, and its FBO
+    // in as m_headlessFbo, for its frames.
+    struct ServedScene {
+        Glitter::Core::ServedSceneDesc m_desc;
+        Glitter::Scene::NodeStore m_nodes;
+        // Read ahead of the assets it draws, until its Nodes are added.
+        std::optional<Glitter::Scene::SceneSnapshot> m_snapshot;
+        std::optional<Glitter::Core::CameraRecording> m_camera;
+        size_t m_frameCount {};
+        // The frame it's rendering, or renders next.
+        size_t m_frame {};
+        GLuint m_fbo {};
+        GLuint m_color {};
+        std::unique_ptr<Glitter::Core::FrameOutput> m_output;
     };
+    // Rendered round-robin, a frame each in turn, all sharing the programs, Meshes, textures and render targets. The
+    // features carrying state over from one frame to the next are turned off, see RestrictToServedScenes().
+    std::vector<ServedScene> m_servedScenes;
+    std::optional<size_t> m_activeServedScene;
 
-    struct {
-        std::vector<DebugVertex> m_debugLines;
-
-        void PushDebugLine(glm::vec3 a, glm::vec3 b)
-        {
-            m_debugLines.emplace_back(DebugVertex {.x = a.x, .y = a.y, .z = a.z});
-            m_debugLines.emplace_back(DebugVertex {.x = b.x, .y = b.y, .z = b.z});
-        }
-
-        void Clear() { m_debugLines.clear(); }
-    } m_debugData;
+    // Reads back the frames captured by "Capture Frame", or every frame into m_frameOutput, counted by m_capturedFrames.
+    Glitter::Render::FrameReadback m_frameReadback;
+    bool m_captureRequested {};
+    std::uint64_t m_capturedFrames {};
 
     int m_windowWidth {1366};
     int m_windowHeight {768};
+    // glfwGetTime() of the last resize.
+    double m_lastResizeTime {};
+    // The viewport of the FBO the main pass renders, scaled down from the window's by dynamic resolution or while the
+    // window outgrows the FBO's targets.
+    int m_renderWidth {1366};
+    int m_renderHeight {768};
+    Glitter::Render::ResolutionScaler m_resolutionScaler;
+    bool m_dynamicResolution {false};
+    // Lowers the LODs, draw distance, shadow map and post effects to hold the frame time, see
+    // Config::ENABLE_QUALITY_GOVERNOR.
+    Glitter::Render::QualityGovernor m_qualityGovernor;
+    bool m_adaptiveQuality {false};
+    // Renders the main pass at a further m_temporalUpsamplingScale, jittered by m_jitter, and upsamples it over the frames.
+    Glitter::Render::TemporalUpsampler m_temporalUpsampler;
+    GLuint m_temporalUpsampleProgram {};
+    bool m_temporalUpsampling {Glitter::Config::ENABLE_TEMPORAL_UPSAMPLING};
+    float m_temporalUpsamplingScale {Glitter::Config::TEMPORAL_UPSAMPLING_SCALE};
+    glm::vec2 m_jitter {};
+    // Renders both eyes in the main pass, through GL_OVR_multiview, see Config::ENABLE_STEREO. Fixed once the programs are
+    // built with it.
+    bool m_stereo {false};
+    Glitter::Render::StereoTargets m_stereoTargets;
+    // Coarsens the main pass' shading, see Config::ENABLE_VARIABLE_RATE_SHADING.
+    Glitter::Render::ShadingRateImage m_shadingRateImage;
+    GLuint m_shadingRateProgram {};
+    Glitter::Render::ShadingRateMode m_shadingRateMode {Glitter::Config::ENABLE_VARIABLE_RATE_SHADING
+            ? Glitter::Render::ShadingRateMode::Foveated
+            : Glitter::Render::ShadingRateMode::Off};
+    // The inset views drawn over the main view, see Config::INSET_VIEW_COUNT. The culling writes which inset views see each
+    // Node into m_insetViewMasks, a bit per view, and the draw lists which views draw each listed Node into
+    // m_drawListViews, the main view's bit first.
+    Glitter::Render::ViewLayout m_viewLayout {Glitter::Config::INSET_VIEW_COUNT > 0
+            ? Glitter::Render::ViewLayout::PictureInPicture
+            : Glitter::Render::ViewLayout::Single};
+    int m_insetViewCount {static_cast<int>(std::max<size_t>(Glitter::Config::INSET_VIEW_COUNT, 1))};
+    std::vector<std::uint8_t> m_insetViewMasks;
+    std::vector<std::uint8_t> m_drawListViews;
 
     glm::mat4 m_currentView {};
     glm::mat4 m_currentProjection {};
 
-    struct CommonData {
-        glm::mat4 m_view;
-        glm::mat4 m_projection;
-        glm::vec4 m_eyePos;
-        glm::vec4 m_lightPos;
-        glm::vec4 m_lightColor;
-    };
-    struct PerDrawData {
-        glm::mat4 m_model;
-        float m_opacity;
-    };
-    struct ShaderData {
-        CommonData m_commonData;
-        PerDrawData m_perDrawData;
+    Glitter::Util::LinearAllocator m_uboAllocator;
+    // The offset between the CommonData of consecutive views in the UBO ring.
+    size_t m_commonDataStride {};
+
+    enum class TextureMode : std::uint8_t {
+        // One GL_TEXTURE_2D per texture, bound per batch.
+        Bound,
+        // One GL_TEXTURE_2D per texture, sampled through resident GL_ARB_bindless_texture handles.
+        Bindless,
+        // Every texture resized into a layer of the single m_textureArray.
+        Array,
     };
-    LinearAllocator m_uboAllocator;
+    TextureMode m_textureMode {TextureMode::Bound};
 
+    size_t m_textureCount {};
+    // Indexed by texture slot, the slots sharing a texture hold it more than once, and a reference to it in m_textureCache
+    // each.
     std::vector<GLuint> m_loadedTextures;
-
-    struct Node {
-        glm::vec3 m_position;
-        glm::vec3 m_scale;
-
-        size_t m_meshID;
-        size_t m_uboOffset;
-
-        GLuint m_texture;
-        float m_opacity;
-
-        bool m_shouldAnimate;
-        bool m_culled;
+    Glitter::Render::TextureCache m_textureCache;
+    // Every Node texture is sampled through m_nodeSampler, at the level of detail biased by m_textureMipBias.
+    GLuint m_nodeSampler {};
+    GLfloat m_textureAnisotropy {1.0f};
+    float m_textureMipBias {Glitter::Config::TEXTURE_MIP_BIAS};
+    std::vector<GLuint64> m_loadedTextureHandles;
+    GLuint m_textureArray {};
+
+    Glitter::Scene::NodeStore m_nodes;
+    Glitter::Core::JobSystem m_jobSystem {Glitter::Config::JOB_WORKER_COUNT};
+    // Resumes the asset loading coroutines on m_jobSystem, or on the main thread for their GL calls.
+    Glitter::Core::CoroutineScheduler m_coroutines {m_jobSystem};
+    // Encodes the frames captured with `--capture` on m_jobSystem, or pipes them to `--capture-pipe`.
+    Glitter::Core::FrameOutput m_frameOutput {m_jobSystem};
+    // Set up by `--telemetry`.
+    Glitter::Core::TelemetryExporter m_telemetry;
+
+    // Indexed by Mesh ID. The skinned Nodes' copies are removed along with them, and their IDs reused.
+    Glitter::Util::ObjectPool<Mesh> m_meshes;
+    // The IDs of the loaded assets' Meshes, which Nodes are spawned and generated from, but not the skinned Nodes' copies.
+    std::vector<std::uint32_t> m_spawnableMeshes;
+    // The default material, then the materials of every loaded asset.
+    std::vector<GpuMaterial> m_materials;
+    GLuint m_materialTableBuffer {};
+
+    // A loaded asset whose primitives are still being uploaded, m_primitives holds the uploaded ones in order.
+    struct PendingAsset {
+        std::string m_path;
+        Glitter::Scene::GltfAsset m_source;
+        std::vector<Primitive> m_primitives;
     };
-    std::vector<Node> m_nodes;
-
-    std::vector<Mesh> m_meshes;
+    std::deque<PendingAsset> m_pendingAssets;
+    Glitter::Scene::GltfLoader m_gltfLoader {&m_jobSystem};
+    // Every asset requested, by path, and its Meshes once they're registered.
+    std::map<std::string, std::optional<AssetMeshes>, std::less<>> m_assetMeshes;
+    // The world streamed around the camera, the Nodes added for each of its chunks, and the chunks landed but not added
+    // yet, see StreamWorld().
+    bool m_worldStreaming {};
+    Glitter::Scene::WorldStreamer m_worldStreamer;
+    std::map<std::uint32_t, std::vector<Glitter::Scene::NodeHandle>> m_worldChunkNodes;
+    std::vector<Glitter::Scene::WorldChunk> m_pendingWorldChunks;
+    // The scene snapshot read but not added yet, see AddSnapshotNodes().
+    std::optional<Glitter::Scene::SceneSnapshot> m_pendingSnapshot;
+    // The position-only stream holds the bytes before the texture coordinates.
+    Glitter::Render::GeometryPool m_geometryPool {
+        Glitter::Config::ENABLE_QUANTIZED_VERTICES ? sizeof(Glitter::Scene::QuantizedVertex) : sizeof(Glitter::Scene::MeshVertex),
+        Glitter::Config::ENABLE_SHORT_INDICES ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+        Glitter::Config::ENABLE_QUANTIZED_VERTICES ? offsetof(Glitter::Scene::QuantizedVertex, u)
+                                                   : offsetof(Glitter::Scene::MeshVertex, u)};
+    // The page the VAOs and the pulled vertices are attached to, see AttachGeometryPage().
+    std::uint32_t m_attachedGeometryPage {};
 
     bool m_frustumCulling {true};
-    bool m_debugLines {true};
+    bool m_gpuCulling {false};
+    bool m_bvhCulling {true};
+    bool m_occlusionCulling {true};
+    bool m_cpuOcclusionCulling {true};
+    bool m_occlusionQueries {false};
+    bool m_meshletCulling {Glitter::Config::ENABLE_MESHLETS};
+    bool m_meshLods {true};
+    bool m_impostors {Glitter::Config::ENABLE_IMPOSTORS};
+    bool m_staticBatching {Glitter::Config::ENABLE_STATIC_BATCHING};
+    // Draw the far static batch cells from their proxies, see Config::ENABLE_HLOD.
+    bool m_hlod {Glitter::Config::ENABLE_HLOD};
+    bool m_contributionCulling {true};
+    float m_maxDrawDistance {Glitter::Config::MAX_DRAW_DISTANCE};
+    float m_minProjectedPixels {Glitter::Config::MIN_PROJECTED_PIXELS};
+    bool m_debugLines {Glitter::Config::ENABLE_DEBUG_DRAW};
+    // The "Glitter Framebuffers" window, with the main pass' color target.
+    bool m_showFramebufferView {false};
+    // Whether the Dear ImGui windows are shown, toggled by F1, whether they're rebuilt this frame, and when they last were.
+    bool m_showOverlays {true};
+    bool m_updateUi {false};
+    double m_uiUpdateTime {};
+    bool m_drawTextures {true};
+    // What the Nodes are drawn as, see DebugView.
+    DebugView m_debugView {DebugView::Shaded};
     bool m_drawAABBs {false};
+    // The point lights' spheres, hidden behind the Nodes, and the main light's shadow frustum.
+    bool m_drawLights {false};
+    bool m_nodeChurn {false};
+    Glitter::Scene::SceneGeneratorSettings m_generatorSettings {.m_nodeCount = Glitter::Config::GENERATOR_NODE_COUNT,
+        .m_meshCount = SIZE_MAX,
+        .m_textureCount = SIZE_MAX,
+        .m_materialCount = 0,
+        .m_distribution = Glitter::Scene::SceneDistribution::Uniform,
+        .m_radius = Glitter::Config::GENERATOR_RADIUS,
+        .m_clusterCount = Glitter::Config::GENERATOR_CLUSTER_COUNT,
+        .m_clusterRadius = Glitter::Config::GENERATOR_CLUSTER_RADIUS,
+        .m_transparentRatio = 0.0f,
+        .m_animatedRatio = 0.0f,
+        .m_seed = Glitter::Config::BENCHMARK_SEED};
+    // The spawned Nodes fade in and out, which keeps them out of the static batches.
+    bool m_animateSpawnedNodes {true};
+    bool m_playAnimations {true};
 
-    float m_sceneGamma {1.0f};
 };
 
-int main()
+int main(int argc, char** argv)
 {
-    GlitterApplication glitterApp;
-    glitterApp.Run();
-    return 0;
+    Glitter::Core::InitializeLogging();
+    int result = 0;
+    {
+        GlitterApplication glitterApp(Glitter::Core::ParseBenchmarkOptions(std::span(argv, static_cast<size_t>(argc))));
+        result = glitterApp.Run();
+    }
+    Glitter::Core::ShutdownLogging();
+    return result;
 }
\ No newline at end of file
@@ -0,0 +1,75 @@
+// Offline builder of the asset pack Glitter mounts at startup, see Config::ASSET_PACK_PATH. Usage, from the data
+// directory:
+//
+//     GlitterPackTool [--compress] [--embed <source>] <pack> <file or directory>...
+//
+// Directories are walked recursively, and each file is stored under its path relative to the working directory, the one
+// Glitter loads it by. Run the GlitterTextures target and Glitter itself first, so that the .ktx2 textures and the
+// .meshcache files the pack should hold exist. With `--compress`, the assets that compress well are stored compressed.
+// With `--embed`, the pack's bytes are also written into `source`, which the build embeds the shaders' pack from.
+
+#include "util/AssetPack.h"
+
+#include <filesystem>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    std::span<char*> arguments(argv + 1, static_cast<size_t>(argc - 1));
+    const char* sourcePath = nullptr;
+    bool compress = false;
+    while (!arguments.empty()) {
+        std::string_view option(arguments[0]);
+        if (option == "--compress") {
+            compress = true;
+            arguments = arguments.subspan(1);
+        } else if (option == "--embed" && arguments.size() >= 2) {
+            sourcePath = arguments[1];
+            arguments = arguments.subspan(2);
+        } else {
+            break;
+        }
+    }
+    if (arguments.size() < 2) {
+        spdlog::error("Usage: GlitterPackTool [--compress] [--embed <source>] <pack> <file or directory>...");
+        return 1;
+    }
+
+    std::filesystem::path packPath(arguments[0]);
+    std::vector<std::string> assetPaths {};
+    for (std::string_view argument : arguments.subspan(1)) {
+        std::filesystem::path path(argument);
+        std::error_code error {};
+        if (!std::filesystem::is_directory(path, error)) {
+            assetPaths.push_back(path.generic_string());
+            continue;
+        }
+
+        for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(path, error)) {
+            // Fails, as not equivalent, while the pack doesn't exist yet.
+            std::error_code packError {};
+            if (entry.is_regular_file() && !std::filesystem::equivalent(entry.path(), packPath, packError)) {
+                assetPaths.push_back(entry.path().lexically_normal().generic_string());
+            }
+        }
+        if (error) {
+            spdlog::error("Failed to list <{}>: {}.", path.string(), error.message());
+            return 1;
+        }
+    }
+
+    if (!Glitter::Util::WriteAssetPack(packPath.string().c_str(), assetPaths, compress)) {
+        return 1;
+    }
+    if (sourcePath && !Glitter::Util::WriteAssetPackSource(sourcePath, packPath.string().c_str())) {
+        return 1;
+    }
+
+    std::println("{} assets -> {}", assetPaths.size(), packPath.string());
+    return 0;
+}
@@ -0,0 +1,42 @@
+// Offline generator of the GLSL declarations of the structs Glitter shares with its shaders, see
+// Render::GenerateShaderDataGlsl(). Usage:
+//
+//     GlitterShaderLayoutTool <include>
+//
+// The include is only written if its contents changed, so that the shaders embedded from it aren't rebuilt for nothing.
+
+#include "render/ShaderData.h"
+#include "util/File.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    if (argc != 2) {
+        spdlog::error("Usage: GlitterShaderLayoutTool <include>");
+        return 1;
+    }
+
+    std::string glsl = Glitter::Render::GenerateShaderDataGlsl();
+    std::optional<std::vector<std::byte>> current = Glitter::Util::ReadBinaryFile(argv[1]);
+    if (current && std::ranges::equal(*current, std::as_bytes(std::span(glsl)))) {
+        return 0;
+    }
+
+    std::ofstream file(argv[1], std::ios::binary | std::ios::trunc);
+    file.write(glsl.data(), static_cast<std::streamsize>(glsl.size()));
+    if (!file) {
+        spdlog::error("Failed to write <{}>.", argv[1]);
+        return 1;
+    }
+
+    std::println("Generated <{}>", argv[1]);
+    return 0;
+}
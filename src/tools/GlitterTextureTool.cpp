@@ -0,0 +1,65 @@
+// Offline converter from the images stb_image reads to the .ktx2 files loaded by Glitter at startup, see
+// Config::ENABLE_COMPRESSED_TEXTURES. Usage:
+//
+//     GlitterTextureTool [--bc1 | --bc7] <image>...
+//
+// Each image is written next to itself with a .ktx2 extension, compressed with its full mip chain. BC7 (the default)
+// keeps alpha and most detail at 1 byte per texel, BC1 drops alpha for 0.5 bytes per texel.
+
+#include "render/TextureCompression.h"
+
+#include <stb_image.h>
+
+#include <filesystem>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+
+int main(int argc, char** argv)
+{
+    GLenum format = GL_COMPRESSED_RGBA_BPTC_UNORM;
+    int failures = 0;
+    int converted = 0;
+    for (std::string_view argument : std::span(argv + 1, static_cast<size_t>(argc - 1))) {
+        if (argument == "--bc1") {
+            format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            continue;
+        }
+        if (argument == "--bc7") {
+            format = GL_COMPRESSED_RGBA_BPTC_UNORM;
+            continue;
+        }
+
+        std::string path(argument);
+        int width = 0, height = 0, nChannels = 0;
+        stbi_uc* image = stbi_load(path.c_str(), &width, &height, &nChannels, 4);
+        if (!image) {
+            spdlog::error("Failed to load <{}>.", path);
+            failures++;
+            continue;
+        }
+
+        std::optional<Glitter::Render::CompressedTexture> texture = Glitter::Render::CompressTexture(
+            std::span(image, 4 * static_cast<size_t>(width) * static_cast<size_t>(height)), width, height, format);
+        stbi_image_free(image);
+
+        std::string outputPath = std::filesystem::path(path).replace_extension(".ktx2").string();
+        if (!texture || !Glitter::Render::WriteKtx2(outputPath.c_str(), *texture)) {
+            spdlog::error("Failed to write <{}>.", outputPath);
+            failures++;
+            continue;
+        }
+
+        std::println("{} -> {} ({}x{}, {} mips, {} bytes instead of {})", path, outputPath, width, height,
+            texture->m_levels.size(), texture->m_data.size(), 4 * static_cast<size_t>(width) * static_cast<size_t>(height));
+        converted++;
+    }
+
+    if (converted == 0 && failures == 0) {
+        spdlog::error("Usage: GlitterTextureTool [--bc1 | --bc7] <image>...");
+        return 1;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
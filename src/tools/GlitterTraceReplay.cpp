@@ -0,0 +1,149 @@
+// Plays back a GL trace Glitter recorded with `--gl-trace=<path>`, see Render::GLTraceRecorder, in a loop without the
+// application, and prints how long its frame takes on the CPU and the GPU. Usage:
+//
+//     GlitterTraceReplay [--frames=<count>] <trace>
+//
+// The window is created at the size the trace was recorded at, without vsync, and the frame is replayed `count` times,
+// 500 by default. The objects the trace starts with are created once, then every loop restores the state the frame
+// started from and makes its calls again.
+
+#include "render/GLTrace.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <print>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    constexpr size_t DEFAULT_FRAME_COUNT = 500;
+    // The frames the timestamps are read back after, so that reading them never waits on the GPU.
+    constexpr size_t QUERY_LATENCY = 4;
+
+    void PrintTimings(const char* name, std::vector<double> milliseconds)
+    {
+        if (milliseconds.empty()) {
+            return;
+        }
+        std::ranges::sort(milliseconds);
+        double sum = 0.0;
+        for (double sample : milliseconds) {
+            sum += sample;
+        }
+        auto percentile = [&](double fraction) {
+            auto idx = static_cast<size_t>(fraction * static_cast<double>(milliseconds.size()));
+            return milliseconds[std::min(idx, milliseconds.size() - 1)];
+        };
+        std::println("{}: mean {:.3f} ms, p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms", name,
+            sum / static_cast<double>(milliseconds.size()), percentile(0.50), percentile(0.95), percentile(0.99));
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::span<char*> arguments(argv + 1, static_cast<size_t>(argc - 1));
+    size_t frameCount = DEFAULT_FRAME_COUNT;
+    constexpr std::string_view FRAMES_PREFIX = "--frames=";
+    while (!arguments.empty() && std::string_view(arguments[0]).starts_with(FRAMES_PREFIX)) {
+        std::string_view count = std::string_view(arguments[0]).substr(FRAMES_PREFIX.size());
+        if (std::from_chars(count.data(), count.data() + count.size(), frameCount).ec != std::errc {} || frameCount == 0) {
+            spdlog::error("Malformed frame count {}.", count);
+            return 1;
+        }
+        arguments = arguments.subspan(1);
+    }
+    if (arguments.size() != 1) {
+        spdlog::error("Usage: GlitterTraceReplay [--frames=<count>] <trace>");
+        return 1;
+    }
+
+    Glitter::Render::GLTraceReplayer replayer {};
+    if (!replayer.Load(arguments[0])) {
+        return 1;
+    }
+
+    if (glfwInit() == GLFW_FALSE) {
+        spdlog::error("Failed to initialize GLFW.");
+        return 1;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    int width = std::max(replayer.GetWidth(), 1);
+    int height = std::max(replayer.GetHeight(), 1);
+    GLFWwindow* window = glfwCreateWindow(width, height, "Glitter Trace Replay", nullptr, nullptr);
+    if (!window) {
+        spdlog::error("Failed to create a GL 4.6 window.");
+        glfwTerminate();
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
+        spdlog::error("Failed to load GL.");
+        glfwTerminate();
+        return 1;
+    }
+    spdlog::info("Replaying {} on {}, {}.", arguments[0], reinterpret_cast<const char*>(glGetString(GL_RENDERER)),
+        reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+
+    auto prepareStart = std::chrono::steady_clock::now();
+    if (!replayer.Prepare()) {
+        glfwTerminate();
+        return 1;
+    }
+    glFinish();
+    spdlog::info("Created the trace's objects in {:.1f} ms.",
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - prepareStart).count());
+
+    // Timestamps rather than GL_TIME_ELAPSED, which the frame may use itself and doesn't nest.
+    std::array<std::array<GLuint, 2>, QUERY_LATENCY> queries {};
+    for (std::array<GLuint, 2>& pair : queries) {
+        glCreateQueries(GL_TIMESTAMP, 2, pair.data());
+    }
+    std::vector<double> cpuMilliseconds {};
+    std::vector<double> gpuMilliseconds {};
+    for (size_t frame = 0; frame < frameCount && glfwWindowShouldClose(window) == GLFW_FALSE; frame++) {
+        std::array<GLuint, 2>& pair = queries[frame % QUERY_LATENCY];
+        if (frame >= QUERY_LATENCY) {
+            GLuint64 start = 0;
+            GLuint64 end = 0;
+            glGetQueryObjectui64v(pair[0], GL_QUERY_RESULT, &start);
+            glGetQueryObjectui64v(pair[1], GL_QUERY_RESULT, &end);
+            gpuMilliseconds.push_back(static_cast<double>(end - start) / 1'000'000.0);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        glQueryCounter(pair[0], GL_TIMESTAMP);
+        if (!replayer.ReplayFrame()) {
+            glfwTerminate();
+            return 1;
+        }
+        glQueryCounter(pair[1], GL_TIMESTAMP);
+        cpuMilliseconds.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    std::println("{} calls per frame, {} frames", replayer.GetFrameCallCount(), cpuMilliseconds.size());
+    PrintTimings("CPU", std::move(cpuMilliseconds));
+    PrintTimings("GPU", std::move(gpuMilliseconds));
+
+    for (std::array<GLuint, 2>& pair : queries) {
+        glDeleteQueries(2, pair.data());
+    }
+    glfwTerminate();
+    return 0;
+}